@@ -244,6 +244,18 @@ macro(xgboost_target_link_libraries target)
     target_link_libraries(${target} PRIVATE Threads::Threads ${CMAKE_THREAD_LIBS_INIT})
   endif()
 
+  if(CMAKE_SYSTEM_NAME STREQUAL "Linux")
+    # shm_open for the shared memory collective, merged into libc since glibc 2.34.
+    find_library(LIBRT rt)
+    if(LIBRT)
+      if(BUILD_STATIC_LIB)
+        target_link_libraries(${target} PUBLIC ${LIBRT})
+      else()
+        target_link_libraries(${target} PRIVATE ${LIBRT})
+      endif()
+    endif()
+  endif()
+
   if(USE_OPENMP)
     if(BUILD_STATIC_LIB)
       target_link_libraries(${target} PUBLIC OpenMP::OpenMP_CXX)
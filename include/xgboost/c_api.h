@@ -109,6 +109,96 @@ XGB_DLL int XGBSetGlobalConfig(char const *config);
  */
 XGB_DLL int XGBGetGlobalConfig(char const **out_config);
 
+/**
+ * @brief Get the hardware performance counters collected for the timed phases of training
+ *        and prediction, when the `perf_counters` global parameter is set.
+ *
+ * @since 3.1.0
+ *
+ * @param out A JSON object keyed by the phase name. Each phase has the number of calls, the
+ *            elapsed time in seconds, the counter values and the estimated memory bandwidth
+ *            in GB/s. Counters that are not available on the host are omitted.
+ *
+ * @return 0 for success, -1 for failure
+ */
+XGB_DLL int XGBGetPerfCounters(char const **out);
+
+/**
+ * @brief Get the host memory used by each subsystem, including the sparse pages, the
+ *        gradient index, the histograms and the prediction cache.
+ *
+ * @since 3.1.0
+ *
+ * @param out A JSON object keyed by the subsystem name, with an additional `Total`
+ *            entry. Each entry has the `current` and the `peak` number of bytes. Device
+ *            memory is not included.
+ *
+ * @return 0 for success, -1 for failure
+ */
+XGB_DLL int XGBGetMemoryStats(char const **out);
+
+/**
+ * @brief Register a callback that receives the statistics of each tree built by the `hist`
+ *        tree method on CPU.
+ *
+ * @since 3.1.0
+ *
+ * The callback is invoked with a JSON object for each tree once the boosting round is
+ * finished, on the thread that runs the training. The object contains the iteration, the
+ * index of the tree in the model, the output group, the wall time in seconds, the exclusive
+ * time of each phase in `phases` (`gradient`, `sampling`, `build_hist`, `subtraction`,
+ * `sync`, `evaluate`, `partition`, `leaf_update` and `prediction_cache`), the number of
+ * expanded nodes, the number of local rows in the nodes expanded at each depth, the hits and
+ * evictions of the histogram cache, and the bytes communicated with other workers.
+ *
+ * @param callback The callback, null to stop recording. The string is only valid during the
+ *                 call.
+ *
+ * @return 0 for success, -1 for failure
+ */
+XGB_DLL int XGBRegisterTreeTelemetryCallback(void (*callback)(char const *record));
+
+/**
+ * @brief A task submitted to the parallel executor.
+ *
+ * @param task_data Opaque data of the task.
+ * @param task_idx  Index of the task, in [0, n_tasks).
+ */
+XGB_EXTERN_C typedef void XGBParallelTask(void *task_data, int32_t task_idx);  // NOLINT(*)
+
+/**
+ * @brief Executor for the parallel loops in XGBoost.
+ *
+ *   The executor must call `task(task_data, i)` exactly once for each i in [0, n_tasks),
+ *   the calls can run concurrently on any thread, and return after all the calls have
+ *   finished. The task index serves as the thread index in XGBoost, tasks with different
+ *   indices can run on the same thread. The tasks don't throw.
+ *
+ * @param executor_data The data passed to @ref XGBSetParallelExecutor.
+ *
+ * @return 0 for success, non-zero if the executor failed to run the tasks.
+ */
+XGB_EXTERN_C typedef int32_t XGBParallelExecutor(void *executor_data,  // NOLINT(*)
+                                                 int32_t n_tasks, XGBParallelTask *task,
+                                                 void *task_data);
+
+/**
+ * @brief Run the CPU parallel loops on an executor provided by the application, like a TBB
+ *        task arena, instead of the OpenMP thread pool. This helps avoiding
+ *        oversubscription when XGBoost is embedded in a multi-threaded process.
+ *
+ *   The executor is shared by all threads, it should be set before any XGBoost
+ *   computation starts. The `nthread` parameter still decides the number of tasks.
+ *
+ * @since 3.1.0
+ *
+ * @param executor      The executor, NULL to restore OpenMP.
+ * @param executor_data Opaque data passed to the executor.
+ *
+ * @return 0 for success, -1 for failure
+ */
+XGB_DLL int XGBSetParallelExecutor(XGBParallelExecutor *executor, void *executor_data);
+
 /**@}*/
 
 /**
@@ -172,6 +262,27 @@ XGB_DLL int XGDMatrixCreateFromCSREx(const size_t *indptr, const unsigned *indic
  */
 XGB_DLL int XGDMatrixCreateFromColumnar(char const *data, char const *config, DMatrixHandle *out);
 
+/**
+ * @brief Create a DMatrix from an Arrow record batch exported through the Arrow C data
+ *        interface.
+ *
+ * The columns are referenced without copying, including the indices of dictionary-encoded
+ * columns, which are used as categorical codes. Nulls are treated as missing values. The
+ * caller retains the ownership of the record batch, XGBoost doesn't call the release
+ * callbacks.
+ *
+ * @since 3.1.0
+ *
+ * @param array  Pointer to a `struct ArrowArray` of the struct type.
+ * @param schema Pointer to the `struct ArrowSchema` of the array.
+ * @param config See @ref XGDMatrixCreateFromDense for details.
+ * @param out    The created DMatrix.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGDMatrixCreateFromArrow(void *array, void *schema, char const *config,
+                                     DMatrixHandle *out);
+
 /**
  * @example c-api-demo.c
  */
@@ -206,6 +317,46 @@ XGB_DLL int XGDMatrixCreateFromCSR(char const *indptr, char const *indices, char
  */
 XGB_DLL int XGDMatrixCreateFromDense(char const *data, char const *config, DMatrixHandle *out);
 
+/**
+ * @brief Create a DMatrix that references a dense array instead of copying it.
+ *
+ * The caller must keep the array alive and unchanged until the DMatrix is freed. The
+ * gradient index used by the `hist` tree method is built directly from the array, and
+ * prediction reads the array directly. Other tree methods need a copy of the data, which is
+ * made on demand.
+ *
+ * @since 3.1.0
+ *
+ * @param data   JSON encoded __array_interface__ to array values, must be on host.
+ * @param config JSON encoded configuration.  Required values are:
+ *   - missing: Which value to represent missing value.
+ *   - nthread (optional): Number of threads used for initializing DMatrix.
+ * @param out The created DMatrix
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGDMatrixCreateBorrowedFromDense(char const *data, char const *config,
+                                             DMatrixHandle *out);
+
+/**
+ * @brief Create a DMatrix that references a CSR matrix instead of copying it, see @ref
+ *        XGDMatrixCreateBorrowedFromDense.
+ *
+ * @since 3.1.0
+ *
+ * @param indptr  JSON encoded __array_interface__ to row pointers in CSR.
+ * @param indices JSON encoded __array_interface__ to column indices in CSR.
+ * @param data    JSON encoded __array_interface__ to values in CSR.
+ * @param ncol    The number of columns.
+ * @param config  See @ref XGDMatrixCreateBorrowedFromDense for details.
+ * @param out     The created dmatrix
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGDMatrixCreateBorrowedFromCSR(char const *indptr, char const *indices,
+                                           char const *data, bst_ulong ncol, char const *config,
+                                           DMatrixHandle *out);
+
 /**
  * @brief Create a DMatrix from a CSC matrix.
  *
@@ -330,6 +481,7 @@ XGB_DLL int XGDMatrixCreateFromCudaArrayInterface(char const *data, char const *
  * - @ref XGProxyDMatrixSetDataCudaArrayInterface
  * - @ref XGProxyDMatrixSetDataColumnar
  * - @ref XGProxyDMatrixSetDataCudaColumnar
+ * - @ref XGProxyDMatrixSetDataArrow
  * - @ref XGProxyDMatrixSetDataDense
  * - @ref XGProxyDMatrixSetDataCSR
  * - ... (data setters)
@@ -469,6 +621,14 @@ XGB_EXTERN_C typedef void DataIterResetCallback(DataIterHandle handle); // NOLIN
  *   - missing:      Which value to represent missing value
  *   - cache_prefix: The path of cache file, caller must initialize all the directories in this path.
  *   - nthread (optional): Number of threads used for initializing DMatrix.
+ *   - target_page_bytes (optional): The target number of bytes of each internal page.
+ *     Small batches from the iterator are merged and large batches are split. Set to 0
+ *     (the default) to use the batches as they are. @since 3.1.0
+ *   - column_pages (optional): Write a column-major copy of the gradient index with each
+ *     page of dense data, used by the column-wise histogram kernel of `hist`. @since 3.1.0
+ *   - persistent_cache (optional): Keep the gradient index cache under `cache_prefix` after
+ *     the DMatrix is freed. A later DMatrix created from the same data and the same
+ *     `max_bin` reuses the cache instead of generating it again. @since 3.1.0
  * \param[out] out      The created external memory DMatrix
  *
  * \return 0 when success, -1 when failure happens
@@ -509,6 +669,15 @@ XGB_DLL int XGDMatrixCreateFromCallback(DataIterHandle iter, DMatrixHandle proxy
  *       help bound the memory usage. By default, XGBoost grows new sub-streams
  *       exponentially until batches are exhausted. Only used for the training dataset and
  *       the default is None (unbounded).
+ *   - single_pass (optional): Iterate through the batches only once. The batches are
+ *       copied into a compact host buffer which is released after construction. Trades
+ *       peak memory for fewer calls to the iterator. Only used by CPU, the default is
+ *       false. @since 3.1.0
+ *   - sketch_sample_eps (optional): Sketch a uniform sample of the rows instead of all of
+ *       them. The sample is sized such that its rank error is bounded by this fraction of
+ *       the bin width (`1 / max_bin`) with a probability of 0.999, and no sample is taken
+ *       for data smaller than that. Valid range is (0, 1], the default is 0 to sketch all
+ *       the rows. Only used by CPU. @since 3.1.0
  * @param out      The created Quantile DMatrix.
  *
  * @return 0 when success, -1 when failure happens
@@ -546,6 +715,16 @@ XGB_DLL int XGQuantileDMatrixCreateFromCallback(DataIterHandle iter, DMatrixHand
  *       help bound the memory usage. By default, XGBoost grows new sub-streams
  *       exponentially until batches are exhausted. Only used for the training dataset and
  *       the default is None (unbounded).
+ *   - max_host_cache_bytes (optional): For CPU-based inputs with `on_host` set to true, the
+ *       maximum number of bytes of the compressed pages kept in the host memory. Pages
+ *       beyond this budget are spilled to the cache file. The default is 0, all pages are
+ *       stored in the cache file. @since 3.1.0
+ *   - column_pages (optional): For CPU-based inputs, write a column-major copy of the
+ *       gradient index with each page of dense data, used by the column-wise histogram
+ *       kernel of `hist`. @since 3.1.0
+ *   - sketch_sample_eps (optional): For CPU-based inputs, sketch a uniform sample of the
+ *       rows instead of all of them. See @ref XGQuantileDMatrixCreateFromCallback.
+ *       @since 3.1.0
  * @param out The created Quantile DMatrix.
  *
  * @return 0 when success, -1 when failure happens
@@ -577,6 +756,20 @@ XGB_DLL int XGProxyDMatrixSetDataCudaArrayInterface(DMatrixHandle handle, const
  */
 XGB_DLL int XGProxyDMatrixSetDataColumnar(DMatrixHandle handle, char const *data);
 
+/**
+ * @brief Set an Arrow record batch on a DMatrix proxy.
+ *
+ * @since 3.1.0
+ *
+ * @param handle A DMatrix proxy created by @ref XGProxyDMatrixCreate
+ * @param array  See @ref XGDMatrixCreateFromArrow for details. The record batch must be
+ *               kept alive until the next call to the `next` callback.
+ * @param schema See @ref XGDMatrixCreateFromArrow for details.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGProxyDMatrixSetDataArrow(DMatrixHandle handle, void *array, void *schema);
+
 /**
  * @brief Set CUDA-based columnar (table) data on a DMatrix proxy.
  *
@@ -641,6 +834,22 @@ XGB_DLL int XGDMatrixSliceDMatrixEx(DMatrixHandle handle,
                                     bst_ulong len,
                                     DMatrixHandle *out,
                                     int allow_groups);
+/**
+ * @brief Append the rows of a DMatrix to another one.
+ *
+ * The existing quantile cuts are reused for the hist tree method and only the new rows are
+ * quantised, which makes it suitable for continued training with new data. The cuts are
+ * not updated, new values outside of the existing range fall into the first or the last
+ * bin of their features.
+ *
+ * @since 3.1.0
+ *
+ * @param handle A `DMatrix` or a `QuantileDMatrix` to be extended.
+ * @param that   The `DMatrix` with new rows, it must have the same number of columns.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGDMatrixAppend(DMatrixHandle handle, DMatrixHandle that);
 /*!
  * \brief free space in data matrix
  * \return 0 when success, -1 when failure happens
@@ -922,6 +1131,27 @@ XGB_DLL int XGBoosterFree(BoosterHandle handle);
  */
 XGB_DLL int XGBoosterReset(BoosterHandle handle);
 
+/**
+ * @brief Switch the booster into the read-only inference mode.
+ *
+ * After the call, prediction functions only read the model and write into thread-local or
+ * caller-owned buffers, multiple threads can share one booster for inference without
+ * contention. The output of a prediction function is valid until the next prediction on
+ * the same thread. Functions that modify the booster, like training, setting parameters
+ * or attributes, and loading a model, return an error. The data caches used for training
+ * are released. The mode can not be reverted, copy the booster through serialization if
+ * modification is needed. Only tree boosters are supported.
+ *
+ * @note This function itself is not thread-safe, call it before sharing the booster.
+ *
+ * @since 3.1.0
+ *
+ * @param handle Booster handle.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGBoosterFreeze(BoosterHandle handle);
+
 /*!
  * \brief Slice a model using boosting index. The slice m:n indicates taking all trees
  *        that were fit during the boosting rounds m, (m+1), (m+2), ..., (n-1).
@@ -939,6 +1169,23 @@ XGB_DLL int XGBoosterSlice(BoosterHandle handle, int begin_layer,
                            int end_layer, int step,
                            BoosterHandle *out);
 
+/**
+ * @brief Append the boosting rounds of another model, the counterpart of @ref
+ *        XGBoosterSlice. The trees of the other model are copied and its attributes take
+ *        precedence.
+ *
+ *   This can be used to merge incremental checkpoints, where each segment contains only
+ *   the trees added since the previous checkpoint. Only the `gbtree` booster is supported.
+ *
+ * @since 3.1.0
+ *
+ * @param handle Booster to be extended.
+ * @param other  Booster trained with the same parameters.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGBoosterAppend(BoosterHandle handle, BoosterHandle other);
+
 /*!
  * \brief Get number of boosted rounds from gradient booster.  When process_type is
  *        update, this number might drop due to removed tree.
@@ -1009,6 +1256,43 @@ XGB_DLL int XGBoosterBoostOneIter(BoosterHandle handle, DMatrixHandle dtrain, fl
 XGB_DLL int XGBoosterTrainOneIter(BoosterHandle handle, DMatrixHandle dtrain, int iter,
                                   char const *grad, char const *hess);
 
+/**
+ * @brief Get a writable view of the gradient buffer owned by the booster. Along with
+ *        @ref XGBoosterTrainOneIterWithGradientBuffer, this is used for training with a
+ *        custom objective function without copying the gradient.
+ *
+ *   The buffer is a float32 array with the shape (n_samples, n_targets, 2), the last
+ *   dimension stores the gradient and the Hessian. It's placed on the device of the
+ *   booster, with a __cuda_array_interface__ for a CUDA device. The buffer is invalidated
+ *   by any other call to the booster, it should be obtained again in each iteration.
+ *
+ * @since 3.1.0
+ *
+ * @param handle handle
+ * @param dtrain The training data.
+ * @param out    Json encoded __(cuda)_array_interface__ for the gradient buffer.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGBoosterGetGradientBuffer(BoosterHandle handle, DMatrixHandle dtrain,
+                                       char const **out);
+
+/**
+ * @brief Update a model with the gradient written into the buffer returned by @ref
+ *        XGBoosterGetGradientBuffer.
+ *
+ * @since 3.1.0
+ *
+ * @param handle handle
+ * @param dtrain The training data, same as the one used to obtain the buffer.
+ * @param iter   The current iteration round. When training continuation is used, the count
+ *               should restart.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGBoosterTrainOneIterWithGradientBuffer(BoosterHandle handle, DMatrixHandle dtrain,
+                                                    int iter);
+
 /*!
  * \brief get evaluation statistics for xgboost
  * \param handle handle
@@ -1021,6 +1305,124 @@ XGB_DLL int XGBoosterTrainOneIter(BoosterHandle handle, DMatrixHandle dtrain, in
  */
 XGB_DLL int XGBoosterEvalOneIter(BoosterHandle handle, int iter, DMatrixHandle dmats[],
                                  const char *evnames[], bst_ulong len, const char **out_result);
+
+/**
+ * @brief Wait for the asynchronous evaluation started by the last call to @ref
+ *        XGBoosterEvalOneIter, used when the `async_eval` parameter is set.
+ *
+ * @since 3.1.0
+ *
+ * @param handle     Booster handle.
+ * @param out_result The evaluation result, an empty string if there's no evaluation in
+ *                   flight.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGBoosterEvalPending(BoosterHandle handle, const char **out_result);
+
+/*! \brief handle to a training running in the background */
+typedef void *AsyncTrainHandle;  // NOLINT(*)
+
+/**
+ * @brief Callback of @ref XGBoosterTrainAsync, invoked by the training thread after each
+ *        boosting round.
+ *
+ * @param iter        Iteration of the finished round.
+ * @param eval_result Evaluation result of the round, see @ref XGBoosterEvalOneIter. An empty
+ *                    string if there's no evaluation dataset. Valid only during the call.
+ * @param user_data   The pointer passed to @ref XGBoosterTrainAsync.
+ *
+ * @return Non-zero to stop the training after this round, 0 to continue.
+ */
+XGB_EXTERN_C typedef int XGAsyncTrainCallback(int iter, char const *eval_result,  // NOLINT(*)
+                                              void *user_data);
+
+/**
+ * @brief Start training for a number of boosting rounds in a background thread.
+ *
+ * This is for callers that can't block in the training, like event loops. The booster
+ * must not be used by other functions until the training has finished, except after
+ * @ref XGAsyncTrainPause returns. Boosting continues from the existing rounds of the
+ * booster.
+ *
+ * @since 3.1.0
+ *
+ * @param handle    Booster handle.
+ * @param dtrain    The training data.
+ * @param dmats     Data for evaluation after each round, can be NULL when `len` is 0.
+ * @param evnames   Name of each evaluation data.
+ * @param len       Number of evaluation data.
+ * @param n_rounds  Number of boosting rounds.
+ * @param callback  Optional (NULL if not needed) callback for reporting the progress.
+ * @param user_data Pointer passed to the callback.
+ * @param out       The created handle, must be freed by @ref XGAsyncTrainFree.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGBoosterTrainAsync(BoosterHandle handle, DMatrixHandle dtrain, DMatrixHandle dmats[],
+                                char const *evnames[], bst_ulong len, int n_rounds,
+                                XGAsyncTrainCallback *callback, void *user_data,
+                                AsyncTrainHandle *out);
+/**
+ * @brief Pause the training, blocks until the training thread is parked.
+ *
+ * The training is parked between the levels of a tree for the hist and approx tree
+ * methods, or between boosting rounds otherwise. Once this function returns, the booster
+ * can be used for prediction by the caller until @ref XGAsyncTrainResume is called.
+ *
+ * @since 3.1.0
+ *
+ * @param handle Handle created by @ref XGBoosterTrainAsync.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGAsyncTrainPause(AsyncTrainHandle handle);
+/**
+ * @brief Resume a paused training.
+ *
+ * @since 3.1.0
+ *
+ * @param handle Handle created by @ref XGBoosterTrainAsync.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGAsyncTrainResume(AsyncTrainHandle handle);
+/**
+ * @brief Request the training to stop, returns without waiting for it.
+ *
+ * The training checks the request between the levels of a tree and between boosting
+ * rounds. The tree being built is cut at its current level and kept in the model, which
+ * remains valid.
+ *
+ * @since 3.1.0
+ *
+ * @param handle Handle created by @ref XGBoosterTrainAsync.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGAsyncTrainCancel(AsyncTrainHandle handle);
+/**
+ * @brief Wait for the training to finish.
+ *
+ * @since 3.1.0
+ *
+ * @param handle       Handle created by @ref XGBoosterTrainAsync.
+ * @param out_n_rounds Number of boosting rounds added to the model.
+ *
+ * @return 0 when success, -1 when the training has failed, the error is returned by
+ *         @ref XGBGetLastError.
+ */
+XGB_DLL int XGAsyncTrainWait(AsyncTrainHandle handle, int *out_n_rounds);
+/**
+ * @brief Cancel the training if it's still running, wait for it, and free the handle.
+ *
+ * @since 3.1.0
+ *
+ * @param handle Handle created by @ref XGBoosterTrainAsync.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGAsyncTrainFree(AsyncTrainHandle handle);
 /**
  * @example c-api-demo.c
  */
@@ -1105,6 +1507,16 @@ XGB_DLL int XGBoosterPredict(BoosterHandle handle,
  *      normal/margin/contrib/interaction predict will output consistent shape
  *      disregarding the use of multi-class model, and leaf prediction will output 4-dim
  *      array representing: (n_samples, n_iterations, n_classes, n_trees_in_forest)
+ *    "output_mask": int (optional, since 3.1.0)
+ *      Request multiple outputs from a single traversal of the trees, as a bitmask of
+ *      `1 << type`. Supported masks are normal or margin prediction combined with leaf
+ *      prediction, like `(1 << 1) | (1 << 6)`. When set, `type` and `strict_shape` are
+ *      ignored, and the output is a 2-dim array with shape (n_samples, n_groups + n_trees).
+ *      Each row holds the predictions of the groups followed by the leaf indices.
+ *    "nthread": int (optional, since 3.1.0)
+ *      Number of threads used by this call only, 0 to use the `nthread` of the booster.
+ *      Unlike @ref XGBoosterSetParam, the booster is not reconfigured and the calls from
+ *      other threads are not affected.
  *
  *   Example JSON input for running a normal prediction with strict output shape, 2 dim
  *   for softprob , 1 dim for others.
@@ -1261,6 +1673,116 @@ XGB_DLL int XGBoosterPredictFromCudaColumnar(BoosterHandle handle, char const *d
                                              bst_ulong const **out_shape, bst_ulong *out_dim,
                                              const float **out_result);
 
+/*! \brief handle to a prepared prediction */
+typedef void *PredictHandle;  // NOLINT(*)
+
+/**
+ * @brief Create a prepared prediction for low latency inference with CPU dense data.
+ *
+ * The configuration is parsed once and the output buffer is reused across calls to @ref
+ * XGBoosterPredictWithHandle. It's intended for serving a few samples at a time where
+ * the overhead of the array interface and the proxy DMatrix dominates.
+ *
+ * @note The handle is not thread-safe, create one handle for each thread. The handle
+ *       must be freed by @ref XGPredictHandleFree before the booster is freed. Changing
+ *       the booster after the handle is created, like training or loading a model, is
+ *       not supported.
+ *
+ * @param handle       Booster handle.
+ * @param config       JSON encoded configuration with the following fields:
+ *   - "type": int, 0 for normal prediction and 1 for output margin.
+ *   - "missing": float
+ *   - "iteration_begin": int
+ *   - "iteration_end": int
+ *   - "nthread": int (optional), see @ref XGBoosterPredictFromDMatrix.
+ * @param out          The created prediction handle.
+ * @param out_row_size Number of output values for each row.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGBoosterCreatePredictHandle(BoosterHandle handle, char const *config,
+                                         PredictHandle *out, bst_ulong *out_row_size);
+
+/**
+ * @brief Run prediction with a prepared handle.
+ *
+ * @param handle     Handle created by @ref XGBoosterCreatePredictHandle.
+ * @param data       Pointer to a row-major dense matrix of float, with the same number of
+ *                   features as the booster.
+ * @param n_rows     Number of rows in the data.
+ * @param out_result Caller-owned buffer with size `n_rows * out_row_size`.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGBoosterPredictWithHandle(PredictHandle handle, float const *data, bst_ulong n_rows,
+                                       float *out_result);
+
+/**
+ * @brief Run prediction with multiple prepared handles on the same data.
+ *
+ * This is intended for serving several boosters, like models for different targets, with
+ * the same batch of samples. The input is converted once for each block of rows and used
+ * by the trees of all the boosters, instead of being processed again by each booster.
+ *
+ * @note All handles must use the same missing value and the boosters must be tree models
+ *       with the same number of features. The `nthread` of the first handle is used.
+ *
+ * @since 3.1.0
+ *
+ * @param handles     Handles created by @ref XGBoosterCreatePredictHandle.
+ * @param n_handles   Number of handles.
+ * @param data        Pointer to a row-major dense matrix of float, with the same number of
+ *                    features as the boosters.
+ * @param n_rows      Number of rows in the data.
+ * @param out_results Caller-owned buffers, one for each handle, the i^th buffer has size
+ *                    `n_rows * out_row_size` of the i^th handle.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGBoosterPredictWithHandles(PredictHandle const *handles, bst_ulong n_handles,
+                                        float const *data, bst_ulong n_rows,
+                                        float *const *out_results);
+
+/**
+ * @brief Free a prepared prediction handle.
+ *
+ * @param handle Handle created by @ref XGBoosterCreatePredictHandle.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGPredictHandleFree(PredictHandle handle);
+
+/**
+ * @brief Cascade prediction with early exit for models with a single output, like binary
+ *        classification and ranking.
+ *
+ * Trees are evaluated in stages that end at the checkpoints. Once a stage is done, rows
+ * with a partial margin less than the threshold of the checkpoint are not evaluated by
+ * the remaining trees, and their output is formed by the evaluated trees only. Rows that
+ * are evaluated by the full model are marked in out_finished. Only the CPU is supported.
+ *
+ * @since 3.1.0
+ *
+ * @param handle       Booster handle.
+ * @param dmat         DMatrix handle. For inplace prediction, pass a proxy DMatrix created
+ *                     by @ref XGProxyDMatrixCreate with the data set.
+ * @param config       JSON encoded configuration with the following fields:
+ *   - "type": int, 0 for normal prediction and 1 for output margin.
+ *   - "iteration_begin": int
+ *   - "iteration_end": int
+ *   - "checkpoints": list of int, increasing iterations in (iteration_begin, iteration_end).
+ *   - "thresholds": list of float, margin cutoff for each checkpoint.
+ *   - "missing": float, optional, only used for the proxy DMatrix.
+ * @param out_len      Number of rows.
+ * @param out_result   Prediction for each row.
+ * @param out_finished 1 if a row is evaluated by all trees, 0 otherwise.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGBoosterPredictCascade(BoosterHandle handle, DMatrixHandle dmat, char const *config,
+                                    bst_ulong *out_len, float const **out_result,
+                                    uint8_t const **out_finished);
+
 /**@}*/  // End of Prediction
 
 
@@ -1294,15 +1816,69 @@ XGB_DLL int XGBoosterPredictFromCudaColumnar(BoosterHandle handle, char const *d
 /*!
  * \brief Load model from existing file
  *
+ * The format is chosen by the file extension. Files with the `mmap` extension are mapped
+ * into memory and the trees are copied without parsing, which requires a local file.
+ *
  * \param handle handle
  * \param fname File URI or file name. The string must be UTF-8 encoded.
  * \return 0 when success, -1 when failure happens
  */
 XGB_DLL int XGBoosterLoadModel(BoosterHandle handle,
                                const char *fname);
+/**
+ * @brief Load a model saved with the `mmap` extension without loading the trees. The
+ *        trees are loaded by pages of boosted layers when they are needed for prediction
+ *        and the loaded pages are kept under a memory budget. Only the normal prediction
+ *        is supported by the loaded model.
+ *
+ * @since 3.1.0
+ *
+ * @param handle The booster handle.
+ * @param fname  The path to a local model file. The string must be UTF-8 encoded.
+ * @param config JSON encoded string with the following keys:
+ *   - max_bytes: Budget for the loaded trees in bytes, default to 0 for unlimited.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGBoosterLoadModelLazy(BoosterHandle handle, char const *fname, char const *config);
+/**
+ * @brief Save the margin prediction cache of the training data into a file, for continuing
+ *        the training from a checkpoint without predicting all the existing trees. Only the
+ *        `gbtree` booster is supported.
+ *
+ * @since 3.1.0
+ *
+ * @param handle The booster handle.
+ * @param dtrain The training DMatrix.
+ * @param fname  The path to a local file. The string must be UTF-8 encoded.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGBoosterSavePredictionCache(BoosterHandle handle, DMatrixHandle dtrain,
+                                         char const *fname);
+/**
+ * @brief Restore the cache saved by @ref XGBoosterSavePredictionCache. The cache is rejected
+ *        with a warning if it's saved from a different model or DMatrix, and the prediction
+ *        is recomputed in the next iteration.
+ *
+ * @since 3.1.0
+ *
+ * @param handle     The booster handle.
+ * @param dtrain     The training DMatrix.
+ * @param fname      The path to a local file. The string must be UTF-8 encoded.
+ * @param out_loaded 1 if the cache is restored, 0 otherwise.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGBoosterLoadPredictionCache(BoosterHandle handle, DMatrixHandle dtrain,
+                                         char const *fname, int *out_loaded);
 /*!
  * \brief Save model into existing file
  *
+ * The format is chosen by the file extension: `json`, `ubj`, `mmap` or `deprecated`. The
+ * `mmap` format is a binary format for fast loading in native byte order. It requires a
+ * local file and doesn't support multi-target trees.
+ *
  * \param handle handle
  * \param fname File URI or file name. The string must be UTF-8 encoded.
  * \return 0 when success, -1 when failure happens
@@ -1321,6 +1897,88 @@ XGB_DLL int XGBoosterLoadModelFromBuffer(BoosterHandle handle,
                                          const void *buf,
                                          bst_ulong len);
 
+/*! \brief handle to a slot holding the serving model, see @ref XGModelSlotCreate */
+typedef void *ModelSlotHandle;  // NOLINT(*)
+/*! \brief handle to a model pinned by a prediction, see @ref XGModelSlotAcquire */
+typedef void *ModelPinHandle;  // NOLINT(*)
+
+/**
+ * @brief Create a slot for serving a model that can be replaced without blocking the
+ *        predictions.
+ *
+ * A new model is loaded by @ref XGModelSlotLoad, usually from a background thread, while
+ * the predictions keep using the current model. The new booster is switched into the
+ * read-only inference mode (see @ref XGBoosterFreeze), and the caches of the predictor
+ * like the compiled forest and the device model are built before the booster is
+ * published with an atomic exchange. Each prediction acquires the current booster with
+ * @ref XGModelSlotAcquire, and a replaced booster is freed once all its pins are freed.
+ *
+ * @since 3.1.0
+ *
+ * @param config JSON encoded parameters set on each loaded booster, like `nthread` and
+ *               `device`. Use `{}` for the default parameters.
+ * @param out    The created slot, which is empty until a model is loaded.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGModelSlotCreate(char const *config, ModelSlotHandle *out);
+/**
+ * @brief Free a model slot. Boosters pinned by @ref XGModelSlotAcquire stay valid until
+ *        their pins are freed.
+ *
+ * @since 3.1.0
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGModelSlotFree(ModelSlotHandle handle);
+/**
+ * @brief Load a model file into a new booster and publish it in the slot. The format is
+ *        chosen by the file extension, see @ref XGBoosterLoadModel. The `mmap` format is
+ *        the fastest to load. Loads into the same slot are serialized.
+ *
+ * @since 3.1.0
+ *
+ * @param handle      The model slot.
+ * @param fname       File URI or file name. The string must be UTF-8 encoded.
+ * @param out_version Version of the published model, increased by each load.
+ *
+ * @return 0 when success, -1 when failure happens. The current model is kept on failure.
+ */
+XGB_DLL int XGModelSlotLoad(ModelSlotHandle handle, char const *fname, bst_ulong *out_version);
+/**
+ * @brief Same as @ref XGModelSlotLoad, but load the model from a buffer, see @ref
+ *        XGBoosterLoadModelFromBuffer.
+ *
+ * @since 3.1.0
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGModelSlotLoadFromBuffer(ModelSlotHandle handle, void const *buf, bst_ulong len,
+                                      bst_ulong *out_version);
+/**
+ * @brief Pin the current model of the slot for prediction. Thread-safe.
+ *
+ * @since 3.1.0
+ *
+ * @param handle      The model slot, a model must have been loaded.
+ * @param out_pin     The pin, must be freed by @ref XGModelPinFree after the prediction.
+ * @param out_booster The frozen booster, valid until the pin is freed. Only the
+ *                    prediction functions can be used with it.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGModelSlotAcquire(ModelSlotHandle handle, ModelPinHandle *out_pin,
+                               BoosterHandle *out_booster);
+/**
+ * @brief Release a model pinned by @ref XGModelSlotAcquire. The booster is freed if it has
+ *        been replaced and this is the last pin.
+ *
+ * @since 3.1.0
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGModelPinFree(ModelPinHandle handle);
+
 /*!
  * \brief Save model into raw bytes, return header of the array.  User must copy the
  *        result out, before next xgboost call
@@ -1332,6 +1990,10 @@ XGB_DLL int XGBoosterLoadModelFromBuffer(BoosterHandle handle,
  *                 - json: Output booster will be encoded as JSON.
  *                 - ubj:  Output booster will be encoded as Universal binary JSON.
  *                   this format except for compatibility reasons.
+ *               - "serving": bool, optional. Save the model for serving, without the node
+ *                 statistics of trees. The gain and cover based feature importance and the
+ *                 feature contributions are not available for the loaded model. Only
+ *                 valid for json and ubj. (Since 3.1.0)
  * \param out_len  The argument to hold the output length
  * \param out_dptr The argument to hold the output data pointer
  *
@@ -1461,6 +2123,73 @@ XGB_DLL int XGBoosterDumpModelExWithFeatures(BoosterHandle handle,
                                              bst_ulong *out_len,
                                              const char ***out_models);
 
+/**
+ * @brief Callback of @ref XGBoosterDumpModelStream, invoked once for each booster.
+ *
+ * @param idx       Index of the booster (tree).
+ * @param dump      Dump of the booster, not null-terminated. Valid only during the call.
+ * @param len       Length of the dump in bytes.
+ * @param user_data The pointer passed to @ref XGBoosterDumpModelStream.
+ *
+ * @return Non-zero to stop the dump, 0 to continue.
+ */
+XGB_EXTERN_C typedef int XGBoosterDumpCallback(bst_ulong idx, char const *dump,  // NOLINT(*)
+                                               bst_ulong len, void *user_data);
+
+/**
+ * @brief Dump the model without materializing the dump of the entire model.
+ *
+ * Trees are dumped in parallel in small chunks, and passed to the callback in order as
+ * they are generated. Only the current chunk is held in memory. The output of each tree is
+ * the same as @ref XGBoosterDumpModelEx.
+ *
+ * @since 3.1.0
+ *
+ * @param handle    An instance of Booster
+ * @param config    JSON encoded parameters:
+ *                    - fmap: Optional, name of the feature map file.
+ *                    - with_stats: Optional, whether to dump the statistics. Default false.
+ *                    - format: Optional, format of the dump. Default "text".
+ * @param callback  Callback for receiving the dump of each tree.
+ * @param user_data Pointer passed to the callback.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGBoosterDumpModelStream(BoosterHandle handle, char const *config,
+                                     XGBoosterDumpCallback *callback, void *user_data);
+
+/**
+ * @brief Generate C source code for a tree model.
+ *
+ * Each tree becomes a function of nested branches with the split conditions and leaf
+ * values compiled in as constants. Categorical splits and multi-target trees are
+ * supported. The generated code can be compiled by a C or C++ compiler into a shared
+ * object, which exports the following functions:
+ *
+ * @code
+ *   size_t xgboost_num_feature(void);
+ *   size_t xgboost_num_target(void);
+ *   void xgboost_predict_batch(float const* data, size_t n_rows, float missing, float* out);
+ * @endcode
+ *
+ * The batch function takes a row-major dense matrix with `xgboost_num_feature()` columns,
+ * and writes `n_rows * xgboost_num_target()` output margins, the same as the prediction
+ * with `output_margin`. The objective transformation is not included.
+ *
+ * @since 3.1.0
+ *
+ * @param handle  Booster handle, the dart booster is not supported.
+ * @param config  JSON encoded configuration with the following fields:
+ *   - "iteration_begin": int
+ *   - "iteration_end": int, 0 means using all iterations.
+ * @param out_len Length of the output string.
+ * @param out_str The generated source code.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGBoosterGenerateCode(BoosterHandle handle, char const *config, bst_ulong *out_len,
+                                  char const **out_str);
+
 /*!
  * \brief Get string attribute from Booster.
  * \param handle handle
@@ -1567,6 +2296,29 @@ XGB_DLL int XGBoosterFeatureScore(BoosterHandle handle, const char *config,
                                   bst_ulong *out_n_features, char const ***out_features,
                                   bst_ulong *out_dim, bst_ulong const **out_shape,
                                   float const **out_scores);
+/**
+ * @brief Calculate dense feature scores indexed by the feature, without the feature names.
+ *
+ * Unlike @ref XGBoosterFeatureScore, features without any split are included with a score
+ * of 0, the output for tree models has the shape [n_features]. For linear models, the
+ * output is the same as @ref XGBoosterFeatureScore. For tree models, the split
+ * statistics are maintained as trees are added to the model, querying the scores for all
+ * trees doesn't walk through the trees.
+ *
+ * @since 3.1.0
+ *
+ * @param handle     An instance of Booster
+ * @param config     Parameters encoded as JSON, with the same `importance_type` and
+ *                   `tree_idx` as @ref XGBoosterFeatureScore.
+ * @param out_dim    Dimension of output feature scores.
+ * @param out_shape  Shape of output feature scores with length of `out_dim`.
+ * @param out_scores An array of floating point as feature scores with shape of `out_shape`.
+ *
+ * @return 0 when success, -1 when failure happens
+ */
+XGB_DLL int XGBoosterFeatureImportance(BoosterHandle handle, char const *config,
+                                       bst_ulong *out_dim, bst_ulong const **out_shape,
+                                       float const **out_scores);
 /**@}*/  // End of Booster
 
 /**
@@ -1627,6 +2379,11 @@ typedef void *TrackerHandle; /* NOLINT */
  *   - sortby: (Optional) Integer.
  *     + 0: Sort workers by their host name.
  *     + 1: Sort workers by task IDs.
+ *   - min_workers: (Optional) Integer, the minimum number of workers for elastic restart. After
+ *                  an error, the tracker forms a smaller group if the lost workers are not
+ *                  replaced in time. Defaults to `n_workers`, which disables elastic restart.
+ *   - elastic_timeout: (Optional) Integer, seconds to wait for the replacement workers before
+ *                      forming a smaller group. Defaults to 60.
  *
  *   Some `federated` specific configurations:
  *   - federated_secure: Boolean, whether this is a secure server. False for testing.
@@ -1707,6 +2464,9 @@ XGB_DLL int XGTrackerFree(TrackerHandle handle);
  *   - dmlc_retry: The number of retries for connection failure.
  *   - dmlc_timeout: Timeout in seconds.
  *   - dmlc_nccl_path: Path to the nccl shared library `libnccl.so`.
+ *   - dmlc_shared_memory: Use shared memory when all workers are on the same host.
+ *   - dmlc_tcp_streams: The number of TCP connections between each pair of workers, large
+ *                       messages are split across them. Defaults to 1.
  *
  * Only applicable to the `federated` communicator (use upper case for environment variables, use
  * lower case for runtime configuration):
@@ -1770,6 +2530,43 @@ XGB_DLL int XGCommunicatorPrint(char const *message);
  */
 XGB_DLL int XGCommunicatorGetProcessorName(const char** name_str);
 
+/**
+ * @brief Get the statistics of the collective calls made by the current worker.
+ *
+ * The statistics are grouped by the operation and the source location of the call, with
+ * the number of calls, the size of the data, the bytes sent to and received from the
+ * peers, the wall time, the time spent waiting for the peers and the algorithm used. The
+ * `worker_load` key holds the number of rows and the local time of updating the trees in
+ * row-split training with the `hist` tree method.
+ *
+ * @param config JSON encoded configuration. Accepted JSON keys are:
+ *   - reset: Clear the statistics after they are returned. Defaults to false.
+ * @param out JSON encoded statistics.
+ * @return 0 for success, -1 for failure.
+ */
+XGB_DLL int XGCommunicatorGetStats(char const *config, char const **out);
+
+/**
+ * @brief Plan the migration of training rows between the workers in row-split training,
+ *        for the slow workers to stop holding the synchronization of the histograms.
+ *
+ * The speed of each worker is measured by the `worker_load` in the statistics returned by
+ * @ref XGCommunicatorGetStats, which is recorded by the `hist` tree method. The loads are
+ * gathered from all workers and every worker obtains the same plan. The rows are not moved
+ * by XGBoost, re-partition the data according to the plan and continue the training from a
+ * checkpoint. This is a collective call and should be made at an iteration boundary.
+ *
+ * @since 3.1.0
+ *
+ * @param config JSON encoded configuration. Accepted JSON keys are:
+ *   - tolerance: No transfer is planned if the build time of the slowest worker is within
+ *     `1 + tolerance` of the mean. Defaults to 0.1.
+ * @param out JSON encoded object with the `loads` of all workers and the `transfers`, each
+ *            transfer has the `src` rank, the `dst` rank and the `n_rows` to be moved.
+ * @return 0 for success, -1 for failure.
+ */
+XGB_DLL int XGCommunicatorPlanRebalance(char const *config, char const **out);
+
 /**
  * @brief Broadcast a memory region to all others from root. This function is NOT
  *        thread-safe.
@@ -27,6 +27,7 @@
 #endif  // defined(_WIN32)
 
 #include <chrono>
+#include <cstdint>
 #include <cstring>
 #include <string>
 #include <system_error>  // make_error_code, errc
@@ -37,6 +38,10 @@
 
 #include <poll.h>
 
+#if defined(__linux__)
+#include <sys/epoll.h>
+#endif  // defined(__linux__)
+
 using SOCKET = int;
 using sock_size_t = size_t;  // NOLINT
 #endif  // !defined(_WIN32)
@@ -224,6 +229,147 @@ struct PollHelper {
 
   std::unordered_map<SOCKET, pollfd> fds;
 };
+
+#if defined(__linux__)
+/**
+ * @brief Same as the @ref PollHelper, but backed by epoll for long-running event loops.
+ *
+ *   The descriptors stay registered across rounds, a round only issues `epoll_ctl` for
+ *   descriptors whose events have changed. Call @ref Clear at the beginning of each round
+ *   before watching the descriptors of that round.
+ */
+class EPollHelper {
+  SOCKET epfd_{-1};
+  // The events registered in epoll.
+  std::unordered_map<SOCKET, std::uint32_t> registered_;
+  // The events watched in this round.
+  std::unordered_map<SOCKET, std::uint32_t> watched_;
+  // The ready events after poll.
+  std::unordered_map<SOCKET, std::uint32_t> ready_;
+  std::vector<epoll_event> events_;
+
+  [[nodiscard]] xgboost::collective::Result Register(SOCKET fd, std::uint32_t events) {
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.fd = fd;
+    auto it = registered_.find(fd);
+    auto rc = epoll_ctl(epfd_, it == registered_.cend() ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &ev);
+    // The descriptor might have been closed and the number reused, which removes it from
+    // epoll, or registered by a previous instance of the closed descriptor.
+    if (rc != 0 && errno == ENOENT) {
+      rc = epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev);
+    } else if (rc != 0 && errno == EEXIST) {
+      rc = epoll_ctl(epfd_, EPOLL_CTL_MOD, fd, &ev);
+    }
+    if (rc != 0) {
+      registered_.erase(fd);
+      return xgboost::system::FailWithCode("Failed to register the socket for epoll.");
+    }
+    registered_[fd] = events;
+    return xgboost::collective::Success();
+  }
+
+ public:
+  EPollHelper() = default;
+  EPollHelper(EPollHelper const& that) = delete;
+  EPollHelper& operator=(EPollHelper const& that) = delete;
+  ~EPollHelper() {
+    if (epfd_ >= 0) {
+      close(epfd_);
+    }
+  }
+
+  void Clear() {
+    watched_.clear();
+    ready_.clear();
+  }
+  void WatchRead(SOCKET fd) { watched_[fd] |= EPOLLIN; }
+  void WatchRead(xgboost::collective::TCPSocket const& socket) {
+    this->WatchRead(socket.Handle());
+  }
+  void WatchWrite(SOCKET fd) { watched_[fd] |= EPOLLOUT; }
+  void WatchWrite(xgboost::collective::TCPSocket const& socket) {
+    this->WatchWrite(socket.Handle());
+  }
+  [[nodiscard]] bool CheckRead(SOCKET fd) const {
+    auto it = ready_.find(fd);
+    return it != ready_.cend() && (it->second & EPOLLIN) != 0;
+  }
+  [[nodiscard]] bool CheckRead(xgboost::collective::TCPSocket const& socket) const {
+    return this->CheckRead(socket.Handle());
+  }
+  [[nodiscard]] bool CheckWrite(SOCKET fd) const {
+    auto it = ready_.find(fd);
+    return it != ready_.cend() && (it->second & EPOLLOUT) != 0;
+  }
+  [[nodiscard]] bool CheckWrite(xgboost::collective::TCPSocket const& socket) const {
+    return this->CheckWrite(socket.Handle());
+  }
+  [[nodiscard]] bool Empty() const { return watched_.empty(); }
+  /**
+   * @brief Wait for the watched descriptors.
+   *
+   * @param timeout specify timeout in seconds. Block if negative.
+   */
+  [[nodiscard]] xgboost::collective::Result Poll(std::chrono::seconds timeout,
+                                                 bool check_error = true) {
+    if (epfd_ < 0) {
+      epfd_ = epoll_create1(EPOLL_CLOEXEC);
+      if (epfd_ < 0) {
+        return xgboost::system::FailWithCode("Failed to create epoll.");
+      }
+    }
+    for (auto const& kv : watched_) {
+      auto it = registered_.find(kv.first);
+      if (it != registered_.cend() && it->second == kv.second) {
+        continue;
+      }
+      auto rc = this->Register(kv.first, kv.second);
+      if (!rc.OK()) {
+        return rc;
+      }
+    }
+    // Stop watching descriptors that are not used in this round, errors are ignored as
+    // the descriptor might have been closed.
+    for (auto it = registered_.begin(); it != registered_.end();) {
+      if (it->second == 0 || watched_.find(it->first) != watched_.cend()) {
+        ++it;
+        continue;
+      }
+      epoll_event ev{};
+      ev.data.fd = it->first;
+      if (epoll_ctl(epfd_, EPOLL_CTL_MOD, it->first, &ev) != 0) {
+        it = registered_.erase(it);
+      } else {
+        it->second = 0;
+        ++it;
+      }
+    }
+
+    events_.resize(watched_.size());
+    auto ms = timeout.count() < 0 ? -1 : std::chrono::milliseconds(timeout).count();
+    std::int32_t ret = epoll_wait(epfd_, events_.data(), events_.size(), ms);
+    if (ret == 0) {
+      return xgboost::collective::Fail(
+          "Poll timeout:" + std::to_string(timeout.count()) + " seconds.",
+          std::make_error_code(std::errc::timed_out));
+    } else if (ret < 0) {
+      return xgboost::system::FailWithCode("Poll failed, nfds:" +
+                                           std::to_string(watched_.size()));
+    }
+    for (std::int32_t i = 0; i < ret; ++i) {
+      auto const& ev = events_[i];
+      // The epoll flags have the same values as the poll flags.
+      auto result = PollError(ev.events);
+      if (check_error && !result.OK()) {
+        return result;
+      }
+      ready_[ev.data.fd] = ev.events & watched_[ev.data.fd];
+    }
+    return xgboost::collective::Success();
+  }
+};
+#endif  // defined(__linux__)
 }  // namespace utils
 }  // namespace rabit
 
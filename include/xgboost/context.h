@@ -172,7 +172,8 @@ struct Context : public XGBoostParameter<Context> {
   void ConfigureGpuId(bool require_gpu);
   /**
    * @brief Returns the automatically chosen number of threads based on the `nthread`
-   *        parameter and the system settting.
+   *        parameter and the system settting. The `nthread` is replaced by the @ref
+   *        ScopedThreads of the calling thread if there's one.
    */
   [[nodiscard]] std::int32_t Threads() const;
   /**
@@ -310,6 +311,26 @@ struct Context : public XGBoostParameter<Context> {
   // cached value for CFS CPU limit. (used in containerized env)
   std::int32_t cfs_cpu_count_;  // NOLINT
 };
+
+/**
+ * @brief Override the `nthread` of every @ref Context used by the current thread over the
+ *        lifetime of this object, without changing the contexts. Used for setting the
+ *        number of threads of a single call, like a prediction request, without
+ *        configuring the learner shared by other threads.
+ */
+class ScopedThreads {
+  std::int32_t prev_;
+
+ public:
+  /**
+   * @param n_threads The number of threads, 0 to use the `nthread` of the context.
+   */
+  explicit ScopedThreads(std::int32_t n_threads);
+  ~ScopedThreads();
+
+  ScopedThreads(ScopedThreads const& that) = delete;
+  ScopedThreads& operator=(ScopedThreads const& that) = delete;
+};
 }  // namespace xgboost
 
 #endif  // XGBOOST_CONTEXT_H_
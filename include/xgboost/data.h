@@ -276,6 +276,11 @@ struct BatchParam {
    * @brief The number of batches to pre-fetch for external memory.
    */
   std::int32_t n_prefetch_batches{3};
+  /**
+   * @brief Memory budget in bytes for the pre-fetched batches, 0 for no limit. At least
+   *        one batch is fetched regardless of the budget.
+   */
+  std::int64_t n_prefetch_bytes{0};
 
   /**
    * @brief Exact or others that don't need histogram.
@@ -527,6 +532,22 @@ struct ExtMemConfig {
   std::int64_t max_num_device_pages{0};
   // The number of CPU threads.
   std::int32_t n_threads{0};
+  // Target number of bytes of each page for the DMatrix. Small batches from the iterator
+  // are merged, and large batches are split. 0 to use the batches as they are.
+  std::int64_t target_page_bytes{0};
+  // Maximum number of bytes of the CPU gradient index pages kept in the host memory when
+  // `on_host` is true, pages beyond this are spilled to the cache file. Only used for
+  // CPU-based ExtMemQdm.
+  std::int64_t max_host_cache_bytes{0};
+  // Whether the CPU gradient index pages of dense data are written with a column-major copy
+  // of the index for the column-wise histogram kernel and partitioner of `hist`.
+  bool column_pages{false};
+  // Whether the cache is kept on disk for reuse by the DMatrix created from the same data
+  // in later runs.
+  bool persistent{false};
+  // Rank error of the row sample used for sketching, relative to the width of a bin. 0 to
+  // sketch all the rows. Only used for CPU-based ExtMemQdm.
+  double sketch_sample_eps{0};
 
   ExtMemConfig() = default;
   ExtMemConfig(std::string cache, bool on_host, std::int64_t min_cache, float missing,
@@ -638,6 +659,11 @@ class DMatrix {
    * @param missing Value that should be treated as missing.
    * @param nthread number of threads used for initialization.
    * @param max_bin Maximum number of bins.
+   * @param single_pass Iterate through the data only once by buffering the batches in
+   *                    memory, for iterators that are expensive to run. CPU only.
+   * @param sketch_sample_eps Sketch a uniform row sample instead of all the rows, with the
+   *                          rank error of the sample bounded by this fraction of the bin
+   *                          width. 0 to disable. CPU only.
    *
    * @return A created quantile based DMatrix.
    */
@@ -645,7 +671,8 @@ class DMatrix {
             typename XGDMatrixCallbackNext>
   static DMatrix* Create(DataIterHandle iter, DMatrixHandle proxy, std::shared_ptr<DMatrix> ref,
                          DataIterResetCallback* reset, XGDMatrixCallbackNext* next, float missing,
-                         std::int32_t nthread, bst_bin_t max_bin, std::int64_t max_quantile_blocks);
+                         std::int32_t nthread, bst_bin_t max_bin, std::int64_t max_quantile_blocks,
+                         bool single_pass = false, double sketch_sample_eps = 0.0);
 
   /**
    * @brief Create an external memory DMatrix with callbacks.
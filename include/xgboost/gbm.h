@@ -14,6 +14,7 @@
 #include <xgboost/host_device_vector.h>
 #include <xgboost/model.h>
 
+#include <cstdint>  // for uint8_t
 #include <vector>
 #include <string>
 #include <functional>
@@ -24,10 +25,17 @@ namespace xgboost {
 class Json;
 class FeatureMap;
 class ObjFunction;
+class RegTree;
+class RowGradient;
 
 struct Context;
 struct LearnerModelParam;
 struct PredictionCacheEntry;
+struct DenseModelSlice;
+
+namespace gbm {
+class TreePager;
+}  // namespace gbm
 
 /*!
  * \brief interface of gradient boosting model.
@@ -57,6 +65,42 @@ class GradientBooster : public Model, public Configurable {
    * \param fo output stream
    */
   virtual void Save(dmlc::Stream* fo) const = 0;
+  /**
+   * @brief Load the model from a document where the trees have been loaded separately by
+   *        the streaming UBJSON reader. The booster takes the ownership of the trees.
+   *
+   * @param in    The model document, with empty tree arrays.
+   * @param trees Trees indexed by the tree id.
+   */
+  virtual void LoadStreamedModel(Json const& in, std::vector<std::unique_ptr<RegTree>>&& trees) {
+    CHECK(trees.empty()) << "Found trees in a model for booster without trees.";
+    this->LoadModel(in);
+  }
+  /**
+   * @brief Save the model without serializing the trees, the counterpart of
+   *        @ref LoadStreamedModel.
+   *
+   * @param out   The model document, with empty tree arrays.
+   * @param trees Trees indexed by the tree id.
+   */
+  virtual void SaveStreamedModel(Json* out, std::vector<RegTree const*>* /*trees*/) const {
+    this->SaveModel(out);
+  }
+  /**
+   * @brief Save the model for serving, leaving out the information that is only used by
+   *        training and model inspection.
+   */
+  virtual void SaveServingModel(Json* out) const { this->SaveModel(out); }
+  /**
+   * @brief Load the model from a document without trees, the trees are loaded on demand
+   *        from a mmap model by `pager`.
+   *
+   * @param in    The model document, with empty tree arrays.
+   * @param pager Loader for the trees.
+   */
+  virtual void LoadLazyModel(Json const& /*in*/, std::shared_ptr<gbm::TreePager> /*pager*/) {
+    LOG(FATAL) << "Lazy loading is not supported by the current booster.";
+  }
   /**
    * \brief Slice a model using boosting index. The slice m:n indicates taking all trees
    *        that were fit during the boosting rounds m, (m+1), (m+2), ..., (n-1).
@@ -68,6 +112,15 @@ class GradientBooster : public Model, public Configurable {
                      GradientBooster* /*out*/, bool* /*out_of_bound*/) const {
     LOG(FATAL) << "Slice is not supported by the current booster.";
   }
+  /**
+   * @brief Append the boosted rounds of another model, the counterpart of @ref Slice. The
+   *        trees are copied.
+   *
+   * @param that A booster of the same type, trained with the same model parameters.
+   */
+  virtual void Append(GradientBooster const* /*that*/) {
+    LOG(FATAL) << "Append is not supported by the current booster.";
+  }
   /**
    * @brief Return number of boosted rounds.
    */
@@ -88,6 +141,16 @@ class GradientBooster : public Model, public Configurable {
    */
   virtual void DoBoost(DMatrix* p_fmat, linalg::Matrix<GradientPair>* in_gpair,
                        PredictionCacheEntry*, ObjFunction const* obj) = 0;
+  /**
+   * @brief Request the next @ref DoBoost to compute the gradient on demand, with the
+   *        gradient matrix passed to it left uninitialized.
+   *
+   * @param fn The on demand gradient, must outlive the next @ref DoBoost.
+   *
+   * @return Whether the booster accepts the request. The gradient must be computed
+   *         before calling @ref DoBoost if it returns false.
+   */
+  virtual bool FuseGradient(RowGradient const* /*fn*/) { return false; }
 
   /**
    * \brief Generate predictions for given feature matrix
@@ -115,6 +178,51 @@ class GradientBooster : public Model, public Configurable {
                               bst_layer_t) const {
     LOG(FATAL) << "Inplace predict is not supported by the current booster.";
   }
+  /**
+   * \brief Predict a row-major dense matrix on CPU, see Predictor::PredictDense.
+   *
+   * \param           data      Row-major dense matrix.
+   * \param           n_rows    Number of rows in data.
+   * \param           missing   Missing value in the data.
+   * \param           begin     Beginning of boosted tree layer used for prediction.
+   * \param           end       End of booster layer. 0 means do not limit trees.
+   * \param [in,out]  out_preds The output preds, resized to (n_rows, n_groups).
+   */
+  virtual void PredictDense(float const*, bst_idx_t, float, bst_layer_t, bst_layer_t,
+                            HostDeviceVector<float>*) const {
+    LOG(FATAL) << "Dense predict is not supported by the current booster.";
+  }
+  /**
+   * \brief Prepare this booster for predicting a dense matrix along with other boosters,
+   *        see Predictor::PredictDenseMulti.
+   *
+   * \param           n_rows    Number of rows in the data.
+   * \param           begin     Beginning of boosted tree layer used for prediction.
+   * \param           end       End of booster layer. 0 means do not limit trees.
+   * \param [in,out]  out_preds The output preds, resized to (n_rows, n_groups).
+   * \param [out]     out_slice The trees and the output used by the predictor.
+   */
+  virtual void PrepareDense(bst_idx_t, bst_layer_t, bst_layer_t, HostDeviceVector<float>*,
+                            DenseModelSlice*) const {
+    LOG(FATAL) << "Dense predict is not supported by the current booster.";
+  }
+  /**
+   * \brief Cascade prediction with early exit, see Predictor::PredictCascade.
+   *
+   * \param           p_fmat      Feature matrix, can be a proxy DMatrix.
+   * \param           missing     Missing value in the data of the proxy DMatrix.
+   * \param           begin       Beginning of boosted tree layer used for prediction.
+   * \param           end         End of booster layer. 0 means do not limit trees.
+   * \param           checkpoints Increasing layer indices in (begin, end) that end a stage.
+   * \param           thresholds  Score cutoff for each checkpoint.
+   * \param [in,out]  out_preds   The output margin.
+   * \param [out]     finished    1 if a row is evaluated by all trees, 0 otherwise.
+   */
+  virtual void PredictCascade(DMatrix*, float, bst_layer_t, bst_layer_t,
+                              std::vector<bst_layer_t> const&, std::vector<float> const&,
+                              HostDeviceVector<float>*, HostDeviceVector<std::uint8_t>*) const {
+    LOG(FATAL) << "Cascade predict is not supported by the current booster.";
+  }
   /*!
    * \brief predict the leaf index of each tree, the output will be nsample * ntree vector
    *        this is only valid in gbtree predictor
@@ -127,6 +235,20 @@ class GradientBooster : public Model, public Configurable {
                            HostDeviceVector<bst_float> *out_preds,
                            unsigned layer_begin, unsigned layer_end) = 0;
 
+  /**
+   * \brief Predict the leaf index and the margin together, see Predictor::PredictLeafMargin.
+   *
+   * \param           p_fmat      Feature matrix.
+   * \param [out]     out_leaf    The leaf index with shape (n_samples, n_trees).
+   * \param [out]     out_margin  The margin with shape (n_samples, n_groups).
+   * \param           layer_begin Beginning of boosted tree layer, must be 0.
+   * \param           layer_end   End of booster layer. 0 means do not limit trees.
+   */
+  virtual void PredictLeafMargin(DMatrix*, HostDeviceVector<float>*, HostDeviceVector<float>*,
+                                 bst_layer_t, bst_layer_t) {
+    LOG(FATAL) << "Fused leaf and margin prediction is not supported by the current booster.";
+  }
+
   /*!
    * \brief feature contributions to individual predictions; the output will be a vector
    *         of length (nfeats + 1) * num_output_group * nsample, arranged in that order
@@ -153,6 +275,27 @@ class GradientBooster : public Model, public Configurable {
    */
   [[nodiscard]] virtual std::vector<std::string> DumpModel(const FeatureMap& fmap, bool with_stats,
                                                            std::string format) const = 0;
+  /**
+   * @brief Dump the model in chunks, see @ref Learner::DumpModelTo.
+   */
+  virtual void DumpModelTo(FeatureMap const& fmap, bool with_stats, std::string format,
+                           std::function<bool(std::string const&)> const& fn) const {
+    for (auto const& str : this->DumpModel(fmap, with_stats, format)) {
+      if (!fn(str)) {
+        break;
+      }
+    }
+  }
+  /**
+   * \brief Generate C source code for the model, see predictor::GenerateCode.
+   *
+   * \param layer_begin Beginning of boosted tree layer.
+   * \param layer_end   End of booster layer. 0 means do not limit trees.
+   */
+  [[nodiscard]] virtual std::string GenerateCode(bst_layer_t, bst_layer_t) const {
+    LOG(FATAL) << "Code generation is not supported by the current booster.";
+    return {};
+  }
 
   virtual void FeatureScore(std::string const& importance_type,
                             common::Span<int32_t const> trees,
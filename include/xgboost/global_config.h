@@ -10,12 +10,18 @@
 #include <dmlc/thread_local.h>  // for ThreadLocalStore
 #include <xgboost/parameter.h>  // for XGBoostParameter
 
-#include <cstdint>  // for int32_t
+#include <cstdint>  // for int32_t, int64_t
+#include <string>   // for string
 
 namespace xgboost {
 struct GlobalConfiguration : public XGBoostParameter<GlobalConfiguration> {
   std::int32_t verbosity{1};
   bool use_rmm{false};
+  std::string trace_file;
+  bool perf_counters{false};
+  std::string huge_pages{"none"};
+  bool numa_interleave{false};
+  std::int64_t device_pool_release_threshold{-1};
   DMLC_DECLARE_PARAMETER(GlobalConfiguration) {
     DMLC_DECLARE_FIELD(verbosity)
         .set_range(0, 3)
@@ -23,6 +29,21 @@ struct GlobalConfiguration : public XGBoostParameter<GlobalConfiguration> {
         .describe("Flag to print out detailed breakdown of runtime.");
     DMLC_DECLARE_FIELD(use_rmm).set_default(false).describe(
         "Whether to use RAPIDS Memory Manager to allocate GPU memory in XGBoost");
+    DMLC_DECLARE_FIELD(trace_file).set_default("").describe(
+        "Record a trace of the training and write it to this file in the Chrome trace format "
+        "once the parameter is reset to an empty string.");
+    DMLC_DECLARE_FIELD(perf_counters)
+        .set_default(false)
+        .describe("Collect hardware performance counters for the timed phases.");
+    DMLC_DECLARE_FIELD(huge_pages)
+        .set_default("none")
+        .describe("Use huge pages for large host buffers: none, transparent or explicit.");
+    DMLC_DECLARE_FIELD(numa_interleave)
+        .set_default(false)
+        .describe("Interleave the pages of large host buffers across the NUMA nodes.");
+    DMLC_DECLARE_FIELD(device_pool_release_threshold)
+        .set_default(-1)
+        .describe("Bytes of freed memory kept in the CUDA memory pool, -1 to keep all.");
   }
 };
 
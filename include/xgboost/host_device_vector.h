@@ -139,6 +139,23 @@ class HostDeviceVector {
   /** @brief Resize and initialize the data if the new size is larger than the old size. */
   void Resize(std::size_t new_size, T v);
 
+  /**
+   * @brief Stage the copies between the host and the device in pinned memory, so that the
+   *        copies to the device don't block the host. No-op without CUDA.
+   */
+  void SetPinned(bool pinned);
+  /**
+   * @brief Start copying the data to the device if the device can not read it, without
+   *        blocking the host. Both sides can read the data afterward.
+   */
+  void PrefetchToDevice() const;
+  /**
+   * @brief Start copying the data to the host if the host can not read it. The next host
+   *        access waits for the copy instead of issuing one. The device data must not be
+   *        modified through pointers obtained before this call until the host access.
+   */
+  void PrefetchToHost() const;
+
   using value_type = T;  // NOLINT
 
  private:
@@ -9,8 +9,10 @@
 #include <xgboost/parameter.h>
 #include <xgboost/string_view.h>
 
+#include <algorithm>  // for lower_bound, stable_sort
 #include <functional>
-#include <map>
+#include <initializer_list>  // for initializer_list
+#include <stdexcept>         // for out_of_range
 #include <string>
 #include <type_traits>  // std::enable_if_t
 #include <utility>
@@ -36,7 +38,7 @@ class Value {
     kString,
     kNumber,
     kInteger,
-    kObject,  // std::map
+    kObject,  // sorted vector
     kArray,   // std::vector
     kBoolean,
     kNull,
@@ -202,9 +204,157 @@ using I32Array = JsonTypedArray<std::int32_t, Value::ValueKind::kI32Array>;
  */
 using I64Array = JsonTypedArray<std::int64_t, Value::ValueKind::kI64Array>;
 
+namespace detail {
+/**
+ * @brief Map for JSON objects, implemented as a sorted vector of key-value pairs.
+ *
+ *   Provides the subset of the `std::map` interface used by XGBoost. Most objects have
+ *   only a handful of keys, storing them contiguously avoids allocating a tree node for
+ *   each key. Like `std::vector`, inserting or erasing a key invalidates the references
+ *   and the iterators to the other values.
+ */
+template <typename V>
+class FlatMap {
+ public:
+  using key_type = std::string;   // NOLINT
+  using mapped_type = V;          // NOLINT
+  using value_type = std::pair<std::string, V>;  // NOLINT
+  using size_type = std::size_t;  // NOLINT
+  using iterator = typename std::vector<value_type>::iterator;              // NOLINT
+  using const_iterator = typename std::vector<value_type>::const_iterator;  // NOLINT
+
+ private:
+  std::vector<value_type> items_;
+
+  template <typename It, typename K>
+  static It LowerBound(It first, It last, K const& key) {
+    return std::lower_bound(first, last, key,
+                            [](value_type const& kv, K const& k) { return kv.first < k; });
+  }
+  template <typename K>
+  [[nodiscard]] bool Match(const_iterator it, K const& key) const {
+    return it != items_.cend() && !(key < it->first);
+  }
+  // The key is copied only when it's not in the map.
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> EmplaceImpl(K&& key, Args&&... args) {
+    auto it = LowerBound(items_.begin(), items_.end(), key);
+    if (this->Match(it, key)) {
+      return {it, false};
+    }
+    it = items_.emplace(it, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                        std::forward_as_tuple(std::forward<Args>(args)...));
+    return {it, true};
+  }
+
+ public:
+  FlatMap() = default;
+  FlatMap(std::initializer_list<value_type> items)
+      : FlatMap{std::vector<value_type>{items}} {}
+  /**
+   * @brief Build the map from unsorted items. For duplicated keys, only the last one is
+   *        kept, which is the behaviour of assigning the items one by one.
+   */
+  explicit FlatMap(std::vector<value_type>&& items) : items_{std::move(items)} {
+    std::stable_sort(items_.begin(), items_.end(),
+                     [](value_type const& l, value_type const& r) { return l.first < r.first; });
+    auto out = items_.begin();
+    for (auto it = items_.begin(); it != items_.end(); ++it) {
+      auto next = it + 1;
+      if (next != items_.end() && next->first == it->first) {
+        continue;
+      }
+      if (out != it) {
+        *out = std::move(*it);
+      }
+      ++out;
+    }
+    items_.erase(out, items_.end());
+  }
+
+  [[nodiscard]] iterator begin() { return items_.begin(); }              // NOLINT
+  [[nodiscard]] iterator end() { return items_.end(); }                  // NOLINT
+  [[nodiscard]] const_iterator begin() const { return items_.cbegin(); }  // NOLINT
+  [[nodiscard]] const_iterator end() const { return items_.cend(); }      // NOLINT
+  [[nodiscard]] const_iterator cbegin() const { return items_.cbegin(); }  // NOLINT
+  [[nodiscard]] const_iterator cend() const { return items_.cend(); }      // NOLINT
+
+  [[nodiscard]] size_type size() const { return items_.size(); }  // NOLINT
+  [[nodiscard]] bool empty() const { return items_.empty(); }     // NOLINT
+  void clear() { items_.clear(); }                                // NOLINT
+  void reserve(size_type n) { items_.reserve(n); }                // NOLINT
+
+  template <typename K>
+  [[nodiscard]] iterator find(K const& key) {  // NOLINT
+    auto it = LowerBound(items_.begin(), items_.end(), key);
+    return this->Match(it, key) ? it : items_.end();
+  }
+  template <typename K>
+  [[nodiscard]] const_iterator find(K const& key) const {  // NOLINT
+    auto it = LowerBound(items_.cbegin(), items_.cend(), key);
+    return this->Match(it, key) ? it : items_.cend();
+  }
+  template <typename K>
+  [[nodiscard]] size_type count(K const& key) const {  // NOLINT
+    return this->find(key) == this->cend() ? 0 : 1;
+  }
+
+  template <typename K>
+  [[nodiscard]] V& at(K const& key) {  // NOLINT
+    auto it = this->find(key);
+    if (it == this->end()) {
+      throw std::out_of_range{"FlatMap::at"};
+    }
+    return it->second;
+  }
+  template <typename K>
+  [[nodiscard]] V const& at(K const& key) const {  // NOLINT
+    auto it = this->find(key);
+    if (it == this->cend()) {
+      throw std::out_of_range{"FlatMap::at"};
+    }
+    return it->second;
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(std::string const& key, Args&&... args) {  // NOLINT
+    return this->EmplaceImpl(key, std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(std::string&& key, Args&&... args) {  // NOLINT
+    return this->EmplaceImpl(std::move(key), std::forward<Args>(args)...);
+  }
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> emplace(K&& key, Args&&... args) {  // NOLINT
+    return this->EmplaceImpl(std::forward<K>(key), std::forward<Args>(args)...);
+  }
+  std::pair<iterator, bool> insert(value_type kv) {  // NOLINT
+    return this->EmplaceImpl(std::move(kv.first), std::move(kv.second));
+  }
+
+  V& operator[](std::string const& key) { return this->EmplaceImpl(key).first->second; }
+  V& operator[](std::string&& key) { return this->EmplaceImpl(std::move(key)).first->second; }
+
+  iterator erase(iterator it) { return items_.erase(it); }        // NOLINT
+  iterator erase(const_iterator it) { return items_.erase(it); }  // NOLINT
+  template <typename K>
+  size_type erase(K const& key) {  // NOLINT
+    auto it = this->find(key);
+    if (it == this->end()) {
+      return 0;
+    }
+    items_.erase(it);
+    return 1;
+  }
+
+  bool operator==(FlatMap const& that) const { return items_ == that.items_; }
+  bool operator!=(FlatMap const& that) const { return !(*this == that); }
+};
+}  // namespace detail
+
 class JsonObject : public Value {
  public:
-  using Map = std::map<std::string, Json, std::less<>>;
+  using Map = detail::FlatMap<Json>;
 
  private:
   Map object_;
@@ -358,6 +508,15 @@ class JsonBoolean : public Value {
   }
 };
 
+namespace detail {
+/**
+ * @brief The null value shared by default-constructed Json, which avoids an allocation
+ *        for each of them. There's one for each thread to avoid contention on the
+ *        reference counter.
+ */
+[[nodiscard]] IntrusivePtr<Value> const& NullValue();
+}  // namespace detail
+
 /*!
  * \brief Data structure representing JSON format.
  *
@@ -387,9 +546,14 @@ class Json {
   /**
    *  \brief Encode the JSON object.  Optional parameter mode for choosing between text
    *         and binary (ubjson) output.
+   *
+   *  Elements of large arrays of objects are encoded in parallel when `n_threads` is
+   *  greater than 1.
    */
-  static void Dump(Json json, std::string* out, std::ios::openmode mode = std::ios::out);
-  static void Dump(Json json, std::vector<char>* out, std::ios::openmode mode = std::ios::out);
+  static void Dump(Json json, std::string* out, std::ios::openmode mode = std::ios::out,
+                   std::int32_t n_threads = 1);
+  static void Dump(Json json, std::vector<char>* out, std::ios::openmode mode = std::ios::out,
+                   std::int32_t n_threads = 1);
   /*! \brief Use your own JsonWriter. */
   static void Dump(Json json, JsonWriter* writer);
 
@@ -455,10 +619,9 @@ class Json {
     return *this;
   }
   // null
-  explicit Json(JsonNull null) :
-      ptr_{new JsonNull(std::move(null))} {}
-  Json& operator=(JsonNull null) {
-    ptr_.reset(new JsonNull(std::move(null)));
+  explicit Json(JsonNull) : ptr_{detail::NullValue()} {}
+  Json& operator=(JsonNull) {
+    ptr_ = detail::NullValue();
     return *this;
   }
 
@@ -496,7 +659,7 @@ class Json {
   [[nodiscard]] IntrusivePtr<Value> const& Ptr() const { return ptr_; }
 
  private:
-  IntrusivePtr<Value> ptr_{new JsonNull};
+  IntrusivePtr<Value> ptr_{detail::NullValue()};
 };
 
 /**
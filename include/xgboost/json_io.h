@@ -7,7 +7,9 @@
 #include <xgboost/base.h>
 #include <xgboost/json.h>
 
-#include <cstdint>  // for int8_t
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int8_t, int32_t
+#include <cstring>  // for memcpy
 #include <limits>
 #include <string>
 #include <utility>
@@ -33,7 +35,7 @@ class JsonReader {
     size_t Pos() const { return pos_; }
 
     void Forward() { pos_++; }
-    void Forward(uint32_t n) { pos_ += n; }
+    void Forward(std::size_t n) { pos_ += n; }
   } cursor_;
 
   StringView raw_str_;
@@ -129,9 +131,13 @@ class JsonWriter {
 
  protected:
   std::vector<char>* stream_;
+  // Number of threads for writing the elements of an array of objects, like trees.
+  std::int32_t n_threads_{1};
 
  public:
   explicit JsonWriter(std::vector<char>* stream) : stream_{stream} {}
+  JsonWriter(std::vector<char>* stream, std::int32_t n_threads)
+      : stream_{stream}, n_threads_{n_threads} {}
 
   virtual ~JsonWriter() = default;
 
@@ -201,6 +207,7 @@ inline T ToBigEndian(T v) {
  * \brief Reader for UBJSON https://ubjson.org/
  */
 class UBJReader : public JsonReader {
+ protected:
   Json Parse();
 
   template <typename T>
@@ -230,6 +237,11 @@ class UBJReader : public JsonReader {
   }
 
   std::string DecodeStr();
+  /**
+   * @brief Move the cursor past the next value without decoding it. Typed arrays are
+   *        skipped without reading the elements.
+   */
+  void SkipValue();
 
   Json ParseArray() override;
   Json ParseObject() override;
@@ -262,6 +274,39 @@ class UBJWriter : public JsonWriter {
   using JsonWriter::JsonWriter;
   void Save(Json json) override;
 };
+
+/**
+ * @brief Compute the size of a document encoded by the @ref UBJWriter without writing
+ *        it. Used as the first pass of writing UBJSON, so that the output buffer is
+ *        allocated only once.
+ */
+class UBJSizer : public JsonWriter {
+  std::size_t n_bytes_{0};
+
+  void Visit(JsonArray const* arr) override;
+  void Visit(F32Array const* arr) override;
+  void Visit(F64Array const* arr) override;
+  void Visit(I8Array  const* arr) override;
+  void Visit(U8Array  const* arr) override;
+  void Visit(I16Array  const* arr) override;
+  void Visit(I32Array  const* arr) override;
+  void Visit(I64Array  const* arr) override;
+  void Visit(JsonObject const* obj) override;
+  void Visit(JsonNumber const* num) override;
+  void Visit(JsonInteger const* num) override;
+  void Visit(JsonNull const* null) override;
+  void Visit(JsonString const* str) override;
+  void Visit(JsonBoolean const* boolean) override;
+
+ public:
+  UBJSizer() : JsonWriter{nullptr} {}
+  explicit UBJSizer(std::int32_t n_threads) : JsonWriter{nullptr, n_threads} {}
+  void Save(Json json) override;
+  /**
+   * @brief Number of bytes of the saved values.
+   */
+  [[nodiscard]] std::size_t Size() const { return n_bytes_; }
+};
 }      // namespace xgboost
 
 #endif  // XGBOOST_JSON_IO_H_
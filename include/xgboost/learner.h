@@ -8,22 +8,25 @@
 #ifndef XGBOOST_LEARNER_H_
 #define XGBOOST_LEARNER_H_
 
-#include <dmlc/io.h>          // for Serializable
-#include <xgboost/base.h>     // for bst_feature_t, bst_target_t, bst_float, Args, GradientPair, ..
-#include <xgboost/context.h>  // for Context
-#include <xgboost/linalg.h>   // for Tensor, TensorView
-#include <xgboost/metric.h>   // for Metric
-#include <xgboost/model.h>    // for Configurable, Model
-#include <xgboost/span.h>     // for Span
-#include <xgboost/task.h>     // for ObjInfo
+#include <dmlc/io.h>              // for Serializable
+#include <xgboost/base.h>         // for bst_feature_t, bst_target_t, bst_float, Args, GradientP...
+#include <xgboost/context.h>      // for Context
+#include <xgboost/linalg.h>       // for Tensor, TensorView
+#include <xgboost/metric.h>       // for Metric
+#include <xgboost/model.h>        // for Configurable, Model
+#include <xgboost/span.h>         // for Span
+#include <xgboost/string_view.h>  // for StringView
+#include <xgboost/task.h>         // for ObjInfo
 
-#include <algorithm>          // for max
-#include <cstdint>            // for int32_t, uint32_t, uint8_t
-#include <map>                // for map
-#include <memory>             // for shared_ptr, unique_ptr
-#include <string>             // for string
-#include <utility>            // for move
-#include <vector>             // for vector
+#include <algorithm>              // for max
+#include <cstdint>                // for int32_t, uint32_t, uint8_t
+#include <functional>             // for function
+#include <ios>                    // for ios
+#include <map>                    // for map
+#include <memory>                 // for shared_ptr, unique_ptr
+#include <string>                 // for string
+#include <utility>                // for move
+#include <vector>                 // for vector
 
 namespace xgboost {
 class FeatureMap;
@@ -46,6 +49,20 @@ enum class PredictionType : std::uint8_t {  // NOLINT
   kLeaf = 6
 };
 
+class Learner;
+
+/**
+ * @brief A booster and its output for @ref Learner::PredictDenseMulti.
+ */
+struct DensePredictEntry {
+  Learner* learner{nullptr};
+  PredictionType type{PredictionType::kValue};
+  bst_layer_t layer_begin{0};
+  bst_layer_t layer_end{0};
+  // Output prediction vector, the memory is reused.
+  HostDeviceVector<float>* out_preds{nullptr};
+};
+
 /*!
  * \brief Learner class that does training and prediction.
  *  This is the user facing module of xgboost training.
@@ -88,6 +105,19 @@ class Learner : public Model, public Configurable, public dmlc::Serializable {
    */
   virtual void BoostOneIter(std::int32_t iter, std::shared_ptr<DMatrix> train,
                             linalg::Matrix<GradientPair>* in_gpair) = 0;
+  /**
+   * @brief Get the gradient buffer owned by the learner, for writing the gradient of a
+   *        custom objective without an intermediate copy.
+   *
+   *   The buffer has the shape (n_samples, n_targets) and is placed on the device of the
+   *   learner. Pass it to @ref BoostOneIter after filling it. Its content is unspecified
+   *   after each iteration, and it's invalidated by any other call to the learner.
+   *
+   * @param train reference to the data matrix.
+   *
+   * @return The gradient buffer.
+   */
+  virtual linalg::Matrix<GradientPair>* GradientBuffer(std::shared_ptr<DMatrix> train) = 0;
   /*!
    * \brief evaluate the model for specific iteration using the configured metrics.
    * \param iter iteration number
@@ -98,6 +128,17 @@ class Learner : public Model, public Configurable, public dmlc::Serializable {
   virtual std::string EvalOneIter(int iter,
                                   const std::vector<std::shared_ptr<DMatrix>>& data_sets,
                                   const std::vector<std::string>& data_names) = 0;
+  /**
+   * @brief Wait for the evaluation started by the last @ref EvalOneIter when the
+   *        `async_eval` parameter is set.
+   *
+   *   With asynchronous evaluation, @ref EvalOneIter starts the evaluation of the current
+   *   iteration in a background thread and returns the result of the previous one.
+   *
+   * @return The result of the evaluation in flight, tagged with its iteration. Empty if
+   *         there's none.
+   */
+  virtual std::string EvalPending() = 0;
   /*!
    * \brief get prediction given the model.
    * \param data input data
@@ -116,6 +157,21 @@ class Learner : public Model, public Configurable, public dmlc::Serializable {
                        bst_layer_t layer_end, bool training = false, bool pred_leaf = false,
                        bool pred_contribs = false, bool approx_contribs = false,
                        bool pred_interactions = false) = 0;
+  /**
+   * @brief Predict the leaf index and the prediction value in a single traversal of the
+   *        trees, instead of calling @ref Predict twice.
+   *
+   * @param          data          Input data.
+   * @param          output_margin Whether to output the untransformed margin.
+   * @param [out]    out_preds     Output prediction, same as @ref Predict.
+   * @param [out]    out_leaf      Output leaf index, same as @ref Predict with `pred_leaf`.
+   * @param          layer_begin   Beginning of boosted tree layer, must be 0.
+   * @param          layer_end     End of booster layer. 0 means do not limit trees.
+   */
+  virtual void PredictLeafMargin(std::shared_ptr<DMatrix> data, bool output_margin,
+                                 HostDeviceVector<float>* out_preds,
+                                 HostDeviceVector<float>* out_leaf, bst_layer_t layer_begin,
+                                 bst_layer_t layer_end) = 0;
 
   /*!
    * \brief Inplace prediction.
@@ -130,6 +186,49 @@ class Learner : public Model, public Configurable, public dmlc::Serializable {
   virtual void InplacePredict(std::shared_ptr<DMatrix> p_m, PredictionType type, float missing,
                               HostDeviceVector<float>** out_preds, bst_layer_t layer_begin,
                               bst_layer_t layer_end) = 0;
+  /**
+   * @brief Predict a row-major dense matrix on CPU with the same number of features as
+   *        the model.
+   *
+   * Unlike @ref InplacePredict, no proxy DMatrix is needed and the output is written into
+   * a buffer owned by the caller. Only the value and margin prediction types are
+   * supported.
+   *
+   * @param          data        Pointer to the row-major dense matrix.
+   * @param          n_rows      Number of rows in the data.
+   * @param          missing     Missing value in the data.
+   * @param          type        Prediction type.
+   * @param          layer_begin Beginning of boosted tree layer used for prediction.
+   * @param          layer_end   End of booster layer. 0 means do not limit trees.
+   * @param [in,out] out_preds   Output prediction vector, the memory is reused.
+   */
+  virtual void PredictDense(float const* data, bst_idx_t n_rows, float missing,
+                            PredictionType type, bst_layer_t layer_begin, bst_layer_t layer_end,
+                            HostDeviceVector<float>* out_preds) = 0;
+  /**
+   * @brief Cascade prediction with early exit for models with a single output.
+   *
+   * Trees are evaluated in stages that end at the checkpoints. After each stage, rows with
+   * a partial margin less than the threshold of the checkpoint stop traversing the
+   * remaining trees, their prediction is formed by the evaluated trees only. Only the value
+   * and margin prediction types are supported, thresholds are compared against the margin.
+   *
+   * @param          data        Input data, can be a proxy DMatrix for inplace prediction.
+   * @param          type        Prediction type.
+   * @param          missing     Missing value in the data of the proxy DMatrix.
+   * @param          layer_begin Beginning of boosted tree layer used for prediction.
+   * @param          layer_end   End of booster layer. 0 means do not limit trees.
+   * @param          checkpoints Increasing boosted layers in (layer_begin, layer_end).
+   * @param          thresholds  Score cutoff for each checkpoint.
+   * @param [out]    out_preds   Output prediction vector.
+   * @param [out]    finished    1 if a row is evaluated by all trees, 0 otherwise.
+   */
+  virtual void PredictCascade(std::shared_ptr<DMatrix> data, PredictionType type, float missing,
+                              bst_layer_t layer_begin, bst_layer_t layer_end,
+                              std::vector<bst_layer_t> const& checkpoints,
+                              std::vector<float> const& thresholds,
+                              HostDeviceVector<float>* out_preds,
+                              HostDeviceVector<std::uint8_t>* finished) = 0;
 
   /*!
    * \brief Calculate feature score.  See doc in C API for outputs.
@@ -152,7 +251,66 @@ class Learner : public Model, public Configurable, public dmlc::Serializable {
   void SaveModel(Json* out) const override = 0;
 
   virtual void LoadModel(dmlc::Stream* fi) = 0;
+  /**
+   * @brief Load the model from a serialized JSON or UBJSON document. For UBJSON, the trees
+   *        are loaded while the document is being parsed instead of building a JSON object
+   *        for the entire model first.
+   *
+   * @param str  The serialized model.
+   * @param mode std::ios::binary for UBJSON, std::ios::in for JSON.
+   */
+  virtual void LoadModel(StringView str, std::ios::openmode mode) = 0;
+  /**
+   * @brief Save the model into a binary file that can be loaded with mmap. The trees are
+   *        stored as flat arrays in native byte order, and only the small remaining part
+   *        of the model is encoded as UBJSON.
+   *
+   * @param path Path to the output file.
+   */
+  virtual void SaveMmapModel(StringView path) const = 0;
+  /**
+   * @brief Load a model saved by @ref SaveMmapModel.
+   *
+   * @param path Path to the model file.
+   */
+  virtual void LoadMmapModel(StringView path) = 0;
+  /**
+   * @brief Load a model saved by @ref SaveMmapModel without loading the trees. The trees
+   *        are loaded by pages of boosted layers when they are needed for prediction, and
+   *        the loaded pages are kept under a memory budget. Only the normal prediction is
+   *        supported by the loaded model.
+   *
+   * @param path      Path to the model file.
+   * @param max_bytes Budget for the loaded trees in bytes, 0 for unlimited.
+   */
+  virtual void LoadLazyModel(StringView path, std::size_t max_bytes) = 0;
+  /**
+   * @brief Save the margin prediction cache of the training data into a file. The cache is
+   *        tagged with fingerprints of the model and the DMatrix, and can be restored by
+   *        @ref LoadPredictionCache for continuing the training from a checkpoint without
+   *        predicting all the existing trees.
+   *
+   * @param data The training DMatrix.
+   * @param path Path to the output file.
+   */
+  virtual void SavePredictionCache(std::shared_ptr<DMatrix> data, StringView path) = 0;
+  /**
+   * @brief Restore the cache saved by @ref SavePredictionCache. The fingerprints cover the
+   *        model, the shape of the data and the meta info used by the prediction, but not the
+   *        feature values.
+   *
+   * @return false if the cache doesn't match the current model or the data, in which case
+   *         the cache is recomputed during the next iteration.
+   */
+  virtual bool LoadPredictionCache(std::shared_ptr<DMatrix> data, StringView path) = 0;
   virtual void SaveModel(dmlc::Stream* fo) const = 0;
+  /**
+   * @brief Save the model for serving. The node statistics of trees are left out, and the
+   *        tree nodes are stored in the smallest integer types. The model can be loaded
+   *        by @ref LoadModel for prediction, but the gain and cover based feature
+   *        importance and the feature contributions are no longer available.
+   */
+  virtual void SaveServingModel(Json* out) const = 0;
 
   /*!
    * \brief Set multiple parameters at once.
@@ -237,6 +395,16 @@ class Learner : public Model, public Configurable, public dmlc::Serializable {
    */
   virtual Learner* Slice(bst_layer_t begin, bst_layer_t end, bst_layer_t step,
                          bool* out_of_bound) = 0;
+  /**
+   * @brief Append the boosted rounds of another model, the counterpart of @ref Slice.
+   *        The attributes of the other model take precedence.
+   *
+   * Used for merging incremental checkpoints, where each segment contains the trees
+   * added since the previous checkpoint.
+   *
+   * @param that A model trained with the same parameters, its trees are copied.
+   */
+  virtual void Append(Learner* that) = 0;
   /*!
    * \brief dump the model in the requested format
    * \param fmap feature map that may help give interpretations of feature
@@ -247,12 +415,56 @@ class Learner : public Model, public Configurable, public dmlc::Serializable {
   virtual std::vector<std::string> DumpModel(const FeatureMap& fmap,
                                              bool with_stats,
                                              std::string format) = 0;
+  /**
+   * @brief Dump the model in the requested format without holding the dump of the entire
+   *        model in memory.
+   *
+   * @param fn Called with the dump of each booster in order, returns false to stop.
+   */
+  virtual void DumpModelTo(FeatureMap const& fmap, bool with_stats, std::string format,
+                           std::function<bool(std::string const&)> const& fn) = 0;
+  /**
+   * @brief Generate C source code for the tree model. See the C API for the interface of
+   *        the generated code.
+   *
+   * @param layer_begin Beginning of boosted tree layer.
+   * @param layer_end   End of booster layer. 0 means do not limit trees.
+   */
+  virtual std::string GenerateCode(bst_layer_t layer_begin, bst_layer_t layer_end) = 0;
 
   virtual XGBAPIThreadLocalEntry& GetThreadLocal() const = 0;
   /**
    * @brief Reset the booster object to release data caches used for training.
    */
   virtual void Reset() = 0;
+  /**
+   * @brief Switch the booster into the read-only inference mode.
+   *
+   * Prediction no longer uses the shared prediction cache and only reads the model, the
+   * output is written into caller-owned or thread-local buffers. Multiple threads can then
+   * share one booster for inference without contention. Methods that modify the booster,
+   * like training, setting parameters and loading a model, raise an error afterward. The
+   * training caches are released and the mode can not be reverted.
+   */
+  virtual void Freeze() = 0;
+  /**
+   * @brief Whether the booster is in the read-only inference mode, see @ref Freeze.
+   */
+  [[nodiscard]] virtual bool IsFrozen() const = 0;
+  /**
+   * @brief Predict the same row-major dense matrix with multiple boosters, see @ref
+   *        PredictDense.
+   *
+   * The input is converted once for each block of rows and shared by all the boosters,
+   * which must be tree boosters with the same number of features.
+   *
+   * @param entries The boosters along with their prediction types and outputs.
+   * @param data    Pointer to the row-major dense matrix.
+   * @param n_rows  Number of rows in the data.
+   * @param missing Missing value in the data.
+   */
+  static void PredictDenseMulti(std::vector<DensePredictEntry> const& entries, float const* data,
+                                bst_idx_t n_rows, float missing);
   /*!
    * \brief Create a new instance of learner.
    * \param cache_data The matrix to cache the prediction.
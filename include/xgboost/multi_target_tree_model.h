@@ -88,6 +88,11 @@ class MultiTargetTree : public Model {
     CHECK(IsLeaf(nidx));
     return this->NodeWeight(nidx);
   }
+  /**
+   * @brief Weights of all nodes stored contiguously, the weight of node `nidx` starts at
+   *        `nidx * NumTarget()`.
+   */
+  [[nodiscard]] common::Span<float const> Weights() const { return weights_; }
 
   void LoadModel(Json const& in) override;
   void SaveModel(Json* out) const override;
@@ -14,15 +14,36 @@
 #include <xgboost/model.h>
 #include <xgboost/task.h>
 
+#include <cstddef>  // for size_t
 #include <cstdint>  // std::int32_t
 #include <functional>
+#include <memory>   // for unique_ptr
 #include <string>
 
+#include "xgboost/span.h"  // for Span
+
 namespace xgboost {
 
 class RegTree;
 struct Context;
 
+/**
+ * @brief Gradient of an elementwise objective computed on demand for ranges of samples.
+ *        Used by the tree updaters to compute the gradient in their first pass over the
+ *        training data, instead of reading it from a precomputed buffer.
+ */
+class RowGradient {
+ public:
+  virtual ~RowGradient() = default;
+  /**
+   * @brief Compute the gradient of samples in [begin, end).
+   *
+   * @param out_gpair The gradient of all samples, only the range is written.
+   */
+  virtual void operator()(std::size_t begin, std::size_t end,
+                          common::Span<GradientPair> out_gpair) const = 0;
+};
+
 /*! \brief interface of objective function */
 class ObjFunction : public Configurable {
  protected:
@@ -126,6 +147,20 @@ class ObjFunction : public Configurable {
                               MetaInfo const& /*info*/, float /*learning_rate*/,
                               HostDeviceVector<float> const& /*prediction*/,
                               std::int32_t /*group_idx*/, RegTree* /*p_tree*/) const {}
+  /**
+   * @brief Create the on demand gradient for the current predictions. The labels are not
+   *        validated, which is done by @ref GetGradient in the first iteration.
+   *
+   * @param preds The predictions, must outlive the returned object.
+   * @param info  MetaInfo providing labels and weights.
+   *
+   * @return Null if the objective can't compute the gradient of each sample independently
+   *         on CPU.
+   */
+  [[nodiscard]] virtual std::unique_ptr<RowGradient> MakeRowGradient(
+      HostDeviceVector<float> const& /*preds*/, MetaInfo const& /*info*/) const {
+    return nullptr;
+  }
 
   /*!
    * \brief Create an objective function according to name.
@@ -12,6 +12,7 @@
 #include <xgboost/data.h>
 #include <xgboost/host_device_vector.h>
 
+#include <cstdint>     // for uint8_t
 #include <functional>  // for function
 #include <memory>      // for shared_ptr
 #include <string>
@@ -31,6 +32,12 @@ struct PredictionCacheEntry {
   HostDeviceVector<float> predictions;
   // The version of current cache, corresponding number of layers of trees
   std::uint32_t version{0};
+  // Prediction of the first `l` layers for l in [0, n_prefix_layers), stored layer by
+  // layer. Only used when the `prefix_cache` parameter of gbtree is enabled.
+  HostDeviceVector<float> layer_prefix;
+  std::uint32_t n_prefix_layers{0};
+  // Version of the model that produced the prefix sums.
+  std::uint64_t prefix_model_version{0};
 
   PredictionCacheEntry() = default;
   /**
@@ -60,6 +67,22 @@ class PredictionContainer : public DMatrixCache<PredictionCacheEntry> {
   }
 };
 
+class Predictor;
+
+/**
+ * \brief A model used by \ref Predictor::PredictDenseMulti along with its output.
+ */
+struct DenseModelSlice {
+  // The predictor that owns the cached data structures of the model, like the compiled
+  // forest.
+  Predictor const* predictor{nullptr};
+  gbm::GBTreeModel const* model{nullptr};
+  bst_tree_t tree_begin{0};
+  bst_tree_t tree_end{0};
+  // Output with shape (n_rows, n_groups).
+  linalg::MatrixView<float> out_predt{common::Span<float>{}, {0, 0}, DeviceOrd::CPU()};
+};
+
 /**
  * \class Predictor
  *
@@ -108,6 +131,27 @@ class Predictor {
                             gbm::GBTreeModel const& model, bst_tree_t tree_begin,
                             bst_tree_t tree_end = 0) const = 0;
 
+  /**
+   * \brief Batch prediction with the leaf values of each tree multiplied by a weight, like
+   *        the normalized trees of dart. Trees with 0 weight are skipped. All trees are
+   *        accumulated in a single pass over the data.
+   *
+   * \param [in,out]  dmat         Feature matrix.
+   * \param [in,out]  out_preds    The output preds, the predictions are added to it.
+   * \param           model        The model to predict from.
+   * \param           tree_begin   The tree begin index.
+   * \param           tree_end     The tree end index.
+   * \param           tree_weights Weight of each tree in the model, indexed by the tree id.
+   *
+   * \return True if the predictor supports weighted prediction for the data, false otherwise.
+   */
+  virtual bool PredictWeightedBatch(DMatrix* /*dmat*/, PredictionCacheEntry* /*out_preds*/,
+                                    gbm::GBTreeModel const& /*model*/, bst_tree_t /*tree_begin*/,
+                                    bst_tree_t /*tree_end*/,
+                                    common::Span<float const> /*tree_weights*/) const {
+    return false;
+  }
+
   /**
    * \brief Inplace prediction.
    *
@@ -125,6 +169,80 @@ class Predictor {
                               float missing, PredictionCacheEntry* out_preds,
                               bst_tree_t tree_begin = 0, bst_tree_t tree_end = 0) const = 0;
 
+  /**
+   * \brief Predict a row-major dense matrix without going through the DMatrix proxy.
+   *
+   * This is the low latency path for predicting a few samples at a time, the output is
+   * written into a buffer owned by the caller and initialized with the base score.
+   *
+   * \param           model      The model to predict from.
+   * \param           data       Row-major dense matrix with the same number of features as
+   *                             the model.
+   * \param           n_rows     Number of rows in data.
+   * \param           missing    Missing value in the data.
+   * \param           tree_begin Beginning of boosted trees used for prediction.
+   * \param           tree_end   End of boosted trees used for prediction.
+   * \param [in,out]  out_predt  Output with shape (n_rows, n_groups).
+   *
+   * \return True if the predictor supports this path, false otherwise.
+   */
+  virtual bool PredictDense(gbm::GBTreeModel const& /*model*/, float const* /*data*/,
+                            bst_idx_t /*n_rows*/, float /*missing*/, bst_tree_t /*tree_begin*/,
+                            bst_tree_t /*tree_end*/,
+                            linalg::MatrixView<float> /*out_predt*/) const {
+    return false;
+  }
+
+  /**
+   * \brief Predict the same row-major dense matrix with multiple models.
+   *
+   * The feature vectors are filled once for each block of rows and shared by the trees of
+   * all the models, the output of each model is initialized with its base score.
+   *
+   * \param models  Models with the same number of features, along with their outputs.
+   * \param data    Row-major dense matrix.
+   * \param n_rows  Number of rows in data.
+   * \param missing Missing value in the data.
+   *
+   * \return True if the predictor supports this path, false otherwise.
+   */
+  virtual bool PredictDenseMulti(common::Span<DenseModelSlice const> /*models*/,
+                                 float const* /*data*/, bst_idx_t /*n_rows*/,
+                                 float /*missing*/) const {
+    return false;
+  }
+
+  /**
+   * \brief Cascade prediction with early exit.
+   *
+   * The trees are evaluated in stages, where the i^th stage ends before the tree
+   * `tree_checkpoints[i]`. Once a stage is done, rows with a partial margin less than
+   * `thresholds[i]` are not evaluated by the remaining trees. Only models with a single
+   * output are supported.
+   *
+   * \param           dmat             Feature matrix, can be a proxy DMatrix for inplace
+   *                                   prediction.
+   * \param           model            The model to predict from.
+   * \param           missing          Missing value in the data of the proxy DMatrix.
+   * \param           tree_begin       The tree begin index.
+   * \param           tree_end         The tree end index.
+   * \param           tree_checkpoints Increasing tree indices in (tree_begin, tree_end).
+   * \param           thresholds       Score cutoff for each checkpoint.
+   * \param [in,out]  out_preds        The output margin, initialized with the base margin.
+   * \param [out]     finished         1 if a row is evaluated by all trees, 0 otherwise.
+   *
+   * \return True if the predictor supports this path, false otherwise.
+   */
+  virtual bool PredictCascade(DMatrix* /*dmat*/, gbm::GBTreeModel const& /*model*/,
+                              float /*missing*/, bst_tree_t /*tree_begin*/,
+                              bst_tree_t /*tree_end*/,
+                              common::Span<bst_tree_t const> /*tree_checkpoints*/,
+                              common::Span<float const> /*thresholds*/,
+                              linalg::VectorView<float> /*out_preds*/,
+                              common::Span<std::uint8_t> /*finished*/) const {
+    return false;
+  }
+
   /**
    * \brief predict the leaf index of each tree, the output will be nsample *
    * ntree vector this is only valid in gbtree predictor.
@@ -138,6 +256,25 @@ class Predictor {
   virtual void PredictLeaf(DMatrix* dmat, HostDeviceVector<float>* out_preds,
                            gbm::GBTreeModel const& model, bst_tree_t tree_end = 0) const = 0;
 
+  /**
+   * \brief Predict the leaf index and the margin in a single traversal of the trees, see
+   *        \ref PredictLeaf.
+   *
+   * \param           dmat        The input feature matrix.
+   * \param           model       Model to make predictions from.
+   * \param           tree_end    The tree end index, 0 means all the trees.
+   * \param [out]     out_leaf    The leaf index with shape (n_samples, n_trees).
+   * \param [out]     out_margin  The margin with shape (n_samples, n_groups), including the
+   *                              base margin of the data.
+   *
+   * \return True if the predictor supports this path, false otherwise.
+   */
+  virtual bool PredictLeafMargin(DMatrix* /*dmat*/, gbm::GBTreeModel const& /*model*/,
+                                 bst_tree_t /*tree_end*/, HostDeviceVector<float>* /*out_leaf*/,
+                                 HostDeviceVector<float>* /*out_margin*/) const {
+    return false;
+  }
+
   /**
    * \brief feature contributions to individual predictions; the output will be
    * a vector of length (nfeats + 1) * num_output_group * nsample, arranged in
@@ -34,6 +34,9 @@ struct ObjInfo {
   // Does the objective have constant hessian value?
   bool const_hess{false};
   bool zero_hess{false};
+  // Does the objective truncate small gradients to zero? Rows with zero gradient and hessian
+  // can be excluded from building the tree of each output.
+  bool sparse_grad{false};
 
   ObjInfo(Task t) : task{t} {}  // NOLINT
   ObjInfo(Task t, bool khess, bool zhess) : task{t}, const_hess{khess}, zero_hess(zhess) {}
@@ -28,6 +28,11 @@
 namespace xgboost {
 class Json;
 
+namespace common {
+class AlignedResourceReadStream;
+class AlignedFileWriteStream;
+}  // namespace common
+
 // FIXME(trivialfis): Once binary IO is gone, make this parameter internal as it should
 // not be configured by users.
 /*! \brief meta parameters of the tree */
@@ -136,6 +141,13 @@ class CopyUniquePtr {
       ptr_ = std::make_unique<T>(*that);
     }
   }
+  CopyUniquePtr(CopyUniquePtr&& that) noexcept = default;
+  CopyUniquePtr& operator=(CopyUniquePtr const& that) {
+    CopyUniquePtr{that}.ptr_.swap(this->ptr_);
+    return *this;
+  }
+  CopyUniquePtr& operator=(CopyUniquePtr&& that) noexcept = default;
+
   T* get() const noexcept { return ptr_.get(); }  // NOLINT
 
   T& operator*() { return *ptr_; }
@@ -375,9 +387,49 @@ class RegTree : public Model {
    * \param fo output stream
    */
   void Save(dmlc::Stream* fo) const;
+  /**
+   * @brief Read the tree from the flat binary format of the mmap model. The format uses
+   *        native byte order and doesn't support multi-target trees.
+   *
+   * @return Whether the read is successful.
+   */
+  [[nodiscard]] bool Read(common::AlignedResourceReadStream* fi);
+  /**
+   * @brief Move the stream past a tree written by @ref Write without loading it.
+   *
+   * @return Whether the tree is complete.
+   */
+  [[nodiscard]] static bool Skip(common::AlignedResourceReadStream* fi);
+  /**
+   * @brief Write the tree in the flat binary format of the mmap model.
+   *
+   * @return Number of bytes written.
+   */
+  [[nodiscard]] std::size_t Write(common::AlignedFileWriteStream* fo) const;
 
   void LoadModel(Json const& in) override;
   void SaveModel(Json* out) const override;
+  /**
+   * @brief Save the tree for serving. The node statistics are left out, and the node
+   *        indices and feature indices are stored in the smallest integer type that
+   *        holds them. @ref LoadModel loads the tree with zero statistics.
+   */
+  void SaveServingModel(Json* out) const;
+  /**
+   * @brief Save only the node statistics, in the same fields as @ref SaveModel.
+   */
+  void SaveStats(Json* out) const;
+  /**
+   * @brief Load the node statistics saved by @ref SaveStats. The tree must have the same
+   *        number of nodes.
+   */
+  void LoadStats(Json const& in);
+  /**
+   * @brief Whether two trees have the same nodes, splits and leaf values. Unlike
+   *        `operator==`, the node statistics are not compared while the categorical
+   *        splits are. Multi-target trees are never equal.
+   */
+  [[nodiscard]] bool SameSplits(RegTree const& that) const;
 
   bool operator==(const RegTree& b) const {
     return nodes_ == b.nodes_ && stats_ == b.stats_ &&
@@ -555,8 +607,11 @@ class RegTree : public Model {
     /*!
      * \brief initialize the vector with size vector
      * \param size The size of the feature vector.
+     * \param use_mask Keep a bitmask of the present features. Looking up a missing feature
+     *        then reads only the bitmask, which is 32 times smaller than the values. Used
+     *        for wide and sparse rows, where the values don't fit in the cache.
      */
-    void Init(size_t size);
+    void Init(size_t size, bool use_mask = false);
     /*!
      * \brief fill the vector with sparse vector
      * \param inst The sparse instance to fill.
@@ -587,8 +642,31 @@ class RegTree : public Model {
     [[nodiscard]] bool IsMissing(size_t i) const;
     [[nodiscard]] bool HasMissing() const;
     void HasMissing(bool has_missing) { this->has_missing_ = has_missing; }
+    /**
+     * @brief Whether the vector keeps a bitmask of the present features.
+     */
+    [[nodiscard]] bool HasMask() const { return !mask_.empty(); }
+    /**
+     * @brief Set the value of the i-th feature, the bitmask is updated if there's one.
+     */
+    void Set(size_t i, float fvalue) {
+      data_[i] = fvalue;
+      if (!mask_.empty()) {
+        mask_[i / 64] |= std::uint64_t{1} << (i % 64);
+      }
+    }
+    /**
+     * @brief Reset the i-th feature to missing.
+     */
+    void Reset(size_t i) {
+      data_[i] = std::numeric_limits<float>::quiet_NaN();
+      if (!mask_.empty()) {
+        mask_[i / 64] &= ~(std::uint64_t{1} << (i % 64));
+      }
+    }
 
     [[nodiscard]] common::Span<float> Data() { return data_; }
+    [[nodiscard]] common::Span<float const> Data() const { return data_; }
 
    private:
     /**
@@ -597,6 +675,9 @@ class RegTree : public Model {
      * It's nan if the value is missing.
      */
     std::vector<float> data_;
+    // Optional bitmask of the present features, empty if not used. The values are kept
+    // dense either way, the bitmask only skips loading them for missing features.
+    std::vector<std::uint64_t> mask_;
     bool has_missing_;
   };
 
@@ -606,7 +687,7 @@ class RegTree : public Model {
    * \param out_contribs output vector to hold the contributions
    */
   void CalculateContributionsApprox(const RegTree::FVec& feat,
-                                    std::vector<float>* mean_values,
+                                    std::vector<float> const* mean_values,
                                     bst_float* out_contribs) const;
   /*!
    * \brief dump the model in the requested format as a text string
@@ -790,9 +871,10 @@ class RegTree : public Model {
   }
 };
 
-inline void RegTree::FVec::Init(size_t size) {
+inline void RegTree::FVec::Init(size_t size, bool use_mask) {
   data_.resize(size);
   std::fill(data_.begin(), data_.end(), std::numeric_limits<float>::quiet_NaN());
+  mask_.assign(use_mask ? (size + 63) / 64 : 0, 0);
   has_missing_ = true;
 }
 
@@ -804,16 +886,23 @@ inline void RegTree::FVec::Fill(SparsePage::Inst const& inst) {
     auto const& entry = p_data[i];
     p_out[entry.index] = entry.fvalue;
   }
+  for (std::size_t i = 0, n = mask_.empty() ? 0 : inst.size(); i < n; ++i) {
+    auto fidx = p_data[i].index;
+    mask_[fidx / 64] |= std::uint64_t{1} << (fidx % 64);
+  }
   has_missing_ = data_.size() != inst.size();
 }
 
-inline void RegTree::FVec::Drop() { this->Init(this->Size()); }
+inline void RegTree::FVec::Drop() { this->Init(this->Size(), this->HasMask()); }
 
 inline size_t RegTree::FVec::Size() const {
   return data_.size();
 }
 
 inline float RegTree::FVec::GetFvalue(size_t i) const {
+  if (!mask_.empty() && !((mask_[i / 64] >> (i % 64)) & 1)) {
+    return std::numeric_limits<float>::quiet_NaN();
+  }
   return data_[i];
 }
 
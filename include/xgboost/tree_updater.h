@@ -29,6 +29,7 @@ struct TrainParam;
 class Json;
 struct Context;
 struct ObjInfo;
+class RowGradient;
 
 /**
  * \brief interface of tree update module, that performs update of a tree.
@@ -74,6 +75,22 @@ class TreeUpdater : public Configurable {
   virtual void Update(tree::TrainParam const* param, linalg::Matrix<GradientPair>* gpair,
                       DMatrix* data, common::Span<HostDeviceVector<bst_node_t>> out_position,
                       const std::vector<RegTree*>& out_trees) = 0;
+  /**
+   * @brief Request the next @ref Update to compute the gradient on demand. The gradient
+   *        passed to the update is uninitialized and must be filled by the updater.
+   *
+   * @return Whether the updater accepts the request.
+   */
+  virtual bool FuseGradient(RowGradient const* /*fn*/) { return false; }
+  /**
+   * @brief Request the next @ref UpdatePredictionCache to return before the update is
+   *        finished, so that it can overlap with building the next tree. The deferred
+   *        updates are finished by the next call without the request, the cache must not be
+   *        read before that.
+   *
+   * @return Whether the updater accepts the request.
+   */
+  virtual bool DeferPredictionCache() { return false; }
 
   /*!
    * \brief determines whether updater has enough knowledge about a given dataset
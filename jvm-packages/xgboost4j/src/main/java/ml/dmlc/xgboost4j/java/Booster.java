@@ -16,6 +16,7 @@
 package ml.dmlc.xgboost4j.java;
 
 import java.io.*;
+import java.nio.ByteBuffer;
 import java.util.Arrays;
 import java.util.HashMap;
 import java.util.HashSet;
@@ -481,6 +482,46 @@ public class Booster implements Serializable, KryoSerializable {
     return predicts;
   }
 
+  /**
+   * Perform thread-safe prediction on data stored in direct buffers.
+   *
+   * The input is read and the result is written by the native library in place, no float
+   * array is copied or pinned by the JVM. All buffers must be direct and in the native byte
+   * order.
+   *
+   * @param data            Row-major input matrix of float32 features
+   * @param nrow            The number of rows in the input matrix
+   * @param ncol            The number of columns in the input matrix
+   * @param missing         Value indicating missing element in the <code>data</code> input matrix
+   * @param iteration_range Specifies which layer of trees are used in prediction.
+   * @param predict_type    What kind of prediction to run.
+   * @param base_margin     Optional float32 base margin, the length is given by its capacity.
+   * @param out             Output buffer, must be large enough to hold the prediction.
+   * @return The number of float32 values written into <code>out</code>.
+   */
+  public long inplace_predict(ByteBuffer data,
+                              long nrow,
+                              long ncol,
+                              float missing,
+                              int[] iteration_range,
+                              PredictionType predict_type,
+                              ByteBuffer base_margin,
+                              ByteBuffer out) throws XGBoostError {
+    if (iteration_range.length != 2) {
+      throw new XGBoostError(new String("Iteration range is expected to be [begin, end)."));
+    }
+    DMatrix.checkDirectBuffer(data);
+    DMatrix.checkDirectBuffer(out);
+    if (base_margin != null) {
+      DMatrix.checkDirectBuffer(base_margin);
+    }
+    long[] outLength = new long[1];
+    XGBoostJNI.checkCall(XGBoostJNI.XGBoosterPredictFromDirectBuffer(handle, data, nrow, ncol,
+        missing, iteration_range[0], iteration_range[1], predict_type.getPType(), base_margin,
+        out, outLength));
+    return outLength[0];
+  }
+
   /**
    * Predict leaf indices given the data
    *
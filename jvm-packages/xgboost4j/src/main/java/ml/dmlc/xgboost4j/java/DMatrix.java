@@ -15,6 +15,8 @@
  */
 package ml.dmlc.xgboost4j.java;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.util.Iterator;
 
 import ml.dmlc.xgboost4j.LabeledPoint;
@@ -177,6 +179,35 @@ public class DMatrix {
     handle = out[0];
   }
 
+  /**
+   * Create DMatrix from a row-major dense matrix stored in a direct buffer.
+   *
+   * The buffer is read by the native library in place, without the copy made by the JVM for
+   * a float array.
+   *
+   * @param data    direct buffer of float32 values in the native byte order
+   * @param nrow    number of rows
+   * @param ncol    number of columns
+   * @param missing the specified value to represent the missing value
+   * @throws XGBoostError native error
+   */
+  public DMatrix(ByteBuffer data, long nrow, long ncol, float missing) throws XGBoostError {
+    checkDirectBuffer(data);
+    long[] out = new long[1];
+    XGBoostJNI.checkCall(XGBoostJNI.XGDMatrixCreateFromDirectBuffer(data, nrow, ncol, missing,
+                                                                    0, out));
+    handle = out[0];
+  }
+
+  static void checkDirectBuffer(ByteBuffer buffer) throws XGBoostError {
+    if (!buffer.isDirect()) {
+      throw new XGBoostError("Expecting a direct buffer.");
+    }
+    if (buffer.order() != ByteOrder.nativeOrder()) {
+      throw new XGBoostError("Expecting a buffer in the native byte order.");
+    }
+  }
+
   /**
    * used for DMatrix slice
    */
@@ -69,6 +69,10 @@ class XGBoostJNI {
   public final static native int XGDMatrixCreateFromMat(float[] data, int nrow, int ncol,
                                                         float missing, long[] out);
 
+  public final static native int XGDMatrixCreateFromDirectBuffer(ByteBuffer data, long nrow,
+                                                                 long ncol, float missing,
+                                                                 int nthread, long[] out);
+
   public final static native int XGDMatrixCreateFromMatRef(long dataRef, int nrow, int ncol,
                                                            float missing, long[] out);
 
@@ -123,6 +127,10 @@ class XGBoostJNI {
       long nrow, long ncol, float missing, int iteration_begin, int iteration_end, int predict_type, float[] margin,
       float[][] predicts);
 
+  public final static native int XGBoosterPredictFromDirectBuffer(long handle, ByteBuffer data,
+      long nrow, long ncol, float missing, int iteration_begin, int iteration_end, int predict_type,
+      ByteBuffer margin, ByteBuffer predicts, long[] outLength);
+
   public final static native int XGBoosterLoadModel(long handle, String fname);
 
   public final static native int XGBoosterSaveModel(long handle, String fname);
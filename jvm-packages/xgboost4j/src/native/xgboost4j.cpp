@@ -379,6 +379,50 @@ JNIEXPORT jint JNICALL Java_ml_dmlc_xgboost4j_java_XGBoostJNI_XGDMatrixCreateFro
   return ret;
 }
 
+namespace {
+/**
+ * @brief Get the address of a direct buffer holding at least `n` floats.
+ */
+float *GetDirectFloatBuffer(JNIEnv *jenv, jobject jbuffer, std::size_t n) {
+  auto ptr = static_cast<float *>(jenv->GetDirectBufferAddress(jbuffer));
+  CHECK(ptr) << "Expecting a direct buffer.";
+  auto capacity = jenv->GetDirectBufferCapacity(jbuffer);
+  CHECK_GE(capacity, 0);
+  CHECK_GE(static_cast<std::size_t>(capacity), n * sizeof(float))
+      << "The direct buffer is too small.";
+  return ptr;
+}
+}  // namespace
+
+/*
+ * Class:     ml_dmlc_xgboost4j_java_XGBoostJNI
+ * Method:    XGDMatrixCreateFromDirectBuffer
+ * Signature: (Ljava/nio/ByteBuffer;JJFI[J)I
+ */
+JNIEXPORT jint JNICALL Java_ml_dmlc_xgboost4j_java_XGBoostJNI_XGDMatrixCreateFromDirectBuffer(
+    JNIEnv *jenv, jclass jcls, jobject jdata, jlong jnrow, jlong jncol, jfloat jmiss,
+    jint jnthread, jlongArray jout) {
+  API_BEGIN();
+  namespace linalg = xgboost::linalg;
+  auto n = static_cast<std::size_t>(jnrow * jncol);
+  // The buffer is read in place, no copy is made by the JVM.
+  auto data = GetDirectFloatBuffer(jenv, jdata, n);
+  xgboost::Context ctx;
+  auto t_data = linalg::MakeTensorView(ctx.Device(), xgboost::common::Span{data, n}, jnrow, jncol);
+  auto s_array = linalg::ArrayInterfaceStr(t_data);
+
+  xgboost::Json config{xgboost::Object{}};
+  config["missing"] = xgboost::Number{static_cast<float>(jmiss)};
+  config["nthread"] = xgboost::Integer{static_cast<std::int32_t>(jnthread)};
+  std::string s_config;
+  xgboost::Json::Dump(config, &s_config);
+
+  DMatrixHandle result;
+  JVM_CHECK_CALL(XGDMatrixCreateFromDense(s_array.c_str(), s_config.c_str(), &result));
+  setHandle(jenv, jout, result);
+  API_END();
+}
+
 namespace {
 // Workaround int is not the same as jint. For some reason, if constexpr couldn't dispatch
 // the following.
@@ -843,6 +887,87 @@ JNIEXPORT jint JNICALL Java_ml_dmlc_xgboost4j_java_XGBoostJNI_XGBoosterPredictFr
   API_END();
 }
 
+/*
+ * Class:     ml_dmlc_xgboost4j_java_XGBoostJNI
+ * Method:    XGBoosterPredictFromDirectBuffer
+ * Signature: (JLjava/nio/ByteBuffer;JJFIIILjava/nio/ByteBuffer;Ljava/nio/ByteBuffer;[J)I
+ */
+JNIEXPORT jint JNICALL Java_ml_dmlc_xgboost4j_java_XGBoostJNI_XGBoosterPredictFromDirectBuffer(
+    JNIEnv *jenv, jclass jcls, jlong jhandle, jobject jdata, jlong num_rows, jlong num_features,
+    jfloat missing, jint iteration_begin, jint iteration_end, jint predict_type, jobject jmargin,
+    jobject jout, jlongArray jout_len) {
+  API_BEGIN();
+  auto handle = reinterpret_cast<BoosterHandle>(jhandle);
+
+  /**
+   * Create array interface, the buffers are read in place without being pinned or copied
+   * by the JVM.
+   */
+  namespace linalg = xgboost::linalg;
+  auto n_values = static_cast<std::size_t>(num_rows * num_features);
+  auto data = GetDirectFloatBuffer(jenv, jdata, n_values);
+  xgboost::Context ctx;
+  auto t_data = linalg::MakeTensorView(ctx.Device(), xgboost::common::Span{data, n_values},
+                                       num_rows, num_features);
+  auto s_array = linalg::ArrayInterfaceStr(t_data);
+
+  /**
+   * Create configuration object.
+   */
+  xgboost::Json config{xgboost::Object{}};
+  config["cache_id"] = xgboost::Integer{};
+  config["type"] = xgboost::Integer{static_cast<std::int32_t>(predict_type)};
+  config["iteration_begin"] = xgboost::Integer{static_cast<xgboost::bst_layer_t>(iteration_begin)};
+  config["iteration_end"] = xgboost::Integer{static_cast<xgboost::bst_layer_t>(iteration_end)};
+  config["missing"] = xgboost::Number{static_cast<float>(missing)};
+  config["strict_shape"] = xgboost::Boolean{true};
+  std::string s_config;
+  xgboost::Json::Dump(config, &s_config);
+
+  /**
+   * Handle base margin
+   */
+  DMatrixHandle proxy{nullptr};
+  if (jmargin) {
+    // The length of the base margin is given by the capacity of the buffer.
+    auto capacity = jenv->GetDirectBufferCapacity(jmargin);
+    CHECK_GE(capacity, 0) << "Expecting a direct buffer for the base margin.";
+    auto n_margin = static_cast<std::size_t>(capacity) / sizeof(float);
+    auto margin = GetDirectFloatBuffer(jenv, jmargin, n_margin);
+    JVM_CHECK_CALL(XGProxyDMatrixCreate(&proxy));
+    auto str = xgboost::linalg::Make1dInterface(margin, n_margin);
+    auto ret = XGDMatrixSetInfoFromInterface(proxy, "base_margin", str.c_str());
+    if (ret != 0) {
+      XGDMatrixFree(proxy);
+      return ret;
+    }
+  }
+
+  bst_ulong const *out_shape;
+  bst_ulong out_dim;
+  float const *result;
+  auto ret = XGBoosterPredictFromDense(handle, s_array.c_str(), s_config.c_str(), proxy, &out_shape,
+                                       &out_dim, &result);
+  if (proxy) {
+    XGDMatrixFree(proxy);
+  }
+  if (ret != 0) {
+    return ret;
+  }
+
+  std::size_t n{1};
+  for (std::size_t i = 0; i < out_dim; ++i) {
+    n *= out_shape[i];
+  }
+  // Write the result into the output buffer owned by the caller.
+  auto out = GetDirectFloatBuffer(jenv, jout, n);
+  std::copy_n(result, n, out);
+  jlong out_len = static_cast<jlong>(n);
+  jenv->SetLongArrayRegion(jout_len, 0, 1, &out_len);
+
+  API_END();
+}
+
 /*
  * Class:     ml_dmlc_xgboost4j_java_XGBoostJNI
  * Method:    XGBoosterLoadModel
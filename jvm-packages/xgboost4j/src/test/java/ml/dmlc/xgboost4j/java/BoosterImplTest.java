@@ -22,6 +22,8 @@ import java.io.ByteArrayInputStream;
 import java.io.ByteArrayOutputStream;
 import java.io.File;
 import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.util.*;
 import java.util.concurrent.*;
 
@@ -155,6 +157,53 @@ public class BoosterImplTest {
     assertArrayEquals(predictions, inplacePredictions);
   }
 
+  @Test
+  public void inplacePredictDirectBufferTest() throws XGBoostError {
+    int trainRows = 1000;
+    int features = 10;
+    float[] trainX = generateRandomDataSet(trainRows * features);
+    float[] trainY = generateRandomDataSet(trainRows);
+
+    ByteBuffer trainBuffer = ByteBuffer.allocateDirect(trainX.length * Float.BYTES)
+        .order(ByteOrder.nativeOrder());
+    trainBuffer.asFloatBuffer().put(trainX);
+    DMatrix trainingMatrix = new DMatrix(trainBuffer, trainRows, features, Float.NaN);
+    trainingMatrix.setLabel(trainY);
+    TestCase.assertEquals(trainRows, trainingMatrix.rowNum());
+
+    Map<String, Object> params = new HashMap<>();
+    params.put("eta", 1.0);
+    params.put("max_depth", 2);
+    params.put("tree_method", "hist");
+    Booster booster = XGBoost.train(trainingMatrix, params, 10, new HashMap<>(), null, null);
+
+    int testRows = 10;
+    float[] testX = generateRandomDataSet(testRows * features);
+    ByteBuffer testBuffer = ByteBuffer.allocateDirect(testX.length * Float.BYTES)
+        .order(ByteOrder.nativeOrder());
+    testBuffer.asFloatBuffer().put(testX);
+    ByteBuffer out = ByteBuffer.allocateDirect(testRows * Float.BYTES)
+        .order(ByteOrder.nativeOrder());
+    long n = booster.inplace_predict(testBuffer, testRows, features, Float.NaN,
+        new int[]{0, 0}, Booster.PredictionType.kValue, null, out);
+    TestCase.assertEquals(testRows, n);
+
+    float[][] expected = booster.inplace_predict(testX, testRows, features, Float.NaN);
+    float[] predictions = new float[testRows];
+    out.asFloatBuffer().get(predictions);
+    for (int i = 0; i < testRows; ++i) {
+      TestCase.assertEquals(expected[i][0], predictions[i]);
+    }
+
+    // Heap buffers are rejected.
+    try {
+      new DMatrix(ByteBuffer.allocate(16), 2, 2, Float.NaN);
+      fail("Expecting an error for a heap buffer.");
+    } catch (XGBoostError e) {
+      // expected
+    }
+  }
+
   @Test
   public void inplacePredictMultiPredictTest() throws InterruptedException {
     // Multithreaded, multiple prediction
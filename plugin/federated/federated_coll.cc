@@ -1,16 +1,19 @@
 /**
- * Copyright 2023, XGBoost contributors
+ * Copyright 2023-2025, XGBoost contributors
  */
 #include "federated_coll.h"
 
 #include <federated.grpc.pb.h>
 #include <federated.pb.h>
 
-#include <algorithm>  // for copy_n
+#include <algorithm>  // for copy_n, min
+#include <cstddef>    // for size_t
+#include <string>     // for string
+#include <utility>    // for move
 
 #include "../../src/collective/allgather.h"
 #include "../../src/common/common.h"    // for AssertGPUSupport
-#include "federated_comm.h"             // for FederatedComm
+#include "federated_comm.h"             // for FederatedComm, kStreamChunkBytes
 #include "xgboost/collective/result.h"  // for Result
 
 namespace xgboost::collective {
@@ -20,6 +23,51 @@ namespace {
               status.error_message());
 }
 
+/**
+ * @brief Run a collective with the streaming RPC, the send buffer and the reply are split
+ *        into chunks.
+ *
+ * @param header The request without the total size and the chunk.
+ */
+[[nodiscard]] Result StreamImpl(FederatedComm const *fed, std::string const &name,
+                                federated::ChunkRequest header,
+                                common::Span<std::int8_t const> data, std::string *out) {
+  grpc::ClientContext context;
+  context.set_wait_for_ready(true);
+  auto stream = fed->Handle()->CollectiveStream(&context);
+
+  header.set_total_size(data.size());
+  std::size_t offset = 0;
+  do {
+    auto n_bytes = std::min(kStreamChunkBytes, data.size() - offset);
+    federated::ChunkRequest chunk;
+    auto &request = offset == 0 ? header : chunk;
+    request.set_chunk(data.data() + offset, n_bytes);
+    if (!stream->Write(request)) {
+      // The stream is broken, the status is obtained from `Finish`.
+      break;
+    }
+    offset += n_bytes;
+  } while (offset < data.size());
+  stream->WritesDone();
+
+  out->clear();
+  federated::ChunkReply reply;
+  bool is_first = true;
+  while (stream->Read(&reply)) {
+    if (is_first) {
+      out->reserve(reply.total_size());
+      is_first = false;
+    }
+    out->append(reply.chunk());
+  }
+  grpc::Status status = stream->Finish();
+  if (!status.ok()) {
+    return GetGRPCResult(name, status);
+  }
+  return Success();
+}
+
 [[nodiscard]] Result BroadcastImpl(Comm const &comm, std::uint64_t *sequence_number,
                                    common::Span<std::int8_t> data, std::int32_t root) {
   using namespace federated;  // NOLINT
@@ -28,6 +76,28 @@ namespace {
   CHECK(fed);
   auto stub = fed->Handle();
 
+  if (data.size_bytes() > kStreamThresholdBytes) {
+    ChunkRequest header;
+    header.set_sequence_number((*sequence_number)++);
+    header.set_rank(comm.Rank());
+    header.set_collective(BROADCAST);
+    header.set_root(root);
+    std::string r;
+    common::Span<std::int8_t const> send;
+    if (comm.Rank() == root) {
+      send = data;
+    }
+    auto rc = StreamImpl(fed, "Broadcast", std::move(header), send, &r);
+    if (!rc.OK()) {
+      return rc;
+    }
+    if (comm.Rank() != root) {
+      CHECK_EQ(r.size(), data.size());
+      std::copy_n(r.cbegin(), r.size(), data.data());
+    }
+    return Success();
+  }
+
   BroadcastRequest request;
   request.set_sequence_number((*sequence_number)++);
   request.set_rank(comm.Rank());
@@ -68,6 +138,24 @@ Coll *FederatedColl::MakeCUDAVar() {
   CHECK(fed);
   auto stub = fed->Handle();
 
+  if (data.size_bytes() > kStreamThresholdBytes) {
+    ChunkRequest header;
+    header.set_sequence_number(sequence_number_++);
+    header.set_rank(comm.Rank());
+    header.set_collective(ALLREDUCE);
+    header.set_data_type(static_cast<::xgboost::collective::federated::DataType>(type));
+    header.set_reduce_operation(
+        static_cast<::xgboost::collective::federated::ReduceOperation>(op));
+    std::string r;
+    auto rc = StreamImpl(fed, "Allreduce", std::move(header), data, &r);
+    if (!rc.OK()) {
+      return rc;
+    }
+    CHECK_EQ(r.size(), data.size());
+    std::copy_n(r.cbegin(), r.size(), data.data());
+    return Success();
+  }
+
   AllreduceRequest request;
   request.set_sequence_number(sequence_number_++);
   request.set_rank(comm.Rank());
@@ -102,6 +190,21 @@ Coll *FederatedColl::MakeCUDAVar() {
   auto offset = comm.Rank() * size;
   auto segment = data.subspan(offset, size);
 
+  if (data.size_bytes() > kStreamThresholdBytes) {
+    ChunkRequest header;
+    header.set_sequence_number(sequence_number_++);
+    header.set_rank(comm.Rank());
+    header.set_collective(ALLGATHER);
+    std::string r;
+    auto rc = StreamImpl(fed, "Allgather", std::move(header), segment, &r);
+    if (!rc.OK()) {
+      return rc;
+    }
+    CHECK_EQ(r.size(), data.size());
+    std::copy_n(r.cbegin(), r.size(), data.begin());
+    return Success();
+  }
+
   AllgatherRequest request;
   request.set_sequence_number(sequence_number_++);
   request.set_rank(comm.Rank());
@@ -131,6 +234,22 @@ Coll *FederatedColl::MakeCUDAVar() {
   CHECK(fed);
   auto stub = fed->Handle();
 
+  // The size of the received buffer is known on all workers.
+  if (recv.size_bytes() > kStreamThresholdBytes) {
+    ChunkRequest header;
+    header.set_sequence_number(sequence_number_++);
+    header.set_rank(comm.Rank());
+    header.set_collective(ALLGATHER_V);
+    std::string r;
+    auto rc = StreamImpl(fed, "AllgatherV", std::move(header), data, &r);
+    if (!rc.OK()) {
+      return rc;
+    }
+    CHECK_EQ(r.size(), recv.size());
+    std::copy_n(r.cbegin(), r.size(), recv.begin());
+    return Success();
+  }
+
   AllgatherVRequest request;
   request.set_sequence_number(sequence_number_++);
   request.set_rank(comm.Rank());
@@ -1,5 +1,5 @@
 /**
- * Copyright 2023-2024, XGBoost contributors
+ * Copyright 2023-2025, XGBoost contributors
  */
 #include "federated_comm.h"
 
@@ -17,9 +17,23 @@
 #include "xgboost/logging.h"
 
 namespace xgboost::collective {
+grpc_compression_algorithm ParseCompression(StringView name) {
+  if (name == "none") {
+    return GRPC_COMPRESS_NONE;
+  } else if (name == "deflate") {
+    return GRPC_COMPRESS_DEFLATE;
+  } else if (name == "gzip") {
+    return GRPC_COMPRESS_GZIP;
+  }
+  LOG(FATAL) << "Invalid compression for federated learning: " << name
+             << ", expecting one of `none`, `deflate`, or `gzip`.";
+  return GRPC_COMPRESS_NONE;
+}
+
 void FederatedComm::Init(std::string const& host, std::int32_t port, std::int32_t world,
                          std::int32_t rank, std::string const& server_cert,
-                         std::string const& client_key, std::string const& client_cert) {
+                         std::string const& client_key, std::string const& client_cert,
+                         grpc_compression_algorithm compression) {
   this->rank_ = rank;
   this->world_ = world;
 
@@ -41,6 +55,7 @@ void FederatedComm::Init(std::string const& host, std::int32_t port, std::int32_
     stub_ = [&] {
       grpc::ChannelArguments args;
       args.SetMaxReceiveMessageSize(std::numeric_limits<std::int32_t>::max());
+      args.SetCompressionAlgorithm(compression);
       return federated::Federated::NewStub(grpc::CreateCustomChannel(
           host + ":" + std::to_string(port), grpc::InsecureChannelCredentials(), args));
     }();
@@ -52,6 +67,7 @@ void FederatedComm::Init(std::string const& host, std::int32_t port, std::int32_
       options.pem_cert_chain = common::ReadAll(client_cert);
       grpc::ChannelArguments args;
       args.SetMaxReceiveMessageSize(std::numeric_limits<std::int32_t>::max());
+      args.SetCompressionAlgorithm(compression);
       auto channel = grpc::CreateCustomChannel(host + ":" + std::to_string(port),
                                                grpc::SslCredentials(options), args);
       channel->WaitForConnected(gpr_time_add(
@@ -123,8 +139,18 @@ FederatedComm::FederatedComm(std::int32_t retry, std::chrono::seconds timeout, s
   client_key = OptionalArg<String>(config, "federated_client_key_path", client_key);
   client_cert = OptionalArg<String>(config, "federated_client_cert_path", client_cert);
 
+  /**
+   * Compression
+   */
+  std::string compression{"none"};
+  value = getenv("FEDERATED_COMPRESSION");
+  if (value != nullptr) {
+    compression = value;
+  }
+  compression = OptionalArg<String>(config, "federated_compression", compression);
+
   this->Init(parsed[0], std::stoi(parsed[1]), world_size, rank, server_cert, client_key,
-             client_cert);
+             client_cert, ParseCompression(compression));
 }
 
 #if !defined(XGBOOST_USE_CUDA)
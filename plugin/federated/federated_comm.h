@@ -1,26 +1,45 @@
 /**
- * Copyright 2023-2024, XGBoost contributors
+ * Copyright 2023-2025, XGBoost contributors
  */
 #pragma once
 
 #include <federated.grpc.pb.h>
 #include <federated.pb.h>
+#include <grpc/compression.h>  // for grpc_compression_algorithm
 
 #include <chrono>   // for seconds
+#include <cstddef>  // for size_t
 #include <cstdint>  // for int32_t
 #include <memory>   // for shared_ptr
 #include <string>   // for string
 
 #include "../../src/collective/comm.h"    // for HostComm
 #include "xgboost/json.h"
+#include "xgboost/string_view.h"          // for StringView
 
 namespace xgboost::collective {
+/**
+ * @brief Buffers larger than this are sent with the streaming RPC.
+ */
+inline constexpr std::size_t kStreamThresholdBytes = static_cast<std::size_t>(4) << 20;
+/**
+ * @brief Size of each message in the streaming RPC.
+ */
+inline constexpr std::size_t kStreamChunkBytes = static_cast<std::size_t>(1) << 20;
+
+/**
+ * @brief Get the gRPC compression algorithm from its name, one of `none`, `deflate`, or
+ *        `gzip`.
+ */
+[[nodiscard]] grpc_compression_algorithm ParseCompression(StringView name);
+
 class FederatedComm : public HostComm {
   std::shared_ptr<federated::Federated::Stub> stub_;
 
   void Init(std::string const& host, std::int32_t port, std::int32_t world, std::int32_t rank,
             std::string const& server_cert, std::string const& client_key,
-            std::string const& client_cert);
+            std::string const& client_cert,
+            grpc_compression_algorithm compression = GRPC_COMPRESS_NONE);
 
  protected:
   explicit FederatedComm(std::shared_ptr<FederatedComm const> that) : stub_{that->stub_} {
@@ -44,6 +63,9 @@ class FederatedComm : public HostComm {
    * - federated_server_cert_path
    * - federated_client_key_path
    * - federated_client_cert_path
+   * - federated_compression: Compression for the requests, one of `none`, `deflate`, or
+   *   `gzip`. The messages are compressed individually, including the chunks of large
+   *   buffers.
    */
   explicit FederatedComm(std::int32_t retry, std::chrono::seconds timeout, std::string task_id,
                          Json const& config);
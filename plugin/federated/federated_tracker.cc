@@ -6,6 +6,8 @@
 #include <grpcpp/security/server_credentials.h>  // for InsecureServerCredentials, ...
 #include <grpcpp/server_builder.h>               // for ServerBuilder
 
+#include <algorithm>  // for min
+#include <cstddef>    // for size_t
 #include <cstdint>    // for int32_t
 #include <exception>  // for exception
 #include <future>     // for future, async
@@ -13,7 +15,8 @@
 #include <string>     // for string
 
 #include "../../src/common/io.h"          // for ReadAll
-#include "../../src/common/json_utils.h"  // for RequiredArg
+#include "../../src/common/json_utils.h"  // for RequiredArg, OptionalArg
+#include "federated_comm.h"               // for ParseCompression, kStreamChunkBytes
 
 namespace xgboost::collective {
 namespace federated {
@@ -47,6 +50,68 @@ grpc::Status FederatedService::Broadcast(grpc::ServerContext*, BroadcastRequest
                      request->root());
   return grpc::Status::OK;
 }
+
+grpc::Status FederatedService::CollectiveStream(
+    grpc::ServerContext*, grpc::ServerReaderWriter<ChunkReply, ChunkRequest>* stream) {
+  ChunkRequest header;
+  std::string buffer;
+  ChunkRequest request;
+  bool is_first = true;
+  while (stream->Read(&request)) {
+    if (is_first) {
+      header = request;
+      header.clear_chunk();
+      buffer.reserve(header.total_size());
+      is_first = false;
+    }
+    buffer.append(request.chunk());
+  }
+  if (is_first) {
+    return grpc::Status{grpc::StatusCode::INVALID_ARGUMENT, "Empty collective stream."};
+  }
+  if (buffer.size() != header.total_size()) {
+    return grpc::Status{grpc::StatusCode::DATA_LOSS, "Incomplete collective stream."};
+  }
+
+  std::string result;
+  auto seq = header.sequence_number();
+  auto rank = header.rank();
+  switch (header.collective()) {
+    case ALLGATHER:
+      handler_.Allgather(buffer.data(), buffer.size(), &result, seq, rank);
+      break;
+    case ALLGATHER_V:
+      handler_.AllgatherV(buffer.data(), buffer.size(), &result, seq, rank);
+      break;
+    case ALLREDUCE:
+      handler_.Allreduce(buffer.data(), buffer.size(), &result, seq, rank,
+                         static_cast<xgboost::ArrayInterfaceHandler::Type>(header.data_type()),
+                         static_cast<xgboost::collective::Op>(header.reduce_operation()));
+      break;
+    case BROADCAST:
+      handler_.Broadcast(buffer.data(), buffer.size(), &result, seq, rank, header.root());
+      break;
+    default:
+      return grpc::Status{grpc::StatusCode::INVALID_ARGUMENT, "Invalid collective."};
+  }
+  // The send buffer is no longer needed.
+  std::string{}.swap(buffer);
+
+  std::size_t offset = 0;
+  do {
+    ChunkReply reply;
+    if (offset == 0) {
+      reply.set_total_size(result.size());
+    }
+    auto n_bytes = std::min(kStreamChunkBytes, result.size() - offset);
+    reply.set_chunk(result.data() + offset, n_bytes);
+    if (!stream->Write(reply)) {
+      return grpc::Status{grpc::StatusCode::UNAVAILABLE, "Failed to write the reply."};
+    }
+    offset += n_bytes;
+  } while (offset < result.size());
+  return grpc::Status::OK;
+}
 }  // namespace federated
 
 FederatedTracker::FederatedTracker(Json const& config) : Tracker{config} {
@@ -60,6 +125,8 @@ FederatedTracker::FederatedTracker(Json const& config) : Tracker{config} {
     client_cert_file_ = RequiredArg<String const>(config, "client_cert_path", __func__);
     CHECK(!client_cert_file_.empty()) << msg;
   }
+  compression_ = ParseCompression(
+      OptionalArg<String const>(config, "federated_compression", std::string{"none"}));
 }
 
 std::future<Result> FederatedTracker::Run() {
@@ -68,6 +135,7 @@ std::future<Result> FederatedTracker::Run() {
     xgboost::collective::federated::FederatedService service{
         static_cast<std::int32_t>(this->n_workers_)};
     grpc::ServerBuilder builder;
+    builder.SetDefaultCompressionAlgorithm(this->compression_);
 
     if (this->server_cert_file_.empty()) {
       builder.SetMaxReceiveMessageSize(std::numeric_limits<std::int32_t>::max());
@@ -1,5 +1,5 @@
 /**
- * Copyright 2022-2023, XGBoost contributors
+ * Copyright 2022-2025, XGBoost contributors
  */
 #pragma once
 #include <federated.grpc.pb.h>  // for Server
@@ -31,6 +31,10 @@ class FederatedService final : public Federated::Service {
   grpc::Status Broadcast(grpc::ServerContext* context, BroadcastRequest const* request,
                          BroadcastReply* reply) override;
 
+  grpc::Status CollectiveStream(
+      grpc::ServerContext* context,
+      grpc::ServerReaderWriter<ChunkReply, ChunkRequest>* stream) override;
+
  private:
   xgboost::collective::InMemoryHandler handler_;
 };
@@ -41,6 +45,7 @@ class FederatedTracker : public collective::Tracker {
   std::string server_key_path_;
   std::string server_cert_file_;
   std::string client_cert_file_;
+  grpc_compression_algorithm compression_{GRPC_COMPRESS_NONE};
 
  public:
   /**
@@ -52,6 +57,8 @@ class FederatedTracker : public collective::Tracker {
    * - server_key_path: path to the key.
    * - server_cert_path: certificate path.
    * - client_cert_path: certificate path for client.
+   * - federated_compression: Compression for the replies, one of `none`, `deflate`, or
+   *   `gzip`.
    */
   explicit FederatedTracker(Json const& config);
   ~FederatedTracker() override;
@@ -393,6 +393,15 @@ void HostDeviceVector<T>::SetDevice(DeviceOrd device) const {
   impl_->SetDevice(device);
 }
 
+template <typename T>
+void HostDeviceVector<T>::SetPinned(bool) {}
+
+template <typename T>
+void HostDeviceVector<T>::PrefetchToDevice() const {}
+
+template <typename T>
+void HostDeviceVector<T>::PrefetchToHost() const {}
+
 // explicit instantiations are required, as HostDeviceVector isn't header-only
 template class HostDeviceVector<bst_float>;
 template class HostDeviceVector<double>;
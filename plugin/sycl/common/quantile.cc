@@ -0,0 +1,176 @@
+/*!
+ * Copyright 2017-2025 by Contributors
+ * \file quantile.cc
+ */
+#include <oneapi/dpl/execution>
+#include <oneapi/dpl/algorithm>
+#include <oneapi/dpl/numeric>
+
+#include <cmath>
+#include <vector>
+
+#include "quantile.h"
+
+#include "../../src/collective/communicator-inl.h"
+
+namespace xgboost {
+namespace sycl {
+namespace common {
+
+bool CanSketchOnDevice(DMatrix* dmat) {
+  const auto& info = dmat->Info();
+  return info.weights_.Size() == 0 && !info.HasCategorical() &&
+         !collective::IsDistributed() && info.num_nonzero_ > 0;
+}
+
+xgboost::common::HistogramCuts SketchOnDevice(::sycl::queue* qu, Context const* ctx,
+                                              DMatrix* dmat, int max_bins) {
+  CHECK_GT(max_bins, 1);
+  const size_t n_features = dmat->Info().num_col_;
+
+  size_t nnz = 0;
+  for (const auto& batch : dmat->GetBatches<SparsePage>()) {
+    nnz += batch.data.Size();
+  }
+  CHECK_GT(nnz, 0U);
+
+  USMVector<Entry, MemoryType::on_device> entries(qu, nnz);
+  size_t pos = 0;
+  for (const auto& batch : dmat->GetBatches<SparsePage>()) {
+    batch.data.SetDevice(ctx->Device());
+    const size_t batch_nnz = batch.data.Size();
+    if (batch_nnz > 0) {
+      qu->memcpy(entries.Data() + pos, batch.data.ConstDevicePointer(),
+                 batch_nnz * sizeof(Entry)).wait();
+    }
+    pos += batch_nnz;
+  }
+
+  // Sort by feature and by value within the feature.
+  auto policy = oneapi::dpl::execution::make_device_policy(*qu);
+  oneapi::dpl::sort(policy, entries.Begin(), entries.End(),
+                    [](const Entry& l, const Entry& r) {
+                      return l.index < r.index || (l.index == r.index && l.fvalue < r.fvalue);
+                    });
+
+  const Entry* entries_ptr = entries.DataConst();
+
+  // Column pointers from the boundaries of the sorted features, and a flag for the first entry
+  // of each unique value.
+  USMVector<size_t, MemoryType::on_device> column_ptr(qu, n_features + 1);
+  USMVector<size_t, MemoryType::on_device> run_flag(qu, nnz + 1);
+  size_t* column_ptr_ptr = column_ptr.Data();
+  size_t* run_flag_ptr = run_flag.Data();
+  qu->submit([&](::sycl::handler& cgh) {
+    cgh.parallel_for<>(::sycl::range<1>(nnz + 1), [=](::sycl::item<1> pid) {
+      const size_t i = pid.get_id(0);
+      if (i == nnz) {
+        run_flag_ptr[i] = 0;
+        for (size_t fid = entries_ptr[nnz - 1].index + 1; fid <= n_features; ++fid) {
+          column_ptr_ptr[fid] = nnz;
+        }
+        return;
+      }
+      const Entry e = entries_ptr[i];
+      const size_t fid_begin = (i == 0) ? 0 : entries_ptr[i - 1].index + 1;
+      for (size_t fid = fid_begin; fid <= e.index; ++fid) {
+        column_ptr_ptr[fid] = i;
+      }
+      const bool is_run_start = (i == 0) || (entries_ptr[i - 1].index != e.index) ||
+                                (entries_ptr[i - 1].fvalue != e.fvalue);
+      run_flag_ptr[i] = is_run_start ? 1 : 0;
+    });
+  }).wait();
+
+  // Rank of each unique value over all features.
+  USMVector<size_t, MemoryType::on_device> run_id(qu, nnz + 1);
+  oneapi::dpl::exclusive_scan(policy, run_flag.Begin(), run_flag.End(), run_id.Begin(),
+                              size_t{0});
+  const size_t* run_id_ptr = run_id.DataConst();
+
+  USMVector<float, MemoryType::on_device> cut_buff(qu, n_features * max_bins);
+  USMVector<uint32_t, MemoryType::on_device> n_cuts(qu, n_features);
+  USMVector<float, MemoryType::on_device> min_max(qu, 2 * n_features, 0.0f);
+  float* cut_buff_ptr = cut_buff.Data();
+  uint32_t* n_cuts_ptr = n_cuts.Data();
+  float* min_max_ptr = min_max.Data();
+  const size_t n_bins = max_bins;
+
+  // Features with few unique values take all of them, except for the minimum.
+  ::sycl::event event = qu->submit([&](::sycl::handler& cgh) {
+    cgh.parallel_for<>(::sycl::range<1>(nnz), [=](::sycl::item<1> pid) {
+      const size_t i = pid.get_id(0);
+      const size_t fid = entries_ptr[i].index;
+      const size_t beg = column_ptr_ptr[fid];
+      const size_t n_unique = run_id_ptr[column_ptr_ptr[fid + 1]] - run_id_ptr[beg];
+      if (n_unique <= n_bins && run_flag_ptr[i] && i != beg) {
+        cut_buff_ptr[fid * n_bins + run_id_ptr[i] - run_id_ptr[beg] - 1] = entries_ptr[i].fvalue;
+      }
+    });
+  });
+
+  // Others take the values at evenly spaced ranks, skipping the duplicates.
+  qu->submit([&](::sycl::handler& cgh) {
+    cgh.depends_on(event);
+    cgh.parallel_for<>(::sycl::range<1>(n_features), [=](::sycl::item<1> pid) {
+      const size_t fid = pid.get_id(0);
+      const size_t beg = column_ptr_ptr[fid];
+      const size_t n = column_ptr_ptr[fid + 1] - beg;
+      const size_t n_unique = run_id_ptr[beg + n] - run_id_ptr[beg];
+      if (n > 0) {
+        min_max_ptr[2 * fid] = entries_ptr[beg].fvalue;
+        min_max_ptr[2 * fid + 1] = entries_ptr[beg + n - 1].fvalue;
+      }
+      if (n_unique <= n_bins) {
+        n_cuts_ptr[fid] = n_unique > 0 ? n_unique - 1 : 0;
+        return;
+      }
+      float* out = cut_buff_ptr + fid * n_bins;
+      uint32_t k = 0;
+      for (size_t i = 1; i < n_bins; ++i) {
+        const float v = entries_ptr[beg + i * (n - 1) / n_bins].fvalue;
+        if (k == 0 || v > out[k - 1]) {
+          out[k++] = v;
+        }
+      }
+      n_cuts_ptr[fid] = k;
+    });
+  }).wait();
+
+  std::vector<size_t> column_ptr_h(n_features + 1);
+  std::vector<uint32_t> n_cuts_h(n_features);
+  std::vector<float> cut_buff_h(n_features * max_bins);
+  std::vector<float> min_max_h(2 * n_features);
+  qu->memcpy(column_ptr_h.data(), column_ptr_ptr, column_ptr_h.size() * sizeof(size_t));
+  qu->memcpy(n_cuts_h.data(), n_cuts_ptr, n_cuts_h.size() * sizeof(uint32_t));
+  qu->memcpy(cut_buff_h.data(), cut_buff_ptr, cut_buff_h.size() * sizeof(float));
+  qu->memcpy(min_max_h.data(), min_max_ptr, min_max_h.size() * sizeof(float));
+  qu->wait();
+
+  // Assemble the cuts in the same layout as the host sketch.
+  xgboost::common::HistogramCuts cuts;
+  auto& cut_values = cuts.cut_values_.HostVector();
+  auto& cut_ptrs = cuts.cut_ptrs_.HostVector();
+  auto& min_vals = cuts.min_vals_.HostVector();
+  min_vals.resize(n_features, 0.0f);
+  for (size_t fid = 0; fid < n_features; ++fid) {
+    const bool is_empty = column_ptr_h[fid + 1] == column_ptr_h[fid];
+    if (is_empty) {
+      min_vals[fid] = 1e-5f;
+    } else {
+      const float mval = min_max_h[2 * fid];
+      min_vals[fid] = mval - std::fabs(mval) - 1e-5f;
+    }
+    const float* feature_cuts = cut_buff_h.data() + fid * max_bins;
+    cut_values.insert(cut_values.end(), feature_cuts, feature_cuts + n_cuts_h[fid]);
+    // push a value that is greater than anything
+    const float cpt = is_empty ? min_vals[fid] : min_max_h[2 * fid + 1];
+    cut_values.push_back(cpt + (std::fabs(cpt) + 1e-5f));
+    cut_ptrs.push_back(static_cast<uint32_t>(cut_values.size()));
+  }
+  return cuts;
+}
+
+}  // namespace common
+}  // namespace sycl
+}  // namespace xgboost
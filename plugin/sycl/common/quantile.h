@@ -0,0 +1,39 @@
+/*!
+ * Copyright 2017-2025 by Contributors
+ * \file quantile.h
+ */
+#ifndef PLUGIN_SYCL_COMMON_QUANTILE_H_
+#define PLUGIN_SYCL_COMMON_QUANTILE_H_
+
+#include "../data.h"
+
+#include "../../src/common/hist_util.h"
+
+#include <sycl/sycl.hpp>
+
+namespace xgboost {
+namespace sycl {
+namespace common {
+
+/*!
+ * \brief Whether the cuts of the DMatrix can be built on device by SketchOnDevice.
+ *
+ *  Weighted samples, categorical features and distributed training require the weighted
+ *  sketch with the allreduce of the summaries, they use the host sketch instead.
+ */
+bool CanSketchOnDevice(DMatrix* dmat);
+
+/*!
+ * \brief Build the histogram cuts from the USM copy of the DMatrix data.
+ *
+ *  The entries are sorted by (feature, value) on device, then a feature with no more unique
+ *  values than max_bins takes all of them as cuts, and others take values at evenly spaced
+ *  ranks. Only the cuts are copied back to the host.
+ */
+xgboost::common::HistogramCuts SketchOnDevice(::sycl::queue* qu, Context const* ctx,
+                                              DMatrix* dmat, int max_bins);
+
+}  // namespace common
+}  // namespace sycl
+}  // namespace xgboost
+#endif  // PLUGIN_SYCL_COMMON_QUANTILE_H_
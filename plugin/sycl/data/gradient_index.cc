@@ -7,6 +7,7 @@
 #include <algorithm>
 
 #include "gradient_index.h"
+#include "../common/quantile.h"
 
 #include <sycl/sycl.hpp>
 
@@ -118,7 +119,11 @@ void GHistIndexMatrix::Init(::sycl::queue* qu,
                             int max_bins) {
   nfeatures = dmat->Info().num_col_;
 
-  cut = xgboost::common::SketchOnDMatrix(ctx, dmat, max_bins);
+  if (CanSketchOnDevice(dmat)) {
+    cut = SketchOnDevice(qu, ctx, dmat, max_bins);
+  } else {
+    cut = xgboost::common::SketchOnDMatrix(ctx, dmat, max_bins);
+  }
   cut.SetDevice(ctx->Device());
 
   max_num_bins = max_bins;
@@ -7,6 +7,7 @@
 #pragma GCC diagnostic pop
 
 #include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <mutex>
 
@@ -87,6 +88,11 @@ class Node {
 };
 
 class DeviceModel {
+  // The model version and the tree range of the nodes on device.
+  std::uint64_t version_{0};
+  size_t tree_begin_{0};
+  size_t tree_end_{0};
+
  public:
   USMVector<Node> nodes;
   HostDeviceVector<size_t> first_node_position;
@@ -97,7 +103,16 @@ class DeviceModel {
     tree_group.SetDevice(device);
   }
 
+  // Copy the trees to the device, skipped if the same trees are already copied.
   void Init(::sycl::queue* qu, const gbm::GBTreeModel& model, size_t tree_begin, size_t tree_end) {
+    if (version_ != 0 && version_ == model.Version() && tree_begin_ == tree_begin &&
+        tree_end_ == tree_end) {
+      return;
+    }
+    version_ = model.Version();
+    tree_begin_ = tree_begin;
+    tree_end_ = tree_end;
+
     int n_nodes = 0;
     first_node_position.Resize((tree_end - tree_begin) + 1);
     auto& first_node_position_host = first_node_position.HostVector();
@@ -318,6 +333,82 @@ class Predictor : public xgboost::Predictor {
     });
   }
 
+  // Number of work-items walking the trees for the same row.
+  static constexpr size_t kWorkGroupSize = 64;
+  // Rows of a batch below which the work-group traversal is used.
+  static constexpr size_t kMaxWorkGroupRows = 2048;
+
+  /**
+   * One work-group for each row. The row is loaded into the local memory, then the
+   * work-items walk different trees of the same row and their results are reduced. This
+   * keeps the device busy for small batches, where a work-item for each row doesn't expose
+   * enough parallelism.
+   */
+  template <bool any_missing>
+  void PredictKernelWorkGroup(::sycl::event* event,
+                              const Entry* data,
+                              float* out_predictions,
+                              const size_t* row_ptr,
+                              size_t num_rows,
+                              size_t num_features,
+                              size_t num_group,
+                              size_t tree_begin,
+                              size_t tree_end) const {
+    const Node* nodes = device_model.nodes.DataConst();
+    const size_t* first_node_position = device_model.first_node_position.ConstDevicePointer();
+    const int* tree_group = device_model.tree_group.ConstDevicePointer();
+
+    *event = qu_->submit([&](::sycl::handler& cgh) {
+      cgh.depends_on(*event);
+      ::sycl::local_accessor<float, 1> fval_local(::sycl::range<1>(num_features), cgh);
+      ::sycl::local_accessor<uint8_t, 1> miss_local(
+          ::sycl::range<1>(any_missing ? num_features : 1), cgh);
+      ::sycl::nd_range<1> range(::sycl::range<1>(num_rows * kWorkGroupSize),
+                                ::sycl::range<1>(kWorkGroupSize));
+      cgh.parallel_for<>(range, [=](::sycl::nd_item<1> item) {
+        size_t row_idx = item.get_group(0);
+        size_t tid = item.get_local_id(0);
+        auto group = item.get_group();
+        float* fval = &fval_local[0];
+        uint8_t* miss = &miss_local[0];
+
+        if constexpr (any_missing) {
+          for (size_t fidx = tid; fidx < num_features; fidx += kWorkGroupSize) {
+            miss[fidx] = 1;
+          }
+          ::sycl::group_barrier(group);
+        }
+        for (size_t i = row_ptr[row_idx] + tid; i < row_ptr[row_idx + 1]; i += kWorkGroupSize) {
+          fval[data[i].index] = data[i].fvalue;
+          if constexpr (any_missing) {
+            miss[data[i].index] = 0;
+          }
+        }
+        ::sycl::group_barrier(group);
+
+        for (size_t gid = 0; gid < num_group; ++gid) {
+          float sum = 0.0;
+          for (size_t tree_idx = tree_begin + tid; tree_idx < tree_end;
+               tree_idx += kWorkGroupSize) {
+            if (num_group > 1 && static_cast<size_t>(tree_group[tree_idx]) != gid) {
+              continue;
+            }
+            const Node* first_node = nodes + first_node_position[tree_idx - tree_begin];
+            if constexpr (any_missing) {
+              sum += GetLeafWeight(first_node, fval, miss);
+            } else {
+              sum += GetLeafWeight(first_node, fval);
+            }
+          }
+          sum = ::sycl::reduce_over_group(group, sum, ::sycl::plus<float>());
+          if (tid == 0) {
+            out_predictions[row_idx * num_group + gid] += sum;
+          }
+        }
+      });
+    });
+  }
+
   template <bool any_missing>
   void DevicePredictInternal(DMatrix *dmat,
                              HostDeviceVector<float>* out_preds,
@@ -333,6 +424,12 @@ class Predictor : public xgboost::Predictor {
     int num_features = dmat->Info().num_col_;
 
     float* out_predictions = out_preds->DevicePointer();
+    // The row must fit into the local memory.
+    size_t row_bytes = num_features * (sizeof(float) + (any_missing ? sizeof(uint8_t) : 0));
+    size_t local_mem_size = qu_->get_device().get_info<::sycl::info::device::local_mem_size>();
+    auto use_work_group = [&](size_t batch_size) {
+      return batch_size <= kMaxWorkGroupRows && row_bytes <= local_mem_size;
+    };
     ::sycl::event event;
     for (auto &batch : dmat->GetBatches<SparsePage>()) {
       batch.data.SetDevice(ctx_->Device());
@@ -343,6 +440,16 @@ class Predictor : public xgboost::Predictor {
       if (batch_size > 0) {
         const auto base_rowid = batch.base_rowid;
 
+        if (use_work_group(batch_size)) {
+          // The row buffers are not used, they are still outdated for the next call.
+          PredictKernelWorkGroup<any_missing>(&event, data,
+                                              out_predictions + base_rowid * num_group,
+                                              row_ptr, batch_size, num_features,
+                                              num_group, tree_begin, tree_end);
+          needs_buffer_update = true;
+          continue;
+        }
+
         if (needs_buffer_update) {
           fval_buff.ResizeNoCopy(qu_, num_features * batch_size);
           if constexpr (any_missing) {
@@ -350,7 +457,7 @@ class Predictor : public xgboost::Predictor {
           }
         }
 
-        PredictKernel<any_missing>(&event, data, out_predictions + base_rowid,
+        PredictKernel<any_missing>(&event, data, out_predictions + base_rowid * num_group,
                                    row_ptr, batch_size, num_features,
                                    num_group, tree_begin, tree_end);
         needs_buffer_update = (batch_size != out_preds->Size());
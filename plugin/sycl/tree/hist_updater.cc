@@ -10,6 +10,7 @@
 #include <functional>
 
 #include "../../src/tree/common_row_partitioner.h"
+#include "../../src/tree/driver.h"
 
 #include "../common/hist_util.h"
 #include "../../src/collective/allreduce.h"
@@ -64,14 +65,23 @@ void HistUpdater<GradientSumT>::BuildHistogramsLossGuide(
     const common::GHistIndexMatrix &gmat,
     RegTree *p_tree,
     const HostDeviceVector<GradientPair>& gpair) {
-  nodes_for_explicit_hist_build_.clear();
-  nodes_for_subtraction_trick_.clear();
-  nodes_for_explicit_hist_build_.push_back(entry);
-
+  std::vector<ExpandEntry> nodes{entry};
   if (!(*p_tree)[entry.nid].IsRoot()) {
     auto sibling_id = entry.GetSiblingId(p_tree);
-    nodes_for_subtraction_trick_.emplace_back(sibling_id, p_tree->GetDepth(sibling_id));
+    nodes.emplace_back(sibling_id, p_tree->GetDepth(sibling_id));
   }
+  BuildHistogramsLossGuide(nodes, gmat, p_tree, gpair);
+}
+
+template <typename GradientSumT>
+void HistUpdater<GradientSumT>::BuildHistogramsLossGuide(
+    const std::vector<ExpandEntry>& nodes,
+    const common::GHistIndexMatrix &gmat,
+    RegTree *p_tree,
+    const HostDeviceVector<GradientPair>& gpair) {
+  nodes_for_explicit_hist_build_.clear();
+  nodes_for_subtraction_trick_.clear();
+  SplitSiblings(nodes, &nodes_for_explicit_hist_build_, &nodes_for_subtraction_trick_, p_tree);
 
   std::vector<int> sync_ids;
   hist_rows_adder_->AddHistRows(this, &sync_ids, p_tree);
@@ -265,28 +275,32 @@ void HistUpdater<GradientSumT>::ExpandWithLossGuide(
     RegTree* p_tree,
     const HostDeviceVector<GradientPair>& gpair) {
   builder_monitor_.Start("ExpandWithLossGuide");
-  int num_leaves = 0;
   const auto lr = param_.learning_rate;
+  xgboost::tree::Driver<ExpandEntry> driver(param_);
 
   ExpandEntry node(ExpandEntry::kRootNid, p_tree->GetDepth(ExpandEntry::kRootNid));
-  BuildHistogramsLossGuide(node, gmat, p_tree, gpair);
+  BuildHistogramsLossGuide(std::vector<ExpandEntry>{node}, gmat, p_tree, gpair);
 
   this->InitNewNode(ExpandEntry::kRootNid, gmat, gpair, *p_tree);
 
   this->EvaluateSplits({node}, gmat, *p_tree);
   node.split.loss_chg = snode_host_[ExpandEntry::kRootNid].best.loss_chg;
-
-  qexpand_loss_guided_->push(node);
-  ++num_leaves;
-
-  while (!qexpand_loss_guided_->empty()) {
-    const ExpandEntry candidate = qexpand_loss_guided_->top();
-    const int nid = candidate.nid;
-    qexpand_loss_guided_->pop();
-    if (!candidate.IsValid(param_, num_leaves)) {
-      (*p_tree)[nid].SetLeaf(snode_host_[nid].weight * lr);
-    } else {
-      auto evaluator = tree_evaluator_.GetEvaluator();
+  if (!node.IsValid(param_, 1)) {
+    (*p_tree)[ExpandEntry::kRootNid].SetLeaf(snode_host_[ExpandEntry::kRootNid].weight * lr);
+  }
+  driver.Push(node);
+
+  // The driver returns a single node when the number of leaves is limited, otherwise all
+  // the expandable nodes. Nodes that are not expanded keep the leaf value set by their
+  // parent. The children of a batch are processed together, each pair of siblings has one
+  // histogram built from the data and the other obtained by subtraction.
+  std::vector<ExpandEntry> expand_set;
+  std::vector<ExpandEntry> children;
+  driver.Pop(&expand_set);
+  while (!expand_set.empty()) {
+    auto evaluator = tree_evaluator_.GetEvaluator();
+    for (auto const& candidate : expand_set) {
+      const int nid = candidate.nid;
       NodeEntry<GradientSumT>& e = snode_host_[nid];
       bst_float left_leaf_weight =
           evaluator.CalcWeight(nid, GradStats<GradientSumT>{e.best.left_sum}) * lr;
@@ -296,37 +310,36 @@ void HistUpdater<GradientSumT>::ExpandWithLossGuide(
                          e.best.DefaultLeft(), e.weight, left_leaf_weight,
                          right_leaf_weight, e.best.loss_chg, e.stats.GetHess(),
                          e.best.left_sum.GetHess(), e.best.right_sum.GetHess());
+    }
+    this->ApplySplit(expand_set, gmat, p_tree);
+
+    children.clear();
+    for (auto const& candidate : expand_set) {
+      const int cleft = (*p_tree)[candidate.nid].LeftChild();
+      const int cright = (*p_tree)[candidate.nid].RightChild();
+      children.emplace_back(cleft, p_tree->GetDepth(cleft));
+      children.emplace_back(cright, p_tree->GetDepth(cright));
+    }
+    BuildHistogramsLossGuide(children, gmat, p_tree, gpair);
 
-      this->ApplySplit({candidate}, gmat, p_tree);
-
+    for (auto const& candidate : expand_set) {
+      const int nid = candidate.nid;
       const int cleft = (*p_tree)[nid].LeftChild();
       const int cright = (*p_tree)[nid].RightChild();
-
-      ExpandEntry left_node(cleft, p_tree->GetDepth(cleft));
-      ExpandEntry right_node(cright, p_tree->GetDepth(cright));
-
-      if (row_set_collection_[cleft].Size() < row_set_collection_[cright].Size()) {
-        BuildHistogramsLossGuide(left_node, gmat, p_tree, gpair);
-      } else {
-        BuildHistogramsLossGuide(right_node, gmat, p_tree, gpair);
-      }
-
       this->InitNewNode(cleft, gmat, gpair, *p_tree);
       this->InitNewNode(cright, gmat, gpair, *p_tree);
       bst_uint featureid = snode_host_[nid].best.SplitIndex();
       tree_evaluator_.AddSplit(nid, cleft, cright, featureid,
                                snode_host_[cleft].weight, snode_host_[cright].weight);
       interaction_constraints_.Split(nid, featureid, cleft, cright);
+    }
 
-      this->EvaluateSplits({left_node, right_node}, gmat, *p_tree);
-      left_node.split.loss_chg = snode_host_[cleft].best.loss_chg;
-      right_node.split.loss_chg = snode_host_[cright].best.loss_chg;
-
-      qexpand_loss_guided_->push(left_node);
-      qexpand_loss_guided_->push(right_node);
-
-      ++num_leaves;  // give two and take one, as parent is no longer a leaf
+    this->EvaluateSplits(children, gmat, *p_tree);
+    for (auto& child : children) {
+      child.split.loss_chg = snode_host_[child.nid].best.loss_chg;
     }
+    driver.Push(children);
+    driver.Pop(&expand_set);
   }
   builder_monitor_.Stop("ExpandWithLossGuide");
 }
@@ -606,12 +619,8 @@ void HistUpdater<GradientSumT>::InitData(
 
   std::fill(snode_host_.begin(), snode_host_.end(),  NodeEntry<GradientSumT>(param_));
 
-  {
-    if (param_.grow_policy == xgboost::tree::TrainParam::kLossGuide) {
-      qexpand_loss_guided_.reset(new ExpandQueue(LossGuide));
-    } else {
-      qexpand_depth_wise_.clear();
-    }
+  if (param_.grow_policy != xgboost::tree::TrainParam::kLossGuide) {
+    qexpand_depth_wise_.clear();
   }
   builder_monitor_.Stop("InitData");
 }
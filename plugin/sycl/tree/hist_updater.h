@@ -13,7 +13,6 @@
 
 #include <vector>
 #include <memory>
-#include <queue>
 #include <utility>
 
 #include "../common/partition_builder.h"
@@ -176,26 +175,27 @@ class HistUpdater {
                             RegTree *p_tree,
                             const HostDeviceVector<GradientPair>& gpair);
 
+  // Build the histograms of the node and its sibling.
   void BuildHistogramsLossGuide(
                       ExpandEntry entry,
                       const common::GHistIndexMatrix &gmat,
                       RegTree *p_tree,
                       const HostDeviceVector<GradientPair>& gpair);
 
+  // Build the histograms of the nodes, the siblings must be in the same set. The smaller
+  // one of two siblings is built from the data, the other one by subtraction.
+  void BuildHistogramsLossGuide(
+                      const std::vector<ExpandEntry>& nodes,
+                      const common::GHistIndexMatrix &gmat,
+                      RegTree *p_tree,
+                      const HostDeviceVector<GradientPair>& gpair);
+
   void ExpandWithLossGuide(const common::GHistIndexMatrix& gmat,
                            RegTree* p_tree,
                            const HostDeviceVector<GradientPair>& gpair);
 
   void ReduceHists(const std::vector<int>& sync_ids, size_t nbins);
 
-  inline static bool LossGuide(ExpandEntry lhs, ExpandEntry rhs) {
-    if (lhs.GetLossChange() == rhs.GetLossChange()) {
-      return lhs.GetNodeId() > rhs.GetNodeId();  // favor small timestamp
-    } else {
-      return lhs.GetLossChange() < rhs.GetLossChange();  // favor large loss_chg
-    }
-  }
-
   //  --data fields--
   const Context* ctx_;
   bool has_fp64_support_;
@@ -220,11 +220,6 @@ class HistUpdater {
   const RegTree* p_last_tree_;
   DMatrix const* const p_last_fmat_;
 
-  using ExpandQueue =
-      std::priority_queue<ExpandEntry, std::vector<ExpandEntry>,
-                          std::function<bool(ExpandEntry, ExpandEntry)>>;
-
-  std::unique_ptr<ExpandQueue> qexpand_loss_guided_;
   std::vector<ExpandEntry> qexpand_depth_wise_;
 
   enum DataLayout { kDenseDataZeroBased, kDenseDataOneBased, kSparseData };
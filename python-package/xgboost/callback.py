@@ -6,6 +6,7 @@
 import collections
 import os
 import pickle
+import re
 from abc import ABC
 from typing import (
     Any,
@@ -28,6 +29,7 @@ from .core import (
     DMatrix,
     XGBoostError,
     _deprecate_positional_args,
+    _parse_eval_iteration,
     _parse_eval_str,
 )
 
@@ -192,6 +194,14 @@ class CallbackContainer:
 
     def after_training(self, model: _Model) -> _Model:
         """Function called after training."""
+        if not self.is_cv:
+            # The last iteration of the asynchronous evaluation.
+            score = cast(Booster, model).eval_pending()
+            if score:
+                epoch = _parse_eval_iteration(score)
+                self._update_history(_parse_eval_str(score), epoch)
+                for c in self.callbacks:
+                    c.after_iteration(model, epoch, self.history)
         for c in self.callbacks:
             model = c.after_training(model=model)
             msg = "after_training should return the model"
@@ -254,6 +264,8 @@ class CallbackContainer:
         """Function called after training iteration."""
         if self.is_cv:
             scores = model.eval(epoch, self.metric, self._output_margin)
+            if not all(scores):
+                raise ValueError("`async_eval` is not supported by cv.")
             scores = _aggcv(scores)
             self.aggregated_cv = scores
             self._update_history(scores, epoch)
@@ -262,6 +274,11 @@ class CallbackContainer:
             for _, name in evals:
                 assert name.find("-") == -1, "Dataset name should not contain `-`"
             score: str = model.eval_set(evals, epoch, self.metric, self._output_margin)
+            if not score:
+                # The asynchronous evaluation doesn't have any result yet.
+                return False
+            # With asynchronous evaluation, the result is from the previous iteration.
+            epoch = _parse_eval_iteration(score)
             metric_score = _parse_eval_str(score)
             self._update_history(metric_score, epoch)
         ret = any(c.after_iteration(model, epoch, self.history) for c in self.callbacks)
@@ -603,6 +620,14 @@ class TrainingCheckPoint(TrainingCallback):
     interval :
         Interval of checkpointing.  Checkpointing is slow so setting a larger number can
         reduce performance hit.
+    incremental :
+        When set to True, only the first checkpoint contains the full model. The
+        following checkpoints contain only the trees added since the previous one and
+        are saved as name_i.delta.ubj, which reduces the total size of the checkpoints
+        from quadratic to linear in the number of boosting rounds. Use :py:meth:`merge`
+        to restore the model. Only the `gbtree` booster is supported.
+
+        .. versionadded:: 3.1.0
 
     """
 
@@ -614,28 +639,86 @@ class TrainingCheckPoint(TrainingCallback):
         name: str = "model",
         as_pickle: bool = False,
         interval: int = 100,
+        incremental: bool = False,
     ) -> None:
+        if incremental and as_pickle:
+            raise ValueError("`incremental` is not supported when `as_pickle` is True.")
         self._path = os.fspath(directory)
         self._name = name
         self._as_pickle = as_pickle
         self._iterations = interval
+        self._incremental = incremental
         self._epoch = 0  # counter for iterval
         self._start = 0  # beginning iteration
+        self._saved: Optional[int] = None  # number of rounds in the saved checkpoints
         super().__init__()
 
     def before_training(self, model: _Model) -> _Model:
         self._start = model.num_boosted_rounds()
+        self._saved = None
         return model
 
+    def _save_delta(self, model: Booster, path: str) -> None:
+        assert self._saved is not None
+        delta = model[self._saved :]
+        # Slicing removes the attributes like `best_iteration`.
+        delta.set_attr(**model.attributes())
+        delta.save_model(path)
+
+    @classmethod
+    def merge(cls, directory: Union[str, os.PathLike], name: str = "model") -> Booster:
+        """Restore the model from the checkpoints written with `incremental` set to
+        True, by appending the trees of the delta checkpoints to the latest full one.
+
+        .. versionadded:: 3.1.0
+
+        Parameters
+        ----------
+        directory :
+            Model directory of the checkpoints.
+        name :
+            Name of the checkpoints.
+
+        """
+        path = os.fspath(directory)
+        full = re.compile(rf"{re.escape(name)}_(\d+)\.{cls.default_format}")
+        delta = re.compile(rf"{re.escape(name)}_(\d+)\.delta\.{cls.default_format}")
+        full_its, delta_its = [], []
+        for fname in os.listdir(path):
+            if matched := full.fullmatch(fname):
+                full_its.append(int(matched.group(1)))
+            elif matched := delta.fullmatch(fname):
+                delta_its.append(int(matched.group(1)))
+        if not full_its:
+            raise ValueError(f"No checkpoint named `{name}` is found in {path}.")
+
+        base = max(full_its)
+        booster = Booster(
+            model_file=os.path.join(path, f"{name}_{base}.{cls.default_format}")
+        )
+        for it in sorted(i for i in delta_its if i > base):
+            segment = Booster(
+                model_file=os.path.join(
+                    path, f"{name}_{it}.delta.{cls.default_format}"
+                )
+            )
+            n_rounds = booster.num_boosted_rounds() + segment.num_boosted_rounds()
+            if n_rounds != it + 1:
+                raise ValueError(f"Missing checkpoint before iteration {it}.")
+            booster.append(segment)
+        return booster
+
     def after_iteration(
         self, model: _Model, epoch: int, evals_log: TrainingCallback.EvalsLog
     ) -> bool:
         if self._epoch == self._iterations:
+            is_delta = self._incremental and self._saved is not None
             path = os.path.join(
                 self._path,
                 self._name
                 + "_"
                 + (str(epoch + self._start))
+                + (".delta" if is_delta else "")
                 + (".pkl" if self._as_pickle else f".{self.default_format}"),
             )
             self._epoch = 0  # reset counter
@@ -644,7 +727,10 @@ class TrainingCheckPoint(TrainingCallback):
                 if self._as_pickle:
                     with open(path, "wb") as fd:
                         pickle.dump(model, fd)
+                elif is_delta:
+                    self._save_delta(model, path)
                 else:
                     model.save_model(path)
+            self._saved = model.num_boosted_rounds()
         self._epoch += 1
         return False
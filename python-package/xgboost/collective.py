@@ -1,12 +1,13 @@
 """XGBoost collective communication related API."""
 
 import ctypes
+import json
 import logging
 import os
 import pickle
 from dataclasses import dataclass
 from enum import IntEnum, unique
-from typing import Any, Dict, Optional, TypeAlias, Union
+from typing import Any, Dict, List, Optional, TypeAlias, Union
 
 import numpy as np
 
@@ -82,6 +83,10 @@ def init(**args: _ArgVals) -> None:
           - dmlc_retry: The number of retry when handling network errors.
           - dmlc_timeout: Timeout in seconds.
           - dmlc_nccl_path: Path to load (dlopen) nccl for GPU-based communication.
+          - dmlc_shared_memory: Use shared memory when all workers are on the same host.
+          - dmlc_tcp_streams: The number of TCP connections between each pair of
+            workers. Large messages are split across them, which can help saturating
+            high bandwidth links like IPoIB.
 
         Only applicable to the Federated communicator:
           - federated_server_address: Address of the federated server.
@@ -168,6 +173,62 @@ def get_processor_name() -> str:
     return py_str(value)
 
 
+def get_stats(reset: bool = False) -> Dict[str, Dict[str, Any]]:
+    """Get the statistics of the collective calls made by the current worker, grouped by
+    the operation and the call site.
+
+    .. versionadded:: 3.1.0
+
+    Parameters
+    ----------
+    reset :
+        Clear the statistics after they are returned.
+
+    Returns
+    -------
+    stats :
+        Number of calls, data size, bytes sent and received, wall time, wait time and
+        the algorithm for each call site.
+    """
+    out = ctypes.c_char_p()
+    _check_call(_LIB.XGCommunicatorGetStats(make_jcargs(reset=reset), ctypes.byref(out)))
+    assert out.value is not None
+    return json.loads(py_str(out.value))
+
+
+def plan_rebalance(tolerance: float = 0.1) -> Dict[str, List[Dict[str, Any]]]:
+    """Plan the migration of training rows from the slow workers to the fast ones in
+    row-split training, based on the ``worker_load`` in :py:func:`get_stats`. This is a
+    collective call, all workers should call it at an iteration boundary and obtain the
+    same plan.
+
+    .. versionadded:: 3.1.0
+
+    The rows are not moved by XGBoost. Re-partition the data according to the plan and
+    continue the training from a checkpoint.
+
+    Parameters
+    ----------
+    tolerance :
+        No transfer is planned if the build time of the slowest worker is within
+        ``1 + tolerance`` of the mean.
+
+    Returns
+    -------
+    plan :
+        The ``loads`` of all workers, and the ``transfers`` with the ``src`` rank, the
+        ``dst`` rank and the ``n_rows`` to be moved.
+    """
+    out = ctypes.c_char_p()
+    _check_call(
+        _LIB.XGCommunicatorPlanRebalance(
+            make_jcargs(tolerance=float(tolerance)), ctypes.byref(out)
+        )
+    )
+    assert out.value is not None
+    return json.loads(py_str(out.value))
+
+
 def broadcast(data: _T, root: int) -> _T:
     """Broadcast object from one node to all other nodes.
 
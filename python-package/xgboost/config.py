@@ -152,6 +152,46 @@ def get_config() -> Dict[str, Any]:
     return config
 
 
+def get_perf_counters() -> Dict[str, Dict[str, Any]]:
+    """Get the hardware performance counters collected for the timed phases, when the
+    ``perf_counters`` global parameter is set. Only available on Linux.
+
+    .. versionadded:: 3.1.0
+
+    Returns
+    -------
+    counters :
+        The number of calls, the elapsed time in seconds, the counter values and the
+        estimated memory bandwidth in GB/s for each phase.
+
+    """
+    out = ctypes.c_char_p()
+    _check_call(_LIB.XGBGetPerfCounters(ctypes.byref(out)))
+    value = out.value
+    assert value
+    return json.loads(py_str(value))
+
+
+def get_memory_stats() -> Dict[str, Dict[str, int]]:
+    """Get the host memory used by each subsystem of XGBoost, like the sparse pages, the
+    gradient index and the histograms. Device memory is not included.
+
+    .. versionadded:: 3.1.0
+
+    Returns
+    -------
+    stats :
+        The current and the peak number of bytes for each subsystem, along with the
+        ``Total``.
+
+    """
+    out = ctypes.c_char_p()
+    _check_call(_LIB.XGBGetMemoryStats(ctypes.byref(out)))
+    value = out.value
+    assert value
+    return json.loads(py_str(value))
+
+
 @contextmanager
 @config_doc(
     header="""
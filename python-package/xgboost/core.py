@@ -125,6 +125,11 @@ def make_jcargs(**kwargs: Any) -> bytes:
     return from_pystr_to_cstr(json.dumps(kwargs))
 
 
+def _parse_eval_iteration(result: str) -> int:
+    """Get the iteration of an eval result string from the booster."""
+    return int(result[1 : result.index("]")])
+
+
 def _parse_eval_str(result: str) -> List[Tuple[str, float]]:
     """Parse an eval result string from the booster."""
     splited = result.split()[1:]
@@ -483,6 +488,45 @@ class DataIter(ABC):  # pylint: disable=too-many-instance-attributes
 
             This is an experimental parameter and subject to change.
 
+    target_page_bytes :
+        The target number of bytes of each internal page of the external memory
+        :py:class:`DMatrix`. Small batches from the iterator are merged and large
+        batches are split, which reduces the per-page overhead without exceeding the
+        memory budget. By default, each batch from the iterator is a page.
+
+        .. versionadded:: 3.1.0
+
+        .. warning::
+
+            This is an experimental parameter and subject to change.
+
+    column_pages :
+        Whether to write a column-major copy of the gradient index along with each page
+        of dense data for the CPU `hist` tree method. Training can then use the
+        column-wise histogram kernel and partitioner, which is faster for dense data with
+        many features, at the cost of about twice the cache size. Used by both the
+        CPU-based :py:class:`DMatrix` and :py:class:`ExtMemQuantileDMatrix`.
+
+        .. versionadded:: 3.1.0
+
+        .. warning::
+
+            This is an experimental parameter and subject to change.
+
+    persistent_cache :
+        Whether to keep the gradient index cache on disk under the `cache_prefix` after
+        the :py:class:`DMatrix` is freed. A later :py:class:`DMatrix` created from the
+        same data with the same `max_bin`, possibly in a different process, reuses the
+        cache instead of generating it again. The cache is verified by the hash of the
+        data, stale files are not removed automatically. Only used by the CPU-based
+        :py:class:`DMatrix`.
+
+        .. versionadded:: 3.1.0
+
+        .. warning::
+
+            This is an experimental parameter and subject to change.
+
     """
 
     def __init__(
@@ -492,10 +536,16 @@ class DataIter(ABC):  # pylint: disable=too-many-instance-attributes
         *,
         on_host: bool = True,
         min_cache_page_bytes: Optional[int] = None,
+        target_page_bytes: Optional[int] = None,
+        column_pages: bool = False,
+        persistent_cache: bool = False,
     ) -> None:
         self.cache_prefix = cache_prefix
         self.on_host = on_host
         self.min_cache_page_bytes = min_cache_page_bytes
+        self.target_page_bytes = target_page_bytes
+        self.column_pages = column_pages
+        self.persistent_cache = persistent_cache
 
         self._handle = _ProxyDMatrix()
         self._exception: Optional[Exception] = None
@@ -895,6 +945,9 @@ class DMatrix:  # pylint: disable=too-many-instance-attributes,too-many-public-m
             cache_prefix=it.cache_prefix if it.cache_prefix else "",
             on_host=it.on_host,
             min_cache_page_bytes=it.min_cache_page_bytes,
+            target_page_bytes=it.target_page_bytes,
+            column_pages=it.column_pages,
+            persistent_cache=it.persistent_cache,
         )
         handle = ctypes.c_void_p()
         reset_callback, next_callback = it.get_callbacks(enable_categorical)
@@ -1688,6 +1741,7 @@ class ExtMemQuantileDMatrix(DMatrix, _RefMixIn):
         enable_categorical: bool = False,
         max_num_device_pages: Optional[int] = None,
         max_quantile_batches: Optional[int] = None,
+        max_host_cache_bytes: Optional[int] = None,
     ) -> None:
         """
         Parameters
@@ -1702,11 +1756,21 @@ class ExtMemQuantileDMatrix(DMatrix, _RefMixIn):
             pages to be cached in the device memory. This can be useful for preventing
             OOM error where there are more than one validation datasets. The default
             number of device-based page is 1. Lastly, XGBoost infers whether a dataset
-            is used for valdiation by checking whether ref is not None.
+            is used for valdiation by checking whether ref is not None. On systems
+            with coherent memory like the Grace-Hopper, host pages that are read
+            frequently are also moved to the device memory within this limit.
 
         max_quantile_batches :
             See :py:class:`QuantileDMatrix`.
 
+        max_host_cache_bytes :
+            For a CPU-based dataset with the `on_host` option of the :py:class:`DataIter`,
+            the maximum number of bytes of the compressed pages kept in the host memory.
+            Pages beyond this budget are spilled to the cache file. By default, all pages
+            are stored in the cache file.
+
+            .. versionadded:: 3.1.0
+
         """
         self.max_bin = max_bin
         self.missing = missing if missing is not None else np.nan
@@ -1718,6 +1782,7 @@ class ExtMemQuantileDMatrix(DMatrix, _RefMixIn):
             enable_categorical=enable_categorical,
             max_num_device_pages=max_num_device_pages,
             max_quantile_blocks=max_quantile_batches,
+            max_host_cache_bytes=max_host_cache_bytes,
         )
         assert self.handle is not None
 
@@ -1729,6 +1794,7 @@ class ExtMemQuantileDMatrix(DMatrix, _RefMixIn):
         enable_categorical: bool,
         max_num_device_pages: Optional[int] = None,
         max_quantile_blocks: Optional[int] = None,
+        max_host_cache_bytes: Optional[int] = None,
     ) -> None:
         args = make_jcargs(
             missing=self.missing,
@@ -1740,6 +1806,8 @@ class ExtMemQuantileDMatrix(DMatrix, _RefMixIn):
             max_num_device_pages=max_num_device_pages,
             # It's called blocks internally due to block-based quantile sketching.
             max_quantile_blocks=max_quantile_blocks,
+            max_host_cache_bytes=max_host_cache_bytes,
+            column_pages=it.column_pages,
         )
         handle = ctypes.c_void_p()
         reset_callback, next_callback = it.get_callbacks(enable_categorical)
@@ -1993,6 +2061,26 @@ class Booster:
         sliced.handle = sliced_handle
         return sliced
 
+    def append(self, other: "Booster") -> None:
+        """Append the boosting rounds of another tree-based model to this one, the
+        counterpart of slicing. The trees of `other` are copied and its attributes take
+        precedence. Only the `gbtree` booster is supported.
+
+        .. versionadded:: 3.1.0
+
+        .. code-block:: python
+
+            booster = bst[:10]
+            booster.append(bst[10:])
+
+        Parameters
+        ----------
+        other :
+            A booster trained with the same parameters.
+
+        """
+        _check_call(_LIB.XGBoosterAppend(self.handle, other.handle))
+
     def __iter__(self) -> Generator["Booster", None, None]:
         """Iterator method for getting individual trees.
 
@@ -2293,6 +2381,67 @@ class Booster:
             )
         )
 
+    def gradient_buffer(self, dtrain: DMatrix) -> NumpyOrCupy:
+        """Get a writable view of the gradient buffer owned by the booster. Filling the
+        buffer and calling :py:meth:`boost_with_gradient_buffer` avoids copying the
+        gradient computed by a custom objective.
+
+        .. versionadded:: 3.1.0
+
+        .. code-block:: python
+
+            for i in range(n_rounds):
+                buf = booster.gradient_buffer(dtrain)
+                predt = booster.inplace_predict(X, output_margin=True)
+                buf[:, :, 0] = grad(predt, y)
+                buf[:, :, 1] = hess(predt, y)
+                booster.boost_with_gradient_buffer(dtrain, i)
+
+        Parameters
+        ----------
+        dtrain :
+            The training DMatrix.
+
+        Returns
+        -------
+        buf :
+            A float32 array with the shape (n_samples, n_targets, 2), the last dimension
+            stores the gradient and the Hessian. The array is a :py:class:`cupy.ndarray`
+            when the booster runs on a CUDA device. It's invalidated by any other call to
+            the booster and should be obtained again in each iteration.
+
+        """
+        self._assign_dmatrix_features(dtrain)
+        interface = ctypes.c_char_p()
+        _check_call(
+            _LIB.XGBoosterGetGradientBuffer(
+                self.handle, dtrain.handle, ctypes.byref(interface)
+            )
+        )
+        assert interface.value is not None
+        return from_array_interface(json.loads(interface.value), zero_copy=True)
+
+    def boost_with_gradient_buffer(self, dtrain: DMatrix, iteration: int) -> None:
+        """Boost the booster for one iteration with the gradient written into the buffer
+        returned by :py:meth:`gradient_buffer`.
+
+        .. versionadded:: 3.1.0
+
+        Parameters
+        ----------
+        dtrain :
+            The training DMatrix, same as the one used to obtain the buffer.
+        iteration :
+            Current iteration.
+
+        """
+        self._assign_dmatrix_features(dtrain)
+        _check_call(
+            _LIB.XGBoosterTrainOneIterWithGradientBuffer(
+                self.handle, dtrain.handle, iteration
+            )
+        )
+
     def eval_set(
         self,
         evals: Sequence[Tuple[DMatrix, str]],
@@ -2340,6 +2489,8 @@ class Booster:
         assert msg.value is not None
         res = msg.value.decode()  # pylint: disable=no-member
         if feval is not None:
+            if not res.startswith(f"[{iteration}]"):
+                raise ValueError("Custom metric is not supported with `async_eval`.")
             for dmat, evname in evals:
                 feval_ret = feval(
                     self.predict(dmat, training=False, output_margin=output_margin),
@@ -2355,6 +2506,24 @@ class Booster:
                     res += "\t%s-%s:%f" % (evname, name, val)
         return res
 
+    def eval_pending(self) -> str:
+        """Wait for the evaluation in flight when the ``async_eval`` parameter is set.
+        With asynchronous evaluation, :py:meth:`eval_set` starts the evaluation of the
+        current iteration in a background thread, and returns the result of the
+        previous iteration.
+
+        .. versionadded:: 3.1.0
+
+        Returns
+        -------
+        result: str
+            Evaluation result string of the evaluation in flight, empty if there's none.
+        """
+        msg = ctypes.c_char_p()
+        _check_call(_LIB.XGBoosterEvalPending(self.handle, ctypes.byref(msg)))
+        assert msg.value is not None
+        return msg.value.decode()  # pylint: disable=no-member
+
     def eval(self, data: DMatrix, name: str = "eval", iteration: int = 0) -> str:
         """Evaluate the model on mat.
 
@@ -2526,6 +2695,7 @@ class Booster:
         validate_features: bool = True,
         base_margin: Any = None,
         strict_shape: bool = False,
+        nthread: int = 0,
     ) -> NumpyOrCupy:
         """Run prediction in-place when possible, Unlike :py:meth:`predict` method,
         inplace prediction does not cache the prediction result.
@@ -2573,6 +2743,13 @@ class Booster:
 
             .. versionadded:: 1.4.0
 
+        nthread:
+            Number of threads used by this call only, 0 to use the ``nthread`` of the
+            booster. Unlike :py:meth:`set_param`, the booster is not reconfigured and
+            other threads are not affected.
+
+            .. versionadded:: 3.1.0
+
         Returns
         -------
         prediction : numpy.ndarray/cupy.ndarray
@@ -2591,6 +2768,7 @@ class Booster:
             missing=missing,
             strict_shape=strict_shape,
             cache_id=0,
+            nthread=nthread,
         )
         shape = ctypes.POINTER(c_bst_ulong)()
         dims = c_bst_ulong()
@@ -2762,6 +2940,12 @@ class Booster:
           # or
           model.save_model("model.ubj")
 
+        .. versionadded:: 3.1.0
+
+            Models saved with the ``.mmap`` extension use a binary format that is loaded
+            by memory mapping the file without parsing the trees. The format uses the
+            native byte order and doesn't support multi-target trees.
+
         Parameters
         ----------
         fname :
@@ -2774,7 +2958,7 @@ class Booster:
         else:
             raise TypeError("fname must be a string or os PathLike")
 
-    def save_raw(self, raw_format: str = "ubj") -> bytearray:
+    def save_raw(self, raw_format: str = "ubj", *, serving: bool = False) -> bytearray:
         """Save the model to a in memory buffer representation instead of file.
 
         The model is saved in an XGBoost internal format which is universal among the
@@ -2786,6 +2970,13 @@ class Booster:
         ----------
         raw_format :
             Format of output buffer. Can be `json` or `ubj`.
+        serving :
+
+            .. versionadded:: 3.1.0
+
+            Save a smaller model for serving, without the node statistics of trees.
+            The loaded model supports prediction, but not the gain and cover based
+            feature importance or the feature contributions (SHAP values).
 
         Returns
         -------
@@ -2793,7 +2984,7 @@ class Booster:
         """
         length = c_bst_ulong()
         cptr = ctypes.POINTER(ctypes.c_char)()
-        config = make_jcargs(format=raw_format)
+        config = make_jcargs(format=raw_format, serving=serving)
         _check_call(
             _LIB.XGBoosterSaveModelToBuffer(
                 self.handle, config, ctypes.byref(length), ctypes.byref(cptr)
@@ -2837,6 +3028,89 @@ class Booster:
         else:
             raise TypeError("Unknown file type: ", fname)
 
+    def load_model_lazy(
+        self, fname: Union[str, os.PathLike], max_bytes: int = 0
+    ) -> None:
+        """Load a model saved with the ``.mmap`` extension, with the trees loaded on
+        demand. See :doc:`Model IO </tutorials/saving_model>` for more info.
+
+        .. versionadded:: 3.1.0
+
+        Only the normal prediction is supported by the loaded model. Other operations
+        like saving the model, or predicting leaves and SHAP values, require loading
+        the model with :py:meth:`load_model`.
+
+        Parameters
+        ----------
+        fname :
+            Path to a local model file.
+        max_bytes :
+            Budget for the loaded trees in bytes. Pages of trees are evicted when the
+            budget is exceeded. 0 means unlimited.
+
+        """
+        fname = os.fspath(os.path.expanduser(fname))
+        config = make_jcargs(max_bytes=int(max_bytes))
+        _check_call(_LIB.XGBoosterLoadModelLazy(self.handle, c_str(fname), config))
+
+    def save_prediction_cache(
+        self, dtrain: DMatrix, fname: Union[str, os.PathLike]
+    ) -> None:
+        """Save the margin prediction of the training data along with the model
+        checkpoint. Restoring it with :py:meth:`load_prediction_cache` lets the training
+        continue without predicting all the existing trees on the training data.
+
+        .. versionadded:: 3.1.0
+
+        Only the ``gbtree`` booster is supported.
+
+        Parameters
+        ----------
+        dtrain :
+            The training data.
+        fname :
+            Path to a local file.
+
+        """
+        fname = os.fspath(os.path.expanduser(fname))
+        _check_call(
+            _LIB.XGBoosterSavePredictionCache(self.handle, dtrain.handle, c_str(fname))
+        )
+
+    def load_prediction_cache(
+        self, dtrain: DMatrix, fname: Union[str, os.PathLike]
+    ) -> bool:
+        """Restore the cache saved by :py:meth:`save_prediction_cache` after loading
+        the model checkpoint.
+
+        .. versionadded:: 3.1.0
+
+        The cache is tagged with fingerprints of the model and the data. The
+        fingerprint of the data covers the shape, the labels, the weights and the base
+        margin, but not the feature values.
+
+        Parameters
+        ----------
+        dtrain :
+            The training data, used for the following training iterations.
+        fname :
+            Path to a local file.
+
+        Returns
+        -------
+        Whether the cache is restored. The prediction is recomputed in the next
+        iteration if the cache doesn't match the model or the data.
+
+        """
+        fname = os.fspath(os.path.expanduser(fname))
+        loaded = ctypes.c_int()
+        _check_call(
+            _LIB.XGBoosterLoadPredictionCache(
+                self.handle, dtrain.handle, c_str(fname), ctypes.byref(loaded)
+            )
+        )
+        return bool(loaded.value)
+
     @property
     def best_iteration(self) -> int:
         """The best iteration during training."""
@@ -32,6 +32,13 @@ class FederatedTracker(RabitTracker):
     client_cert_path :
         Path to the client certificate file.
 
+    compression :
+        Compression for the replies from the server, one of ``none``, ``deflate``, or
+        ``gzip``. Workers can set ``federated_compression`` in the communicator arguments
+        to compress the requests.
+
+        .. versionadded:: 3.1.0
+
     """
 
     @_deprecate_positional_args
@@ -45,6 +52,7 @@ class FederatedTracker(RabitTracker):
         server_cert_path: Optional[str] = None,
         client_cert_path: Optional[str] = None,
         timeout: int = 300,
+        compression: Optional[str] = None,
     ) -> None:
         handle = ctypes.c_void_p()
         args = make_jcargs(
@@ -56,6 +64,7 @@ class FederatedTracker(RabitTracker):
             server_cert_path=server_cert_path,
             client_cert_path=client_cert_path,
             timeout=int(timeout),
+            federated_compression=compression,
         )
         _check_call(_LIB.XGTrackerCreate(args, ctypes.byref(handle)))
         self.handle = handle
@@ -295,7 +295,7 @@ __model_doc = f"""
 
     sampling_method : {Optional[str]}
 
-        Sampling method. Used only by the GPU version of ``hist`` tree method.
+        Sampling method. Used only by the ``hist`` and ``approx`` tree methods.
 
         - ``uniform``: Select random training instances uniformly.
         - ``gradient_based``: Select random training instances with higher probability
@@ -58,6 +58,19 @@ class RabitTracker:
         the tracker even if the tracker is still being used. A value error is raised
         when timeout is reached.
 
+    min_workers :
+
+        The minimum number of workers for elastic restart. After a worker fails, the
+        tracker waits for the workers to be restarted. If the lost workers are not
+        replaced within `elastic_timeout` seconds, the tracker forms a smaller group with
+        the returned workers as long as there are at least `min_workers` of them. The
+        default is `n_workers`, which disables elastic restart. Restoring the training
+        state and re-distributing the data are left to the caller.
+
+    elastic_timeout :
+
+        Seconds to wait for the replacement workers, see `min_workers`.
+
     Examples
     --------
 
@@ -89,6 +102,8 @@ class RabitTracker:
         *,
         sortby: str = "host",
         timeout: int = 0,
+        min_workers: Optional[int] = None,
+        elastic_timeout: int = 60,
     ) -> None:
 
         handle = ctypes.c_void_p()
@@ -103,6 +118,8 @@ class RabitTracker:
             dmlc_communicator="rabit",
             sortby=self._SortBy.HOST if sortby == "host" else self._SortBy.TASK,
             timeout=int(timeout),
+            min_workers=n_workers if min_workers is None else int(min_workers),
+            elastic_timeout=int(elastic_timeout),
         )
         _check_call(_LIB.XGTrackerCreate(args, ctypes.byref(handle)))
         self.handle = handle
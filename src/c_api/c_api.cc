@@ -4,28 +4,41 @@
 #include "xgboost/c_api.h"
 
 #include <algorithm>     // for copy, transform
+#include <atomic>        // for atomic
 #include <cinttypes>     // for strtoimax
-#include <cmath>         // for nan
+#include <cmath>         // for nan, isnan
+#include <cstdint>       // for uint8_t
 #include <cstring>       // for strcmp
+#include <future>        // for future
 #include <limits>        // for numeric_limits
 #include <map>           // for operator!=, _Rb_tree_const_iterator, _Rb_tre...
-#include <memory>        // for shared_ptr, allocator, __shared_ptr_access
+#include <memory>        // for shared_ptr, allocator, atomic_load_explicit
+#include <mutex>         // for mutex, lock_guard
 #include <string>        // for char_traits, basic_string, operator==, string
 #include <system_error>  // for errc
 #include <utility>       // for pair
 #include <vector>        // for vector
 
 #include "../common/api_entry.h"         // for XGBAPIThreadLocalEntry
+#include "../common/cancel.h"            // for CancelToken, CancelScope
 #include "../common/charconv.h"          // for from_chars, to_chars, NumericLimits, from_ch...
+#include "../common/cleanup.h"           // for MakeCleanup
 #include "../common/error_msg.h"         // for NoFederated
 #include "../common/hist_util.h"         // for HistogramCuts
 #include "../common/io.h"                // for FileExtension, LoadSequentialFile, MemoryBuf...
-#include "../common/threading_utils.h"   // for OmpGetNumThreads, ParallelFor
+#include "../common/memory_stats.h"      // for GlobalMemoryStats
+#include "../common/perf_counter.h"      // for PerfCounters
+#include "../common/threadpool.h"        // for ThreadPool
+#include "../common/threading_utils.h"   // for OmpGetNumThreads, ParallelFor, SetParallelE...
+#include "../common/trace.h"             // for Tracer
 #include "../data/adapter.h"             // for ArrayAdapter, DenseAdapter, RecordBatchesIte...
 #include "../data/batch_utils.h"         // for MatchingPageBytes, CachePageRatio
+#include "../data/borrowed_dmatrix.h"    // for BorrowedDMatrix
 #include "../data/ellpack_page.h"        // for EllpackPage
+#include "../data/iterative_dmatrix.h"   // for IterativeDMatrix
 #include "../data/proxy_dmatrix.h"       // for DMatrixProxy
 #include "../data/simple_dmatrix.h"      // for SimpleDMatrix
+#include "../tree/tree_telemetry.h"      // for TelemetryRound
 #include "c_api_error.h"                 // for xgboost_CHECK_C_ARG_PTR, API_END, API_BEGIN
 #include "c_api_utils.h"                 // for RequiredArg, OptionalArg, GetMissing, CastDM...
 #include "dmlc/base.h"                   // for BeginPtr
@@ -169,7 +182,25 @@ XGB_DLL int XGBSetGlobalConfig(const char* json_str) {
       break;
     }
   }
+  // The tracer, the counters and the allocation policy are shared by all threads, only
+  // configure them when this thread changes them.
+  auto trace_file = GlobalConfigThreadLocalStore::Get()->trace_file;
+  auto perf_counters = GlobalConfigThreadLocalStore::Get()->perf_counters;
+  auto huge_pages = GlobalConfigThreadLocalStore::Get()->huge_pages;
+  auto numa_interleave = GlobalConfigThreadLocalStore::Get()->numa_interleave;
   auto unknown = FromJson(config, GlobalConfigThreadLocalStore::Get());
+  if (GlobalConfigThreadLocalStore::Get()->trace_file != trace_file) {
+    common::Tracer::Get().Configure(GlobalConfigThreadLocalStore::Get()->trace_file);
+  }
+  if (GlobalConfigThreadLocalStore::Get()->perf_counters != perf_counters) {
+    common::PerfCounters::Get().Configure(GlobalConfigThreadLocalStore::Get()->perf_counters);
+  }
+  if (GlobalConfigThreadLocalStore::Get()->huge_pages != huge_pages ||
+      GlobalConfigThreadLocalStore::Get()->numa_interleave != numa_interleave) {
+    auto const& new_config = *GlobalConfigThreadLocalStore::Get();
+    common::SetLargeAllocPolicy(
+        {common::ParseHugePages(new_config.huge_pages), new_config.numa_interleave});
+  }
   if (!unknown.empty()) {
     std::stringstream ss;
     ss << "Unknown global parameters: { ";
@@ -224,6 +255,36 @@ XGB_DLL int XGBGetGlobalConfig(const char** json_str) {
   API_END();
 }
 
+XGB_DLL int XGBGetPerfCounters(char const **out) {
+  API_BEGIN();
+  auto &local = *GlobalConfigAPIThreadLocalStore::Get();
+  Json::Dump(common::PerfCounters::Get().Dump(), &local.ret_str);
+  xgboost_CHECK_C_ARG_PTR(out);
+  *out = local.ret_str.c_str();
+  API_END();
+}
+
+XGB_DLL int XGBRegisterTreeTelemetryCallback(void (*callback)(char const *record)) {
+  API_BEGIN();
+  tree::TelemetryRound::SetCallback(callback);
+  API_END();
+}
+
+XGB_DLL int XGBGetMemoryStats(char const **out) {
+  API_BEGIN();
+  auto &local = *GlobalConfigAPIThreadLocalStore::Get();
+  Json::Dump(common::GlobalMemoryStats().ToJson(), &local.ret_str);
+  xgboost_CHECK_C_ARG_PTR(out);
+  *out = local.ret_str.c_str();
+  API_END();
+}
+
+XGB_DLL int XGBSetParallelExecutor(XGBParallelExecutor *executor, void *executor_data) {
+  API_BEGIN();
+  common::SetParallelExecutor(executor, executor_data);
+  API_END();
+}
+
 XGB_DLL int XGDMatrixCreateFromFile(const char *fname, int silent, DMatrixHandle *out) {
   xgboost_CHECK_C_ARG_PTR(fname);
   xgboost_CHECK_C_ARG_PTR(out);
@@ -310,6 +371,9 @@ XGB_DLL int XGDMatrixCreateFromCallback(DataIterHandle iter, DMatrixHandle proxy
 
   auto config = ExtMemConfig{
       cache, on_host, min_cache_page_bytes, missing, /*max_num_device_pages=*/0, n_threads};
+  config.persistent = OptionalArg<Boolean>(jconfig, "persistent_cache", false);
+  config.target_page_bytes = OptionalArg<Integer, std::int64_t>(jconfig, "target_page_bytes", 0);
+  config.column_pages = OptionalArg<Boolean>(jconfig, "column_pages", false);
   *out = new std::shared_ptr<xgboost::DMatrix>{
       xgboost::DMatrix::Create(iter, proxy, reset, next, config)};
   API_END();
@@ -344,13 +408,16 @@ XGB_DLL int XGQuantileDMatrixCreateFromCallback(DataIterHandle iter, DMatrixHand
   auto max_bin = OptionalArg<Integer, int64_t>(jconfig, "max_bin", 256);
   auto max_quantile_blocks = OptionalArg<Integer, std::int64_t>(
       jconfig, "max_quantile_blocks", std::numeric_limits<std::int64_t>::max());
+  auto single_pass = OptionalArg<Boolean>(jconfig, "single_pass", false);
+  auto sketch_sample_eps = OptionalArg<Number, float>(jconfig, "sketch_sample_eps", 0.0f);
 
   xgboost_CHECK_C_ARG_PTR(next);
   xgboost_CHECK_C_ARG_PTR(reset);
   xgboost_CHECK_C_ARG_PTR(out);
 
-  *out = new std::shared_ptr<xgboost::DMatrix>{xgboost::DMatrix::Create(
-      iter, proxy, p_ref, reset, next, missing, n_threads, max_bin, max_quantile_blocks)};
+  *out = new std::shared_ptr<xgboost::DMatrix>{
+      xgboost::DMatrix::Create(iter, proxy, p_ref, reset, next, missing, n_threads, max_bin,
+                               max_quantile_blocks, single_pass, sketch_sample_eps)};
   API_END();
 }
 
@@ -375,6 +442,8 @@ XGB_DLL int XGExtMemQuantileDMatrixCreateFromCallback(DataIterHandle iter, DMatr
                                                                  cuda_impl::MaxNumDevicePages());
   auto max_quantile_blocks = OptionalArg<Integer, std::int64_t>(
       jconfig, "max_quantile_blocks", std::numeric_limits<std::int64_t>::max());
+  auto max_host_cache_bytes =
+      OptionalArg<Integer, std::int64_t>(jconfig, "max_host_cache_bytes", 0);
 
   xgboost_CHECK_C_ARG_PTR(next);
   xgboost_CHECK_C_ARG_PTR(reset);
@@ -382,6 +451,9 @@ XGB_DLL int XGExtMemQuantileDMatrixCreateFromCallback(DataIterHandle iter, DMatr
 
   auto config =
       ExtMemConfig{cache, on_host, min_cache_page_bytes, missing, max_num_device_pages, n_threads};
+  config.max_host_cache_bytes = max_host_cache_bytes;
+  config.column_pages = OptionalArg<Boolean>(jconfig, "column_pages", false);
+  config.sketch_sample_eps = OptionalArg<Number, float>(jconfig, "sketch_sample_eps", 0.0f);
   *out = new std::shared_ptr<xgboost::DMatrix>{xgboost::DMatrix::Create(
       iter, proxy, p_ref, reset, next, max_bin, max_quantile_blocks, config)};
   API_END();
@@ -431,6 +503,20 @@ XGB_DLL int XGProxyDMatrixSetDataColumnar(DMatrixHandle handle, char const *c_in
   API_END();
 }
 
+XGB_DLL int XGProxyDMatrixSetDataArrow(DMatrixHandle handle, void *array, void *schema) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  xgboost_CHECK_C_ARG_PTR(array);
+  xgboost_CHECK_C_ARG_PTR(schema);
+  auto p_m = static_cast<std::shared_ptr<xgboost::DMatrix> *>(handle);
+  CHECK(p_m);
+  auto m = static_cast<xgboost::data::DMatrixProxy *>(p_m->get());
+  CHECK(m) << "Current DMatrix type does not support set data.";
+  m->SetArrowData(static_cast<ArrowArray const *>(array),
+                  static_cast<ArrowSchema const *>(schema));
+  API_END();
+}
+
 XGB_DLL int XGProxyDMatrixSetDataDense(DMatrixHandle handle, char const *c_interface_str) {
   API_BEGIN();
   CHECK_HANDLE();
@@ -489,6 +575,27 @@ XGB_DLL int XGDMatrixCreateFromColumnar(char const *data, char const *c_json_con
   API_END();
 }
 
+XGB_DLL int XGDMatrixCreateFromArrow(void *array, void *schema, char const *c_json_config,
+                                     DMatrixHandle *out) {
+  API_BEGIN();
+  xgboost_CHECK_C_ARG_PTR(c_json_config);
+  xgboost_CHECK_C_ARG_PTR(array);
+  xgboost_CHECK_C_ARG_PTR(schema);
+
+  auto config = Json::Load(c_json_config);
+  float missing = GetMissing(config);
+  auto n_threads = OptionalArg<Integer, std::int64_t>(config, "nthread", 0);
+  auto data_split_mode =
+      static_cast<DataSplitMode>(OptionalArg<Integer, int64_t>(config, "data_split_mode", 0));
+
+  data::ColumnarAdapter adapter{data::ArrowColumns{static_cast<ArrowArray const *>(array),
+                                                   static_cast<ArrowSchema const *>(schema)}};
+  *out = new std::shared_ptr<DMatrix>(
+      DMatrix::Create(&adapter, missing, n_threads, "", data_split_mode));
+
+  API_END();
+}
+
 XGB_DLL int XGDMatrixCreateFromCSR(char const *indptr, char const *indices, char const *data,
                                    xgboost::bst_ulong ncol, char const *c_json_config,
                                    DMatrixHandle *out) {
@@ -527,6 +634,41 @@ XGB_DLL int XGDMatrixCreateFromDense(char const *data,
   API_END();
 }
 
+XGB_DLL int XGDMatrixCreateBorrowedFromDense(char const *data, char const *c_json_config,
+                                             DMatrixHandle *out) {
+  API_BEGIN();
+  xgboost_CHECK_C_ARG_PTR(data);
+  auto proxy = std::make_shared<data::DMatrixProxy>();
+  proxy->SetArrayData(StringView{data});
+  xgboost_CHECK_C_ARG_PTR(c_json_config);
+  auto config = Json::Load(StringView{c_json_config});
+  float missing = GetMissing(config);
+  auto n_threads = OptionalArg<Integer, int64_t>(config, "nthread", 0);
+  xgboost_CHECK_C_ARG_PTR(out);
+  *out = new std::shared_ptr<DMatrix>(
+      new data::BorrowedDMatrix{std::move(proxy), missing, static_cast<std::int32_t>(n_threads)});
+  API_END();
+}
+
+XGB_DLL int XGDMatrixCreateBorrowedFromCSR(char const *indptr, char const *indices,
+                                           char const *data, xgboost::bst_ulong ncol,
+                                           char const *c_json_config, DMatrixHandle *out) {
+  API_BEGIN();
+  xgboost_CHECK_C_ARG_PTR(indptr);
+  xgboost_CHECK_C_ARG_PTR(indices);
+  xgboost_CHECK_C_ARG_PTR(data);
+  auto proxy = std::make_shared<data::DMatrixProxy>();
+  proxy->SetCSRData(indptr, indices, data, ncol, true);
+  xgboost_CHECK_C_ARG_PTR(c_json_config);
+  auto config = Json::Load(StringView{c_json_config});
+  float missing = GetMissing(config);
+  auto n_threads = OptionalArg<Integer, int64_t>(config, "nthread", 0);
+  xgboost_CHECK_C_ARG_PTR(out);
+  *out = new std::shared_ptr<DMatrix>(
+      new data::BorrowedDMatrix{std::move(proxy), missing, static_cast<std::int32_t>(n_threads)});
+  API_END();
+}
+
 XGB_DLL int XGDMatrixCreateFromCSC(char const *indptr, char const *indices, char const *data,
                                    xgboost::bst_ulong nrow, char const *c_json_config,
                                    DMatrixHandle *out) {
@@ -631,6 +773,23 @@ XGB_DLL int XGDMatrixSaveBinary(DMatrixHandle handle, const char* fname,
   API_END();
 }
 
+XGB_DLL int XGDMatrixAppend(DMatrixHandle handle, DMatrixHandle that) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  xgboost_CHECK_C_ARG_PTR(that);
+  auto dmat = static_cast<std::shared_ptr<DMatrix> *>(handle)->get();
+  auto p_that = static_cast<std::shared_ptr<DMatrix> *>(that)->get();
+  CHECK(p_that);
+  if (auto derived = dynamic_cast<data::SimpleDMatrix *>(dmat)) {
+    derived->Append(p_that);
+  } else if (auto derived = dynamic_cast<data::IterativeDMatrix *>(dmat)) {
+    derived->Append(p_that);
+  } else {
+    LOG(FATAL) << "Appending data is only supported by `DMatrix` and `QuantileDMatrix`.";
+  }
+  API_END();
+}
+
 XGB_DLL int XGDMatrixSetFloatInfo(DMatrixHandle handle, const char *field, const bst_float *info,
                                   xgboost::bst_ulong len) {
   API_BEGIN();
@@ -976,6 +1135,13 @@ XGB_DLL int XGBoosterReset(BoosterHandle handle) {
   API_END();
 }
 
+XGB_DLL int XGBoosterFreeze(BoosterHandle handle) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  static_cast<Learner *>(handle)->Freeze();
+  API_END();
+}
+
 XGB_DLL int XGBoosterSetParam(BoosterHandle handle,
                               const char *name,
                               const char *value) {
@@ -1113,6 +1279,37 @@ XGB_DLL int XGBoosterTrainOneIter(BoosterHandle handle, DMatrixHandle dtrain, in
   API_END();
 }
 
+XGB_DLL int XGBoosterGetGradientBuffer(BoosterHandle handle, DMatrixHandle dtrain,
+                                       char const **out) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  auto p_fmat = CastDMatrixHandle(dtrain);
+  auto *learner = static_cast<Learner *>(handle);
+  auto p_gpair = learner->GradientBuffer(p_fmat);
+  static_assert(sizeof(GradientPair) == sizeof(float) * 2);
+  auto d_gpair = learner->Ctx()->IsCUDA() ? p_gpair->Data()->DevicePointer()
+                                          : p_gpair->Data()->HostPointer();
+  // View the interleaved gradient pairs as floats, the buffer is filled in place.
+  auto t_gpair = linalg::MakeTensorView(
+      learner->Ctx(), common::Span{reinterpret_cast<float *>(d_gpair), p_gpair->Size() * 2},
+      p_gpair->Shape(0), p_gpair->Shape(1), 2);
+  auto &str = learner->GetThreadLocal().ret_str;
+  str = linalg::ArrayInterfaceStr(t_gpair);
+  xgboost_CHECK_C_ARG_PTR(out);
+  *out = str.c_str();
+  API_END();
+}
+
+XGB_DLL int XGBoosterTrainOneIterWithGradientBuffer(BoosterHandle handle, DMatrixHandle dtrain,
+                                                    int iter) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  auto p_fmat = CastDMatrixHandle(dtrain);
+  auto *learner = static_cast<Learner *>(handle);
+  learner->BoostOneIter(iter, p_fmat, learner->GradientBuffer(p_fmat));
+  API_END();
+}
+
 XGB_DLL int XGBoosterEvalOneIter(BoosterHandle handle,
                                  int iter,
                                  DMatrixHandle dmats[],
@@ -1140,6 +1337,150 @@ XGB_DLL int XGBoosterEvalOneIter(BoosterHandle handle,
   API_END();
 }
 
+XGB_DLL int XGBoosterEvalPending(BoosterHandle handle, const char **out_result) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  auto *bst = static_cast<Learner *>(handle);
+  std::string &eval_str = bst->GetThreadLocal().ret_str;
+  eval_str = bst->EvalPending();
+  xgboost_CHECK_C_ARG_PTR(out_result);
+  *out_result = eval_str.c_str();
+  API_END();
+}
+
+namespace {
+/**
+ * @brief Training running in a background thread, see XGBoosterTrainAsync.
+ */
+class AsyncTrain {
+  Learner *learner_;
+  std::shared_ptr<DMatrix> dtrain_;
+  std::vector<std::shared_ptr<DMatrix>> evals_;
+  std::vector<std::string> names_;
+  common::CancelToken token_;
+  std::atomic<std::int32_t> n_finished_{0};
+  // A single worker, a thread pool is used for the future.
+  common::ThreadPool pool_{"async-train", 1, InitNewThread{}};
+  std::future<void> fut_;
+
+  void Run(std::int32_t n_rounds, XGAsyncTrainCallback *callback, void *user_data) {
+    auto done = common::MakeCleanup([this] { token_.Done(); });
+    common::CancelScope scope{&token_};
+    learner_->Configure();
+    auto begin = learner_->BoostedRounds();
+    for (std::int32_t i = 0; i < n_rounds; ++i) {
+      if (token_.Checkpoint()) {
+        break;
+      }
+      auto iter = begin + i;
+      learner_->UpdateOneIter(iter, dtrain_);
+      ++n_finished_;
+      std::string eval;
+      if (!evals_.empty()) {
+        eval = learner_->EvalOneIter(iter, evals_, names_);
+      }
+      if (callback && callback(iter, eval.c_str(), user_data) != 0) {
+        break;
+      }
+    }
+  }
+
+ public:
+  AsyncTrain(Learner *learner, std::shared_ptr<DMatrix> dtrain,
+             std::vector<std::shared_ptr<DMatrix>> evals, std::vector<std::string> names,
+             std::int32_t n_rounds, XGAsyncTrainCallback *callback, void *user_data)
+      : learner_{learner},
+        dtrain_{std::move(dtrain)},
+        evals_{std::move(evals)},
+        names_{std::move(names)} {
+    fut_ = pool_.Submit([this, n_rounds, callback, user_data] {
+      this->Run(n_rounds, callback, user_data);
+    });
+  }
+  ~AsyncTrain() {
+    token_.Cancel();
+    if (fut_.valid()) {
+      fut_.wait();
+    }
+  }
+
+  void Pause() {
+    token_.Pause();
+    token_.WaitParked();
+  }
+  void Resume() { token_.Resume(); }
+  void Cancel() { token_.Cancel(); }
+  [[nodiscard]] std::int32_t Wait() {
+    if (fut_.valid()) {
+      // Rethrow the error from the training thread.
+      fut_.get();
+    }
+    return n_finished_.load();
+  }
+};
+}  // namespace
+
+XGB_DLL int XGBoosterTrainAsync(BoosterHandle handle, DMatrixHandle dtrain, DMatrixHandle dmats[],
+                                char const *evnames[], xgboost::bst_ulong len, int n_rounds,
+                                XGAsyncTrainCallback *callback, void *user_data,
+                                AsyncTrainHandle *out) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  xgboost_CHECK_C_ARG_PTR(dtrain);
+  xgboost_CHECK_C_ARG_PTR(out);
+  CHECK_GE(n_rounds, 0) << "Invalid number of boosting rounds.";
+  auto *learner = static_cast<Learner *>(handle);
+  auto p_train = *static_cast<std::shared_ptr<DMatrix> *>(dtrain);
+  std::vector<std::shared_ptr<DMatrix>> data_sets;
+  std::vector<std::string> data_names;
+  for (xgboost::bst_ulong i = 0; i < len; ++i) {
+    xgboost_CHECK_C_ARG_PTR(dmats);
+    data_sets.push_back(*static_cast<std::shared_ptr<DMatrix> *>(dmats[i]));
+    xgboost_CHECK_C_ARG_PTR(evnames);
+    data_names.emplace_back(evnames[i]);
+  }
+  *out = new AsyncTrain{learner,  p_train,  std::move(data_sets), std::move(data_names),
+                        n_rounds, callback, user_data};
+  API_END();
+}
+
+XGB_DLL int XGAsyncTrainPause(AsyncTrainHandle handle) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  static_cast<AsyncTrain *>(handle)->Pause();
+  API_END();
+}
+
+XGB_DLL int XGAsyncTrainResume(AsyncTrainHandle handle) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  static_cast<AsyncTrain *>(handle)->Resume();
+  API_END();
+}
+
+XGB_DLL int XGAsyncTrainCancel(AsyncTrainHandle handle) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  static_cast<AsyncTrain *>(handle)->Cancel();
+  API_END();
+}
+
+XGB_DLL int XGAsyncTrainWait(AsyncTrainHandle handle, int *out_n_rounds) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  auto n_rounds = static_cast<AsyncTrain *>(handle)->Wait();
+  xgboost_CHECK_C_ARG_PTR(out_n_rounds);
+  *out_n_rounds = n_rounds;
+  API_END();
+}
+
+XGB_DLL int XGAsyncTrainFree(AsyncTrainHandle handle) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  delete static_cast<AsyncTrain *>(handle);
+  API_END();
+}
+
 XGB_DLL int XGBoosterPredict(BoosterHandle handle,
                              DMatrixHandle dmat,
                              int option_mask,
@@ -1166,6 +1507,48 @@ XGB_DLL int XGBoosterPredict(BoosterHandle handle,
   API_END();
 }
 
+namespace {
+void PredictLeafMarginImpl(Learner *learner, std::shared_ptr<DMatrix> p_m, std::int64_t mask,
+                           bst_layer_t iteration_begin, bst_layer_t iteration_end,
+                           xgboost::bst_ulong const **out_shape, xgboost::bst_ulong *out_dim,
+                           float const **out_result) {
+  auto bit = [](PredictionType type) { return std::int64_t{1} << static_cast<int>(type); };
+  auto value = bit(PredictionType::kValue);
+  auto margin = bit(PredictionType::kMargin);
+  auto leaf = bit(PredictionType::kLeaf);
+  CHECK(mask == (value | leaf) || mask == (margin | leaf))
+      << "Invalid `output_mask`: " << mask << ". Only the normal or the margin prediction "
+      << "combined with the leaf prediction is supported.";
+
+  HostDeviceVector<float> predt;
+  HostDeviceVector<float> leaves;
+  learner->PredictLeafMargin(p_m, (mask & margin) != 0, &predt, &leaves, iteration_begin,
+                             iteration_end);
+  auto n_samples = p_m->Info().num_row_;
+  auto n_groups = n_samples == 0 ? 0 : predt.Size() / n_samples;
+  auto n_trees = n_samples == 0 ? 0 : leaves.Size() / n_samples;
+  auto const &h_predt = predt.ConstHostVector();
+  auto const &h_leaves = leaves.ConstHostVector();
+  auto &entry = learner->GetThreadLocal().prediction_entry;
+  auto &h_out = entry.predictions.HostVector();
+  h_out.resize(n_samples * (n_groups + n_trees));
+  common::ParallelFor(n_samples, learner->Ctx()->Threads(), [&](auto i) {
+    auto out = h_out.begin() + i * (n_groups + n_trees);
+    out = std::copy_n(h_predt.cbegin() + i * n_groups, n_groups, out);
+    std::copy_n(h_leaves.cbegin() + i * n_trees, n_trees, out);
+  });
+
+  xgboost_CHECK_C_ARG_PTR(out_result);
+  xgboost_CHECK_C_ARG_PTR(out_dim);
+  xgboost_CHECK_C_ARG_PTR(out_shape);
+  *out_result = dmlc::BeginPtr(h_out);
+  auto &shape = learner->GetThreadLocal().prediction_shape;
+  shape = {n_samples, n_groups + n_trees};
+  *out_dim = shape.size();
+  *out_shape = dmlc::BeginPtr(shape);
+}
+}  // namespace
+
 XGB_DLL int XGBoosterPredictFromDMatrix(BoosterHandle handle,
                                         DMatrixHandle dmat,
                                         char const* c_json_config,
@@ -1185,10 +1568,17 @@ XGB_DLL int XGBoosterPredictFromDMatrix(BoosterHandle handle,
   auto *learner = static_cast<Learner*>(handle);
   auto& entry = learner->GetThreadLocal().prediction_entry;
   auto p_m = *static_cast<std::shared_ptr<DMatrix> *>(dmat);
+  ScopedThreads threads{GetPredictThreads(config)};
 
-  auto type = PredictionType(RequiredArg<Integer>(config, "type", __func__));
   auto iteration_begin = RequiredArg<Integer>(config, "iteration_begin", __func__);
   auto iteration_end = RequiredArg<Integer>(config, "iteration_end", __func__);
+  auto output_mask = OptionalArg<Integer, std::int64_t>(config, "output_mask", 0);
+  if (output_mask != 0) {
+    PredictLeafMarginImpl(learner, p_m, output_mask, iteration_begin, iteration_end, out_shape,
+                          out_dim, out_result);
+    return 0;
+  }
+  auto type = PredictionType(RequiredArg<Integer>(config, "type", __func__));
 
   auto const& j_config = get<Object const>(config);
   auto ntree_limit_it = j_config.find("ntree_limit");
@@ -1237,6 +1627,7 @@ void InplacePredictImpl(std::shared_ptr<DMatrix> p_m, char const *c_json_config,
                         const float **out_result) {
   xgboost_CHECK_C_ARG_PTR(c_json_config);
   auto config = Json::Load(StringView{c_json_config});
+  ScopedThreads threads{GetPredictThreads(config)};
 
   HostDeviceVector<float> *p_predt{nullptr};
   auto type = PredictionType(RequiredArg<Integer>(config, "type", __func__));
@@ -1348,10 +1739,165 @@ XGB_DLL int XGBoosterPredictFromCUDAColumnar(BoosterHandle handle, char const *,
 }
 #endif  // !defined(XGBOOST_USE_CUDA)
 
-XGB_DLL int XGBoosterLoadModel(BoosterHandle handle, const char* fname) {
+namespace {
+/**
+ * @brief Prediction parameters parsed once, along with the reused output buffer.
+ */
+struct PreparedPredict {
+  Learner *learner;
+  PredictionType type;
+  float missing;
+  bst_layer_t iteration_begin;
+  bst_layer_t iteration_end;
+  std::int32_t n_threads;
+  HostDeviceVector<float> predt;
+};
+}  // namespace
+
+XGB_DLL int XGBoosterCreatePredictHandle(BoosterHandle handle, char const *c_json_config,
+                                         PredictHandle *out, xgboost::bst_ulong *out_row_size) {
   API_BEGIN();
   CHECK_HANDLE();
-  xgboost_CHECK_C_ARG_PTR(fname);
+  xgboost_CHECK_C_ARG_PTR(c_json_config);
+  xgboost_CHECK_C_ARG_PTR(out);
+  xgboost_CHECK_C_ARG_PTR(out_row_size);
+
+  auto config = Json::Load(StringView{c_json_config});
+  auto type = PredictionType(RequiredArg<Integer>(config, "type", __func__));
+  CHECK(type == PredictionType::kValue || type == PredictionType::kMargin)
+      << "Only normal prediction and output margin are supported by the predict handle.";
+  auto p_predict = std::make_unique<PreparedPredict>();
+  p_predict->learner = static_cast<Learner *>(handle);
+  p_predict->type = type;
+  p_predict->missing = GetMissing(config);
+  p_predict->iteration_begin = RequiredArg<Integer>(config, "iteration_begin", __func__);
+  p_predict->iteration_end = RequiredArg<Integer>(config, "iteration_end", __func__);
+  p_predict->n_threads = GetPredictThreads(config);
+  ScopedThreads threads{p_predict->n_threads};
+
+  // The output size of a row depends on the objective (like `multi:softmax`), obtain it
+  // by predicting a row of missing values. This also prepares the predictor.
+  std::vector<float> row(p_predict->learner->GetNumFeature(), p_predict->missing);
+  p_predict->learner->PredictDense(row.data(), 1, p_predict->missing, p_predict->type,
+                                   p_predict->iteration_begin, p_predict->iteration_end,
+                                   &p_predict->predt);
+  *out_row_size = p_predict->predt.Size();
+  *out = p_predict.release();
+  API_END();
+}
+
+XGB_DLL int XGBoosterPredictWithHandle(PredictHandle handle, float const *data,
+                                       xgboost::bst_ulong n_rows, float *out_result) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  auto *p_predict = static_cast<PreparedPredict *>(handle);
+  if (n_rows != 0) {
+    xgboost_CHECK_C_ARG_PTR(data);
+    xgboost_CHECK_C_ARG_PTR(out_result);
+  }
+  ScopedThreads threads{p_predict->n_threads};
+  p_predict->learner->PredictDense(data, n_rows, p_predict->missing, p_predict->type,
+                                   p_predict->iteration_begin, p_predict->iteration_end,
+                                   &p_predict->predt);
+  auto const &h_predt = p_predict->predt.ConstHostVector();
+  std::copy(h_predt.cbegin(), h_predt.cend(), out_result);
+  API_END();
+}
+
+XGB_DLL int XGBoosterPredictWithHandles(PredictHandle const *handles,
+                                        xgboost::bst_ulong n_handles, float const *data,
+                                        xgboost::bst_ulong n_rows, float *const *out_results) {
+  API_BEGIN();
+  if (n_handles == 0) {
+    return 0;
+  }
+  xgboost_CHECK_C_ARG_PTR(handles);
+  xgboost_CHECK_C_ARG_PTR(out_results);
+  if (n_rows != 0) {
+    xgboost_CHECK_C_ARG_PTR(data);
+  }
+  std::vector<DensePredictEntry> entries(n_handles);
+  float missing = std::numeric_limits<float>::quiet_NaN();
+  for (xgboost::bst_ulong i = 0; i < n_handles; ++i) {
+    auto *p_predict = static_cast<PreparedPredict *>(handles[i]);
+    CHECK(p_predict) << "Invalid prediction handle.";
+    if (i == 0) {
+      missing = p_predict->missing;
+    } else {
+      CHECK(p_predict->missing == missing ||
+            (std::isnan(p_predict->missing) && std::isnan(missing)))
+          << "All prediction handles must use the same missing value.";
+    }
+    if (n_rows != 0) {
+      xgboost_CHECK_C_ARG_PTR(out_results[i]);
+    }
+    entries[i] = DensePredictEntry{p_predict->learner, p_predict->type,
+                                   p_predict->iteration_begin, p_predict->iteration_end,
+                                   &p_predict->predt};
+  }
+  ScopedThreads threads{static_cast<PreparedPredict *>(handles[0])->n_threads};
+  Learner::PredictDenseMulti(entries, data, n_rows, missing);
+  for (xgboost::bst_ulong i = 0; i < n_handles; ++i) {
+    auto const &h_predt = entries[i].out_preds->ConstHostVector();
+    std::copy(h_predt.cbegin(), h_predt.cend(), out_results[i]);
+  }
+  API_END();
+}
+
+XGB_DLL int XGPredictHandleFree(PredictHandle handle) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  delete static_cast<PreparedPredict *>(handle);
+  API_END();
+}
+
+XGB_DLL int XGBoosterPredictCascade(BoosterHandle handle, DMatrixHandle dmat,
+                                    char const *c_json_config, xgboost::bst_ulong *out_len,
+                                    float const **out_result, std::uint8_t const **out_finished) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  if (dmat == nullptr) {
+    LOG(FATAL) << "DMatrix has not been initialized or has already been disposed.";
+  }
+  xgboost_CHECK_C_ARG_PTR(c_json_config);
+  auto config = Json::Load(StringView{c_json_config});
+
+  auto *learner = static_cast<Learner *>(handle);
+  auto p_m = *static_cast<std::shared_ptr<DMatrix> *>(dmat);
+  auto type = PredictionType(RequiredArg<Integer>(config, "type", __func__));
+  auto iteration_begin = RequiredArg<Integer>(config, "iteration_begin", __func__);
+  auto iteration_end = RequiredArg<Integer>(config, "iteration_end", __func__);
+  std::vector<bst_layer_t> checkpoints;
+  for (auto const &v : RequiredArg<Array>(config, "checkpoints", __func__)) {
+    checkpoints.push_back(get<Integer const>(v));
+  }
+  std::vector<float> thresholds;
+  for (auto const &v : RequiredArg<Array>(config, "thresholds", __func__)) {
+    thresholds.push_back(IsA<Integer>(v) ? get<Integer const>(v) : get<Number const>(v));
+  }
+  auto const &obj = get<Object const>(config);
+  float missing = std::numeric_limits<float>::quiet_NaN();
+  if (obj.find("missing") != obj.cend()) {
+    missing = GetMissing(config);
+  }
+
+  auto &entry = learner->GetThreadLocal().prediction_entry;
+  auto &finished = learner->GetThreadLocal().prediction_finished;
+  learner->PredictCascade(p_m, type, missing, iteration_begin, iteration_end, checkpoints,
+                          thresholds, &entry.predictions, &finished);
+
+  xgboost_CHECK_C_ARG_PTR(out_len);
+  xgboost_CHECK_C_ARG_PTR(out_result);
+  xgboost_CHECK_C_ARG_PTR(out_finished);
+  *out_len = finished.Size();
+  *out_result = dmlc::BeginPtr(entry.predictions.ConstHostVector());
+  *out_finished = dmlc::BeginPtr(finished.ConstHostVector());
+  API_END();
+}
+
+namespace {
+// Load a model file with the format chosen by the file extension.
+void LoadModelFile(Learner *learner, char const *fname) {
   auto read_file = [&]() {
     auto str = common::LoadSequentialFile(fname);
     CHECK_GE(str.size(), 3);  // "{}\0"
@@ -1360,16 +1906,59 @@ XGB_DLL int XGBoosterLoadModel(BoosterHandle handle, const char* fname) {
   };
   if (common::FileExtension(fname) == "json") {
     auto buffer = read_file();
-    Json in{Json::Load(StringView{buffer.data(), buffer.size()})};
-    static_cast<Learner*>(handle)->LoadModel(in);
+    learner->LoadModel(StringView{buffer.data(), buffer.size()}, std::ios::in);
   } else if (common::FileExtension(fname) == "ubj") {
     auto buffer = read_file();
-    Json in = Json::Load(StringView{buffer.data(), buffer.size()}, std::ios::binary);
-    static_cast<Learner *>(handle)->LoadModel(in);
+    learner->LoadModel(StringView{buffer.data(), buffer.size()}, std::ios::binary);
+  } else if (common::FileExtension(fname) == "mmap") {
+    learner->LoadMmapModel(fname);
   } else {
     std::unique_ptr<dmlc::Stream> fi(dmlc::Stream::Create(fname, "r"));
-    static_cast<Learner*>(handle)->LoadModel(fi.get());
+    learner->LoadModel(fi.get());
   }
+}
+}  // anonymous namespace
+
+XGB_DLL int XGBoosterLoadModel(BoosterHandle handle, const char* fname) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  xgboost_CHECK_C_ARG_PTR(fname);
+  LoadModelFile(static_cast<Learner *>(handle), fname);
+  API_END();
+}
+
+XGB_DLL int XGBoosterLoadModelLazy(BoosterHandle handle, char const *fname, char const *config) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  xgboost_CHECK_C_ARG_PTR(fname);
+  xgboost_CHECK_C_ARG_PTR(config);
+  auto jconfig = Json::Load(StringView{config});
+  auto max_bytes = OptionalArg<Integer, std::int64_t>(jconfig, "max_bytes", 0);
+  CHECK_GE(max_bytes, 0);
+  static_cast<Learner *>(handle)->LoadLazyModel(fname, static_cast<std::size_t>(max_bytes));
+  API_END();
+}
+
+XGB_DLL int XGBoosterSavePredictionCache(BoosterHandle handle, DMatrixHandle dtrain,
+                                         char const *fname) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  xgboost_CHECK_C_ARG_PTR(dtrain);
+  xgboost_CHECK_C_ARG_PTR(fname);
+  auto *dtr = static_cast<std::shared_ptr<DMatrix> *>(dtrain);
+  static_cast<Learner *>(handle)->SavePredictionCache(*dtr, fname);
+  API_END();
+}
+
+XGB_DLL int XGBoosterLoadPredictionCache(BoosterHandle handle, DMatrixHandle dtrain,
+                                         char const *fname, int *out_loaded) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  xgboost_CHECK_C_ARG_PTR(dtrain);
+  xgboost_CHECK_C_ARG_PTR(fname);
+  xgboost_CHECK_C_ARG_PTR(out_loaded);
+  auto *dtr = static_cast<std::shared_ptr<DMatrix> *>(dtrain);
+  *out_loaded = static_cast<Learner *>(handle)->LoadPredictionCache(*dtr, fname);
   API_END();
 }
 
@@ -1385,27 +1974,29 @@ XGB_DLL int XGBoosterSaveModel(BoosterHandle handle, const char *fname) {
   CHECK_HANDLE();
   xgboost_CHECK_C_ARG_PTR(fname);
 
-  std::unique_ptr<dmlc::Stream> fo(dmlc::Stream::Create(fname, "w"));
   auto *learner = static_cast<Learner *>(handle);
   learner->Configure();
   auto save_json = [&](std::ios::openmode mode) {
+    std::unique_ptr<dmlc::Stream> fo(dmlc::Stream::Create(fname, "w"));
     Json out{Object()};
     learner->SaveModel(&out);
     std::vector<char> str;
-    Json::Dump(out, &str, mode);
+    Json::Dump(out, &str, mode, learner->Ctx()->Threads());
     fo->Write(str.data(), str.size());
   };
   if (common::FileExtension(fname) == "json") {
     save_json(std::ios::out);
   } else if (common::FileExtension(fname) == "ubj") {
     save_json(std::ios::binary);
+  } else if (common::FileExtension(fname) == "mmap") {
+    learner->SaveMmapModel(fname);
   } else if (common::FileExtension(fname) == "deprecated") {
     WarnOldModel();
-    auto *bst = static_cast<Learner *>(handle);
-    bst->SaveModel(fo.get());
+    std::unique_ptr<dmlc::Stream> fo(dmlc::Stream::Create(fname, "w"));
+    learner->SaveModel(fo.get());
   } else {
     LOG(WARNING) << "Saving model in the UBJSON format as default.  You can use file extension:"
-                    " `json`, `ubj` or `deprecated` to choose between formats.";
+                    " `json`, `ubj`, `mmap` or `deprecated` to choose between formats.";
     save_json(std::ios::binary);
   }
   API_END();
@@ -1422,6 +2013,129 @@ XGB_DLL int XGBoosterLoadModelFromBuffer(BoosterHandle handle, const void *buf,
   API_END();
 }
 
+namespace {
+/**
+ * @brief A slot holding the serving model, which can be replaced while predictions are
+ *        running.
+ *
+ *   The model is published by an atomic exchange of the shared pointer. Each prediction
+ *   pins the model it's using, so the replaced model is freed by the last prediction that
+ *   holds it.
+ */
+class ModelSlot {
+  Args params_;
+  // Only accessed with the atomic functions for shared_ptr.
+  std::shared_ptr<Learner> current_;
+  std::uint64_t version_{0};
+  // Models are loaded one at a time.
+  std::mutex load_lock_;
+
+  // Predict a row of missing values with all the trees to build the caches of the
+  // predictor, like the compiled forest and the device model.
+  static void Warm(Learner *learner) {
+    auto n_features = learner->GetNumFeature();
+    if (n_features == 0) {
+      return;
+    }
+    auto nan = std::numeric_limits<float>::quiet_NaN();
+    std::vector<float> row(n_features, nan);
+    data::DenseAdapter adapter{row.data(), 1, n_features};
+    std::shared_ptr<DMatrix> p_fmat{DMatrix::Create(&adapter, nan, 1)};
+    HostDeviceVector<float> predt;
+    learner->Predict(p_fmat, false, &predt, 0, 0);
+  }
+
+ public:
+  explicit ModelSlot(Args params) : params_{std::move(params)} {}
+
+  /**
+   * @brief Load a new booster with `load_fn`, prepare it for inference, then publish it.
+   *
+   * @return The version of the published model, starting from 1.
+   */
+  template <typename Fn>
+  [[nodiscard]] std::uint64_t Load(Fn &&load_fn) {
+    std::lock_guard guard{load_lock_};
+    std::shared_ptr<Learner> learner{Learner::Create({})};
+    load_fn(learner.get());
+    learner->SetParams(params_);
+    learner->Freeze();
+    Warm(learner.get());
+    std::atomic_store_explicit(&current_, std::move(learner), std::memory_order_release);
+    return ++version_;
+  }
+  [[nodiscard]] std::shared_ptr<Learner> Acquire() const {
+    auto learner = std::atomic_load_explicit(&current_, std::memory_order_acquire);
+    CHECK(learner) << "No model has been loaded into the slot.";
+    return learner;
+  }
+};
+}  // anonymous namespace
+
+XGB_DLL int XGModelSlotCreate(char const *config, ModelSlotHandle *out) {
+  API_BEGIN();
+  xgboost_CHECK_C_ARG_PTR(config);
+  xgboost_CHECK_C_ARG_PTR(out);
+  auto jconfig = Json::Load(StringView{config});
+  Args params;
+  for (auto const &kv : get<Object const>(jconfig)) {
+    params.emplace_back(kv.first, IsA<String>(kv.second) ? get<String const>(kv.second)
+                                                         : Json::Dump(kv.second));
+  }
+  *out = new ModelSlot{std::move(params)};
+  API_END();
+}
+
+XGB_DLL int XGModelSlotFree(ModelSlotHandle handle) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  delete static_cast<ModelSlot *>(handle);
+  API_END();
+}
+
+XGB_DLL int XGModelSlotLoad(ModelSlotHandle handle, char const *fname, bst_ulong *out_version) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  xgboost_CHECK_C_ARG_PTR(fname);
+  xgboost_CHECK_C_ARG_PTR(out_version);
+  *out_version = static_cast<ModelSlot *>(handle)->Load(
+      [&](Learner *learner) { LoadModelFile(learner, fname); });
+  API_END();
+}
+
+XGB_DLL int XGModelSlotLoadFromBuffer(ModelSlotHandle handle, void const *buf, bst_ulong len,
+                                      bst_ulong *out_version) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  xgboost_CHECK_C_ARG_PTR(buf);
+  xgboost_CHECK_C_ARG_PTR(out_version);
+  *out_version = static_cast<ModelSlot *>(handle)->Load([&](Learner *learner) {
+    common::MemoryFixSizeBuffer fs(const_cast<void *>(buf), len);
+    learner->LoadModel(&fs);
+  });
+  API_END();
+}
+
+XGB_DLL int XGModelSlotAcquire(ModelSlotHandle handle, ModelPinHandle *out_pin,
+                               BoosterHandle *out_booster) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  xgboost_CHECK_C_ARG_PTR(out_pin);
+  xgboost_CHECK_C_ARG_PTR(out_booster);
+  auto pin = std::make_unique<std::shared_ptr<Learner>>(
+      static_cast<ModelSlot const *>(handle)->Acquire());
+  *out_booster = pin->get();
+  *out_pin = pin.release();
+  API_END();
+}
+
+XGB_DLL int XGModelPinFree(ModelPinHandle handle) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  delete static_cast<std::shared_ptr<Learner> *>(handle);
+  API_END();
+}
+
 XGB_DLL int XGBoosterSaveModelToBuffer(BoosterHandle handle, char const *json_config,
                                        xgboost::bst_ulong *out_len, char const **out_dptr) {
   API_BEGIN();
@@ -1437,11 +2151,16 @@ XGB_DLL int XGBoosterSaveModelToBuffer(BoosterHandle handle, char const *json_co
   auto *learner = static_cast<Learner *>(handle);
   learner->Configure();
 
+  auto serving = OptionalArg<Boolean>(config, "serving", false);
   auto save_json = [&](std::ios::openmode mode) {
     std::vector<char> &raw_char_vec = learner->GetThreadLocal().ret_char_vec;
     Json out{Object{}};
-    learner->SaveModel(&out);
-    Json::Dump(out, &raw_char_vec, mode);
+    if (serving) {
+      learner->SaveServingModel(&out);
+    } else {
+      learner->SaveModel(&out);
+    }
+    Json::Dump(out, &raw_char_vec, mode, learner->Ctx()->Threads());
     *out_dptr = dmlc::BeginPtr(raw_char_vec);
     *out_len = static_cast<xgboost::bst_ulong>(raw_char_vec.size());
   };
@@ -1518,6 +2237,15 @@ XGB_DLL int XGBoosterSlice(BoosterHandle handle, int begin_layer, int end_layer,
   API_END();
 }
 
+XGB_DLL int XGBoosterAppend(BoosterHandle handle, BoosterHandle other) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  xgboost_CHECK_C_ARG_PTR(other);
+  auto *learner = static_cast<Learner *>(handle);
+  learner->Append(static_cast<Learner *>(other));
+  API_END();
+}
+
 inline void XGBoostDumpModelImpl(BoosterHandle handle, FeatureMap* fmap,
                                  int with_stats, const char *format,
                                  xgboost::bst_ulong *len,
@@ -1599,6 +2327,49 @@ XGB_DLL int XGBoosterDumpModelExWithFeatures(BoosterHandle handle,
   API_END();
 }
 
+XGB_DLL int XGBoosterDumpModelStream(BoosterHandle handle, char const *config,
+                                     XGBoosterDumpCallback *callback, void *user_data) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  xgboost_CHECK_C_ARG_PTR(config);
+  xgboost_CHECK_C_ARG_PTR(callback);
+  auto jconfig = Json::Load(StringView{config});
+  auto uri = OptionalArg<String>(jconfig, "fmap", std::string{});
+  auto with_stats = OptionalArg<Boolean>(jconfig, "with_stats", false);
+  auto format = OptionalArg<String>(jconfig, "format", std::string{"text"});
+
+  auto *bst = static_cast<Learner *>(handle);
+  bst->Configure();
+  FeatureMap featmap = LoadFeatureMap(uri);
+  GenerateFeatureMap(bst, {}, bst->GetNumFeature(), &featmap);
+
+  xgboost::bst_ulong idx = 0;
+  bst->DumpModelTo(featmap, with_stats, format, [&](std::string const &dump) {
+    return callback(idx++, dump.data(), dump.size(), user_data) == 0;
+  });
+  API_END();
+}
+
+XGB_DLL int XGBoosterGenerateCode(BoosterHandle handle, char const *c_json_config,
+                                  xgboost::bst_ulong *out_len, char const **out_str) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  xgboost_CHECK_C_ARG_PTR(c_json_config);
+  auto config = Json::Load(StringView{c_json_config});
+  auto iteration_begin = RequiredArg<Integer>(config, "iteration_begin", __func__);
+  auto iteration_end = RequiredArg<Integer>(config, "iteration_end", __func__);
+
+  auto *learner = static_cast<Learner *>(handle);
+  std::string &raw_str = learner->GetThreadLocal().ret_str;
+  raw_str = learner->GenerateCode(iteration_begin, iteration_end);
+
+  xgboost_CHECK_C_ARG_PTR(out_str);
+  xgboost_CHECK_C_ARG_PTR(out_len);
+  *out_str = raw_str.c_str();
+  *out_len = static_cast<xgboost::bst_ulong>(raw_str.length());
+  API_END();
+}
+
 XGB_DLL int XGBoosterGetAttr(BoosterHandle handle, const char *key, const char **out,
                              int *success) {
   auto* bst = static_cast<Learner*>(handle);
@@ -1787,3 +2558,50 @@ XGB_DLL int XGBoosterFeatureScore(BoosterHandle handle, char const *config,
   *out_features = dmlc::BeginPtr(feature_names_c);
   API_END();
 }
+
+XGB_DLL int XGBoosterFeatureImportance(BoosterHandle handle, char const *config,
+                                       xgboost::bst_ulong *out_dim,
+                                       xgboost::bst_ulong const **out_shape,
+                                       float const **out_scores) {
+  API_BEGIN();
+  CHECK_HANDLE();
+  auto *learner = static_cast<Learner *>(handle);
+  xgboost_CHECK_C_ARG_PTR(config);
+  auto jconfig = Json::Load(StringView{config});
+  auto importance = RequiredArg<String>(jconfig, "importance_type", __func__);
+  std::vector<int32_t> tree_idx;
+  if (!IsA<Null>(jconfig["tree_idx"])) {
+    for (auto const &idx : get<Array const>(jconfig["tree_idx"])) {
+      tree_idx.push_back(get<Integer const>(idx));
+    }
+  }
+
+  std::vector<float> scores;
+  std::vector<bst_feature_t> features;
+  learner->CalcFeatureScore(importance, common::Span<int32_t const>(tree_idx), &features, &scores);
+  bst_ulong n_features = learner->GetNumFeature();
+  auto &out = learner->GetThreadLocal().ret_vec_float;
+  auto &shape = learner->GetThreadLocal().prediction_shape;
+  xgboost_CHECK_C_ARG_PTR(out_dim);
+  if (scores.size() > features.size()) {
+    // Linear model multi-class model, all features are included.
+    CHECK_EQ(scores.size() % features.size(), 0ul);
+    out = std::move(scores);
+    *out_dim = 2;
+    shape = {n_features, out.size() / n_features};
+  } else {
+    CHECK_EQ(features.size(), scores.size());
+    out.assign(n_features, 0.0f);
+    for (std::size_t i = 0; i < features.size(); ++i) {
+      CHECK_LT(features[i], n_features);
+      out[features[i]] = scores[i];
+    }
+    *out_dim = 1;
+    shape = {n_features};
+  }
+  xgboost_CHECK_C_ARG_PTR(out_shape);
+  xgboost_CHECK_C_ARG_PTR(out_scores);
+  *out_shape = dmlc::BeginPtr(shape);
+  *out_scores = out.data();
+  API_END();
+}
@@ -6,7 +6,9 @@
 
 #include <algorithm>   // for min
 #include <cstddef>     // for size_t
+#include <cstdint>     // for int32_t, int64_t
 #include <functional>  // for multiplies
+#include <limits>      // for numeric_limits
 #include <memory>      // for shared_ptr
 #include <numeric>     // for accumulate
 #include <string>      // for string
@@ -177,6 +179,16 @@ inline float GetMissing(Json const &config) {
   return missing;
 }
 
+/**
+ * @brief The optional `nthread` of a prediction call, 0 to use the booster parameter.
+ */
+inline std::int32_t GetPredictThreads(Json const &config) {
+  auto n_threads = OptionalArg<Integer, std::int64_t>(config, "nthread", 0);
+  CHECK_GE(n_threads, 0) << "Invalid `nthread` for prediction.";
+  CHECK_LE(n_threads, std::numeric_limits<std::int32_t>::max());
+  return static_cast<std::int32_t>(n_threads);
+}
+
 // Safe guard some global variables from being changed by XGBoost.
 class XGBoostAPIGuard {
 #if defined(XGBOOST_USE_CUDA)
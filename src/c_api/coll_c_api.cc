@@ -8,6 +8,7 @@
 #include <thread>       // for sleep_for
 #include <type_traits>  // for is_same_v, remove_pointer_t
 #include <utility>      // for pair
+#include <vector>       // for vector
 
 #include "../collective/allgather.h"         // for Allgather
 #include "../collective/allreduce.h"         // for Allreduce
@@ -15,6 +16,7 @@
 #include "../collective/comm.h"              // for DefaultTimeoutSec
 #include "../collective/comm_group.h"        // for GlobalCommGroup
 #include "../collective/communicator-inl.h"  // for GetProcessorName
+#include "../collective/rebalance.h"         // for PlanRebalance
 #include "../collective/tracker.h"           // for RabitTracker
 #include "../common/timer.h"                 // for Timer
 #include "c_api_error.h"                     // for API_BEGIN
@@ -238,6 +240,60 @@ XGB_DLL int XGCommunicatorGetProcessorName(char const **name_str) {
   API_END();
 }
 
+XGB_DLL int XGCommunicatorGetStats(char const *config, char const **out) {
+  API_BEGIN();
+  xgboost_CHECK_C_ARG_PTR(config);
+  xgboost_CHECK_C_ARG_PTR(out);
+  auto jconfig = Json::Load(StringView{config});
+  auto reset = OptionalArg<Boolean>(jconfig, "reset", false);
+  auto stats = collective::GlobalCommGroup()->Stats();
+  auto &local = *CollAPIThreadLocalStore::Get();
+  local.ret_str = Json::Dump(stats->ToJson());
+  if (reset) {
+    stats->Clear();
+  }
+  *out = local.ret_str.c_str();
+  API_END();
+}
+
+XGB_DLL int XGCommunicatorPlanRebalance(char const *config, char const **out) {
+  API_BEGIN();
+  xgboost_CHECK_C_ARG_PTR(config);
+  xgboost_CHECK_C_ARG_PTR(out);
+  auto jconfig = Json::Load(StringView{config});
+  double tolerance = OptionalArg<Number, float>(jconfig, "tolerance", 0.1f);
+  CHECK_GE(tolerance, 0.0);
+  Context ctx;
+  std::vector<collective::WorkerLoad> loads;
+  std::vector<collective::RowTransfer> transfers;
+  auto const &comm = *collective::GlobalCommGroup();
+  SafeColl(collective::PlanRebalance(&ctx, comm, tolerance, &loads, &transfers));
+
+  Json jout{Object{}};
+  Json jloads{Array{}};
+  for (auto const &load : loads) {
+    Json jload{Object{}};
+    jload["n_rows"] = Integer{load.n_rows};
+    jload["build"] = Number{load.build};
+    jload["n_updates"] = Integer{load.n_updates};
+    get<Array>(jloads).emplace_back(std::move(jload));
+  }
+  Json jtransfers{Array{}};
+  for (auto const &transfer : transfers) {
+    Json jtransfer{Object{}};
+    jtransfer["src"] = Integer{transfer.src};
+    jtransfer["dst"] = Integer{transfer.dst};
+    jtransfer["n_rows"] = Integer{transfer.n_rows};
+    get<Array>(jtransfers).emplace_back(std::move(jtransfer));
+  }
+  jout["loads"] = std::move(jloads);
+  jout["transfers"] = std::move(jtransfers);
+  auto &local = *CollAPIThreadLocalStore::Get();
+  local.ret_str = Json::Dump(jout);
+  *out = local.ret_str.c_str();
+  API_END();
+}
+
 XGB_DLL int XGCommunicatorBroadcast(void *send_receive_buffer, size_t size, int root) {
   API_BEGIN();
   collective::Broadcast(send_receive_buffer, size, root);
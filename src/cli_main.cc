@@ -12,24 +12,38 @@
 #include <xgboost/logging.h>
 #include <xgboost/parameter.h>
 
+#include <xgboost/global_config.h>
+
+#include <algorithm>
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <ctime>
+#include <future>
 #include <iomanip>
+#include <limits>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "c_api/c_api_utils.h"
 #include "common/common.h"
 #include "common/config.h"
 #include "common/io.h"
+#include "common/threading_utils.h"
+#include "common/threadpool.h"
 #include "common/version.h"
+#include "data/file_iterator.h"
+#include "data/libsvm_parser.h"
+#include "data/proxy_dmatrix.h"
 
 namespace xgboost {
 enum CLITask {
   kTrain = 0,
   kDumpModel = 1,
-  kPredict = 2
+  kPredict = 2,
+  kCodegen = 3
 };
 
 struct CLIParam : public XGBoostParameter<CLIParam> {
@@ -61,6 +75,8 @@ struct CLIParam : public XGBoostParameter<CLIParam> {
   int iteration_end;
   /*!\brief whether to directly output margin value */
   bool pred_margin;
+  /*! \brief number of rows predicted at a time, 0 means loading the entire test data */
+  std::size_t pred_batch_rows;
   /*! \brief whether dump statistics along with model */
   int dump_stats;
   /*! \brief what format to dump the model in */
@@ -69,6 +85,8 @@ struct CLIParam : public XGBoostParameter<CLIParam> {
   std::string name_fmap;
   /*! \brief name of dump file */
   std::string name_dump;
+  /*! \brief name of the generated source file */
+  std::string name_code;
   /*! \brief the paths of validation data sets */
   std::vector<std::string> eval_data_paths;
   /*! \brief the names of the evaluation data used in output log */
@@ -85,6 +103,7 @@ struct CLIParam : public XGBoostParameter<CLIParam> {
         .add_enum("train", kTrain)
         .add_enum("dump", kDumpModel)
         .add_enum("pred", kPredict)
+        .add_enum("codegen", kCodegen)
         .describe("Task to be performed by the CLI program.");
     DMLC_DECLARE_FIELD(eval_train).set_default(false)
         .describe("Whether evaluate on training data during training.");
@@ -116,6 +135,9 @@ struct CLIParam : public XGBoostParameter<CLIParam> {
         .describe("End of boosted tree iteration used for prediction.  0 means all the trees.");
     DMLC_DECLARE_FIELD(pred_margin).set_default(false)
         .describe("Whether to predict margin value instead of probability.");
+    DMLC_DECLARE_FIELD(pred_batch_rows).set_default(0)
+        .describe("Stream the test data in batches of this many rows for prediction, "
+                  "0 means loading the entire test data.");
     DMLC_DECLARE_FIELD(dump_stats).set_default(false)
         .describe("Whether dump the model statistics.");
     DMLC_DECLARE_FIELD(dump_format).set_default("text")
@@ -124,6 +146,8 @@ struct CLIParam : public XGBoostParameter<CLIParam> {
         .describe("Name of the feature map file.");
     DMLC_DECLARE_FIELD(name_dump).set_default("dump.txt")
         .describe("Name of the output dump text file.");
+    DMLC_DECLARE_FIELD(name_code).set_default("model.c")
+        .describe("Name of the C source file generated by the codegen task.");
     // alias
     DMLC_DECLARE_ALIAS(train_path, data);
     DMLC_DECLARE_ALIAS(test_path, test:data);
@@ -156,6 +180,89 @@ constexpr char const* const CLIParam::kNull;
 
 DMLC_REGISTER_PARAMETER(CLIParam);
 
+/*!
+ * \brief A batch of rows from the test data in the CSR format.
+ */
+struct RowBatch {
+  std::vector<std::size_t> indptr{0};
+  std::vector<std::uint32_t> indices;
+  std::vector<float> values;
+
+  [[nodiscard]] bst_idx_t Size() const { return indptr.size() - 1; }
+};
+
+/*!
+ * \brief Read the text data in batches of a fixed number of rows, regardless of the size
+ *        of the blocks returned by the parser.
+ */
+class BatchReader {
+  std::unique_ptr<dmlc::Parser<std::uint32_t>> parser_;
+  dmlc::RowBlock<std::uint32_t> block_{};
+  // The first row in the current block that is not read yet.
+  std::size_t offset_{0};
+
+ public:
+  explicit BatchReader(std::string const& uri) {
+    CHECK_EQ(uri.find('#'), std::string::npos)
+        << "External memory cache is not supported by streaming prediction.";
+    auto fname = data::ValidateFileFormat(uri);
+    parser_ = data::TryCreateNativeParser(fname, Context{}.Threads());
+    if (!parser_) {
+      parser_.reset(dmlc::Parser<std::uint32_t>::Create(fname.c_str(), 0, 1, "auto"));
+    }
+  }
+
+  /*! \brief Returns an empty batch at the end of the data. */
+  RowBatch Next(bst_idx_t n_rows) {
+    RowBatch out;
+    while (out.Size() < n_rows) {
+      if (offset_ == block_.size) {
+        if (!parser_->Next()) {
+          break;
+        }
+        block_ = parser_->Value();
+        offset_ = 0;
+        continue;
+      }
+      auto n = std::min(static_cast<bst_idx_t>(block_.size - offset_), n_rows - out.Size());
+      for (auto i = offset_; i < offset_ + n; ++i) {
+        for (auto j = block_.offset[i]; j < block_.offset[i + 1]; ++j) {
+          out.indices.push_back(block_.index[j]);
+          out.values.push_back(block_.value ? block_.value[j] : 1.0f);
+        }
+        out.indptr.push_back(out.indices.size());
+      }
+      offset_ += n;
+    }
+    return out;
+  }
+};
+
+/*!
+ * \brief Format the predictions as text in parallel, one value on each line.
+ */
+std::string FormatPredictions(std::vector<float> const& preds, std::int32_t n_threads) {
+  constexpr std::size_t kBlockSize = 4096;
+  auto n_blocks = common::DivRoundUp(preds.size(), kBlockSize);
+  std::vector<std::string> blocks(n_blocks);
+  common::ParallelFor(n_blocks, n_threads, [&](auto k) {
+    // Same as `std::setprecision(max_digits10)` for the stream.
+    char buf[64];
+    auto end = std::min(preds.size(), (k + 1) * kBlockSize);
+    for (auto i = k * kBlockSize; i < end; ++i) {
+      auto n = std::snprintf(buf, sizeof(buf), "%.*g\n",
+                             std::numeric_limits<bst_float>::max_digits10,
+                             static_cast<double>(preds[i]));
+      blocks[k].append(buf, n);
+    }
+  });
+  std::string out;
+  for (auto const& b : blocks) {
+    out.append(b);
+  }
+  return out;
+}
+
 std::string CliHelp() {
   return "Use xgboost -h for showing help information.\n";
 }
@@ -270,33 +377,53 @@ class CLI {
     this->ResetLearner({});
 
     // dump data
-    std::vector<std::string> dump =
-        learner_->DumpModel(fmap, param_.dump_stats, param_.dump_format);
     std::unique_ptr<dmlc::Stream> fo(
         dmlc::Stream::Create(param_.name_dump.c_str(), "w"));
     dmlc::ostream os(fo.get());
-    if (param_.dump_format == "json") {
+    bool is_json = param_.dump_format == "json";
+    std::size_t i = 0;
+    if (is_json) {
       os << "[" << std::endl;
-      for (size_t i = 0; i < dump.size(); ++i) {
-        if (i != 0) {
-          os << "," << std::endl;
-        }
-        os << dump[i];  // Dump the previously generated JSON here
-      }
+    }
+    // Write the trees as they are generated instead of holding the entire dump.
+    learner_->DumpModelTo(fmap, param_.dump_stats, param_.dump_format,
+                          [&](std::string const& dump) {
+                            if (is_json) {
+                              if (i != 0) {
+                                os << "," << std::endl;
+                              }
+                              os << dump;  // Dump the previously generated JSON here
+                            } else {
+                              os << "booster[" << i << "]:\n";
+                              os << dump;
+                            }
+                            ++i;
+                            return true;
+                          });
+    if (is_json) {
       os << std::endl << "]" << std::endl;
-    } else {
-      for (size_t i = 0; i < dump.size(); ++i) {
-        os << "booster[" << i << "]:\n";
-        os << dump[i];
-      }
     }
     // force flush before fo destruct.
     os.set_stream(nullptr);
   }
 
+  void CLICodegen() {
+    CHECK_NE(param_.model_in, CLIParam::kNull) << "Must specify model_in for codegen";
+    this->ResetLearner({});
+
+    auto code = learner_->GenerateCode(param_.iteration_begin, param_.iteration_end);
+    std::unique_ptr<dmlc::Stream> fo(dmlc::Stream::Create(param_.name_code.c_str(), "w"));
+    fo->Write(code.c_str(), code.size());
+    LOG(CONSOLE) << "Writing generated code to " << param_.name_code;
+  }
+
   void CLIPredict() {
     CHECK_NE(param_.test_path, CLIParam::kNull)
         << "Test dataset parameter test:data must be specified.";
+    if (param_.pred_batch_rows != 0) {
+      this->CLIPredictStream();
+      return;
+    }
     // load data
     std::shared_ptr<DMatrix> dtest(DMatrix::Load(
         param_.test_path,
@@ -328,6 +455,70 @@ class CLI {
     os.set_stream(nullptr);
   }
 
+  /*!
+   * \brief Predict the test data batch by batch with inplace prediction. Parsing the next
+   *        batch and writing the previous one run in the background while a batch is being
+   *        predicted, only three batches are in memory at a time.
+   */
+  void CLIPredictStream() {
+    CHECK_NE(param_.model_in, CLIParam::kNull) << "Must specify model_in for predict";
+    this->ResetLearner({});
+    if (param_.ntree_limit != 0) {
+      param_.iteration_end = GetIterationFromTreeLimit(param_.ntree_limit, learner_.get());
+      LOG(WARNING) << "`ntree_limit` is deprecated, use `iteration_begin` and "
+                      "`iteration_end` instead.";
+    }
+    auto n_threads = Context{}.Threads();
+    auto n_features = learner_->GetNumFeature();
+    auto type = param_.pred_margin ? PredictionType::kMargin : PredictionType::kValue;
+    BatchReader reader{param_.test_path};
+    std::unique_ptr<dmlc::Stream> fo(dmlc::Stream::Create(param_.name_pred.c_str(), "w"));
+    LOG(CONSOLE) << "Writing prediction to " << param_.name_pred;
+
+    common::ThreadPool parse_pool{StringView{"cli-parse"}, 1, InitNewThread{}};
+    common::ThreadPool write_pool{StringView{"cli-write"}, 1, InitNewThread{}};
+    auto n_rows = static_cast<bst_idx_t>(param_.pred_batch_rows);
+    auto parse = [&] { return reader.Next(n_rows); };
+    auto next = parse_pool.Submit(parse);
+    std::future<void> written;
+    std::shared_ptr<DMatrix> p_m{new data::DMatrixProxy};
+    auto proxy = static_cast<data::DMatrixProxy*>(p_m.get());
+    bst_idx_t n_total{0};
+    while (true) {
+      auto batch = next.get();
+      if (batch.Size() == 0) {
+        break;
+      }
+      next = parse_pool.Submit(parse);
+
+      auto indptr = linalg::ArrayInterfaceStr(
+          linalg::MakeVec(batch.indptr.data(), batch.indptr.size()));
+      auto indices = linalg::ArrayInterfaceStr(
+          linalg::MakeVec(batch.indices.data(), batch.indices.size()));
+      auto values = linalg::ArrayInterfaceStr(
+          linalg::MakeVec(batch.values.data(), batch.values.size()));
+      proxy->SetCSRData(indptr.c_str(), indices.c_str(), values.c_str(), n_features, true);
+      HostDeviceVector<float>* out{nullptr};
+      learner_->InplacePredict(p_m, type, std::numeric_limits<float>::quiet_NaN(), &out,
+                               param_.iteration_begin, param_.iteration_end);
+      // The output is owned by the learner and is overwritten by the next batch.
+      std::vector<float> preds{out->ConstHostVector()};
+      n_total += batch.Size();
+
+      if (written.valid()) {
+        written.get();
+      }
+      written = write_pool.Submit([&fo, preds = std::move(preds), n_threads] {
+        auto str = FormatPredictions(preds, n_threads);
+        fo->Write(str.data(), str.size());
+      });
+    }
+    if (written.valid()) {
+      written.get();
+    }
+    LOG(INFO) << "Predicted " << n_total << " rows.";
+  }
+
   void LoadModel(std::string const& path, Learner* learner) const {
     if (common::FileExtension(path) == "json") {
       auto buffer = common::LoadSequentialFile(path);
@@ -478,6 +669,9 @@ class CLI {
       case kPredict:
         CLIPredict();
         break;
+      case kCodegen:
+        CLICodegen();
+        break;
       }
     } catch (dmlc::Error const& e) {
       xgboost::CLIError(e);
@@ -10,9 +10,11 @@
 #include <type_traits>  // for remove_cv_t
 #include <vector>       // for vector
 
+#include "../common/trace.h"            // for TraceScope
 #include "../common/type.h"             // for EraseType
 #include "comm.h"                       // for Comm, Channel
 #include "comm_group.h"                 // for CommGroup
+#include "stats.h"                      // for CallSite, ScopedCall
 #include "xgboost/collective/result.h"  // for Result
 #include "xgboost/linalg.h"             // for MakeVec
 #include "xgboost/span.h"               // for Span
@@ -105,12 +107,15 @@ template <typename T>
 
 template <typename T>
 [[nodiscard]] Result Allgather(Context const* ctx, CommGroup const& comm,
-                               linalg::VectorView<T> data) {
+                               linalg::VectorView<T> data, CallSite site = CallSite::Current()) {
   if (!comm.IsDistributed()) {
     return Success();
   }
   CHECK(data.Contiguous());
   auto erased = common::EraseType(data.Values());
+  ScopedCall scope{comm.Stats(), "Allgather", site, erased.size_bytes()};
+  common::TraceScope trace{common::TraceEvent::kAllgather,
+                           static_cast<std::int64_t>(erased.size_bytes())};
 
   auto const& cctx = comm.Ctx(ctx, data.Device());
   auto backend = comm.Backend(data.Device());
@@ -123,22 +128,27 @@ template <typename T>
  * @param data The input and output buffer, needs to be pre-allocated by the caller.
  */
 template <typename T>
-[[nodiscard]] Result Allgather(Context const* ctx, linalg::VectorView<T> data) {
+[[nodiscard]] Result Allgather(Context const* ctx, linalg::VectorView<T> data,
+                               CallSite site = CallSite::Current()) {
   auto const& cg = *GlobalCommGroup();
   if (data.Size() % cg.World() != 0) {
     return Fail("The total number of elements should be multiple of the number of workers.");
   }
-  return Allgather(ctx, cg, data);
+  return Allgather(ctx, cg, data, site);
 }
 
 template <typename T>
 [[nodiscard]] Result AllgatherV(Context const* ctx, CommGroup const& comm,
                                 linalg::VectorView<T> data,
                                 std::vector<std::int64_t>* recv_segments,
-                                HostDeviceVector<std::int8_t>* recv) {
+                                HostDeviceVector<std::int8_t>* recv,
+                                CallSite site = CallSite::Current()) {
   if (!comm.IsDistributed()) {
     return Success();
   }
+  ScopedCall scope{comm.Stats(), "AllgatherV", site, data.Values().size_bytes()};
+  common::TraceScope trace{common::TraceEvent::kAllgather,
+                           static_cast<std::int64_t>(data.Values().size_bytes())};
   std::vector<std::int64_t> sizes(comm.World(), 0);
   sizes[comm.Rank()] = data.Values().size_bytes();
   auto erased_sizes = common::EraseType(common::Span{sizes.data(), sizes.size()});
@@ -175,8 +185,9 @@ template <typename T>
 template <typename T>
 [[nodiscard]] Result AllgatherV(Context const* ctx, linalg::VectorView<T> data,
                                 std::vector<std::int64_t>* recv_segments,
-                                HostDeviceVector<std::int8_t>* recv) {
-  return AllgatherV(ctx, *GlobalCommGroup(), data, recv_segments, recv);
+                                HostDeviceVector<std::int8_t>* recv,
+                                CallSite site = CallSite::Current()) {
+  return AllgatherV(ctx, *GlobalCommGroup(), data, recv_segments, recv, site);
 }
 
 [[nodiscard]] std::vector<std::vector<char>> VectorAllgatherV(
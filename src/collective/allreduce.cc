@@ -3,15 +3,19 @@
  */
 #include "allreduce.h"
 
-#include <algorithm>  // for min
+#include <algorithm>  // for min, copy_n, find
 #include <cstddef>    // for size_t
 #include <cstdint>    // for int32_t, int8_t
+#include <iterator>   // for distance
+#include <numeric>    // for iota
+#include <string>     // for to_string
 #include <utility>    // for move
 #include <vector>     // for vector
 
 #include "../data/array_interface.h"    // for Type, DispatchDType
 #include "allgather.h"                  // for RingAllgather
-#include "comm.h"                       // for Comm
+#include "comm.h"                       // for Comm, HostTopology
+#include "stats.h"                      // for RecordAlgo
 #include "xgboost/collective/result.h"  // for Result
 #include "xgboost/span.h"               // for Span
 
@@ -147,4 +151,229 @@ Result RingAllreduce(Comm const& comm, common::Span<std::int8_t> data, Func cons
     };
   });
 }
+
+AllreduceAlgo SelectAllreduceAlgo(std::size_t n_bytes, std::int32_t world,
+                                  HostTopology const& topo) {
+  // Use the hierarchical allreduce when there are multiple hosts and some of them have
+  // more than one worker, otherwise, it only adds steps.
+  if (!topo.Empty() && topo.leaders.size() > 1 &&
+      topo.leaders.size() < static_cast<std::size_t>(world)) {
+    return AllreduceAlgo::kHierarchical;
+  }
+  return SelectAllreduceAlgo(n_bytes, world);
+}
+
+AllreduceAlgo SelectAllreduceAlgo(std::size_t n_bytes, std::int32_t world) {
+  // Each step of the recursive doubling sends the entire message, it's used when the
+  // latency dominates.
+  std::size_t constexpr kSmallBytes = 64 * 1024;
+  if (world <= 2 || n_bytes <= kSmallBytes) {
+    return AllreduceAlgo::kRecursiveDoubling;
+  }
+  return AllreduceAlgo::kRing;
+}
+
+namespace {
+// Recursive doubling among a subset of workers. `rank` and `world` are the position of
+// the current worker in `ranks` and the size of `ranks`.
+Result RecursiveDoublingImpl(Comm const& comm, common::Span<std::int32_t const> ranks,
+                             common::Span<std::int8_t> data, Func const& op) {
+  auto it = std::find(ranks.cbegin(), ranks.cend(), comm.Rank());
+  CHECK(it != ranks.cend());
+  auto rank = static_cast<std::int32_t>(std::distance(ranks.cbegin(), it));
+  auto world = static_cast<std::int32_t>(ranks.size());
+  if (world == 1 || data.empty()) {
+    return Success();
+  }
+  auto chan = [&](std::int32_t r) { return comm.Chan(ranks[r]); };
+
+  std::vector<std::int8_t> buffer(data.size_bytes());
+  auto s_buf = common::Span{buffer.data(), buffer.size()};
+  // Both peers compute `op(higher, lower)` so that they have the same result even if the
+  // operator is not commutative in floating point.
+  auto combine = [&](bool is_lower) {
+    if (is_lower) {
+      op(s_buf, data);
+    } else {
+      op(data, s_buf);
+      std::copy_n(s_buf.data(), s_buf.size(), data.data());
+    }
+  };
+
+  // Largest power of 2 that's not greater than the world size.
+  std::int32_t pof2 = 1;
+  while (pof2 * 2 <= world) {
+    pof2 *= 2;
+  }
+  auto n_extra = world - pof2;
+
+  // Fold the extra workers. Among the first 2 * n_extra workers, the even ones send their
+  // data to the next odd one and wait for the result.
+  std::int32_t vrank{-1};
+  if (rank < 2 * n_extra) {
+    if (rank % 2 == 0) {
+      auto rc = Success() << [&] {
+        return chan(rank + 1)->SendAll(data);
+      } << [&] {
+        return chan(rank + 1)->Block();
+      };
+      if (!rc.OK()) {
+        return Fail("Recursive doubling allreduce failed to fold.", std::move(rc));
+      }
+    } else {
+      auto rc = Success() << [&] {
+        return chan(rank - 1)->RecvAll(s_buf);
+      } << [&] {
+        return chan(rank - 1)->Block();
+      };
+      if (!rc.OK()) {
+        return Fail("Recursive doubling allreduce failed to fold.", std::move(rc));
+      }
+      combine(false);
+      vrank = rank / 2;
+    }
+  } else {
+    vrank = rank - n_extra;
+  }
+
+  auto to_rank = [&](std::int32_t v) { return v < n_extra ? v * 2 + 1 : v + n_extra; };
+  if (vrank != -1) {
+    for (std::int32_t mask = 1; mask < pof2; mask <<= 1) {
+      auto peer = to_rank(vrank ^ mask);
+      auto peer_ch = chan(peer);
+      auto rc = Success() << [&] {
+        return peer_ch->SendAll(data);
+      } << [&] {
+        return peer_ch->RecvAll(s_buf);
+      } << [&] {
+        return comm.Block();
+      };
+      if (!rc.OK()) {
+        return Fail("Recursive doubling allreduce failed, mask:" + std::to_string(mask),
+                    std::move(rc));
+      }
+      combine(rank < peer);
+    }
+  }
+
+  // Unfold, send the result back to the extra workers.
+  if (rank < 2 * n_extra) {
+    auto rc = Success() << [&] {
+      if (rank % 2 == 0) {
+        return chan(rank + 1)->RecvAll(data);
+      }
+      return chan(rank - 1)->SendAll(data);
+    } << [&] {
+      return comm.Block();
+    };
+    if (!rc.OK()) {
+      return Fail("Recursive doubling allreduce failed to unfold.", std::move(rc));
+    }
+  }
+  return Success();
+}
+
+}  // namespace
+
+Result RecursiveDoublingAllreduce(Comm const& comm, common::Span<std::int8_t> data,
+                                  Func const& op) {
+  std::vector<std::int32_t> ranks(comm.World());
+  std::iota(ranks.begin(), ranks.end(), 0);
+  return RecursiveDoublingImpl(comm, common::Span{ranks.data(), ranks.size()}, data, op);
+}
+
+Result HierarchicalAllreduce(Comm const& comm, common::Span<std::int8_t> data, Func const& op,
+                             HostTopology const& topo) {
+  CHECK(!topo.Empty());
+  auto rank = comm.Rank();
+  auto leader = topo.Leader();
+  auto const& local = topo.local;
+  if (comm.World() == 1 || data.empty()) {
+    return Success();
+  }
+
+  // Reduce to the leader of the host. The leader receives one worker at a time to avoid
+  // allocating a buffer for each local worker.
+  if (rank != leader) {
+    auto rc = Success() << [&] {
+      return comm.Chan(leader)->SendAll(data);
+    } << [&] {
+      return comm.Block();
+    };
+    if (!rc.OK()) {
+      return Fail("Hierarchical allreduce failed to reduce on the host.", std::move(rc));
+    }
+  } else if (local.size() > 1) {
+    std::vector<std::int8_t> buffer(data.size_bytes());
+    auto s_buf = common::Span{buffer.data(), buffer.size()};
+    for (std::size_t i = 1; i < local.size(); ++i) {
+      auto rc = Success() << [&] {
+        return comm.Chan(local[i])->RecvAll(s_buf);
+      } << [&] {
+        return comm.Block();
+      };
+      if (!rc.OK()) {
+        return Fail("Hierarchical allreduce failed to reduce on the host.", std::move(rc));
+      }
+      op(s_buf, data);
+    }
+  }
+
+  // Allreduce between hosts.
+  if (rank == leader && topo.leaders.size() > 1) {
+    auto rc = RecursiveDoublingImpl(
+        comm, common::Span{topo.leaders.data(), topo.leaders.size()}, data, op);
+    if (!rc.OK()) {
+      return Fail("Hierarchical allreduce failed between hosts.", std::move(rc));
+    }
+  }
+
+  // Broadcast on the host.
+  auto rc = Success() << [&] {
+    if (rank != leader) {
+      return comm.Chan(leader)->RecvAll(data);
+    }
+    for (std::size_t i = 1; i < local.size(); ++i) {
+      auto rc = comm.Chan(local[i])->SendAll(data);
+      if (!rc.OK()) {
+        return rc;
+      }
+    }
+    return Success();
+  } << [&] {
+    return comm.Block();
+  };
+  if (!rc.OK()) {
+    return Fail("Hierarchical allreduce failed to broadcast on the host.", std::move(rc));
+  }
+  return Success();
+}
+
+Result Allreduce(Comm const& comm, common::Span<std::int8_t> data, Func const& op,
+                 ArrayInterfaceHandler::Type type, AllreduceAlgo algo) {
+  if (comm.World() == 1 || data.empty()) {
+    return Success();
+  }
+  auto const& topo = comm.Topology();
+  if (algo == AllreduceAlgo::kAuto) {
+    algo = SelectAllreduceAlgo(data.size_bytes(), comm.World(), topo);
+  }
+  if (algo == AllreduceAlgo::kHierarchical && topo.Empty()) {
+    // The topology is not available, for instance, with the federated communicator.
+    algo = SelectAllreduceAlgo(data.size_bytes(), comm.World());
+  }
+  switch (algo) {
+    case AllreduceAlgo::kHierarchical:
+      RecordAlgo("hierarchical");
+      return HierarchicalAllreduce(comm, data, op, topo);
+    case AllreduceAlgo::kRecursiveDoubling:
+      RecordAlgo("recursive_doubling");
+      return RecursiveDoublingAllreduce(comm, data, op);
+    case AllreduceAlgo::kRing:
+      RecordAlgo("ring");
+      return RingAllreduce(comm, data, op, type);
+    default:
+      return Fail("Invalid allreduce algorithm.");
+  }
+}
 }  // namespace xgboost::collective::cpu_impl
@@ -2,26 +2,78 @@
  * Copyright 2023-2024, XGBoost Contributors
  */
 #pragma once
-#include <cstdint>      // for int8_t
+#include <algorithm>    // for count_if, fill
+#include <cstddef>      // for size_t
+#include <cstdint>      // for int8_t, int32_t, uint32_t
+#include <cstring>      // for memcpy
 #include <functional>   // for function
+#include <limits>       // for numeric_limits
 #include <type_traits>  // for is_invocable_v, enable_if_t
 #include <vector>       // for vector
 
-#include "../common/type.h"             // for EraseType, RestoreType
-#include "../data/array_interface.h"    // for ToDType, ArrayInterfaceHandler
-#include "comm.h"                       // for Comm, RestoreType
-#include "comm_group.h"                 // for GlobalCommGroup
-#include "xgboost/collective/result.h"  // for Result
-#include "xgboost/context.h"            // for Context
-#include "xgboost/span.h"               // for Span
+#include "../common/trace.h"             // for TraceScope
+#include "../common/type.h"              // for EraseType, RestoreType
+#include "../data/array_interface.h"     // for ToDType, ArrayInterfaceHandler
+#include "allgather.h"                   // for AllgatherV
+#include "comm.h"                        // for Comm, RestoreType
+#include "comm_group.h"                  // for GlobalCommGroup
+#include "stats.h"                       // for CallSite, ScopedCall
+#include "xgboost/collective/result.h"   // for Result
+#include "xgboost/context.h"             // for Context
+#include "xgboost/host_device_vector.h"  // for HostDeviceVector
+#include "xgboost/span.h"                // for Span
 
 namespace xgboost::collective {
 namespace cpu_impl {
 using Func =
     std::function<void(common::Span<std::int8_t const> lhs, common::Span<std::int8_t> out)>;
 
+enum class AllreduceAlgo : std::int8_t {
+  kAuto = 0,               // choose from the message size and the world size
+  kRing = 1,               // ring scatter-reduce followed by ring allgather
+  kRecursiveDoubling = 2,  // pairwise exchange in log2(world) steps
+  kHierarchical = 3,       // reduce on each host, allreduce between hosts, then broadcast
+};
+
+/**
+ * @brief Choose the allreduce algorithm. Small messages are latency-bound and use
+ *        recursive doubling, which takes log2(world) steps instead of 2 * (world - 1) for
+ *        the ring.
+ */
+[[nodiscard]] AllreduceAlgo SelectAllreduceAlgo(std::size_t n_bytes, std::int32_t world);
+/**
+ * @brief Same as above, but prefers the hierarchical allreduce when there are multiple
+ *        hosts with multiple workers on at least one of them.
+ */
+[[nodiscard]] AllreduceAlgo SelectAllreduceAlgo(std::size_t n_bytes, std::int32_t world,
+                                                HostTopology const& topo);
+
 Result RingAllreduce(Comm const& comm, common::Span<std::int8_t> data, Func const& op,
                      ArrayInterfaceHandler::Type type);
+
+/**
+ * @brief Recursive doubling allreduce. For non-power-of-2 world sizes, the extra workers
+ *        are folded into their neighbours before the exchange.
+ *
+ *   All workers obtain bitwise identical results.
+ */
+Result RecursiveDoublingAllreduce(Comm const& comm, common::Span<std::int8_t> data,
+                                  Func const& op);
+
+/**
+ * @brief Allreduce that only sends one copy of the data across each host boundary.
+ *
+ *   The workers on a host reduce to the lowest rank of the host (the leader) through the
+ *   loopback, the leaders run the recursive doubling among themselves, then each leader
+ *   sends the result back to the workers on its host.
+ *
+ * @param topo The topology of the workers, @ref Comm::Topology unless it's for testing.
+ */
+Result HierarchicalAllreduce(Comm const& comm, common::Span<std::int8_t> data, Func const& op,
+                             HostTopology const& topo);
+
+Result Allreduce(Comm const& comm, common::Span<std::int8_t> data, Func const& op,
+                 ArrayInterfaceHandler::Type type, AllreduceAlgo algo = AllreduceAlgo::kAuto);
 }  // namespace cpu_impl
 
 template <typename T, typename Fn>
@@ -37,34 +89,40 @@ std::enable_if_t<std::is_invocable_v<Fn, common::Span<T const>, common::Span<T>>
     redop(lhs_t, rhs_t);
   };
 
-  return cpu_impl::RingAllreduce(comm, erased, erased_fn, type);
+  return cpu_impl::Allreduce(comm, erased, erased_fn, type);
 }
 
 template <typename T, std::int32_t kDim>
 [[nodiscard]] Result Allreduce(Context const* ctx, CommGroup const& comm,
-                               linalg::TensorView<T, kDim> data, Op op) {
+                               linalg::TensorView<T, kDim> data, Op op,
+                               CallSite site = CallSite::Current()) {
   if (!comm.IsDistributed()) {
     return Success();
   }
   CHECK(data.Contiguous());
   auto erased = common::EraseType(data.Values());
   auto type = ToDType<T>::kType;
+  ScopedCall scope{comm.Stats(), "Allreduce", site, erased.size_bytes()};
+  common::TraceScope trace{common::TraceEvent::kAllreduce,
+                           static_cast<std::int64_t>(erased.size_bytes())};
 
   auto backend = comm.Backend(data.Device());
   return backend->Allreduce(comm.Ctx(ctx, data.Device()), erased, type, op);
 }
 
 template <typename T, std::int32_t kDim>
-[[nodiscard]] Result Allreduce(Context const* ctx, linalg::TensorView<T, kDim> data, Op op) {
-  return Allreduce(ctx, *GlobalCommGroup(), data, op);
+[[nodiscard]] Result Allreduce(Context const* ctx, linalg::TensorView<T, kDim> data, Op op,
+                               CallSite site = CallSite::Current()) {
+  return Allreduce(ctx, *GlobalCommGroup(), data, op, site);
 }
 
 /**
  * @brief Specialization for std::vector.
  */
 template <typename T, typename Alloc>
-[[nodiscard]] Result Allreduce(Context const* ctx, std::vector<T, Alloc>* data, Op op) {
-  return Allreduce(ctx, linalg::MakeVec(data->data(), data->size()), op);
+[[nodiscard]] Result Allreduce(Context const* ctx, std::vector<T, Alloc>* data, Op op,
+                               CallSite site = CallSite::Current()) {
+  return Allreduce(ctx, linalg::MakeVec(data->data(), data->size()), op, site);
 }
 
 /**
@@ -72,7 +130,102 @@ template <typename T, typename Alloc>
  */
 template <typename T>
 [[nodiscard]] std::enable_if_t<std::is_standard_layout_v<T> && std::is_trivial_v<T>, Result>
-Allreduce(Context const* ctx, T* data, Op op) {
-  return Allreduce(ctx, linalg::MakeVec(data, 1), op);
+Allreduce(Context const* ctx, T* data, Op op, CallSite site = CallSite::Current()) {
+  return Allreduce(ctx, linalg::MakeVec(data, 1), op, site);
+}
+
+namespace detail {
+/**
+ * @brief Pack the non-zero elements of `data` as indices followed by values.
+ */
+template <typename T>
+[[nodiscard]] std::vector<std::int8_t> PackNonZeros(common::Span<T const> data, std::size_t nnz) {
+  std::vector<std::int8_t> packed(nnz * (sizeof(std::uint32_t) + sizeof(T)));
+  auto* p_idx = packed.data();
+  auto* p_val = packed.data() + nnz * sizeof(std::uint32_t);
+  for (std::size_t i = 0, k = 0; i < data.size(); ++i) {
+    if (data[i] == T{0}) {
+      continue;
+    }
+    auto idx = static_cast<std::uint32_t>(i);
+    std::memcpy(p_idx + k * sizeof(idx), &idx, sizeof(idx));
+    std::memcpy(p_val + k * sizeof(T), &data[i], sizeof(T));
+    ++k;
+  }
+  return packed;
+}
+
+/**
+ * @brief Add the elements packed by @ref PackNonZeros to `out`.
+ */
+template <typename T>
+void AddPacked(common::Span<std::int8_t const> packed, common::Span<T> out) {
+  auto nnz = packed.size() / (sizeof(std::uint32_t) + sizeof(T));
+  auto const* p_idx = packed.data();
+  auto const* p_val = packed.data() + nnz * sizeof(std::uint32_t);
+  for (std::size_t k = 0; k < nnz; ++k) {
+    std::uint32_t idx;
+    T v;
+    std::memcpy(&idx, p_idx + k * sizeof(idx), sizeof(idx));
+    std::memcpy(&v, p_val + k * sizeof(T), sizeof(T));
+    out[idx] += v;
+  }
+}
+}  // namespace detail
+
+/**
+ * @brief Sum-allreduce that only exchanges the non-zero elements when the data is sparse.
+ *
+ *   The workers first agree on the total number of non-zero elements. If the (index,
+ *   value) pairs from all workers take less space than the data itself, the pairs are
+ *   gathered and every worker sums them in rank order. Otherwise, this is the same as the
+ *   dense sum @ref Allreduce. Only host data is packed.
+ */
+template <typename T>
+[[nodiscard]] Result SparseAllreduce(Context const* ctx, CommGroup const& comm,
+                                     linalg::VectorView<T> data,
+                                     CallSite site = CallSite::Current()) {
+  if (!comm.IsDistributed()) {
+    return Success();
+  }
+  if (!data.Device().IsCPU() || !data.Contiguous() ||
+      data.Size() > std::numeric_limits<std::uint32_t>::max()) {
+    return Allreduce(ctx, comm, data, Op::kSum, site);
+  }
+  ScopedCall scope{comm.Stats(), "SparseAllreduce", site, data.Values().size_bytes()};
+  common::TraceScope trace{common::TraceEvent::kAllreduce,
+                           static_cast<std::int64_t>(data.Values().size_bytes())};
+  auto h_data = data.Values();
+  auto n_local = static_cast<std::int64_t>(
+      std::count_if(h_data.cbegin(), h_data.cend(), [](T const& v) { return v != T{0}; }));
+  auto n_total = n_local;
+  auto rc = Allreduce(ctx, comm, linalg::MakeVec(&n_total, 1), Op::kSum);
+  if (!rc.OK()) {
+    return rc;
+  }
+  auto n_packed_bytes = static_cast<std::size_t>(n_total) * (sizeof(std::uint32_t) + sizeof(T));
+  if (n_packed_bytes >= h_data.size_bytes()) {
+    return Allreduce(ctx, comm, data, Op::kSum);
+  }
+
+  auto packed = detail::PackNonZeros(common::Span<T const>{h_data}, n_local);
+  std::vector<std::int64_t> segments;
+  HostDeviceVector<std::int8_t> recv;
+  rc = AllgatherV(ctx, comm, linalg::MakeVec(packed.data(), packed.size()), &segments, &recv);
+  if (!rc.OK()) {
+    return rc;
+  }
+  std::fill(h_data.begin(), h_data.end(), T{0});
+  auto h_recv = recv.ConstHostSpan();
+  for (std::size_t r = 0; r + 1 < segments.size(); ++r) {
+    detail::AddPacked(h_recv.subspan(segments[r], segments[r + 1] - segments[r]), h_data);
+  }
+  return Success();
+}
+
+template <typename T>
+[[nodiscard]] Result SparseAllreduce(Context const* ctx, linalg::VectorView<T> data,
+                                     CallSite site = CallSite::Current()) {
+  return SparseAllreduce(ctx, *GlobalCommGroup(), data, site);
 }
 }  // namespace xgboost::collective
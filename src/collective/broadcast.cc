@@ -1,13 +1,17 @@
 /**
- * Copyright 2023, XGBoost Contributors
+ * Copyright 2023-2025, XGBoost Contributors
  */
 #include "broadcast.h"
 
-#include <cmath>    // for ceil, log2
-#include <cstdint>  // for int32_t, int8_t
-#include <utility>  // for move
+#include <algorithm>  // for min
+#include <cmath>      // for ceil, log2
+#include <cstddef>    // for size_t
+#include <cstdint>    // for int32_t, int8_t
+#include <string>     // for to_string
+#include <utility>    // for move
 
 #include "../common/bitfield.h"         // for TrailingZeroBits, RBitField32
+#include "../common/common.h"           // for DivRoundUp
 #include "comm.h"                       // for Comm
 #include "xgboost/collective/result.h"  // for Result
 #include "xgboost/span.h"               // for Span
@@ -46,7 +50,7 @@ std::int32_t ShiftRight(std::int32_t rank, std::int32_t world, std::int32_t root
 }
 }  // namespace
 
-Result Broadcast(Comm const& comm, common::Span<std::int8_t> data, std::int32_t root) {
+Result BinomialBroadcast(Comm const& comm, common::Span<std::int8_t> data, std::int32_t root) {
   // Binomial tree broadcast
   // * Wiki
   // https://en.wikipedia.org/wiki/Broadcast_(parallel_pattern)#Binomial_Tree_Broadcast
@@ -84,4 +88,54 @@ Result Broadcast(Comm const& comm, common::Span<std::int8_t> data, std::int32_t
 
   return comm.Block();
 }
+
+Result ChainBroadcast(Comm const& comm, common::Span<std::int8_t> data, std::int32_t root,
+                      std::size_t segment_bytes) {
+  CHECK_GT(segment_bytes, 0);
+  auto world = comm.World();
+  auto shifted_rank = ShiftLeft(comm.Rank(), world, root);
+  if (world == 1 || data.empty()) {
+    return Success();
+  }
+  bool has_prev = shifted_rank != 0;
+  bool has_next = shifted_rank != world - 1;
+
+  auto n_segments = common::DivRoundUp(data.size_bytes(), segment_bytes);
+  auto segment = [&](std::size_t i) {
+    auto beg = i * segment_bytes;
+    return data.subspan(beg, std::min(segment_bytes, data.size_bytes() - beg));
+  };
+  // At step i, a worker receives the i^th segment from the previous worker and forwards the
+  // (i - 1)^th segment to the next one.
+  for (std::size_t i = 0; i <= n_segments; ++i) {
+    auto rc = Success() << [&] {
+      if (has_prev && i < n_segments) {
+        auto prev = ShiftRight(shifted_rank - 1, world, root);
+        return comm.Chan(prev)->RecvAll(segment(i));
+      }
+      return Success();
+    } << [&] {
+      if (has_next && i > 0) {
+        auto next = ShiftRight(shifted_rank + 1, world, root);
+        return comm.Chan(next)->SendAll(segment(i - 1));
+      }
+      return Success();
+    } << [&] {
+      return comm.Block();
+    };
+    if (!rc.OK()) {
+      return Fail("Chain broadcast failed, current iteration:" + std::to_string(i),
+                  std::move(rc));
+    }
+  }
+  return Success();
+}
+
+Result Broadcast(Comm const& comm, common::Span<std::int8_t> data, std::int32_t root) {
+  // With 2 workers, the binomial tree is a single transfer, there's nothing to pipeline.
+  if (comm.World() > 2 && data.size_bytes() > kChainBroadcastBytes) {
+    return ChainBroadcast(comm, data, root);
+  }
+  return BinomialBroadcast(comm, data, root);
+}
 }  // namespace xgboost::collective::cpu_impl
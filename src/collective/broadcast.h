@@ -1,12 +1,15 @@
 /**
- * Copyright 2023-2024, XGBoost Contributors
+ * Copyright 2023-2025, XGBoost Contributors
  */
 #pragma once
+#include <cstddef>  // for size_t
 #include <cstdint>  // for int32_t, int8_t
 
+#include "../common/trace.h"  // for TraceScope
 #include "../common/type.h"
 #include "comm.h"                       // for Comm, EraseType
 #include "comm_group.h"                 // for CommGroup
+#include "stats.h"                      // for CallSite, ScopedCall
 #include "xgboost/collective/result.h"  // for Result
 #include "xgboost/context.h"            // for Context
 #include "xgboost/linalg.h"             // for VectorView
@@ -14,11 +17,39 @@
 
 namespace xgboost::collective {
 namespace cpu_impl {
+/**
+ * @brief Messages larger than this are broadcast with the pipelined chain.
+ */
+inline constexpr std::size_t kChainBroadcastBytes = static_cast<std::size_t>(1) << 20;
+/**
+ * @brief Size of the segments in the pipelined chain broadcast.
+ */
+inline constexpr std::size_t kChainSegmentBytes = static_cast<std::size_t>(1) << 18;
+
+/**
+ * @brief Binomial tree broadcast.
+ */
+Result BinomialBroadcast(Comm const& comm, common::Span<std::int8_t> data, std::int32_t root);
+/**
+ * @brief Pipelined chain broadcast.
+ *
+ *   The workers form a chain starting from the root. The message is split into segments,
+ *   each worker forwards a segment to the next worker while receiving the following one.
+ *   The broadcast takes `(n_segments + world - 2)` steps, the completion time approaches
+ *   `bytes / bandwidth` for large messages instead of growing with `log2(world)` like the
+ *   binomial tree.
+ */
+Result ChainBroadcast(Comm const& comm, common::Span<std::int8_t> data, std::int32_t root,
+                      std::size_t segment_bytes = kChainSegmentBytes);
+/**
+ * @brief Choose between the binomial tree and the chain based on the message size.
+ */
 Result Broadcast(Comm const& comm, common::Span<std::int8_t> data, std::int32_t root);
-}
+}  // namespace cpu_impl
 
 /**
- * @brief binomial tree broadcast is used on CPU with the default implementation.
+ * @brief binomial tree broadcast is used on CPU with the default implementation, large
+ *        messages are pipelined through a chain of workers.
  */
 template <typename T>
 [[nodiscard]] Result Broadcast(Comm const& comm, common::Span<T> data, std::int32_t root) {
@@ -30,18 +61,23 @@ template <typename T>
 
 template <typename T>
 [[nodiscard]] Result Broadcast(Context const* ctx, CommGroup const& comm,
-                               linalg::VectorView<T> data, std::int32_t root) {
+                               linalg::VectorView<T> data, std::int32_t root,
+                               CallSite site = CallSite::Current()) {
   if (!comm.IsDistributed()) {
     return Success();
   }
   CHECK(data.Contiguous());
   auto erased = common::EraseType(data.Values());
+  ScopedCall scope{comm.Stats(), "Broadcast", site, erased.size_bytes()};
+  common::TraceScope trace{common::TraceEvent::kBroadcast,
+                           static_cast<std::int64_t>(erased.size_bytes())};
   auto backend = comm.Backend(data.Device());
   return backend->Broadcast(comm.Ctx(ctx, data.Device()), erased, root);
 }
 
 template <typename T>
-[[nodiscard]] Result Broadcast(Context const* ctx, linalg::VectorView<T> data, std::int32_t root) {
-  return Broadcast(ctx, *GlobalCommGroup(), data, root);
+[[nodiscard]] Result Broadcast(Context const* ctx, linalg::VectorView<T> data, std::int32_t root,
+                               CallSite site = CallSite::Current()) {
+  return Broadcast(ctx, *GlobalCommGroup(), data, root, site);
 }
 }  // namespace xgboost::collective
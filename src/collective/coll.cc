@@ -16,6 +16,7 @@
 #include "allreduce.h"                // for Allreduce
 #include "broadcast.h"                // for Broadcast
 #include "comm.h"                     // for Comm
+#include "stats.h"                    // for RecordAlgo
 
 #if defined(XGBOOST_USE_CUDA)
 #include "cuda_fp16.h"  // for __half
@@ -31,6 +32,11 @@ bool constexpr IsFloatingPointV() {
 #endif  // defined(XGBOOST_USE_CUDA)
 }
 
+[[nodiscard]] Result Coll::AllreduceFn(Comm const& comm, common::Span<std::int8_t> data,
+                                       ReduceFn const& fn, ArrayInterfaceHandler::Type type) {
+  return cpu_impl::Allreduce(comm, data, fn, type);
+}
+
 [[nodiscard]] Result Coll::Allreduce(Comm const& comm, common::Span<std::int8_t> data,
                                      ArrayInterfaceHandler::Type type, Op op) {
   namespace coll = ::xgboost::collective;
@@ -58,7 +64,7 @@ bool constexpr IsFloatingPointV() {
       redop_fn(lhs_t, rhs_t, elem_op);
     };
 
-    return cpu_impl::RingAllreduce(comm, data, erased_fn, type);
+    return this->AllreduceFn(comm, data, erased_fn, type);
   };
 
   std::string msg{"Floating point is not supported for bit wise collective operations."};
@@ -127,8 +133,10 @@ bool constexpr IsFloatingPointV() {
 
   switch (algo) {
     case AllgatherVAlgo::kRing:
+      RecordAlgo("ring");
       return detail::RingAllgatherV(comm, sizes, recv_segments, recv);
     case AllgatherVAlgo::kBcast:
+      RecordAlgo("broadcast");
       return cpu_impl::BroadcastAllgatherV(comm, sizes, recv);
     default: {
       return Fail("Unknown algorithm for allgather-v");
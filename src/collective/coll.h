@@ -2,8 +2,9 @@
  * Copyright 2023, XGBoost Contributors
  */
 #pragma once
-#include <cstdint>  // for int8_t, int64_t
-#include <memory>   // for enable_shared_from_this
+#include <cstdint>     // for int8_t, int64_t
+#include <functional>  // for function
+#include <memory>      // for enable_shared_from_this
 
 #include "../data/array_interface.h"    // for ArrayInterfaceHandler
 #include "comm.h"                       // for Comm
@@ -20,6 +21,16 @@ enum class AllgatherVAlgo {
  * @brief Interface and base implementation for collective.
  */
 class Coll : public std::enable_shared_from_this<Coll> {
+ protected:
+  using ReduceFn =
+      std::function<void(common::Span<std::int8_t const> lhs, common::Span<std::int8_t> out)>;
+  /**
+   * @brief Allreduce with a type-erased reduce function, used by the CPU implementation
+   *        of @ref Allreduce. Backends can override this to replace the transport.
+   */
+  [[nodiscard]] virtual Result AllreduceFn(Comm const& comm, common::Span<std::int8_t> data,
+                                           ReduceFn const& fn, ArrayInterfaceHandler::Type type);
+
  public:
   Coll() = default;
   virtual ~Coll() noexcept(false) {}  // NOLINT
@@ -5,12 +5,16 @@
 
 #include <algorithm>  // for copy
 #include <chrono>     // for seconds
+#include <cstddef>    // for size_t
 #include <cstdint>    // for int32_t
 #include <cstdlib>    // for exit
+#include <cstring>    // for memcpy
 #include <memory>     // for shared_ptr
+#include <set>        // for set
 #include <string>     // for string
 #include <thread>     // for thread
 #include <utility>    // for move, forward
+#include <vector>     // for vector
 #if !defined(XGBOOST_USE_NCCL)
 #include "../common/common.h"           // for AssertNCCLSupport
 #endif                                  // !defined(XGBOOST_USE_NCCL)
@@ -59,10 +63,26 @@ Result ConnectTrackerImpl(proto::PeerInfo info, std::chrono::seconds timeout, st
                             this->Rank(), this->World());
 }
 
+HostTopology MakeHostTopology(std::vector<std::string> const& hosts, std::int32_t rank) {
+  HostTopology topo;
+  CHECK_LT(static_cast<std::size_t>(rank), hosts.size());
+  std::set<std::string> seen;
+  for (std::int32_t r = 0; r < static_cast<std::int32_t>(hosts.size()); ++r) {
+    if (seen.insert(hosts[r]).second) {
+      topo.leaders.push_back(r);
+    }
+    if (hosts[r] == hosts[rank]) {
+      topo.local.push_back(r);
+    }
+  }
+  return topo;
+}
+
 [[nodiscard]] Result ConnectWorkers(Comm const& comm, TCPSocket* listener, std::int32_t lport,
                                     proto::PeerInfo ninfo, std::chrono::seconds timeout,
-                                    std::int32_t retry,
-                                    std::vector<std::shared_ptr<TCPSocket>>* out_workers) {
+                                    std::int32_t retry, std::int32_t n_streams,
+                                    std::vector<std::shared_ptr<TCPSocket>>* out_workers,
+                                    std::vector<std::string>* out_hosts) {
   auto next = std::make_shared<TCPSocket>();
   auto prev = std::make_shared<TCPSocket>();
 
@@ -84,14 +104,19 @@ Result ConnectTrackerImpl(proto::PeerInfo info, std::chrono::seconds timeout, st
     return rc;
   }
 
-  // exchange host name and port
-  std::vector<std::int8_t> buffer(HOST_NAME_MAX * comm.World(), 0);
+  // Exchange the host name, the port, and the number of streams in a single allgather.
+  // Each record has the host name followed by the port and the number of streams.
+  std::size_t constexpr kRecordBytes = HOST_NAME_MAX + sizeof(std::int32_t) * 2;
+  std::vector<std::int8_t> buffer(kRecordBytes * comm.World(), 0);
   auto s_buffer = common::Span{buffer.data(), buffer.size()};
-  auto next_host = s_buffer.subspan(HOST_NAME_MAX * comm.Rank(), HOST_NAME_MAX);
-  if (next_host.size() < ninfo.host.size()) {
+  auto record = [&](std::int32_t r) { return s_buffer.subspan(kRecordBytes * r, kRecordBytes); };
+  auto next_host = record(comm.Rank()).subspan(0, HOST_NAME_MAX);
+  if (next_host.size() <= ninfo.host.size()) {
     return Fail("Got an invalid host name.");
   }
   std::copy(ninfo.host.cbegin(), ninfo.host.cend(), next_host.begin());
+  std::int32_t local[2] = {ninfo.port, n_streams};
+  std::memcpy(record(comm.Rank()).subspan(HOST_NAME_MAX).data(), local, sizeof(local));
 
   auto prev_ch = std::make_shared<Channel>(comm, prev);
   auto next_ch = std::make_shared<Channel>(comm, next);
@@ -107,61 +132,67 @@ Result ConnectTrackerImpl(proto::PeerInfo info, std::chrono::seconds timeout, st
   };
 
   rc = std::move(rc) << [&] {
-    return cpu_impl::RingAllgather(comm, s_buffer, HOST_NAME_MAX, 0, prev_ch, next_ch);
+    return cpu_impl::RingAllgather(comm, s_buffer, kRecordBytes, 0, prev_ch, next_ch);
   } << [&] { return block(); };
   if (!rc.OK()) {
-    return Fail("Failed to get host names from peers.", std::move(rc));
+    return Fail("Failed to get the host names and the ports from peers.", std::move(rc));
   }
 
   std::vector<std::int32_t> peers_port(comm.World(), -1);
-  peers_port[comm.Rank()] = ninfo.port;
-  rc = std::move(rc) << [&] {
-    auto s_ports = common::Span{reinterpret_cast<std::int8_t*>(peers_port.data()),
-                                peers_port.size() * sizeof(ninfo.port)};
-    return cpu_impl::RingAllgather(comm, s_ports, sizeof(ninfo.port), 0, prev_ch, next_ch);
-  } << [&] { return block(); };
-  if (!rc.OK()) {
-    return Fail("Failed to get the port from peers.", std::move(rc));
+  for (std::int32_t r = 0; r < comm.World(); ++r) {
+    std::int32_t peer[2];
+    std::memcpy(peer, record(r).subspan(HOST_NAME_MAX).data(), sizeof(peer));
+    peers_port[r] = peer[0];
+    if (peer[1] != n_streams) {
+      return Fail("All workers must use the same number of TCP streams, got " +
+                  std::to_string(peer[1]) + " and " + std::to_string(n_streams) + ".");
+    }
   }
 
   std::vector<proto::PeerInfo> peers(comm.World());
   for (auto r = 0; r < comm.World(); ++r) {
-    auto nhost = s_buffer.subspan(HOST_NAME_MAX * r, HOST_NAME_MAX);
+    auto nhost = record(r).subspan(0, HOST_NAME_MAX);
     auto nport = peers_port[r];
     auto nrank = BootstrapNext(r, comm.World());
 
     peers[nrank] = {std::string{reinterpret_cast<char const*>(nhost.data())}, nport, nrank};
   }
   CHECK_EQ(peers[comm.Rank()].port, lport);
+  out_hosts->clear();
   for (auto const& p : peers) {
     CHECK_NE(p.port, -1);
+    out_hosts->push_back(p.host);
   }
 
+  // The streams for rank r are stored in [r * n_streams, (r + 1) * n_streams).
   std::vector<std::shared_ptr<TCPSocket>>& workers = *out_workers;
-  workers.resize(comm.World());
+  workers.resize(comm.World() * n_streams);
 
   for (std::int32_t r = (comm.Rank() + 1); r < comm.World(); ++r) {
     auto const& peer = peers[r];
-    auto worker = std::make_shared<TCPSocket>();
-    rc = std::move(rc)
-         << [&] { return Connect(peer.host, peer.port, retry, timeout, worker.get()); }
-         << [&] { return worker->RecvTimeout(timeout); };
-    if (!rc.OK()) {
-      return rc;
-    }
+    for (std::int32_t s = 0; s < n_streams; ++s) {
+      auto worker = std::make_shared<TCPSocket>();
+      rc = std::move(rc)
+           << [&] { return Connect(peer.host, peer.port, retry, timeout, worker.get()); }
+           << [&] { return worker->RecvTimeout(timeout); };
+      if (!rc.OK()) {
+        return rc;
+      }
 
-    auto rank = comm.Rank();
-    std::size_t n_bytes{0};
-    auto rc = worker->SendAll(&rank, sizeof(comm.Rank()), &n_bytes);
-    if (!rc.OK()) {
-      return rc;
-    } else if (n_bytes != sizeof(comm.Rank())) {
-      return Fail("Failed to send rank.", std::move(rc));
+      // Send the rank and the stream index.
+      std::int32_t info[2] = {comm.Rank(), s};
+      std::size_t n_bytes{0};
+      auto rc = worker->SendAll(info, sizeof(info), &n_bytes);
+      if (!rc.OK()) {
+        return rc;
+      } else if (n_bytes != sizeof(info)) {
+        return Fail("Failed to send rank.", std::move(rc));
+      }
+      workers[r * n_streams + s] = std::move(worker);
     }
-    workers[r] = std::move(worker);
   }
 
-  for (std::int32_t r = 0; r < comm.Rank(); ++r) {
+  for (std::int32_t i = 0; i < comm.Rank() * n_streams; ++i) {
     auto peer = std::make_shared<TCPSocket>();
     rc = std::move(rc) << [&] {
       SockAddress addr;
@@ -172,22 +203,28 @@ Result ConnectTrackerImpl(proto::PeerInfo info, std::chrono::seconds timeout, st
     if (!rc.OK()) {
       return rc;
     }
-    std::int32_t rank{-1};
+    std::int32_t info[2] = {-1, -1};
     std::size_t n_bytes{0};
-    auto rc = peer->RecvAll(&rank, sizeof(rank), &n_bytes);
+    auto rc = peer->RecvAll(info, sizeof(info), &n_bytes);
     if (!rc.OK()) {
       return rc;
-    } else if (n_bytes != sizeof(comm.Rank())) {
+    } else if (n_bytes != sizeof(info)) {
       return Fail("Failed to recv rank.");
     }
-    workers[rank] = std::move(peer);
+    auto [rank, s] = info;
+    if (rank < 0 || rank >= comm.Rank() || s < 0 || s >= n_streams) {
+      return Fail("Invalid rank or stream index from peer.");
+    }
+    workers[rank * n_streams + s] = std::move(peer);
   }
 
   for (std::int32_t r = 0; r < comm.World(); ++r) {
     if (r == comm.Rank()) {
       continue;
     }
-    CHECK(workers[r]);
+    for (std::int32_t s = 0; s < n_streams; ++s) {
+      CHECK(workers[r * n_streams + s]);
+    }
   }
 
   return Success();
@@ -204,9 +241,11 @@ std::string InitLog(std::string task_id, std::int32_t rank) {
 
 RabitComm::RabitComm(std::string const& tracker_host, std::int32_t tracker_port,
                      std::chrono::seconds timeout, std::int32_t retry, std::string task_id,
-                     StringView nccl_path)
+                     StringView nccl_path, std::int32_t n_streams)
     : HostComm{tracker_host, tracker_port, timeout, retry, std::move(task_id)},
-      nccl_path_{std::move(nccl_path)} {
+      nccl_path_{std::move(nccl_path)},
+      n_streams_{n_streams} {
+  CHECK_GE(n_streams_, 1) << "Invalid number of TCP streams.";
   if (this->TrackerInfo().host.empty()) {
     // Not in a distributed environment.
     LOG(CONSOLE) << InitLog(task_id_, rank_);
@@ -312,6 +351,13 @@ Comm* RabitComm::MakeCUDAVar(Context const*, std::shared_ptr<Coll>) const {
     return rc;
   }
   this->world_ = world;
+  // Enlarge the backlog now that the world size is known. A worker accepts the connections
+  // from the lower ranks only after connecting to the higher ranks, the pending connections
+  // are dropped by the OS if they don't fit in the backlog, and the peers have to retry.
+  rc = listener.Listen(world * n_streams_);
+  if (!rc.OK()) {
+    return rc;
+  }
 
   // get ring neighbors
   std::string snext;
@@ -327,10 +373,13 @@ Comm* RabitComm::MakeCUDAVar(Context const*, std::shared_ptr<Coll>) const {
   this->tracker_.rank = rank_;
 
   std::vector<std::shared_ptr<TCPSocket>> workers;
-  rc = ConnectWorkers(*this, &listener, lport, ninfo, timeout, retry, &workers);
+  std::vector<std::string> hosts;
+  rc = ConnectWorkers(*this, &listener, lport, ninfo, timeout, retry, n_streams_, &workers,
+                      &hosts);
   if (!rc.OK()) {
     return Fail("Failed to connect to other workers.", std::move(rc));
   }
+  this->topology_ = MakeHostTopology(hosts, rank_);
 
   CHECK(this->channels_.empty());
   for (auto& w : workers) {
@@ -346,7 +395,15 @@ Comm* RabitComm::MakeCUDAVar(Context const*, std::shared_ptr<Coll>) const {
     if (!rc.OK()) {
       return rc;
     }
-    this->channels_.emplace_back(std::make_shared<Channel>(*this, w));
+  }
+  for (std::int32_t r = 0; r < world; ++r) {
+    auto beg = workers.begin() + r * n_streams_;
+    if (n_streams_ == 1 || r == rank_) {
+      this->channels_.emplace_back(std::make_shared<Channel>(*this, *beg));
+    } else {
+      std::vector<std::shared_ptr<TCPSocket>> streams(beg, beg + n_streams_);
+      this->channels_.emplace_back(std::make_shared<MultiStreamChannel>(*this, std::move(streams)));
+    }
   }
 
   LOG(CONSOLE) << InitLog(task_id_, rank_);
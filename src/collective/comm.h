@@ -2,17 +2,19 @@
  * Copyright 2023-2024, XGBoost Contributors
  */
 #pragma once
-#include <chrono>   // for seconds
-#include <cstddef>  // for size_t
-#include <cstdint>  // for int32_t, int64_t
-#include <memory>   // for shared_ptr
-#include <string>   // for string
-#include <thread>   // for thread
-#include <utility>  // for move
-#include <vector>   // for vector
+#include <algorithm>  // for min, max
+#include <chrono>     // for seconds
+#include <cstddef>    // for size_t
+#include <cstdint>    // for int32_t, int64_t
+#include <memory>     // for shared_ptr
+#include <string>     // for string
+#include <thread>     // for thread
+#include <utility>    // for move
+#include <vector>     // for vector
 
 #include "loop.h"                       // for Loop
 #include "protocol.h"                   // for PeerInfo
+#include "stats.h"                      // for RecordSend, RecordRecv, RecordWait
 #include "xgboost/collective/result.h"  // for Result
 #include "xgboost/collective/socket.h"  // for TCPSocket, GetHostName
 #include "xgboost/context.h"            // for Context
@@ -39,6 +41,27 @@ inline StringView DefaultNcclName() { return "libnccl.so.2"; }
 class Channel;
 class Coll;
 
+/**
+ * @brief Workers grouped by the host they run on.
+ */
+struct HostTopology {
+  // Ranks on the same host as the current worker, sorted. The first one is the leader.
+  std::vector<std::int32_t> local;
+  // The leader of each host, sorted.
+  std::vector<std::int32_t> leaders;
+
+  [[nodiscard]] bool Empty() const { return local.empty(); }
+  [[nodiscard]] std::int32_t Leader() const { return local.front(); }
+};
+
+/**
+ * @brief Group the workers by the host addresses obtained during bootstrap.
+ *
+ * @param hosts The host address of each rank.
+ */
+[[nodiscard]] HostTopology MakeHostTopology(std::vector<std::string> const& hosts,
+                                            std::int32_t rank);
+
 /**
  * @brief Base communicator storing info about the tracker and other communicators.
  */
@@ -58,6 +81,8 @@ class Comm : public std::enable_shared_from_this<Comm> {
   std::string task_id_;
   std::vector<std::shared_ptr<Channel>> channels_;
   std::shared_ptr<Loop> loop_{nullptr};  // fixme: require federated comm to have a timeout
+  // Empty if the communicator doesn't know where the workers are.
+  HostTopology topology_;
 
   void ResetState() {
     this->world_ = -1;
@@ -67,6 +92,7 @@ class Comm : public std::enable_shared_from_this<Comm> {
     tracker_ = proto::PeerInfo{};
     this->task_id_.clear();
     channels_.clear();
+    topology_ = HostTopology{};
 
     loop_.reset();
   }
@@ -92,11 +118,24 @@ class Comm : public std::enable_shared_from_this<Comm> {
   [[nodiscard]] auto Rank() const noexcept { return rank_; }
   [[nodiscard]] auto World() const noexcept { return IsDistributed() ? world_ : 1; }
   [[nodiscard]] bool IsDistributed() const noexcept { return world_ != -1; }
+  [[nodiscard]] HostTopology const& Topology() const { return topology_; }
   void Submit(Loop::Op op) const {
     CHECK(loop_);
+    if (op.code == Loop::Op::kWrite) {
+      RecordSend(op.n);
+    } else if (op.code == Loop::Op::kRead) {
+      RecordRecv(op.n);
+    }
     loop_->Submit(std::move(op));
   }
-  [[nodiscard]] virtual Result Block() const { return loop_->Block(); }
+  [[nodiscard]] virtual Result Block() const {
+    common::Timer timer;
+    timer.Start();
+    auto rc = loop_->Block();
+    timer.Stop();
+    RecordWait(timer.ElapsedSeconds());
+    return rc;
+  }
 
   [[nodiscard]] virtual std::shared_ptr<Channel> Chan(std::int32_t rank) const {
     return channels_.at(rank);
@@ -127,6 +166,8 @@ class HostComm : public Comm {
 
 class RabitComm : public HostComm {
   std::string nccl_path_ = std::string{DefaultNcclName()};
+  // The number of TCP connections between each pair of workers.
+  std::int32_t n_streams_{1};
 
   [[nodiscard]] Result Bootstrap(std::chrono::seconds timeout, std::int32_t retry,
                                  std::string task_id);
@@ -136,7 +177,7 @@ class RabitComm : public HostComm {
   RabitComm() = default;
   RabitComm(std::string const& tracker_host, std::int32_t tracker_port,
             std::chrono::seconds timeout, std::int32_t retry, std::string task_id,
-            StringView nccl_path);
+            StringView nccl_path, std::int32_t n_streams = 1);
   ~RabitComm() noexcept(false) override;
 
   [[nodiscard]] bool IsFederated() const override { return false; }
@@ -152,6 +193,7 @@ class RabitComm : public HostComm {
  * @brief Communication channel between workers.
  */
 class Channel {
+ protected:
   std::shared_ptr<TCPSocket> sock_{nullptr};
   Result rc_;
   Comm const& comm_;
@@ -184,5 +226,48 @@ class Channel {
   [[nodiscard]] virtual Result Block() { return comm_.Block(); }
 };
 
+/**
+ * @brief Channel that splits large messages across multiple TCP connections to the same
+ *        peer.
+ *
+ *   A single TCP stream is often bounded by the throughput of one core on high bandwidth
+ *   links like IPoIB. Both ends must use the same number of streams, messages are split
+ *   deterministically based on their size so that the receiver can reassemble them.
+ */
+class MultiStreamChannel : public Channel {
+  // All streams including the one held by the base class.
+  std::vector<std::shared_ptr<TCPSocket>> streams_;
+
+  void SubmitStriped(Loop::Op::Code code, std::int8_t const* ptr, std::size_t n) {
+    auto n_streams = std::min(streams_.size(), std::max(n / kMinStripeBytes, std::size_t{1}));
+    auto n_per_stream = (n + n_streams - 1) / n_streams;
+    for (std::size_t i = 0; i < n_streams; ++i) {
+      auto beg = std::min(n_per_stream * i, n);
+      auto size = std::min(n_per_stream, n - beg);
+      auto const& sock = streams_[i];
+      CHECK(sock.get());
+      Loop::Op op{code, comm_.Rank(), const_cast<std::int8_t*>(ptr) + beg, size, sock.get(), 0};
+      comm_.Submit(std::move(op));
+    }
+  }
+
+ public:
+  // Messages smaller than this are not split.
+  static constexpr std::size_t kMinStripeBytes = static_cast<std::size_t>(1) << 16;
+
+  MultiStreamChannel(Comm const& comm, std::vector<std::shared_ptr<TCPSocket>> streams)
+      : Channel{comm, streams.front()}, streams_{std::move(streams)} {}
+
+  [[nodiscard]] Result SendAll(std::int8_t const* ptr, std::size_t n) override {
+    this->SubmitStriped(Loop::Op::kWrite, ptr, n);
+    return Success();
+  }
+  [[nodiscard]] Result RecvAll(std::int8_t* ptr, std::size_t n) override {
+    this->SubmitStriped(Loop::Op::kRead, ptr, n);
+    return Success();
+  }
+  [[nodiscard]] auto const& Streams() const { return streams_; }
+};
+
 enum class Op { kMax = 0, kMin = 1, kSum = 2, kBitwiseAND = 3, kBitwiseOR = 4, kBitwiseXOR = 5 };
 }  // namespace xgboost::collective
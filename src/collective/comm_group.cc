@@ -14,6 +14,7 @@
 #include "../common/json_utils.h"  // for OptionalArg
 #include "coll.h"                  // for Coll
 #include "comm.h"                  // for Comm
+#include "shm_coll.h"              // for ShmColl
 #include "xgboost/context.h"       // for DeviceOrd
 #include "xgboost/json.h"          // for Json
 
@@ -84,11 +85,16 @@ CommGroup::CommGroup()
     auto tracker_host = get_param("dmlc_tracker_uri", std::string{}, String{});
     auto tracker_port = get_param("dmlc_tracker_port", static_cast<std::int64_t>(0), Integer{});
     auto nccl = get_param("dmlc_nccl_path", std::string{DefaultNcclName()}, String{});
+    // Use shared memory when all workers are on the same host.
+    auto shm = get_param("dmlc_shared_memory", false, Boolean{});
+    auto n_streams = get_param("dmlc_tcp_streams", static_cast<Integer::Int>(1), Integer{});
     auto ptr = new CommGroup{
         std::shared_ptr<RabitComm>{new RabitComm{  // NOLINT
             tracker_host, static_cast<std::int32_t>(tracker_port), std::chrono::seconds{timeout},
-            static_cast<std::int32_t>(retry), task_id, nccl}},
-        std::shared_ptr<Coll>(new Coll{})};  // NOLINT
+            static_cast<std::int32_t>(retry), task_id, nccl,
+            static_cast<std::int32_t>(n_streams)}},
+        shm ? std::shared_ptr<Coll>(new ShmColl{})   // NOLINT
+            : std::shared_ptr<Coll>(new Coll{})};  // NOLINT
     return ptr;
   } else if (type == "federated") {
 #if defined(XGBOOST_USE_FEDERATED)
@@ -8,6 +8,7 @@
 
 #include "coll.h"                       // for Comm
 #include "comm.h"                       // for Coll
+#include "stats.h"                      // for CollStats
 #include "xgboost/collective/result.h"  // for Result
 
 namespace xgboost::collective {
@@ -22,6 +23,8 @@ class CommGroup {
   std::shared_ptr<Coll> backend_;
   mutable std::shared_ptr<Coll> gpu_coll_;  // lazy initialization
 
+  std::shared_ptr<CollStats> stats_{std::make_shared<CollStats>()};
+
   CommGroup(std::shared_ptr<Comm> comm, std::shared_ptr<Coll> coll)
       : comm_{std::dynamic_pointer_cast<HostComm>(comm)}, backend_{std::move(coll)} {
     CHECK(comm_);
@@ -35,6 +38,8 @@ class CommGroup {
   [[nodiscard]] bool IsDistributed() const noexcept { return comm_->IsDistributed(); }
 
   [[nodiscard]] Result Finalize() const {
+    // Print before the group is torn down, the monitor needs the rank.
+    stats_->Print();
     return Success() << [this] {
       if (gpu_comm_) {
         return gpu_comm_->Shutdown();
@@ -60,6 +65,10 @@ class CommGroup {
   [[nodiscard]] Result ProcessorName(std::string* out) const {
     return this->comm_->ProcessorName(out);
   }
+  /**
+   * @brief Statistics of the collective calls made through this group.
+   */
+  [[nodiscard]] CollStats* Stats() const { return stats_.get(); }
 };
 
 std::unique_ptr<collective::CommGroup>& GlobalCommGroup();
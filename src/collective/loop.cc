@@ -15,7 +15,7 @@
 #include <utility>    // for move
 
 #include "../common/threading_utils.h"      // for NameThread
-#include "xgboost/collective/poll_utils.h"  // for PollHelper
+#include "xgboost/collective/poll_utils.h"  // for PollHelper, EPollHelper
 #include "xgboost/collective/result.h"      // for Fail, Success
 #include "xgboost/collective/socket.h"      // for FailWithCode
 #include "xgboost/logging.h"                // for CHECK
@@ -37,7 +37,12 @@ Result Loop::ProcessQueue(std::queue<Op>* p_queue) const {
 
   // clear the copied queue
   while (!qcopy.empty()) {
+#if defined(__linux__)
+    auto& poll = this->poll_;
+    poll.Clear();
+#else
     rabit::utils::PollHelper poll;
+#endif  // defined(__linux__)
     std::size_t n_ops = qcopy.size();
 
     // Iterate through all the ops for poll
@@ -68,7 +73,12 @@ Result Loop::ProcessQueue(std::queue<Op>* p_queue) const {
 
     // poll, work on fds that are ready.
     timer_.Start("poll");
-    if (!poll.fds.empty()) {
+#if defined(__linux__)
+    auto has_fd = !poll.Empty();
+#else
+    auto has_fd = !poll.fds.empty();
+#endif  // defined(__linux__)
+    if (has_fd) {
       auto rc = poll.Poll(timeout_);
       if (!rc.OK()) {
         timer_.Stop(__func__);
@@ -14,9 +14,10 @@
 #include <thread>              // for thread
 #include <vector>              // for vector
 
-#include "../common/timer.h"            // for Monitor
-#include "xgboost/collective/result.h"  // for Result
-#include "xgboost/collective/socket.h"  // for TCPSocket
+#include "../common/timer.h"                // for Monitor
+#include "xgboost/collective/poll_utils.h"  // for EPollHelper
+#include "xgboost/collective/result.h"      // for Result
+#include "xgboost/collective/socket.h"      // for TCPSocket
 
 namespace xgboost::collective {
 class Loop {
@@ -63,6 +64,10 @@ class Loop {
   bool stop_{false};
   std::exception_ptr curr_exce_{nullptr};
   common::Monitor mutable timer_;
+#if defined(__linux__)
+  // Keep the sockets registered across rounds, only used by the worker thread.
+  rabit::utils::EPollHelper mutable poll_;
+#endif  // defined(__linux__)
 
   Result ProcessQueue(std::queue<Op>* p_queue) const;
   // The cunsumer function that runs inside a worker thread.
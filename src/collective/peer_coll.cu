@@ -0,0 +1,92 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <cstddef>  // for size_t
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "../common/cuda_rt_utils.h"     // for SetDevice, CurrentDevice
+#include "../common/device_helpers.cuh"  // for LaunchN, ToSpan, DefaultStream
+#include "peer_coll.cuh"
+#include "xgboost/logging.h"  // for CHECK
+
+namespace xgboost::collective {
+namespace {
+// Enable the access from the current device to the peer if it's supported.
+void EnablePeerAccess(std::int32_t device, std::int32_t peer) {
+  std::int32_t can_access = 0;
+  dh::safe_cuda(cudaDeviceCanAccessPeer(&can_access, device, peer));
+  if (!can_access) {
+    return;
+  }
+  curt::SetDevice(device);
+  auto err = cudaDeviceEnablePeerAccess(peer, 0);
+  if (err == cudaErrorPeerAccessAlreadyEnabled) {
+    // Clear the error.
+    err = cudaGetLastError();
+  }
+  dh::safe_cuda(err);
+}
+}  // anonymous namespace
+
+PeerGroup::PeerGroup(std::vector<DeviceOrd> devices) : devices_{std::move(devices)} {
+  CHECK(!devices_.empty());
+  auto current = curt::CurrentDevice();
+  for (std::size_t i = 0; i < devices_.size(); ++i) {
+    CHECK(devices_[i].IsCUDA()) << "Peer group requires CUDA devices.";
+    for (std::size_t j = 0; j < i; ++j) {
+      CHECK_NE(devices_[i].ordinal, devices_[j].ordinal) << "Duplicated device in the group.";
+    }
+  }
+  auto root = devices_.front().ordinal;
+  for (std::size_t i = 1; i < devices_.size(); ++i) {
+    EnablePeerAccess(root, devices_[i].ordinal);
+    EnablePeerAccess(devices_[i].ordinal, root);
+  }
+  curt::SetDevice(current);
+}
+
+Result PeerGroup::AllreduceSum(std::vector<common::Span<std::int64_t>> const& data) {
+  if (data.size() != devices_.size()) {
+    return Fail("Invalid number of buffers for the peer group.");
+  }
+  auto n = data.front().size();
+  auto n_bytes = data.front().size_bytes();
+  for (auto const& buf : data) {
+    if (buf.size() != n) {
+      return Fail("All buffers in the peer group must have the same size.");
+    }
+  }
+  if (devices_.size() == 1 || n == 0) {
+    return Success();
+  }
+
+  auto current = curt::CurrentDevice();
+  // Wait for the inputs.
+  for (auto device : devices_) {
+    curt::SetDevice(device.ordinal);
+    dh::DefaultStream().Sync();
+  }
+
+  auto root = devices_.front().ordinal;
+  curt::SetDevice(root);
+  auto stream = dh::DefaultStream();
+  staging_.resize(n);
+  auto d_staging = dh::ToSpan(staging_);
+  auto d_root = data.front();
+  // Reduce
+  for (std::size_t i = 1; i < devices_.size(); ++i) {
+    dh::safe_cuda(cudaMemcpyPeerAsync(d_staging.data(), root, data[i].data(),
+                                      devices_[i].ordinal, n_bytes, stream));
+    dh::LaunchN(n, stream, [=] __device__(std::size_t j) { d_root[j] += d_staging[j]; });
+  }
+  // Broadcast
+  for (std::size_t i = 1; i < devices_.size(); ++i) {
+    dh::safe_cuda(cudaMemcpyPeerAsync(data[i].data(), devices_[i].ordinal, d_root.data(), root,
+                                      n_bytes, stream));
+  }
+  stream.Sync();
+  curt::SetDevice(current);
+  return Success();
+}
+}  // namespace xgboost::collective
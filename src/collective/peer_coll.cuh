@@ -0,0 +1,46 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#pragma once
+#include <cstdint>  // for int32_t, int64_t
+#include <vector>   // for vector
+
+#include "../common/device_vector.cuh"  // for device_vector
+#include "xgboost/collective/result.h"  // for Result
+#include "xgboost/context.h"            // for DeviceOrd
+#include "xgboost/span.h"               // for Span
+
+namespace xgboost::collective {
+/**
+ * @brief Sum reduction between multiple devices driven by a single process.
+ *
+ *   The buffers are reduced into the first device of the group, then the result is copied
+ *   back to the other devices. Copies between devices use the peer-to-peer path, like
+ *   NVLink, when the peer access is supported by the devices, and are staged by the driver
+ *   otherwise. Neither the host nor NCCL is involved.
+ *
+ *   Only 64-bit integers are supported, which is the type of the quantised histogram. The
+ *   result doesn't depend on the order of the reduction.
+ */
+class PeerGroup {
+  std::vector<DeviceOrd> devices_;
+  // Buffer on the first device for receiving the data from other devices.
+  dh::device_vector<std::int64_t> staging_;
+
+ public:
+  /**
+   * @param devices Distinct CUDA devices, the first one is used for the reduction.
+   */
+  explicit PeerGroup(std::vector<DeviceOrd> devices);
+
+  [[nodiscard]] std::int32_t Size() const { return static_cast<std::int32_t>(devices_.size()); }
+  /**
+   * @brief Sum the buffers of all devices in place.
+   *
+   * @param data One buffer for each device in the same order as the devices of the group,
+   *             all buffers must have the same size. Pending work in the per-thread stream
+   *             of each device is waited for before reading the buffers.
+   */
+  [[nodiscard]] Result AllreduceSum(std::vector<common::Span<std::int64_t>> const& data);
+};
+}  // namespace xgboost::collective
@@ -104,7 +104,8 @@ struct Connect {
 };
 
 class Start {
- private:
+ public:
+  // The world size is sent during bootstrap, when the group is formed.
   [[nodiscard]] Result TrackerSend(std::int32_t world, TCPSocket* worker) const {
     Json jcmd{Object{}};
     jcmd["world_size"] = Integer{world};
@@ -115,8 +116,6 @@ class Start {
     }
     return Success();
   }
-
- public:
   [[nodiscard]] Result WorkerSend(std::int32_t lport, TCPSocket* tracker,
                                   std::int32_t eport) const {
     Json jcmd{Object{}};
@@ -145,8 +144,7 @@ class Start {
     return rc;
   }
   [[nodiscard]] Result TrackerHandle(Json jcmd, std::int32_t* recv_world, std::int32_t world,
-                                     std::int32_t* p_port, TCPSocket* p_sock,
-                                     std::int32_t* eport) const {
+                                     std::int32_t* p_port, std::int32_t* eport) const {
     *p_port = get<Integer const>(jcmd["port"]);
     if (*p_port <= 0) {
       return Fail("Invalid port.");
@@ -156,7 +154,7 @@ class Start {
     }
     *recv_world = world;
     *eport = get<Integer const>(jcmd["error_port"]);
-    return TrackerSend(world, p_sock);
+    return Success();
   }
 };
 
@@ -0,0 +1,101 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include "rebalance.h"
+
+#include <algorithm>  // for max, min, max_element
+#include <cmath>      // for llround
+#include <cstddef>    // for size_t
+#include <cstdint>    // for int32_t, int64_t
+#include <vector>     // for vector
+
+#include "allgather.h"       // for Allgather
+#include "xgboost/linalg.h"  // for MakeVec
+
+namespace xgboost::collective {
+std::vector<RowTransfer> PlanRowTransfers(common::Span<WorkerLoad const> loads,
+                                          double tolerance) {
+  std::vector<RowTransfer> out;
+  auto n_workers = loads.size();
+  if (n_workers < 2) {
+    return out;
+  }
+  std::int64_t total_rows{0};
+  double total_build{0}, total_speed{0}, max_build{0};
+  for (auto const& load : loads) {
+    if (load.n_updates == 0 || load.build <= 0) {
+      return out;
+    }
+    // Build time of an update.
+    auto build = load.build / static_cast<double>(load.n_updates);
+    total_rows += load.n_rows;
+    total_build += build;
+    total_speed += static_cast<double>(load.n_rows) / build;
+    max_build = std::max(max_build, build);
+  }
+  auto mean_build = total_build / static_cast<double>(n_workers);
+  if (total_rows == 0 || max_build <= mean_build * (1.0 + tolerance)) {
+    return out;
+  }
+
+  // Surplus of each worker, the rounding error is given to the fastest worker.
+  std::vector<std::int64_t> surplus(n_workers);
+  std::int64_t assigned{0};
+  std::size_t fastest{0};
+  double max_speed{0};
+  for (std::size_t i = 0; i < n_workers; ++i) {
+    auto speed = static_cast<double>(loads[i].n_rows) * static_cast<double>(loads[i].n_updates) /
+                 loads[i].build;
+    auto target = std::llround(static_cast<double>(total_rows) * speed / total_speed);
+    surplus[i] = loads[i].n_rows - target;
+    assigned += target;
+    if (speed > max_speed) {
+      max_speed = speed;
+      fastest = i;
+    }
+  }
+  surplus[fastest] -= total_rows - assigned;
+
+  // Match the donors with the receivers in the order of the ranks.
+  std::size_t dst{0};
+  for (std::size_t src = 0; src < n_workers; ++src) {
+    while (surplus[src] > 0) {
+      while (surplus[dst] >= 0) {
+        ++dst;
+      }
+      auto n = std::min(surplus[src], -surplus[dst]);
+      out.push_back({static_cast<std::int32_t>(src), static_cast<std::int32_t>(dst), n});
+      surplus[src] -= n;
+      surplus[dst] += n;
+    }
+  }
+  return out;
+}
+
+Result PlanRebalance(Context const* ctx, CommGroup const& comm, double tolerance,
+                     std::vector<WorkerLoad>* out_loads, std::vector<RowTransfer>* out_transfers) {
+  auto local = comm.Stats()->Load();
+  auto n_workers = static_cast<std::size_t>(comm.World());
+  std::size_t constexpr kFields = 3;
+  // The number of rows and the number of updates are exact in double.
+  std::vector<double> buffer(n_workers * kFields, 0.0);
+  auto rank = static_cast<std::size_t>(comm.Rank());
+  buffer[rank * kFields] = static_cast<double>(local.n_rows);
+  buffer[rank * kFields + 1] = local.build;
+  buffer[rank * kFields + 2] = static_cast<double>(local.n_updates);
+  auto rc = Allgather(ctx, comm, linalg::MakeVec(buffer.data(), buffer.size()));
+  if (!rc.OK()) {
+    return rc;
+  }
+
+  out_loads->resize(n_workers);
+  for (std::size_t i = 0; i < n_workers; ++i) {
+    auto& load = (*out_loads)[i];
+    load.n_rows = static_cast<std::int64_t>(buffer[i * kFields]);
+    load.build = buffer[i * kFields + 1];
+    load.n_updates = static_cast<std::int64_t>(buffer[i * kFields + 2]);
+  }
+  *out_transfers = PlanRowTransfers(common::Span{*out_loads}, tolerance);
+  return Success();
+}
+}  // namespace xgboost::collective
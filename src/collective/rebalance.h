@@ -0,0 +1,52 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ *
+ * @brief Planning the migration of training rows from the slow workers to the fast ones in
+ *        row-split training.
+ */
+#pragma once
+#include <cstdint>  // for int32_t, int64_t
+#include <vector>   // for vector
+
+#include "comm_group.h"                 // for CommGroup
+#include "stats.h"                      // for WorkerLoad
+#include "xgboost/collective/result.h"  // for Result
+#include "xgboost/context.h"            // for Context
+#include "xgboost/span.h"               // for Span
+
+namespace xgboost::collective {
+/**
+ * @brief Rows moved from a worker to another.
+ */
+struct RowTransfer {
+  std::int32_t src{0};
+  std::int32_t dst{0};
+  std::int64_t n_rows{0};
+};
+
+/**
+ * @brief Plan the row transfers that equalize the build time of the workers. The speed of
+ *        each worker is estimated by the number of rows built per second, and the rows are
+ *        assigned in proportion to the speeds.
+ *
+ * @param loads     Load of each worker, indexed by the rank.
+ * @param tolerance No transfer is planned if the slowest worker is within `1 + tolerance`
+ *                  of the mean build time.
+ *
+ * @return Transfers ordered by the source and the destination. Empty if the workers are
+ *         balanced or the loads are not yet measured.
+ */
+[[nodiscard]] std::vector<RowTransfer> PlanRowTransfers(common::Span<WorkerLoad const> loads,
+                                                        double tolerance);
+
+/**
+ * @brief Gather the loads recorded in the statistics of the communicator group and plan the
+ *        row transfers. Every worker obtains the same plan without a coordinator. This is a
+ *        collective call and should be made by all workers at an iteration boundary.
+ *
+ * @param out_loads Load of each worker.
+ */
+[[nodiscard]] Result PlanRebalance(Context const* ctx, CommGroup const& comm, double tolerance,
+                                   std::vector<WorkerLoad>* out_loads,
+                                   std::vector<RowTransfer>* out_transfers);
+}  // namespace xgboost::collective
@@ -0,0 +1,360 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include "shm_coll.h"
+
+#include <algorithm>     // for min, max, copy_n, copy
+#include <array>         // for array
+#include <atomic>        // for atomic
+#include <chrono>        // for steady_clock, duration
+#include <cstddef>       // for size_t
+#include <cstdint>       // for int8_t, int32_t, int64_t, uint32_t
+#include <new>           // for new
+#include <string>        // for string, to_string
+#include <system_error>  // for make_error_code, errc
+#include <vector>        // for vector
+
+#if defined(__linux__)
+#include <fcntl.h>        // for O_CREAT, O_EXCL, O_RDWR
+#include <limits.h>       // for INT_MAX
+#include <linux/futex.h>  // for FUTEX_WAIT, FUTEX_WAKE
+#include <sys/mman.h>     // for shm_open, shm_unlink, mmap, munmap
+#include <sys/syscall.h>  // for SYS_futex
+#include <time.h>         // for timespec
+#include <unistd.h>       // for ftruncate, close, getpid, syscall
+#endif                    // defined(__linux__)
+
+#include "../common/common.h"           // for DivRoundUp
+#include "../common/type.h"             // for EraseType
+#include "allgather.h"                  // for AllgatherVOffset, RingAllgather
+#include "broadcast.h"                  // for Broadcast
+#include "stats.h"                      // for RecordAlgo, RecordWait
+#include "xgboost/collective/socket.h"  // for FailWithCode
+#include "xgboost/logging.h"            // for CHECK
+
+namespace xgboost::collective {
+namespace {
+#if defined(__linux__)
+void FutexWait(std::atomic<std::uint32_t>* addr, std::uint32_t val) {
+  // Wake up periodically to check the timeout.
+  timespec ts{0, 100 * 1000 * 1000};
+  syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(addr), FUTEX_WAIT, val, &ts, nullptr, 0);
+}
+
+void FutexWake(std::atomic<std::uint32_t>* addr) {
+  syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(addr), FUTEX_WAKE, INT_MAX, nullptr,
+          nullptr, 0);
+}
+#endif  // defined(__linux__)
+}  // anonymous namespace
+
+ShmColl::~ShmColl() noexcept(false) {
+#if defined(__linux__)
+  if (header_) {
+    munmap(header_, n_bytes_);
+  }
+#endif  // defined(__linux__)
+}
+
+[[nodiscard]] Result ShmColl::Init(Comm const& comm) {
+#if defined(__linux__)
+  auto world = comm.World();
+  auto n_bytes = sizeof(Header) + kSlotBytes * world;
+  std::array<char, 64> name{};
+  if (comm.Rank() == 0) {
+    static std::atomic<std::uint32_t> counter{0};
+    auto str = "/xgboost-" + std::to_string(getpid()) + "-" + std::to_string(counter++);
+    CHECK_LT(str.size(), name.size());
+    std::copy(str.cbegin(), str.cend(), name.begin());
+  }
+
+  void* ptr{nullptr};
+  auto map = [&](std::int32_t fd) {
+    ptr = mmap(nullptr, n_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED) {
+      ptr = nullptr;
+      return system::FailWithCode("Failed to map the shared memory.");
+    }
+    return Success();
+  };
+
+  auto rc = Success() << [&] {
+    if (comm.Rank() != 0) {
+      return Success();
+    }
+    auto fd = shm_open(name.data(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+      return system::FailWithCode("Failed to create the shared memory.");
+    }
+    if (ftruncate(fd, n_bytes) != 0) {
+      close(fd);
+      shm_unlink(name.data());
+      return system::FailWithCode("Failed to allocate the shared memory.");
+    }
+    auto rc = map(fd);
+    if (!rc.OK()) {
+      shm_unlink(name.data());
+      return rc;
+    }
+    new (ptr) Header{};
+    return Success();
+  } << [&] {
+    // Send the name after the segment is created.
+    return cpu_impl::Broadcast(comm, common::EraseType(common::Span{name.data(), name.size()}),
+                               0);
+  } << [&] {
+    if (comm.Rank() == 0) {
+      return Success();
+    }
+    auto fd = shm_open(name.data(), O_RDWR, 0600);
+    if (fd < 0) {
+      return system::FailWithCode("Failed to open the shared memory.");
+    }
+    return map(fd);
+  } << [&] {
+    // Wait for all workers to map the segment before removing the name.
+    std::vector<std::int8_t> done(world, 1);
+    return RingAllgather(comm, common::Span{done.data(), done.size()});
+  } << [&] {
+    return comm.Block();
+  };
+  if (comm.Rank() == 0) {
+    shm_unlink(name.data());
+  }
+  if (!rc.OK()) {
+    if (ptr) {
+      munmap(ptr, n_bytes);
+    }
+    return Fail("Failed to initialize the shared memory collective.", std::move(rc));
+  }
+
+  header_ = static_cast<Header*>(ptr);
+  slots_ = static_cast<std::int8_t*>(ptr) + sizeof(Header);
+  n_bytes_ = n_bytes;
+  world_ = world;
+  return Success();
+#else
+  (void)comm;
+  return Fail("Shared memory collective is only supported on Linux.");
+#endif  // defined(__linux__)
+}
+
+[[nodiscard]] Result ShmColl::Prepare(Comm const& comm, bool* enabled) {
+  *enabled = false;
+  if (fallback_ || !comm.IsDistributed() || comm.World() == 1) {
+    return Success();
+  }
+  if (header_) {
+    CHECK_EQ(world_, comm.World());
+    *enabled = true;
+    RecordAlgo("shm");
+    return Success();
+  }
+#if defined(__linux__)
+  // All workers have the same topology, they reach the same decision.
+  auto const& topo = comm.Topology();
+  if (topo.Empty() || topo.leaders.size() != 1) {
+    LOG(INFO) << "Workers are not on the same host, using sockets for collective.";
+    fallback_ = true;
+    return Success();
+  }
+  auto rc = this->Init(comm);
+  if (!rc.OK()) {
+    return rc;
+  }
+  *enabled = true;
+  RecordAlgo("shm");
+#else
+  fallback_ = true;
+#endif  // defined(__linux__)
+  return Success();
+}
+
+[[nodiscard]] Result ShmColl::Barrier(Comm const& comm) const {
+#if defined(__linux__)
+  auto gen = header_->generation.load(std::memory_order_acquire);
+  if (header_->count.fetch_add(1, std::memory_order_acq_rel) + 1 ==
+      static_cast<std::uint32_t>(world_)) {
+    // The last one to arrive resets the counter and releases others.
+    header_->count.store(0, std::memory_order_relaxed);
+    header_->generation.fetch_add(1, std::memory_order_release);
+    FutexWake(&header_->generation);
+    return Success();
+  }
+
+  std::int32_t constexpr kSpins = 1024;
+  auto start = std::chrono::steady_clock::now();
+  for (std::int32_t i = 0; header_->generation.load(std::memory_order_acquire) == gen; ++i) {
+    if (i < kSpins) {
+      continue;
+    }
+    FutexWait(&header_->generation, gen);
+    auto timeout = comm.Timeout();
+    if (timeout.count() > 0 && std::chrono::steady_clock::now() - start > timeout) {
+      return Fail("Timeout waiting for other workers in the shared memory barrier.",
+                  std::make_error_code(std::errc::timed_out));
+    }
+  }
+  RecordWait(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+  return Success();
+#else
+  (void)comm;
+  return Fail("Shared memory collective is only supported on Linux.");
+#endif  // defined(__linux__)
+}
+
+[[nodiscard]] Result ShmColl::AllreduceFn(Comm const& comm, common::Span<std::int8_t> data,
+                                          ReduceFn const& fn, ArrayInterfaceHandler::Type type) {
+  bool enabled{false};
+  auto rc = this->Prepare(comm, &enabled);
+  if (!rc.OK()) {
+    return rc;
+  }
+  if (!enabled) {
+    return Coll::AllreduceFn(comm, data, fn, type);
+  }
+
+  return DispatchDType(type, [&](auto t) {
+    using T = decltype(t);
+    auto rank = comm.Rank();
+    std::size_t constexpr kChunk = kSlotBytes / sizeof(T);
+    CHECK_EQ(data.size_bytes() % sizeof(T), 0);
+    auto n = data.size_bytes() / sizeof(T);
+    for (std::size_t beg = 0; beg < n; beg += kChunk) {
+      auto n_elems = std::min(kChunk, n - beg);
+      auto chunk = data.subspan(beg * sizeof(T), n_elems * sizeof(T));
+      std::copy_n(chunk.data(), chunk.size(), this->Slot(rank).data());
+      auto rc = this->Barrier(comm);
+      if (!rc.OK()) {
+        return rc;
+      }
+      // Each worker reduces a part of the chunk in rank order, the result is written into
+      // the slot of the first worker.
+      auto n_per_worker = common::DivRoundUp(n_elems, static_cast<std::size_t>(world_));
+      auto part_beg = std::min(n_elems, n_per_worker * rank);
+      auto part_end = std::min(n_elems, part_beg + n_per_worker);
+      if (part_end > part_beg) {
+        auto off = part_beg * sizeof(T);
+        auto size = (part_end - part_beg) * sizeof(T);
+        auto out = this->Slot(0).subspan(off, size);
+        for (std::int32_t r = 1; r < world_; ++r) {
+          fn(this->Slot(r).subspan(off, size), out);
+        }
+      }
+      rc = this->Barrier(comm);
+      if (!rc.OK()) {
+        return rc;
+      }
+      std::copy_n(this->Slot(0).data(), chunk.size(), chunk.data());
+      // Don't overwrite the result before everyone has copied it.
+      rc = this->Barrier(comm);
+      if (!rc.OK()) {
+        return rc;
+      }
+    }
+    return Success();
+  });
+}
+
+[[nodiscard]] Result ShmColl::Broadcast(Comm const& comm, common::Span<std::int8_t> data,
+                                        std::int32_t root) {
+  bool enabled{false};
+  auto rc = this->Prepare(comm, &enabled);
+  if (!rc.OK()) {
+    return rc;
+  }
+  if (!enabled) {
+    return Coll::Broadcast(comm, data, root);
+  }
+
+  for (std::size_t beg = 0; beg < data.size(); beg += kSlotBytes) {
+    auto chunk = data.subspan(beg, std::min(kSlotBytes, data.size() - beg));
+    if (comm.Rank() == root) {
+      std::copy_n(chunk.data(), chunk.size(), this->Slot(root).data());
+    }
+    rc = std::move(rc) << [&] {
+      return this->Barrier(comm);
+    } << [&] {
+      if (comm.Rank() != root) {
+        std::copy_n(this->Slot(root).data(), chunk.size(), chunk.data());
+      }
+      return this->Barrier(comm);
+    };
+    if (!rc.OK()) {
+      return rc;
+    }
+  }
+  return rc;
+}
+
+[[nodiscard]] Result ShmColl::Allgather(Comm const& comm, common::Span<std::int8_t> data) {
+  bool enabled{false};
+  auto rc = this->Prepare(comm, &enabled);
+  if (!rc.OK()) {
+    return rc;
+  }
+  if (!enabled) {
+    return Coll::Allgather(comm, data);
+  }
+
+  CHECK_EQ(data.size() % world_, 0);
+  auto n_bytes_in_seg = data.size() / world_;
+  auto self = data.subspan(n_bytes_in_seg * comm.Rank(), n_bytes_in_seg);
+  for (std::size_t beg = 0; beg < n_bytes_in_seg; beg += kSlotBytes) {
+    auto n = std::min(kSlotBytes, n_bytes_in_seg - beg);
+    std::copy_n(self.data() + beg, n, this->Slot(comm.Rank()).data());
+    rc = std::move(rc) << [&] {
+      return this->Barrier(comm);
+    } << [&] {
+      for (std::int32_t r = 0; r < world_; ++r) {
+        if (r != comm.Rank()) {
+          std::copy_n(this->Slot(r).data(), n, data.data() + n_bytes_in_seg * r + beg);
+        }
+      }
+      return this->Barrier(comm);
+    };
+    if (!rc.OK()) {
+      return rc;
+    }
+  }
+  return rc;
+}
+
+[[nodiscard]] Result ShmColl::AllgatherV(Comm const& comm, common::Span<std::int8_t const> data,
+                                         common::Span<std::int64_t const> sizes,
+                                         common::Span<std::int64_t> recv_segments,
+                                         common::Span<std::int8_t> recv, AllgatherVAlgo algo) {
+  bool enabled{false};
+  auto rc = this->Prepare(comm, &enabled);
+  if (!rc.OK()) {
+    return rc;
+  }
+  if (!enabled) {
+    return Coll::AllgatherV(comm, data, sizes, recv_segments, recv, algo);
+  }
+
+  detail::AllgatherVOffset(sizes, recv_segments);
+  auto max_size = static_cast<std::size_t>(*std::max_element(sizes.cbegin(), sizes.cend()));
+  for (std::size_t beg = 0; beg < max_size; beg += kSlotBytes) {
+    auto piece = [&](std::int32_t r) {
+      auto size = static_cast<std::size_t>(sizes[r]);
+      return beg < size ? std::min(kSlotBytes, size - beg) : 0;
+    };
+    std::copy_n(data.data() + std::min(beg, data.size()), piece(comm.Rank()),
+                this->Slot(comm.Rank()).data());
+    rc = std::move(rc) << [&] {
+      return this->Barrier(comm);
+    } << [&] {
+      for (std::int32_t r = 0; r < world_; ++r) {
+        std::copy_n(this->Slot(r).data(), piece(r), recv.data() + recv_segments[r] + beg);
+      }
+      return this->Barrier(comm);
+    };
+    if (!rc.OK()) {
+      return rc;
+    }
+  }
+  return rc;
+}
+}  // namespace xgboost::collective
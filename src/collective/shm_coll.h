@@ -0,0 +1,73 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#pragma once
+#include <atomic>   // for atomic
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int8_t, int32_t, int64_t, uint32_t
+
+#include "../data/array_interface.h"    // for ArrayInterfaceHandler
+#include "coll.h"                       // for Coll, AllgatherVAlgo
+#include "comm.h"                       // for Comm
+#include "xgboost/collective/result.h"  // for Result
+#include "xgboost/span.h"               // for Span
+
+namespace xgboost::collective {
+/**
+ * @brief Collective backend for multiple processes on a single host, using a POSIX
+ *        shared memory segment instead of the loopback sockets.
+ *
+ *   The communicator is still used for bootstrapping. The segment is created on the first
+ *   collective call, its name is sent to other workers by rank 0 and it's unlinked once
+ *   all workers have mapped it, so that nothing is left behind if a worker is killed.
+ *   Each worker owns a slot in the segment, the data is copied into the slots in chunks
+ *   and the workers are synchronised with a barrier backed by futex.
+ *
+ *   Falls back to the socket-based implementation when the workers are spread across
+ *   multiple hosts or on platforms other than Linux.
+ */
+class ShmColl : public Coll {
+ public:
+  // The size of the slot for each worker.
+  static constexpr std::size_t kSlotBytes = static_cast<std::size_t>(1) << 20;
+
+ private:
+  struct Header {
+    alignas(64) std::atomic<std::uint32_t> count;
+    alignas(64) std::atomic<std::uint32_t> generation;
+  };
+
+  Header* header_{nullptr};
+  std::int8_t* slots_{nullptr};
+  std::size_t n_bytes_{0};
+  std::int32_t world_{0};
+  // Set if the shared memory is not available for the current group of workers.
+  bool fallback_{false};
+
+  [[nodiscard]] Result Init(Comm const& comm);
+  // Create the segment if needed, `enabled` is false if the shared memory can't be used.
+  [[nodiscard]] Result Prepare(Comm const& comm, bool* enabled);
+  [[nodiscard]] Result Barrier(Comm const& comm) const;
+  [[nodiscard]] common::Span<std::int8_t> Slot(std::int32_t r) const {
+    return {slots_ + kSlotBytes * r, kSlotBytes};
+  }
+
+ protected:
+  [[nodiscard]] Result AllreduceFn(Comm const& comm, common::Span<std::int8_t> data,
+                                   ReduceFn const& fn, ArrayInterfaceHandler::Type type) override;
+
+ public:
+  ShmColl() = default;
+  ShmColl(ShmColl const& that) = delete;
+  ShmColl& operator=(ShmColl const& that) = delete;
+  ~ShmColl() noexcept(false) override;
+
+  [[nodiscard]] Result Broadcast(Comm const& comm, common::Span<std::int8_t> data,
+                                 std::int32_t root) override;
+  [[nodiscard]] Result Allgather(Comm const& comm, common::Span<std::int8_t> data) override;
+  [[nodiscard]] Result AllgatherV(Comm const& comm, common::Span<std::int8_t const> data,
+                                  common::Span<std::int64_t const> sizes,
+                                  common::Span<std::int64_t> recv_segments,
+                                  common::Span<std::int8_t> recv, AllgatherVAlgo algo) override;
+};
+}  // namespace xgboost::collective
@@ -0,0 +1,148 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include "stats.h"
+
+#include <cstring>  // for strrchr
+#include <memory>   // for make_unique
+#include <mutex>    // for lock_guard
+#include <string>   // for string, to_string
+#include <utility>  // for move
+
+#include "xgboost/json.h"  // for Json, Object, Integer, Number, String
+
+namespace xgboost::collective {
+namespace {
+// Strip the directories from the file path.
+char const* BaseName(char const* path) {
+  for (auto sep : {'/', '\\'}) {
+    if (auto ptr = std::strrchr(path, sep)) {
+      path = ptr + 1;
+    }
+  }
+  return path;
+}
+}  // anonymous namespace
+
+void CollStats::Start(std::string const& key) {
+  std::lock_guard lock{mu_};
+  if (!monitor_) {
+    monitor_ = std::make_unique<common::Monitor>();
+    monitor_->Init("Collective");
+  }
+  monitor_->Start(key);
+}
+
+void CollStats::Stop(std::string const& key, CallStats const& stats) {
+  std::lock_guard lock{mu_};
+  auto& out = stats_[key];
+  out.n_calls += stats.n_calls;
+  out.n_bytes += stats.n_bytes;
+  out.n_sent += stats.n_sent;
+  out.n_recv += stats.n_recv;
+  out.elapsed += stats.elapsed;
+  out.wait += stats.wait;
+  if (!stats.algo.empty()) {
+    out.algo = stats.algo;
+  }
+  if (monitor_) {
+    monitor_->Stop(key);
+  }
+}
+
+void CollStats::RecordLoad(std::int64_t n_rows, double build) {
+  std::lock_guard lock{mu_};
+  load_.n_rows = n_rows;
+  load_.build += build;
+  load_.n_updates += 1;
+}
+
+[[nodiscard]] WorkerLoad CollStats::Load() const {
+  std::lock_guard lock{mu_};
+  return load_;
+}
+
+void CollStats::Print() {
+  std::lock_guard lock{mu_};
+  // The monitor prints during destruction.
+  monitor_.reset();
+}
+
+[[nodiscard]] Json CollStats::ToJson() const {
+  std::lock_guard lock{mu_};
+  Json out{Object{}};
+  for (auto const& [key, stats] : stats_) {
+    Json jstats{Object{}};
+    jstats["n_calls"] = Integer{stats.n_calls};
+    jstats["n_bytes"] = Integer{stats.n_bytes};
+    jstats["n_sent"] = Integer{stats.n_sent};
+    jstats["n_recv"] = Integer{stats.n_recv};
+    jstats["elapsed"] = Number{stats.elapsed};
+    jstats["wait"] = Number{stats.wait};
+    jstats["algo"] = String{stats.algo};
+    out[key] = std::move(jstats);
+  }
+  // Not a call site, the keys of the call sites always contain the `@`.
+  if (load_.n_updates != 0) {
+    Json jload{Object{}};
+    jload["n_rows"] = Integer{load_.n_rows};
+    jload["build"] = Number{load_.build};
+    jload["n_updates"] = Integer{load_.n_updates};
+    out["worker_load"] = std::move(jload);
+  }
+  return out;
+}
+
+[[nodiscard]] CallStats CollStats::Total() const {
+  std::lock_guard lock{mu_};
+  CallStats total;
+  for (auto const& kv : stats_) {
+    auto const& stats = kv.second;
+    total.n_calls += stats.n_calls;
+    total.n_bytes += stats.n_bytes;
+    total.n_sent += stats.n_sent;
+    total.n_recv += stats.n_recv;
+    total.elapsed += stats.elapsed;
+    total.wait += stats.wait;
+  }
+  return total;
+}
+
+void CollStats::Clear() {
+  std::lock_guard lock{mu_};
+  stats_.clear();
+  load_ = WorkerLoad{};
+}
+
+namespace detail {
+[[nodiscard]] CallStats*& CurrentCall() {
+  thread_local CallStats* current{nullptr};
+  return current;
+}
+}  // namespace detail
+
+ScopedCall::ScopedCall(CollStats* registry, StringView op, CallSite site, std::size_t n_bytes) {
+  auto& current = detail::CurrentCall();
+  if (current) {
+    return;
+  }
+  registry_ = registry;
+  key_ = static_cast<std::string>(op) + "@" + BaseName(site.file) + ":" +
+         std::to_string(site.line);
+  stats_.n_calls = 1;
+  stats_.n_bytes = static_cast<std::int64_t>(n_bytes);
+  current = &stats_;
+  registry_->Start(key_);
+  timer_.Start();
+}
+
+ScopedCall::~ScopedCall() {
+  if (!registry_) {
+    return;
+  }
+  timer_.Stop();
+  stats_.elapsed = timer_.ElapsedSeconds();
+  detail::CurrentCall() = nullptr;
+  registry_->Stop(key_, stats_);
+}
+}  // namespace xgboost::collective
@@ -0,0 +1,145 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#pragma once
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int32_t, int64_t
+#include <map>      // for map
+#include <memory>   // for unique_ptr
+#include <mutex>    // for mutex
+#include <string>   // for string
+
+#include "../common/timer.h"      // for Monitor, Timer
+#include "xgboost/json.h"         // for Json
+#include "xgboost/string_view.h"  // for StringView
+
+namespace xgboost::collective {
+/**
+ * @brief Source location of a collective call. Used as a default argument to obtain the
+ *        location of the caller.
+ */
+struct CallSite {
+  char const* file{""};
+  std::int32_t line{0};
+
+  [[nodiscard]] static CallSite Current(char const* file = __builtin_FILE(),
+                                        std::int32_t line = __builtin_LINE()) {
+    return {file, line};
+  }
+};
+
+/**
+ * @brief Counters for collective calls from the same call site.
+ */
+struct CallStats {
+  std::int64_t n_calls{0};
+  // Size of the user data in bytes.
+  std::int64_t n_bytes{0};
+  // Bytes sent to and received from the peers.
+  std::int64_t n_sent{0};
+  std::int64_t n_recv{0};
+  // Wall time of the calls, in seconds.
+  double elapsed{0};
+  // Time spent waiting for the peers, in seconds.
+  double wait{0};
+  // The algorithm used by the last call, empty if it's not applicable.
+  std::string algo;
+};
+
+/**
+ * @brief Local work of a worker in row-split training, used for finding the stragglers
+ *        that hold the synchronization of the histograms.
+ */
+struct WorkerLoad {
+  std::int64_t n_rows{0};
+  // Wall time of updating the trees, excluding the time waiting for the peers. In seconds.
+  double build{0};
+  std::int64_t n_updates{0};
+};
+
+/**
+ * @brief Collective statistics of a communicator group, grouped by the operation and
+ *        the call site.
+ *
+ *   The wall time is also recorded in a @ref common::Monitor, which is printed during
+ *   finalization when the verbosity is set to debug.
+ */
+class CollStats {
+  std::mutex mutable mu_;
+  std::map<std::string, CallStats> stats_;
+  WorkerLoad load_;
+  // Created on the first call. The monitor queries the rank of the global communicator
+  // when it's printed.
+  std::unique_ptr<common::Monitor> monitor_;
+
+ public:
+  void Start(std::string const& key);
+  void Stop(std::string const& key, CallStats const& stats);
+  /**
+   * @brief Record a tree update of the local worker.
+   *
+   * @param n_rows Number of local training rows.
+   * @param build  Time of the update excluding the wait time of the collective calls.
+   */
+  void RecordLoad(std::int64_t n_rows, double build);
+  [[nodiscard]] WorkerLoad Load() const;
+  // Print the monitor.
+  void Print();
+
+  [[nodiscard]] Json ToJson() const;
+  /**
+   * @brief Sum of the statistics of all call sites, the algorithm is not set.
+   */
+  [[nodiscard]] CallStats Total() const;
+  void Clear();
+};
+
+namespace detail {
+// The counters of the outermost collective call running in the current thread, null if
+// there's none.
+[[nodiscard]] CallStats*& CurrentCall();
+}  // namespace detail
+
+/**
+ * @brief Record the statistics of a collective call during the lifetime of this object.
+ *        Nested calls are accounted to the outermost one.
+ */
+class ScopedCall {
+  CollStats* registry_{nullptr};
+  std::string key_;
+  CallStats stats_;
+  common::Timer timer_;
+
+ public:
+  ScopedCall(CollStats* registry, StringView op, CallSite site, std::size_t n_bytes);
+  ~ScopedCall();
+
+  ScopedCall(ScopedCall const& that) = delete;
+  ScopedCall& operator=(ScopedCall const& that) = delete;
+};
+
+// Hooks for the communicator and the collective implementations.
+inline void RecordSend(std::size_t n_bytes) {
+  if (auto* p_stats = detail::CurrentCall()) {
+    p_stats->n_sent += static_cast<std::int64_t>(n_bytes);
+  }
+}
+
+inline void RecordRecv(std::size_t n_bytes) {
+  if (auto* p_stats = detail::CurrentCall()) {
+    p_stats->n_recv += static_cast<std::int64_t>(n_bytes);
+  }
+}
+
+inline void RecordWait(double seconds) {
+  if (auto* p_stats = detail::CurrentCall()) {
+    p_stats->wait += seconds;
+  }
+}
+
+inline void RecordAlgo(StringView name) {
+  if (auto* p_stats = detail::CurrentCall()) {
+    p_stats->algo = static_cast<std::string>(name);
+  }
+}
+}  // namespace xgboost::collective
@@ -1,5 +1,5 @@
 /**
- * Copyright 2023-2024, XGBoost Contributors
+ * Copyright 2023-2025, XGBoost Contributors
  */
 
 #if defined(__unix__) || defined(__APPLE__)
@@ -18,9 +18,11 @@
 #include <algorithm>  // for sort
 #include <chrono>     // for seconds, ms
 #include <cstdint>    // for int32_t
+#include <future>     // for future, async
 #include <memory>     // for unique_ptr
 #include <string>     // for string
-#include <utility>    // for move, forward
+#include <utility>    // for move, forward, pair
+#include <vector>     // for vector
 
 #include "../common/json_utils.h"
 #include "../common/threading_utils.h"  // for NameThread
@@ -92,7 +94,7 @@ RabitTracker::WorkerProxy::WorkerProxy(std::int32_t world, TCPSocket sock, SockA
   } << [&] {
     if (cmd_ == proto::CMD::kStart) {
       proto::Start start;
-      return start.TrackerHandle(jcmd, &world_, world, &port, &sock_, &eport_);
+      return start.TrackerHandle(jcmd, &world_, world, &port, &eport_);
     } else if (cmd_ == proto::CMD::kPrint) {
       proto::Print print;
       return print.TrackerHandle(jcmd, &msg_);
@@ -130,6 +132,38 @@ RabitTracker::RabitTracker(Json const& config) : Tracker{config} {
     return listener_.Listen(this->n_workers_);
   };
   SafeColl(rc);
+
+  min_workers_ = static_cast<std::int32_t>(
+      OptionalArg<Integer const>(config, "min_workers", static_cast<Integer::Int>(n_workers_)));
+  CHECK_GE(min_workers_, 1) << "Invalid `min_workers`.";
+  CHECK_LE(min_workers_, n_workers_) << "`min_workers` must not exceed `n_workers`.";
+  elastic_timeout_ = std::chrono::seconds{
+      OptionalArg<Integer const>(config, "elastic_timeout", static_cast<Integer::Int>(60))};
+  CHECK_GT(elastic_timeout_.count(), 0) << "Invalid `elastic_timeout`.";
+}
+
+std::vector<RabitTracker::WorkerProxy> RabitTracker::Handshake(
+    std::vector<std::pair<TCPSocket, SockAddress>> accepted) const {
+  std::vector<WorkerProxy> workers;
+  if (accepted.size() == 1) {
+    auto& [sock, addr] = accepted.front();
+    workers.emplace_back(n_workers_, std::move(sock), std::move(addr));
+    return workers;
+  }
+
+  std::vector<std::future<WorkerProxy>> futures;
+  for (auto& [sock, addr] : accepted) {
+    futures.emplace_back(std::async(std::launch::async, [world = n_workers_, sock = std::move(sock),
+                                                         addr = std::move(addr),
+                                                         init = InitNewThread{}]() mutable {
+      init();
+      return WorkerProxy{world, std::move(sock), std::move(addr)};
+    }));
+  }
+  for (auto& fut : futures) {
+    workers.emplace_back(fut.get());
+  }
+  return workers;
 }
 
 Result RabitTracker::Bootstrap(std::vector<WorkerProxy>* p_workers) {
@@ -137,18 +171,26 @@ Result RabitTracker::Bootstrap(std::vector<WorkerProxy>* p_workers) {
 
   std::sort(workers.begin(), workers.end(), WorkerCmp{this->sortby_});
 
+  // The group can be smaller than `n_workers_` after an elastic restart.
+  auto world = static_cast<std::int32_t>(workers.size());
+  std::vector<Result> results(world);
   std::vector<std::thread> bootstrap_threads;
-  for (std::int32_t r = 0; r < n_workers_; ++r) {
+  for (std::int32_t r = 0; r < world; ++r) {
     auto& worker = workers[r];
-    auto next = BootstrapNext(r, n_workers_);
+    auto next = BootstrapNext(r, world);
     auto const& next_w = workers[next];
-    bootstrap_threads.emplace_back([next, &worker, &next_w, init = InitNewThread{}] {
-      init();
-      auto jnext = proto::PeerInfo{next_w.Host(), next_w.Port(), next}.ToJson();
-      std::string str;
-      Json::Dump(jnext, &str);
-      worker.Send(StringView{str});
-    });
+    bootstrap_threads.emplace_back(
+        [world, next, &worker, &next_w, p_rc = &results[r], init = InitNewThread{}] {
+          init();
+          *p_rc = worker.SendWorld(world);
+          if (!p_rc->OK()) {
+            return;
+          }
+          auto jnext = proto::PeerInfo{next_w.Host(), next_w.Port(), next}.ToJson();
+          std::string str;
+          Json::Dump(jnext, &str);
+          worker.Send(StringView{str});
+        });
     std::string name = "tkbs_t-" + std::to_string(r);
     common::NameThread(&bootstrap_threads.back(), name.c_str());
   }
@@ -156,7 +198,14 @@ Result RabitTracker::Bootstrap(std::vector<WorkerProxy>* p_workers) {
   for (auto& t : bootstrap_threads) {
     t.join();
   }
+  for (auto& rc : results) {
+    if (!rc.OK()) {
+      return Fail("Failed to bootstrap the workers.", std::move(rc));
+    }
+  }
 
+  // Workers from the previous group are no longer reachable.
+  worker_error_handles_.clear();
   for (auto const& w : workers) {
     worker_error_handles_.emplace_back(w.Host(), w.ErrorPort());
   }
@@ -166,26 +215,29 @@ Result RabitTracker::Bootstrap(std::vector<WorkerProxy>* p_workers) {
 [[nodiscard]] std::future<Result> RabitTracker::Run() {
   // a state machine to keep track of consistency.
   struct State {
-    std::int32_t const n_workers;
+    std::int32_t const max_workers;
+    // The size of the current group, can be smaller than `max_workers` after an elastic
+    // restart.
+    std::int32_t n_workers;
 
     std::int32_t n_shutdown{0};
     bool during_restart{false};
     bool running{false};
     std::vector<WorkerProxy> pending;
 
-    explicit State(std::int32_t world) : n_workers{world} {}
+    explicit State(std::int32_t world) : max_workers{world}, n_workers{world} {}
     State(State const& that) = delete;
     State& operator=(State&& that) = delete;
 
     // modifiers
     void Start(WorkerProxy&& worker) {
-      CHECK_LT(pending.size(), n_workers);
+      CHECK_LT(pending.size(), max_workers);
       CHECK_LE(n_shutdown, n_workers);
       CHECK(!running);
 
       pending.emplace_back(std::forward<WorkerProxy>(worker));
 
-      CHECK_LE(pending.size(), n_workers);
+      CHECK_LE(pending.size(), max_workers);
     }
     void Shutdown() {
       CHECK_GE(n_shutdown, 0);
@@ -197,17 +249,18 @@ Result RabitTracker::Bootstrap(std::vector<WorkerProxy>* p_workers) {
       CHECK_LE(n_shutdown, n_workers);
     }
     void Error() {
-      CHECK_LE(pending.size(), n_workers);
+      CHECK_LE(pending.size(), max_workers);
       CHECK_LE(n_shutdown, n_workers);
 
       running = false;
       during_restart = true;
     }
     void Bootstrap() {
-      CHECK_EQ(pending.size(), n_workers);
+      CHECK_LE(pending.size(), max_workers);
       CHECK_LE(n_shutdown, n_workers);
 
       running = true;
+      n_workers = static_cast<std::int32_t>(pending.size());
 
       // A reset.
       n_shutdown = 0;
@@ -217,11 +270,16 @@ Result RabitTracker::Bootstrap(std::vector<WorkerProxy>* p_workers) {
 
     // observers
     [[nodiscard]] bool Ready() const {
-      CHECK_LE(pending.size(), n_workers);
-      return static_cast<std::int32_t>(pending.size()) == n_workers;
+      CHECK_LE(pending.size(), max_workers);
+      return static_cast<std::int32_t>(pending.size()) == max_workers;
+    }
+    // Whether a smaller group can be formed after an error.
+    [[nodiscard]] bool CanShrink(std::int32_t min_workers) const {
+      return during_restart && !running &&
+             static_cast<std::int32_t>(pending.size()) >= min_workers;
     }
     [[nodiscard]] bool ShouldContinue() const {
-      CHECK_LE(pending.size(), n_workers);
+      CHECK_LE(pending.size(), max_workers);
       CHECK_LE(n_shutdown, n_workers);
       // - Without error, we should shutdown after all workers are offline.
       // - With error, all workers are offline, and we have during_restart as true.
@@ -229,7 +287,8 @@ Result RabitTracker::Bootstrap(std::vector<WorkerProxy>* p_workers) {
     }
   };
 
-  auto handle_error = [&](WorkerProxy const& worker) {
+  bool elastic = this->min_workers_ < this->n_workers_;
+  auto handle_error = [elastic, this](WorkerProxy const& worker) {
     auto msg = worker.Msg();
     auto code = worker.Code();
     LOG(WARNING) << "[tracker]: Recieved error from [" << worker.Host() << ":" << worker.Rank()
@@ -250,14 +309,17 @@ Result RabitTracker::Bootstrap(std::vector<WorkerProxy>* p_workers) {
       } << [&] {
         return proto::Error{}.SignalError(&out);
       };
-      if (!rc.OK()) {
+      if (!rc.OK() && elastic) {
+        // The worker might be the one that is lost.
+        LOG(WARNING) << "[tracker]: Failed to inform worker:" << w.first << " for error.";
+      } else if (!rc.OK()) {
         return Fail("Failed to inform worker:" + w.first + " for error.", std::move(rc));
       }
     }
     return Success();
   };
 
-  return std::async(std::launch::async, [this, handle_error, init = InitNewThread{}] {
+  return std::async(std::launch::async, [this, elastic, handle_error, init = InitNewThread{}] {
     init();
     State state{this->n_workers_};
 
@@ -275,6 +337,9 @@ Result RabitTracker::Bootstrap(std::vector<WorkerProxy>* p_workers) {
         if (state.running) {
           // Don't timeout if the communicator group is up and running.
           return poll.Poll(std::chrono::seconds{-1});
+        } else if (elastic && state.CanShrink(this->min_workers_)) {
+          // Bounded wait for the replacements.
+          return poll.Poll(this->elastic_timeout_);
         } else {
           // Have timeout for workers to bootstrap.
           return poll.Poll(timeout_);
@@ -287,66 +352,106 @@ Result RabitTracker::Bootstrap(std::vector<WorkerProxy>* p_workers) {
       return rc;
     };
 
+    // Accept a connection that is already pending, returns timeout if there's none.
+    auto accept_pending = [&](TCPSocket* sock, SockAddress* addr) {
+      rabit::utils::PollHelper poll;
+      return Success() << [&] {
+        std::lock_guard lock{listener_mu_};
+        poll.WatchRead(listener_);
+        return Success();
+      } << [&] {
+        return poll.Poll(std::chrono::seconds{0});
+      } << [&] {
+        return listener_.Accept(sock, addr);
+      };
+    };
+
     while (state.ShouldContinue()) {
       TCPSocket sock;
       SockAddress addr;
       this->ready_ = true;
       auto rc = select_accept(&sock, &addr);
+      if (!rc.OK() && rc.Code() == std::errc::timed_out && elastic &&
+          state.CanShrink(this->min_workers_)) {
+        LOG(WARNING) << "[tracker]: Forming a new group with " << state.pending.size()
+                     << " workers out of " << state.max_workers << ".";
+        rc = this->Bootstrap(&state.pending);
+        state.Bootstrap();
+        if (!rc.OK()) {
+          return this->Stop() + std::move(rc);
+        }
+        continue;
+      }
       if (!rc.OK()) {
         return Fail("Failed to accept connection.", this->Stop() + std::move(rc));
       }
 
-      auto worker = WorkerProxy{n_workers_, std::move(sock), std::move(addr)};
-      if (!worker.Status().OK()) {
-        LOG(WARNING) << "Failed to initialize worker proxy." << worker.Status().Report();
-        continue;
+      // Drain the connections that are already pending so that the handshakes with a batch
+      // of workers can run concurrently.
+      std::vector<std::pair<TCPSocket, SockAddress>> accepted;
+      accepted.emplace_back(std::move(sock), std::move(addr));
+      while (accepted.size() < kMaxAcceptBatch) {
+        TCPSocket pending_sock;
+        SockAddress pending_addr;
+        if (!accept_pending(&pending_sock, &pending_addr).OK() || pending_sock.IsClosed()) {
+          break;
+        }
+        accepted.emplace_back(std::move(pending_sock), std::move(pending_addr));
       }
-      switch (worker.Command()) {
-        case proto::CMD::kStart: {
-          if (state.running) {
-            // Something went wrong with one of the workers. It got disconnected without
-            // notice.
-            state.Error();
-            rc = handle_error(worker);
-            if (!rc.OK()) {
-              return Fail("Failed to handle abort.", this->Stop() + std::move(rc));
+      auto workers = this->Handshake(std::move(accepted));
+
+      for (auto& worker : workers) {
+        if (!worker.Status().OK()) {
+          LOG(WARNING) << "Failed to initialize worker proxy." << worker.Status().Report();
+          continue;
+        }
+        switch (worker.Command()) {
+          case proto::CMD::kStart: {
+            if (state.running) {
+              // Something went wrong with one of the workers. It got disconnected without
+              // notice.
+              state.Error();
+              rc = handle_error(worker);
+              if (!rc.OK()) {
+                return Fail("Failed to handle abort.", this->Stop() + std::move(rc));
+              }
             }
-          }
 
-          state.Start(std::move(worker));
-          if (state.Ready()) {
-            rc = this->Bootstrap(&state.pending);
-            state.Bootstrap();
+            state.Start(std::move(worker));
+            if (state.Ready()) {
+              rc = this->Bootstrap(&state.pending);
+              state.Bootstrap();
+            }
+            if (!rc.OK()) {
+              return this->Stop() + std::move(rc);
+            }
+            continue;
           }
-          if (!rc.OK()) {
-            return this->Stop() + std::move(rc);
+          case proto::CMD::kShutdown: {
+            if (state.during_restart) {
+              // The worker can still send shutdown after call to `std::exit`.
+              continue;
+            }
+            state.Shutdown();
+            continue;
           }
-          continue;
-        }
-        case proto::CMD::kShutdown: {
-          if (state.during_restart) {
-            // The worker can still send shutdown after call to `std::exit`.
+          case proto::CMD::kError: {
+            if (state.during_restart) {
+              // Ignore further errors.
+              continue;
+            }
+            state.Error();
+            rc = handle_error(worker);
             continue;
           }
-          state.Shutdown();
-          continue;
-        }
-        case proto::CMD::kError: {
-          if (state.during_restart) {
-            // Ignore further errors.
+          case proto::CMD::kPrint: {
+            LOG(CONSOLE) << worker.Msg();
             continue;
           }
-          state.Error();
-          rc = handle_error(worker);
-          continue;
-        }
-        case proto::CMD::kPrint: {
-          LOG(CONSOLE) << worker.Msg();
-          continue;
-        }
-        case proto::CMD::kInvalid:
-        default: {
-          return Fail("Invalid command received.", this->Stop());
+          case proto::CMD::kInvalid:
+          default: {
+            return Fail("Invalid command received.", this->Stop());
+          }
         }
       }
     }
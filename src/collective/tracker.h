@@ -3,6 +3,7 @@
  */
 #pragma once
 #include <chrono>   // for seconds
+#include <cstddef>  // for size_t
 #include <cstdint>  // for int32_t
 #include <future>   // for future
 #include <string>   // for string
@@ -35,6 +36,12 @@ inline bool HasTimeout(std::chrono::seconds timeout) { return timeout.count() >
  *   - Logging.
  *   - Signal error. If an exception is thrown in one (or many) of the workers, it can
  *     signal an error to the tracker and the tracker will notify other workers.
+ *
+ *   After an error, the workers are expected to be restarted and the tracker waits for
+ *   them to form a new group. With elastic restart (`min_workers` < `n_workers`), the
+ *   tracker stops waiting for the lost workers after a bounded time and forms a smaller
+ *   group with the ones that have returned. Restoring the training state is left to the
+ *   caller.
  */
 class Tracker {
  public:
@@ -111,6 +118,10 @@ class RabitTracker : public Tracker {
     [[nodiscard]] Result& Status() { return rc_; }
 
     void Send(StringView value) { this->sock_.Send(value); }
+    [[nodiscard]] Result SendWorld(std::int32_t world) {
+      world_ = world;
+      return proto::Start{}.TrackerSend(world, &sock_);
+    }
   };
   // Provide an ordering for workers, this helps us get deterministic topology.
   struct WorkerCmp {
@@ -137,7 +148,16 @@ class RabitTracker : public Tracker {
   // mutex for protecting the listener, used to prevent race when it's listening while
   // another thread tries to shut it down.
   std::mutex listener_mu_;
-
+  // Elastic restart. After an error, the tracker waits `elastic_timeout_` for the
+  // replacements, then forms a smaller group if at least `min_workers_` have returned.
+  std::int32_t min_workers_;
+  std::chrono::seconds elastic_timeout_;
+
+  // Maximum number of pending connections accepted at once.
+  static constexpr std::size_t kMaxAcceptBatch = 256;
+  // Run the handshakes with the accepted workers concurrently.
+  [[nodiscard]] std::vector<WorkerProxy> Handshake(
+      std::vector<std::pair<TCPSocket, SockAddress>> accepted) const;
   Result Bootstrap(std::vector<WorkerProxy>* p_workers);
 
  public:
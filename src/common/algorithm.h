@@ -5,12 +5,19 @@
 #define XGBOOST_COMMON_ALGORITHM_H_
 #include <algorithm>          // upper_bound, stable_sort, sort, max
 #include <cinttypes>          // size_t
+#include <cstdint>            // uint32_t
+#include <cstring>            // memcpy
 #include <functional>         // less
 #include <iterator>           // iterator_traits, distance
+#include <numeric>            // iota
+#include <utility>            // make_pair
 #include <vector>             // vector
 
+#include "common.h"           // DivRoundUp
 #include "numeric.h"          // Iota
+#include "threading_utils.h"  // ParallelFor
 #include "xgboost/context.h"  // Context
+#include "xgboost/span.h"     // Span
 
 // clang with libstdc++ works as well
 #if defined(__GNUC__) && (__GNUC__ >= 4) && !defined(__sun) && !defined(sun) && \
@@ -83,6 +90,222 @@ std::vector<Idx> ArgSort(Context const *ctx, Iter begin, Iter end, Comp comp = s
   StableSort(ctx, result.begin(), result.end(), op);
   return result;
 }
+
+namespace detail {
+// Segments smaller than this are not sorted in parallel.
+constexpr std::size_t kMinRadixSize = static_cast<std::size_t>(1) << 14;
+
+// Map the bits of a float to an integer key with the same order.
+inline std::uint32_t FlipFloat(std::uint32_t bits) {
+  return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+inline std::uint32_t UnflipFloat(std::uint32_t key) {
+  return (key & 0x80000000u) ? (key & 0x7fffffffu) : ~key;
+}
+// Map a float to an integer key, the ascending order of the key is the ascending order of
+// the float. -0 and 0 have the same key.
+inline std::uint32_t RadixKey(float v) {
+  v = v == 0.0f ? 0.0f : v;
+  std::uint32_t bits;
+  std::memcpy(&bits, &v, sizeof(bits));
+  return FlipFloat(bits);
+}
+// Same as @ref RadixKey, but in descending order.
+inline std::uint32_t DescendingRadixKey(float v) { return ~RadixKey(v); }
+
+/**
+ * @brief Stable LSD radix sort of the keys, the indices are moved along with the keys if
+ *        `p_idx` is not null.
+ *
+ *   Each pass sorts by 8 bits of the key. Every thread builds a histogram of the digits
+ *   in its own block of the input, and the blocks are scattered in order so that the sort
+ *   is stable. Passes on which all keys have the same digit are skipped.
+ */
+template <typename Idx>
+void RadixSortKeys(Context const *ctx, std::vector<std::uint32_t> *p_keys,
+                   std::vector<Idx> *p_idx) {
+  auto &keys = *p_keys;
+  std::size_t n = keys.size();
+  constexpr std::uint32_t kDigitBits = 8;
+  constexpr std::size_t kBuckets = static_cast<std::size_t>(1) << kDigitBits;
+  std::int32_t n_blocks = ctx->Threads();
+  std::size_t block_size = DivRoundUp(n, n_blocks);
+  auto block = [&](std::size_t t) {
+    return std::make_pair(std::min(t * block_size, n), std::min((t + 1) * block_size, n));
+  };
+
+  std::vector<std::uint32_t> keys_out(n);
+  std::vector<Idx> idx_out(p_idx ? n : 0);
+  std::vector<std::size_t> hist(n_blocks * kBuckets);
+  for (std::uint32_t shift = 0; shift < sizeof(std::uint32_t) * 8; shift += kDigitBits) {
+    std::fill(hist.begin(), hist.end(), 0);
+    ParallelFor(n_blocks, ctx->Threads(), Sched::Static(), [&](std::size_t t) {
+      auto [beg, end] = block(t);
+      auto t_hist = hist.data() + t * kBuckets;
+      for (std::size_t i = beg; i < end; ++i) {
+        ++t_hist[(keys[i] >> shift) & (kBuckets - 1)];
+      }
+    });
+    // Exclusive scan in the order of (digit, block).
+    std::size_t sum = 0;
+    bool skip = false;
+    for (std::size_t d = 0; d < kBuckets; ++d) {
+      std::size_t d_beg = sum;
+      for (std::int32_t t = 0; t < n_blocks; ++t) {
+        auto cnt = hist[t * kBuckets + d];
+        hist[t * kBuckets + d] = sum;
+        sum += cnt;
+      }
+      skip = skip || (sum - d_beg == n);
+    }
+    if (skip) {
+      continue;
+    }
+    ParallelFor(n_blocks, ctx->Threads(), Sched::Static(), [&](std::size_t t) {
+      auto [beg, end] = block(t);
+      auto t_hist = hist.data() + t * kBuckets;
+      for (std::size_t i = beg; i < end; ++i) {
+        auto pos = t_hist[(keys[i] >> shift) & (kBuckets - 1)]++;
+        keys_out[pos] = keys[i];
+        if (p_idx) {
+          idx_out[pos] = (*p_idx)[i];
+        }
+      }
+    });
+    keys.swap(keys_out);
+    if (p_idx) {
+      p_idx->swap(idx_out);
+    }
+  }
+}
+}  // namespace detail
+
+/**
+ * @brief Stable argsort of float values with a parallel LSD radix sort. The result is the
+ *        same as @ref ArgSort with `std::less` or `std::greater`, the order of NaN is
+ *        unspecified.
+ */
+template <typename Idx>
+std::vector<Idx> RadixArgSort(Context const *ctx, Span<float const> values,
+                              bool descending = false) {
+  CHECK(!ctx->IsCUDA());
+  std::size_t n = values.size();
+  if (n < detail::kMinRadixSize) {
+    if (descending) {
+      return ArgSort<Idx>(ctx, values.data(), values.data() + n, std::greater<>{});
+    }
+    return ArgSort<Idx>(ctx, values.data(), values.data() + n, std::less<>{});
+  }
+
+  std::vector<std::uint32_t> keys(n);
+  std::vector<Idx> result(n);
+  ParallelFor(n, ctx->Threads(), Sched::Static(), [&](std::size_t i) {
+    keys[i] = descending ? detail::DescendingRadixKey(values[i]) : detail::RadixKey(values[i]);
+    result[i] = static_cast<Idx>(i);
+  });
+  detail::RadixSortKeys(ctx, &keys, &result);
+  return result;
+}
+
+/**
+ * @brief Stable argsort of float values in descending order, see @ref RadixArgSort.
+ */
+template <typename Idx>
+std::vector<Idx> RadixArgSortDesc(Context const *ctx, Span<float const> values) {
+  return RadixArgSort<Idx>(ctx, values, true);
+}
+
+/**
+ * @brief Sort float values in ascending order with a parallel LSD radix sort. The order of
+ *        NaN is unspecified.
+ */
+inline void RadixSort(Context const *ctx, Span<float> values) {
+  CHECK(!ctx->IsCUDA());
+  std::size_t n = values.size();
+  if (n < detail::kMinRadixSize) {
+    std::sort(values.data(), values.data() + n);
+    return;
+  }
+  std::vector<std::uint32_t> keys(n);
+  ParallelFor(n, ctx->Threads(), Sched::Static(), [&](std::size_t i) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &values[i], sizeof(bits));
+    keys[i] = detail::FlipFloat(bits);
+  });
+  detail::RadixSortKeys<std::uint32_t>(ctx, &keys, nullptr);
+  ParallelFor(n, ctx->Threads(), Sched::Static(), [&](std::size_t i) {
+    auto bits = detail::UnflipFloat(keys[i]);
+    std::memcpy(&values[i], &bits, sizeof(bits));
+  });
+}
+
+/**
+ * @brief Run a function on each segment, with the segments balanced between threads.
+ *
+ *   Large segments are passed to `large_fn` one at a time, which is expected to use all the
+ *   threads. The other segments are passed to `small_fn` in parallel, from the largest to
+ *   the smallest with a dynamic schedule.
+ *
+ * @param segments Pointer of the segments, with the size of the number of segments + 1.
+ */
+template <typename S, typename SmallFn, typename LargeFn>
+void ParallelForSegments(Context const *ctx, Span<S const> segments, SmallFn &&small_fn,
+                         LargeFn &&large_fn) {
+  if (segments.size() < 2) {
+    return;
+  }
+  auto n_segments = segments.size() - 1;
+  auto size = [&](std::size_t s) {
+    return static_cast<std::size_t>(segments[s + 1] - segments[s]);
+  };
+  std::vector<std::size_t> small;
+  for (std::size_t s = 0; s < n_segments; ++s) {
+    if (size(s) >= detail::kMinRadixSize) {
+      large_fn(s);
+    } else {
+      small.push_back(s);
+    }
+  }
+  std::stable_sort(small.begin(), small.end(),
+                   [&](std::size_t l, std::size_t r) { return size(l) > size(r); });
+  ParallelFor(small.size(), ctx->Threads(), Sched::Dyn(), [&](std::size_t i) {
+    small_fn(small[i]);
+  });
+}
+
+/**
+ * @brief Stable argsort of float values in each segment. The indices are local to each
+ *        segment, the result is the same as running @ref ArgSort on every segment.
+ *
+ * @param segments   Pointer of the segments, with the size of the number of segments + 1.
+ * @param descending Sort in descending order.
+ * @param out        Output with the same size as the values.
+ */
+template <typename Idx, typename S>
+void SegmentedArgSort(Context const *ctx, Span<float const> values, Span<S const> segments,
+                      bool descending, Span<Idx> out) {
+  CHECK(!ctx->IsCUDA());
+  CHECK_EQ(values.size(), out.size());
+  auto small_fn = [&](std::size_t s) {
+    auto beg = static_cast<std::size_t>(segments[s]);
+    auto s_values = values.subspan(beg, segments[s + 1] - segments[s]);
+    auto s_out = out.subspan(beg, s_values.size());
+    auto first = s_out.data(), last = s_out.data() + s_out.size();
+    std::iota(first, last, static_cast<Idx>(0));
+    if (descending) {
+      std::stable_sort(first, last, [&](Idx l, Idx r) { return s_values[l] > s_values[r]; });
+    } else {
+      std::stable_sort(first, last, [&](Idx l, Idx r) { return s_values[l] < s_values[r]; });
+    }
+  };
+  auto large_fn = [&](std::size_t s) {
+    auto beg = static_cast<std::size_t>(segments[s]);
+    auto s_values = values.subspan(beg, segments[s + 1] - segments[s]);
+    auto sorted_idx = RadixArgSort<Idx>(ctx, s_values, descending);
+    std::copy(sorted_idx.cbegin(), sorted_idx.cend(), out.data() + beg);
+  };
+  ParallelForSegments(ctx, segments, small_fn, large_fn);
+}
 }  // namespace common
 }  // namespace xgboost
 
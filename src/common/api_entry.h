@@ -3,10 +3,12 @@
  */
 #ifndef XGBOOST_COMMON_API_ENTRY_H_
 #define XGBOOST_COMMON_API_ENTRY_H_
+#include <cstdint>              // std::uint8_t
 #include <string>               // std::string
 #include <vector>               // std::vector
 
 #include "xgboost/base.h"       // GradientPair,bst_ulong
+#include "xgboost/host_device_vector.h"  // HostDeviceVector
 #include "xgboost/predictor.h"  // PredictionCacheEntry
 
 namespace xgboost {
@@ -32,6 +34,8 @@ struct XGBAPIThreadLocalEntry {
   PredictionCacheEntry prediction_entry;
   /*! \brief Temp variable for returning prediction shape. */
   std::vector<bst_ulong> prediction_shape;
+  /*! \brief Temp variable for returning the finished rows of cascade prediction. */
+  HostDeviceVector<std::uint8_t> prediction_finished;
 };
 }  // namespace xgboost
 #endif  // XGBOOST_COMMON_API_ENTRY_H_
@@ -7,6 +7,7 @@
 
 #include <algorithm>    // for min
 #include <bitset>       // for bitset
+#include <cassert>      // for assert
 #include <cstdint>      // for uint32_t, uint64_t, uint8_t
 #include <ostream>      // for ostream
 #include <type_traits>  // for conditional_t, is_signed_v, add_const_t
@@ -0,0 +1,108 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#pragma once
+#include <atomic>              // for atomic
+#include <condition_variable>  // for condition_variable
+#include <mutex>               // for mutex, unique_lock, lock_guard
+
+namespace xgboost::common {
+/**
+ * @brief Cooperative cancellation and pausing of a long running task, like training.
+ *
+ *   The task calls @ref Checkpoint at points where it can stop with a consistent state,
+ *   see @ref CancelScope. Other threads can request the task to be cancelled, or to be
+ *   parked at the next checkpoint until it's resumed.
+ */
+class CancelToken {
+  std::atomic<bool> cancelled_{false};
+  std::atomic<bool> paused_{false};
+  std::mutex mu_;
+  std::condition_variable cv_;
+  // Whether the task is waiting in a checkpoint, or has finished.
+  bool parked_{false};
+  bool done_{false};
+
+ public:
+  void Cancel() {
+    {
+      std::lock_guard guard{mu_};
+      cancelled_.store(true);
+    }
+    cv_.notify_all();
+  }
+  [[nodiscard]] bool IsCancelled() const { return cancelled_.load(); }
+  /**
+   * @brief Request the task to wait at the next checkpoint, returns immediately.
+   */
+  void Pause() { paused_.store(true); }
+  void Resume() {
+    {
+      std::lock_guard guard{mu_};
+      paused_.store(false);
+    }
+    cv_.notify_all();
+  }
+  /**
+   * @brief Block until the task is parked after @ref Pause, or has finished.
+   */
+  void WaitParked() {
+    std::unique_lock lock{mu_};
+    cv_.wait(lock, [this] { return parked_ || done_; });
+  }
+  /**
+   * @brief Called by the task when it won't reach any more checkpoints.
+   */
+  void Done() {
+    {
+      std::lock_guard guard{mu_};
+      done_ = true;
+    }
+    cv_.notify_all();
+  }
+  /**
+   * @brief Called by the task, waits while the task is paused.
+   *
+   * @return Whether the task has been cancelled.
+   */
+  [[nodiscard]] bool Checkpoint() {
+    if (paused_.load()) {
+      std::unique_lock lock{mu_};
+      parked_ = true;
+      cv_.notify_all();
+      cv_.wait(lock, [this] { return !paused_.load() || cancelled_.load(); });
+      parked_ = false;
+    }
+    return this->IsCancelled();
+  }
+};
+
+/**
+ * @brief Install a cancellation token for the current thread, the previous token is
+ *        restored when the scope ends.
+ */
+class CancelScope {
+  CancelToken* prev_;
+
+  [[nodiscard]] static CancelToken*& Current() {
+    static thread_local CancelToken* token{nullptr};
+    return token;
+  }
+
+ public:
+  explicit CancelScope(CancelToken* token) : prev_{Current()} { Current() = token; }
+  ~CancelScope() { Current() = prev_; }
+
+  CancelScope(CancelScope const& that) = delete;
+  CancelScope& operator=(CancelScope const& that) = delete;
+
+  /**
+   * @brief Checkpoint of the task running in the current thread, see
+   *        @ref CancelToken::Checkpoint. Returns false if there's no token.
+   */
+  [[nodiscard]] static bool Checkpoint() {
+    auto token = Current();
+    return token && token->Checkpoint();
+  }
+};
+}  // namespace xgboost::common
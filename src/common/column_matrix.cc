@@ -1,12 +1,12 @@
 /**
- * Copyright 2017-2023, XGBoost Contributors
+ * Copyright 2017-2025, XGBoost Contributors
  * \brief Utility for fast column-wise access
  */
 #include "column_matrix.h"
 
 #include <algorithm>    // for transform
 #include <cstddef>      // for size_t
-#include <cstdint>      // for uint64_t, uint8_t
+#include <cstdint>      // for uint64_t, uint32_t, uint8_t
 #include <limits>       // for numeric_limits
 #include <type_traits>  // for remove_reference_t
 #include <vector>       // for vector
@@ -18,6 +18,7 @@
 
 namespace xgboost::common {
 void ColumnMatrix::InitStorage(GHistIndexMatrix const& gmat, double sparse_threshold) {
+  MemTagScope scope{MemTag::kColumnMatrix};
   auto const nfeature = gmat.Features();
   const size_t nrow = gmat.Size();
   // identify type of each column
@@ -63,8 +64,12 @@ void ColumnMatrix::InitStorage(GHistIndexMatrix const& gmat, double sparse_thres
 
   index_ = common::MakeFixedVecWithMalloc(storage_size, std::uint8_t{0});
 
+  // Row indices are in [0, nrow) for all pages.
+  row_ind_type_size_ = nrow <= std::numeric_limits<std::uint32_t>::max() ? kUint32RowIdxTypeSize
+                                                                         : kUint64RowIdxTypeSize;
   if (!all_dense_column) {
-    row_ind_ = common::MakeFixedVecWithMalloc(feature_offsets_[nfeature], std::size_t{0});
+    row_ind_ = common::MakeFixedVecWithMalloc(feature_offsets_[nfeature] * row_ind_type_size_,
+                                              std::uint8_t{0});
   }
 
   // store least bin id for each feature
@@ -99,6 +104,9 @@ bool ColumnMatrix::Read(AlignedResourceReadStream* fi, uint32_t const* index_bas
   if (!fi->Read(&bins_type_size_)) {
     return false;
   }
+  if (!fi->Read(&row_ind_type_size_)) {
+    return false;
+  }
   if (!fi->Read(&any_missing_)) {
     return false;
   }
@@ -115,6 +123,7 @@ std::size_t ColumnMatrix::Write(AlignedFileWriteStream* fo) const {
   bytes += common::WriteVec(fo, missing_.storage);
 
   bytes += fo->Write(bins_type_size_);
+  bytes += fo->Write(row_ind_type_size_);
   bytes += fo->Write(any_missing_);
 
   return bytes;
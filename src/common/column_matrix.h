@@ -10,7 +10,7 @@
 
 #include <algorithm>
 #include <cstddef>  // for size_t, byte
-#include <cstdint>  // for uint8_t
+#include <cstdint>  // for uint8_t, uint32_t, uint64_t
 #include <limits>
 #include <memory>
 #include <type_traits>  // for enable_if_t, is_same_v, is_signed_v
@@ -19,6 +19,7 @@
 #include "../data/gradient_index.h"
 #include "bitfield.h"  // for RBitField8
 #include "hist_util.h"
+#include "memory_stats.h"       // for MemTagScope
 #include "ref_resource_view.h"  // for RefResourceView
 #include "xgboost/base.h"       // for bst_bin_t
 #include "xgboost/span.h"       // for Span
@@ -31,6 +32,33 @@ class AlignedResourceReadStream;
 /*! \brief column type */
 enum ColumnType : std::uint8_t { kDenseColumn, kSparseColumn };
 
+/**
+ * @brief Size of the row indices stored for sparse columns. 32-bit indices are used unless
+ *        the matrix has more rows than they can represent.
+ */
+enum RowIdxTypeSize : std::uint8_t {
+  kUint32RowIdxTypeSize = sizeof(std::uint32_t),
+  kUint64RowIdxTypeSize = sizeof(std::uint64_t),
+};
+
+/**
+ * @brief Dispatch for row index type, fn is a function that accepts a scalar of the row
+ *        index type.
+ */
+template <typename Fn>
+decltype(auto) DispatchRowIdxType(RowIdxTypeSize type, Fn&& fn) {
+  switch (type) {
+    case kUint32RowIdxTypeSize: {
+      return fn(std::uint32_t{});
+    }
+    case kUint64RowIdxTypeSize: {
+      return fn(std::uint64_t{});
+    }
+  }
+  LOG(FATAL) << "Unreachable";
+  return fn(std::uint64_t{});
+}
+
 /*! \brief a column storage, to be used with ApplySplit. Note that each
     bin id is stored as index[i] + index_base.
     Different types of column index for each column allow
@@ -58,26 +86,29 @@ class Column {
   bst_bin_t const index_base_;
 };
 
-template <typename BinIdxT>
+/**
+ * @tparam RowIdxT Type of the stored row indices, see @ref RowIdxTypeSize.
+ */
+template <typename BinIdxT, typename RowIdxT>
 class SparseColumnIter : public Column<BinIdxT> {
  private:
   using Base = Column<BinIdxT>;
   /* indexes of rows */
-  common::Span<const size_t> row_ind_;
+  common::Span<RowIdxT const> row_ind_;
   size_t idx_;
 
-  [[nodiscard]] size_t const* RowIndices() const { return row_ind_.data(); }
+  [[nodiscard]] RowIdxT const* RowIndices() const { return row_ind_.data(); }
 
  public:
   SparseColumnIter(common::Span<const BinIdxT> index, bst_bin_t least_bin_idx,
-                   common::Span<const size_t> row_ind, bst_idx_t first_row_idx)
+                   common::Span<RowIdxT const> row_ind, bst_idx_t first_row_idx)
       : Base{index, least_bin_idx}, row_ind_(row_ind) {
     // first_row_id is the first row in the leaf partition
-    const size_t* row_data = RowIndices();
+    RowIdxT const* row_data = RowIndices();
     const size_t column_size = this->Size();
     // search first nonzero row with index >= rid_span.front()
     // note that the input row partition is always sorted.
-    const size_t* p = std::lower_bound(row_data, row_data + column_size, first_row_idx);
+    RowIdxT const* p = std::lower_bound(row_data, row_data + column_size, first_row_idx);
     // column_size if all missing
     idx_ = p - row_data;
   }
@@ -196,9 +227,22 @@ class ColumnMatrix {
   };
 
   void InitStorage(GHistIndexMatrix const& gmat, double sparse_threshold);
+  /** @brief Call `fn` with typed pointers to the bin index and the row index storage. */
+  template <typename Fn>
+  void DispatchColumnTypes(Fn&& fn) {
+    DispatchBinType(bins_type_size_, [&](auto t) {
+      using ColumnBinT = decltype(t);
+      auto* local_index = reinterpret_cast<ColumnBinT*>(index_.data());
+      DispatchRowIdxType(row_ind_type_size_, [&](auto r) {
+        using RowIdxT = decltype(r);
+        fn(local_index, reinterpret_cast<RowIdxT*>(row_ind_.data()));
+      });
+    });
+  }
 
-  template <typename ColumnBinT, typename BinT, typename RIdx>
-  void SetBinSparse(BinT bin_id, RIdx rid, bst_feature_t fid, ColumnBinT* local_index) {
+  template <typename ColumnBinT, typename RowIdxT, typename BinT, typename RIdx>
+  void SetBinSparse(BinT bin_id, RIdx rid, bst_feature_t fid, ColumnBinT* local_index,
+                    RowIdxT* local_row_ind) {
     if (type_[fid] == kDenseColumn) {
       ColumnBinT* begin = &local_index[feature_offsets_[fid]];
       begin[rid] = bin_id - index_base_[fid];
@@ -209,7 +253,7 @@ class ColumnMatrix {
     } else {
       ColumnBinT* begin = &local_index[feature_offsets_[fid]];
       begin[num_nonzeros_[fid]] = bin_id - index_base_[fid];
-      row_ind_[feature_offsets_[fid] + num_nonzeros_[fid]] = rid;
+      local_row_ind[feature_offsets_[fid] + num_nonzeros_[fid]] = static_cast<RowIdxT>(rid);
       ++num_nonzeros_[fid];
     }
   }
@@ -298,15 +342,24 @@ class ColumnMatrix {
     }
   }
 
-  template <typename BinIdxType>
-  auto SparseColumn(bst_feature_t fidx, bst_idx_t first_row_idx) const {
+  /**
+   * @brief Call `fn` with the iterator of a sparse column, the type of the iterator
+   *        depends on the size of the row index.
+   */
+  template <typename BinIdxType, typename Fn>
+  decltype(auto) VisitSparseColumn(bst_feature_t fidx, bst_idx_t first_row_idx, Fn&& fn) const {
     const size_t feature_offset = feature_offsets_[fidx];  // to get right place for certain feature
     const size_t column_size = feature_offsets_[fidx + 1] - feature_offset;
     common::Span<const BinIdxType> bin_index = {
         reinterpret_cast<const BinIdxType*>(&index_[feature_offset * bins_type_size_]),
         column_size};
-    return SparseColumnIter<BinIdxType>(bin_index, index_base_[fidx],
-                                        {&row_ind_[feature_offset], column_size}, first_row_idx);
+    return DispatchRowIdxType(row_ind_type_size_, [&](auto t) -> decltype(auto) {
+      using RowIdxT = decltype(t);
+      auto row_ind = reinterpret_cast<RowIdxT const*>(row_ind_.data()) + feature_offset;
+      SparseColumnIter<BinIdxType, RowIdxT> column(bin_index, index_base_[fidx],
+                                                   {row_ind, column_size}, first_row_idx);
+      return fn(column);
+    });
   }
 
   template <typename BinIdxType, bool any_missing>
@@ -350,6 +403,7 @@ class ColumnMatrix {
   template <typename Batch>
   void SetIndexMixedColumns(size_t base_rowid, Batch const& batch, const GHistIndexMatrix& gmat,
                             float missing) {
+    MemTagScope scope{MemTag::kColumnMatrix};
     auto n_features = gmat.Features();
 
     missing_.GrowTo(feature_offsets_[n_features], true);
@@ -362,9 +416,7 @@ class ColumnMatrix {
 
     auto is_valid = data::IsValidFunctor{missing};
 
-    DispatchBinType(bins_type_size_, [&](auto t) {
-      using ColumnBinT = decltype(t);
-      ColumnBinT* local_index = reinterpret_cast<ColumnBinT*>(index_.data());
+    this->DispatchColumnTypes([&](auto* local_index, auto* local_row_ind) {
       size_t const batch_size = batch.Size();
       size_t k{0};
       for (size_t rid = 0; rid < batch_size; ++rid) {
@@ -374,7 +426,7 @@ class ColumnMatrix {
           if (is_valid(coo)) {
             auto fid = coo.column_idx;
             const uint32_t bin_id = row_index[k];
-            SetBinSparse(bin_id, rid + base_rowid, fid, local_index);
+            SetBinSparse(bin_id, rid + base_rowid, fid, local_index, local_row_ind);
             ++k;
           }
         }
@@ -387,23 +439,23 @@ class ColumnMatrix {
    *        available and requires a search for each bin.
    */
   void SetIndexMixedColumns(const GHistIndexMatrix& gmat) {
+    MemTagScope scope{MemTag::kColumnMatrix};
     auto n_features = gmat.Features();
 
     missing_ = MissingIndicator{feature_offsets_[n_features], true};
     num_nonzeros_ = common::MakeFixedVecWithMalloc(n_features, std::size_t{0});
 
-    DispatchBinType(bins_type_size_, [&](auto t) {
-      using ColumnBinT = decltype(t);
-      ColumnBinT* local_index = reinterpret_cast<ColumnBinT*>(index_.data());
+    this->DispatchColumnTypes([&](auto* local_index, auto* local_row_ind) {
       CHECK(this->any_missing_);
       AssignColumnBinIndex(gmat,
                            [&](auto bin_idx, std::size_t, std::size_t ridx, bst_feature_t fidx) {
-                             SetBinSparse(bin_idx, ridx, fidx, local_index);
+                             SetBinSparse(bin_idx, ridx, fidx, local_index, local_row_ind);
                            });
     });
   }
 
   [[nodiscard]] BinTypeSize GetTypeSize() const { return bins_type_size_; }
+  [[nodiscard]] RowIdxTypeSize GetRowIdxTypeSize() const { return row_ind_type_size_; }
   [[nodiscard]] auto GetColumnType(bst_feature_t fidx) const { return type_[fidx]; }
 
   // And this returns part of state
@@ -418,8 +470,8 @@ class ColumnMatrix {
   RefResourceView<std::uint8_t> index_;
 
   RefResourceView<ColumnType> type_;
-  /** @brief indptr of a CSC matrix. */
-  RefResourceView<std::size_t> row_ind_;
+  /** @brief Row indices of the sparse columns, stored with `row_ind_type_size_` bytes. */
+  RefResourceView<std::uint8_t> row_ind_;
   /** @brief indicate where each column's index and row_ind is stored. */
   RefResourceView<std::size_t> feature_offsets_;
   /** @brief The number of nnz of each column. */
@@ -430,8 +482,9 @@ class ColumnMatrix {
 
   MissingIndicator missing_;
 
-  BinTypeSize bins_type_size_;
-  bool any_missing_;
+  BinTypeSize bins_type_size_{kUint8BinsTypeSize};
+  RowIdxTypeSize row_ind_type_size_{kUint32RowIdxTypeSize};
+  bool any_missing_{false};
 };
 }  // namespace xgboost::common
 #endif  // XGBOOST_COMMON_COLUMN_MATRIX_H_
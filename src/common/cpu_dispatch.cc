@@ -0,0 +1,61 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include "cpu_dispatch.h"
+
+#include <atomic>  // for atomic
+
+#include "xgboost/logging.h"  // for CHECK_LE
+
+namespace xgboost::common {
+namespace {
+CpuIsa Detect() {
+// Detected for Clang as well, used by the kernels written with intrinsics.
+#if defined(__x86_64__) && defined(__GNUC__)
+  __builtin_cpu_init();
+  // FMA is not used by the dispatched kernels, but it's required by the AVX2 vector math.
+  bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+              __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2") &&
+              __builtin_cpu_supports("popcnt");
+  if (avx2 && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+      __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl")) {
+    return CpuIsa::kAvx512;
+  }
+  if (avx2) {
+    return CpuIsa::kAvx2;
+  }
+#endif  // defined(__x86_64__) && defined(__GNUC__)
+  return CpuIsa::kBaseline;
+}
+
+std::atomic<CpuIsa>& CurrentIsa() {
+  static std::atomic<CpuIsa> isa{DetectCpuIsa()};
+  return isa;
+}
+}  // anonymous namespace
+
+CpuIsa DetectCpuIsa() {
+  static CpuIsa const kIsa = Detect();
+  return kIsa;
+}
+
+CpuIsa GetCpuIsa() { return CurrentIsa().load(std::memory_order_relaxed); }
+
+void SetCpuIsa(CpuIsa isa) {
+  CHECK_LE(static_cast<std::int32_t>(isa), static_cast<std::int32_t>(DetectCpuIsa()))
+      << CpuIsaName(isa) << " is not supported by the CPU.";
+  CurrentIsa().store(isa, std::memory_order_relaxed);
+}
+
+StringView CpuIsaName(CpuIsa isa) {
+  switch (isa) {
+    case CpuIsa::kBaseline:
+      return "baseline";
+    case CpuIsa::kAvx2:
+      return "avx2";
+    case CpuIsa::kAvx512:
+      return "avx512";
+  }
+  return "unknown";
+}
+}  // namespace xgboost::common
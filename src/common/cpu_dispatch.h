@@ -0,0 +1,86 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ *
+ * @brief Runtime selection of the instruction set for the hot CPU kernels.
+ *
+ *   The library is built for the baseline architecture of the compiler. Kernels that
+ *   benefit from wider vectors are compiled again with function-level target attributes,
+ *   and one of the copies is chosen by @ref DispatchCpuIsa from the features reported by
+ *   the CPU. No compiler flag is needed for the rest of the library.
+ */
+#ifndef XGBOOST_COMMON_CPU_DISPATCH_H_
+#define XGBOOST_COMMON_CPU_DISPATCH_H_
+
+#include <cstdint>  // for int32_t
+
+#include "xgboost/string_view.h"  // for StringView
+
+// Contracting the multiply and add into FMA changes the rounding, it's excluded for all copies
+// of a kernel to produce the same result as the baseline one. AVX-512 implies FMA, hence the
+// contraction is turned off instead. Clang doesn't have an attribute for it.
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+#define XGBOOST_ISA_DISPATCH_PRESENT 1
+#define XGBOOST_TARGET_AVX2 __attribute__((target("avx2,bmi,bmi2,popcnt,lzcnt"), flatten))
+#define XGBOOST_TARGET_AVX512 \
+  __attribute__((target("avx512f,avx512bw,avx512dq,avx512vl,bmi,bmi2,popcnt,lzcnt"), \
+                 optimize("fp-contract=off"), flatten))
+#endif  // defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+
+namespace xgboost::common {
+/**
+ * @brief Instruction sets with dedicated copies of the kernels, in increasing order.
+ *
+ *   - kAvx2: AVX2, FMA, BMI1 and BMI2 (Haswell and Zen).
+ *   - kAvx512: AVX-512 F, BW, DQ and VL (Skylake-SP, Ice Lake and Zen 4).
+ */
+enum class CpuIsa : std::int32_t { kBaseline = 0, kAvx2 = 1, kAvx512 = 2 };
+
+/** @brief The best instruction set supported by the CPU, detected once. */
+[[nodiscard]] CpuIsa DetectCpuIsa();
+/** @brief The instruction set used by the kernels. */
+[[nodiscard]] CpuIsa GetCpuIsa();
+/**
+ * @brief Restrict the kernels to an instruction set, used for comparing the copies of the
+ *        kernels. It can not exceed the one from @ref DetectCpuIsa.
+ */
+void SetCpuIsa(CpuIsa isa);
+[[nodiscard]] StringView CpuIsaName(CpuIsa isa);
+
+#if defined(XGBOOST_ISA_DISPATCH_PRESENT)
+namespace detail {
+// The call to `fn` and everything it calls are inlined into these functions by the
+// flatten attribute, hence compiled for the target.
+template <typename Fn>
+XGBOOST_TARGET_AVX512 decltype(auto) InvokeAvx512(Fn&& fn) {
+  return fn();
+}
+
+template <typename Fn>
+XGBOOST_TARGET_AVX2 decltype(auto) InvokeAvx2(Fn&& fn) {
+  return fn();
+}
+}  // namespace detail
+#endif  // defined(XGBOOST_ISA_DISPATCH_PRESENT)
+
+/**
+ * @brief Invoke `fn` with the copy compiled for the instruction set from @ref GetCpuIsa.
+ *
+ *   Calls to other translation units and the parallel regions are not inlined, they run
+ *   the baseline code. Dispatch inside the parallel loop instead of around it.
+ */
+template <typename Fn>
+decltype(auto) DispatchCpuIsa(Fn&& fn) {
+#if defined(XGBOOST_ISA_DISPATCH_PRESENT)
+  switch (GetCpuIsa()) {
+    case CpuIsa::kAvx512:
+      return detail::InvokeAvx512(fn);
+    case CpuIsa::kAvx2:
+      return detail::InvokeAvx2(fn);
+    case CpuIsa::kBaseline:
+      break;
+  }
+#endif  // defined(XGBOOST_ISA_DISPATCH_PRESENT)
+  return fn();
+}
+}  // namespace xgboost::common
+#endif  // XGBOOST_COMMON_CPU_DISPATCH_H_
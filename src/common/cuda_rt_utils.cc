@@ -16,15 +16,20 @@
 namespace xgboost::curt {
 #if defined(XGBOOST_USE_CUDA)
 std::int32_t AllVisibleGPUs() {
-  int n_visgpus = 0;
-  try {
-    // When compiled with CUDA but running on CPU only device,
-    // cudaGetDeviceCount will fail.
-    dh::safe_cuda(cudaGetDeviceCount(&n_visgpus));
-  } catch (const dmlc::Error&) {
-    cudaGetLastError();  // reset error.
-    return 0;
-  }
+  // Querying the device count initializes the driver, which is expensive. Only do it once,
+  // when it's first needed.
+  static std::int32_t n_visgpus = 0;
+  static std::once_flag flag;
+  std::call_once(flag, [] {
+    try {
+      // When compiled with CUDA but running on CPU only device,
+      // cudaGetDeviceCount will fail.
+      dh::safe_cuda(cudaGetDeviceCount(&n_visgpus));
+    } catch (const dmlc::Error&) {
+      cudaGetLastError();  // reset error.
+      n_visgpus = 0;
+    }
+  });
   return n_visgpus;
 }
 
@@ -104,6 +104,12 @@ inline size_t AvailableMemory(int device_idx) {
   size_t device_total = 0;
   safe_cuda(cudaSetDevice(device_idx));
   dh::safe_cuda(cudaMemGetInfo(&device_free, &device_total));
+#if !defined(XGBOOST_USE_RMM)
+  // Memory kept by the pool can be reused by XGBoost.
+  if (detail::UseDevicePool()) {
+    device_free += detail::DevicePoolIdleBytes(device_idx);
+  }
+#endif  // !defined(XGBOOST_USE_RMM)
   return device_free;
 }
 
@@ -1,7 +1,10 @@
 /**
  * Copyright 2017-2024, XGBoost contributors
  */
+#include <cstdint>  // for int32_t, int64_t, uint64_t
+#include <limits>   // for numeric_limits
 #include <numeric>  // for accumulate
+#include <vector>   // for vector
 
 #include "../collective/communicator-inl.h"  // for GetRank
 #include "common.h"                          // for HumanMemUnit
@@ -9,9 +12,98 @@
 #include "device_helpers.cuh"  // for CurrentDevice
 #include "device_vector.cuh"
 #include "transform_iterator.h"  // for MakeIndexTransformIter
+#include "xgboost/global_config.h"  // for GlobalConfigThreadLocalStore
 
 namespace dh {
 namespace detail {
+#if !defined(XGBOOST_USE_RMM)
+namespace {
+cudaMemPool_t CurrentDevicePool(std::int32_t device) {
+  cudaMemPool_t pool;
+  safe_cuda(cudaDeviceGetDefaultMemPool(&pool, device));
+  return pool;
+}
+
+// Apply the release threshold from the global configuration, once for each value.
+void SetReleaseThreshold(std::int32_t device) {
+  auto threshold = xgboost::GlobalConfigThreadLocalStore::Get()->device_pool_release_threshold;
+  auto constexpr kNotSet = std::numeric_limits<std::int64_t>::min();
+  thread_local std::vector<std::int64_t> applied;
+  if (applied.size() <= static_cast<std::size_t>(device)) {
+    applied.resize(device + 1, kNotSet);
+  }
+  if (applied[device] == threshold) {
+    return;
+  }
+  // A negative threshold keeps all the freed memory in the pool.
+  std::uint64_t value = threshold < 0 ? std::numeric_limits<std::uint64_t>::max()
+                                      : static_cast<std::uint64_t>(threshold);
+  safe_cuda(cudaMemPoolSetAttribute(CurrentDevicePool(device), cudaMemPoolAttrReleaseThreshold,
+                                    &value));
+  applied[device] = threshold;
+}
+
+std::uint64_t GetPoolAttribute(std::int32_t device, cudaMemPoolAttr attr) {
+  std::uint64_t value{0};
+  safe_cuda(cudaMemPoolGetAttribute(CurrentDevicePool(device), attr, &value));
+  return value;
+}
+}  // anonymous namespace
+
+[[nodiscard]] bool UseDevicePool() {
+  static auto const kSupported = [] {
+    std::int32_t n_devices{0};
+    if (cudaGetDeviceCount(&n_devices) != cudaSuccess) {
+      cudaGetLastError();  // Reset the error.
+      n_devices = 0;
+    }
+    std::vector<bool> supported(n_devices, false);
+    for (std::int32_t i = 0; i < n_devices; ++i) {
+      std::int32_t value{0};
+      safe_cuda(cudaDeviceGetAttribute(&value, cudaDevAttrMemoryPoolsSupported, i));
+      supported[i] = value != 0;
+    }
+    return supported;
+  }();
+  auto device = CurrentDevice();
+  return device < static_cast<std::int32_t>(kSupported.size()) && kSupported[device];
+}
+
+[[nodiscard]] void *DevicePoolAllocate(std::size_t n_bytes) {
+  auto device = CurrentDevice();
+  SetReleaseThreshold(device);
+  void *ptr{nullptr};
+  auto err = cudaMallocAsync(&ptr, n_bytes, cudaStreamPerThread);
+  if (err != cudaSuccess) {
+    cudaGetLastError();  // Reset the error.
+    ThrowOOMError(cudaGetErrorString(err), n_bytes);
+  }
+  return ptr;
+}
+
+void DevicePoolFree(void *ptr) { safe_cuda(cudaFreeAsync(ptr, cudaStreamPerThread)); }
+
+[[nodiscard]] std::size_t DevicePoolIdleBytes(std::int32_t device) {
+  auto reserved = GetPoolAttribute(device, cudaMemPoolAttrReservedMemCurrent);
+  auto used = GetPoolAttribute(device, cudaMemPoolAttrUsedMemCurrent);
+  return reserved > used ? reserved - used : 0;
+}
+
+void LogDevicePool() {
+  if (!UseDevicePool()) {
+    return;
+  }
+  auto device = CurrentDevice();
+  using xgboost::common::HumanMemUnit;
+  LOG(CONSOLE) << "Memory pool reserved: "
+               << HumanMemUnit(GetPoolAttribute(device, cudaMemPoolAttrReservedMemCurrent))
+               << ", peak reserved: "
+               << HumanMemUnit(GetPoolAttribute(device, cudaMemPoolAttrReservedMemHigh))
+               << ", peak used: "
+               << HumanMemUnit(GetPoolAttribute(device, cudaMemPoolAttrUsedMemHigh));
+}
+#endif  // !defined(XGBOOST_USE_RMM)
+
 void ThrowOOMError(std::string const &err, std::size_t bytes) {
   auto device = CurrentDevice();
   auto rank = xgboost::collective::GetRank();
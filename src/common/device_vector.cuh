@@ -55,6 +55,29 @@ T AtomicFetchMax(std::atomic<T> &atom, T val,  // NOLINT
   return expected;
 }
 
+#if !defined(XGBOOST_USE_RMM)
+/**
+ * @brief Whether the stream-ordered memory pool (`cudaMallocAsync`) is used for the
+ *        current device. The pool is used when the device supports it.
+ */
+[[nodiscard]] bool UseDevicePool();
+/**
+ * @brief Allocate from the memory pool of the current device, ordered on the per-thread
+ *        default stream. The release threshold of the pool is set by the global
+ *        configuration `device_pool_release_threshold`.
+ */
+[[nodiscard]] void *DevicePoolAllocate(std::size_t n_bytes);
+void DevicePoolFree(void *ptr);
+/**
+ * @brief Memory that's reserved by the pool but not used by any allocation.
+ */
+[[nodiscard]] std::size_t DevicePoolIdleBytes(std::int32_t device);
+/**
+ * @brief Print the statistics of the memory pool for the current device.
+ */
+void LogDevicePool();
+#endif  // !defined(XGBOOST_USE_RMM)
+
 /** \brief Keeps track of global device memory allocations. Thread safe.*/
 class MemoryLogger {
   // Information for a single device
@@ -105,6 +128,9 @@ class MemoryLogger {
                  << " ========";
     LOG(CONSOLE) << "Peak memory usage: "
                  << xgboost::common::HumanMemUnit(stats_.peak_allocated_bytes);
+#if !defined(XGBOOST_USE_RMM)
+    LogDevicePool();
+#endif  // !defined(XGBOOST_USE_RMM)
   }
 };
 
@@ -272,7 +298,8 @@ using XGBBaseDeviceAllocator = thrust::device_malloc_allocator<T>;
 #endif  // defined(XGBOOST_USE_RMM) && XGBOOST_USE_RMM == 1
 
 /**
- * \brief Default memory allocator, uses cudaMalloc/Free and logs allocations if verbose.
+ * \brief Default memory allocator, uses the stream-ordered memory pool or cudaMalloc/Free, and
+ *        logs allocations if verbose.
  */
 template <class T>
 struct XGBDefaultDeviceAllocatorImpl : XGBBaseDeviceAllocator<T> {
@@ -285,6 +312,13 @@ struct XGBDefaultDeviceAllocatorImpl : XGBBaseDeviceAllocator<T> {
   };
   pointer allocate(size_t n) {  // NOLINT
     pointer ptr;
+#if !defined(XGBOOST_USE_RMM)
+    if (UseDevicePool()) {
+      ptr = pointer{static_cast<T *>(DevicePoolAllocate(n * sizeof(T)))};
+      GlobalMemoryLogger().RegisterAllocation(n * sizeof(T));
+      return ptr;
+    }
+#endif  // !defined(XGBOOST_USE_RMM)
     try {
       ptr = SuperT::allocate(n);
       dh::safe_cuda(cudaGetLastError());
@@ -296,6 +330,12 @@ struct XGBDefaultDeviceAllocatorImpl : XGBBaseDeviceAllocator<T> {
   }
   void deallocate(pointer ptr, size_t n) {  // NOLINT
     GlobalMemoryLogger().RegisterDeallocation(n * sizeof(T));
+#if !defined(XGBOOST_USE_RMM)
+    if (UseDevicePool()) {
+      DevicePoolFree(thrust::raw_pointer_cast(ptr));
+      return;
+    }
+#endif  // !defined(XGBOOST_USE_RMM)
     SuperT::deallocate(ptr, n);
   }
 #if defined(XGBOOST_USE_RMM) && XGBOOST_USE_RMM == 1
@@ -305,8 +345,9 @@ struct XGBDefaultDeviceAllocatorImpl : XGBBaseDeviceAllocator<T> {
 };
 
 /**
- * \brief Caching memory allocator, uses cub::CachingDeviceAllocator as a back-end, unless
- *        RMM pool allocator is enabled. Does not initialise memory on construction.
+ * \brief Caching memory allocator, uses the stream-ordered memory pool, or
+ *        cub::CachingDeviceAllocator if the pool is not supported, as a back-end, unless RMM
+ *        pool allocator is enabled. Does not initialise memory on construction.
  */
 template <class T>
 struct XGBCachingDeviceAllocatorImpl : XGBBaseDeviceAllocator<T> {
@@ -326,6 +367,13 @@ struct XGBCachingDeviceAllocatorImpl : XGBBaseDeviceAllocator<T> {
   }
   pointer allocate(size_t n) {  // NOLINT
     pointer thrust_ptr;
+#if !defined(XGBOOST_USE_RMM)
+    if (UseDevicePool()) {
+      thrust_ptr = pointer{static_cast<T *>(DevicePoolAllocate(n * sizeof(T)))};
+      GlobalMemoryLogger().RegisterAllocation(n * sizeof(T));
+      return thrust_ptr;
+    }
+#endif  // !defined(XGBOOST_USE_RMM)
     if (use_cub_allocator_) {
       T *raw_ptr{nullptr};
       // NOLINTBEGIN(clang-analyzer-unix.BlockInCriticalSection)
@@ -349,6 +397,12 @@ struct XGBCachingDeviceAllocatorImpl : XGBBaseDeviceAllocator<T> {
   }
   void deallocate(pointer ptr, size_t n) {  // NOLINT
     GlobalMemoryLogger().RegisterDeallocation(n * sizeof(T));
+#if !defined(XGBOOST_USE_RMM)
+    if (UseDevicePool()) {
+      DevicePoolFree(thrust::raw_pointer_cast(ptr));
+      return;
+    }
+#endif  // !defined(XGBOOST_USE_RMM)
     if (use_cub_allocator_) {
       GetGlobalCachingAllocator().DeviceFree(thrust::raw_pointer_cast(ptr));
     } else {
@@ -56,6 +56,21 @@ constexpr StringView InplacePredictProxy() {
   return "Inplace predict accepts only DMatrixProxy as input.";
 }
 
+constexpr StringView FrozenBooster() {
+  return "The booster is frozen for inference, it can not be modified. Use a copy of the booster "
+         "instead.";
+}
+
+constexpr StringView LazyModel() {
+  return "The trees of this model are loaded on demand, only the normal prediction is supported. "
+         "Load the model without lazy loading for other operations.";
+}
+
+constexpr StringView ServingModel() {
+  return "The model is saved for serving without the node statistics. Feature importance "
+         "based on gain or cover and feature contributions are not available.";
+}
+
 inline void MaxSampleSize(std::size_t n) {
   LOG(FATAL) << "Sample size too large for the current updater. Maximum number of samples:" << n
              << ". Consider using a different updater or tree_method.";
@@ -0,0 +1,160 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include "feature_bundle.h"
+
+#include <algorithm>  // for max, stable_sort
+#include <limits>     // for numeric_limits
+#include <numeric>    // for iota, partial_sum
+
+#include "../data/gradient_index.h"  // for GHistIndexMatrix
+#include "threading_utils.h"         // for ParallelFor
+#include "xgboost/logging.h"         // for CHECK
+
+namespace xgboost::common {
+void FeatureBundles::Build(Context const* ctx, GHistIndexMatrix const& gmat) {
+  *this = FeatureBundles{};
+  if (gmat.IsDense() || gmat.Size() == 0) {
+    // The dense index is already compressed with feature offsets.
+    return;
+  }
+  CHECK_EQ(gmat.index.GetBinTypeSize(), kUint32BinsTypeSize);
+
+  auto const& ptrs = gmat.cut.Ptrs();
+  auto n_features = gmat.Features();
+  auto n_samples = gmat.Size();
+  auto const& row_ptr = gmat.row_ptr;
+  auto nnz = row_ptr[n_samples] - row_ptr[0];
+
+  std::vector<bst_feature_t> bin_feature(gmat.cut.TotalBins());
+  for (bst_feature_t f = 0; f < n_features; ++f) {
+    std::fill(bin_feature.begin() + ptrs[f], bin_feature.begin() + ptrs[f + 1], f);
+  }
+
+  /**
+   * Group the entries by feature.
+   */
+  std::vector<bst_idx_t> col_ptr(n_features + 1, 0);
+  for (std::size_t k = row_ptr[0]; k < row_ptr[n_samples]; ++k) {
+    col_ptr[bin_feature[gmat.index[k]] + 1]++;
+  }
+  std::partial_sum(col_ptr.cbegin(), col_ptr.cend(), col_ptr.begin());
+  std::vector<bst_idx_t> col_rows(nnz);
+  std::vector<bst_idx_t> col_entries(nnz);
+  {
+    std::vector<bst_idx_t> cursor(col_ptr.cbegin(), col_ptr.cend() - 1);
+    for (bst_idx_t r = 0; r < n_samples; ++r) {
+      for (auto k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
+        auto pos = cursor[bin_feature[gmat.index[k]]]++;
+        col_rows[pos] = r;
+        col_entries[pos] = k;
+      }
+    }
+  }
+
+  /**
+   * Greedy bundling, features with more entries are assigned first.
+   */
+  std::vector<bst_feature_t> order;
+  std::uint32_t max_bins = 0;
+  for (bst_feature_t f = 0; f < n_features; ++f) {
+    if (col_ptr[f + 1] != col_ptr[f]) {
+      order.push_back(f);
+      max_bins = std::max(max_bins, ptrs[f + 1] - ptrs[f]);
+    }
+  }
+  std::stable_sort(order.begin(), order.end(), [&](bst_feature_t l, bst_feature_t r) {
+    return col_ptr[l + 1] - col_ptr[l] > col_ptr[r + 1] - col_ptr[r];
+  });
+  // Local bin 0 is reserved, the capacity of a bundle is the maximum of the bin type.
+  std::uint32_t capacity;
+  if (max_bins < std::numeric_limits<std::uint8_t>::max()) {
+    bin_type_size_ = kUint8BinsTypeSize;
+    capacity = std::numeric_limits<std::uint8_t>::max();
+  } else if (max_bins < std::numeric_limits<std::uint16_t>::max()) {
+    bin_type_size_ = kUint16BinsTypeSize;
+    capacity = std::numeric_limits<std::uint16_t>::max();
+  } else {
+    bin_type_size_ = kUint32BinsTypeSize;
+    capacity = std::numeric_limits<std::uint32_t>::max();
+  }
+
+  constexpr auto kNone = std::numeric_limits<std::uint32_t>::max();
+  // The bundle of each entry in the gradient index, used to find conflicts.
+  std::vector<std::uint32_t> entry_bundle(row_ptr[n_samples], kNone);
+  std::vector<std::uint32_t> feature_bundle(n_features, kNone);
+  // Local bin of the first bin of each feature.
+  std::vector<std::uint32_t> feature_begin(n_features, 0);
+  std::vector<std::uint32_t> bundle_bins;
+  // The features that conflict with a bundle mark it with their index.
+  std::vector<bst_feature_t> conflict;
+  for (auto f : order) {
+    for (auto i = col_ptr[f]; i < col_ptr[f + 1]; ++i) {
+      auto r = col_rows[i];
+      for (auto k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
+        if (entry_bundle[k] != kNone) {
+          conflict[entry_bundle[k]] = f + 1;
+        }
+      }
+    }
+    auto n_bins = ptrs[f + 1] - ptrs[f];
+    std::uint32_t b = 0;
+    for (; b < bundle_bins.size(); ++b) {
+      if (conflict[b] != f + 1 && capacity - bundle_bins[b] >= n_bins) {
+        break;
+      }
+    }
+    if (b == bundle_bins.size()) {
+      bundle_bins.push_back(0);
+      conflict.push_back(0);
+    }
+    feature_bundle[f] = b;
+    feature_begin[f] = bundle_bins[b] + 1;
+    bundle_bins[b] += n_bins;
+    for (auto i = col_ptr[f]; i < col_ptr[f + 1]; ++i) {
+      entry_bundle[col_entries[i]] = b;
+    }
+  }
+
+  auto n_bundles = bundle_bins.size();
+  auto bundled_bytes = n_samples * n_bundles * static_cast<std::size_t>(bin_type_size_);
+  auto sparse_bytes = nnz * sizeof(std::uint32_t) + (n_samples + 1) * sizeof(std::size_t);
+  LOG(DEBUG) << "Bundled " << order.size() << " features into " << n_bundles << " bundles.";
+  if (n_bundles == 0 || bundled_bytes >= sparse_bytes) {
+    return;
+  }
+
+  /**
+   * Map the local bins back to the global bins.
+   */
+  ptrs_.resize(n_bundles + 1, 0);
+  for (std::size_t b = 0; b < n_bundles; ++b) {
+    ptrs_[b + 1] = ptrs_[b] + bundle_bins[b] + 1;
+  }
+  bin_map_.resize(ptrs_.back(), 0);
+  for (auto f : order) {
+    auto out = bin_map_.begin() + ptrs_[feature_bundle[f]] + feature_begin[f];
+    std::iota(out, out + (ptrs[f + 1] - ptrs[f]), ptrs[f]);
+  }
+
+  /**
+   * Fill the bundled index.
+   */
+  data_.resize(bundled_bytes, 0);
+  DispatchBinType(bin_type_size_, [&](auto t) {
+    using BinT = decltype(t);
+    auto out = reinterpret_cast<BinT*>(data_.data());
+    ParallelFor(n_samples, ctx->Threads(), [&](bst_idx_t r) {
+      auto out_row = out + r * n_bundles;
+      for (auto k = row_ptr[r]; k < row_ptr[r + 1]; ++k) {
+        auto bin = gmat.index[k];
+        auto f = bin_feature[bin];
+        out_row[feature_bundle[f]] = static_cast<BinT>(feature_begin[f] + (bin - ptrs[f]));
+      }
+    });
+  });
+  n_bundles_ = n_bundles;
+  n_samples_ = n_samples;
+  base_rowid_ = gmat.base_rowid;
+}
+}  // namespace xgboost::common
@@ -0,0 +1,73 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#ifndef XGBOOST_COMMON_FEATURE_BUNDLE_H_
+#define XGBOOST_COMMON_FEATURE_BUNDLE_H_
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint8_t, uint32_t
+#include <vector>   // for vector
+
+#include "hist_util.h"        // for BinTypeSize
+#include "xgboost/base.h"     // for bst_feature_t, bst_idx_t
+#include "xgboost/context.h"  // for Context
+
+namespace xgboost {
+class GHistIndexMatrix;
+
+namespace common {
+/**
+ * @brief Exclusive feature bundling for the sparse gradient index.
+ *
+ *   Features that are never present in the same row, like the columns of a one-hot
+ *   encoded variable, are merged into a bundle. Every row stores a single local bin for
+ *   each bundle, which is 0 when none of the features in the bundle is present. The local
+ *   bin is mapped back to the global bin of the histogram, so the layout of the histogram
+ *   is not changed, and neither the split evaluation nor the tree model is aware of the
+ *   bundles.
+ *
+ *   The bundles are exact, features with any conflicting row are not merged.
+ */
+class FeatureBundles {
+  // Number of bundles, also the stride of the rows in the index.
+  std::size_t n_bundles_{0};
+  bst_idx_t n_samples_{0};
+  bst_idx_t base_rowid_{0};
+  // Offset of each bundle into the bin map, the first entry of each bundle is reserved for
+  // rows without any feature in the bundle.
+  std::vector<std::uint32_t> ptrs_;
+  // Local bin of a bundle to the global bin.
+  std::vector<std::uint32_t> bin_map_;
+  // Row-major local bins with shape (n_samples, n_bundles).
+  std::vector<std::uint8_t> data_;
+  BinTypeSize bin_type_size_{kUint8BinsTypeSize};
+
+ public:
+  FeatureBundles() = default;
+  /**
+   * @brief Bundle the features of a sparse gradient index.
+   *
+   *   Bundling is not used if the bundled index is not smaller than the sparse index.
+   */
+  void Build(Context const* ctx, GHistIndexMatrix const& gmat);
+  /**
+   * @brief Whether the bundled index is built and can be used in place of the sparse
+   *        index.
+   */
+  [[nodiscard]] bool IsBundled() const { return n_bundles_ != 0; }
+
+  [[nodiscard]] std::size_t NumBundles() const { return n_bundles_; }
+  [[nodiscard]] bst_idx_t Size() const { return n_samples_; }
+  [[nodiscard]] bst_idx_t BaseRowId() const { return base_rowid_; }
+  [[nodiscard]] BinTypeSize GetBinTypeSize() const { return bin_type_size_; }
+  [[nodiscard]] std::vector<std::uint32_t> const& Ptrs() const { return ptrs_; }
+  [[nodiscard]] std::vector<std::uint32_t> const& BinMap() const { return bin_map_; }
+
+  template <typename BinT>
+  [[nodiscard]] BinT const* Data() const {
+    return reinterpret_cast<BinT const*>(data_.data());
+  }
+};
+}  // namespace common
+}  // namespace xgboost
+#endif  // XGBOOST_COMMON_FEATURE_BUNDLE_H_
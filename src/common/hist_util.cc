@@ -6,10 +6,16 @@
 
 #include <dmlc/timer.h>
 
+#include <algorithm>    // for clamp, max, min
+#include <cstdint>      // for uint8_t, uint32_t
+#include <type_traits>  // for integral_constant, is_same_v
 #include <vector>
 
 #include "../data/adapter.h"         // for SparsePageAdapterBatch
 #include "../data/gradient_index.h"  // for GHistIndexMatrix
+#include "column_matrix.h"           // for ColumnMatrix
+#include "cpu_dispatch.h"            // for DispatchCpuIsa
+#include "feature_bundle.h"          // for FeatureBundles
 #include "quantile.h"
 #include "xgboost/base.h"
 #include "xgboost/context.h"  // for Context
@@ -186,15 +192,16 @@ class GHistBuildingManager {
   }
 };
 
-template <bool do_prefetch, class BuildingManager>
-void RowsWiseBuildHistKernel(Span<GradientPair const> gpair, Span<bst_idx_t const> row_indices,
+template <bool do_prefetch, class BuildingManager, typename RowIdxT>
+void RowsWiseBuildHistKernel(Span<GradientPair const> gpair, Span<RowIdxT const> row_indices,
                              const GHistIndexMatrix &gmat, GHistRow hist) {
   constexpr bool kAnyMissing = BuildingManager::kAnyMissing;
   constexpr bool kFirstPage = BuildingManager::kFirstPage;
   using BinIdxType = typename BuildingManager::BinIdxType;
+  constexpr size_t kFeaturesPerBlock = 8;
 
   const size_t size = row_indices.size();
-  bst_idx_t const *rid = row_indices.data();
+  RowIdxT const *rid = row_indices.data();
   auto const *p_gpair = reinterpret_cast<const float *>(gpair.data());
   const BinIdxType *gradient_index = gmat.index.data<BinIdxType>();
 
@@ -231,7 +238,8 @@ void RowsWiseBuildHistKernel(Span<GradientPair const> gpair, Span<bst_idx_t cons
         kAnyMissing ? get_row_ptr(rid[i] + 1) : icol_start + n_features;
 
     const size_t row_size = icol_end - icol_start;
-    const size_t idx_gh = two * rid[i];
+    // Widen the row index before the multiplication for 32-bit indices.
+    const size_t idx_gh = two * static_cast<size_t>(rid[i]);
 
     if (do_prefetch) {
       const size_t icol_start_prefetch =
@@ -242,7 +250,7 @@ void RowsWiseBuildHistKernel(Span<GradientPair const> gpair, Span<bst_idx_t cons
           kAnyMissing ? get_row_ptr(rid[i + Prefetch::kPrefetchOffset] + 1)
                       : icol_start_prefetch + n_features;
 
-      PREFETCH_READ_T0(p_gpair + two * rid[i + Prefetch::kPrefetchOffset]);
+      PREFETCH_READ_T0(p_gpair + two * static_cast<size_t>(rid[i + Prefetch::kPrefetchOffset]));
       for (size_t j = icol_start_prefetch; j < icol_end_prefetch;
            j += Prefetch::GetPrefetchStep<uint32_t>()) {
         PREFETCH_READ_T0(gradient_index + j);
@@ -252,24 +260,37 @@ void RowsWiseBuildHistKernel(Span<GradientPair const> gpair, Span<bst_idx_t cons
 
     // The trick with pgh_t buffer helps the compiler to generate faster binary.
     const float pgh_t[] = {p_gpair[idx_gh], p_gpair[idx_gh + 1]};
-    for (size_t j = 0; j < row_size; ++j) {
+    auto add_bin = [&](size_t j) {
       const uint32_t idx_bin =
           two * (static_cast<uint32_t>(gr_index_local[j]) + (kAnyMissing ? 0 : offsets[j]));
       auto hist_local = hist_data + idx_bin;
       *(hist_local) += pgh_t[0];
       *(hist_local + 1) += pgh_t[1];
+    };
+    size_t j = 0;
+    if constexpr (!kAnyMissing) {
+      // Dense rows are short for most tabular data. Process the features in blocks with a
+      // fixed trip count for the compiler to unroll, only the tail has the loop overhead.
+      for (; j + kFeaturesPerBlock <= row_size; j += kFeaturesPerBlock) {
+        for (size_t k = 0; k < kFeaturesPerBlock; ++k) {
+          add_bin(j + k);
+        }
+      }
+    }
+    for (; j < row_size; ++j) {
+      add_bin(j);
     }
   }
 }
 
-template <class BuildingManager>
-void ColsWiseBuildHistKernel(Span<GradientPair const> gpair, Span<bst_idx_t const> row_indices,
+template <class BuildingManager, typename RowIdxT>
+void ColsWiseBuildHistKernel(Span<GradientPair const> gpair, Span<RowIdxT const> row_indices,
                              const GHistIndexMatrix &gmat, GHistRow hist) {
   constexpr bool kAnyMissing = BuildingManager::kAnyMissing;
   constexpr bool kFirstPage = BuildingManager::kFirstPage;
   using BinIdxType = typename BuildingManager::BinIdxType;
   const size_t size = row_indices.size();
-  bst_idx_t const *rid = row_indices.data();
+  RowIdxT const *rid = row_indices.data();
   auto const *pgh = reinterpret_cast<const float *>(gpair.data());
   const BinIdxType *gradient_index = gmat.index.data<BinIdxType>();
 
@@ -312,10 +333,154 @@ void ColsWiseBuildHistKernel(Span<GradientPair const> gpair, Span<bst_idx_t cons
   }
 }
 
-template <class BuildingManager>
-void BuildHistDispatch(Span<GradientPair const> gpair, Span<bst_idx_t const> row_indices,
-                       const GHistIndexMatrix &gmat, GHistRow hist) {
-  if (BuildingManager::kReadByColumn) {
+/**
+ * @brief Histogram kernel for dense matrices.
+ *
+ *   It's used in place of the column-wise kernel for 8-bit bin indices when the histogram
+ *   doesn't fit in the L2 cache, and for building a subset of features sampled by
+ *   `colsample_bytree`. Features are processed in blocks whose histograms fit in the L1
+ *   cache, and rows are processed in chunks whose bin indices fit in the L2 cache. The
+ *   histogram of each feature is disjoint from others, so no merging is needed after a
+ *   block is done. Since the matrix is dense, each row starts at a fixed multiple of the
+ *   number of features.
+ *
+ * @param features Sorted subset of features to build, empty for all features.
+ */
+template <class BuildingManager, typename RowIdxT>
+void DenseBlockedBuildHistKernel(Span<GradientPair const> gpair,
+                                 Span<RowIdxT const> row_indices, const GHistIndexMatrix &gmat,
+                                 GHistRow hist, Span<bst_feature_t const> features) {
+  static_assert(!BuildingManager::kAnyMissing);
+  constexpr bool kFirstPage = BuildingManager::kFirstPage;
+  using BinIdxType = typename BuildingManager::BinIdxType;
+  // With 8-bit bin indices, at most 256 bins of 16 bytes for each feature, 16KB for a block
+  // of features.
+  constexpr std::size_t kFeaturesPerBlock = 4;
+  // Size of the bin indices for a chunk of rows.
+  constexpr std::size_t kChunkBytes = 256 * 1024;
+
+  const size_t size = row_indices.size();
+  RowIdxT const *rid = row_indices.data();
+  auto const *p_gpair = reinterpret_cast<const float *>(gpair.data());
+  BinIdxType const *gradient_index = gmat.index.data<BinIdxType>();
+  std::uint32_t const *offsets = gmat.index.Offset();
+  CHECK(offsets);
+  auto base_rowid = gmat.base_rowid;
+  auto hist_data = reinterpret_cast<double *>(hist.data());
+
+  const size_t n_features = gmat.cut.Ptrs().size() - 1;
+  const size_t n_sampled = features.empty() ? n_features : features.size();
+  const size_t rows_per_chunk = std::clamp(
+      kChunkBytes / std::max(n_sampled * sizeof(BinIdxType), static_cast<size_t>(1)),
+      static_cast<size_t>(16), static_cast<size_t>(1024));
+
+  auto add_block = [&](size_t r_begin, size_t r_end, size_t f_begin, auto n_block,
+                       auto const &feature_at) {
+    for (size_t i = r_begin; i < r_end; ++i) {
+      size_t const ridx = rid[i];
+      auto row_index = gradient_index + (kFirstPage ? ridx : ridx - base_rowid) * n_features;
+      // The trick with pgh_t buffer helps the compiler to generate faster binary.
+      const float pgh_t[] = {p_gpair[2 * ridx], p_gpair[2 * ridx + 1]};
+      for (size_t k = 0; k < n_block; ++k) {
+        auto fidx = feature_at(f_begin + k);
+        auto hist_local =
+            hist_data + 2 * (static_cast<uint32_t>(row_index[fidx]) + offsets[fidx]);
+        *(hist_local) += pgh_t[0];
+        *(hist_local + 1) += pgh_t[1];
+      }
+    }
+  };
+
+  auto build = [&](auto const &feature_at) {
+    for (size_t r_begin = 0; r_begin < size; r_begin += rows_per_chunk) {
+      auto r_end = std::min(r_begin + rows_per_chunk, size);
+      for (size_t f_begin = 0; f_begin < n_sampled; f_begin += kFeaturesPerBlock) {
+        auto f_end = std::min(f_begin + kFeaturesPerBlock, n_sampled);
+        if (f_end - f_begin == kFeaturesPerBlock) {
+          // Fixed trip count for the compiler to unroll.
+          add_block(r_begin, r_end, f_begin,
+                    std::integral_constant<size_t, kFeaturesPerBlock>{}, feature_at);
+        } else {
+          add_block(r_begin, r_end, f_begin, f_end - f_begin, feature_at);
+        }
+      }
+    }
+  };
+
+  if (features.empty()) {
+    build([](size_t k) { return k; });
+  } else {
+    build([&](size_t k) { return static_cast<size_t>(features[k]); });
+  }
+}
+
+/**
+ * @brief Row-wise histogram kernel for multiple targets, see @ref BuildHistMultiTarget.
+ */
+template <class BuildingManager, typename RowIdxT>
+void MultiTargetBuildHistKernel(Span<GradientPair const> gpair, Span<RowIdxT const> row_indices,
+                                const GHistIndexMatrix &gmat, Span<GHistRow const> hists,
+                                Span<bst_feature_t const> features) {
+  constexpr bool kAnyMissing = BuildingManager::kAnyMissing;
+  constexpr bool kFirstPage = BuildingManager::kFirstPage;
+  using BinIdxType = typename BuildingManager::BinIdxType;
+
+  auto const n_targets = hists.size();
+  RowIdxT const *rid = row_indices.data();
+  auto const *p_gpair = reinterpret_cast<const float *>(gpair.data());
+  const BinIdxType *gradient_index = gmat.index.data<BinIdxType>();
+  auto const &row_ptr = gmat.row_ptr.data();
+  auto base_rowid = gmat.base_rowid;
+  std::uint32_t const *offsets = gmat.index.Offset();
+  auto n_features = gmat.cut.Ptrs().size() - 1;
+  bool use_subset = !kAnyMissing && !features.empty();
+
+  std::vector<double *> hist_data(n_targets);
+  for (std::size_t t = 0; t < n_targets; ++t) {
+    hist_data[t] = reinterpret_cast<double *>(hists[t].data());
+  }
+  auto get_rid = [&](bst_idx_t ridx) { return kFirstPage ? ridx : (ridx - base_rowid); };
+
+  for (std::size_t i = 0; i < row_indices.size(); ++i) {
+    auto local_rid = get_rid(rid[i]);
+    std::size_t icol_start = kAnyMissing ? row_ptr[local_rid] : local_rid * n_features;
+    std::size_t icol_end = kAnyMissing ? row_ptr[local_rid + 1] : icol_start + n_features;
+    BinIdxType const *gr_index_local = gradient_index + icol_start;
+    // Gradient of all the targets for this row, read once for all the bins.
+    float const *pgh = p_gpair + 2 * n_targets * rid[i];
+    auto add_bin = [&](std::uint32_t bin_idx) {
+      auto idx_bin = 2 * static_cast<std::size_t>(bin_idx);
+      for (std::size_t t = 0; t < n_targets; ++t) {
+        hist_data[t][idx_bin] += pgh[2 * t];
+        hist_data[t][idx_bin + 1] += pgh[2 * t + 1];
+      }
+    };
+    if (use_subset) {
+      for (auto fidx : features) {
+        add_bin(static_cast<std::uint32_t>(gr_index_local[fidx]) + offsets[fidx]);
+      }
+    } else {
+      for (std::size_t j = 0; j < icol_end - icol_start; ++j) {
+        add_bin(static_cast<std::uint32_t>(gr_index_local[j]) + (kAnyMissing ? 0 : offsets[j]));
+      }
+    }
+  }
+}
+
+template <class BuildingManager, typename RowIdxT>
+void BuildHistDispatch(Span<GradientPair const> gpair, Span<RowIdxT const> row_indices,
+                       const GHistIndexMatrix &gmat, GHistRow hist,
+                       Span<bst_feature_t const> features) {
+  if constexpr (!BuildingManager::kAnyMissing) {
+    if (!features.empty()) {
+      DenseBlockedBuildHistKernel<BuildingManager>(gpair, row_indices, gmat, hist, features);
+      return;
+    }
+  }
+  if constexpr (BuildingManager::kReadByColumn && !BuildingManager::kAnyMissing &&
+                std::is_same_v<typename BuildingManager::BinIdxType, std::uint8_t>) {
+    DenseBlockedBuildHistKernel<BuildingManager>(gpair, row_indices, gmat, hist, {});
+  } else if (BuildingManager::kReadByColumn) {
     ColsWiseBuildHistKernel<BuildingManager>(gpair, row_indices, gmat, hist);
   } else {
     const size_t nrows = row_indices.size();
@@ -344,30 +509,178 @@ void BuildHistDispatch(Span<GradientPair const> gpair, Span<bst_idx_t const> row
   }
 }
 
-template <bool any_missing>
-void BuildHist(Span<GradientPair const> gpair, Span<bst_idx_t const> row_indices,
-               const GHistIndexMatrix &gmat, GHistRow hist, bool force_read_by_column) {
+namespace {
+template <bool any_missing, typename RowIdxT>
+void BuildHistImpl(Span<GradientPair const> gpair, Span<RowIdxT const> row_indices,
+                   const GHistIndexMatrix &gmat, GHistRow hist, bool force_read_by_column,
+                   Span<bst_feature_t const> features) {
   /* force_read_by_column is used for testing the columnwise building of histograms.
    * default force_read_by_column = false
    */
-  constexpr double kAdhocL2Size = 1024 * 1024 * 0.8;
-  const bool hist_fit_to_l2 = kAdhocL2Size > 2 * sizeof(float) * gmat.cut.Ptrs().back();
   bool first_page = gmat.base_rowid == 0;
-  bool read_by_column = !hist_fit_to_l2 && !any_missing;
+  bool read_by_column = ReadByColumn(gmat.cut.TotalBins()) && !any_missing;
   auto bin_type_size = gmat.index.GetBinTypeSize();
 
   GHistBuildingManager<any_missing>::DispatchAndExecute(
       {first_page, read_by_column || force_read_by_column, bin_type_size}, [&](auto t) {
         using BuildingManager = decltype(t);
-        BuildHistDispatch<BuildingManager>(gpair, row_indices, gmat, hist);
+        BuildHistDispatch<BuildingManager>(gpair, row_indices, gmat, hist, features);
       });
 }
 
-template void BuildHist<true>(Span<GradientPair const> gpair, Span<bst_idx_t const> row_indices,
-                              const GHistIndexMatrix &gmat, GHistRow hist,
-                              bool force_read_by_column);
+template <bool any_missing, typename RowIdxT>
+void BuildHistMultiTargetImpl(Span<GradientPair const> gpair, Span<RowIdxT const> row_indices,
+                              const GHistIndexMatrix &gmat, Span<GHistRow const> hists,
+                              Span<bst_feature_t const> features) {
+  if (row_indices.empty()) {
+    return;
+  }
+  CHECK(!hists.empty());
+  bool first_page = gmat.base_rowid == 0;
+  auto bin_type_size = gmat.index.GetBinTypeSize();
+  GHistBuildingManager<any_missing>::DispatchAndExecute(
+      {first_page, false, bin_type_size}, [&](auto t) {
+        using BuildingManager = decltype(t);
+        MultiTargetBuildHistKernel<BuildingManager>(gpair, row_indices, gmat, hists, features);
+      });
+}
 
-template void BuildHist<false>(Span<GradientPair const> gpair, Span<bst_idx_t const> row_indices,
-                               const GHistIndexMatrix &gmat, GHistRow hist,
-                               bool force_read_by_column);
+template <typename RowIdxT>
+void BuildHistColumnsImpl(Span<GradientPair const> gpair, Span<RowIdxT const> row_indices,
+                          ColumnMatrix const &columns, bst_idx_t base_rowid, GHistRow hist,
+                          Span<bst_feature_t const> features) {
+  CHECK(columns.IsInitialized());
+  CHECK(!columns.AnyMissing());
+  auto const *p_gpair = reinterpret_cast<const float *>(gpair.data());
+  auto hist_data = reinterpret_cast<double *>(hist.data());
+  std::size_t n_features = features.empty() ? columns.GetNumFeature() : features.size();
+
+  DispatchBinType(columns.GetTypeSize(), [&](auto t) {
+    using BinT = decltype(t);
+    for (std::size_t k = 0; k < n_features; ++k) {
+      auto fidx = features.empty() ? static_cast<bst_feature_t>(k) : features[k];
+      CHECK_EQ(columns.GetColumnType(fidx), kDenseColumn);
+      auto column = columns.DenseColumn<BinT, false>(fidx);
+      for (bst_idx_t ridx : row_indices) {
+        auto hist_local = hist_data + 2 * static_cast<std::size_t>(column[ridx - base_rowid]);
+        *(hist_local) += p_gpair[2 * ridx];
+        *(hist_local + 1) += p_gpair[2 * ridx + 1];
+      }
+    }
+  });
+}
+
+template <typename RowIdxT>
+void BuildHistBundledImpl(Span<GradientPair const> gpair, Span<RowIdxT const> row_indices,
+                          FeatureBundles const &bundles, GHistRow hist) {
+  CHECK(bundles.IsBundled());
+  auto n_bundles = bundles.NumBundles();
+  auto base_rowid = bundles.BaseRowId();
+  auto const *p_gpair = reinterpret_cast<const float *>(gpair.data());
+  auto const *ptrs = bundles.Ptrs().data();
+  auto const *bin_map = bundles.BinMap().data();
+  auto hist_data = reinterpret_cast<double *>(hist.data());
+
+  DispatchBinType(bundles.GetBinTypeSize(), [&](auto t) {
+    using BinT = decltype(t);
+    BinT const *index = bundles.Data<BinT>();
+    for (bst_idx_t ridx : row_indices) {
+      auto row_index = index + (ridx - base_rowid) * n_bundles;
+      // The trick with pgh_t buffer helps the compiler to generate faster binary.
+      const float pgh_t[] = {p_gpair[2 * ridx], p_gpair[2 * ridx + 1]};
+      for (std::size_t b = 0; b < n_bundles; ++b) {
+        auto local = static_cast<std::uint32_t>(row_index[b]);
+        if (local == 0) {
+          continue;
+        }
+        auto hist_local = hist_data + 2 * static_cast<std::size_t>(bin_map[ptrs[b] + local]);
+        *(hist_local) += pgh_t[0];
+        *(hist_local + 1) += pgh_t[1];
+      }
+    }
+  });
+}
+}  // anonymous namespace
+
+template <bool any_missing>
+void BuildHist(Span<GradientPair const> gpair, Span<bst_idx_t const> row_indices,
+               const GHistIndexMatrix &gmat, GHistRow hist, bool force_read_by_column,
+               Span<bst_feature_t const> features) {
+  DispatchCpuIsa([&] {
+    BuildHistImpl<any_missing>(gpair, row_indices, gmat, hist, force_read_by_column, features);
+  });
+}
+
+template <bool any_missing>
+void BuildHist(Span<GradientPair const> gpair, Span<std::uint32_t const> row_indices,
+               const GHistIndexMatrix &gmat, GHistRow hist, bool force_read_by_column,
+               Span<bst_feature_t const> features) {
+  DispatchCpuIsa([&] {
+    BuildHistImpl<any_missing>(gpair, row_indices, gmat, hist, force_read_by_column, features);
+  });
+}
+
+template <bool any_missing>
+void BuildHistMultiTarget(Span<GradientPair const> gpair, Span<bst_idx_t const> row_indices,
+                          const GHistIndexMatrix &gmat, Span<GHistRow const> hists,
+                          Span<bst_feature_t const> features) {
+  DispatchCpuIsa(
+      [&] { BuildHistMultiTargetImpl<any_missing>(gpair, row_indices, gmat, hists, features); });
+}
+
+template <bool any_missing>
+void BuildHistMultiTarget(Span<GradientPair const> gpair, Span<std::uint32_t const> row_indices,
+                          const GHistIndexMatrix &gmat, Span<GHistRow const> hists,
+                          Span<bst_feature_t const> features) {
+  DispatchCpuIsa(
+      [&] { BuildHistMultiTargetImpl<any_missing>(gpair, row_indices, gmat, hists, features); });
+}
+
+#define INSTANTIATE_BUILD_HIST(RowIdxT)                                                     \
+  template void BuildHist<true>(Span<GradientPair const>, Span<RowIdxT const>,              \
+                                const GHistIndexMatrix &, GHistRow, bool,                   \
+                                Span<bst_feature_t const>);                                 \
+  template void BuildHist<false>(Span<GradientPair const>, Span<RowIdxT const>,             \
+                                 const GHistIndexMatrix &, GHistRow, bool,                  \
+                                 Span<bst_feature_t const>);                                \
+  template void BuildHistMultiTarget<true>(Span<GradientPair const>, Span<RowIdxT const>,   \
+                                           const GHistIndexMatrix &, Span<GHistRow const>,  \
+                                           Span<bst_feature_t const>);                      \
+  template void BuildHistMultiTarget<false>(Span<GradientPair const>, Span<RowIdxT const>,  \
+                                            const GHistIndexMatrix &, Span<GHistRow const>, \
+                                            Span<bst_feature_t const>);
+
+INSTANTIATE_BUILD_HIST(bst_idx_t)
+INSTANTIATE_BUILD_HIST(std::uint32_t)
+
+#undef INSTANTIATE_BUILD_HIST
+
+bool ReadByColumn(bst_bin_t n_total_bins) {
+  constexpr double kAdhocL2Size = 1024 * 1024 * 0.8;
+  return kAdhocL2Size <= 2 * sizeof(float) * static_cast<double>(n_total_bins);
+}
+
+void BuildHistColumns(Span<GradientPair const> gpair, Span<bst_idx_t const> row_indices,
+                      ColumnMatrix const &columns, bst_idx_t base_rowid, GHistRow hist,
+                      Span<bst_feature_t const> features) {
+  DispatchCpuIsa(
+      [&] { BuildHistColumnsImpl(gpair, row_indices, columns, base_rowid, hist, features); });
+}
+
+void BuildHistColumns(Span<GradientPair const> gpair, Span<std::uint32_t const> row_indices,
+                      ColumnMatrix const &columns, bst_idx_t base_rowid, GHistRow hist,
+                      Span<bst_feature_t const> features) {
+  DispatchCpuIsa(
+      [&] { BuildHistColumnsImpl(gpair, row_indices, columns, base_rowid, hist, features); });
+}
+
+void BuildHistBundled(Span<GradientPair const> gpair, Span<bst_idx_t const> row_indices,
+                      FeatureBundles const &bundles, GHistRow hist) {
+  DispatchCpuIsa([&] { BuildHistBundledImpl(gpair, row_indices, bundles, hist); });
+}
+
+void BuildHistBundled(Span<GradientPair const> gpair, Span<std::uint32_t const> row_indices,
+                      FeatureBundles const &bundles, GHistRow hist) {
+  DispatchCpuIsa([&] { BuildHistBundledImpl(gpair, row_indices, bundles, hist); });
+}
 }  // namespace xgboost::common
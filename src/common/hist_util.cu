@@ -82,6 +82,17 @@ size_t RequiredMemory(bst_idx_t num_rows, bst_feature_t num_columns, size_t nnz,
   return peak;
 }
 
+std::size_t SketchContainerPeakBytes(bst_feature_t n_features, std::size_t num_cuts,
+                                     bst_idx_t nnz) {
+  auto n_entries = std::min(static_cast<bst_idx_t>(n_features) * num_cuts, nnz);
+  // The current sketch, the pruned input batch, and the merged result that's twice the size
+  // of the current sketch before pruning.
+  std::size_t total = n_entries * sizeof(SketchEntry) * 4;
+  // Two buffers of column pointers.
+  total += (n_features + 1) * sizeof(SketchContainer::OffsetT) * 2;
+  return total;
+}
+
 bst_idx_t SketchBatchNumElements(bst_idx_t sketch_batch_num_elements, SketchShape shape, int device,
                                  size_t num_cuts, bool has_weight, std::size_t container_bytes) {
   auto constexpr kIntMax = static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max());
@@ -97,15 +108,21 @@ bst_idx_t SketchBatchNumElements(bst_idx_t sketch_batch_num_elements, SketchShap
   }
   return std::min(static_cast<bst_idx_t>(n_max_used_f32), shape.nnz);
 #endif  // defined(XGBOOST_USE_RMM) && XGBOOST_USE_RMM == 1
-  (void)container_bytes;  // We known the remaining size when RMM is not used.
-
   if (sketch_batch_num_elements == detail::UnknownSketchNumElements()) {
     auto required_memory =
         RequiredMemory(shape.n_samples, shape.n_features, shape.nnz, num_cuts, has_weight);
     // use up to 80% of available space
-    auto avail = dh::AvailableMemory(device) * 0.8;
+    double avail = dh::AvailableMemory(device) * 0.8;
+    // The available memory already excludes the allocated sketch container, but we need to
+    // leave room for it to grow. The container dominates the memory usage on wide data.
+    auto container_peak = SketchContainerPeakBytes(shape.n_features, num_cuts, shape.nnz);
+    if (container_peak > container_bytes) {
+      avail = std::max(avail - static_cast<double>(container_peak - container_bytes), 0.0);
+    }
     if (required_memory > avail) {
-      sketch_batch_num_elements = avail / BytesPerElement(has_weight);
+      auto n_min_elements = static_cast<bst_idx_t>(shape.n_features);
+      sketch_batch_num_elements = std::max(
+          static_cast<bst_idx_t>(avail / BytesPerElement(has_weight)), n_min_elements);
     } else {
       sketch_batch_num_elements = std::min(shape.Size(), shape.nnz);
     }
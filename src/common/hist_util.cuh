@@ -178,9 +178,23 @@ struct SketchShape {
   [[nodiscard]] bst_idx_t Size() const { return n_samples * n_features; }
 };
 
+/**
+ * @brief Estimate the peak memory usage of the sketch container, including the buffers
+ *        used for merging new batches.
+ *
+ * @param n_features Number of features.
+ * @param num_cuts   Number of sample cuts for each feature.
+ * @param nnz        Number of non-missing values, the container can not be larger than it.
+ */
+std::size_t SketchContainerPeakBytes(bst_feature_t n_features, std::size_t num_cuts,
+                                     bst_idx_t nnz);
+
 /**
  * @brief Calcuate the length of sliding window. Returns `sketch_batch_num_elements`
  *        directly if it's not 0.
+ *
+ *   The window leaves room for the sketch container to grow to its peak size. The
+ *   `container_bytes` is the size of the container that's already allocated.
  */
 bst_idx_t SketchBatchNumElements(bst_idx_t sketch_batch_num_elements, SketchShape shape, int device,
                                  size_t num_cuts, bool has_weight, std::size_t container_bytes);
@@ -24,6 +24,8 @@ namespace xgboost {
 class GHistIndexMatrix;
 
 namespace common {
+class FeatureBundles;
+class ColumnMatrix;
 /*!
  * \brief A single row in global histogram index.
  *  Directly represent the global index in the histogram entry.
@@ -490,7 +492,26 @@ class ParallelGHistBuilder {
 
     MatchThreadsToNodes(space);
     AllocateAdditionalHistograms();
-    MatchNodeNidPairToHist();
+
+    hist_was_used_.resize(nthreads * nodes_);
+    std::fill(hist_was_used_.begin(), hist_was_used_.end(), static_cast<int>(false));
+  }
+  /**
+   * @brief Same as @ref Reset, but every thread can work on every node. Used when the rows
+   *        are not grouped by the nodes.
+   */
+  void Reset(size_t nthreads, size_t nodes, const std::vector<GHistRow>& targeted_hists) {
+    hist_buffer_.Init(nbins_);
+    tid_nid_to_hist_.clear();
+    threads_to_nids_map_.clear();
+
+    targeted_hists_ = targeted_hists;
+    CHECK_EQ(nodes, targeted_hists.size());
+    nodes_ = nodes;
+    nthreads_ = nthreads;
+
+    threads_to_nids_map_.resize(nthreads_ * nodes_, true);
+    AllocateAdditionalHistograms();
 
     hist_was_used_.resize(nthreads * nodes_);
     std::fill(hist_was_used_.begin(), hist_was_used_.end(), static_cast<int>(false));
@@ -514,6 +535,21 @@ class ParallelGHistBuilder {
 
     return hist;
   }
+  /**
+   * @brief Get the target histogram of a node, initialized by zeros if it wasn't used
+   *        before. Used when the bins of a node are split among the threads instead of the
+   *        rows, which needs no reduction. Not thread-safe.
+   */
+  GHistRow GetInitializedTargetHist(size_t nid) {
+    for (size_t tid = 0; tid < nthreads_; ++tid) {
+      auto it = tid_nid_to_hist_.find({tid, nid});
+      if (it != tid_nid_to_hist_.cend() && it->second == -1) {
+        return this->GetInitializedHist(tid, nid);
+      }
+    }
+    LOG(FATAL) << "No thread is assigned to the node: " << nid;
+    return {};
+  }
 
   // Reduce following bins (begin, end] for nid-node in dst across threads
   void ReduceHist(size_t nid, size_t begin, size_t end) const {
@@ -564,36 +600,18 @@ class ParallelGHistBuilder {
     }
   }
 
+  /**
+   * @brief Assign the additional histograms to threads.
+   *
+   *   The first thread of each node writes into the target histogram directly, while the
+   *   other threads get an additional histogram from the buffer. The j-th additional
+   *   histogram of thread `tid` is always the `tid + j * nthreads`-th histogram in the
+   *   buffer, so a thread reuses the same memory across iterations. The memory is
+   *   allocated and zeroed in `GetInitializedHist` by the thread itself, which places
+   *   it on the NUMA node of that thread with the first-touch policy.
+   */
   void AllocateAdditionalHistograms() {
-    size_t hist_allocated_additionally = 0;
-
-    for (size_t nid = 0; nid < nodes_; ++nid) {
-      int nthreads_for_nid = 0;
-
-      for (size_t tid = 0; tid < nthreads_; ++tid) {
-        if (threads_to_nids_map_[tid * nodes_ + nid]) {
-          nthreads_for_nid++;
-        }
-      }
-
-      // In distributed mode - some tree nodes can be empty on local machines,
-      // set nthreads_for_nid to 0 in this case.
-      // In another case - allocate additional (nthreads_for_nid - 1) histograms,
-      // because one is already allocated externally (will store final result for the node).
-      hist_allocated_additionally += std::max<int>(0, nthreads_for_nid - 1);
-    }
-
-    for (size_t i = 0; i < hist_allocated_additionally; ++i) {
-      hist_buffer_.AddHistRow(i);
-    }
-  }
-
-  [[nodiscard]] bst_bin_t TotalBins() const { return nbins_; }
-
- private:
-  void MatchNodeNidPairToHist() {
-    size_t hist_allocated_additionally = 0;
-
+    std::vector<std::size_t> n_additional(nthreads_, 0);
     for (size_t nid = 0; nid < nodes_; ++nid) {
       bool first_hist = true;
       for (size_t tid = 0; tid < nthreads_; ++tid) {
@@ -602,13 +620,24 @@ class ParallelGHistBuilder {
             tid_nid_to_hist_[{tid, nid}] = -1;
             first_hist = false;
           } else {
-            tid_nid_to_hist_[{tid, nid}] = hist_allocated_additionally++;
+            tid_nid_to_hist_[{tid, nid}] = tid + nthreads_ * n_additional[tid]++;
           }
         }
       }
     }
+    // In distributed mode - some tree nodes can be empty on local machines, no
+    // histogram is needed in this case.
+    auto max_additional = std::max_element(n_additional.cbegin(), n_additional.cend());
+    auto n_hists = max_additional == n_additional.cend() ? 0 : *max_additional * nthreads_;
+    for (size_t i = 0; i < n_hists; ++i) {
+      hist_buffer_.AddHistRow(i);
+    }
   }
 
+  [[nodiscard]] bst_bin_t TotalBins() const { return nbins_; }
+
+ private:
+
   /*! \brief number of bins in each histogram */
   size_t nbins_ = 0;
   /*! \brief number of threads for parallel computation */
@@ -635,10 +664,73 @@ class ParallelGHistBuilder {
   std::map<std::pair<size_t, size_t>, int> tid_nid_to_hist_;
 };
 
-// construct a histogram via histogram aggregation
+/**
+ * @brief Construct a histogram via histogram aggregation.
+ *
+ * @param features Sorted subset of features to build. Empty for all features. Only used
+ *                 for dense matrices, the histogram of other features is left untouched.
+ */
 template <bool any_missing>
 void BuildHist(Span<GradientPair const> gpair, Span<bst_idx_t const> row_indices,
-               const GHistIndexMatrix& gmat, GHistRow hist, bool force_read_by_column = false);
+               const GHistIndexMatrix& gmat, GHistRow hist, bool force_read_by_column = false,
+               Span<bst_feature_t const> features = {});
+/**
+ * @brief Overload for 32-bit row indices, used when the number of rows fits.
+ */
+template <bool any_missing>
+void BuildHist(Span<GradientPair const> gpair, Span<std::uint32_t const> row_indices,
+               const GHistIndexMatrix& gmat, GHistRow hist, bool force_read_by_column = false,
+               Span<bst_feature_t const> features = {});
+
+/**
+ * @brief Construct the histograms of all targets in a single pass over the rows.
+ *
+ *   The bin indices of each row are read once and the gradient of every target is added
+ *   to the histogram of that target.
+ *
+ * @param gpair    Row-major gradient with shape (n_samples, n_targets).
+ * @param hists    Histogram for each target, with the same length as the number of targets.
+ * @param features See @ref BuildHist.
+ */
+template <bool any_missing>
+void BuildHistMultiTarget(Span<GradientPair const> gpair, Span<bst_idx_t const> row_indices,
+                          const GHistIndexMatrix& gmat, Span<GHistRow const> hists,
+                          Span<bst_feature_t const> features = {});
+template <bool any_missing>
+void BuildHistMultiTarget(Span<GradientPair const> gpair, Span<std::uint32_t const> row_indices,
+                          const GHistIndexMatrix& gmat, Span<GHistRow const> hists,
+                          Span<bst_feature_t const> features = {});
+
+/**
+ * @brief Whether the histogram of dense data is built by column instead of by row. The
+ *        column-wise kernel is used when the histogram of a node doesn't fit in the L2
+ *        cache.
+ */
+[[nodiscard]] bool ReadByColumn(bst_bin_t n_total_bins);
+
+/**
+ * @brief Construct a histogram from the column matrix of a dense matrix without missing
+ *        value, has the same result as @ref BuildHist. Each column is contiguous, the bins
+ *        of a feature are read in sequence for all rows.
+ *
+ * @param base_rowid The first row of the page.
+ * @param features   See @ref BuildHist.
+ */
+void BuildHistColumns(Span<GradientPair const> gpair, Span<bst_idx_t const> row_indices,
+                      ColumnMatrix const& columns, bst_idx_t base_rowid, GHistRow hist,
+                      Span<bst_feature_t const> features = {});
+void BuildHistColumns(Span<GradientPair const> gpair, Span<std::uint32_t const> row_indices,
+                      ColumnMatrix const& columns, bst_idx_t base_rowid, GHistRow hist,
+                      Span<bst_feature_t const> features = {});
+
+/**
+ * @brief Construct a histogram from the bundled index of a sparse matrix, has the same
+ *        result as @ref BuildHist.
+ */
+void BuildHistBundled(Span<GradientPair const> gpair, Span<bst_idx_t const> row_indices,
+                      FeatureBundles const& bundles, GHistRow hist);
+void BuildHistBundled(Span<GradientPair const> gpair, Span<std::uint32_t const> row_indices,
+                      FeatureBundles const& bundles, GHistRow hist);
 }  // namespace common
 }  // namespace xgboost
 #endif  // XGBOOST_COMMON_HIST_UTIL_H_
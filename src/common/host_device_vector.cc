@@ -13,24 +13,37 @@
 #include <utility>
 #include "xgboost/tree_model.h"
 #include "xgboost/host_device_vector.h"
+#include "memory_stats.h"  // for MemoryAccount
 
 namespace xgboost {
 
 template <typename T>
 struct HostDeviceVectorImpl {
-  explicit HostDeviceVectorImpl(size_t size, T v) : data_h_(size, v) {}
-  HostDeviceVectorImpl(std::initializer_list<T> init) : data_h_(init) {}
-  explicit HostDeviceVectorImpl(std::vector<T>  init) : data_h_(std::move(init)) {}
-  HostDeviceVectorImpl(HostDeviceVectorImpl&& that) : data_h_(std::move(that.data_h_)) {}
+  explicit HostDeviceVectorImpl(size_t size, T v) : data_h_(size, v) { this->Sync(); }
+  HostDeviceVectorImpl(std::initializer_list<T> init) : data_h_(init) { this->Sync(); }
+  explicit HostDeviceVectorImpl(std::vector<T>  init) : data_h_(std::move(init)) { this->Sync(); }
+  HostDeviceVectorImpl(HostDeviceVectorImpl&& that) : data_h_(std::move(that.data_h_)) {
+    that.Sync();
+    this->Sync();
+  }
 
   void Swap(HostDeviceVectorImpl &other) {
      data_h_.swap(other.data_h_);
+     this->Sync();
+     other.Sync();
   }
 
-  std::vector<T>& Vec() { return data_h_; }
+  // The vector can be modified through the returned reference, the memory account is
+  // updated at the next access.
+  std::vector<T>& Vec() {
+    this->Sync();
+    return data_h_;
+  }
+  void Sync() { account_.Update(data_h_.capacity() * sizeof(T)); }
 
  private:
   std::vector<T> data_h_;
+  common::MemoryAccount account_;
 };
 
 template <typename T>
@@ -113,11 +126,13 @@ const std::vector<T>& HostDeviceVector<T>::ConstHostVector() const {
 template <typename T>
 void HostDeviceVector<T>::Resize(size_t new_size, T v) {
   impl_->Vec().resize(new_size, v);
+  impl_->Sync();
 }
 
 template <typename T>
 void HostDeviceVector<T>::Resize(size_t new_size) {
   impl_->Vec().resize(new_size, T{});
+  impl_->Sync();
 }
 
 template <typename T>
@@ -174,6 +189,15 @@ bool HostDeviceVector<T>::DeviceCanWrite() const {
 template <typename T>
 void HostDeviceVector<T>::SetDevice(DeviceOrd) const {}
 
+template <typename T>
+void HostDeviceVector<T>::SetPinned(bool) {}
+
+template <typename T>
+void HostDeviceVector<T>::PrefetchToDevice() const {}
+
+template <typename T>
+void HostDeviceVector<T>::PrefetchToHost() const {}
+
 // explicit instantiations are required, as HostDeviceVector isn't header-only
 template class HostDeviceVector<bst_float>;
 template class HostDeviceVector<double>;
@@ -6,7 +6,10 @@
 #include <algorithm>
 #include <cstddef>  // for size_t
 #include <cstdint>
+#include <memory>   // for unique_ptr, make_unique
+#include <vector>   // for vector
 
+#include "cuda_pinned_allocator.h"  // for PinnedAllocator
 #include "device_helpers.cuh"
 #include "device_vector.cuh"  // for DeviceUVector
 #include "xgboost/data.h"
@@ -51,11 +54,16 @@ class HostDeviceVectorImpl {
     device_{that.device_},
     data_h_{std::move(that.data_h_)},
     data_d_{std::move(that.data_d_)},
-    gpu_access_{that.gpu_access_} {}
+    gpu_access_{that.gpu_access_},
+    pinned_{that.pinned_},
+    staging_{std::move(that.staging_)},
+    staged_{std::move(that.staged_)},
+    host_pending_{that.host_pending_} {}
 
   ~HostDeviceVectorImpl() {
     if (device_.IsCUDA()) {
       SetDevice();
+      this->WaitStaging();
     }
   }
 
@@ -67,6 +75,7 @@ class HostDeviceVectorImpl {
 
   T* DevicePointer() {
     LazySyncDevice(GPUAccess::kWrite);
+    host_pending_ = false;
     return data_d_->data();
   }
 
@@ -77,6 +86,7 @@ class HostDeviceVectorImpl {
 
   common::Span<T> DeviceSpan() {
     LazySyncDevice(GPUAccess::kWrite);
+    host_pending_ = false;
     return {this->DevicePointer(), Size()};
   }
 
@@ -90,6 +100,7 @@ class HostDeviceVectorImpl {
       std::fill(data_h_.begin(), data_h_.end(), v);
     } else {
       gpu_access_ = GPUAccess::kWrite;
+      host_pending_ = false;
       SetDevice();
       auto s_data = dh::ToSpan(*data_d_);
       dh::LaunchN(data_d_->size(), dh::DefaultStream(),
@@ -179,6 +190,7 @@ class HostDeviceVectorImpl {
     if ((Size() == 0 && device_.IsCUDA()) || (DeviceCanWrite() && device_.IsCUDA())) {
       // fast on-device resize
       gpu_access_ = GPUAccess::kWrite;
+      host_pending_ = false;
       SetDevice();
       auto old_size = data_d_->size();
       data_d_->resize(new_size, std::forward<U>(args)...);
@@ -198,6 +210,16 @@ class HostDeviceVectorImpl {
       return;
     }
     gpu_access_ = access;
+    if (host_pending_) {
+      // Started by `PrefetchToHost`.
+      this->FinishStageToHost();
+      return;
+    }
+    if (pinned_) {
+      this->StageToHost();
+      this->FinishStageToHost();
+      return;
+    }
     if (data_h_.size() != data_d_->size()) { data_h_.resize(data_d_->size()); }
     SetDevice();
     dh::safe_cuda(cudaMemcpy(data_h_.data(), data_d_->data(), data_d_->size() * sizeof(T),
@@ -214,11 +236,49 @@ class HostDeviceVectorImpl {
     // data is on the host
     LazyResizeDevice(data_h_.size());
     SetDevice();
-    dh::safe_cuda(cudaMemcpyAsync(data_d_->data(), data_h_.data(), data_d_->size() * sizeof(T),
-                                  cudaMemcpyHostToDevice, dh::DefaultStream()));
+    if (pinned_ && !data_h_.empty()) {
+      // Copy through the staging buffer for the transfer to be asynchronous to the host.
+      this->WaitStaging();
+      staging_.resize(data_h_.size());
+      std::copy(data_h_.cbegin(), data_h_.cend(), staging_.begin());
+      dh::safe_cuda(cudaMemcpyAsync(data_d_->data(), staging_.data(), data_d_->size() * sizeof(T),
+                                    cudaMemcpyHostToDevice, dh::DefaultStream()));
+      this->RecordStaging();
+    } else {
+      dh::safe_cuda(cudaMemcpyAsync(data_d_->data(), data_h_.data(),
+                                    data_d_->size() * sizeof(T), cudaMemcpyHostToDevice,
+                                    dh::DefaultStream()));
+    }
     gpu_access_ = access;
   }
 
+  void SetPinned(bool pinned) {
+    pinned_ = pinned;
+    if (!pinned_ && !host_pending_) {
+      this->WaitStaging();
+      staging_ = decltype(staging_){};
+    }
+  }
+
+  void PrefetchToDevice() {
+    if (!device_.IsCUDA() || DeviceCanRead()) {
+      return;
+    }
+    bool pinned = pinned_;
+    pinned_ = true;
+    // Host keeps the read access.
+    LazySyncDevice(GPUAccess::kRead);
+    pinned_ = pinned;
+  }
+
+  void PrefetchToHost() {
+    if (HostCanRead() || host_pending_) {
+      return;
+    }
+    this->StageToHost();
+    host_pending_ = true;
+  }
+
   [[nodiscard]] bool HostCanAccess(GPUAccess access) const { return gpu_access_ <= access; }
   [[nodiscard]] bool HostCanRead() const { return HostCanAccess(GPUAccess::kRead); }
   [[nodiscard]] bool HostCanWrite() const { return HostCanAccess(GPUAccess::kNone); }
@@ -232,6 +292,45 @@ class HostDeviceVectorImpl {
   std::vector<T> data_h_{};
   std::unique_ptr<dh::DeviceUVector<T>> data_d_{};
   GPUAccess gpu_access_{GPUAccess::kNone};
+  // Stage the host copies in pinned memory.
+  bool pinned_{false};
+  std::vector<T, common::cuda_impl::PinnedAllocator<T>> staging_;
+  // Recorded after the last copy from or to the staging buffer.
+  std::unique_ptr<dh::CUDAEvent> staged_;
+  // The staging buffer holds a copy of the device data for the next host access.
+  bool host_pending_{false};
+
+  void RecordStaging() {
+    if (!staged_) {
+      staged_ = std::make_unique<dh::CUDAEvent>();
+    }
+    staged_->Record(dh::DefaultStream());
+  }
+
+  void WaitStaging() {
+    if (staged_) {
+      dh::safe_cuda(cudaEventSynchronize(*staged_));
+    }
+  }
+
+  void StageToHost() {
+    SetDevice();
+    this->WaitStaging();
+    staging_.resize(data_d_->size());
+    dh::safe_cuda(cudaMemcpyAsync(staging_.data(), data_d_->data(), data_d_->size() * sizeof(T),
+                                  cudaMemcpyDeviceToHost, dh::DefaultStream()));
+    this->RecordStaging();
+  }
+
+  void FinishStageToHost() {
+    this->WaitStaging();
+    data_h_.resize(staging_.size());
+    std::copy(staging_.cbegin(), staging_.cend(), data_h_.begin());
+    host_pending_ = false;
+    if (!pinned_) {
+      staging_ = decltype(staging_){};
+    }
+  }
 
   void CopyToDevice(HostDeviceVectorImpl* other) {
     if (other->HostCanWrite()) {
@@ -239,6 +338,7 @@ class HostDeviceVectorImpl {
     } else {
       LazyResizeDevice(Size());
       gpu_access_ = GPUAccess::kWrite;
+      host_pending_ = false;
       SetDevice();
       dh::safe_cuda(cudaMemcpyAsync(data_d_->data(), other->data_d_->data(),
                                     data_d_->size() * sizeof(T), cudaMemcpyDefault,
@@ -249,6 +349,7 @@ class HostDeviceVectorImpl {
   void CopyToDevice(const T* begin) {
     LazyResizeDevice(Size());
     gpu_access_ = GPUAccess::kWrite;
+    host_pending_ = false;
     SetDevice();
     dh::safe_cuda(cudaMemcpyAsync(data_d_->data(), begin, data_d_->size() * sizeof(T),
                                   cudaMemcpyDefault, dh::DefaultStream()));
@@ -403,6 +504,21 @@ void HostDeviceVector<T>::Resize(std::size_t new_size) {
   impl_->Resize(new_size);
 }
 
+template <typename T>
+void HostDeviceVector<T>::SetPinned(bool pinned) {
+  impl_->SetPinned(pinned);
+}
+
+template <typename T>
+void HostDeviceVector<T>::PrefetchToDevice() const {
+  impl_->PrefetchToDevice();
+}
+
+template <typename T>
+void HostDeviceVector<T>::PrefetchToHost() const {
+  impl_->PrefetchToHost();
+}
+
 template <typename T>
 void HostDeviceVector<T>::Resize(std::size_t new_size, T v) {
   impl_->Resize(new_size, v);
@@ -21,7 +21,7 @@
 #include <cctype>        // for tolower
 #include <cerrno>        // for errno
 #include <cstddef>       // for size_t
-#include <cstdint>       // for int32_t, uint32_t
+#include <cstdint>       // for int32_t, uint32_t, uintptr_t
 #include <cstring>       // for memcpy
 #include <filesystem>    // for filesystem, weakly_canonical
 #include <fstream>       // for ifstream
@@ -41,6 +41,15 @@
 #include <limits>  // for numeric_limits
 #endif
 
+#if defined(__linux__)
+#include <linux/mempolicy.h>  // for MPOL_INTERLEAVE, MPOL_F_MEMS_ALLOWED
+#include <sys/syscall.h>      // for SYS_mbind, SYS_get_mempolicy
+
+#include <array>   // for array
+#include <atomic>  // for atomic
+#include <bitset>  // for bitset
+#endif             // defined(__linux__)
+
 namespace xgboost::common {
 size_t PeekableInStream::Read(void* dptr, size_t size) {
   size_t nbuffer = buffer_.length() - buffer_ptr_;
@@ -255,6 +264,126 @@ void detail::CloseMmap(MMAPFile* handle) {
   delete handle;
 }
 
+HugePages ParseHugePages(StringView name) {
+  if (name == "none") {
+    return HugePages::kNone;
+  } else if (name == "transparent") {
+    return HugePages::kTransparent;
+  } else if (name == "explicit") {
+    return HugePages::kExplicit;
+  }
+  LOG(FATAL) << "Invalid value for `huge_pages`: " << name
+             << ". Expecting `none`, `transparent` or `explicit`.";
+  return HugePages::kNone;
+}
+
+namespace {
+std::atomic<HugePages> huge_pages{HugePages::kNone};
+std::atomic<bool> numa_interleave{false};
+
+#if defined(__linux__)
+// Interleave the pages of a mapping across the allowed NUMA nodes.
+void InterleavePages(void* ptr, std::size_t n_bytes) {
+  constexpr std::size_t kMaxNodes = 1024;
+  using Word = unsigned long;  // NOLINT
+  constexpr std::size_t kWordBits = sizeof(Word) * 8;
+  std::array<Word, kMaxNodes / kWordBits> nodes{};
+  std::int32_t mode{0};
+  if (syscall(SYS_get_mempolicy, &mode, nodes.data(), kMaxNodes, nullptr, MPOL_F_MEMS_ALLOWED) !=
+      0) {
+    return;
+  }
+  std::size_t n_nodes = 0;
+  for (auto w : nodes) {
+    n_nodes += std::bitset<kWordBits>{w}.count();
+  }
+  if (n_nodes < 2) {
+    return;
+  }
+  if (syscall(SYS_mbind, ptr, n_bytes, MPOL_INTERLEAVE, nodes.data(), kMaxNodes, 0) != 0) {
+    static std::atomic<bool> warned{false};
+    if (!warned.exchange(true)) {
+      LOG(WARNING) << "Failed to interleave memory across NUMA nodes: " << SystemErrorMsg();
+    }
+  }
+}
+#endif  // defined(__linux__)
+}  // anonymous namespace
+
+void SetLargeAllocPolicy(LargeAllocPolicy policy) {
+  huge_pages.store(policy.huge_pages);
+  numa_interleave.store(policy.numa_interleave);
+}
+
+LargeAllocPolicy GetLargeAllocPolicy() {
+  return LargeAllocPolicy{huge_pages.load(std::memory_order_relaxed),
+                          numa_interleave.load(std::memory_order_relaxed)};
+}
+
+void* detail::MapLarge(std::size_t n_bytes, LargeAllocPolicy policy, std::size_t* capacity) {
+#if defined(__linux__)
+  auto size = DivRoundUp(n_bytes, kHugePageSize) * kHugePageSize;
+  auto prot = PROT_READ | PROT_WRITE;
+  void* ptr = MAP_FAILED;
+  if (policy.huge_pages == HugePages::kExplicit) {
+    // Pages from the hugetlb pool are always aligned.
+    ptr = mmap(nullptr, size, prot, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (ptr == MAP_FAILED) {
+      static std::atomic<bool> warned{false};
+      if (!warned.exchange(true)) {
+        LOG(WARNING) << "Failed to allocate explicit huge pages, falling back to transparent "
+                        "huge pages: "
+                     << SystemErrorMsg();
+      }
+      policy.huge_pages = HugePages::kTransparent;
+    }
+  }
+  if (ptr == MAP_FAILED) {
+    // The kernel can only use huge pages for aligned ranges, over-allocate then trim both
+    // ends of the mapping.
+    auto padded = size + kHugePageSize;
+    auto* raw = mmap(nullptr, padded, prot, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+      LOG(FATAL) << "bad_malloc: Failed to allocate " << n_bytes << " bytes. "
+                 << SystemErrorMsg();
+    }
+    auto addr = reinterpret_cast<std::uintptr_t>(raw);
+    auto head = DivRoundUp(addr, kHugePageSize) * kHugePageSize - addr;
+    auto tail = padded - head - size;
+    ptr = reinterpret_cast<std::byte*>(raw) + head;
+    if (head != 0) {
+      CHECK_NE(munmap(raw, head), -1) << SystemErrorMsg();
+    }
+    if (tail != 0) {
+      CHECK_NE(munmap(reinterpret_cast<std::byte*>(ptr) + size, tail), -1) << SystemErrorMsg();
+    }
+    if (policy.huge_pages == HugePages::kTransparent) {
+      // Fails if THP is disabled, regular pages are used in that case.
+      madvise(ptr, size, MADV_HUGEPAGE);
+    }
+  }
+  if (policy.numa_interleave) {
+    InterleavePages(ptr, size);
+  }
+  *capacity = size;
+  return ptr;
+#else
+  (void)n_bytes;
+  (void)policy;
+  (void)capacity;
+  return nullptr;
+#endif  // defined(__linux__)
+}
+
+void detail::UnmapLarge(void* ptr, std::size_t capacity) noexcept(true) {
+#if defined(__linux__)
+  munmap(ptr, capacity);
+#else
+  (void)ptr;
+  (void)capacity;
+#endif  // defined(__linux__)
+}
+
 MmapResource::MmapResource(StringView path, std::size_t offset, std::size_t length)
     : ResourceHandler{kMmap},
       handle_{detail::OpenMmap(std::string{path}, offset, length), detail::CloseMmap},
@@ -16,6 +16,7 @@
 #include <algorithm>    // for min, fill_n, copy_n
 #include <array>        // for array
 #include <cstddef>      // for byte, size_t
+#include <cstdint>      // for uint8_t
 #include <cstdlib>      // for malloc, realloc, free
 #include <cstring>      // for memcpy
 #include <fstream>      // for ifstream
@@ -29,6 +30,7 @@
 
 #include "common.h"               // for DivRoundUp
 #include "dmlc/io.h"              // for SeekStream
+#include "memory_stats.h"         // for MemoryAccount
 #include "xgboost/string_view.h"  // for StringView
 
 namespace xgboost::common {
@@ -273,6 +275,52 @@ namespace detail {
 void CloseMmap(MMAPFile* handle);
 }  // namespace detail
 
+/**
+ * @brief Kind of pages used for large buffers allocated by @ref MallocResource.
+ */
+enum class HugePages : std::uint8_t {
+  kNone = 0,
+  // Advise the kernel to back the buffer with transparent huge pages.
+  kTransparent = 1,
+  // Use the pre-allocated huge pages, fall back to transparent huge pages if there's none.
+  kExplicit = 2,
+};
+
+[[nodiscard]] HugePages ParseHugePages(StringView name);
+
+/**
+ * @brief Process-wide policy for large buffers allocated by @ref MallocResource.
+ */
+struct LargeAllocPolicy {
+  HugePages huge_pages{HugePages::kNone};
+  // Interleave the pages across all allowed NUMA nodes.
+  bool numa_interleave{false};
+
+  [[nodiscard]] bool Enabled() const {
+    return huge_pages != HugePages::kNone || numa_interleave;
+  }
+};
+
+void SetLargeAllocPolicy(LargeAllocPolicy policy);
+[[nodiscard]] LargeAllocPolicy GetLargeAllocPolicy();
+
+namespace detail {
+// Size of a huge page on x86 and most aarch64 systems.
+constexpr std::size_t kHugePageSize = 2 * 1024 * 1024;
+/**
+ * @brief Map zero-initialized memory for a large buffer according to the policy.
+ *
+ *   The returned pointer is aligned to @ref kHugePageSize, and the size of the mapping is
+ *   rounded up to a multiple of it.
+ *
+ * @param capacity The size of the mapping.
+ *
+ * @return nullptr if mapping memory is not supported on this platform.
+ */
+[[nodiscard]] void* MapLarge(std::size_t n_bytes, LargeAllocPolicy policy, std::size_t* capacity);
+void UnmapLarge(void* ptr, std::size_t capacity) noexcept(true);
+}  // namespace detail
+
 /**
  * @brief Handler for one-shot resource. Unlike `std::pmr::*`, the resource handler is
  *        fixed once it's constructed. Users cannot use mutable operations like resize
@@ -339,14 +387,63 @@ class ResourceHandler {
   }
 };
 
+/**
+ * @brief Resource allocated from the system memory.
+ *
+ *   Buffers larger than a huge page are mapped according to the @ref LargeAllocPolicy
+ *   when the policy is enabled. A mapped buffer keeps its capacity when shrunk, so the
+ *   memory can be reused without new allocation when it grows again.
+ */
 class MallocResource : public ResourceHandler {
   void* ptr_{nullptr};
   std::size_t n_{0};
+  // Size of the mapping if the memory is obtained from `detail::MapLarge`, 0 for malloc.
+  std::size_t capacity_{0};
+  // Tagged by the scope that resizes the resource.
+  MemoryAccount account_;
 
   void Clear() noexcept(true) {
-    std::free(ptr_);
+    if (capacity_ != 0) {
+      detail::UnmapLarge(ptr_, capacity_);
+    } else {
+      std::free(ptr_);
+    }
     ptr_ = nullptr;
     n_ = 0;
+    capacity_ = 0;
+    account_.Update(0);
+  }
+  // Returns false if the buffer should be allocated by malloc.
+  [[nodiscard]] bool ResizeLarge(std::size_t n_bytes, std::byte init) {
+    auto* bytes = reinterpret_cast<std::byte*>(ptr_);
+    if (n_bytes <= capacity_) {
+      // Reuse the existing mapping.
+      if (n_bytes > n_) {
+        std::fill_n(bytes + n_, n_bytes - n_, init);
+      }
+      n_ = n_bytes;
+      return true;
+    }
+    auto policy = GetLargeAllocPolicy();
+    // A mapped buffer stays mapped even if the policy is disabled afterward.
+    if (capacity_ == 0 && (n_bytes < detail::kHugePageSize || !policy.Enabled())) {
+      return false;
+    }
+    std::size_t capacity{0};
+    auto* new_ptr = reinterpret_cast<std::byte*>(detail::MapLarge(n_bytes, policy, &capacity));
+    if (!new_ptr) {
+      return false;
+    }
+    std::copy_n(bytes, n_, new_ptr);
+    // The mapping is zero-initialized, avoid touching the pages before they are used.
+    if (init != std::byte{0}) {
+      std::fill_n(new_ptr + n_, n_bytes - n_, init);
+    }
+    this->Clear();
+    ptr_ = new_ptr;
+    n_ = n_bytes;
+    capacity_ = capacity;
+    return true;
   }
 
  public:
@@ -370,7 +467,10 @@ class MallocResource : public ResourceHandler {
       this->Clear();
       return;
     }
-
+    if (this->ResizeLarge(n_bytes, init)) {
+      account_.Update(n_);
+      return;
+    }
     // If realloc fails, we need to copy the data ourselves.
     bool need_copy{false};
     void* new_ptr{nullptr};
@@ -401,6 +501,7 @@ class MallocResource : public ResourceHandler {
 
     ptr_ = new_ptr;
     n_ = n_bytes;
+    account_.Update(n_);
   }
 };
 
@@ -3,6 +3,7 @@
  */
 #include "xgboost/json.h"
 
+#include <algorithm>         // for min
 #include <array>             // for array
 #include <cctype>            // for isdigit
 #include <cmath>             // for isinf, isnan
@@ -13,12 +14,16 @@
 #include <initializer_list>  // for initializer_list
 #include <iterator>          // for distance
 #include <limits>            // for numeric_limits
+#include <numeric>           // for accumulate
 #include <sstream>           // for operator<<, basic_ostream, operator&, ios, stringstream
 #include <system_error>      // for errc
+#include <type_traits>       // for conditional_t
+#include <vector>            // for vector
 
 #include "./math.h"                 // for CheckNAN
 #include "charconv.h"               // for to_chars, NumericLimits, from_chars, to_chars_result
 #include "common.h"                 // for EscapeU8
+#include "threading_utils.h"        // for ParallelFor
 #include "xgboost/base.h"           // for XGBOOST_EXPECT
 #include "xgboost/intrusive_ptr.h"  // for IntrusivePtr
 #include "xgboost/json_io.h"        // for JsonReader, UBJReader, UBJWriter, JsonWriter, ToBigEn...
@@ -27,10 +32,49 @@
 
 namespace xgboost {
 
+namespace {
+// Minimum number of elements for writing an array in parallel.
+constexpr std::size_t kMinParallelElements = 16;
+
+[[nodiscard]] bool UseParallelWrite(std::vector<Json> const& vec, std::int32_t n_threads) {
+  // Only arrays of objects are considered, small values are not worth the extra copy.
+  return n_threads > 1 && vec.size() >= kMinParallelElements && IsA<Object>(vec.front());
+}
+
+// Encode each element into its own buffer.
+template <typename Writer>
+[[nodiscard]] std::vector<std::vector<char>> WriteElements(std::vector<Json> const& vec,
+                                                           std::int32_t n_threads) {
+  std::vector<std::vector<char>> buffers(vec.size());
+  common::ParallelFor(vec.size(), n_threads, [&](auto i) {
+    Writer writer{&buffers[i]};
+    writer.Save(vec[i]);
+  });
+  return buffers;
+}
+
+void Append(std::vector<char> const& buffer, std::vector<char>* stream) {
+  stream->insert(stream->end(), buffer.cbegin(), buffer.cend());
+}
+}  // anonymous namespace
+
 void JsonWriter::Save(Json json) { json.Ptr()->Save(this); }
 
 void JsonWriter::Visit(JsonArray const* arr) {
-  this->WriteArray(arr, [](auto const& v) { return v; });
+  auto const& vec = arr->GetArray();
+  if (!UseParallelWrite(vec, n_threads_)) {
+    this->WriteArray(arr, [](auto const& v) { return v; });
+    return;
+  }
+  auto buffers = WriteElements<JsonWriter>(vec, n_threads_);
+  stream_->emplace_back('[');
+  for (std::size_t i = 0; i < buffers.size(); ++i) {
+    Append(buffers[i], stream_);
+    if (i != buffers.size() - 1) {
+      stream_->emplace_back(',');
+    }
+  }
+  stream_->emplace_back(']');
 }
 void JsonWriter::Visit(F32Array const* arr) {
   this->WriteArray(arr, [](float v) { return Json{v}; });
@@ -310,6 +354,13 @@ bool JsonNull::operator==(Value const& rhs) const {
 
 void JsonNull::Save(JsonWriter* writer) const { writer->Visit(this); }
 
+namespace detail {
+[[nodiscard]] IntrusivePtr<Value> const& NullValue() {
+  thread_local IntrusivePtr<Value> null{new JsonNull};
+  return null;
+}
+}  // namespace detail
+
 // Json Boolean
 bool JsonBoolean::operator==(Value const& rhs) const {
   if (!IsA<JsonBoolean>(&rhs)) { return false; }
@@ -491,13 +542,14 @@ Json JsonReader::ParseArray() {
 Json JsonReader::ParseObject() {
   GetConsecutiveChar('{');
 
-  Object::Map data;
+  // Sorted once all the items are parsed.
+  std::vector<Object::Map::value_type> data;
   SkipSpaces();
   auto ch = PeekNextChar();
 
   if (ch == '}') {
     GetConsecutiveChar('}');
-    return Json(std::move(data));
+    return Json{Object{}};
   }
 
   while (true) {
@@ -518,7 +570,7 @@ Json JsonReader::ParseObject() {
 
     Json value { Parse() };
 
-    data[get<String>(key)] = std::move(value);
+    data.emplace_back(std::move(get<String>(key)), std::move(value));
 
     ch = GetNextNonSpaceChar();
 
@@ -528,7 +580,7 @@ Json JsonReader::ParseObject() {
     }
   }
 
-  return Json(std::move(data));
+  return Json{Object{Object::Map{std::move(data)}}};
 }
 
 Json JsonReader::ParseNumber() {
@@ -678,20 +730,25 @@ Json Json::Load(JsonReader* reader) {
   return json;
 }
 
-void Json::Dump(Json json, std::string* str, std::ios::openmode mode) {
+void Json::Dump(Json json, std::string* str, std::ios::openmode mode, std::int32_t n_threads) {
   std::vector<char> buffer;
-  Dump(json, &buffer, mode);
+  Dump(json, &buffer, mode, n_threads);
   str->resize(buffer.size());
   std::copy(buffer.cbegin(), buffer.cend(), str->begin());
 }
 
-void Json::Dump(Json json, std::vector<char>* str, std::ios::openmode mode) {
+void Json::Dump(Json json, std::vector<char>* str, std::ios::openmode mode,
+                std::int32_t n_threads) {
   str->clear();
   if (mode & std::ios::binary) {
-    UBJWriter writer{str};
+    // Size the document first to write it without growing the buffer.
+    UBJSizer sizer{n_threads};
+    sizer.Save(json);
+    str->reserve(sizer.Size());
+    UBJWriter writer{str, n_threads};
     writer.Save(json);
   } else {
-    JsonWriter writer(str);
+    JsonWriter writer(str, n_threads);
     writer.Save(json);
   }
 }
@@ -770,18 +827,124 @@ std::string UBJReader::DecodeStr() {
   return str;
 }
 
+namespace {
+[[nodiscard]] std::size_t TypedArrayElementSize(JsonReader::Char type) {
+  switch (type) {
+    case 'i':
+    case 'U':
+      return 1;
+    case 'I':
+      return 2;
+    case 'd':
+    case 'l':
+      return 4;
+    case 'D':
+    case 'L':
+      return 8;
+    default:
+      LOG(FATAL) << "`" + std::string{static_cast<char>(type)} +  // NOLINT
+                        "` is not supported for typed array.";
+  }
+  return 0;
+}
+}  // anonymous namespace
+
+void UBJReader::SkipValue() {
+  auto skip = [this](std::size_t n_bytes) {
+    if (XGBOOST_EXPECT(raw_str_.size() - cursor_.Pos() < n_bytes, false)) {
+      Error("Unexpected end of input.");
+    }
+    cursor_.Forward(n_bytes);
+  };
+  auto read_length = [&] {
+    GetConsecutiveChar('L');
+    auto n = this->ReadPrimitive<std::int64_t>();
+    if (XGBOOST_EXPECT(cursor_.Pos() > raw_str_.size() || n < 0, false)) {
+      Error("Invalid length.");
+    }
+    return static_cast<std::size_t>(n);
+  };
+  auto skip_str = [&] { skip(read_length()); };
+
+  auto c = GetNextChar();
+  switch (c) {
+    case '{': {
+      while (PeekNextChar() != '}') {
+        skip_str();
+        this->SkipValue();
+      }
+      GetConsecutiveChar('}');
+      break;
+    }
+    case '[': {
+      auto marker = PeekNextChar();
+      if (marker == '$') {  // typed array
+        GetNextChar();
+        auto type = GetNextChar();
+        GetConsecutiveChar('#');
+        auto n = read_length();
+        auto size = TypedArrayElementSize(type);
+        if (XGBOOST_EXPECT(n > (raw_str_.size() - cursor_.Pos()) / size, false)) {
+          Error("Unexpected end of input.");
+        }
+        skip(n * size);
+      } else if (marker == '#') {  // array with length optimization
+        GetNextChar();
+        auto n = read_length();
+        for (std::size_t i = 0; i < n; ++i) {
+          this->SkipValue();
+        }
+      } else {
+        while (PeekNextChar() != ']') {
+          this->SkipValue();
+        }
+        GetConsecutiveChar(']');
+      }
+      break;
+    }
+    case 'Z':
+    case 'T':
+    case 'F':
+      break;
+    case 'i':
+    case 'U':
+    case 'C':
+      skip(1);
+      break;
+    case 'I':
+      skip(2);
+      break;
+    case 'd':
+    case 'l':
+      skip(4);
+      break;
+    case 'D':
+    case 'L':
+      skip(8);
+      break;
+    case 'S':
+      skip_str();
+      break;
+    case 'H':
+      LOG(FATAL) << "High precision number is not supported.";
+      break;
+    default:
+      Error("Unknown construct");
+  }
+}
+
 Json UBJReader::ParseObject() {
   auto marker = PeekNextChar();
-  Object::Map results;
+  std::vector<Object::Map::value_type> results;
 
   while (marker != '}') {
     auto str = this->DecodeStr();
-    results.emplace(str, this->Parse());
+    results.emplace_back(std::move(str), this->Parse());
     marker = PeekNextChar();
   }
 
   GetConsecutiveChar('}');
-  return Json{std::move(results)};
+  return Json{Object{Object::Map{std::move(results)}}};
 }
 
 Json UBJReader::Load() {
@@ -880,6 +1043,47 @@ void EncodeStr(std::vector<char>* stream, std::string const& string) {
   auto ptr = stream->data() + s;
   std::memcpy(ptr, string.data(), string.size());
 }
+
+// Copy the values into the output in big endian. Values are swapped in blocks through an
+// aligned buffer to let the compiler vectorise the loop.
+template <typename T>
+void CopyToBigEndian(T const* in, std::size_t n, char* out) {
+#if DMLC_LITTLE_ENDIAN
+  if constexpr (sizeof(T) != 1) {
+    using U = std::conditional_t<sizeof(T) == 2, std::uint16_t,
+                                 std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>>;
+    constexpr std::size_t kBlockSize = 256;
+    std::array<U, kBlockSize> block;
+    for (std::size_t i = 0; i < n; i += kBlockSize) {
+      auto n_values = std::min(kBlockSize, n - i);
+      std::memcpy(block.data(), in + i, n_values * sizeof(T));
+      for (std::size_t j = 0; j < n_values; ++j) {
+        block[j] = BuiltinBSwap(block[j]);
+      }
+      std::memcpy(out + i * sizeof(T), block.data(), n_values * sizeof(T));
+    }
+    return;
+  }
+#endif  // DMLC_LITTLE_ENDIAN
+  std::memcpy(out, in, n * sizeof(T));
+}
+
+// Size of an integer encoded by the UBJWriter, excluding the marker.
+[[nodiscard]] std::size_t IntegerBytes(Integer::Int i) {
+  if (i > std::numeric_limits<int8_t>::min() && i < std::numeric_limits<int8_t>::max()) {
+    return sizeof(std::int8_t);
+  } else if (i > std::numeric_limits<int16_t>::min() && i < std::numeric_limits<int16_t>::max()) {
+    return sizeof(std::int16_t);
+  } else if (i > std::numeric_limits<int32_t>::min() && i < std::numeric_limits<int32_t>::max()) {
+    return sizeof(std::int32_t);
+  }
+  return sizeof(std::int64_t);
+}
+
+// Size of a string with its length, excluding the marker.
+[[nodiscard]] std::size_t StrBytes(std::string const& string) {
+  return 1 + sizeof(std::int64_t) + string.size();
+}
 }  // anonymous namespace
 
 void UBJWriter::Visit(JsonArray const* arr) {
@@ -889,6 +1093,20 @@ void UBJWriter::Visit(JsonArray const* arr) {
   stream_->push_back('#');
   stream_->push_back('L');
   WritePrimitive(n, stream_);
+  if (UseParallelWrite(vec, n_threads_)) {
+    std::vector<std::vector<char>> buffers(vec.size());
+    common::ParallelFor(vec.size(), n_threads_, [&](auto i) {
+      UBJSizer sizer;
+      sizer.Save(vec[i]);
+      buffers[i].reserve(sizer.Size());
+      UBJWriter writer{&buffers[i]};
+      writer.Save(vec[i]);
+    });
+    for (auto const& buffer : buffers) {
+      Append(buffer, stream_);
+    }
+    return;
+  }
   for (auto const& v : vec) {
     this->Save(v);
   }
@@ -923,12 +1141,7 @@ void WriteTypedArray(JsonTypedArray<T, kind> const* arr, std::vector<char>* stre
   WritePrimitive(n, stream);
   auto s = stream->size();
   stream->resize(s + arr->Size() * sizeof(T));
-  auto const& vec = arr->GetArray();
-  for (int64_t i = 0; i < n; ++i) {
-    auto v = ToBigEndian(vec[i]);
-    std::memcpy(stream->data() + s, &v, sizeof(v));
-    s += sizeof(v);
-  }
+  CopyToBigEndian(arr->GetArray().data(), arr->Size(), stream->data() + s);
 }
 
 void UBJWriter::Visit(F32Array const* arr) { WriteTypedArray(arr, stream_); }
@@ -984,4 +1197,56 @@ void UBJWriter::Visit(JsonBoolean const* boolean) {
 }
 
 void UBJWriter::Save(Json json) { json.Ptr()->Save(this); }
+
+void UBJSizer::Visit(JsonArray const* arr) {
+  auto const& vec = arr->GetArray();
+  // [#L<n>
+  n_bytes_ += 3 + sizeof(std::int64_t);
+  if (UseParallelWrite(vec, n_threads_)) {
+    std::vector<std::size_t> n_bytes(vec.size());
+    common::ParallelFor(vec.size(), n_threads_, [&](auto i) {
+      UBJSizer sizer;
+      sizer.Save(vec[i]);
+      n_bytes[i] = sizer.Size();
+    });
+    n_bytes_ = std::accumulate(n_bytes.cbegin(), n_bytes.cend(), n_bytes_);
+    return;
+  }
+  for (auto const& v : vec) {
+    this->Save(v);
+  }
+}
+
+namespace {
+template <typename T, Value::ValueKind kind>
+[[nodiscard]] std::size_t TypedArrayBytes(JsonTypedArray<T, kind> const* arr) {
+  // [$<type>#L<n>
+  return 5 + sizeof(std::int64_t) + arr->Size() * sizeof(T);
+}
+}  // anonymous namespace
+
+void UBJSizer::Visit(F32Array const* arr) { n_bytes_ += TypedArrayBytes(arr); }
+void UBJSizer::Visit(F64Array const* arr) { n_bytes_ += TypedArrayBytes(arr); }
+void UBJSizer::Visit(I8Array const* arr) { n_bytes_ += TypedArrayBytes(arr); }
+void UBJSizer::Visit(U8Array const* arr) { n_bytes_ += TypedArrayBytes(arr); }
+void UBJSizer::Visit(I16Array const* arr) { n_bytes_ += TypedArrayBytes(arr); }
+void UBJSizer::Visit(I32Array const* arr) { n_bytes_ += TypedArrayBytes(arr); }
+void UBJSizer::Visit(I64Array const* arr) { n_bytes_ += TypedArrayBytes(arr); }
+
+void UBJSizer::Visit(JsonObject const* obj) {
+  // {}
+  n_bytes_ += 2;
+  for (auto const& value : obj->GetObject()) {
+    n_bytes_ += StrBytes(value.first);
+    this->Save(value.second);
+  }
+}
+
+void UBJSizer::Visit(JsonNumber const*) { n_bytes_ += 1 + sizeof(Number::Float); }
+void UBJSizer::Visit(JsonInteger const* num) { n_bytes_ += 1 + IntegerBytes(num->GetInteger()); }
+void UBJSizer::Visit(JsonNull const*) { n_bytes_ += 1; }
+void UBJSizer::Visit(JsonString const* str) { n_bytes_ += 1 + StrBytes(str->GetString()); }
+void UBJSizer::Visit(JsonBoolean const*) { n_bytes_ += 1; }
+
+void UBJSizer::Save(Json json) { json.Ptr()->Save(this); }
 }  // namespace xgboost
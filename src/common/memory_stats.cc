@@ -0,0 +1,128 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include "memory_stats.h"
+
+#include <algorithm>  // for max
+#include <sstream>    // for stringstream
+#include <string>     // for string
+
+#include "common.h"           // for HumanMemUnit
+#include "xgboost/json.h"     // for Json, Object, Integer
+#include "xgboost/logging.h"  // for LOG, ConsoleLogger
+
+namespace xgboost::common {
+StringView MemTagName(MemTag tag) {
+  switch (tag) {
+    case MemTag::kOther:
+      return "Other";
+    case MemTag::kSparsePage:
+      return "SparsePage";
+    case MemTag::kGradientIndex:
+      return "GHistIndexMatrix";
+    case MemTag::kColumnMatrix:
+      return "ColumnMatrix";
+    case MemTag::kHistogram:
+      return "Histogram";
+    case MemTag::kPredictionCache:
+      return "PredictionCache";
+    case MemTag::kGradient:
+      return "Gradient";
+    case MemTag::kPredictorBuffer:
+      return "PredictorBuffer";
+    case MemTag::kNumTags:
+      break;
+  }
+  LOG(FATAL) << "Unknown memory tag: " << static_cast<std::int32_t>(tag);
+  return "";
+}
+
+namespace {
+void FetchMax(std::atomic<std::int64_t>* p_peak, std::int64_t value) {
+  auto old = p_peak->load(std::memory_order_relaxed);
+  while (old < value && !p_peak->compare_exchange_weak(old, value, std::memory_order_relaxed)) {
+  }
+}
+}  // anonymous namespace
+
+void MemoryStats::RegisterAllocation(MemTag tag, std::size_t n_bytes) {
+  auto i = static_cast<std::size_t>(tag);
+  auto n = static_cast<std::int64_t>(n_bytes);
+  FetchMax(&peak_[i], current_[i].fetch_add(n, std::memory_order_relaxed) + n);
+  FetchMax(&total_peak_, total_.fetch_add(n, std::memory_order_relaxed) + n);
+}
+
+void MemoryStats::RegisterDeallocation(MemTag tag, std::size_t n_bytes) {
+  auto i = static_cast<std::size_t>(tag);
+  auto n = static_cast<std::int64_t>(n_bytes);
+  current_[i].fetch_sub(n, std::memory_order_relaxed);
+  total_.fetch_sub(n, std::memory_order_relaxed);
+}
+
+std::int64_t MemoryStats::CurrentBytes(MemTag tag) const {
+  return current_[static_cast<std::size_t>(tag)].load();
+}
+
+std::int64_t MemoryStats::PeakBytes(MemTag tag) const {
+  return peak_[static_cast<std::size_t>(tag)].load();
+}
+
+Json MemoryStats::ToJson() const {
+  Json out{Object{}};
+  auto entry = [](std::int64_t current, std::int64_t peak) {
+    Json jentry{Object{}};
+    jentry["current"] = Integer{current};
+    jentry["peak"] = Integer{peak};
+    return jentry;
+  };
+  for (std::size_t i = 0; i < kNumTags; ++i) {
+    auto name = MemTagName(static_cast<MemTag>(i));
+    out[std::string{name.c_str(), name.size()}] = entry(current_[i].load(), peak_[i].load());
+  }
+  out["Total"] = entry(total_.load(), total_peak_.load());
+  return out;
+}
+
+void MemoryStats::ResetPeak() {
+  for (std::size_t i = 0; i < kNumTags; ++i) {
+    peak_[i] = current_[i].load();
+  }
+  total_peak_ = total_.load();
+  logged_peak_ = 0;
+}
+
+void MemoryStats::Log() {
+  if (!ConsoleLogger::ShouldLog(ConsoleLogger::LV::kInfo)) {
+    return;
+  }
+  auto peak = total_peak_.load();
+  if (logged_peak_.exchange(peak) >= peak) {
+    return;
+  }
+  std::stringstream ss;
+  ss << "Host memory usage, current/peak:";
+  for (std::size_t i = 0; i < kNumTags; ++i) {
+    if (peak_[i].load() == 0) {
+      continue;
+    }
+    ss << " " << MemTagName(static_cast<MemTag>(i)) << ": "
+       << HumanMemUnit(static_cast<std::size_t>(std::max(current_[i].load(), std::int64_t{0})))
+       << "/" << HumanMemUnit(static_cast<std::size_t>(peak_[i].load())) << ",";
+  }
+  auto total = std::max(total_.load(), std::int64_t{0});
+  ss << " Total: " << HumanMemUnit(static_cast<std::size_t>(total)) << "/"
+     << HumanMemUnit(static_cast<std::size_t>(peak));
+  LOG(INFO) << ss.str();
+}
+
+MemoryStats& GlobalMemoryStats() {
+  // Leaked to outlive the buffers of other static objects.
+  static auto* stats = new MemoryStats;
+  return *stats;
+}
+
+MemTag& MemTagScope::Tag() {
+  static thread_local MemTag tag{MemTag::kOther};
+  return tag;
+}
+}  // namespace xgboost::common
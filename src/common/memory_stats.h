@@ -0,0 +1,150 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ *
+ * @brief Accounting of the host memory used by each subsystem.
+ */
+#ifndef XGBOOST_COMMON_MEMORY_STATS_H_
+#define XGBOOST_COMMON_MEMORY_STATS_H_
+
+#include <array>    // for array
+#include <atomic>   // for atomic
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int64_t, uint8_t
+
+#include "xgboost/string_view.h"  // for StringView
+
+namespace xgboost {
+class Json;
+
+namespace common {
+/**
+ * @brief The subsystem that owns a memory buffer.
+ */
+enum class MemTag : std::uint8_t {
+  kOther = 0,
+  kSparsePage,
+  kGradientIndex,
+  kColumnMatrix,
+  kHistogram,
+  kPredictionCache,
+  kGradient,
+  // Thread buffers of the CPU predictor.
+  kPredictorBuffer,
+  kNumTags,
+};
+
+[[nodiscard]] StringView MemTagName(MemTag tag);
+
+/**
+ * @brief Current and peak bytes for each tag. Thread safe.
+ *
+ *   Only the buffers with a @ref MemoryAccount are counted, which are the host vectors of
+ *   @ref HostDeviceVector in CPU builds, the malloc resources used by the @ref
+ *   RefResourceView and the thread buffers of the CPU predictor. Device memory is tracked
+ *   by the `dh::GlobalMemoryLogger` instead.
+ */
+class MemoryStats {
+  static constexpr auto kNumTags = static_cast<std::size_t>(MemTag::kNumTags);
+  // Use signed int to allow temporary under-flow.
+  std::array<std::atomic<std::int64_t>, kNumTags> current_{};
+  std::array<std::atomic<std::int64_t>, kNumTags> peak_{};
+  std::atomic<std::int64_t> total_{0};
+  std::atomic<std::int64_t> total_peak_{0};
+  // The total peak when the statistics were last logged.
+  std::atomic<std::int64_t> logged_peak_{0};
+
+ public:
+  void RegisterAllocation(MemTag tag, std::size_t n_bytes);
+  void RegisterDeallocation(MemTag tag, std::size_t n_bytes);
+
+  [[nodiscard]] std::int64_t CurrentBytes(MemTag tag) const;
+  [[nodiscard]] std::int64_t PeakBytes(MemTag tag) const;
+  [[nodiscard]] std::int64_t TotalPeakBytes() const { return total_peak_.load(); }
+  /**
+   * @brief The current and the peak bytes of each tag, along with the total.
+   */
+  [[nodiscard]] Json ToJson() const;
+  /**
+   * @brief Reset the peaks to the current usage.
+   */
+  void ResetPeak();
+  /**
+   * @brief Log the statistics at the info level if the total peak has grown since the last
+   *        time they were logged.
+   */
+  void Log();
+};
+
+[[nodiscard]] MemoryStats& GlobalMemoryStats();
+
+/**
+ * @brief Set the tag for the untagged buffers that are resized by the current thread during
+ *        the lifetime of this object.
+ */
+class MemTagScope {
+  MemTag prev_;
+
+  [[nodiscard]] static MemTag& Tag();
+
+ public:
+  explicit MemTagScope(MemTag tag) : prev_{Tag()} { Tag() = tag; }
+  ~MemTagScope() { Tag() = prev_; }
+
+  MemTagScope(MemTagScope const& that) = delete;
+  MemTagScope& operator=(MemTagScope const& that) = delete;
+
+  [[nodiscard]] static MemTag Current() { return Tag(); }
+};
+
+/**
+ * @brief The size of a buffer registered in the @ref GlobalMemoryStats. The owner of the
+ *        buffer calls @ref Update after the buffer is resized, the size is deregistered when
+ *        the account is destroyed.
+ *
+ *   A buffer without an explicit tag is accounted as `kOther` until it's resized within a
+ *   @ref MemTagScope, then it takes the tag of the scope along with its existing bytes. For
+ *   instance, the offset of a `SparsePage` is allocated when the page is created, but it's
+ *   tagged when the page is filled. Concurrent updates with the same size, like the ones
+ *   from readers of a buffer, are registered only once.
+ */
+class MemoryAccount {
+  std::atomic<MemTag> tag_{MemTag::kOther};
+  std::atomic<std::size_t> n_bytes_{0};
+
+ public:
+  MemoryAccount() = default;
+  explicit MemoryAccount(MemTag tag) : tag_{tag} {}
+  ~MemoryAccount() { this->Update(0); }
+
+  MemoryAccount(MemoryAccount const& that) = delete;
+  MemoryAccount& operator=(MemoryAccount const& that) = delete;
+
+  void Update(std::size_t n_bytes) {
+    if (n_bytes_.load(std::memory_order_relaxed) == n_bytes) {
+      return;
+    }
+    auto old = n_bytes_.exchange(n_bytes, std::memory_order_relaxed);
+    if (old == n_bytes) {
+      return;
+    }
+    auto tag = this->Tag();
+    auto scope = MemTagScope::Current();
+    if (tag == MemTag::kOther && scope != MemTag::kOther &&
+        tag_.compare_exchange_strong(tag, scope, std::memory_order_relaxed)) {
+      GlobalMemoryStats().RegisterDeallocation(MemTag::kOther, old);
+      GlobalMemoryStats().RegisterAllocation(scope, old);
+      tag = scope;
+    }
+    if (n_bytes > old) {
+      GlobalMemoryStats().RegisterAllocation(tag, n_bytes - old);
+    } else {
+      GlobalMemoryStats().RegisterDeallocation(tag, old - n_bytes);
+    }
+  }
+
+  [[nodiscard]] MemTag Tag() const { return tag_.load(std::memory_order_relaxed); }
+  [[nodiscard]] std::size_t Bytes() const { return n_bytes_.load(std::memory_order_relaxed); }
+};
+}  // namespace common
+}  // namespace xgboost
+#endif  // XGBOOST_COMMON_MEMORY_STATS_H_
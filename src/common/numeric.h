@@ -4,8 +4,6 @@
 #ifndef XGBOOST_COMMON_NUMERIC_H_
 #define XGBOOST_COMMON_NUMERIC_H_
 
-#include <dmlc/common.h>  // OMPException
-
 #include <algorithm>    // for max
 #include <cstddef>      // for size_t
 #include <cstdint>      // for int32_t
@@ -56,46 +54,30 @@ void PartialSum(int32_t n_threads, InIt begin, InIt end, T init, OutIt out_it) {
 
   size_t block_size = n / batch_threads;
 
-  dmlc::OMPException exc;
-#pragma omp parallel num_threads(batch_threads)
-  {
-#pragma omp for
-    for (omp_ulong tid = 0; tid < batch_threads; ++tid) {
-      exc.Run([&]() {
-        size_t ibegin = block_size * tid;
-        size_t iend = (tid == (batch_threads - 1) ? n : (block_size * (tid + 1)));
-
-        T running_sum = 0;
-        for (size_t ridx = ibegin; ridx < iend; ++ridx) {
-          running_sum += *(begin + ridx);
-          *(out_it + 1 + ridx) = running_sum;
-        }
-      });
-    }
+  ParallelFor(batch_threads, static_cast<std::int32_t>(batch_threads), [&](std::size_t tid) {
+    size_t ibegin = block_size * tid;
+    size_t iend = (tid == (batch_threads - 1) ? n : (block_size * (tid + 1)));
 
-#pragma omp single
-    {
-      exc.Run([&]() {
-        partial_sums[0] = init;
-        for (size_t i = 1; i < batch_threads; ++i) {
-          partial_sums[i] = partial_sums[i - 1] + *(out_it + i * block_size);
-        }
-      });
+    T running_sum = 0;
+    for (size_t ridx = ibegin; ridx < iend; ++ridx) {
+      running_sum += *(begin + ridx);
+      *(out_it + 1 + ridx) = running_sum;
     }
+  });
+
+  partial_sums[0] = init;
+  for (size_t i = 1; i < batch_threads; ++i) {
+    partial_sums[i] = partial_sums[i - 1] + *(out_it + i * block_size);
+  }
 
-#pragma omp for
-    for (omp_ulong tid = 0; tid < batch_threads; ++tid) {
-      exc.Run([&]() {
-        size_t ibegin = block_size * tid;
-        size_t iend = (tid == (batch_threads - 1) ? n : (block_size * (tid + 1)));
+  ParallelFor(batch_threads, static_cast<std::int32_t>(batch_threads), [&](std::size_t tid) {
+    size_t ibegin = block_size * tid;
+    size_t iend = (tid == (batch_threads - 1) ? n : (block_size * (tid + 1)));
 
-        for (size_t i = ibegin; i < iend; ++i) {
-          *(out_it + 1 + i) += partial_sums[tid];
-        }
-      });
+    for (size_t i = ibegin; i < iend; ++i) {
+      *(out_it + 1 + i) += partial_sums[tid];
     }
-  }
-  exc.Rethrow();
+  });
 }
 
 namespace cuda_impl {
@@ -117,7 +99,7 @@ V Reduce(Context const* ctx, It first, It second, V const& init) {
   std::size_t n = std::distance(first, second);
   auto n_threads = static_cast<std::size_t>(std::min(n, static_cast<std::size_t>(ctx->Threads())));
   common::MemStackAllocator<V, common::DefaultMaxThreads()> result_tloc(n_threads, init);
-  common::ParallelFor(n, n_threads, [&](auto i) { result_tloc[omp_get_thread_num()] += first[i]; });
+  common::ParallelFor(n, n_threads, [&](auto i) { result_tloc[common::ThreadIdx()] += first[i]; });
   auto result = std::accumulate(result_tloc.cbegin(), result_tloc.cbegin() + n_threads, init);
   return result;
 }
@@ -134,18 +116,13 @@ void Iota(Context const* ctx, It first, It last,
   auto n = std::distance(first, last);
   std::int32_t n_threads = ctx->Threads();
   const size_t block_size = n / n_threads + !!(n % n_threads);
-  dmlc::OMPException exc;
-#pragma omp parallel num_threads(n_threads)
-  {
-    exc.Run([&]() {
-      const size_t tid = omp_get_thread_num();
-      const size_t ibegin = tid * block_size;
-      const size_t iend = std::min(ibegin + block_size, static_cast<size_t>(n));
-      for (size_t i = ibegin; i < iend; ++i) {
-        first[i] = i + value;
-      }
-    });
-  }
+  ParallelRegion(n_threads, [&](std::size_t tid) {
+    const size_t ibegin = tid * block_size;
+    const size_t iend = std::min(ibegin + block_size, static_cast<size_t>(n));
+    for (size_t i = ibegin; i < iend; ++i) {
+      first[i] = i + value;
+    }
+  });
 }
 }  // namespace xgboost::common
 
@@ -18,7 +18,7 @@
 #include "../tree/sample_position.h"  // for SamplePosition
 #include "categorical.h"
 #include "column_matrix.h"
-#include "row_set.h"  // for RowSetCollection
+#include "row_set.h"  // for RowSetCollectionImpl
 #include "xgboost/context.h"
 #include "xgboost/tree_model.h"
 
@@ -28,7 +28,8 @@ namespace xgboost::common {
 // 1) Effective memory allocation for intermediate results for multi-thread work
 // 2) Merging partial results produced by threads into original row set (row_set_collection_)
 // BlockSize is template to enable memory alignment easily with C++11 'alignas()' feature
-template<size_t BlockSize>
+// RowIdxT is the type of the row indices, see RowSetCollectionImpl.
+template <size_t BlockSize, typename RowIdxT = bst_idx_t>
 class PartitionBuilder {
   using BitVector = RBitField8;
 
@@ -53,15 +54,19 @@ class PartitionBuilder {
   // on comparison of indexes values (idx_span) and split point (split_cond)
   // Handle dense columns
   // Analog of std::stable_partition, but in no-inplace manner
+  //
+  // The row index is written to both buffers and only the counter of the chosen side is
+  // incremented. The next row overwrites the other slot. This avoids a hard to predict
+  // branch for each row, as both buffers have the size of the range.
   template <bool default_left, bool any_missing, typename ColumnType, typename Predicate>
   std::pair<size_t, size_t> PartitionKernel(ColumnType* p_column,
-                                            common::Span<bst_idx_t const> row_indices,
-                                            common::Span<bst_idx_t> left_part,
-                                            common::Span<bst_idx_t> right_part,
+                                            common::Span<RowIdxT const> row_indices,
+                                            common::Span<RowIdxT> left_part,
+                                            common::Span<RowIdxT> right_part,
                                             bst_idx_t base_rowid, Predicate&& pred) {
     auto& column = *p_column;
-    bst_idx_t* p_left_part = left_part.data();
-    bst_idx_t* p_right_part = right_part.data();
+    RowIdxT* p_left_part = left_part.data();
+    RowIdxT* p_right_part = right_part.data();
     bst_idx_t nleft_elems = 0;
     bst_idx_t nright_elems = 0;
 
@@ -71,39 +76,37 @@ class PartitionBuilder {
     for (size_t i = 0; i < n_samples; ++i) {
       auto rid = p_row_indices[i];
       bst_bin_t const bin_id = column[rid - base_rowid];
+      bool go_left;
       if (any_missing && bin_id == ColumnType::kMissingId) {
-        if (default_left) {
-          p_left_part[nleft_elems++] = rid;
-        } else {
-          p_right_part[nright_elems++] = rid;
-        }
+        go_left = default_left;
       } else {
-        if (pred(rid, bin_id)) {
-          p_left_part[nleft_elems++] = rid;
-        } else {
-          p_right_part[nright_elems++] = rid;
-        }
+        go_left = pred(rid, bin_id);
       }
+      p_left_part[nleft_elems] = rid;
+      p_right_part[nright_elems] = rid;
+      nleft_elems += static_cast<bst_idx_t>(go_left);
+      nright_elems += static_cast<bst_idx_t>(!go_left);
     }
 
     return {nleft_elems, nright_elems};
   }
 
   template <typename Pred>
-  inline std::pair<size_t, size_t> PartitionRangeKernel(common::Span<const bst_idx_t> ridx,
-                                                        common::Span<bst_idx_t> left_part,
-                                                        common::Span<bst_idx_t> right_part,
+  inline std::pair<size_t, size_t> PartitionRangeKernel(common::Span<const RowIdxT> ridx,
+                                                        common::Span<RowIdxT> left_part,
+                                                        common::Span<RowIdxT> right_part,
                                                         Pred pred) {
-    bst_idx_t* p_left_part = left_part.data();
-    bst_idx_t* p_right_part = right_part.data();
+    RowIdxT* p_left_part = left_part.data();
+    RowIdxT* p_right_part = right_part.data();
     bst_idx_t nleft_elems = 0;
     bst_idx_t nright_elems = 0;
+    // Branchless, see PartitionKernel.
     for (auto row_id : ridx) {
-      if (pred(row_id)) {
-        p_left_part[nleft_elems++] = row_id;
-      } else {
-        p_right_part[nright_elems++] = row_id;
-      }
+      bool go_left = pred(row_id);
+      p_left_part[nleft_elems] = row_id;
+      p_right_part[nright_elems] = row_id;
+      nleft_elems += static_cast<bst_idx_t>(go_left);
+      nright_elems += static_cast<bst_idx_t>(!go_left);
     }
     return {nleft_elems, nright_elems};
   }
@@ -112,10 +115,10 @@ class PartitionBuilder {
   void Partition(const size_t node_in_set, std::vector<ExpandEntry> const& nodes,
                  const common::Range1d range, const bst_bin_t split_cond,
                  GHistIndexMatrix const& gmat, const common::ColumnMatrix& column_matrix,
-                 const RegTree& tree, bst_idx_t const* rid) {
-    common::Span<bst_idx_t const> rid_span{rid + range.begin(), rid + range.end()};
-    common::Span<bst_idx_t> left = GetLeftBuffer(node_in_set, range.begin(), range.end());
-    common::Span<bst_idx_t> right = GetRightBuffer(node_in_set, range.begin(), range.end());
+                 const RegTree& tree, RowIdxT const* rid) {
+    common::Span<RowIdxT const> rid_span{rid + range.begin(), rid + range.end()};
+    common::Span<RowIdxT> left = GetLeftBuffer(node_in_set, range.begin(), range.end());
+    common::Span<RowIdxT> right = GetRightBuffer(node_in_set, range.begin(), range.end());
     std::size_t nid = nodes[node_in_set].nid;
     bst_feature_t fid = tree.SplitIndex(nid);
     bool default_left = tree.DefaultLeft(nid);
@@ -164,15 +167,16 @@ class PartitionBuilder {
         }
       } else {
         CHECK_EQ(any_missing, true);
-        auto column =
-            column_matrix.SparseColumn<BinIdxType>(fid, rid_span.front() - gmat.base_rowid);
-        if (default_left) {
-          child_nodes_sizes = PartitionKernel<true, any_missing>(&column, rid_span, left, right,
-                                                                 gmat.base_rowid, pred_hist);
-        } else {
-          child_nodes_sizes = PartitionKernel<false, any_missing>(&column, rid_span, left, right,
-                                                                  gmat.base_rowid, pred_hist);
-        }
+        column_matrix.VisitSparseColumn<BinIdxType>(
+            fid, rid_span.front() - gmat.base_rowid, [&](auto& column) {
+              if (default_left) {
+                child_nodes_sizes = PartitionKernel<true, any_missing>(
+                    &column, rid_span, left, right, gmat.base_rowid, pred_hist);
+              } else {
+                child_nodes_sizes = PartitionKernel<false, any_missing>(
+                    &column, rid_span, left, right, gmat.base_rowid, pred_hist);
+              }
+            });
       }
     }
 
@@ -183,32 +187,30 @@ class PartitionBuilder {
     SetNRightElems(node_in_set, range.begin(), n_right);
   }
 
-  template <bool any_missing, typename ColumnType, typename Predicate>
-  void MaskKernel(ColumnType* p_column, common::Span<bst_idx_t const> row_indices,
+  template <bool any_missing, typename ColumnType, typename Predicate, typename BitIdx>
+  void MaskKernel(ColumnType* p_column, common::Span<RowIdxT const> row_indices,
                   bst_idx_t base_rowid, BitVector* decision_bits, BitVector* missing_bits,
-                  Predicate&& pred) {
+                  Predicate&& pred, BitIdx&& bit_idx) {
     auto& column = *p_column;
-    for (auto const row_id : row_indices) {
+    for (std::size_t k = 0; k < row_indices.size(); ++k) {
+      auto const row_id = row_indices[k];
       auto const bin_id = column[row_id - base_rowid];
       if (any_missing && bin_id == ColumnType::kMissingId) {
-        missing_bits->Set(row_id - base_rowid);
+        missing_bits->Set(bit_idx(k, row_id));
       } else if (pred(row_id, bin_id)) {
-        decision_bits->Set(row_id - base_rowid);
+        decision_bits->Set(bit_idx(k, row_id));
       }
     }
   }
 
-  /**
-   * @brief When data is split by column, we don't have all the features locally on the current
-   * worker, so we go through all the rows and mark the bit vectors on whether the decision is made
-   * to go right, or if the feature value used for the split is missing.
-   */
-  template <typename BinIdxType, bool any_missing, bool any_cat, typename ExpandEntry>
-  void MaskRows(const size_t node_in_set, std::vector<ExpandEntry> const& nodes,
-                const common::Range1d range, bst_bin_t split_cond, GHistIndexMatrix const& gmat,
-                const common::ColumnMatrix& column_matrix, const RegTree& tree,
-                bst_idx_t const* rid, BitVector* decision_bits, BitVector* missing_bits) {
-    common::Span<bst_idx_t const> rid_span{rid + range.begin(), rid + range.end()};
+  template <typename BinIdxType, bool any_missing, bool any_cat, typename ExpandEntry,
+            typename BitIdx>
+  void MaskRowsImpl(const size_t node_in_set, std::vector<ExpandEntry> const& nodes,
+                    const common::Range1d range, bst_bin_t split_cond,
+                    GHistIndexMatrix const& gmat, const common::ColumnMatrix& column_matrix,
+                    const RegTree& tree, RowIdxT const* rid, BitVector* decision_bits,
+                    BitVector* missing_bits, BitIdx&& bit_idx) {
+    common::Span<RowIdxT const> rid_span{rid + range.begin(), rid + range.end()};
     std::size_t nid = nodes[node_in_set].nid;
     bst_feature_t fid = tree.SplitIndex(nid);
     bool is_cat = tree.GetSplitTypes()[nid] == FeatureType::kCategorical;
@@ -216,7 +218,8 @@ class PartitionBuilder {
     auto const& cut_values = gmat.cut.Values();
 
     if (!column_matrix.IsInitialized()) {
-      for (auto row_id : rid_span) {
+      for (std::size_t k = 0; k < rid_span.size(); ++k) {
+        auto row_id = rid_span[k];
         auto gidx = gmat.GetGindex(row_id, fid);
         if (gidx > -1) {
           bool go_left;
@@ -226,10 +229,10 @@ class PartitionBuilder {
             go_left = cut_values[gidx] <= nodes[node_in_set].split.split_value;
           }
           if (go_left) {
-            decision_bits->Set(row_id - gmat.base_rowid);
+            decision_bits->Set(bit_idx(k, row_id));
           }
         } else {
-          missing_bits->Set(row_id - gmat.base_rowid);
+          missing_bits->Set(bit_idx(k, row_id));
         }
       }
     } else {
@@ -246,17 +249,48 @@ class PartitionBuilder {
       if (column_matrix.GetColumnType(fid) == xgboost::common::kDenseColumn) {
         auto column = column_matrix.DenseColumn<BinIdxType, any_missing>(fid);
         MaskKernel<any_missing>(&column, rid_span, gmat.base_rowid, decision_bits, missing_bits,
-                                pred_hist);
+                                pred_hist, bit_idx);
       } else {
         CHECK_EQ(any_missing, true);
-        auto column =
-            column_matrix.SparseColumn<BinIdxType>(fid, rid_span.front() - gmat.base_rowid);
-        MaskKernel<any_missing>(&column, rid_span, gmat.base_rowid, decision_bits, missing_bits,
-                                pred_hist);
+        column_matrix.VisitSparseColumn<BinIdxType>(
+            fid, rid_span.front() - gmat.base_rowid, [&](auto& column) {
+              MaskKernel<any_missing>(&column, rid_span, gmat.base_rowid, decision_bits,
+                                      missing_bits, pred_hist, bit_idx);
+            });
       }
     }
   }
 
+  /**
+   * @brief When data is split by column, we don't have all the features locally on the current
+   * worker, so we go through all the rows and mark the bit vectors on whether the decision is made
+   * to go right, or if the feature value used for the split is missing.
+   */
+  template <typename BinIdxType, bool any_missing, bool any_cat, typename ExpandEntry>
+  void MaskRows(const size_t node_in_set, std::vector<ExpandEntry> const& nodes,
+                const common::Range1d range, bst_bin_t split_cond, GHistIndexMatrix const& gmat,
+                const common::ColumnMatrix& column_matrix, const RegTree& tree,
+                RowIdxT const* rid, BitVector* decision_bits, BitVector* missing_bits) {
+    this->MaskRowsImpl<BinIdxType, any_missing, any_cat>(
+        node_in_set, nodes, range, split_cond, gmat, column_matrix, tree, rid, decision_bits,
+        missing_bits, [&](std::size_t, auto row_id) { return row_id - gmat.base_rowid; });
+  }
+  /**
+   * @brief Same as @ref MaskRows, but the bits are indexed by the position of the rows in
+   *        the node instead of the row index. Used by the worker that owns the split
+   *        feature when the data is split by column.
+   */
+  template <typename BinIdxType, bool any_missing, bool any_cat, typename ExpandEntry>
+  void MaskRowsByPosition(const size_t node_in_set, std::vector<ExpandEntry> const& nodes,
+                          const common::Range1d range, bst_bin_t split_cond,
+                          GHistIndexMatrix const& gmat, const common::ColumnMatrix& column_matrix,
+                          const RegTree& tree, RowIdxT const* rid, BitVector* decision_bits,
+                          BitVector* missing_bits) {
+    this->MaskRowsImpl<BinIdxType, any_missing, any_cat>(
+        node_in_set, nodes, range, split_cond, gmat, column_matrix, tree, rid, decision_bits,
+        missing_bits, [&](std::size_t k, auto) { return range.begin() + k; });
+  }
+
   /**
    * @brief Once we've aggregated the decision and missing bits from all the workers, we can then
    * use them to partition the rows accordingly.
@@ -264,11 +298,11 @@ class PartitionBuilder {
   template <typename ExpandEntry>
   void PartitionByMask(const size_t node_in_set, std::vector<ExpandEntry> const& nodes,
                        const common::Range1d range, GHistIndexMatrix const& gmat,
-                       const RegTree& tree, bst_idx_t const* rid, BitVector const& decision_bits,
+                       const RegTree& tree, RowIdxT const* rid, BitVector const& decision_bits,
                        BitVector const& missing_bits) {
-    common::Span<bst_idx_t const> rid_span(rid + range.begin(), rid + range.end());
-    common::Span<bst_idx_t> left = GetLeftBuffer(node_in_set, range.begin(), range.end());
-    common::Span<bst_idx_t> right = GetRightBuffer(node_in_set, range.begin(), range.end());
+    common::Span<RowIdxT const> rid_span(rid + range.begin(), rid + range.end());
+    common::Span<RowIdxT> left = GetLeftBuffer(node_in_set, range.begin(), range.end());
+    common::Span<RowIdxT> right = GetRightBuffer(node_in_set, range.begin(), range.end());
     std::size_t nid = nodes[node_in_set].nid;
     bool default_left = tree.DefaultLeft(nid);
 
@@ -291,6 +325,25 @@ class PartitionBuilder {
     SetNRightElems(node_in_set, range.begin(), n_right);
   }
 
+  /**
+   * @brief Partition the rows with the decisions from the worker that owns the split
+   *        feature. The i^th bit of `go_left` is the decision for the i^th row of the node.
+   */
+  void PartitionByDecision(const size_t node_in_set, const common::Range1d range,
+                           RowIdxT const* rid, BitVector const& go_left) {
+    common::Span<RowIdxT const> rid_span(rid + range.begin(), rid + range.end());
+    common::Span<RowIdxT> left = GetLeftBuffer(node_in_set, range.begin(), range.end());
+    common::Span<RowIdxT> right = GetRightBuffer(node_in_set, range.begin(), range.end());
+
+    // The kernel visits the rows in order.
+    auto pos = range.begin();
+    auto pred = [&](auto) { return go_left.Check(pos++); };
+    auto [n_left, n_right] = PartitionRangeKernel(rid_span, left, right, pred);
+
+    SetNLeftElems(node_in_set, range.begin(), n_left);
+    SetNRightElems(node_in_set, range.begin(), n_right);
+  }
+
   // allocate thread local memory, should be called for each specific task
   void AllocateForTask(size_t id) {
     if (mem_blocks_[id].get() == nullptr) {
@@ -300,12 +353,12 @@ class PartitionBuilder {
     }
   }
 
-  common::Span<bst_idx_t> GetLeftBuffer(int nid, size_t begin, size_t end) {
+  common::Span<RowIdxT> GetLeftBuffer(int nid, size_t begin, size_t end) {
     const size_t task_idx = GetTaskIdx(nid, begin);
     return { mem_blocks_.at(task_idx)->Left(), end - begin };
   }
 
-  common::Span<bst_idx_t> GetRightBuffer(int nid, size_t begin, size_t end) {
+  common::Span<RowIdxT> GetRightBuffer(int nid, size_t begin, size_t end) {
     const size_t task_idx = GetTaskIdx(nid, begin);
     return { mem_blocks_.at(task_idx)->Right(), end - begin };
   }
@@ -347,14 +400,14 @@ class PartitionBuilder {
     }
   }
 
-  void MergeToArray(bst_node_t nid, size_t begin, bst_idx_t* rows_indexes) {
+  void MergeToArray(bst_node_t nid, size_t begin, RowIdxT* rows_indexes) {
     size_t task_idx = GetTaskIdx(nid, begin);
 
-    bst_idx_t* left_result = rows_indexes + mem_blocks_[task_idx]->n_offset_left;
-    bst_idx_t* right_result = rows_indexes + mem_blocks_[task_idx]->n_offset_right;
+    RowIdxT* left_result = rows_indexes + mem_blocks_[task_idx]->n_offset_left;
+    RowIdxT* right_result = rows_indexes + mem_blocks_[task_idx]->n_offset_right;
 
-    bst_idx_t const* left = mem_blocks_[task_idx]->Left();
-    bst_idx_t const* right = mem_blocks_[task_idx]->Right();
+    RowIdxT const* left = mem_blocks_[task_idx]->Left();
+    RowIdxT const* right = mem_blocks_[task_idx]->Right();
 
     std::copy_n(left, mem_blocks_[task_idx]->n_left, left_result);
     std::copy_n(right, mem_blocks_[task_idx]->n_right, right_result);
@@ -366,8 +419,9 @@ class PartitionBuilder {
 
   // Copy row partitions into global cache for reuse in objective
   template <typename Invalidp>
-  void LeafPartition(Context const* ctx, RegTree const& tree, RowSetCollection const& row_set,
-                     Span<bst_node_t> position, Invalidp invalidp) const {
+  void LeafPartition(Context const* ctx, RegTree const& tree,
+                     RowSetCollectionImpl<RowIdxT> const& row_set, Span<bst_node_t> position,
+                     Invalidp invalidp) const {
     auto p_begin = row_set.Data()->data();
     // For each node, walk through all the samples that fall in this node.
     auto p_pos = position.data();
@@ -395,16 +449,16 @@ class PartitionBuilder {
     size_t n_offset_left;
     size_t n_offset_right;
 
-    bst_idx_t* Left() {
+    RowIdxT* Left() {
       return &left_data_[0];
     }
 
-    bst_idx_t* Right() {
+    RowIdxT* Right() {
       return &right_data_[0];
     }
    private:
-    bst_idx_t left_data_[BlockSize];
-    bst_idx_t right_data_[BlockSize];
+    RowIdxT left_data_[BlockSize];
+    RowIdxT right_data_[BlockSize];
   };
   std::vector<std::pair<size_t, size_t>> left_right_nodes_sizes_;
   std::vector<size_t> blocks_offsets_;
@@ -0,0 +1,242 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include "perf_counter.h"
+
+#include <chrono>   // for steady_clock, duration_cast, nanoseconds
+#include <cstdlib>  // for strtol
+#include <memory>   // for make_unique
+#include <utility>  // for move
+
+#include "xgboost/logging.h"  // for LOG
+
+#if defined(__linux__)
+#include <dirent.h>            // for opendir, readdir, closedir
+#include <linux/perf_event.h>  // for perf_event_attr, PERF_TYPE_HARDWARE
+#include <sys/syscall.h>       // for SYS_perf_event_open
+#include <unistd.h>            // for syscall, read, close
+
+#include <cstring>  // for memset
+#endif              // defined(__linux__)
+
+namespace xgboost::common {
+StringView PerfCounterName(PerfCounter counter) {
+  switch (counter) {
+    case PerfCounter::kCycles:
+      return "cycles";
+    case PerfCounter::kInstructions:
+      return "instructions";
+    case PerfCounter::kLLCMisses:
+      return "llc_misses";
+    case PerfCounter::kBranchMisses:
+      return "branch_misses";
+    case PerfCounter::kNumCounters:
+      break;
+  }
+  LOG(FATAL) << "Unknown performance counter: " << static_cast<std::int32_t>(counter);
+  return "";
+}
+
+namespace {
+constexpr std::size_t kNumCounters = static_cast<std::size_t>(PerfCounter::kNumCounters);
+// Used for estimating the memory bandwidth from the cache misses.
+constexpr std::uint64_t kCacheLineSize = 64;
+
+#if defined(__linux__)
+// Open a counter for a thread, returns -1 if the counter is not available.
+std::int32_t OpenCounter(PerfCounter counter, std::int32_t tid) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  switch (counter) {
+    case PerfCounter::kCycles:
+      attr.config = PERF_COUNT_HW_CPU_CYCLES;
+      break;
+    case PerfCounter::kInstructions:
+      attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+      break;
+    case PerfCounter::kLLCMisses:
+      attr.config = PERF_COUNT_HW_CACHE_MISSES;
+      break;
+    case PerfCounter::kBranchMisses:
+      attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+      break;
+    case PerfCounter::kNumCounters:
+      LOG(FATAL) << "Unknown performance counter.";
+  }
+  // Only the user space is counted, which is permitted by the default paranoid level.
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  // The counters are multiplexed when there are more events than hardware counters.
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  auto fd = syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0);
+  return static_cast<std::int32_t>(fd);
+}
+
+std::uint64_t ReadCounter(std::int32_t fd) {
+  struct {
+    std::uint64_t value;
+    std::uint64_t time_enabled;
+    std::uint64_t time_running;
+  } data;
+  if (read(fd, &data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) ||
+      data.time_running == 0) {
+    return 0;
+  }
+  if (data.time_running == data.time_enabled) {
+    return data.value;
+  }
+  // Scale the multiplexed counter to the running time.
+  return static_cast<std::uint64_t>(static_cast<double>(data.value) *
+                                    static_cast<double>(data.time_enabled) /
+                                    static_cast<double>(data.time_running));
+}
+#endif  // defined(__linux__)
+}  // anonymous namespace
+
+struct PerfCounters::ThreadCounters {
+  std::array<std::int32_t, kNumCounters> fds;
+
+  ThreadCounters() { fds.fill(-1); }
+  ~ThreadCounters() {
+#if defined(__linux__)
+    for (auto fd : fds) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+#endif  // defined(__linux__)
+  }
+};
+
+std::atomic<bool> PerfCounters::enabled_{false};
+
+PerfCounters::PerfCounters() {
+#if defined(__linux__)
+  for (std::size_t i = 0; i < kNumCounters; ++i) {
+    auto fd = OpenCounter(static_cast<PerfCounter>(i), 0);
+    supported_[i] = fd >= 0;
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+#endif  // defined(__linux__)
+}
+
+PerfCounters::~PerfCounters() = default;
+
+PerfCounters& PerfCounters::Get() {
+  static PerfCounters counters;
+  return counters;
+}
+
+void PerfCounters::Configure(bool enable) {
+  std::lock_guard guard{mu_};
+  if (!enable) {
+    enabled_.store(false);
+    return;
+  }
+  bool any = false;
+  for (auto v : supported_) {
+    any |= v;
+  }
+  if (!any) {
+    LOG(WARNING) << "Hardware performance counters are not available. They require Linux "
+                    "with a `perf_event_paranoid` level of 2 or less.";
+    return;
+  }
+  stats_.clear();
+  this->OpenThreadsUnlocked();
+  enabled_.store(true);
+}
+
+void PerfCounters::OpenThreadsUnlocked() {
+#if defined(__linux__)
+  // Threads might be created after the last sample, like the OpenMP thread pool.
+  auto* dir = opendir("/proc/self/task");
+  if (!dir) {
+    return;
+  }
+  while (auto* entry = readdir(dir)) {
+    char* end = nullptr;
+    auto tid = static_cast<std::int32_t>(std::strtol(entry->d_name, &end, 10));
+    if (end == entry->d_name || *end != '\0' || threads_.find(tid) != threads_.cend()) {
+      continue;
+    }
+    auto counters = std::make_unique<ThreadCounters>();
+    for (std::size_t i = 0; i < kNumCounters; ++i) {
+      if (supported_[i]) {
+        counters->fds[i] = OpenCounter(static_cast<PerfCounter>(i), tid);
+      }
+    }
+    threads_.emplace(tid, std::move(counters));
+  }
+  closedir(dir);
+#endif  // defined(__linux__)
+}
+
+PerfCounters::Sample PerfCounters::Read() {
+  Sample sample;
+  std::lock_guard guard{mu_};
+  this->OpenThreadsUnlocked();
+#if defined(__linux__)
+  // An exited thread keeps the final values.
+  for (auto const& kv : threads_) {
+    for (std::size_t i = 0; i < kNumCounters; ++i) {
+      auto fd = kv.second->fds[i];
+      if (fd >= 0) {
+        sample.values[i] += ReadCounter(fd);
+      }
+    }
+  }
+#endif  // defined(__linux__)
+  sample.time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch())
+                    .count();
+  return sample;
+}
+
+void PerfCounters::Add(std::string const& name, Sample const& begin, Sample const& end) {
+  std::lock_guard guard{mu_};
+  if (!Enabled()) {
+    return;
+  }
+  auto& stat = stats_[name];
+  stat.count++;
+  stat.total.time += end.time - begin.time;
+  for (std::size_t i = 0; i < kNumCounters; ++i) {
+    // A failed read of an exited thread can make the difference negative.
+    if (end.values[i] > begin.values[i]) {
+      stat.total.values[i] += end.values[i] - begin.values[i];
+    }
+  }
+}
+
+Json PerfCounters::Dump() {
+  std::lock_guard guard{mu_};
+  Json out{Object{}};
+  auto k_llc = static_cast<std::size_t>(PerfCounter::kLLCMisses);
+  for (auto const& kv : stats_) {
+    auto const& stat = kv.second;
+    Json phase{Object{}};
+    phase["count"] = Integer{static_cast<Integer::Int>(stat.count)};
+    auto elapsed = static_cast<double>(stat.total.time) / 1e9;
+    phase["elapsed"] = Number{elapsed};
+    for (std::size_t i = 0; i < kNumCounters; ++i) {
+      if (supported_[i]) {
+        auto name = PerfCounterName(static_cast<PerfCounter>(i));
+        auto value = static_cast<Integer::Int>(stat.total.values[i]);
+        phase[static_cast<std::string>(name)] = Integer{value};
+      }
+    }
+    if (supported_[k_llc] && elapsed > 0.0) {
+      // Lower bound of the memory traffic, the prefetched lines and writes are not counted.
+      auto bytes = static_cast<double>(stat.total.values[k_llc] * kCacheLineSize);
+      phase["bandwidth_gbps"] = Number{bytes / elapsed / 1e9};
+    }
+    out[kv.first] = std::move(phase);
+  }
+  return out;
+}
+}  // namespace xgboost::common
@@ -0,0 +1,122 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ *
+ * @brief Hardware performance counters for the phases measured by @ref Monitor.
+ */
+#ifndef XGBOOST_COMMON_PERF_COUNTER_H_
+#define XGBOOST_COMMON_PERF_COUNTER_H_
+
+#include <array>    // for array
+#include <atomic>   // for atomic
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int64_t, int32_t, uint64_t
+#include <map>      // for map
+#include <memory>   // for unique_ptr
+#include <mutex>    // for mutex
+#include <string>   // for string
+
+#include "xgboost/json.h"         // for Json
+#include "xgboost/string_view.h"  // for StringView
+
+namespace xgboost::common {
+/**
+ * @brief Counters collected for each phase.
+ */
+enum class PerfCounter : std::uint8_t {
+  kCycles = 0,
+  kInstructions,
+  // Last level cache misses, each miss is a cache line read from memory.
+  kLLCMisses,
+  kBranchMisses,
+  kNumCounters,
+};
+
+[[nodiscard]] StringView PerfCounterName(PerfCounter counter);
+
+/**
+ * @brief Process-wide collector of hardware counters using `perf_event_open`.
+ *
+ *   The counters are opened for every thread of the process, a sample is the sum of all
+ *   threads. As a result, the values of a phase include the work of other threads running
+ *   concurrently. Taking a sample costs a few system calls for each thread, it's meant for
+ *   coarse phases like the ones measured by @ref Monitor.
+ *
+ *   The collector is only available on Linux. Counters that are not supported by the
+ *   hardware, or not permitted by `perf_event_paranoid`, are omitted from the output.
+ */
+class PerfCounters {
+ public:
+  struct Sample {
+    // Wall clock time in nanoseconds.
+    std::int64_t time{0};
+    std::array<std::uint64_t, static_cast<std::size_t>(PerfCounter::kNumCounters)> values{};
+  };
+
+ private:
+  struct Stat {
+    std::size_t count{0};
+    Sample total;
+  };
+  struct ThreadCounters;
+
+  static std::atomic<bool> enabled_;
+  std::mutex mu_;
+  // Sorted by the thread ID.
+  std::map<std::int32_t, std::unique_ptr<ThreadCounters>> threads_;
+  // Accumulated values for each phase, keyed by `label::name`.
+  std::map<std::string, Stat> stats_;
+  // Counters that can be opened on this host.
+  std::array<bool, static_cast<std::size_t>(PerfCounter::kNumCounters)> supported_{};
+
+  void OpenThreadsUnlocked();
+
+ public:
+  PerfCounters();
+  ~PerfCounters();
+
+  [[nodiscard]] static PerfCounters& Get();
+  [[nodiscard]] static bool Enabled() { return enabled_.load(std::memory_order_relaxed); }
+  /**
+   * @brief Start or stop the collection. Starting the collection clears the existing
+   *        results.
+   */
+  void Configure(bool enable);
+  /** @brief Read the counters of all threads. */
+  [[nodiscard]] Sample Read();
+  /** @brief Accumulate the difference between two samples into a phase. */
+  void Add(std::string const& name, Sample const& begin, Sample const& end);
+  /**
+   * @brief Get the results for all phases. Each phase has the number of calls, the elapsed
+   *        time in seconds, the counter values and the estimated memory bandwidth.
+   */
+  [[nodiscard]] Json Dump();
+};
+
+/**
+ * @brief Collect the counters for a phase over the lifetime of this object. Unlike @ref
+ *        Monitor, it can be used by const and concurrent methods.
+ */
+class PerfScope {
+  char const* name_{nullptr};
+  PerfCounters::Sample begin_;
+
+ public:
+  // The name must outlive the scope, like a string literal.
+  explicit PerfScope(char const* name) {
+    if (PerfCounters::Enabled()) {
+      name_ = name;
+      begin_ = PerfCounters::Get().Read();
+    }
+  }
+  ~PerfScope() {
+    if (name_) {
+      auto& counters = PerfCounters::Get();
+      counters.Add(name_, begin_, counters.Read());
+    }
+  }
+
+  PerfScope(PerfScope const& that) = delete;
+  PerfScope& operator=(PerfScope const& that) = delete;
+};
+}  // namespace xgboost::common
+#endif  // XGBOOST_COMMON_PERF_COUNTER_H_
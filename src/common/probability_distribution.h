@@ -32,6 +32,17 @@ enum class ProbabilityDistributionType : int {
   kNormal = 0, kLogistic = 1, kExtreme = 2
 };
 
+/*!
+ * \brief PDF, CDF and the derivatives of the PDF evaluated at the same point. The values are
+ *        the same as calling the individual functions, but the exponentials are shared.
+ */
+struct DistributionValue {
+  double pdf;
+  double cdf;
+  double grad_pdf;
+  double hess_pdf;
+};
+
 struct NormalDistribution {
   XGBOOST_DEVICE static double PDF(double z) {
     return exp(-z * z / 2.0) / sqrt(2.0 * kPI);
@@ -49,6 +60,11 @@ struct NormalDistribution {
     return (z * z - 1.0) * PDF(z);
   }
 
+  XGBOOST_DEVICE static DistributionValue Eval(double z) {
+    const double pdf = PDF(z);
+    return {pdf, CDF(z), -z * pdf, (z * z - 1.0) * pdf};
+  }
+
   XGBOOST_DEVICE static ProbabilityDistributionType Type() {
     return ProbabilityDistributionType::kNormal;
   }
@@ -84,6 +100,19 @@ struct LogisticDistribution {
     }
   }
 
+  XGBOOST_DEVICE static DistributionValue Eval(double z) {
+    const double w = exp(z);
+    if (isinf(w)) {
+      return {0.0, 1.0, 0.0, 0.0};
+    }
+    const double sqrt_denominator = 1 + w;
+    const bool overflow = isinf(w * w);
+    const double pdf = overflow ? 0.0 : w / (sqrt_denominator * sqrt_denominator);
+    const double hess_pdf =
+        overflow ? 0.0 : pdf * (w * w - 4 * w + 1) / (sqrt_denominator * sqrt_denominator);
+    return {pdf, w / (1 + w), pdf * (1 - w) / (1 + w), hess_pdf};
+  }
+
   XGBOOST_DEVICE static ProbabilityDistributionType Type() {
     return ProbabilityDistributionType::kLogistic;
   }
@@ -114,6 +143,17 @@ struct ExtremeDistribution {
     }
   }
 
+  XGBOOST_DEVICE static DistributionValue Eval(double z) {
+    const double w = exp(z);
+    const double exp_neg_w = exp(-w);
+    if (isinf(w)) {
+      return {0.0, 1 - exp_neg_w, 0.0, 0.0};
+    }
+    const double pdf = w * exp_neg_w;
+    const double hess_pdf = isinf(w * w) ? 0.0 : (w * w - 3 * w + 1) * pdf;
+    return {pdf, 1 - exp_neg_w, (1 - w) * pdf, hess_pdf};
+  }
+
   XGBOOST_DEVICE static ProbabilityDistributionType Type() {
     return ProbabilityDistributionType::kExtreme;
   }
@@ -3,14 +3,20 @@
  */
 #include "quantile.h"
 
+#include <algorithm>  // for copy_n
+#include <cmath>      // for log, ceil, ldexp
+#include <cstdint>    // for uint32_t, int8_t
 #include <limits>
 #include <numeric>  // for partial_sum
 #include <utility>
 
 #include "../collective/aggregator.h"
+#include "../collective/allreduce.h"   // for RecursiveDoublingAllreduce
+#include "../collective/comm_group.h"  // for GlobalCommGroup
 #include "../common/error_msg.h"  // for InvalidMaxBin
 #include "../data/adapter.h"
 #include "categorical.h"
+#include "common.h"  // for DivRoundUp
 #include "hist_util.h"
 
 namespace xgboost::common {
@@ -34,6 +40,26 @@ SketchContainerImpl<WQSketch>::SketchContainerImpl(Context const *ctx,
   has_categorical_ = std::any_of(feature_types_.cbegin(), feature_types_.cend(), IsCatOp{});
 }
 
+bst_idx_t SketchSampleSize(double eps, double delta) {
+  CHECK(eps > 0.0 && eps < 1.0) << "Invalid rank error for the sketch sample: " << eps;
+  CHECK(delta > 0.0 && delta < 1.0);
+  return static_cast<bst_idx_t>(std::ceil(std::log(2.0 / delta) / (2.0 * eps * eps)));
+}
+
+template <typename WQSketch>
+void SketchContainerImpl<WQSketch>::SampleRows(bst_idx_t n_samples, double rank_eps) {
+  CHECK(rank_eps > 0.0 && rank_eps <= 1.0)
+      << "The rank error of the sketch sample must be in (0, 1], got: " << rank_eps;
+  CHECK_EQ(n_pushed_rows_, 0) << "The sample must be set before pushing data.";
+  auto n_sampled = SketchSampleSize(rank_eps / static_cast<double>(max_bins_));
+  if (n_samples <= n_sampled) {
+    return;
+  }
+  sample_rate_ = static_cast<double>(n_sampled) / static_cast<double>(n_samples);
+  sample_threshold_ = static_cast<std::uint64_t>(std::ldexp(sample_rate_, 64));
+  LOG(INFO) << "Sketching a sample of " << n_sampled << " rows out of " << n_samples << ".";
+}
+
 namespace {
 // Function to merge hessian and sample weights
 std::vector<float> MergeWeights(MetaInfo const &info, Span<float const> hessian, bool use_group,
@@ -101,8 +127,10 @@ void HostSketchContainer::PushAdapterBatch(Batch const &batch, size_t base_rowid
   // the data.
   auto is_dense = info.num_nonzero_ == info.num_col_ * info.num_row_;
   CHECK(!this->columns_size_.empty());
-  this->PushRowPageImpl(batch, base_rowid, weights, info.num_nonzero_, info.num_col_, is_dense,
-                        is_valid);
+  data::DispatchTypedBatch(batch, [&](auto const &typed) {
+    this->PushRowPageImpl(typed, base_rowid, weights, info.num_nonzero_, info.num_col_, is_dense,
+                          is_valid);
+  });
 }
 
 #define INSTANTIATE(_type)                                          \
@@ -215,6 +243,96 @@ void SketchContainerImpl<WQSketch>::GatherSketchInfo(
   }
 }
 
+template <typename WQSketch>
+void SketchContainerImpl<WQSketch>::AllreducePruned(
+    Context const *ctx, std::vector<int32_t> const &num_cuts,
+    std::vector<typename WQSketch::SummaryContainer> *p_reduced) {
+  using Entry = typename WQSketch::Entry;
+  using Summary = typename WQSketch::Summary;
+  auto &reduced = *p_reduced;
+  bst_feature_t n_columns = sketches_.size();
+  auto const &comm = collective::GlobalCommGroup()->Ctx(ctx, DeviceOrd::CPU());
+
+  // Features are merged in groups to bound the size of the buffer.
+  std::size_t constexpr kMaxGroupBytes = static_cast<std::size_t>(32) << 20;
+  auto n_cuts = [&](bst_feature_t fidx) {
+    return IsCat(feature_types_, fidx) ? static_cast<std::size_t>(0)
+                                       : static_cast<std::size_t>(num_cuts[fidx]);
+  };
+  bst_feature_t group_beg = 0;
+  while (group_beg < n_columns) {
+    bst_feature_t group_end = group_beg;
+    std::size_t n_entries = 0;
+    do {
+      n_entries += n_cuts(group_end);
+      ++group_end;
+    } while (group_end < n_columns &&
+             (n_entries + n_cuts(group_end)) * sizeof(Entry) <= kMaxGroupBytes);
+    auto n_features = group_end - group_beg;
+
+    /**
+     * The buffer starts with the size of each sketch, followed by a fixed slot of
+     * `num_cuts` entries for each feature. The layout is the same on all workers as the
+     * number of cuts is calculated from the global column sizes.
+     */
+    auto n_header = common::DivRoundUp(n_features * sizeof(std::uint32_t), sizeof(Entry));
+    std::vector<std::size_t> slot_ptr(n_features + 1, n_header);
+    for (bst_feature_t i = 0; i < n_features; ++i) {
+      slot_ptr[i + 1] = slot_ptr[i] + n_cuts(group_beg + i);
+    }
+    std::vector<Entry> buffer(slot_ptr.back());
+    auto sizes = reinterpret_cast<std::uint32_t *>(buffer.data());
+    for (bst_feature_t i = 0; i < n_features; ++i) {
+      auto const &sketch = reduced[group_beg + i];
+      if (n_cuts(group_beg + i) == 0 || sketch.size == 0) {
+        sizes[i] = 0;
+        continue;
+      }
+      CHECK_LE(sketch.size, n_cuts(group_beg + i));
+      sizes[i] = sketch.size;
+      std::copy_n(sketch.data, sketch.size, buffer.begin() + slot_ptr[i]);
+    }
+
+    auto op = [&](common::Span<std::int8_t const> lhs, common::Span<std::int8_t> out) {
+      auto lhs_entries = const_cast<Entry *>(reinterpret_cast<Entry const *>(lhs.data()));
+      auto lhs_sizes = reinterpret_cast<std::uint32_t const *>(lhs.data());
+      auto out_entries = reinterpret_cast<Entry *>(out.data());
+      auto out_sizes = reinterpret_cast<std::uint32_t *>(out.data());
+      ParallelFor(n_features, n_threads_, [&](auto i) {
+        auto max_size = slot_ptr[i + 1] - slot_ptr[i];
+        if (max_size == 0) {
+          return;
+        }
+        Summary a{lhs_entries + slot_ptr[i], lhs_sizes[i]};
+        Summary b{out_entries + slot_ptr[i], out_sizes[i]};
+        typename WQSketch::SummaryContainer combined;
+        combined.Reserve(a.size + b.size);
+        combined.SetCombine(a, b);
+        Summary result{out_entries + slot_ptr[i], 0};
+        result.SetPrune(combined, max_size);
+        out_sizes[i] = result.size;
+      });
+    };
+    auto erased = common::EraseType(common::Span{buffer.data(), buffer.size()});
+    auto rc = collective::cpu_impl::RecursiveDoublingAllreduce(comm, erased, op);
+    if (!rc.OK()) {
+      collective::SafeColl(collective::Fail("Failed to merge sketches.", std::move(rc)));
+    }
+
+    for (bst_feature_t i = 0; i < n_features; ++i) {
+      auto max_size = slot_ptr[i + 1] - slot_ptr[i];
+      if (max_size == 0) {
+        continue;
+      }
+      auto &sketch = reduced[group_beg + i];
+      sketch.Reserve(max_size);
+      sketch.size = sizes[i];
+      std::copy_n(buffer.cbegin() + slot_ptr[i], sizes[i], sketch.data);
+    }
+    group_beg = group_end;
+  }
+}
+
 template <typename WQSketch>
 void SketchContainerImpl<WQSketch>::AllreduceCategories(Context const* ctx, MetaInfo const& info) {
   auto world_size = collective::GetWorldSize();
@@ -322,6 +440,9 @@ void SketchContainerImpl<WQSketch>::AllReduce(
     } else {
       typename WQSketch::SummaryContainer out;
       sketches_[i].GetSummary(&out);
+      // The sketch is no longer needed after being summarized. Release it before the
+      // summaries from other workers are gathered to reduce the peak memory usage.
+      sketches_[i] = WQSketch{};
       reduced[i].Reserve(intermediate_num_cuts);
       CHECK(reduced[i].data);
       reduced[i].SetPrune(out, intermediate_num_cuts);
@@ -335,6 +456,14 @@ void SketchContainerImpl<WQSketch>::AllReduce(
     return;
   }
 
+  if (!collective::IsFederated()) {
+    this->AllreducePruned(ctx, num_cuts, &reduced);
+    monitor_.Stop(__func__);
+    return;
+  }
+
+  // The federated communicator doesn't support custom reduction operators, gather the
+  // sketches from all workers instead.
   std::vector<bst_idx_t> worker_segments(1, 0);  // CSC pointer to sketches.
   std::vector<bst_idx_t> sketches_scan((n_columns + 1) * world, 0);
 
@@ -468,8 +597,9 @@ HostSketchContainer::HostSketchContainer(Context const *ctx, bst_bin_t max_bins,
     n_bins = std::max(n_bins, static_cast<decltype(n_bins)>(1));
     auto eps = 1.0 / (static_cast<float>(n_bins) * WQSketch::kFactor);
     if (!IsCat(this->feature_types_, i)) {
+      // The input queue is allocated lazily by the sketch once the column has more than
+      // one distinct value.
       sketches_[i].Init(columns_size_[i], eps);
-      sketches_[i].inqueue.queue.resize(sketches_[i].limit_size * 2);
     }
   });
 }
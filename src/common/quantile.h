@@ -12,7 +12,9 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>  // for uint64_t
 #include <cstring>
+#include <limits>   // for numeric_limits
 #include <iostream>
 #include <set>
 #include <vector>
@@ -727,7 +729,7 @@ std::vector<bst_idx_t> CalcColumnSize(Batch const &batch, bst_feature_t const n_
   }
 
   ParallelFor(batch.Size(), n_threads, [&](omp_ulong i) {
-    auto &local_column_sizes = column_sizes_tloc.at(omp_get_thread_num());
+    auto &local_column_sizes = column_sizes_tloc.at(common::ThreadIdx());
     auto const &line = batch.GetLine(i);
     for (size_t j = 0; j < line.Size(); ++j) {
       auto elem = line.GetElement(j);
@@ -781,6 +783,32 @@ std::vector<bst_feature_t> LoadBalance(Batch const &batch, size_t nnz, bst_featu
   return cols_ptr;
 }
 
+/**
+ * @brief Probability that the rank error of a sampled sketch exceeds the requested bound.
+ */
+inline double constexpr kSketchSampleDelta = 1e-3;
+
+/**
+ * @brief Number of rows for a uniform row sample to be used in place of all rows in the
+ *        sketch. By the DKW inequality, the empirical CDF of every column computed from
+ *        this many rows is within `eps` of the CDF from all rows with a probability of at
+ *        least `1 - delta`. For weighted data, the bound applies to the effective number
+ *        of samples.
+ */
+[[nodiscard]] bst_idx_t SketchSampleSize(double eps, double delta = kSketchSampleDelta);
+
+/**
+ * @brief Hash of the row index for selecting the rows of the sample, the same rows are
+ *        kept for all the columns regardless of how the data is batched.
+ */
+[[nodiscard]] inline std::uint64_t SampleRowHash(std::uint64_t ridx) {
+  // The finalizer of splitmix64.
+  ridx += 0x9e3779b97f4a7c15ULL;
+  ridx = (ridx ^ (ridx >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  ridx = (ridx ^ (ridx >> 27)) * 0x94d049bb133111ebULL;
+  return ridx ^ (ridx >> 31);
+}
+
 /*!
  * A sketch matrix storing sketches for each feature.
  */
@@ -796,8 +824,15 @@ class SketchContainerImpl {
   bool use_group_ind_{false};
   int32_t n_threads_;
   bool has_categorical_{false};
+  // Rows with a hash greater than the threshold are excluded from the sketch.
+  std::uint64_t sample_threshold_{std::numeric_limits<std::uint64_t>::max()};
+  double sample_rate_{1.0};
+  // Number of rows pushed so far, used as the global index of the rows in the sample.
+  bst_idx_t n_pushed_rows_{0};
   Monitor monitor_;
 
+  [[nodiscard]] bool Sampling() const { return sample_rate_ < 1.0; }
+
  public:
   /* \brief Initialize necessary info.
    *
@@ -832,7 +867,27 @@ class SketchContainerImpl {
                         std::vector<bst_idx_t> *p_worker_segments,
                         std::vector<bst_idx_t> *p_sketches_scan,
                         std::vector<typename WQSketch::Entry> *p_global_sketches);
-  // Merge sketches from all workers.
+  // Merge the pruned sketches with a recursive doubling allreduce. Each step combines the
+  // sketches from a pair of workers and prunes the result back to the intermediate size.
+  void AllreducePruned(Context const *ctx, std::vector<int32_t> const &num_cuts,
+                       std::vector<typename WQSketch::SummaryContainer> *p_reduced);
+  /**
+   * @brief Sketch a uniform sample of the rows instead of all of them.
+   *
+   *   The sample is sized by @ref SketchSampleSize, such that the additional rank error
+   *   introduced by the sampling is less than `rank_eps / max_bin`, a fraction of the
+   *   width of a bin. No sample is taken if the data is smaller than the sample. Must be
+   *   called before any data is pushed.
+   *
+   * @param n_samples Total number of rows to be pushed into this container.
+   * @param rank_eps  Rank error relative to the bin width, in (0, 1].
+   */
+  void SampleRows(bst_idx_t n_samples, double rank_eps);
+  /** @brief The fraction of rows used for sketching. */
+  [[nodiscard]] double SampleRate() const { return sample_rate_; }
+
+  // Merge sketches from all workers. The local sketches are released once they are
+  // summarized, no data can be pushed afterward.
   void AllReduce(Context const *ctx, MetaInfo const &info,
                  std::vector<typename WQSketch::SummaryContainer> *p_reduced,
                  std::vector<int32_t> *p_num_cuts);
@@ -841,48 +896,54 @@ class SketchContainerImpl {
   void PushRowPageImpl(Batch const &batch, size_t base_rowid, OptionalWeights weights, size_t nnz,
                        size_t n_features, bool is_dense, IsValid is_valid) {
     auto thread_columns_ptr = LoadBalance(batch, nnz, n_features, n_threads_, is_valid);
+    // Rows of the sample, shared by all the threads.
+    std::vector<bst_idx_t> sampled;
+    if (this->Sampling()) {
+      for (bst_idx_t ridx = 0; ridx < batch.Size(); ++ridx) {
+        if (SampleRowHash(n_pushed_rows_ + ridx) <= sample_threshold_) {
+          sampled.push_back(ridx);
+        }
+      }
+    }
+    auto n_rows = this->Sampling() ? sampled.size() : batch.Size();
+    n_pushed_rows_ += batch.Size();
 
-    dmlc::OMPException exc;
-#pragma omp parallel num_threads(n_threads_)
-    {
-      exc.Run([&]() {
-        auto tid = static_cast<uint32_t>(omp_get_thread_num());
-        auto const begin = thread_columns_ptr[tid];
-        auto const end = thread_columns_ptr[tid + 1];
-
-        // do not iterate if no columns are assigned to the thread
-        if (begin < end && end <= n_features) {
-          for (size_t ridx = 0; ridx < batch.Size(); ++ridx) {
-            auto const &line = batch.GetLine(ridx);
-            auto w = weights[ridx + base_rowid];
-            if (is_dense) {
-              for (size_t ii = begin; ii < end; ii++) {
-                auto elem = line.GetElement(ii);
-                if (is_valid(elem)) {
-                  if (IsCat(feature_types_, ii)) {
-                    categories_[ii].emplace(elem.value);
-                  } else {
-                    sketches_[ii].Push(elem.value, w);
-                  }
+    ParallelRegion(n_threads_, [&](std::uint32_t tid) {
+      auto const begin = thread_columns_ptr[tid];
+      auto const end = thread_columns_ptr[tid + 1];
+
+      // do not iterate if no columns are assigned to the thread
+      if (begin < end && end <= n_features) {
+        for (size_t k = 0; k < n_rows; ++k) {
+          auto ridx = this->Sampling() ? sampled[k] : k;
+          auto const &line = batch.GetLine(ridx);
+          auto w = weights[ridx + base_rowid];
+          if (is_dense) {
+            for (size_t ii = begin; ii < end; ii++) {
+              auto elem = line.GetElement(ii);
+              if (is_valid(elem)) {
+                if (IsCat(feature_types_, ii)) {
+                  categories_[ii].emplace(elem.value);
+                } else {
+                  sketches_[ii].Push(elem.value, w);
                 }
               }
-            } else {
-              for (size_t i = 0; i < line.Size(); ++i) {
-                auto const &elem = line.GetElement(i);
-                if (is_valid(elem) && elem.column_idx >= begin && elem.column_idx < end) {
-                  if (IsCat(feature_types_, elem.column_idx)) {
-                    categories_[elem.column_idx].emplace(elem.value);
-                  } else {
-                    sketches_[elem.column_idx].Push(elem.value, w);
-                  }
+            }
+          } else {
+            for (size_t i = 0; i < line.Size(); ++i) {
+              auto const &elem = line.GetElement(i);
+              if (is_valid(elem) && elem.column_idx >= begin && elem.column_idx < end) {
+                if (IsCat(feature_types_, elem.column_idx)) {
+                  categories_[elem.column_idx].emplace(elem.value);
+                } else {
+                  sketches_[elem.column_idx].Push(elem.value, w);
                 }
               }
             }
           }
         }
-      });
-    }
-    exc.Rethrow();
+      }
+    });
   }
 
   /* \brief Push a CSR matrix. */
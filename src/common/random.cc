@@ -1,16 +1,71 @@
 /**
- * Copyright 2020-2023, XGBoost Contributors
+ * Copyright 2020-2025, XGBoost Contributors
  */
 #include "random.h"
 
-#include <algorithm>  // for sort, max, copy
+#include <algorithm>  // for sort, max, copy_n, nth_element, swap
+#include <cmath>      // for log
+#include <cstddef>    // for size_t
 #include <memory>     // for shared_ptr
+#include <numeric>    // for iota
 
 #include "xgboost/host_device_vector.h"  // for HostDeviceVector
 
 namespace xgboost::common {
+void ColumnSampler::SampleHost(std::vector<bst_feature_t> const& features,
+                               std::vector<bst_feature_t>* p_perm, std::size_t n,
+                               std::vector<bst_feature_t>* p_out) {
+  auto& out = *p_out;
+  if (!feature_weights_.Empty()) {
+    /*
+     * Original paper:
+     * Weighted Random Sampling (2005; Efraimidis, Spirakis)
+     *
+     * Blog:
+     * https://timvieira.github.io/blog/post/2019/09/16/algorithms-for-sampling-without-replacement/
+     *
+     * Only the n largest keys are needed, which are selected without sorting all the keys.
+     */
+    auto const& h_feature_weight = feature_weights_.ConstHostVector();
+    auto& keys = this->weight_buffer_.HostVector();
+    keys.resize(features.size());
+    std::uniform_real_distribution<float> dist;
+    auto& rng = GlobalRandom();
+    for (std::size_t i = 0; i < features.size(); ++i) {
+      auto w = std::max(h_feature_weight[features[i]], kRtEps);
+      keys[i] = std::log(dist(rng)) / w;
+    }
+    auto& idx = this->idx_buffer_.HostVector();
+    idx.resize(features.size());
+    std::iota(idx.begin(), idx.end(), 0);
+    // Break the ties with the index so the result doesn't depend on the implementation.
+    std::nth_element(idx.begin(), idx.begin() + (n - 1), idx.end(),
+                     [&](bst_feature_t l, bst_feature_t r) {
+                       return keys[l] > keys[r] || (keys[l] == keys[r] && l < r);
+                     });
+    out.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = features[idx[i]];
+    }
+  } else {
+    // Partial Fisher-Yates shuffle, only the first n elements of the permutation are drawn.
+    auto& perm = *p_perm;
+    if (perm.size() != features.size()) {
+      perm = features;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+      std::uniform_int_distribution<std::size_t> dist{i, perm.size() - 1};
+      std::swap(perm[i], perm[dist(rng_)]);
+    }
+    out.resize(n);
+    std::copy_n(perm.cbegin(), n, out.begin());
+  }
+  std::sort(out.begin(), out.end());
+}
+
 std::shared_ptr<HostDeviceVector<bst_feature_t>> ColumnSampler::ColSample(
-    std::shared_ptr<HostDeviceVector<bst_feature_t>> p_features, float colsample) {
+    std::shared_ptr<HostDeviceVector<bst_feature_t>> p_features, float colsample,
+    std::vector<bst_feature_t>* p_perm) {
   if (colsample == 1.0f) {
     return p_features;
   }
@@ -29,29 +84,12 @@ std::shared_ptr<HostDeviceVector<bst_feature_t>> ColumnSampler::ColSample(
 #endif  // defined(XGBOOST_USE_CUDA)
   }
 
-  const auto &features = p_features->HostVector();
+  const auto &features = p_features->ConstHostVector();
   CHECK_GT(features.size(), 0);
+  CHECK(ctx_);
 
-  auto &new_features = *p_new_features;
-
-  if (!feature_weights_.Empty()) {
-    auto const &h_features = p_features->HostVector();
-    auto const &h_feature_weight = feature_weights_.ConstHostVector();
-    auto &weight = this->weight_buffer_.HostVector();
-    weight.resize(h_features.size());
-    for (size_t i = 0; i < h_features.size(); ++i) {
-      weight[i] = h_feature_weight[h_features[i]];
-    }
-    CHECK(ctx_);
-    new_features.HostVector() =
-        WeightedSamplingWithoutReplacement(ctx_, p_features->HostVector(), weight, n);
-  } else {
-    new_features.Resize(features.size());
-    std::copy(features.begin(), features.end(), new_features.HostVector().begin());
-    std::shuffle(new_features.HostVector().begin(), new_features.HostVector().end(), rng_);
-    new_features.Resize(n);
-  }
-  std::sort(new_features.HostVector().begin(), new_features.HostVector().end());
+  std::vector<bst_feature_t> perm;
+  this->SampleHost(features, p_perm ? p_perm : &perm, n, &p_new_features->HostVector());
   return p_new_features;
 }
 }  // namespace xgboost::common
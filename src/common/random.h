@@ -82,38 +82,6 @@ using GlobalRandomEngine = RandomEngine;
  */
 GlobalRandomEngine& GlobalRandom(); // NOLINT(*)
 
-/*
- * Original paper:
- * Weighted Random Sampling (2005; Efraimidis, Spirakis)
- *
- * Blog:
- * https://timvieira.github.io/blog/post/2019/09/16/algorithms-for-sampling-without-replacement/
-*/
-template <typename T>
-std::vector<T> WeightedSamplingWithoutReplacement(Context const* ctx, std::vector<T> const& array,
-                                                  std::vector<float> const& weights, size_t n) {
-  // ES sampling.
-  CHECK_EQ(array.size(), weights.size());
-  std::vector<float> keys(weights.size());
-  std::uniform_real_distribution<float> dist;
-  auto& rng = GlobalRandom();
-  for (size_t i = 0; i < array.size(); ++i) {
-    auto w = std::max(weights.at(i), kRtEps);
-    auto u = dist(rng);
-    auto k = std::log(u) / w;
-    keys[i] = k;
-  }
-  auto ind = ArgSort<std::size_t>(ctx, keys.data(), keys.data() + keys.size(), std::greater<>{});
-  ind.resize(n);
-
-  std::vector<T> results(ind.size());
-  for (size_t k = 0; k < ind.size(); ++k) {
-    auto idx = ind[k];
-    results[k] = array[idx];
-  }
-  return results;
-}
-
 namespace cuda_impl {
 void SampleFeature(Context const* ctx, bst_feature_t n_features,
                    std::shared_ptr<HostDeviceVector<bst_feature_t>> p_features,
@@ -146,10 +114,25 @@ class ColumnSampler {
   // Used for weighted sampling.
   HostDeviceVector<bst_feature_t> idx_buffer_;
   HostDeviceVector<float> weight_buffer_;
+  // Permutations of the tree and the level feature sets reused by the CPU sampling. Any
+  // permutation of a feature set is a valid starting point for the partial shuffle, so
+  // the permutation is kept between calls instead of being copied from the feature set.
+  std::vector<bst_feature_t> tree_perm_;
+  std::map<int, std::vector<bst_feature_t>> level_perm_;
+
+  void SampleHost(std::vector<bst_feature_t> const& features, std::vector<bst_feature_t>* p_perm,
+                  std::size_t n, std::vector<bst_feature_t>* p_out);
 
  public:
+  /**
+   * @brief Sample a subset of the feature set.
+   *
+   * @param p_perm Optional CPU scratch buffer. It's either empty or a permutation of the
+   *               `p_features` from a previous call.
+   */
   std::shared_ptr<HostDeviceVector<bst_feature_t>> ColSample(
-      std::shared_ptr<HostDeviceVector<bst_feature_t>> p_features, float colsample);
+      std::shared_ptr<HostDeviceVector<bst_feature_t>> p_features, float colsample,
+      std::vector<bst_feature_t>* p_perm = nullptr);
   /**
    * @brief Column sampler constructor.
    * @note This constructor manually sets the rng seed
@@ -192,7 +175,16 @@ class ColumnSampler {
       std::iota(feature_set_tree_->HostVector().begin(), feature_set_tree_->HostVector().end(), 0);
     }
 
-    feature_set_tree_ = ColSample(feature_set_tree_, colsample_bytree_);
+    std::vector<bst_feature_t> perm;
+    feature_set_tree_ = ColSample(feature_set_tree_, colsample_bytree_, &perm);
+  }
+
+  /**
+   * @brief Features sampled for the current tree, a superset of the feature set of all
+   *        nodes in the tree.
+   */
+  [[nodiscard]] std::shared_ptr<HostDeviceVector<bst_feature_t> const> GetTreeFeatureSet() const {
+    return feature_set_tree_;
   }
 
   /**
@@ -201,6 +193,8 @@ class ColumnSampler {
   void Reset() {
     feature_set_tree_->Resize(0);
     feature_set_level_.clear();
+    tree_perm_.clear();
+    level_perm_.clear();
   }
 
   /**
@@ -221,14 +215,30 @@ class ColumnSampler {
 
     if (feature_set_level_.count(depth) == 0) {
       // Level sampling, level does not yet exist so generate it
-      feature_set_level_[depth] = ColSample(feature_set_tree_, colsample_bylevel_);
+      feature_set_level_[depth] = ColSample(feature_set_tree_, colsample_bylevel_, &tree_perm_);
     }
     if (colsample_bynode_ == 1.0f) {
       // Level sampling
       return feature_set_level_[depth];
     }
     // Need to sample for the node individually
-    return ColSample(feature_set_level_[depth], colsample_bynode_);
+    return ColSample(feature_set_level_[depth], colsample_bynode_, &level_perm_[depth]);
+  }
+  /**
+   * @brief Samples the feature sets for a batch of nodes, like all the nodes in an
+   *        expansion set.
+   *
+   *   Equivalent to calling @ref GetFeatureSet for each depth in order.
+   *
+   * @param depths     The tree depth of each node.
+   * @param p_features Output feature set for each node.
+   */
+  void GetFeatureSets(common::Span<bst_node_t const> depths,
+                      std::vector<std::shared_ptr<HostDeviceVector<bst_feature_t>>>* p_features) {
+    p_features->resize(depths.size());
+    for (std::size_t i = 0; i < depths.size(); ++i) {
+      (*p_features)[i] = this->GetFeatureSet(depths[i]);
+    }
   }
 };
 
@@ -3,13 +3,14 @@
  */
 #include "ranking_utils.h"
 
-#include <algorithm>          // for copy_n, max, min, none_of, all_of
+#include <algorithm>          // for max, min, none_of, all_of
 #include <cstddef>            // for size_t
 #include <cstdio>             // for sscanf
 #include <functional>         // for greater
+#include <numeric>            // for iota, accumulate
 #include <string>             // for char_traits, string
 
-#include "algorithm.h"        // for ArgSort
+#include "algorithm.h"        // for ArgSort, SegmentedArgSort
 #include "linalg_op.h"        // for cbegin, cend
 #include "optional_weight.h"  // for MakeOptionalWeights
 #include "threading_utils.h"  // for ParallelFor
@@ -34,8 +35,39 @@ void RankingCache::InitOnCPU(Context const* ctx, MetaInfo const& info) {
     max_group_size_ = std::max(max_group_size_, n);
   }
 
-  double sum_weights = 0;
   auto n_groups = Groups();
+  group_order_.resize(n_groups);
+  std::iota(group_order_.begin(), group_order_.end(), 0);
+  std::stable_sort(group_order_.begin(), group_order_.end(), [&](bst_group_t l, bst_group_t r) {
+    return gptr[l + 1] - gptr[l] > gptr[r + 1] - gptr[r];
+  });
+
+  if (!param_.HasTruncation() && info.labels.Size() != 0) {
+    // The labels don't change during training, the buckets of equal labels are used to
+    // sort the model rank list by label in a single pass.
+    auto h_label = info.labels.HostView().Slice(linalg::All(), 0);
+    label_bucket_.resize(h_label.Size());
+    bucket_gptr_.resize(n_groups + 1, 0);
+    for (bst_group_t g = 0; g < n_groups; ++g) {
+      auto g_label = h_label.Slice(linalg::Range(gptr[g], gptr[g + 1]));
+      auto sorted_idx = common::ArgSort<std::size_t>(ctx, linalg::cbegin(g_label),
+                                                     linalg::cend(g_label), std::greater<>{});
+      auto g_bucket = common::Span{label_bucket_}.subspan(gptr[g], g_label.Size());
+      std::uint32_t b = 0;
+      bucket_ptr_.push_back(0);
+      for (std::size_t i = 0; i < sorted_idx.size(); ++i) {
+        if (i != 0 && g_label(sorted_idx[i]) != g_label(sorted_idx[i - 1])) {
+          bucket_ptr_.push_back(i);
+          ++b;
+        }
+        g_bucket[sorted_idx[i]] = b;
+      }
+      bucket_ptr_.push_back(sorted_idx.size());
+      bucket_gptr_[g + 1] = bucket_ptr_.size();
+    }
+  }
+
+  double sum_weights = 0;
   auto weight = common::MakeOptionalWeights(ctx, info.weights_);
   for (bst_omp_uint k = 0; k < n_groups; ++k) {
     sum_weights += weight[k];
@@ -49,15 +81,7 @@ common::Span<std::size_t const> RankingCache::MakeRankOnCPU(Context const* ctx,
   auto rank = this->sorted_idx_cache_.HostSpan();
   CHECK_EQ(rank.size(), predt.size());
 
-  common::ParallelFor(this->Groups(), ctx->Threads(), [&](auto g) {
-    auto cnt = gptr[g + 1] - gptr[g];
-    auto g_predt = predt.subspan(gptr[g], cnt);
-    auto g_rank = rank.subspan(gptr[g], cnt);
-    auto sorted_idx = common::ArgSort<std::size_t>(
-        ctx, g_predt.data(), g_predt.data() + g_predt.size(), std::greater<>{});
-    CHECK_EQ(g_rank.size(), sorted_idx.size());
-    std::copy_n(sorted_idx.data(), sorted_idx.size(), g_rank.data());
-  });
+  common::SegmentedArgSort(ctx, predt, gptr, true, rank);
 
   return rank;
 }
@@ -124,10 +148,18 @@ void PreCache::InitOnCPU(Context const*, MetaInfo const& info) {
 void PreCache::InitOnCUDA(Context const*, MetaInfo const&) { common::AssertGPUSupport(); }
 #endif  // !defined(XGBOOST_USE_CUDA)
 
-void MAPCache::InitOnCPU(Context const*, MetaInfo const& info) {
+void MAPCache::InitOnCPU(Context const* ctx, MetaInfo const& info) {
   auto const& h_label = info.labels.HostView().Slice(linalg::All(), 0);
   CheckPreLabels("map", h_label,
                  [](auto beg, auto end, auto op) { return std::all_of(beg, end, op); });
+
+  auto gptr = this->DataGroupPtr(ctx);
+  auto& h_group_rel = group_rel_.HostVector();
+  h_group_rel.resize(this->Groups());
+  common::ParallelFor(this->Groups(), ctx->Threads(), [&](auto g) {
+    auto g_label = h_label.Slice(linalg::Range(gptr[g], gptr[g + 1]));
+    h_group_rel[g] = std::accumulate(linalg::cbegin(g_label), linalg::cend(g_label), 0.0);
+  });
 }
 
 #if !defined(XGBOOST_USE_CUDA)
@@ -13,6 +13,7 @@
 
 #include "dmlc/parameter.h"              // for FieldEntry, DMLC_DECLARE_FIELD
 #include "error_msg.h"                   // for GroupWeight, GroupSize, InvalidCUDAOrdinal
+#include "threading_utils.h"             // for ParallelFor, Sched
 #include "xgboost/base.h"                // for XGBOOST_DEVICE, bst_group_t
 #include "xgboost/context.h"             // for Context
 #include "xgboost/data.h"                // for MetaInfo
@@ -164,6 +165,15 @@ class RankingCache {
   HostDeviceVector<std::size_t> sorted_idx_cache_;
   // Maximum size of group
   std::size_t max_group_size_{0};
+  // Groups sorted by size in descending order, for balancing the CPU work between threads.
+  std::vector<bst_group_t> group_order_;
+  // Label bucket of each sample for the mean pair method. The buckets of a group are
+  // numbered in descending order of the label.
+  std::vector<std::uint32_t> label_bucket_;
+  // Offsets of the buckets of each group, the offsets of group g are in the range
+  // [bucket_gptr_[g], bucket_gptr_[g + 1]) of bucket_ptr_.
+  std::vector<std::size_t> bucket_ptr_;
+  std::vector<std::size_t> bucket_gptr_;
   // Normalization for weight
   double weight_norm_{1.0};
   /**
@@ -228,6 +238,34 @@ class RankingCache {
 
   [[nodiscard]] auto const& Param() const { return param_; }
   [[nodiscard]] std::size_t Groups() const { return group_ptr_.Size() - 1; }
+  /**
+   * @brief Run a function on each query group in parallel on CPU. The groups are
+   *        scheduled dynamically from the largest to the smallest, so that the threads
+   *        are balanced by the size of the groups instead of their count.
+   */
+  template <typename Fn>
+  void ParallelForGroups(Context const* ctx, Fn&& fn) const {
+    CHECK_EQ(group_order_.size(), this->Groups());
+    common::ParallelFor(group_order_.size(), ctx->Threads(), common::Sched::Dyn(),
+                        [&](std::size_t i) { fn(group_order_[i]); });
+  }
+  /**
+   * @brief The label bucket of each sample in a group, only available for the mean pair
+   *        method on CPU.
+   */
+  [[nodiscard]] common::Span<std::uint32_t const> LabelBucket(bst_group_t g) const {
+    CHECK(!label_bucket_.empty());
+    auto h_gptr = group_ptr_.ConstHostSpan();
+    return common::Span{label_bucket_}.subspan(h_gptr[g], h_gptr[g + 1] - h_gptr[g]);
+  }
+  /**
+   * @brief Offsets of the label buckets in a group.
+   */
+  [[nodiscard]] common::Span<std::size_t const> LabelBucketPtr(bst_group_t g) const {
+    CHECK(!bucket_gptr_.empty());
+    return common::Span{bucket_ptr_}.subspan(bucket_gptr_[g],
+                                             bucket_gptr_[g + 1] - bucket_gptr_[g]);
+  }
   [[nodiscard]] double WeightNorm() const { return weight_norm_; }
 
   // Create a rank list by model prediction
@@ -416,6 +454,9 @@ class MAPCache : public RankingCache {
   // \sum l_k/k
   HostDeviceVector<double> acc_;
   HostDeviceVector<double> map_;
+  // Total number of relevant documents in each group, the labels don't change between
+  // iterations.
+  HostDeviceVector<double> group_rel_;
   // Number of samples in this dataset.
   std::size_t n_samples_{0};
 
@@ -453,6 +494,14 @@ class MAPCache : public RankingCache {
     }
     return ctx->IsCUDA() ? map_.DeviceSpan() : map_.HostSpan();
   }
+  /**
+   * @brief Number of relevant documents in each group, only available on CPU.
+   */
+  [[nodiscard]] common::Span<double const> GroupRelevant(Context const* ctx) const {
+    CHECK(!ctx->IsCUDA());
+    CHECK_EQ(group_rel_.Size(), this->Groups());
+    return group_rel_.ConstHostSpan();
+  }
 };
 
 /**
@@ -8,7 +8,9 @@
 #define XGBOOST_COMMON_ROW_SET_H_
 
 #include <cstddef>   // for size_t
+#include <cstdint>   // for uint32_t
 #include <iterator>  // for distance
+#include <limits>    // for numeric_limits
 #include <vector>    // for vector
 
 #include "xgboost/base.h"     // for bst_node_t
@@ -17,14 +19,21 @@
 namespace xgboost::common {
 /**
  * @brief Collection of rows for each tree node.
+ *
+ * @tparam RowIdxT Type of the row indices. 32-bit indices halve the memory and bandwidth of
+ *                 the partitions when the number of rows fits in them, see
+ *                 @ref DispatchRowIdxType.
  */
-class RowSetCollection {
+template <typename RowIdxT>
+class RowSetCollectionImpl {
  public:
-  RowSetCollection() = default;
-  RowSetCollection(RowSetCollection const&) = delete;
-  RowSetCollection(RowSetCollection&&) = default;
-  RowSetCollection& operator=(RowSetCollection const&) = delete;
-  RowSetCollection& operator=(RowSetCollection&&) = default;
+  using RowIdxType = RowIdxT;
+
+  RowSetCollectionImpl() = default;
+  RowSetCollectionImpl(RowSetCollectionImpl const&) = delete;
+  RowSetCollectionImpl(RowSetCollectionImpl&&) = default;
+  RowSetCollectionImpl& operator=(RowSetCollectionImpl const&) = delete;
+  RowSetCollectionImpl& operator=(RowSetCollectionImpl&&) = default;
 
   /**
    * @brief data structure to store an instance set, a subset of rows (instances)
@@ -32,14 +41,14 @@ class RowSetCollection {
    */
   struct Elem {
    private:
-    bst_idx_t* begin_{nullptr};
-    bst_idx_t* end_{nullptr};
+    RowIdxT* begin_{nullptr};
+    RowIdxT* end_{nullptr};
 
    public:
     bst_node_t node_id{-1};
     // id of node associated with this instance set; -1 means uninitialized
     Elem() = default;
-    Elem(bst_idx_t* begin, bst_idx_t* end, bst_node_t node_id = -1)
+    Elem(RowIdxT* begin, RowIdxT* end, bst_node_t node_id = -1)
         : begin_(begin), end_(end), node_id(node_id) {}
 
     // Disable copy ctor to avoid casting away the constness via copy.
@@ -50,16 +59,16 @@ class RowSetCollection {
 
     [[nodiscard]] std::size_t Size() const { return std::distance(begin(), end()); }
 
-    [[nodiscard]] bst_idx_t const* begin() const { return this->begin_; }  // NOLINT
-    [[nodiscard]] bst_idx_t const* end() const { return this->end_; }      // NOLINT
-    [[nodiscard]] bst_idx_t* begin() { return this->begin_; }              // NOLINT
-    [[nodiscard]] bst_idx_t* end() { return this->end_; }                  // NOLINT
+    [[nodiscard]] RowIdxT const* begin() const { return this->begin_; }  // NOLINT
+    [[nodiscard]] RowIdxT const* end() const { return this->end_; }      // NOLINT
+    [[nodiscard]] RowIdxT* begin() { return this->begin_; }              // NOLINT
+    [[nodiscard]] RowIdxT* end() { return this->end_; }                  // NOLINT
   };
 
-  [[nodiscard]] std::vector<Elem>::const_iterator begin() const {  // NOLINT
+  [[nodiscard]] typename std::vector<Elem>::const_iterator begin() const {  // NOLINT
     return elem_of_each_node_.cbegin();
   }
-  [[nodiscard]] std::vector<Elem>::const_iterator end() const {  // NOLINT
+  [[nodiscard]] typename std::vector<Elem>::const_iterator end() const {  // NOLINT
     return elem_of_each_node_.cend();
   }
 
@@ -85,29 +94,29 @@ class RowSetCollection {
     CHECK(elem_of_each_node_.empty());
 
     if (row_indices_.empty()) {  // edge case: empty instance set
-      constexpr bst_idx_t* kBegin = nullptr;
-      constexpr bst_idx_t* kEnd = nullptr;
+      constexpr RowIdxT* kBegin = nullptr;
+      constexpr RowIdxT* kEnd = nullptr;
       static_assert(kEnd - kBegin == 0);
       elem_of_each_node_.emplace_back(kBegin, kEnd, 0);
       return;
     }
 
-    bst_idx_t* begin = row_indices_.data();
-    bst_idx_t* end = row_indices_.data() + row_indices_.size();
+    RowIdxT* begin = row_indices_.data();
+    RowIdxT* end = row_indices_.data() + row_indices_.size();
     elem_of_each_node_.emplace_back(begin, end, 0);
   }
 
-  [[nodiscard]] std::vector<bst_idx_t>* Data() { return &row_indices_; }
-  [[nodiscard]] std::vector<bst_idx_t> const* Data() const { return &row_indices_; }
+  [[nodiscard]] std::vector<RowIdxT>* Data() { return &row_indices_; }
+  [[nodiscard]] std::vector<RowIdxT> const* Data() const { return &row_indices_; }
 
   // split rowset into two
   void AddSplit(bst_node_t node_id, bst_node_t left_node_id, bst_node_t right_node_id,
                 bst_idx_t n_left, bst_idx_t n_right) {
     Elem& e = elem_of_each_node_[node_id];
 
-    bst_idx_t* all_begin{nullptr};
-    bst_idx_t* begin{nullptr};
-    bst_idx_t* end{nullptr};
+    RowIdxT* all_begin{nullptr};
+    RowIdxT* begin{nullptr};
+    RowIdxT* end{nullptr};
     if (e.begin() == nullptr) {
       CHECK_EQ(n_left, 0);
       CHECK_EQ(n_right, 0);
@@ -135,10 +144,24 @@ class RowSetCollection {
 
  private:
   // stores the row indexes in the set
-  std::vector<bst_idx_t> row_indices_;
+  std::vector<RowIdxT> row_indices_;
   // vector: node_id -> elements
   std::vector<Elem> elem_of_each_node_;
 };
+
+using RowSetCollection = RowSetCollectionImpl<bst_idx_t>;
+
+/**
+ * @brief Call the function with a 32-bit row index if all the (global) row indices fit
+ *        into it, otherwise with a 64-bit one.
+ */
+template <typename Fn>
+decltype(auto) DispatchRowIdxType(bst_idx_t n_samples, Fn&& fn) {
+  if (n_samples <= std::numeric_limits<std::uint32_t>::max()) {
+    return fn(std::uint32_t{});
+  }
+  return fn(bst_idx_t{});
+}
 }  // namespace xgboost::common
 
 #endif  // XGBOOST_COMMON_ROW_SET_H_
@@ -57,7 +57,7 @@ void Mean(Context const* ctx, linalg::Vector<float> const& v, linalg::Vector<flo
     float n = v.Size();
     MemStackAllocator<float, DefaultMaxThreads()> tloc(ctx->Threads(), 0.0f);
     ParallelFor(v.Size(), ctx->Threads(),
-                [&](auto i) { tloc[omp_get_thread_num()] += h_v(i) / n; });
+                [&](auto i) { tloc[common::ThreadIdx()] += h_v(i) / n; });
     auto ret = std::accumulate(tloc.cbegin(), tloc.cend(), .0f);
     out->HostView()(0) = ret;
   }
@@ -78,7 +78,7 @@ void SampleMean(Context const* ctx, bool is_column_split, linalg::Matrix<float>
     for (std::size_t j = 0; j < n_columns; ++j) {
       MemStackAllocator<double, DefaultMaxThreads()> mean_tloc(ctx->Threads(), 0.0);
       ParallelFor(v.Shape(0), ctx->Threads(),
-                  [&](auto i) { mean_tloc[omp_get_thread_num()] += (h_v(i, j) / n_rows_f64); });
+                  [&](auto i) { mean_tloc[common::ThreadIdx()] += (h_v(i, j) / n_rows_f64); });
       auto mean = std::accumulate(mean_tloc.cbegin(), mean_tloc.cend(), 0.0);
       h_out(j) = mean;
     }
@@ -103,7 +103,7 @@ void WeightedSampleMean(Context const* ctx, bool is_column_split, linalg::Matrix
     for (std::size_t j = 0; j < v.Shape(1); ++j) {
       MemStackAllocator<double, DefaultMaxThreads()> mean_tloc(ctx->Threads(), 0.0);
       ParallelFor(v.Shape(0), ctx->Threads(),
-                  [&](auto i) { mean_tloc[omp_get_thread_num()] += (h_v(i, j) / sum_w * h_w(i)); });
+                  [&](auto i) { mean_tloc[common::ThreadIdx()] += (h_v(i, j) / sum_w * h_w(i)); });
       auto mean = std::accumulate(mean_tloc.cbegin(), mean_tloc.cend(), 0.0);
       h_out(j) = mean;
     }
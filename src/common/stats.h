@@ -4,8 +4,10 @@
 #ifndef XGBOOST_COMMON_STATS_H_
 #define XGBOOST_COMMON_STATS_H_
 #include <algorithm>
+#include <cmath>     // for floor
 #include <iterator>  // for distance
 #include <limits>
+#include <utility>   // for pair
 #include <vector>
 
 #include "algorithm.h"        // for StableSort
@@ -108,6 +110,84 @@ float WeightedQuantile(Context const* ctx, double alpha, Iter begin, Iter end, W
   return val(idx);
 }
 
+/**
+ * @brief Same as @ref Quantile, but the order statistics are found by selection instead of
+ *        sorting the input. The result is identical.
+ *
+ * @param alpha  Quantile, must be in range [0, 1].
+ * @param values Input values, reordered by the function.
+ */
+inline float SelectQuantile(double alpha, Span<float> values) {
+  CHECK(alpha >= 0 && alpha <= 1);
+  auto n = static_cast<double>(values.size());
+  if (values.empty()) {
+    return std::numeric_limits<float>::quiet_NaN();
+  }
+  if (alpha <= (1 / (n + 1))) {
+    return *std::min_element(values.begin(), values.end());
+  }
+  if (alpha >= (n / (n + 1))) {
+    return *std::max_element(values.begin(), values.end());
+  }
+
+  double x = alpha * static_cast<double>((n + 1));
+  double k = std::floor(x) - 1;
+  CHECK_GE(k, 0);
+  double d = (x - 1) - k;
+
+  auto kth = values.begin() + static_cast<std::size_t>(k);
+  std::nth_element(values.begin(), kth, values.end());
+  auto v0 = *kth;
+  auto v1 = *std::min_element(kth + 1, values.end());
+  return v0 + d * (v1 - v0);
+}
+
+/**
+ * @brief Same as @ref WeightedQuantile, but the quantile is found by a weighted
+ *        quickselect instead of sorting the input. The weights are accumulated in double,
+ *        the result can differ from @ref WeightedQuantile when the float prefix sum used
+ *        there is rounded across the threshold.
+ *
+ * @param alpha  Quantile, must be in range [0, 1].
+ * @param values Pairs of value and weight, reordered by the function.
+ */
+inline float SelectWeightedQuantile(double alpha, Span<std::pair<float, float>> values) {
+  if (values.empty()) {
+    return std::numeric_limits<float>::quiet_NaN();
+  }
+  double total{0};
+  for (auto const& v : values) {
+    total += v.second;
+  }
+  // Find the first value in sorted order where the weighted CDF reaches the threshold.
+  double thresh = total * alpha;
+  if (thresh <= 0) {
+    return std::min_element(values.begin(), values.end(),
+                            [](auto const& l, auto const& r) { return l.first < r.first; })
+        ->first;
+  }
+  auto beg = values.begin();
+  auto end = values.end();
+  while (true) {
+    auto pivot = (beg + std::distance(beg, end) / 2)->first;
+    auto eq_beg = std::partition(beg, end, [&](auto const& v) { return v.first < pivot; });
+    // Not greater instead of equal, the range is never empty even if the pivot is NaN.
+    auto eq_end = std::partition(eq_beg, end, [&](auto const& v) { return !(pivot < v.first); });
+    double w_less{0}, w_eq{0};
+    std::for_each(beg, eq_beg, [&](auto const& v) { w_less += v.second; });
+    std::for_each(eq_beg, eq_end, [&](auto const& v) { w_eq += v.second; });
+    if (thresh <= w_less) {
+      end = eq_beg;
+    } else if (thresh <= w_less + w_eq || eq_end == end) {
+      // The second condition handles the rounding error when the threshold is the total.
+      return pivot;
+    } else {
+      thresh -= w_less + w_eq;
+      beg = eq_end;
+    }
+  }
+}
+
 namespace cuda_impl {
 void Median(Context const* ctx, linalg::TensorView<float const, 2> t, OptionalWeights weights,
             linalg::Tensor<float, 1>* out);
@@ -14,6 +14,7 @@
  * at https://arxiv.org/abs/2006.04920.
  */
 
+#include <xgboost/base.h>
 #include <xgboost/parameter.h>
 #include <memory>
 #include <algorithm>
@@ -127,111 +128,80 @@ struct AFTLoss {
     return cost;
   }
 
-  XGBOOST_DEVICE inline static
-  double Gradient(double y_lower, double y_upper, double y_pred, double sigma) {
+  /*!
+   * \brief Gradient and hessian of the loss. The distribution is evaluated once for each
+   *        bound, which is shared by the gradient and the hessian.
+   *
+   * \return The clipped gradient and hessian.
+   */
+  XGBOOST_DEVICE inline static GradientPairPrecise GradientHessian(double y_lower,
+                                                                   double y_upper,
+                                                                   double y_pred, double sigma) {
     const double log_y_lower = log(y_lower);
     const double log_y_upper = log(y_upper);
-    double numerator, denominator, gradient;  // numerator and denominator of gradient
+    // numerators and denominators of gradient and hessian
+    double grad_numerator, grad_denominator, hess_numerator, hess_denominator;
     CensoringType censor_type;
     bool z_sign;  // sign of z-score
 
     if (y_lower == y_upper) {  // uncensored
       const double z = (log_y_lower - y_pred) / sigma;
-      const double pdf = Distribution::PDF(z);
-      const double grad_pdf = Distribution::GradPDF(z);
+      const auto v = Distribution::Eval(z);
       censor_type = CensoringType::kUncensored;
-      numerator = grad_pdf;
-      denominator = sigma * pdf;
+      grad_numerator = v.grad_pdf;
+      grad_denominator = sigma * v.pdf;
+      hess_numerator = -(v.pdf * v.hess_pdf - v.grad_pdf * v.grad_pdf);
+      hess_denominator = sigma * sigma * v.pdf * v.pdf;
       z_sign = (z > 0);
     } else {  // censored; now check what type of censorship we have
-      double z_u = 0.0, z_l = 0.0, pdf_u, pdf_l, cdf_u, cdf_l;
+      double z_u = 0.0, z_l = 0.0;
+      DistributionValue v_u, v_l;
       censor_type = CensoringType::kIntervalCensored;
       if (isinf(y_upper)) {  // right-censored
-        pdf_u = 0;
-        cdf_u = 1;
+        v_u = {0.0, 1.0, 0.0, 0.0};
         censor_type = CensoringType::kRightCensored;
       } else {  // interval-censored or left-censored
         z_u = (log_y_upper - y_pred) / sigma;
-        pdf_u = Distribution::PDF(z_u);
-        cdf_u = Distribution::CDF(z_u);
+        v_u = Distribution::Eval(z_u);
       }
       if (y_lower <= 0.0) {  // left-censored
-        pdf_l = 0;
-        cdf_l = 0;
+        v_l = {0.0, 0.0, 0.0, 0.0};
         censor_type = CensoringType::kLeftCensored;
       } else {  // interval-censored or right-censored
         z_l = (log_y_lower - y_pred) / sigma;
-        pdf_l = Distribution::PDF(z_l);
-        cdf_l = Distribution::CDF(z_l);
+        v_l = Distribution::Eval(z_l);
       }
+      const double cdf_diff = v_u.cdf - v_l.cdf;
+      const double pdf_diff = v_u.pdf - v_l.pdf;
+      const double grad_diff = v_u.grad_pdf - v_l.grad_pdf;
+      const double sqrt_denominator = sigma * cdf_diff;
       z_sign = (z_u > 0 || z_l > 0);
-      numerator = pdf_u - pdf_l;
-      denominator = sigma * (cdf_u - cdf_l);
+      grad_numerator = pdf_diff;
+      grad_denominator = sqrt_denominator;
+      hess_numerator = -(cdf_diff * grad_diff - pdf_diff * pdf_diff);
+      hess_denominator = sqrt_denominator * sqrt_denominator;
     }
-    gradient = numerator / denominator;
-    if (denominator < aft::kEps && (isnan(gradient) || isinf(gradient))) {
+    double gradient = grad_numerator / grad_denominator;
+    if (grad_denominator < aft::kEps && (isnan(gradient) || isinf(gradient))) {
       gradient = aft::GetLimitGradAtInfPred<Distribution>(censor_type, z_sign, sigma);
     }
+    double hessian = hess_numerator / hess_denominator;
+    if (hess_denominator < aft::kEps && (isnan(hessian) || isinf(hessian))) {
+      hessian = aft::GetLimitHessAtInfPred<Distribution>(censor_type, z_sign, sigma);
+    }
 
-    return aft::Clip(gradient, aft::kMinGradient, aft::kMaxGradient);
+    return {aft::Clip(gradient, aft::kMinGradient, aft::kMaxGradient),
+            aft::Clip(hessian, aft::kMinHessian, aft::kMaxHessian)};
   }
 
   XGBOOST_DEVICE inline static
-  double Hessian(double y_lower, double y_upper, double y_pred, double sigma) {
-    const double log_y_lower = log(y_lower);
-    const double log_y_upper = log(y_upper);
-    double numerator, denominator, hessian;  // numerator and denominator of hessian
-    CensoringType censor_type;
-    bool z_sign;  // sign of z-score
-
-    if (y_lower == y_upper) {  // uncensored
-      const double z = (log_y_lower - y_pred) / sigma;
-      const double pdf = Distribution::PDF(z);
-      const double grad_pdf = Distribution::GradPDF(z);
-      const double hess_pdf = Distribution::HessPDF(z);
-      censor_type = CensoringType::kUncensored;
-      numerator = -(pdf * hess_pdf - grad_pdf * grad_pdf);
-      denominator = sigma * sigma * pdf * pdf;
-      z_sign = (z > 0);
-    } else {  // censored; now check what type of censorship we have
-      double z_u = 0.0, z_l = 0.0, grad_pdf_u, grad_pdf_l, pdf_u, pdf_l, cdf_u, cdf_l;
-      censor_type = CensoringType::kIntervalCensored;
-      if (isinf(y_upper)) {  // right-censored
-        pdf_u = 0;
-        cdf_u = 1;
-        grad_pdf_u = 0;
-        censor_type = CensoringType::kRightCensored;
-      } else {  // interval-censored or left-censored
-        z_u = (log_y_upper - y_pred) / sigma;
-        pdf_u = Distribution::PDF(z_u);
-        cdf_u = Distribution::CDF(z_u);
-        grad_pdf_u = Distribution::GradPDF(z_u);
-      }
-      if (y_lower <= 0.0) {  // left-censored
-        pdf_l = 0;
-        cdf_l = 0;
-        grad_pdf_l = 0;
-        censor_type = CensoringType::kLeftCensored;
-      } else {  // interval-censored or right-censored
-        z_l = (log_y_lower - y_pred) / sigma;
-        pdf_l = Distribution::PDF(z_l);
-        cdf_l = Distribution::CDF(z_l);
-        grad_pdf_l = Distribution::GradPDF(z_l);
-      }
-      const double cdf_diff = cdf_u - cdf_l;
-      const double pdf_diff = pdf_u - pdf_l;
-      const double grad_diff = grad_pdf_u - grad_pdf_l;
-      const double sqrt_denominator = sigma * cdf_diff;
-      z_sign = (z_u > 0 || z_l > 0);
-      numerator = -(cdf_diff * grad_diff - pdf_diff * pdf_diff);
-      denominator = sqrt_denominator * sqrt_denominator;
-    }
-    hessian = numerator / denominator;
-    if (denominator < aft::kEps && (isnan(hessian) || isinf(hessian))) {
-      hessian = aft::GetLimitHessAtInfPred<Distribution>(censor_type, z_sign, sigma);
-    }
+  double Gradient(double y_lower, double y_upper, double y_pred, double sigma) {
+    return GradientHessian(y_lower, y_upper, y_pred, sigma).GetGrad();
+  }
 
-    return aft::Clip(hessian, aft::kMinHessian, aft::kMaxHessian);
+  XGBOOST_DEVICE inline static
+  double Hessian(double y_lower, double y_upper, double y_pred, double sigma) {
+    return GradientHessian(y_lower, y_upper, y_pred, sigma).GetHess();
   }
 };
 
@@ -4,6 +4,7 @@
 #include "threading_utils.h"
 
 #include <algorithm>   // for max, min
+#include <atomic>      // for atomic
 #include <exception>   // for exception
 #include <filesystem>  // for path, exists
 #include <fstream>     // for ifstream
@@ -105,13 +106,34 @@ std::int32_t GetCfsCPUCount() noexcept {
   return -1;
 }
 
+namespace {
+std::atomic<ParallelExecutor> executor_{nullptr};
+std::atomic<void*> executor_data_{nullptr};
+}  // anonymous namespace
+
+void SetParallelExecutor(ParallelExecutor executor, void* executor_data) {
+  executor_data_.store(executor_data, std::memory_order_relaxed);
+  executor_.store(executor, std::memory_order_release);
+}
+
+ParallelExecutor GetParallelExecutor(void** executor_data) {
+  auto executor = executor_.load(std::memory_order_acquire);
+  *executor_data = executor_data_.load(std::memory_order_relaxed);
+  return executor;
+}
+
 std::int32_t OmpGetNumThreads(std::int32_t n_threads) noexcept(true) {
   // Don't use parallel if we are in a parallel region.
-  if (omp_in_parallel()) {
+  if (omp_in_parallel() || detail::executor_task_idx != -1) {
     return 1;
   }
-  // Honor the openmp thread limit, which can be set via environment variable.
-  auto max_n_threads = std::min({omp_get_num_procs(), omp_get_max_threads(), OmpGetThreadLimit()});
+  void* executor_data = nullptr;
+  // Honor the openmp thread limit, which can be set via environment variable. The limit
+  // doesn't apply to a custom executor, the host application might disable OpenMP.
+  auto max_n_threads =
+      GetParallelExecutor(&executor_data)
+          ? omp_get_num_procs()
+          : std::min({omp_get_num_procs(), omp_get_max_threads(), OmpGetThreadLimit()});
   // If -1 or 0 is specified by the user, we default to maximum number of threads.
   if (n_threads <= 0) {
     n_threads = max_n_threads;
@@ -129,6 +151,25 @@ std::int32_t OmpGetNumThreads(std::int32_t n_threads) noexcept(true) {
 #endif
 }
 
+std::int32_t NumNumaNodes() {
+  std::int32_t n_nodes{1};
+#if defined(__linux__)
+  // A list of ranges like `0-1,4`.
+  std::ifstream fin{"/sys/devices/system/node/online"};
+  std::string online;
+  if (!(fin >> online) || online.empty()) {
+    return n_nodes;
+  }
+  auto pos = online.find_last_of("-,");
+  try {
+    n_nodes = std::stoi(pos == std::string::npos ? online : online.substr(pos + 1)) + 1;
+  } catch (std::exception const&) {
+    return 1;
+  }
+#endif  // defined(__linux__)
+  return std::max(n_nodes, 1);
+}
+
 void NameThread(std::thread* t, StringView name) {
 #if defined(__linux__)
   auto handle = t->native_handle();
@@ -150,4 +191,27 @@ void NameThread(std::thread* t, StringView name) {
   (void)t;
 #endif
 }
+
+std::size_t GetCacheSize(std::int32_t level) noexcept {
+  long size{0};  // NOLINT
+#if defined(__linux__) && defined(_SC_LEVEL1_DCACHE_SIZE)
+  switch (level) {
+    case 1:
+      size = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+      break;
+    case 2:
+      size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+      break;
+    case 3:
+      size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+      break;
+    default:
+      break;
+  }
+#else
+  (void)level;
+#endif
+  // Negative for errors, and 0 if the value is not available to the system.
+  return size > 0 ? static_cast<std::size_t>(size) : 0;
+}
 }  // namespace xgboost::common
@@ -7,7 +7,8 @@
 #include <dmlc/common.h>
 #include <dmlc/omp.h>
 
-#include <algorithm>    // for min
+#include <algorithm>    // for min, max
+#include <atomic>       // for atomic
 #include <cstddef>      // for size_t
 #include <cstdint>      // for int32_t
 #include <cstdlib>      // for malloc, free
@@ -138,6 +139,88 @@ class BlockedSpace2d {
 };
 
 
+/**
+ * @brief Callback for running a batch of tasks on an executor provided by the host
+ *        application, in place of the OpenMP thread pool.
+ *
+ * @param executor_data The data registered with the executor.
+ * @param n_tasks       Number of tasks, each task must be called exactly once with an index
+ *                      in [0, n_tasks). The tasks can run concurrently.
+ * @param task          The task function, it doesn't throw.
+ * @param task_data     Data passed to the task function.
+ *
+ * @return 0 after all tasks have finished, non-zero if the executor failed.
+ */
+using ParallelTask = void (*)(void* task_data, std::int32_t task_idx);
+using ParallelExecutor = std::int32_t (*)(void* executor_data, std::int32_t n_tasks,
+                                          ParallelTask task, void* task_data);
+
+/**
+ * @brief Register an executor for all the parallel loops. Pass nullptr to restore OpenMP.
+ *        This should not be called while XGBoost is running.
+ */
+void SetParallelExecutor(ParallelExecutor executor, void* executor_data);
+/** @brief Get the registered executor, nullptr if OpenMP is used. */
+[[nodiscard]] ParallelExecutor GetParallelExecutor(void** executor_data);
+
+namespace detail {
+// Index of the running task when using a custom executor, -1 otherwise.
+inline thread_local std::int32_t executor_task_idx = -1;
+
+template <typename Fn>
+void RunExecutorTasks(ParallelExecutor executor, void* executor_data, std::int32_t n_tasks,
+                      Fn&& fn) {
+  dmlc::OMPException exc;
+  auto run = [&](std::int32_t task_idx) {
+    auto prev = executor_task_idx;
+    executor_task_idx = task_idx;
+    exc.Run(fn, task_idx);
+    executor_task_idx = prev;
+  };
+  if (n_tasks == 1 || executor_task_idx != -1) {
+    // Run nested loops sequentially, like nested OpenMP regions.
+    for (std::int32_t i = 0; i < n_tasks; ++i) {
+      run(i);
+    }
+  } else {
+    auto task = [](void* task_data, std::int32_t task_idx) {
+      (*static_cast<decltype(run)*>(task_data))(task_idx);
+    };
+    auto rc = executor(executor_data, n_tasks, task, &run);
+    CHECK_EQ(rc, 0) << "The parallel executor failed.";
+  }
+  exc.Rethrow();
+}
+}  // namespace detail
+
+/**
+ * @brief Index of the calling thread in the current parallel region, this should be used
+ *        in place of `omp_get_thread_num` to support custom executors.
+ */
+[[nodiscard]] inline std::int32_t ThreadIdx() {
+  auto task_idx = detail::executor_task_idx;
+  return task_idx == -1 ? omp_get_thread_num() : task_idx;
+}
+
+/**
+ * @brief Run `fn(tid)` for each tid in [0, n_threads) in parallel, an equivalent of the
+ *        `omp parallel` region.
+ */
+template <typename Fn>
+void ParallelRegion(std::int32_t n_threads, Fn&& fn) {
+  CHECK_GE(n_threads, 1);
+  void* executor_data = nullptr;
+  if (auto executor = GetParallelExecutor(&executor_data)) {
+    detail::RunExecutorTasks(executor, executor_data, n_threads, fn);
+    return;
+  }
+  dmlc::OMPException exc;
+#pragma omp parallel num_threads(n_threads)
+  { exc.Run(fn, static_cast<std::int32_t>(omp_get_thread_num())); }
+  exc.Rethrow();
+}
+
+
 // Wrapper to implement nested parallelism with simple omp parallel for
 template <typename Func>
 void ParallelFor2d(const BlockedSpace2d& space, int n_threads, Func&& func) {
@@ -145,21 +228,58 @@ void ParallelFor2d(const BlockedSpace2d& space, int n_threads, Func&& func) {
   std::size_t n_blocks_in_space = space.Size();
   CHECK_GE(n_threads, 1);
 
-  dmlc::OMPException exc;
-#pragma omp parallel num_threads(n_threads)
-  {
-    exc.Run([&]() {
-      std::size_t tid = omp_get_thread_num();
-      std::size_t chunck_size = n_blocks_in_space / n_threads + !!(n_blocks_in_space % n_threads);
-
-      std::size_t begin = chunck_size * tid;
-      std::size_t end = std::min(begin + chunck_size, n_blocks_in_space);
-      for (auto i = begin; i < end; i++) {
+  ParallelRegion(n_threads, [&](std::size_t tid) {
+    std::size_t chunck_size = n_blocks_in_space / n_threads + !!(n_blocks_in_space % n_threads);
+
+    std::size_t begin = chunck_size * tid;
+    std::size_t end = std::min(begin + chunck_size, n_blocks_in_space);
+    for (auto i = begin; i < end; i++) {
+      func(space.GetFirstDimension(i), space.GetRange(i));
+    }
+  });
+}
+
+/**
+ * @brief Same as ParallelFor2d, but a thread that has finished its own blocks steals the
+ *        remaining blocks of other threads.
+ *
+ *   Each thread starts with the same contiguous chunk of blocks as in ParallelFor2d, and
+ *   the chunk is consumed from the front by a shared atomic cursor. Once the chunk is
+ *   exhausted, the thread moves on to the chunks of the following threads. This balances
+ *   the load when the cost of blocks varies, like evaluating categorical features or
+ *   partitioning nodes of different density. The function can not rely on a fixed
+ *   mapping between the thread index and the blocks.
+ */
+template <typename Func>
+void ParallelFor2dStealing(const BlockedSpace2d& space, int n_threads, Func&& func) {
+  static_assert(std::is_void_v<std::invoke_result_t<Func, std::size_t, Range1d>>);
+  std::size_t n_blocks_in_space = space.Size();
+  CHECK_GE(n_threads, 1);
+  std::size_t chunck_size = n_blocks_in_space / n_threads + !!(n_blocks_in_space % n_threads);
+
+  // Padded to avoid false sharing between threads.
+  struct alignas(64) Cursor {
+    std::atomic<std::size_t> next{0};
+  };
+  std::vector<Cursor> cursors(n_threads);
+  for (std::size_t tid = 0; tid < cursors.size(); ++tid) {
+    cursors[tid].next.store(std::min(chunck_size * tid, n_blocks_in_space),
+                            std::memory_order_relaxed);
+  }
+
+  ParallelRegion(n_threads, [&](std::size_t tid) {
+    for (std::size_t k = 0; k < cursors.size(); ++k) {
+      auto victim = (tid + k) % cursors.size();
+      auto end = std::min(chunck_size * (victim + 1), n_blocks_in_space);
+      while (true) {
+        auto i = cursors[victim].next.fetch_add(1, std::memory_order_relaxed);
+        if (i >= end) {
+          break;
+        }
         func(space.GetFirstDimension(i), space.GetRange(i));
       }
-    });
-  }
-  exc.Rethrow();
+    }
+  });
 }
 
 /**
@@ -180,6 +300,54 @@ struct Sched {
   Sched static Guided() { return Sched{kGuided}; }
 };
 
+namespace detail {
+// Emulate the OpenMP schedules with a custom executor, each task is a thread of OpenMP.
+template <typename Index, typename Func>
+void ParallelForExecutor(ParallelExecutor executor, void* executor_data, Index size,
+                         std::int32_t n_threads, Sched sched, Func const& fn) {
+  if (!(size > 0)) {
+    return;
+  }
+  auto n = static_cast<std::size_t>(size);
+  bool is_static = sched.sched == Sched::kAuto || sched.sched == Sched::kStatic;
+  std::size_t chunk = sched.chunk;
+  if (chunk == 0) {
+    // The default static schedule divides the loop into equal sized chunks.
+    chunk = is_static ? n / n_threads + !!(n % n_threads)
+            : sched.sched == Sched::kGuided
+                ? std::max(n / (static_cast<std::size_t>(n_threads) * 4), std::size_t{1})
+                : 1;
+  }
+  std::size_t n_chunks = n / chunk + !!(n % chunk);
+  auto n_tasks = static_cast<std::int32_t>(std::min<std::size_t>(n_threads, n_chunks));
+  // Each task has its own copy of the function, which might not be const.
+  auto run_chunk = [&](Func* local, std::size_t c) {
+    auto end = std::min(n, (c + 1) * chunk);
+    for (auto i = c * chunk; i < end; ++i) {
+      (*local)(static_cast<Index>(i));
+    }
+  };
+  if (is_static) {
+    // Round-robin assignment of chunks.
+    RunExecutorTasks(executor, executor_data, n_tasks, [&](std::int32_t tid) {
+      auto local = fn;
+      for (auto c = static_cast<std::size_t>(tid); c < n_chunks; c += n_tasks) {
+        run_chunk(&local, c);
+      }
+    });
+  } else {
+    std::atomic<std::size_t> next{0};
+    RunExecutorTasks(executor, executor_data, n_tasks, [&](std::int32_t) {
+      auto local = fn;
+      for (auto c = next.fetch_add(1, std::memory_order_relaxed); c < n_chunks;
+           c = next.fetch_add(1, std::memory_order_relaxed)) {
+        run_chunk(&local, c);
+      }
+    });
+  }
+}
+}  // namespace detail
+
 template <typename Index, typename Func>
 void ParallelFor(Index size, int32_t n_threads, Sched sched, Func fn) {
 #if defined(_MSC_VER)
@@ -191,6 +359,12 @@ void ParallelFor(Index size, int32_t n_threads, Sched sched, Func fn) {
   OmpInd length = static_cast<OmpInd>(size);
   CHECK_GE(n_threads, 1);
 
+  void* executor_data = nullptr;
+  if (auto executor = GetParallelExecutor(&executor_data)) {
+    detail::ParallelForExecutor(executor, executor_data, size, n_threads, sched, fn);
+    return;
+  }
+
   dmlc::OMPException exc;
   switch (sched.sched) {
   case Sched::kAuto: {
@@ -316,10 +490,22 @@ std::int32_t constexpr DefaultMaxThreads() { return 128; }
  */
 [[nodiscard]] bool GetCpuNuma(unsigned int* cpu, unsigned int* numa);
 
+/**
+ * @brief Get the number of NUMA nodes, which is the largest online node index plus one.
+ *        Supports only Linux, returns 1 if the topology is unknown.
+ */
+[[nodiscard]] std::int32_t NumNumaNodes();
+
 /**
  * @brief Give the thread a name. Supports only pthread on linux.
  */
 void NameThread(std::thread* t, StringView name);
+
+/**
+ * @brief Get the size of the data cache of a CPU core in bytes, level 1, 2 or 3. Supports
+ *        only Linux, returns 0 if the size is unknown.
+ */
+[[nodiscard]] std::size_t GetCacheSize(std::int32_t level) noexcept;
 }  // namespace xgboost::common
 
 #endif  // XGBOOST_COMMON_THREADING_UTILS_H_
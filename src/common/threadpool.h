@@ -1,64 +1,278 @@
 /**
- * Copyright 2024, XGBoost Contributors
+ * Copyright 2024-2025, XGBoost Contributors
  */
 #pragma once
+#include <atomic>              // for atomic
 #include <condition_variable>  // for condition_variable
-#include <cstdint>             // for int32_t
-#include <functional>          // for function
-#include <future>              // for promise
-#include <memory>              // for make_shared
+#include <cstddef>             // for size_t, max_align_t
+#include <cstdint>             // for int32_t, int64_t
+#include <future>              // for packaged_task, future
+#include <memory>              // for unique_ptr
 #include <mutex>               // for mutex, unique_lock
-#include <queue>               // for queue
+#include <new>                 // for launder
 #include <string>              // for string
-#include <thread>              // for thread
-#include <type_traits>         // for invoke_result_t
-#include <utility>             // for move
+#include <thread>              // for thread, yield
+#include <type_traits>         // for invoke_result_t, decay_t
+#include <utility>             // for move, forward
 #include <vector>              // for vector
 
 #include "threading_utils.h"      // for NameThread
+#include "xgboost/logging.h"      // for CHECK
 #include "xgboost/string_view.h"  // for StringView
 
 namespace xgboost::common {
 /**
- * @brief Simple implementation of a thread pool.
+ * @brief Type erased, move-only nullary function. Small callables are stored inline
+ *        without memory allocation.
+ */
+class MoveOnlyTask {
+ public:
+  static constexpr std::size_t kInlineSize = 48;
+
+ private:
+  struct Ops {
+    void (*invoke)(void* storage);
+    // Move construct into dst and destroy the source.
+    void (*relocate)(void* dst, void* src);
+    void (*destroy)(void* storage);
+  };
+
+  template <typename Fn>
+  static constexpr bool kIsInline = sizeof(Fn) <= kInlineSize &&
+                                    alignof(Fn) <= alignof(std::max_align_t) &&
+                                    std::is_nothrow_move_constructible_v<Fn>;
+
+  template <typename Fn>
+  static Ops const* GetOps() {
+    if constexpr (kIsInline<Fn>) {
+      static Ops constexpr kOps{
+          [](void* s) { (*std::launder(static_cast<Fn*>(s)))(); },
+          [](void* dst, void* src) {
+            auto* fn = std::launder(static_cast<Fn*>(src));
+            new (dst) Fn{std::move(*fn)};
+            fn->~Fn();
+          },
+          [](void* s) { std::launder(static_cast<Fn*>(s))->~Fn(); }};
+      return &kOps;
+    } else {
+      // Store the pointer to a heap allocated callable.
+      static Ops constexpr kOps{
+          [](void* s) { (**static_cast<Fn**>(s))(); },
+          [](void* dst, void* src) { *static_cast<Fn**>(dst) = *static_cast<Fn**>(src); },
+          [](void* s) { delete *static_cast<Fn**>(s); }};
+      return &kOps;
+    }
+  }
+
+  alignas(std::max_align_t) unsigned char storage_[kInlineSize];
+  Ops const* ops_{nullptr};
+
+ public:
+  MoveOnlyTask() = default;
+  template <typename Fn, typename F = std::decay_t<Fn>,
+            std::enable_if_t<!std::is_same_v<F, MoveOnlyTask>>* = nullptr>
+  explicit MoveOnlyTask(Fn&& fn) : ops_{GetOps<F>()} {
+    if constexpr (kIsInline<F>) {
+      new (storage_) F{std::forward<Fn>(fn)};
+    } else {
+      *reinterpret_cast<F**>(storage_) = new F{std::forward<Fn>(fn)};
+    }
+  }
+  MoveOnlyTask(MoveOnlyTask&& that) noexcept : ops_{that.ops_} {
+    if (ops_) {
+      ops_->relocate(storage_, that.storage_);
+      that.ops_ = nullptr;
+    }
+  }
+  MoveOnlyTask& operator=(MoveOnlyTask&& that) noexcept {
+    if (this != &that) {
+      this->Reset();
+      ops_ = that.ops_;
+      if (ops_) {
+        ops_->relocate(storage_, that.storage_);
+        that.ops_ = nullptr;
+      }
+    }
+    return *this;
+  }
+  MoveOnlyTask(MoveOnlyTask const& that) = delete;
+  MoveOnlyTask& operator=(MoveOnlyTask const& that) = delete;
+  ~MoveOnlyTask() { this->Reset(); }
+
+  void Reset() {
+    if (ops_) {
+      ops_->destroy(storage_);
+      ops_ = nullptr;
+    }
+  }
+  [[nodiscard]] explicit operator bool() const { return ops_ != nullptr; }
+  void operator()() { ops_->invoke(storage_); }
+};
+
+/**
+ * @brief Bounded lock-free multi-producer multi-consumer queue. Each cell has a sequence
+ *        number that tells whether it's ready for a producer or a consumer, as described
+ *        by Dmitry Vyukov.
+ */
+template <typename T>
+class MPMCQueue {
+  struct alignas(64) Cell {
+    std::atomic<std::size_t> seq;
+    T value;
+  };
+
+  std::unique_ptr<Cell[]> cells_;
+  std::size_t mask_;
+  alignas(64) std::atomic<std::size_t> enqueue_pos_{0};
+  alignas(64) std::atomic<std::size_t> dequeue_pos_{0};
+
+ public:
+  /**
+   * @param capacity Must be a power of two.
+   */
+  explicit MPMCQueue(std::size_t capacity) : cells_{new Cell[capacity]}, mask_{capacity - 1} {
+    CHECK(capacity >= 2 && (capacity & mask_) == 0) << "Capacity must be a power of two.";
+    for (std::size_t i = 0; i < capacity; ++i) {
+      cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /** @brief Returns false if the queue is full, the value is not moved. */
+  [[nodiscard]] bool TryPush(T* value) {
+    auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+      auto& cell = cells_[pos & mask_];
+      auto seq = cell.seq.load(std::memory_order_acquire);
+      auto diff = static_cast<std::int64_t>(seq) - static_cast<std::int64_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          cell.value = std::move(*value);
+          cell.seq.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+  /** @brief Returns false if the queue is empty. */
+  [[nodiscard]] bool TryPop(T* out) {
+    auto pos = dequeue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+      auto& cell = cells_[pos & mask_];
+      auto seq = cell.seq.load(std::memory_order_acquire);
+      auto diff = static_cast<std::int64_t>(seq) - static_cast<std::int64_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          *out = std::move(cell.value);
+          cell.seq.store(pos + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+};
+
+/**
+ * @brief Thread pool backed by a lock-free task queue.
+ *
+ *   Submitting a task doesn't take a lock unless there are idle workers to be woken up,
+ *   and the workers only take the lock before going to sleep. Each task costs one
+ *   allocation for the shared state of the future.
  */
 class ThreadPool {
+  // Number of rounds an idle worker checks the queue before sleeping.
+  static constexpr std::int32_t kSpins = 64;
+
+  MPMCQueue<MoveOnlyTask> tasks_;
+  // Number of tasks pushed but not yet popped, can be negative temporarily.
+  std::atomic<std::int64_t> n_pending_{0};
+  std::atomic<std::int32_t> n_sleeping_{0};
   std::mutex mu_;
-  std::queue<std::function<void()>> tasks_;
   std::condition_variable cv_;
   std::vector<std::thread> pool_;
-  bool stop_{false};
+  std::atomic<bool> stop_{false};
+
+  void Notify(std::int64_t n_tasks) {
+    // Pairs with the increment of `n_sleeping_` in the worker, either the worker sees the
+    // new task or we see the sleeping worker.
+    n_pending_.fetch_add(n_tasks);
+    if (n_sleeping_.load() > 0) {
+      std::lock_guard guard{mu_};
+      if (n_tasks == 1) {
+        cv_.notify_one();
+      } else {
+        cv_.notify_all();
+      }
+    }
+  }
+  /**
+   * @param n_unnotified Number of tasks pushed by the caller without notifying the workers.
+   */
+  void Push(MoveOnlyTask&& task, std::int64_t* n_unnotified) {
+    while (!tasks_.TryPush(&task)) {
+      // The queue is full, make sure the workers are awake before waiting for them.
+      if (*n_unnotified > 0) {
+        this->Notify(*n_unnotified);
+        *n_unnotified = 0;
+      }
+      std::this_thread::yield();
+    }
+    ++(*n_unnotified);
+  }
+  void RunWorker() {
+    MoveOnlyTask task;
+    std::int32_t n_spins = 0;
+    while (true) {
+      if (tasks_.TryPop(&task)) {
+        n_pending_.fetch_sub(1);
+        task();
+        task.Reset();
+        n_spins = 0;
+        continue;
+      }
+      if (stop_.load()) {
+        // Run all the remaining tasks before exit.
+        if (n_pending_.load() <= 0) {
+          return;
+        }
+        std::this_thread::yield();
+        continue;
+      }
+      if (++n_spins < kSpins) {
+        std::this_thread::yield();
+        continue;
+      }
+      n_spins = 0;
+      std::unique_lock lock{mu_};
+      n_sleeping_.fetch_add(1);
+      cv_.wait(lock, [this] { return n_pending_.load() > 0 || stop_.load(); });
+      n_sleeping_.fetch_sub(1);
+    }
+  }
 
  public:
   /**
    * @param name      Name prefix for threads.
    * @param n_threads The number of threads this pool should hold.
    * @param init_fn   Function called once during thread creation.
+   * @param capacity  Maximum number of queued tasks, a power of two. Submission blocks
+   *                  when the queue is full.
    */
   template <typename InitFn>
-  explicit ThreadPool(StringView name, std::int32_t n_threads, InitFn&& init_fn) {
+  explicit ThreadPool(StringView name, std::int32_t n_threads, InitFn&& init_fn,
+                      std::size_t capacity = 256)
+      : tasks_{capacity} {
     for (std::int32_t i = 0; i < n_threads; ++i) {
       pool_.emplace_back([&, init_fn = std::forward<InitFn>(init_fn)] {
         init_fn();
-
-        while (true) {
-          std::unique_lock lock{mu_};
-          cv_.wait(lock, [this] { return !this->tasks_.empty() || stop_; });
-
-          if (this->stop_) {
-            while (!tasks_.empty()) {
-              auto fn = tasks_.front();
-              tasks_.pop();
-              fn();
-            }
-            return;
-          }
-
-          auto fn = tasks_.front();
-          tasks_.pop();
-          lock.unlock();
-          fn();
-        }
+        this->RunWorker();
       });
       std::string name_i = name.c_str() + std::string{"-"} + std::to_string(i);  // NOLINT
       NameThread(&pool_.back(), name_i);
@@ -66,17 +280,11 @@ class ThreadPool {
   }
 
   ~ThreadPool() {
-    std::unique_lock lock{mu_};
-    stop_ = true;
-    lock.unlock();
-
-    for (auto& t : pool_) {
-      if (t.joinable()) {
-        std::unique_lock lock{mu_};
-        this->cv_.notify_one();
-        lock.unlock();
-      }
+    {
+      std::lock_guard guard{mu_};
+      stop_.store(true);
     }
+    cv_.notify_all();
 
     for (auto& t : pool_) {
       if (t.joinable()) {
@@ -90,24 +298,28 @@ class ThreadPool {
    */
   template <typename Fn, typename R = std::invoke_result_t<Fn>>
   auto Submit(Fn&& fn) {
-    // Use shared ptr to make the task copy constructible.
-    auto p{std::make_shared<std::promise<R>>()};
-    auto fut = p->get_future();
-    auto ffn = std::function{[task = std::move(p), fn = std::forward<Fn>(fn)]() mutable {
-      if constexpr (std::is_void_v<R>) {
-        fn();
-        task->set_value();
-      } else {
-        task->set_value(fn());
-      }
-    }};
-
-    std::unique_lock lock{mu_};
-    this->tasks_.push(std::move(ffn));
-    lock.unlock();
-
-    cv_.notify_one();
+    std::packaged_task<R()> task{std::forward<Fn>(fn)};
+    auto fut = task.get_future();
+    std::int64_t n_unnotified = 0;
+    this->Push(MoveOnlyTask{std::move(task)}, &n_unnotified);
+    this->Notify(n_unnotified);
     return fut;
   }
+  /**
+   * @brief Submit a batch of tasks, `fn(arg)` for each of the arguments, with a single
+   *        wake up of the workers. The function and the argument are copied into each task.
+   */
+  template <typename T, typename Fn, typename R = std::invoke_result_t<Fn, T const&>>
+  auto SubmitBulk(std::vector<T> const& args, Fn const& fn) {
+    std::vector<std::future<R>> futures(args.size());
+    std::int64_t n_unnotified = 0;
+    for (std::size_t i = 0; i < args.size(); ++i) {
+      std::packaged_task<R()> task{[arg = args[i], fn] { return fn(arg); }};
+      futures[i] = task.get_future();
+      this->Push(MoveOnlyTask{std::move(task)}, &n_unnotified);
+    }
+    this->Notify(n_unnotified);
+    return futures;
+  }
 };
 }  // namespace xgboost::common
@@ -22,6 +22,9 @@ void Monitor::Start(std::string const &name) {
     stats.nvtx_id = range_handle.get_value();
 #endif  // defined(XGBOOST_USE_NVTX)
   }
+  if (PerfCounters::Enabled()) {
+    perf_begin_[name] = PerfCounters::Get().Read();
+  }
 }
 
 void Monitor::Stop(const std::string &name) {
@@ -33,6 +36,14 @@ void Monitor::Stop(const std::string &name) {
     nvtx3::end_range_in<curt::NvtxDomain>(nvtx3::range_handle{stats.nvtx_id});
 #endif  // defined(XGBOOST_USE_NVTX)
   }
+  if (!perf_begin_.empty()) {
+    auto it = perf_begin_.find(name);
+    if (it != perf_begin_.cend()) {
+      auto &counters = PerfCounters::Get();
+      counters.Add(label_ + "::" + name, it->second, counters.Read());
+      perf_begin_.erase(it);
+    }
+  }
 }
 
 void Monitor::PrintStatistics(StatMap const &statistics) const {
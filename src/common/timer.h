@@ -9,6 +9,8 @@
 #include <string>
 #include <utility>
 
+#include "perf_counter.h"  // for PerfCounters
+
 namespace xgboost::common {
 struct Timer {
   using ClockT = std::chrono::high_resolution_clock;
@@ -55,6 +57,8 @@ struct Monitor {
 
   std::string label_ = "";
   std::map<std::string, Statistics> statistics_map_;
+  // Samples of the hardware counters at the start of each running phase.
+  std::map<std::string, PerfCounters::Sample> perf_begin_;
   Timer self_timer_;
 
   void PrintStatistics(StatMap const& statistics) const;
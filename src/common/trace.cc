@@ -0,0 +1,152 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include "trace.h"
+
+#include <algorithm>  // for max
+#include <array>      // for array
+#include <chrono>     // for steady_clock, duration_cast, nanoseconds
+#include <fstream>    // for ofstream
+#include <iomanip>    // for setprecision
+#include <ios>        // for fixed
+#include <memory>     // for make_shared
+
+#include "../collective/communicator-inl.h"  // for GetRank
+#include "xgboost/logging.h"                 // for LOG
+
+namespace xgboost::common {
+StringView TraceEventName(TraceEvent event) {
+  switch (event) {
+    case TraceEvent::kTreeLevel:
+      return "TreeLevel";
+    case TraceEvent::kBuildHist:
+      return "BuildHist";
+    case TraceEvent::kPageRead:
+      return "PageRead";
+    case TraceEvent::kPageWait:
+      return "PageWait";
+    case TraceEvent::kAllreduce:
+      return "Allreduce";
+    case TraceEvent::kAllgather:
+      return "Allgather";
+    case TraceEvent::kBroadcast:
+      return "Broadcast";
+    case TraceEvent::kNumEvents:
+      break;
+  }
+  LOG(FATAL) << "Unknown trace event: " << static_cast<std::int32_t>(event);
+  return "";
+}
+
+// Single producer ring buffer, only the owning thread writes the records.
+struct Tracer::ThreadBuffer {
+  std::int32_t tid;
+  std::array<Tracer::Entry, Tracer::kBufferSize> records;
+  // Total number of records written.
+  std::atomic<std::uint64_t> n_records{0};
+
+  explicit ThreadBuffer(std::int32_t tid) : tid{tid} {}
+};
+
+std::atomic<bool> Tracer::enabled_{false};
+
+Tracer& Tracer::Get() {
+  static Tracer tracer;
+  return tracer;
+}
+
+Tracer::~Tracer() {
+  std::lock_guard guard{mu_};
+  if (Enabled()) {
+    // Write the trace during exit if it's not stopped. The communicator might have been
+    // destroyed, use the rank obtained earlier.
+    this->ConfigureUnlocked("");
+  }
+}
+
+std::int64_t Tracer::Now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+Tracer::ThreadBuffer* Tracer::LocalBuffer() {
+  thread_local std::shared_ptr<ThreadBuffer> local;
+  if (!local) {
+    std::lock_guard guard{mu_};
+    local = std::make_shared<ThreadBuffer>(static_cast<std::int32_t>(buffers_.size()));
+    buffers_.push_back(local);
+  }
+  return local.get();
+}
+
+void Tracer::Record(TraceEvent event, std::int64_t begin, std::int64_t end, std::int64_t arg) {
+  if (!Enabled()) {
+    return;
+  }
+  auto* buffer = this->LocalBuffer();
+  auto n = buffer->n_records.load(std::memory_order_relaxed);
+  buffer->records[n % kBufferSize] = Entry{begin, end, arg, event};
+  buffer->n_records.store(n + 1, std::memory_order_release);
+}
+
+void Tracer::Configure(std::string const& path) {
+  std::lock_guard guard{mu_};
+  if (path == path_) {
+    return;
+  }
+  // The communicator might be initialized after the tracing is started.
+  rank_ = collective::GetRank();
+  this->ConfigureUnlocked(path);
+}
+
+void Tracer::ConfigureUnlocked(std::string const& path) {
+  if (!path_.empty()) {
+    enabled_.store(false);
+    this->WriteUnlocked();
+  }
+  path_ = path;
+  if (!path_.empty()) {
+    for (auto const& buffer : buffers_) {
+      buffer->n_records.store(0);
+    }
+    epoch_ = Now();
+    enabled_.store(true);
+  }
+}
+
+void Tracer::WriteUnlocked() const {
+  std::ofstream fout{path_};
+  if (!fout) {
+    // Don't throw, this can run during exit.
+    LOG(WARNING) << "Failed to open the trace file: " << path_;
+    return;
+  }
+  fout << std::fixed << std::setprecision(3);
+  fout << R"({"displayTimeUnit":"ms","traceEvents":[)";
+  bool first = true;
+  for (auto const& buffer : buffers_) {
+    auto n = buffer->n_records.load(std::memory_order_acquire);
+    auto beg = n > kBufferSize ? n - kBufferSize : 0;
+    for (auto i = beg; i < n; ++i) {
+      auto const& r = buffer->records[i % kBufferSize];
+      // Events that started before the tracing.
+      if (r.begin < epoch_) {
+        continue;
+      }
+      if (!first) {
+        fout << ',';
+      }
+      first = false;
+      // Complete events, the time is in microseconds.
+      auto dur = std::max(r.end - r.begin, std::int64_t{0});
+      fout << R"({"name":")" << TraceEventName(r.event) << R"(","cat":"xgboost","ph":"X")"
+           << R"(,"ts":)" << static_cast<double>(r.begin - epoch_) / 1e3
+           << R"(,"dur":)" << static_cast<double>(dur) / 1e3
+           << R"(,"pid":)" << rank_ << R"(,"tid":)" << buffer->tid
+           << R"(,"args":{"value":)" << r.arg << "}}";
+    }
+  }
+  fout << "]}\n";
+}
+}  // namespace xgboost::common
@@ -0,0 +1,118 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ *
+ * @brief Low overhead tracing of the training, written in the Chrome trace format.
+ */
+#ifndef XGBOOST_COMMON_TRACE_H_
+#define XGBOOST_COMMON_TRACE_H_
+
+#include <atomic>   // for atomic
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int64_t, int32_t, uint8_t
+#include <memory>   // for shared_ptr
+#include <mutex>    // for mutex
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "xgboost/string_view.h"  // for StringView
+
+namespace xgboost::common {
+/**
+ * @brief IDs of the traced events. Add the name to @ref TraceEventName when adding a new
+ *        event.
+ */
+enum class TraceEvent : std::uint8_t {
+  // Expanding a set of nodes in the tree updater, the argument is the depth of the first
+  // node.
+  kTreeLevel = 0,
+  // Building the histogram for a batch of nodes, the argument is the number of nodes.
+  kBuildHist,
+  // Reading a page from the external memory cache, the argument is the page index.
+  kPageRead,
+  // Waiting for a prefetched page, the argument is the page index.
+  kPageWait,
+  // Collective calls, the argument is the size of the data in bytes.
+  kAllreduce,
+  kAllgather,
+  kBroadcast,
+  kNumEvents,
+};
+
+[[nodiscard]] StringView TraceEventName(TraceEvent event);
+
+/**
+ * @brief Process-wide tracer.
+ *
+ *   Each thread records the events into its own ring buffer, only the most recent @ref
+ *   kBufferSize events of each thread are kept. The events are written to the file when
+ *   the tracing is stopped. Use @ref TraceScope for recording events, it only reads an
+ *   atomic flag when the tracing is disabled.
+ */
+class Tracer {
+ public:
+  struct Entry {
+    std::int64_t begin;
+    std::int64_t end;
+    std::int64_t arg;
+    TraceEvent event;
+  };
+  // Number of records for each thread.
+  static constexpr std::size_t kBufferSize = 1 << 14;
+
+ private:
+  struct ThreadBuffer;
+
+  static std::atomic<bool> enabled_;
+  std::mutex mu_;
+  std::string path_;
+  std::int64_t epoch_{0};
+  std::int32_t rank_{0};
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+
+  ThreadBuffer* LocalBuffer();
+  void WriteUnlocked() const;
+  void ConfigureUnlocked(std::string const& path);
+
+ public:
+  Tracer() = default;
+  ~Tracer();
+
+  [[nodiscard]] static Tracer& Get();
+  [[nodiscard]] static bool Enabled() { return enabled_.load(std::memory_order_relaxed); }
+  /** @brief Monotonic time in nanoseconds. */
+  [[nodiscard]] static std::int64_t Now();
+
+  /**
+   * @brief Start tracing. If a trace is already running, it's stopped and written first.
+   *
+   * @param path Output file, an empty path stops the tracing.
+   */
+  void Configure(std::string const& path);
+  void Record(TraceEvent event, std::int64_t begin, std::int64_t end, std::int64_t arg);
+};
+
+/**
+ * @brief Record an event over the lifetime of this object.
+ */
+class TraceScope {
+  std::int64_t begin_{-1};
+  std::int64_t arg_;
+  TraceEvent event_;
+
+ public:
+  explicit TraceScope(TraceEvent event, std::int64_t arg = 0) : arg_{arg}, event_{event} {
+    if (Tracer::Enabled()) {
+      begin_ = Tracer::Now();
+    }
+  }
+  ~TraceScope() {
+    if (begin_ >= 0) {
+      Tracer::Get().Record(event_, begin_, Tracer::Now(), arg_);
+    }
+  }
+
+  TraceScope(TraceScope const& that) = delete;
+  TraceScope& operator=(TraceScope const& that) = delete;
+};
+}  // namespace xgboost::common
+#endif  // XGBOOST_COMMON_TRACE_H_
@@ -0,0 +1,203 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include "vector_math.h"
+
+#include <cmath>    // for exp
+#include <cstddef>  // for size_t
+
+#include "cpu_dispatch.h"     // for GetCpuIsa, CpuIsa
+#include "math.h"             // for Sigmoid
+#include "xgboost/logging.h"  // for CHECK_EQ
+
+#if defined(__x86_64__) && defined(__GNUC__)
+// The kernels are compiled with function-level target attributes and selected at runtime,
+// no compiler flag is required for the rest of the library.
+#define XGBOOST_SIMD_MATH_PRESENT 1
+#include <immintrin.h>
+#endif  // defined(__x86_64__) && defined(__GNUC__)
+
+namespace xgboost::common {
+namespace {
+#if defined(XGBOOST_SIMD_MATH_PRESENT)
+/**
+ * The exp kernel follows the single precision exp from Cephes. The input is reduced to
+ * r = x - n * ln(2) with |r| <= ln(2) / 2, exp(r) is approximated by a polynomial, and the
+ * result is scaled by 2^n. The scaling is split into two multiplications so that results
+ * close to the overflow threshold and subnormal results don't overflow the exponent.
+ */
+// Beyond this range the result is infinity or 0, the clamp keeps n in [-151, 129].
+constexpr float kExpLo = -104.0f;
+constexpr float kExpHi = 89.0f;
+constexpr float kLog2e = 1.44269504088896341f;
+// ln(2) split into a part exactly representable with few bits and the rest.
+constexpr float kLn2Hi = 0.693359375f;
+constexpr float kLn2Lo = -2.12194440e-4f;
+constexpr float kExpP0 = 1.9875691500e-4f;
+constexpr float kExpP1 = 1.3981999507e-3f;
+constexpr float kExpP2 = 8.3334519073e-3f;
+constexpr float kExpP3 = 4.1665795894e-2f;
+constexpr float kExpP4 = 1.6666665459e-1f;
+constexpr float kExpP5 = 5.0000001201e-1f;
+// Clamp of the negated input in Sigmoid.
+constexpr float kSigmoidHi = 88.7f;
+
+__attribute__((target("avx512f"))) inline __m512 Exp512(__m512 x) {
+  auto nan = _mm512_cmp_ps_mask(x, x, _CMP_UNORD_Q);
+  auto v = _mm512_min_ps(_mm512_max_ps(x, _mm512_set1_ps(kExpLo)), _mm512_set1_ps(kExpHi));
+  auto n = _mm512_roundscale_ps(_mm512_mul_ps(v, _mm512_set1_ps(kLog2e)),
+                                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  auto r = _mm512_fnmadd_ps(n, _mm512_set1_ps(kLn2Hi), v);
+  r = _mm512_fnmadd_ps(n, _mm512_set1_ps(kLn2Lo), r);
+
+  auto p = _mm512_set1_ps(kExpP0);
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(kExpP1));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(kExpP2));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(kExpP3));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(kExpP4));
+  p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(kExpP5));
+  auto y = _mm512_fmadd_ps(_mm512_mul_ps(p, r), r, _mm512_add_ps(r, _mm512_set1_ps(1.0f)));
+
+  auto k = _mm512_cvtps_epi32(n);
+  auto k1 = _mm512_srai_epi32(k, 1);
+  auto k2 = _mm512_sub_epi32(k, k1);
+  auto bias = _mm512_set1_epi32(127);
+  auto s1 = _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(k1, bias), 23));
+  auto s2 = _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(k2, bias), 23));
+  y = _mm512_mul_ps(_mm512_mul_ps(y, s1), s2);
+  return _mm512_mask_blend_ps(nan, y, x);
+}
+
+__attribute__((target("avx2,fma"))) inline __m256 Exp256(__m256 x) {
+  auto nan = _mm256_cmp_ps(x, x, _CMP_UNORD_Q);
+  auto v = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(kExpLo)), _mm256_set1_ps(kExpHi));
+  auto n = _mm256_round_ps(_mm256_mul_ps(v, _mm256_set1_ps(kLog2e)),
+                           _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  auto r = _mm256_fnmadd_ps(n, _mm256_set1_ps(kLn2Hi), v);
+  r = _mm256_fnmadd_ps(n, _mm256_set1_ps(kLn2Lo), r);
+
+  auto p = _mm256_set1_ps(kExpP0);
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(kExpP1));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(kExpP2));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(kExpP3));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(kExpP4));
+  p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(kExpP5));
+  auto y = _mm256_fmadd_ps(_mm256_mul_ps(p, r), r, _mm256_add_ps(r, _mm256_set1_ps(1.0f)));
+
+  auto k = _mm256_cvtps_epi32(n);
+  auto k1 = _mm256_srai_epi32(k, 1);
+  auto k2 = _mm256_sub_epi32(k, k1);
+  auto bias = _mm256_set1_epi32(127);
+  auto s1 = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(k1, bias), 23));
+  auto s2 = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(k2, bias), 23));
+  y = _mm256_mul_ps(_mm256_mul_ps(y, s1), s2);
+  return _mm256_blendv_ps(y, x, nan);
+}
+
+// Same as `Sigmoid(float)`, the boundary is the second operand of min to keep NaN.
+__attribute__((target("avx512f"))) inline __m512 Sigmoid512(__m512 x) {
+  auto neg = _mm512_sub_ps(_mm512_setzero_ps(), x);
+  auto e = Exp512(_mm512_min_ps(_mm512_set1_ps(kSigmoidHi), neg));
+  return _mm512_div_ps(_mm512_set1_ps(1.0f), _mm512_add_ps(e, _mm512_set1_ps(1.0f)));
+}
+
+__attribute__((target("avx2,fma"))) inline __m256 Sigmoid256(__m256 x) {
+  auto neg = _mm256_sub_ps(_mm256_setzero_ps(), x);
+  auto e = Exp256(_mm256_min_ps(_mm256_set1_ps(kSigmoidHi), neg));
+  return _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_add_ps(e, _mm256_set1_ps(1.0f)));
+}
+
+// The tail is processed with masked loads and stores, so that the result of an element
+// doesn't depend on its position.
+template <typename Fn>
+__attribute__((target("avx512f"))) void Apply512(Span<float const> in, Span<float> out, Fn fn) {
+  std::size_t constexpr kLanes = 16;
+  std::size_t i = 0;
+  for (; i + kLanes <= in.size(); i += kLanes) {
+    _mm512_storeu_ps(out.data() + i, fn(_mm512_loadu_ps(in.data() + i)));
+  }
+  if (i < in.size()) {
+    auto mask = static_cast<__mmask16>((1u << (in.size() - i)) - 1u);
+    auto v = fn(_mm512_maskz_loadu_ps(mask, in.data() + i));
+    _mm512_mask_storeu_ps(out.data() + i, mask, v);
+  }
+}
+
+template <typename Fn>
+__attribute__((target("avx2,fma"))) void Apply256(Span<float const> in, Span<float> out, Fn fn) {
+  std::size_t constexpr kLanes = 8;
+  std::size_t i = 0;
+  for (; i + kLanes <= in.size(); i += kLanes) {
+    _mm256_storeu_ps(out.data() + i, fn(_mm256_loadu_ps(in.data() + i)));
+  }
+  if (i < in.size()) {
+    auto n_tail = static_cast<std::int32_t>(in.size() - i);
+    auto lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    auto mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(n_tail), lane);
+    auto v = fn(_mm256_maskload_ps(in.data() + i, mask));
+    _mm256_maskstore_ps(out.data() + i, mask, v);
+  }
+}
+
+// Functors with the target attribute, so that the kernels are inlined into the loops.
+struct Exp512Op {
+  __attribute__((target("avx512f"))) __m512 operator()(__m512 x) const { return Exp512(x); }
+};
+struct Exp256Op {
+  __attribute__((target("avx2,fma"))) __m256 operator()(__m256 x) const { return Exp256(x); }
+};
+struct Sigmoid512Op {
+  __attribute__((target("avx512f"))) __m512 operator()(__m512 x) const { return Sigmoid512(x); }
+};
+struct Sigmoid256Op {
+  __attribute__((target("avx2,fma"))) __m256 operator()(__m256 x) const { return Sigmoid256(x); }
+};
+#endif  // defined(XGBOOST_SIMD_MATH_PRESENT)
+}  // anonymous namespace
+
+[[nodiscard]] bool VectorMathHasSimd() {
+#if defined(XGBOOST_SIMD_MATH_PRESENT)
+  return GetCpuIsa() != CpuIsa::kBaseline;
+#else
+  return false;
+#endif  // defined(XGBOOST_SIMD_MATH_PRESENT)
+}
+
+void VectorExp(Span<float const> in, Span<float> out) {
+  CHECK_EQ(in.size(), out.size());
+#if defined(XGBOOST_SIMD_MATH_PRESENT)
+  switch (GetCpuIsa()) {
+    case CpuIsa::kAvx512:
+      Apply512(in, out, Exp512Op{});
+      return;
+    case CpuIsa::kAvx2:
+      Apply256(in, out, Exp256Op{});
+      return;
+    case CpuIsa::kBaseline:
+      break;
+  }
+#endif  // defined(XGBOOST_SIMD_MATH_PRESENT)
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    out[i] = std::exp(in[i]);
+  }
+}
+
+void VectorSigmoid(Span<float const> in, Span<float> out) {
+  CHECK_EQ(in.size(), out.size());
+#if defined(XGBOOST_SIMD_MATH_PRESENT)
+  switch (GetCpuIsa()) {
+    case CpuIsa::kAvx512:
+      Apply512(in, out, Sigmoid512Op{});
+      return;
+    case CpuIsa::kAvx2:
+      Apply256(in, out, Sigmoid256Op{});
+      return;
+    case CpuIsa::kBaseline:
+      break;
+  }
+#endif  // defined(XGBOOST_SIMD_MATH_PRESENT)
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    out[i] = Sigmoid(in[i]);
+  }
+}
+}  // namespace xgboost::common
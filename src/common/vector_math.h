@@ -0,0 +1,48 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ *
+ * @brief Vectorised elementwise math functions for the CPU objectives.
+ */
+#ifndef XGBOOST_COMMON_VECTOR_MATH_H_
+#define XGBOOST_COMMON_VECTOR_MATH_H_
+
+#include <cstdint>  // for int32_t
+
+#include "xgboost/span.h"  // for Span
+
+namespace xgboost::common {
+/**
+ * @brief Maximum error of @ref VectorExp in units in the last place, compared to the
+ *        correctly rounded result.
+ */
+constexpr std::int32_t kVectorExpMaxUlp = 2;
+
+/**
+ * @brief Whether the functions in this file use the SIMD kernels on the current CPU.
+ *        Otherwise they use the math functions from the standard library.
+ */
+[[nodiscard]] bool VectorMathHasSimd();
+
+/**
+ * @brief Compute exp of each element.
+ *
+ *   The AVX-512 and the AVX2 kernels are selected at runtime, they produce the same
+ *   result for each element regardless of the size of the input. The error is bounded by
+ *   @ref kVectorExpMaxUlp, including subnormal results. Overflow produces infinity, and
+ *   NaN is propagated.
+ *
+ * @param in  Input values.
+ * @param out Output values, can be the same as the input.
+ */
+void VectorExp(Span<float const> in, Span<float> out);
+
+/**
+ * @brief Compute the logistic function of each element, vectorised version of
+ *        @ref Sigmoid for float.
+ *
+ * @param in  Input values.
+ * @param out Output values, can be the same as the input.
+ */
+void VectorSigmoid(Span<float const> in, Span<float> out);
+}  // namespace xgboost::common
+#endif  // XGBOOST_COMMON_VECTOR_MATH_H_
@@ -28,6 +28,11 @@ Context::Context() : cfs_cpu_count_{common::GetCfsCPUCount()} {}
 namespace {
 inline constexpr char const* kDevice = "device";
 
+std::int32_t& ThreadsOverride() {
+  static thread_local std::int32_t n_threads{0};
+  return n_threads;
+}
+
 #if !defined(XGBOOST_USE_CUDA)
 DeviceOrd CUDAOrdinal(DeviceOrd device, bool) {
   device = DeviceOrd::CPU();
@@ -268,13 +273,21 @@ void Context::SetDeviceOrdinal(Args const& kwargs) {
 }
 
 std::int32_t Context::Threads() const {
-  auto n_threads = common::OmpGetNumThreads(nthread);
+  auto n = ThreadsOverride();
+  auto n_threads = common::OmpGetNumThreads(n > 0 ? n : nthread);
   if (cfs_cpu_count_ > 0) {
     n_threads = std::min(n_threads, cfs_cpu_count_);
   }
   return n_threads;
 }
 
+ScopedThreads::ScopedThreads(std::int32_t n_threads) : prev_{ThreadsOverride()} {
+  CHECK_GE(n_threads, 0) << "Invalid number of threads.";
+  ThreadsOverride() = n_threads;
+}
+
+ScopedThreads::~ScopedThreads() { ThreadsOverride() = prev_; }
+
 #if !defined(XGBOOST_USE_CUDA)
 CUDAContext const* Context::CUDACtx() const {
   common::AssertGPUSupport();
@@ -17,6 +17,7 @@
 
 #include "../common/math.h"
 #include "array_interface.h"
+#include "arrow_interface.h"  // for ArrowColumns
 #include "xgboost/base.h"
 #include "xgboost/data.h"
 #include "xgboost/logging.h"
@@ -270,11 +271,62 @@ class ArrayAdapterBatch : public detail::NoMetaInfo {
   [[nodiscard]] std::size_t NumRows() const { return array_interface_.Shape<0>(); }
   [[nodiscard]] std::size_t NumCols() const { return array_interface_.Shape<1>(); }
   [[nodiscard]] std::size_t Size() const { return this->NumRows(); }
+  [[nodiscard]] ArrayInterface<2> const& Array() const { return array_interface_; }
 
   explicit ArrayAdapterBatch(ArrayInterface<2> array_interface)
       : array_interface_{std::move(array_interface)} {}
 };
 
+/**
+ * @brief Same as @ref ArrayAdapterBatch, but the data type is resolved once for the batch
+ *        instead of for each element. Created by @ref DispatchTypedBatch.
+ */
+template <typename T>
+class TypedArrayAdapterBatch : public detail::NoMetaInfo {
+ public:
+  static constexpr bool kIsRowMajor = true;
+
+ private:
+  T const* data_{nullptr};
+  std::size_t n_rows_{0};
+  std::size_t n_cols_{0};
+  // Strides in number of elements.
+  std::size_t row_stride_{0};
+  std::size_t col_stride_{0};
+
+  class Line {
+    T const* row_;
+    std::size_t ridx_;
+    std::size_t n_cols_;
+    std::size_t col_stride_;
+
+   public:
+    Line(T const* row, std::size_t ridx, std::size_t n_cols, std::size_t col_stride)
+        : row_{row}, ridx_{ridx}, n_cols_{n_cols}, col_stride_{col_stride} {}
+
+    [[nodiscard]] std::size_t Size() const { return n_cols_; }
+
+    [[nodiscard]] COOTuple GetElement(std::size_t idx) const {
+      return {ridx_, idx, static_cast<float>(row_[idx * col_stride_])};
+    }
+  };
+
+ public:
+  explicit TypedArrayAdapterBatch(ArrayInterface<2> const& array)
+      : data_{static_cast<T const*>(array.data)},
+        n_rows_{array.Shape<0>()},
+        n_cols_{array.Shape<1>()},
+        row_stride_{array.strides[0]},
+        col_stride_{array.strides[1]} {}
+
+  [[nodiscard]] Line GetLine(std::size_t ridx) const {
+    return Line{data_ + ridx * row_stride_, ridx, n_cols_, col_stride_};
+  }
+  [[nodiscard]] std::size_t NumRows() const { return n_rows_; }
+  [[nodiscard]] std::size_t NumCols() const { return n_cols_; }
+  [[nodiscard]] std::size_t Size() const { return this->NumRows(); }
+};
+
 /**
  * Adapter for dense array on host, in Python that's `numpy.ndarray`.  This is similar to
  * `DenseAdapter`, but supports __array_interface__ instead of raw pointers.  An
@@ -564,13 +616,63 @@ class ColumnarAdapterBatch : public detail::NoMetaInfo {
   }
   [[nodiscard]] std::size_t NumCols() const { return columns_.empty() ? 0 : columns_.size(); }
   [[nodiscard]] std::size_t NumRows() const { return this->Size(); }
+  [[nodiscard]] common::Span<ArrayInterface<1> const> Columns() const { return columns_; }
+
+  static constexpr bool kIsRowMajor = true;
+};
+
+/**
+ * @brief Same as @ref ColumnarAdapterBatch for columns with the same data type and without
+ *        validity masks. Created by @ref DispatchTypedBatch.
+ */
+template <typename T>
+class TypedColumnarAdapterBatch : public detail::NoMetaInfo {
+  common::Span<ArrayInterface<1> const> columns_;
+
+  class Line {
+    common::Span<ArrayInterface<1> const> columns_;
+    std::size_t ridx_;
+
+   public:
+    Line(common::Span<ArrayInterface<1> const> columns, std::size_t ridx)
+        : columns_{columns}, ridx_{ridx} {}
+    [[nodiscard]] std::size_t Size() const { return columns_.size(); }
+
+    [[nodiscard]] COOTuple GetElement(std::size_t fidx) const {
+      auto const& column = columns_.data()[fidx];
+      auto value = static_cast<T const*>(column.data)[ridx_ * column.strides[0]];
+      return {ridx_, fidx, static_cast<float>(value)};
+    }
+  };
 
+ public:
   static constexpr bool kIsRowMajor = true;
+
+  explicit TypedColumnarAdapterBatch(common::Span<ArrayInterface<1> const> columns)
+      : columns_{columns} {}
+  [[nodiscard]] Line GetLine(std::size_t ridx) const { return Line{columns_, ridx}; }
+  [[nodiscard]] std::size_t Size() const {
+    return columns_.empty() ? 0 : columns_.front().Shape<0>();
+  }
+  [[nodiscard]] std::size_t NumCols() const { return columns_.size(); }
+  [[nodiscard]] std::size_t NumRows() const { return this->Size(); }
 };
 
 class ColumnarAdapter : public detail::SingleBatchDataIter<ColumnarAdapterBatch> {
   std::vector<ArrayInterface<1>> columns_;
   ColumnarAdapterBatch batch_;
+  // Buffers referenced by the columns when the input is an Arrow record batch.
+  ArrowColumns arrow_;
+
+  void Init() {
+    bool consistent =
+        columns_.empty() ||
+        std::all_of(columns_.cbegin(), columns_.cend(), [&](ArrayInterface<1> const& array) {
+          return array.Shape<0>() == columns_[0].Shape<0>();
+        });
+    CHECK(consistent) << "Size of columns should be the same.";
+    batch_ = ColumnarAdapterBatch{columns_};
+  }
 
  public:
   explicit ColumnarAdapter(StringView columns) {
@@ -580,13 +682,11 @@ class ColumnarAdapter : public detail::SingleBatchDataIter<ColumnarAdapterBatch>
     for (auto col : array) {
       columns_.emplace_back(get<Object const>(col));
     }
-    bool consistent =
-        columns_.empty() ||
-        std::all_of(columns_.cbegin(), columns_.cend(), [&](ArrayInterface<1> const& array) {
-          return array.Shape<0>() == columns_[0].Shape<0>();
-        });
-    CHECK(consistent) << "Size of columns should be the same.";
-    batch_ = ColumnarAdapterBatch{columns_};
+    this->Init();
+  }
+  explicit ColumnarAdapter(ArrowColumns&& columns)
+      : columns_{columns.Columns()}, arrow_{std::move(columns)} {
+    this->Init();
   }
 
   [[nodiscard]] ColumnarAdapterBatch const& Value() const override { return batch_; }
@@ -787,5 +887,56 @@ class SparsePageAdapterBatch {
   Line GetLine(size_t ridx) const { return Line{page_[ridx].data(), page_[ridx].size(), ridx}; }
   size_t Size() const { return page_.Size(); }
 };
+
+/**
+ * @brief Call the function with a batch that reads the values without dispatching the
+ *        data type for each element, if there's one for the input batch. Otherwise, the
+ *        function is called with the input batch.
+ *
+ *   The function is instantiated for each data type, use it for the loops over all the
+ *   elements of a batch.
+ */
+template <typename BatchT, typename Fn>
+decltype(auto) DispatchTypedBatch(BatchT const& batch, Fn&& fn) {
+  return fn(batch);
+}
+
+template <typename Fn>
+decltype(auto) DispatchTypedBatch(ArrayAdapterBatch const& batch, Fn&& fn) {
+  return DispatchDType(batch.Array().type, [&](auto t) {
+    using T = decltype(t);
+    return fn(TypedArrayAdapterBatch<T>{batch.Array()});
+  });
+}
+
+template <typename Fn>
+decltype(auto) DispatchTypedBatch(ColumnarAdapterBatch const& batch, Fn&& fn) {
+  auto columns = batch.Columns();
+  bool homogeneous =
+      !columns.empty() && std::all_of(columns.cbegin(), columns.cend(), [&](auto const& col) {
+        return col.type == columns.front().type && col.valid.Data() == nullptr;
+      });
+  if (!homogeneous) {
+    return fn(batch);
+  }
+  return DispatchDType(columns.front().type, [&](auto t) {
+    using T = decltype(t);
+    return fn(TypedColumnarAdapterBatch<T>{columns});
+  });
+}
+
+/**
+ * @brief Adapter for a single batch, used to pass the batch from @ref DispatchTypedBatch
+ *        to functions that take an adapter.
+ */
+template <typename BatchT>
+class BatchRef {
+  BatchT batch_;
+
+ public:
+  explicit BatchRef(BatchT batch) : batch_{std::move(batch)} {}
+  [[nodiscard]] BatchT const& Value() const { return batch_; }
+  [[nodiscard]] std::size_t NumRows() const { return batch_.Size(); }
+};
 }  // namespace xgboost::data
 #endif  // XGBOOST_DATA_ADAPTER_H_
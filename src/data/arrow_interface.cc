@@ -0,0 +1,125 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include "arrow_interface.h"
+
+#include <cstddef>  // for size_t
+#include <cstring>  // for strcmp
+
+#include "../common/bitfield.h"   // for RBitField8
+#include "xgboost/logging.h"      // for CHECK
+#include "xgboost/span.h"         // for Span
+#include "xgboost/string_view.h"  // for StringView
+
+namespace xgboost::data {
+namespace {
+// Map the Arrow format string of a fixed-width primitive to the type string of the array
+// interface. Returns nullptr for unsupported types.
+char const* ToTypeStr(StringView format) {
+  if (format.size() != 1) {
+    return nullptr;
+  }
+  switch (format[0]) {
+    case 'c':
+      return "<i1";
+    case 'C':
+      return "<u1";
+    case 's':
+      return "<i2";
+    case 'S':
+      return "<u2";
+    case 'i':
+      return "<i4";
+    case 'I':
+      return "<u4";
+    case 'l':
+      return "<i8";
+    case 'L':
+      return "<u8";
+    case 'e':
+      return "<f2";
+    case 'f':
+      return "<f4";
+    case 'g':
+      return "<f8";
+    default:
+      return nullptr;
+  }
+}
+
+bool GetBit(std::uint8_t const* bits, std::size_t i) { return (bits[i / 8] >> (i % 8)) & 1; }
+
+// Copy `n` bits starting from `offset` into a new bitmap that starts from 0.
+std::vector<std::uint8_t> ShiftBits(std::uint8_t const* bits, std::size_t offset,
+                                    std::size_t n) {
+  std::vector<std::uint8_t> out(RBitField8::ComputeStorageSize(n), 0);
+  for (std::size_t i = 0; i < n; ++i) {
+    out[i / 8] |= static_cast<std::uint8_t>(GetBit(bits, i + offset) << (i % 8));
+  }
+  return out;
+}
+}  // anonymous namespace
+
+ArrowColumns::ArrowColumns(ArrowArray const* array, ArrowSchema const* schema) {
+  CHECK(array);
+  CHECK(schema);
+  CHECK(array->release) << "The Arrow array has been released.";
+  CHECK(schema->release) << "The Arrow schema has been released.";
+  CHECK_EQ(std::strcmp(schema->format, "+s"), 0)
+      << "Expecting a struct array (record batch) for the Arrow input, got: " << schema->format;
+  CHECK_EQ(array->n_children, schema->n_children);
+  CHECK(array->null_count == 0 || array->n_buffers == 0 || array->buffers[0] == nullptr)
+      << "Null rows are not supported in the Arrow record batch.";
+
+  auto n_samples = static_cast<std::size_t>(array->length);
+  columns_.resize(array->n_children);
+  for (std::int64_t fidx = 0; fidx < array->n_children; ++fidx) {
+    auto const* child = array->children[fidx];
+    auto const* child_schema = schema->children[fidx];
+    CHECK(child && child_schema);
+    CHECK_GE(child->length, array->offset + array->length);
+    // The parent offset is applied on top of the child offset.
+    auto offset = static_cast<std::size_t>(array->offset + child->offset);
+    StringView format{child_schema->format};
+    CHECK_GE(child->n_buffers, 2) << "Unsupported Arrow type: " << format;
+
+    auto& column = columns_[fidx];
+    column.shape[0] = n_samples;
+    column.strides[0] = 1;
+    column.n = n_samples;
+    column.is_contiguous = true;
+
+    auto const* values = static_cast<std::uint8_t const*>(child->buffers[1]);
+    if (format == StringView{"b"}) {
+      // Bit-packed boolean.
+      auto& buf = buffers_.emplace_back(n_samples);
+      for (std::size_t i = 0; i < n_samples; ++i) {
+        buf[i] = GetBit(values, i + offset);
+      }
+      column.AssignType(StringView{"|u1"});
+      column.data = buf.data();
+    } else {
+      // Dictionary-encoded columns are represented by their indices, which are used as
+      // the categorical codes.
+      auto typestr = ToTypeStr(format);
+      CHECK(typestr) << "Unsupported Arrow type: " << format;
+      column.AssignType(StringView{typestr});
+      column.data = values + offset * column.ElementSize();
+    }
+
+    // Validity bitmap, can be omitted when there's no null.
+    auto const* bits = static_cast<std::uint8_t const*>(child->buffers[0]);
+    if (bits == nullptr || child->null_count == 0) {
+      continue;
+    }
+    auto n_bytes = RBitField8::ComputeStorageSize(n_samples);
+    if (offset % 8 == 0) {
+      auto ptr = const_cast<std::uint8_t*>(bits + offset / 8);
+      column.valid = RBitField8{common::Span<std::uint8_t>{ptr, n_bytes}};
+    } else {
+      auto& buf = buffers_.emplace_back(ShiftBits(bits, offset, n_samples));
+      column.valid = RBitField8{common::Span<std::uint8_t>{buf.data(), n_bytes}};
+    }
+  }
+}
+}  // namespace xgboost::data
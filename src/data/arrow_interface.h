@@ -0,0 +1,93 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ *
+ * @brief Support for the Arrow C data interface.
+ *
+ *   https://arrow.apache.org/docs/format/CDataInterface.html
+ */
+#ifndef XGBOOST_DATA_ARROW_INTERFACE_H_
+#define XGBOOST_DATA_ARROW_INTERFACE_H_
+
+#include <cstdint>  // for int64_t, uint8_t
+#include <vector>   // for vector
+
+#include "array_interface.h"  // for ArrayInterface
+
+// The ABI is defined by the Arrow specification, and the definitions are meant to be
+// copied into any project that consumes it.
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+  // Array type description
+  const char* format;
+  const char* name;
+  const char* metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema** children;
+  struct ArrowSchema* dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowSchema*);
+  // Opaque producer-specific data
+  void* private_data;
+};
+
+struct ArrowArray {
+  // Array data description
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void** buffers;
+  struct ArrowArray** children;
+  struct ArrowArray* dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowArray*);
+  // Opaque producer-specific data
+  void* private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+namespace xgboost::data {
+/**
+ * @brief Columns of an Arrow record batch, viewed as array interfaces.
+ *
+ *   Numeric columns and the indices of dictionary-encoded columns are referenced
+ *   without copying. The validity bitmap is referenced directly unless the column has
+ *   an offset that's not a multiple of 8, in which case it's shifted into an owned
+ *   buffer. Boolean columns are bit-packed in Arrow and are expanded into bytes.
+ *
+ *   The record batch is owned by the caller, which must keep it alive as long as the
+ *   columns are used. The release callbacks are never called.
+ */
+class ArrowColumns {
+  std::vector<ArrayInterface<1>> columns_;
+  // Storage for the shifted validity bitmaps and the expanded boolean columns.
+  std::vector<std::vector<std::uint8_t>> buffers_;
+
+ public:
+  ArrowColumns() = default;
+  /**
+   * @param array  A struct array, as exported from an Arrow record batch or table.
+   * @param schema The schema of the array.
+   */
+  ArrowColumns(ArrowArray const* array, ArrowSchema const* schema);
+  // The columns might reference the owned buffers.
+  ArrowColumns(ArrowColumns const& that) = delete;
+  ArrowColumns& operator=(ArrowColumns const& that) = delete;
+  ArrowColumns(ArrowColumns&& that) = default;
+  ArrowColumns& operator=(ArrowColumns&& that) = default;
+
+  [[nodiscard]] std::vector<ArrayInterface<1>> const& Columns() const { return columns_; }
+};
+}  // namespace xgboost::data
+#endif  // XGBOOST_DATA_ARROW_INTERFACE_H_
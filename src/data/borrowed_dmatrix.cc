@@ -0,0 +1,171 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include "borrowed_dmatrix.h"
+
+#include <limits>   // for numeric_limits
+#include <memory>   // for make_shared
+#include <string>   // for to_string
+#include <utility>  // for move
+
+#include "../common/error_msg.h"    // for InconsistentMaxBin, MaxSampleSize
+#include "../common/hist_util.h"    // for HistogramCuts
+#include "../common/quantile.h"     // for HostSketchContainer
+#include "batch_utils.h"            // for CheckEmpty, RegenGHist
+#include "ellpack_page.h"           // for EllpackPage
+#include "gradient_index.h"         // for GHistIndexMatrix
+#include "quantile_dmatrix.h"       // for CountColumnSizes
+#include "simple_batch_iterator.h"  // for SimpleBatchIteratorImpl
+#include "xgboost/logging.h"        // for CHECK
+
+namespace xgboost::data {
+BorrowedDMatrix::BorrowedDMatrix(std::shared_ptr<DMatrixProxy> proxy, float missing,
+                                 std::int32_t nthread)
+    : proxy_{std::move(proxy)}, missing_{missing} {
+  CHECK(proxy_);
+  CHECK(proxy_->Ctx()->IsCPU()) << "Borrowed DMatrix only supports CPU data.";
+  fmat_ctx_.Init(Args{{"nthread", std::to_string(nthread)}});
+
+  info_.num_row_ = BatchSamples(proxy_.get());
+  info_.num_col_ = BatchColumns(proxy_.get());
+  column_sizes_.resize(info_.num_col_, 0);
+  info_.num_nonzero_ =
+      cpu_impl::CountColumnSizes(&fmat_ctx_, proxy_.get(), missing_, &column_sizes_);
+  info_.SynchronizeNumberOfColumns(&fmat_ctx_, DataSplitMode::kRow);
+}
+
+void BorrowedDMatrix::InitSparsePage() {
+  if (sparse_page_) {
+    return;
+  }
+  LOG(INFO) << "Copying the borrowed data into a sparse page.";
+  auto page = std::make_shared<SparsePage>();
+  HostAdapterDispatch(proxy_.get(), [&](auto const& batch) {
+    page->Push(batch, missing_, fmat_ctx_.Threads());
+  });
+  // Trailing empty rows.
+  auto& h_offset = page->offset.HostVector();
+  if (h_offset.size() < info_.num_row_ + 1) {
+    h_offset.resize(info_.num_row_ + 1, h_offset.back());
+  }
+  CHECK_EQ(page->data.Size(), info_.num_nonzero_);
+  sparse_page_ = std::move(page);
+}
+
+BatchSet<SparsePage> BorrowedDMatrix::GetRowBatches() {
+  std::lock_guard guard{lock_};
+  this->InitSparsePage();
+  auto begin_iter =
+      BatchIterator<SparsePage>(new SimpleBatchIteratorImpl<SparsePage>(sparse_page_));
+  return BatchSet<SparsePage>(begin_iter);
+}
+
+BatchSet<CSCPage> BorrowedDMatrix::GetColumnBatches(Context const* ctx) {
+  std::lock_guard guard{lock_};
+  if (!column_page_) {
+    this->InitSparsePage();
+    auto n = std::numeric_limits<decltype(Entry::index)>::max();
+    if (this->sparse_page_->Size() > n) {
+      error::MaxSampleSize(n);
+    }
+    column_page_.reset(new CSCPage(sparse_page_->GetTranspose(info_.num_col_, ctx->Threads())));
+  }
+  auto begin_iter = BatchIterator<CSCPage>(new SimpleBatchIteratorImpl<CSCPage>(column_page_));
+  return BatchSet<CSCPage>(begin_iter);
+}
+
+BatchSet<SortedCSCPage> BorrowedDMatrix::GetSortedColumnBatches(Context const* ctx) {
+  std::lock_guard guard{lock_};
+  if (!sorted_column_page_) {
+    this->InitSparsePage();
+    auto n = std::numeric_limits<decltype(Entry::index)>::max();
+    if (this->sparse_page_->Size() > n) {
+      error::MaxSampleSize(n);
+    }
+    sorted_column_page_.reset(
+        new SortedCSCPage(sparse_page_->GetTranspose(info_.num_col_, ctx->Threads())));
+    sorted_column_page_->SortRows(ctx->Threads());
+  }
+  auto begin_iter =
+      BatchIterator<SortedCSCPage>(new SimpleBatchIteratorImpl<SortedCSCPage>(sorted_column_page_));
+  return BatchSet<SortedCSCPage>(begin_iter);
+}
+
+BatchSet<EllpackPage> BorrowedDMatrix::GetEllpackBatches(Context const* ctx,
+                                                         BatchParam const& param) {
+  std::lock_guard guard{lock_};
+  detail::CheckEmpty(batch_param_, param);
+  if (ellpack_page_ && param.Initialized() && param.forbid_regen) {
+    CHECK(!detail::RegenGHist(batch_param_, param)) << error::InconsistentMaxBin();
+  }
+  if (!ellpack_page_ || detail::RegenGHist(batch_param_, param)) {
+    CHECK_GE(param.max_bin, 2);
+    // The ellpack page is generated from the sparse page, the data is copied to the device
+    // anyway.
+    if (ctx->IsCUDA()) {
+      ellpack_page_.reset(new EllpackPage(ctx, this, param));
+    } else {
+      auto cuda_ctx = ctx->MakeCUDA();
+      ellpack_page_.reset(new EllpackPage(&cuda_ctx, this, param));
+    }
+    batch_param_ = param.MakeCache();
+  }
+  auto begin_iter =
+      BatchIterator<EllpackPage>(new SimpleBatchIteratorImpl<EllpackPage>(ellpack_page_));
+  return BatchSet<EllpackPage>(begin_iter);
+}
+
+BatchSet<GHistIndexMatrix> BorrowedDMatrix::GetGradientIndex(Context const* ctx,
+                                                             BatchParam const& param) {
+  std::lock_guard guard{lock_};
+  detail::CheckEmpty(batch_param_, param);
+  if (gradient_index_ && param.Initialized() && param.forbid_regen) {
+    if (detail::RegenGHist(batch_param_, param)) {
+      CHECK_EQ(batch_param_.max_bin, param.max_bin) << error::InconsistentMaxBin();
+    }
+    CHECK(!detail::RegenGHist(batch_param_, param)) << "Inconsistent sparse threshold.";
+  }
+  if (!gradient_index_ || detail::RegenGHist(batch_param_, param)) {
+    CHECK_GE(param.max_bin, 2);
+    // The data is on CPU, use the context from initialization if the booster is on GPU.
+    auto const* cpu_ctx = ctx->IsCUDA() ? &fmat_ctx_ : ctx;
+    // Used only by approx.
+    auto sorted_sketch = param.regen;
+    if (param.hess.empty() && !sorted_sketch) {
+      // Sketch and quantise the borrowed data directly.
+      LOG(DEBUG) << "Generating new Gradient Index from the borrowed data.";
+      auto const& h_ft = info_.feature_types.ConstHostVector();
+      common::HistogramCuts cuts;
+      HostAdapterDispatch(proxy_.get(), [&](auto const& batch) {
+        common::HostSketchContainer sketch{cpu_ctx, param.max_bin, h_ft, column_sizes_,
+                                           !info_.group_ptr_.empty()};
+        sketch.PushAdapterBatch(batch, 0, info_, missing_);
+        sketch.MakeCuts(cpu_ctx, info_, &cuts);
+      });
+      auto page = std::make_shared<GHistIndexMatrix>(info_, std::move(cuts), param.max_bin);
+      HostAdapterDispatch(proxy_.get(), [&](auto const& batch) {
+        page->PushAdapterBatch(cpu_ctx, 0, 0, batch, missing_, h_ft, param.sparse_thresh,
+                               info_.num_row_);
+      });
+      gradient_index_ = std::move(page);
+    } else {
+      // The weighted sketch needs the sparse page.
+      gradient_index_.reset(new GHistIndexMatrix{cpu_ctx, this, param.max_bin,
+                                                 param.sparse_thresh, sorted_sketch, param.hess});
+    }
+    batch_param_ = param.MakeCache();
+  }
+  auto begin_iter = BatchIterator<GHistIndexMatrix>(
+      new SimpleBatchIteratorImpl<GHistIndexMatrix>(gradient_index_));
+  return BatchSet<GHistIndexMatrix>(begin_iter);
+}
+
+BatchSet<ExtSparsePage> BorrowedDMatrix::GetExtBatches(Context const*, BatchParam const&) {
+  std::lock_guard guard{lock_};
+  this->InitSparsePage();
+  auto casted = std::make_shared<ExtSparsePage>(sparse_page_);
+  auto begin_iter =
+      BatchIterator<ExtSparsePage>(new SimpleBatchIteratorImpl<ExtSparsePage>(casted));
+  return BatchSet<ExtSparsePage>(begin_iter);
+}
+}  // namespace xgboost::data
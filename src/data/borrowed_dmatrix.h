@@ -0,0 +1,88 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#pragma once
+
+#include <cstdint>  // for int32_t
+#include <memory>   // for shared_ptr
+#include <mutex>    // for recursive_mutex
+#include <vector>   // for vector
+
+#include "proxy_dmatrix.h"  // for DMatrixProxy
+#include "xgboost/base.h"   // for bst_idx_t
+#include "xgboost/data.h"   // for DMatrix, MetaInfo, BatchParam
+
+namespace xgboost::data {
+/**
+ * @brief DMatrix that references the input buffers instead of copying them.
+ *
+ *   The caller owns the buffers and must keep them alive and unchanged for the lifetime of
+ *   the DMatrix. The data is accessed through the adapter batch held by the proxy.
+ *
+ *   - The gradient index for the `hist` tree method is built directly from the borrowed
+ *     buffers, the data is never copied into a `SparsePage`.
+ *   - Prediction reads the borrowed buffers directly.
+ *   - Other pages, like the CSC page for the `exact` tree method or the weighted sketch for
+ *     `approx`, are generated from a `SparsePage`. The page is copied from the buffers when
+ *     it's first requested and is kept by the DMatrix afterward.
+ *
+ *   Only CPU input with row-split is supported.
+ */
+class BorrowedDMatrix : public DMatrix {
+  Context fmat_ctx_;
+  MetaInfo info_;
+  std::shared_ptr<DMatrixProxy> proxy_;
+  float missing_;
+  std::vector<bst_idx_t> column_sizes_;
+
+  // Serialize the generation of pages between concurrent learners. Recursive as the
+  // generation of a page can request the sparse page from this DMatrix.
+  std::recursive_mutex lock_;
+  std::shared_ptr<SparsePage> sparse_page_{nullptr};
+  std::shared_ptr<CSCPage> column_page_{nullptr};
+  std::shared_ptr<SortedCSCPage> sorted_column_page_{nullptr};
+  std::shared_ptr<EllpackPage> ellpack_page_{nullptr};
+  std::shared_ptr<GHistIndexMatrix> gradient_index_{nullptr};
+  BatchParam batch_param_;
+
+  // Copy the borrowed data into a sparse page, must be called with the lock.
+  void InitSparsePage();
+
+ public:
+  /**
+   * @param proxy A proxy with CPU data, owned by this DMatrix. The data can not be reset
+   *              after the DMatrix is created.
+   */
+  explicit BorrowedDMatrix(std::shared_ptr<DMatrixProxy> proxy, float missing,
+                           std::int32_t nthread);
+  ~BorrowedDMatrix() override = default;
+
+  [[nodiscard]] MetaInfo& Info() override { return info_; }
+  [[nodiscard]] MetaInfo const& Info() const override { return info_; }
+  [[nodiscard]] Context const* Ctx() const override { return &fmat_ctx_; }
+
+  [[nodiscard]] DMatrixProxy const* Proxy() const { return proxy_.get(); }
+  [[nodiscard]] float Missing() const { return missing_; }
+
+  DMatrix* Slice(common::Span<std::int32_t const>) override {
+    LOG(FATAL) << "Slicing DMatrix is not supported for borrowed data.";
+    return nullptr;
+  }
+  DMatrix* SliceCol(std::int32_t, std::int32_t) override {
+    LOG(FATAL) << "Slicing DMatrix columns is not supported for borrowed data.";
+    return nullptr;
+  }
+
+ protected:
+  BatchSet<SparsePage> GetRowBatches() override;
+  BatchSet<CSCPage> GetColumnBatches(Context const* ctx) override;
+  BatchSet<SortedCSCPage> GetSortedColumnBatches(Context const* ctx) override;
+  BatchSet<EllpackPage> GetEllpackBatches(Context const* ctx, BatchParam const& param) override;
+  BatchSet<GHistIndexMatrix> GetGradientIndex(Context const* ctx, BatchParam const& param) override;
+  BatchSet<ExtSparsePage> GetExtBatches(Context const* ctx, BatchParam const& param) override;
+
+  bool EllpackExists() const override { return static_cast<bool>(ellpack_page_); }
+  bool GHistIndexExists() const override { return static_cast<bool>(gradient_index_); }
+  bool SparsePageExists() const override { return static_cast<bool>(sparse_page_); }
+};
+}  // namespace xgboost::data
@@ -6,16 +6,16 @@
 
 #include <dmlc/registry.h>  // for DMLC_REGISTRY_ENABLE, DMLC_REGISTRY_LINK_TAG
 
-#include <algorithm>    // for copy, max, none_of, min
-#include <atomic>       // for atomic
+#include <algorithm>    // for copy, max, min, min_element
 #include <cmath>        // for abs
 #include <cstdint>      // for uint64_t, int32_t, uint8_t, uint32_t
 #include <cstring>      // for size_t, strcmp, memcpy
 #include <iostream>     // for operator<<, basic_ostream, basic_ostream::op...
+#include <limits>       // for numeric_limits
 #include <map>          // for map, operator!=
 #include <numeric>      // for accumulate, partial_sum
 #include <tuple>        // for get, apply
-#include <type_traits>  // for remove_pointer_t, remove_reference
+#include <type_traits>  // for remove_pointer_t, remove_reference, remove_reference_t
 
 #include "../collective/allgather.h"          // for AllgatherStrings
 #include "../collective/allreduce.h"          // for Allreduce
@@ -27,6 +27,7 @@
 #include "../common/io.h"                     // for PeekableInStream
 #include "../common/linalg_op.h"              // for ElementWiseTransformHost
 #include "../common/math.h"                   // for CheckNAN
+#include "../common/memory_stats.h"           // for MemTagScope
 #include "../common/numeric.h"                // for Iota, RunLengthEncode
 #include "../common/threading_utils.h"        // for ParallelFor
 #include "../common/version.h"                // for Version
@@ -45,9 +46,10 @@
 #include "ellpack_page.h"                     // for EllpackPage
 #include "file_iterator.h"                    // for ValidateFileFormat, FileIterator, Next, Reset
 #include "gradient_index.h"                   // for GHistIndexMatrix
+#include "libsvm_parser.h"                    // for TryCreateNativeParser
 #include "simple_dmatrix.h"                   // for SimpleDMatrix
 #include "sparse_page_writer.h"               // for SparsePageFormatReg
-#include "validation.h"                       // for LabelsCheck, WeightsCheck, ValidateQueryGroup
+#include "validation.h"                       // for FindFirstInvalid, LabelsCheck, WeightsCheck
 #include "xgboost/base.h"                     // for bst_group_t, bst_idx_t, bst_float, bst_ulong
 #include "xgboost/context.h"                  // for Context
 #include "xgboost/host_device_vector.h"       // for HostDeviceVector
@@ -369,6 +371,23 @@ std::vector<T> Gather(const std::vector<T>& in, common::Span<bst_idx_t const> ri
   }
   return out;
 }
+
+/**
+ * @brief Tag the buffers of a sparse page that are resized during the lifetime of this
+ *        object. The host vectors are modified through references, the new sizes are
+ *        registered when the scope ends.
+ */
+class SparsePageMemScope {
+  common::MemTagScope scope_{common::MemTag::kSparsePage};
+  SparsePage const* page_;
+
+ public:
+  explicit SparsePageMemScope(SparsePage const* page) : page_{page} {}
+  ~SparsePageMemScope() {
+    page_->data.ConstHostVector();
+    page_->offset.ConstHostVector();
+  }
+};
 }  // namespace
 
 namespace cuda_impl {
@@ -545,9 +564,11 @@ void MetaInfo::SetInfoFromHost(Context const* ctx, StringView key, Json arr) {
       size_t n_targets = this->labels.Size() / this->num_row_;
       this->labels.Reshape(this->num_row_, n_targets);
     }
-    auto const& h_labels = labels.Data()->ConstHostVector();
-    auto valid = std::none_of(h_labels.cbegin(), h_labels.cend(), data::LabelsCheck{});
-    CHECK(valid) << "Label contains NaN, infinity or a value too large.";
+    auto h_labels = labels.Data()->ConstHostSpan();
+    auto invalid = data::FindFirstInvalid(ctx->Threads(), h_labels, data::LabelsCheck{});
+    CHECK_EQ(invalid, h_labels.size())
+        << "Label contains NaN, infinity or a value too large. Invalid label: "
+        << h_labels[invalid] << " at index: " << invalid;
     return;
   }
   // uint info
@@ -583,20 +604,22 @@ void MetaInfo::SetInfoFromHost(Context const* ctx, StringView key, Json arr) {
   CopyTensorInfoImpl<1>(ctx, arr, &t);
   if (key == "weight") {
     this->weights_ = std::move(*t.Data());
-    auto const& h_weights = this->weights_.ConstHostVector();
-    auto valid = std::none_of(h_weights.cbegin(), h_weights.cend(),
-                              [](float w) { return w < 0 || std::isinf(w) || std::isnan(w); });
-    CHECK(valid) << "Weights must be positive values.";
+    auto h_weights = this->weights_.ConstHostSpan();
+    auto invalid = data::FindFirstInvalid(ctx->Threads(), h_weights, data::WeightsCheck{});
+    CHECK_EQ(invalid, h_weights.size()) << "Weights must be positive values. Invalid weight: "
+                                        << h_weights[invalid] << " at index: " << invalid;
   } else if (key == "label_lower_bound") {
     this->labels_lower_bound_ = std::move(*t.Data());
   } else if (key == "label_upper_bound") {
     this->labels_upper_bound_ = std::move(*t.Data());
   } else if (key == "feature_weights") {
     this->feature_weights = std::move(*t.Data());
-    auto const& h_feature_weights = feature_weights.ConstHostVector();
-    bool valid =
-        std::none_of(h_feature_weights.cbegin(), h_feature_weights.cend(), data::WeightsCheck{});
-    CHECK(valid) << "Feature weight must be greater than 0.";
+    auto h_feature_weights = feature_weights.ConstHostSpan();
+    auto invalid =
+        data::FindFirstInvalid(ctx->Threads(), h_feature_weights, data::WeightsCheck{});
+    CHECK_EQ(invalid, h_feature_weights.size())
+        << "Feature weight must be greater than 0. Invalid weight: " << h_feature_weights[invalid]
+        << " at feature: " << invalid;
   } else {
     LOG(FATAL) << "Unknown key for MetaInfo: " << key;
   }
@@ -877,7 +900,14 @@ DMatrix* TryLoadBinary(std::string fname, bool silent) {
         dmlc::ByteSwap(&magic, sizeof(magic), 1);
       }
       if (magic == data::SimpleDMatrix::kMagic) {
-        DMatrix* dmat = new data::SimpleDMatrix(&is);
+        DMatrix* dmat{nullptr};
+        auto is_local = fname.find("://") == std::string::npos;
+        if (is_local && DMLC_IO_NO_ENDIAN_SWAP) {
+          // Copy the page from a memory map instead of reading it through the stream.
+          dmat = new data::SimpleDMatrix(fname, common::OmpGetNumThreads(0));
+        } else {
+          dmat = new data::SimpleDMatrix(&is);
+        }
         if (!silent) {
           LOG(INFO) << dmat->Info().num_row_ << 'x' << dmat->Info().num_col_ << " matrix with "
                     << dmat->Info().num_nonzero_ << " entries loaded from " << fname;
@@ -913,8 +943,12 @@ DMatrix* DMatrix::Load(const std::string& uri, bool silent, DataSplitMode data_s
 
   if (cache_file.empty()) {
     fname = data::ValidateFileFormat(fname);
-    std::unique_ptr<dmlc::Parser<std::uint32_t>> parser(
-        dmlc::Parser<std::uint32_t>::Create(fname.c_str(), partid, npart, "auto"));
+    // Prefer the parallel native parser, falls back to dmlc for anything it doesn't
+    // support.
+    auto parser = data::TryCreateNativeParser(fname, Context{}.Threads());
+    if (!parser) {
+      parser.reset(dmlc::Parser<std::uint32_t>::Create(fname.c_str(), partid, npart, "auto"));
+    }
     data::FileAdapter adapter(parser.get());
     dmat = DMatrix::Create(&adapter, std::numeric_limits<float>::quiet_NaN(), Context{}.Threads(),
                            cache_file, data_split_mode);
@@ -939,9 +973,10 @@ template <typename DataIterHandle, typename DMatrixHandle, typename DataIterRese
           typename XGDMatrixCallbackNext>
 DMatrix* DMatrix::Create(DataIterHandle iter, DMatrixHandle proxy, std::shared_ptr<DMatrix> ref,
                          DataIterResetCallback* reset, XGDMatrixCallbackNext* next, float missing,
-                         int nthread, bst_bin_t max_bin, std::int64_t max_quantile_blocks) {
+                         int nthread, bst_bin_t max_bin, std::int64_t max_quantile_blocks,
+                         bool single_pass, double sketch_sample_eps) {
   return new data::IterativeDMatrix(iter, proxy, ref, reset, next, missing, nthread, max_bin,
-                                    max_quantile_blocks);
+                                    max_quantile_blocks, single_pass, sketch_sample_eps);
 }
 
 template <typename DataIterHandle, typename DMatrixHandle, typename DataIterResetCallback,
@@ -965,7 +1000,7 @@ template DMatrix*
 DMatrix::Create<DataIterHandle, DMatrixHandle, DataIterResetCallback, XGDMatrixCallbackNext>(
     DataIterHandle iter, DMatrixHandle proxy, std::shared_ptr<DMatrix> ref,
     DataIterResetCallback* reset, XGDMatrixCallbackNext* next, float missing, int nthread,
-    int max_bin, std::int64_t max_quantile_blocks);
+    int max_bin, std::int64_t max_quantile_blocks, bool single_pass, double sketch_sample_eps);
 
 template DMatrix* DMatrix::Create<DataIterHandle, DMatrixHandle, DataIterResetCallback,
                                   XGDMatrixCallbackNext>(DataIterHandle iter, DMatrixHandle proxy,
@@ -1013,7 +1048,7 @@ SparsePage SparsePage::GetTranspose(int num_columns, int32_t n_threads) const {
   long batch_size = static_cast<long>(this->Size());  // NOLINT(*)
   auto page = this->GetView();
   common::ParallelFor(batch_size, n_threads, [&](long i) {  // NOLINT(*)
-    int tid = omp_get_thread_num();
+    int tid = common::ThreadIdx();
     auto inst = page[i];
     for (const auto& entry : inst) {
       builder.AddBudget(entry.index, tid);
@@ -1021,7 +1056,7 @@ SparsePage SparsePage::GetTranspose(int num_columns, int32_t n_threads) const {
   });
   builder.InitStorage();
   common::ParallelFor(batch_size, n_threads, [&](long i) {  // NOLINT(*)
-    int tid = omp_get_thread_num();
+    int tid = common::ThreadIdx();
     auto inst = page[i];
     for (const auto& entry : inst) {
       builder.Push(
@@ -1048,7 +1083,7 @@ bool SparsePage::IsIndicesSorted(int32_t n_threads) const {
   common::ParallelFor(this->Size(), n_threads, [&](auto i) {
     auto beg = h_offset[i];
     auto end = h_offset[i + 1];
-    is_sorted_tloc[omp_get_thread_num()] +=
+    is_sorted_tloc[common::ThreadIdx()] +=
         !!std::is_sorted(h_data.begin() + beg, h_data.begin() + end, Entry::CmpIndex);
   });
   auto is_sorted = std::accumulate(is_sorted_tloc.cbegin(), is_sorted_tloc.cend(),
@@ -1085,6 +1120,7 @@ void SparsePage::SortRows(int32_t n_threads) {
 }
 
 void SparsePage::Push(const SparsePage &batch) {
+  SparsePageMemScope scope{this};
   auto& data_vec = data.HostVector();
   auto& offset_vec = offset.HostVector();
   const auto& batch_offset_vec = batch.offset.HostVector();
@@ -1103,57 +1139,60 @@ void SparsePage::Push(const SparsePage &batch) {
 }
 
 template <typename AdapterBatchT>
-uint64_t SparsePage::Push(const AdapterBatchT& batch, float missing, int nthread) {
-  constexpr bool kIsRowMajor = AdapterBatchT::kIsRowMajor;
-  // Allow threading only for row-major case as column-major requires O(nthread*batch_size) memory
-  nthread = kIsRowMajor ? nthread : 1;
-  if (!kIsRowMajor) {
-    CHECK_EQ(nthread, 1);
-  }
-  auto& offset_vec = offset.HostVector();
-  auto& data_vec = data.HostVector();
-
-  size_t builder_base_row_offset = this->Size();
-  common::ParallelGroupBuilder<
-      Entry, std::remove_reference<decltype(offset_vec)>::type::value_type, kIsRowMajor>
-      builder(&offset_vec, &data_vec, builder_base_row_offset);
-  // Estimate expected number of rows by using last element in batch
-  // This is not required to be exact but prevents unnecessary resizing
-  size_t expected_rows = 0;
-  if (batch.Size() > 0) {
-    auto last_line = batch.GetLine(batch.Size() - 1);
-    if (last_line.Size() > 0) {
-      expected_rows =
-          last_line.GetElement(last_line.Size() - 1).row_idx - base_rowid;
+uint64_t SparsePage::Push(const AdapterBatchT& input, float missing, int nthread) {
+  SparsePageMemScope scope{this};
+  // Resolve the data type once for the batch, the loops below read every element.
+  return data::DispatchTypedBatch(input, [&](auto const& batch) -> uint64_t {
+    constexpr bool kIsRowMajor = std::remove_reference_t<decltype(batch)>::kIsRowMajor;
+    // Allow threading only for row-major case as column-major requires O(nthread*batch_size) memory
+    nthread = kIsRowMajor ? nthread : 1;
+    if (!kIsRowMajor) {
+      CHECK_EQ(nthread, 1);
     }
-  }
-  size_t batch_size = batch.Size();
-  expected_rows = kIsRowMajor ? batch_size : expected_rows;
-  uint64_t max_columns = 0;
-  if (batch_size == 0) {
-    return max_columns;
-  }
-  const size_t thread_size = batch_size / nthread;
-
-  builder.InitBudget(expected_rows, nthread);
-  std::vector<std::vector<uint64_t>> max_columns_vector(nthread, std::vector<uint64_t>{0});
-  dmlc::OMPException exec;
-  std::atomic<bool> valid{true};
-  // First-pass over the batch counting valid elements
-#pragma omp parallel num_threads(nthread)
-  {
-    exec.Run([&]() {
-      int tid = omp_get_thread_num();
+    auto& offset_vec = offset.HostVector();
+    auto& data_vec = data.HostVector();
+
+    size_t builder_base_row_offset = this->Size();
+    common::ParallelGroupBuilder<
+        Entry, std::remove_reference<decltype(offset_vec)>::type::value_type, kIsRowMajor>
+        builder(&offset_vec, &data_vec, builder_base_row_offset);
+    // Estimate expected number of rows by using last element in batch
+    // This is not required to be exact but prevents unnecessary resizing
+    size_t expected_rows = 0;
+    if (batch.Size() > 0) {
+      auto last_line = batch.GetLine(batch.Size() - 1);
+      if (last_line.Size() > 0) {
+        expected_rows =
+            last_line.GetElement(last_line.Size() - 1).row_idx - base_rowid;
+      }
+    }
+    size_t batch_size = batch.Size();
+    expected_rows = kIsRowMajor ? batch_size : expected_rows;
+    uint64_t max_columns = 0;
+    if (batch_size == 0) {
+      return max_columns;
+    }
+    const size_t thread_size = batch_size / nthread;
+
+    builder.InitBudget(expected_rows, nthread);
+    std::vector<std::vector<uint64_t>> max_columns_vector(nthread, std::vector<uint64_t>{0});
+    // The first row with `inf` found by each thread.
+    auto constexpr kValid = std::numeric_limits<bst_idx_t>::max();
+    std::vector<bst_idx_t> invalid_rows(nthread, kValid);
+    bool const check_inf = !std::isinf(missing);
+    // First-pass over the batch counting valid elements
+    common::ParallelRegion(nthread, [&](std::int32_t tid) {
       size_t begin = tid*thread_size;
       size_t end = tid != (nthread-1) ? (tid+1)*thread_size : batch_size;
       uint64_t& max_columns_local = max_columns_vector[tid][0];
+      bst_idx_t invalid_row = kValid;
 
       for (size_t i = begin; i < end; ++i) {
         auto line = batch.GetLine(i);
         for (auto j = 0ull; j < line.Size(); j++) {
           data::COOTuple const& element = line.GetElement(j);
-          if (!std::isinf(missing) && std::isinf(element.value)) {
-            valid = false;
+          if (XGBOOST_EXPECT(check_inf && std::isinf(element.value), false)) {
+            invalid_row = std::min(invalid_row, element.row_idx);
           }
           const size_t key = element.row_idx - base_rowid;
           CHECK_GE(key,  builder_base_row_offset);
@@ -1167,22 +1206,20 @@ uint64_t SparsePage::Push(const AdapterBatchT& batch, float missing, int nthread
           }
         }
       }
+      invalid_rows[tid] = invalid_row;
     });
-  }
-  exec.Rethrow();
-  CHECK(valid) << error::InfInData();
-  for (const auto & max : max_columns_vector) {
-    max_columns = std::max(max_columns, max[0]);
-  }
+    auto first_invalid = *std::min_element(invalid_rows.cbegin(), invalid_rows.cend());
+    CHECK_EQ(first_invalid, kValid) << error::InfInData() << ". Found `inf` at row: "
+                                    << first_invalid;
+    for (const auto & max : max_columns_vector) {
+      max_columns = std::max(max_columns, max[0]);
+    }
 
-  builder.InitStorage();
+    builder.InitStorage();
 
-  // Second pass over batch, placing elements in correct position
-  auto is_valid = data::IsValidFunctor{missing};
-#pragma omp parallel num_threads(nthread)
-  {
-    exec.Run([&]() {
-      int tid = omp_get_thread_num();
+    // Second pass over batch, placing elements in correct position
+    auto is_valid = data::IsValidFunctor{missing};
+    common::ParallelRegion(nthread, [&](std::int32_t tid) {
       size_t begin = tid * thread_size;
       size_t end = tid != (nthread - 1) ? (tid + 1) * thread_size : batch_size;
       for (size_t i = begin; i < end; ++i) {
@@ -1196,12 +1233,12 @@ uint64_t SparsePage::Push(const AdapterBatchT& batch, float missing, int nthread
         }
       }
     });
-  }
-  exec.Rethrow();
-  return max_columns;
+    return max_columns;
+  });
 }
 
 void SparsePage::PushCSC(const SparsePage &batch) {
+  SparsePageMemScope scope{this};
   std::vector<xgboost::Entry>& self_data = data.HostVector();
   std::vector<bst_idx_t>& self_offset = offset.HostVector();
 
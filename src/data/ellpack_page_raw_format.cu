@@ -117,7 +117,8 @@ template <typename T>
   dh::DefaultStream().Sync();
 
   if (new_page) {
-    return fo->Share()->pages.back()->MemCostBytes();
+    auto cache = fo->Share();
+    return cache->PageBytes(cache->pages.size() - 1);
   } else {
     return InvalidPageSize();
   }
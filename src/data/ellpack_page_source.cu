@@ -1,5 +1,5 @@
 /**
- * Copyright 2019-2024, XGBoost contributors
+ * Copyright 2019-2025, XGBoost contributors
  */
 #include <algorithm>  // for count_if
 #include <cstddef>    // for size_t
@@ -8,8 +8,12 @@
 #include <numeric>    // for accumulate
 #include <utility>    // for move
 
+#include <thrust/iterator/counting_iterator.h>  // for make_counting_iterator
+#include <thrust/scan.h>                        // for inclusive_scan
+
 #include "../common/common.h"               // for safe_cuda
 #include "../common/common.h"               // for HumanMemUnit
+#include "../common/compressed_iterator.h"  // for CompressedBufferWriter, CompressedIterator
 #include "../common/cuda_rt_utils.h"        // for SetDevice
 #include "../common/device_helpers.cuh"     // for CUDAStreamView, DefaultStream
 #include "../common/ref_resource_view.cuh"  // for MakeFixedVecWithCudaMalloc
@@ -40,6 +44,158 @@ namespace {
 }
 }  // anonymous namespace
 
+/**
+ * @brief Sparse host page without the null padding.
+ *
+ *   Rows in a sparse Ellpack page are padded to the row stride with null values, which
+ *   can be the majority of the page when the row length varies. Only the valid symbols of
+ *   each row are kept in the host memory, along with the length of each row. Both are
+ *   bit-packed with the same compressed format as the Ellpack page. The page crosses the
+ *   PCIe bus in this form and is padded again by the device.
+ */
+struct EllpackCompactPage {
+  // Packed row lengths, the alphabet size is the row stride plus 1.
+  common::RefResourceView<common::CompressedByteT> row_sizes;
+  // Size of the padded gidx buffer in bytes.
+  std::size_t n_padded_bytes{0};
+};
+
+namespace {
+// Not worth the expansion during read if the compact page is not much smaller.
+constexpr double kMaxCompactRatio = 0.75;
+// A host page is moved to the device after being read this many times.
+constexpr std::int64_t kHotPageReads = 2;
+
+[[nodiscard]] bst_idx_t SparseNullValue(EllpackPageImpl const* page) {
+  return page->NumSymbols() - 1;
+}
+
+/**
+ * @brief Remove the null padding of a device page and store the result in the host.
+ *
+ * @param page The page in the device memory.
+ * @param out  Output host page, only the gidx buffer is set.
+ *
+ * @return Null if the page is not compacted.
+ */
+[[nodiscard]] std::unique_ptr<EllpackCompactPage> CompactPage(Context const* ctx,
+                                                              EllpackPageImpl const* page,
+                                                              EllpackPageImpl* out) {
+  if (page->n_rows == 0 || page->IsDenseCompressed()) {
+    // Null values in a dense page are missing values instead of padding.
+    return nullptr;
+  }
+  auto cuctx = ctx->CUDACtx();
+  auto n_rows = page->n_rows;
+  auto row_stride = page->info.row_stride;
+  auto null = SparseNullValue(page);
+  auto d_src = common::CompressedIterator<std::uint32_t>{page->gidx_buffer.data(),
+                                                         page->NumSymbols()};
+
+  // Valid symbols are sorted and placed before the padding in each row.
+  dh::caching_device_vector<bst_idx_t> row_ptr(n_rows + 1, 0);
+  auto d_row_ptr = dh::ToSpan(row_ptr);
+  dh::LaunchN(n_rows, cuctx->Stream(), [=] __device__(std::size_t ridx) {
+    auto beg = ridx * row_stride;
+    bst_idx_t n_valid = 0;
+    while (n_valid < row_stride && d_src[beg + n_valid] != null) {
+      ++n_valid;
+    }
+    d_row_ptr[ridx + 1] = n_valid;
+  });
+  thrust::inclusive_scan(cuctx->CTP(), row_ptr.begin() + 1, row_ptr.end(), row_ptr.begin() + 1);
+  bst_idx_t n_valid{0};
+  dh::safe_cuda(cudaMemcpyAsync(&n_valid, d_row_ptr.data() + n_rows, sizeof(n_valid),
+                                cudaMemcpyDeviceToHost, cuctx->Stream()));
+  cuctx->Stream().Sync();
+
+  auto n_symbol_bytes =
+      common::CompressedBufferWriter::CalculateBufferSize(n_valid, page->NumSymbols());
+  auto n_size_bytes = common::CompressedBufferWriter::CalculateBufferSize(n_rows, row_stride + 1);
+  if (static_cast<double>(n_symbol_bytes + n_size_bytes) >
+      static_cast<double>(page->gidx_buffer.size_bytes()) * kMaxCompactRatio) {
+    return nullptr;
+  }
+
+  dh::caching_device_vector<common::CompressedByteT> symbols(n_symbol_bytes, 0);
+  dh::caching_device_vector<common::CompressedByteT> sizes(n_size_bytes, 0);
+  auto d_symbols = symbols.data().get();
+  auto d_sizes = sizes.data().get();
+  common::CompressedBufferWriter symbol_writer{page->NumSymbols()};
+  common::CompressedBufferWriter size_writer{row_stride + 1};
+  dh::LaunchN(n_rows * row_stride, cuctx->Stream(), [=] __device__(std::size_t i) mutable {
+    auto ridx = i / row_stride;
+    auto k = i % row_stride;
+    auto beg = d_row_ptr[ridx];
+    auto n = d_row_ptr[ridx + 1] - beg;
+    if (k == 0) {
+      size_writer.AtomicWriteSymbol(d_sizes, n, ridx);
+    }
+    if (k < n) {
+      symbol_writer.AtomicWriteSymbol(d_symbols, d_src[i], beg + k);
+    }
+  });
+
+  auto compact = std::make_unique<EllpackCompactPage>();
+  compact->n_padded_bytes = page->gidx_buffer.size_bytes();
+  compact->row_sizes = common::MakeFixedVecWithPinnedMalloc<common::CompressedByteT>(n_size_bytes);
+  out->gidx_buffer = common::MakeFixedVecWithPinnedMalloc<common::CompressedByteT>(n_symbol_bytes);
+  dh::safe_cuda(cudaMemcpyAsync(compact->row_sizes.data(), d_sizes, n_size_bytes,
+                                cudaMemcpyDefault, cuctx->Stream()));
+  dh::safe_cuda(cudaMemcpyAsync(out->gidx_buffer.data(), d_symbols, n_symbol_bytes,
+                                cudaMemcpyDefault, cuctx->Stream()));
+  cuctx->Stream().Sync();
+  return compact;
+}
+
+/**
+ * @brief Copy a compact page to the device and restore the null padding.
+ *
+ * @return The padded gidx buffer in the device memory.
+ */
+[[nodiscard]] common::RefResourceView<common::CompressedByteT> ExpandPage(
+    Context const* ctx, EllpackPageImpl const* page, EllpackCompactPage const& compact) {
+  auto cuctx = ctx->CUDACtx();
+  auto n_rows = page->n_rows;
+  auto row_stride = page->info.row_stride;
+  auto null = SparseNullValue(page);
+
+  dh::caching_device_vector<common::CompressedByteT> symbols(page->gidx_buffer.size());
+  dh::caching_device_vector<common::CompressedByteT> sizes(compact.row_sizes.size());
+  dh::safe_cuda(cudaMemcpyAsync(symbols.data().get(), page->gidx_buffer.data(),
+                                page->gidx_buffer.size_bytes(), cudaMemcpyDefault,
+                                cuctx->Stream()));
+  dh::safe_cuda(cudaMemcpyAsync(sizes.data().get(), compact.row_sizes.data(),
+                                compact.row_sizes.size_bytes(), cudaMemcpyDefault,
+                                cuctx->Stream()));
+  auto d_symbols = common::CompressedIterator<std::uint32_t>{symbols.data().get(),
+                                                             page->NumSymbols()};
+  auto d_sizes = common::CompressedIterator<bst_idx_t>{sizes.data().get(), row_stride + 1};
+
+  dh::caching_device_vector<bst_idx_t> row_ptr(n_rows + 1, 0);
+  auto size_it = dh::MakeTransformIterator<bst_idx_t>(
+      thrust::make_counting_iterator(0ul),
+      [=] __device__(std::size_t ridx) { return d_sizes[ridx]; });
+  thrust::inclusive_scan(cuctx->CTP(), size_it, size_it + n_rows, row_ptr.begin() + 1);
+  auto d_row_ptr = dh::ToSpan(row_ptr);
+
+  auto gidx_buffer =
+      common::MakeFixedVecWithCudaMalloc<common::CompressedByteT>(ctx, compact.n_padded_bytes, 0);
+  auto d_gidx = gidx_buffer.data();
+  common::CompressedBufferWriter writer{page->NumSymbols()};
+  dh::LaunchN(n_rows * row_stride, cuctx->Stream(), [=] __device__(std::size_t i) mutable {
+    auto ridx = i / row_stride;
+    auto k = i % row_stride;
+    auto beg = d_row_ptr[ridx];
+    auto n = d_row_ptr[ridx + 1] - beg;
+    bst_idx_t symbol = k < n ? d_symbols[beg + k] : null;
+    writer.AtomicWriteSymbol(d_gidx, symbol, i);
+  });
+  cuctx->Stream().Sync();
+  return gidx_buffer;
+}
+}  // anonymous namespace
+
 /**
  * Cache
  */
@@ -48,25 +204,37 @@ EllpackMemCache::EllpackMemCache(EllpackCacheInfo cinfo)
       buffer_bytes{std::move(cinfo.buffer_bytes)},
       buffer_rows{std::move(cinfo.buffer_rows)},
       prefer_device{cinfo.prefer_device},
-      max_num_device_pages{cinfo.max_num_device_pages} {
+      max_num_device_pages{cinfo.max_num_device_pages},
+      direct_access{cinfo.direct_access} {
   CHECK_EQ(buffer_bytes.size(), buffer_rows.size());
 }
 
 EllpackMemCache::~EllpackMemCache() = default;
 
 [[nodiscard]] std::size_t EllpackMemCache::SizeBytes() const {
-  auto it = common::MakeIndexTransformIter([&](auto i) { return pages.at(i)->MemCostBytes(); });
+  auto it = common::MakeIndexTransformIter([&](auto i) { return this->PageBytes(i); });
   using T = std::iterator_traits<decltype(it)>::value_type;
   return std::accumulate(it, it + pages.size(), static_cast<T>(0));
 }
 
+[[nodiscard]] std::size_t EllpackMemCache::PageBytes(std::int32_t k) const {
+  auto const& page = this->pages.at(k);
+  auto const& compact = this->compact.at(k);
+  if (!compact) {
+    return page->MemCostBytes();
+  }
+  return page->MemCostBytes() - page->gidx_buffer.size_bytes() + compact->n_padded_bytes;
+}
+
 [[nodiscard]] EllpackPageImpl const* EllpackMemCache::At(std::int32_t k) const {
   return this->pages.at(k).get();
 }
 
 [[nodiscard]] std::int64_t EllpackMemCache::NumDevicePages() const {
-  return std::count_if(this->pages.cbegin(), this->pages.cend(),
-                       [](auto const& page) { return IsDevicePage(page.get()); });
+  auto n_hot = std::count_if(this->hot_pages.cbegin(), this->hot_pages.cend(),
+                             [](auto const& hot) { return !hot.empty(); });
+  return n_hot + std::count_if(this->pages.cbegin(), this->pages.cend(),
+                               [](auto const& page) { return IsDevicePage(page.get()); });
 }
 
 /**
@@ -76,6 +244,44 @@ class EllpackHostCacheStreamImpl {
   std::shared_ptr<EllpackMemCache> cache_;
   std::int32_t ptr_{0};
 
+  /**
+   * @brief Get the device copy of the current page. The page is copied to the device once
+   *        it's read frequently enough and there's room for more device pages.
+   *
+   * @return Empty if the page is not in the device.
+   */
+  [[nodiscard]] common::RefResourceView<common::CompressedByteT> HotPage() const {
+    auto& cache = *this->cache_;
+    auto page = cache.At(this->ptr_);
+    if (!cache.direct_access || IsDevicePage(page) || cache.compact.at(this->ptr_)) {
+      return {};
+    }
+    std::lock_guard guard{cache.hot_lock};
+    if (cache.hot_pages.empty()) {
+      cache.hot_pages.resize(cache.pages.size());
+      cache.n_reads.resize(cache.pages.size(), 0);
+    }
+    auto& hot = cache.hot_pages.at(this->ptr_);
+    auto n_reads = ++cache.n_reads.at(this->ptr_);
+    if (hot.empty() && n_reads >= kHotPageReads &&
+        cache.NumDevicePages() < cache.max_num_device_pages) {
+      // Use the virtual memory API to keep the long-lived page out of the memory pool.
+      hot = common::MakeCudaGrowOnly<common::CompressedByteT>(page->gidx_buffer.size());
+      dh::safe_cuda(cudaMemcpyAsync(hot.data(), page->gidx_buffer.data(),
+                                    page->gidx_buffer.size_bytes(), cudaMemcpyDefault,
+                                    dh::DefaultStream()));
+      // Other readers can access the page once it's published.
+      dh::DefaultStream().Sync();
+      LOG(INFO) << "Move a host cache page to the device after " << n_reads
+                << " reads, size:" << common::HumanMemUnit(hot.size_bytes());
+    }
+    if (hot.empty()) {
+      return {};
+    }
+    auto res = hot.Resource();
+    return {res->DataAs<common::CompressedByteT>(), hot.size(), res};
+  }
+
  public:
   explicit EllpackHostCacheStreamImpl(std::shared_ptr<EllpackMemCache> cache)
       : cache_{std::move(cache)} {}
@@ -90,7 +296,7 @@ class EllpackHostCacheStreamImpl {
         k = i;
         break;
       }
-      n_bytes += cache_->pages[i]->MemCostBytes();
+      n_bytes += cache_->PageBytes(i);
     }
     if (offset_bytes == n_bytes && k == -1) {
       k = this->cache_->pages.size();  // seek end
@@ -121,14 +327,19 @@ class EllpackHostCacheStreamImpl {
     bool to_device = this->cache_->prefer_device &&
                      this->cache_->NumDevicePages() < this->cache_->max_num_device_pages;
 
-    auto commit_page = [&ctx](EllpackPageImpl const* old_impl) {
+    auto commit_page = [&ctx, this](EllpackPageImpl const* old_impl) {
       CHECK_EQ(old_impl->gidx_buffer.Resource()->Type(), common::ResourceHandler::kCudaMalloc);
       auto new_impl = std::make_unique<EllpackPageImpl>();
       new_impl->CopyInfo(old_impl);
-      new_impl->gidx_buffer = common::MakeFixedVecWithPinnedMalloc<common::CompressedByteT>(
-          old_impl->gidx_buffer.size());
-      dh::safe_cuda(cudaMemcpyAsync(new_impl->gidx_buffer.data(), old_impl->gidx_buffer.data(),
-                                    old_impl->gidx_buffer.size_bytes(), cudaMemcpyDefault));
+      if (!this->cache_->direct_access) {
+        this->cache_->compact.back() = CompactPage(&ctx, old_impl, new_impl.get());
+      }
+      if (!this->cache_->compact.back()) {
+        new_impl->gidx_buffer = common::MakeFixedVecWithPinnedMalloc<common::CompressedByteT>(
+            old_impl->gidx_buffer.size());
+        dh::safe_cuda(cudaMemcpyAsync(new_impl->gidx_buffer.data(), old_impl->gidx_buffer.data(),
+                                      old_impl->gidx_buffer.size_bytes(), cudaMemcpyDefault));
+      }
       LOG(INFO) << "Create cache page with size:" << common::HumanMemUnit(new_impl->MemCostBytes());
       return new_impl;
     };
@@ -138,20 +349,31 @@ class EllpackHostCacheStreamImpl {
       auto new_impl = std::make_unique<EllpackPageImpl>();
       new_impl->CopyInfo(page.Impl());
 
+      std::unique_ptr<EllpackCompactPage> compact;
       if (to_device) {
         // Copy to device
         new_impl->gidx_buffer = common::MakeFixedVecWithCudaMalloc<common::CompressedByteT>(
             page.Impl()->gidx_buffer.size());
       } else {
-        // Copy to host
-        new_impl->gidx_buffer = common::MakeFixedVecWithPinnedMalloc<common::CompressedByteT>(
-            page.Impl()->gidx_buffer.size());
+        // Copy to host, try to remove the padding first if the page is not accessed
+        // directly by the device.
+        if (!this->cache_->direct_access) {
+          compact = CompactPage(&ctx, page.Impl(), new_impl.get());
+        }
+        if (!compact) {
+          new_impl->gidx_buffer = common::MakeFixedVecWithPinnedMalloc<common::CompressedByteT>(
+              page.Impl()->gidx_buffer.size());
+        }
+      }
+      if (!compact) {
+        dh::safe_cuda(cudaMemcpyAsync(new_impl->gidx_buffer.data(),
+                                      page.Impl()->gidx_buffer.data(),
+                                      page.Impl()->gidx_buffer.size_bytes(), cudaMemcpyDefault));
       }
-      dh::safe_cuda(cudaMemcpyAsync(new_impl->gidx_buffer.data(), page.Impl()->gidx_buffer.data(),
-                                    page.Impl()->gidx_buffer.size_bytes(), cudaMemcpyDefault));
 
       this->cache_->offsets.push_back(new_impl->n_rows * new_impl->info.row_stride);
       this->cache_->pages.push_back(std::move(new_impl));
+      this->cache_->compact.push_back(std::move(compact));
       return new_page;
     }
 
@@ -176,6 +398,7 @@ class EllpackHostCacheStreamImpl {
 
       this->cache_->offsets.push_back(offset);
       this->cache_->pages.push_back(std::move(new_impl));
+      this->cache_->compact.emplace_back();
     } else {
       CHECK(!this->cache_->pages.empty());
       CHECK_EQ(cache_idx, this->cache_->pages.size() - 1);
@@ -199,7 +422,14 @@ class EllpackHostCacheStreamImpl {
       prefetch_copy = false;
     }
     auto out_impl = out->Impl();
-    if (prefetch_copy) {
+    auto const& compact = this->cache_->compact.at(this->ptr_);
+    if (auto hot = this->HotPage(); !hot.empty()) {
+      out_impl->gidx_buffer = std::move(hot);
+    } else if (compact) {
+      // Always copied since the padding needs to be restored.
+      auto ctx = Context{}.MakeCUDA(dh::CurrentDevice());
+      out_impl->gidx_buffer = ExpandPage(&ctx, page, *compact);
+    } else if (prefetch_copy) {
       out_impl->gidx_buffer =
           common::MakeFixedVecWithCudaMalloc<common::CompressedByteT>(page->gidx_buffer.size());
       dh::safe_cuda(cudaMemcpyAsync(out_impl->gidx_buffer.data(), page->gidx_buffer.data(),
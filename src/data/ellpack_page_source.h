@@ -1,5 +1,5 @@
 /**
- * Copyright 2019-2024, XGBoost Contributors
+ * Copyright 2019-2025, XGBoost Contributors
  */
 
 #ifndef XGBOOST_DATA_ELLPACK_PAGE_SOURCE_H_
@@ -8,11 +8,13 @@
 #include <cstdint>  // for int32_t
 #include <limits>   // for numeric_limits
 #include <memory>   // for shared_ptr
+#include <mutex>    // for mutex
 #include <utility>  // for move
 #include <vector>   // for vector
 
-#include "../common/cuda_rt_utils.h"  // for SupportsPageableMem, SupportsAts
-#include "../common/hist_util.h"      // for HistogramCuts
+#include "../common/cuda_rt_utils.h"      // for SupportsPageableMem, SupportsAts
+#include "../common/hist_util.h"          // for HistogramCuts
+#include "../common/ref_resource_view.h"  // for RefResourceView
 #include "ellpack_page.h"             // for EllpackPage
 #include "ellpack_page_raw_format.h"  // for EllpackPageRawFormat
 #include "sparse_page_source.h"       // for PageSourceIncMixIn
@@ -26,6 +28,10 @@ struct EllpackCacheInfo {
   BatchParam param;
   bool prefer_device{false};  // Prefer to cache the page in the device memory instead of host.
   std::int64_t max_num_device_pages{0};  // Maximum number of pages cached in device.
+  // Whether the device can read the host cache directly through a coherent link like the
+  // NVLink-C2C. Host pages are kept as they are for direct access, and pages that are read
+  // frequently are moved to the device memory if `max_num_device_pages` allows it.
+  bool direct_access{curt::SupportsAts()};
   float missing{std::numeric_limits<float>::quiet_NaN()};
   std::vector<bst_idx_t> cache_mapping;
   std::vector<bst_idx_t> buffer_bytes;
@@ -40,6 +46,9 @@ struct EllpackCacheInfo {
         missing{missing} {}
 };
 
+// Host page stored without the null padding, defined in the CUDA implementation.
+struct EllpackCompactPage;
+
 // We need to decouple the storage and the view of the storage so that we can implement
 // concurrent read. As a result, there are two classes, one for cache storage, another one
 // for stream.
@@ -47,6 +56,10 @@ struct EllpackCacheInfo {
 // This is a memory-based cache. It can be a mixed of the device memory and the host memory.
 struct EllpackMemCache {
   std::vector<std::unique_ptr<EllpackPageImpl>> pages;
+  // One for each page, null if the page is stored as it is. A compacted page holds only
+  // the valid symbols in its `gidx_buffer` and is expanded after being copied to the
+  // device.
+  std::vector<std::unique_ptr<EllpackCompactPage>> compact;
   std::vector<std::size_t> offsets;
   // Size of each batch before concatenation.
   std::vector<bst_idx_t> sizes_orig;
@@ -57,18 +70,27 @@ struct EllpackMemCache {
   std::vector<bst_idx_t> const buffer_rows;
   bool const prefer_device;
   std::int64_t const max_num_device_pages;
+  bool const direct_access;
+  // Read statistics of the host pages and their copies in the device, one for each page.
+  // Guarded by the `hot_lock`.
+  std::vector<std::int64_t> n_reads;
+  std::vector<common::RefResourceView<common::CompressedByteT>> hot_pages;
+  std::mutex hot_lock;
 
   explicit EllpackMemCache(EllpackCacheInfo cinfo);
   ~EllpackMemCache();
 
   // The number of bytes for the entire cache.
   [[nodiscard]] std::size_t SizeBytes() const;
+  // The number of bytes of the k^th page after expansion.
+  [[nodiscard]] std::size_t PageBytes(std::int32_t k) const;
 
   [[nodiscard]] bool Empty() const { return this->SizeBytes() == 0; }
 
   [[nodiscard]] bst_idx_t NumBatchesOrig() const { return cache_mapping.size(); }
   [[nodiscard]] EllpackPageImpl const* At(std::int32_t k) const;
 
+  // The number of pages in the device, including the copies of the hot host pages.
   [[nodiscard]] std::int64_t NumDevicePages() const;
 };
 
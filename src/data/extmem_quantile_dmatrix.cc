@@ -40,8 +40,11 @@ ExtMemQuantileDMatrix::ExtMemQuantileDMatrix(DataIterHandle iter_handle, DMatrix
 
   BatchParam p{max_bin, tree::TrainParam::DftSparseThreshold()};
   if (ctx.IsCPU()) {
-    this->InitFromCPU(&ctx, iter, proxy, p, config.missing, ref);
+    this->InitFromCPU(&ctx, iter, proxy, p, ref, config);
   } else {
+    if (config.sketch_sample_eps > 0) {
+      LOG(WARNING) << "Sketching on a sample is not supported by GPU, ignored.";
+    }
     p.n_prefetch_batches = ::xgboost::cuda_impl::DftPrefetchBatches();
     this->InitFromCUDA(&ctx, iter, proxy, p, ref, max_quantile_blocks, config);
   }
@@ -67,8 +70,12 @@ BatchSet<ExtSparsePage> ExtMemQuantileDMatrix::GetExtBatches(Context const *, Ba
 void ExtMemQuantileDMatrix::InitFromCPU(
     Context const *ctx,
     std::shared_ptr<DataIterProxy<DataIterResetCallback, XGDMatrixCallbackNext>> iter,
-    DMatrixHandle proxy_handle, BatchParam const &p, float missing, std::shared_ptr<DMatrix> ref) {
+    DMatrixHandle proxy_handle, BatchParam const &p, std::shared_ptr<DMatrix> ref,
+    ExtMemConfig const &config) {
   xgboost_NVTX_FN_RANGE();
+  CHECK_GE(config.max_host_cache_bytes, 0);
+  auto missing = config.missing;
+  auto max_host_cache_bytes = config.on_host ? config.max_host_cache_bytes : 0;
 
   auto proxy = MakeProxy(proxy_handle);
   CHECK(proxy);
@@ -85,14 +92,17 @@ void ExtMemQuantileDMatrix::InitFromCPU(
    */
   std::vector<FeatureType> h_ft;
   cpu_impl::MakeSketches(ctx, iter.get(), proxy, ref, missing, &cuts, p, this->info_, ext_info,
-                         &h_ft);
+                         config.sketch_sample_eps, &h_ft);
 
   /**
    * Generate gradient index
    */
-  auto id = MakeCache(this, ".gradient_index.page", false, cache_prefix_, &cache_info_);
+  // The pages are stored in the host cache, which spills to the cache file above the
+  // budget and owns the file.
+  auto id = MakeCache(this, ".gradient_index.page", true, cache_prefix_, &cache_info_);
   this->ghist_index_source_ = std::make_unique<ExtGradientIndexPageSource>(
-      ctx, missing, &this->info_, cache_info_.at(id), p, cuts, iter, proxy, ext_info.base_rowids);
+      ctx, missing, &this->info_, cache_info_.at(id), p, cuts, iter, proxy, ext_info.base_rowids,
+      max_host_cache_bytes, config.column_pages);
 
   /**
    * Force initialize the cache and do some sanity checks along the way
@@ -39,7 +39,8 @@ class ExtMemQuantileDMatrix : public QuantileDMatrix {
   void InitFromCPU(
       Context const *ctx,
       std::shared_ptr<DataIterProxy<DataIterResetCallback, XGDMatrixCallbackNext>> iter,
-      DMatrixHandle proxy, BatchParam const &p, float missing, std::shared_ptr<DMatrix> ref);
+      DMatrixHandle proxy, BatchParam const &p, std::shared_ptr<DMatrix> ref,
+      ExtMemConfig const &config);
   void InitFromCUDA(
       Context const *ctx,
       std::shared_ptr<DataIterProxy<DataIterResetCallback, XGDMatrixCallbackNext>> iter,
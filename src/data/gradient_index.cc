@@ -6,14 +6,23 @@
 
 #include <limits>
 #include <memory>
-#include <utility>  // for forward
+#include <utility>  // for forward, move
 
 #include "../common/column_matrix.h"
+#include "../common/feature_bundle.h"  // for FeatureBundles
 #include "../common/hist_util.h"
+#include "../common/memory_stats.h"  // for MemTagScope
 #include "../common/numeric.h"
 #include "../common/transform_iterator.h"  // for MakeIndexTransformIter
 
 namespace xgboost {
+namespace {
+template <typename T>
+[[nodiscard]] common::RefResourceView<T> MakeIndexVec(std::size_t n_elements, T const &init) {
+  common::MemTagScope scope{common::MemTag::kGradientIndex};
+  return common::MakeFixedVecWithMalloc(n_elements, init);
+}
+}  // anonymous namespace
 
 GHistIndexMatrix::GHistIndexMatrix() : columns_{std::make_unique<common::ColumnMatrix>()} {}
 
@@ -27,7 +36,7 @@ GHistIndexMatrix::GHistIndexMatrix(Context const *ctx, DMatrix *p_fmat, bst_bin_
   cut = common::SketchOnDMatrix(ctx, p_fmat, max_bins_per_feat, sorted_sketch, hess);
 
   const uint32_t nbins = cut.Ptrs().back();
-  hit_count = common::MakeFixedVecWithMalloc(nbins, std::size_t{0});
+  hit_count = MakeIndexVec(nbins, std::size_t{0});
   hit_count_tloc_.resize(ctx->Threads() * nbins, 0);
 
   size_t new_size = 1;
@@ -35,7 +44,7 @@ GHistIndexMatrix::GHistIndexMatrix(Context const *ctx, DMatrix *p_fmat, bst_bin_
     new_size += batch.Size();
   }
 
-  row_ptr = common::MakeFixedVecWithMalloc(new_size, std::size_t{0});
+  row_ptr = MakeIndexVec(new_size, std::size_t{0});
 
   const bool isDense = p_fmat->IsDense();
   this->isDense_ = isDense;
@@ -44,22 +53,21 @@ GHistIndexMatrix::GHistIndexMatrix(Context const *ctx, DMatrix *p_fmat, bst_bin_
   for (const auto &batch : p_fmat->GetBatches<SparsePage>()) {
     this->PushBatch(batch, ft, ctx->Threads());
   }
-  this->columns_ = std::make_unique<common::ColumnMatrix>();
 
   // hessian is empty when hist tree method is used or when dataset is empty
   if (hess.empty() && !std::isnan(sparse_thresh)) {
     // hist
     CHECK(!sorted_sketch);
-    for (auto const &page : p_fmat->GetBatches<SparsePage>()) {
-      this->columns_->InitFromSparse(page, *this, sparse_thresh, ctx->Threads());
-    }
+    this->DeferColumns(sparse_thresh);
+  } else {
+    this->DeferColumns(std::numeric_limits<double>::quiet_NaN());
   }
 }
 
 GHistIndexMatrix::GHistIndexMatrix(MetaInfo const &info, common::HistogramCuts &&cuts,
                                    bst_bin_t max_bin_per_feat)
-    : row_ptr{common::MakeFixedVecWithMalloc(info.num_row_ + 1, std::size_t{0})},
-      hit_count{common::MakeFixedVecWithMalloc(cuts.TotalBins(), std::size_t{0})},
+    : row_ptr{MakeIndexVec(info.num_row_ + 1, std::size_t{0})},
+      hit_count{MakeIndexVec(cuts.TotalBins(), std::size_t{0})},
       cut{std::forward<common::HistogramCuts>(cuts)},
       max_numeric_bins_per_feat(max_bin_per_feat),
       isDense_{info.IsDense()} {}
@@ -67,8 +75,8 @@ GHistIndexMatrix::GHistIndexMatrix(MetaInfo const &info, common::HistogramCuts &
 GHistIndexMatrix::GHistIndexMatrix(bst_idx_t n_samples, bst_idx_t base_rowid,
                                    common::HistogramCuts &&cuts, bst_bin_t max_bin_per_feat,
                                    bool is_dense)
-    : row_ptr{common::MakeFixedVecWithMalloc(n_samples + 1, std::size_t{0})},
-      hit_count{common::MakeFixedVecWithMalloc(cuts.TotalBins(), std::size_t{0})},
+    : row_ptr{MakeIndexVec(n_samples + 1, std::size_t{0})},
+      hit_count{MakeIndexVec(cuts.TotalBins(), std::size_t{0})},
       cut{std::forward<common::HistogramCuts>(cuts)},
       max_numeric_bins_per_feat(max_bin_per_feat),
       base_rowid{base_rowid},
@@ -95,22 +103,25 @@ void GHistIndexMatrix::PushBatch(SparsePage const &batch, common::Span<FeatureTy
 
 GHistIndexMatrix::GHistIndexMatrix(SparsePage const &batch, common::Span<FeatureType const> ft,
                                    common::HistogramCuts cuts, bst_bin_t max_bins_per_feat,
-                                   bool is_dense, double sparse_thresh, std::int32_t n_threads)
+                                   bool is_dense, double sparse_thresh, std::int32_t n_threads,
+                                   bool dense_columns)
     : cut{std::move(cuts)},
       max_numeric_bins_per_feat{max_bins_per_feat},
       base_rowid{batch.base_rowid},
-      isDense_{is_dense} {
+      isDense_{is_dense},
+      dense_columns_{dense_columns} {
   CHECK_GE(n_threads, 1);
   CHECK_EQ(row_ptr.size(), 0);
-  row_ptr = common::MakeFixedVecWithMalloc(batch.Size() + 1, std::size_t{0});
+  row_ptr = MakeIndexVec(batch.Size() + 1, std::size_t{0});
 
   const uint32_t nbins = cut.Ptrs().back();
-  hit_count = common::MakeFixedVecWithMalloc(nbins, std::size_t{0});
+  hit_count = MakeIndexVec(nbins, std::size_t{0});
   hit_count_tloc_.resize(n_threads * nbins, 0);
 
   this->PushBatch(batch, ft, n_threads);
+  // The page is cached, build the column matrix now instead of after each read.
   this->columns_ = std::make_unique<common::ColumnMatrix>();
-  if (!std::isnan(sparse_thresh)) {
+  if (this->NeedColumns(sparse_thresh)) {
     this->columns_->InitFromSparse(batch, *this, sparse_thresh, n_threads);
   }
 }
@@ -119,6 +130,12 @@ template <typename Batch>
 void GHistIndexMatrix::PushAdapterBatchColumns(Context const *ctx, Batch const &batch,
                                                float missing, size_t rbegin) {
   CHECK(columns_);
+  if (std::isnan(this->sparse_thresh_)) {
+    return;
+  }
+  if (!this->columns_->IsInitialized()) {
+    this->columns_ = std::make_unique<common::ColumnMatrix>(*this, this->sparse_thresh_);
+  }
   this->columns_->PushBatch(ctx->Threads(), batch, missing, *this, rbegin);
 }
 
@@ -132,9 +149,53 @@ INSTANTIATION_PUSH(data::SparsePageAdapterBatch)
 INSTANTIATION_PUSH(data::ColumnarAdapterBatch)
 #undef INSTANTIATION_PUSH
 
-void GHistIndexMatrix::ResizeColumns(double sparse_thresh) {
-  CHECK(!std::isnan(sparse_thresh));
-  this->columns_ = std::make_unique<common::ColumnMatrix>(*this, sparse_thresh);
+void GHistIndexMatrix::Extend(Context const *ctx, DMatrix *p_fmat, double sparse_thresh) {
+  CHECK_EQ(p_fmat->Info().num_col_, this->Features());
+  CHECK_EQ(this->base_rowid, 0) << "Extending an external memory page is not supported.";
+  auto n_threads = ctx->Threads();
+  if (this->IsDense() && !p_fmat->IsDense()) {
+    // The dense index is compressed with feature offsets, convert it to the sparse layout
+    // by restoring the global bin index.
+    auto n_index = this->index.Size();
+    auto sparse = MakeIndexVec(n_index * sizeof(std::uint32_t), std::uint8_t{0});
+    auto out = reinterpret_cast<std::uint32_t *>(sparse.data());
+    common::ParallelFor(n_index, n_threads, [&](std::size_t i) { out[i] = this->index[i]; });
+    this->data = std::move(sparse);
+    this->index = common::Index{common::Span{data.data(), static_cast<size_t>(data.size())},
+                                common::kUint32BinsTypeSize};
+    this->isDense_ = false;
+  }
+
+  auto ft = p_fmat->Info().feature_types.ConstHostSpan();
+  auto n_bins_total = cut.TotalBins();
+  for (auto const &batch : p_fmat->GetBatches<SparsePage>()) {
+    auto n_old = this->Size();
+    auto new_ptr = MakeIndexVec(n_old + batch.Size() + 1, std::size_t{0});
+    std::copy_n(this->row_ptr.data(), n_old + 1, new_ptr.data());
+    this->row_ptr = std::move(new_ptr);
+
+    auto page = batch.GetView();
+    auto it = common::MakeIndexTransformIter([&](std::size_t ridx) { return page[ridx].size(); });
+    common::PartialSum(n_threads, it, it + page.Size(), row_ptr[n_old], row_ptr.begin() + n_old);
+    hit_count_tloc_.clear();
+    hit_count_tloc_.resize(n_threads * n_bins_total, 0);
+    data::SparsePageAdapterBatch adapter_batch{page};
+    auto is_valid = [](auto) { return true; };  // SparsePage always contains valid entries
+    this->PushBatchImpl(n_threads, adapter_batch, n_old, is_valid, ft);
+  }
+
+  {
+    std::lock_guard guard{bundles_lock_};
+    this->bundles_.reset();
+  }
+  this->DeferColumns(sparse_thresh);
+}
+
+void GHistIndexMatrix::DeferColumns(double sparse_thresh) {
+  std::lock_guard guard{columns_lock_};
+  this->columns_ = std::make_unique<common::ColumnMatrix>();
+  this->sparse_thresh_ =
+      this->NeedColumns(sparse_thresh) ? sparse_thresh : std::numeric_limits<double>::quiet_NaN();
 }
 
 void GHistIndexMatrix::ResizeIndex(const size_t n_index, const bool isDense) {
@@ -150,7 +211,7 @@ void GHistIndexMatrix::ResizeIndex(const size_t n_index, const bool isDense) {
     decltype(this->data) new_vec;
     if (!resource) {
       CHECK(this->data.empty());
-      new_vec = common::MakeFixedVecWithMalloc(n_bytes, std::uint8_t{0});
+      new_vec = MakeIndexVec(n_bytes, std::uint8_t{0});
     } else {
       CHECK(resource->Type() == common::ResourceHandler::kMalloc);
       auto malloc_resource = std::dynamic_pointer_cast<common::MallocResource>(resource);
@@ -181,11 +242,27 @@ void GHistIndexMatrix::ResizeIndex(const size_t n_index, const bool isDense) {
   }
 }
 
-common::ColumnMatrix const &GHistIndexMatrix::Transpose() const {
+common::ColumnMatrix const &GHistIndexMatrix::Transpose(Context const *ctx) const {
+  std::lock_guard guard{columns_lock_};
   CHECK(columns_);
+  if (!std::isnan(this->sparse_thresh_) && !this->columns_->IsInitialized()) {
+    auto columns = std::make_unique<common::ColumnMatrix>(*this, this->sparse_thresh_);
+    columns->InitFromGHist(ctx, *this);
+    this->columns_ = std::move(columns);
+  }
   return *columns_;
 }
 
+common::FeatureBundles const &GHistIndexMatrix::Bundles(Context const *ctx) const {
+  std::lock_guard guard{bundles_lock_};
+  if (!this->bundles_) {
+    auto bundles = std::make_unique<common::FeatureBundles>();
+    bundles->Build(ctx, *this);
+    this->bundles_ = std::move(bundles);
+  }
+  return *bundles_;
+}
+
 bst_bin_t GHistIndexMatrix::GetGindex(size_t ridx, size_t fidx) const {
   auto begin = RowIdx(ridx);
   if (IsDense()) {
@@ -205,43 +282,6 @@ float GHistIndexMatrix::GetFvalue(size_t ridx, size_t fidx, bool is_cat) const {
   return this->GetFvalue(ptrs, values, mins, ridx, fidx, is_cat);
 }
 
-float GetFvalueImpl(std::vector<std::uint32_t> const &ptrs, std::vector<float> const &values,
-                    std::vector<float> const &mins, bst_idx_t ridx, bst_feature_t fidx,
-                    bst_idx_t base_rowid, std::unique_ptr<common::ColumnMatrix> const &columns_) {
-  auto get_bin_val = [&](auto &column) {
-    auto bin_idx = column[ridx - base_rowid];
-    if (bin_idx == common::DenseColumnIter<uint8_t, true>::kMissingId) {
-      return std::numeric_limits<float>::quiet_NaN();
-    }
-    return common::HistogramCuts::NumericBinValue(ptrs, values, mins, fidx, bin_idx);
-  };
-  switch (columns_->GetColumnType(fidx)) {
-    case common::kDenseColumn: {
-      if (columns_->AnyMissing()) {
-        return common::DispatchBinType(columns_->GetTypeSize(), [&](auto dtype) {
-          auto column = columns_->DenseColumn<decltype(dtype), true>(fidx);
-          return get_bin_val(column);
-        });
-      } else {
-        return common::DispatchBinType(columns_->GetTypeSize(), [&](auto dtype) {
-          auto column = columns_->DenseColumn<decltype(dtype), false>(fidx);
-          auto bin_idx = column[ridx - base_rowid];
-          return common::HistogramCuts::NumericBinValue(ptrs, values, mins, fidx, bin_idx);
-        });
-      }
-    }
-    case common::kSparseColumn: {
-      return common::DispatchBinType(columns_->GetTypeSize(), [&](auto dtype) {
-        auto column = columns_->SparseColumn<decltype(dtype)>(fidx, 0);
-        return get_bin_val(column);
-      });
-    }
-  }
-
-  SPAN_CHECK(false);
-  return std::numeric_limits<float>::quiet_NaN();
-}
-
 bool GHistIndexMatrix::ReadColumnPage(common::AlignedResourceReadStream *fi) {
   return this->columns_->Read(fi, this->cut.Ptrs().data());
 }
@@ -6,6 +6,7 @@
 #include <vector>   // for vector
 
 #include "../common/column_matrix.h"
+#include "../common/feature_bundle.h"  // for FeatureBundles
 #include "../common/hist_util.h"  // Index
 #include "ellpack_page.cuh"
 #include "gradient_index.h"
@@ -30,7 +31,7 @@ void SetIndexData(Context const* ctx, EllpackPageImpl const* page,
   hit_count_tloc.resize(ctx->Threads() * n_bins_total, 0);
   bool dense_compressed = page->IsDenseCompressed() && !page->IsDense();
   common::ParallelFor(page->Size(), ctx->Threads(), [&](auto ridx) {
-    auto tid = omp_get_thread_num();
+    auto tid = common::ThreadIdx();
     size_t in_rbegin = page->info.row_stride * ridx;
     size_t out_rbegin = out->row_ptr[ridx];
     if (dense_compressed) {
@@ -123,7 +124,6 @@ GHistIndexMatrix::GHistIndexMatrix(Context const* ctx, MetaInfo const& info,
   CHECK(this->cut.cut_values_.HostCanRead());
   CHECK(this->cut.min_vals_.HostCanRead());
 
-  this->columns_ = std::make_unique<common::ColumnMatrix>(*this, p.sparse_thresh);
-  this->columns_->InitFromGHist(ctx, *this);
+  this->DeferColumns(p.sparse_thresh);
 }
 }  // namespace xgboost
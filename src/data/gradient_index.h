@@ -7,10 +7,12 @@
 
 #include <algorithm>  // for min
 #include <atomic>     // for atomic
+#include <cmath>      // for isnan
 #include <cstddef>    // for size_t
 #include <cstdint>    // for uint32_t
 #include <limits>     // for numeric_limits
 #include <memory>     // for make_unique
+#include <mutex>      // for mutex
 #include <vector>     // for vector
 
 #include "../common/categorical.h"
@@ -27,13 +29,10 @@
 namespace xgboost {
 namespace common {
 class ColumnMatrix;
+class FeatureBundles;
 class AlignedFileWriteStream;
 }  // namespace common
 
-float GetFvalueImpl(std::vector<std::uint32_t> const& ptrs, std::vector<float> const& values,
-                    std::vector<float> const& mins, bst_idx_t ridx, bst_feature_t fidx,
-                    bst_idx_t base_rowid, std::unique_ptr<common::ColumnMatrix> const& columns_);
-
 /**
  * @brief preprocessed global index matrix, in CSR format.
  *
@@ -77,7 +76,7 @@ class GHistIndexMatrix {
       auto line = batch.GetLine(i);
       size_t ibegin = row_ptr[rbegin + i];  // index of first entry for current block
       size_t k = 0;
-      auto tid = omp_get_thread_num();
+      auto tid = common::ThreadIdx();
       for (size_t j = 0; j < line.Size(); ++j) {
         data::COOTuple elem = line.GetElement(j);
         if (is_valid(elem)) {
@@ -141,8 +140,23 @@ class GHistIndexMatrix {
     this->GatherHitCount(n_threads, n_bins_total);
   }
 
-  // The function is only created to avoid using the column matrix in the header.
-  void ResizeColumns(double sparse_thresh);
+  /**
+   * @brief Whether the column matrix is worth building for the row partitioner of
+   *        `hist`. A dense index is already laid out by row and feature, the partitioner
+   *        reads it directly and a column matrix would be a second copy of the index. For
+   *        sparse data, the column matrix avoids a binary search in each row. External
+   *        memory can request it for dense pages as well, see @ref SetDenseColumns.
+   */
+  [[nodiscard]] bool NeedColumns(double sparse_thresh) const {
+    return !std::isnan(sparse_thresh) && (!this->IsDense() || this->dense_columns_);
+  }
+  /**
+   * @brief Drop the column matrix and build it on the first call to @ref Transpose
+   *        instead, if it's needed.
+   *
+   *   The function is only created to avoid using the column matrix in the header.
+   */
+  void DeferColumns(double sparse_thresh);
 
  public:
   /** @brief row pointer to rows by element position */
@@ -193,10 +207,13 @@ class GHistIndexMatrix {
 
   /**
    * @brief Constructor for external memory.
+   *
+   * @param dense_columns Build the column matrix for a dense page, see @ref
+   *                      SetDenseColumns.
    */
   GHistIndexMatrix(SparsePage const& page, common::Span<FeatureType const> ft,
                    common::HistogramCuts cuts, bst_bin_t max_bins_per_feat, bool is_dense,
-                   double sparse_thresh, std::int32_t n_threads);
+                   double sparse_thresh, std::int32_t n_threads, bool dense_columns = false);
   GHistIndexMatrix();  // also for ext mem, empty ctor so that we can read the cache back.
 
   /**
@@ -214,24 +231,39 @@ class GHistIndexMatrix {
     hit_count_tloc_.resize(ctx->Threads() * n_bins_total, 0);
 
     auto n_threads = ctx->Threads();
-    auto valid_counts = GetRowCounts(batch, missing, n_threads);
+    // Resolve the data type once for the batch.
+    data::DispatchTypedBatch(batch, [&](auto const& typed) {
+      auto valid_counts = GetRowCounts(typed, missing, n_threads);
 
-    auto it = common::MakeIndexTransformIter([&](size_t ridx) { return valid_counts[ridx]; });
-    common::PartialSum(n_threads, it, it + batch.Size(), prev_sum, row_ptr.begin() + rbegin);
-    auto is_valid = data::IsValidFunctor{missing};
+      auto it = common::MakeIndexTransformIter([&](size_t ridx) { return valid_counts[ridx]; });
+      common::PartialSum(n_threads, it, it + typed.Size(), prev_sum, row_ptr.begin() + rbegin);
+      auto is_valid = data::IsValidFunctor{missing};
 
-    PushBatchImpl(ctx->Threads(), batch, rbegin, is_valid, ft);
+      PushBatchImpl(ctx->Threads(), typed, rbegin, is_valid, ft);
+    });
 
     if (rbegin + batch.Size() == n_samples_total) {
       // finished
-      this->ResizeColumns(sparse_thresh);
+      this->DeferColumns(sparse_thresh);
     }
   }
 
-  // Call ColumnMatrix::PushBatch
+  /**
+   * @brief Build the column matrix from the input batch instead of deferring it to @ref
+   *        Transpose, used by external memory where the column matrix is cached along
+   *        with the page. Calls ColumnMatrix::PushBatch.
+   */
   template <typename Batch>
   void PushAdapterBatchColumns(Context const* ctx, Batch const& batch, float missing,
                                size_t rbegin);
+  /**
+   * @brief Append the rows of another DMatrix, which are quantised with the existing cuts
+   *        instead of being sketched again. The existing rows are not quantised again.
+   *
+   * @param sparse_thresh The threshold used to rebuild the column matrix, NaN if the
+   *                      column matrix is not used.
+   */
+  void Extend(Context const* ctx, DMatrix* p_fmat, double sparse_thresh);
 
   void ResizeIndex(const size_t n_index, const bool isDense);
 
@@ -248,6 +280,15 @@ class GHistIndexMatrix {
 
   [[nodiscard]] bool IsDense() const { return isDense_; }
   void SetDense(bool is_dense) { isDense_ = is_dense; }
+  /**
+   * @brief Build the column matrix for a dense index as well, must be called before the
+   *        data is pushed.
+   *
+   *   Used by external memory with column pages. The column matrix is written along with
+   *   the row-major page, the `hist` tree method can then use the column-wise histogram
+   *   kernel and the column-based partitioner for dense data.
+   */
+  void SetDenseColumns(bool dense_columns) { dense_columns_ = dense_columns; }
   [[nodiscard]] bst_idx_t BaseRowId() const { return base_rowid; }
   /**
    * @brief Get the local row index from the global row index.
@@ -262,7 +303,17 @@ class GHistIndexMatrix {
   [[nodiscard]] bool ReadColumnPage(common::AlignedResourceReadStream* fi);
   [[nodiscard]] std::size_t WriteColumnPage(common::AlignedFileWriteStream* fo) const;
 
-  [[nodiscard]] common::ColumnMatrix const& Transpose() const;
+  /**
+   * @brief Get the column matrix, which is built on the first call if it was deferred.
+   *        The result is not initialized when the column matrix is not needed, see @ref
+   *        NeedColumns.
+   */
+  [[nodiscard]] common::ColumnMatrix const& Transpose(Context const* ctx) const;
+  /**
+   * @brief Get the exclusive feature bundles of a sparse index, which are built on the
+   *        first call. See @ref common::FeatureBundles.
+   */
+  [[nodiscard]] common::FeatureBundles const& Bundles(Context const* ctx) const;
 
   [[nodiscard]] bst_bin_t GetGindex(size_t ridx, size_t fidx) const;
 
@@ -270,28 +321,36 @@ class GHistIndexMatrix {
   [[nodiscard]] float GetFvalue(std::vector<std::uint32_t> const& ptrs,
                                 std::vector<float> const& values, std::vector<float> const& mins,
                                 bst_idx_t ridx, bst_feature_t fidx, bool is_cat) const {
-    if (is_cat) {
-      auto gidx = GetGindex(ridx, fidx);
-      if (gidx == -1) {
-        return std::numeric_limits<float>::quiet_NaN();
-      }
-      return values[gidx];
-    }
-    if (this->IsDense()) {
+    if (this->IsDense() && !is_cat) {
       auto begin = RowIdx(ridx);
       auto bin_idx = this->index[begin + fidx];
       return common::HistogramCuts::NumericBinValue(ptrs, values, mins, fidx, bin_idx);
     }
-    return GetFvalueImpl(ptrs, values, mins, ridx, fidx, this->base_rowid, this->columns_);
+    // Search the row instead of using the column matrix, which might not be built yet.
+    auto gidx = GetGindex(ridx, fidx);
+    if (gidx == -1) {
+      return std::numeric_limits<float>::quiet_NaN();
+    }
+    if (is_cat) {
+      return values[gidx];
+    }
+    return common::HistogramCuts::NumericBinValue(ptrs, values, mins, fidx, gidx);
   }
 
   [[nodiscard]] common::HistogramCuts& Cuts() { return cut; }
   [[nodiscard]] common::HistogramCuts const& Cuts() const { return cut; }
 
  private:
-  std::unique_ptr<common::ColumnMatrix> columns_;
+  mutable std::unique_ptr<common::ColumnMatrix> columns_;
+  mutable std::mutex columns_lock_;
+  mutable std::unique_ptr<common::FeatureBundles> bundles_;
+  mutable std::mutex bundles_lock_;
+  // Sparse threshold of the deferred column matrix, NaN if the column matrix is not built
+  // by `Transpose`.
+  double sparse_thresh_{std::numeric_limits<double>::quiet_NaN()};
   std::vector<size_t> hit_count_tloc_;
   bool isDense_;
+  bool dense_columns_{false};
 };
 
 /**
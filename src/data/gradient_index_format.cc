@@ -3,17 +3,41 @@
  */
 #include "gradient_index_format.h"
 
+#include <algorithm>                      // for max_element
 #include <cstddef>                        // for size_t
-#include <cstdint>                        // for uint8_t
+#include <cstdint>                        // for uint8_t, uint64_t
 #include <type_traits>                    // for underlying_type_t
 #include <vector>                         // for vector
 
-#include "../common/hist_util.h"          // for HistogramCuts
-#include "../common/io.h"                 // for AlignedResourceReadStream
-#include "../common/ref_resource_view.h"  // for ReadVec, WriteVec
-#include "gradient_index.h"               // for GHistIndexMatrix
+#include "../common/compressed_iterator.h"  // for CompressedBufferWriter, CompressedIterator
+#include "../common/hist_util.h"            // for HistogramCuts
+#include "../common/io.h"                   // for AlignedResourceReadStream
+#include "../common/ref_resource_view.h"    // for ReadVec, WriteVec
+#include "gradient_index.h"                 // for GHistIndexMatrix
 
 namespace xgboost::data {
+namespace {
+/**
+ * @brief Get the number of symbols for bit-packing the index, 0 if packing doesn't save
+ *        space.
+ */
+std::uint64_t NumPackedSymbols(common::Index const& index) {
+  if (index.Size() == 0) {
+    return 0;
+  }
+  auto n_symbols = common::DispatchBinType(index.GetBinTypeSize(), [&](auto t) {
+    using T = decltype(t);
+    auto ptr = index.data<T>();
+    return static_cast<std::uint64_t>(*std::max_element(ptr, ptr + index.Size())) + 1;
+  });
+  auto constexpr kBitsPerByte = 8;
+  if (common::detail::SymbolBits(n_symbols) >= index.GetBinTypeSize() * kBitsPerByte) {
+    return 0;
+  }
+  return n_symbols;
+}
+}  // anonymous namespace
+
 [[nodiscard]] bool GHistIndexRawFormat::Read(GHistIndexMatrix* page,
                                              common::AlignedResourceReadStream* fi) {
   CHECK(fi);
@@ -32,10 +56,38 @@ namespace xgboost::data {
     return false;
   }
   common::BinTypeSize size_type = static_cast<common::BinTypeSize>(uint_bin_type);
-  // - index buffer
-  if (!common::ReadVec(fi, &page->data)) {
+  // - number of symbols for the bit-packed index, 0 if not packed.
+  std::uint64_t n_symbols{0};
+  if (!fi->Read(&n_symbols)) {
     return false;
   }
+  // - index buffer
+  if (n_symbols == 0) {
+    if (!common::ReadVec(fi, &page->data)) {
+      return false;
+    }
+  } else {
+    // Unpack in the prefetch thread.
+    std::uint64_t n_elements{0};
+    if (!fi->Read(&n_elements)) {
+      return false;
+    }
+    common::RefResourceView<common::CompressedByteT> packed;
+    if (!common::ReadVec(fi, &packed)) {
+      return false;
+    }
+    CHECK_GE(packed.size(),
+             common::CompressedBufferWriter::CalculateBufferSize(n_elements, n_symbols));
+    page->data = common::MakeFixedVecWithMalloc(n_elements * size_type, std::uint8_t{0});
+    common::CompressedIterator<std::uint32_t> it{packed.data(), n_symbols};
+    common::DispatchBinType(size_type, [&](auto t) {
+      using T = decltype(t);
+      auto out = reinterpret_cast<T*>(page->data.data());
+      for (std::size_t i = 0; i < n_elements; ++i) {
+        out[i] = static_cast<T>(it[i]);
+      }
+    });
+  }
   // - index
   page->index = common::Index{
       common::Span{page->data.data(), static_cast<size_t>(page->data.size())}, size_type};
@@ -75,11 +127,30 @@ namespace xgboost::data {
   // - bin type
   std::underlying_type_t<common::BinTypeSize> uint_bin_type = page.index.GetBinTypeSize();
   bytes += fo->Write(uint_bin_type);
+  // - number of symbols for the bit-packed index. The index is packed when it has fewer
+  //   distinct bins than its storage type can hold, which is common for sparse data and
+  //   small `max_bin`.
+  auto n_symbols = NumPackedSymbols(page.index);
+  bytes += fo->Write(n_symbols);
   // - index buffer
-  std::vector<std::uint8_t> data(page.index.begin(), page.index.end());
-  bytes += fo->Write(static_cast<std::uint64_t>(data.size()));
-  if (!data.empty()) {
-    bytes += fo->Write(data.data(), data.size());
+  if (n_symbols == 0) {
+    std::vector<std::uint8_t> data(page.index.begin(), page.index.end());
+    bytes += fo->Write(static_cast<std::uint64_t>(data.size()));
+    if (!data.empty()) {
+      bytes += fo->Write(data.data(), data.size());
+    }
+  } else {
+    auto n_elements = static_cast<std::uint64_t>(page.index.Size());
+    bytes += fo->Write(n_elements);
+    std::vector<common::CompressedByteT> packed(
+        common::CompressedBufferWriter::CalculateBufferSize(n_elements, n_symbols), 0);
+    common::CompressedBufferWriter writer{n_symbols};
+    common::DispatchBinType(page.index.GetBinTypeSize(), [&](auto t) {
+      using T = decltype(t);
+      auto ptr = page.index.data<T>();
+      writer.Write(packed.data(), ptr, ptr + n_elements);
+    });
+    bytes += common::WriteVec(fo, packed);
   }
 
   // hit count
@@ -4,12 +4,69 @@
 #include "gradient_index_page_source.h"
 
 #include <memory>   // for make_shared
+#include <string>   // for string
 #include <utility>  // for move
 
 #include "../common/hist_util.h"  // for HistogramCuts
 #include "gradient_index.h"       // for GHistIndexMatrix
 
 namespace xgboost::data {
+GHistIndexHostCache::~GHistIndexHostCache() {
+  if (!this->spill_file.empty()) {
+    TryDeleteCacheFile(this->spill_file);
+  }
+}
+
+class GHistIndexHostWriteStream::PageResource : public common::ResourceHandler {
+ public:
+  std::string buffer;
+
+  PageResource() : common::ResourceHandler{kMalloc} {}
+  void* Data() override { return buffer.data(); }
+  [[nodiscard]] std::size_t Size() const override { return buffer.size(); }
+};
+
+GHistIndexHostWriteStream::GHistIndexHostWriteStream(GHistIndexHostCache* cache,
+                                                     std::string path)
+    : cache_{cache}, path_{std::move(path)}, page_{std::make_shared<PageResource>()} {
+  CHECK(cache_);
+  cache_->pages.emplace_back(nullptr);
+  cache_->offsets.push_back(cache_->total_bytes);
+  cache_->file_offsets.push_back(cache_->file_bytes);
+}
+
+GHistIndexHostWriteStream::~GHistIndexHostWriteStream() {
+  cache_->total_bytes += n_bytes_;
+  if (spill_) {
+    spill_.reset();  // flush
+    cache_->file_bytes += n_bytes_;
+  } else {
+    cache_->host_bytes += n_bytes_;
+    cache_->pages.back() = std::move(page_);
+  }
+}
+
+[[nodiscard]] std::size_t GHistIndexHostWriteStream::DoWrite(const void* ptr,
+                                                             std::size_t n_bytes) noexcept(true) {
+  auto const* bytes = static_cast<char const*>(ptr);
+  if (!spill_) {
+    if (cache_->host_bytes + n_bytes_ + n_bytes <= cache_->max_host_bytes) {
+      page_->buffer.append(bytes, n_bytes);
+      n_bytes_ += n_bytes;
+      return n_bytes;
+    }
+    // Move the page to the spill file once it exceeds the budget.
+    auto flags = cache_->spill_file.empty() ? "wb" : "ab";
+    cache_->spill_file = path_;
+    spill_.reset(dmlc::Stream::Create(path_.c_str(), flags));
+    spill_->Write(page_->buffer.data(), page_->buffer.size());
+    page_.reset();
+  }
+  spill_->Write(bytes, n_bytes);
+  n_bytes_ += n_bytes;
+  return n_bytes;
+}
+
 void GradientIndexPageSource::Fetch() {
   if (!this->ReadCache()) {
     // source is initialized to be the 0th page during construction, so when count_ is 0
@@ -24,7 +81,8 @@ void GradientIndexPageSource::Fetch() {
     auto const& csr = this->source_->Page();
     CHECK_NE(this->cuts_.Values().size(), 0);
     this->page_.reset(new GHistIndexMatrix{*csr, feature_types_, cuts_, max_bin_per_feat_,
-                                           is_dense_, sparse_thresh_, nthreads_});
+                                           is_dense_, sparse_thresh_, nthreads_,
+                                           column_pages_});
     this->WriteCache();
   }
 }
@@ -55,6 +113,7 @@ void ExtGradientIndexPageSource::Fetch() {
       this->page_ =
           std::make_shared<GHistIndexMatrix>(value.NumRows(), this->base_rows_.at(source_->Iter()),
                                              std::move(cuts), this->p_.max_bin, info_->IsDense());
+      this->page_->SetDenseColumns(this->column_pages_);
       bst_idx_t prev_sum = 0;
       bst_idx_t rbegin = 0;
       // Use `value.NumRows()` for the size of a single batch. Unlike the
@@ -4,13 +4,18 @@
 #ifndef XGBOOST_DATA_GRADIENT_INDEX_PAGE_SOURCE_H_
 #define XGBOOST_DATA_GRADIENT_INDEX_PAGE_SOURCE_H_
 
-#include <cmath>    // for isnan
-#include <cstdint>  // for int32_t
-#include <memory>   // for shared_ptr
-#include <utility>  // for move
-#include <vector>   // for vector
+#include <algorithm>  // for count, lower_bound
+#include <cmath>      // for isnan
+#include <cstddef>    // for size_t
+#include <cstdint>    // for int32_t
+#include <iterator>   // for distance
+#include <memory>     // for shared_ptr
+#include <string>     // for string
+#include <utility>    // for move
+#include <vector>     // for vector
 
 #include "../common/hist_util.h"    // for HistogramCuts
+#include "../common/io.h"           // for AlignedFileWriteStream, ResourceHandler
 #include "gradient_index.h"         // for GHistIndexMatrix
 #include "gradient_index_format.h"  // for GHistIndexRawFormat
 #include "sparse_page_source.h"     // for PageSourceIncMixIn
@@ -39,6 +44,96 @@ class GHistIndexFormatPolicy {
   void SetCuts(common::HistogramCuts cuts) { std::swap(cuts_, cuts); }
 };
 
+/**
+ * @brief In-memory cache for the gradient index pages.
+ *
+ *   Pages are kept in the host memory in the raw format, which bit-packs the bin index,
+ *   until the total size reaches the memory budget. Pages above the budget are spilled to
+ *   the cache file.
+ */
+struct GHistIndexHostCache {
+  // Maximum number of bytes of the pages in the host memory.
+  bst_idx_t const max_host_bytes;
+  // One for each page, null if the page is spilled.
+  std::vector<std::shared_ptr<common::ResourceHandler>> pages;
+  // Offset of each page into the cache (`Cache::offset`).
+  std::vector<bst_idx_t> offsets;
+  // Offset of each page into the spill file, only used by the spilled pages.
+  std::vector<bst_idx_t> file_offsets;
+  bst_idx_t total_bytes{0};
+  bst_idx_t host_bytes{0};
+  bst_idx_t file_bytes{0};
+  // Path of the spill file, empty if no page is spilled.
+  std::string spill_file;
+
+  explicit GHistIndexHostCache(bst_idx_t max_host_bytes) : max_host_bytes{max_host_bytes} {}
+  ~GHistIndexHostCache();
+
+  [[nodiscard]] std::size_t NumSpilled() const {
+    return std::count(this->pages.cbegin(), this->pages.cend(), nullptr);
+  }
+};
+
+/**
+ * @brief Write stream for a single page of the host cache. The page is written to the
+ *        memory until it exceeds the budget, then the page is moved to the spill file.
+ */
+class GHistIndexHostWriteStream : public common::AlignedFileWriteStream {
+  class PageResource;
+
+  GHistIndexHostCache* cache_;
+  std::string path_;
+  std::shared_ptr<PageResource> page_;
+  std::unique_ptr<dmlc::Stream> spill_;
+  bst_idx_t n_bytes_{0};
+
+ protected:
+  [[nodiscard]] std::size_t DoWrite(const void* ptr, std::size_t n_bytes) noexcept(true) override;
+
+ public:
+  GHistIndexHostWriteStream(GHistIndexHostCache* cache, std::string path);
+  ~GHistIndexHostWriteStream() override;
+};
+
+/**
+ * @brief Stream policy for the host cache of the gradient index pages.
+ */
+template <typename S, template <typename> typename F>
+class GHistIndexHostStreamPolicy : public F<S> {
+  std::shared_ptr<GHistIndexHostCache> p_cache_;
+
+ public:
+  using WriterT = common::AlignedFileWriteStream;
+  using ReaderT = common::AlignedResourceReadStream;
+
+ public:
+  void SetHostCache(bst_idx_t max_host_bytes) {
+    this->p_cache_ = std::make_shared<GHistIndexHostCache>(max_host_bytes);
+  }
+  [[nodiscard]] std::shared_ptr<GHistIndexHostCache const> HostCache() const {
+    return this->p_cache_;
+  }
+
+  [[nodiscard]] std::unique_ptr<WriterT> CreateWriter(StringView name, std::uint32_t) {
+    CHECK(this->p_cache_);
+    return std::make_unique<GHistIndexHostWriteStream>(this->p_cache_.get(), std::string{name});
+  }
+
+  [[nodiscard]] std::unique_ptr<ReaderT> CreateReader(StringView, bst_idx_t offset,
+                                                      bst_idx_t length) const {
+    auto const& cache = *this->p_cache_;
+    auto it = std::lower_bound(cache.offsets.cbegin(), cache.offsets.cend(), offset);
+    CHECK(it != cache.offsets.cend() && *it == offset);
+    auto k = std::distance(cache.offsets.cbegin(), it);
+    if (cache.pages[k]) {
+      CHECK_EQ(cache.pages[k]->Size(), length);
+      return std::make_unique<common::AlignedResourceReadStream>(cache.pages[k]);
+    }
+    return std::make_unique<common::PrivateMmapConstStream>(cache.spill_file,
+                                                            cache.file_offsets[k], length);
+  }
+};
+
 class GradientIndexPageSource
     : public PageSourceIncMixIn<
           GHistIndexMatrix, DefaultFormatStreamPolicy<GHistIndexMatrix, GHistIndexFormatPolicy>> {
@@ -46,19 +141,22 @@ class GradientIndexPageSource
   std::int32_t max_bin_per_feat_;
   common::Span<FeatureType const> feature_types_;
   double sparse_thresh_;
+  // Write the column matrix for dense pages.
+  bool column_pages_;
 
  public:
   GradientIndexPageSource(float missing, std::int32_t nthreads, bst_feature_t n_features,
                           bst_idx_t n_batches, std::shared_ptr<Cache> cache, BatchParam param,
                           common::HistogramCuts cuts, bool is_dense,
                           common::Span<FeatureType const> feature_types,
-                          std::shared_ptr<SparsePageSource> source)
+                          std::shared_ptr<SparsePageSource> source, bool column_pages)
       : PageSourceIncMixIn(missing, nthreads, n_features, n_batches, cache,
                            std::isnan(param.sparse_thresh)),
         is_dense_{is_dense},
         max_bin_per_feat_{param.max_bin},
         feature_types_{feature_types},
-        sparse_thresh_{param.sparse_thresh} {
+        sparse_thresh_{param.sparse_thresh},
+        column_pages_{column_pages} {
     this->source_ = source;
     this->SetCuts(std::move(cuts));
     if (this->cuts_.HasCategorical()) {
@@ -72,7 +170,7 @@ class GradientIndexPageSource
 
 class ExtGradientIndexPageSource
     : public ExtQantileSourceMixin<
-          GHistIndexMatrix, DefaultFormatStreamPolicy<GHistIndexMatrix, GHistIndexFormatPolicy>> {
+          GHistIndexMatrix, GHistIndexHostStreamPolicy<GHistIndexMatrix, GHistIndexFormatPolicy>> {
   BatchParam p_;
 
   Context const* ctx_;
@@ -80,21 +178,27 @@ class ExtGradientIndexPageSource
   MetaInfo* info_;
 
   std::vector<bst_idx_t> base_rows_;
+  // Write the column matrix for dense pages.
+  bool column_pages_;
 
  public:
   ExtGradientIndexPageSource(
       Context const* ctx, float missing, MetaInfo* info, std::shared_ptr<Cache> cache,
       BatchParam param, common::HistogramCuts cuts,
       std::shared_ptr<DataIterProxy<DataIterResetCallback, XGDMatrixCallbackNext>> source,
-      DMatrixProxy* proxy, std::vector<bst_idx_t> base_rows)
+      DMatrixProxy* proxy, std::vector<bst_idx_t> base_rows, bst_idx_t max_host_cache_bytes,
+      bool column_pages)
       : ExtQantileSourceMixin{missing, ctx->Threads(), static_cast<bst_feature_t>(info->num_col_),
                               source, cache},
         p_{std::move(param)},
         ctx_{ctx},
         proxy_{proxy},
         info_{info},
-        base_rows_{std::move(base_rows)} {
+        base_rows_{std::move(base_rows)},
+        column_pages_{column_pages} {
     CHECK(!this->cache_info_->written);
+    CHECK(this->cache_info_->OnHost()) << "The spill file is owned by the host cache.";
+    this->SetHostCache(max_host_cache_bytes);
     this->source_->Reset();
     CHECK(this->source_->Next());
     this->SetCuts(std::move(cuts));
@@ -6,11 +6,14 @@
 #include <algorithm>  // for copy
 #include <cstddef>    // for size_t
 #include <memory>     // for shared_ptr
+#include <numeric>    // for partial_sum
 #include <utility>    // for move
 #include <vector>     // for vector
 
+#include "../collective/allreduce.h"  // for Allreduce
 #include "../common/categorical.h"  // common::IsCat
 #include "../common/hist_util.h"    // for HistogramCuts
+#include "../common/quantile.h"     // for HostSketchContainer
 #include "../tree/param.h"          // FIXME(jiamingy): Find a better way to share this parameter.
 #include "batch_utils.h"            // for RegenGHist
 #include "gradient_index.h"         // for GHistIndexMatrix
@@ -18,6 +21,7 @@
 #include "quantile_dmatrix.h"       // for GetCutsFromRef
 #include "quantile_dmatrix.h"       // for GetDataShape, MakeSketches
 #include "simple_batch_iterator.h"  // for SimpleBatchIteratorImpl
+#include "xgboost/collective/result.h"  // for SafeColl
 #include "xgboost/data.h"           // for FeatureType, DMatrix
 #include "xgboost/logging.h"
 
@@ -25,7 +29,8 @@ namespace xgboost::data {
 IterativeDMatrix::IterativeDMatrix(DataIterHandle iter_handle, DMatrixHandle proxy,
                                    std::shared_ptr<DMatrix> ref, DataIterResetCallback* reset,
                                    XGDMatrixCallbackNext* next, float missing, int nthread,
-                                   bst_bin_t max_bin, std::int64_t max_quantile_blocks)
+                                   bst_bin_t max_bin, std::int64_t max_quantile_blocks,
+                                   bool single_pass, double sketch_sample_eps)
     : proxy_{proxy}, reset_{reset}, next_{next} {
   // fetch the first batch
   auto iter =
@@ -42,9 +47,17 @@ IterativeDMatrix::IterativeDMatrix(DataIterHandle iter_handle, DMatrixHandle pro
   BatchParam p{max_bin, tree::TrainParam::DftSparseThreshold()};
 
   if (ctx.IsCUDA()) {
+    if (single_pass) {
+      LOG(WARNING) << "Single pass construction is not supported by GPU, ignored.";
+    }
+    if (sketch_sample_eps > 0) {
+      LOG(WARNING) << "Sketching on a sample is not supported by GPU, ignored.";
+    }
     this->InitFromCUDA(&ctx, p, max_quantile_blocks, iter_handle, missing, ref);
+  } else if (single_pass) {
+    this->InitFromCPUBuffered(&ctx, p, iter_handle, missing, sketch_sample_eps, ref);
   } else {
-    this->InitFromCPU(&ctx, p, iter_handle, missing, ref);
+    this->InitFromCPU(&ctx, p, iter_handle, missing, sketch_sample_eps, ref);
   }
 
   this->fmat_ctx_ = ctx;
@@ -55,7 +68,7 @@ IterativeDMatrix::IterativeDMatrix(DataIterHandle iter_handle, DMatrixHandle pro
 }
 
 void IterativeDMatrix::InitFromCPU(Context const* ctx, BatchParam const& p,
-                                   DataIterHandle iter_handle, float missing,
+                                   DataIterHandle iter_handle, float missing, double sample_eps,
                                    std::shared_ptr<DMatrix> ref) {
   DMatrixProxy* proxy = MakeProxy(proxy_);
   CHECK(proxy);
@@ -72,7 +85,8 @@ void IterativeDMatrix::InitFromCPU(Context const* ctx, BatchParam const& p,
    * Generate quantiles
    */
   std::vector<FeatureType> h_ft;
-  cpu_impl::MakeSketches(ctx, &iter, proxy, ref, missing, &cuts, p, this->info_, ext_info, &h_ft);
+  cpu_impl::MakeSketches(ctx, &iter, proxy, ref, missing, &cuts, p, this->info_, ext_info,
+                         sample_eps, &h_ft);
 
   /**
    * Generate gradient index.
@@ -99,18 +113,8 @@ void IterativeDMatrix::InitFromCPU(Context const* ctx, BatchParam const& p,
   CHECK_EQ(rbegin, Info().num_row_);
   CHECK_EQ(this->ghist_->Features(), Info().num_col_);
 
-  /**
-   * Generate column matrix
-   */
-  bst_idx_t accumulated_rows = 0;
-  while (iter.Next()) {
-    HostAdapterDispatch(proxy, [&](auto const& batch) {
-      this->ghist_->PushAdapterBatchColumns(ctx, batch, missing, accumulated_rows);
-    });
-    accumulated_rows += BatchSamples(proxy);
-  }
-  iter.Reset();
-  CHECK_EQ(accumulated_rows, Info().num_row_);
+  // The column matrix is built from the gradient index when it's first used for
+  // training, there's no need to iterate through the data again.
 
   if (ext_info.n_batches == 1) {
     this->info_ = std::move(proxy->Info());
@@ -122,6 +126,105 @@ void IterativeDMatrix::InitFromCPU(Context const* ctx, BatchParam const& p,
   info_.feature_types.HostVector() = h_ft;
 }
 
+void IterativeDMatrix::InitFromCPUBuffered(Context const* ctx, BatchParam const& p,
+                                           DataIterHandle iter_handle, float missing,
+                                           double sample_eps, std::shared_ptr<DMatrix> ref) {
+  DMatrixProxy* proxy = MakeProxy(proxy_);
+  CHECK(proxy);
+
+  auto iter =
+      DataIterProxy<DataIterResetCallback, XGDMatrixCallbackNext>{iter_handle, reset_, next_};
+  // A compact CSR copy of all batches, released once the gradient index is built.
+  SparsePage buffer;
+  ExternalDataInfo ext_info;
+  do {
+    // The first batch is fetched in ctor.
+    if (ext_info.n_features == 0) {
+      ext_info.n_features = BatchColumns(proxy);
+      collective::SafeColl(
+          collective::Allreduce(ctx, &ext_info.n_features, collective::Op::kMax));
+      ext_info.column_sizes.resize(ext_info.n_features, 0);
+    } else {
+      CHECK_EQ(ext_info.n_features, BatchColumns(proxy)) << "Inconsistent number of columns.";
+    }
+    auto batch_size = BatchSamples(proxy);
+    ext_info.batch_nnz.push_back(
+        cpu_impl::CountColumnSizes(ctx, proxy, missing, &ext_info.column_sizes));
+    HostAdapterDispatch(proxy, [&](auto const& batch) {
+      buffer.Push(batch, missing, ctx->Threads());
+    });
+    // Empty rows at the end of the batch.
+    auto& h_offset = buffer.offset.HostVector();
+    h_offset.resize(ext_info.accumulated_rows + batch_size + 1, h_offset.back());
+
+    ext_info.base_rowids.push_back(batch_size);
+    ext_info.nnz += ext_info.batch_nnz.back();
+    ext_info.accumulated_rows += batch_size;
+    ext_info.n_batches++;
+    this->info_.Extend(std::move(proxy->Info()), false, true);
+  } while (iter.Next());
+  iter.Reset();
+  std::partial_sum(ext_info.base_rowids.cbegin(), ext_info.base_rowids.cend(),
+                   ext_info.base_rowids.begin());
+  CHECK_EQ(buffer.data.Size(), ext_info.nnz);
+  ext_info.SetInfo(ctx, &this->info_);
+
+  /**
+   * Generate quantiles from the buffer, or take them from the reference.
+   */
+  common::HistogramCuts cuts;
+  std::vector<FeatureType> h_ft;
+  if (ref) {
+    GetCutsFromRef(ctx, ref, this->info_.num_col_, p, &cuts);
+    h_ft = ref->Info().feature_types.HostVector();
+  } else {
+    h_ft = this->info_.feature_types.ConstHostVector();
+    cpu_impl::SyncFeatureType(ctx, &h_ft);
+    common::HostSketchContainer sketch{ctx, p.max_bin, h_ft, ext_info.column_sizes,
+                                       !this->info_.group_ptr_.empty()};
+    if (sample_eps > 0) {
+      sketch.SampleRows(this->info_.num_row_, sample_eps);
+    }
+    sketch.PushRowPage(buffer, this->info_);
+    sketch.MakeCuts(ctx, this->info_, &cuts);
+  }
+  if (!h_ft.empty()) {
+    CHECK_EQ(h_ft.size(), ext_info.n_features);
+  }
+
+  /**
+   * Generate gradient index.
+   */
+  this->ghist_ = std::make_shared<GHistIndexMatrix>(buffer, common::Span<FeatureType const>{h_ft},
+                                                    std::move(cuts), p.max_bin,
+                                                    this->info_.IsDense(), p.sparse_thresh,
+                                                    ctx->Threads());
+  CHECK_EQ(this->ghist_->Size(), Info().num_row_);
+  CHECK_EQ(this->ghist_->Features(), Info().num_col_);
+  info_.feature_types.HostVector() = h_ft;
+}
+
+void IterativeDMatrix::Append(DMatrix* that) {
+  CHECK(that);
+  CHECK(!Info().IsColumnSplit() && !that->Info().IsColumnSplit())
+      << "Appending column-split data is not supported.";
+  CHECK_EQ(Info().num_col_, that->Info().num_col_)
+      << "The number of columns must be the same for appending data.";
+  auto ctx = fmat_ctx_.MakeCPU();
+  if (!ghist_) {
+    CHECK(ellpack_) << "`QuantileDMatrix` not initialized.";
+    ghist_ = std::make_shared<GHistIndexMatrix>(&ctx, Info(), *ellpack_, batch_);
+  }
+  ghist_->Extend(&ctx, that, batch_.sparse_thresh);
+  // The ellpack page is generated from the gradient index on demand.
+  ellpack_.reset();
+
+  auto n_nonzero = info_.num_nonzero_ + that->Info().num_nonzero_;
+  info_.Extend(that->Info(), true, true);
+  info_.num_nonzero_ = n_nonzero;
+  CHECK_EQ(ghist_->Size(), info_.num_row_);
+}
+
 BatchSet<GHistIndexMatrix> IterativeDMatrix::GetGradientIndex(Context const* ctx,
                                                               BatchParam const& param) {
   if (param.Initialized()) {
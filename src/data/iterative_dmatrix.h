@@ -41,13 +41,20 @@ class IterativeDMatrix : public QuantileDMatrix {
   void InitFromCUDA(Context const *ctx, BatchParam const &p, std::int64_t max_quantile_blocks,
                     DataIterHandle iter_handle, float missing, std::shared_ptr<DMatrix> ref);
   void InitFromCPU(Context const *ctx, BatchParam const &p, DataIterHandle iter_handle,
-                   float missing, std::shared_ptr<DMatrix> ref);
+                   float missing, double sample_eps, std::shared_ptr<DMatrix> ref);
+  /**
+   * @brief Copy the batches into a buffer in a single pass over the iterator, then
+   *        sketch and quantise the buffer.
+   */
+  void InitFromCPUBuffered(Context const *ctx, BatchParam const &p, DataIterHandle iter_handle,
+                           float missing, double sample_eps, std::shared_ptr<DMatrix> ref);
 
  public:
   explicit IterativeDMatrix(DataIterHandle iter_handle, DMatrixHandle proxy,
                             std::shared_ptr<DMatrix> ref, DataIterResetCallback *reset,
                             XGDMatrixCallbackNext *next, float missing, int nthread,
-                            bst_bin_t max_bin, std::int64_t max_quantile_blocks);
+                            bst_bin_t max_bin, std::int64_t max_quantile_blocks,
+                            bool single_pass = false, double sketch_sample_eps = 0.0);
   /**
    * @param Directly construct a QDM from an existing one.
    */
@@ -55,6 +62,12 @@ class IterativeDMatrix : public QuantileDMatrix {
 
   ~IterativeDMatrix() override = default;
 
+  /**
+   * @brief Append the rows of another DMatrix. The rows are quantised with the existing
+   *        cuts on CPU.
+   */
+  void Append(DMatrix *that);
+
   bool EllpackExists() const override { return static_cast<bool>(ellpack_); }
   bool GHistIndexExists() const override { return static_cast<bool>(ghist_); }
 
@@ -0,0 +1,281 @@
+/**
+ * Copyright 2025, XGBoost contributors
+ */
+#include "libsvm_parser.h"
+
+#include <algorithm>     // for copy, find, equal, clamp, max, all_of, transform
+#include <array>         // for array
+#include <charconv>      // for from_chars
+#include <cstdlib>       // for strtof
+#include <cstring>       // for memchr
+#include <filesystem>    // for file_size, is_regular_file
+#include <map>           // for map
+#include <system_error>  // for errc
+
+#include "../common/charconv.h"         // for from_chars
+#include "../common/common.h"           // for Split
+#include "../common/io.h"               // for MmapResource
+#include "../common/threading_utils.h"  // for ParallelFor
+#include "xgboost/logging.h"            // for LOG
+
+namespace xgboost::data {
+namespace {
+bool IsBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+/**
+ * @brief Parse a float with the ryu-based `from_chars`, falls back to `strtof` for input
+ *        outside of its supported range, like long mantissa or a leading `+`.
+ */
+bool ParseFloat(char const* beg, char const* end, float* out) {
+  auto res = from_chars(beg, end, *out);
+  if (res.ec == std::errc{} && res.ptr == end) {
+    return true;
+  }
+  std::array<char, 64> buf;
+  auto n = static_cast<std::size_t>(end - beg);
+  if (n == 0 || n >= buf.size()) {
+    return false;
+  }
+  std::copy(beg, end, buf.begin());
+  buf[n] = '\0';
+  char* p_end{nullptr};
+  *out = std::strtof(buf.data(), &p_end);
+  return p_end == buf.data() + n;
+}
+
+template <typename T>
+bool ParseInt(char const* beg, char const* end, T* out) {
+  auto res = std::from_chars(beg, end, *out);
+  return res.ec == std::errc{} && res.ptr == end;
+}
+
+// Parse the lines in [beg, end) into `out`.
+bool ParseLines(char const* beg, char const* end, bool one_based, LibSVMBlock* out) {
+  auto& blk = *out;
+  // -1 for unknown, otherwise whether the lines have weights or query IDs.
+  std::int32_t has_weight{-1}, has_qid{-1};
+  while (beg != end) {
+    auto lend = static_cast<char const*>(std::memchr(beg, '\n', end - beg));
+    if (lend == nullptr) {
+      lend = end;
+    }
+    auto p = beg;
+    beg = lend == end ? end : lend + 1;
+
+    char const *tbeg{nullptr}, *tend{nullptr};
+    auto next_token = [&] {
+      while (p != lend && IsBlank(*p)) {
+        ++p;
+      }
+      if (p == lend) {
+        return false;
+      }
+      tbeg = p;
+      while (p != lend && !IsBlank(*p)) {
+        ++p;
+      }
+      tend = p;
+      return true;
+    };
+
+    if (!next_token()) {
+      continue;  // Blank line.
+    }
+    if (std::find(tbeg, lend, '#') != lend) {
+      return false;  // Comments are not supported.
+    }
+    // label[:weight]
+    auto colon = std::find(tbeg, tend, ':');
+    float label{0};
+    if (!ParseFloat(tbeg, colon, &label)) {
+      return false;
+    }
+    std::int32_t line_has_weight = colon != tend;
+    if (has_weight != -1 && has_weight != line_has_weight) {
+      return false;
+    }
+    has_weight = line_has_weight;
+    if (line_has_weight) {
+      float w{0};
+      if (!ParseFloat(colon + 1, tend, &w)) {
+        return false;
+      }
+      blk.weight.push_back(w);
+    }
+    blk.label.push_back(label);
+
+    // [qid:id] index:value ...
+    std::int32_t line_has_qid{0};
+    while (next_token()) {
+      colon = std::find(tbeg, tend, ':');
+      if (colon == tend) {
+        return false;  // Feature without value.
+      }
+      StringView qid_key{"qid"};
+      if (std::equal(tbeg, colon, qid_key.cbegin(), qid_key.cend())) {
+        if (line_has_qid || blk.index.size() != blk.offset.back()) {
+          return false;
+        }
+        std::uint64_t qid{0};
+        if (!ParseInt(colon + 1, tend, &qid)) {
+          return false;
+        }
+        blk.qid.push_back(qid);
+        line_has_qid = 1;
+        continue;
+      }
+      std::uint32_t fidx{0};
+      float value{0};
+      if (!ParseInt(tbeg, colon, &fidx) || !ParseFloat(colon + 1, tend, &value)) {
+        return false;
+      }
+      if (one_based) {
+        if (fidx == 0) {
+          return false;
+        }
+        --fidx;
+      }
+      blk.index.push_back(fidx);
+      blk.value.push_back(value);
+    }
+    if (has_qid != -1 && has_qid != line_has_qid) {
+      return false;
+    }
+    has_qid = line_has_qid;
+    blk.offset.push_back(blk.index.size());
+  }
+  return true;
+}
+}  // anonymous namespace
+
+[[nodiscard]] bool ParseLibSVM(StringView text, bool one_based, std::int32_t n_threads,
+                               LibSVMBlock* out) {
+  // Don't split small text.
+  std::size_t constexpr kMinChunkBytes = 1ul << 20;
+  auto n_chunks = std::clamp(text.size() / kMinChunkBytes, static_cast<std::size_t>(1),
+                             static_cast<std::size_t>(std::max(n_threads, 1)));
+
+  // Split the text on line boundaries.
+  auto text_end = text.c_str() + text.size();
+  std::vector<char const*> bounds(n_chunks + 1, text_end);
+  bounds.front() = text.c_str();
+  for (std::size_t i = 1; i < n_chunks; ++i) {
+    auto p = std::max(text.c_str() + text.size() / n_chunks * i, bounds[i - 1]);
+    auto nl = static_cast<char const*>(std::memchr(p, '\n', text_end - p));
+    bounds[i] = nl == nullptr ? text_end : nl + 1;
+  }
+
+  std::vector<LibSVMBlock> blocks(n_chunks);
+  std::vector<std::int32_t> valid(n_chunks, 0);
+  common::ParallelFor(n_chunks, n_threads, [&](auto i) {
+    valid[i] = ParseLines(bounds[i], bounds[i + 1], one_based, &blocks[i]);
+  });
+  if (!std::all_of(valid.cbegin(), valid.cend(), [](auto v) { return v; })) {
+    return false;
+  }
+
+  // All chunks must agree on the weights and query IDs.
+  std::int32_t has_weight{-1}, has_qid{-1};
+  std::vector<std::size_t> row_ptr(n_chunks + 1, 0), nnz_ptr(n_chunks + 1, 0);
+  for (std::size_t i = 0; i < n_chunks; ++i) {
+    auto const& blk = blocks[i];
+    row_ptr[i + 1] = row_ptr[i] + blk.Size();
+    nnz_ptr[i + 1] = nnz_ptr[i] + blk.index.size();
+    if (blk.Size() == 0) {
+      continue;
+    }
+    std::int32_t blk_has_weight = !blk.weight.empty(), blk_has_qid = !blk.qid.empty();
+    if ((has_weight != -1 && has_weight != blk_has_weight) ||
+        (has_qid != -1 && has_qid != blk_has_qid)) {
+      return false;
+    }
+    has_weight = blk_has_weight;
+    has_qid = blk_has_qid;
+  }
+
+  auto& result = *out;
+  auto n_rows = row_ptr.back(), nnz = nnz_ptr.back();
+  result.offset.resize(n_rows + 1);
+  result.offset.front() = 0;
+  result.label.resize(n_rows);
+  result.weight.resize(has_weight == 1 ? n_rows : 0);
+  result.qid.resize(has_qid == 1 ? n_rows : 0);
+  result.index.resize(nnz);
+  result.value.resize(nnz);
+  common::ParallelFor(n_chunks, n_threads, [&](auto i) {
+    auto const& blk = blocks[i];
+    auto rbeg = row_ptr[i];
+    std::transform(blk.offset.cbegin() + 1, blk.offset.cend(), result.offset.begin() + rbeg + 1,
+                   [&](auto v) { return v + nnz_ptr[i]; });
+    std::copy(blk.label.cbegin(), blk.label.cend(), result.label.begin() + rbeg);
+    std::copy(blk.weight.cbegin(), blk.weight.cend(), result.weight.begin() + rbeg);
+    std::copy(blk.qid.cbegin(), blk.qid.cend(), result.qid.begin() + rbeg);
+    std::copy(blk.index.cbegin(), blk.index.cend(), result.index.begin() + nnz_ptr[i]);
+    std::copy(blk.value.cbegin(), blk.value.cend(), result.value.begin() + nnz_ptr[i]);
+  });
+  return true;
+}
+
+LibSVMTextParser::LibSVMTextParser(LibSVMBlock&& data, std::size_t n_bytes)
+    : data_{std::move(data)}, n_bytes_{n_bytes} {
+  block_.size = data_.Size();
+  block_.offset = data_.offset.data();
+  block_.label = data_.label.data();
+  block_.weight = data_.weight.empty() ? nullptr : data_.weight.data();
+  block_.qid = data_.qid.empty() ? nullptr : data_.qid.data();
+  block_.field = nullptr;
+  block_.index = data_.index.data();
+  block_.value = data_.value.data();
+}
+
+[[nodiscard]] std::unique_ptr<dmlc::Parser<std::uint32_t>> TryCreateNativeParser(
+    std::string const& uri, std::int32_t n_threads) {
+  auto name_args = common::Split(uri, '?');
+  if (name_args.size() != 2) {
+    return nullptr;
+  }
+  std::map<std::string, std::string> args;
+  for (auto const& kv : common::Split(name_args[1], '&')) {
+    auto pair = common::Split(kv, '=');
+    if (pair.size() != 2) {
+      return nullptr;
+    }
+    args[pair[0]] = pair[1];
+  }
+  bool one_based{false};
+  for (auto const& [key, value] : args) {
+    if (key == "format" && value == "libsvm") {
+      continue;
+    } else if (key == "indexing_mode" && (value == "0" || value == "1")) {
+      one_based = value == "1";
+    } else {
+      // Leave anything else to the dmlc parser.
+      return nullptr;
+    }
+  }
+  if (args.find("format") == args.cend()) {
+    return nullptr;
+  }
+
+  auto const& path = name_args[0];
+  std::error_code ec;
+  if (!std::filesystem::is_regular_file(path, ec)) {
+    return nullptr;
+  }
+  auto n_bytes = std::filesystem::file_size(path, ec);
+  if (ec || n_bytes == 0) {
+    return nullptr;
+  }
+
+  LibSVMBlock data;
+  {
+    common::MmapResource mmap{StringView{path}, 0, n_bytes};
+    StringView text{static_cast<char const*>(mmap.Data()), n_bytes};
+    if (!ParseLibSVM(text, one_based, n_threads, &data)) {
+      LOG(DEBUG) << "Use the dmlc parser for: " << path;
+      return nullptr;
+    }
+  }
+  return std::make_unique<LibSVMTextParser>(std::move(data), n_bytes);
+}
+}  // namespace xgboost::data
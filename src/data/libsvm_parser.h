@@ -0,0 +1,89 @@
+/**
+ * Copyright 2025, XGBoost contributors
+ */
+#ifndef XGBOOST_DATA_LIBSVM_PARSER_H_
+#define XGBOOST_DATA_LIBSVM_PARSER_H_
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t, uint64_t, int32_t
+#include <memory>   // for unique_ptr
+#include <string>   // for string
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "dmlc/data.h"            // for RowBlock, Parser
+#include "xgboost/string_view.h"  // for StringView
+
+namespace xgboost::data {
+/**
+ * @brief Rows parsed from a LibSVM text, in CSR format.
+ */
+struct LibSVMBlock {
+  std::vector<std::size_t> offset{0};
+  std::vector<float> label;
+  // Empty if the text doesn't have weights.
+  std::vector<float> weight;
+  // Empty if the text doesn't have query IDs.
+  std::vector<std::uint64_t> qid;
+  std::vector<std::uint32_t> index;
+  std::vector<float> value;
+
+  [[nodiscard]] std::size_t Size() const { return label.size(); }
+};
+
+/**
+ * @brief Parse a LibSVM text with multiple threads.
+ *
+ *   The text is split into chunks on line boundaries, and each chunk is parsed by a
+ *   thread. Only the common subset of the format is supported: `label[:weight]
+ *   [qid:id] index:value ...` with the weight and the query ID being either present or
+ *   absent on all lines.
+ *
+ * @param text      The content of a LibSVM file.
+ * @param one_based Whether the feature index starts from 1.
+ * @param n_threads The number of threads used for parsing.
+ * @param out       The parsed rows.
+ *
+ * @return False if the text contains anything outside the supported syntax, like comments
+ *         or features without values.
+ */
+[[nodiscard]] bool ParseLibSVM(StringView text, bool one_based, std::int32_t n_threads,
+                               LibSVMBlock* out);
+
+/**
+ * @brief A parser that returns all rows parsed by @ref ParseLibSVM as a single block.
+ */
+class LibSVMTextParser : public dmlc::Parser<std::uint32_t> {
+  LibSVMBlock data_;
+  dmlc::RowBlock<std::uint32_t> block_;
+  std::size_t n_bytes_;
+  bool at_head_{true};
+
+ public:
+  LibSVMTextParser(LibSVMBlock&& data, std::size_t n_bytes);
+
+  void BeforeFirst() override { at_head_ = true; }
+  bool Next() override {
+    if (!at_head_) {
+      return false;
+    }
+    at_head_ = false;
+    return true;
+  }
+  [[nodiscard]] const dmlc::RowBlock<std::uint32_t>& Value() const override { return block_; }
+  [[nodiscard]] std::size_t BytesRead() const override { return n_bytes_; }
+};
+
+/**
+ * @brief Create a native parser for a local LibSVM file.
+ *
+ * @param uri       File path with URI arguments, as returned by `ValidateFileFormat`.
+ * @param n_threads The number of threads used for parsing.
+ *
+ * @return nullptr if the file or its content is not supported, in which case the dmlc
+ *         parser should be used instead.
+ */
+[[nodiscard]] std::unique_ptr<dmlc::Parser<std::uint32_t>> TryCreateNativeParser(
+    std::string const& uri, std::int32_t n_threads);
+}  // namespace xgboost::data
+#endif  // XGBOOST_DATA_LIBSVM_PARSER_H_
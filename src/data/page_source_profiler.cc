@@ -0,0 +1,117 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include "page_source_profiler.h"
+
+#include <algorithm>  // for clamp, max, sort
+#include <atomic>     // for atomic
+#include <cmath>      // for ceil
+#include <cstddef>    // for size_t, byte
+#include <utility>    // for move
+
+#include "../common/io.h"  // for AlignedResourceReadStream
+
+namespace xgboost::data {
+std::atomic<bool> PageSourceProfiler::enabled_{false};
+
+PageSourceProfiler& PageSourceProfiler::Get() {
+  static PageSourceProfiler profiler;
+  return profiler;
+}
+
+void PageSourceProfiler::Start() {
+  std::lock_guard guard{mu_};
+  records_.clear();
+  start_ = std::chrono::steady_clock::now();
+  enabled_ = true;
+}
+
+std::vector<PageFetchRecord> PageSourceProfiler::Stop() {
+  std::lock_guard guard{mu_};
+  enabled_ = false;
+  auto records = std::move(records_);
+  records_.clear();
+  std::stable_sort(records.begin(), records.end(),
+                   [](auto const& l, auto const& r) { return l.begin < r.begin; });
+  return records;
+}
+
+double PageSourceProfiler::Now() const {
+  return std::chrono::duration<double>{std::chrono::steady_clock::now() - start_}.count();
+}
+
+void PageSourceProfiler::Record(PageFetchRecord const& record) {
+  std::lock_guard guard{mu_};
+  if (Enabled()) {
+    records_.push_back(record);
+  }
+}
+
+void PrefaultStream(common::AlignedResourceReadStream* fi) {
+  auto resource = fi->Share();
+  auto const* data = static_cast<std::byte const*>(resource->Data());
+  auto n_bytes = resource->Size();
+  std::size_t constexpr kPageSize = 4096;
+  std::uint8_t acc{0};
+  for (std::size_t i = 0; i < n_bytes; i += kPageSize) {
+    acc ^= std::to_integer<std::uint8_t>(data[i]);
+  }
+  // Keep the loop from being optimized out.
+  static std::atomic<std::uint8_t> sink{0};
+  sink.store(acc, std::memory_order_relaxed);
+}
+
+PageSourceSuggestion SuggestPageSource(common::Span<PageFetchRecord const> records,
+                                       std::int32_t max_prefetch) {
+  PageSourceSuggestion out;
+  if (records.empty()) {
+    return out;
+  }
+  // Least squares for read = latency + n_bytes * inv_bw. Use the total fetch time when the
+  // read is not measured separately.
+  auto read_time = [](PageFetchRecord const& r) { return r.read > 0 ? r.read : r.decode; };
+  double n = static_cast<double>(records.size());
+  double sx{0}, sy{0}, sxx{0}, sxy{0}, fetch{0}, compute{0};
+  for (auto const& r : records) {
+    auto x = static_cast<double>(r.n_bytes);
+    auto y = read_time(r);
+    sx += x;
+    sy += y;
+    sxx += x * x;
+    sxy += x * y;
+    fetch += r.read + r.decode;
+    compute += r.compute;
+  }
+  double var = sxx - sx * sx / n;
+  double inv_bw{0};
+  if (var > 0) {
+    inv_bw = (sxy - sx * sy / n) / var;
+    out.latency = std::max((sy - inv_bw * sx) / n, 0.0);
+  }
+  if (inv_bw <= 0) {
+    // All pages have the same size, or the reads are too noisy for a fit.
+    inv_bw = sx > 0 ? sy / sx : 0;
+    out.latency = 0;
+  }
+  out.bandwidth = inv_bw > 0 ? 1.0 / inv_bw : 0;
+
+  // Keep the latency below 10% of the read time.
+  double constexpr kLatencyRatio = 0.1;
+  auto mean_bytes = static_cast<std::int64_t>(sx / n);
+  if (out.latency > 0 && out.bandwidth > 0) {
+    auto min_bytes = out.latency * out.bandwidth * (1.0 - kLatencyRatio) / kLatencyRatio;
+    out.page_bytes = std::max(static_cast<std::int64_t>(min_bytes), std::int64_t{1});
+  } else {
+    out.page_bytes = mean_bytes;
+  }
+
+  // Enough pages in flight for the fetch of a page to finish within the time of consuming
+  // the pages before it, plus one to absorb the jitter.
+  fetch /= n;
+  compute /= n;
+  auto depth = compute > 0 ? std::ceil(fetch / compute) + 1.0 : static_cast<double>(max_prefetch);
+  out.n_prefetch_batches =
+      std::clamp(static_cast<std::int32_t>(depth), 1, std::max(max_prefetch, 1));
+  return out;
+}
+}  // namespace xgboost::data
@@ -0,0 +1,118 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ *
+ * @brief Profiling of the page fetches from the external memory cache.
+ */
+#ifndef XGBOOST_DATA_PAGE_SOURCE_PROFILER_H_
+#define XGBOOST_DATA_PAGE_SOURCE_PROFILER_H_
+
+#include <atomic>       // for atomic
+#include <chrono>       // for steady_clock
+#include <cstdint>      // for int32_t, int64_t, uint32_t
+#include <mutex>        // for mutex
+#include <type_traits>  // for is_same_v
+#include <vector>       // for vector
+
+#include "xgboost/data.h"         // for SparsePage, CSCPage, SortedCSCPage
+#include "xgboost/span.h"         // for Span
+#include "xgboost/string_view.h"  // for StringView
+
+namespace xgboost::common {
+class AlignedResourceReadStream;
+}  // namespace xgboost::common
+
+namespace xgboost::data {
+/**
+ * @brief Statistics of fetching a page from the cache.
+ */
+struct PageFetchRecord {
+  // Name of the page type.
+  StringView source;
+  std::uint32_t page{0};
+  std::int64_t n_bytes{0};
+  // Seconds since the profiler is started, when the page is requested by the consumer.
+  double begin{0};
+  // Seconds for reading the bytes from the storage, measured by the prefetch worker. It's
+  // zero if the reader can not be separated from the decoding.
+  double read{0};
+  // Seconds for decoding the page, measured by the prefetch worker.
+  double decode{0};
+  // Seconds that the consumer is stalled waiting for the page.
+  double wait{0};
+  // Seconds that the consumer spent on the previous page.
+  double compute{0};
+  // Number of pages in the prefetch queue when the page is requested.
+  std::int32_t depth{0};
+};
+
+/**
+ * @brief Process-wide recorder of the page fetches. Only reads an atomic flag when it's not
+ *        started.
+ */
+class PageSourceProfiler {
+  static std::atomic<bool> enabled_;
+  std::mutex mu_;
+  std::vector<PageFetchRecord> records_;
+  std::chrono::steady_clock::time_point start_;
+
+ public:
+  [[nodiscard]] static PageSourceProfiler& Get();
+  [[nodiscard]] static bool Enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  /** @brief Discard the existing records and start recording. */
+  void Start();
+  /** @brief Stop recording and return the records in the order of the requests. */
+  [[nodiscard]] std::vector<PageFetchRecord> Stop();
+  /** @brief Seconds since the profiler is started. */
+  [[nodiscard]] double Now() const;
+  void Record(PageFetchRecord const& record);
+};
+
+/**
+ * @brief Settings suggested from the page fetches of a storage device.
+ */
+struct PageSourceSuggestion {
+  // Read bandwidth in bytes per second.
+  double bandwidth{0};
+  // Fixed cost of reading a page in seconds, like the seek time or the network latency.
+  double latency{0};
+  std::int32_t n_prefetch_batches{1};
+  std::int64_t page_bytes{0};
+};
+
+/**
+ * @brief Fit the read time as `latency + n_bytes / bandwidth`, then suggest the smallest page
+ *        size that makes the latency a negligible part of the read, along with the number
+ *        of prefetched pages needed for hiding the fetch behind the consumer.
+ *
+ * @param records      Page fetches, pages of different sizes are required for estimating the
+ *                     latency.
+ * @param max_prefetch Upper bound of the suggested number of prefetched pages.
+ */
+[[nodiscard]] PageSourceSuggestion SuggestPageSource(common::Span<PageFetchRecord const> records,
+                                                     std::int32_t max_prefetch);
+
+/**
+ * @brief Touch every memory page of the stream to bring a mapped file into memory, without
+ *        moving the cursor. Used for timing the read separately from the decoding.
+ */
+void PrefaultStream(common::AlignedResourceReadStream* fi);
+
+template <typename S>
+[[nodiscard]] StringView PageSourceName() {
+  if constexpr (std::is_same_v<S, CSCPage>) {
+    return "CSCPage";
+  } else if constexpr (std::is_same_v<S, SortedCSCPage>) {
+    return "SortedCSCPage";
+  } else if constexpr (std::is_same_v<S, SparsePage>) {
+    return "SparsePage";
+  } else if constexpr (std::is_same_v<S, GHistIndexMatrix>) {
+    return "GHistIndexMatrix";
+  } else if constexpr (std::is_same_v<S, EllpackPage>) {
+    return "EllpackPage";
+  } else {
+    return "Unknown";
+  }
+}
+}  // namespace xgboost::data
+#endif  // XGBOOST_DATA_PAGE_SOURCE_PROFILER_H_
@@ -24,6 +24,14 @@ void DMatrixProxy::SetColumnarData(StringView interface_str) {
   this->ctx_.Init(Args{{"device", "cpu"}});
 }
 
+void DMatrixProxy::SetArrowData(ArrowArray const* array, ArrowSchema const* schema) {
+  std::shared_ptr<ColumnarAdapter> adapter{new ColumnarAdapter{ArrowColumns{array, schema}}};
+  this->batch_ = adapter;
+  this->Info().num_col_ = adapter->NumColumns();
+  this->Info().num_row_ = adapter->NumRows();
+  this->ctx_.Init(Args{{"device", "cpu"}});
+}
+
 void DMatrixProxy::SetArrayData(StringView interface_str) {
   std::shared_ptr<ArrayAdapter> adapter{new ArrayAdapter{interface_str}};
   this->batch_ = adapter;
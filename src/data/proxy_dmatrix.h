@@ -93,6 +93,10 @@ class DMatrixProxy : public DMatrix {
   }
 
   void SetColumnarData(StringView interface_str);
+  /**
+   * @brief Set an Arrow record batch, see @ref ArrowColumns for the lifetime requirement.
+   */
+  void SetArrowData(ArrowArray const* array, ArrowSchema const* schema);
 
   void SetArrayData(StringView interface_str);
   void SetCSRData(char const* c_indptr, char const* c_indices, char const* c_values,
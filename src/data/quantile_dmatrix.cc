@@ -83,38 +83,40 @@ void SyncFeatureType(Context const* ctx, std::vector<FeatureType>* p_h_ft) {
   }
 }
 
-void GetDataShape(Context const* ctx, DMatrixProxy* proxy,
-                  DataIterProxy<DataIterResetCallback, XGDMatrixCallbackNext> iter, float missing,
-                  ExternalDataInfo* p_info) {
-  auto& info = *p_info;
-
+bst_idx_t CountColumnSizes(Context const* ctx, DMatrixProxy const* proxy, float missing,
+                           std::vector<bst_idx_t>* p_column_sizes) {
+  auto& column_sizes = *p_column_sizes;
   auto const is_valid = data::IsValidFunctor{missing};
-  auto nnz_cnt = [&]() {
-    return HostAdapterDispatch(proxy, [&](auto const& value) {
-      bst_idx_t n_threads = ctx->Threads();
-      bst_idx_t n_features = info.column_sizes.size();
-      linalg::Tensor<bst_idx_t, 2> column_sizes_tloc({n_threads, n_features}, DeviceOrd::CPU());
-      column_sizes_tloc.Data()->Fill(0ul);
-      auto view = column_sizes_tloc.HostView();
-      common::ParallelFor(value.Size(), n_threads, common::Sched::Static(256), [&](auto i) {
-        auto const& line = value.GetLine(i);
-        for (bst_idx_t j = 0; j < line.Size(); ++j) {
-          data::COOTuple const& elem = line.GetElement(j);
-          if (is_valid(elem)) {
-            view(omp_get_thread_num(), elem.column_idx)++;
-          }
-        }
-      });
-      auto ptr = column_sizes_tloc.Data()->HostPointer();
-      auto result = std::accumulate(ptr, ptr + column_sizes_tloc.Size(), static_cast<bst_idx_t>(0));
-      for (bst_idx_t tidx = 0; tidx < n_threads; ++tidx) {
-        for (bst_idx_t fidx = 0; fidx < n_features; ++fidx) {
-          info.column_sizes[fidx] += view(tidx, fidx);
+  return HostAdapterDispatch(proxy, [&](auto const& value) {
+    bst_idx_t n_threads = ctx->Threads();
+    bst_idx_t n_features = column_sizes.size();
+    linalg::Tensor<bst_idx_t, 2> column_sizes_tloc({n_threads, n_features}, DeviceOrd::CPU());
+    column_sizes_tloc.Data()->Fill(0ul);
+    auto view = column_sizes_tloc.HostView();
+    common::ParallelFor(value.Size(), n_threads, common::Sched::Static(256), [&](auto i) {
+      auto const& line = value.GetLine(i);
+      for (bst_idx_t j = 0; j < line.Size(); ++j) {
+        data::COOTuple const& elem = line.GetElement(j);
+        if (is_valid(elem)) {
+          view(common::ThreadIdx(), elem.column_idx)++;
         }
       }
-      return result;
     });
-  };
+    auto ptr = column_sizes_tloc.Data()->HostPointer();
+    auto result = std::accumulate(ptr, ptr + column_sizes_tloc.Size(), static_cast<bst_idx_t>(0));
+    for (bst_idx_t tidx = 0; tidx < n_threads; ++tidx) {
+      for (bst_idx_t fidx = 0; fidx < n_features; ++fidx) {
+        column_sizes[fidx] += view(tidx, fidx);
+      }
+    }
+    return result;
+  });
+}
+
+void GetDataShape(Context const* ctx, DMatrixProxy* proxy,
+                  DataIterProxy<DataIterResetCallback, XGDMatrixCallbackNext> iter, float missing,
+                  ExternalDataInfo* p_info) {
+  auto& info = *p_info;
 
   /**
    * CPU impl needs an additional loop for accumulating the column size.
@@ -130,7 +132,7 @@ void GetDataShape(Context const* ctx, DMatrixProxy* proxy,
       CHECK_EQ(info.n_features, BatchColumns(proxy)) << "Inconsistent number of columns.";
     }
     bst_idx_t batch_size = BatchSamples(proxy);
-    info.batch_nnz.push_back(nnz_cnt());
+    info.batch_nnz.push_back(CountColumnSizes(ctx, proxy, missing, &info.column_sizes));
     info.base_rowids.push_back(batch_size);
     info.nnz += info.batch_nnz.back();
     info.accumulated_rows += batch_size;
@@ -145,7 +147,8 @@ void MakeSketches(Context const* ctx,
                   DataIterProxy<DataIterResetCallback, XGDMatrixCallbackNext>* iter,
                   DMatrixProxy* proxy, std::shared_ptr<DMatrix> ref, float missing,
                   common::HistogramCuts* cuts, BatchParam const& p, MetaInfo const& info,
-                  ExternalDataInfo const& ext_info, std::vector<FeatureType>* p_h_ft) {
+                  ExternalDataInfo const& ext_info, double sample_eps,
+                  std::vector<FeatureType>* p_h_ft) {
   std::unique_ptr<common::HostSketchContainer> p_sketch;
   auto& h_ft = *p_h_ft;
   bst_idx_t accumulated_rows = 0;
@@ -160,6 +163,9 @@ void MakeSketches(Context const* ctx,
         cpu_impl::SyncFeatureType(ctx, &h_ft);
         p_sketch = std::make_unique<common::HostSketchContainer>(
             ctx, p.max_bin, h_ft, ext_info.column_sizes, !proxy->Info().group_ptr_.empty());
+        if (sample_eps > 0) {
+          p_sketch->SampleRows(info.num_row_, sample_eps);
+        }
       }
       HostAdapterDispatch(proxy, [&](auto const& batch) {
         proxy->Info().num_nonzero_ = ext_info.batch_nnz[i];
@@ -87,6 +87,18 @@ void GetCutsFromEllpack(EllpackPage const &page, common::HistogramCuts *cuts);
 namespace cpu_impl {
 void SyncFeatureType(Context const *ctx, std::vector<FeatureType> *p_h_ft);
 
+/**
+ * @brief Count the number of valid values in each column of the current batch in the
+ *        proxy.
+ *
+ * @param p_column_sizes The counts are accumulated into it, must have the same length as the
+ *                       number of columns.
+ *
+ * @return The number of valid values in the batch.
+ */
+bst_idx_t CountColumnSizes(Context const *ctx, DMatrixProxy const *proxy, float missing,
+                           std::vector<bst_idx_t> *p_column_sizes);
+
 /**
  * @brief Fetch the external data shape.
  */
@@ -97,12 +109,16 @@ void GetDataShape(Context const *ctx, DMatrixProxy *proxy,
 /**
  * @brief Create quantile sketch for CPU from an external iterator or from a reference
  *        DMatrix.
+ *
+ * @param sample_eps Sketch a row sample with this rank error relative to the bin width,
+ *                   see `SketchContainerImpl::SampleRows`. 0 to sketch all the rows.
  */
 void MakeSketches(Context const *ctx,
                   DataIterProxy<DataIterResetCallback, XGDMatrixCallbackNext> *iter,
                   DMatrixProxy *proxy, std::shared_ptr<DMatrix> ref, float missing,
                   common::HistogramCuts *cuts, BatchParam const &p, MetaInfo const &info,
-                  ExternalDataInfo const &ext_info, std::vector<FeatureType> *p_h_ft);
+                  ExternalDataInfo const &ext_info, double sample_eps,
+                  std::vector<FeatureType> *p_h_ft);
 }  // namespace cpu_impl
 
 namespace cuda_impl {
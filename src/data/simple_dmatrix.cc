@@ -7,14 +7,20 @@
 #include "simple_dmatrix.h"
 
 #include <algorithm>
+#include <cstddef>     // for byte
+#include <cstring>     // for memcpy
+#include <filesystem>  // for file_size
 #include <limits>
 #include <numeric>  // for accumulate
 #include <type_traits>
+#include <utility>  // for move
 #include <vector>
 
 #include "../collective/communicator-inl.h"  // for GetWorldSize, GetRank, Allgather
 #include "../collective/allgather.h"
 #include "../common/error_msg.h"             // for InconsistentMaxBin
+#include "../common/io.h"                    // for MmapResource
+#include "../common/threading_utils.h"       // for ParallelFor
 #include "./simple_batch_iterator.h"
 #include "adapter.h"
 #include "batch_utils.h"   // for CheckEmpty, RegenGHist
@@ -52,6 +58,37 @@ DMatrix* SimpleDMatrix::Slice(common::Span<int32_t const> ridxs) {
   return out;
 }
 
+void SimpleDMatrix::Append(DMatrix* that) {
+  CHECK(that);
+  CHECK(!info_.IsColumnSplit() && !that->Info().IsColumnSplit())
+      << "Appending column-split data is not supported.";
+  CHECK_EQ(info_.num_col_, that->Info().num_col_)
+      << "The number of columns must be the same for appending data.";
+
+  auto ctx = fmat_ctx_.MakeCPU();
+  // The gradient index is generated for each iteration for the approx tree method and the
+  // sketch depends on the hessian, only the one for hist is kept.
+  if (gradient_index_ && !batch_param_.regen && batch_param_.hess.empty()) {
+    gradient_index_->Extend(&ctx, that, batch_param_.sparse_thresh);
+  } else {
+    gradient_index_.reset();
+    batch_param_ = BatchParam{};
+  }
+  ghist_cache_.clear();
+
+  for (auto const& page : that->GetBatches<SparsePage>()) {
+    this->sparse_page_->Push(page);
+  }
+  auto n_nonzero = info_.num_nonzero_ + that->Info().num_nonzero_;
+  info_.Extend(that->Info(), true, true);
+  info_.num_nonzero_ = n_nonzero;
+  CHECK_EQ(this->sparse_page_->Size(), info_.num_row_);
+
+  column_page_.reset();
+  sorted_column_page_.reset();
+  ellpack_page_.reset();
+}
+
 DMatrix* SimpleDMatrix::SliceCol(int num_slices, int slice_id) {
   auto out = new SimpleDMatrix;
   SparsePage& out_page = *out->sparse_page_;
@@ -166,8 +203,42 @@ BatchSet<EllpackPage> SimpleDMatrix::GetEllpackBatches(Context const* ctx,
   return BatchSet<EllpackPage>(begin_iter);
 }
 
+namespace {
+// The sketch weighted by the hessian changes in each iteration.
+bool CacheableGHist(BatchParam const& param) {
+  return param.Initialized() && !param.regen && param.hess.empty();
+}
+}  // anonymous namespace
+
+bool SimpleDMatrix::SwapCachedGHist(BatchParam const& param) {
+  if (gradient_index_ && CacheableGHist(ghist_param_)) {
+    ghist_cache_.push_back(
+        CachedGHist{ghist_param_.MakeCache(), std::move(ghist_ft_), std::move(gradient_index_)});
+    if (ghist_cache_.size() > kMaxCachedGHist) {
+      ghist_cache_.erase(ghist_cache_.begin());
+    }
+  }
+  gradient_index_.reset();
+  if (!CacheableGHist(param)) {
+    return false;
+  }
+  auto const& h_ft = info_.feature_types.ConstHostVector();
+  auto it = std::find_if(ghist_cache_.begin(), ghist_cache_.end(), [&](CachedGHist const& v) {
+    return !v.param.ParamNotEqual(param) && v.feature_types == h_ft;
+  });
+  if (it == ghist_cache_.end()) {
+    return false;
+  }
+  gradient_index_ = std::move(it->page);
+  ghist_param_ = it->param;
+  ghist_ft_ = std::move(it->feature_types);
+  ghist_cache_.erase(it);
+  return true;
+}
+
 BatchSet<GHistIndexMatrix> SimpleDMatrix::GetGradientIndex(Context const* ctx,
                                                            const BatchParam& param) {
+  std::lock_guard guard{ghist_lock_};
   detail::CheckEmpty(batch_param_, param);
   // Check whether we can regenerate the gradient index. This is to keep the consistency
   // between evaluation data and training data.
@@ -177,7 +248,11 @@ BatchSet<GHistIndexMatrix> SimpleDMatrix::GetGradientIndex(Context const* ctx,
     }
     CHECK(!detail::RegenGHist(batch_param_, param)) << "Inconsistent sparse threshold.";
   }
-  if (!gradient_index_ || detail::RegenGHist(batch_param_, param)) {
+  if ((!gradient_index_ || detail::RegenGHist(batch_param_, param)) &&
+      this->SwapCachedGHist(param)) {
+    LOG(DEBUG) << "Using cached Gradient Index.";
+    batch_param_ = param.MakeCache();
+  } else if (!gradient_index_) {
     // GIDX page doesn't exist, generate it
     LOG(DEBUG) << "Generating new Gradient Index.";
     // These places can ask for a CSR gidx:
@@ -206,6 +281,9 @@ BatchSet<GHistIndexMatrix> SimpleDMatrix::GetGradientIndex(Context const* ctx,
 
     batch_param_ = param.MakeCache();
     CHECK_EQ(batch_param_.hess.data(), param.hess.data());
+    // Keep the `regen` flag, the sorted sketch is not cached.
+    ghist_param_ = param;
+    ghist_ft_ = info_.feature_types.ConstHostVector();
   }
   auto begin_iter = BatchIterator<GHistIndexMatrix>(
       new SimpleBatchIteratorImpl<GHistIndexMatrix>(gradient_index_));
@@ -335,6 +413,52 @@ SimpleDMatrix::SimpleDMatrix(dmlc::Stream* in_stream) {
   in_stream->Read(&sparse_page_->data.HostVector());
 }
 
+namespace {
+/**
+ * @brief Copy a vector written by `dmlc::Stream` from a memory buffer.
+ *
+ * @return The number of bytes consumed.
+ */
+template <typename T>
+std::size_t CopyVec(std::int32_t n_threads, common::Span<std::byte const> buf,
+                    std::vector<T>* out) {
+  std::uint64_t n{0};
+  CHECK_GE(buf.size(), sizeof(n)) << "invalid input file format";
+  std::memcpy(&n, buf.data(), sizeof(n));
+  auto n_bytes = n * sizeof(T);
+  CHECK_GE(buf.size() - sizeof(n), n_bytes) << "invalid input file format";
+  out->resize(n);
+  auto src = buf.data() + sizeof(n);
+  auto dst = reinterpret_cast<std::byte*>(out->data());
+  // Large blocks to amortize the page faults.
+  std::size_t constexpr kBlockBytes = 1ul << 22;
+  common::ParallelFor(common::DivRoundUp(n_bytes, kBlockBytes), n_threads, [&](auto i) {
+    auto beg = i * kBlockBytes;
+    std::memcpy(dst + beg, src + beg, std::min(kBlockBytes, n_bytes - beg));
+  });
+  return sizeof(n) + n_bytes;
+}
+}  // anonymous namespace
+
+SimpleDMatrix::SimpleDMatrix(std::string const& path, std::int32_t n_threads) {
+  std::size_t offset{0};
+  {
+    std::unique_ptr<dmlc::SeekStream> fi{dmlc::SeekStream::CreateForRead(path.c_str())};
+    int tmagic;
+    CHECK(fi->Read(&tmagic)) << "invalid input file format";
+    CHECK_EQ(tmagic, kMagic) << "invalid format, magic number mismatch";
+    info_.LoadBinary(fi.get());
+    offset = fi->Tell();
+  }
+  auto file_size = std::filesystem::file_size(path);
+  CHECK_GE(file_size, offset) << "invalid input file format";
+  common::MmapResource mmap{StringView{path}, offset, file_size - offset};
+  common::Span<std::byte const> buf{reinterpret_cast<std::byte const*>(mmap.Data()),
+                                    mmap.Size()};
+  auto n_bytes = CopyVec(n_threads, buf, &sparse_page_->offset.HostVector());
+  CopyVec(n_threads, buf.subspan(n_bytes), &sparse_page_->data.HostVector());
+}
+
 void SimpleDMatrix::SaveToLocalFile(const std::string& fname) {
   std::unique_ptr<dmlc::Stream> fo(dmlc::Stream::Create(fname.c_str(), "w"));
   int tmagic = kMagic;
@@ -10,8 +10,11 @@
 #include <xgboost/base.h>
 #include <xgboost/data.h>
 
+#include <cstddef>  // for size_t
 #include <memory>
+#include <mutex>    // for mutex
 #include <string>
+#include <vector>   // for vector
 
 #include "gradient_index.h"
 
@@ -25,6 +28,11 @@ class SimpleDMatrix : public DMatrix {
                          DataSplitMode data_split_mode = DataSplitMode::kRow);
 
   explicit SimpleDMatrix(dmlc::Stream* in_stream);
+  /**
+   * @brief Load the binary format from a local file. The sparse page is copied from a
+   *        memory map of the file using multiple threads.
+   */
+  SimpleDMatrix(std::string const& path, std::int32_t n_threads);
   ~SimpleDMatrix() override = default;
 
   void SaveToLocalFile(const std::string& fname);
@@ -35,6 +43,13 @@ class SimpleDMatrix : public DMatrix {
 
   DMatrix* Slice(common::Span<int32_t const> ridxs) override;
   DMatrix* SliceCol(int num_slices, int slice_id) override;
+  /**
+   * @brief Append the rows of another DMatrix.
+   *
+   *   The cached gradient index for the hist tree method is extended with the existing
+   *   cuts, only the new rows are quantised. Other cached pages are dropped.
+   */
+  void Append(DMatrix* that);
 
   /*! \brief magic number used to identify SimpleDMatrix binary files */
   static const int kMagic = 0xffffab01;
@@ -55,6 +70,32 @@ class SimpleDMatrix : public DMatrix {
   std::shared_ptr<EllpackPage> ellpack_page_{nullptr};
   std::shared_ptr<GHistIndexMatrix> gradient_index_{nullptr};
   BatchParam batch_param_;
+  // Parameter and feature types used to build the current gradient index.
+  BatchParam ghist_param_;
+  std::vector<FeatureType> ghist_ft_;
+  /**
+   * @brief Gradient indices built with other parameters, kept for switching between them
+   *        like a hyper-parameter search over `max_bin`. Learners hold their own reference
+   *        to the pages, replacing the current one doesn't affect running training.
+   *
+   *   Only unweighted sketches are kept, the most recently used one is at the back.
+   */
+  struct CachedGHist {
+    BatchParam param;
+    std::vector<FeatureType> feature_types;
+    std::shared_ptr<GHistIndexMatrix> page;
+  };
+  static constexpr std::size_t kMaxCachedGHist = 3;
+  std::vector<CachedGHist> ghist_cache_;
+  // Serialize the creation of the gradient index between concurrent learners.
+  std::mutex ghist_lock_;
+  /**
+   * @brief Move the current gradient index into the cache, then take the one matching the
+   *        parameter out of the cache.
+   *
+   * @return Whether a matching gradient index is found.
+   */
+  bool SwapCachedGHist(BatchParam const& param);
 
   bool EllpackExists() const override { return static_cast<bool>(ellpack_page_); }
   bool GHistIndexExists() const override { return static_cast<bool>(gradient_index_); }
@@ -7,17 +7,53 @@
  */
 #include "sparse_page_dmatrix.h"
 
-#include <algorithm>  // for max
+#include <algorithm>  // for max, copy
+#include <cstddef>    // for size_t
 #include <memory>     // for make_shared
 #include <string>     // for string
 #include <utility>    // for move
 #include <variant>    // for visit
+#include <vector>     // for vector
 
-#include "batch_utils.h"         // for RegenGHist
-#include "gradient_index.h"      // for GHistIndexMatrix
-#include "sparse_page_source.h"  // for MakeCachePrefix
+#include "../collective/communicator-inl.h"  // for IsDistributed
+#include "../common/hist_util.h"             // for HistogramCuts
+#include "batch_utils.h"                     // for RegenGHist
+#include "gradient_index.h"                  // for GHistIndexMatrix
+#include "sparse_page_source.h"              // for MakeCachePrefix, LoadPersistentCache
+#include "xgboost/json.h"                    // for Json, I64Array, F32Array
 
 namespace xgboost::data {
+namespace {
+Json CutsToJson(common::HistogramCuts const &cuts) {
+  Json out{Object{}};
+  auto const &h_ptrs = cuts.Ptrs();
+  I64Array ptrs{h_ptrs.size()};
+  for (std::size_t i = 0; i < h_ptrs.size(); ++i) {
+    ptrs.Set(i, h_ptrs[i]);
+  }
+  out["cut_ptrs"] = std::move(ptrs);
+  auto save = [](std::vector<float> const &h_values) {
+    F32Array values{h_values.size()};
+    std::copy(h_values.cbegin(), h_values.cend(), values.GetArray().begin());
+    return values;
+  };
+  out["cut_values"] = save(cuts.Values());
+  out["min_vals"] = save(cuts.MinValues());
+  out["has_categorical"] = Boolean{cuts.HasCategorical()};
+  out["max_cat"] = Number{cuts.MaxCategory()};
+  return out;
+}
+
+void CutsFromJson(Json const &in, common::HistogramCuts *out) {
+  auto const &ptrs = get<I64Array const>(in["cut_ptrs"]);
+  out->cut_ptrs_.HostVector().assign(ptrs.cbegin(), ptrs.cend());
+  out->cut_values_.HostVector() = get<F32Array const>(in["cut_values"]);
+  out->min_vals_.HostVector() = get<F32Array const>(in["min_vals"]);
+  out->SetCategorical(get<Boolean const>(in["has_categorical"]),
+                      get<Number const>(in["max_cat"]));
+}
+}  // anonymous namespace
+
 MetaInfo &SparsePageDMatrix::Info() { return info_; }
 
 const MetaInfo &SparsePageDMatrix::Info() const { return info_; }
@@ -32,22 +68,27 @@ SparsePageDMatrix::SparsePageDMatrix(DataIterHandle iter_handle, DMatrixHandle p
       missing_{config.missing},
       cache_prefix_{config.cache},
       on_host_{config.on_host},
-      min_cache_page_bytes_{config.min_cache_page_bytes} {
+      min_cache_page_bytes_{config.min_cache_page_bytes},
+      target_page_bytes_{config.target_page_bytes},
+      column_pages_{config.column_pages},
+      persistent_{config.persistent} {
+  CHECK_GE(target_page_bytes_, 0);
   Context ctx;
   ctx.Init(Args{{"nthread", std::to_string(config.n_threads)}});
   cache_prefix_ = MakeCachePrefix(cache_prefix_);
 
-  DMatrixProxy *proxy = MakeProxy(proxy_);
   auto iter = DataIterProxy<DataIterResetCallback, XGDMatrixCallbackNext>{
       iter_, reset_, next_};
 
   // The proxy is iterated together with the sparse page source so we can obtain all
-  // information in 1 pass.
+  // information in 1 pass. The meta info is collected for each batch by the source, as a
+  // page can have multiple batches.
+  ContentHash hash;
   for (auto const &page : this->GetRowBatchesImpl(&ctx)) {
-    this->info_.Extend(std::move(proxy->Info()), false, false);
-    ext_info_.n_features =
-        std::max(static_cast<bst_feature_t>(ext_info_.n_features), BatchColumns(proxy));
-    ext_info_.accumulated_rows += BatchSamples(proxy);
+    if (this->persistent_) {
+      hash.Update(page.offset.ConstHostSpan());
+      hash.Update(page.data.ConstHostSpan());
+    }
     ext_info_.nnz += page.data.Size();
     ext_info_.n_batches++;
     ext_info_.base_rowids.push_back(page.Size());
@@ -55,6 +96,8 @@ SparsePageDMatrix::SparsePageDMatrix(DataIterHandle iter_handle, DMatrixHandle p
   }
   std::partial_sum(ext_info_.base_rowids.cbegin(), ext_info_.base_rowids.cend(),
                    ext_info_.base_rowids.begin());
+  hash.UpdateValue(ext_info_.n_features);
+  content_key_ = hash.Get();
 
   iter.Reset();
 
@@ -71,9 +114,21 @@ SparsePageDMatrix::~SparsePageDMatrix() {
   sorted_column_source_.reset();
   ghist_index_source_.reset();
 
+  this->SaveGHistCache(MakeId(cache_prefix_, this) + ".gradient_index.page");
   DeleteCacheFiles(cache_info_);
 }
 
+void SparsePageDMatrix::SaveGHistCache(std::string const &id) {
+  auto it = cache_info_.find(id);
+  if (IsA<Null>(ghist_extra_) || it == cache_info_.cend() || !it->second->written ||
+      it->second->persistent) {
+    return;
+  }
+  auto name = PersistentCacheName(cache_prefix_, ghist_key_);
+  SavePersistentCache(name, ghist_key_, std::move(ghist_extra_), it->second.get());
+  ghist_extra_ = Json{Null{}};
+}
+
 void SparsePageDMatrix::InitializeSparsePage(Context const *ctx) {
   auto id = MakeCache(this, ".row.page", false, cache_prefix_, &cache_info_);
   // Don't use proxy DMatrix once this is already initialized, this allows users to
@@ -89,9 +144,15 @@ void SparsePageDMatrix::InitializeSparsePage(Context const *ctx) {
   sparse_page_source_.reset();  // clear before creating new one to prevent conflicts.
   // During initialization, the n_batches is 0.
   CHECK_EQ(this->ext_info_.n_batches, static_cast<decltype(this->ext_info_.n_batches)>(0));
+  auto on_batch = [this](DMatrixProxy *proxy) {
+    this->info_.Extend(std::move(proxy->Info()), false, false);
+    ext_info_.n_features =
+        std::max(static_cast<bst_feature_t>(ext_info_.n_features), BatchColumns(proxy));
+    ext_info_.accumulated_rows += BatchSamples(proxy);
+  };
   sparse_page_source_ = std::make_shared<SparsePageSource>(
       iter, proxy, this->missing_, ctx->Threads(), this->info_.num_col_, this->ext_info_.n_batches,
-      cache_info_.at(id));
+      cache_info_.at(id), target_page_bytes_, on_batch);
 }
 
 BatchSet<SparsePage> SparsePageDMatrix::GetRowBatchesImpl(Context const *ctx) {
@@ -140,22 +201,55 @@ BatchSet<GHistIndexMatrix> SparsePageDMatrix::GetGradientIndex(Context const *ct
   detail::CheckEmpty(batch_param_, param);
   auto id = MakeCache(this, ".gradient_index.page", on_host_, cache_prefix_, &cache_info_);
   if (!cache_info_.at(id)->written || detail::RegenGHist(batch_param_, param)) {
+    // Keep the previous index if it can be reused by a later DMatrix.
+    ghist_index_source_.reset();
+    this->SaveGHistCache(id);
     this->InitializeSparsePage(ctx);
     cache_info_.erase(id);
     id = MakeCache(this, ".gradient_index.page", on_host_, cache_prefix_, &cache_info_);
-    LOG(INFO) << "Generating new Gradient Index.";
-    // Use sorted sketch for approx.
-    auto sorted_sketch = param.regen;
-    auto cuts = common::SketchOnDMatrix(ctx, this, param.max_bin, sorted_sketch, param.hess);
-    this->InitializeSparsePage(ctx);  // reset after use.
+
+    // The hessian-weighted sketch for approx is regenerated in every iteration and the
+    // cuts of a distributed sketch depend on other workers, neither is persisted.
+    auto persistent = this->persistent_ && !this->on_host_ && param.hess.empty() &&
+                      !collective::IsDistributed();
+    common::HistogramCuts cuts;
+    std::shared_ptr<Cache> loaded;
+    if (persistent) {
+      ContentHash hash{content_key_};
+      hash.Update(this->info_.weights_.ConstHostSpan());
+      hash.Update(this->info_.feature_types.ConstHostSpan());
+      hash.UpdateValue(param.max_bin);
+      hash.UpdateValue(param.sparse_thresh);
+      hash.UpdateValue(this->column_pages_);
+      ghist_key_ = hash.Get();
+      Json extra{Null{}};
+      loaded = LoadPersistentCache(PersistentCacheName(cache_prefix_, ghist_key_),
+                                   ".gradient_index.page", ghist_key_, &extra);
+      if (loaded && loaded->Size() == static_cast<bst_idx_t>(this->NumBatches())) {
+        CutsFromJson(extra, &cuts);
+        cache_info_[id] = loaded;
+      } else {
+        loaded.reset();
+      }
+    }
+    if (loaded) {
+      LOG(INFO) << "Reusing the Gradient Index cache: " << loaded->ShardName();
+    } else {
+      LOG(INFO) << "Generating new Gradient Index.";
+      // Use sorted sketch for approx.
+      auto sorted_sketch = param.regen;
+      cuts = common::SketchOnDMatrix(ctx, this, param.max_bin, sorted_sketch, param.hess);
+      this->InitializeSparsePage(ctx);  // reset after use.
+      ghist_extra_ = persistent ? CutsToJson(cuts) : Json{Null{}};
+    }
 
     batch_param_ = param;
-    ghist_index_source_.reset();
     CHECK_NE(cuts.Values().size(), 0);
     auto ft = this->info_.feature_types.ConstHostSpan();
     ghist_index_source_.reset(new GradientIndexPageSource(
         this->missing_, ctx->Threads(), this->Info().num_col_, this->NumBatches(),
-        cache_info_.at(id), param, std::move(cuts), this->IsDense(), ft, sparse_page_source_));
+        cache_info_.at(id), param, std::move(cuts), this->IsDense(), ft, sparse_page_source_,
+        column_pages_));
   } else {
     CHECK(ghist_index_source_);
     ghist_index_source_->Reset(param);
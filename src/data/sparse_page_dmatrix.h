@@ -7,7 +7,7 @@
 #ifndef XGBOOST_DATA_SPARSE_PAGE_DMATRIX_H_
 #define XGBOOST_DATA_SPARSE_PAGE_DMATRIX_H_
 
-#include <cstdint>  // for uint32_t, int32_t
+#include <cstdint>  // for uint32_t, int32_t, uint64_t
 #include <map>      // for map
 #include <memory>   // for shared_ptr
 #include <string>   // for string
@@ -18,6 +18,7 @@
 #include "sparse_page_source.h"          // for SparsePageSource, Cache
 #include "xgboost/context.h"             // for Context
 #include "xgboost/data.h"                // for DMatrix, MetaInfo
+#include "xgboost/json.h"                // for Json
 #include "xgboost/logging.h"
 #include "xgboost/span.h"  // for Span
 
@@ -75,10 +76,20 @@ class SparsePageDMatrix : public DMatrix {
   std::string cache_prefix_;
   bool const on_host_;
   std::int64_t const min_cache_page_bytes_;
+  std::int64_t const target_page_bytes_;
+  bool const column_pages_;
   ExternalDataInfo ext_info_;
+  // Persistent gradient index cache, the content key is the hash of the row pages.
+  bool const persistent_;
+  std::uint64_t content_key_{0};
+  // Key and cuts of the gradient index cache pending for publication.
+  std::uint64_t ghist_key_{0};
+  Json ghist_extra_{Null{}};
 
   // sparse page is the source to other page types, we make a special member function.
   void InitializeSparsePage(Context const *ctx);
+  // Publish the gradient index cache if it's complete.
+  void SaveGHistCache(std::string const &id);
   // Non-virtual version that can be used in constructor
   BatchSet<SparsePage> GetRowBatchesImpl(Context const *ctx);
 
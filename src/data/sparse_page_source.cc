@@ -3,12 +3,19 @@
  */
 #include "sparse_page_source.h"
 
+#include <algorithm>   // for max, transform
 #include <cstdio>      // for remove
-#include <filesystem>  // for exists
+#include <cstring>     // for memcpy
+#include <filesystem>  // for exists, rename, file_size
+#include <fstream>     // for ifstream, ofstream
+#include <iterator>    // for istreambuf_iterator
 #include <numeric>     // for partial_sum
+#include <sstream>     // for stringstream
 #include <string>      // for string
+#include <utility>     // for move
 
 #include "../collective/communicator-inl.h"  // for IsDistributed, GetRank
+#include "../common/version.h"               // for Version
 
 namespace xgboost::data {
 void Cache::Commit() {
@@ -37,4 +44,158 @@ std::string MakeCachePrefix(std::string cache_prefix) {
   }
   return cache_prefix;
 }
+
+void SplitPage(std::shared_ptr<SparsePage> page, bst_idx_t target_bytes,
+               std::deque<std::shared_ptr<SparsePage>>* out) {
+  CHECK_NE(target_bytes, 0);
+  auto n_chunks = std::max(page->MemCostBytes() / target_bytes, static_cast<bst_idx_t>(1));
+  if (n_chunks == 1 || page->Size() < 2) {
+    out->push_back(std::move(page));
+    return;
+  }
+  // Split by the number of bytes of each row.
+  auto const& h_offset = page->offset.ConstHostVector();
+  auto const& h_data = page->data.ConstHostVector();
+  auto n_samples = page->Size();
+  auto row_bytes = [&](bst_idx_t i) {
+    return h_offset[i] * sizeof(Entry) + i * sizeof(bst_idx_t);
+  };
+  auto total = row_bytes(n_samples);
+  bst_idx_t begin = 0;
+  for (bst_idx_t k = 1; k <= n_chunks && begin < n_samples; ++k) {
+    bst_idx_t end = n_samples;
+    if (k != n_chunks) {
+      // First row that reaches the k^th boundary.
+      auto bound = total / n_chunks * k;
+      end = begin + 1;
+      while (end < n_samples && row_bytes(end) < bound) {
+        ++end;
+      }
+    }
+    auto chunk = std::make_shared<SparsePage>();
+    auto& c_offset = chunk->offset.HostVector();
+    c_offset.resize(end - begin + 1);
+    std::transform(h_offset.cbegin() + begin, h_offset.cbegin() + end + 1, c_offset.begin(),
+                   [&](auto v) { return v - h_offset[begin]; });
+    chunk->data.HostVector().assign(h_data.cbegin() + h_offset[begin],
+                                    h_data.cbegin() + h_offset[end]);
+    out->push_back(std::move(chunk));
+    begin = end;
+  }
+}
+
+void ContentHash::Update(void const* ptr, std::size_t n_bytes) {
+  std::uint64_t constexpr kPrime = 0x100000001b3ull;
+  auto const* bytes = static_cast<char const*>(ptr);
+  auto h = this->hash_;
+  // Hash by 64-bit words, followed by the remaining bytes.
+  std::size_t i = 0;
+  for (; i + sizeof(std::uint64_t) <= n_bytes; i += sizeof(std::uint64_t)) {
+    std::uint64_t word;
+    std::memcpy(&word, bytes + i, sizeof(word));
+    h = (h ^ word) * kPrime;
+  }
+  for (; i < n_bytes; ++i) {
+    h = (h ^ static_cast<std::uint8_t>(bytes[i])) * kPrime;
+  }
+  this->hash_ = h;
+}
+
+namespace {
+[[nodiscard]] std::string KeyStr(std::uint64_t key) {
+  std::stringstream ss;
+  ss << std::hex << key;
+  return ss.str();
+}
+
+[[nodiscard]] std::string MetaName(std::string const& shard) { return shard + ".meta"; }
+}  // anonymous namespace
+
+std::string PersistentCacheName(std::string const& prefix, std::uint64_t key) {
+  return prefix + "-" + KeyStr(key);
+}
+
+std::shared_ptr<Cache> LoadPersistentCache(std::string const& name, std::string const& format,
+                                           std::uint64_t key, Json* extra) {
+  auto shard = Cache::ShardName(name, format);
+  std::ifstream fin{MetaName(shard), std::ios::binary};
+  if (!fin.is_open()) {
+    return nullptr;
+  }
+  std::string buffer{std::istreambuf_iterator<char>{fin}, std::istreambuf_iterator<char>{}};
+  if (buffer.empty()) {
+    return nullptr;
+  }
+  auto meta = Json::Load(StringView{buffer}, std::ios::binary);
+  if (!Version::Same(Version::Load(meta)) || get<String const>(meta["key"]) != KeyStr(key) ||
+      get<String const>(meta["format"]) != format) {
+    LOG(WARNING) << "Ignoring mismatched external memory cache: " << shard;
+    return nullptr;
+  }
+  auto const& offset = get<I64Array const>(meta["offset"]);
+  std::error_code ec;
+  auto n_bytes = std::filesystem::file_size(shard, ec);
+  if (ec || offset.empty() || static_cast<std::uint64_t>(offset.back()) != n_bytes) {
+    LOG(WARNING) << "Ignoring incomplete external memory cache: " << shard;
+    return nullptr;
+  }
+
+  auto cache = std::make_shared<Cache>(true, name, format, false);
+  cache->persistent = true;
+  cache->offset.assign(offset.cbegin(), offset.cend());
+  *extra = meta["extra"];
+  return cache;
+}
+
+void SavePersistentCache(std::string const& name, std::uint64_t key, Json extra, Cache* cache) {
+  CHECK(cache->written);
+  CHECK(!cache->OnHost());
+  Json meta{Object{}};
+  Version::Save(&meta);
+  meta["key"] = String{KeyStr(key)};
+  meta["format"] = String{cache->format};
+  I64Array offset{cache->offset.size()};
+  for (std::size_t i = 0; i < cache->offset.size(); ++i) {
+    offset.Set(i, static_cast<std::int64_t>(cache->offset[i]));
+  }
+  meta["offset"] = std::move(offset);
+  meta["extra"] = std::move(extra);
+
+  auto src = cache->ShardName();
+  auto dst = Cache::ShardName(name, cache->format);
+  auto tmp_meta = MetaName(src);
+  std::string buffer;
+  Json::Dump(meta, &buffer, std::ios::binary);
+  {
+    std::ofstream fout{tmp_meta, std::ios::binary};
+    fout.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!fout.good()) {
+      LOG(WARNING) << "Failed to write the external memory cache metadata: " << tmp_meta;
+      TryDeleteCacheFile(tmp_meta);
+      return;
+    }
+  }
+  // Publish the page before the metadata, readers only use a page with valid metadata.
+  std::error_code ec;
+  auto warn = [&] {
+    LOG(WARNING) << "Failed to publish the external memory cache " << dst << ": "
+                 << ec.message();
+    std::error_code ignored;
+    std::filesystem::remove(tmp_meta, ignored);
+  };
+  std::filesystem::rename(src, dst, ec);
+  if (ec) {
+    warn();
+    return;
+  }
+  cache->name = name;
+  cache->persistent = true;
+  std::filesystem::rename(tmp_meta, MetaName(dst), ec);
+  if (ec) {
+    warn();
+    TryDeleteCacheFile(dst);
+    return;
+  }
+  LOG(INFO) << "Saved persistent cache:" << dst;
+}
 }  // namespace xgboost::data
@@ -5,17 +5,21 @@
 #ifndef XGBOOST_DATA_SPARSE_PAGE_SOURCE_H_
 #define XGBOOST_DATA_SPARSE_PAGE_SOURCE_H_
 
-#include <algorithm>  // for min
-#include <atomic>     // for atomic
-#include <cstdint>    // for uint64_t
-#include <future>     // for future
-#include <limits>     // for numeric_limits
-#include <map>        // for map
-#include <memory>     // for unique_ptr
-#include <mutex>      // for mutex
-#include <string>     // for string
-#include <utility>    // for pair, move
-#include <vector>     // for vector
+#include <algorithm>    // for min
+#include <atomic>       // for atomic
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint64_t
+#include <deque>        // for deque
+#include <functional>   // for function
+#include <future>       // for future
+#include <limits>       // for numeric_limits
+#include <map>          // for map
+#include <memory>       // for unique_ptr
+#include <mutex>        // for mutex
+#include <string>       // for string
+#include <type_traits>  // for is_base_of_v
+#include <utility>      // for pair, move
+#include <vector>       // for vector
 
 #if !defined(XGBOOST_USE_CUDA)
 #include "../common/common.h"  // for AssertGPUSupport
@@ -24,12 +28,16 @@
 #include "../common/io.h"           // for PrivateMmapConstStream
 #include "../common/threadpool.h"   // for ThreadPool
 #include "../common/timer.h"        // for Monitor, Timer
+#include "../common/trace.h"        // for TraceScope
+#include "page_source_profiler.h"   // for PageSourceProfiler, PageFetchRecord
 #include "proxy_dmatrix.h"          // for DMatrixProxy
 #include "sparse_page_writer.h"     // for SparsePageFormat
 #include "xgboost/base.h"           // for bst_feature_t
 #include "xgboost/data.h"           // for SparsePage, CSCPage, SortedCSCPage
 #include "xgboost/global_config.h"  // for InitNewThread
+#include "xgboost/json.h"           // for Json
 #include "xgboost/logging.h"        // for CHECK_EQ
+#include "xgboost/span.h"           // for Span
 
 namespace xgboost::data {
 void TryDeleteCacheFile(const std::string& file);
@@ -45,6 +53,9 @@ struct Cache {
   // whether the write to the cache is complete
   bool written;
   bool on_host;
+  // whether the cache file is kept after the DMatrix is destroyed, see
+  // `LoadPersistentCache`.
+  bool persistent{false};
   std::string name;
   std::string format;
   // offset into binary cache file.
@@ -92,7 +103,7 @@ inline void DeleteCacheFiles(std::map<std::string, std::shared_ptr<Cache>> const
   for (auto const& kv : cache_info) {
     CHECK(kv.second);
     auto n = kv.second->ShardName();
-    if (kv.second->OnHost()) {
+    if (kv.second->OnHost() || kv.second->persistent) {
       continue;
     }
     TryDeleteCacheFile(n);
@@ -105,6 +116,58 @@ inline void DeleteCacheFiles(std::map<std::string, std::shared_ptr<Cache>> const
   return prefix + "-" + ss.str();
 }
 
+/**
+ * @brief Incremental FNV-1a hash for the content of the external memory pages.
+ */
+class ContentHash {
+  std::uint64_t hash_{0xcbf29ce484222325ull};
+
+ public:
+  ContentHash() = default;
+  explicit ContentHash(std::uint64_t seed) : hash_{seed} {}
+
+  void Update(void const* ptr, std::size_t n_bytes);
+  template <typename T>
+  void Update(common::Span<T const> values) {
+    this->Update(values.data(), values.size_bytes());
+  }
+  template <typename T>
+  void UpdateValue(T const& v) {
+    this->Update(&v, sizeof(v));
+  }
+  [[nodiscard]] std::uint64_t Get() const { return hash_; }
+};
+
+/**
+ * @brief Name of the persistent cache for the content key.
+ */
+[[nodiscard]] std::string PersistentCacheName(std::string const& prefix, std::uint64_t key);
+/**
+ * @brief Load a persistent cache written by a previous DMatrix, possibly in a different
+ *        process.
+ *
+ *   A persistent cache is a pair of files, the page file and a metadata file with the
+ *   `.meta` suffix. The metadata records the content key, the page offsets, and the
+ *   caller provided information `extra`. Both files are published by an atomic rename,
+ *   existing readers keep the mapped pages when the cache is replaced.
+ *
+ * @param name   Name of the cache, see @ref PersistentCacheName.
+ * @param format The page format, like `.gradient_index.page`.
+ * @param key    Key of the content, used to verify the cache.
+ * @param extra  Output of the caller provided information.
+ *
+ * @return nullptr if there's no valid cache for the key.
+ */
+[[nodiscard]] std::shared_ptr<Cache> LoadPersistentCache(std::string const& name,
+                                                         std::string const& format,
+                                                         std::uint64_t key, Json* extra);
+/**
+ * @brief Publish a written cache as a persistent cache. The cache is renamed and no
+ *        longer deleted with the DMatrix. Errors are logged as warnings, as this is called
+ *        in a destructor.
+ */
+void SavePersistentCache(std::string const& name, std::uint64_t key, Json extra, Cache* cache);
+
 /**
  * @brief Make cache if it doesn't exist yet.
  */
@@ -219,6 +282,72 @@ class DefaultFormatPolicy {
   }
 };
 
+/**
+ * @brief Choose the number of batches to pre-fetch for external memory.
+ *
+ * The depth grows when the consumer waits for the data (IO-bound), and shrinks when the
+ * data is always ready (compute-bound) to release memory. In addition, the total size of
+ * the pre-fetched pages is limited by a byte budget. A pending read can not be cancelled,
+ * the depth decreases by at most one at each step.
+ */
+class PrefetchDepth {
+  std::int32_t depth_{0};
+
+ public:
+  // Grow the depth if the wait time is larger than this ratio of the compute time.
+  static constexpr double IOBoundRatio() { return 0.1; }
+  // Shrink the depth if the wait time is smaller than this ratio of the compute time.
+  static constexpr double ComputeBoundRatio() { return 0.01; }
+
+  /**
+   * @param wait       Seconds spent on waiting for the previous page.
+   * @param compute    Seconds spent on processing the previous page.
+   * @param max_depth  Upper bound of the depth.
+   * @param page_bytes Size of the k^th page starting from the current page.
+   * @param budget     Maximum number of bytes for the pre-fetched pages, 0 for no limit.
+   *
+   * @return The new depth, which is at least 1.
+   */
+  template <typename Fn>
+  std::int32_t Update(double wait, double compute, std::int32_t max_depth, Fn&& page_bytes,
+                      std::int64_t budget) {
+    CHECK_GE(max_depth, 1);
+    auto depth = depth_;
+    if (depth == 0) {
+      // Start with the maximum depth, same as a fixed number of pre-fetched batches.
+      depth = max_depth;
+    } else if (wait > compute * IOBoundRatio()) {
+      depth += 1;
+    } else if (wait < compute * ComputeBoundRatio()) {
+      depth -= 1;
+    }
+    depth = std::clamp(depth, 1, max_depth);
+    if (budget > 0) {
+      std::int64_t total{0};
+      std::int32_t n{0};
+      while (n < depth) {
+        auto n_bytes = static_cast<std::int64_t>(page_bytes(n));
+        if (n != 0 && total + n_bytes > budget) {
+          break;
+        }
+        total += n_bytes;
+        ++n;
+      }
+      depth = n;
+    }
+    if (depth_ != 0) {
+      depth = std::max(depth, depth_ - 1);
+    }
+    depth_ = depth;
+    return depth_;
+  }
+  [[nodiscard]] std::int32_t Depth() const { return depth_; }
+  /**
+   * @brief Start over when the pre-fetched pages are discarded.
+   */
+  void Reset() { depth_ = 0; }
+};
+
 /**
  * @brief Base class for all page sources. Handles fetching, writing, and iteration.
  *
@@ -252,10 +381,23 @@ class SparsePageSourceImpl : public BatchIteratorImpl<S>, public FormatStreamPol
 
   std::shared_ptr<Cache> cache_info_;
 
-  using Ring = std::vector<std::future<std::shared_ptr<S>>>;
+  // A page along with the seconds spent by the prefetch worker.
+  struct Fetched {
+    std::shared_ptr<S> page;
+    double read{0};
+    double decode{0};
+  };
+  using Ring = std::vector<std::future<Fetched>>;
   // A ring storing futures to data.  Since the DMatrix iterator is forward only, we can
   // pre-fetch data in a ring.
   std::unique_ptr<Ring> ring_{new Ring};
+  // The number of batches in the ring that are being fetched.
+  PrefetchDepth depth_;
+  // Time spent on waiting for the previous page.
+  double wait_seconds_{0.0};
+  // Measures the time spent on processing the page, from returning the page to the
+  // request for the next one.
+  common::Timer compute_timer_;
   // Catching exception in pre-fetch threads to prevent segfault. Not always work though,
   // OOM error can be delayed due to lazy commit. On the bright side, if mmap is used then
   // OOM error should be rare.
@@ -273,6 +415,11 @@ class SparsePageSourceImpl : public BatchIteratorImpl<S>, public FormatStreamPol
 
     std::int32_t n_prefetches = std::min(nthreads_, this->param_.n_prefetch_batches);
     n_prefetches = std::max(n_prefetches, 1);
+    auto compute_seconds = compute_timer_.Duration().count();
+    n_prefetches = depth_.Update(
+        wait_seconds_, compute_seconds, n_prefetches,
+        [&](std::int32_t k) { return cache_info_->Bytes((this->count_ + k) % n_batches); },
+        this->param_.n_prefetch_bytes);
     std::int32_t n_prefetch_batches = std::min(static_cast<bst_idx_t>(n_prefetches), n_batches);
     CHECK_GT(n_prefetch_batches, 0);
     CHECK_LE(n_prefetch_batches, this->param_.n_prefetch_batches);
@@ -284,31 +431,50 @@ class SparsePageSourceImpl : public BatchIteratorImpl<S>, public FormatStreamPol
     // synchronizations by freeing memory.
     page_.reset();
 
+    std::vector<std::size_t> to_fetch;
     for (std::int32_t i = 0; i < n_prefetch_batches; ++i, ++fetch_it) {
       bool restart = fetch_it == n_batches;
       fetch_it %= n_batches;  // ring
       if (ring_->at(fetch_it).valid()) {
         continue;
       }
-      auto const* self = this;  // make sure it's const
       CHECK_LT(fetch_it, cache_info_->offset.size());
       // Make sure the new iteration starts with a copy to avoid spilling configuration.
       if (restart) {
         this->param_.prefetch_copy = true;
       }
-      ring_->at(fetch_it) = this->workers_.Submit([fetch_it, self, this] {
-        auto page = std::make_shared<S>();
-        this->exce_.Run([&] {
-          std::unique_ptr<typename FormatStreamPolicy::FormatT> fmt{
-              self->CreatePageFormat(self->param_)};
-          auto name = self->cache_info_->ShardName();
-          auto [offset, length] = self->cache_info_->View(fetch_it);
-          std::unique_ptr<typename FormatStreamPolicy::ReaderT> fi{
-              self->CreateReader(name, offset, length)};
-          CHECK(fmt->Read(page.get(), fi.get()));
-        });
-        return page;
+      to_fetch.push_back(fetch_it);
+    }
+    auto const* self = this;  // make sure it's const
+    auto pages = this->workers_.SubmitBulk(to_fetch, [self, this](std::size_t fetch_it) {
+      common::TraceScope trace{common::TraceEvent::kPageRead,
+                               static_cast<std::int64_t>(fetch_it)};
+      Fetched fetched{std::make_shared<S>()};
+      this->exce_.Run([&] {
+        bool profile = PageSourceProfiler::Enabled();
+        common::Timer timer;
+        timer.Start();
+        std::unique_ptr<typename FormatStreamPolicy::FormatT> fmt{
+            self->CreatePageFormat(self->param_)};
+        auto name = self->cache_info_->ShardName();
+        auto [offset, length] = self->cache_info_->View(fetch_it);
+        std::unique_ptr<typename FormatStreamPolicy::ReaderT> fi{
+            self->CreateReader(name, offset, length)};
+        if constexpr (std::is_base_of_v<common::AlignedResourceReadStream,
+                                        typename FormatStreamPolicy::ReaderT>) {
+          if (profile) {
+            // Fault in the mapped pages to separate the IO from decoding.
+            PrefaultStream(fi.get());
+            fetched.read = timer.Duration().count();
+          }
+        }
+        CHECK(fmt->Read(fetched.page.get(), fi.get()));
+        fetched.decode = timer.Duration().count() - fetched.read;
       });
+      return fetched;
+    });
+    for (std::size_t i = 0; i < to_fetch.size(); ++i) {
+      ring_->at(to_fetch[i]) = std::move(pages[i]);
       this->fetch_cnt_++;
     }
 
@@ -318,10 +484,32 @@ class SparsePageSourceImpl : public BatchIteratorImpl<S>, public FormatStreamPol
 
     monitor_.Start("Wait-" + std::to_string(count_));
     CHECK((*ring_)[count_].valid());
-    page_ = (*ring_)[count_].get();
+    auto requested = PageSourceProfiler::Enabled() ? PageSourceProfiler::Get().Now() : 0.0;
+    common::Timer wait;
+    Fetched fetched;
+    {
+      common::TraceScope trace{common::TraceEvent::kPageWait, static_cast<std::int64_t>(count_)};
+      fetched = (*ring_)[count_].get();
+    }
+    page_ = std::move(fetched.page);
+    wait_seconds_ = wait.Duration().count();
     monitor_.Stop("Wait-" + std::to_string(count_));
+    if (PageSourceProfiler::Enabled()) {
+      PageFetchRecord record;
+      record.source = PageSourceName<S>();
+      record.page = count_;
+      record.n_bytes = static_cast<std::int64_t>(cache_info_->Bytes(count_));
+      record.begin = requested;
+      record.read = fetched.read;
+      record.decode = fetched.decode;
+      record.wait = wait_seconds_;
+      record.compute = compute_seconds;
+      record.depth = n_prefetch_batches;
+      PageSourceProfiler::Get().Record(record);
+    }
 
     exce_.Rethrow();
+    compute_timer_.Start();
 
     return true;
   }
@@ -408,6 +596,7 @@ class SparsePageSourceImpl : public BatchIteratorImpl<S>, public FormatStreamPol
     if (!at_end || changed) {
       // The last iteration did not get to the end, clear the ring to start from 0.
       this->ring_ = std::make_unique<Ring>();
+      this->depth_.Reset();
     }
     this->Fetch();  // Get the 0^th page, prefetch the next page.
   }
@@ -422,29 +611,76 @@ void DevicePush(DMatrixProxy* proxy, float missing, SparsePage* page);
 inline void DevicePush(DMatrixProxy*, float, SparsePage*) { common::AssertGPUSupport(); }
 #endif
 
+/**
+ * @brief Split a sparse page into pages with about `target_bytes` each. The page is not
+ *        split if it's smaller than twice the target.
+ */
+void SplitPage(std::shared_ptr<SparsePage> page, bst_idx_t target_bytes,
+               std::deque<std::shared_ptr<SparsePage>>* out);
+
 class SparsePageSource : public SparsePageSourceImpl<SparsePage> {
+ public:
+  // Called for each batch of the user iterator during the initial pass.
+  using BatchCallback = std::function<void(DMatrixProxy*)>;
+
+ private:
   // This is the source iterator from the user.
   DataIterProxy<DataIterResetCallback, XGDMatrixCallbackNext> iter_;
   DMatrixProxy* proxy_;
   std::size_t base_row_id_{0};
   // Total number of batches.
   bst_idx_t n_batches_{0};
+  // Target size of the pages, 0 to use the user batches as pages.
+  bst_idx_t target_page_bytes_{0};
+  BatchCallback on_batch_;
+  // Pages split from a large batch, waiting to be written.
+  std::deque<std::shared_ptr<SparsePage>> pending_;
+  // Whether the user iterator is exhausted while merging batches.
+  bool exhausted_{false};
+
+  void PushBatch(SparsePage* page) {
+    bool type_error{false};
+    CHECK(proxy_);
+    HostAdapterDispatch(
+        proxy_,
+        [&](auto const& adapter_batch) {
+          page->Push(adapter_batch, this->missing_, this->nthreads_);
+        },
+        &type_error);
+    if (type_error) {
+      DevicePush(proxy_, missing_, page);
+    }
+    if (on_batch_) {
+      on_batch_(proxy_);
+    }
+  }
 
   void Fetch() final {
     page_ = std::make_shared<SparsePage>();
     // The first round of reading, this is responsible for initialization.
     if (!this->ReadCache()) {
-      bool type_error{false};
-      CHECK(proxy_);
-      HostAdapterDispatch(
-          proxy_,
-          [&](auto const& adapter_batch) {
-            page_->Push(adapter_batch, this->missing_, this->nthreads_);
-          },
-          &type_error);
-      if (type_error) {
-        DevicePush(proxy_, missing_, page_.get());
+      if (pending_.empty()) {
+        auto page = std::make_shared<SparsePage>();
+        this->PushBatch(page.get());
+        // Merge the small batches.
+        while (target_page_bytes_ != 0 && page->MemCostBytes() < target_page_bytes_) {
+          if (!iter_.Next()) {
+            exhausted_ = true;
+            break;
+          }
+          SparsePage batch;
+          this->PushBatch(&batch);
+          page->Push(batch);
+        }
+        // Split the large batch.
+        if (target_page_bytes_ != 0) {
+          SplitPage(std::move(page), target_page_bytes_, &pending_);
+        } else {
+          pending_.push_back(std::move(page));
+        }
       }
+      page_ = std::move(pending_.front());
+      pending_.pop_front();
 
       page_->SetBaseRowId(base_row_id_);
       base_row_id_ += page_->Size();
@@ -454,13 +690,23 @@ class SparsePageSource : public SparsePageSourceImpl<SparsePage> {
   }
 
  public:
+  /**
+   * @param target_page_bytes Target size of the pages. Small batches from the user
+   *                          iterator are merged, and large batches are split. 0 to use
+   *                          the batches as they are.
+   * @param on_batch          Called for each batch of the user iterator during the
+   *                          initial pass, as there can be multiple batches in a page.
+   */
   SparsePageSource(DataIterProxy<DataIterResetCallback, XGDMatrixCallbackNext> iter,
                    DMatrixProxy* proxy, float missing, int nthreads, bst_feature_t n_features,
-                   bst_idx_t n_batches, std::shared_ptr<Cache> cache)
+                   bst_idx_t n_batches, std::shared_ptr<Cache> cache,
+                   bst_idx_t target_page_bytes = 0, BatchCallback on_batch = {})
       : SparsePageSourceImpl(missing, nthreads, n_features, cache),
         iter_{iter},
         proxy_{proxy},
-        n_batches_{n_batches} {
+        n_batches_{n_batches},
+        target_page_bytes_{target_page_bytes},
+        on_batch_{std::move(on_batch)} {
     if (!cache_info_->written) {
       iter_.Reset();
       CHECK(iter_.Next()) << "Must have at least 1 batch.";
@@ -475,13 +721,14 @@ class SparsePageSource : public SparsePageSourceImpl<SparsePage> {
     if (cache_info_->written) {
       at_end_ = (count_ == n_batches_);
     } else {
-      at_end_ = !iter_.Next();
+      at_end_ = pending_.empty() && (exhausted_ || !iter_.Next());
     }
     CHECK_LE(count_, n_batches_);
 
     if (at_end_) {
       this->EndIter();
       this->proxy_ = nullptr;
+      this->on_batch_ = nullptr;
     } else {
       this->Fetch();
     }
@@ -498,6 +745,8 @@ class SparsePageSource : public SparsePageSourceImpl<SparsePage> {
 
     TryLockGuard guard{single_threaded_};
     this->base_row_id_ = 0;
+    this->pending_.clear();
+    this->exhausted_ = false;
   }
 };
 
@@ -3,13 +3,19 @@
  */
 #ifndef XGBOOST_DATA_VALIDATION_H_
 #define XGBOOST_DATA_VALIDATION_H_
+#include <algorithm>  // for min
 #include <cmath>
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int32_t, uint8_t
 #include <vector>
 
+#include "../common/common.h"            // for DivRoundUp
+#include "../common/threading_utils.h"   // for ParallelFor
 #include "xgboost/base.h"
 #include "xgboost/data.h"                // for FeatureType
 #include "xgboost/host_device_vector.h"  // for HostDeviceVector
 #include "xgboost/logging.h"
+#include "xgboost/span.h"                // for Span
 
 namespace xgboost::data {
 struct LabelsCheck {
@@ -26,6 +32,44 @@ struct WeightsCheck {
   XGBOOST_DEVICE bool operator()(float w) { return LabelsCheck{}(w) || w < 0; }  // NOLINT
 };
 
+/**
+ * @brief Find the first value for which `check` returns true.
+ *
+ *   The values are checked in blocks in parallel. The check of a block has no early exit
+ *   so the compiler can vectorize it, only the first invalid block is searched again for
+ *   the index.
+ *
+ * @return The index of the first invalid value, or the size of the input if all values
+ *         are valid.
+ */
+template <typename Check>
+[[nodiscard]] std::size_t FindFirstInvalid(std::int32_t n_threads, common::Span<float const> values,
+                                           Check check) {
+  constexpr std::size_t kBlockSize = 4096;
+  auto n_blocks = common::DivRoundUp(values.size(), kBlockSize);
+  std::vector<std::uint8_t> invalid(n_blocks, 0);
+  common::ParallelFor(n_blocks, n_threads, [&](std::size_t i) {
+    auto begin = i * kBlockSize;
+    auto end = std::min(begin + kBlockSize, values.size());
+    bool any = false;
+    for (auto k = begin; k < end; ++k) {
+      any |= check(values[k]);
+    }
+    invalid[i] = any;
+  });
+  for (std::size_t i = 0; i < n_blocks; ++i) {
+    if (XGBOOST_EXPECT(invalid[i] != 0, false)) {
+      auto end = std::min((i + 1) * kBlockSize, values.size());
+      for (auto k = i * kBlockSize; k < end; ++k) {
+        if (check(values[k])) {
+          return k;
+        }
+      }
+    }
+  }
+  return values.size();
+}
+
 inline void ValidateQueryGroup(std::vector<bst_group_t> const& group_ptr_) {
   bool valid_query_group = true;
   for (size_t i = 1; i < group_ptr_.size(); ++i) {
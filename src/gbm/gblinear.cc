@@ -37,8 +37,7 @@ struct GBLinearTrainParam : public XGBoostParameter<GBLinearTrainParam> {
   size_t max_row_perbatch;
 
   void CheckGPUSupport() {
-    auto n_gpus = curt::AllVisibleGPUs();
-    if (n_gpus == 0 && this->updater == "gpu_coord_descent") {
+    if (this->updater == "gpu_coord_descent" && curt::AllVisibleGPUs() == 0) {
       common::AssertGPUSupport();
       this->UpdateAllowUnknown(Args{{"updater", "coord_descent"}});
       LOG(WARNING) << "Loading configuration on a CPU only machine.   Changing "
@@ -9,13 +9,15 @@
 #include <dmlc/omp.h>
 #include <dmlc/parameter.h>
 
-#include <algorithm>  // for equal
-#include <cstdint>    // for uint32_t
+#include <algorithm>  // for equal, copy, copy_n, max, min, all_of
+#include <cstdint>    // for uint32_t, uint8_t
 #include <memory>
+#include <numeric>    // for iota
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "../collective/communicator-inl.h"  // for IsDistributed
 #include "../common/common.h"
 #include "../common/cuda_rt_utils.h"  // for AllVisibleGPUs
 #include "../common/error_msg.h"  // for UnknownDevice, WarnOldSerialization, InplacePredictProxy
@@ -23,10 +25,13 @@
 #include "../common/threading_utils.h"
 #include "../common/timer.h"
 #include "../data/proxy_dmatrix.h"  // for DMatrixProxy, HostAdapterDispatch
+#include "../tree/tree_telemetry.h"  // for TelemetryRound, PhaseTimer
 #include "gbtree_model.h"
+#include "tree_pager.h"  // for TreePager
 #include "xgboost/base.h"
 #include "xgboost/data.h"
 #include "xgboost/gbm.h"
+#include "xgboost/global_config.h"  // for InitNewThread
 #include "xgboost/host_device_vector.h"
 #include "xgboost/json.h"
 #include "xgboost/logging.h"
@@ -100,16 +105,24 @@ void GBTree::Configure(Args const& cfg) {
   }
 
   // configure predictors
-  if (!cpu_predictor_) {
-    cpu_predictor_ = std::unique_ptr<Predictor>(Predictor::Create("cpu_predictor", this->ctx_));
+  if (!cpu_predictor_ || cpu_predictor_type_ != tparam_.predictor) {
+    auto name = "cpu_predictor";
+    if (tparam_.predictor == PredictorType::kQuickScorer) {
+      name = "qs_predictor";
+    } else if (tparam_.predictor == PredictorType::kQuantized) {
+      name = "quantized_predictor";
+    }
+    cpu_predictor_ = std::unique_ptr<Predictor>(Predictor::Create(name, this->ctx_));
+    cpu_predictor_type_ = tparam_.predictor;
   }
   cpu_predictor_->Configure(cfg);
 #if defined(XGBOOST_USE_CUDA)
-  auto n_gpus = curt::AllVisibleGPUs();
-  if (!gpu_predictor_) {
-    gpu_predictor_ = std::unique_ptr<Predictor>(Predictor::Create("gpu_predictor", this->ctx_));
-  }
-  if (n_gpus != 0) {
+  // Don't touch the CUDA runtime for a CPU model. The context is only CUDA when there's a
+  // visible device, and the booster is configured again when the device changes.
+  if (ctx_->IsCUDA()) {
+    if (!gpu_predictor_) {
+      gpu_predictor_ = std::unique_ptr<Predictor>(Predictor::Create("gpu_predictor", this->ctx_));
+    }
     gpu_predictor_->Configure(cfg);
   }
 #endif  // defined(XGBOOST_USE_CUDA)
@@ -185,12 +198,12 @@ void GBTree::UpdateTreeLeaf(DMatrix const* p_fmat, HostDeviceVector<float> const
   if (!obj || !obj->Task().UpdateTreeLeaf()) {
     return;
   }
+  tree::PhaseTimer timer{tree::TreePhase::kLeafUpdate};
 
   auto& trees = *p_trees;
   CHECK_EQ(model_.param.num_parallel_tree, trees.size());
   CHECK_EQ(model_.param.num_parallel_tree, 1)
       << "Boosting random forest is not supported for current objective.";
-  CHECK(!trees.front()->IsMultiTarget()) << "Update tree leaf" << MTNotImplemented();
   CHECK_EQ(trees.size(), model_.param.num_parallel_tree);
   for (std::size_t tree_idx = 0; tree_idx < trees.size(); ++tree_idx) {
     auto const& position = node_position.at(tree_idx);
@@ -201,6 +214,7 @@ void GBTree::UpdateTreeLeaf(DMatrix const* p_fmat, HostDeviceVector<float> const
 
 void GBTree::DoBoost(DMatrix* p_fmat, linalg::Matrix<GradientPair>* in_gpair,
                      PredictionCacheEntry* predt, ObjFunction const* obj) {
+  CHECK(!model_.IsLazy()) << error::LazyModel();
   if (model_.learner_model_param->IsVectorLeaf()) {
     CHECK(tparam_.tree_method == TreeMethod::kHist || tparam_.tree_method == TreeMethod::kAuto)
         << "Only the hist tree method is supported for building multi-target trees with vector "
@@ -211,15 +225,17 @@ void GBTree::DoBoost(DMatrix* p_fmat, linalg::Matrix<GradientPair>* in_gpair,
   TreesOneIter new_trees;
   bst_target_t const n_groups = model_.learner_model_param->OutputLength();
   monitor_.Start("BoostNewTrees");
+  // The records are emitted after the model is committed.
+  tree::TelemetryRound round{model_.BoostedRounds(), static_cast<std::int32_t>(model_.trees.size()),
+                             model_.param.num_parallel_tree};
 
   predt->predictions.SetDevice(ctx_->Device());
   auto out = linalg::MakeTensorView(ctx_, &predt->predictions, p_fmat->Info().num_row_,
                                     model_.learner_model_param->OutputLength());
   CHECK_NE(n_groups, 0);
 
-  // The node position for each row, 1 HDV for each tree in the forest.  Note that the
-  // position is negated if the row is sampled out.
-  std::vector<HostDeviceVector<bst_node_t>> node_position;
+  // Resized by `BoostNewTrees`, the buffers are reused between iterations.
+  auto& node_position = this->node_position_;
 
   if (model_.learner_model_param->IsVectorLeaf()) {
     TreesOneGroup ret;
@@ -231,6 +247,8 @@ void GBTree::DoBoost(DMatrix* p_fmat, linalg::Matrix<GradientPair>* in_gpair,
         updaters_.back()->UpdatePredictionCache(p_fmat, out)) {
       predt->Update(1);
     }
+  } else if (this->BoostConcurrentTrees(in_gpair, p_fmat, obj, out, predt, &new_trees)) {
+    // All trees of this round are built.
   } else if (model_.learner_model_param->OutputLength() == 1u) {
     TreesOneGroup ret;
     BoostNewTrees(in_gpair, p_fmat, 0, &node_position, &ret);
@@ -243,11 +261,12 @@ void GBTree::DoBoost(DMatrix* p_fmat, linalg::Matrix<GradientPair>* in_gpair,
     }
   } else {
     CHECK_EQ(in_gpair->Size() % n_groups, 0U) << "must have exactly ngroup * nrow gpairs";
-    linalg::Matrix<GradientPair> tmp{{in_gpair->Shape(0), static_cast<std::size_t>(1ul)},
-                                     ctx_->Device()};
+    auto& tmp = this->group_gpair_;
     bool update_predict = true;
+    // The cache of one group can be updated while building the tree of the next group, unless
+    // the objective reads the predictions for updating the leaf values.
+    bool defer_cache = !(obj && obj->Task().UpdateTreeLeaf());
     for (bst_target_t gid = 0; gid < n_groups; ++gid) {
-      node_position.clear();
       CopyGradient(ctx_, in_gpair, gid, &tmp);
       TreesOneGroup ret;
       BoostNewTrees(&tmp, p_fmat, gid, &node_position, &ret);
@@ -255,8 +274,11 @@ void GBTree::DoBoost(DMatrix* p_fmat, linalg::Matrix<GradientPair>* in_gpair,
       const size_t num_new_trees = ret.size();
       new_trees.push_back(std::move(ret));
       auto v_predt = out.Slice(linalg::All(), linalg::Range(gid, gid + 1));
-      if (!(updaters_.size() > 0 && predt->predictions.Size() > 0 && num_new_trees == 1 &&
-            updaters_.back()->UpdatePredictionCache(p_fmat, v_predt))) {
+      bool can_update = updaters_.size() > 0 && predt->predictions.Size() > 0 && num_new_trees == 1;
+      if (can_update && defer_cache && gid + 1 != n_groups) {
+        updaters_.back()->DeferPredictionCache();
+      }
+      if (!(can_update && updaters_.back()->UpdatePredictionCache(p_fmat, v_predt))) {
         update_predict = false;
       }
     }
@@ -269,6 +291,108 @@ void GBTree::DoBoost(DMatrix* p_fmat, linalg::Matrix<GradientPair>* in_gpair,
   this->CommitModel(std::move(new_trees));
 }
 
+bool GBTree::BoostConcurrentTrees(linalg::Matrix<GradientPair> const* in_gpair, DMatrix* p_fmat,
+                                  ObjFunction const* obj, linalg::MatrixView<float> out,
+                                  PredictionCacheEntry* predt, TreesOneIter* out_trees) {
+  bst_target_t const n_groups = model_.learner_model_param->OutputLength();
+  std::int32_t const n_forest = model_.param.num_parallel_tree;
+  std::int32_t const n_tasks = static_cast<std::int32_t>(n_groups) * n_forest;
+  std::int32_t const n_workers =
+      std::min({tparam_.concurrent_trees, n_tasks, std::max(ctx_->Threads(), 1)});
+  // - Only the CPU hist updater is known to be safe for sharing the data between threads.
+  // - The gradient index is generated by the first iteration, the workers must not
+  //   generate it concurrently, neither can they fetch external memory pages.
+  // - Objectives that refresh the leaf values need the position of all trees.
+  // - The collective calls from the updaters can not be interleaved.
+  if (n_workers <= 1 || !ctx_->IsCPU() || tparam_.process_type != TreeProcessType::kDefault ||
+      tparam_.updater_seq != "grow_quantile_histmaker" || updaters_.size() != 1 ||
+      (obj && obj->Task().UpdateTreeLeaf()) || collective::IsDistributed() ||
+      !p_fmat->SingleColBlock() || !p_fmat->PageExists<GHistIndexMatrix>()) {
+    return false;
+  }
+  CHECK_EQ(in_gpair->Shape(1), n_groups) << "must have exactly ngroup * nrow gpairs";
+
+  auto n_threads = std::max(ctx_->Threads() / n_workers, 1);
+  if (tree_workers_.size() != static_cast<std::size_t>(n_workers) ||
+      tree_workers_.front()->ctx.Threads() != n_threads) {
+    tree_pool_.reset();
+    tree_workers_.clear();
+    for (std::int32_t i = 0; i < n_workers; ++i) {
+      auto worker = std::make_unique<TreeWorker>();
+      worker->ctx = *ctx_;
+      worker->ctx.nthread = n_threads;
+      worker->updater.reset(TreeUpdater::Create(tparam_.updater_seq, &worker->ctx,
+                                                &model_.learner_model_param->task));
+      worker->position.resize(1);
+      tree_workers_.push_back(std::move(worker));
+    }
+    tree_pool_ = std::make_unique<common::ThreadPool>(StringView{"xgb-tree"}, n_workers,
+                                                      InitNewThread{});
+  }
+  // Follow the configuration of the main updater, which is the one configured by the
+  // learner.
+  Json config{Object{}};
+  updaters_.front()->SaveConfig(&config);
+  for (auto& worker : tree_workers_) {
+    worker->updater->LoadConfig(config);
+    worker->param = tree_param_;
+    worker->param.learning_rate /= static_cast<float>(n_forest);
+  }
+
+  // The random engine is thread local, draw the seeds before launching the workers.
+  std::vector<std::uint32_t> seeds(n_tasks);
+  for (auto& seed : seeds) {
+    seed = common::GlobalRandom()();
+  }
+  out_trees->resize(n_groups);
+  for (auto& trees : *out_trees) {
+    trees.clear();
+    for (std::int32_t i = 0; i < n_forest; ++i) {
+      trees.emplace_back(std::make_unique<RegTree>(model_.learner_model_param->LeafLength(),
+                                                   model_.learner_model_param->num_feature));
+    }
+  }
+
+  std::vector<std::uint8_t> cached(n_tasks, 0);
+  std::vector<std::int32_t> worker_ids(n_workers);
+  std::iota(worker_ids.begin(), worker_ids.end(), 0);
+  auto* round = tree::TelemetryRound::Current();
+  auto tree_begin = static_cast<std::int32_t>(model_.trees.size());
+  auto futures = tree_pool_->SubmitBulk(worker_ids, [&](std::int32_t w) {
+    auto& worker = *tree_workers_[w];
+    for (std::int32_t t = w; t < n_tasks; t += n_workers) {
+      tree::TelemetryRound::Join join{round, tree_begin + t};
+      auto gid = t / n_forest;
+      common::GlobalRandom().seed(seeds[t]);
+      CopyGradient(&worker.ctx, in_gpair, gid, &worker.gpair);
+      std::vector<RegTree*> trees{out_trees->at(gid).at(t % n_forest).get()};
+      worker.updater->Update(&worker.param, &worker.gpair, p_fmat,
+                             common::Span<HostDeviceVector<bst_node_t>>{worker.position}, trees);
+      // Each group has its own column, the cache is updated only by the worker that
+      // builds the tree.
+      if (n_forest == 1 && predt->predictions.Size() > 0) {
+        auto v_predt = out.Slice(linalg::All(), linalg::Range(gid, gid + 1));
+        cached[t] = worker.updater->UpdatePredictionCache(p_fmat, v_predt);
+      }
+    }
+  });
+  for (auto& fut : futures) {
+    fut.get();
+  }
+  if (n_forest == 1 && std::all_of(cached.cbegin(), cached.cend(), [](auto v) { return v; })) {
+    predt->Update(1);
+  }
+  return true;
+}
+
+bool GBTree::FuseGradient(RowGradient const* fn) {
+  if (!ctx_->IsCPU() || model_.learner_model_param->OutputLength() != 1 ||
+      tparam_.process_type != TreeProcessType::kDefault || updaters_.empty()) {
+    return false;
+  }
+  return updaters_.front()->FuseGradient(fn);
+}
+
 void GBTree::BoostNewTrees(linalg::Matrix<GradientPair>* gpair, DMatrix* p_fmat, int bst_group,
                            std::vector<HostDeviceVector<bst_node_t>>* out_position,
                            TreesOneGroup* ret) {
@@ -343,7 +467,6 @@ void GBTree::LoadConfig(Json const& in) {
   // This would cause all trees to be pushed to trees_to_update
   // e.g. updating a model, then saving and loading it would result in an empty model
   tparam_.process_type = TreeProcessType::kDefault;
-  std::int32_t const n_gpus = curt::AllVisibleGPUs();
 
   auto msg = StringView{
       R"(
@@ -354,7 +477,8 @@ void GBTree::LoadConfig(Json const& in) {
 
   for more details about differences between saving model and serializing.)"};
 
-  if (n_gpus == 0 && tparam_.tree_method == TreeMethod::kGPUHist) {
+  // Only query the devices for a GPU model.
+  if (tparam_.tree_method == TreeMethod::kGPUHist && curt::AllVisibleGPUs() == 0) {
     tparam_.UpdateAllowUnknown(Args{{"tree_method", "hist"}});
     LOG(WARNING) << msg << "  Changing `tree_method` to `hist`.";
   }
@@ -379,7 +503,7 @@ void GBTree::LoadConfig(Json const& in) {
 
   for (auto const& config : updater_seq) {
     auto name = get<String>(config["name"]);
-    if (n_gpus == 0 && name == "grow_gpu_hist") {
+    if (name == "grow_gpu_hist" && curt::AllVisibleGPUs() == 0) {
       name = "grow_quantile_histmaker";
       LOG(WARNING) << "Changing updater from `grow_gpu_hist` to `grow_quantile_histmaker`.";
     }
@@ -423,17 +547,47 @@ void GBTree::LoadModel(Json const& in) {
   model_.LoadModel(in["model"]);
 }
 
+void GBTree::LoadStreamedModel(Json const& in, std::vector<std::unique_ptr<RegTree>>&& trees) {
+  CHECK_EQ(get<String>(in["name"]), "gbtree");
+  model_.LoadModel(in["model"], std::move(trees));
+}
+
+void GBTree::LoadLazyModel(Json const& in, std::shared_ptr<TreePager> pager) {
+  CHECK_EQ(get<String>(in["name"]), "gbtree");
+  model_.LoadLazyModel(in["model"], std::move(pager));
+}
+
 void GBTree::SaveModel(Json* p_out) const {
+  CHECK(!model_.IsLazy()) << error::LazyModel();
+  auto& out = *p_out;
+  out["name"] = String("gbtree");
+  out["model"] = Object();
+  auto& model = out["model"];
+  model_.SaveModel(&model, tparam_.dedup_trees);
+}
+
+void GBTree::SaveServingModel(Json* p_out) const {
+  CHECK(!model_.IsLazy()) << error::LazyModel();
   auto& out = *p_out;
   out["name"] = String("gbtree");
   out["model"] = Object();
   auto& model = out["model"];
-  model_.SaveModel(&model);
+  model_.SaveModel(&model, tparam_.dedup_trees, false);
+}
+
+void GBTree::SaveStreamedModel(Json* p_out, std::vector<RegTree const*>* trees) const {
+  CHECK(!model_.IsLazy()) << error::LazyModel();
+  auto& out = *p_out;
+  out["name"] = String("gbtree");
+  out["model"] = Object();
+  auto& model = out["model"];
+  model_.SaveModel(&model, trees);
 }
 
 void GBTree::Slice(bst_layer_t begin, bst_layer_t end, bst_layer_t step, GradientBooster* out,
                    bool* out_of_bound) const {
   CHECK(out);
+  CHECK(!model_.IsLazy()) << error::LazyModel();
 
   auto p_gbtree = dynamic_cast<GBTree*>(out);
   CHECK(p_gbtree);
@@ -450,7 +604,7 @@ void GBTree::Slice(bst_layer_t begin, bst_layer_t end, bst_layer_t step, Gradien
   }
 
   auto& out_indptr = out_model.iteration_indptr;
-  TreesOneGroup& out_trees = out_model.trees;
+  SharedTrees& out_trees = out_model.trees;
   std::vector<int32_t>& out_trees_info = out_model.tree_info;
 
   bst_layer_t n_layers = (end - begin) / step;
@@ -466,8 +620,8 @@ void GBTree::Slice(bst_layer_t begin, bst_layer_t end, bst_layer_t step, Gradien
 
   *out_of_bound =
       detail::SliceTrees(begin, end, step, this->model_, [&](auto in_tree_idx, auto out_l) {
-        auto new_tree = std::make_unique<RegTree>(*this->model_.trees.at(in_tree_idx));
-        out_trees.emplace_back(std::move(new_tree));
+        // The trees are shared, the sliced model is a view of the original model.
+        out_trees.push_back(this->model_.trees.at(in_tree_idx));
 
         bst_group_t group = this->model_.tree_info[in_tree_idx];
         out_trees_info.push_back(group);
@@ -480,6 +634,36 @@ void GBTree::Slice(bst_layer_t begin, bst_layer_t end, bst_layer_t step, Gradien
 
   out_model.param.num_trees = out_model.trees.size();
   out_model.param.num_parallel_tree = model_.param.num_parallel_tree;
+  out_model.serving = model_.serving;
+  out_model.BumpVersion();
+}
+
+void GBTree::Append(GradientBooster const* that) {
+  auto p_gbtree = dynamic_cast<GBTree const*>(that);
+  CHECK(p_gbtree) << "Only a model with the same booster can be appended.";
+  auto const& in_model = p_gbtree->model_;
+  CHECK(!model_.IsLazy() && !in_model.IsLazy()) << error::LazyModel();
+  CHECK(this->model_.trees_to_update.empty() && in_model.trees_to_update.empty())
+      << "Models with trees being updated can not be appended.";
+  CHECK_EQ(in_model.param.num_parallel_tree, model_.param.num_parallel_tree)
+      << "Models with different `num_parallel_tree` can not be appended.";
+  CHECK_EQ(in_model.learner_model_param->OutputLength(),
+           model_.learner_model_param->OutputLength())
+      << "Models with different number of outputs can not be appended.";
+
+  auto offset = model_.iteration_indptr.back();
+  for (std::size_t i = 0; i < in_model.trees.size(); ++i) {
+    model_.trees.push_back(in_model.trees[i]);
+    model_.tree_info.push_back(in_model.tree_info[i]);
+  }
+  for (auto it = in_model.iteration_indptr.cbegin() + 1; it != in_model.iteration_indptr.cend();
+       ++it) {
+    model_.iteration_indptr.push_back(*it + offset);
+  }
+  model_.param.num_trees = model_.trees.size();
+  CHECK_EQ(model_.iteration_indptr.back(), model_.param.num_trees);
+  model_.serving = model_.serving || in_model.serving;
+  model_.BumpVersion();
 }
 
 void GBTree::PredictBatchImpl(DMatrix* p_fmat, PredictionCacheEntry* out_preds, bool is_training,
@@ -487,6 +671,12 @@ void GBTree::PredictBatchImpl(DMatrix* p_fmat, PredictionCacheEntry* out_preds,
   if (layer_end == 0) {
     layer_end = this->BoostedRounds();
   }
+  // Ranges that can't be served by the incremental cache use the prefix sums.
+  bool incremental = layer_begin == 0 && layer_end >= static_cast<bst_layer_t>(out_preds->version);
+  if (!is_training && !incremental && tparam_.prefix_cache && !model_.IsLazy() &&
+      this->PredictFromPrefix(p_fmat, out_preds, layer_begin, layer_end)) {
+    return;
+  }
   if (layer_begin != 0 || layer_end < static_cast<bst_layer_t>(out_preds->version)) {
     // cache is dropped.
     out_preds->version = 0;
@@ -510,8 +700,10 @@ void GBTree::PredictBatchImpl(DMatrix* p_fmat, PredictionCacheEntry* out_preds,
   }
 
   auto [tree_begin, tree_end] = detail::LayerToTree(model_, layer_begin, layer_end);
-  CHECK_LE(tree_end, model_.trees.size()) << "Invalid number of trees.";
-  if (tree_end > tree_begin) {
+  CHECK_LE(tree_end, model_.param.num_trees) << "Invalid number of trees.";
+  if (tree_end > tree_begin && model_.IsLazy()) {
+    this->PredictLazy(predictor, p_fmat, out_preds, layer_begin, layer_end);
+  } else if (tree_end > tree_begin) {
     predictor->PredictBatch(p_fmat, out_preds, model_, tree_begin, tree_end);
   }
   if (reset) {
@@ -522,6 +714,84 @@ void GBTree::PredictBatchImpl(DMatrix* p_fmat, PredictionCacheEntry* out_preds,
   }
 }
 
+void GBTree::PredictLazy(std::unique_ptr<Predictor> const& predictor, DMatrix* p_fmat,
+                         PredictionCacheEntry* out_preds, bst_layer_t layer_begin,
+                         bst_layer_t layer_end) const {
+  CHECK(ctx_->IsCPU()) << "Lazily loaded models can only be used on CPU.";
+  auto const& pager = *model_.pager;
+  // Predict by pages, each page is a small model with the trees of a range of layers.
+  for (auto l = layer_begin; l < layer_end;) {
+    auto page = pager.PageOf(l);
+    auto [page_begin, page_end] = pager.PageLayers(page);
+    auto end = std::min(page_end, layer_end);
+    auto p_page = pager.Page(page);
+    auto [tree_begin, tree_end] = detail::LayerToTree(*p_page, l - page_begin, end - page_begin);
+    predictor->PredictBatch(p_fmat, out_preds, *p_page, tree_begin, tree_end);
+    l = end;
+  }
+}
+
+bool GBTree::PredictFromPrefix(DMatrix* p_fmat, PredictionCacheEntry* out_preds,
+                               bst_layer_t layer_begin, bst_layer_t layer_end) const {
+  if (!this->ctx_->IsCPU() || p_fmat->Info().IsColumnSplit()) {
+    return false;
+  }
+  CHECK_LE(layer_begin, layer_end);
+  CHECK_LE(layer_end, this->BoostedRounds()) << "Invalid number of trees.";
+  auto n = p_fmat->Info().num_row_ * model_.learner_model_param->OutputLength();
+  auto& prefix = out_preds->layer_prefix;
+  if (out_preds->prefix_model_version != model_.Version() ||
+      prefix.Size() != n * out_preds->n_prefix_layers) {
+    out_preds->n_prefix_layers = 0;
+    out_preds->prefix_model_version = model_.Version();
+  }
+
+  auto n_layers = static_cast<bst_layer_t>(out_preds->n_prefix_layers);
+  if (n_layers <= layer_end) {
+    // Extend the prefix sums by predicting one layer at a time.
+    PredictionCacheEntry running;
+    if (n_layers == 0) {
+      cpu_predictor_->InitOutPredictions(p_fmat->Info(), &running.predictions, model_);
+    } else {
+      auto const& h_prefix = prefix.ConstHostVector();
+      running.predictions.HostVector().assign(h_prefix.cbegin() + (n_layers - 1) * n,
+                                              h_prefix.cbegin() + n_layers * n);
+    }
+    prefix.Resize(n * (layer_end + 1));
+    auto& h_prefix = prefix.HostVector();
+    for (bst_layer_t l = std::max(n_layers - 1, 0); l <= layer_end; ++l) {
+      if (l >= n_layers) {
+        auto const& h_running = running.predictions.ConstHostVector();
+        std::copy(h_running.cbegin(), h_running.cend(), h_prefix.begin() + l * n);
+      }
+      if (l != layer_end) {
+        auto [tree_begin, tree_end] = detail::LayerToTree(model_, l, l + 1);
+        cpu_predictor_->PredictBatch(p_fmat, &running, model_, tree_begin, tree_end);
+      }
+    }
+    out_preds->n_prefix_layers = layer_end + 1;
+  }
+
+  auto const& h_prefix = prefix.ConstHostVector();
+  out_preds->predictions.Resize(n);
+  auto& h_out = out_preds->predictions.HostVector();
+  auto const* p_end = h_prefix.data() + layer_end * n;
+  if (layer_begin == 0) {
+    std::copy_n(p_end, n, h_out.begin());
+    // Same as the incremental cache.
+    out_preds->version = layer_end;
+  } else {
+    // The base margin is in all prefix sums, add it back.
+    auto const* p_begin = h_prefix.data() + layer_begin * n;
+    auto const* p_base = h_prefix.data();
+    common::ParallelFor(n, this->ctx_->Threads(), [&](auto i) {
+      h_out[i] = p_end[i] - p_begin[i] + p_base[i];
+    });
+    out_preds->version = 0;
+  }
+  return true;
+}
+
 void GBTree::PredictBatch(DMatrix* p_fmat, PredictionCacheEntry* out_preds, bool is_training,
                           bst_layer_t layer_begin, bst_layer_t layer_end) {
   // dispatch to const function.
@@ -532,9 +802,13 @@ void GBTree::InplacePredict(std::shared_ptr<DMatrix> p_m, float missing,
                             PredictionCacheEntry* out_preds, bst_layer_t layer_begin,
                             bst_layer_t layer_end) const {
   auto [tree_begin, tree_end] = detail::LayerToTree(model_, layer_begin, layer_end);
-  CHECK_LE(tree_end, model_.trees.size()) << "Invalid number of trees.";
-  if (p_m->Ctx()->Device() != this->ctx_->Device()) {
-    error::MismatchedDevices(this->ctx_, p_m->Ctx());
+  CHECK_LE(tree_end, model_.param.num_trees) << "Invalid number of trees.";
+  bool mismatched = p_m->Ctx()->Device() != this->ctx_->Device();
+  // Lazily loaded models predict by pages with the DMatrix.
+  if (mismatched || model_.IsLazy()) {
+    if (mismatched) {
+      error::MismatchedDevices(this->ctx_, p_m->Ctx());
+    }
     CHECK_EQ(out_preds->version, 0);
     auto proxy = std::dynamic_pointer_cast<data::DMatrixProxy>(p_m);
     CHECK(proxy) << error::InplacePredictProxy();
@@ -562,6 +836,85 @@ void GBTree::InplacePredict(std::shared_ptr<DMatrix> p_m, float missing,
   }
 }
 
+void GBTree::PrepareDense(bst_idx_t n_rows, bst_layer_t layer_begin, bst_layer_t layer_end,
+                          HostDeviceVector<float>* out_preds, DenseModelSlice* out_slice) const {
+  CHECK(ctx_->IsCPU()) << "Dense predict is only supported on CPU.";
+  CHECK(!model_.IsLazy()) << error::LazyModel();
+  auto [tree_begin, tree_end] = detail::LayerToTree(model_, layer_begin, layer_end);
+  CHECK_LE(tree_end, model_.trees.size()) << "Invalid number of trees.";
+  auto n_groups = model_.learner_model_param->OutputLength();
+  // Resize doesn't release the memory, the buffer is reused across calls.
+  out_preds->Resize(n_rows * n_groups);
+  out_slice->predictor = this->cpu_predictor_.get();
+  out_slice->model = &model_;
+  out_slice->tree_begin = tree_begin;
+  out_slice->tree_end = tree_end;
+  out_slice->out_predt = linalg::MakeTensorView(ctx_, out_preds, n_rows, n_groups);
+}
+
+void GBTree::PredictDense(float const* data, bst_idx_t n_rows, float missing,
+                          bst_layer_t layer_begin, bst_layer_t layer_end,
+                          HostDeviceVector<float>* out_preds) const {
+  DenseModelSlice slice;
+  this->PrepareDense(n_rows, layer_begin, layer_end, out_preds, &slice);
+  bool supported = this->cpu_predictor_->PredictDense(
+      model_, data, n_rows, missing, slice.tree_begin, slice.tree_end, slice.out_predt);
+  CHECK(supported) << "Dense predict is not supported by the current predictor.";
+}
+
+void GBTree::PredictCascade(DMatrix* p_fmat, float missing, bst_layer_t layer_begin,
+                            bst_layer_t layer_end, std::vector<bst_layer_t> const& checkpoints,
+                            std::vector<float> const& thresholds,
+                            HostDeviceVector<float>* out_preds,
+                            HostDeviceVector<std::uint8_t>* finished) const {
+  CHECK(ctx_->IsCPU()) << "Cascade predict is only supported on CPU.";
+  CHECK(!model_.IsLazy()) << error::LazyModel();
+  CHECK_EQ(checkpoints.size(), thresholds.size())
+      << "Each checkpoint must have a corresponding threshold.";
+  auto [tree_begin, tree_end] = detail::LayerToTree(model_, layer_begin, layer_end);
+  CHECK_LE(tree_end, model_.trees.size()) << "Invalid number of trees.";
+  layer_end = layer_end == 0 ? model_.BoostedRounds() : layer_end;
+  std::vector<bst_tree_t> tree_checkpoints(checkpoints.size());
+  bst_layer_t prev = layer_begin;
+  for (std::size_t i = 0; i < checkpoints.size(); ++i) {
+    CHECK_GT(checkpoints[i], prev) << "Checkpoints must be increasing and greater than the "
+                                      "beginning of the iteration range.";
+    CHECK_LT(checkpoints[i], layer_end) << "Checkpoints must be less than the end of the "
+                                           "iteration range.";
+    tree_checkpoints[i] = model_.iteration_indptr[checkpoints[i]];
+    prev = checkpoints[i];
+  }
+
+  auto n_samples = p_fmat->Info().num_row_;
+  cpu_predictor_->InitOutPredictions(p_fmat->Info(), out_preds, model_);
+  finished->Resize(n_samples);
+  auto out_predt = linalg::MakeVec(out_preds->HostPointer(), out_preds->Size());
+  bool supported = this->cpu_predictor_->PredictCascade(
+      p_fmat, model_, missing, tree_begin, tree_end, common::Span{tree_checkpoints},
+      common::Span{thresholds}, out_predt, finished->HostSpan());
+  CHECK(supported) << "Cascade predict is not supported by the current predictor.";
+}
+
+void GBTree::PredictLeafMargin(DMatrix* p_fmat, HostDeviceVector<float>* out_leaf,
+                               HostDeviceVector<float>* out_margin, bst_layer_t layer_begin,
+                               bst_layer_t layer_end) {
+  CHECK(!model_.IsLazy()) << error::LazyModel();
+  auto [tree_begin, tree_end] = detail::LayerToTree(model_, layer_begin, layer_end);
+  CHECK_EQ(tree_begin, 0) << "Predict leaf supports only iteration end: (0, "
+                             "n_iteration), use model slicing instead.";
+  auto const& predictor = this->GetPredictor(false);
+  if (predictor->PredictLeafMargin(p_fmat, model_, tree_end, out_leaf, out_margin)) {
+    return;
+  }
+  // Fallback to separated traversals.
+  predictor->PredictLeaf(p_fmat, out_leaf, model_, tree_end);
+  PredictionCacheEntry predt;
+  this->PredictBatch(p_fmat, &predt, false, layer_begin, layer_end);
+  out_margin->SetDevice(predt.predictions.Device());
+  out_margin->Resize(predt.predictions.Size());
+  out_margin->Copy(predt.predictions);
+}
+
 [[nodiscard]] std::unique_ptr<Predictor> const& GBTree::GetPredictor(
     bool is_training, HostDeviceVector<float> const* out_pred, DMatrix* f_dmat) const {
   // Data comes from SparsePageDMatrix. Since we are loading data in pages, no need to
@@ -644,6 +997,16 @@ void GPUDartPredictInc(common::Span<float>, common::Span<float>, float, size_t,
 }
 #endif
 
+/** Compute `y += a * x` on GPU. */
+void GPUDartAxpy(float, common::Span<float const>, common::Span<float>)
+#if defined(XGBOOST_USE_CUDA)
+    ;  // NOLINT
+#else
+{
+  common::AssertGPUSupport();
+}
+#endif
+
 void GPUDartInplacePredictInc(common::Span<float> /*out_predts*/, common::Span<float> /*predts*/,
                               float /*tree_w*/, size_t /*n_rows*/,
                               linalg::TensorView<float const, 1> /*base_score*/,
@@ -681,28 +1044,46 @@ class Dart : public GBTree {
     });
   }
 
+  void Append(GradientBooster const*) final {
+    // Dart normalizes the weights of the existing trees when new trees are added, appending
+    // only the new trees would leave stale weights.
+    LOG(FATAL) << "Append is not supported by dart.";
+  }
+
   void SaveModel(Json *p_out) const override {
     auto &out = *p_out;
     out["name"] = String("dart");
     out["gbtree"] = Object();
     GBTree::SaveModel(&(out["gbtree"]));
-
-    std::vector<Json> j_weight_drop(weight_drop_.size());
-    for (size_t i = 0; i < weight_drop_.size(); ++i) {
-      j_weight_drop[i] = Number(weight_drop_[i]);
-    }
-    out["weight_drop"] = Array(std::move(j_weight_drop));
+    this->SaveWeightDrop(p_out);
+  }
+  void SaveServingModel(Json* p_out) const override {
+    auto& out = *p_out;
+    out["name"] = String("dart");
+    out["gbtree"] = Object();
+    GBTree::SaveServingModel(&(out["gbtree"]));
+    this->SaveWeightDrop(p_out);
+  }
+  void SaveStreamedModel(Json* p_out, std::vector<RegTree const*>* trees) const override {
+    auto& out = *p_out;
+    out["name"] = String("dart");
+    out["gbtree"] = Object();
+    GBTree::SaveStreamedModel(&(out["gbtree"]), trees);
+    this->SaveWeightDrop(p_out);
   }
   void LoadModel(Json const& in) override {
     CHECK_EQ(get<String>(in["name"]), "dart");
     auto const& gbtree = in["gbtree"];
     GBTree::LoadModel(gbtree);
-
-    auto const& j_weight_drop = get<Array>(in["weight_drop"]);
-    weight_drop_.resize(j_weight_drop.size());
-    for (size_t i = 0; i < weight_drop_.size(); ++i) {
-      weight_drop_[i] = get<Number const>(j_weight_drop[i]);
-    }
+    this->LoadWeightDrop(in);
+  }
+  void LoadStreamedModel(Json const& in, std::vector<std::unique_ptr<RegTree>>&& trees) override {
+    CHECK_EQ(get<String>(in["name"]), "dart");
+    GBTree::LoadStreamedModel(in["gbtree"], std::move(trees));
+    this->LoadWeightDrop(in);
+  }
+  void LoadLazyModel(Json const&, std::shared_ptr<TreePager>) override {
+    LOG(FATAL) << "Lazy loading is not supported by dart.";
   }
 
   void Load(dmlc::Stream* fi) override {
@@ -711,6 +1092,7 @@ class Dart : public GBTree {
     if (model_.param.num_trees != 0) {
       fi->Read(&weight_drop_);
     }
+    p_train_ = nullptr;
   }
   void Save(dmlc::Stream* fo) const override {
     GBTree::Save(fo);
@@ -743,28 +1125,34 @@ class Dart : public GBTree {
     CHECK(predictor);
     predictor->InitOutPredictions(p_fmat->Info(), &p_out_preds->predictions,
                                   model_);
-    p_out_preds->version = 0;
     auto [tree_begin, tree_end] = detail::LayerToTree(model_, layer_begin, layer_end);
     auto n_groups = model_.learner_model_param->num_output_group;
 
+    if (training && !idx_drop_.empty()) {
+      auto weights = this->weight_drop_;
+      for (auto i : idx_drop_) {
+        weights[i] = 0.0f;
+      }
+      if (predictor->PredictWeightedBatch(p_fmat, p_out_preds, model_, tree_begin, tree_end,
+                                          weights)) {
+        return;
+      }
+    } else if (predictor->PredictWeightedBatch(p_fmat, p_out_preds, model_, tree_begin, tree_end,
+                                               weight_drop_)) {
+      return;
+    }
+
+    // Fallback to predicting one tree at a time.
     PredictionCacheEntry predts;  // temporary storage for prediction
     if (!ctx_->IsCPU()) {
       predts.predictions.SetDevice(ctx_->Device());
     }
     predts.predictions.Resize(p_fmat->Info().num_row_ * n_groups, 0);
-    // multi-target is not yet supported.
-    auto layer_trees = [&]() {
-      return model_.param.num_parallel_tree * model_.learner_model_param->OutputLength();
-    };
-
     for (bst_tree_t i = tree_begin; i < tree_end; i += 1) {
       if (training && std::binary_search(idx_drop_.cbegin(), idx_drop_.cend(), i)) {
         continue;
       }
 
-      CHECK_GE(i, p_out_preds->version);
-      auto version = i / layer_trees();
-      p_out_preds->version = version;
       predts.predictions.Fill(0);
       predictor->PredictBatch(p_fmat, &predts, model_, i, i + 1);
 
@@ -793,9 +1181,62 @@ class Dart : public GBTree {
   void PredictBatch(DMatrix* p_fmat, PredictionCacheEntry* p_out_preds, bool training,
                     bst_layer_t layer_begin, bst_layer_t layer_end) override {
     DropTrees(training);
+    if (training) {
+      bool all_layers = layer_begin == 0 && (layer_end == 0 || layer_end == BoostedRounds());
+      if (all_layers && this->PredictFromMargin(p_fmat, p_out_preds)) {
+        return;
+      }
+      p_train_ = nullptr;
+    }
     this->PredictBatchImpl(p_fmat, p_out_preds, training, layer_begin, layer_end);
   }
 
+  void DoBoost(DMatrix* p_fmat, linalg::Matrix<GradientPair>* in_gpair,
+               PredictionCacheEntry* predt, ObjFunction const* obj) override {
+    auto n_trees = static_cast<bst_tree_t>(model_.trees.size());
+    // Whether the training prediction of this iteration came from the margin.
+    bool cached = p_train_ == p_fmat && n_margin_trees_ == n_trees;
+    GBTree::DoBoost(p_fmat, in_gpair, predt, obj);
+    if (!cached) {
+      p_train_ = nullptr;
+      return;
+    }
+    // Update the margin with the new weights of the dropped trees and the new trees.
+    this->Axpy(drop_factor_ - 1.0f, train_dropped_.predictions, &train_margin_.predictions);
+    auto n_new_trees = static_cast<bst_tree_t>(model_.trees.size());
+    auto const& predictor = this->GetPredictor(true, &train_margin_.predictions, p_fmat);
+    CHECK(predictor->PredictWeightedBatch(p_fmat, &train_margin_, model_, n_trees, n_new_trees,
+                                          weight_drop_));
+    n_margin_trees_ = n_new_trees;
+    predt->version = BoostedRounds();
+  }
+
+  void PredictDense(float const*, bst_idx_t, float, bst_layer_t, bst_layer_t,
+                    HostDeviceVector<float>*) const override {
+    LOG(FATAL) << "Dense predict is not supported by dart, use inplace predict instead.";
+  }
+
+  void PredictLeafMargin(DMatrix*, HostDeviceVector<float>*, HostDeviceVector<float>*,
+                         bst_layer_t, bst_layer_t) override {
+    LOG(FATAL) << "Fused leaf and margin prediction is not supported by dart.";
+  }
+
+  void PrepareDense(bst_idx_t, bst_layer_t, bst_layer_t, HostDeviceVector<float>*,
+                    DenseModelSlice*) const override {
+    LOG(FATAL) << "Dense predict is not supported by dart, use inplace predict instead.";
+  }
+
+  void PredictCascade(DMatrix*, float, bst_layer_t, bst_layer_t, std::vector<bst_layer_t> const&,
+                      std::vector<float> const&, HostDeviceVector<float>*,
+                      HostDeviceVector<std::uint8_t>*) const override {
+    LOG(FATAL) << "Cascade predict is not supported by dart.";
+  }
+
+  [[nodiscard]] std::string GenerateCode(bst_layer_t, bst_layer_t) const override {
+    LOG(FATAL) << "Code generation is not supported by dart.";
+    return {};
+  }
+
   void InplacePredict(std::shared_ptr<DMatrix> p_fmat, float missing,
                       PredictionCacheEntry* p_out_preds, bst_layer_t layer_begin,
                       bst_layer_t layer_end) const override {
@@ -897,6 +1338,91 @@ class Dart : public GBTree {
   }
 
  protected:
+  void SaveWeightDrop(Json* p_out) const {
+    std::vector<Json> j_weight_drop(weight_drop_.size());
+    for (size_t i = 0; i < weight_drop_.size(); ++i) {
+      j_weight_drop[i] = Number(weight_drop_[i]);
+    }
+    (*p_out)["weight_drop"] = Array(std::move(j_weight_drop));
+  }
+  void LoadWeightDrop(Json const& in) {
+    auto const& j_weight_drop = get<Array>(in["weight_drop"]);
+    weight_drop_.resize(j_weight_drop.size());
+    for (size_t i = 0; i < weight_drop_.size(); ++i) {
+      weight_drop_[i] = get<Number const>(j_weight_drop[i]);
+    }
+    // Invalidate the margin of the training data.
+    p_train_ = nullptr;
+  }
+
+  // y += a * x
+  void Axpy(float a, HostDeviceVector<float> const& x, HostDeviceVector<float>* y) const {
+    CHECK_EQ(x.Size(), y->Size());
+    if (ctx_->IsCUDA()) {
+      x.SetDevice(ctx_->Device());
+      y->SetDevice(ctx_->Device());
+      GPUDartAxpy(a, x.ConstDeviceSpan(), y->DeviceSpan());
+    } else {
+      auto const& h_x = x.ConstHostVector();
+      auto& h_y = y->HostVector();
+      common::ParallelFor(h_y.size(), ctx_->Threads(), [&](auto i) { h_y[i] += a * h_x[i]; });
+    }
+  }
+
+  /**
+   * @brief Training prediction from the margin of all trees, only the dropped trees are
+   *        predicted and subtracted from the margin.
+   *
+   *   The margin is built once for the training data and updated after each iteration by
+   *   `DoBoost`. The cache entry of the training data is marked with the number of boosted
+   *   rounds, a new entry means the margin needs to be rebuilt.
+   */
+  [[nodiscard]] bool PredictFromMargin(DMatrix* p_fmat, PredictionCacheEntry* p_out_preds) {
+    if (tparam_.process_type != TreeProcessType::kDefault ||
+        model_.learner_model_param->IsVectorLeaf()) {
+      return false;
+    }
+    auto n_trees = static_cast<bst_tree_t>(model_.trees.size());
+    auto const& predictor = this->GetPredictor(true, &p_out_preds->predictions, p_fmat);
+    bool valid = p_train_ == p_fmat && n_margin_trees_ == n_trees && p_out_preds->version != 0 &&
+                 p_out_preds->version == static_cast<std::uint32_t>(BoostedRounds());
+    if (!valid) {
+      predictor->InitOutPredictions(p_fmat->Info(), &train_margin_.predictions, model_);
+      if (!predictor->PredictWeightedBatch(p_fmat, &train_margin_, model_, 0, n_trees,
+                                           weight_drop_)) {
+        return false;
+      }
+      p_train_ = p_fmat;
+      n_margin_trees_ = n_trees;
+    }
+
+    auto n = train_margin_.predictions.Size();
+    auto& dropped = train_dropped_.predictions;
+    if (ctx_->IsCUDA()) {
+      dropped.SetDevice(ctx_->Device());
+    }
+    dropped.Resize(n);
+    dropped.Fill(0.0f);
+    if (!idx_drop_.empty()) {
+      std::vector<float> weights(n_trees, 0.0f);
+      for (auto i : idx_drop_) {
+        weights[i] = weight_drop_[i];
+      }
+      CHECK(predictor->PredictWeightedBatch(p_fmat, &train_dropped_, model_, idx_drop_.front(),
+                                            idx_drop_.back() + 1, weights));
+    }
+
+    auto& out = p_out_preds->predictions;
+    if (ctx_->IsCUDA()) {
+      out.SetDevice(ctx_->Device());
+    }
+    out.Resize(n);
+    out.Copy(train_margin_.predictions);
+    this->Axpy(-1.0f, dropped, &out);
+    p_out_preds->version = BoostedRounds();
+    return true;
+  }
+
   // commit new trees all at once
   void CommitModel(TreesOneIter&& new_trees) override {
     auto n_new_trees = model_.CommitModel(std::forward<TreesOneIter>(new_trees));
@@ -959,6 +1485,7 @@ class Dart : public GBTree {
     CHECK(tree_param_.GetInitialised());
     float lr = 1.0 * tree_param_.learning_rate / size_new_trees;
     size_t num_drop = idx_drop_.size();
+    drop_factor_ = 1.0f;
     if (num_drop == 0) {
       for (size_t i = 0; i < size_new_trees; ++i) {
         weight_drop_.push_back(1.0);
@@ -970,6 +1497,7 @@ class Dart : public GBTree {
         for (auto i : idx_drop_) {
           weight_drop_[i] *= factor;
         }
+        drop_factor_ = factor;
         for (size_t i = 0; i < size_new_trees; ++i) {
           weight_drop_.push_back(factor);
         }
@@ -979,6 +1507,7 @@ class Dart : public GBTree {
         for (auto i : idx_drop_) {
           weight_drop_[i] *= factor;
         }
+        drop_factor_ = factor;
         for (size_t i = 0; i < size_new_trees; ++i) {
           weight_drop_.push_back(1.0 / (num_drop + lr));
         }
@@ -1007,6 +1536,15 @@ class Dart : public GBTree {
   std::vector<bst_float> weight_drop_;
   // indexes of dropped trees
   std::vector<size_t> idx_drop_;
+  // The factor applied to the weights of the dropped trees by the last normalization.
+  float drop_factor_{1.0f};
+  // Prediction of all the trees for the training data.
+  PredictionCacheEntry train_margin_;
+  // Prediction of the dropped trees for the training data in the current iteration.
+  PredictionCacheEntry train_dropped_;
+  // The training data and the number of trees of the margin.
+  DMatrix const* p_train_{nullptr};
+  bst_tree_t n_margin_trees_{0};
   // temporal storage for per thread
   std::vector<RegTree::FVec> thread_temp_;
 };
@@ -30,6 +30,10 @@ void GPUDartPredictInc(common::Span<float> out_predts,
   });
 }
 
+void GPUDartAxpy(float a, common::Span<float const> x, common::Span<float> y) {
+  dh::LaunchN(y.size(), [=] XGBOOST_DEVICE(std::size_t i) { y[i] += a * x[i]; });
+}
+
 void GPUDartInplacePredictInc(common::Span<float> out_predts, common::Span<float> predts,
                               float tree_w, size_t n_rows,
                               linalg::TensorView<float const, 1> base_score, bst_group_t n_groups,
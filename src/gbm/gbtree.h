@@ -11,13 +11,17 @@
 
 #include <algorithm>
 #include <cstdint>  // std::int32_t
+#include <functional>  // for function
 #include <memory>
 #include <numeric>  // for iota
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "../common/error_msg.h"  // for LazyModel, ServingModel
+#include "../common/threadpool.h"  // for ThreadPool
 #include "../common/timer.h"
+#include "../predictor/codegen.h"  // for GenerateCode
 #include "../tree/param.h"  // TrainParam
 #include "gbtree_model.h"
 #include "xgboost/base.h"
@@ -41,10 +45,19 @@ enum class TreeProcessType : int {
   kDefault = 0,
   kUpdate = 1
 };
+
+// predictor used for CPU inference
+enum class PredictorType : int {
+  kAuto = 0,
+  kCPUPredictor = 1,
+  kQuickScorer = 2,
+  kQuantized = 3
+};
 }  // namespace xgboost
 
 DECLARE_FIELD_ENUM_CLASS(xgboost::TreeMethod);
 DECLARE_FIELD_ENUM_CLASS(xgboost::TreeProcessType);
+DECLARE_FIELD_ENUM_CLASS(xgboost::PredictorType);
 
 namespace xgboost::gbm {
 /*! \brief training parameters */
@@ -55,6 +68,14 @@ struct GBTreeTrainParam : public XGBoostParameter<GBTreeTrainParam> {
   TreeProcessType process_type;
   // tree construction method
   TreeMethod tree_method;
+  // predictor for CPU inference
+  PredictorType predictor;
+  // cache the prediction of each layer for predicting with iteration ranges
+  bool prefix_cache;
+  // save identical trees once
+  bool dedup_trees;
+  // number of trees from the same boosting round built at the same time
+  std::int32_t concurrent_trees;
   // declare parameters
   DMLC_DECLARE_PARAMETER(GBTreeTrainParam) {
     DMLC_DECLARE_FIELD(updater_seq).describe("Tree updater sequence.").set_default("");
@@ -73,6 +94,28 @@ struct GBTreeTrainParam : public XGBoostParameter<GBTreeTrainParam> {
         .add_enum("hist",      TreeMethod::kHist)
         .add_enum("gpu_hist",  TreeMethod::kGPUHist)
         .describe("Choice of tree construction method.");
+    DMLC_DECLARE_FIELD(predictor)
+        .set_default(PredictorType::kAuto)
+        .add_enum("auto", PredictorType::kAuto)
+        .add_enum("cpu_predictor", PredictorType::kCPUPredictor)
+        .add_enum("qs_predictor", PredictorType::kQuickScorer)
+        .add_enum("quantized_predictor", PredictorType::kQuantized)
+        .describe("Choice of predictor for inference on CPU.");
+    DMLC_DECLARE_FIELD(prefix_cache)
+        .set_default(false)
+        .describe("Cache the prediction of each boosted layer for DMatrix objects used in "
+                  "prediction, such that predicting with any iteration range doesn't "
+                  "traverse the trees again.");
+    DMLC_DECLARE_FIELD(dedup_trees)
+        .set_default(false)
+        .describe("Save trees with the same splits and leaf values as an earlier tree as a "
+                  "reference to that tree.");
+    DMLC_DECLARE_FIELD(concurrent_trees)
+        .set_default(1)
+        .set_lower_bound(1)
+        .describe("Number of trees from the same boosting round, one for each output group "
+                  "and each tree in the forest, built at the same time by the CPU hist tree "
+                  "method. The threads are divided between the trees.");
   }
 };
 
@@ -183,6 +226,11 @@ class GBTree : public GradientBooster {
    */
   void DoBoost(DMatrix* p_fmat, linalg::Matrix<GradientPair>* in_gpair, PredictionCacheEntry* predt,
                ObjFunction const* obj) override;
+  /**
+   * @brief Only the first updater of a single target model that grows new trees can
+   *        compute the gradient.
+   */
+  bool FuseGradient(RowGradient const* fn) override;
 
   [[nodiscard]] bool UseGPU() const override { return tparam_.tree_method == TreeMethod::kGPUHist; }
 
@@ -190,6 +238,7 @@ class GBTree : public GradientBooster {
 
   void Load(dmlc::Stream* fi) override { model_.Load(fi); }
   void Save(dmlc::Stream* fo) const override {
+    CHECK(!model_.IsLazy()) << error::LazyModel();
     model_.Save(fo);
   }
 
@@ -197,19 +246,38 @@ class GBTree : public GradientBooster {
   void SaveConfig(Json* p_out) const override;
 
   void SaveModel(Json* p_out) const override;
+  void SaveServingModel(Json* p_out) const override;
   void LoadModel(Json const& in) override;
+  void LoadStreamedModel(Json const& in, std::vector<std::unique_ptr<RegTree>>&& trees) override;
+  void SaveStreamedModel(Json* p_out, std::vector<RegTree const*>* trees) const override;
+  void LoadLazyModel(Json const& in, std::shared_ptr<TreePager> pager) override;
 
   // slice the trees, out must be already allocated
   void Slice(bst_layer_t begin, bst_layer_t end, bst_layer_t step, GradientBooster* out,
              bool* out_of_bound) const override;
+  void Append(GradientBooster const* that) override;
 
   [[nodiscard]] std::int32_t BoostedRounds() const override { return this->model_.BoostedRounds(); }
   [[nodiscard]] bool ModelFitted() const override {
-    return !model_.trees.empty() || !model_.trees_to_update.empty();
+    return !model_.trees.empty() || !model_.trees_to_update.empty() || model_.IsLazy();
   }
+  [[nodiscard]] GBTreeModel const& Model() const { return model_; }
 
   void PredictBatchImpl(DMatrix* p_fmat, PredictionCacheEntry* out_preds, bool is_training,
                         bst_layer_t layer_begin, bst_layer_t layer_end) const;
+  /**
+   * @brief Predict from the prefix sums of the layers, extend the prefix sums when needed.
+   *
+   * @return Whether the prediction is handled.
+   */
+  bool PredictFromPrefix(DMatrix* p_fmat, PredictionCacheEntry* out_preds,
+                         bst_layer_t layer_begin, bst_layer_t layer_end) const;
+  /**
+   * @brief Predict with a lazily loaded model, the trees are loaded by pages.
+   */
+  void PredictLazy(std::unique_ptr<Predictor> const& predictor, DMatrix* p_fmat,
+                   PredictionCacheEntry* out_preds, bst_layer_t layer_begin,
+                   bst_layer_t layer_end) const;
 
   void PredictBatch(DMatrix* p_fmat, PredictionCacheEntry* out_preds, bool training,
                     bst_layer_t layer_begin, bst_layer_t layer_end) override;
@@ -217,71 +285,63 @@ class GBTree : public GradientBooster {
   void InplacePredict(std::shared_ptr<DMatrix> p_m, float missing, PredictionCacheEntry* out_preds,
                       bst_layer_t layer_begin, bst_layer_t layer_end) const override;
 
+  void PredictDense(float const* data, bst_idx_t n_rows, float missing, bst_layer_t layer_begin,
+                    bst_layer_t layer_end, HostDeviceVector<float>* out_preds) const override;
+
+  void PrepareDense(bst_idx_t n_rows, bst_layer_t layer_begin, bst_layer_t layer_end,
+                    HostDeviceVector<float>* out_preds, DenseModelSlice* out_slice) const override;
+
+  void PredictCascade(DMatrix* p_fmat, float missing, bst_layer_t layer_begin,
+                      bst_layer_t layer_end, std::vector<bst_layer_t> const& checkpoints,
+                      std::vector<float> const& thresholds, HostDeviceVector<float>* out_preds,
+                      HostDeviceVector<std::uint8_t>* finished) const override;
+
   void FeatureScore(std::string const& importance_type, common::Span<int32_t const> trees,
                     std::vector<bst_feature_t>* features,
                     std::vector<float>* scores) const override {
-    // Because feature with no importance doesn't appear in the return value so
-    // we need to set up another pair of vectors to store the values during
-    // computation.
-    std::vector<size_t> split_counts(this->model_.learner_model_param->num_feature, 0);
-    std::vector<float> gain_map(this->model_.learner_model_param->num_feature, 0);
-    std::vector<int32_t> tree_idx;
-    if (trees.empty()) {
-      tree_idx.resize(this->model_.trees.size());
-      std::iota(tree_idx.begin(), tree_idx.end(), 0);
-      trees = common::Span<int32_t const>(tree_idx);
-    }
-
-    auto total_n_trees = model_.trees.size();
-    auto add_score = [&](auto fn) {
-      for (auto idx : trees) {
-        CHECK_LE(idx, total_n_trees) << "Invalid tree index.";
-        auto const& tree = *model_.trees[idx];
-        tree.WalkTree([&](bst_node_t nidx) {
-          if (!tree.IsLeaf(nidx)) {
-            split_counts[tree.SplitIndex(nidx)]++;
-            fn(tree, nidx, tree.SplitIndex(nidx));
-          }
-          return true;
-        });
-      }
-    };
-
-    if (importance_type == "weight") {
-      add_score([&](auto const&, bst_node_t, bst_feature_t split) {
-        gain_map[split] = split_counts[split];
-      });
-    } else if (importance_type == "gain" || importance_type == "total_gain") {
-      if (!model_.trees.empty() && model_.trees.front()->IsMultiTarget()) {
-        LOG(FATAL) << "gain/total_gain " << MTNotImplemented();
-      }
-      add_score([&](auto const& tree, bst_node_t nidx, bst_feature_t split) {
-        gain_map[split] += tree.Stat(nidx).loss_chg;
-      });
-    } else if (importance_type == "cover" || importance_type == "total_cover") {
-      if (!model_.trees.empty() && model_.trees.front()->IsMultiTarget()) {
-        LOG(FATAL) << "cover/total_cover " << MTNotImplemented();
-      }
-      add_score([&](auto const& tree, bst_node_t nidx, bst_feature_t split) {
-        gain_map[split] += tree.Stat(nidx).sum_hess;
-      });
-    } else {
-      LOG(FATAL)
+    CHECK(!model_.IsLazy()) << error::LazyModel();
+    bool has_stats = importance_type != "weight";
+    if (has_stats) {
+      CHECK(importance_type == "gain" || importance_type == "total_gain" ||
+            importance_type == "cover" || importance_type == "total_cover")
           << "Unknown feature importance type, expected one of: "
           << R"({"weight", "total_gain", "total_cover", "gain", "cover"}, got: )"
           << importance_type;
+      CHECK(!model_.serving) << error::ServingModel();
+      if (!model_.trees.empty() && model_.trees.front()->IsMultiTarget()) {
+        LOG(FATAL) << importance_type << " " << MTNotImplemented();
+      }
     }
-    if (importance_type == "gain" || importance_type == "cover") {
-      for (size_t i = 0; i < gain_map.size(); ++i) {
-        gain_map[i] /= std::max(1.0f, static_cast<float>(split_counts[i]));
+    // The statistics of all the trees are maintained by the model, only a selection of
+    // trees needs a walk.
+    FeatureSplitStats stats;
+    if (trees.empty()) {
+      stats = model_.FeatureStats();
+    } else {
+      auto total_n_trees = model_.trees.size();
+      for (auto idx : trees) {
+        CHECK_LE(idx, total_n_trees) << "Invalid tree index.";
+        stats.Add(*model_.trees[idx]);
       }
     }
 
+    auto const& gain_map = importance_type == "gain" || importance_type == "total_gain"
+                               ? stats.gain
+                               : stats.cover;
+    bool average = importance_type == "gain" || importance_type == "cover";
     features->clear();
     scores->clear();
-    for (size_t i = 0; i < split_counts.size(); ++i) {
-      if (split_counts[i] != 0) {
-        features->push_back(i);
+    for (std::size_t i = 0; i < stats.n_splits.size(); ++i) {
+      auto n_splits = stats.n_splits[i];
+      if (n_splits == 0) {
+        continue;
+      }
+      features->push_back(i);
+      if (!has_stats) {
+        scores->push_back(n_splits);
+      } else if (average) {
+        scores->push_back(gain_map[i] / std::max(1.0f, static_cast<float>(n_splits)));
+      } else {
         scores->push_back(gain_map[i]);
       }
     }
@@ -290,15 +350,22 @@ class GBTree : public GradientBooster {
   void PredictLeaf(DMatrix* p_fmat,
                    HostDeviceVector<bst_float>* out_preds,
                    uint32_t layer_begin, uint32_t layer_end) override {
+    CHECK(!model_.IsLazy()) << error::LazyModel();
     auto [tree_begin, tree_end] = detail::LayerToTree(model_, layer_begin, layer_end);
     CHECK_EQ(tree_begin, 0) << "Predict leaf supports only iteration end: (0, "
                                "n_iteration), use model slicing instead.";
     this->GetPredictor(false)->PredictLeaf(p_fmat, out_preds, model_, tree_end);
   }
 
+  void PredictLeafMargin(DMatrix* p_fmat, HostDeviceVector<float>* out_leaf,
+                         HostDeviceVector<float>* out_margin, bst_layer_t layer_begin,
+                         bst_layer_t layer_end) override;
+
   void PredictContribution(DMatrix* p_fmat, HostDeviceVector<float>* out_contribs,
                            bst_layer_t layer_begin, bst_layer_t layer_end,
                            bool approximate) override {
+    CHECK(!model_.IsLazy()) << error::LazyModel();
+    CHECK(!model_.serving) << error::ServingModel();
     auto [tree_begin, tree_end] = detail::LayerToTree(model_, layer_begin, layer_end);
     CHECK_EQ(tree_begin, 0) << "Predict contribution supports only iteration end: (0, "
                                "n_iteration), using model slicing instead.";
@@ -309,6 +376,8 @@ class GBTree : public GradientBooster {
   void PredictInteractionContributions(DMatrix* p_fmat, HostDeviceVector<float>* out_contribs,
                                        bst_layer_t layer_begin, bst_layer_t layer_end,
                                        bool approximate) override {
+    CHECK(!model_.IsLazy()) << error::LazyModel();
+    CHECK(!model_.serving) << error::ServingModel();
     auto [tree_begin, tree_end] = detail::LayerToTree(model_, layer_begin, layer_end);
     CHECK_EQ(tree_begin, 0) << "Predict interaction contribution supports only iteration end: (0, "
                                "n_iteration), using model slicing instead.";
@@ -318,13 +387,36 @@ class GBTree : public GradientBooster {
 
   [[nodiscard]] std::vector<std::string> DumpModel(const FeatureMap& fmap, bool with_stats,
                                                    std::string format) const override {
+    CHECK(!model_.IsLazy()) << error::LazyModel();
     return model_.DumpModel(fmap, with_stats, this->ctx_->Threads(), format);
   }
+  void DumpModelTo(FeatureMap const& fmap, bool with_stats, std::string format,
+                   std::function<bool(std::string const&)> const& fn) const override {
+    CHECK(!model_.IsLazy()) << error::LazyModel();
+    model_.DumpModel(fmap, with_stats, this->ctx_->Threads(), format, fn);
+  }
+
+  [[nodiscard]] std::string GenerateCode(bst_layer_t layer_begin,
+                                         bst_layer_t layer_end) const override {
+    CHECK(!model_.IsLazy()) << error::LazyModel();
+    auto [tree_begin, tree_end] = detail::LayerToTree(model_, layer_begin, layer_end);
+    return predictor::GenerateCode(model_, tree_begin, tree_end);
+  }
 
  protected:
   void BoostNewTrees(linalg::Matrix<GradientPair>* gpair, DMatrix* p_fmat, int bst_group,
                      std::vector<HostDeviceVector<bst_node_t>>* out_position,
                      std::vector<std::unique_ptr<RegTree>>* ret);
+  /**
+   * @brief Build all trees of a boosting round at the same time, each tree is built by a
+   *        worker with a share of the threads. The trees are assigned to the workers in a
+   *        round robin manner, so the result doesn't depend on the scheduling.
+   *
+   * @return False if the model or the data is not supported, nothing is built.
+   */
+  bool BoostConcurrentTrees(linalg::Matrix<GradientPair> const* in_gpair, DMatrix* p_fmat,
+                            ObjFunction const* obj, linalg::MatrixView<float> out,
+                            PredictionCacheEntry* predt, TreesOneIter* out_trees);
 
   [[nodiscard]] std::unique_ptr<Predictor> const& GetPredictor(
       bool is_training, HostDeviceVector<float> const* out_pred = nullptr,
@@ -344,10 +436,28 @@ class GBTree : public GradientBooster {
   std::vector<std::unique_ptr<TreeUpdater>> updaters_;
   // Predictors
   std::unique_ptr<Predictor> cpu_predictor_;
+  PredictorType cpu_predictor_type_{PredictorType::kAuto};
   std::unique_ptr<Predictor> gpu_predictor_{nullptr};
 #if defined(XGBOOST_USE_SYCL)
   std::unique_ptr<Predictor> sycl_predictor_;
 #endif  // defined(XGBOOST_USE_SYCL)
+  // Buffers reused by each boosting iteration.
+  // The node position for each row, 1 HDV for each tree in the forest.  Note that the
+  // position is negated if the row is sampled out.
+  std::vector<HostDeviceVector<bst_node_t>> node_position_;
+  // Gradient of a single output group for multi-class models.
+  linalg::Matrix<GradientPair> group_gpair_;
+  // Workers for building trees of the same round concurrently.
+  struct TreeWorker {
+    Context ctx;
+    tree::TrainParam param;
+    std::unique_ptr<TreeUpdater> updater;
+    linalg::Matrix<GradientPair> gpair;
+    std::vector<HostDeviceVector<bst_node_t>> position;
+  };
+  // The updater holds pointers to the context, the worker is not movable.
+  std::vector<std::unique_ptr<TreeWorker>> tree_workers_;
+  std::unique_ptr<common::ThreadPool> tree_pool_;
   common::Monitor monitor_;
 };
 
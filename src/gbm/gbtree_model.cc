@@ -3,19 +3,32 @@
  */
 #include "gbtree_model.h"
 
-#include <algorithm>                    // for transform, max_element
+#include <algorithm>                    // for transform, max_element, find_if, min, max
+#include <atomic>                       // for atomic
 #include <cstddef>                      // for size_t
+#include <cstdint>                      // for uint64_t, int64_t
+#include <functional>                   // for hash, function
+#include <iterator>                     // for make_move_iterator
+#include <memory>                       // for unique_ptr, make_unique, make_shared, shared_ptr
+#include <mutex>                        // for lock_guard
 #include <numeric>                      // for partial_sum
 #include <ostream>                      // for operator<<, basic_ostream
+#include <string>                       // for string
+#include <string_view>                  // for string_view
+#include <unordered_map>                // for unordered_map
 #include <utility>                      // for move, pair
+#include <vector>                       // for vector
 
 #include "../common/threading_utils.h"  // for ParallelFor
 #include "dmlc/base.h"                  // for BeginPtr
+#include "tree_pager.h"                 // for TreePager
 #include "dmlc/io.h"                    // for Stream
 #include "xgboost/context.h"            // for Context
 #include "xgboost/json.h"               // for Json, get, Integer, Array, FromJson, ToJson, Json...
+#include "xgboost/json_io.h"            // for UBJReader
 #include "xgboost/learner.h"            // for LearnerModelParam
 #include "xgboost/logging.h"            // for LogCheck_EQ, CHECK_EQ, CHECK
+#include "xgboost/string_view.h"        // for StringView
 #include "xgboost/tree_model.h"         // for RegTree
 
 namespace xgboost::gbm {
@@ -43,13 +56,296 @@ void MakeIndptr(GBTreeModel* out_model) {
 
 // Validate the consistency of the model.
 void Validate(GBTreeModel const& model) {
-  CHECK_EQ(model.trees.size(), model.param.num_trees);
+  if (model.IsLazy()) {
+    CHECK(model.trees.empty());
+    CHECK_EQ(model.pager->NumTrees(), model.param.num_trees);
+  } else {
+    CHECK_EQ(model.trees.size(), model.param.num_trees);
+  }
   CHECK_EQ(model.tree_info.size(), model.param.num_trees);
   // True even if the model is empty since we should always have 0 as the first element.
   CHECK_EQ(model.iteration_indptr.back(), model.param.num_trees);
 }
+
+// The key of a tree saved as a reference to an earlier tree with the same splits.
+std::string const kSharedTree{"shared"};
+// Set when the model is saved without the node statistics.
+std::string const kServing{"serving"};
+
+// Get the index of the referenced tree if the tree is saved as a reference, -1 otherwise.
+[[nodiscard]] bst_tree_t SharedSource(Json const& jtree) {
+  auto const& obj = get<Object const>(jtree);
+  auto it = obj.find(kSharedTree);
+  return it == obj.cend() ? -1 : static_cast<bst_tree_t>(get<Integer const>(it->second));
+}
+
+// Copy the referenced tree and load the statistics of a tree saved as a reference. The
+// referenced tree must be loaded first.
+void LoadSharedTree(Json const& jtree, TreesOneGroup* p_trees) {
+  auto& trees = *p_trees;
+  auto tree_id = get<Integer const>(jtree["id"]);
+  auto source = SharedSource(jtree);
+  CHECK_GE(tree_id, 0);
+  CHECK_LT(tree_id, static_cast<bst_tree_t>(trees.size()));
+  CHECK(!trees[tree_id]) << "Duplicated tree id: " << tree_id;
+  CHECK_GE(source, 0);
+  CHECK_LT(source, static_cast<bst_tree_t>(trees.size()));
+  CHECK(trees[source]) << "Invalid reference to tree " << source << " in tree " << tree_id;
+  trees[tree_id] = std::make_unique<RegTree>(*trees[source]);
+  trees[tree_id]->LoadStats(jtree);
+}
+
+// Find the first tree with the same splits for each tree, -1 if the tree is the first
+// one.
+[[nodiscard]] std::vector<bst_tree_t> FindSharedTrees(Context const* ctx,
+                                                      SharedTrees const& trees) {
+  auto n_trees = static_cast<bst_tree_t>(trees.size());
+  std::vector<std::size_t> hashes(trees.size());
+  common::ParallelFor(trees.size(), ctx->Threads(), [&](auto t) {
+    auto const& nodes = trees[t]->GetNodes();
+    auto n_bytes = nodes.size() * sizeof(RegTree::Node);
+    hashes[t] = std::hash<std::string_view>{}(
+        std::string_view{reinterpret_cast<char const*>(nodes.data()), n_bytes});
+  });
+
+  std::vector<bst_tree_t> shared(trees.size(), -1);
+  // Trees with different splits might have the same hash.
+  std::unordered_map<std::size_t, std::vector<bst_tree_t>> buckets;
+  for (bst_tree_t t = 0; t < n_trees; ++t) {
+    if (trees[t]->IsMultiTarget()) {
+      continue;
+    }
+    auto& bucket = buckets[hashes[t]];
+    auto it = std::find_if(bucket.cbegin(), bucket.cend(),
+                           [&](bst_tree_t s) { return trees[s]->SameSplits(*trees[t]); });
+    if (it == bucket.cend()) {
+      bucket.push_back(t);
+    } else {
+      shared[t] = *it;
+    }
+  }
+  return shared;
+}
+
+/**
+ * @brief UBJSON reader that loads the trees of a model as they are parsed. The JSON
+ *        objects of the trees are released once a batch of trees is loaded.
+ */
+class TreeStreamReader : public UBJReader {
+  // Number of trees buffered for each thread before they are loaded.
+  static constexpr std::size_t kTreesPerThread = 4;
+
+  Context const* ctx_;
+  TreesOneGroup* p_trees_;
+  // Keys of the objects enclosing the value being parsed.
+  std::vector<std::string> path_;
+  // Byte ranges of the trees waiting to be parsed.
+  std::vector<std::pair<std::size_t, std::size_t>> batch_;
+  std::vector<std::pair<bst_tree_t, std::unique_ptr<RegTree>>> loaded_;
+  // Trees saved as references, they are loaded after all other trees.
+  std::vector<Json> shared_;
+
+  // learner/gradient_booster/model/trees, dart has an additional gbtree object.
+  [[nodiscard]] bool InTrees() const {
+    auto n = path_.size();
+    return n >= 4 && path_.front() == "learner" && path_[n - 2] == "model" &&
+           path_[n - 1] == "trees";
+  }
+
+  void Flush() {
+    auto n = batch_.size();
+    auto offset = loaded_.size();
+    loaded_.resize(offset + n);
+    std::vector<Json> shared(n);
+    common::ParallelFor(n, ctx_->Threads(), [&](auto i) {
+      auto& [tree_id, tree] = loaded_[offset + i];
+      auto [beg, end] = batch_[i];
+      UBJReader reader{StringView{raw_str_.c_str() + beg, end - beg}};
+      auto jtree = reader.Load();
+      tree_id = get<Integer const>(jtree["id"]);
+      if (SharedSource(jtree) != -1) {
+        shared[i] = std::move(jtree);
+        return;
+      }
+      tree = std::make_unique<RegTree>();
+      tree->LoadModel(jtree);
+    });
+    for (auto& jtree : shared) {
+      if (!IsA<Null>(jtree)) {
+        shared_.emplace_back(std::move(jtree));
+      }
+    }
+    batch_.clear();
+  }
+
+  Json ParseTrees() {
+    std::int64_t n_trees{-1};
+    if (PeekNextChar() == '#') {  // array with length optimization
+      GetNextChar();
+      GetConsecutiveChar('L');
+      n_trees = this->ReadPrimitive<std::int64_t>();
+    }
+    auto batch_size = static_cast<std::size_t>(ctx_->Threads()) * kTreesPerThread;
+    for (std::int64_t i = 0; n_trees < 0 ? PeekNextChar() != ']' : i < n_trees; ++i) {
+      // Only find the boundary of the tree here, the parsing is done in parallel.
+      auto beg = cursor_.Pos();
+      this->SkipValue();
+      batch_.emplace_back(beg, cursor_.Pos());
+      if (batch_.size() == batch_size) {
+        this->Flush();
+      }
+    }
+    if (n_trees < 0) {
+      GetConsecutiveChar(']');
+    }
+    this->Flush();
+
+    auto& trees = *p_trees_;
+    CHECK(trees.empty()) << "Found multiple tree arrays in the model.";
+    trees.resize(loaded_.size());
+    for (auto& [tree_id, tree] : loaded_) {
+      CHECK_GE(tree_id, 0);
+      CHECK_LT(tree_id, static_cast<bst_tree_t>(trees.size()));
+      if (!tree) {
+        continue;
+      }
+      CHECK(!trees[tree_id]) << "Duplicated tree id: " << tree_id;
+      trees[tree_id] = std::move(tree);
+    }
+    for (auto const& jtree : shared_) {
+      LoadSharedTree(jtree, &trees);
+    }
+    loaded_.clear();
+    shared_.clear();
+    return Json{Array{}};
+  }
+
+ protected:
+  Json ParseArray() override {
+    if (!this->InTrees() || PeekNextChar() == '$') {
+      return UBJReader::ParseArray();
+    }
+    return this->ParseTrees();
+  }
+
+  Json ParseObject() override {
+    auto marker = PeekNextChar();
+    std::vector<Object::Map::value_type> results;
+
+    while (marker != '}') {
+      path_.emplace_back(this->DecodeStr());
+      auto value = this->Parse();
+      results.emplace_back(std::move(path_.back()), std::move(value));
+      path_.pop_back();
+      marker = PeekNextChar();
+    }
+
+    GetConsecutiveChar('}');
+    return Json{Object{Object::Map{std::move(results)}}};
+  }
+
+ public:
+  TreeStreamReader(Context const* ctx, StringView str, TreesOneGroup* p_trees)
+      : UBJReader{str}, ctx_{ctx}, p_trees_{p_trees} {}
+};
 }  // namespace
 
+Json LoadUBJModel(Context const* ctx, StringView str, TreesOneGroup* p_trees) {
+  CHECK(p_trees->empty());
+  TreeStreamReader reader{ctx, str, p_trees};
+  return Json::Load(&reader);
+}
+
+void FeatureSplitStats::Add(RegTree const& tree) {
+  bool has_stats = !tree.IsMultiTarget();
+  tree.WalkTree([&](bst_node_t nidx) {
+    if (tree.IsLeaf(nidx)) {
+      return true;
+    }
+    auto split = tree.SplitIndex(nidx);
+    if (n_splits.size() <= split) {
+      n_splits.resize(split + 1, 0);
+      gain.resize(split + 1, 0.0f);
+      cover.resize(split + 1, 0.0f);
+    }
+    n_splits[split]++;
+    if (has_stats) {
+      gain[split] += tree.Stat(nidx).loss_chg;
+      cover[split] += tree.Stat(nidx).sum_hess;
+    }
+    return true;
+  });
+}
+
+FeatureSplitStats GBTreeModel::FeatureStats() const {
+  std::lock_guard guard{*stats_lock_};
+  if (stats_version_ != version_) {
+    stats_ = FeatureSplitStats{};
+    for (auto const& tree : trees) {
+      stats_.Add(*tree);
+    }
+    stats_version_ = version_;
+  }
+  return stats_;
+}
+
+namespace {
+float FillNodeMeanValues(RegTree const& tree, bst_node_t nidx, std::vector<float>* mean_values) {
+  float result;
+  auto const& node = tree[nidx];
+  if (node.IsLeaf()) {
+    result = node.LeafValue();
+  } else {
+    result = FillNodeMeanValues(tree, node.LeftChild(), mean_values) *
+             tree.Stat(node.LeftChild()).sum_hess;
+    result += FillNodeMeanValues(tree, node.RightChild(), mean_values) *
+              tree.Stat(node.RightChild()).sum_hess;
+    result /= tree.Stat(nidx).sum_hess;
+  }
+  (*mean_values)[nidx] = result;
+  return result;
+}
+}  // anonymous namespace
+
+void NodeMeanValues::Add(Context const* ctx, SharedTrees const& trees, std::size_t begin) {
+  CHECK_EQ(values.size(), begin);
+  values.resize(trees.size());
+  max_depth.resize(trees.size());
+  common::ParallelFor(trees.size() - begin, ctx->Threads(), [&](auto i) {
+    auto const& tree = *trees[begin + i];
+    if (tree.IsMultiTarget()) {
+      return;
+    }
+    auto& tree_values = values[begin + i];
+    tree_values.resize(tree.NumNodes());
+    FillNodeMeanValues(tree, RegTree::kRoot, &tree_values);
+    max_depth[begin + i] = tree.MaxDepth(RegTree::kRoot);
+  });
+}
+
+std::shared_ptr<NodeMeanValues const> GBTreeModel::MeanValues() const {
+  std::lock_guard guard{*stats_lock_};
+  if (!means_ || means_version_ != version_) {
+    auto means = std::make_shared<NodeMeanValues>();
+    means->Add(ctx_, trees, 0);
+    means_ = std::move(means);
+    means_version_ = version_;
+  } else if (means_->values.size() < trees.size()) {
+    // Copy instead of appending in place, the old values might be in use.
+    auto means = std::make_shared<NodeMeanValues>(*means_);
+    means->Add(ctx_, trees, means->values.size());
+    means_ = std::move(means);
+  }
+  return means_;
+}
+
+void GBTreeModel::BumpVersion() {
+  // Shared by all models so that a version is never reused by another model allocated at
+  // the same address.
+  static std::atomic<std::uint64_t> n_versions{0};
+  version_ = ++n_versions;
+}
+
 void GBTreeModel::Save(dmlc::Stream* fo) const {
   CHECK_EQ(param.num_trees, static_cast<int32_t>(trees.size()));
 
@@ -83,6 +379,8 @@ void GBTreeModel::Load(dmlc::Stream* fi) {
   }
   trees.clear();
   trees_to_update.clear();
+  pager.reset();
+  serving = false;
   for (int32_t i = 0; i < param.num_trees; ++i) {
     std::unique_ptr<RegTree> ptr(new RegTree());
     ptr->Load(fi);
@@ -104,58 +402,119 @@ void GBTreeModel::Load(dmlc::Stream* fi) {
 
   MakeIndptr(this);
   Validate(*this);
+  this->BumpVersion();
 }
 
-void GBTreeModel::SaveModel(Json* p_out) const {
-  auto& out = *p_out;
-  CHECK_EQ(param.num_trees, static_cast<int>(trees.size()));
-  out["gbtree_model_param"] = ToJson(param);
+void GBTreeModel::SaveModel(Json* p_out) const { this->SaveModel(p_out, false); }
+
+void GBTreeModel::SaveModel(Json* p_out, bool dedup_trees, bool with_stats) const {
+  this->SaveModel(p_out, nullptr);
+  if (!with_stats) {
+    (*p_out)[kServing] = Boolean{true};
+  }
   std::vector<Json> trees_json(trees.size());
+  std::vector<bst_tree_t> shared;
+  if (dedup_trees) {
+    shared = FindSharedTrees(ctx_, trees);
+  }
 
   common::ParallelFor(trees.size(), ctx_->Threads(), [&](auto t) {
     auto const& tree = trees[t];
     Json jtree{Object{}};
-    tree->SaveModel(&jtree);
+    if (!shared.empty() && shared[t] != -1) {
+      jtree[kSharedTree] = Integer{static_cast<Integer::Int>(shared[t])};
+      if (with_stats) {
+        tree->SaveStats(&jtree);
+      }
+    } else if (with_stats) {
+      tree->SaveModel(&jtree);
+    } else {
+      tree->SaveServingModel(&jtree);
+    }
     jtree["id"] = Integer{static_cast<Integer::Int>(t)};
     trees_json[t] = std::move(jtree);
   });
+  (*p_out)["trees"] = Array(std::move(trees_json));
+}
+
+void GBTreeModel::SaveModel(Json* p_out, std::vector<RegTree const*>* p_trees) const {
+  auto& out = *p_out;
+  CHECK_EQ(param.num_trees, static_cast<int>(trees.size()));
+  out["gbtree_model_param"] = ToJson(param);
+  if (p_trees) {
+    p_trees->resize(trees.size());
+    std::transform(trees.cbegin(), trees.cend(), p_trees->begin(),
+                   [](auto const& tree) { return tree.get(); });
+  }
 
   std::vector<Json> tree_info_json(tree_info.size());
   for (size_t i = 0; i < tree_info.size(); ++i) {
     tree_info_json[i] = Integer(tree_info[i]);
   }
 
-  out["trees"] = Array(std::move(trees_json));
+  out["trees"] = Array{};
   out["tree_info"] = Array(std::move(tree_info_json));
 
   std::vector<Json> jiteration_indptr(iteration_indptr.size());
   std::transform(iteration_indptr.cbegin(), iteration_indptr.cend(), jiteration_indptr.begin(),
                  [](bst_tree_t i) { return Integer{i}; });
   out["iteration_indptr"] = Array{std::move(jiteration_indptr)};
+  if (serving) {
+    out[kServing] = Boolean{true};
+  }
 }
 
 void GBTreeModel::LoadModel(Json const& in) {
+  auto const& trees_json = get<Array const>(in["trees"]);
+  TreesOneGroup trees(trees_json.size());
+  common::ParallelFor(trees_json.size(), ctx_->Threads(), [&](auto t) {
+    if (SharedSource(trees_json[t]) != -1) {
+      return;
+    }
+    auto tree_id = get<Integer const>(trees_json[t]["id"]);
+    trees.at(tree_id).reset(new RegTree{});
+    trees[tree_id]->LoadModel(trees_json[t]);
+  });
+  for (auto const& jtree : trees_json) {
+    if (SharedSource(jtree) != -1) {
+      LoadSharedTree(jtree, &trees);
+    }
+  }
+  this->LoadModel(in, std::move(trees));
+}
+
+void GBTreeModel::LoadModel(Json const& in, TreesOneGroup&& loaded) {
   FromJson(in["gbtree_model_param"], &param);
 
   trees.clear();
   trees_to_update.clear();
+  pager.reset();
 
-  auto const& jmodel = get<Object const>(in);
+  CHECK_EQ(loaded.size(), param.num_trees);
+  for (auto const& tree : loaded) {
+    CHECK(tree) << "Missing or duplicated tree id.";
+  }
+  trees.assign(std::make_move_iterator(loaded.begin()), std::make_move_iterator(loaded.end()));
+  this->LoadLayout(in);
+}
 
-  auto const& trees_json = get<Array const>(in["trees"]);
-  CHECK_EQ(trees_json.size(), param.num_trees);
-  trees.resize(param.num_trees);
+void GBTreeModel::LoadLazyModel(Json const& in, std::shared_ptr<TreePager> p_pager) {
+  FromJson(in["gbtree_model_param"], &param);
+
+  trees.clear();
+  trees_to_update.clear();
+  CHECK(p_pager);
+  pager = std::move(p_pager);
+  this->LoadLayout(in);
+  pager->Init(ctx_, *this);
+}
 
+void GBTreeModel::LoadLayout(Json const& in) {
+  auto const& jmodel = get<Object const>(in);
   auto const& tree_info_json = get<Array const>(in["tree_info"]);
   CHECK_EQ(tree_info_json.size(), param.num_trees);
   tree_info.resize(param.num_trees);
 
-  common::ParallelFor(param.num_trees, ctx_->Threads(), [&](auto t) {
-    auto tree_id = get<Integer const>(trees_json[t]["id"]);
-    trees.at(tree_id).reset(new RegTree{});
-    trees[tree_id]->LoadModel(trees_json[t]);
-  });
-
   for (bst_tree_t i = 0; i < param.num_trees; ++i) {
     tree_info[i] = get<Integer const>(tree_info_json[i]);
   }
@@ -170,14 +529,42 @@ void GBTreeModel::LoadModel(Json const& in) {
   } else {
     MakeIndptr(this);
   }
+  auto serving_it = jmodel.find(kServing);
+  serving = serving_it != jmodel.cend() && get<Boolean const>(serving_it->second);
 
   Validate(*this);
+  this->BumpVersion();
+}
+
+void GBTreeModel::DumpModel(FeatureMap const& fmap, bool with_stats, std::int32_t n_threads,
+                            std::string const& format,
+                            std::function<bool(std::string const&)> const& fn) const {
+  auto n_trees = trees.size();
+  // A few trees for each thread to amortize the cost of launching the parallel loop.
+  std::size_t const chunk_size = std::max(n_threads, 1) * 8;
+  std::vector<std::string> chunk;
+  for (std::size_t begin = 0; begin < n_trees; begin += chunk_size) {
+    auto n = std::min(chunk_size, n_trees - begin);
+    chunk.resize(n);
+    common::ParallelFor(n, n_threads, [&](std::size_t i) {
+      chunk[i] = trees[begin + i]->DumpModel(fmap, with_stats, format);
+    });
+    for (auto& str : chunk) {
+      if (!fn(str)) {
+        return;
+      }
+      // Release the memory as soon as it's consumed.
+      std::string{}.swap(str);
+    }
+  }
 }
 
 bst_tree_t GBTreeModel::CommitModel(TreesOneIter&& new_trees) {
   CHECK(!iteration_indptr.empty());
   CHECK_EQ(iteration_indptr.back(), param.num_trees);
   bst_tree_t n_new_trees{0};
+  auto n_old_trees = trees.size();
+  auto version_before_commit = version_;
 
   if (learner_model_param->IsVectorLeaf()) {
     n_new_trees += new_trees.front().size();
@@ -191,6 +578,20 @@ bst_tree_t GBTreeModel::CommitModel(TreesOneIter&& new_trees) {
 
   iteration_indptr.push_back(n_new_trees + iteration_indptr.back());
   Validate(*this);
+  {
+    // Accumulate the statistics of the new trees if the existing ones are up to date.
+    std::lock_guard guard{*stats_lock_};
+    if (stats_version_ == version_before_commit) {
+      for (auto i = n_old_trees; i < trees.size(); ++i) {
+        stats_.Add(*trees[i]);
+      }
+      stats_version_ = version_;
+    }
+    // The mean values of the new trees are computed in the next call.
+    if (means_version_ == version_before_commit) {
+      means_version_ = version_;
+    }
+  }
   return n_new_trees;
 }
 }  // namespace xgboost::gbm
@@ -11,9 +11,13 @@
 #include <xgboost/learner.h>
 #include <xgboost/model.h>
 #include <xgboost/parameter.h>
+#include <xgboost/string_view.h>
 #include <xgboost/tree_model.h>
 
+#include <cstdint>  // for uint64_t
+#include <functional>  // for function
 #include <memory>
+#include <mutex>    // for mutex
 #include <string>
 #include <utility>
 #include <vector>
@@ -25,6 +29,7 @@ namespace xgboost {
 class Json;
 
 namespace gbm {
+class TreePager;
 /**
  * \brief Container for all trees built (not update) for one group.
  */
@@ -33,6 +38,11 @@ using TreesOneGroup = std::vector<std::unique_ptr<RegTree>>;
  * \brief Container for all trees built (not update) for one iteration.
  */
 using TreesOneIter = std::vector<TreesOneGroup>;
+/**
+ * @brief Trees committed to a model. A sliced model shares the trees with the original
+ *        model, the trees must be copied before being modified.
+ */
+using SharedTrees = std::vector<std::shared_ptr<RegTree>>;
 
 /*! \brief model parameters */
 struct GBTreeModelParam : public dmlc::Parameter<GBTreeModelParam> {
@@ -81,10 +91,41 @@ struct GBTreeModelParam : public dmlc::Parameter<GBTreeModelParam> {
   }
 };
 
+/**
+ * \brief Split statistics of each feature summed over trees, indexed by the feature. Used
+ *        for the feature importance.
+ */
+struct FeatureSplitStats {
+  std::vector<std::size_t> n_splits;
+  // Sum of the loss change and the hessian of the split nodes. Not available for
+  // multi-target trees.
+  std::vector<float> gain;
+  std::vector<float> cover;
+
+  void Add(RegTree const& tree);
+};
+
+/**
+ * \brief Expected value of each node, weighted by the hessian, and the depth of each tree.
+ *        Used as the reference values of the feature contributions. Empty for multi-target
+ *        trees.
+ */
+struct NodeMeanValues {
+  std::vector<std::vector<float>> values;
+  std::vector<bst_node_t> max_depth;
+
+  // Append the trees starting from `begin`.
+  void Add(Context const* ctx, SharedTrees const& trees,
+           std::size_t begin);
+};
+
 struct GBTreeModel : public Model {
  public:
   explicit GBTreeModel(LearnerModelParam const* learner_model, Context const* ctx)
-      : learner_model_param{learner_model}, ctx_{ctx} {}
+      : learner_model_param{learner_model}, ctx_{ctx} {
+    this->BumpVersion();
+    stats_version_ = version_;
+  }
   void Configure(const Args& cfg) {
     // initialize model parameters if not yet been initialized.
     if (trees.size() == 0) {
@@ -94,8 +135,9 @@ struct GBTreeModel : public Model {
 
   void InitTreesToUpdate() {
     if (trees_to_update.size() == 0u) {
-      for (auto & tree : trees) {
-        trees_to_update.push_back(std::move(tree));
+      // The trees might be shared with a slice of the model.
+      for (auto const& tree : trees) {
+        trees_to_update.push_back(std::make_unique<RegTree>(*tree));
       }
       trees.clear();
       param.num_trees = 0;
@@ -103,6 +145,7 @@ struct GBTreeModel : public Model {
 
       iteration_indptr.clear();
       iteration_indptr.push_back(0);
+      this->BumpVersion();
     }
   }
 
@@ -110,7 +153,36 @@ struct GBTreeModel : public Model {
   void Save(dmlc::Stream* fo) const;
 
   void SaveModel(Json* p_out) const override;
+  /**
+   * @brief Save the model. When `dedup_trees` is true, a tree that has the same splits and
+   *        leaf values as an earlier tree is saved as a reference to it, along with its own
+   *        node statistics.
+   */
+  void SaveModel(Json* p_out, bool dedup_trees) const { this->SaveModel(p_out, dedup_trees, true); }
+  /**
+   * @brief Save the model, the node statistics are left out when `with_stats` is false.
+   *        See @ref RegTree::SaveServingModel.
+   */
+  void SaveModel(Json* p_out, bool dedup_trees, bool with_stats) const;
+  /**
+   * @brief Save the model without serializing the trees, the `trees` field is left empty.
+   */
+  void SaveModel(Json* p_out, std::vector<RegTree const*>* p_trees) const;
   void LoadModel(Json const& p_out) override;
+  /**
+   * @brief Load the model from a document produced by @ref LoadUBJModel, where the trees
+   *        have been loaded separately and the `trees` field is empty.
+   */
+  void LoadModel(Json const& in, TreesOneGroup&& trees);
+  /**
+   * @brief Load the model from a document without trees, the trees are loaded on demand
+   *        by `pager`. Only prediction by layers through the pager is supported.
+   */
+  void LoadLazyModel(Json const& in, std::shared_ptr<TreePager> pager);
+  /**
+   * @brief Whether the trees are loaded on demand by the @ref pager.
+   */
+  [[nodiscard]] bool IsLazy() const { return static_cast<bool>(pager); }
 
   [[nodiscard]] std::vector<std::string> DumpModel(const FeatureMap& fmap, bool with_stats,
                                                    int32_t n_threads, std::string format) const {
@@ -119,6 +191,15 @@ struct GBTreeModel : public Model {
                         [&](size_t i) { dump[i] = trees[i]->DumpModel(fmap, with_stats, format); });
     return dump;
   }
+  /**
+   * @brief Dump the trees in chunks, the trees in a chunk are dumped in parallel. Only
+   *        one chunk is held in memory.
+   *
+   * @param fn Called with the dump of each tree in order, returns false to stop.
+   */
+  void DumpModel(FeatureMap const& fmap, bool with_stats, std::int32_t n_threads,
+                 std::string const& format,
+                 std::function<bool(std::string const&)> const& fn) const;
   /**
    * \brief Add trees to the model.
    *
@@ -132,6 +213,7 @@ struct GBTreeModel : public Model {
       tree_info.push_back(group_idx);
     }
     param.num_trees += static_cast<int>(new_trees.size());
+    this->BumpVersion();
   }
 
   [[nodiscard]] std::int32_t BoostedRounds() const {
@@ -140,13 +222,35 @@ struct GBTreeModel : public Model {
     }
     return static_cast<std::int32_t>(iteration_indptr.size() - 1);
   }
+  /**
+   * \brief An identifier for the current state of the trees. It changes whenever trees are
+   *        added, removed or loaded, and is unique across all model instances in the
+   *        process. Predictors use it to invalidate data derived from the trees.
+   */
+  [[nodiscard]] std::uint64_t Version() const { return version_; }
+  /**
+   * \brief Mark the trees as modified. Must be called after changing the trees without
+   *        using the methods of this class.
+   */
+  void BumpVersion();
+  /**
+   * \brief Split statistics of all the trees. The statistics are accumulated as new trees
+   *        are committed, other changes to the trees cause a rebuild in the next call.
+   */
+  [[nodiscard]] FeatureSplitStats FeatureStats() const;
+  /**
+   * \brief Mean values of the nodes of all the trees. Like the split statistics, the values
+   *        of the committed trees are added to the existing ones, other changes to the trees
+   *        cause a rebuild.
+   */
+  [[nodiscard]] std::shared_ptr<NodeMeanValues const> MeanValues() const;
 
   // base margin
   LearnerModelParam const* learner_model_param;
   // model parameter
   GBTreeModelParam param;
   /*! \brief vector of trees stored in the model */
-  std::vector<std::unique_ptr<RegTree> > trees;
+  SharedTrees trees;
   /*! \brief for the update process, a place to keep the initial trees */
   std::vector<std::unique_ptr<RegTree> > trees_to_update;
   /**
@@ -157,13 +261,45 @@ struct GBTreeModel : public Model {
    * \brief Number of trees accumulated for each iteration.
    */
   std::vector<bst_tree_t> iteration_indptr{0};
+  /**
+   * \brief Loads the trees on demand, null unless the model is loaded lazily.
+   */
+  std::shared_ptr<TreePager> pager;
+  /**
+   * \brief Whether the model is saved for serving, the node statistics are not available.
+   */
+  bool serving{false};
 
  private:
+  // Load the tree info and the iteration indptr.
+  void LoadLayout(Json const& in);
+
   /**
    * \brief Whether the stack contains multi-target tree.
    */
   Context const* ctx_;
+  std::uint64_t version_{0};
+  // Split statistics of the trees, valid when the version matches the model version. The
+  // lock is held by pointer to keep the model movable.
+  std::unique_ptr<std::mutex> stats_lock_{std::make_unique<std::mutex>()};
+  mutable FeatureSplitStats stats_;
+  mutable std::uint64_t stats_version_{0};
+  // Node mean values, same as the split statistics, except that only the prefix of the
+  // trees is valid after a commit. Guarded by the same lock.
+  mutable std::shared_ptr<NodeMeanValues const> means_;
+  mutable std::uint64_t means_version_{0};
 };
+
+/**
+ * @brief Parse a UBJSON model without building the JSON objects for all trees. Trees are
+ *        loaded into `p_trees` in batches while the document is being read, and the tree
+ *        arrays are left empty in the returned document.
+ *
+ * @param ctx     Context for the number of threads used to load the trees.
+ * @param str     The serialized model.
+ * @param p_trees The loaded trees, indexed by the tree id.
+ */
+[[nodiscard]] Json LoadUBJModel(Context const* ctx, StringView str, TreesOneGroup* p_trees);
 }  // namespace gbm
 }  // namespace xgboost
 
@@ -0,0 +1,120 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include "tree_pager.h"
+
+#include <algorithm>  // for upper_bound, max
+#include <iterator>   // for distance, prev
+#include <memory>     // for make_shared, make_unique
+#include <utility>    // for move
+
+#include "../common/threading_utils.h"  // for ParallelFor
+#include "gbtree_model.h"               // for GBTreeModel
+#include "xgboost/logging.h"            // for CHECK
+#include "xgboost/tree_model.h"         // for RegTree
+
+namespace xgboost::gbm {
+TreePager::TreePager(std::shared_ptr<common::ResourceHandler> resource,
+                     std::vector<std::size_t> offsets, std::size_t max_bytes)
+    : resource_{std::move(resource)}, offsets_{std::move(offsets)}, max_bytes_{max_bytes} {
+  CHECK(!offsets_.empty());
+}
+
+void TreePager::Init(Context const* ctx, GBTreeModel const& model) {
+  CHECK(model.trees.empty());
+  CHECK_EQ(model.param.num_trees, this->NumTrees());
+  ctx_ = ctx;
+  mparam_ = model.learner_model_param;
+  num_parallel_tree_ = model.param.num_parallel_tree;
+  tree_info_ = model.tree_info;
+  iteration_indptr_ = model.iteration_indptr;
+
+  auto page_bytes = max_bytes_ == 0 ? kDefaultPageBytes : max_bytes_ / kPagesInBudget;
+  page_ptr_ = {0};
+  auto n_layers = static_cast<bst_layer_t>(iteration_indptr_.size() - 1);
+  auto layer_bytes = [&](bst_layer_t l) {
+    return offsets_[iteration_indptr_[l + 1]] - offsets_[iteration_indptr_[l]];
+  };
+  std::size_t n_bytes = 0;
+  for (bst_layer_t l = 0; l < n_layers; ++l) {
+    // A page has at least one layer.
+    if (n_bytes != 0 && n_bytes + layer_bytes(l) > page_bytes) {
+      page_ptr_.push_back(l);
+      n_bytes = 0;
+    }
+    n_bytes += layer_bytes(l);
+  }
+  if (n_layers != 0) {
+    page_ptr_.push_back(n_layers);
+  }
+}
+
+std::size_t TreePager::PageOf(bst_layer_t layer) const {
+  CHECK_LT(layer, page_ptr_.back());
+  auto it = std::upper_bound(page_ptr_.cbegin(), page_ptr_.cend(), layer);
+  return std::distance(page_ptr_.cbegin(), it) - 1;
+}
+
+std::size_t TreePager::PageBytes(std::size_t page) const {
+  auto [begin, end] = this->PageLayers(page);
+  return offsets_[iteration_indptr_[end]] - offsets_[iteration_indptr_[begin]];
+}
+
+std::shared_ptr<GBTreeModel const> TreePager::LoadPage(std::size_t page) const {
+  auto [layer_begin, layer_end] = this->PageLayers(page);
+  auto tree_begin = iteration_indptr_[layer_begin];
+  auto tree_end = iteration_indptr_[layer_end];
+
+  SharedTrees trees(tree_end - tree_begin);
+  common::ParallelFor(trees.size(), ctx_->Threads(), [&](auto i) {
+    common::AlignedResourceReadStream fi{resource_};
+    // The offsets are aligned as they are obtained from the same stream.
+    auto consumed = fi.Consume(offsets_[tree_begin + i]);
+    CHECK_EQ(consumed.second, offsets_[tree_begin + i]);
+    trees[i] = std::make_unique<RegTree>();
+    CHECK(trees[i]->Read(&fi)) << "Invalid mmap model.";
+  });
+
+  auto out = std::make_shared<GBTreeModel>(mparam_, ctx_);
+  out->param.num_parallel_tree = num_parallel_tree_;
+  out->param.num_trees = static_cast<std::int32_t>(trees.size());
+  out->trees = std::move(trees);
+  out->tree_info.assign(tree_info_.cbegin() + tree_begin, tree_info_.cbegin() + tree_end);
+  out->iteration_indptr.clear();
+  for (auto l = layer_begin; l <= layer_end; ++l) {
+    out->iteration_indptr.push_back(iteration_indptr_[l] - tree_begin);
+  }
+  out->BumpVersion();
+  return out;
+}
+
+std::shared_ptr<GBTreeModel const> TreePager::Page(std::size_t page) const {
+  CHECK_LT(page, this->NumPages());
+  std::lock_guard lock{mu_};
+  auto it = cache_.find(page);
+  if (it != cache_.cend()) {
+    auto& [p_page, lru_it] = it->second;
+    lru_.splice(lru_.cend(), lru_, lru_it);
+    return p_page;
+  }
+
+  auto p_page = this->LoadPage(page);
+  ++n_loads_;
+  lru_.push_back(page);
+  cache_.emplace(page, std::pair{p_page, std::prev(lru_.end())});
+  n_cached_bytes_ += this->PageBytes(page);
+  // Keep the page that has just been loaded even if it's larger than the budget.
+  while (max_bytes_ != 0 && n_cached_bytes_ > max_bytes_ && lru_.size() > 1) {
+    auto victim = lru_.front();
+    lru_.pop_front();
+    cache_.erase(victim);
+    n_cached_bytes_ -= this->PageBytes(victim);
+  }
+  return p_page;
+}
+
+std::size_t TreePager::NumLoads() const {
+  std::lock_guard lock{mu_};
+  return n_loads_;
+}
+}  // namespace xgboost::gbm
@@ -0,0 +1,104 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#ifndef XGBOOST_GBM_TREE_PAGER_H_
+#define XGBOOST_GBM_TREE_PAGER_H_
+
+#include <cstddef>        // for size_t
+#include <cstdint>        // for int32_t
+#include <list>           // for list
+#include <memory>         // for shared_ptr
+#include <mutex>          // for mutex
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for pair
+#include <vector>         // for vector
+
+#include "../common/io.h"     // for ResourceHandler
+#include "xgboost/base.h"     // for bst_layer_t, bst_tree_t
+#include "xgboost/context.h"  // for Context
+#include "xgboost/learner.h"  // for LearnerModelParam
+
+namespace xgboost::gbm {
+struct GBTreeModel;
+
+/**
+ * @brief Load the trees of a mmap model on demand.
+ *
+ *   Only the offsets of the trees in the mapped file are read when the model is loaded.
+ *   The boosted layers are split into pages of consecutive layers, and a page is loaded
+ *   as a small @ref GBTreeModel when the predictor first needs it. Loaded pages are kept
+ *   in an LRU cache with a budget in bytes. Pages in use by a prediction stay alive
+ *   after eviction until the prediction finishes.
+ */
+class TreePager {
+ public:
+  // Layers of a page are loaded together, with the size of a page bounded by this
+  // fraction of the budget.
+  static constexpr std::size_t kPagesInBudget = 4;
+  // Size of a page when the budget is unlimited.
+  static constexpr std::size_t kDefaultPageBytes = static_cast<std::size_t>(64) << 20;
+
+ private:
+  std::shared_ptr<common::ResourceHandler> resource_;
+  // Offset of each tree in the resource, the end of the last tree is at the back.
+  std::vector<std::size_t> offsets_;
+  // 0 means unlimited.
+  std::size_t max_bytes_;
+
+  Context const* ctx_{nullptr};
+  LearnerModelParam const* mparam_{nullptr};
+  std::int32_t num_parallel_tree_{1};
+  std::vector<int> tree_info_;
+  std::vector<bst_tree_t> iteration_indptr_;
+  // The first layer of each page.
+  std::vector<bst_layer_t> page_ptr_;
+
+  std::mutex mutable mu_;
+  // Pages in the order of use, the least recently used one is at the front.
+  std::list<std::size_t> mutable lru_;
+  std::unordered_map<std::size_t, std::pair<std::shared_ptr<GBTreeModel const>,
+                                            std::list<std::size_t>::iterator>> mutable cache_;
+  std::size_t mutable n_cached_bytes_{0};
+  std::size_t mutable n_loads_{0};
+
+  [[nodiscard]] std::size_t PageBytes(std::size_t page) const;
+  [[nodiscard]] std::shared_ptr<GBTreeModel const> LoadPage(std::size_t page) const;
+
+ public:
+  /**
+   * @param resource  The mapped model file.
+   * @param offsets   The offsets of trees in the file and the end of the last tree.
+   * @param max_bytes Budget for the loaded trees in bytes, 0 for unlimited.
+   */
+  TreePager(std::shared_ptr<common::ResourceHandler> resource,
+            std::vector<std::size_t> offsets, std::size_t max_bytes);
+  /**
+   * @brief Split the layers of the model into pages. Called once the model is loaded,
+   *        the model itself doesn't hold any tree.
+   */
+  void Init(Context const* ctx, GBTreeModel const& model);
+
+  [[nodiscard]] bst_tree_t NumTrees() const { return offsets_.size() - 1; }
+  [[nodiscard]] std::size_t NumPages() const { return page_ptr_.size() - 1; }
+  /**
+   * @brief The page containing a layer.
+   */
+  [[nodiscard]] std::size_t PageOf(bst_layer_t layer) const;
+  /**
+   * @brief The range of layers in a page.
+   */
+  [[nodiscard]] std::pair<bst_layer_t, bst_layer_t> PageLayers(std::size_t page) const {
+    return {page_ptr_[page], page_ptr_[page + 1]};
+  }
+  /**
+   * @brief Get the trees of a page, the layers are numbered from the beginning of the
+   *        page. The page is loaded if it's not in the cache.
+   */
+  [[nodiscard]] std::shared_ptr<GBTreeModel const> Page(std::size_t page) const;
+  /**
+   * @brief Number of page loads so far.
+   */
+  [[nodiscard]] std::size_t NumLoads() const;
+};
+}  // namespace xgboost::gbm
+#endif  // XGBOOST_GBM_TREE_PAGER_H_
@@ -17,7 +17,10 @@
 #include <cmath>                          // for isnan, isinf
 #include <cstdint>                        // for int32_t, uint32_t, int64_t, uint64_t
 #include <cstdlib>                        // for atoi
-#include <cstring>                        // for memcpy, size_t, memset
+#include <cstring>                        // for memcpy, size_t, memset, memcmp
+#include <filesystem>                     // for file_size, u8path
+#include <functional>                     // for function
+#include <future>                         // for future
 #include <iomanip>                        // for operator<<, setiosflags
 #include <iterator>                       // for back_insert_iterator, distance, back_inserter
 #include <limits>                         // for numeric_limits
@@ -38,10 +41,18 @@
 #include "common/common.h"                // for ToString, Split
 #include "common/error_msg.h"             // for MaxFeatureSize, WarnOldSerialization, ...
 #include "common/io.h"                    // for PeekableInStream, ReadAll, FixedSizeStream, Mem...
+#include "common/memory_stats.h"          // for GlobalMemoryStats, MemTagScope
+#include "common/ref_resource_view.h"     // for ReadVec, WriteVec
 #include "common/observer.h"              // for TrainingObserver
 #include "common/random.h"                // for GlobalRandom
+#include "common/threadpool.h"            // for ThreadPool
 #include "common/timer.h"                 // for Monitor
 #include "common/version.h"               // for Version
+#include "data/sparse_page_source.h"      // for ContentHash
+#include "gbm/gbtree_model.h"             // for LoadUBJModel, TreesOneGroup
+#include "gbm/tree_pager.h"               // for TreePager
+#include "metric/metric_common.h"         // for EvaluateMetrics
+#include "tree/tree_telemetry.h"          // for PhaseTimer
 #include "dmlc/endian.h"                  // for ByteSwap, DMLC_IO_NO_ENDIAN_SWAP
 #include "xgboost/base.h"                 // for Args, bst_float, GradientPair, bst_feature_t, ...
 #include "xgboost/context.h"              // for Context
@@ -58,6 +69,7 @@
 #include "xgboost/predictor.h"            // for PredictionContainer, PredictionCacheEntry
 #include "xgboost/string_view.h"          // for operator<<, StringView
 #include "xgboost/task.h"                 // for ObjInfo
+#include "xgboost/tree_model.h"           // for RegTree
 
 namespace {
 const char* kMaxDeltaStepDefaultValue = "0.7";
@@ -75,6 +87,12 @@ T& UsePtr(T& ptr) {  // NOLINT
   CHECK(ptr);
   return ptr;
 }
+
+template <typename T>
+void HashVec(std::vector<T> const& vec, data::ContentHash* p_hash) {
+  p_hash->UpdateValue(static_cast<std::uint64_t>(vec.size()));
+  p_hash->Update(common::Span<T const>{vec});
+}
 }  // anonymous namespace
 
 /*! \brief training parameter for regression
@@ -320,6 +338,7 @@ void LearnerModelParam::Copy(LearnerModelParam const& that) {
 struct LearnerTrainParam : public XGBoostParameter<LearnerTrainParam> {
   // flag to disable default metric
   bool disable_default_eval_metric {false};
+  bool async_eval{false};
   // FIXME(trivialfis): The following parameters belong to model itself, but can be
   // specified by users.  Move them to model parameter once we can get rid of binary IO.
   std::string booster;
@@ -332,6 +351,11 @@ struct LearnerTrainParam : public XGBoostParameter<LearnerTrainParam> {
     DMLC_DECLARE_FIELD(disable_default_eval_metric)
         .set_default(false)
         .describe("Flag to disable default metric. Set to >0 to disable");
+    DMLC_DECLARE_FIELD(async_eval)
+        .set_default(false)
+        .describe(
+            "Evaluate the metrics in a background thread while the next iteration is trained. "
+            "The result of an iteration is returned by the next evaluation.");
     DMLC_DECLARE_FIELD(booster).set_default("gbtree").describe(
         "Gradient booster used for training.");
     DMLC_DECLARE_FIELD(objective)
@@ -362,7 +386,20 @@ class LearnerConfiguration : public Learner {
   static std::string const kEvalMetric;  // NOLINT
 
  protected:
-  std::atomic<bool> need_configuration_;
+  // Bumped by every change that requires the learner to be configured again.
+  std::atomic<std::uint64_t> config_version_{1};
+  // The value of `config_version_` when the learner was configured the last time. A
+  // change made during configuration is not lost, since the version read at the beginning
+  // of the configuration is the one stored.
+  std::atomic<std::uint64_t> configured_version_{0};
+
+  void RequireConfiguration() { config_version_.fetch_add(1, std::memory_order_acq_rel); }
+  [[nodiscard]] bool NeedConfiguration() const {
+    return configured_version_.load(std::memory_order_acquire) !=
+           config_version_.load(std::memory_order_acquire);
+  }
+  // Read-only inference mode, see `Learner::Freeze`.
+  std::atomic<bool> frozen_{false};
   std::map<std::string, std::string> cfg_;
   // Stores information like best-iteration for early stopping.
   std::map<std::string, std::string> attributes_;
@@ -380,6 +417,21 @@ class LearnerConfiguration : public Learner {
 
   std::vector<std::string> metric_names_;
 
+  // Asynchronous evaluation, see the `async_eval` parameter. At most one evaluation is in
+  // flight, and the metrics are not used by the learner until it finishes.
+  std::unique_ptr<common::ThreadPool> eval_pool_;
+  std::future<std::string> pending_eval_;
+  std::string finished_eval_;
+
+  [[nodiscard]] bool AsyncEval() const {
+    return tparam_.async_eval && ctx_.IsCPU() && !collective::IsDistributed();
+  }
+  void WaitEval() {
+    if (pending_eval_.valid()) {
+      finished_eval_ = pending_eval_.get();
+    }
+  }
+
   void ConfigureModelParamWithoutBaseScore() {
     // Convert mparam to learner_model_param
     this->ConfigureTargets();
@@ -438,8 +490,7 @@ class LearnerConfiguration : public Learner {
   }
 
  public:
-  explicit LearnerConfiguration(std::vector<std::shared_ptr<DMatrix>> cache)
-      : need_configuration_{true} {
+  explicit LearnerConfiguration(std::vector<std::shared_ptr<DMatrix>> cache) {
     monitor_.Init("Learner");
     for (std::shared_ptr<DMatrix> const& d : cache) {
       if (d) {
@@ -450,14 +501,17 @@ class LearnerConfiguration : public Learner {
 
   // Configuration before data is known.
   void Configure() override {
-    // Varient of double checked lock
-    if (!this->need_configuration_) {
+    // Varient of double checked lock, the steady state is a pair of atomic loads.
+    if (!this->NeedConfiguration()) {
       return;
     }
     std::lock_guard<std::mutex> guard(config_lock_);
-    if (!this->need_configuration_) {
+    if (!this->NeedConfiguration()) {
       return;
     }
+    auto version = config_version_.load(std::memory_order_acquire);
+    // The metrics and the context might be replaced.
+    this->WaitEval();
 
     monitor_.Start("Configure");
     auto old_tparam = tparam_;
@@ -490,7 +544,7 @@ class LearnerConfiguration : public Learner {
 
     this->ConfigureMetrics(args);
 
-    this->need_configuration_ = false;
+    configured_version_.store(version, std::memory_order_release);
     if (ctx_.validate_parameters) {
       this->ValidateParameters();
     }
@@ -505,6 +559,8 @@ class LearnerConfiguration : public Learner {
   }
 
   void LoadConfig(Json const& in) override {
+    CHECK(!this->frozen_) << error::FrozenBooster();
+    this->WaitEval();
     // If configuration is loaded, ensure that the model came from the same version
     CHECK(IsA<Object>(in));
     auto origin_version = Version::Load(in);
@@ -558,11 +614,11 @@ class LearnerConfiguration : public Learner {
     // make sure the GPU ID is valid in new environment before start running configure.
     ctx_.ConfigureGpuId(false);
 
-    this->need_configuration_ = true;
+    this->RequireConfiguration();
   }
 
   void SaveConfig(Json* p_out) const override {
-    CHECK(!this->need_configuration_) << "Call Configure before saving model.";
+    CHECK(!this->NeedConfiguration()) << "Call Configure before saving model.";
     Version::Save(p_out);
     Json& out { *p_out };
     // parameters
@@ -590,7 +646,8 @@ class LearnerConfiguration : public Learner {
   }
 
   void SetParam(const std::string& key, const std::string& value) override {
-    this->need_configuration_ = true;
+    CHECK(!this->frozen_) << error::FrozenBooster();
+    this->RequireConfiguration();
     if (key == kEvalMetric) {
       if (std::find(metric_names_.cbegin(), metric_names_.cend(),
                     value) == metric_names_.cend()) {
@@ -612,6 +669,7 @@ class LearnerConfiguration : public Learner {
   }
 
   void SetAttr(const std::string& key, const std::string& value) override {
+    CHECK(!this->frozen_) << error::FrozenBooster();
     attributes_[key] = value;
     mparam_.contain_extra_attrs = 1;
   }
@@ -624,6 +682,7 @@ class LearnerConfiguration : public Learner {
   }
 
   bool DelAttr(const std::string& key) override {
+    CHECK(!this->frozen_) << error::FrozenBooster();
     auto it = attributes_.find(key);
     if (it == attributes_.end()) { return false; }
     attributes_.erase(it);
@@ -631,6 +690,7 @@ class LearnerConfiguration : public Learner {
   }
 
   void SetFeatureNames(std::vector<std::string> const& fn) override {
+    CHECK(!this->frozen_) << error::FrozenBooster();
     feature_names_ = fn;
   }
 
@@ -639,6 +699,7 @@ class LearnerConfiguration : public Learner {
   }
 
   void SetFeatureTypes(std::vector<std::string> const& ft) override {
+    CHECK(!this->frozen_) << error::FrozenBooster();
     this->feature_types_ = ft;
   }
 
@@ -857,14 +918,26 @@ class LearnerIO : public LearnerConfiguration {
   // Used to identify the offset of JSON string when
   // Will be removed once JSON takes over.  Right now we still loads some RDS files from R.
   std::string const serialisation_header_ { u8"CONFIG-offset:" };
+  // Header of the mmap model, with the format version as the last character.
+  static constexpr std::array<char, 8> kMmapMagic{'X', 'G', 'B', 'M', 'M', 'A', 'P', '1'};
 
  protected:
+  // The mmap model and the saved prediction cache use the native byte order.
+  static constexpr std::uint64_t kMmapByteOrder{0x0102030405060708};
+  // Header of the saved prediction cache.
+  static constexpr std::array<char, 8> kPredtCacheMagic{'X', 'G', 'B', 'P', 'C', 'A', 'C', '1'};
+
   void ClearCaches() { this->prediction_container_ = PredictionContainer{}; }
 
  public:
   explicit LearnerIO(std::vector<std::shared_ptr<DMatrix>> cache) : LearnerConfiguration{cache} {}
 
-  void LoadModel(Json const& in) override {
+ protected:
+  // `p_trees` is not null if the trees have been loaded by the streaming reader, `pager`
+  // is not null if the trees are loaded on demand.
+  void LoadModelImpl(Json const& in, gbm::TreesOneGroup* p_trees,
+                     std::shared_ptr<gbm::TreePager> pager = nullptr) {
+    CHECK(!this->frozen_) << error::FrozenBooster();
     CHECK(IsA<Object>(in));
     auto version = Version::Load(in);
     if (std::get<0>(version) == 1 && std::get<1>(version) < 6) {
@@ -888,7 +961,13 @@ class LearnerIO : public LearnerConfiguration {
     tparam_.UpdateAllowUnknown(Args{{"booster", name}});
     gbm_.reset(
         GradientBooster::Create(tparam_.booster, &ctx_, &learner_model_param_));
-    gbm_->LoadModel(gradient_booster);
+    if (pager) {
+      gbm_->LoadLazyModel(gradient_booster, std::move(pager));
+    } else if (p_trees) {
+      gbm_->LoadStreamedModel(gradient_booster, std::move(*p_trees));
+    } else {
+      gbm_->LoadModel(gradient_booster);
+    }
 
     auto const& j_attributes = get<Object const>(learner.at("attributes"));
     attributes_.clear();
@@ -912,12 +991,110 @@ class LearnerIO : public LearnerConfiguration {
                      [](Json const& fn) { return get<String const>(fn); });
     }
 
-    this->need_configuration_ = true;
+    this->RequireConfiguration();
     this->ClearCaches();
   }
 
-  void SaveModel(Json* p_out) const override {
-    CHECK(!this->need_configuration_) << "Call Configure before saving model.";
+ public:
+  void LoadModel(Json const& in) override { this->LoadModelImpl(in, nullptr); }
+
+  void LoadModel(StringView str, std::ios::openmode mode) override {
+    CHECK(!this->frozen_) << error::FrozenBooster();
+    if (!(mode & std::ios::binary)) {
+      this->LoadModel(Json::Load(str));
+      return;
+    }
+    gbm::TreesOneGroup trees;
+    auto in = gbm::LoadUBJModel(&ctx_, str, &trees);
+    this->LoadModelImpl(in, &trees);
+  }
+
+  void SaveModel(Json* p_out) const override { this->SaveModelImpl(p_out, nullptr); }
+
+  void SaveServingModel(Json* p_out) const override {
+    this->SaveModelImpl(p_out, nullptr, true);
+  }
+
+  void SaveMmapModel(StringView path) const override {
+    Json out{Object{}};
+    std::vector<RegTree const*> trees;
+    this->SaveModelImpl(&out, &trees);
+    std::vector<char> buffer;
+    Json::Dump(out, &buffer, std::ios::binary);
+
+    common::AlignedFileWriteStream fo{path, "wb"};
+    std::size_t n_bytes{0};
+    n_bytes += fo.Write(kMmapMagic.data(), kMmapMagic.size());
+    n_bytes += fo.Write(kMmapByteOrder);
+    n_bytes += common::WriteVec(&fo, buffer);
+    n_bytes += fo.Write(static_cast<std::uint64_t>(trees.size()));
+    for (auto const* tree : trees) {
+      n_bytes += tree->Write(&fo);
+    }
+    LOG(DEBUG) << "Saved mmap model: " << n_bytes << " bytes.";
+  }
+
+  // Read the header and the model document of a mmap model, the stream is left at the
+  // number of trees.
+  [[nodiscard]] static Json ReadMmapDoc(common::AlignedResourceReadStream* p_fi,
+                                        StringView path) {
+    auto& fi = *p_fi;
+    auto [magic, n_magic] = fi.Consume(kMmapMagic.size());
+    CHECK(n_magic == kMmapMagic.size() &&
+          std::memcmp(magic, kMmapMagic.data(), kMmapMagic.size()) == 0)
+        << "Invalid mmap model: " << path;
+    std::uint64_t byte_order{0};
+    CHECK(fi.Read(&byte_order)) << "Invalid mmap model: " << path;
+    CHECK_EQ(byte_order, kMmapByteOrder)
+        << "The mmap model is saved on a platform with different byte order.";
+
+    std::vector<char> buffer;
+    CHECK(common::ReadVec(&fi, &buffer)) << "Invalid mmap model: " << path;
+    return Json::Load(StringView{buffer.data(), buffer.size()}, std::ios::binary);
+  }
+
+  void LoadMmapModel(StringView path) override {
+    CHECK(!this->frozen_) << error::FrozenBooster();
+    auto fpath = std::filesystem::u8path(static_cast<std::string>(path));
+    auto n_bytes = std::filesystem::file_size(fpath);
+    common::PrivateMmapConstStream fi{path, 0, n_bytes};
+    auto in = ReadMmapDoc(&fi, path);
+
+    std::uint64_t n_trees{0};
+    CHECK(fi.Read(&n_trees)) << "Invalid mmap model: " << path;
+    gbm::TreesOneGroup trees(n_trees);
+    for (auto& tree : trees) {
+      tree = std::make_unique<RegTree>();
+      CHECK(tree->Read(&fi)) << "Invalid mmap model: " << path;
+    }
+    this->LoadModelImpl(in, &trees);
+  }
+
+  void LoadLazyModel(StringView path, std::size_t max_bytes) override {
+    CHECK(!this->frozen_) << error::FrozenBooster();
+    auto fpath = std::filesystem::u8path(static_cast<std::string>(path));
+    auto n_bytes = std::filesystem::file_size(fpath);
+    common::PrivateMmapConstStream fi{path, 0, n_bytes};
+    auto in = ReadMmapDoc(&fi, path);
+
+    std::uint64_t n_trees{0};
+    CHECK(fi.Read(&n_trees)) << "Invalid mmap model: " << path;
+    // Only the offsets are read, the mapped pages of the trees are not touched.
+    std::vector<std::size_t> offsets(n_trees + 1);
+    for (std::uint64_t i = 0; i < n_trees; ++i) {
+      offsets[i] = fi.Tell();
+      CHECK(RegTree::Skip(&fi)) << "Invalid mmap model: " << path;
+    }
+    offsets.back() = fi.Tell();
+    auto pager = std::make_shared<gbm::TreePager>(fi.Share(), std::move(offsets), max_bytes);
+    this->LoadModelImpl(in, nullptr, std::move(pager));
+  }
+
+ protected:
+  // `p_trees` is not null if the trees are saved separately.
+  void SaveModelImpl(Json* p_out, std::vector<RegTree const*>* p_trees,
+                     bool serving = false) const {
+    CHECK(!this->NeedConfiguration()) << "Call Configure before saving model.";
     this->CheckModelInitialized();
 
     Version::Save(p_out);
@@ -929,7 +1106,13 @@ class LearnerIO : public LearnerConfiguration {
     learner["learner_model_param"] = mparam_.ToJson();
     learner["gradient_booster"] = Object();
     auto& gradient_booster = learner["gradient_booster"];
-    gbm_->SaveModel(&gradient_booster);
+    if (p_trees) {
+      gbm_->SaveStreamedModel(&gradient_booster, p_trees);
+    } else if (serving) {
+      gbm_->SaveServingModel(&gradient_booster);
+    } else {
+      gbm_->SaveModel(&gradient_booster);
+    }
 
     learner["objective"] = Object();
     auto& objective_fn = learner["objective"];
@@ -952,8 +1135,10 @@ class LearnerIO : public LearnerConfiguration {
     }
   }
 
+ public:
   // About to be deprecated by JSON format
   void LoadModel(dmlc::Stream* fi) override {
+    CHECK(!this->frozen_) << error::FrozenBooster();
     ctx_.UpdateAllowUnknown(Args{});
     tparam_.Init(std::vector<std::pair<std::string, std::string>>{});
     // TODO(tqchen) mark deprecation of old format.
@@ -982,16 +1167,14 @@ class LearnerIO : public LearnerConfiguration {
 
     if (header[0] == '{') {  // Dispatch to JSON
       auto buffer = common::ReadAll(fi, &fp);
-      Json model;
       auto it = first_non_space(buffer.cbegin() + 1, buffer.cend());
       if (it != buffer.cend() && *it == '"') {
-        model = Json::Load(StringView{buffer});
+        this->LoadModel(StringView{buffer}, std::ios::in);
       } else if (it != buffer.cend() && std::isalpha(*it)) {
-        model = Json::Load(StringView{buffer}, std::ios::binary);
+        this->LoadModel(StringView{buffer}, std::ios::binary);
       } else {
         LOG(FATAL) << "Invalid model format";
       }
-      this->LoadModel(model);
       return;
     }
 
@@ -1079,7 +1262,7 @@ class LearnerIO : public LearnerConfiguration {
     auto n = tparam_.__DICT__();
     cfg_.insert(n.cbegin(), n.cend());
 
-    this->need_configuration_ = true;
+    this->RequireConfiguration();
     this->ClearCaches();
   }
 
@@ -1150,11 +1333,12 @@ class LearnerIO : public LearnerConfiguration {
     this->SaveConfig(&config);
 
     std::vector<char> stream;
-    Json::Dump(memory_snapshot, &stream, std::ios::binary);
+    Json::Dump(memory_snapshot, &stream, std::ios::binary, ctx_.Threads());
     fo->Write(stream.data(), stream.size());
   }
 
   void Load(dmlc::Stream* fi) override {
+    CHECK(!this->frozen_) << error::FrozenBooster();
     common::PeekableInStream fp(fi);
     char header[2];
     fp.PeekRead(header, 2);
@@ -1211,6 +1395,9 @@ class LearnerImpl : public LearnerIO {
   explicit LearnerImpl(std::vector<std::shared_ptr<DMatrix> > cache)
       : LearnerIO{cache} {}
   ~LearnerImpl() override {
+    if (pending_eval_.valid()) {
+      pending_eval_.wait();
+    }
     auto local_map = LearnerAPIThreadLocalStore::Get();
     if (local_map->find(this) != local_map->cend()) {
       local_map->erase(this);
@@ -1225,6 +1412,21 @@ class LearnerImpl : public LearnerIO {
     return gbm_->DumpModel(fmap, with_stats, format);
   }
 
+  void DumpModelTo(FeatureMap const& fmap, bool with_stats, std::string format,
+                   std::function<bool(std::string const&)> const& fn) override {
+    this->Configure();
+    this->CheckModelInitialized();
+
+    gbm_->DumpModelTo(fmap, with_stats, format, fn);
+  }
+
+  std::string GenerateCode(bst_layer_t layer_begin, bst_layer_t layer_end) override {
+    this->Configure();
+    this->CheckModelInitialized();
+
+    return gbm_->GenerateCode(layer_begin, layer_end);
+  }
+
   Learner* Slice(bst_layer_t begin, bst_layer_t end, bst_layer_t step,
                  bool* out_of_bound) override {
     this->Configure();
@@ -1263,7 +1465,30 @@ class LearnerImpl : public LearnerIO {
     return out_impl;
   }
 
+  void Append(Learner* that) override {
+    CHECK(!this->frozen_) << error::FrozenBooster();
+    this->Configure();
+    this->CheckModelInitialized();
+    auto p_that = dynamic_cast<LearnerImpl*>(that);
+    CHECK(p_that);
+    p_that->Configure();
+    p_that->CheckModelInitialized();
+
+    CHECK_EQ(this->tparam_.booster, p_that->tparam_.booster)
+        << "Models with different boosters can not be appended.";
+    CHECK_EQ(this->learner_model_param_.num_feature, p_that->learner_model_param_.num_feature)
+        << "Models with different number of features can not be appended.";
+    CHECK_EQ(this->learner_model_param_.num_output_group,
+             p_that->learner_model_param_.num_output_group)
+        << "Models with different number of outputs can not be appended.";
+    this->gbm_->Append(p_that->gbm_.get());
+    for (auto const& kv : p_that->attributes_) {
+      this->attributes_[kv.first] = kv.second;
+    }
+  }
+
   void Reset() override {
+    CHECK(!this->frozen_) << error::FrozenBooster();
     this->Configure();
     this->CheckModelInitialized();
     // Global data
@@ -1285,7 +1510,75 @@ class LearnerImpl : public LearnerIO {
     this->gpair_ = decltype(this->gpair_){};
   }
 
+  void SavePredictionCache(std::shared_ptr<DMatrix> data, StringView path) override {
+    this->Configure();
+    this->CheckModelInitialized();
+    CHECK_EQ(tparam_.booster, "gbtree") << "Only the gbtree booster supports saving the cache.";
+    auto predt = prediction_container_.Cache(data, ctx_.Device());
+    this->PredictRaw(data.get(), predt.get(), false, 0, 0);
+    CHECK_EQ(predt->version, static_cast<std::uint32_t>(this->BoostedRounds()));
+    auto const& h_predt = predt->predictions.ConstHostVector();
+
+    common::AlignedFileWriteStream fo{path, "wb"};
+    std::size_t n_bytes{0};
+    n_bytes += fo.Write(kPredtCacheMagic.data(), kPredtCacheMagic.size());
+    n_bytes += fo.Write(kMmapByteOrder);
+    n_bytes += fo.Write(this->ModelFingerprint());
+    n_bytes += fo.Write(this->DataFingerprint(data.get()));
+    n_bytes += fo.Write(static_cast<std::uint64_t>(predt->version));
+    n_bytes += common::WriteVec(&fo, h_predt);
+    LOG(DEBUG) << "Saved prediction cache: " << n_bytes << " bytes.";
+  }
+
+  bool LoadPredictionCache(std::shared_ptr<DMatrix> data, StringView path) override {
+    this->Configure();
+    this->CheckModelInitialized();
+    this->ValidateDMatrix(data.get(), true);
+    auto fpath = std::filesystem::u8path(static_cast<std::string>(path));
+    auto n_bytes = std::filesystem::file_size(fpath);
+    common::PrivateMmapConstStream fi{path, 0, n_bytes};
+    auto [magic, n_magic] = fi.Consume(kPredtCacheMagic.size());
+    CHECK(n_magic == kPredtCacheMagic.size() &&
+          std::memcmp(magic, kPredtCacheMagic.data(), kPredtCacheMagic.size()) == 0)
+        << "Invalid prediction cache: " << path;
+    std::uint64_t byte_order{0}, model_fp{0}, data_fp{0}, n_layers{0};
+    CHECK(fi.Read(&byte_order) && fi.Read(&model_fp) && fi.Read(&data_fp) && fi.Read(&n_layers))
+        << "Invalid prediction cache: " << path;
+
+    auto reject = [&](StringView reason) {
+      LOG(WARNING) << "The prediction cache is not restored, " << reason
+                   << ". It will be recomputed from the model.";
+      return false;
+    };
+    if (byte_order != kMmapByteOrder) {
+      return reject("saved on a platform with different byte order");
+    }
+    if (tparam_.booster != "gbtree") {
+      return reject("only the gbtree booster is supported");
+    }
+    if (n_layers != static_cast<std::uint64_t>(this->BoostedRounds()) ||
+        model_fp != this->ModelFingerprint()) {
+      return reject("the cache is saved from a different model");
+    }
+    if (data_fp != this->DataFingerprint(data.get())) {
+      return reject("the cache is saved from a different DMatrix");
+    }
+    std::vector<float> h_predt;
+    CHECK(common::ReadVec(&fi, &h_predt)) << "Invalid prediction cache: " << path;
+    CHECK_EQ(h_predt.size(), data->Info().num_row_ * this->Groups())
+        << "Invalid prediction cache: " << path;
+
+    auto predt = prediction_container_.Cache(data, ctx_.Device());
+    predt->predictions.HostVector() = std::move(h_predt);
+    predt->version = static_cast<std::uint32_t>(n_layers);
+    if (ctx_.IsCUDA()) {
+      predt->predictions.SetDevice(ctx_.Device());
+    }
+    return true;
+  }
+
   void UpdateOneIter(int iter, std::shared_ptr<DMatrix> train) override {
+    CHECK(!this->frozen_) << error::FrozenBooster();
     monitor_.Start("UpdateOneIter");
     TrainingObserver::Instance().Update(iter);
     this->Configure();
@@ -1305,16 +1598,31 @@ class LearnerImpl : public LearnerIO {
     monitor_.Stop("PredictRaw");
 
     monitor_.Start("GetGradient");
-    GetGradient(predt->predictions, train->Info(), iter, &gpair_);
+    // Let the booster compute the gradient during tree construction. The labels are
+    // validated by the objective in the first iteration.
+    std::unique_ptr<RowGradient> fused;
+    if (iter != 0 && ctx_.IsCPU() && !collective::IsDistributed()) {
+      fused = obj_->MakeRowGradient(predt->predictions, train->Info());
+    }
+    if (fused && gbm_->FuseGradient(fused.get())) {
+      common::MemTagScope scope{common::MemTag::kGradient};
+      gpair_.SetDevice(ctx_.Device());
+      gpair_.Reshape(train->Info().num_row_, this->learner_model_param_.OutputLength());
+    } else {
+      fused.reset();
+      GetGradient(predt->predictions, train->Info(), iter, &gpair_);
+      TrainingObserver::Instance().Observe(*gpair_.Data(), "Gradients");
+    }
     monitor_.Stop("GetGradient");
-    TrainingObserver::Instance().Observe(*gpair_.Data(), "Gradients");
 
     gbm_->DoBoost(train.get(), &gpair_, predt.get(), obj_.get());
     monitor_.Stop("UpdateOneIter");
+    common::GlobalMemoryStats().Log();
   }
 
   void BoostOneIter(int iter, std::shared_ptr<DMatrix> train,
                     linalg::Matrix<GradientPair>* in_gpair) override {
+    CHECK(!this->frozen_) << error::FrozenBooster();
     monitor_.Start("BoostOneIter");
     this->Configure();
 
@@ -1332,6 +1640,32 @@ class LearnerImpl : public LearnerIO {
     monitor_.Stop("BoostOneIter");
   }
 
+  linalg::Matrix<GradientPair>* GradientBuffer(std::shared_ptr<DMatrix> train) override {
+    CHECK(!this->frozen_) << error::FrozenBooster();
+    this->Configure();
+    this->ValidateDMatrix(train.get(), true);
+    // Reuse the allocation from the previous iteration, the shape rarely changes.
+    gpair_.SetDevice(ctx_.Device());
+    gpair_.Reshape(train->Info().num_row_, this->learner_model_param_.OutputLength());
+    return &gpair_;
+  }
+
+  // Evaluate the metrics on transformed predictions and format the result.
+  std::string EvalMetrics(int iter, std::vector<std::shared_ptr<DMatrix>> const& data_sets,
+                          std::vector<std::string> const& data_names,
+                          std::vector<HostDeviceVector<float> const*> const& predts) {
+    std::ostringstream os;
+    os.precision(std::numeric_limits<double>::max_digits10);
+    os << '[' << iter << ']' << std::setiosflags(std::ios::fixed);
+    for (size_t i = 0; i < data_sets.size(); ++i) {
+      auto results = metric::EvaluateMetrics(&ctx_, metrics_, *predts[i], data_sets[i]);
+      for (size_t k = 0; k < metrics_.size(); ++k) {
+        os << '\t' << data_names[i] << '-' << metrics_[k]->Name() << ':' << results[k];
+      }
+    }
+    return os.str();
+  }
+
   std::string EvalOneIter(int iter,
                           const std::vector<std::shared_ptr<DMatrix>>& data_sets,
                           const std::vector<std::string>& data_names) override {
@@ -1339,10 +1673,8 @@ class LearnerImpl : public LearnerIO {
     this->Configure();
     this->CheckModelInitialized();
 
-    std::ostringstream os;
-    os.precision(std::numeric_limits<double>::max_digits10);
-    os << '[' << iter << ']' << std::setiosflags(std::ios::fixed);
     if (metrics_.empty() && !tparam_.disable_default_eval_metric) {
+      this->WaitEval();
       metrics_.emplace_back(Metric::Create(obj_->DefaultEvalMetric(), &ctx_));
       auto config = obj_->DefaultMetricConfig();
       if (!IsA<Null>(config)) {
@@ -1351,6 +1683,10 @@ class LearnerImpl : public LearnerIO {
       metrics_.back()->Configure({cfg_.begin(), cfg_.end()});
     }
 
+    auto async = this->AsyncEval();
+    // Snapshot of the predictions for the asynchronous evaluation.
+    auto snapshot = std::make_shared<std::vector<HostDeviceVector<float>>>();
+    std::vector<HostDeviceVector<float> const*> predts;
     for (size_t i = 0; i < data_sets.size(); ++i) {
       std::shared_ptr<DMatrix> m = data_sets[i];
       auto predt = prediction_container_.Cache(m, ctx_.Device());
@@ -1362,13 +1698,40 @@ class LearnerImpl : public LearnerIO {
       out.Copy(predt->predictions);
 
       obj_->EvalTransform(&out);
-      for (auto& ev : metrics_) {
-        os << '\t' << data_names[i] << '-' << ev->Name() << ':' << ev->Evaluate(out, m);
+      if (async) {
+        auto &copy = snapshot->emplace_back();
+        copy.Resize(out.Size());
+        copy.Copy(out);
+      } else {
+        predts.push_back(&out);
       }
     }
 
+    std::string result;
+    if (async) {
+      this->WaitEval();
+      result = std::exchange(finished_eval_, std::string{});
+      if (!eval_pool_) {
+        eval_pool_ = std::make_unique<common::ThreadPool>(StringView{"eval"}, 1, [] {});
+      }
+      pending_eval_ = eval_pool_->Submit([this, iter, data_sets, data_names, snapshot] {
+        std::vector<HostDeviceVector<float> const*> predts;
+        for (auto const &p : *snapshot) {
+          predts.push_back(&p);
+        }
+        return this->EvalMetrics(iter, data_sets, data_names, predts);
+      });
+    } else {
+      result = this->EvalMetrics(iter, data_sets, data_names, predts);
+    }
+
     monitor_.Stop("EvalOneIter");
-    return os.str();
+    return result;
+  }
+
+  std::string EvalPending() override {
+    this->WaitEval();
+    return std::exchange(finished_eval_, std::string{});
   }
 
   void Predict(std::shared_ptr<DMatrix> data, bool output_margin,
@@ -1380,6 +1743,7 @@ class LearnerImpl : public LearnerIO {
                                static_cast<int>(pred_contribs);
     this->Configure();
     if (training) {
+      CHECK(!this->frozen_) << error::FrozenBooster();
       this->InitBaseScore(nullptr);
     }
     this->CheckModelInitialized();
@@ -1392,6 +1756,18 @@ class LearnerImpl : public LearnerIO {
                                             approx_contribs);
     } else if (pred_leaf) {
       gbm_->PredictLeaf(data.get(), out_preds, layer_begin, layer_end);
+    } else if (this->frozen_) {
+      // Bypass the shared prediction cache, predict into the output buffer directly.
+      PredictionCacheEntry predt;
+      predt.predictions = std::move(*out_preds);
+      if (!ctx_.IsCPU()) {
+        predt.predictions.SetDevice(ctx_.Device());
+      }
+      this->PredictRaw(data.get(), &predt, false, layer_begin, layer_end);
+      *out_preds = std::move(predt.predictions);
+      if (!output_margin) {
+        obj_->PredTransform(out_preds);
+      }
     } else {
       auto predt = prediction_container_.Cache(data, ctx_.Device());
       this->PredictRaw(data.get(), predt.get(), training, layer_begin, layer_end);
@@ -1405,18 +1781,44 @@ class LearnerImpl : public LearnerIO {
     }
   }
 
+  void PredictLeafMargin(std::shared_ptr<DMatrix> data, bool output_margin,
+                         HostDeviceVector<float>* out_preds, HostDeviceVector<float>* out_leaf,
+                         bst_layer_t layer_begin, bst_layer_t layer_end) override {
+    this->Configure();
+    this->CheckModelInitialized();
+    this->ValidateDMatrix(data.get(), false);
+
+    gbm_->PredictLeafMargin(data.get(), out_leaf, out_preds, layer_begin, layer_end);
+    if (!output_margin) {
+      obj_->PredTransform(out_preds);
+    }
+  }
+
   int32_t BoostedRounds() const override {
     if (!this->gbm_) { return 0; }  // haven't call train or LoadModel.
-    CHECK(!this->need_configuration_);
+    CHECK(!this->NeedConfiguration());
     return this->gbm_->BoostedRounds();
   }
 
   uint32_t Groups() const override {
-    CHECK(!this->need_configuration_);
+    CHECK(!this->NeedConfiguration());
     this->CheckModelInitialized();
     return this->learner_model_param_.num_output_group;
   }
 
+  void Freeze() override {
+    this->Configure();
+    this->CheckModelInitialized();
+    CHECK_NE(tparam_.booster, "gblinear")
+        << "The read-only inference mode is only supported by tree models.";
+    // Training caches are no longer needed.
+    this->ClearCaches();
+    this->gpair_ = decltype(this->gpair_){};
+    this->frozen_ = true;
+  }
+
+  [[nodiscard]] bool IsFrozen() const override { return this->frozen_; }
+
   XGBAPIThreadLocalEntry& GetThreadLocal() const override {
     return (*LearnerAPIThreadLocalStore::Get())[this];
   }
@@ -1442,6 +1844,56 @@ class LearnerImpl : public LearnerIO {
     *out_preds = &out_predictions.predictions;
   }
 
+  void PredictDense(float const* data, bst_idx_t n_rows, float missing, PredictionType type,
+                    bst_layer_t iteration_begin, bst_layer_t iteration_end,
+                    HostDeviceVector<float>* out_preds) override {
+    this->Configure();
+    this->CheckModelInitialized();
+
+    this->gbm_->PredictDense(data, n_rows, missing, iteration_begin, iteration_end, out_preds);
+    if (type == PredictionType::kValue) {
+      obj_->PredTransform(out_preds);
+    } else if (type != PredictionType::kMargin) {
+      LOG(FATAL) << "Unsupported prediction type:" << static_cast<int>(type);
+    }
+  }
+
+  /**
+   * @brief Prepare the output of @ref Learner::PredictDenseMulti.
+   */
+  void PrepareDense(DensePredictEntry const& entry, bst_idx_t n_rows,
+                    DenseModelSlice* out_slice) {
+    this->Configure();
+    this->CheckModelInitialized();
+    CHECK(entry.type == PredictionType::kValue || entry.type == PredictionType::kMargin)
+        << "Unsupported prediction type:" << static_cast<int>(entry.type);
+    this->gbm_->PrepareDense(n_rows, entry.layer_begin, entry.layer_end, entry.out_preds,
+                             out_slice);
+  }
+  void TransformDense(DensePredictEntry const& entry) {
+    if (entry.type == PredictionType::kValue) {
+      obj_->PredTransform(entry.out_preds);
+    }
+  }
+
+  void PredictCascade(std::shared_ptr<DMatrix> data, PredictionType type, float missing,
+                      bst_layer_t iteration_begin, bst_layer_t iteration_end,
+                      std::vector<bst_layer_t> const& checkpoints,
+                      std::vector<float> const& thresholds, HostDeviceVector<float>* out_preds,
+                      HostDeviceVector<std::uint8_t>* finished) override {
+    this->Configure();
+    this->CheckModelInitialized();
+    this->ValidateDMatrix(data.get(), false);
+
+    this->gbm_->PredictCascade(data.get(), missing, iteration_begin, iteration_end, checkpoints,
+                               thresholds, out_preds, finished);
+    if (type == PredictionType::kValue) {
+      obj_->PredTransform(out_preds);
+    } else if (type != PredictionType::kMargin) {
+      LOG(FATAL) << "Unsupported prediction type:" << static_cast<int>(type);
+    }
+  }
+
   void CalcFeatureScore(std::string const& importance_type, common::Span<int32_t const> trees,
                         std::vector<bst_feature_t>* features, std::vector<float>* scores) override {
     this->Configure();
@@ -1468,9 +1920,36 @@ class LearnerImpl : public LearnerIO {
     CHECK(gbm_ != nullptr) << "Predict must happen after Load or configuration";
     this->CheckModelInitialized();
     this->ValidateDMatrix(data, false);
+    common::MemTagScope scope{common::MemTag::kPredictionCache};
     gbm_->PredictBatch(data, out_preds, training, layer_begin, layer_end);
   }
 
+  // Persistent fingerprint of the trees and the intercept, unlike the model version.
+  [[nodiscard]] std::uint64_t ModelFingerprint() const {
+    Json out{Object{}};
+    out["learner_model_param"] = mparam_.ToJson();
+    out["gradient_booster"] = Object{};
+    gbm_->SaveModel(&out["gradient_booster"]);
+    std::vector<char> buffer;
+    Json::Dump(out, &buffer, std::ios::binary, ctx_.Threads());
+    data::ContentHash hash;
+    HashVec(buffer, &hash);
+    return hash.Get();
+  }
+
+  // Fingerprint of the shape and the meta info used by the prediction. The feature values are
+  // not hashed.
+  [[nodiscard]] static std::uint64_t DataFingerprint(DMatrix* p_fmat) {
+    auto const& info = p_fmat->Info();
+    std::array<std::uint64_t, 3> shape{info.num_row_, info.num_col_, info.num_nonzero_};
+    data::ContentHash hash;
+    hash.Update(common::Span<std::uint64_t const>{shape});
+    HashVec(info.labels.Data()->ConstHostVector(), &hash);
+    HashVec(info.weights_.ConstHostVector(), &hash);
+    HashVec(info.base_margin_.Data()->ConstHostVector(), &hash);
+    return hash.Get();
+  }
+
   void ValidateDMatrix(DMatrix* p_fmat, bool is_training) const {
     MetaInfo const& info = p_fmat->Info();
     info.Validate(ctx_.Device());
@@ -1493,6 +1972,8 @@ class LearnerImpl : public LearnerIO {
  private:
   void GetGradient(HostDeviceVector<bst_float> const& preds, MetaInfo const& info,
                    std::int32_t iter, linalg::Matrix<GradientPair>* out_gpair) {
+    common::MemTagScope scope{common::MemTag::kGradient};
+    tree::PhaseTimer timer{tree::TreePhase::kGradient};
     out_gpair->Reshape(info.num_row_, this->learner_model_param_.OutputLength());
     collective::ApplyWithLabels(&ctx_, info, out_gpair->Data(),
                                 [&] { obj_->GetGradient(preds, info, iter, out_gpair); });
@@ -1513,4 +1994,24 @@ Learner* Learner::Create(
     const std::vector<std::shared_ptr<DMatrix> >& cache_data) {
   return new LearnerImpl(cache_data);
 }
+
+void Learner::PredictDenseMulti(std::vector<DensePredictEntry> const& entries, float const* data,
+                                bst_idx_t n_rows, float missing) {
+  if (entries.empty()) {
+    return;
+  }
+  std::vector<DenseModelSlice> slices(entries.size());
+  for (std::size_t i = 0; i < entries.size(); ++i) {
+    CHECK(entries[i].learner);
+    CHECK(entries[i].out_preds);
+    auto* learner = static_cast<LearnerImpl*>(entries[i].learner);
+    learner->PrepareDense(entries[i], n_rows, &slices[i]);
+  }
+  bool supported = slices.front().predictor->PredictDenseMulti(common::Span{slices}, data,
+                                                               n_rows, missing);
+  CHECK(supported) << "Dense predict is not supported by the current predictor.";
+  for (auto const& entry : entries) {
+    static_cast<LearnerImpl*>(entry.learner)->TransformDense(entry);
+  }
+}
 }  // namespace xgboost
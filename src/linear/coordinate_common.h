@@ -4,6 +4,7 @@
  */
 #pragma once
 #include <algorithm>
+#include <cstddef>  // for size_t
 #include <string>
 #include <utility>
 #include <vector>
@@ -67,6 +68,75 @@ inline double CoordinateDeltaBias(double sum_grad, double sum_hess) {
   return -sum_grad / sum_hess;
 }
 
+// Columns with fewer entries than this are processed by a single thread, starting a
+// parallel region costs more than the column itself.
+constexpr std::size_t kMinParallelColumnSize = 1 << 14;
+
+/**
+ * \brief Whether the column has a value for every row between its first and last rows. The
+ *        entries of a CSC column are sorted by the row index without duplication.
+ */
+inline bool IsContiguousColumn(common::Span<Entry const> col) {
+  return !col.empty() && col.back().index - col.front().index + 1 == col.size();
+}
+
+/**
+ * \brief Get the gradient with respect to a single column of a CSC page. Single threaded.
+ *
+ *   Contiguous columns of single group models read the gradient without going through the
+ *   row index, which can be vectorized.
+ */
+inline std::pair<double, double> GetColumnGradient(common::Span<Entry const> col,
+                                                   int group_idx, int num_group,
+                                                   GradientPair const *gpair) {
+  double sum_grad = 0.0, sum_hess = 0.0;
+  if (num_group == 1 && IsContiguousColumn(col)) {
+    auto const *p = gpair + col.front().index;
+    auto const n = col.size();
+#pragma omp simd reduction(+ : sum_grad, sum_hess)
+    for (std::size_t j = 0; j < n; ++j) {
+      float const v = col[j].fvalue;
+      float const h = p[j].GetHess();
+      // Rows with negative hessian are ignored.
+      float const m = h < 0.0f ? 0.0f : 1.0f;
+      sum_grad += m * p[j].GetGrad() * v;
+      sum_hess += m * h * v * v;
+    }
+    return std::make_pair(sum_grad, sum_hess);
+  }
+  for (auto const &c : col) {
+    auto const &p = gpair[c.index * num_group + group_idx];
+    if (p.GetHess() < 0.0f) continue;
+    const bst_float v = c.fvalue;
+    sum_grad += p.GetGrad() * v;
+    sum_hess += p.GetHess() * v * v;
+  }
+  return std::make_pair(sum_grad, sum_hess);
+}
+
+/**
+ * \brief Updates the gradient with respect to a change in the weight of a single column.
+ *        Single threaded.
+ */
+inline void UpdateColumnResidual(common::Span<Entry const> col, int group_idx, int num_group,
+                                 float dw, GradientPair *gpair) {
+  if (num_group == 1 && IsContiguousColumn(col)) {
+    auto *p = gpair + col.front().index;
+    auto const n = col.size();
+#pragma omp simd
+    for (std::size_t j = 0; j < n; ++j) {
+      float const h = p[j].GetHess();
+      p[j] += GradientPair{h < 0.0f ? 0.0f : h * col[j].fvalue * dw, 0.0f};
+    }
+    return;
+  }
+  for (auto const &c : col) {
+    GradientPair &p = gpair[c.index * num_group + group_idx];
+    if (p.GetHess() < 0.0f) continue;
+    p += GradientPair(p.GetHess() * c.fvalue * dw, 0);
+  }
+}
+
 /**
  * \brief Get the gradient with respect to a single feature.
  *
@@ -85,15 +155,9 @@ inline std::pair<double, double> GetGradient(Context const *ctx, int group_idx,
   double sum_grad = 0.0, sum_hess = 0.0;
   for (const auto &batch : p_fmat->GetBatches<CSCPage>(ctx)) {
     auto page = batch.GetView();
-    auto col = page[fidx];
-    const auto ndata = static_cast<bst_omp_uint>(col.size());
-    for (bst_omp_uint j = 0; j < ndata; ++j) {
-      const bst_float v = col[j].fvalue;
-      auto &p = gpair[col[j].index * num_group + group_idx];
-      if (p.GetHess() < 0.0f) continue;
-      sum_grad += p.GetGrad() * v;
-      sum_hess += p.GetHess() * v * v;
-    }
+    auto [grad, hess] = GetColumnGradient(page[fidx], group_idx, num_group, gpair.data());
+    sum_grad += grad;
+    sum_hess += hess;
   }
   return std::make_pair(sum_grad, sum_hess);
 }
@@ -120,13 +184,19 @@ inline std::pair<double, double> GetGradientParallel(Context const *ctx, int gro
     auto page = batch.GetView();
     auto col = page[fidx];
     const auto ndata = static_cast<bst_omp_uint>(col.size());
+    if (ndata < kMinParallelColumnSize || ctx->Threads() == 1) {
+      auto [grad, hess] = GetColumnGradient(col, group_idx, num_group, gpair.data());
+      sum_grad_tloc[0] += grad;
+      sum_hess_tloc[0] += hess;
+      continue;
+    }
     common::ParallelFor(ndata, ctx->Threads(), [&](size_t j) {
       const bst_float v = col[j].fvalue;
       auto &p = gpair[col[j].index * num_group + group_idx];
       if (p.GetHess() < 0.0f) {
         return;
       }
-      auto t_idx = omp_get_thread_num();
+      auto t_idx = common::ThreadIdx();
       sum_grad_tloc[t_idx] += p.GetGrad() * v;
       sum_hess_tloc[t_idx] += p.GetHess() * v * v;
     });
@@ -156,7 +226,7 @@ inline std::pair<double, double> GetBiasGradientParallel(int group_idx, int num_
   std::vector<double> sum_hess_tloc(n_threads, 0);
 
   common::ParallelFor(ndata, n_threads, [&](auto i) {
-    auto tid = omp_get_thread_num();
+    auto tid = common::ThreadIdx();
     auto &p = gpair[i * num_group + group_idx];
     if (p.GetHess() >= 0.0f) {
       sum_grad_tloc[tid] += p.GetGrad();
@@ -187,6 +257,10 @@ inline void UpdateResidualParallel(Context const *ctx, bst_feature_t fidx, int g
     auto col = page[fidx];
     // update grad value
     const auto num_row = static_cast<bst_omp_uint>(col.size());
+    if (num_row < kMinParallelColumnSize || ctx->Threads() == 1) {
+      UpdateColumnResidual(col, group_idx, num_group, dw, in_gpair->data());
+      continue;
+    }
     common::ParallelFor(num_row, ctx->Threads(), [&](auto j) {
       GradientPair &p = (*in_gpair)[col[j].index * num_group + group_idx];
       if (p.GetHess() < 0.0f) return;
@@ -317,6 +391,11 @@ class RandomFeatureSelector : public FeatureSelector {
  * the largest magnitude of univariate weight change, by passing the top_k value
  * through the `param` argument of Setup(). That would reduce the complexity to
  * O(num_feature*top_k).
+ *
+ * \note Between two selections, only the gradient of the rows in the column of the last
+ * selected feature is changed by the coordinate update. The gradient sums are updated
+ * through the non-missing values of these rows instead of being computed from all the
+ * columns again, when it's cheaper.
  */
 class GreedyFeatureSelector : public FeatureSelector {
  public:
@@ -333,6 +412,7 @@ class GreedyFeatureSelector : public FeatureSelector {
     for (bst_uint gid = 0u; gid < ngroup; ++gid) {
       counter_[gid] = 0u;
     }
+    last_fidx_ = -1;
   }
 
   int NextFeature(Context const* ctx, int, const gbm::GBLinearModel &model,
@@ -345,28 +425,35 @@ class GreedyFeatureSelector : public FeatureSelector {
 
     const int ngroup = model.learner_model_param->num_output_group;
     const bst_omp_uint nfeat = model.learner_model_param->num_feature;
-    // Calculate univariate gradient sums
-    std::fill(gpair_sums_.begin(), gpair_sums_.end(), std::make_pair(0., 0.));
-    for (const auto &batch : p_fmat->GetBatches<CSCPage>(ctx)) {
-      auto page = batch.GetView();
-      common::ParallelFor(nfeat, ctx->Threads(), [&](bst_omp_uint i) {
-        const auto col = page[i];
-        const bst_uint ndata = col.size();
-        auto &sums = gpair_sums_[group_idx * nfeat + i];
-        for (bst_uint j = 0u; j < ndata; ++j) {
-          const bst_float v = col[j].fvalue;
-          auto &p = gpair[col[j].index * ngroup + group_idx];
-          if (p.GetHess() < 0.f) continue;
-          sums.first += p.GetGrad() * v;
-          sums.second += p.GetHess() * v * v;
-        }
-      });
+    auto sums = common::Span{gpair_sums_}.subspan(group_idx * nfeat, nfeat);
+    if (k == 0 || !this->UpdateSums(ctx, group_idx, ngroup, gpair, p_fmat, sums)) {
+      // Calculate univariate gradient sums
+      std::fill(sums.begin(), sums.end(), std::make_pair(0., 0.));
+      for (const auto &batch : p_fmat->GetBatches<CSCPage>(ctx)) {
+        auto page = batch.GetView();
+        common::ParallelFor(nfeat, ctx->Threads(), [&](bst_omp_uint i) {
+          const auto col = page[i];
+          const bst_uint ndata = col.size();
+          auto &sum = sums[i];
+          for (bst_uint j = 0u; j < ndata; ++j) {
+            const bst_float v = col[j].fvalue;
+            auto &p = gpair[col[j].index * ngroup + group_idx];
+            if (p.GetHess() < 0.f) continue;
+            sum.first += p.GetGrad() * v;
+            sum.second += p.GetHess() * v * v;
+          }
+        });
+      }
+      // Gradient used by the sums.
+      grad_.resize(p_fmat->Info().num_row_);
+      common::ParallelFor(grad_.size(), ctx->Threads(),
+                          [&](auto i) { grad_[i] = gpair[i * ngroup + group_idx].GetGrad(); });
     }
     // Find a feature with the largest magnitude of weight change
     int best_fidx = 0;
     double best_weight_update = 0.0f;
     for (bst_omp_uint fidx = 0; fidx < nfeat; ++fidx) {
-      auto &s = gpair_sums_[group_idx * nfeat + fidx];
+      auto &s = sums[fidx];
       float dw = std::abs(static_cast<bst_float>(
                  CoordinateDelta(s.first, s.second, model[fidx][group_idx], alpha, lambda)));
       if (dw > best_weight_update) {
@@ -374,13 +461,64 @@ class GreedyFeatureSelector : public FeatureSelector {
         best_fidx = fidx;
       }
     }
+    last_fidx_ = best_fidx;
     return best_fidx;
   }
 
  protected:
+  /**
+   * \brief Update the gradient sums with the rows changed by the last coordinate update.
+   *
+   * \return False if the sums need to be computed from all the columns, which happens
+   *         when the changed rows contain more values than what a parallel pass over
+   *         all the columns would process in each thread.
+   */
+  bool UpdateSums(Context const *ctx, int group_idx, int ngroup,
+                  std::vector<GradientPair> const &gpair, DMatrix *p_fmat,
+                  common::Span<std::pair<double, double>> sums) {
+    auto const &info = p_fmat->Info();
+    if (last_fidx_ < 0 || grad_.size() != info.num_row_) {
+      return false;
+    }
+    // Rows with a changed gradient and the change.
+    changed_.clear();
+    for (auto const &batch : p_fmat->GetBatches<CSCPage>(ctx)) {
+      auto page = batch.GetView();
+      for (auto const &c : page[last_fidx_]) {
+        auto const &p = gpair[c.index * ngroup + group_idx];
+        auto d = p.GetGrad() - grad_[c.index];
+        if (p.GetHess() < 0.f || d == 0.f) continue;
+        changed_.emplace_back(c.index, d);
+        grad_[c.index] = p.GetGrad();
+      }
+    }
+    auto n_values = static_cast<double>(changed_.size()) * info.num_nonzero_ /
+                    std::max(info.num_row_, static_cast<bst_idx_t>(1));
+    if (n_values * ctx->Threads() > static_cast<double>(info.num_nonzero_)) {
+      return false;
+    }
+    auto it = changed_.cbegin();
+    for (auto const &page : p_fmat->GetBatches<SparsePage>()) {
+      auto view = page.GetView();
+      auto row_end = page.base_rowid + page.Size();
+      for (; it != changed_.cend() && it->first < row_end; ++it) {
+        auto d = it->second;
+        for (auto const &e : view[it->first - page.base_rowid]) {
+          sums[e.index].first += d * e.fvalue;
+        }
+      }
+    }
+    return true;
+  }
+
   bst_uint top_k_;
   std::vector<bst_uint> counter_;
   std::vector<std::pair<double, double>> gpair_sums_;
+  // The last selected feature, -1 if there's none in the current round.
+  int last_fidx_{-1};
+  // Gradient of each row for the current group, as used by the gradient sums.
+  std::vector<float> grad_;
+  std::vector<std::pair<bst_idx_t, float>> changed_;
 };
 
 /**
@@ -4,6 +4,12 @@
  */
 
 #include <xgboost/linear_updater.h>
+
+#include <algorithm>  // for max
+#include <cstddef>    // for size_t
+#include <vector>     // for vector
+
+#include "../common/common.h"  // for DivRoundUp
 #include "coordinate_common.h"
 
 namespace xgboost::linear {
@@ -54,43 +60,78 @@ class ShotgunUpdater : public LinearUpdater {
     for (const auto &batch : p_fmat->GetBatches<CSCPage>(ctx_)) {
       auto page = batch.GetView();
       const auto nfeat = static_cast<bst_omp_uint>(batch.Size());
-      common::ParallelFor(nfeat, ctx_->Threads(), [&](auto i) {
-        int ii = selector_->NextFeature(ctx_, i, *model, 0, gpair->ConstHostVector(), p_fmat,
-                                        param_.reg_alpha_denorm, param_.reg_lambda_denorm);
-        if (ii < 0) return;
-        const bst_uint fid = ii;
-        auto col = page[ii];
-        for (int gid = 0; gid < ngroup; ++gid) {
-          double sum_grad = 0.0, sum_hess = 0.0;
-          for (auto &c : col) {
-            const GradientPair &p = h_gpair[c.index * ngroup + gid];
-            if (p.GetHess() < 0.0f) continue;
-            const bst_float v = c.fvalue;
-            sum_grad += p.GetGrad() * v;
-            sum_hess += p.GetHess() * v * v;
-          }
-          bst_float &w = (*model)[fid][gid];
-          auto dw = static_cast<bst_float>(
-              param_.learning_rate * CoordinateDelta(sum_grad, sum_hess, w, param_.reg_alpha_denorm,
-                                                     param_.reg_lambda_denorm));
-          if (dw == 0.f) continue;
-          w += dw;
-          // update grad values
-          for (auto &c : col) {
-            GradientPair &p = h_gpair[c.index * ngroup + gid];
-            if (p.GetHess() < 0.0f) continue;
-            p += GradientPair(p.GetHess() * c.fvalue * dw, 0);
+      this->InitFeatureBlocks(page, nfeat, *model, h_gpair, p_fmat);
+      // Each thread takes a block of features at a time and updates the shared gradient
+      // without synchronization, as in Hogwild. Concurrent updates of the same row can be
+      // lost, which only adds noise to the descent.
+      auto n_blocks = block_ptr_.size() - 1;
+      common::ParallelFor(n_blocks, ctx_->Threads(), common::Sched::Dyn(), [&](auto k) {
+        for (auto i = block_ptr_[k]; i < block_ptr_[k + 1]; ++i) {
+          auto ii = features_[i];
+          if (ii < 0) continue;
+          const bst_uint fid = ii;
+          auto col = page[ii];
+          for (int gid = 0; gid < ngroup; ++gid) {
+            auto [sum_grad, sum_hess] = GetColumnGradient(col, gid, ngroup, h_gpair.data());
+            bst_float &w = (*model)[fid][gid];
+            auto dw = static_cast<bst_float>(
+                param_.learning_rate * CoordinateDelta(sum_grad, sum_hess, w,
+                                                       param_.reg_alpha_denorm,
+                                                       param_.reg_lambda_denorm));
+            if (dw == 0.f) continue;
+            w += dw;
+            // update grad values
+            UpdateColumnResidual(col, gid, ngroup, dw, h_gpair.data());
           }
         }
       });
     }
   }
 
+ private:
+  /**
+   * \brief Split the features of a CSC page into blocks with a similar number of entries,
+   *        so that the threads are balanced when the feature sizes vary.
+   */
+  void InitFeatureBlocks(HostSparsePageView const &page, bst_omp_uint nfeat,
+                         gbm::GBLinearModel const &model,
+                         std::vector<GradientPair> const &gpair, DMatrix *p_fmat) {
+    // Number of blocks for each thread, for dynamic load balancing.
+    constexpr std::size_t kBlocksPerThread = 8;
+    features_.resize(nfeat);
+    std::size_t n_entries = 0;
+    for (bst_omp_uint i = 0; i < nfeat; ++i) {
+      features_[i] = selector_->NextFeature(ctx_, i, model, 0, gpair, p_fmat,
+                                            param_.reg_alpha_denorm, param_.reg_lambda_denorm);
+      n_entries += features_[i] < 0 ? 0 : page[features_[i]].size();
+    }
+    auto n_blocks = std::max(static_cast<std::size_t>(ctx_->Threads()) * kBlocksPerThread,
+                             static_cast<std::size_t>(1));
+    // Add one for each feature to account for the cost of empty features.
+    auto block_size = common::DivRoundUp(n_entries + nfeat, n_blocks);
+    block_ptr_.clear();
+    block_ptr_.push_back(0);
+    std::size_t acc = 0;
+    for (bst_omp_uint i = 0; i < nfeat; ++i) {
+      acc += (features_[i] < 0 ? 0 : page[features_[i]].size()) + 1;
+      if (acc >= block_size) {
+        block_ptr_.push_back(i + 1);
+        acc = 0;
+      }
+    }
+    if (block_ptr_.back() != nfeat) {
+      block_ptr_.push_back(nfeat);
+    }
+  }
+
  protected:
   // training parameters
   LinearTrainParam param_;
 
   std::unique_ptr<FeatureSelector> selector_;
+  // Order of the features and the boundaries of the feature blocks.
+  std::vector<int> features_;
+  std::vector<bst_omp_uint> block_ptr_;
 };
 
 XGBOOST_REGISTER_LINEAR_UPDATER(ShotgunUpdater, "shotgun")
@@ -14,9 +14,10 @@
 #include <utility>
 #include <vector>
 
-#include "../common/algorithm.h"        // ArgSort
+#include "../common/algorithm.h"        // SegmentedArgSort, RadixArgSortDesc
 #include "../common/math.h"
 #include "../common/optional_weight.h"  // OptionalWeights
+#include "../common/threading_utils.h"  // ParallelFor
 #include "metric_common.h"              // MetricNoCache
 #include "xgboost/context.h"
 #include "xgboost/host_device_vector.h"
@@ -26,6 +27,125 @@
 namespace xgboost::metric {
 // tag the this file, used by force static link later.
 DMLC_REGISTRY_FILE_TAG(auc);
+DMLC_REGISTER_PARAMETER(AUCParam);
+
+namespace detail {
+std::pair<double, double> HistogramROCAUC(linalg::MatrixView<double const> hist) {
+  double fp{0}, tp{0}, auc{0}, bound{0};
+  for (std::size_t b = 0; b < hist.Shape(0); ++b) {
+    double fp_prev = fp, tp_prev = tp;
+    fp += hist(b, 0);
+    tp += hist(b, 1);
+    auc += TrapezoidArea(fp_prev, fp, tp_prev, tp);
+    bound += hist(b, 0) * hist(b, 1) * 0.5;
+  }
+  if (fp <= 0 || tp <= 0) {
+    return {std::numeric_limits<double>::quiet_NaN(), 0.0};
+  }
+  return {std::min(auc / (fp * tp), 1.0), bound / (fp * tp)};
+}
+
+std::pair<double, double> HistogramPRAUC(linalg::MatrixView<double const> hist) {
+  double total_pos{0}, total_neg{0};
+  for (std::size_t b = 0; b < hist.Shape(0); ++b) {
+    total_neg += hist(b, 0);
+    total_pos += hist(b, 1);
+  }
+  if (total_pos <= 0 || total_neg <= 0) {
+    return {std::numeric_limits<double>::quiet_NaN(), 0.0};
+  }
+  double fp{0}, tp{0}, auc{0}, bound{0};
+  for (std::size_t b = 0; b < hist.Shape(0); ++b) {
+    if (hist(b, 0) == 0 && hist(b, 1) == 0) {
+      continue;
+    }
+    double fp_prev = fp, tp_prev = tp;
+    fp += hist(b, 0);
+    tp += hist(b, 1);
+    auc += CalcDeltaPRAUC(fp_prev, fp, tp_prev, tp, total_pos);
+    if (hist(b, 1) > 0) {
+      // Area of the bin with `n_neg` negative samples ranked before all the positive
+      // samples of the bin.
+      auto area = [&](double n_neg) {
+        auto pos = hist(b, 1);
+        return (n_neg > 0 ? pos - n_neg * std::log((tp + n_neg) / (tp_prev + n_neg)) : pos) /
+               total_pos;
+      };
+      // The area is the largest when the positive samples of the bin come first, and the
+      // smallest when they come last.
+      bound += area(fp_prev) - area(fp);
+    }
+  }
+  return {auc, bound};
+}
+}  // namespace detail
+
+/**
+ * Build a histogram of the prediction for approximating the AUC of binary classification.
+ * The bins have equal width between the global minimum and maximum of the prediction, and
+ * are ordered from the highest prediction to the lowest. Each bin has the weighted number
+ * of negative and positive samples, summed across workers.
+ */
+linalg::Matrix<double> BinaryHistogram(Context const *ctx, common::Span<float const> predts,
+                                       MetaInfo const &info, bst_bin_t n_bins) {
+  CHECK_GT(n_bins, 0);
+  auto labels = info.labels.HostView().Slice(linalg::All(), 0);
+  auto weights = common::OptionalWeights{info.weights_.ConstHostSpan()};
+  if (labels.Size() == 0) {
+    // Empty worker.
+    predts = predts.subspan(0, 0);
+  }
+  CHECK_EQ(labels.Size(), predts.size());
+  auto n_threads = ctx->Threads();
+
+  std::vector<double> t_lo(n_threads, std::numeric_limits<double>::infinity());
+  std::vector<double> t_hi(n_threads, -std::numeric_limits<double>::infinity());
+  common::ParallelFor(predts.size(), n_threads, common::Sched::Static(), [&](std::size_t i) {
+    auto t = common::ThreadIdx();
+    double v = predts[i];
+    if (std::isfinite(v)) {
+      t_lo[t] = std::min(t_lo[t], v);
+      t_hi[t] = std::max(t_hi[t], v);
+    }
+  });
+  // The negated minimum and the maximum.
+  std::array<double, 2> range{-*std::min_element(t_lo.cbegin(), t_lo.cend()),
+                              *std::max_element(t_hi.cbegin(), t_hi.cend())};
+  if (info.IsRowSplit()) {
+    auto rc = collective::Allreduce(ctx, linalg::MakeVec(range.data(), range.size()),
+                                    collective::Op::kMax);
+    collective::SafeColl(rc);
+  }
+  double lo = -range[0], hi = range[1];
+  double scale = hi > lo ? static_cast<double>(n_bins) / (hi - lo) : 0.0;
+
+  std::vector<double> t_hist(static_cast<std::size_t>(n_threads) * n_bins * 2, 0.0);
+  common::ParallelFor(predts.size(), n_threads, common::Sched::Static(), [&](std::size_t i) {
+    auto t = common::ThreadIdx();
+    auto x = (predts[i] - lo) * scale;
+    auto b = std::isnan(x) ? 0 : static_cast<bst_bin_t>(std::clamp(x, 0.0, n_bins - 1.0));
+    auto idx = (static_cast<std::size_t>(t) * n_bins + (n_bins - 1 - b)) * 2;
+    auto w = weights[i];
+    auto y = labels(i);
+    t_hist[idx] += (1.0 - y) * w;
+    t_hist[idx + 1] += y * w;
+  });
+
+  linalg::Matrix<double> hist{{static_cast<std::size_t>(n_bins), static_cast<std::size_t>(2)},
+                              DeviceOrd::CPU()};
+  auto h_hist = hist.HostView();
+  common::ParallelFor(n_bins, n_threads, [&](auto b) {
+    for (std::int32_t t = 0; t < n_threads; ++t) {
+      auto idx = (static_cast<std::size_t>(t) * n_bins + b) * 2;
+      h_hist(b, 0) += t_hist[idx];
+      h_hist(b, 1) += t_hist[idx + 1];
+    }
+  });
+  auto rc = collective::GlobalSum(ctx, info, h_hist);
+  collective::SafeColl(rc);
+  return hist;
+}
+
 /**
  * Calculate AUC for binary classification problem.  This function does not normalize the
  * AUC by 1 / (num_positive * num_negative), instead it returns a tuple for caller to
@@ -35,7 +155,7 @@ template <typename Fn>
 std::tuple<double, double, double>
 BinaryAUC(common::Span<float const> predts, linalg::VectorView<float const> labels,
           common::OptionalWeights weights,
-          std::vector<size_t> const &sorted_idx, Fn &&area_fn) {
+          common::Span<std::size_t const> sorted_idx, Fn &&area_fn) {
   CHECK_NE(labels.Size(), 0);
   CHECK_EQ(labels.Size(), predts.size());
   auto p_predts = predts.data();
@@ -141,22 +261,18 @@ std::tuple<double, double, double> BinaryROCAUC(Context const *ctx,
                                                 common::Span<float const> predts,
                                                 linalg::VectorView<float const> labels,
                                                 common::OptionalWeights weights) {
-  auto const sorted_idx =
-      common::ArgSort<size_t>(ctx, predts.data(), predts.data() + predts.size(), std::greater<>{});
-  return BinaryAUC(predts, labels, weights, sorted_idx, TrapezoidArea);
+  auto const sorted_idx = common::RadixArgSortDesc<size_t>(ctx, predts);
+  return BinaryAUC(predts, labels, weights, common::Span{sorted_idx}, TrapezoidArea);
 }
 
 /**
- * Calculate AUC for 1 ranking group;
+ * Calculate AUC for 1 ranking group, with the documents sorted by the label in descending
+ * order.
  */
-double GroupRankingROC(Context const* ctx, common::Span<float const> predts,
-                       linalg::VectorView<float const> labels, float w) {
+double GroupRankingROC(common::Span<float const> predts, linalg::VectorView<float const> labels,
+                       common::Span<std::size_t const> sorted_idx, float w) {
   // on ranking, we just count all pairs.
   double auc{0};
-  // argsort doesn't support tensor input yet.
-  auto raw_labels = labels.Values().subspan(0, labels.Size());
-  auto const sorted_idx = common::ArgSort<size_t>(
-      ctx, raw_labels.data(), raw_labels.data() + raw_labels.size(), std::greater<>{});
   w = common::Sqr(w);
 
   double sum_w = 0.0f;
@@ -182,15 +298,15 @@ double GroupRankingROC(Context const* ctx, common::Span<float const> predts,
 }
 
 /**
- * \brief PR-AUC for binary classification.
+ * \brief PR-AUC for binary classification, with the predictions sorted in descending
+ *        order.
  *
  *   https://doi.org/10.1371/journal.pone.0092209
  */
-std::tuple<double, double, double> BinaryPRAUC(Context const *ctx, common::Span<float const> predts,
-                                               linalg::VectorView<float const> labels,
-                                               common::OptionalWeights weights) {
-  auto const sorted_idx =
-      common::ArgSort<size_t>(ctx, predts.data(), predts.data() + predts.size(), std::greater<>{});
+std::tuple<double, double, double> BinaryPRAUCSorted(common::Span<float const> predts,
+                                                     linalg::VectorView<float const> labels,
+                                                     common::OptionalWeights weights,
+                                                     common::Span<std::size_t const> sorted_idx) {
   double total_pos{0}, total_neg{0};
   for (size_t i = 0; i < labels.Size(); ++i) {
     auto w = weights[i];
@@ -209,6 +325,13 @@ std::tuple<double, double, double> BinaryPRAUC(Context const *ctx, common::Span<
   return std::make_tuple(1.0, 1.0, auc);
 }
 
+std::tuple<double, double, double> BinaryPRAUC(Context const *ctx, common::Span<float const> predts,
+                                               linalg::VectorView<float const> labels,
+                                               common::OptionalWeights weights) {
+  auto const sorted_idx = common::RadixArgSortDesc<size_t>(ctx, predts);
+  return BinaryPRAUCSorted(predts, labels, weights, common::Span{sorted_idx});
+}
+
 /**
  * Cast LTR problem to binary classification problem by comparing pairs.
  */
@@ -223,6 +346,12 @@ std::pair<double, uint32_t> RankingAUC(Context const *ctx, std::vector<float> co
 
   std::atomic<uint32_t> invalid_groups{0};
 
+  // Sort all the groups at once, by the label for ROC and by the prediction for PR.
+  std::vector<std::size_t> sorted_idx(predts.size());
+  auto keys = is_roc ? labels.Values().subspan(0, labels.Size()) : s_predts;
+  common::SegmentedArgSort(ctx, keys, common::Span<bst_group_t const>{info.group_ptr_}, true,
+                           common::Span{sorted_idx});
+
   std::vector<double> auc_tloc(n_threads, 0);
   common::ParallelFor(n_groups, n_threads, [&](size_t g) {
     g += 1;  // indexing needs to start from 1
@@ -230,6 +359,8 @@ std::pair<double, uint32_t> RankingAUC(Context const *ctx, std::vector<float> co
     float w = s_weights.empty() ? 1.0f : s_weights[g - 1];
     auto g_predts = s_predts.subspan(info.group_ptr_[g - 1], cnt);
     auto g_labels = labels.Slice(linalg::Range(info.group_ptr_[g - 1], info.group_ptr_[g]));
+    auto g_sorted_idx = common::Span<std::size_t const>{sorted_idx}.subspan(
+        info.group_ptr_[g - 1], cnt);
     double auc;
     if (is_roc && g_labels.Size() < 3) {
       // With 2 documents, there's only 1 comparison can be made.  So either
@@ -238,16 +369,17 @@ std::pair<double, uint32_t> RankingAUC(Context const *ctx, std::vector<float> co
       auc = 0;
     } else {
       if (is_roc) {
-        auc = GroupRankingROC(ctx, g_predts, g_labels, w);
+        auc = GroupRankingROC(g_predts, g_labels, g_sorted_idx, w);
       } else {
-        auc = std::get<2>(BinaryPRAUC(ctx, g_predts, g_labels, common::OptionalWeights{w}));
+        auc = std::get<2>(
+            BinaryPRAUCSorted(g_predts, g_labels, common::OptionalWeights{w}, g_sorted_idx));
       }
       if (std::isnan(auc)) {
         invalid_groups++;
         auc = 0;
       }
     }
-    auc_tloc[omp_get_thread_num()] += auc;
+    auc_tloc[common::ThreadIdx()] += auc;
   });
   double sum_auc = std::accumulate(auc_tloc.cbegin(), auc_tloc.cend(), 0.0);
 
@@ -256,6 +388,23 @@ std::pair<double, uint32_t> RankingAUC(Context const *ctx, std::vector<float> co
 
 template <typename Curve>
 class EvalAUC : public MetricNoCache {
+  AUCParam param_;
+
+ public:
+  void Configure(Args const &args) override { param_.UpdateAllowUnknown(args); }
+  void LoadConfig(Json const &in) override {
+    auto const &obj = get<Object const>(in);
+    auto it = obj.find("auc_param");
+    if (it != obj.cend()) {
+      FromJson(it->second, &param_);
+    }
+  }
+  void SaveConfig(Json *p_out) const override {
+    auto &out = *p_out;
+    out["name"] = String(this->Name());
+    out["auc_param"] = ToJson(param_);
+  }
+
   double Eval(const HostDeviceVector<bst_float> &preds, const MetaInfo &info) override {
     double auc {0};
     if (ctx_->Device().IsCUDA()) {
@@ -309,12 +458,21 @@ class EvalAUC : public MetricNoCache {
       /**
        * binary classification
        */
-      double fp{0}, tp{0};
-      if (!(preds.Empty() || info.labels.Size() == 0)) {
-        std::tie(fp, tp, auc) =
-            static_cast<Curve *>(this)->EvalBinary(preds, info);
+      bool approx = param_.auc_approx_bins != 0 && !ctx_->IsCUDA();
+      if (approx) {
+        auto hist = BinaryHistogram(ctx_, preds.ConstHostSpan(), info, param_.auc_approx_bins);
+        double bound{0};
+        std::tie(auc, bound) = Curve::IntegrateHistogram(std::as_const(hist).HostView());
+        // The bound is global, all workers fall back to the exact AUC together.
+        approx = std::isnan(auc) || bound <= param_.auc_approx_tolerance;
+      }
+      if (!approx) {
+        double fp{0}, tp{0};
+        if (!(preds.Empty() || info.labels.Size() == 0)) {
+          std::tie(fp, tp, auc) = static_cast<Curve *>(this)->EvalBinary(preds, info);
+        }
+        auc = collective::GlobalRatio(ctx_, info, auc, fp * tp);
       }
-      auc = collective::GlobalRatio(ctx_, info, auc, fp * tp);
       if (!std::isnan(auc)) {
         CHECK_LE(auc, 1.0 + kRtEps);
         auc = std::min(auc, 1.0);
@@ -331,6 +489,10 @@ class EvalROCAUC : public EvalAUC<EvalROCAUC> {
   std::shared_ptr<DeviceAUCCache> d_cache_;
 
  public:
+  static std::pair<double, double> IntegrateHistogram(linalg::MatrixView<double const> hist) {
+    return detail::HistogramROCAUC(hist);
+  }
+
   std::pair<double, uint32_t> EvalRanking(HostDeviceVector<float> const &predts,
                                           MetaInfo const &info) {
     double auc{0};
@@ -410,6 +572,10 @@ class EvalPRAUC : public EvalAUC<EvalPRAUC> {
   std::shared_ptr<DeviceAUCCache> d_cache_;
 
  public:
+  static std::pair<double, double> IntegrateHistogram(linalg::MatrixView<double const> hist) {
+    return detail::HistogramPRAUC(hist);
+  }
+
   std::tuple<double, double, double>
   EvalBinary(HostDeviceVector<float> const &predts, MetaInfo const &info) {
     double pr, re, auc;
@@ -11,10 +11,32 @@
 #include "../collective/communicator-inl.h"
 #include "xgboost/base.h"
 #include "xgboost/data.h"
+#include "xgboost/linalg.h"
 #include "xgboost/metric.h"
+#include "xgboost/parameter.h"
 #include "xgboost/span.h"
 
 namespace xgboost::metric {
+struct AUCParam : public XGBoostParameter<AUCParam> {
+  bst_bin_t auc_approx_bins{0};
+  float auc_approx_tolerance{1e-3f};
+
+  DMLC_DECLARE_PARAMETER(AUCParam) {
+    DMLC_DECLARE_FIELD(auc_approx_bins)
+        .set_default(0)
+        .set_lower_bound(0)
+        .describe(
+            "Number of equal width bins of the prediction for approximating the AUC of binary "
+            "classification on CPU, 0 for the exact AUC.");
+    DMLC_DECLARE_FIELD(auc_approx_tolerance)
+        .set_default(1e-3f)
+        .set_range(0.0f, 1.0f)
+        .describe(
+            "Upper bound of the error of the approximated AUC. The exact AUC is computed "
+            "when the bound of the histogram is larger than this value.");
+  }
+};
+
 /***********
  * ROC AUC *
  ***********/
@@ -93,6 +115,23 @@ XGBOOST_DEVICE inline double CalcDeltaPRAUC(double fp_prev, double fp,
   }
   return area;
 }
+/**
+ * @brief Integrate the ROC curve of a histogram of the prediction.
+ *
+ * @param hist Weighted number of negative and positive samples in each bin, the bins are
+ *             in descending order of the prediction.
+ *
+ * @return The normalized AUC and the bound of its error. The samples in the same bin are
+ *         treated as ties, the error is at most half of the positive-negative pairs inside
+ *         the bins.
+ */
+std::pair<double, double> HistogramROCAUC(linalg::MatrixView<double const> hist);
+/**
+ * @brief Integrate the PR curve of a histogram of the prediction, see @ref
+ *        HistogramROCAUC. The bound of each bin is the difference between the areas of
+ *        the two extreme orderings inside the bin, with the positive samples first or last.
+ */
+std::pair<double, double> HistogramPRAUC(linalg::MatrixView<double const> hist);
 }  // namespace detail
 
 inline void InvalidGroupAUC() {
@@ -93,7 +93,7 @@ PackedReduceResult Reduce(Context const* ctx, MetaInfo const& info, Fn&& loss) {
         sum_weight += wt;
       }
 
-      auto t_idx = omp_get_thread_num();
+      auto t_idx = common::ThreadIdx();
       score_tloc[t_idx] += sum_score;
       weight_tloc[t_idx] += sum_weight;
     });
@@ -352,17 +352,46 @@ struct EvalTweedieNLogLik {
  * \tparam Derived the name of subclass
  */
 template <typename Policy>
-struct EvalEWiseBase : public MetricNoCache {
+struct EvalEWiseBase : public RowwiseMetric {
   EvalEWiseBase() = default;
   explicit EvalEWiseBase(char const* policy_param) : policy_{policy_param} {}
 
+  [[nodiscard]] RowKernel MakeRowKernel(HostDeviceVector<float> const& preds,
+                                        MetaInfo const& info) const override {
+    CheckShape(preds, info);
+    auto labels = info.labels.HostView();
+    common::OptionalWeights weights(info.weights_.ConstHostSpan());
+    auto predts = preds.ConstHostSpan();
+    auto policy = policy_;
+    return [=](std::size_t begin, std::size_t end) {
+      auto n_targets = labels.Shape(1);
+      double sum_score = 0, sum_weight = 0;
+      for (std::size_t sample_id = begin; sample_id < end; ++sample_id) {
+        float wt = weights[sample_id];
+        for (std::size_t target_id = 0; target_id < n_targets; ++target_id) {
+          auto i = sample_id * n_targets + target_id;
+          float residue = policy.EvalRow(labels(sample_id, target_id), predts[i]);
+          residue *= wt;
+          sum_score += residue;
+          sum_weight += wt;
+        }
+      }
+      return PackedReduceResult{sum_score, sum_weight};
+    };
+  }
+
+  [[nodiscard]] double Finalize(double residue, double weights) const override {
+    return Policy::GetFinal(residue, weights);
+  }
+
   double Eval(HostDeviceVector<bst_float> const& preds, const MetaInfo& info) override {
-    CHECK_EQ(preds.Size(), info.labels.Size())
-        << "label and prediction size not match, "
-        << "hint: use merror or mlogloss for multi-class classification";
-    if (info.labels.Size() != 0) {
-      CHECK_NE(info.labels.Shape(1), 0);
+    if (!ctx_->IsCUDA()) {
+      double result{0};
+      RowwiseMetric const* self = this;
+      EvalRowwise(ctx_, {&self, 1}, preds, info, {&result, 1});
+      return result;
     }
+    CheckShape(preds, info);
     auto device = ctx_->Device().IsSycl() ? DeviceOrd::CPU() : ctx_->Device();
     auto labels = info.labels.View(device);
     info.weights_.SetDevice(device);
@@ -389,6 +418,15 @@ struct EvalEWiseBase : public MetricNoCache {
   [[nodiscard]] const char* Name() const override { return policy_.Name(); }
 
  private:
+  static void CheckShape(HostDeviceVector<float> const& preds, MetaInfo const& info) {
+    CHECK_EQ(preds.Size(), info.labels.Size())
+        << "label and prediction size not match, "
+        << "hint: use merror or mlogloss for multi-class classification";
+    if (info.labels.Size() != 0) {
+      CHECK_NE(info.labels.Shape(1), 0);
+    }
+  }
+
   Policy policy_;
 };
 
@@ -7,6 +7,10 @@
 #include <xgboost/context.h>
 #include <xgboost/metric.h>
 
+#include <algorithm>  // for min
+
+#include "../common/common.h"           // for DivRoundUp
+#include "../common/threading_utils.h"  // for ParallelFor
 #include "metric_common.h"
 
 namespace xgboost {
@@ -52,6 +56,78 @@ Metric::Create(const std::string& name, Context const* ctx) {
   metric->ctx_ = ctx;
   return metric;
 }
+
+namespace metric {
+void EvalRowwise(Context const* ctx, common::Span<RowwiseMetric const* const> metrics,
+                 HostDeviceVector<float> const& predts, MetaInfo const& info,
+                 common::Span<double> out) {
+  CHECK_EQ(metrics.size(), out.size());
+  std::vector<RowwiseMetric::RowKernel> kernels;
+  for (auto const* metric : metrics) {
+    kernels.emplace_back(metric->MakeRowKernel(predts, info));
+  }
+
+  std::size_t const n_samples = info.labels.Shape(0);
+  std::size_t const n_metrics = metrics.size();
+  // Small enough for the predictions of a block to stay in the cache across the metrics.
+  std::size_t constexpr kBlockSize = 2048;
+  auto n_blocks = common::DivRoundUp(n_samples, kBlockSize);
+  std::vector<PackedReduceResult> partial(n_blocks * n_metrics);
+  common::ParallelFor(n_blocks, ctx->Threads(), [&](auto block_idx) {
+    auto begin = block_idx * kBlockSize;
+    auto end = std::min(n_samples, begin + kBlockSize);
+    for (std::size_t k = 0; k < n_metrics; ++k) {
+      partial[block_idx * n_metrics + k] = kernels[k](begin, end);
+    }
+  });
+
+  std::vector<double> dat(n_metrics * 2, 0.0);
+  for (std::size_t i = 0; i < n_blocks; ++i) {
+    for (std::size_t k = 0; k < n_metrics; ++k) {
+      dat[k * 2] += partial[i * n_metrics + k].Residue();
+      dat[k * 2 + 1] += partial[i * n_metrics + k].Weights();
+    }
+  }
+  auto rc = collective::GlobalSum(ctx, info, linalg::MakeVec(dat.data(), dat.size()));
+  collective::SafeColl(rc);
+  for (std::size_t k = 0; k < n_metrics; ++k) {
+    out[k] = metrics[k]->Finalize(dat[k * 2], dat[k * 2 + 1]);
+  }
+}
+
+std::vector<double> EvaluateMetrics(Context const* ctx,
+                                    common::Span<std::unique_ptr<Metric> const> metrics,
+                                    HostDeviceVector<float> const& predts,
+                                    std::shared_ptr<DMatrix> p_fmat) {
+  std::vector<double> results(metrics.size());
+  std::vector<RowwiseMetric const*> rowwise;
+  std::vector<std::size_t> rowwise_idx;
+  for (std::size_t i = 0; i < metrics.size(); ++i) {
+    auto const* p_rowwise =
+        ctx->IsCPU() ? dynamic_cast<RowwiseMetric const*>(metrics[i].get()) : nullptr;
+    if (p_rowwise) {
+      rowwise.push_back(p_rowwise);
+      rowwise_idx.push_back(i);
+    } else {
+      results[i] = metrics[i]->Evaluate(predts, p_fmat);
+    }
+  }
+  if (rowwise.size() == 1) {
+    results[rowwise_idx.front()] = metrics[rowwise_idx.front()]->Evaluate(predts, p_fmat);
+  } else if (!rowwise.empty()) {
+    // Same as the `Evaluate` of each metric, the labels are only available on the first
+    // worker for vertical federated learning.
+    auto const& info = p_fmat->Info();
+    std::vector<double> fused(rowwise.size(), 0.0);
+    collective::ApplyWithLabels(ctx, info, fused.data(), fused.size() * sizeof(double),
+                                [&] { EvalRowwise(ctx, rowwise, predts, info, fused); });
+    for (std::size_t k = 0; k < rowwise.size(); ++k) {
+      results[rowwise_idx[k]] = fused[k];
+    }
+  }
+  return results;
+}
+}  // namespace metric
 }  // namespace xgboost
 
 namespace dmlc {
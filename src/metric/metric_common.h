@@ -4,12 +4,16 @@
 #ifndef XGBOOST_METRIC_METRIC_COMMON_H_
 #define XGBOOST_METRIC_METRIC_COMMON_H_
 
+#include <cstddef>     // for size_t
+#include <functional>  // for function
 #include <limits>
 #include <memory>  // shared_ptr
 #include <string>
+#include <vector>  // for vector
 
 #include "../collective/aggregator.h"
 #include "xgboost/metric.h"
+#include "xgboost/span.h"  // for Span
 
 namespace xgboost {
 struct Context;
@@ -60,6 +64,45 @@ class PackedReduceResult {
   [[nodiscard]] double Weights() const { return weights_sum_; }
 };
 
+/**
+ * @brief Metric from the weighted sum of a loss over the samples. On CPU, the rowwise
+ *        metrics of a data set can share a single pass over the data, see
+ *        @ref EvaluateMetrics.
+ */
+class RowwiseMetric : public MetricNoCache {
+ public:
+  /** @brief Sum of the weighted loss and the weights for the samples in [begin, end). */
+  using RowKernel = std::function<PackedReduceResult(std::size_t begin, std::size_t end)>;
+  /**
+   * @brief Validate the input, and create the kernel for the samples on CPU. The kernel
+   *        refers to the input.
+   */
+  [[nodiscard]] virtual RowKernel MakeRowKernel(HostDeviceVector<float> const &predts,
+                                                MetaInfo const &info) const = 0;
+  /** @brief The metric from the global sums. */
+  [[nodiscard]] virtual double Finalize(double residue, double weights) const = 0;
+};
+
+/**
+ * @brief Evaluate rowwise metrics on CPU with one parallel pass over blocks of samples, and
+ *        one allreduce for all of them.
+ *
+ *   The sums are accumulated in the order of the blocks, the result is the same for any
+ *   number of threads and any combination of metrics.
+ */
+void EvalRowwise(Context const *ctx, common::Span<RowwiseMetric const *const> metrics,
+                 HostDeviceVector<float> const &predts, MetaInfo const &info,
+                 common::Span<double> out);
+
+/**
+ * @brief Evaluate all the metrics on a data set. The rowwise metrics are fused into a single
+ *        pass on CPU, the others are evaluated one by one.
+ *
+ * @return The result of each metric.
+ */
+[[nodiscard]] std::vector<double> EvaluateMetrics(
+    Context const *ctx, common::Span<std::unique_ptr<Metric> const> metrics,
+    HostDeviceVector<float> const &predts, std::shared_ptr<DMatrix> p_fmat);
 }  // namespace metric
 }  // namespace xgboost
 
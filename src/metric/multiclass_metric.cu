@@ -30,7 +30,7 @@ DMLC_REGISTRY_FILE_TAG(multiclass_metric);
 
 template <typename EvalRowPolicy>
 class MultiClassMetricsReduction {
-  void CheckLabelError(int32_t label_error, size_t n_class) const {
+  static void CheckLabelError(int32_t label_error, size_t n_class) {
     CHECK(label_error >= 0 && label_error < static_cast<int32_t>(n_class))
         << "MultiClassEvaluation: label must be in [0, num_class),"
         << " num_class=" << n_class << " but found " << label_error << " in label";
@@ -39,45 +39,28 @@ class MultiClassMetricsReduction {
  public:
   MultiClassMetricsReduction() = default;
 
-  [[nodiscard]] PackedReduceResult CpuReduceMetrics(const HostDeviceVector<bst_float>& weights,
-                                                    const HostDeviceVector<bst_float>& labels,
-                                                    const HostDeviceVector<bst_float>& preds,
-                                                    const size_t n_class, int32_t n_threads) const {
-    size_t ndata = labels.Size();
-
-    const auto& h_labels = labels.HostVector();
-    const auto& h_weights = weights.HostVector();
-    const auto& h_preds = preds.HostVector();
-
-    std::atomic<int> label_error {0};
-    bool const is_null_weight = weights.Size() == 0;
-
-    std::vector<double> scores_tloc(n_threads, 0);
-    std::vector<double> weights_tloc(n_threads, 0);
-    common::ParallelFor(ndata, n_threads, [&](size_t idx) {
+  /** @brief Kernel for the samples on CPU, see @ref RowwiseMetric. */
+  [[nodiscard]] static RowwiseMetric::RowKernel MakeRowKernel(
+      const HostDeviceVector<bst_float>& weights, const HostDeviceVector<bst_float>& labels,
+      const HostDeviceVector<bst_float>& preds, const size_t n_class) {
+    auto h_labels = labels.ConstHostSpan();
+    auto h_weights = weights.ConstHostSpan();
+    auto h_preds = preds.ConstHostSpan();
+    bool const is_null_weight = h_weights.empty();
+    return [=](std::size_t begin, std::size_t end) {
+      double residue_sum = 0, weights_sum = 0;
+      for (std::size_t idx = begin; idx < end; ++idx) {
         bst_float weight = is_null_weight ? 1.0f : h_weights[idx];
         auto label = static_cast<int>(h_labels[idx]);
-        if (label >= 0 && label < static_cast<int>(n_class)) {
-          auto t_idx = omp_get_thread_num();
-          scores_tloc[t_idx] +=
-              EvalRowPolicy::EvalRow(label, h_preds.data() + idx * n_class,
-                                     n_class) *
-              weight;
-          weights_tloc[t_idx] += weight;
-        } else {
-          label_error = label;
+        if (label < 0 || label >= static_cast<int>(n_class)) {
+          CheckLabelError(label, n_class);
         }
-    });
-
-    double residue_sum =
-        std::accumulate(scores_tloc.cbegin(), scores_tloc.cend(), 0.0);
-    double weights_sum =
-        std::accumulate(weights_tloc.cbegin(), weights_tloc.cend(), 0.0);
-
-    CheckLabelError(label_error, n_class);
-    PackedReduceResult res { residue_sum, weights_sum };
-
-    return res;
+        residue_sum +=
+            EvalRowPolicy::EvalRow(label, h_preds.data() + idx * n_class, n_class) * weight;
+        weights_sum += weight;
+      }
+      return PackedReduceResult{residue_sum, weights_sum};
+    };
   }
 
 #if defined(XGBOOST_USE_CUDA)
@@ -129,12 +112,8 @@ class MultiClassMetricsReduction {
                             const HostDeviceVector<bst_float>& labels,
                             const HostDeviceVector<bst_float>& preds) {
     PackedReduceResult result;
-
-    if (ctx->IsCPU()) {
-      result = CpuReduceMetrics(weights, labels, preds, n_class, ctx->Threads());
-    }
 #if defined(XGBOOST_USE_CUDA)
-    else {  // NOLINT
+    {
       preds.SetDevice(ctx->Device());
       labels.SetDevice(ctx->Device());
       weights.SetDevice(ctx->Device());
@@ -157,19 +136,28 @@ class MultiClassMetricsReduction {
  * \tparam Derived the name of subclass
  */
 template<typename Derived>
-struct EvalMClassBase : public MetricNoCache {
+struct EvalMClassBase : public RowwiseMetric {
+  [[nodiscard]] RowKernel MakeRowKernel(HostDeviceVector<float> const &preds,
+                                        MetaInfo const &info) const override {
+    auto nclass = CheckShape(preds, info);
+    return MultiClassMetricsReduction<Derived>::MakeRowKernel(info.weights_, *info.labels.Data(),
+                                                              preds, nclass);
+  }
+
+  [[nodiscard]] double Finalize(double residue, double weights) const override {
+    return Derived::GetFinal(residue, weights);
+  }
+
   double Eval(const HostDeviceVector<float> &preds, const MetaInfo &info) override {
-    if (info.labels.Size() == 0) {
-      CHECK_EQ(preds.Size(), 0);
-    } else {
-      CHECK(preds.Size() % info.labels.Size() == 0) << "label and prediction size not match";
+    if (ctx_->IsCPU()) {
+      double result{0};
+      RowwiseMetric const *self = this;
+      EvalRowwise(ctx_, {&self, 1}, preds, info, {&result, 1});
+      return result;
     }
+    auto nclass = CheckShape(preds, info);
     std::array<double, 2> dat{0.0, 0.0};
     if (info.labels.Size() != 0) {
-      const size_t nclass = preds.Size() / info.labels.Size();
-      CHECK_GE(nclass, 1U)
-          << "mlogloss and merror are only used for multi-class classification,"
-          << " use logloss for binary classification";
       auto result = reducer_.Reduce(this->ctx_, nclass, info.weights_, *info.labels.Data(), preds);
       dat[0] = result.Residue();
       dat[1] = result.Weights();
@@ -198,6 +186,20 @@ struct EvalMClassBase : public MetricNoCache {
   }
 
  private:
+  // Returns the number of classes, 0 for empty input.
+  static std::size_t CheckShape(const HostDeviceVector<float> &preds, const MetaInfo &info) {
+    if (info.labels.Size() == 0) {
+      CHECK_EQ(preds.Size(), 0);
+      return 0;
+    }
+    CHECK(preds.Size() % info.labels.Size() == 0) << "label and prediction size not match";
+    const size_t nclass = preds.Size() / info.labels.Size();
+    CHECK_GE(nclass, 1U)
+        << "mlogloss and merror are only used for multi-class classification,"
+        << " use logloss for binary classification";
+    return nclass;
+  }
+
   MultiClassMetricsReduction<Derived> reducer_;
   // used to store error message
   const char *error_msg_;
@@ -6,25 +6,24 @@
 #include <dmlc/omp.h>
 #include <dmlc/registry.h>
 
-#include <algorithm>                         // for stable_sort, copy, fill_n, min, max
+#include <algorithm>                         // for partial_sort, copy, fill_n, min, max
 #include <array>                             // for array
 #include <cmath>                             // for log, sqrt
-#include <functional>                        // for less, greater
 #include <limits>                            // for numeric_limits
 #include <map>                               // for operator!=, _Rb_tree_const_iterator
 #include <memory>                            // for allocator, unique_ptr, shared_ptr, __shared_...
-#include <numeric>                           // for accumulate
+#include <numeric>                           // for accumulate, iota
 #include <ostream>                           // for operator<<, basic_ostream, ostringstream
 #include <string>                            // for char_traits, operator<, basic_string, to_string
 #include <utility>                           // for pair, make_pair
 #include <vector>                            // for vector
 
 #include "../collective/aggregator.h"        // for ApplyWithLabels
-#include "../common/algorithm.h"             // for ArgSort, Sort
+#include "../common/algorithm.h"             // for RadixArgSortDesc
 #include "../common/linalg_op.h"             // for cbegin, cend
 #include "../common/math.h"                  // for CmpFirst
 #include "../common/optional_weight.h"       // for OptionalWeights, MakeOptionalWeights
-#include "dmlc/common.h"                     // for OMPException
+#include "../common/threading_utils.h"       // for ParallelFor, ThreadIdx
 #include "metric_common.h"                   // for MetricNoCache, GPUMetric, PackedReduceResult
 #include "xgboost/base.h"                    // for bst_float, bst_omp_uint, bst_group_t, Args
 #include "xgboost/cache.h"                   // for DMatrixCache
@@ -63,13 +62,8 @@ struct EvalAMS : public MetricNoCache {
     using namespace std;  // NOLINT(*)
 
     const auto ndata = static_cast<bst_omp_uint>(info.labels.Size());
-    PredIndPairContainer rec(ndata);
-
-    const auto &h_preds = preds.ConstHostVector();
-    common::ParallelFor(ndata, ctx_->Threads(),
-                        [&](bst_omp_uint i) { rec[i] = std::make_pair(h_preds[i], i); });
-    common::Sort(ctx_, rec.begin(), rec.end(),
-                 [](auto const& l, auto const& r) { return l.first > r.first; });
+    auto h_preds = preds.ConstHostSpan();
+    auto const sorted_idx = common::RadixArgSortDesc<bst_omp_uint>(ctx_, h_preds);
     auto ntop = static_cast<unsigned>(ratio_ * ndata);
     if (ntop == 0) ntop = ndata;
     const double br = 10.0;
@@ -77,14 +71,14 @@ struct EvalAMS : public MetricNoCache {
     double s_tp = 0.0, b_fp = 0.0, tams = 0.0;
     const auto& labels = info.labels.View(DeviceOrd::CPU());
     for (unsigned i = 0; i < static_cast<unsigned>(ndata-1) && i < ntop; ++i) {
-      const unsigned ridx = rec[i].second;
+      const unsigned ridx = sorted_idx[i];
       const bst_float wt = info.GetWeight(ridx);
       if (labels(ridx) > 0.5f) {
         s_tp += wt;
       } else {
         b_fp += wt;
       }
-      if (rec[i].first != rec[i + 1].first) {
+      if (h_preds[sorted_idx[i]] != h_preds[sorted_idx[i + 1]]) {
         double ams = sqrt(2 * ((s_tp + b_fp + br) * log(1.0 + s_tp / (b_fp + br)) - s_tp));
         if (tams < ams) {
           thresindex = i;
@@ -137,26 +131,18 @@ struct EvalRank : public MetricNoCache, public EvalRankConfig {
       const auto& labels = info.labels.HostView();
       const auto &h_preds = preds.ConstHostVector();
 
-      dmlc::OMPException exc;
-#pragma omp parallel num_threads(ctx_->Threads())
-      {
-        exc.Run([&]() {
-          // each thread takes a local rec
-          PredIndPairContainer rec;
-#pragma omp for schedule(static)
-          for (bst_omp_uint k = 0; k < ngroups; ++k) {
-            exc.Run([&]() {
-              rec.clear();
-              for (unsigned j = gptr[k]; j < gptr[k + 1]; ++j) {
-                rec.emplace_back(h_preds[j], static_cast<int>(labels(j)));
-              }
-              sum_tloc[omp_get_thread_num()] += this->EvalGroup(&rec);
-            });
-          }
-        });
-      }
+      // each thread takes a local rec
+      std::vector<PredIndPairContainer> rec_tloc(ctx_->Threads());
+      common::ParallelFor(ngroups, ctx_->Threads(), [&](bst_omp_uint k) {
+        auto tid = common::ThreadIdx();
+        auto& rec = rec_tloc[tid];
+        rec.clear();
+        for (unsigned j = gptr[k]; j < gptr[k + 1]; ++j) {
+          rec.emplace_back(h_preds[j], static_cast<int>(labels(j)));
+        }
+        sum_tloc[tid] += this->EvalGroup(&rec);
+      });
       sum_metric = std::accumulate(sum_tloc.cbegin(), sum_tloc.cend(), 0.0);
-      exc.Rethrow();
     }
 
     return collective::GlobalRatio(ctx_, info, sum_metric, static_cast<double>(ngroups));
@@ -309,6 +295,23 @@ double Finalize(Context const* ctx, MetaInfo const& info, double score, double s
 
   return score;
 }
+
+/**
+ * @brief Indices of the top n predictions in a group, in descending order of the
+ *        prediction. Ties are ordered by the index, same as the stable `ArgSort`, but only
+ *        the first n elements are sorted.
+ */
+void TopKIdx(linalg::VectorView<float const> g_predt, std::size_t n,
+             std::vector<std::size_t>* p_out) {
+  auto& out = *p_out;
+  out.resize(g_predt.Size());
+  std::iota(out.begin(), out.end(), 0);
+  std::partial_sort(out.begin(), out.begin() + n, out.end(),
+                    [&](std::size_t l, std::size_t r) {
+                      auto pl = g_predt(l), pr = g_predt(r);
+                      return pl > pr || (pl == pr && l < r);
+                    });
+}
 }  // namespace
 
 class EvalPrecision : public EvalRankWithCache<ltr::PreCache> {
@@ -329,16 +332,19 @@ class EvalPrecision : public EvalRankWithCache<ltr::PreCache> {
 
     auto gptr = p_cache->DataGroupPtr(ctx_);
     auto h_label = info.labels.HostView().Slice(linalg::All(), 0);
-    auto rank_idx = p_cache->SortedIdx(ctx_, predt.ConstHostSpan());
+    auto h_predt = linalg::MakeTensorView(ctx_, predt.ConstHostSpan(), predt.Size());
 
     auto weight = common::MakeOptionalWeights(ctx_, info.weights_);
     auto pre = p_cache->Pre(ctx_);
+    std::vector<std::vector<std::size_t>> rank_idx(ctx_->Threads());
 
-    common::ParallelFor(p_cache->Groups(), ctx_->Threads(), [&](auto g) {
+    p_cache->ParallelForGroups(ctx_, [&](auto g) {
       auto g_label = h_label.Slice(linalg::Range(gptr[g], gptr[g + 1]));
-      auto g_rank = rank_idx.subspan(gptr[g], gptr[g + 1] - gptr[g]);
+      auto g_predt = h_predt.Slice(linalg::Range(gptr[g], gptr[g + 1]));
 
       auto n = std::min(static_cast<std::size_t>(param_.TopK()), g_label.Size());
+      auto& g_rank = rank_idx[common::ThreadIdx()];
+      TopKIdx(g_predt, n, &g_rank);
       double n_hits{0.0};
       for (std::size_t i = 0; i < n; ++i) {
         n_hits += g_label(g_rank[i]) * weight[g];
@@ -382,21 +388,24 @@ class EvalNDCG : public EvalRankWithCache<ltr::NDCGCache> {
     auto p_discount = p_cache->Discount(ctx_).data();
 
     auto h_label = info.labels.HostView();
-    auto h_predt = linalg::MakeTensorView(ctx_, &preds, preds.Size());
+    auto h_predt = linalg::MakeTensorView(ctx_, preds.ConstHostSpan(), preds.Size());
     auto weights = common::MakeOptionalWeights(ctx_, info.weights_);
 
-    common::ParallelFor(n_groups, ctx_->Threads(), [&](auto g) {
-      auto g_predt = h_predt.Slice(linalg::Range(group_ptr[g], group_ptr[g + 1]));
-      auto g_labels = h_label.Slice(linalg::Range(group_ptr[g], group_ptr[g + 1]), 0);
-      auto sorted_idx = common::ArgSort<std::size_t>(ctx_, linalg::cbegin(g_predt),
-                                                     linalg::cend(g_predt), std::greater<>{});
-      double ndcg{.0};
+    // The groups are balanced between threads, each thread sorts a group with its own buffer.
+    std::vector<std::vector<std::size_t>> rank_idx(ctx_->Threads());
+
+    p_cache->ParallelForGroups(ctx_, [&](auto g) {
       double inv_idcg = h_inv_idcg(g);
       if (inv_idcg <= 0.0) {
         ndcg_gloc(g) = minus_ ? 0.0 : 1.0;
         return;
       }
-      std::size_t n{std::min(sorted_idx.size(), static_cast<std::size_t>(param_.TopK()))};
+      auto g_predt = h_predt.Slice(linalg::Range(group_ptr[g], group_ptr[g + 1]));
+      auto g_labels = h_label.Slice(linalg::Range(group_ptr[g], group_ptr[g + 1]), 0);
+      std::size_t n{std::min(g_predt.Size(), static_cast<std::size_t>(param_.TopK()))};
+      auto& sorted_idx = rank_idx[common::ThreadIdx()];
+      TopKIdx(g_predt, n, &sorted_idx);
+      double ndcg{.0};
       if (param_.ndcg_exp_gain) {
         for (std::size_t i = 0; i < n; ++i) {
           ndcg += p_discount[i] * ltr::CalcDCGGain(g_labels(sorted_idx[i])) * inv_idcg;
@@ -433,24 +442,28 @@ class EvalMAPScore : public EvalRankWithCache<ltr::MAPCache> {
     auto gptr = p_cache->DataGroupPtr(ctx_);
     auto h_label = info.labels.HostView().Slice(linalg::All(), 0);
 
+    auto h_predt = linalg::MakeTensorView(ctx_, predt.ConstHostSpan(), predt.Size());
+
     auto map_gloc = p_cache->Map(ctx_);
     std::fill_n(map_gloc.data(), map_gloc.size(), 0.0);
-    auto rank_idx = p_cache->SortedIdx(ctx_, predt.ConstHostSpan());
+    auto group_rel = p_cache->GroupRelevant(ctx_);
+    std::vector<std::vector<std::size_t>> rank_idx(ctx_->Threads());
 
-    common::ParallelFor(p_cache->Groups(), ctx_->Threads(), [&](auto g) {
+    p_cache->ParallelForGroups(ctx_, [&](auto g) {
       auto g_label = h_label.Slice(linalg::Range(gptr[g], gptr[g + 1]));
-      auto g_rank = rank_idx.subspan(gptr[g], gptr[g + 1] - gptr[g]);
+      auto g_predt = h_predt.Slice(linalg::Range(gptr[g], gptr[g + 1]));
 
       auto n = std::min(static_cast<std::size_t>(param_.TopK()), g_label.Size());
+      auto& g_rank = rank_idx[common::ThreadIdx()];
+      TopKIdx(g_predt, n, &g_rank);
       double n_hits{0.0};
       for (std::size_t i = 0; i < n; ++i) {
         auto p = g_label(g_rank[i]);
         n_hits += p;
         map_gloc[g] += n_hits / static_cast<double>((i + 1)) * p;
       }
-      for (std::size_t i = n; i < g_label.Size(); ++i) {
-        n_hits += g_label(g_rank[i]);
-      }
+      // The relevant documents after the cutoff are counted once in the cache.
+      n_hits = group_rel[g];
       if (n_hits > 0.0) {
         map_gloc[g] /= std::min(n_hits, static_cast<double>(param_.TopK()));
       } else {
@@ -3,29 +3,28 @@
  */
 #include "adaptive.h"
 
-#include <algorithm>  // std::transform,std::find_if,std::copy,std::unique
+#include <algorithm>  // std::transform,std::stable_sort,std::sort,std::min,std::replace_if
 #include <cmath>      // std::isnan
 #include <cstddef>    // std::size_t
-#include <iterator>   // std::distance
+#include <cstdint>    // std::int32_t
+#include <limits>     // std::numeric_limits
+#include <numeric>    // std::iota
+#include <utility>    // std::pair,std::make_pair
 #include <vector>     // std::vector
 
-#include "../common/algorithm.h"           // ArgSort
-#include "../common/numeric.h"             // RunLengthEncode
-#include "../common/stats.h"               // Quantile,WeightedQuantile
-#include "../common/threading_utils.h"     // ParallelFor
-#include "../common/transform_iterator.h"  // MakeIndexTransformIter
-#include "../tree/sample_position.h"       // for SamplePosition
-#include "xgboost/base.h"                  // bst_node_t
-#include "xgboost/context.h"               // Context
-#include "xgboost/data.h"                  // MetaInfo
-#include "xgboost/host_device_vector.h"    // HostDeviceVector
-#include "xgboost/linalg.h"                // MakeTensorView
-#include "xgboost/span.h"                  // Span
-#include "xgboost/tree_model.h"            // RegTree
-
-#if !defined(XGBOOST_USE_CUDA)
-#include "../common/common.h"  // AssertGPUSupport
-#endif                         // !defined(XGBOOST_USE_CUDA)
+#include "../common/common.h"                 // DivRoundUp
+#include "../common/linalg_op.h"              // cbegin,cend
+#include "../common/stats.h"                  // SelectQuantile,SelectWeightedQuantile
+#include "../common/threading_utils.h"        // ParallelFor
+#include "../tree/sample_position.h"          // for SamplePosition
+#include "xgboost/base.h"                     // bst_node_t
+#include "xgboost/context.h"                  // Context
+#include "xgboost/data.h"                     // MetaInfo
+#include "xgboost/host_device_vector.h"       // HostDeviceVector
+#include "xgboost/linalg.h"                   // MakeTensorView
+#include "xgboost/multi_target_tree_model.h"  // MultiTargetTree
+#include "xgboost/span.h"                     // Span
+#include "xgboost/tree_model.h"               // RegTree
 
 namespace xgboost::obj::detail {
 void EncodeTreeLeafHost(Context const* ctx, RegTree const& tree,
@@ -34,46 +33,80 @@ void EncodeTreeLeafHost(Context const* ctx, RegTree const& tree,
   auto& nptr = *p_nptr;
   auto& nidx = *p_nidx;
   auto& ridx = *p_ridx;
-  ridx = common::ArgSort<size_t>(ctx, position.cbegin(), position.cend());
-  std::vector<bst_node_t> sorted_pos(position);
-  // permutation
-  for (size_t i = 0; i < position.size(); ++i) {
-    sorted_pos[i] = position[ridx[i]];
-  }
-  // find the first non-sampled row
-  size_t begin_pos = std::distance(
-      sorted_pos.cbegin(),
-      std::find_if(sorted_pos.cbegin(), sorted_pos.cend(),
-                   [](bst_node_t nidx) { return tree::SamplePosition::IsValid(nidx); }));
-  CHECK_LE(begin_pos, sorted_pos.size());
 
   std::vector<bst_node_t> leaf;
   tree.WalkTree([&](bst_node_t nidx) {
-    if (tree[nidx].IsLeaf()) {
+    if (tree.IsLeaf(nidx)) {
       leaf.push_back(nidx);
     }
     return true;
   });
 
-  if (begin_pos == sorted_pos.size()) {
+  // Counting sort of the rows by node, the first bucket is for the sampled rows. The rows
+  // are sorted within each block of the input, then the blocks are scattered in order so
+  // that the row index is sorted inside each leaf.
+  std::size_t n_buckets = static_cast<std::size_t>(tree.NumNodes()) + 1;
+  std::size_t n_samples = position.size();
+  auto n_blocks = static_cast<std::size_t>(ctx->Threads());
+  auto block_size = common::DivRoundUp(n_samples, n_blocks);
+  auto block = [&](std::size_t t) {
+    return std::make_pair(std::min(t * block_size, n_samples),
+                          std::min((t + 1) * block_size, n_samples));
+  };
+  auto bucket = [&](std::size_t i) -> std::size_t {
+    auto pos = position[i];
+    return tree::SamplePosition::IsValid(pos) ? static_cast<std::size_t>(pos) + 1 : 0;
+  };
+  std::vector<std::size_t> hist(n_blocks * n_buckets, 0);
+  common::ParallelFor(n_blocks, ctx->Threads(), common::Sched::Static(), [&](std::size_t t) {
+    auto [beg, end] = block(t);
+    auto t_hist = hist.data() + t * n_buckets;
+    for (std::size_t i = beg; i < end; ++i) {
+      auto b = bucket(i);
+      CHECK_LT(b, n_buckets);
+      ++t_hist[b];
+    }
+  });
+  // Exclusive scan in the order of (bucket, block).
+  std::vector<std::size_t> bucket_ptr(n_buckets + 1, 0);
+  std::size_t sum = 0;
+  for (std::size_t b = 0; b < n_buckets; ++b) {
+    bucket_ptr[b] = sum;
+    for (std::size_t t = 0; t < n_blocks; ++t) {
+      auto cnt = hist[t * n_buckets + b];
+      hist[t * n_buckets + b] = sum;
+      sum += cnt;
+    }
+  }
+  bucket_ptr[n_buckets] = sum;
+
+  // All rows are sampled out.
+  if (bucket_ptr[1] == n_samples) {
     nidx = leaf;
     return;
   }
 
-  auto beg_it = sorted_pos.begin() + begin_pos;
-  common::RunLengthEncode(beg_it, sorted_pos.end(), &nptr);
-  CHECK_GT(nptr.size(), 0);
-  // skip the sampled rows in indptr
-  std::transform(nptr.begin(), nptr.end(), nptr.begin(),
-                 [begin_pos](size_t ptr) { return ptr + begin_pos; });
+  ridx.resize(n_samples);
+  common::ParallelFor(n_blocks, ctx->Threads(), common::Sched::Static(), [&](std::size_t t) {
+    auto [beg, end] = block(t);
+    auto t_hist = hist.data() + t * n_buckets;
+    for (std::size_t i = beg; i < end; ++i) {
+      ridx[t_hist[bucket(i)]++] = i;
+    }
+  });
 
-  size_t n_leaf = nptr.size() - 1;
-  auto n_unique = std::unique(beg_it, sorted_pos.end()) - beg_it;
-  CHECK_EQ(n_unique, n_leaf);
-  nidx.resize(n_leaf);
-  std::copy(beg_it, beg_it + n_unique, nidx.begin());
+  nptr.clear();
+  nidx.clear();
+  for (std::size_t b = 1; b < n_buckets; ++b) {
+    if (bucket_ptr[b + 1] != bucket_ptr[b]) {
+      nidx.push_back(static_cast<bst_node_t>(b - 1));
+      nptr.push_back(bucket_ptr[b]);
+    }
+  }
+  nptr.push_back(n_samples);
+  CHECK_GT(nptr.size(), 0);
 
-  if (n_leaf != leaf.size()) {
+  if (nidx.size() != leaf.size()) {
     FillMissingLeaf(leaf, &nidx, &nptr);
   }
 }
@@ -104,33 +137,45 @@ void UpdateTreeLeafHost(Context const* ctx, std::vector<bst_node_t> const& posit
   auto h_predt = linalg::MakeTensorView(ctx, predt.ConstHostSpan(), info.num_row_,
                                         predt.Size() / info.num_row_);
 
+  // Process the large leaves first, the selection is linear in the size of the leaf.
+  std::vector<std::size_t> leaf_order(n_leaf);
+  std::iota(leaf_order.begin(), leaf_order.end(), 0);
+  std::stable_sort(leaf_order.begin(), leaf_order.end(), [&](std::size_t l, std::size_t r) {
+    return h_node_ptr[l + 1] - h_node_ptr[l] > h_node_ptr[r + 1] - h_node_ptr[r];
+  });
+  // Thread local buffers for the residuals of a leaf.
+  std::vector<std::vector<float>> residuals(ctx->Threads());
+  std::vector<std::vector<std::pair<float, float>>> w_residuals(ctx->Threads());
+
   collective::ApplyWithLabels(
       ctx, info, static_cast<void*>(quantiles.data()), quantiles.size() * sizeof(float), [&] {
+        auto h_labels = info.labels.HostView().Slice(linalg::All(), IdxY(info, group_idx));
+        auto h_weights = linalg::MakeVec(&info.weights_);
         // loop over each leaf
-        common::ParallelFor(quantiles.size(), ctx->Threads(), [&](size_t k) {
+        common::ParallelFor(n_leaf, ctx->Threads(), common::Sched::Dyn(), [&](size_t i) {
+          auto k = leaf_order[i];
           auto nidx = h_node_idx[k];
           CHECK(tree[nidx].IsLeaf());
           CHECK_LT(k + 1, h_node_ptr.size());
           size_t n = h_node_ptr[k + 1] - h_node_ptr[k];
           auto h_row_set = common::Span<size_t const>{ridx}.subspan(h_node_ptr[k], n);
-
-          auto h_labels = info.labels.HostView().Slice(linalg::All(), IdxY(info, group_idx));
-          auto h_weights = linalg::MakeVec(&info.weights_);
-
-          auto iter = common::MakeIndexTransformIter([&](size_t i) -> float {
-            auto row_idx = h_row_set[i];
+          auto residual = [&](std::size_t row_idx) -> float {
             return h_labels(row_idx) - h_predt(row_idx, group_idx);
-          });
-          auto w_it = common::MakeIndexTransformIter([&](size_t i) -> float {
-            auto row_idx = h_row_set[i];
-            return h_weights(row_idx);
-          });
+          };
 
           float q{0};
           if (info.weights_.Empty()) {
-            q = common::Quantile(ctx, alpha, iter, iter + h_row_set.size());
+            auto& buf = residuals[common::ThreadIdx()];
+            buf.resize(n);
+            std::transform(h_row_set.cbegin(), h_row_set.cend(), buf.begin(), residual);
+            q = common::SelectQuantile(alpha, common::Span{buf});
           } else {
-            q = common::WeightedQuantile(ctx, alpha, iter, iter + h_row_set.size(), w_it);
+            auto& buf = w_residuals[common::ThreadIdx()];
+            buf.resize(n);
+            std::transform(h_row_set.cbegin(), h_row_set.cend(), buf.begin(), [&](auto row_idx) {
+              return std::make_pair(residual(row_idx), h_weights(row_idx));
+            });
+            q = common::SelectWeightedQuantile(alpha, common::Span{buf});
           }
           if (std::isnan(q)) {
             CHECK(h_row_set.empty());
@@ -142,6 +187,157 @@ void UpdateTreeLeafHost(Context const* ctx, std::vector<bst_node_t> const& posit
   UpdateLeafValues(ctx, &quantiles, nidx, info, learning_rate, p_tree);
 }
 
+namespace {
+void UpdateMultiTargetLeafValues(Context const* ctx, std::vector<float>* p_quantiles,
+                                 std::vector<bst_node_t> const& nidx, MetaInfo const& info,
+                                 float learning_rate, std::vector<float> const& alpha,
+                                 RegTree* p_tree) {
+  auto& tree = *p_tree;
+  auto& quantiles = *p_quantiles;
+  auto n_targets = static_cast<std::size_t>(tree.NumTargets());
+
+  bst_idx_t n_leaf = collective::GlobalMax(ctx, info, static_cast<bst_idx_t>(nidx.size()));
+  CHECK(quantiles.empty() || quantiles.size() == n_leaf * n_targets);
+  if (quantiles.empty()) {
+    quantiles.resize(n_leaf * n_targets, std::numeric_limits<float>::quiet_NaN());
+  }
+
+  // Same as `UpdateLeafValues`, use the mean of the workers that have valid quantiles.
+  std::vector<std::int32_t> n_valids(quantiles.size());
+  std::transform(quantiles.cbegin(), quantiles.cend(), n_valids.begin(),
+                 [](float q) { return static_cast<std::int32_t>(!std::isnan(q)); });
+  auto rc = collective::GlobalSum(ctx, info, linalg::MakeVec(n_valids.data(), n_valids.size()));
+  collective::SafeColl(rc);
+  std::replace_if(
+      quantiles.begin(), quantiles.end(), [](float q) { return std::isnan(q); }, 0.f);
+  rc = collective::GlobalSum(ctx, info, linalg::MakeVec(quantiles.data(), quantiles.size()));
+  collective::SafeColl(rc);
+
+  auto h_quantiles = linalg::MakeTensorView(ctx, common::Span{quantiles}, n_leaf, n_targets);
+  auto const& mt_tree = *tree.GetMultiTargetTree();
+  for (std::size_t i = 0; i < n_leaf; ++i) {
+    auto leaf_value = mt_tree.LeafValue(nidx[i]);
+    for (std::size_t t = 0; t < n_targets; ++t) {
+      auto idx = i * n_targets + t;
+      if (n_valids[idx] > 0) {
+        h_quantiles(i, t) /= static_cast<float>(n_valids[idx]);
+      } else {
+        // Use original leaf value if no worker can provide the quantile.
+        h_quantiles(i, t) = leaf_value(t);
+      }
+    }
+  }
+
+  // Sort the leaf values by alpha when the targets are quantiles of the same label. The
+  // initial prediction is the same for all targets, so the predicted quantiles remain
+  // monotonic after each tree.
+  if (info.labels.Shape(1) == 1) {
+    std::vector<std::size_t> alpha_order(n_targets);
+    std::iota(alpha_order.begin(), alpha_order.end(), 0);
+    std::stable_sort(alpha_order.begin(), alpha_order.end(),
+                     [&](std::size_t l, std::size_t r) { return alpha[l] < alpha[r]; });
+    std::vector<float> sorted(n_targets);
+    for (std::size_t i = 0; i < n_leaf; ++i) {
+      auto leaf = h_quantiles.Slice(i, linalg::All());
+      std::copy(linalg::cbegin(leaf), linalg::cend(leaf), sorted.begin());
+      std::sort(sorted.begin(), sorted.end());
+      for (std::size_t r = 0; r < n_targets; ++r) {
+        leaf(alpha_order[r]) = sorted[r];
+      }
+    }
+  }
+
+  std::vector<float> weight(n_targets);
+  for (std::size_t i = 0; i < nidx.size(); ++i) {
+    CHECK(tree.IsLeaf(nidx[i]));
+    for (std::size_t t = 0; t < n_targets; ++t) {
+      weight[t] = h_quantiles(i, t) * learning_rate;
+    }
+    tree.SetLeaf(nidx[i], linalg::MakeVec(weight.data(), weight.size()));
+  }
+}
+}  // anonymous namespace
+
+void UpdateMultiTargetTreeLeafHost(Context const* ctx, std::vector<bst_node_t> const& position,
+                                   MetaInfo const& info, float learning_rate,
+                                   HostDeviceVector<float> const& predt,
+                                   std::vector<float> const& alpha, RegTree* p_tree) {
+  auto& tree = *p_tree;
+  CHECK(tree.IsMultiTarget());
+  auto n_targets = static_cast<std::size_t>(tree.NumTargets());
+  CHECK_EQ(alpha.size(), n_targets);
+
+  std::vector<bst_node_t> nidx;
+  std::vector<size_t> nptr;
+  std::vector<size_t> ridx;
+  EncodeTreeLeafHost(ctx, tree, position, &nptr, &nidx, &ridx);
+  std::size_t n_leaf = nidx.size();
+  std::vector<float> quantiles;
+  if (nptr.empty()) {
+    UpdateMultiTargetLeafValues(ctx, &quantiles, nidx, info, learning_rate, alpha, p_tree);
+    return;
+  }
+
+  CHECK(!position.empty());
+  CHECK_LE(nptr.back(), info.num_row_);
+  CHECK_EQ(predt.Size(), info.num_row_ * n_targets);
+  quantiles.resize(n_leaf * n_targets, 0);
+  auto h_predt = linalg::MakeTensorView(ctx, predt.ConstHostSpan(), info.num_row_, n_targets);
+
+  std::vector<std::size_t> leaf_order(n_leaf);
+  std::iota(leaf_order.begin(), leaf_order.end(), 0);
+  std::stable_sort(leaf_order.begin(), leaf_order.end(), [&](std::size_t l, std::size_t r) {
+    return nptr[l + 1] - nptr[l] > nptr[r + 1] - nptr[r];
+  });
+  std::vector<std::vector<float>> residuals(ctx->Threads());
+  std::vector<std::vector<std::pair<float, float>>> w_residuals(ctx->Threads());
+
+  collective::ApplyWithLabels(
+      ctx, info, static_cast<void*>(quantiles.data()), quantiles.size() * sizeof(float), [&] {
+        auto h_labels = info.labels.HostView();
+        auto h_weights = linalg::MakeVec(&info.weights_);
+        common::ParallelFor(n_leaf, ctx->Threads(), common::Sched::Dyn(), [&](size_t i) {
+          auto k = leaf_order[i];
+          CHECK(tree.IsLeaf(nidx[k]));
+          size_t n = nptr[k + 1] - nptr[k];
+          auto h_row_set = common::Span<size_t const>{ridx}.subspan(nptr[k], n);
+          auto leaf_q = common::Span{quantiles}.subspan(k * n_targets, n_targets);
+          // A single pass over the rows of the leaf, the residuals of each target are stored
+          // in a contiguous segment of the buffer.
+          auto residual = [&](std::size_t row_idx, std::size_t t) -> float {
+            return h_labels(row_idx, IdxY(info, t)) - h_predt(row_idx, t);
+          };
+          if (info.weights_.Empty()) {
+            auto& buf = residuals[common::ThreadIdx()];
+            buf.resize(n * n_targets);
+            for (std::size_t j = 0; j < n; ++j) {
+              for (std::size_t t = 0; t < n_targets; ++t) {
+                buf[t * n + j] = residual(h_row_set[j], t);
+              }
+            }
+            for (std::size_t t = 0; t < n_targets; ++t) {
+              leaf_q[t] = common::SelectQuantile(alpha[t], common::Span{buf}.subspan(t * n, n));
+            }
+          } else {
+            auto& buf = w_residuals[common::ThreadIdx()];
+            buf.resize(n * n_targets);
+            for (std::size_t j = 0; j < n; ++j) {
+              auto row_idx = h_row_set[j];
+              for (std::size_t t = 0; t < n_targets; ++t) {
+                buf[t * n + j] = std::make_pair(residual(row_idx, t), h_weights(row_idx));
+              }
+            }
+            for (std::size_t t = 0; t < n_targets; ++t) {
+              leaf_q[t] =
+                  common::SelectWeightedQuantile(alpha[t], common::Span{buf}.subspan(t * n, n));
+            }
+          }
+        });
+      });
+
+  UpdateMultiTargetLeafValues(ctx, &quantiles, nidx, info, learning_rate, alpha, p_tree);
+}
+
 #if !defined(XGBOOST_USE_CUDA)
 void UpdateTreeLeafDevice(Context const*, common::Span<bst_node_t const>, std::int32_t,
                           MetaInfo const&, float, HostDeviceVector<float> const&, float, RegTree*) {
@@ -93,11 +93,39 @@ void UpdateTreeLeafDevice(Context const* ctx, common::Span<bst_node_t const> pos
 void UpdateTreeLeafHost(Context const* ctx, std::vector<bst_node_t> const& position,
                         std::int32_t group_idx, MetaInfo const& info, float learning_rate,
                         HostDeviceVector<float> const& predt, float alpha, RegTree* p_tree);
+
+void UpdateMultiTargetTreeLeafHost(Context const* ctx, std::vector<bst_node_t> const& position,
+                                   MetaInfo const& info, float learning_rate,
+                                   HostDeviceVector<float> const& predt,
+                                   std::vector<float> const& alpha, RegTree* p_tree);
 }  // namespace detail
 
+/**
+ * @brief Update the leaf values of a multi-target tree with the quantiles of the residuals,
+ *        one quantile for each target. The rows are grouped by leaf once for all targets.
+ *
+ *   When all targets share the same label, the leaf values are rearranged to be monotonic
+ *   in alpha so that the predicted quantiles don't cross.
+ */
+inline void UpdateTreeLeaf(Context const* ctx, HostDeviceVector<bst_node_t> const& position,
+                           MetaInfo const& info, float learning_rate,
+                           HostDeviceVector<float> const& predt, std::vector<float> const& alpha,
+                           RegTree* p_tree) {
+  CHECK(p_tree->IsMultiTarget());
+  CHECK(ctx->IsCPU()) << "GPU is not yet supported for vector leaf.";
+  detail::UpdateMultiTargetTreeLeafHost(ctx, position.ConstHostVector(), info, learning_rate,
+                                        predt, alpha, p_tree);
+}
+
 inline void UpdateTreeLeaf(Context const* ctx, HostDeviceVector<bst_node_t> const& position,
                            std::int32_t group_idx, MetaInfo const& info, float learning_rate,
                            HostDeviceVector<float> const& predt, float alpha, RegTree* p_tree) {
+  if (p_tree->IsMultiTarget()) {
+    // The same quantile for all targets.
+    UpdateTreeLeaf(ctx, position, info, learning_rate, predt,
+                   std::vector<float>(p_tree->NumTargets(), alpha), p_tree);
+    return;
+  }
   if (ctx->IsCUDA()) {
     position.SetDevice(ctx->Device());
     detail::UpdateTreeLeafDevice(ctx, position.ConstDeviceSpan(), group_idx, info, learning_rate,
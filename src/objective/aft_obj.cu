@@ -54,12 +54,10 @@ class AFTObj : public ObjFunction {
       const double pred = static_cast<double>(_preds[_idx]);
       const double label_lower_bound = static_cast<double>(_labels_lower_bound[_idx]);
       const double label_upper_bound = static_cast<double>(_labels_upper_bound[_idx]);
-      const float grad = static_cast<float>(
-          AFTLoss<Distribution>::Gradient(label_lower_bound, label_upper_bound,
-                                          pred, aft_loss_distribution_scale));
-      const float hess = static_cast<float>(
-          AFTLoss<Distribution>::Hessian(label_lower_bound, label_upper_bound,
-                                         pred, aft_loss_distribution_scale));
+      const auto gpair = AFTLoss<Distribution>::GradientHessian(
+          label_lower_bound, label_upper_bound, pred, aft_loss_distribution_scale);
+      const auto grad = static_cast<float>(gpair.GetGrad());
+      const auto hess = static_cast<float>(gpair.GetHess());
       const bst_float w = is_null_weight ? 1.0f : _weights[_idx];
       _out_gpair[_idx] = GradientPair(grad * w, hess * w);
     },
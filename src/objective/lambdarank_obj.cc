@@ -362,7 +362,6 @@ class LambdaRankNDCG : public LambdaRankObj<LambdaRankNDCG, ltr::NDCGCache> {
       return;
     }
 
-    bst_group_t n_groups = p_cache_->Groups();
     auto gptr = p_cache_->DataGroupPtr(ctx_);
 
     out_gpair->SetDevice(ctx_->Device());
@@ -378,7 +377,7 @@ class LambdaRankNDCG : public LambdaRankObj<LambdaRankNDCG, ltr::NDCGCache> {
     auto rank_idx = p_cache_->SortedIdx(ctx_, h_predt);
     auto inv_IDCG = GetCache()->InvIDCG(ctx_);
 
-    common::ParallelFor(n_groups, ctx_->Threads(), common::Sched::Guided(), [&](auto g) {
+    p_cache_->ParallelForGroups(ctx_, [&](auto g) {
       std::size_t cnt = gptr[g + 1] - gptr[g];
       auto w = h_weight[g];
       auto g_predt = h_predt.subspan(gptr[g], cnt);
@@ -484,7 +483,6 @@ class LambdaRankMAP : public LambdaRankObj<LambdaRankMAP, ltr::MAPCache> {
     }
 
     auto gptr = p_cache_->DataGroupPtr(ctx_).data();
-    bst_group_t n_groups = p_cache_->Groups();
 
     CHECK_EQ(info.labels.Shape(1), 1) << "multi-target for learning to rank is not yet supported.";
     out_gpair->SetDevice(ctx_->Device());
@@ -517,7 +515,7 @@ class LambdaRankMAP : public LambdaRankObj<LambdaRankMAP, ltr::MAPCache> {
     };
     using D = decltype(delta_map);
 
-    common::ParallelFor(n_groups, ctx_->Threads(), [&](auto g) {
+    p_cache_->ParallelForGroups(ctx_, [&](auto g) {
       auto cnt = gptr[g + 1] - gptr[g];
       auto w = h_weight[g];
       auto g_predt = h_predt.subspan(gptr[g], cnt);
@@ -573,7 +571,6 @@ class LambdaRankPairwise : public LambdaRankObj<LambdaRankPairwise, ltr::Ranking
     }
 
     auto gptr = p_cache_->DataGroupPtr(ctx_);
-    bst_group_t n_groups = p_cache_->Groups();
 
     out_gpair->SetDevice(ctx_->Device());
     out_gpair->Reshape(info.num_row_, this->Targets(info));
@@ -589,7 +586,7 @@ class LambdaRankPairwise : public LambdaRankObj<LambdaRankPairwise, ltr::Ranking
     auto delta = [](auto...) { return 1.0; };
     using D = decltype(delta);
 
-    common::ParallelFor(n_groups, ctx_->Threads(), [&](auto g) {
+    p_cache_->ParallelForGroups(ctx_, [&](auto g) {
       auto cnt = gptr[g + 1] - gptr[g];
       auto w = h_weight[g];
       auto g_predt = h_predt.subspan(gptr[g], cnt);
@@ -17,15 +17,12 @@
 #include <cassert>                         // for assert
 #include <cmath>                           // for log, abs
 #include <cstddef>                         // for size_t
-#include <functional>                      // for greater
 #include <memory>                          // for shared_ptr
 #include <random>                          // for minstd_rand, uniform_int_distribution
 #include <vector>                          // for vector
 
-#include "../common/algorithm.h"           // for ArgSort
 #include "../common/math.h"                // for Sigmoid
 #include "../common/ranking_utils.h"       // for CalcDCGGain
-#include "../common/transform_iterator.h"  // for MakeIndexTransformIter
 #include "xgboost/base.h"                  // for GradientPair, XGBOOST_DEVICE, kRtEps
 #include "xgboost/context.h"               // for Context
 #include "xgboost/data.h"                  // for MetaInfo
@@ -230,28 +227,25 @@ void MakePairs(Context const* ctx, std::int32_t iter,
     CHECK_EQ(g_rank.size(), g_label.Size());
     std::minstd_rand rnd(iter);
     rnd.discard(g);  // fixme(jiamingy): honor the global seed
-    // sort label according to the rank list
-    auto it = common::MakeIndexTransformIter(
-        [&g_rank, &g_label](std::size_t idx) { return g_label(g_rank[idx]); });
-    std::vector<std::size_t> y_sorted_idx =
-        common::ArgSort<std::size_t>(ctx, it, it + cnt, std::greater<>{});
-    // permutation iterator to get the original label
-    auto rev_it = common::MakeIndexTransformIter(
-        [&](std::size_t idx) { return g_label(g_rank[y_sorted_idx[idx]]); });
+    // Sort the rank list by label in a single pass. The cache assigns a bucket to each
+    // sample by its label, and the rank order is kept inside each bucket.
+    auto g_bucket = cache->LabelBucket(g);
+    auto bucket_ptr = cache->LabelBucketPtr(g);
+    CHECK_EQ(g_bucket.size(), g_rank.size());
+    std::vector<std::size_t> y_sorted_idx(cnt);
+    std::vector<std::size_t> offsets(bucket_ptr.cbegin(), bucket_ptr.cend() - 1);
+    for (std::size_t r = 0; r < cnt; ++r) {
+      y_sorted_idx[offsets[g_bucket[g_rank[r]]]++] = r;
+    }
 
-    for (std::size_t i = 0; i < cnt;) {
-      std::size_t j = i + 1;
-      // find the bucket boundary
-      while (j < cnt && rev_it[i] == rev_it[j]) {
-        ++j;
-      }
+    for (std::size_t b = 0; b + 1 < bucket_ptr.size(); ++b) {
+      std::size_t i = bucket_ptr[b], j = bucket_ptr[b + 1];
       // Bucket [i,j), construct n_samples pairs for each sample inside the bucket with
       // another sample outside the bucket.
       //
       // n elements left to the bucket, and n elements right to the bucket
       std::size_t n_lefts = i, n_rights = static_cast<std::size_t>(cnt - j);
       if (n_lefts + n_rights == 0) {
-        i = j;
         continue;
       }
 
@@ -271,7 +265,6 @@ void MakePairs(Context const* ctx, std::int32_t iter,
           op(idx0, idx1);
         }
       }
-      i = j;
     }
   }
 }
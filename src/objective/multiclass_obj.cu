@@ -8,7 +8,10 @@
 
 #include <vector>
 #include <algorithm>
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int32_t
 #include <limits>
+#include <numeric>  // for accumulate
 #include <utility>
 
 #include "xgboost/parameter.h"
@@ -19,7 +22,9 @@
 
 #include "../common/common.h"
 #include "../common/math.h"
+#include "../common/threading_utils.h"  // for ParallelFor
 #include "../common/transform.h"
+#include "../common/vector_math.h"  // for VectorExp
 
 #include "multiclass_param.h"
 
@@ -39,7 +44,11 @@ class SoftmaxMultiClassObj : public ObjFunction {
     param_.UpdateAllowUnknown(args);
   }
 
-  ObjInfo Task() const override { return ObjInfo::kClassification; }
+  ObjInfo Task() const override {
+    ObjInfo info{ObjInfo::kClassification};
+    info.sparse_grad = param_.sparse_grad_eps > 0.0f;
+    return info;
+  }
 
   void GetGradient(const HostDeviceVector<bst_float>& preds, const MetaInfo& info, std::int32_t,
                    linalg::Matrix<GradientPair>* out_gpair) override {
@@ -55,6 +64,7 @@ class SoftmaxMultiClassObj : public ObjFunction {
 
     const int nclass = param_.num_class;
     const auto ndata = static_cast<int64_t>(preds.Size() / nclass);
+    const float grad_eps = param_.sparse_grad_eps;
 
     auto device = ctx_->Device();
     out_gpair->SetDevice(device);
@@ -74,6 +84,11 @@ class SoftmaxMultiClassObj : public ObjFunction {
           << "Number of weights should be equal to number of data points.";
     }
 
+    if (device.IsCPU()) {
+      this->GetGradientHost(preds, info, out_gpair);
+      return;
+    }
+
     common::Transform<>::Init(
         [=] XGBOOST_DEVICE(size_t idx,
                            common::Span<GradientPair> gpair,
@@ -100,7 +115,8 @@ class SoftmaxMultiClassObj : public ObjFunction {
             const float eps = 1e-16f;
             const bst_float h = fmax(2.0f * p * (1.0f - p) * wt, eps);
             p = label == k ? p - 1.0f : p;
-            gpair[idx * nclass + k] = GradientPair(p * wt, h);
+            gpair[idx * nclass + k] =
+                fabsf(p * wt) < grad_eps ? GradientPair{} : GradientPair(p * wt, h);
           }
         }, common::Range{0, ndata}, ctx_->Threads(), device)
         .Eval(out_gpair->Data(), info.labels.Data(), &preds, &info.weights_, &label_correct_);
@@ -112,6 +128,53 @@ class SoftmaxMultiClassObj : public ObjFunction {
       }
     }
   }
+  /**
+   * @brief The CPU gradient. The exp of each row is computed once with the vectorised exp
+   *        into a thread-local buffer, instead of for both the sum and the gradient.
+   */
+  void GetGradientHost(HostDeviceVector<float> const& preds, MetaInfo const& info,
+                       linalg::Matrix<GradientPair>* out_gpair) const {
+    auto const nclass = static_cast<std::size_t>(param_.num_class);
+    auto h_preds = preds.ConstHostSpan();
+    auto h_labels = info.labels.Data()->ConstHostSpan();
+    auto h_weights = info.weights_.ConstHostSpan();
+    auto h_gpair = out_gpair->Data()->HostSpan();
+    auto n_threads = ctx_->Threads();
+    auto grad_eps = param_.sparse_grad_eps;
+
+    std::vector<float> buffer(static_cast<std::size_t>(n_threads) * nclass);
+    std::vector<std::int32_t> label_correct(n_threads, 1);
+    common::ParallelFor(h_labels.size(), n_threads, [&](std::size_t idx) {
+      auto tid = common::ThreadIdx();
+      auto point = h_preds.subspan(idx * nclass, nclass);
+      auto exp = common::Span<float>{buffer}.subspan(tid * nclass, nclass);
+
+      // Part of Softmax function
+      float wmax = *std::max_element(point.cbegin(), point.cend());
+      std::transform(point.cbegin(), point.cend(), exp.begin(),
+                     [&](float v) { return v - wmax; });
+      common::VectorExp(exp, exp);
+      double wsum = std::accumulate(exp.cbegin(), exp.cend(), 0.0);
+
+      auto label = h_labels[idx];
+      if (label < 0 || label >= nclass) {
+        label_correct[tid] = 0;
+        label = 0;
+      }
+      float wt = h_weights.empty() ? 1.0f : h_weights[idx];
+      auto gpair = h_gpair.subspan(idx * nclass, nclass);
+      for (std::size_t k = 0; k < nclass; ++k) {
+        float p = exp[k] / static_cast<float>(wsum);
+        float const eps = 1e-16f;
+        float const h = std::max(2.0f * p * (1.0f - p) * wt, eps);
+        p = label == k ? p - 1.0f : p;
+        gpair[k] = std::abs(p * wt) < grad_eps ? GradientPair{} : GradientPair(p * wt, h);
+      }
+    });
+    if (std::any_of(label_correct.cbegin(), label_correct.cend(), [](auto v) { return v != 1; })) {
+      LOG(FATAL) << "SoftmaxMultiClassObj: label must be in [0, num_class).";
+    }
+  }
   void PredTransform(HostDeviceVector<bst_float>* io_preds) const override {
     this->Transform(io_preds, output_prob_);
   }
@@ -13,10 +13,18 @@ namespace obj {
 
 struct SoftmaxMultiClassParam : public XGBoostParameter<SoftmaxMultiClassParam> {
   int num_class;
+  float sparse_grad_eps;
   // declare parameters
   DMLC_DECLARE_PARAMETER(SoftmaxMultiClassParam) {
     DMLC_DECLARE_FIELD(num_class).set_lower_bound(1)
         .describe("Number of output class in the multi-class classification.");
+    DMLC_DECLARE_FIELD(sparse_grad_eps)
+        .set_default(0.0f)
+        .set_lower_bound(0.0f)
+        .describe(
+            "Gradients with absolute value below this threshold are set to zero along with the "
+            "hessian. The hist tree method builds the tree of each class with only the rows "
+            "that have non-zero gradient.");
   }
 };
 
@@ -186,6 +186,12 @@ class QuantileRegression : public ObjFunction {
   void UpdateTreeLeaf(HostDeviceVector<bst_node_t> const& position, MetaInfo const& info,
                       float learning_rate, HostDeviceVector<float> const& prediction,
                       std::int32_t group_idx, RegTree* p_tree) const override {
+    if (p_tree->IsMultiTarget()) {
+      // All quantiles are updated together with the vector leaf.
+      ::xgboost::obj::UpdateTreeLeaf(ctx_, position, info, learning_rate, prediction,
+                                     param_.quantile_alpha.Get(), p_tree);
+      return;
+    }
     auto alpha = param_.quantile_alpha[group_idx];
     ::xgboost::obj::UpdateTreeLeaf(ctx_, position, group_idx, info, learning_rate, prediction,
                                    alpha, p_tree);
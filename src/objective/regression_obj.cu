@@ -7,9 +7,11 @@
 #include <dmlc/omp.h>
 
 #include <algorithm>
+#include <array>    // for array
 #include <cmath>
 #include <cstdint>  // std::int32_t
 #include <memory>
+#include <type_traits>  // for is_same_v
 #include <vector>
 
 #include "../common/common.h"
@@ -20,6 +22,7 @@
 #include "../common/stats.h"
 #include "../common/threading_utils.h"
 #include "../common/transform.h"
+#include "../common/vector_math.h"  // for VectorSigmoid, VectorExp
 #include "./regression_loss.h"
 #include "adaptive.h"
 #include "init_estimation.h"  // FitIntercept
@@ -53,6 +56,88 @@ void CheckRegInputs(MetaInfo const& info, HostDeviceVector<bst_float> const& pre
   CheckInitInputs(info);
   CHECK_EQ(info.labels.Size(), preds.Size()) << "Invalid shape of labels.";
 }
+
+// Gradient from the transformed prediction.
+template <typename Loss>
+XGBOOST_DEVICE GradientPair TransformedGradient(float p, float label, float w,
+                                                float scale_pos_weight) {
+  if (label == 1.0f) {
+    w *= scale_pos_weight;
+  }
+  return GradientPair(Loss::FirstOrderGradient(p, label) * w,
+                      Loss::SecondOrderGradient(p, label) * w);
+}
+
+template <typename Loss>
+XGBOOST_DEVICE GradientPair RegLossGradient(float predt, float label, float w,
+                                            float scale_pos_weight) {
+  return TransformedGradient<Loss>(Loss::PredTransform(predt), label, w, scale_pos_weight);
+}
+
+/**
+ * @brief Compute the gradient of elements in [begin, end) on CPU. The predictions are
+ *        transformed in blocks, with the vectorised exp for the sigmoid and the log links.
+ *
+ * @param weights Null if there's no weight.
+ */
+template <typename Loss>
+void RegLossGradientHost(std::size_t begin, std::size_t end, float const* preds,
+                         float const* labels, float const* weights, bst_target_t n_targets,
+                         float scale_pos_weight, GradientPair* out_gpair) {
+  constexpr bool kSigmoid = std::is_same_v<Loss, LogisticRegression> ||
+                            std::is_same_v<Loss, LogisticClassification> ||
+                            std::is_same_v<Loss, LogisticRaw>;
+  // The raw logistic loss applies the sigmoid in its gradient.
+  using GradLoss = std::conditional_t<std::is_same_v<Loss, LogisticRaw>, LogisticRegression, Loss>;
+  constexpr std::size_t kBlockSize = 256;
+  std::array<float, kBlockSize> predt;
+  for (std::size_t i = begin; i < end; i += kBlockSize) {
+    auto n = std::min(kBlockSize, end - i);
+    common::Span<float const> in{preds + i, n};
+    common::Span<float> out{predt.data(), n};
+    if constexpr (kSigmoid) {
+      common::VectorSigmoid(in, out);
+    } else if constexpr (std::is_same_v<Loss, GammaDeviance>) {
+      common::VectorExp(in, out);
+    } else {
+      std::transform(in.cbegin(), in.cend(), out.begin(),
+                     [](float v) { return Loss::PredTransform(v); });
+    }
+    for (std::size_t j = 0; j < n; ++j) {
+      auto idx = i + j;
+      float w = weights ? weights[idx / n_targets] : 1.0f;
+      out_gpair[idx] =
+          TransformedGradient<GradLoss>(predt[j], labels[idx], w, scale_pos_weight);
+    }
+  }
+}
+
+/**
+ * @brief Gradient of single target regression losses on CPU, computed on demand.
+ */
+template <typename Loss>
+class RegLossRowGradient : public RowGradient {
+  float const* preds_;
+  float const* labels_;
+  // Null if there's no weight.
+  float const* weights_;
+  float scale_pos_weight_;
+
+ public:
+  RegLossRowGradient(HostDeviceVector<float> const& preds, MetaInfo const& info,
+                     float scale_pos_weight)
+      : preds_{preds.ConstHostPointer()},
+        labels_{info.labels.Data()->ConstHostPointer()},
+        weights_{info.weights_.Empty() ? nullptr : info.weights_.ConstHostPointer()},
+        scale_pos_weight_{scale_pos_weight} {}
+
+  void operator()(std::size_t begin, std::size_t end,
+                  common::Span<GradientPair> out_gpair) const override {
+    CHECK_LE(end, out_gpair.size());
+    RegLossGradientHost<Loss>(begin, end, preds_, labels_, weights_, 1, scale_pos_weight_,
+                              out_gpair.data());
+  }
+};
 }  // anonymous namespace
 
 #if defined(XGBOOST_USE_CUDA)
@@ -140,6 +225,20 @@ class RegLossObj : public FitInterceptGlmLike {
     auto const n_targets = this->Targets(info);
     out_gpair->Reshape(info.num_row_, n_targets);
 
+    if (device.IsCPU()) {
+      auto h_preds = preds.ConstHostPointer();
+      auto h_labels = info.labels.Data()->ConstHostPointer();
+      auto h_weights = is_null_weight ? nullptr : info.weights_.ConstHostPointer();
+      auto h_gpair = out_gpair->Data()->HostPointer();
+      common::ParallelFor(n_data_blocks, nthreads, [&](std::size_t data_block_idx) {
+        std::size_t begin = data_block_idx * block_size;
+        std::size_t end = std::min(ndata, begin + block_size);
+        RegLossGradientHost<Loss>(begin, end, h_preds, h_labels, h_weights, n_targets,
+                                  scale_pos_weight, h_gpair);
+      });
+      return;
+    }
+
     common::Transform<>::Init(
         [block_size, ndata, n_targets] XGBOOST_DEVICE(
             size_t data_block_idx, common::Span<float> _additional_input,
@@ -157,14 +256,9 @@ class RegLossObj : public FitInterceptGlmLike {
           const bool _is_null_weight = _additional_input[1];
 
           for (size_t idx = begin; idx < end; ++idx) {
-            bst_float p = Loss::PredTransform(preds_ptr[idx]);
             bst_float w = _is_null_weight ? 1.0f : weights_ptr[idx / n_targets];
-            bst_float label = labels_ptr[idx];
-            if (label == 1.0f) {
-              w *= _scale_pos_weight;
-            }
-            out_gpair_ptr[idx] = GradientPair(Loss::FirstOrderGradient(p, label) * w,
-                                              Loss::SecondOrderGradient(p, label) * w);
+            out_gpair_ptr[idx] =
+                RegLossGradient<Loss>(preds_ptr[idx], labels_ptr[idx], w, _scale_pos_weight);
           }
         },
         common::Range{0, static_cast<int64_t>(n_data_blocks)}, nthreads, device)
@@ -172,6 +266,15 @@ class RegLossObj : public FitInterceptGlmLike {
               &info.weights_);
   }
 
+  [[nodiscard]] std::unique_ptr<RowGradient> MakeRowGradient(
+      HostDeviceVector<float> const& preds, MetaInfo const& info) const override {
+    if (!ctx_->IsCPU() || this->Targets(info) != 1) {
+      return nullptr;
+    }
+    CheckRegInputs(info, preds);
+    return std::make_unique<RegLossRowGradient<Loss>>(preds, info, param_.scale_pos_weight);
+  }
+
  public:
   [[nodiscard]] const char* DefaultEvalMetric() const override {
     return Loss::DefaultEvalMetric();
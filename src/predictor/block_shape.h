@@ -0,0 +1,80 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#ifndef XGBOOST_PREDICTOR_BLOCK_SHAPE_H_
+#define XGBOOST_PREDICTOR_BLOCK_SHAPE_H_
+
+#include <algorithm>  // for min
+#include <cstddef>    // for size_t
+#include <vector>     // for vector
+
+#include "xgboost/base.h"  // for bst_tree_t
+#include "xgboost/span.h"  // for Span
+
+namespace xgboost::predictor {
+/**
+ * @brief How the CPU predictor divides the work between rows and trees.
+ *
+ * A block of rows is evaluated by all trees in a tile before the next block starts. When
+ * the model is larger than the cache, the row blocks of a thread stream through one tile
+ * of trees after another so that the nodes of the tile stay in the cache.
+ */
+struct BlockShape {
+  // Number of rows in a block.
+  std::size_t n_rows{1};
+  // Boundaries of the tree tiles, from the first tree to one past the last tree.
+  std::vector<bst_tree_t> tree_ptr;
+
+  [[nodiscard]] std::size_t NumTiles() const { return tree_ptr.size() - 1; }
+};
+
+/**
+ * @brief Used when the cache size can not be obtained from the system.
+ */
+constexpr std::size_t DefaultL2CacheSize() { return 1024 * 1024; }
+
+/**
+ * @brief Choose the row block size and the tree tiles from the footprint of the data and
+ *        the model.
+ *
+ * The feature vectors of a row block and the nodes of a tree tile each take at most half
+ * of the L2 cache. Row blocks are shrunk by powers of 2 for wide data, and trees are
+ * grouped greedily into tiles.
+ *
+ * @param max_rows   Capacity of the row block.
+ * @param row_bytes  Size of the feature vector for one row.
+ * @param tree_begin Index of the first tree.
+ * @param tree_bytes Size of the nodes for each tree in the range.
+ * @param cache_size Size of the L2 cache, 0 if unknown.
+ */
+inline BlockShape ChooseBlockShape(std::size_t max_rows, std::size_t row_bytes,
+                                   bst_tree_t tree_begin,
+                                   common::Span<std::size_t const> tree_bytes,
+                                   std::size_t cache_size) {
+  // Smaller blocks lose the benefit of walking the same tree for multiple rows.
+  std::size_t constexpr kMinRows = 8;
+  if (cache_size == 0) {
+    cache_size = DefaultL2CacheSize();
+  }
+  auto budget = cache_size / 2;
+
+  BlockShape shape;
+  shape.n_rows = max_rows;
+  while (shape.n_rows > std::min(max_rows, kMinRows) && shape.n_rows * row_bytes > budget) {
+    shape.n_rows /= 2;
+  }
+
+  shape.tree_ptr.push_back(tree_begin);
+  std::size_t tile_bytes{0};
+  for (std::size_t i = 0; i < tree_bytes.size(); ++i) {
+    if (tile_bytes != 0 && tile_bytes + tree_bytes[i] > budget) {
+      shape.tree_ptr.push_back(tree_begin + static_cast<bst_tree_t>(i));
+      tile_bytes = 0;
+    }
+    tile_bytes += tree_bytes[i];
+  }
+  shape.tree_ptr.push_back(tree_begin + static_cast<bst_tree_t>(tree_bytes.size()));
+  return shape;
+}
+}  // namespace xgboost::predictor
+#endif  // XGBOOST_PREDICTOR_BLOCK_SHAPE_H_
@@ -0,0 +1,211 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include "codegen.h"
+
+#include <cmath>    // for isnan, isinf
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t
+#include <cstdio>   // for snprintf
+#include <sstream>  // for stringstream
+#include <string>   // for string
+
+#include "../common/categorical.h"              // for GetNodeCats
+#include "../common/version.h"                  // for Version
+#include "../gbm/gbtree_model.h"                // for GBTreeModel
+#include "xgboost/learner.h"                    // for LearnerModelParam
+#include "xgboost/logging.h"                    // for CHECK_LE
+#include "xgboost/multi_target_tree_model.h"    // for MultiTargetTree
+#include "xgboost/tree_model.h"                 // for RegTree
+
+namespace xgboost::predictor {
+namespace {
+/**
+ * @brief Exact float literal of a value.
+ */
+std::string Literal(float v) {
+  if (std::isnan(v)) {
+    return "NAN";
+  }
+  if (std::isinf(v)) {
+    return v > 0 ? "HUGE_VALF" : "(-HUGE_VALF)";
+  }
+  // 9 significant digits are sufficient for the round trip of a 32-bit float.
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%.8ef", static_cast<double>(v));
+  return buf;
+}
+
+std::string Indent(std::size_t depth) { return std::string(2 * depth, ' '); }
+
+class CodeGenerator {
+  gbm::GBTreeModel const& model_;
+  bst_target_t n_targets_;
+  // Constant arrays for the category sets.
+  std::stringstream constants_;
+  std::stringstream trees_;
+
+  [[nodiscard]] static std::string TreeName(bst_tree_t tree_idx) {
+    return "xgb_tree_" + std::to_string(tree_idx);
+  }
+
+  /**
+   * @brief Expression that evaluates to true if the sample goes to the left child.
+   */
+  std::string Condition(RegTree const& tree, bst_tree_t tree_idx, bst_node_t nidx,
+                        bst_feature_t fidx, float cond, bool default_left) {
+    auto fvalue = "x[" + std::to_string(fidx) + "]";
+    std::string go_left;
+    if (tree.HasCategoricalSplit() && tree.NodeSplitType(nidx) == FeatureType::kCategorical) {
+      auto node_cats =
+          common::GetNodeCats(tree.GetSplitCategories(), tree.GetSplitCategoriesPtr()[nidx]);
+      // Re-encode the set with the lowest bit first, independent of the bit field layout.
+      auto n_words = node_cats.Capacity() / 32;
+      auto name = "xgb_cats_" + std::to_string(tree_idx) + "_" + std::to_string(nidx);
+      constants_ << "static uint32_t const " << name << "[] = {";
+      for (std::size_t w = 0; w < n_words; ++w) {
+        std::uint32_t word{0};
+        for (std::uint32_t b = 0; b < 32; ++b) {
+          if (node_cats.Check(w * 32 + b)) {
+            word |= 1U << b;
+          }
+        }
+        constants_ << (w == 0 ? "" : ", ") << word << "u";
+      }
+      if (n_words == 0) {
+        constants_ << "0u";
+      }
+      constants_ << "};\n";
+      // Go to the left if it's not the matching category, same as common::Decision.
+      go_left = "!xgb_in_set(" + name + ", " + std::to_string(n_words) + ", " + fvalue + ")";
+    } else {
+      go_left = fvalue + " < " + Literal(cond);
+    }
+    if (default_left) {
+      return "xgb_missing(" + fvalue + ", missing) || " + go_left;
+    }
+    return "!xgb_missing(" + fvalue + ", missing) && " + go_left;
+  }
+
+  void Leaf(RegTree const& tree, bst_node_t nidx, std::size_t depth) {
+    if (tree.IsMultiTarget()) {
+      auto value = tree.GetMultiTargetTree()->LeafValue(nidx);
+      for (std::size_t t = 0; t < value.Size(); ++t) {
+        trees_ << Indent(depth) << "out[" << t << "] += " << Literal(value(t)) << ";\n";
+      }
+      trees_ << Indent(depth) << "return;\n";
+    } else {
+      trees_ << Indent(depth) << "return " << Literal(tree[nidx].LeafValue()) << ";\n";
+    }
+  }
+
+  void Node(RegTree const& tree, bst_tree_t tree_idx, bst_node_t nidx, std::size_t depth) {
+    bst_node_t left, right;
+    std::string go_left;
+    if (tree.IsMultiTarget()) {
+      auto const* mt_tree = tree.GetMultiTargetTree();
+      if (mt_tree->IsLeaf(nidx)) {
+        this->Leaf(tree, nidx, depth);
+        return;
+      }
+      left = mt_tree->LeftChild(nidx);
+      right = mt_tree->RightChild(nidx);
+      go_left = this->Condition(tree, tree_idx, nidx, mt_tree->SplitIndex(nidx),
+                                mt_tree->SplitCond(nidx), mt_tree->DefaultLeft(nidx));
+    } else {
+      auto const& node = tree[nidx];
+      if (node.IsLeaf()) {
+        this->Leaf(tree, nidx, depth);
+        return;
+      }
+      left = node.LeftChild();
+      right = node.RightChild();
+      go_left = this->Condition(tree, tree_idx, nidx, node.SplitIndex(), node.SplitCond(),
+                                node.DefaultLeft());
+    }
+    trees_ << Indent(depth) << "if (" << go_left << ") {\n";
+    this->Node(tree, tree_idx, left, depth + 1);
+    trees_ << Indent(depth) << "} else {\n";
+    this->Node(tree, tree_idx, right, depth + 1);
+    trees_ << Indent(depth) << "}\n";
+  }
+
+ public:
+  explicit CodeGenerator(gbm::GBTreeModel const& model)
+      : model_{model}, n_targets_{model.learner_model_param->OutputLength()} {}
+
+  std::string Generate(bst_tree_t tree_begin, bst_tree_t tree_end) {
+    CHECK_LE(tree_begin, tree_end);
+    CHECK_LE(tree_end, static_cast<bst_tree_t>(model_.trees.size()));
+    bool has_categorical{false};
+    for (bst_tree_t t = tree_begin; t < tree_end; ++t) {
+      auto const& tree = *model_.trees[t];
+      has_categorical |= tree.HasCategoricalSplit();
+      if (tree.IsMultiTarget()) {
+        trees_ << "static void " << TreeName(t)
+               << "(float const* x, float missing, float* out) {\n";
+      } else {
+        trees_ << "static float " << TreeName(t) << "(float const* x, float missing) {\n";
+      }
+      this->Node(tree, t, RegTree::kRoot, 1);
+      trees_ << "}\n\n";
+    }
+
+    auto n_features = model_.learner_model_param->num_feature;
+    auto base_score = model_.learner_model_param->BaseScore(DeviceOrd::CPU())(0);
+    std::stringstream ss;
+    ss << "/* Generated by XGBoost " << Version::String(Version::Self()) << " for trees ["
+       << tree_begin << ", " << tree_end << "). */\n"
+       << "#include <math.h>\n"
+       << "#include <stddef.h>\n"
+       << "#include <stdint.h>\n\n"
+       << "#if defined(__cplusplus)\n"
+       << "extern \"C\" {\n"
+       << "#endif\n\n"
+       << "static int xgb_missing(float v, float missing) { return isnan(v) || v == missing; }\n\n";
+    if (has_categorical) {
+      // Invalid categories go to the left, same as common::InvalidCat.
+      ss << "static int xgb_in_set(uint32_t const* set, size_t n_words, float v) {\n"
+         << "  uint32_t c;\n"
+         << "  if (!(v >= 0.0f && v < 16777216.0f)) {\n"
+         << "    return 0;\n"
+         << "  }\n"
+         << "  c = (uint32_t)v;\n"
+         << "  return c / 32 < n_words && ((set[c / 32] >> (c % 32)) & 1u);\n"
+         << "}\n\n"
+         << constants_.str() << "\n";
+    }
+    ss << trees_.str();
+    ss << "size_t xgboost_num_feature(void) { return " << n_features << "; }\n\n"
+       << "size_t xgboost_num_target(void) { return " << n_targets_ << "; }\n\n"
+       << "void xgboost_predict_batch(float const* data, size_t n_rows, float missing, "
+          "float* out) {\n"
+       << "  size_t i, k;\n"
+       << "  for (i = 0; i < n_rows; ++i) {\n"
+       << "    float const* x = data + i * " << n_features << ";\n"
+       << "    float* y = out + i * " << n_targets_ << ";\n"
+       << "    for (k = 0; k < " << n_targets_ << "; ++k) {\n"
+       << "      y[k] = " << Literal(base_score) << ";\n"
+       << "    }\n";
+    for (bst_tree_t t = tree_begin; t < tree_end; ++t) {
+      if (model_.trees[t]->IsMultiTarget()) {
+        ss << "    " << TreeName(t) << "(x, missing, y);\n";
+      } else {
+        ss << "    y[" << model_.tree_info[t] << "] += " << TreeName(t) << "(x, missing);\n";
+      }
+    }
+    ss << "  }\n"
+       << "}\n\n"
+       << "#if defined(__cplusplus)\n"
+       << "}\n"
+       << "#endif\n";
+    return ss.str();
+  }
+};
+}  // namespace
+
+std::string GenerateCode(gbm::GBTreeModel const& model, bst_tree_t tree_begin,
+                         bst_tree_t tree_end) {
+  return CodeGenerator{model}.Generate(tree_begin, tree_end);
+}
+}  // namespace xgboost::predictor
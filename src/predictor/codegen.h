@@ -0,0 +1,41 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#ifndef XGBOOST_PREDICTOR_CODEGEN_H_
+#define XGBOOST_PREDICTOR_CODEGEN_H_
+
+#include <string>  // for string
+
+#include "xgboost/base.h"  // for bst_tree_t
+
+namespace xgboost::gbm {
+struct GBTreeModel;
+}  // namespace xgboost::gbm
+
+namespace xgboost::predictor {
+/**
+ * @brief Generate C source code for a range of trees in the model.
+ *
+ * Each tree becomes a function of nested branches with thresholds, category sets and leaf
+ * values compiled in as constants. Missing values, categorical splits and multi-target
+ * trees follow the same rules as the CPU predictor. The generated code is valid C99 and
+ * C++, and exports the following functions with C linkage:
+ *
+ * @code
+ *   size_t xgboost_num_feature(void);
+ *   size_t xgboost_num_target(void);
+ *   void xgboost_predict_batch(float const* data, size_t n_rows, float missing, float* out);
+ * @endcode
+ *
+ * The batch function takes a row-major dense matrix with @ref xgboost_num_feature columns
+ * and writes the output margin of each row, like @ref Predictor::PredictBatch without the
+ * base margin. Values that are NaN or equal to `missing` are treated as missing.
+ *
+ * @param model      The tree model.
+ * @param tree_begin Index of the first tree.
+ * @param tree_end   One past the index of the last tree.
+ */
+[[nodiscard]] std::string GenerateCode(gbm::GBTreeModel const& model, bst_tree_t tree_begin,
+                                       bst_tree_t tree_end);
+}  // namespace xgboost::predictor
+#endif  // XGBOOST_PREDICTOR_CODEGEN_H_
@@ -0,0 +1,446 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include "compiled_forest.h"
+
+#include <algorithm>      // for none_of, find_if, fill, max, count_if
+#include <cstddef>        // for size_t
+#include <cstdint>        // for int32_t, int64_t, intptr_t, uint32_t
+#include <cstring>        // for memcpy
+#include <limits>         // for numeric_limits
+#include <memory>         // for make_shared
+#include <mutex>          // for once_flag, call_once
+#include <numeric>        // for partial_sum
+#include <type_traits>    // for is_same_v
+#include <unordered_map>  // for unordered_multimap
+#include <utility>        // for move
+#include <vector>         // for vector
+
+#include "../common/categorical.h"      // for KCatBitField
+#include "../common/common.h"           // for DivRoundUp
+#include "../common/cpu_dispatch.h"     // for GetCpuIsa
+#include "../common/threading_utils.h"  // for ParallelFor, GetCpuNuma, NumNumaNodes
+#include "../gbm/gbtree_model.h"        // for GBTreeModel
+#include "xgboost/logging.h"            // for CHECK_EQ
+
+#if defined(__x86_64__) && defined(__GNUC__)
+// The kernels are compiled with function-level target attributes and selected at runtime,
+// no compiler flag is required for the rest of the library.
+#define XGBOOST_SIMD_TRAVERSAL_PRESENT 1
+#include <immintrin.h>
+#endif  // defined(__x86_64__) && defined(__GNUC__)
+
+namespace xgboost::predictor {
+namespace {
+// Get the node indices of a tree in breadth-first order. Deleted nodes are not reachable
+// hence excluded.
+std::vector<bst_node_t> BfsOrder(RegTree const& tree) {
+  std::vector<bst_node_t> order{RegTree::kRoot};
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    auto const& node = tree[order[i]];
+    if (!node.IsLeaf()) {
+      order.push_back(node.LeftChild());
+      order.push_back(node.RightChild());
+    }
+  }
+  return order;
+}
+
+// Get the node indices of a tree padded into a complete tree with the given depth, in
+// breadth-first order. Leaves above the last level are repeated for the positions of their
+// subtrees.
+std::vector<bst_node_t> CompleteOrder(RegTree const& tree, std::int32_t depth) {
+  std::size_t n_internal = (std::size_t{1} << depth) - 1;
+  std::vector<bst_node_t> order(2 * n_internal + 1);
+  order[0] = RegTree::kRoot;
+  for (std::size_t i = 0; i < n_internal; ++i) {
+    auto const& node = tree[order[i]];
+    order[2 * i + 1] = node.IsLeaf() ? order[i] : node.LeftChild();
+    order[2 * i + 2] = node.IsLeaf() ? order[i] : node.RightChild();
+  }
+  return order;
+}
+
+// Depth of the complete layout for a tree, kPacked if the packed layout should be used.
+std::int32_t CompleteDepth(RegTree const& tree, std::vector<bst_node_t> const& bfs,
+                           std::int32_t max_depth, std::int32_t packed) {
+  if (tree.HasCategoricalSplit()) {
+    return packed;
+  }
+  auto depth = tree.MaxDepth(RegTree::kRoot);
+  if (depth > max_depth) {
+    return packed;
+  }
+  // Use the complete layout when the padding adds at most a third of the nodes.
+  auto n_complete = (std::size_t{2} << depth) - 1;
+  return bfs.size() * 4 >= n_complete * 3 ? depth : packed;
+}
+
+std::uint32_t FloatBits(float v) {
+  std::uint32_t bits;
+  std::memcpy(&bits, &v, sizeof(bits));
+  return bits;
+}
+
+float BitsFloat(std::uint32_t bits) {
+  float v;
+  std::memcpy(&v, &bits, sizeof(v));
+  return v;
+}
+
+// Number of 64-bit words for the bitset of a categorical split, including the size.
+std::size_t CatWords(RegTree const& tree, bst_node_t nidx) {
+  auto n_words = common::DivRoundUp(tree.NodeCats(nidx).size(), 2);
+  // Keep at least one word so that out of range categories can be tested without branch.
+  return 1 + std::max(n_words, static_cast<std::size_t>(1));
+}
+
+#if defined(XGBOOST_SIMD_TRAVERSAL_PRESENT)
+/**
+ * @brief A single tree in the compiled forest, see @ref CompiledForest for the layout.
+ */
+struct TreeView {
+  std::uint32_t const* sindex;
+  float const* value;
+  bst_node_t const* left;
+  std::uint32_t feature_mask;
+  std::uint32_t default_left_bit;
+};
+
+/**
+ * @brief Prepare the lanes for a group of samples.
+ *
+ * The feature vectors are not contiguous, we gather from a base pointer with 64-bit byte
+ * offsets to each of them. Lanes of samples without missing value use the scalar
+ * comparison for NaN, which sends it to the right child.
+ */
+template <std::size_t kLanes>
+void InitLanes(RegTree::FVec const* feats, float const* base, std::int64_t* offsets,
+               std::int32_t* has_missing) {
+  for (std::size_t k = 0; k < kLanes; ++k) {
+    offsets[k] = reinterpret_cast<std::intptr_t>(feats[k].Data().data()) -
+                 reinterpret_cast<std::intptr_t>(base);
+    has_missing[k] = feats[k].HasMissing() ? -1 : 0;
+  }
+}
+
+/**
+ * @brief Move `kGroups * 16` samples down the tree. Groups are interleaved to hide the
+ *        latency of gather instructions. The output is the leaf value if `T` is float,
+ *        otherwise the leaf index.
+ */
+template <std::size_t kGroups, typename T>
+__attribute__((target("avx512f"))) void PredValueAvx512(TreeView const& tree,
+                                                        RegTree::FVec const* feats, T* out) {
+  std::size_t constexpr kLanes = 16;
+  auto const* p_sindex = reinterpret_cast<int const*>(tree.sindex);
+  auto const* p_left = reinterpret_cast<int const*>(tree.left);
+  auto const* base = feats[0].Data().data();
+
+  auto const zero = _mm512_setzero_si512();
+  auto const one = _mm512_set1_epi32(1);
+  auto const invalid = _mm512_set1_epi32(RegTree::kInvalidNodeId);
+  auto const feature_mask = _mm512_set1_epi32(static_cast<std::int32_t>(tree.feature_mask));
+  auto const dleft_bit = _mm512_set1_epi32(static_cast<std::int32_t>(tree.default_left_bit));
+
+  __m512i off_lo[kGroups], off_hi[kGroups], nidx[kGroups];
+  __mmask16 lane_missing[kGroups], is_split[kGroups];
+  for (std::size_t g = 0; g < kGroups; ++g) {
+    alignas(64) std::int64_t offsets[kLanes];
+    alignas(64) std::int32_t has_missing[kLanes];
+    InitLanes<kLanes>(feats + g * kLanes, base, offsets, has_missing);
+    off_lo[g] = _mm512_load_si512(offsets);
+    off_hi[g] = _mm512_load_si512(offsets + 8);
+    lane_missing[g] = _mm512_cmpneq_epi32_mask(_mm512_load_si512(has_missing), zero);
+    nidx[g] = zero;
+    is_split[g] = 0xFFFF;
+  }
+
+  bool active = true;
+  while (active) {
+    active = false;
+    for (std::size_t g = 0; g < kGroups; ++g) {
+      // Lanes that have reached a leaf are masked out in all gathers.
+      auto left = _mm512_mask_i32gather_epi32(invalid, is_split[g], nidx[g], p_left, 4);
+      is_split[g] = _mm512_cmpneq_epi32_mask(left, invalid);
+      if (is_split[g] == 0) {
+        continue;
+      }
+      active = true;
+      auto split = _mm512_mask_i32gather_epi32(zero, is_split[g], nidx[g], p_sindex, 4);
+      auto cond =
+          _mm512_mask_i32gather_ps(_mm512_setzero_ps(), is_split[g], nidx[g], tree.value, 4);
+      auto fidx = _mm512_and_si512(split, feature_mask);
+      auto addr_lo = _mm512_add_epi64(
+          off_lo[g], _mm512_slli_epi64(_mm512_cvtepu32_epi64(_mm512_castsi512_si256(fidx)), 2));
+      auto addr_hi = _mm512_add_epi64(
+          off_hi[g],
+          _mm512_slli_epi64(_mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(fidx, 1)), 2));
+      auto f_lo = _mm512_mask_i64gather_ps(_mm256_setzero_ps(),
+                                           static_cast<__mmask8>(is_split[g]), addr_lo, base, 1);
+      auto f_hi = _mm512_mask_i64gather_ps(
+          _mm256_setzero_ps(), static_cast<__mmask8>(is_split[g] >> 8), addr_hi, base, 1);
+      auto fvalue = _mm512_castpd_ps(_mm512_insertf64x4(
+          _mm512_castpd256_pd512(_mm256_castps_pd(f_lo)), _mm256_castps_pd(f_hi), 1));
+      // Select the child.
+      __mmask16 missing = _mm512_cmp_ps_mask(fvalue, fvalue, _CMP_UNORD_Q) & lane_missing[g];
+      __mmask16 not_less = _mm512_cmp_ps_mask(fvalue, cond, _CMP_NLT_UQ);
+      __mmask16 default_right = _mm512_testn_epi32_mask(split, dleft_bit);
+      __mmask16 go_right = (not_less & ~missing) | (default_right & missing);
+      auto next = _mm512_mask_add_epi32(left, go_right, left, one);
+      nidx[g] = _mm512_mask_mov_epi32(nidx[g], is_split[g], next);
+    }
+  }
+  for (std::size_t g = 0; g < kGroups; ++g) {
+    if constexpr (std::is_same_v<T, float>) {
+      _mm512_storeu_ps(out + g * kLanes, _mm512_i32gather_ps(nidx[g], tree.value, 4));
+    } else {
+      static_assert(std::is_same_v<T, bst_node_t>);
+      _mm512_storeu_si512(out + g * kLanes, nidx[g]);
+    }
+  }
+}
+#endif  // defined(XGBOOST_SIMD_TRAVERSAL_PRESENT)
+}  // namespace
+
+CompiledForest::CompiledForest(Context const* ctx, gbm::GBTreeModel const& model)
+    : version_{model.Version()} {
+  CHECK(CanCompile(model));
+  auto n_trees = model.trees.size();
+  std::vector<std::vector<bst_node_t>> orders(n_trees);
+  cat_ptr_.resize(n_trees + 1, 0);
+  depth_.resize(n_trees);
+  common::ParallelFor(n_trees, ctx->Threads(), [&](auto t) {
+    auto const& tree = *model.trees[t];
+    orders[t] = BfsOrder(tree);
+    depth_[t] = CompleteDepth(tree, orders[t], kMaxCompleteDepth, kPacked);
+    if (depth_[t] != kPacked) {
+      orders[t] = CompleteOrder(tree, depth_[t]);
+    }
+    if (tree.HasCategoricalSplit()) {
+      for (auto nidx : orders[t]) {
+        if (!tree[nidx].IsLeaf() && tree.NodeSplitType(nidx) == FeatureType::kCategorical) {
+          cat_ptr_[t + 1] += CatWords(tree, nidx);
+        }
+      }
+    }
+  });
+
+  tree_ptr_.resize(n_trees + 1, 0);
+  for (std::size_t t = 0; t < n_trees; ++t) {
+    tree_ptr_[t + 1] = orders[t].size();
+  }
+  std::partial_sum(tree_ptr_.cbegin(), tree_ptr_.cend(), tree_ptr_.begin());
+  std::partial_sum(cat_ptr_.cbegin(), cat_ptr_.cend(), cat_ptr_.begin());
+
+  auto n_nodes = tree_ptr_.back();
+  sindex_.resize(n_nodes);
+  value_.resize(n_nodes);
+  left_.resize(n_nodes);
+  cat_bits_.resize(cat_ptr_.back(), 0);
+
+  common::ParallelFor(n_trees, ctx->Threads(), [&](auto t) {
+    auto const& tree = *model.trees[t];
+    auto const& order = orders[t];
+    auto beg = tree_ptr_[t];
+    auto cat_beg = cat_ptr_[t];
+    std::size_t cat_offset{0};
+    // Positions before the last level are splits in the complete layout.
+    auto n_internal = depth_[t] == kPacked ? 0 : (std::size_t{1} << depth_[t]) - 1;
+    // The children of the i^th internal node in BFS order are placed consecutively, with
+    // the left child at the position where it's pushed into the queue.
+    bst_node_t next_child{1};
+    for (std::size_t i = 0; i < order.size(); ++i) {
+      auto const& node = tree[order[i]];
+      if (node.IsLeaf() && i < n_internal) {
+        // Dummy split of a padded leaf, both children are copies of the leaf.
+        sindex_[beg + i] = 0;
+        value_[beg + i] = std::numeric_limits<float>::infinity();
+        left_[beg + i] = next_child;
+        next_child += 2;
+      } else if (node.IsLeaf()) {
+        sindex_[beg + i] = 0;
+        value_[beg + i] = node.LeafValue();
+        left_[beg + i] = RegTree::kInvalidNodeId;
+      } else {
+        CHECK_EQ(order[next_child], node.LeftChild());
+        CHECK_LE(node.SplitIndex(), kFeatureMask);
+        sindex_[beg + i] = node.SplitIndex() | (node.DefaultLeft() ? kDefaultLeftBit : 0U);
+        if (tree.NodeSplitType(order[i]) == FeatureType::kCategorical) {
+          // Convert the bitset into 64-bit words with the i^th bit being the i^th category.
+          auto node_cats = tree.NodeCats(order[i]);
+          common::KCatBitField s_cats{node_cats};
+          auto* bits = cat_bits_.data() + cat_beg + cat_offset;
+          bits[0] = CatWords(tree, order[i]) - 1;
+          for (std::size_t c = 0; c < node_cats.size() * 32; ++c) {
+            if (s_cats.Check(c)) {
+              bits[1 + c / 64] |= std::uint64_t{1} << (c % 64);
+            }
+          }
+          CHECK_LE(cat_offset, std::numeric_limits<std::uint32_t>::max());
+          sindex_[beg + i] |= kCategoricalBit;
+          value_[beg + i] = BitsFloat(static_cast<std::uint32_t>(cat_offset));
+          cat_offset += bits[0] + 1;
+        } else {
+          value_[beg + i] = node.SplitCond();
+        }
+        left_[beg + i] = next_child;
+        next_child += 2;
+      }
+    }
+  });
+
+  this->FindSharedTrees(ctx, model);
+}
+
+void CompiledForest::FindSharedTrees(Context const* ctx, gbm::GBTreeModel const& model) {
+  auto n_trees = this->NumTrees();
+  // The thresholds are compared by their bits, leaves are distinguished by the children.
+  auto same_split = [this](std::size_t l, std::size_t r) {
+    return left_[l] == left_[r] && sindex_[l] == sindex_[r] &&
+           (left_[l] == RegTree::kInvalidNodeId ||
+            FloatBits(value_[l]) == FloatBits(value_[r]));
+  };
+  std::vector<std::size_t> hashes(n_trees);
+  common::ParallelFor(n_trees, ctx->Threads(), [&](auto t) {
+    std::size_t h = model.tree_info[t];
+    auto combine = [&](std::size_t v) { h ^= v + 0x9e3779b9 + (h << 6) + (h >> 2); };
+    for (auto i = tree_ptr_[t]; i < tree_ptr_[t + 1]; ++i) {
+      combine(static_cast<std::uint32_t>(left_[i]));
+      if (left_[i] != RegTree::kInvalidNodeId) {
+        combine(sindex_[i]);
+        combine(FloatBits(value_[i]));
+      }
+    }
+    hashes[t] = h;
+  });
+
+  prev_shared_.assign(n_trees, kNoTree);
+  next_shared_.assign(n_trees, kNoTree);
+  // Hash of the splits -> the last tree of each group of identical trees.
+  std::unordered_multimap<std::size_t, bst_tree_t> last;
+  for (bst_tree_t t = 0; t < n_trees; ++t) {
+    auto [beg, end] = last.equal_range(hashes[t]);
+    auto it = std::find_if(beg, end, [&](auto const& kv) {
+      auto s = kv.second;
+      auto n_nodes = tree_ptr_[t + 1] - tree_ptr_[t];
+      if (model.tree_info[s] != model.tree_info[t] || depth_[s] != depth_[t] ||
+          tree_ptr_[s + 1] - tree_ptr_[s] != n_nodes) {
+        return false;
+      }
+      for (std::size_t i = 0; i < n_nodes; ++i) {
+        if (!same_split(tree_ptr_[s] + i, tree_ptr_[t] + i)) {
+          return false;
+        }
+      }
+      return true;
+    });
+    if (it == end) {
+      last.emplace(hashes[t], t);
+    } else {
+      prev_shared_[t] = it->second;
+      next_shared_[it->second] = t;
+      it->second = t;
+    }
+  }
+}
+
+template <typename T>
+void CompiledForest::Traverse(bst_tree_t tree_idx, common::Span<RegTree::FVec const> feats,
+                              common::Span<T> out) const {
+  CHECK_EQ(feats.size(), out.size());
+  std::size_t i = 0;
+#if defined(XGBOOST_SIMD_TRAVERSAL_PRESENT)
+  // AVX2 is not used. It has half the lanes and the gathers with 64-bit offsets into the
+  // feature vectors are slower than the branch-free scalar loop.
+  bool const has_avx512 = common::GetCpuIsa() == common::CpuIsa::kAvx512;
+  auto const beg = tree_ptr_[tree_idx];
+  TreeView tree{sindex_.data() + beg, value_.data() + beg, left_.data() + beg, kFeatureMask,
+                kDefaultLeftBit};
+  auto n = feats.size();
+  if (has_avx512 && !this->HasCategorical(tree_idx)) {
+    for (; i + 32 <= n; i += 32) {
+      PredValueAvx512<2>(tree, feats.data() + i, out.data() + i);
+    }
+    for (; i + 16 <= n; i += 16) {
+      PredValueAvx512<1>(tree, feats.data() + i, out.data() + i);
+    }
+  }
+#endif  // defined(XGBOOST_SIMD_TRAVERSAL_PRESENT)
+  for (; i < feats.size(); ++i) {
+    if constexpr (std::is_same_v<T, float>) {
+      out[i] = feats[i].HasMissing() ? this->PredValue<true>(tree_idx, feats[i])
+                                     : this->PredValue<false>(tree_idx, feats[i]);
+    } else {
+      out[i] = feats[i].HasMissing() ? this->PredLeaf<true>(tree_idx, feats[i])
+                                     : this->PredLeaf<false>(tree_idx, feats[i]);
+    }
+  }
+}
+
+void CompiledForest::PredValue(bst_tree_t tree_idx, common::Span<RegTree::FVec const> feats,
+                               common::Span<float> out) const {
+  this->Traverse(tree_idx, feats, out);
+}
+
+void CompiledForest::PredValue(bst_tree_t tree_idx, bst_tree_t tree_end,
+                               common::Span<RegTree::FVec const> feats,
+                               common::Span<bst_node_t> leaves, common::Span<float> out) const {
+  auto next = next_shared_[tree_idx];
+  if (next == kNoTree || next >= tree_end) {
+    this->Traverse(tree_idx, feats, out);
+    return;
+  }
+  CHECK_EQ(leaves.size(), out.size());
+  this->Traverse(tree_idx, feats, leaves);
+  std::fill(out.begin(), out.end(), 0.0f);
+  for (auto t = tree_idx; t != kNoTree && t < tree_end; t = next_shared_[t]) {
+    auto const* value = value_.data() + tree_ptr_[t];
+    for (std::size_t i = 0; i < out.size(); ++i) {
+      out[i] += value[leaves[i]];
+    }
+  }
+}
+
+NumaForest::NumaForest(Context const* ctx, std::shared_ptr<CompiledForest const> forest)
+    : forest_{std::move(forest)} {
+  CHECK(forest_);
+  auto n_nodes = common::NumNumaNodes();
+  if (n_nodes < 2) {
+    return;
+  }
+  replicas_.resize(n_nodes);
+  std::vector<std::once_flag> copied(n_nodes);
+  // There's no guarantee that the threads are spread over all nodes, the ones missed here
+  // use the original.
+  common::ParallelFor(ctx->Threads(), ctx->Threads(), common::Sched::Static(1), [&](auto) {
+    unsigned cpu{0}, node{0};
+    if (common::GetCpuNuma(&cpu, &node) && node < replicas_.size()) {
+      std::call_once(copied[node],
+                     [&] { replicas_[node] = std::make_shared<CompiledForest const>(*forest_); });
+    }
+  });
+}
+
+CompiledForest const* NumaForest::Local() const {
+  unsigned cpu{0}, node{0};
+  if (!replicas_.empty() && common::GetCpuNuma(&cpu, &node) && node < replicas_.size() &&
+      replicas_[node]) {
+    return replicas_[node].get();
+  }
+  return forest_.get();
+}
+
+std::size_t NumaForest::NumReplicas() const {
+  return std::count_if(replicas_.cbegin(), replicas_.cend(),
+                       [](auto const& p) { return static_cast<bool>(p); });
+}
+
+bool CompiledForest::CanCompile(gbm::GBTreeModel const& model) {
+  if (model.trees.empty() || model.learner_model_param->IsVectorLeaf()) {
+    return false;
+  }
+  return std::none_of(model.trees.cbegin(), model.trees.cend(),
+                      [](auto const& tree) { return tree->IsMultiTarget(); });
+}
+}  // namespace xgboost::predictor
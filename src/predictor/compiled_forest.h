@@ -0,0 +1,278 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#ifndef XGBOOST_PREDICTOR_COMPILED_FOREST_H_
+#define XGBOOST_PREDICTOR_COMPILED_FOREST_H_
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int32_t, uint32_t, uint64_t
+#include <cstring>  // for memcpy
+#include <memory>   // for shared_ptr
+#include <vector>   // for vector
+
+#include "../common/math.h"      // for CheckNAN
+#include "xgboost/base.h"        // for bst_node_t, bst_tree_t, bst_feature_t
+#include "xgboost/context.h"     // for Context
+#include "xgboost/span.h"        // for Span
+#include "xgboost/tree_model.h"  // for RegTree
+
+namespace xgboost::gbm {
+struct GBTreeModel;
+}  // namespace xgboost::gbm
+
+namespace xgboost::predictor {
+/**
+ * @brief A prediction-only copy of the trees in a model.
+ *
+ * Inference needs only the split feature, the threshold, the default direction and the
+ * children of each node. The @ref RegTree::Node carries the parent index as well and the
+ * statistics live next to it, which wastes cache lines during traversal. This class
+ * stores those fields as a struct of arrays, with nodes of each tree renumbered in
+ * breadth-first order. As a result, the right child is always next to the left child, and
+ * the top levels of all trees are packed together at the beginning of each tree segment.
+ *
+ * Categorical splits are compiled into dense bitsets with 64-bit words, indexed by the
+ * category and stored in the order of the nodes of each tree. The first word of each
+ * bitset is the number of words that follow. Unlike the @ref RegTree::CategoricalSplitMatrix,
+ * testing a category doesn't need the segment of the node and doesn't branch.
+ *
+ * Trees that are close to complete, which is the common case for depthwise growth, are
+ * padded into a complete tree instead. Leaves above the last level are replaced by dummy
+ * splits with both subtrees leading to copies of the leaf. The children of node `i` are
+ * then at `2i + 1` and `2i + 2`, and every sample takes exactly `depth` steps. The loop has
+ * a fixed trip count and doesn't load the child indices, which makes it branch-free and
+ * lets the grandchildren be prefetched.
+ *
+ * Only models with scalar leaves can be compiled, see @ref CanCompile.
+ */
+class CompiledForest {
+  static constexpr std::uint32_t kDefaultLeftBit = 1U << 31;
+  static constexpr std::uint32_t kCategoricalBit = 1U << 30;
+  static constexpr std::uint32_t kFeatureMask = kCategoricalBit - 1U;
+  // Trees in the packed layout.
+  static constexpr std::int32_t kPacked = -1;
+
+  // Split feature index, the highest bit is used for the default direction and the second
+  // highest bit is set for categorical splits.
+  std::vector<std::uint32_t> sindex_;
+  // Split condition for numerical splits, the bits of the tree-local offset into the
+  // category bitsets for categorical splits, and leaf value for leaf nodes.
+  std::vector<float> value_;
+  // Tree-local index of the left child, kInvalidNodeId for leaf nodes. The right child is
+  // always `left + 1`.
+  std::vector<bst_node_t> left_;
+  // Offset of each tree in the node arrays.
+  std::vector<std::size_t> tree_ptr_;
+  // Bitsets of the categorical splits, see the class description.
+  std::vector<std::uint64_t> cat_bits_;
+  // Offset of each tree in the bitsets, trees without categorical split have empty range.
+  std::vector<std::size_t> cat_ptr_;
+  // The previous and the next tree of the same output group with the same splits,
+  // kNoTree if there's none. Such trees differ only in leaf values.
+  std::vector<bst_tree_t> prev_shared_;
+  std::vector<bst_tree_t> next_shared_;
+  // Depth of each tree stored in the complete layout, kPacked for the others.
+  std::vector<std::int32_t> depth_;
+  // Version of the model this forest is compiled from.
+  std::uint64_t version_;
+
+  void FindSharedTrees(Context const* ctx, gbm::GBTreeModel const& model);
+  // Whether the category goes to the right child, which is the case only if it's in the
+  // bitset. Negative, out of range and missing values go to the left.
+  [[nodiscard]] static bool CatRight(std::uint64_t const* bits, float fvalue) {
+    auto n_bits = static_cast<float>(bits[0] * 64);
+    bool valid = fvalue >= 0.0f && fvalue < n_bits;
+    auto cat = static_cast<std::uint64_t>(valid ? fvalue : 0.0f);
+    return valid & static_cast<bool>((bits[1 + (cat >> 6)] >> (cat & 63)) & 1);
+  }
+  template <bool has_missing, bool has_categorical>
+  [[nodiscard]] bst_node_t Walk(bst_tree_t tree_idx, RegTree::FVec const& feat) const {
+    auto const beg = tree_ptr_[tree_idx];
+    auto const* sindex = sindex_.data() + beg;
+    auto const* value = value_.data() + beg;
+    auto const* left = left_.data() + beg;
+    auto const* cat_bits = cat_bits_.data() + cat_ptr_[tree_idx];
+
+    bst_node_t nidx{0};
+    while (left[nidx] != RegTree::kInvalidNodeId) {
+      auto const split = sindex[nidx];
+      auto const fvalue = feat.GetFvalue(split & kFeatureMask);
+      if (has_missing && common::CheckNAN(fvalue)) {
+        nidx = left[nidx] + !(split & kDefaultLeftBit);
+      } else if (has_categorical && (split & kCategoricalBit)) {
+        std::uint32_t offset;
+        std::memcpy(&offset, value + nidx, sizeof(offset));
+        nidx = left[nidx] + CatRight(cat_bits + offset, fvalue);
+      } else {
+        nidx = left[nidx] + !(fvalue < value[nidx]);
+      }
+    }
+    return nidx;
+  }
+  // Walk a tree in the complete layout, the output is the position of the leaf in the last
+  // level.
+  template <bool has_missing>
+  [[nodiscard]] bst_node_t WalkComplete(bst_tree_t tree_idx, RegTree::FVec const& feat) const {
+    auto const beg = tree_ptr_[tree_idx];
+    auto const* sindex = sindex_.data() + beg;
+    auto const* value = value_.data() + beg;
+    auto const depth = depth_[tree_idx];
+
+    std::uint32_t nidx{0};
+    for (std::int32_t d = 0; d < depth; ++d) {
+#if defined(XGBOOST_BUILTIN_PREFETCH_PRESENT)
+      // The four grandchildren are contiguous.
+      if (d + 2 <= depth) {
+        __builtin_prefetch(sindex + 4 * nidx + 3, 0, 3);
+        __builtin_prefetch(value + 4 * nidx + 3, 0, 3);
+      }
+#endif  // defined(XGBOOST_BUILTIN_PREFETCH_PRESENT)
+      auto const split = sindex[nidx];
+      auto const fvalue = feat.GetFvalue(split & kFeatureMask);
+      // NaN is not less than the threshold, only the default left needs to be tested.
+      bool right = !(fvalue < value[nidx]);
+      if (has_missing) {
+        right &= !(common::CheckNAN(fvalue) & static_cast<bool>(split & kDefaultLeftBit));
+      }
+      nidx = 2 * nidx + 1 + right;
+    }
+    return static_cast<bst_node_t>(nidx);
+  }
+  // Move a block of samples down the tree, the output is either the leaf values or the
+  // leaf indices.
+  template <typename T>
+  void Traverse(bst_tree_t tree_idx, common::Span<RegTree::FVec const> feats,
+                common::Span<T> out) const;
+
+ public:
+  static constexpr bst_tree_t kNoTree = -1;
+  // Deepest tree that can be stored in the complete layout.
+  static constexpr std::int32_t kMaxCompleteDepth = 10;
+
+  CompiledForest(Context const* ctx, gbm::GBTreeModel const& model);
+
+  /**
+   * @brief Whether the model can be represented by the compiled forest.
+   */
+  [[nodiscard]] static bool CanCompile(gbm::GBTreeModel const& model);
+
+  [[nodiscard]] std::uint64_t Version() const { return version_; }
+  [[nodiscard]] bst_tree_t NumTrees() const { return tree_ptr_.size() - 1; }
+  [[nodiscard]] std::size_t NumNodes() const { return left_.size(); }
+  /**
+   * @brief Size of the nodes of a tree in bytes.
+   */
+  [[nodiscard]] std::size_t TreeBytes(bst_tree_t tree_idx) const {
+    auto n_nodes = tree_ptr_[tree_idx + 1] - tree_ptr_[tree_idx];
+    auto n_words = cat_ptr_[tree_idx + 1] - cat_ptr_[tree_idx];
+    // The child indices are not used by the complete layout.
+    auto node_bytes = sizeof(std::uint32_t) + sizeof(float) +
+                      (this->IsComplete(tree_idx) ? 0 : sizeof(bst_node_t));
+    return n_nodes * node_bytes + n_words * sizeof(std::uint64_t);
+  }
+  /**
+   * @brief Whether the tree has categorical splits.
+   */
+  [[nodiscard]] bool HasCategorical(bst_tree_t tree_idx) const {
+    return cat_ptr_[tree_idx + 1] != cat_ptr_[tree_idx];
+  }
+  /**
+   * @brief Whether the tree is stored in the complete layout, see the class description.
+   */
+  [[nodiscard]] bool IsComplete(bst_tree_t tree_idx) const {
+    return depth_[tree_idx] != kPacked;
+  }
+
+  /**
+   * @brief The previous tree of the same output group with the same splits, @ref kNoTree
+   *        if there's none.
+   */
+  [[nodiscard]] bst_tree_t PrevShared(bst_tree_t tree_idx) const {
+    return prev_shared_[tree_idx];
+  }
+
+  /**
+   * @brief Get the index of the leaf reached by a sample, local to the tree. The index is into
+   *        the compiled nodes and doesn't match the node index of the @ref RegTree.
+   *
+   * @tparam has_missing Whether the feature vector contains missing values.
+   *
+   * @param tree_idx Index of the tree in the model.
+   * @param feat     Dense feature vector for a single sample.
+   */
+  template <bool has_missing>
+  [[nodiscard]] bst_node_t PredLeaf(bst_tree_t tree_idx, RegTree::FVec const& feat) const {
+    if (this->IsComplete(tree_idx)) {
+      return this->WalkComplete<has_missing>(tree_idx, feat);
+    }
+    return this->HasCategorical(tree_idx) ? this->Walk<has_missing, true>(tree_idx, feat)
+                                          : this->Walk<has_missing, false>(tree_idx, feat);
+  }
+  /**
+   * @brief Get the leaf value for a sample, see @ref PredLeaf for the parameters.
+   */
+  template <bool has_missing>
+  [[nodiscard]] float PredValue(bst_tree_t tree_idx, RegTree::FVec const& feat) const {
+    return value_[tree_ptr_[tree_idx] + this->PredLeaf<has_missing>(tree_idx, feat)];
+  }
+  /**
+   * @brief Get the leaf values for a block of samples.
+   *
+   * Groups of 16 samples are moved down the tree together using AVX-512 gathers when the
+   * CPU supports it and the tree has no categorical split, the remainder is handled by
+   * @ref PredValue.
+   *
+   * @param tree_idx Index of the tree in the model.
+   * @param feats    Dense feature vectors, one for each sample.
+   * @param out      Output leaf values, same length as `feats`.
+   */
+  void PredValue(bst_tree_t tree_idx, common::Span<RegTree::FVec const> feats,
+                 common::Span<float> out) const;
+  /**
+   * @brief Get the sum of leaf values for a block of samples, over the tree and the
+   *        following trees with the same splits before `tree_end`. The samples go down
+   *        the tree only once.
+   *
+   * @param tree_idx Index of the tree in the model.
+   * @param tree_end End of the tree range being predicted.
+   * @param feats    Dense feature vectors, one for each sample.
+   * @param leaves   Buffer for the leaf indices, same length as `feats`.
+   * @param out      Output leaf values, same length as `feats`.
+   */
+  void PredValue(bst_tree_t tree_idx, bst_tree_t tree_end,
+                 common::Span<RegTree::FVec const> feats, common::Span<bst_node_t> leaves,
+                 common::Span<float> out) const;
+};
+
+/**
+ * @brief Copies of a compiled forest, one on each NUMA node.
+ *
+ * The nodes are read by every thread for every sample. On a multi-socket machine, threads
+ * on the other sockets walk the trees through the interconnect if the forest is placed on
+ * a single node. The copies are made by threads on each node, which places them locally
+ * with the first-touch policy of the OS.
+ */
+class NumaForest {
+  std::shared_ptr<CompiledForest const> forest_;
+  // Indexed by the NUMA node, null for nodes without a copy.
+  std::vector<std::shared_ptr<CompiledForest const>> replicas_;
+
+ public:
+  NumaForest(Context const* ctx, std::shared_ptr<CompiledForest const> forest);
+
+  /**
+   * @brief The forest being replicated.
+   */
+  [[nodiscard]] CompiledForest const* Forest() const { return forest_.get(); }
+  /**
+   * @brief The copy on the NUMA node of the calling thread, or the original forest if the
+   *        node doesn't have a copy.
+   */
+  [[nodiscard]] CompiledForest const* Local() const;
+  /**
+   * @brief Number of NUMA nodes with a copy of the forest.
+   */
+  [[nodiscard]] std::size_t NumReplicas() const;
+};
+}  // namespace xgboost::predictor
+#endif  // XGBOOST_PREDICTOR_COMPILED_FOREST_H_
@@ -1,33 +1,49 @@
 /**
  * Copyright 2017-2025, XGBoost Contributors
  */
-#include <algorithm>  // for max, fill, min
-#include <any>        // for any, any_cast
-#include <cassert>    // for assert
-#include <cstddef>    // for size_t
-#include <cstdint>    // for uint32_t, int32_t, uint64_t
-#include <memory>     // for unique_ptr, shared_ptr
-#include <ostream>    // for char_traits, operator<<, basic_ostream
-#include <typeinfo>   // for type_info
-#include <vector>     // for vector
+#include <algorithm>    // for max, fill, fill_n, min, remove_if
+#include <any>          // for any, any_cast
+#include <atomic>       // for atomic
+#include <array>        // for array
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint32_t, int32_t, uint64_t
+#include <future>       // for future, promise
+#include <iterator>     // for distance
+#include <limits>       // for numeric_limits
+#include <memory>       // for unique_ptr, shared_ptr
+#include <mutex>        // for mutex, lock_guard
+#include <numeric>      // for iota, accumulate
+#include <ostream>      // for char_traits, operator<<, basic_ostream
+#include <type_traits>  // for remove_reference_t, remove_cv_t
+#include <typeinfo>     // for type_info
+#include <vector>       // for vector
 
 #include "../collective/communicator-inl.h"   // for Allreduce, IsDistributed
 #include "../collective/allreduce.h"
+#include "../collective/comm_group.h"         // for GlobalCommGroup
 #include "../common/bitfield.h"               // for RBitField8
 #include "../common/common.h"                 // for DivRoundUp
+#include "../common/cpu_dispatch.h"           // for DispatchCpuIsa
 #include "../common/error_msg.h"              // for InplacePredictProxy
 #include "../common/math.h"                   // for CheckNAN
-#include "../common/threading_utils.h"        // for ParallelFor
+#include "../common/memory_stats.h"           // for MemoryAccount
+#include "../common/perf_counter.h"           // for PerfScope
+#include "../common/threading_utils.h"        // for ParallelFor, NumNumaNodes
+#include "../common/threadpool.h"             // for ThreadPool
 #include "../data/adapter.h"                  // for ArrayAdapter, CSRAdapter, CSRArrayAdapter
+#include "../data/borrowed_dmatrix.h"         // for BorrowedDMatrix
 #include "../data/gradient_index.h"           // for GHistIndexMatrix
 #include "../data/proxy_dmatrix.h"            // for DMatrixProxy
 #include "../gbm/gbtree_model.h"              // for GBTreeModel, GBTreeModelParam
-#include "cpu_treeshap.h"                     // for CalculateContributions
+#include "block_shape.h"                      // for BlockShape, ChooseBlockShape
+#include "compiled_forest.h"                  // for CompiledForest, NumaForest
+#include "cpu_treeshap.h"                     // for CalculateContributions, TreeShapTable
 #include "dmlc/registry.h"                    // for DMLC_REGISTRY_FILE_TAG
 #include "predict_fn.h"                       // for GetNextNode, GetNextNodeMulti
 #include "xgboost/base.h"                     // for bst_float, bst_node_t, bst_omp_uint, bst_fe...
 #include "xgboost/context.h"                  // for Context
 #include "xgboost/data.h"                     // for Entry, DMatrix, MetaInfo, SparsePage, Batch...
+#include "xgboost/global_config.h"            // for InitNewThread
 #include "xgboost/host_device_vector.h"       // for HostDeviceVector
 #include "xgboost/learner.h"                  // for LearnerModelParam
 #include "xgboost/linalg.h"                   // for TensorView, All, VectorView, Tensor
@@ -79,82 +95,166 @@ bst_node_t GetLeafIndex(MultiTargetTree const &tree, const RegTree::FVec &feat,
   return nidx;
 }
 
-template <bool has_categorical>
-void PredValueByOneTree(RegTree::FVec const &p_feats, MultiTargetTree const &tree,
-                        RegTree::CategoricalSplitMatrix const &cats,
-                        linalg::VectorView<float> out_predt) {
-  bst_node_t const leaf = p_feats.HasMissing()
-                              ? GetLeafIndex<true, has_categorical>(tree, p_feats, cats)
-                              : GetLeafIndex<false, has_categorical>(tree, p_feats, cats);
-  auto leaf_value = tree.LeafValue(leaf);
-  assert(out_predt.Shape(0) == leaf_value.Shape(0) && "shape mismatch.");
-  for (size_t i = 0; i < leaf_value.Size(); ++i) {
-    out_predt(i) += leaf_value(i);
+// Number of trees whose leaves are found before accumulating the leaf weights.
+constexpr std::size_t kBlockOfTreesSize = 16;
+// Number of targets accumulated together, the output tile of a block of rows is kept in
+// the L1 cache while the leaf weights of all trees in a block are added to it.
+constexpr std::size_t kBlockOfTargetsSize = 64;
+
+/**
+ * @brief Predict a block of rows with multi-target trees.
+ *
+ *   For each block of trees, the leaf index of every row is found first. Then the leaf
+ *   weights, which are contiguous in the tree, are accumulated over blocks of targets.
+ */
+template <std::size_t kBlockOfRowsSize>
+void PredictByAllTrees(gbm::GBTreeModel const &model, bst_tree_t const tree_begin,
+                       bst_tree_t const tree_end, std::size_t const predict_offset,
+                       common::Span<RegTree::FVec const> feats,
+                       linalg::MatrixView<float> out_predt) {
+  std::array<bst_node_t, kBlockOfTreesSize * kBlockOfRowsSize> leaves;
+  auto const block_size = feats.size();
+  auto const n_targets = out_predt.Shape(1);
+  bool const contiguous = out_predt.Stride(1) == 1;
+
+  for (auto t_begin = tree_begin; t_begin < tree_end;
+       t_begin += static_cast<bst_tree_t>(kBlockOfTreesSize)) {
+    auto t_end = std::min(t_begin + static_cast<bst_tree_t>(kBlockOfTreesSize), tree_end);
+    for (auto tree_id = t_begin; tree_id < t_end; ++tree_id) {
+      auto const &tree = *model.trees[tree_id];
+      auto const &cats = tree.GetCategoriesMatrix();
+      auto const *mt_tree = tree.GetMultiTargetTree();
+      auto *tree_leaves = leaves.data() + (tree_id - t_begin) * kBlockOfRowsSize;
+      for (std::size_t i = 0; i < block_size; ++i) {
+        if (tree.HasCategoricalSplit()) {
+          tree_leaves[i] = feats[i].HasMissing()
+                               ? GetLeafIndex<true, true>(*mt_tree, feats[i], cats)
+                               : GetLeafIndex<false, true>(*mt_tree, feats[i], cats);
+        } else {
+          tree_leaves[i] = feats[i].HasMissing()
+                               ? GetLeafIndex<true, false>(*mt_tree, feats[i], cats)
+                               : GetLeafIndex<false, false>(*mt_tree, feats[i], cats);
+        }
+      }
+    }
+
+    for (std::size_t k_begin = 0; k_begin < n_targets; k_begin += kBlockOfTargetsSize) {
+      auto k_end = std::min(k_begin + kBlockOfTargetsSize, n_targets);
+      for (auto tree_id = t_begin; tree_id < t_end; ++tree_id) {
+        auto weights = model.trees[tree_id]->GetMultiTargetTree()->Weights();
+        auto const *tree_leaves = leaves.data() + (tree_id - t_begin) * kBlockOfRowsSize;
+        for (std::size_t i = 0; i < block_size; ++i) {
+          auto const *w = weights.data() + tree_leaves[i] * n_targets;
+          if (contiguous) {
+            float *o = &out_predt(predict_offset + i, 0);
+#pragma omp simd
+            for (std::size_t k = k_begin; k < k_end; ++k) {
+              o[k] += w[k];
+            }
+          } else {
+            for (std::size_t k = k_begin; k < k_end; ++k) {
+              out_predt(predict_offset + i, k) += w[k];
+            }
+          }
+        }
+      }
+    }
   }
 }
 }  // namespace multi
 
 namespace {
+template <std::size_t kBlockOfRowsSize>
+void PredictByAllTrees(CompiledForest const &forest, gbm::GBTreeModel const &model,
+                       std::uint32_t const tree_begin, std::uint32_t const tree_end,
+                       std::size_t const predict_offset,
+                       std::vector<RegTree::FVec> const &thread_temp, std::size_t const offset,
+                       std::size_t const block_size, linalg::MatrixView<float> out_predt) {
+  std::array<float, kBlockOfRowsSize> leaf_values;
+  std::array<bst_node_t, kBlockOfRowsSize> leaf_indices;
+  common::Span<RegTree::FVec const> feats{thread_temp.data() + offset, block_size};
+  common::Span<float> leaves{leaf_values.data(), block_size};
+  common::Span<bst_node_t> lidx{leaf_indices.data(), block_size};
+  for (std::uint32_t tree_id = tree_begin; tree_id < tree_end; ++tree_id) {
+    auto const gid = model.tree_info[tree_id];
+    // Already accounted for by an earlier tree with the same splits.
+    auto prev = forest.PrevShared(tree_id);
+    if (prev != CompiledForest::kNoTree && static_cast<std::uint32_t>(prev) >= tree_begin) {
+      continue;
+    }
+    // The whole block goes down the same tree together.
+    forest.PredValue(tree_id, tree_end, feats, lidx, leaves);
+    for (std::size_t i = 0; i < block_size; ++i) {
+      out_predt(predict_offset + i, gid) += leaves[i];
+    }
+  }
+}
+
+/**
+ * @param tree_weights Optional weight of each tree indexed by the tree id, trees with 0
+ *                     weight are skipped.
+ */
+template <std::size_t kBlockOfRowsSize>
 void PredictByAllTrees(gbm::GBTreeModel const &model, std::uint32_t const tree_begin,
                        std::uint32_t const tree_end, std::size_t const predict_offset,
                        std::vector<RegTree::FVec> const &thread_temp, std::size_t const offset,
-                       std::size_t const block_size, linalg::MatrixView<float> out_predt) {
+                       std::size_t const block_size, linalg::MatrixView<float> out_predt,
+                       common::Span<float const> tree_weights) {
+  if (model.learner_model_param->IsVectorLeaf()) {
+    CHECK(tree_weights.empty());
+    multi::PredictByAllTrees<kBlockOfRowsSize>(
+        model, tree_begin, tree_end, predict_offset,
+        common::Span<RegTree::FVec const>{thread_temp.data() + offset, block_size}, out_predt);
+    return;
+  }
   for (std::uint32_t tree_id = tree_begin; tree_id < tree_end; ++tree_id) {
+    float const w = tree_weights.empty() ? 1.0f : tree_weights[tree_id];
+    if (w == 0.0f) {
+      continue;
+    }
     auto const &tree = *model.trees.at(tree_id);
     auto const &cats = tree.GetCategoriesMatrix();
-    bool has_categorical = tree.HasCategoricalSplit();
-
-    if (tree.IsMultiTarget()) {
-      if (has_categorical) {
-        for (std::size_t i = 0; i < block_size; ++i) {
-          auto t_predts = out_predt.Slice(predict_offset + i, linalg::All());
-          multi::PredValueByOneTree<true>(thread_temp[offset + i], *tree.GetMultiTargetTree(), cats,
-                                          t_predts);
-        }
-      } else {
-        for (std::size_t i = 0; i < block_size; ++i) {
-          auto t_predts = out_predt.Slice(predict_offset + i, linalg::All());
-          multi::PredValueByOneTree<false>(thread_temp[offset + i], *tree.GetMultiTargetTree(),
-                                           cats, t_predts);
-        }
+    auto const gid = model.tree_info[tree_id];
+    if (tree.HasCategoricalSplit()) {
+      for (std::size_t i = 0; i < block_size; ++i) {
+        out_predt(predict_offset + i, gid) +=
+            scalar::PredValueByOneTree<true>(thread_temp[offset + i], tree, cats) * w;
       }
     } else {
-      auto const gid = model.tree_info[tree_id];
-      if (has_categorical) {
-        for (std::size_t i = 0; i < block_size; ++i) {
-          out_predt(predict_offset + i, gid) +=
-              scalar::PredValueByOneTree<true>(thread_temp[offset + i], tree, cats);
-        }
-      } else {
-        for (std::size_t i = 0; i < block_size; ++i) {
-          out_predt(predict_offset + i, gid) +=
-              scalar::PredValueByOneTree<false>(thread_temp[offset + i], tree, cats);
-        }
+      for (std::size_t i = 0; i < block_size; ++i) {
+        out_predt(predict_offset + i, gid) +=
+            scalar::PredValueByOneTree<false>(thread_temp[offset + i], tree, cats) * w;
       }
     }
   }
 }
 
+// Features of a row fit in the L1 cache below this width, the bitmask of the present
+// features is not worth maintaining.
+bst_feature_t constexpr kFVecMaskMinFeatures = 8192;
+
 template <typename DataView>
 void FVecFill(std::size_t const block_size, std::size_t const batch_offset,
               bst_feature_t n_features, DataView *p_batch, std::size_t const fvec_offset,
-              std::vector<RegTree::FVec> *p_feats) {
+              std::vector<RegTree::FVec> *p_feats, bool use_mask = false) {
   auto &feats_vec = *p_feats;
   auto &batch = *p_batch;
   for (std::size_t i = 0; i < block_size; ++i) {
     RegTree::FVec &feats = feats_vec[fvec_offset + i];
-    if (feats.Size() == 0) {
-      feats.Init(n_features);
+    // The buffer might be reused from a different model.
+    if (feats.Size() != n_features || feats.HasMask() != use_mask) {
+      feats.Init(n_features, use_mask);
     }
     batch.Fill(batch_offset + i, &feats);
   }
 }
 
-void FVecDrop(std::size_t const block_size, std::size_t const fvec_offset,
-              std::vector<RegTree::FVec> *p_feats) {
+template <typename DataView>
+void FVecDrop(std::size_t const block_size, std::size_t const batch_offset, DataView *p_batch,
+              std::size_t const fvec_offset, std::vector<RegTree::FVec> *p_feats) {
   for (size_t i = 0; i < block_size; ++i) {
     RegTree::FVec &feats = (*p_feats)[fvec_offset + i];
-    feats.Drop();
+    p_batch->Drop(batch_offset + i, &feats);
   }
 }
 
@@ -163,9 +263,61 @@ template <typename BatchView>
 struct DataToFeatVec {
   void Fill(bst_idx_t ridx, RegTree::FVec *p_feats) const {
     auto &feats = *p_feats;
-    auto n_valid = static_cast<BatchView const *>(this)->DoFill(ridx, feats.Data().data());
+    auto n_valid = static_cast<BatchView const *>(this)->DoFill(ridx, &feats);
     feats.HasMissing(n_valid != feats.Size());
   }
+  // Reset the feature vector after prediction. Views with sparse rows reset only the
+  // entries of the row.
+  void Drop(bst_idx_t, RegTree::FVec *p_feats) const { p_feats->Drop(); }
+};
+
+/**
+ * @brief Reset the given entries of a feature vector to missing.
+ */
+template <typename Fn>
+void DropEntries(std::size_t n_entries, Fn &&fidx, RegTree::FVec *p_feats) {
+  for (std::size_t i = 0; i < n_entries; ++i) {
+    p_feats->Reset(fidx(i));
+  }
+  p_feats->HasMissing(true);
+}
+
+/**
+ * @brief Feature vectors reused across predictions, one arena for each caller thread.
+ *
+ * The rows are filled and dropped within a single prediction, hence the buffers are
+ * always clean after a successful prediction. If a prediction fails in between, the
+ * buffers are discarded at the next acquisition.
+ */
+class FVecArena {
+  std::vector<RegTree::FVec> feats_;
+  bool in_use_{false};
+  common::MemoryAccount account_{common::MemTag::kPredictorBuffer};
+
+ public:
+  [[nodiscard]] std::vector<RegTree::FVec> *Acquire(std::size_t n) {
+    if (in_use_) {
+      feats_.clear();
+    }
+    in_use_ = true;
+    if (feats_.size() < n) {
+      feats_.resize(n);
+    }
+    return &feats_;
+  }
+  void Release() {
+    in_use_ = false;
+    auto n_bytes = feats_.capacity() * sizeof(RegTree::FVec);
+    for (auto const &feats : feats_) {
+      n_bytes += feats.Size() * sizeof(float);
+    }
+    account_.Update(n_bytes);
+  }
+
+  [[nodiscard]] static FVecArena *ThreadLocal() {
+    static thread_local FVecArena arena;
+    return &arena;
+  }
 };
 
 struct SparsePageView : public DataToFeatVec<SparsePageView> {
@@ -175,16 +327,21 @@ struct SparsePageView : public DataToFeatVec<SparsePageView> {
   explicit SparsePageView(SparsePage const *p) : base_rowid{p->base_rowid} { view = p->GetView(); }
   [[nodiscard]] std::size_t Size() const { return view.Size(); }
 
-  [[nodiscard]] bst_idx_t DoFill(bst_idx_t ridx, float *out) const {
+  [[nodiscard]] bst_idx_t DoFill(bst_idx_t ridx, RegTree::FVec *out) const {
     auto p_data = view[ridx].data();
 
     for (std::size_t i = 0, n = view[ridx].size(); i < n; ++i) {
       auto const &entry = p_data[i];
-      out[entry.index] = entry.fvalue;
+      out->Set(entry.index, entry.fvalue);
     }
 
     return view[ridx].size();
   }
+
+  void Drop(bst_idx_t ridx, RegTree::FVec *p_feats) const {
+    auto row = view[ridx];
+    DropEntries(row.size(), [&](std::size_t i) { return row[i].index; }, p_feats);
+  }
 };
 
 struct GHistIndexMatrixView : public DataToFeatVec<GHistIndexMatrixView> {
@@ -208,7 +365,7 @@ struct GHistIndexMatrixView : public DataToFeatVec<GHistIndexMatrixView> {
         values_{_page.cut.Values()},
         base_rowid{_page.base_rowid} {}
 
-  [[nodiscard]] bst_idx_t DoFill(bst_idx_t ridx, float* out) const {
+  [[nodiscard]] bst_idx_t DoFill(bst_idx_t ridx, RegTree::FVec *out) const {
     auto gridx = ridx + this->base_rowid;
     auto n_features = page_.Features();
 
@@ -229,7 +386,7 @@ struct GHistIndexMatrixView : public DataToFeatVec<GHistIndexMatrixView> {
             fvalue =
                 common::HistogramCuts::NumericBinValue(this->ptrs_, values_, mins_, fidx, bin_idx);
           }
-          out[fidx] = fvalue;
+          out->Set(fidx, fvalue);
         }
       });
       n_non_missings += n_features;
@@ -237,7 +394,7 @@ struct GHistIndexMatrixView : public DataToFeatVec<GHistIndexMatrixView> {
       for (bst_feature_t fidx = 0; fidx < n_features; ++fidx) {
         float f = page_.GetFvalue(ptrs_, values_, mins_, gridx, fidx, common::IsCat(ft_, fidx));
         if (!common::CheckNAN(f)) {
-          out[fidx] = f;
+          out->Set(fidx, f);
           n_non_missings++;
         }
       }
@@ -257,76 +414,297 @@ class AdapterView : public DataToFeatVec<AdapterView<Adapter>> {
   explicit AdapterView(Adapter const *adapter, float missing)
       : adapter_{adapter}, missing_{missing} {}
 
-  [[nodiscard]] bst_idx_t DoFill(bst_idx_t ridx, float *out) const {
+  [[nodiscard]] bst_idx_t DoFill(bst_idx_t ridx, RegTree::FVec *out) const {
     auto const &batch = adapter_->Value();
     auto row = batch.GetLine(ridx);
     bst_idx_t n_non_missings = 0;
     for (size_t c = 0; c < row.Size(); ++c) {
       auto e = row.GetElement(c);
       if (missing_ != e.value && !common::CheckNAN(e.value)) {
-        out[e.column_idx] = e.value;
+        out->Set(e.column_idx, e.value);
         n_non_missings++;
       }
     }
     return n_non_missings;
   }
 
+  void Drop(bst_idx_t ridx, RegTree::FVec *p_feats) const {
+    auto row = adapter_->Value().GetLine(ridx);
+    if (row.Size() >= p_feats->Size()) {
+      p_feats->Drop();
+      return;
+    }
+    DropEntries(row.Size(), [&](std::size_t i) { return row.GetElement(i).column_idx; }, p_feats);
+  }
+
   [[nodiscard]] size_t Size() const { return adapter_->NumRows(); }
 
   bst_idx_t const static base_rowid = 0;  // NOLINT
 };
 
+/**
+ * @brief Choose the block shape from the size of the feature vector and the nodes.
+ */
+BlockShape ChooseBlockShape(gbm::GBTreeModel const &model, CompiledForest const *forest,
+                            bst_tree_t tree_begin, bst_tree_t tree_end, std::size_t max_rows) {
+  static std::size_t const kCacheSize = common::GetCacheSize(2);
+  auto n_targets = model.learner_model_param->OutputLength();
+  std::vector<std::size_t> tree_bytes(tree_end - tree_begin);
+  for (auto tree_id = tree_begin; tree_id < tree_end; ++tree_id) {
+    auto const &tree = *model.trees[tree_id];
+    std::size_t n_bytes;
+    if (forest) {
+      n_bytes = forest->TreeBytes(tree_id);
+    } else if (tree.IsMultiTarget()) {
+      n_bytes = tree.NumNodes() * (sizeof(RegTree::Node) + n_targets * sizeof(float));
+    } else {
+      n_bytes = tree.NumNodes() * sizeof(RegTree::Node);
+    }
+    tree_bytes[tree_id - tree_begin] = n_bytes;
+  }
+  auto row_bytes = model.learner_model_param->num_feature * sizeof(float);
+  return predictor::ChooseBlockShape(max_rows, row_bytes, tree_begin, tree_bytes, kCacheSize);
+}
+
 template <typename DataView, std::size_t kBlockOfRowsSize>
 void PredictBatchByBlockOfRowsKernel(DataView batch, gbm::GBTreeModel const &model,
-                                     bst_tree_t tree_begin, bst_tree_t tree_end,
+                                     CompiledForest const *forest, bst_tree_t tree_begin,
+                                     bst_tree_t tree_end,
                                      std::vector<RegTree::FVec> *p_thread_temp,
                                      std::int32_t n_threads,
-                                     linalg::TensorView<float, 2> out_predt) {
+                                     linalg::TensorView<float, 2> out_predt,
+                                     common::Span<float const> tree_weights = {},
+                                     NumaForest const *numa_forest = nullptr) {
+  // The compiled forest merges the leaves of trees with the same splits.
+  CHECK(tree_weights.empty() || !forest);
+  CHECK(!numa_forest || numa_forest->Forest() == forest);
   auto &thread_temp = *p_thread_temp;
 
-  // Parallel over local batches
   auto const n_samples = batch.Size();
   auto const n_features = model.learner_model_param->num_feature;
+  auto const shape = ChooseBlockShape(model, forest, tree_begin, tree_end, kBlockOfRowsSize);
+  auto const n_blocks = common::DivRoundUp(n_samples, shape.n_rows);
+  // Rows are predicted one at a time for sparse data. With many features, most lookups are
+  // for missing values, which hit only the bitmask.
+  bool const use_mask = kBlockOfRowsSize == 1 && n_features >= kFVecMaskMinFeatures;
+
+  auto predict_block = [&](std::size_t block_id, bst_tree_t t_begin, bst_tree_t t_end) {
+    auto const batch_offset = block_id * shape.n_rows;
+    auto const block_size =
+        std::min(static_cast<std::size_t>(n_samples - batch_offset), shape.n_rows);
+    auto const fvec_offset = common::ThreadIdx() * kBlockOfRowsSize;
+    // The copy of the forest on the NUMA node of this thread.
+    auto const *local = numa_forest ? numa_forest->Local() : forest;
+
+    // Dispatched inside the parallel loop, the outlined region is not inlined.
+    common::DispatchCpuIsa([&] {
+      FVecFill(block_size, batch_offset, n_features, &batch, fvec_offset, p_thread_temp,
+               use_mask);
+      // process block of rows through all trees to keep cache locality
+      if (local) {
+        PredictByAllTrees<kBlockOfRowsSize>(*local, model, t_begin, t_end,
+                                            batch_offset + batch.base_rowid, thread_temp,
+                                            fvec_offset, block_size, out_predt);
+      } else {
+        PredictByAllTrees<kBlockOfRowsSize>(model, t_begin, t_end,
+                                            batch_offset + batch.base_rowid, thread_temp,
+                                            fvec_offset, block_size, out_predt, tree_weights);
+      }
+      FVecDrop(block_size, batch_offset, &batch, fvec_offset, p_thread_temp);
+    });
+  };
+
+  if (shape.NumTiles() == 1) {
+    // Parallel over local batches
+    common::ParallelFor(n_blocks, n_threads,
+                        [&](auto block_id) { predict_block(block_id, tree_begin, tree_end); });
+    return;
+  }
+  // The model doesn't fit in the cache. Each thread streams its own row blocks through one
+  // tile of trees before moving to the next tile. The feature vectors are filled again for
+  // each tile, which is cheap compared to walking the trees.
+  auto const n_chunks = std::min(n_blocks, static_cast<std::size_t>(n_threads));
+  common::ParallelFor(n_chunks, n_threads, [&](auto chunk) {
+    auto block_begin = chunk * n_blocks / n_chunks;
+    auto block_end = (chunk + 1) * n_blocks / n_chunks;
+    for (std::size_t k = 0; k < shape.NumTiles(); ++k) {
+      for (auto block_id = block_begin; block_id < block_end; ++block_id) {
+        predict_block(block_id, shape.tree_ptr[k], shape.tree_ptr[k + 1]);
+      }
+    }
+  });
+}
+
+/**
+ * @brief Predict a batch with multiple models, each block of rows is filled once and then
+ *        walked through the trees of all the models.
+ *
+ * @param forests The compiled forest of each model, can be nullptr.
+ */
+template <typename DataView, std::size_t kBlockOfRowsSize>
+void PredictMultiByBlockOfRowsKernel(DataView batch, common::Span<DenseModelSlice const> models,
+                                     std::vector<CompiledForest const *> const &forests,
+                                     std::vector<RegTree::FVec> *p_thread_temp,
+                                     std::int32_t n_threads) {
+  auto &thread_temp = *p_thread_temp;
+  auto const n_samples = batch.Size();
+  auto const n_features = models.front().model->learner_model_param->num_feature;
   auto const n_blocks = common::DivRoundUp(n_samples, kBlockOfRowsSize);
 
   common::ParallelFor(n_blocks, n_threads, [&](auto block_id) {
     auto const batch_offset = block_id * kBlockOfRowsSize;
     auto const block_size =
         std::min(static_cast<std::size_t>(n_samples - batch_offset), kBlockOfRowsSize);
-    auto const fvec_offset = omp_get_thread_num() * kBlockOfRowsSize;
+    auto const fvec_offset = common::ThreadIdx() * kBlockOfRowsSize;
 
     FVecFill(block_size, batch_offset, n_features, &batch, fvec_offset, p_thread_temp);
-    // process block of rows through all trees to keep cache locality
-    PredictByAllTrees(model, tree_begin, tree_end, batch_offset + batch.base_rowid, thread_temp,
-                      fvec_offset, block_size, out_predt);
-    FVecDrop(block_size, fvec_offset, p_thread_temp);
+    for (std::size_t i = 0; i < models.size(); ++i) {
+      auto const &slice = models[i];
+      if (forests[i]) {
+        PredictByAllTrees<kBlockOfRowsSize>(*forests[i], *slice.model, slice.tree_begin,
+                                            slice.tree_end, batch_offset + batch.base_rowid,
+                                            thread_temp, fvec_offset, block_size,
+                                            slice.out_predt);
+      } else {
+        PredictByAllTrees<kBlockOfRowsSize>(*slice.model, slice.tree_begin, slice.tree_end,
+                                            batch_offset + batch.base_rowid, thread_temp,
+                                            fvec_offset, block_size, slice.out_predt, {});
+      }
+    }
+    FVecDrop(block_size, batch_offset, &batch, fvec_offset, p_thread_temp);
   });
 }
 
-float FillNodeMeanValues(RegTree const *tree, bst_node_t nidx, std::vector<float> *mean_values) {
-  bst_float result;
-  auto &node = (*tree)[nidx];
-  auto &node_mean_values = *mean_values;
-  if (node.IsLeaf()) {
-    result = node.LeafValue();
-  } else {
-    result = FillNodeMeanValues(tree, node.LeftChild(), mean_values) *
-             tree->Stat(node.LeftChild()).sum_hess;
-    result += FillNodeMeanValues(tree, node.RightChild(), mean_values) *
-              tree->Stat(node.RightChild()).sum_hess;
-    result /= tree->Stat(nidx).sum_hess;
-  }
-  node_mean_values[nidx] = result;
-  return result;
+/**
+ * @brief Find the leaf of each tree for a batch, and accumulate the leaf values into the
+ *        margin along the way.
+ *
+ * @param out_leaf   Leaf index with shape (n_samples, tree_end).
+ * @param out_margin Margin with shape (n_samples, n_groups), initialized by the caller.
+ */
+template <typename DataView, std::size_t kBlockOfRowsSize>
+void PredictLeafMarginKernel(DataView batch, gbm::GBTreeModel const &model, bst_tree_t tree_end,
+                             std::vector<RegTree::FVec> *p_thread_temp, std::int32_t n_threads,
+                             linalg::MatrixView<float> out_leaf,
+                             linalg::MatrixView<float> out_margin) {
+  auto &thread_temp = *p_thread_temp;
+  auto const n_samples = batch.Size();
+  auto const n_features = model.learner_model_param->num_feature;
+  auto const n_blocks = common::DivRoundUp(n_samples, kBlockOfRowsSize);
+
+  common::ParallelFor(n_blocks, n_threads, [&](auto block_id) {
+    auto const batch_offset = block_id * kBlockOfRowsSize;
+    auto const block_size =
+        std::min(static_cast<std::size_t>(n_samples - batch_offset), kBlockOfRowsSize);
+    auto const fvec_offset = common::ThreadIdx() * kBlockOfRowsSize;
+
+    FVecFill(block_size, batch_offset, n_features, &batch, fvec_offset, p_thread_temp);
+    for (bst_tree_t tree_id = 0; tree_id < tree_end; ++tree_id) {
+      auto const &tree = *model.trees[tree_id];
+      auto const &cats = tree.GetCategoriesMatrix();
+      for (std::size_t i = 0; i < block_size; ++i) {
+        auto const &feats = thread_temp[fvec_offset + i];
+        auto ridx = batch.base_rowid + batch_offset + i;
+        if (tree.IsMultiTarget()) {
+          auto const *mt_tree = tree.GetMultiTargetTree();
+          auto nidx = multi::GetLeafIndex<true, true>(*mt_tree, feats, cats);
+          auto n_targets = out_margin.Shape(1);
+          auto const *w = mt_tree->Weights().data() + nidx * n_targets;
+          for (std::size_t k = 0; k < n_targets; ++k) {
+            out_margin(ridx, k) += w[k];
+          }
+          out_leaf(ridx, tree_id) = static_cast<float>(nidx);
+        } else {
+          auto nidx = feats.HasMissing() ? scalar::GetLeafIndex<true, true>(tree, feats, cats)
+                                         : scalar::GetLeafIndex<false, true>(tree, feats, cats);
+          out_margin(ridx, model.tree_info[tree_id]) += tree[nidx].LeafValue();
+          out_leaf(ridx, tree_id) = static_cast<float>(nidx);
+        }
+      }
+    }
+    FVecDrop(block_size, batch_offset, &batch, fvec_offset, p_thread_temp);
+  });
 }
 
-void FillNodeMeanValues(RegTree const* tree, std::vector<float>* mean_values) {
-  auto n_nodes = tree->NumNodes();
-  if (static_cast<decltype(n_nodes)>(mean_values->size()) == n_nodes) {
-    return;
+float PredValueByOneTree(gbm::GBTreeModel const &model, CompiledForest const *forest,
+                         bst_tree_t tree_id, RegTree::FVec const &feat) {
+  if (forest) {
+    return feat.HasMissing() ? forest->PredValue<true>(tree_id, feat)
+                             : forest->PredValue<false>(tree_id, feat);
   }
-  mean_values->resize(n_nodes);
-  FillNodeMeanValues(tree, 0, mean_values);
+  auto const &tree = *model.trees[tree_id];
+  auto const &cats = tree.GetCategoriesMatrix();
+  return tree.HasCategoricalSplit() ? scalar::PredValueByOneTree<true>(feat, tree, cats)
+                                    : scalar::PredValueByOneTree<false>(feat, tree, cats);
+}
+
+/**
+ * @brief Predict a batch in stages, rows with a partial margin less than the threshold of
+ *        a checkpoint are not evaluated by the remaining trees.
+ */
+template <typename DataView, std::size_t kBlockOfRowsSize>
+void PredictCascadeKernel(DataView batch, gbm::GBTreeModel const &model,
+                          CompiledForest const *forest, bst_tree_t tree_begin, bst_tree_t tree_end,
+                          common::Span<bst_tree_t const> tree_checkpoints,
+                          common::Span<float const> thresholds,
+                          std::vector<RegTree::FVec> *p_thread_temp, std::int32_t n_threads,
+                          linalg::VectorView<float> out_preds,
+                          common::Span<std::uint8_t> finished) {
+  auto &thread_temp = *p_thread_temp;
+
+  auto const n_samples = batch.Size();
+  auto const n_features = model.learner_model_param->num_feature;
+  auto const n_blocks = common::DivRoundUp(n_samples, kBlockOfRowsSize);
+  auto const n_stages = tree_checkpoints.size() + 1;
+
+  common::ParallelFor(n_blocks, n_threads, [&](auto block_id) {
+    auto const batch_offset = block_id * kBlockOfRowsSize;
+    auto const block_size =
+        std::min(static_cast<std::size_t>(n_samples - batch_offset), kBlockOfRowsSize);
+    auto const fvec_offset = common::ThreadIdx() * kBlockOfRowsSize;
+    auto const predict_offset = batch_offset + batch.base_rowid;
+
+    FVecFill(block_size, batch_offset, n_features, &batch, fvec_offset, p_thread_temp);
+    common::Span<RegTree::FVec const> feats{thread_temp.data() + fvec_offset, block_size};
+    std::array<float, kBlockOfRowsSize> leaf_values;
+    // Rows in the block that are still being evaluated.
+    std::array<std::uint32_t, kBlockOfRowsSize> active;
+    std::iota(active.begin(), active.begin() + block_size, 0);
+    std::size_t n_active = block_size;
+
+    auto stage_begin = tree_begin;
+    for (std::size_t s = 0; s < n_stages && n_active != 0; ++s) {
+      auto stage_end = s < tree_checkpoints.size() ? tree_checkpoints[s] : tree_end;
+      for (auto tree_id = stage_begin; tree_id < stage_end; ++tree_id) {
+        if (forest && n_active == block_size) {
+          // No row has exited yet, the whole block goes down the same tree together.
+          common::Span<float> leaves{leaf_values.data(), block_size};
+          forest->PredValue(tree_id, feats, leaves);
+          for (std::size_t i = 0; i < block_size; ++i) {
+            out_preds(predict_offset + i) += leaves[i];
+          }
+        } else {
+          for (std::size_t k = 0; k < n_active; ++k) {
+            auto i = active[k];
+            out_preds(predict_offset + i) += PredValueByOneTree(model, forest, tree_id, feats[i]);
+          }
+        }
+      }
+      if (s < tree_checkpoints.size()) {
+        auto it = std::remove_if(active.begin(), active.begin() + n_active, [&](auto i) {
+          return out_preds(predict_offset + i) < thresholds[s];
+        });
+        n_active = std::distance(active.begin(), it);
+      }
+      stage_begin = stage_end;
+    }
+
+    std::fill_n(finished.data() + predict_offset, block_size, 0);
+    for (std::size_t k = 0; k < n_active; ++k) {
+      finished[predict_offset + active[k]] = 1;
+    }
+    FVecDrop(block_size, batch_offset, &batch, fvec_offset, p_thread_temp);
+  });
 }
 
 // init thread buffers
@@ -348,20 +726,23 @@ static void InitThreadTemp(int nthread, std::vector<RegTree::FVec> *out) {
  * First pass:
  * for each tree:
  *   for each row:
- *     for each node:
- *       if the feature is available and passes the filter, mark the corresponding decision bit
- *       if the feature is missing, mark the missing bit
+ *     for each split node:
+ *       if the feature is available, mark the present bit
+ *       if the feature is available and passes the filter, mark the decision bit
  *
- * Once the two bit vectors are populated, run allreduce on both, using bitwise OR for the decision
- * bits, and bitwise AND for the missing bits.
+ * Once the bit vector is populated, run allreduce on it using bitwise OR. Only the worker owning
+ * the feature can set the bits of a node.
  *
  * Second pass:
  * for each tree:
  *   for each row:
- *     find the leaf node using the decision and missing bits, return the leaf value
+ *     find the leaf node using the decision and present bits, return the leaf value
+ *
+ * The trees are processed in groups, the allreduce of one group is overlapped with the first pass
+ * of the next group and the second pass of the previous group.
  *
- * The size of the decision/missing bit vector is:
- *   number of rows in a batch * sum(number of nodes in each tree)
+ * The size of the bit vector is:
+ *   2 * number of rows in a batch * sum(number of split nodes in each tree)
  */
 class ColumnSplitHelper {
  public:
@@ -370,17 +751,41 @@ class ColumnSplitHelper {
       : n_threads_{n_threads}, model_{model}, tree_begin_{tree_begin}, tree_end_{tree_end} {
     auto const n_trees = tree_end_ - tree_begin_;
     tree_sizes_.resize(n_trees);
-    tree_offsets_.resize(n_trees);
+    node_offsets_.resize(n_trees + 1, 0);
     for (decltype(tree_begin) i = 0; i < n_trees; i++) {
       auto const &tree = *model_.trees[tree_begin_ + i];
-      tree_sizes_[i] = tree.GetNodes().size();
+      bst_node_t n_nodes = tree.GetNodes().size();
+      node_offsets_[i + 1] = node_offsets_[i] + n_nodes;
     }
-    // std::exclusive_scan (only available in c++17) equivalent to get tree offsets.
-    tree_offsets_[0] = 0;
-    for (decltype(tree_begin) i = 1; i < n_trees; i++) {
-      tree_offsets_[i] = tree_offsets_[i - 1] + tree_sizes_[i - 1];
+    // Only split nodes need bits, map the node index to the index of the split node.
+    split_index_.resize(node_offsets_.back(), -1);
+    for (decltype(tree_begin) i = 0; i < n_trees; i++) {
+      auto const &tree = *model_.trees[tree_begin_ + i];
+      bst_node_t n_nodes = tree.GetNodes().size();
+      bst_node_t n_splits = 0;
+      for (bst_node_t nid = 0; nid < n_nodes; nid++) {
+        if (!tree[nid].IsDeleted() && !tree[nid].IsLeaf()) {
+          split_index_[node_offsets_[i] + nid] = n_splits++;
+        }
+      }
+      tree_sizes_[i] = n_splits;
+    }
+
+    // Partition the trees into groups with similar number of split nodes.
+    auto n_total = std::accumulate(tree_sizes_.cbegin(), tree_sizes_.cend(), std::size_t{0});
+    auto n_per_group = std::max(common::DivRoundUp(n_total, kMaxGroups), std::size_t{1});
+    groups_.push_back(0);
+    std::size_t n_acc = 0;
+    for (decltype(tree_begin) i = 0; i < n_trees; i++) {
+      n_acc += tree_sizes_[i];
+      if (n_acc >= n_per_group || i + 1 == n_trees) {
+        groups_.push_back(i + 1);
+        n_acc = 0;
+      }
+    }
+    if (groups_.size() > 2) {
+      pool_ = std::make_unique<common::ThreadPool>(StringView{"predict-sync"}, 1, InitNewThread{});
     }
-    bits_per_row_ = tree_offsets_.back() + tree_sizes_.back();
 
     InitThreadTemp(n_threads_ * kBlockOfRowsSize, &feat_vecs_);
   }
@@ -418,35 +823,43 @@ class ColumnSplitHelper {
 
   void InitBitVectors(std::size_t n_rows) {
     n_rows_ = n_rows;
-    auto const size = BitVector::ComputeStorageSize(bits_per_row_ * n_rows_);
-    decision_storage_.resize(size);
+    // Each tree starts at a byte boundary so that the trees can be reduced separately, and
+    // the blocks of rows don't share bytes between threads.
+    auto const n_trees = tree_end_ - tree_begin_;
+    tree_offsets_.resize(n_trees + 1);
+    tree_offsets_[0] = 0;
+    for (std::uint32_t i = 0; i < n_trees; i++) {
+      auto n_bits = 2 * n_rows_ * tree_sizes_[i];
+      tree_offsets_[i + 1] = tree_offsets_[i] + common::DivRoundUp(n_bits, 8) * 8;
+    }
+    decision_storage_.resize(BitVector::ComputeStorageSize(tree_offsets_.back()));
     decision_bits_ = BitVector(common::Span<BitVector::value_type>(decision_storage_));
-    missing_storage_.resize(size);
-    missing_bits_ = BitVector(common::Span<BitVector::value_type>(missing_storage_));
   }
 
-  void ClearBitVectors() {
-    std::fill(decision_storage_.begin(), decision_storage_.end(), 0);
-    std::fill(missing_storage_.begin(), missing_storage_.end(), 0);
-  }
+  void ClearBitVectors() { std::fill(decision_storage_.begin(), decision_storage_.end(), 0); }
 
+  // Index of the decision bit, the present bit is the next one.
   [[nodiscard]] std::size_t BitIndex(std::size_t tree_id, std::size_t row_id,
                                      std::size_t node_id) const {
     size_t tree_index = tree_id - tree_begin_;
-    return tree_offsets_[tree_index] * n_rows_ + row_id * tree_sizes_[tree_index] + node_id;
-  }
-
-  void AllreduceBitVectors(Context const *ctx) {
-    auto rc = collective::Success() << [&] {
-      return collective::Allreduce(
-          ctx, linalg::MakeVec(decision_storage_.data(), decision_storage_.size()),
-          collective::Op::kBitwiseOR);
-    } << [&] {
-      return collective::Allreduce(
-          ctx, linalg::MakeVec(missing_storage_.data(), missing_storage_.size()),
-          collective::Op::kBitwiseAND);
-    };
-    collective::SafeColl(rc);
+    auto split_id = split_index_[node_offsets_[tree_index] + node_id];
+    return tree_offsets_[tree_index] + 2 * (row_id * tree_sizes_[tree_index] + split_id);
+  }
+
+  [[nodiscard]] std::future<collective::Result> StartAllreduce(Context const *ctx,
+                                                               std::size_t group) {
+    auto beg = tree_offsets_[groups_[group]] / 8;
+    auto end = tree_offsets_[groups_[group + 1]] / 8;
+    auto data = linalg::MakeVec(decision_storage_.data() + beg, end - beg);
+    // The global communicator is thread-local, it's passed to the pool explicitly.
+    auto const *comm = collective::GlobalCommGroup().get();
+    auto fn = [=] { return collective::Allreduce(ctx, *comm, data, collective::Op::kBitwiseOR); };
+    if (pool_) {
+      return pool_->Submit(fn);
+    }
+    std::promise<collective::Result> rc;
+    rc.set_value(fn());
+    return rc.get_future();
   }
 
   void MaskOneTree(RegTree::FVec const &feat, std::size_t tree_id, std::size_t row_id) {
@@ -460,13 +873,13 @@ class ColumnSplitHelper {
         continue;
       }
 
-      auto const bit_index = BitIndex(tree_id, row_id, nid);
       unsigned split_index = node.SplitIndex();
       if (feat.IsMissing(split_index)) {
-        missing_bits_.Set(bit_index);
         continue;
       }
 
+      auto const bit_index = BitIndex(tree_id, row_id, nid);
+      decision_bits_.Set(bit_index + 1);
       auto const fvalue = feat.GetFvalue(split_index);
       auto const decision = tree.HasCategoricalSplit()
                                 ? GetDecision<true>(node, nid, fvalue, cats)
@@ -477,8 +890,10 @@ class ColumnSplitHelper {
     }
   }
 
-  void MaskAllTrees(std::size_t batch_offset, std::size_t fvec_offset, std::size_t block_size) {
-    for (auto tree_id = tree_begin_; tree_id < tree_end_; ++tree_id) {
+  void MaskTrees(std::size_t group, std::size_t batch_offset, std::size_t fvec_offset,
+                 std::size_t block_size) {
+    for (auto tree_id = tree_begin_ + groups_[group]; tree_id < tree_begin_ + groups_[group + 1];
+         ++tree_id) {
       for (size_t i = 0; i < block_size; ++i) {
         MaskOneTree(feat_vecs_[fvec_offset + i], tree_id, batch_offset + i);
       }
@@ -486,7 +901,7 @@ class ColumnSplitHelper {
   }
 
   bst_node_t GetNextNode(RegTree::Node const &node, std::size_t bit_index) {
-    if (missing_bits_.Check(bit_index)) {
+    if (!decision_bits_.Check(bit_index + 1)) {
       return node.DefaultChild();
     } else {
       return node.LeftChild() + !decision_bits_.Check(bit_index);
@@ -514,10 +929,11 @@ class ColumnSplitHelper {
   }
 
   template <bool predict_leaf = false>
-  void PredictAllTrees(std::vector<bst_float> *out_preds, std::size_t batch_offset,
-                       std::size_t predict_offset, std::size_t num_group, std::size_t block_size) {
+  void PredictTrees(std::size_t group, std::vector<bst_float> *out_preds, std::size_t batch_offset,
+                    std::size_t predict_offset, std::size_t num_group, std::size_t block_size) {
     auto &preds = *out_preds;
-    for (size_t tree_id = tree_begin_; tree_id < tree_end_; ++tree_id) {
+    for (size_t tree_id = tree_begin_ + groups_[group]; tree_id < tree_begin_ + groups_[group + 1];
+         ++tree_id) {
       auto const gid = model_.tree_info[tree_id];
       for (size_t i = 0; i < block_size; ++i) {
         auto const result = PredictOneTree<predict_leaf>(tree_id, batch_offset + i);
@@ -540,57 +956,85 @@ class ColumnSplitHelper {
     auto const n_blocks = common::DivRoundUp(nsize, block_of_rows_size);
     InitBitVectors(nsize);
 
-    // auto block_id has the same type as `n_blocks`.
-    common::ParallelFor(n_blocks, n_threads_, [&](auto block_id) {
-      auto const batch_offset = block_id * block_of_rows_size;
-      auto const block_size = std::min(static_cast<std::size_t>(nsize - batch_offset),
-                                       static_cast<std::size_t>(block_of_rows_size));
-      auto const fvec_offset = omp_get_thread_num() * block_of_rows_size;
-
-      FVecFill(block_size, batch_offset, num_feature, &batch, fvec_offset, &feat_vecs_);
-      MaskAllTrees(batch_offset, fvec_offset, block_size);
-      FVecDrop(block_size, fvec_offset, &feat_vecs_);
-    });
-
-    AllreduceBitVectors(ctx);
+    auto mask = [&](std::size_t group) {
+      // auto block_id has the same type as `n_blocks`.
+      common::ParallelFor(n_blocks, n_threads_, [&](auto block_id) {
+        auto const batch_offset = block_id * block_of_rows_size;
+        auto const block_size = std::min(static_cast<std::size_t>(nsize - batch_offset),
+                                         static_cast<std::size_t>(block_of_rows_size));
+        auto const fvec_offset = common::ThreadIdx() * block_of_rows_size;
+
+        FVecFill(block_size, batch_offset, num_feature, &batch, fvec_offset, &feat_vecs_);
+        MaskTrees(group, batch_offset, fvec_offset, block_size);
+        FVecDrop(block_size, batch_offset, &batch, fvec_offset, &feat_vecs_);
+      });
+    };
+    auto predict = [&](std::size_t group) {
+      // auto block_id has the same type as `n_blocks`.
+      common::ParallelFor(n_blocks, n_threads_, [&](auto block_id) {
+        auto const batch_offset = block_id * block_of_rows_size;
+        auto const block_size = std::min(static_cast<std::size_t>(nsize - batch_offset),
+                                         static_cast<std::size_t>(block_of_rows_size));
+        PredictTrees<predict_leaf>(group, out_preds, batch_offset,
+                                   batch_offset + batch.base_rowid, num_group, block_size);
+      });
+    };
 
-    // auto block_id has the same type as `n_blocks`.
-    common::ParallelFor(n_blocks, n_threads_, [&](auto block_id) {
-      auto const batch_offset = block_id * block_of_rows_size;
-      auto const block_size = std::min(static_cast<std::size_t>(nsize - batch_offset),
-                                       static_cast<std::size_t>(block_of_rows_size));
-      PredictAllTrees<predict_leaf>(out_preds, batch_offset, batch_offset + batch.base_rowid,
-                                    num_group, block_size);
-    });
+    // Only one allreduce is in flight at any time, the groups use disjoint parts of the bit
+    // vector.
+    auto const n_groups = groups_.size() - 1;
+    std::future<collective::Result> rc;
+    for (std::size_t group = 0; group < n_groups; ++group) {
+      mask(group);
+      if (group != 0) {
+        collective::SafeColl(rc.get());
+      }
+      rc = this->StartAllreduce(ctx, group);
+      if (group != 0) {
+        predict(group - 1);
+      }
+    }
+    if (n_groups != 0) {
+      collective::SafeColl(rc.get());
+      predict(n_groups - 1);
+    }
 
     ClearBitVectors();
   }
 
   static std::size_t constexpr kBlockOfRowsSize = 64;
+  // Maximum number of tree groups for pipelining the allreduce.
+  static std::size_t constexpr kMaxGroups = 4;
 
   std::int32_t const n_threads_;
   gbm::GBTreeModel const &model_;
   uint32_t const tree_begin_;
   uint32_t const tree_end_;
 
+  // Number of split nodes in each tree.
   std::vector<std::size_t> tree_sizes_{};
+  // Offset of each tree in the bit vector, in bits.
   std::vector<std::size_t> tree_offsets_{};
-  std::size_t bits_per_row_{};
+  std::vector<std::size_t> node_offsets_{};
+  std::vector<bst_node_t> split_index_{};
+  // Boundaries of the tree groups, relative to `tree_begin_`.
+  std::vector<std::size_t> groups_{};
+  std::unique_ptr<common::ThreadPool> pool_{nullptr};
   std::vector<RegTree::FVec> feat_vecs_{};
 
   std::size_t n_rows_;
   /**
-   * @brief Stores decision bit for each split node.
+   * @brief Stores the decision bit and the present bit for each split node.
    *
-   * Conceptually it's a 3-dimensional bit matrix:
+   * Conceptually it's a 3-dimensional matrix of bit pairs:
    *   - 1st dimension is the tree index, from `tree_begin_` to `tree_end_`.
    *   - 2nd dimension is the row index, for each row in the batch.
-   *   - 3rd dimension is the node id, for each node in the tree.
+   *   - 3rd dimension is the index of the split node, for each split node in the tree.
    *
    * Since we have to ship the whole thing over the wire to do an allreduce, the matrix is flattened
    * into a 1-dimensional array.
    *
-   * First, it's divided by the tree index:
+   * First, it's divided by the tree index, each tree starts at a byte boundary:
    *
    * [ tree 0 ] [ tree 1 ] ...
    *
@@ -599,33 +1043,73 @@ class ColumnSplitHelper {
    * [             tree 0              ] [           tree 1     ] ...
    * [ row 0 ] [ row 1 ] ... [ row n-1 ] [ row 0 ] ...
    *
-   * Finally, each row is divided by the node id:
+   * Finally, each row is divided by the split node:
    *
    * [                             tree 0                                         ]
    * [              row 0                 ] [        row 1           ] ...
-   * [ node 0 ] [ node 1 ] ... [ node n-1 ] [ node 0 ] ...
+   * [ split 0 ] [ split 1 ] ... [ split n-1 ] [ split 0 ] ...
    *
-   * The first two dimensions are fixed length, while the last dimension is variable length since
-   * each tree may have a different number of nodes. We precompute the tree offsets, which are the
-   * cumulative sums of tree sizes. The index of tree t, row r, node n is:
-   *   index(t, r, n) = tree_offsets[t] * n_rows + r * tree_sizes[t] + n
+   * For each split node, the first bit is the decision and the second bit indicates whether
+   * the feature is present. The index of tree t, row r, split s is:
+   *   index(t, r, s) = tree_offsets[t] + 2 * (r * tree_sizes[t] + s)
    */
   std::vector<BitVector::value_type> decision_storage_{};
   BitVector decision_bits_{};
-  /**
-   * @brief Stores whether the feature is missing for each split node.
-   *
-   * See above for the storage layout.
-   */
-  std::vector<BitVector::value_type> missing_storage_{};
-  BitVector missing_bits_{};
 };
 
 class CPUPredictor : public Predictor {
  protected:
+  /**
+   * @brief Get the compiled forest for the model, nullptr if the model can't be compiled.
+   *
+   * The forest is built once for each model version. Since building it walks through all
+   * the trees in the model, it's skipped when only a small portion of the model is used,
+   * like predicting with the prediction cache during training.
+   */
+  [[nodiscard]] std::shared_ptr<CompiledForest const> GetCompiledForest(
+      gbm::GBTreeModel const &model, bst_tree_t tree_begin, bst_tree_t tree_end) const {
+    auto n_trees = static_cast<bst_tree_t>(model.trees.size());
+    if ((tree_end - tree_begin) * 2 < n_trees) {
+      return nullptr;
+    }
+    // The model doesn't change during prediction, only the first call takes the lock.
+    auto version = model.Version();
+    if (forest_version_.load(std::memory_order_acquire) != version) {
+      std::lock_guard<std::mutex> guard{forest_lock_};
+      if (forest_version_.load(std::memory_order_relaxed) != version) {
+        forest_ = CompiledForest::CanCompile(model)
+                      ? std::make_shared<CompiledForest const>(this->ctx_, model)
+                      : nullptr;
+        forest_version_.store(version, std::memory_order_release);
+      }
+    }
+    return forest_;
+  }
+  /**
+   * @brief Get the copies of the compiled forest on each NUMA node, nullptr if there's a
+   *        single node or the batch is too small to pay for the copies.
+   */
+  [[nodiscard]] std::shared_ptr<NumaForest const> GetNumaForest(
+      std::shared_ptr<CompiledForest const> const &forest, bst_idx_t n_samples) const {
+    static std::int32_t const kNumaNodes = common::NumNumaNodes();
+    if (!forest || kNumaNodes < 2 || n_samples < kNumaMinRows || this->ctx_->Threads() < 2) {
+      return nullptr;
+    }
+    std::lock_guard<std::mutex> guard{forest_lock_};
+    if (!numa_forest_ || numa_forest_->Forest() != forest.get()) {
+      numa_forest_ = std::make_shared<NumaForest const>(this->ctx_, forest);
+    }
+    return numa_forest_;
+  }
+
+  /**
+   * @param tree_weights Optional weight of each tree, see `PredictWeightedBatch`.
+   */
   void PredictDMatrix(DMatrix *p_fmat, std::vector<float> *out_preds, gbm::GBTreeModel const &model,
-                      bst_tree_t tree_begin, bst_tree_t tree_end) const {
+                      bst_tree_t tree_begin, bst_tree_t tree_end,
+                      common::Span<float const> tree_weights = {}) const {
     if (p_fmat->Info().IsColumnSplit()) {
+      CHECK(tree_weights.empty());
       CHECK(!model.learner_model_param->IsVectorLeaf())
           << "Predict DMatrix with column split" << MTNotImplemented();
 
@@ -641,49 +1125,69 @@ class CPUPredictor : public Predictor {
     double density = static_cast<double>(p_fmat->Info().num_nonzero_) / static_cast<double>(total);
     bool blocked = density > kDensityThresh;
 
-    std::vector<RegTree::FVec> feat_vecs;
-    InitThreadTemp(n_threads * (blocked ? kBlockOfRowsSize : 1), &feat_vecs);
+    auto *arena = FVecArena::ThreadLocal();
+    auto &feat_vecs = *arena->Acquire(n_threads * (blocked ? kBlockOfRowsSize : 1));
 
     std::size_t n_samples = p_fmat->Info().num_row_;
     std::size_t n_groups = model.learner_model_param->OutputLength();
     CHECK_EQ(out_preds->size(), n_samples * n_groups);
     auto out_predt = linalg::MakeTensorView(ctx_, *out_preds, n_samples, n_groups);
-
-    if (!p_fmat->PageExists<SparsePage>()) {
+    auto forest =
+        tree_weights.empty() ? this->GetCompiledForest(model, tree_begin, tree_end) : nullptr;
+    auto numa_forest = this->GetNumaForest(forest, n_samples);
+
+    if (auto borrowed = dynamic_cast<data::BorrowedDMatrix const *>(p_fmat)) {
+      // Read the borrowed buffers directly.
+      data::HostAdapterDispatch<false>(borrowed->Proxy(), [&](auto const &adapter) {
+        using Adapter = typename std::remove_reference_t<decltype(adapter)>::element_type;
+        AdapterView<Adapter> view{adapter.get(), borrowed->Missing()};
+        if (blocked) {
+          PredictBatchByBlockOfRowsKernel<AdapterView<Adapter>, kBlockOfRowsSize>(
+              view, model, forest.get(), tree_begin, tree_end, &feat_vecs, n_threads, out_predt,
+              tree_weights, numa_forest.get());
+        } else {
+          PredictBatchByBlockOfRowsKernel<AdapterView<Adapter>, 1>(
+              view, model, forest.get(), tree_begin, tree_end, &feat_vecs, n_threads, out_predt,
+              tree_weights, numa_forest.get());
+        }
+      });
+    } else if (!p_fmat->PageExists<SparsePage>()) {
       auto ft = p_fmat->Info().feature_types.ConstHostVector();
       for (auto const &batch : p_fmat->GetBatches<GHistIndexMatrix>(ctx_, {})) {
         if (blocked) {
           PredictBatchByBlockOfRowsKernel<GHistIndexMatrixView, kBlockOfRowsSize>(
-              GHistIndexMatrixView{batch, ft}, model, tree_begin, tree_end, &feat_vecs, n_threads,
-              out_predt);
+              GHistIndexMatrixView{batch, ft}, model, forest.get(), tree_begin, tree_end,
+              &feat_vecs, n_threads, out_predt, tree_weights, numa_forest.get());
         } else {
           PredictBatchByBlockOfRowsKernel<GHistIndexMatrixView, 1>(
-              GHistIndexMatrixView{batch, ft}, model, tree_begin, tree_end, &feat_vecs, n_threads,
-              out_predt);
+              GHistIndexMatrixView{batch, ft}, model, forest.get(), tree_begin, tree_end,
+              &feat_vecs, n_threads, out_predt, tree_weights, numa_forest.get());
         }
       }
     } else {
       for (auto const &batch : p_fmat->GetBatches<SparsePage>()) {
         if (blocked) {
           PredictBatchByBlockOfRowsKernel<SparsePageView, kBlockOfRowsSize>(
-              SparsePageView{&batch}, model, tree_begin, tree_end, &feat_vecs, n_threads,
-              out_predt);
+              SparsePageView{&batch}, model, forest.get(), tree_begin, tree_end, &feat_vecs,
+              n_threads, out_predt, tree_weights, numa_forest.get());
 
         } else {
-          PredictBatchByBlockOfRowsKernel<SparsePageView, 1>(SparsePageView{&batch}, model,
-                                                             tree_begin, tree_end, &feat_vecs,
-                                                             n_threads, out_predt);
+          PredictBatchByBlockOfRowsKernel<SparsePageView, 1>(
+              SparsePageView{&batch}, model, forest.get(), tree_begin, tree_end, &feat_vecs,
+              n_threads, out_predt, tree_weights, numa_forest.get());
         }
       }
     }
+    arena->Release();
   }
 
   template <typename DataView>
   void PredictContributionKernel(
       DataView batch, const MetaInfo &info, const gbm::GBTreeModel &model,
-      const std::vector<bst_float> *tree_weights, std::vector<std::vector<float>> *mean_values,
-      std::vector<RegTree::FVec> *feat_vecs, std::vector<bst_float> *contribs,
-      bst_tree_t ntree_limit, bool approximate, int condition, unsigned condition_feature) const {
+      const std::vector<bst_float> *tree_weights, gbm::NodeMeanValues const &means,
+      std::vector<RegTree::FVec> *feat_vecs,
+      std::vector<bst_float> *contribs, bst_tree_t ntree_limit, bool approximate, int condition,
+      unsigned condition_feature) const {
     const int num_feature = model.learner_model_param->num_feature;
     const int ngroup = model.learner_model_param->num_output_group;
     CHECK_NE(ngroup, 0);
@@ -692,40 +1196,142 @@ class CPUPredictor : public Predictor {
     auto device = ctx_->Device().IsSycl() ? DeviceOrd::CPU() : ctx_->Device();
     auto base_margin = info.base_margin_.View(device);
     auto base_score = model.learner_model_param->BaseScore(device)(0);
+    auto const n_threads = this->ctx_->Threads();
+    std::size_t const n_rows = batch.Size();
 
-    // parallel over local batch
-    common::ParallelFor(batch.Size(), this->ctx_->Threads(), [&](auto i) {
-      auto row_idx = batch.base_rowid + i;
-      RegTree::FVec &feats = (*feat_vecs)[omp_get_thread_num()];
-      if (feats.Size() == 0) {
-        feats.Init(num_feature);
+    std::vector<TreeShapWorkspace> workspaces(n_threads);
+    // Only used when the trees are weighted (dart).
+    std::vector<std::vector<float>> tree_contribs;
+    if (tree_weights != nullptr) {
+      tree_contribs.resize(n_threads, std::vector<float>(ncolumns));
+    }
+    auto row_contribs = [&](std::size_t i, bst_target_t gid) {
+      return contribs->data() + ((batch.base_rowid + i) * ngroup + gid) * ncolumns;
+    };
+    // Accumulate the contributions of tree j into p_contribs.
+    auto explain = [&](TreeShapTable const *table, bst_tree_t j, RegTree::FVec const &feats,
+                       std::int32_t tidx, float *p_contribs) {
+      auto const &tree = *model.trees[j];
+      auto const *tree_mean_values = &means.values.at(j);
+      float *out = p_contribs;
+      if (tree_weights != nullptr) {
+        out = tree_contribs[tidx].data();
+        std::fill_n(out, ncolumns, 0.0f);
       }
-      std::vector<bst_float> this_tree_contribs(ncolumns);
-      // loop over all classes
-      for (int gid = 0; gid < ngroup; ++gid) {
-        bst_float *p_contribs = &(*contribs)[(row_idx * ngroup + gid) * ncolumns];
-        batch.Fill(i, &feats);
-        // calculate contributions
-        for (bst_tree_t j = 0; j < ntree_limit; ++j) {
-          auto *tree_mean_values = &mean_values->at(j);
-          std::fill(this_tree_contribs.begin(), this_tree_contribs.end(), 0);
-          if (model.tree_info[j] != gid) {
+      if (approximate) {
+        tree.CalculateContributionsApprox(feats, tree_mean_values, out);
+      } else if (table != nullptr) {
+        table->Calculate(tree, feats, &workspaces[tidx], out);
+        out[ncolumns - 1] += (*tree_mean_values)[0];
+      } else {
+        CalculateContributions(tree, feats, tree_mean_values, out, condition, condition_feature,
+                               means.max_depth[j], &workspaces[tidx]);
+      }
+      if (tree_weights != nullptr) {
+        auto w = (*tree_weights)[j];
+        for (size_t ci = 0; ci < ncolumns; ++ci) {
+          p_contribs[ci] += out[ci] * w;
+        }
+      }
+    };
+
+    // With only a few rows, parallelize over trees instead, each thread accumulates into its
+    // own buffer.
+    std::size_t const n_out = n_rows * ngroup * ncolumns;
+    bool const by_tree = n_rows < static_cast<std::size_t>(n_threads) &&
+                         ntree_limit > 1 && n_out * n_threads <= kShapTableBudget;
+    std::vector<RegTree::FVec> row_feats;
+    std::vector<std::vector<float>> thread_contribs;
+    if (by_tree) {
+      row_feats.resize(n_rows);
+      common::ParallelFor(n_rows, n_threads, [&](auto i) {
+        row_feats[i].Init(num_feature);
+        batch.Fill(i, &row_feats[i]);
+      });
+      thread_contribs.resize(n_threads);
+    }
+
+    // Process the trees in chunks such that the total size of path tables in a chunk is
+    // bounded. A table is built only if it's cheaper than running the recursive algorithm
+    // for all rows, the cost of both is roughly proportional to the number of leaves.
+    bool const use_table = condition == 0 && !approximate;
+    std::vector<std::unique_ptr<TreeShapTable>> tables;
+    std::vector<bst_tree_t> todo;
+    bst_tree_t chunk_begin = 0;
+    while (chunk_begin < ntree_limit) {
+      bst_tree_t chunk_end = chunk_begin;
+      todo.clear();
+      if (use_table) {
+        std::size_t n_elements = 0;
+        for (; chunk_end < ntree_limit; ++chunk_end) {
+          auto const &tree = *model.trees[chunk_end];
+          auto size = TreeShapTable::TableSize(tree);
+          if (size > kShapTableBudget ||
+              size > n_rows * static_cast<std::size_t>(tree.GetNumLeaves())) {
             continue;
           }
-          if (!approximate) {
-            CalculateContributions(*model.trees[j], feats, tree_mean_values,
-                                   &this_tree_contribs[0], condition, condition_feature);
-          } else {
-            model.trees[j]->CalculateContributionsApprox(
-                feats, tree_mean_values, &this_tree_contribs[0]);
+          if (n_elements + size > kShapTableBudget) {
+            break;
+          }
+          n_elements += size;
+          todo.push_back(chunk_end);
+        }
+      } else {
+        chunk_end = ntree_limit;
+      }
+      tables.clear();
+      tables.resize(chunk_end - chunk_begin);
+      common::ParallelFor(todo.size(), n_threads, [&](auto k) {
+        auto j = todo[k];
+        tables[j - chunk_begin] = std::make_unique<TreeShapTable>(*model.trees[j]);
+      });
+
+      if (by_tree) {
+        common::ParallelFor(chunk_end - chunk_begin, n_threads, [&](auto k) {
+          auto tidx = common::ThreadIdx();
+          auto &acc = thread_contribs[tidx];
+          if (acc.empty()) {
+            acc.resize(n_out, 0.0f);
+          }
+          bst_tree_t j = chunk_begin + k;
+          auto gid = model.tree_info[j];
+          for (std::size_t i = 0; i < n_rows; ++i) {
+            explain(tables[k].get(), j, row_feats[i], tidx,
+                    acc.data() + (i * ngroup + gid) * ncolumns);
+          }
+        });
+      } else {
+        // parallel over local batch, fill the feature vector once for all trees in the chunk
+        common::ParallelFor(n_rows, n_threads, [&](auto i) {
+          auto tidx = common::ThreadIdx();
+          RegTree::FVec &feats = (*feat_vecs)[tidx];
+          if (feats.Size() == 0) {
+            feats.Init(num_feature);
           }
+          batch.Fill(i, &feats);
+          for (bst_tree_t j = chunk_begin; j < chunk_end; ++j) {
+            explain(tables[j - chunk_begin].get(), j, feats, tidx,
+                    row_contribs(i, model.tree_info[j]));
+          }
+          feats.Drop();
+        });
+      }
+      chunk_begin = chunk_end;
+    }
+
+    common::ParallelFor(n_rows, n_threads, [&](auto i) {
+      auto row_idx = batch.base_rowid + i;
+      for (int gid = 0; gid < ngroup; ++gid) {
+        bst_float *p_contribs = row_contribs(i, gid);
+        for (auto const &acc : thread_contribs) {
+          if (acc.empty()) {
+            continue;
+          }
+          auto const *p_acc = acc.data() + (i * ngroup + gid) * ncolumns;
           for (size_t ci = 0; ci < ncolumns; ++ci) {
-            p_contribs[ci] +=
-                this_tree_contribs[ci] *
-                (tree_weights == nullptr ? 1 : (*tree_weights)[j]);
+            p_contribs[ci] += p_acc[ci];
           }
         }
-        feats.Drop();
         // add base margin to BIAS
         if (base_margin.Size() != 0) {
           CHECK_EQ(base_margin.Shape(1), ngroup);
@@ -742,6 +1348,7 @@ class CPUPredictor : public Predictor {
 
   void PredictBatch(DMatrix *dmat, PredictionCacheEntry *predts, gbm::GBTreeModel const &model,
                     bst_tree_t tree_begin, bst_tree_t tree_end = 0) const override {
+    common::PerfScope perf{"CPUPredictor::PredictBatch"};
     auto *out_preds = &predts->predictions;
     // This is actually already handled in gbm, but large amount of tests rely on the
     // behaviour.
@@ -751,6 +1358,20 @@ class CPUPredictor : public Predictor {
     this->PredictDMatrix(dmat, &out_preds->HostVector(), model, tree_begin, tree_end);
   }
 
+  bool PredictWeightedBatch(DMatrix *dmat, PredictionCacheEntry *predts,
+                            gbm::GBTreeModel const &model, bst_tree_t tree_begin,
+                            bst_tree_t tree_end,
+                            common::Span<float const> tree_weights) const override {
+    if (dmat->Info().IsColumnSplit() || model.learner_model_param->IsVectorLeaf()) {
+      return false;
+    }
+    common::PerfScope perf{"CPUPredictor::PredictWeightedBatch"};
+    CHECK_GE(tree_weights.size(), static_cast<std::size_t>(tree_end));
+    this->PredictDMatrix(dmat, &predts->predictions.HostVector(), model, tree_begin, tree_end,
+                         tree_weights);
+    return true;
+  }
+
   template <typename Adapter, size_t kBlockSize>
   void DispatchedInplacePredict(std::any const &x, std::shared_ptr<DMatrix> p_m,
                                 const gbm::GBTreeModel &model, float missing,
@@ -766,18 +1387,27 @@ class CPUPredictor : public Predictor {
     this->InitOutPredictions(p_m->Info(), &(out_preds->predictions), model);
 
     auto &predictions = out_preds->predictions.HostVector();
-    std::vector<RegTree::FVec> thread_temp;
-    InitThreadTemp(n_threads * kBlockSize, &thread_temp);
+    auto *arena = FVecArena::ThreadLocal();
+    auto *thread_temp = arena->Acquire(n_threads * kBlockSize);
     std::size_t n_groups = model.learner_model_param->OutputLength();
     auto out_predt = linalg::MakeTensorView(ctx_, predictions, m->NumRows(), n_groups);
-    PredictBatchByBlockOfRowsKernel<AdapterView<Adapter>, kBlockSize>(
-        AdapterView<Adapter>(m.get(), missing), model, tree_begin, tree_end, &thread_temp,
-        n_threads, out_predt);
+    auto forest = this->GetCompiledForest(model, tree_begin, tree_end);
+    auto numa_forest = this->GetNumaForest(forest, m->NumRows());
+    // Resolve the data type once instead of for each element.
+    data::DispatchTypedBatch(m->Value(), [&](auto const &batch) {
+      using BatchT = std::remove_cv_t<std::remove_reference_t<decltype(batch)>>;
+      data::BatchRef<BatchT> typed{batch};
+      PredictBatchByBlockOfRowsKernel<AdapterView<data::BatchRef<BatchT>>, kBlockSize>(
+          AdapterView<data::BatchRef<BatchT>>(&typed, missing), model, forest.get(), tree_begin,
+          tree_end, thread_temp, n_threads, out_predt, {}, numa_forest.get());
+    });
+    arena->Release();
   }
 
   bool InplacePredict(std::shared_ptr<DMatrix> p_m, const gbm::GBTreeModel &model, float missing,
                       PredictionCacheEntry *out_preds, bst_tree_t tree_begin,
                       bst_tree_t tree_end) const override {
+    common::PerfScope perf{"CPUPredictor::InplacePredict"};
     auto proxy = dynamic_cast<data::DMatrixProxy *>(p_m.get());
     CHECK(proxy)<< error::InplacePredictProxy();
     CHECK(!p_m->Info().IsColumnSplit())
@@ -804,8 +1434,124 @@ class CPUPredictor : public Predictor {
     return true;
   }
 
+  bool PredictDense(gbm::GBTreeModel const &model, float const *data, bst_idx_t n_rows,
+                    float missing, bst_tree_t tree_begin, bst_tree_t tree_end,
+                    linalg::MatrixView<float> out_predt) const override {
+    auto n_features = model.learner_model_param->num_feature;
+    CHECK_EQ(out_predt.Shape(0), n_rows);
+    CHECK_EQ(out_predt.Shape(1), model.learner_model_param->OutputLength());
+    auto base_score = model.learner_model_param->BaseScore(DeviceOrd::CPU())(0);
+    std::fill_n(out_predt.Values().data(), out_predt.Size(), base_score);
+    if (n_rows == 0) {
+      return true;
+    }
+
+    // No need to wake up the whole thread pool for a handful of rows.
+    auto n_threads = static_cast<std::int32_t>(std::min<bst_idx_t>(
+        common::DivRoundUp(n_rows, kBlockOfRowsSize), this->ctx_->Threads()));
+    data::DenseAdapter adapter{data, n_rows, n_features};
+    auto *arena = FVecArena::ThreadLocal();
+    auto *thread_temp = arena->Acquire(n_threads * kBlockOfRowsSize);
+    auto forest = this->GetCompiledForest(model, tree_begin, tree_end);
+    PredictBatchByBlockOfRowsKernel<AdapterView<data::DenseAdapter>, kBlockOfRowsSize>(
+        AdapterView<data::DenseAdapter>(&adapter, missing), model, forest.get(), tree_begin,
+        tree_end, thread_temp, n_threads, out_predt);
+    arena->Release();
+    return true;
+  }
+
+  bool PredictDenseMulti(common::Span<DenseModelSlice const> models, float const *data,
+                         bst_idx_t n_rows, float missing) const override {
+    if (models.empty()) {
+      return true;
+    }
+    auto n_features = models.front().model->learner_model_param->num_feature;
+    // Keep the compiled forests alive during prediction.
+    std::vector<std::shared_ptr<CompiledForest const>> forests(models.size());
+    std::vector<CompiledForest const *> p_forests(models.size(), nullptr);
+    for (std::size_t i = 0; i < models.size(); ++i) {
+      auto const &slice = models[i];
+      auto const &model = *slice.model;
+      CHECK_EQ(model.learner_model_param->num_feature, n_features)
+          << "All models must have the same number of features.";
+      CHECK_EQ(slice.out_predt.Shape(0), n_rows);
+      CHECK_EQ(slice.out_predt.Shape(1), model.learner_model_param->OutputLength());
+      auto base_score = model.learner_model_param->BaseScore(DeviceOrd::CPU())(0);
+      std::fill_n(slice.out_predt.Values().data(), slice.out_predt.Size(), base_score);
+      // The compiled forest is cached by the predictor of each model.
+      auto predictor = dynamic_cast<CPUPredictor const *>(slice.predictor);
+      if (predictor) {
+        forests[i] = predictor->GetCompiledForest(model, slice.tree_begin, slice.tree_end);
+        p_forests[i] = forests[i].get();
+      }
+    }
+    if (n_rows == 0) {
+      return true;
+    }
+
+    auto n_threads = static_cast<std::int32_t>(std::min<bst_idx_t>(
+        common::DivRoundUp(n_rows, kBlockOfRowsSize), this->ctx_->Threads()));
+    data::DenseAdapter adapter{data, n_rows, n_features};
+    auto *arena = FVecArena::ThreadLocal();
+    auto *thread_temp = arena->Acquire(n_threads * kBlockOfRowsSize);
+    PredictMultiByBlockOfRowsKernel<AdapterView<data::DenseAdapter>, kBlockOfRowsSize>(
+        AdapterView<data::DenseAdapter>(&adapter, missing), models, p_forests, thread_temp,
+        n_threads);
+    arena->Release();
+    return true;
+  }
+
+  bool PredictCascade(DMatrix *p_fmat, gbm::GBTreeModel const &model, float missing,
+                      bst_tree_t tree_begin, bst_tree_t tree_end,
+                      common::Span<bst_tree_t const> tree_checkpoints,
+                      common::Span<float const> thresholds, linalg::VectorView<float> out_preds,
+                      common::Span<std::uint8_t> finished) const override {
+    CHECK(!model.learner_model_param->IsVectorLeaf())
+        << "Cascade prediction" << MTNotImplemented();
+    CHECK_EQ(model.learner_model_param->OutputLength(), 1)
+        << "Cascade prediction only supports models with a single output.";
+    CHECK(!p_fmat->Info().IsColumnSplit())
+        << "Cascade prediction support for column-wise data split is not yet implemented.";
+    CHECK_EQ(tree_checkpoints.size(), thresholds.size());
+    auto n_samples = p_fmat->Info().num_row_;
+    CHECK_EQ(out_preds.Size(), n_samples);
+    CHECK_EQ(finished.size(), n_samples);
+
+    auto const n_threads = this->ctx_->Threads();
+    auto *arena = FVecArena::ThreadLocal();
+    auto *feat_vecs = arena->Acquire(n_threads * kBlockOfRowsSize);
+    auto forest = this->GetCompiledForest(model, tree_begin, tree_end);
+    auto kernel = [&](auto const &view) {
+      using View = std::remove_cv_t<std::remove_reference_t<decltype(view)>>;
+      PredictCascadeKernel<View, kBlockOfRowsSize>(view, model, forest.get(), tree_begin,
+                                                   tree_end, tree_checkpoints, thresholds,
+                                                   feat_vecs, n_threads, out_preds, finished);
+    };
+
+    if (auto proxy = dynamic_cast<data::DMatrixProxy *>(p_fmat)) {
+      CHECK_EQ(data::BatchColumns(proxy), model.learner_model_param->num_feature)
+          << "Number of columns in data must equal to trained model.";
+      data::HostAdapterDispatch<false>(proxy, [&](auto const &adapter) {
+        using Adapter = typename std::remove_reference_t<decltype(adapter)>::element_type;
+        kernel(AdapterView<Adapter>{adapter.get(), missing});
+      });
+    } else if (!p_fmat->PageExists<SparsePage>()) {
+      auto ft = p_fmat->Info().feature_types.ConstHostVector();
+      for (auto const &batch : p_fmat->GetBatches<GHistIndexMatrix>(ctx_, {})) {
+        kernel(GHistIndexMatrixView{batch, ft});
+      }
+    } else {
+      for (auto const &batch : p_fmat->GetBatches<SparsePage>()) {
+        kernel(SparsePageView{&batch});
+      }
+    }
+    arena->Release();
+    return true;
+  }
+
   void PredictLeaf(DMatrix *p_fmat, HostDeviceVector<float> *out_preds,
                    gbm::GBTreeModel const &model, bst_tree_t ntree_limit) const override {
+    common::PerfScope perf{"CPUPredictor::PredictLeaf"};
     auto const n_threads = this->ctx_->Threads();
     // number of valid trees
     ntree_limit = GetTreeLimit(model.trees, ntree_limit);
@@ -830,7 +1576,7 @@ class CPUPredictor : public Predictor {
       // parallel over local batch
       auto page = batch.GetView();
       common::ParallelFor(page.Size(), n_threads, [&](auto i) {
-        const int tid = omp_get_thread_num();
+        const int tid = common::ThreadIdx();
         auto ridx = static_cast<size_t>(batch.base_rowid + i);
         RegTree::FVec &feats = feat_vecs[tid];
         if (feats.Size() == 0) {
@@ -853,10 +1599,46 @@ class CPUPredictor : public Predictor {
     }
   }
 
+  bool PredictLeafMargin(DMatrix *p_fmat, gbm::GBTreeModel const &model, bst_tree_t tree_end,
+                         HostDeviceVector<float> *out_leaf,
+                         HostDeviceVector<float> *out_margin) const override {
+    if (p_fmat->Info().IsColumnSplit()) {
+      return false;
+    }
+    common::PerfScope perf{"CPUPredictor::PredictLeafMargin"};
+    auto const n_threads = this->ctx_->Threads();
+    tree_end = GetTreeLimit(model.trees, tree_end);
+    auto const &info = p_fmat->Info();
+    std::size_t n_samples = info.num_row_;
+    std::size_t n_groups = model.learner_model_param->OutputLength();
+    this->InitOutPredictions(info, out_margin, model);
+    out_leaf->Resize(n_samples * tree_end);
+    auto margin = linalg::MakeTensorView(ctx_, out_margin->HostSpan(), n_samples, n_groups);
+    auto leaf = linalg::MakeTensorView(ctx_, out_leaf->HostSpan(), n_samples, tree_end);
+
+    auto *arena = FVecArena::ThreadLocal();
+    auto *feat_vecs = arena->Acquire(n_threads * kBlockOfRowsSize);
+    if (!p_fmat->PageExists<SparsePage>()) {
+      auto ft = info.feature_types.ConstHostVector();
+      for (auto const &batch : p_fmat->GetBatches<GHistIndexMatrix>(ctx_, {})) {
+        PredictLeafMarginKernel<GHistIndexMatrixView, kBlockOfRowsSize>(
+            GHistIndexMatrixView{batch, ft}, model, tree_end, feat_vecs, n_threads, leaf, margin);
+      }
+    } else {
+      for (auto const &batch : p_fmat->GetBatches<SparsePage>()) {
+        PredictLeafMarginKernel<SparsePageView, kBlockOfRowsSize>(
+            SparsePageView{&batch}, model, tree_end, feat_vecs, n_threads, leaf, margin);
+      }
+    }
+    arena->Release();
+    return true;
+  }
+
   void PredictContribution(DMatrix *p_fmat, HostDeviceVector<float> *out_contribs,
                            const gbm::GBTreeModel &model, bst_tree_t ntree_limit,
                            std::vector<bst_float> const *tree_weights, bool approximate,
                            int condition, unsigned condition_feature) const override {
+    common::PerfScope perf{"CPUPredictor::PredictContribution"};
     CHECK(!model.learner_model_param->IsVectorLeaf())
         << "Predict contribution" << MTNotImplemented();
     CHECK(!p_fmat->Info().IsColumnSplit())
@@ -874,85 +1656,172 @@ class CPUPredictor : public Predictor {
     // make sure contributions is zeroed, we could be reusing a previously
     // allocated one
     std::fill(contribs.begin(), contribs.end(), 0);
-    // initialize tree node mean values
-    std::vector<std::vector<float>> mean_values(ntree_limit);
-    common::ParallelFor(ntree_limit, n_threads, [&](bst_omp_uint i) {
-      FillNodeMeanValues(model.trees[i].get(), &(mean_values[i]));
-    });
+    // Cached in the model across calls.
+    auto means = model.MeanValues();
     // start collecting the contributions
     if (!p_fmat->PageExists<SparsePage>()) {
       auto ft = p_fmat->Info().feature_types.ConstHostVector();
       for (const auto &batch : p_fmat->GetBatches<GHistIndexMatrix>(ctx_, {})) {
         PredictContributionKernel(GHistIndexMatrixView{batch, ft}, info, model, tree_weights,
-                                  &mean_values, &feat_vecs, &contribs, ntree_limit, approximate,
+                                  *means, &feat_vecs, &contribs, ntree_limit, approximate,
                                   condition, condition_feature);
       }
     } else {
       for (const auto &batch : p_fmat->GetBatches<SparsePage>()) {
-        PredictContributionKernel(
-            SparsePageView{&batch}, info, model, tree_weights, &mean_values, &feat_vecs,
-            &contribs, ntree_limit, approximate, condition, condition_feature);
+        PredictContributionKernel(SparsePageView{&batch}, info, model, tree_weights,
+                                  *means, &feat_vecs, &contribs, ntree_limit, approximate,
+                                  condition, condition_feature);
       }
     }
   }
 
+  /**
+   * @brief Accumulate the off-diagonal interaction values of each row, and subtract them
+   *        from the diagonal.
+   *
+   *   The interaction of a pair of features is the difference of the contributions when
+   *   conditioning on one of them being on and off. For each tree, only the features of the
+   *   tree are conditioned on. Since the interactions are symmetric, a pair is computed by
+   *   conditioning on the smaller feature and written to both sides, and the largest feature
+   *   of a tree doesn't need to be conditioned on.
+   */
+  template <typename DataView>
+  void PredictInteractionKernel(DataView batch, gbm::GBTreeModel const &model,
+                                std::vector<float> const *tree_weights,
+                                gbm::NodeMeanValues const &means,
+                                std::vector<std::vector<bst_feature_t>> const &tree_features,
+                                std::vector<RegTree::FVec> *feat_vecs, bst_tree_t ntree_limit,
+                                std::vector<float> *contribs) const {
+    auto const num_feature = model.learner_model_param->num_feature;
+    auto const ngroup = model.learner_model_param->num_output_group;
+    std::size_t const ncolumns = num_feature + 1;
+    auto const n_threads = this->ctx_->Threads();
+    std::vector<TreeShapWorkspace> workspaces(n_threads);
+    // Conditional contributions, only the entries of the tree features are written to.
+    std::vector<std::vector<float>> contribs_on(n_threads), contribs_off(n_threads);
+
+    common::ParallelFor(batch.Size(), n_threads, [&](auto i) {
+      auto tidx = common::ThreadIdx();
+      RegTree::FVec &feats = (*feat_vecs)[tidx];
+      if (feats.Size() == 0) {
+        feats.Init(num_feature);
+      }
+      auto &on = contribs_on[tidx];
+      auto &off = contribs_off[tidx];
+      if (on.empty()) {
+        on.resize(ncolumns, 0.0f);
+        off.resize(ncolumns, 0.0f);
+      }
+      batch.Fill(i, &feats);
+      for (bst_tree_t j = 0; j < ntree_limit; ++j) {
+        auto const &tree = *model.trees[j];
+        auto const &features = tree_features[j];
+        auto const *mean_values = &means.values[j];
+        float w = tree_weights == nullptr ? 1.0f : (*tree_weights)[j];
+        auto *mat = contribs->data() +
+                    ((batch.base_rowid + i) * ngroup + model.tree_info[j]) * ncolumns * ncolumns;
+        for (std::size_t a = 0; a + 1 < features.size(); ++a) {
+          auto f = features[a];
+          CalculateContributions(tree, feats, mean_values, off.data(), -1, f,
+                                 means.max_depth[j], &workspaces[tidx]);
+          CalculateContributions(tree, feats, mean_values, on.data(), 1, f, means.max_depth[j],
+                                 &workspaces[tidx]);
+          for (std::size_t b = a + 1; b < features.size(); ++b) {
+            auto k = features[b];
+            float v = (on[k] - off[k]) / 2.0f * w;
+            mat[f * ncolumns + k] += v;
+            mat[k * ncolumns + f] += v;
+            mat[f * ncolumns + f] -= v;
+            mat[k * ncolumns + k] -= v;
+          }
+          for (auto k : features) {
+            on[k] = 0.0f;
+            off[k] = 0.0f;
+          }
+          on.back() = 0.0f;
+          off.back() = 0.0f;
+        }
+      }
+      feats.Drop();
+    });
+  }
+
   void PredictInteractionContributions(DMatrix *p_fmat, HostDeviceVector<float> *out_contribs,
                                        gbm::GBTreeModel const &model, bst_tree_t ntree_limit,
                                        std::vector<float> const *tree_weights,
                                        bool approximate) const override {
+    common::PerfScope perf{"CPUPredictor::PredictInteractionContributions"};
     CHECK(!model.learner_model_param->IsVectorLeaf())
         << "Predict interaction contribution" << MTNotImplemented();
     CHECK(!p_fmat->Info().IsColumnSplit()) << "Predict interaction contribution support for "
                                               "column-wise data split is not yet implemented.";
-    const MetaInfo& info = p_fmat->Info();
-    const int ngroup = model.learner_model_param->num_output_group;
-    size_t const ncolumns = model.learner_model_param->num_feature;
-    const unsigned row_chunk = ngroup * (ncolumns + 1) * (ncolumns + 1);
-    const unsigned mrow_chunk = (ncolumns + 1) * (ncolumns + 1);
-    const unsigned crow_chunk = ngroup * (ncolumns + 1);
-
-    // allocate space for (number of features^2) times the number of rows and tmp off/on contribs
-    std::vector<bst_float>& contribs = out_contribs->HostVector();
-    contribs.resize(info.num_row_ * ngroup * (ncolumns + 1) * (ncolumns + 1));
-    HostDeviceVector<bst_float> contribs_off_hdv(info.num_row_ * ngroup * (ncolumns + 1));
-    auto &contribs_off = contribs_off_hdv.HostVector();
-    HostDeviceVector<bst_float> contribs_on_hdv(info.num_row_ * ngroup * (ncolumns + 1));
-    auto &contribs_on = contribs_on_hdv.HostVector();
-    HostDeviceVector<bst_float> contribs_diag_hdv(info.num_row_ * ngroup * (ncolumns + 1));
-    auto &contribs_diag = contribs_diag_hdv.HostVector();
-
-    // Compute the difference in effects when conditioning on each of the features on and off
-    // see: Axiomatic characterizations of probabilistic and
-    //      cardinal-probabilistic interaction indices
-    PredictContribution(p_fmat, &contribs_diag_hdv, model, ntree_limit,
-                        tree_weights, approximate, 0, 0);
-    for (size_t i = 0; i < ncolumns + 1; ++i) {
-      PredictContribution(p_fmat, &contribs_off_hdv, model, ntree_limit,
-                          tree_weights, approximate, -1, i);
-      PredictContribution(p_fmat, &contribs_on_hdv, model, ntree_limit,
-                          tree_weights, approximate, 1, i);
-
-      for (size_t j = 0; j < info.num_row_; ++j) {
-        for (int l = 0; l < ngroup; ++l) {
-          const unsigned o_offset = j * row_chunk + l * mrow_chunk + i * (ncolumns + 1);
-          const unsigned c_offset = j * crow_chunk + l * (ncolumns + 1);
-          contribs[o_offset + i] = 0;
-          for (size_t k = 0; k < ncolumns + 1; ++k) {
-            // fill in the diagonal with additive effects, and off-diagonal with the interactions
-            if (k == i) {
-              contribs[o_offset + i] += contribs_diag[c_offset + k];
-            } else {
-              contribs[o_offset + k] = (contribs_on[c_offset + k] - contribs_off[c_offset + k])/2.0;
-              contribs[o_offset + i] -= contribs[o_offset + k];
-            }
+    auto const &info = p_fmat->Info();
+    auto const ngroup = model.learner_model_param->num_output_group;
+    std::size_t const ncolumns = model.learner_model_param->num_feature + 1;
+    std::vector<float> &contribs = out_contribs->HostVector();
+    contribs.resize(info.num_row_ * ngroup * ncolumns * ncolumns);
+    std::fill(contribs.begin(), contribs.end(), 0.0f);
+
+    // The diagonal starts with the additive effects.
+    HostDeviceVector<float> contribs_diag;
+    PredictContribution(p_fmat, &contribs_diag, model, ntree_limit, tree_weights, approximate, 0,
+                        0);
+    // The approximated contributions can't be conditioned, there's no interaction.
+    if (!approximate) {
+      ntree_limit = GetTreeLimit(model.trees, ntree_limit);
+      auto means = model.MeanValues();
+      // Only the features used by a tree can interact in it.
+      std::vector<std::vector<bst_feature_t>> tree_features(ntree_limit);
+      common::ParallelFor(ntree_limit, this->ctx_->Threads(), [&](auto j) {
+        auto const &tree = *model.trees[j];
+        auto &features = tree_features[j];
+        for (bst_node_t nidx = 0; nidx < tree.NumNodes(); ++nidx) {
+          if (!tree[nidx].IsLeaf() && !tree[nidx].IsDeleted()) {
+            features.push_back(tree[nidx].SplitIndex());
           }
         }
+        std::sort(features.begin(), features.end());
+        features.erase(std::unique(features.begin(), features.end()), features.end());
+      });
+      std::vector<RegTree::FVec> feat_vecs;
+      InitThreadTemp(this->ctx_->Threads(), &feat_vecs);
+      if (!p_fmat->PageExists<SparsePage>()) {
+        auto ft = p_fmat->Info().feature_types.ConstHostVector();
+        for (auto const &batch : p_fmat->GetBatches<GHistIndexMatrix>(ctx_, {})) {
+          PredictInteractionKernel(GHistIndexMatrixView{batch, ft}, model, tree_weights, *means,
+                                   tree_features, &feat_vecs, ntree_limit, &contribs);
+        }
+      } else {
+        for (auto const &batch : p_fmat->GetBatches<SparsePage>()) {
+          PredictInteractionKernel(SparsePageView{&batch}, model, tree_weights, *means,
+                                   tree_features, &feat_vecs, ntree_limit, &contribs);
+        }
       }
     }
+
+    auto const &h_diag = contribs_diag.ConstHostVector();
+    common::ParallelFor(info.num_row_ * ngroup, this->ctx_->Threads(), [&](auto r) {
+      auto *mat = contribs.data() + r * ncolumns * ncolumns;
+      auto const *diag = h_diag.data() + r * ncolumns;
+      for (std::size_t k = 0; k < ncolumns; ++k) {
+        mat[k * ncolumns + k] += diag[k];
+      }
+    });
   }
 
  private:
   static size_t constexpr kBlockOfRowsSize = 64;
+  // Maximum number of floats in the temporary buffers used by SHAP, 16MB.
+  static std::size_t constexpr kShapTableBudget = static_cast<std::size_t>(1) << 22;
+
+  mutable std::mutex forest_lock_;
+  mutable std::shared_ptr<CompiledForest const> forest_{nullptr};
+  mutable std::atomic<std::uint64_t> forest_version_{0};
+  // Copies of `forest_` on each NUMA node for large batches.
+  mutable std::shared_ptr<NumaForest const> numa_forest_{nullptr};
+  // Replicating the forest costs a copy for each NUMA node, which is amortized over the
+  // batches of offline prediction.
+  static bst_idx_t constexpr kNumaMinRows = static_cast<bst_idx_t>(1) << 16;
 };
 
 XGBOOST_REGISTER_PREDICTOR(CPUPredictor, "cpu_predictor")
@@ -1,10 +1,13 @@
 /**
- * Copyright by XGBoost Contributors 2017-2022
+ * Copyright by XGBoost Contributors 2017-2025
  */
 #include "cpu_treeshap.h"
 
-#include <algorithm>             // copy
+#include <algorithm>             // copy, find, sort, unique
 #include <cinttypes>             // std::uint32_t
+#include <cstddef>               // std::size_t
+#include <limits>                // std::numeric_limits
+#include <utility>               // std::pair
 
 #include "predict_fn.h"          // GetNextNode
 #include "xgboost/base.h"        // bst_node_t
@@ -12,20 +15,6 @@
 #include "xgboost/tree_model.h"  // RegTree
 
 namespace xgboost {
-// Used by TreeShap
-// data we keep about our decision path
-// note that pweight is included for convenience and is not tied with the other attributes
-// the pweight of the i'th path element is the permutation weight of paths with i-1 ones in them
-struct PathElement {
-  int feature_index;
-  float zero_fraction;
-  float one_fraction;
-  float pweight;
-  PathElement() = default;
-  PathElement(int i, float z, float o, float w)
-      : feature_index(i), zero_fraction(z), one_fraction(o), pweight(w) {}
-};
-
 // extend our decision path with a fraction of one and zero extensions
 void ExtendPath(PathElement* unique_path, std::uint32_t unique_depth, float zero_fraction,
                 float one_fraction, int feature_index) {
@@ -185,19 +174,184 @@ void TreeShap(RegTree const& tree, const RegTree::FVec& feat, float* phi, bst_no
 }
 
 void CalculateContributions(RegTree const& tree, const RegTree::FVec& feat,
-                            std::vector<float>* mean_values, float* out_contribs, int condition,
-                            std::uint32_t condition_feature) {
+                            std::vector<float> const* mean_values, float* out_contribs,
+                            int condition, std::uint32_t condition_feature, bst_node_t max_depth,
+                            TreeShapWorkspace* workspace) {
   // find the expected value of the tree's predictions
   if (condition == 0) {
     float node_value = (*mean_values)[0];
     out_contribs[feat.Size()] += node_value;
   }
 
-  // Preallocate space for the unique path data
-  const int maxd = tree.MaxDepth(0) + 2;
-  std::vector<PathElement> unique_path_data((maxd * (maxd + 1)) / 2);
+  // Reuse the space for the unique path data
+  const int maxd = max_depth + 2;
+  auto& unique_path_data = workspace->unique_path;
+  unique_path_data.resize((maxd * (maxd + 1)) / 2);
 
   TreeShap(tree, feat, out_contribs, 0, 0, unique_path_data.data(), 1, 1, -1, condition,
            condition_feature, 1);
 }
+
+namespace {
+using PathT = std::vector<std::pair<bst_node_t, bst_node_t>>;
+
+// Invoke fn with the index of each leaf and the (node, child) pairs along its path.
+template <typename Fn>
+void ForEachLeafPath(RegTree const& tree, bst_node_t nidx, PathT* path, Fn&& fn) {
+  auto const& node = tree[nidx];
+  if (node.IsLeaf()) {
+    fn(nidx, *path);
+    return;
+  }
+  for (auto child : {node.LeftChild(), node.RightChild()}) {
+    path->emplace_back(nidx, child);
+    ForEachLeafPath(tree, child, path, fn);
+    path->pop_back();
+  }
+}
+
+/**
+ * @brief Fill the permutation weights for all subsets of features that the sample follows.
+ *
+ * The coefficients of the polynomial prod_{j in mask} (z_j + x) are stored in poly, the
+ * s^th coefficient is the sum of zero fraction products for the subsets of size s.
+ */
+void FillTable(float const* zero_fractions, std::uint32_t n_features,
+               std::vector<double> const& weights, std::uint32_t j, std::uint32_t mask,
+               double* poly, float* out) {
+  if (j == n_features) {
+    double value = 0;
+    for (std::uint32_t s = 0; s <= n_features; ++s) {
+      value += weights[s] * poly[s];
+    }
+    out[mask] = static_cast<float>(value);
+    return;
+  }
+  FillTable(zero_fractions, n_features, weights, j + 1, mask, poly, out);
+  double* next = poly + n_features + 1;
+  double z = zero_fractions[j];
+  next[0] = poly[0] * z;
+  for (std::uint32_t s = 1; s <= n_features; ++s) {
+    next[s] = poly[s] * z + poly[s - 1];
+  }
+  FillTable(zero_fractions, n_features, weights, j + 1, mask | (1u << j), next, out);
+}
+}  // anonymous namespace
+
+std::size_t TreeShapTable::TableSize(RegTree const& tree) {
+  std::size_t n_elements = 0;
+  bool supported = true;
+  PathT path;
+  std::vector<bst_feature_t> features;
+  ForEachLeafPath(tree, 0, &path, [&](bst_node_t, PathT const& leaf_path) {
+    features.clear();
+    for (auto const& kv : leaf_path) {
+      features.push_back(tree[kv.first].SplitIndex());
+    }
+    std::sort(features.begin(), features.end());
+    auto n_features = std::unique(features.begin(), features.end()) - features.begin();
+    if (n_features > kMaxFeatures) {
+      supported = false;
+    } else if (n_features != 0) {
+      n_elements += static_cast<std::size_t>(1) << n_features;
+    }
+  });
+  return supported ? n_elements : std::numeric_limits<std::size_t>::max();
+}
+
+TreeShapTable::TreeShapTable(RegTree const& tree) {
+  CHECK(!tree.IsMultiTarget());
+  PathT path;
+  std::vector<double> weights;
+  std::vector<double> poly;
+  ForEachLeafPath(tree, 0, &path, [&](bst_node_t nidx, PathT const& leaf_path) {
+    if (leaf_path.empty()) {
+      // A tree with only the root, there's no contribution other than the bias.
+      return;
+    }
+    Leaf leaf;
+    leaf.value = tree[nidx].LeafValue();
+    leaf.feature_begin = features_.size();
+    leaf.path_begin = path_.size();
+    for (auto const& kv : leaf_path) {
+      auto fidx = tree[kv.first].SplitIndex();
+      auto beg = features_.cbegin() + leaf.feature_begin;
+      auto slot = static_cast<std::uint32_t>(std::find(beg, features_.cend(), fidx) - beg);
+      if (leaf.feature_begin + slot == features_.size()) {
+        features_.push_back(fidx);
+        zero_fractions_.push_back(1.0f);
+      }
+      zero_fractions_[leaf.feature_begin + slot] *=
+          tree.Stat(kv.second).sum_hess / tree.Stat(kv.first).sum_hess;
+      path_.push_back(PathNode{kv.first, kv.second, slot});
+    }
+    leaf.path_end = path_.size();
+    leaf.n_features = static_cast<std::uint32_t>(features_.size() - leaf.feature_begin);
+    CHECK_LE(leaf.n_features, kMaxFeatures);
+    auto d = leaf.n_features;
+    // Shapley weights s!(d-1-s)!/d! for subsets of size s.
+    weights.resize(d + 1);
+    weights[0] = 1.0 / d;
+    for (std::uint32_t s = 0; s + 1 < d; ++s) {
+      weights[s + 1] = weights[s] * (s + 1) / static_cast<double>(d - 1 - s);
+    }
+    weights[d] = 0;
+    poly.assign((d + 1) * (d + 1), 0.0);
+    poly[0] = 1.0;
+
+    leaf.table_begin = tables_.size();
+    tables_.resize(tables_.size() + (static_cast<std::size_t>(1) << d));
+    FillTable(zero_fractions_.data() + leaf.feature_begin, d, weights, 0, 0, poly.data(),
+              tables_.data() + leaf.table_begin);
+    leaves_.push_back(leaf);
+  });
+}
+
+void TreeShapTable::Calculate(RegTree const& tree, RegTree::FVec const& feat,
+                              TreeShapWorkspace* workspace, float* out_contribs) const {
+  // find which branch is "hot" (meaning x would follow it) for all split nodes
+  auto& hot = workspace->hot;
+  hot.resize(tree.NumNodes());
+  auto const& cats = tree.GetCategoriesMatrix();
+  for (bst_node_t nidx = 0; nidx < tree.NumNodes(); ++nidx) {
+    auto const& node = tree[nidx];
+    if (node.IsLeaf() || node.IsDeleted()) {
+      continue;
+    }
+    auto split_index = node.SplitIndex();
+    hot[nidx] = predictor::GetNextNode<true, true>(node, nidx, feat.GetFvalue(split_index),
+                                                   feat.IsMissing(split_index), cats);
+  }
+
+  for (auto const& leaf : leaves_) {
+    // The set of features for which the sample follows the path to this leaf.
+    std::uint32_t ones = (1u << leaf.n_features) - 1;
+    for (auto i = leaf.path_begin; i < leaf.path_end; ++i) {
+      auto const& pn = path_[i];
+      if (hot[pn.nidx] != pn.child) {
+        ones &= ~(1u << pn.slot);
+      }
+    }
+    auto const* zero_fractions = zero_fractions_.data() + leaf.feature_begin;
+    auto const* features = features_.data() + leaf.feature_begin;
+    auto const* table = tables_.data() + leaf.table_begin;
+    float scale = leaf.value;
+    for (std::uint32_t j = 0; j < leaf.n_features; ++j) {
+      if (!(ones & (1u << j))) {
+        scale *= zero_fractions[j];
+      }
+    }
+    if (scale == 0) {
+      continue;
+    }
+    float const off = scale * table[ones];
+    for (std::uint32_t j = 0; j < leaf.n_features; ++j) {
+      if (ones & (1u << j)) {
+        out_contribs[features[j]] += (1.0f - zero_fractions[j]) * scale * table[ones & ~(1u << j)];
+      } else {
+        out_contribs[features[j]] -= off;
+      }
+    }
+  }
+}
 }  // namespace xgboost
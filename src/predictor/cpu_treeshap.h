@@ -1,22 +1,103 @@
 #ifndef XGBOOST_PREDICTOR_CPU_TREESHAP_H_
 #define XGBOOST_PREDICTOR_CPU_TREESHAP_H_
 /**
- * Copyright by XGBoost Contributors 2017-2022
+ * Copyright by XGBoost Contributors 2017-2025
  */
+#include <cstddef>               // for size_t
+#include <cstdint>               // for uint32_t
 #include <vector>                // vector
 
+#include "xgboost/base.h"        // for bst_node_t, bst_feature_t
 #include "xgboost/tree_model.h"  // RegTree
 
 namespace xgboost {
+// Used by TreeShap
+// data we keep about our decision path
+// note that pweight is included for convenience and is not tied with the other attributes
+// the pweight of the i'th path element is the permutation weight of paths with i-1 ones in them
+struct PathElement {
+  int feature_index;
+  float zero_fraction;
+  float one_fraction;
+  float pweight;
+  PathElement() = default;
+  PathElement(int i, float z, float o, float w)
+      : feature_index(i), zero_fraction(z), one_fraction(o), pweight(w) {}
+};
+
+/**
+ * @brief Buffers reused across samples, one for each thread.
+ */
+struct TreeShapWorkspace {
+  std::vector<PathElement> unique_path;
+  // The child visited by the sample for each split node.
+  std::vector<bst_node_t> hot;
+};
+
 /**
  * \brief calculate the feature contributions (https://arxiv.org/abs/1706.06060) for the tree
  * \param feat dense feature vector, if the feature is missing the field is set to NaN
  * \param out_contribs output vector to hold the contributions
  * \param condition fix one feature to either off (-1) on (1) or not fixed (0 default)
  * \param condition_feature the index of the feature to fix
+ * \param max_depth the depth of the tree
+ * \param workspace buffers for the unique path
  */
 void CalculateContributions(RegTree const &tree, const RegTree::FVec &feat,
-                            std::vector<float> *mean_values, bst_float *out_contribs, int condition,
-                            unsigned condition_feature);
+                            std::vector<float> const *mean_values, bst_float *out_contribs,
+                            int condition, unsigned condition_feature, bst_node_t max_depth,
+                            TreeShapWorkspace *workspace);
+
+/**
+ * @brief Precomputed path summaries of a tree for the Fast TreeSHAP v2 algorithm
+ *        (https://arxiv.org/abs/2109.09847).
+ *
+ * For a leaf with d unique features on its path, the contribution of a feature depends only
+ * on which of these d features the sample satisfies. The permutation weights of all the 2^d
+ * combinations are computed once for each leaf, then computing the contributions of a
+ * sample takes O(d) for each leaf instead of the O(d^2) of the recursive algorithm. Only
+ * unconditional contributions are supported.
+ */
+class TreeShapTable {
+  struct Leaf {
+    float value;
+    std::uint32_t n_features;
+    // Unique features and their zero fractions.
+    std::size_t feature_begin;
+    // Split nodes on the path.
+    std::size_t path_begin;
+    std::size_t path_end;
+    std::size_t table_begin;
+  };
+  struct PathNode {
+    bst_node_t nidx;
+    // The child on the path to the leaf.
+    bst_node_t child;
+    // Index of the split feature in the unique features of the leaf.
+    std::uint32_t slot;
+  };
+
+  std::vector<Leaf> leaves_;
+  std::vector<PathNode> path_;
+  std::vector<bst_feature_t> features_;
+  std::vector<float> zero_fractions_;
+  std::vector<float> tables_;
+
+ public:
+  /** @brief Maximum number of unique features on the path of a leaf. */
+  static constexpr std::uint32_t kMaxFeatures = 24;
+
+  explicit TreeShapTable(RegTree const &tree);
+  /**
+   * @brief Number of elements in the table of a tree, the maximum value of size_t if a leaf
+   *        has more than @ref kMaxFeatures unique features on its path.
+   */
+  [[nodiscard]] static std::size_t TableSize(RegTree const &tree);
+  /**
+   * @brief Same as @ref CalculateContributions without condition and the expected value.
+   */
+  void Calculate(RegTree const &tree, RegTree::FVec const &feat, TreeShapWorkspace *workspace,
+                 float *out_contribs) const;
+};
 }  // namespace xgboost
 #endif  // XGBOOST_PREDICTOR_CPU_TREESHAP_H_
@@ -6,17 +6,24 @@
 #include <thrust/device_vector.h>
 #include <thrust/fill.h>
 
-#include <any>  // for any, any_cast
-#include <memory>
+#include <algorithm>  // for copy_n, max, min
+#include <any>        // for any, any_cast
+#include <array>      // for array
+#include <memory>     // for shared_ptr, make_shared
+#include <mutex>      // for mutex, lock_guard
+#include <tuple>      // for ignore
+#include <vector>     // for vector
 
 #include "../collective/allreduce.h"
 #include "../common/bitfield.h"
 #include "../common/categorical.h"
 #include "../common/common.h"
 #include "../common/cuda_context.cuh"  // for CUDAContext
+#include "../common/cuda_pinned_allocator.h"  // for PinnedAllocator
 #include "../common/cuda_rt_utils.h"   // for AllVisibleGPUs, SetDevice
 #include "../common/device_helpers.cuh"
 #include "../common/error_msg.h"  // for InplacePredictProxy
+#include "../common/threading_utils.h"  // for ParallelFor
 #include "../data/batch_utils.h"  // for StaticBatch
 #include "../data/device_adapter.cuh"
 #include "../data/ellpack_page.cuh"
@@ -25,6 +32,7 @@
 #include "predict_fn.h"
 #include "xgboost/data.h"
 #include "xgboost/host_device_vector.h"
+#include "xgboost/multi_target_tree_model.h"  // for MultiTargetTree
 #include "xgboost/predictor.h"
 #include "xgboost/tree_model.h"
 #include "xgboost/tree_updater.h"
@@ -276,6 +284,74 @@ PredictLeafKernel(Data data, common::Span<const RegTree::Node> d_nodes,
   }
 }
 
+/**
+ * @brief Predict with the tree nodes cached in the shared memory.
+ *
+ *   The trees are processed in groups, the nodes of a group are loaded into the shared
+ *   memory by the block before all rows of the block traverse them. The cache is placed
+ *   after the row features used by the loader. All threads of the block must call this
+ *   function as it synchronizes the block.
+ *
+ * @param cache_nodes Capacity of the cache, must not be less than the size of any tree.
+ */
+template <bool has_missing, typename Loader>
+__device__ void PredictCachedTrees(
+    Loader* loader, common::Span<const RegTree::Node> d_nodes,
+    common::Span<float> d_out_predictions, common::Span<size_t const> d_tree_segments,
+    common::Span<int const> d_tree_group, common::Span<FeatureType const> d_tree_split_types,
+    common::Span<uint32_t const> d_cat_tree_segments,
+    common::Span<RegTree::CategoricalSplitMatrix::Segment const> d_cat_node_segments,
+    common::Span<uint32_t const> d_categories, bst_tree_t tree_begin, bst_tree_t tree_end,
+    size_t num_features, size_t num_rows, bool use_shared, int num_group,
+    std::size_t cache_nodes) {
+  extern __shared__ float _smem[];
+  auto row_elements = use_shared ? blockDim.x * num_features : 0;
+  auto s_nodes = reinterpret_cast<RegTree::Node*>(_smem + row_elements);
+  bst_idx_t global_idx = blockDim.x * blockIdx.x + threadIdx.x;
+  bool is_valid = global_idx < num_rows;
+
+  float sum = 0;
+  bst_tree_t group_begin = tree_begin;
+  while (group_begin < tree_end) {
+    auto node_begin = d_tree_segments[group_begin - tree_begin];
+    auto group_end = group_begin + 1;
+    while (group_end < tree_end &&
+           d_tree_segments[group_end - tree_begin + 1] - node_begin <= cache_nodes) {
+      ++group_end;
+    }
+    auto n_nodes = d_tree_segments[group_end - tree_begin] - node_begin;
+    // Wait for the previous group to be finished.
+    __syncthreads();
+    for (std::size_t i = threadIdx.x; i < n_nodes; i += blockDim.x) {
+      s_nodes[i] = d_nodes[node_begin + i];
+    }
+    __syncthreads();
+
+    for (bst_tree_t tree_idx = group_begin; is_valid && tree_idx < group_end; ++tree_idx) {
+      TreeView d_tree{
+          tree_begin,          tree_idx,           d_nodes,
+          d_tree_segments,     d_tree_split_types, d_cat_tree_segments,
+          d_cat_node_segments, d_categories};
+      d_tree.d_tree = {s_nodes + (d_tree_segments[tree_idx - tree_begin] - node_begin),
+                       d_tree.d_tree.size()};
+      float leaf = GetLeafWeight<has_missing>(global_idx, d_tree, loader);
+      if (num_group == 1) {
+        sum += leaf;
+      } else {
+        d_out_predictions[global_idx * num_group + d_tree_group[tree_idx]] += leaf;
+      }
+    }
+    group_begin = group_end;
+  }
+  if (is_valid && num_group == 1) {
+    d_out_predictions[global_idx] += sum;
+  }
+}
+
+/**
+ * @param cache_nodes Number of tree nodes that can be cached in the shared memory, 0 to
+ *                    read the nodes from the global memory.
+ */
 template <typename Loader, typename Data, bool has_missing = true>
 __global__ void
 PredictKernel(Data data, common::Span<const RegTree::Node> d_nodes,
@@ -287,9 +363,16 @@ PredictKernel(Data data, common::Span<const RegTree::Node> d_nodes,
               common::Span<RegTree::CategoricalSplitMatrix::Segment const> d_cat_node_segments,
               common::Span<uint32_t const> d_categories, bst_tree_t tree_begin,
               bst_tree_t tree_end, size_t num_features, size_t num_rows,
-              bool use_shared, int num_group, float missing) {
+              bool use_shared, int num_group, float missing, std::size_t cache_nodes) {
   bst_uint global_idx = blockDim.x * blockIdx.x + threadIdx.x;
   Loader loader(data, use_shared, num_features, num_rows, missing);
+  if (cache_nodes != 0) {
+    PredictCachedTrees<has_missing>(&loader, d_nodes, d_out_predictions, d_tree_segments,
+                                    d_tree_group, d_tree_split_types, d_cat_tree_segments,
+                                    d_cat_node_segments, d_categories, tree_begin, tree_end,
+                                    num_features, num_rows, use_shared, num_group, cache_nodes);
+    return;
+  }
   if (global_idx >= num_rows) return;
 
   if (num_group == 1) {
@@ -317,6 +400,81 @@ PredictKernel(Data data, common::Span<const RegTree::Node> d_nodes,
   }
 }
 
+/**
+ * @brief Split node of a multi-target tree, the right child is always `left + 1`.
+ */
+struct MultiTargetNode {
+  bst_node_t left{MultiTargetTree::InvalidNodeId()};
+  bst_feature_t split_index{0};
+  float split_cond{0.0f};
+  bool default_left{false};
+
+  [[nodiscard]] XGBOOST_DEVICE bool IsLeaf() const {
+    return left == MultiTargetTree::InvalidNodeId();
+  }
+};
+
+template <typename Loader>
+__device__ bst_node_t GetLeafIndex(bst_idx_t ridx, common::Span<MultiTargetNode const> tree,
+                                   Loader* loader) {
+  bst_node_t nidx = 0;
+  MultiTargetNode n = tree[nidx];
+  while (!n.IsLeaf()) {
+    float fvalue = loader->GetElement(ridx, n.split_index);
+    if (common::CheckNAN(fvalue)) {
+      nidx = n.default_left ? n.left : n.left + 1;
+    } else {
+      nidx = n.left + !(fvalue < n.split_cond);
+    }
+    n = tree[nidx];
+  }
+  return nidx;
+}
+
+/**
+ * @brief Predict with multi-target trees.
+ *
+ *   Each thread finds the leaf for its own row, then the warp adds the leaf weights of the
+ *   32 rows one row at a time, with lanes spread over the targets. Both the reads of the
+ *   contiguous leaf weights and the writes to the output are coalesced.
+ */
+template <typename Loader, typename Data>
+__global__ void PredictMultiTargetKernel(
+    Data data, common::Span<MultiTargetNode const> d_nodes, common::Span<float const> d_weights,
+    common::Span<std::size_t const> d_tree_segments, common::Span<float> d_out_predictions,
+    bst_tree_t tree_begin, bst_tree_t tree_end, std::size_t num_features, std::size_t num_rows,
+    bool use_shared, bst_target_t n_targets, float missing) {
+  std::uint32_t constexpr kWarpSize = 32;
+  bst_idx_t ridx = blockDim.x * blockIdx.x + threadIdx.x;
+  // No early return, all lanes of a warp are required for the shuffle.
+  Loader loader(data, use_shared, num_features, num_rows, missing);
+  auto lane = threadIdx.x % kWarpSize;
+  auto warp_begin = ridx - lane;
+
+  for (bst_tree_t tree_idx = tree_begin; tree_idx < tree_end; ++tree_idx) {
+    auto beg = d_tree_segments[tree_idx - tree_begin];
+    auto end = d_tree_segments[tree_idx - tree_begin + 1];
+    auto tree = d_nodes.subspan(beg, end - beg);
+    auto weights = d_weights.subspan(beg * n_targets, (end - beg) * n_targets);
+
+    bst_node_t leaf = MultiTargetTree::InvalidNodeId();
+    if (ridx < num_rows) {
+      leaf = GetLeafIndex(ridx, tree, &loader);
+    }
+    for (std::uint32_t k = 0; k < kWarpSize; ++k) {
+      auto k_leaf = __shfl_sync(0xffffffff, leaf, k);
+      if (k_leaf == MultiTargetTree::InvalidNodeId()) {
+        continue;
+      }
+      auto k_out = d_out_predictions.subspan((warp_begin + k) * n_targets, n_targets);
+      auto k_weight = weights.subspan(k_leaf * n_targets, n_targets);
+      for (bst_target_t t = lane; t < n_targets; t += kWarpSize) {
+        k_out[t] += k_weight[t];
+      }
+    }
+  }
+}
+
 class DeviceModel {
  public:
   // Need to lazily construct the vectors because GPU id is only known at runtime
@@ -332,12 +490,71 @@ class DeviceModel {
   HostDeviceVector<RegTree::CategoricalSplitMatrix::Segment> categories_node_segments;
   HostDeviceVector<uint32_t> categories;
 
+  // Multi-target trees, segmented by `tree_segments`.
+  dh::device_vector<MultiTargetNode> mt_nodes;
+  HostDeviceVector<float> mt_weights;
+
   size_t tree_beg_;  // NOLINT
   size_t tree_end_;  // NOLINT
   int num_group;
+  bool vector_leaf{false};
+  // Number of nodes of the largest tree.
+  std::size_t max_tree_nodes{0};
+
+  [[nodiscard]] common::Span<MultiTargetNode const> MultiTargetNodes() const {
+    return {thrust::raw_pointer_cast(mt_nodes.data()), mt_nodes.size()};
+  }
+
+  void InitMultiTarget(const gbm::GBTreeModel& model, size_t tree_begin, size_t tree_end,
+                       DeviceOrd device) {
+    auto n_targets = model.learner_model_param->OutputLength();
+    tree_segments = HostDeviceVector<size_t>({}, device);
+    auto& h_tree_segments = tree_segments.HostVector();
+    h_tree_segments.reserve((tree_end - tree_begin) + 1);
+    size_t sum = 0;
+    h_tree_segments.push_back(sum);
+    for (auto tree_idx = tree_begin; tree_idx < tree_end; tree_idx++) {
+      sum += model.trees.at(tree_idx)->GetMultiTargetTree()->Size();
+      h_tree_segments.push_back(sum);
+    }
+
+    std::vector<MultiTargetNode> h_nodes(sum);
+    mt_weights = HostDeviceVector<float>(sum * n_targets, 0.0f, device);
+    auto& h_weights = mt_weights.HostVector();
+    for (auto tree_idx = tree_begin; tree_idx < tree_end; tree_idx++) {
+      auto const* tree = model.trees.at(tree_idx)->GetMultiTargetTree();
+      auto beg = h_tree_segments[tree_idx - tree_begin];
+      for (bst_node_t nidx = 0; nidx < static_cast<bst_node_t>(tree->Size()); ++nidx) {
+        auto& node = h_nodes[beg + nidx];
+        if (!tree->IsLeaf(nidx)) {
+          CHECK_EQ(tree->RightChild(nidx), tree->LeftChild(nidx) + 1);
+          node.left = tree->LeftChild(nidx);
+          node.split_index = tree->SplitIndex(nidx);
+          node.split_cond = tree->SplitCond(nidx);
+          node.default_left = tree->DefaultLeft(nidx);
+        }
+      }
+      auto weights = tree->Weights();
+      std::copy(weights.cbegin(), weights.cend(), h_weights.begin() + beg * n_targets);
+    }
+    mt_nodes = h_nodes;
+
+    this->tree_beg_ = tree_begin;
+    this->tree_end_ = tree_end;
+    this->num_group = n_targets;
+    this->vector_leaf = true;
+  }
 
   void Init(const gbm::GBTreeModel& model, size_t tree_begin, size_t tree_end, DeviceOrd device) {
     dh::safe_cuda(cudaSetDevice(device.ordinal));
+    if (model.learner_model_param->IsVectorLeaf()) {
+      for (auto tree_idx = tree_begin; tree_idx < tree_end; ++tree_idx) {
+        CHECK(!model.trees.at(tree_idx)->HasCategoricalSplit())
+            << "Categorical split with vector leaf" << MTNotImplemented();
+      }
+      this->InitMultiTarget(model, tree_begin, tree_end, device);
+      return;
+    }
 
     // Copy decision trees to device
     tree_segments = HostDeviceVector<size_t>({}, device);
@@ -346,7 +563,9 @@ class DeviceModel {
     size_t sum = 0;
     h_tree_segments.push_back(sum);
     for (auto tree_idx = tree_begin; tree_idx < tree_end; tree_idx++) {
-      sum += model.trees.at(tree_idx)->GetNodes().size();
+      auto n_nodes = model.trees.at(tree_idx)->GetNodes().size();
+      max_tree_nodes = std::max(max_tree_nodes, n_nodes);
+      sum += n_nodes;
       h_tree_segments.push_back(sum);
     }
 
@@ -407,6 +626,38 @@ class DeviceModel {
     this->tree_end_ = tree_end;
     this->num_group = model.learner_model_param->OutputLength();
   }
+  /**
+   * @brief Copy the arrays to the device. Afterward, the model can be read by concurrent
+   *        predictions since the accessors no longer modify the vectors.
+   */
+  void SyncDevice() {
+    auto sync = [](auto const&... vecs) {
+      ((std::ignore = vecs.Device().IsCUDA() ? vecs.ConstDeviceSpan().size() : 0), ...);
+    };
+    sync(stats, tree_segments, nodes, tree_group, split_types, categories_tree_segments,
+         categories_node_segments, categories, mt_weights);
+  }
+  /**
+   * @brief Multiply the leaf values of each tree by its weight.
+   *
+   * @param tree_weights Weight of each tree in the model, indexed by the tree id.
+   */
+  void ScaleLeaves(common::Span<float const> tree_weights) {
+    CHECK(!vector_leaf);
+    CHECK_GE(tree_weights.size(), tree_end_);
+    dh::device_vector<float> weights(tree_weights.data() + tree_beg_,
+                                     tree_weights.data() + tree_end_);
+    auto d_weights = dh::ToSpan(weights);
+    auto d_tree_segments = tree_segments.ConstDeviceSpan();
+    auto d_nodes = nodes.DeviceSpan();
+    dh::LaunchN(d_nodes.size(), [=] __device__(std::size_t i) {
+      auto& node = d_nodes[i];
+      if (node.IsLeaf()) {
+        auto w = d_weights[dh::SegmentId(d_tree_segments, i)];
+        node.SetLeaf(node.LeafValue() * w, node.RightChild());
+      }
+    });
+  }
 };
 
 struct ShapSplitCondition {
@@ -612,6 +863,30 @@ size_t SharedMemoryBytes(size_t cols, size_t max_shared_memory_bytes) {
   return shared_memory_bytes;
 }
 
+// Upper bound of the shared memory used for caching the tree nodes, a larger cache reduces
+// the number of resident blocks.
+constexpr std::size_t kTreeCacheBytes = 32 * 1024;
+
+/**
+ * @brief Number of tree nodes cached in the shared memory by the prediction kernel.
+ *
+ * @param row_bytes Shared memory used by the loader for the row features.
+ *
+ * @return 0 if the largest tree doesn't fit into the remaining shared memory.
+ */
+std::size_t TreeCacheNodes(DeviceModel const& model, std::size_t row_bytes,
+                           std::size_t max_shared_memory_bytes) {
+  if (model.vector_leaf || model.max_tree_nodes == 0 || row_bytes >= max_shared_memory_bytes) {
+    return 0;
+  }
+  auto n_bytes = std::min(max_shared_memory_bytes - row_bytes, kTreeCacheBytes);
+  auto n_nodes = std::min(n_bytes / sizeof(RegTree::Node), model.nodes.Size());
+  if (n_nodes < model.max_tree_nodes) {
+    return 0;
+  }
+  return n_nodes;
+}
+
 using BitVector = LBitField64;
 
 __global__ void MaskBitVectorKernel(
@@ -841,6 +1116,110 @@ class ColumnSplitHelper {
 
   Context const* ctx_;
 };
+
+/**
+ * @brief A view of a range of rows in the data for GPUTreeShap.
+ */
+template <typename Loader>
+struct RowRangeLoader {
+  Loader data;
+  bst_idx_t begin;
+  bst_idx_t n_rows;
+
+  [[nodiscard]] XGBOOST_DEV_INLINE float GetElement(size_t ridx, size_t fidx) const {
+    return data.GetElement(ridx + begin, fidx);
+  }
+  [[nodiscard]] XGBOOST_DEVICE bst_idx_t NumCols() const { return data.NumCols(); }
+  [[nodiscard]] XGBOOST_DEVICE bst_idx_t NumRows() const { return n_rows; }
+};
+
+/**
+ * @brief Number of rows for each batch of SHAP interaction values. Returns n_rows if the
+ *        output fits in the device memory.
+ */
+bst_idx_t InteractionBatchRows(DeviceOrd device, bst_idx_t n_rows, std::size_t dim_size) {
+  auto row_bytes = dim_size * sizeof(float);
+  // Leave the other half for the paths and the temporary memory used by GPUTreeShap.
+  auto budget = dh::AvailableMemory(device.ordinal) / 2;
+  if (n_rows * row_bytes <= budget) {
+    return n_rows;
+  }
+  // Two buffers, one for computing, another one for copying.
+  return std::max(static_cast<bst_idx_t>(budget / 2 / row_bytes), static_cast<bst_idx_t>(1));
+}
+
+/**
+ * @brief Compute SHAP interaction values in batches of rows, with output in host memory.
+ *
+ * A batch is computed into one of the two device buffers, then copied into a pinned
+ * staging buffer using a separate stream while the next batch is being computed.
+ */
+class InteractionStream {
+  using PinnedVec = std::vector<float, common::cuda_impl::PinnedAllocator<float>>;
+
+  Context const* ctx_;
+  std::size_t dim_size_;
+  bst_idx_t batch_rows_;
+  dh::CUDAStream copy_stream_;
+  std::array<dh::device_vector<float>, 2> d_buffers_;
+  std::array<PinnedVec, 2> h_buffers_;
+  std::array<dh::CUDAEvent, 2> computed_;
+  std::array<dh::CUDAEvent, 2> copied_;
+  // Destination of the pending copies.
+  std::array<common::Span<float>, 2> pending_;
+  std::size_t slot_{0};
+
+  void Flush(std::size_t k) {
+    if (pending_[k].empty()) {
+      return;
+    }
+    dh::safe_cuda(cudaEventSynchronize(copied_[k]));
+    std::copy_n(h_buffers_[k].data(), pending_[k].size(), pending_[k].data());
+    pending_[k] = {};
+  }
+
+ public:
+  InteractionStream(Context const* ctx, std::size_t dim_size, bst_idx_t batch_rows)
+      : ctx_{ctx}, dim_size_{dim_size}, batch_rows_{batch_rows} {
+    for (auto& buf : h_buffers_) {
+      buf.resize(batch_rows_ * dim_size_);
+    }
+    for (auto& buf : d_buffers_) {
+      buf.resize(batch_rows_ * dim_size_);
+    }
+  }
+
+  template <typename Loader, typename PathIt>
+  void Push(Loader const& X, PathIt paths_begin, PathIt paths_end, bst_target_t n_groups,
+            common::Span<float> out) {
+    CHECK_EQ(out.size(), X.NumRows() * dim_size_);
+    for (bst_idx_t begin = 0; begin < X.NumRows(); begin += batch_rows_) {
+      auto n = std::min(batch_rows_, static_cast<bst_idx_t>(X.NumRows() - begin));
+      auto k = slot_;
+      slot_ = (slot_ + 1) % d_buffers_.size();
+      // Wait for the previous copy from this buffer.
+      this->Flush(k);
+      auto& d_buf = d_buffers_[k];
+      auto n_values = n * dim_size_;
+      thrust::fill_n(ctx_->CUDACtx()->CTP(), d_buf.begin(), n_values, 0.0f);
+      gpu_treeshap::GPUTreeShapInteractions<dh::XGBDeviceAllocator<int>>(
+          RowRangeLoader<Loader>{X, begin, n}, paths_begin, paths_end, n_groups, d_buf.begin(),
+          d_buf.begin() + n_values);
+      computed_[k].Record(ctx_->CUDACtx()->Stream());
+      copy_stream_.Wait(computed_[k]);
+      dh::safe_cuda(cudaMemcpyAsync(h_buffers_[k].data(), d_buf.data().get(),
+                                    n_values * sizeof(float), cudaMemcpyDeviceToHost,
+                                    copy_stream_.Handle()));
+      copied_[k].Record(copy_stream_.View());
+      pending_[k] = out.subspan(begin * dim_size_, n_values);
+    }
+  }
+  void Finish() {
+    for (std::size_t k = 0; k < pending_.size(); ++k) {
+      this->Flush(k);
+    }
+  }
+};
 }  // anonymous namespace
 
 class GPUPredictor : public xgboost::Predictor {
@@ -857,20 +1236,30 @@ class GPUPredictor : public xgboost::Predictor {
     size_t shared_memory_bytes =
         SharedMemoryBytes<BLOCK_THREADS>(num_features, max_shared_memory_bytes);
     bool use_shared = shared_memory_bytes != 0;
+    auto cache_nodes = TreeCacheNodes(model, shared_memory_bytes, max_shared_memory_bytes);
 
     SparsePageView data(batch.data.DeviceSpan(), batch.offset.DeviceSpan(),
                         num_features);
     auto const kernel = [&](auto predict_fn) {
-      dh::LaunchKernel {GRID_SIZE, BLOCK_THREADS, shared_memory_bytes, ctx_->CUDACtx()->Stream()}(
+      dh::LaunchKernel {GRID_SIZE, BLOCK_THREADS,
+                        shared_memory_bytes + cache_nodes * sizeof(RegTree::Node),
+                        ctx_->CUDACtx()->Stream()}(
           predict_fn, data, model.nodes.ConstDeviceSpan(),
           predictions->DeviceSpan().subspan(batch_offset), model.tree_segments.ConstDeviceSpan(),
           model.tree_group.ConstDeviceSpan(), model.split_types.ConstDeviceSpan(),
           model.categories_tree_segments.ConstDeviceSpan(),
           model.categories_node_segments.ConstDeviceSpan(), model.categories.ConstDeviceSpan(),
           model.tree_beg_, model.tree_end_, num_features, num_rows, use_shared, model.num_group,
-          std::numeric_limits<float>::quiet_NaN());
+          std::numeric_limits<float>::quiet_NaN(), cache_nodes);
     };
-    if (is_dense) {
+    if (model.vector_leaf) {
+      dh::LaunchKernel {GRID_SIZE, BLOCK_THREADS, shared_memory_bytes, ctx_->CUDACtx()->Stream()}(
+          PredictMultiTargetKernel<SparsePageLoader, SparsePageView>, data,
+          model.MultiTargetNodes(), model.mt_weights.ConstDeviceSpan(),
+          model.tree_segments.ConstDeviceSpan(), predictions->DeviceSpan().subspan(batch_offset),
+          model.tree_beg_, model.tree_end_, num_features, num_rows, use_shared, model.num_group,
+          std::numeric_limits<float>::quiet_NaN());
+    } else if (is_dense) {
       kernel(PredictKernel<SparsePageLoader, SparsePageView, false>);
     } else {
       kernel(PredictKernel<SparsePageLoader, SparsePageView, true>);
@@ -885,19 +1274,33 @@ class GPUPredictor : public xgboost::Predictor {
     DeviceModel d_model;
 
     bool use_shared = false;
-    dh::LaunchKernel {GRID_SIZE, BLOCK_THREADS, 0, ctx_->CUDACtx()->Stream()}(
+    if (model.vector_leaf) {
+      dh::LaunchKernel {GRID_SIZE, BLOCK_THREADS, 0, ctx_->CUDACtx()->Stream()}(
+          PredictMultiTargetKernel<EllpackLoader, EllpackDeviceAccessor>, batch,
+          model.MultiTargetNodes(), model.mt_weights.ConstDeviceSpan(),
+          model.tree_segments.ConstDeviceSpan(), out_preds->DeviceSpan().subspan(batch_offset),
+          model.tree_beg_, model.tree_end_, batch.NumFeatures(), num_rows, use_shared,
+          model.num_group, std::numeric_limits<float>::quiet_NaN());
+      return;
+    }
+    auto cache_nodes = TreeCacheNodes(model, 0, ConfigureDevice(ctx_->Device()));
+    dh::LaunchKernel {GRID_SIZE, BLOCK_THREADS, cache_nodes * sizeof(RegTree::Node),
+                      ctx_->CUDACtx()->Stream()}(
         PredictKernel<EllpackLoader, EllpackDeviceAccessor>, batch, model.nodes.ConstDeviceSpan(),
         out_preds->DeviceSpan().subspan(batch_offset), model.tree_segments.ConstDeviceSpan(),
         model.tree_group.ConstDeviceSpan(), model.split_types.ConstDeviceSpan(),
         model.categories_tree_segments.ConstDeviceSpan(),
         model.categories_node_segments.ConstDeviceSpan(), model.categories.ConstDeviceSpan(),
         model.tree_beg_, model.tree_end_, batch.NumFeatures(), num_rows, use_shared,
-        model.num_group, std::numeric_limits<float>::quiet_NaN());
+        model.num_group, std::numeric_limits<float>::quiet_NaN(), cache_nodes);
   }
 
+  /**
+   * @param tree_weights Optional weight of each tree, see `PredictWeightedBatch`.
+   */
   void DevicePredictInternal(DMatrix* dmat, HostDeviceVector<float>* out_preds,
-                             const gbm::GBTreeModel& model, size_t tree_begin,
-                             size_t tree_end) const {
+                             const gbm::GBTreeModel& model, size_t tree_begin, size_t tree_end,
+                             common::Span<float const> tree_weights = {}) const {
     if (tree_end - tree_begin == 0) {
       return;
     }
@@ -905,8 +1308,13 @@ class GPUPredictor : public xgboost::Predictor {
     auto const& info = dmat->Info();
     DeviceModel d_model;
     d_model.Init(model, tree_begin, tree_end, ctx_->Device());
+    if (!tree_weights.empty()) {
+      // The leaves of dropped trees become 0, they are still traversed.
+      d_model.ScaleLeaves(tree_weights);
+    }
 
     if (info.IsColumnSplit()) {
+      CHECK(!d_model.vector_leaf) << "Predict DMatrix with column split" << MTNotImplemented();
       column_split_helper_.PredictBatch(dmat, out_preds, model, d_model);
       return;
     }
@@ -951,6 +1359,19 @@ class GPUPredictor : public xgboost::Predictor {
     this->DevicePredictInternal(dmat, out_preds, model, tree_begin, tree_end);
   }
 
+  bool PredictWeightedBatch(DMatrix* dmat, PredictionCacheEntry* predts,
+                            gbm::GBTreeModel const& model, bst_tree_t tree_begin,
+                            bst_tree_t tree_end,
+                            common::Span<float const> tree_weights) const override {
+    if (dmat->Info().IsColumnSplit() || model.learner_model_param->IsVectorLeaf()) {
+      return false;
+    }
+    CHECK(ctx_->Device().IsCUDA()) << "Set `device' to `cuda` for processing GPU data.";
+    this->DevicePredictInternal(dmat, &predts->predictions, model, tree_begin, tree_end,
+                                tree_weights);
+    return true;
+  }
+
   template <typename Adapter, typename Loader>
   void DispatchedInplacePredict(std::any const& x, std::shared_ptr<DMatrix> p_m,
                                 const gbm::GBTreeModel& model, float missing,
@@ -980,18 +1401,31 @@ class GPUPredictor : public xgboost::Predictor {
     auto max_shared_memory_bytes = dh::MaxSharedMemory(m->Device().ordinal);
     size_t shared_memory_bytes =
         SharedMemoryBytes<BLOCK_THREADS>(m->NumColumns(), max_shared_memory_bytes);
-    DeviceModel d_model;
-    d_model.Init(model, tree_begin, tree_end, m->Device());
+    auto p_model = this->GetDeviceModel(model, tree_begin, tree_end, m->Device());
+    auto const& d_model = *p_model;
 
     bool use_shared = shared_memory_bytes != 0;
 
-    dh::LaunchKernel {GRID_SIZE, BLOCK_THREADS, shared_memory_bytes, ctx_->CUDACtx()->Stream()}(
+    if (d_model.vector_leaf) {
+      dh::LaunchKernel {GRID_SIZE, BLOCK_THREADS, shared_memory_bytes, ctx_->CUDACtx()->Stream()}(
+          PredictMultiTargetKernel<Loader, typename Loader::BatchT>, m->Value(),
+          d_model.MultiTargetNodes(), d_model.mt_weights.ConstDeviceSpan(),
+          d_model.tree_segments.ConstDeviceSpan(), out_preds->predictions.DeviceSpan(),
+          tree_begin, tree_end, m->NumColumns(), m->NumRows(), use_shared, d_model.num_group,
+          missing);
+      return;
+    }
+    auto cache_nodes = TreeCacheNodes(d_model, shared_memory_bytes, max_shared_memory_bytes);
+    dh::LaunchKernel {GRID_SIZE, BLOCK_THREADS,
+                      shared_memory_bytes + cache_nodes * sizeof(RegTree::Node),
+                      ctx_->CUDACtx()->Stream()}(
         PredictKernel<Loader, typename Loader::BatchT>, m->Value(), d_model.nodes.ConstDeviceSpan(),
         out_preds->predictions.DeviceSpan(), d_model.tree_segments.ConstDeviceSpan(),
         d_model.tree_group.ConstDeviceSpan(), d_model.split_types.ConstDeviceSpan(),
         d_model.categories_tree_segments.ConstDeviceSpan(),
         d_model.categories_node_segments.ConstDeviceSpan(), d_model.categories.ConstDeviceSpan(),
-        tree_begin, tree_end, m->NumColumns(), m->NumRows(), use_shared, output_groups, missing);
+        tree_begin, tree_end, m->NumColumns(), m->NumRows(), use_shared, output_groups, missing,
+        cache_nodes);
   }
 
   bool InplacePredict(std::shared_ptr<DMatrix> p_m, gbm::GBTreeModel const& model, float missing,
@@ -1045,6 +1479,8 @@ class GPUPredictor : public xgboost::Predictor {
     dh::device_vector<gpu_treeshap::PathElement<ShapSplitCondition>>
         device_paths;
     DeviceModel d_model;
+    CHECK(!model.learner_model_param->IsVectorLeaf())
+        << "Predict contribution" << MTNotImplemented();
     d_model.Init(model, 0, tree_end, ctx_->Device());
     dh::device_vector<uint32_t> categories;
     ExtractPaths(ctx_, &device_paths, &d_model, &categories, ctx_->Device());
@@ -1104,51 +1540,84 @@ class GPUPredictor : public xgboost::Predictor {
         model.learner_model_param->num_feature + 1;  // +1 for bias
     auto dim_size =
         contributions_columns * contributions_columns * model.learner_model_param->num_output_group;
-    out_contribs->Resize(p_fmat->Info().num_row_ * dim_size);
-    out_contribs->Fill(0.0f);
-    auto phis = out_contribs->DeviceSpan();
+    auto n_rows = p_fmat->Info().num_row_;
+    // The output has a size of rows x (features + 1)^2, compute it in batches with the output
+    // in host memory if it doesn't fit in the device memory.
+    auto batch_rows = InteractionBatchRows(ctx_->Device(), n_rows, dim_size);
+    bool streaming = batch_rows < n_rows;
+    std::unique_ptr<InteractionStream> stream;
+    common::Span<float> phis;
+    if (streaming) {
+      LOG(INFO) << "Computing SHAP interaction values in batches of " << batch_rows << " rows.";
+      auto& h_contribs = out_contribs->HostVector();
+      h_contribs.resize(n_rows * dim_size);
+      phis = common::Span<float>{h_contribs.data(), h_contribs.size()};
+      stream = std::make_unique<InteractionStream>(ctx_, dim_size, batch_rows);
+    } else {
+      out_contribs->Resize(n_rows * dim_size);
+      out_contribs->Fill(0.0f);
+      phis = out_contribs->DeviceSpan();
+    }
 
     dh::device_vector<gpu_treeshap::PathElement<ShapSplitCondition>>
         device_paths;
     DeviceModel d_model;
+    CHECK(!model.learner_model_param->IsVectorLeaf())
+        << "Predict interaction" << MTNotImplemented();
     d_model.Init(model, 0, tree_end, ctx_->Device());
     dh::device_vector<uint32_t> categories;
     ExtractPaths(ctx_, &device_paths, &d_model, &categories, ctx_->Device());
+    auto shap = [&](auto const& X, bst_idx_t base_rowid) {
+      if (streaming) {
+        stream->Push(X, device_paths.begin(), device_paths.end(), ngroup,
+                     phis.subspan(base_rowid * dim_size, X.NumRows() * dim_size));
+      } else {
+        auto begin = dh::tbegin(phis) + base_rowid * dim_size;
+        gpu_treeshap::GPUTreeShapInteractions<dh::XGBDeviceAllocator<int>>(
+            X, device_paths.begin(), device_paths.end(), ngroup, begin, dh::tend(phis));
+      }
+    };
     if (p_fmat->PageExists<SparsePage>()) {
       for (auto const& batch : p_fmat->GetBatches<SparsePage>()) {
         batch.data.SetDevice(ctx_->Device());
         batch.offset.SetDevice(ctx_->Device());
         SparsePageView X(batch.data.DeviceSpan(), batch.offset.DeviceSpan(),
                          model.learner_model_param->num_feature);
-        auto begin = dh::tbegin(phis) + batch.base_rowid * dim_size;
-        gpu_treeshap::GPUTreeShapInteractions<dh::XGBDeviceAllocator<int>>(
-            X, device_paths.begin(), device_paths.end(), ngroup, begin, dh::tend(phis));
+        shap(X, batch.base_rowid);
       }
     } else {
       for (auto const& batch : p_fmat->GetBatches<EllpackPage>(ctx_, StaticBatch(true))) {
         auto impl = batch.Impl();
         auto acc = impl->GetDeviceAccessor(ctx_, p_fmat->Info().feature_types.ConstDeviceSpan());
-        auto begin = dh::tbegin(phis) + batch.BaseRowId() * dim_size;
         auto X = EllpackLoader{acc, true, model.learner_model_param->num_feature, batch.Size(),
                                std::numeric_limits<float>::quiet_NaN()};
-        gpu_treeshap::GPUTreeShapInteractions<dh::XGBDeviceAllocator<int>>(
-            X, device_paths.begin(), device_paths.end(), ngroup, begin, dh::tend(phis));
+        shap(X, batch.BaseRowId());
       }
     }
 
     // Add the base margin term to last column
+    size_t n_features = model.learner_model_param->num_feature;
+    auto bias_idx = [=] XGBOOST_DEVICE(std::size_t idx) {
+      // Same as gpu_treeshap::IndexPhiInteractions(row_idx, ngroup, group, n_features,
+      // n_features, n_features).
+      return (idx * contributions_columns + n_features) * contributions_columns + n_features;
+    };
+    if (streaming) {
+      stream->Finish();
+      auto const& h_margin = p_fmat->Info().base_margin_.Data()->ConstHostVector();
+      auto base_score = model.learner_model_param->BaseScore(DeviceOrd::CPU())(0);
+      common::ParallelFor(n_rows * ngroup, ctx_->Threads(), [&](std::size_t idx) {
+        phis[bias_idx(idx)] += h_margin.empty() ? base_score : h_margin[idx];
+      });
+      return;
+    }
     p_fmat->Info().base_margin_.SetDevice(ctx_->Device());
     const auto margin = p_fmat->Info().base_margin_.Data()->ConstDeviceSpan();
 
     auto base_score = model.learner_model_param->BaseScore(ctx_);
-    size_t n_features = model.learner_model_param->num_feature;
-    dh::LaunchN(p_fmat->Info().num_row_ * model.learner_model_param->num_output_group,
-                ctx_->CUDACtx()->Stream(), [=] __device__(size_t idx) {
-                  size_t group = idx % ngroup;
-                  size_t row_idx = idx / ngroup;
-                  phis[gpu_treeshap::IndexPhiInteractions(row_idx, ngroup, group, n_features,
-                                                          n_features, n_features)] +=
-                      margin.empty() ? base_score(0) : margin[idx];
+    dh::LaunchN(n_rows * model.learner_model_param->num_output_group, ctx_->CUDACtx()->Stream(),
+                [=] __device__(size_t idx) {
+                  phis[bias_idx(idx)] += margin.empty() ? base_score(0) : margin[idx];
                 });
   }
 
@@ -1163,6 +1632,8 @@ class GPUPredictor : public xgboost::Predictor {
     predictions->SetDevice(ctx_->Device());
     predictions->Resize(num_rows * tree_end);
     DeviceModel d_model;
+    CHECK(!model.learner_model_param->IsVectorLeaf())
+        << "Predict leaf" << MTNotImplemented();
     d_model.Init(model, 0, tree_end, this->ctx_->Device());
 
     if (info.IsColumnSplit()) {
@@ -1211,6 +1682,36 @@ class GPUPredictor : public xgboost::Predictor {
   }
 
  private:
+  /**
+   * @brief Get the model copied to the device for the inplace prediction.
+   *
+   *   The copy is made once for each model version and tree range, then shared by the
+   *   concurrent callers. Each caller launches the kernels on its own per-thread stream
+   *   with its own output buffer, so the predictions from different threads overlap on the
+   *   device instead of waiting for the model to be copied in every call.
+   */
+  [[nodiscard]] std::shared_ptr<DeviceModel const> GetDeviceModel(gbm::GBTreeModel const& model,
+                                                                  bst_tree_t tree_begin,
+                                                                  bst_tree_t tree_end,
+                                                                  DeviceOrd device) const {
+    std::lock_guard<std::mutex> guard{d_model_lock_};
+    auto version = model.Version();
+    if (!d_model_ || d_model_version_ != version ||
+        d_model_->tree_beg_ != static_cast<std::size_t>(tree_begin) ||
+        d_model_->tree_end_ != static_cast<std::size_t>(tree_end) || d_model_device_ != device) {
+      auto d_model = std::make_shared<DeviceModel>();
+      d_model->Init(model, tree_begin, tree_end, device);
+      d_model->SyncDevice();
+      // Some of the copies are not made on the per-thread stream, wait for all of them
+      // before sharing the model with other threads.
+      dh::safe_cuda(cudaDeviceSynchronize());
+      d_model_ = std::move(d_model);
+      d_model_version_ = version;
+      d_model_device_ = device;
+    }
+    return d_model_;
+  }
+
   /*! \brief Reconfigure the device when GPU is changed. */
   static size_t ConfigureDevice(DeviceOrd device) {
     if (device.IsCUDA()) {
@@ -1220,6 +1721,10 @@ class GPUPredictor : public xgboost::Predictor {
   }
 
   ColumnSplitHelper column_split_helper_;
+  mutable std::mutex d_model_lock_;
+  mutable std::shared_ptr<DeviceModel const> d_model_{nullptr};
+  mutable std::uint64_t d_model_version_{0};
+  mutable DeviceOrd d_model_device_;
 };
 
 XGBOOST_REGISTER_PREDICTOR(GPUPredictor, "gpu_predictor")
@@ -4,7 +4,7 @@
 #ifndef XGBOOST_PREDICTOR_PREDICT_FN_H_
 #define XGBOOST_PREDICTOR_PREDICT_FN_H_
 
-#include <memory>  // for unique_ptr
+#include <memory>  // for shared_ptr
 #include <vector>  // for vector
 
 #include "../common/categorical.h"  // for IsCat, Decision
@@ -56,7 +56,7 @@ XGBOOST_DEVICE bst_node_t GetNextNodeMulti(MultiTargetTree const &tree, bst_node
  * @brief Some old prediction methods accept the ntree_limit parameter and they use 0 to
  *        indicate no limit.
  */
-inline bst_tree_t GetTreeLimit(std::vector<std::unique_ptr<RegTree>> const &trees,
+inline bst_tree_t GetTreeLimit(std::vector<std::shared_ptr<RegTree>> const &trees,
                                bst_tree_t ntree_limit) {
   auto n_trees = static_cast<bst_tree_t>(trees.size());
   if (ntree_limit == 0 || ntree_limit > n_trees) {
@@ -72,4 +72,6 @@ namespace xgboost::predictor {
 DMLC_REGISTRY_LINK_TAG(gpu_predictor);
 #endif  // XGBOOST_USE_CUDA
 DMLC_REGISTRY_LINK_TAG(cpu_predictor);
+DMLC_REGISTRY_LINK_TAG(quick_scorer);
+DMLC_REGISTRY_LINK_TAG(quantized_forest);
 }  // namespace xgboost::predictor
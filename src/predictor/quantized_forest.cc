@@ -0,0 +1,525 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include "quantized_forest.h"
+
+#include <algorithm>  // for sort, unique, upper_bound, lower_bound, none_of, max, copy, fill
+#include <any>        // for any, any_cast
+#include <atomic>     // for atomic
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint8_t, uint16_t, uint32_t, uint64_t
+#include <cstring>    // for memcpy
+#include <limits>     // for numeric_limits
+#include <memory>     // for shared_ptr, unique_ptr, make_shared
+#include <mutex>      // for mutex, lock_guard
+#include <numeric>    // for partial_sum
+#include <typeinfo>   // for typeid
+#include <vector>     // for vector
+
+#include "../common/error_msg.h"        // for InplacePredictProxy
+#include "../common/math.h"             // for CheckNAN
+#include "../common/threading_utils.h"  // for ParallelFor
+#include "../data/adapter.h"            // for ArrayAdapter, DenseAdapter
+#include "../data/gradient_index.h"     // for GHistIndexMatrix
+#include "../data/proxy_dmatrix.h"      // for DMatrixProxy
+#include "../gbm/gbtree_model.h"        // for GBTreeModel
+#include "dmlc/registry.h"              // for DMLC_REGISTRY_FILE_TAG
+#include "xgboost/data.h"               // for DMatrix, SparsePage, BatchParam
+#include "xgboost/learner.h"            // for LearnerModelParam
+#include "xgboost/logging.h"            // for CHECK_EQ, CHECK
+#include "xgboost/predictor.h"          // for Predictor, PredictionCacheEntry
+
+namespace xgboost::predictor {
+
+DMLC_REGISTRY_FILE_TAG(quantized_forest);
+
+namespace {
+/**
+ * @brief Collect the sorted unique split values of each feature.
+ */
+void FindCuts(gbm::GBTreeModel const& model, std::vector<float>* p_cuts,
+              std::vector<std::size_t>* p_ptr) {
+  auto n_features = model.learner_model_param->num_feature;
+  std::vector<std::vector<float>> values(n_features);
+  for (auto const& p_tree : model.trees) {
+    for (auto const& node : p_tree->GetNodes()) {
+      if (!node.IsDeleted() && !node.IsLeaf()) {
+        CHECK_LT(node.SplitIndex(), n_features);
+        values[node.SplitIndex()].push_back(node.SplitCond());
+      }
+    }
+  }
+  auto& ptr = *p_ptr;
+  ptr.resize(n_features + 1, 0);
+  for (bst_feature_t f = 0; f < n_features; ++f) {
+    auto& v = values[f];
+    std::sort(v.begin(), v.end());
+    v.erase(std::unique(v.begin(), v.end()), v.end());
+    ptr[f + 1] = v.size();
+  }
+  std::partial_sum(ptr.cbegin(), ptr.cend(), ptr.begin());
+  p_cuts->resize(ptr.back());
+  for (bst_feature_t f = 0; f < n_features; ++f) {
+    std::copy(values[f].cbegin(), values[f].cend(), p_cuts->begin() + ptr[f]);
+  }
+}
+
+std::size_t MaxCuts(std::vector<std::size_t> const& ptr) {
+  std::size_t n{0};
+  for (std::size_t f = 1; f < ptr.size(); ++f) {
+    n = std::max(n, ptr[f] - ptr[f - 1]);
+  }
+  return n;
+}
+
+// Number of bits for the bin index, the largest bin is used for missing values.
+std::uint32_t NumBinBits(std::size_t max_cuts) {
+  return max_cuts < std::numeric_limits<std::uint8_t>::max() ? 8 : 16;
+}
+
+bool IsSupported(gbm::GBTreeModel const& model) {
+  if (model.trees.empty() || model.learner_model_param->IsVectorLeaf()) {
+    return false;
+  }
+  return std::none_of(model.trees.cbegin(), model.trees.cend(), [](auto const& tree) {
+    return tree->IsMultiTarget() || tree->HasCategoricalSplit();
+  });
+}
+
+bool FitsSplitWord(gbm::GBTreeModel const& model, std::size_t max_cuts) {
+  // The feature index takes the remaining bits of the split word.
+  auto n_features = static_cast<std::uint64_t>(model.learner_model_param->num_feature);
+  return n_features <= (std::uint64_t{1} << (32 - NumBinBits(max_cuts)));
+}
+}  // namespace
+
+QuantizedForest::QuantizedForest(Context const* ctx, gbm::GBTreeModel const& model)
+    : version_{model.Version()} {
+  CHECK(CanCompile(model));
+  FindCuts(model, &cuts_, &cut_ptr_);
+  bin_bits_ = NumBinBits(MaxCuts(cut_ptr_));
+  auto n_features = model.learner_model_param->num_feature;
+  for (bst_feature_t f = 0; f < n_features; ++f) {
+    if (cut_ptr_[f + 1] != cut_ptr_[f]) {
+      used_features_.push_back(f);
+    }
+  }
+  this->Build(ctx, model);
+}
+
+QuantizedForest::QuantizedForest(Context const* ctx, gbm::GBTreeModel const& model,
+                                 common::HistogramCuts const& cuts)
+    : version_{model.Version()} {
+  CHECK(CanCompile(model, cuts));
+  cuts_ = cuts.Values();
+  cut_ptr_.assign(cuts.Ptrs().cbegin(), cuts.Ptrs().cend());
+  bin_bits_ = NumBinBits(MaxCuts(cut_ptr_));
+  auto n_features = model.learner_model_param->num_feature;
+  for (bst_feature_t f = 0; f < n_features; ++f) {
+    used_features_.push_back(f);
+  }
+  this->Build(ctx, model);
+}
+
+void QuantizedForest::Build(Context const* ctx, gbm::GBTreeModel const& model) {
+  auto n_trees = model.trees.size();
+  std::vector<std::vector<bst_node_t>> orders(n_trees);
+  common::ParallelFor(n_trees, ctx->Threads(), [&](auto t) {
+    auto const& tree = *model.trees[t];
+    auto& order = orders[t];
+    order.push_back(RegTree::kRoot);
+    for (std::size_t i = 0; i < order.size(); ++i) {
+      auto const& node = tree[order[i]];
+      if (!node.IsLeaf()) {
+        order.push_back(node.LeftChild());
+        order.push_back(node.RightChild());
+      }
+    }
+  });
+
+  tree_ptr_.resize(n_trees + 1, 0);
+  for (std::size_t t = 0; t < n_trees; ++t) {
+    tree_ptr_[t + 1] = orders[t].size();
+  }
+  std::partial_sum(tree_ptr_.cbegin(), tree_ptr_.cend(), tree_ptr_.begin());
+  auto n_nodes = tree_ptr_.back();
+  split_.resize(n_nodes);
+  left_.resize(n_nodes);
+
+  common::ParallelFor(n_trees, ctx->Threads(), [&](auto t) {
+    auto const& tree = *model.trees[t];
+    auto const& order = orders[t];
+    auto beg = tree_ptr_[t];
+    std::uint32_t next_child{1};
+    for (std::size_t i = 0; i < order.size(); ++i) {
+      auto const& node = tree[order[i]];
+      if (node.IsLeaf()) {
+        float value = node.LeafValue();
+        std::memcpy(&split_[beg + i], &value, sizeof(value));
+        left_[beg + i] = 0;
+      } else {
+        auto fidx = node.SplitIndex();
+        auto f_beg = cuts_.cbegin() + cut_ptr_[fidx];
+        auto f_end = cuts_.cbegin() + cut_ptr_[fidx + 1];
+        auto bin = static_cast<std::uint32_t>(std::lower_bound(f_beg, f_end, node.SplitCond()) -
+                                              f_beg);
+        split_[beg + i] = (fidx << bin_bits_) | bin;
+        left_[beg + i] = next_child | (node.DefaultLeft() ? kDefaultLeftBit : 0U);
+        next_child += 2;
+      }
+    }
+  });
+}
+
+bool QuantizedForest::CanCompile(gbm::GBTreeModel const& model) {
+  if (!IsSupported(model)) {
+    return false;
+  }
+  std::vector<float> cuts;
+  std::vector<std::size_t> ptr;
+  FindCuts(model, &cuts, &ptr);
+  auto max_cuts = MaxCuts(ptr);
+  if (max_cuts > kMaxCuts) {
+    return false;
+  }
+  return FitsSplitWord(model, max_cuts);
+}
+
+bool QuantizedForest::CanCompile(gbm::GBTreeModel const& model,
+                                 common::HistogramCuts const& cuts) {
+  if (!IsSupported(model)) {
+    return false;
+  }
+  auto n_features = model.learner_model_param->num_feature;
+  auto const& ptrs = cuts.Ptrs();
+  auto const& values = cuts.Values();
+  if (ptrs.size() != n_features + 1) {
+    return false;
+  }
+  std::vector<std::size_t> ptr(ptrs.cbegin(), ptrs.cend());
+  auto max_cuts = MaxCuts(ptr);
+  if (max_cuts > kMaxCuts || !FitsSplitWord(model, max_cuts)) {
+    return false;
+  }
+  // Every threshold must be a cut other than the last one, the gradient index puts values
+  // greater than the last cut into the last bin.
+  for (auto const& p_tree : model.trees) {
+    for (auto const& node : p_tree->GetNodes()) {
+      if (node.IsDeleted() || node.IsLeaf()) {
+        continue;
+      }
+      auto fidx = node.SplitIndex();
+      if (fidx >= n_features) {
+        return false;
+      }
+      auto f_beg = values.cbegin() + ptrs[fidx];
+      auto f_end = values.cbegin() + ptrs[fidx + 1];
+      auto it = std::lower_bound(f_beg, f_end, node.SplitCond());
+      if (it == f_end || *it != node.SplitCond() || it + 1 == f_end) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+template <typename BinT>
+void QuantizedForest::Quantise(RegTree::FVec const& feat, common::Span<BinT> bins) const {
+  CHECK_EQ(sizeof(BinT) * 8, bin_bits_);
+  for (auto fidx : used_features_) {
+    auto fvalue = feat.GetFvalue(fidx);
+    if (common::CheckNAN(fvalue)) {
+      bins[fidx] = std::numeric_limits<BinT>::max();
+      continue;
+    }
+    auto f_beg = cuts_.cbegin() + cut_ptr_[fidx];
+    auto f_end = cuts_.cbegin() + cut_ptr_[fidx + 1];
+    bins[fidx] = static_cast<BinT>(std::upper_bound(f_beg, f_end, fvalue) - f_beg);
+  }
+}
+
+template void QuantizedForest::Quantise(RegTree::FVec const& feat,
+                                        common::Span<std::uint8_t> bins) const;
+template void QuantizedForest::Quantise(RegTree::FVec const& feat,
+                                        common::Span<std::uint16_t> bins) const;
+
+/**
+ * @brief Predictor using the @ref QuantizedForest.
+ *
+ * Only normal prediction is implemented, everything else, including models that can't be
+ * quantised, is handled by the CPU predictor.
+ */
+class QuantizedPredictor : public Predictor {
+  std::unique_ptr<Predictor> cpu_predictor_;
+
+  mutable std::mutex forest_lock_;
+  mutable std::shared_ptr<QuantizedForest const> forest_{nullptr};
+  mutable std::atomic<std::uint64_t> forest_version_{0};
+
+  /**
+   * @brief Get the forest for the model, nullptr if the model is not supported.
+   */
+  [[nodiscard]] std::shared_ptr<QuantizedForest const> GetForest(
+      gbm::GBTreeModel const& model) const {
+    // The model doesn't change during prediction, only the first call takes the lock.
+    auto version = model.Version();
+    if (forest_version_.load(std::memory_order_acquire) != version) {
+      std::lock_guard<std::mutex> guard{forest_lock_};
+      if (forest_version_.load(std::memory_order_relaxed) != version) {
+        forest_ = QuantizedForest::CanCompile(model)
+                      ? std::make_shared<QuantizedForest const>(this->ctx_, model)
+                      : nullptr;
+        forest_version_.store(version, std::memory_order_release);
+      }
+    }
+    return forest_;
+  }
+
+  /**
+   * @param fill Function for filling the feature vector of a row.
+   */
+  template <typename BinT, typename Fn>
+  void PredictRows(QuantizedForest const& forest, gbm::GBTreeModel const& model,
+                   bst_tree_t tree_begin, bst_tree_t tree_end, bst_idx_t n_rows,
+                   bst_idx_t base_rowid, Fn&& fill, std::vector<float>* out_preds) const {
+    auto n_threads = this->ctx_->Threads();
+    auto n_features = model.learner_model_param->num_feature;
+    auto n_groups = model.learner_model_param->OutputLength();
+    std::vector<RegTree::FVec> feat_vecs(n_threads);
+    std::vector<std::vector<BinT>> bins(n_threads);
+    common::ParallelFor(n_rows, n_threads, [&](auto i) {
+      auto tidx = common::ThreadIdx();
+      auto& feats = feat_vecs[tidx];
+      auto& row_bins = bins[tidx];
+      if (feats.Size() == 0) {
+        feats.Init(n_features);
+        row_bins.resize(n_features);
+      }
+      fill(i, &feats);
+      // Each row is quantised once for all trees.
+      forest.Quantise(feats, common::Span<BinT>{row_bins});
+      auto out = out_preds->data() + (base_rowid + i) * n_groups;
+      for (bst_tree_t t = tree_begin; t < tree_end; ++t) {
+        out[model.tree_info[t]] +=
+            feats.HasMissing() ? forest.PredValue<BinT, true>(t, row_bins.data())
+                               : forest.PredValue<BinT, false>(t, row_bins.data());
+      }
+      feats.Drop();
+    });
+  }
+
+  template <typename Fn>
+  void DispatchRows(QuantizedForest const& forest, gbm::GBTreeModel const& model,
+                    bst_tree_t tree_begin, bst_tree_t tree_end, bst_idx_t n_rows,
+                    bst_idx_t base_rowid, Fn&& fill, std::vector<float>* out_preds) const {
+    if (forest.BinBits() == 8) {
+      this->PredictRows<std::uint8_t>(forest, model, tree_begin, tree_end, n_rows, base_rowid,
+                                      fill, out_preds);
+    } else {
+      this->PredictRows<std::uint16_t>(forest, model, tree_begin, tree_end, n_rows, base_rowid,
+                                       fill, out_preds);
+    }
+  }
+
+  template <typename BinT>
+  void PredictGHistPage(QuantizedForest const& forest, GHistIndexMatrix const& page,
+                        gbm::GBTreeModel const& model, bst_tree_t tree_begin,
+                        bst_tree_t tree_end, std::vector<float>* out_preds) const {
+    constexpr BinT kMissing = std::numeric_limits<BinT>::max();
+    auto n_threads = this->ctx_->Threads();
+    auto n_features = model.learner_model_param->num_feature;
+    auto n_groups = model.learner_model_param->OutputLength();
+    auto const& ptrs = page.cut.Ptrs();
+    bool is_dense = page.IsDense() && page.Features() == n_features;
+    std::vector<std::vector<BinT>> bins(n_threads);
+    common::ParallelFor(page.Size(), n_threads, [&](auto i) {
+      auto& row_bins = bins[common::ThreadIdx()];
+      row_bins.resize(n_features);
+      std::fill(row_bins.begin(), row_bins.end(), kMissing);
+      auto beg = page.row_ptr[i];
+      auto end = page.row_ptr[i + 1];
+      for (auto j = beg; j < end; ++j) {
+        auto gidx = page.index[j];
+        // The dense index stores all features of a row, in order.
+        auto fidx = static_cast<bst_feature_t>(
+            is_dense ? j - beg
+                     : std::upper_bound(ptrs.cbegin(), ptrs.cend(), gidx) - ptrs.cbegin() - 1);
+        row_bins[fidx] = static_cast<BinT>(gidx - ptrs[fidx]);
+      }
+      auto out = out_preds->data() + (page.base_rowid + i) * n_groups;
+      for (bst_tree_t t = tree_begin; t < tree_end; ++t) {
+        out[model.tree_info[t]] += is_dense ? forest.PredValue<BinT, false>(t, row_bins.data())
+                                            : forest.PredValue<BinT, true>(t, row_bins.data());
+      }
+    });
+  }
+
+  /**
+   * @brief Predict the gradient index of a DMatrix without the row page, like a quantile
+   *        DMatrix used for repeated scoring. The rows are quantised once at construction
+   *        and the thresholds are compiled into bins of the same cuts.
+   *
+   * @return false if the thresholds are not cuts of the data.
+   */
+  bool PredictGHistIndex(DMatrix* p_fmat, gbm::GBTreeModel const& model, bst_tree_t tree_begin,
+                         bst_tree_t tree_end, std::vector<float>* out_preds) const {
+    std::shared_ptr<QuantizedForest const> forest;
+    for (auto const& page : p_fmat->GetBatches<GHistIndexMatrix>(this->ctx_, BatchParam{})) {
+      if (!forest) {
+        // All pages share the same cuts.
+        if (!QuantizedForest::CanCompile(model, page.cut)) {
+          return false;
+        }
+        forest = std::make_shared<QuantizedForest const>(this->ctx_, model, page.cut);
+      }
+      if (forest->BinBits() == 8) {
+        this->PredictGHistPage<std::uint8_t>(*forest, page, model, tree_begin, tree_end,
+                                             out_preds);
+      } else {
+        this->PredictGHistPage<std::uint16_t>(*forest, page, model, tree_begin, tree_end,
+                                              out_preds);
+      }
+    }
+    return static_cast<bool>(forest);
+  }
+
+  template <typename Adapter>
+  void DispatchedInplacePredict(QuantizedForest const& forest, std::any const& x,
+                                std::shared_ptr<DMatrix> p_m, gbm::GBTreeModel const& model,
+                                float missing, PredictionCacheEntry* out_preds,
+                                bst_tree_t tree_begin, bst_tree_t tree_end) const {
+    auto m = std::any_cast<std::shared_ptr<Adapter>>(x);
+    CHECK_EQ(m->NumColumns(), model.learner_model_param->num_feature)
+        << "Number of columns in data must equal to trained model.";
+    CHECK_EQ(p_m->Info().num_row_, m->NumRows());
+    this->InitOutPredictions(p_m->Info(), &(out_preds->predictions), model);
+    auto const& batch = m->Value();
+    auto n_features = model.learner_model_param->num_feature;
+    this->DispatchRows(
+        forest, model, tree_begin, tree_end, m->NumRows(), 0,
+        [&](bst_idx_t ridx, RegTree::FVec* p_feats) {
+          auto row = batch.GetLine(ridx);
+          auto out = p_feats->Data();
+          bst_idx_t n_valids = 0;
+          for (std::size_t c = 0; c < row.Size(); ++c) {
+            auto e = row.GetElement(c);
+            if (missing != e.value && !common::CheckNAN(e.value)) {
+              out[e.column_idx] = e.value;
+              n_valids++;
+            }
+          }
+          p_feats->HasMissing(n_valids != n_features);
+        },
+        &out_preds->predictions.HostVector());
+  }
+
+ public:
+  explicit QuantizedPredictor(Context const* ctx)
+      : Predictor::Predictor{ctx},
+        cpu_predictor_{Predictor::Create("cpu_predictor", ctx)} {}
+
+  void Configure(Args const& cfg) override { cpu_predictor_->Configure(cfg); }
+
+  void PredictBatch(DMatrix* p_fmat, PredictionCacheEntry* predts, gbm::GBTreeModel const& model,
+                    bst_tree_t tree_begin, bst_tree_t tree_end = 0) const override {
+    if (tree_end == 0) {
+      tree_end = model.trees.size();
+    }
+    auto* out_preds = &predts->predictions.HostVector();
+    if (!p_fmat->Info().IsColumnSplit() && !p_fmat->PageExists<SparsePage>()) {
+      CHECK_EQ(out_preds->size(),
+               p_fmat->Info().num_row_ * model.learner_model_param->OutputLength());
+      if (this->PredictGHistIndex(p_fmat, model, tree_begin, tree_end, out_preds)) {
+        return;
+      }
+    }
+    auto forest = this->GetForest(model);
+    if (!forest || p_fmat->Info().IsColumnSplit() || !p_fmat->PageExists<SparsePage>()) {
+      cpu_predictor_->PredictBatch(p_fmat, predts, model, tree_begin, tree_end);
+      return;
+    }
+
+    CHECK_EQ(out_preds->size(),
+             p_fmat->Info().num_row_ * model.learner_model_param->OutputLength());
+    for (auto const& batch : p_fmat->GetBatches<SparsePage>()) {
+      auto page = batch.GetView();
+      this->DispatchRows(
+          *forest, model, tree_begin, tree_end, batch.Size(), batch.base_rowid,
+          [&](bst_idx_t ridx, RegTree::FVec* p_feats) { p_feats->Fill(page[ridx]); }, out_preds);
+    }
+  }
+
+  bool InplacePredict(std::shared_ptr<DMatrix> p_m, gbm::GBTreeModel const& model, float missing,
+                      PredictionCacheEntry* out_preds, bst_tree_t tree_begin,
+                      bst_tree_t tree_end) const override {
+    auto proxy = dynamic_cast<data::DMatrixProxy*>(p_m.get());
+    CHECK(proxy) << error::InplacePredictProxy();
+    auto forest = this->GetForest(model);
+    auto x = proxy->Adapter();
+    if (forest && !p_m->Info().IsColumnSplit()) {
+      if (x.type() == typeid(std::shared_ptr<data::DenseAdapter>)) {
+        this->DispatchedInplacePredict<data::DenseAdapter>(*forest, x, p_m, model, missing,
+                                                           out_preds, tree_begin, tree_end);
+        return true;
+      } else if (x.type() == typeid(std::shared_ptr<data::ArrayAdapter>)) {
+        this->DispatchedInplacePredict<data::ArrayAdapter>(*forest, x, p_m, model, missing,
+                                                           out_preds, tree_begin, tree_end);
+        return true;
+      }
+    }
+    return cpu_predictor_->InplacePredict(p_m, model, missing, out_preds, tree_begin, tree_end);
+  }
+
+  bool PredictDense(gbm::GBTreeModel const& model, float const* data, bst_idx_t n_rows,
+                    float missing, bst_tree_t tree_begin, bst_tree_t tree_end,
+                    linalg::MatrixView<float> out_predt) const override {
+    return cpu_predictor_->PredictDense(model, data, n_rows, missing, tree_begin, tree_end,
+                                        out_predt);
+  }
+
+  bool PredictDenseMulti(common::Span<DenseModelSlice const> models, float const* data,
+                         bst_idx_t n_rows, float missing) const override {
+    return cpu_predictor_->PredictDenseMulti(models, data, n_rows, missing);
+  }
+
+  bool PredictCascade(DMatrix* p_fmat, gbm::GBTreeModel const& model, float missing,
+                      bst_tree_t tree_begin, bst_tree_t tree_end,
+                      common::Span<bst_tree_t const> tree_checkpoints,
+                      common::Span<float const> thresholds, linalg::VectorView<float> out_preds,
+                      common::Span<std::uint8_t> finished) const override {
+    return cpu_predictor_->PredictCascade(p_fmat, model, missing, tree_begin, tree_end,
+                                          tree_checkpoints, thresholds, out_preds, finished);
+  }
+
+  void PredictLeaf(DMatrix* p_fmat, HostDeviceVector<float>* out_preds,
+                   gbm::GBTreeModel const& model, bst_tree_t tree_end) const override {
+    cpu_predictor_->PredictLeaf(p_fmat, out_preds, model, tree_end);
+  }
+
+  bool PredictLeafMargin(DMatrix* p_fmat, gbm::GBTreeModel const& model, bst_tree_t tree_end,
+                         HostDeviceVector<float>* out_leaf,
+                         HostDeviceVector<float>* out_margin) const override {
+    return cpu_predictor_->PredictLeafMargin(p_fmat, model, tree_end, out_leaf, out_margin);
+  }
+
+  void PredictContribution(DMatrix* p_fmat, HostDeviceVector<float>* out_contribs,
+                           gbm::GBTreeModel const& model, bst_tree_t tree_end,
+                           std::vector<float> const* tree_weights, bool approximate,
+                           int condition, unsigned condition_feature) const override {
+    cpu_predictor_->PredictContribution(p_fmat, out_contribs, model, tree_end, tree_weights,
+                                        approximate, condition, condition_feature);
+  }
+
+  void PredictInteractionContributions(DMatrix* p_fmat, HostDeviceVector<float>* out_contribs,
+                                       gbm::GBTreeModel const& model, bst_tree_t tree_end,
+                                       std::vector<float> const* tree_weights,
+                                       bool approximate) const override {
+    cpu_predictor_->PredictInteractionContributions(p_fmat, out_contribs, model, tree_end,
+                                                    tree_weights, approximate);
+  }
+};
+
+XGBOOST_REGISTER_PREDICTOR(QuantizedPredictor, "quantized_predictor")
+    .describe("Make predictions with split thresholds quantised into bin indices on CPU.")
+    .set_body([](Context const* ctx) { return new QuantizedPredictor(ctx); });
+}  // namespace xgboost::predictor
@@ -0,0 +1,148 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#ifndef XGBOOST_PREDICTOR_QUANTIZED_FOREST_H_
+#define XGBOOST_PREDICTOR_QUANTIZED_FOREST_H_
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint8_t, uint16_t, uint32_t, uint64_t
+#include <cstring>  // for memcpy
+#include <limits>   // for numeric_limits
+#include <vector>   // for vector
+
+#include "../common/hist_util.h"  // for HistogramCuts
+#include "xgboost/base.h"         // for bst_node_t, bst_tree_t, bst_feature_t
+#include "xgboost/context.h"      // for Context
+#include "xgboost/span.h"         // for Span
+#include "xgboost/tree_model.h"   // for RegTree
+
+namespace xgboost::gbm {
+struct GBTreeModel;
+}  // namespace xgboost::gbm
+
+namespace xgboost::predictor {
+/**
+ * @brief A prediction-only copy of the trees with split thresholds replaced by bin indices.
+ *
+ * The unique split values of each feature form the cuts of the feature. A sample goes left
+ * at a split with the k^th cut as threshold if and only if fewer than k + 1 cuts are less
+ * than or equal to the feature value. Hence, once a sample is quantised into bin indices, the
+ * traversal compares small integers and gives the same result as the float comparison.
+ *
+ * The bin index uses 8 bits if all features have at most 254 cuts and 16 bits otherwise,
+ * leaving one value for missing. The feature index and the bin of a split are packed into a
+ * 32-bit word, which stores the leaf value for leaf nodes. With the child index, a node takes
+ * 8 bytes instead of the 12 bytes of the @ref CompiledForest. Like the compiled forest, nodes
+ * are renumbered in breadth-first order and the right child is always next to the left child.
+ *
+ * Only models with scalar leaves and without categorical splits can be quantised, see
+ * @ref CanCompile.
+ *
+ * When the data is already quantised into a @ref GHistIndexMatrix with the cuts used in
+ * training, the forest can use the histogram cuts instead. The thresholds are then bins of
+ * the gradient index and the pages can be predicted without going back to the float values.
+ */
+class QuantizedForest {
+  static constexpr std::uint32_t kDefaultLeftBit = 1U << 31;
+  static constexpr std::uint32_t kChildMask = kDefaultLeftBit - 1U;
+
+  // Sorted unique split values of each feature, or the histogram cuts.
+  std::vector<float> cuts_;
+  std::vector<std::size_t> cut_ptr_;
+  // Features used by at least one split, other features are not quantised.
+  std::vector<bst_feature_t> used_features_;
+  // Feature index and bin for split nodes, bits of the leaf value for leaf nodes.
+  std::vector<std::uint32_t> split_;
+  // Tree-local index of the left child, 0 for leaf nodes. The highest bit is used for the
+  // default direction. The right child is always `left + 1`.
+  std::vector<std::uint32_t> left_;
+  // Offset of each tree in the node arrays.
+  std::vector<std::size_t> tree_ptr_;
+  // Number of bits for the bin index, 8 or 16.
+  std::uint32_t bin_bits_;
+  // Version of the model this forest is built from.
+  std::uint64_t version_;
+
+ public:
+  /** @brief Maximum number of cuts for a feature. */
+  static constexpr std::size_t kMaxCuts = std::numeric_limits<std::uint16_t>::max() - 1;
+
+  QuantizedForest(Context const* ctx, gbm::GBTreeModel const& model);
+  /**
+   * @brief Compile the thresholds into bins of the histogram cuts, the local bin index of the
+   *        gradient index can be used as the input of @ref PredValue.
+   */
+  QuantizedForest(Context const* ctx, gbm::GBTreeModel const& model,
+                  common::HistogramCuts const& cuts);
+
+  /**
+   * @brief Whether the model can be quantised.
+   *
+   * Requires scalar leaves, no categorical split, at most @ref kMaxCuts cuts for each
+   * feature, and a number of features that fits into the split word.
+   */
+  [[nodiscard]] static bool CanCompile(gbm::GBTreeModel const& model);
+  /**
+   * @brief Whether the model can be quantised with the histogram cuts.
+   *
+   * In addition, every threshold must be a cut of the feature other than the last one. It's
+   * true for models trained with the hist tree method on the same cuts, like a quantile
+   * DMatrix constructed with the training data as reference.
+   */
+  [[nodiscard]] static bool CanCompile(gbm::GBTreeModel const& model,
+                                       common::HistogramCuts const& cuts);
+
+  [[nodiscard]] std::uint64_t Version() const { return version_; }
+  [[nodiscard]] bst_tree_t NumTrees() const { return tree_ptr_.size() - 1; }
+  [[nodiscard]] std::size_t NumNodes() const { return left_.size(); }
+  [[nodiscard]] std::uint32_t BinBits() const { return bin_bits_; }
+
+  /**
+   * @brief Quantise the used features of a sample.
+   *
+   * @tparam BinT @ref std::uint8_t when @ref BinBits is 8, @ref std::uint16_t otherwise.
+   *
+   * @param feat Dense feature vector for a single sample.
+   * @param bins Output bin indices, with the length of the feature vector.
+   */
+  template <typename BinT>
+  void Quantise(RegTree::FVec const& feat, common::Span<BinT> bins) const;
+
+  /**
+   * @brief Get the leaf value for a quantised sample.
+   *
+   * @tparam BinT        Type of the bin index, see @ref Quantise.
+   * @tparam has_missing Whether the feature vector contains missing values.
+   *
+   * @param tree_idx Index of the tree in the model.
+   * @param bins     Bin indices obtained from @ref Quantise.
+   */
+  template <typename BinT, bool has_missing>
+  [[nodiscard]] float PredValue(bst_tree_t tree_idx, BinT const* bins) const {
+    constexpr BinT kMissing = std::numeric_limits<BinT>::max();
+    constexpr std::uint32_t kShift = sizeof(BinT) * 8;
+    auto const beg = tree_ptr_[tree_idx];
+    auto const* split = split_.data() + beg;
+    auto const* left = left_.data() + beg;
+
+    std::uint32_t nidx{0};
+    while ((left[nidx] & kChildMask) != 0) {
+      auto const word = split[nidx];
+      auto const child = left[nidx] & kChildMask;
+      auto const bin = bins[word >> kShift];
+      if (has_missing && bin == kMissing) {
+        nidx = child + !(left[nidx] & kDefaultLeftBit);
+      } else {
+        nidx = child + (bin > static_cast<BinT>(word));
+      }
+    }
+    float value;
+    std::memcpy(&value, split + nidx, sizeof(value));
+    return value;
+  }
+
+ private:
+  void Build(Context const* ctx, gbm::GBTreeModel const& model);
+};
+}  // namespace xgboost::predictor
+#endif  // XGBOOST_PREDICTOR_QUANTIZED_FOREST_H_
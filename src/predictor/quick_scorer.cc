@@ -0,0 +1,351 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include "quick_scorer.h"
+
+#include <algorithm>  // for stable_sort, none_of, copy
+#include <any>        // for any, any_cast
+#include <atomic>     // for atomic
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint32_t, uint64_t
+#include <memory>     // for shared_ptr, unique_ptr, make_shared
+#include <mutex>      // for mutex, lock_guard
+#include <numeric>    // for partial_sum
+#include <tuple>      // for tie
+#include <typeinfo>   // for typeid
+#include <utility>    // for pair
+#include <vector>     // for vector
+
+#include "../common/bitfield.h"         // for TrailingZeroBits
+#include "../common/error_msg.h"        // for InplacePredictProxy
+#include "../common/threading_utils.h"  // for ParallelFor
+#include "../data/adapter.h"            // for ArrayAdapter, DenseAdapter
+#include "../data/proxy_dmatrix.h"      // for DMatrixProxy
+#include "../gbm/gbtree_model.h"        // for GBTreeModel
+#include "dmlc/registry.h"              // for DMLC_REGISTRY_FILE_TAG
+#include "xgboost/data.h"               // for DMatrix, SparsePage
+#include "xgboost/learner.h"            // for LearnerModelParam
+#include "xgboost/logging.h"            // for CHECK_EQ, CHECK
+#include "xgboost/predictor.h"          // for Predictor, PredictionCacheEntry
+
+namespace xgboost::predictor {
+
+DMLC_REGISTRY_FILE_TAG(quick_scorer);
+
+namespace {
+struct SplitNode {
+  bst_feature_t fidx;
+  float threshold;
+  std::uint32_t tree;
+  QuickScorerForest::BitVector mask;
+  bool default_left;
+};
+
+/**
+ * @brief Number the leaves from left to right, and build the mask of each split node.
+ *
+ * @return The range of leaves in the subtree.
+ */
+std::pair<bst_node_t, bst_node_t> VisitTree(RegTree const& tree, bst_node_t nidx,
+                                            std::uint32_t tree_idx, std::vector<float>* leaves,
+                                            std::vector<SplitNode>* nodes) {
+  auto const& node = tree[nidx];
+  if (node.IsLeaf()) {
+    auto i = static_cast<bst_node_t>(leaves->size());
+    leaves->push_back(node.LeafValue());
+    return {i, i + 1};
+  }
+  auto [lbeg, lend] = VisitTree(tree, node.LeftChild(), tree_idx, leaves, nodes);
+  auto [rbeg, rend] = VisitTree(tree, node.RightChild(), tree_idx, leaves, nodes);
+  CHECK_EQ(lend, rbeg);
+  // The right subtree has at least one leaf, the shift is less than 64.
+  auto left_leaves = ((QuickScorerForest::BitVector{1} << (lend - lbeg)) - 1) << lbeg;
+  nodes->push_back(
+      {node.SplitIndex(), node.SplitCond(), tree_idx, ~left_leaves, node.DefaultLeft()});
+  return {lbeg, rend};
+}
+
+std::uint32_t LeftmostLeaf(QuickScorerForest::BitVector bits) {
+  auto lo = static_cast<std::uint32_t>(bits);
+  if (lo != 0) {
+    return TrailingZeroBits(lo);
+  }
+  return 32 + TrailingZeroBits(static_cast<std::uint32_t>(bits >> 32));
+}
+}  // namespace
+
+QuickScorerForest::QuickScorerForest(Context const* ctx, gbm::GBTreeModel const& model)
+    : version_{model.Version()} {
+  CHECK(CanCompile(model));
+  auto n_trees = model.trees.size();
+  std::vector<std::vector<float>> leaves(n_trees);
+  std::vector<std::vector<SplitNode>> nodes(n_trees);
+  common::ParallelFor(n_trees, ctx->Threads(), [&](auto t) {
+    VisitTree(*model.trees[t], RegTree::kRoot, t, &leaves[t], &nodes[t]);
+  });
+
+  leaf_ptr_.resize(n_trees + 1, 0);
+  std::size_t n_nodes{0};
+  for (std::size_t t = 0; t < n_trees; ++t) {
+    leaf_ptr_[t + 1] = leaves[t].size();
+    n_nodes += nodes[t].size();
+  }
+  std::partial_sum(leaf_ptr_.cbegin(), leaf_ptr_.cend(), leaf_ptr_.begin());
+  leaf_values_.resize(leaf_ptr_.back());
+  for (std::size_t t = 0; t < n_trees; ++t) {
+    std::copy(leaves[t].cbegin(), leaves[t].cend(), leaf_values_.begin() + leaf_ptr_[t]);
+  }
+  tree_group_.assign(model.tree_info.cbegin(), model.tree_info.cend());
+
+  std::vector<SplitNode> all_nodes;
+  all_nodes.reserve(n_nodes);
+  for (auto const& tree_nodes : nodes) {
+    all_nodes.insert(all_nodes.end(), tree_nodes.cbegin(), tree_nodes.cend());
+  }
+  std::stable_sort(all_nodes.begin(), all_nodes.end(), [](auto const& l, auto const& r) {
+    return std::tie(l.fidx, l.threshold) < std::tie(r.fidx, r.threshold);
+  });
+
+  auto n_features = model.learner_model_param->num_feature;
+  feature_ptr_.resize(n_features + 1, 0);
+  missing_ptr_.resize(n_features + 1, 0);
+  thresholds_.resize(n_nodes);
+  node_tree_.resize(n_nodes);
+  node_mask_.resize(n_nodes);
+  for (std::size_t i = 0; i < n_nodes; ++i) {
+    auto const& node = all_nodes[i];
+    CHECK_LT(node.fidx, n_features);
+    thresholds_[i] = node.threshold;
+    node_tree_[i] = node.tree;
+    node_mask_[i] = node.mask;
+    feature_ptr_[node.fidx + 1]++;
+    if (!node.default_left) {
+      missing_tree_.push_back(node.tree);
+      missing_mask_.push_back(node.mask);
+      missing_ptr_[node.fidx + 1]++;
+    }
+  }
+  std::partial_sum(feature_ptr_.cbegin(), feature_ptr_.cend(), feature_ptr_.begin());
+  std::partial_sum(missing_ptr_.cbegin(), missing_ptr_.cend(), missing_ptr_.begin());
+}
+
+bool QuickScorerForest::CanCompile(gbm::GBTreeModel const& model) {
+  if (model.trees.empty() || model.learner_model_param->IsVectorLeaf()) {
+    return false;
+  }
+  return std::none_of(model.trees.cbegin(), model.trees.cend(), [](auto const& tree) {
+    return tree->IsMultiTarget() || tree->HasCategoricalSplit() ||
+           tree->GetNumLeaves() > kMaxLeaves;
+  });
+}
+
+void QuickScorerForest::Predict(RegTree::FVec const& feat, std::vector<BitVector>* bits,
+                                common::Span<float> out) const {
+  auto n_trees = this->NumTrees();
+  bits->assign(n_trees, ~BitVector{0});
+  if (feat.HasMissing()) {
+    this->Mask<true>(feat, bits);
+  } else {
+    this->Mask<false>(feat, bits);
+  }
+  for (bst_tree_t t = 0; t < n_trees; ++t) {
+    auto leaf = LeftmostLeaf((*bits)[t]);
+    out[tree_group_[t]] += leaf_values_[leaf_ptr_[t] + leaf];
+  }
+}
+
+/**
+ * @brief Predictor using the @ref QuickScorerForest.
+ *
+ * Only normal prediction over the full model is implemented, everything else, including
+ * models that can't be represented by the bitvectors, is handled by the CPU predictor.
+ */
+class QuickScorerPredictor : public Predictor {
+  std::unique_ptr<Predictor> cpu_predictor_;
+
+  mutable std::mutex forest_lock_;
+  mutable std::shared_ptr<QuickScorerForest const> forest_{nullptr};
+  mutable std::atomic<std::uint64_t> forest_version_{0};
+
+  /**
+   * @brief Get the forest for the model, nullptr if the model or the tree range is not
+   *        supported.
+   */
+  [[nodiscard]] std::shared_ptr<QuickScorerForest const> GetForest(
+      gbm::GBTreeModel const& model, bst_tree_t tree_begin, bst_tree_t tree_end) const {
+    auto n_trees = static_cast<bst_tree_t>(model.trees.size());
+    // Masks of all trees are interleaved, slicing is not supported.
+    if (tree_begin != 0 || tree_end != n_trees) {
+      return nullptr;
+    }
+    // The model doesn't change during prediction, only the first call takes the lock.
+    auto version = model.Version();
+    if (forest_version_.load(std::memory_order_acquire) != version) {
+      std::lock_guard<std::mutex> guard{forest_lock_};
+      if (forest_version_.load(std::memory_order_relaxed) != version) {
+        forest_ = QuickScorerForest::CanCompile(model)
+                      ? std::make_shared<QuickScorerForest const>(this->ctx_, model)
+                      : nullptr;
+        forest_version_.store(version, std::memory_order_release);
+      }
+    }
+    return forest_;
+  }
+
+  /**
+   * @param fill Function for filling the feature vector of a row.
+   */
+  template <typename Fn>
+  void PredictRows(QuickScorerForest const& forest, gbm::GBTreeModel const& model,
+                   bst_idx_t n_rows, bst_idx_t base_rowid, Fn&& fill,
+                   std::vector<float>* out_preds) const {
+    auto n_threads = this->ctx_->Threads();
+    auto n_features = model.learner_model_param->num_feature;
+    auto n_groups = model.learner_model_param->OutputLength();
+    std::vector<RegTree::FVec> feat_vecs(n_threads);
+    std::vector<std::vector<QuickScorerForest::BitVector>> bits(n_threads);
+    common::ParallelFor(n_rows, n_threads, [&](auto i) {
+      auto tidx = common::ThreadIdx();
+      auto& feats = feat_vecs[tidx];
+      if (feats.Size() == 0) {
+        feats.Init(n_features);
+      }
+      fill(i, &feats);
+      auto out = common::Span<float>{out_preds->data() + (base_rowid + i) * n_groups, n_groups};
+      forest.Predict(feats, &bits[tidx], out);
+      feats.Drop();
+    });
+  }
+
+  template <typename Adapter>
+  void DispatchedInplacePredict(QuickScorerForest const& forest, std::any const& x,
+                                std::shared_ptr<DMatrix> p_m, gbm::GBTreeModel const& model,
+                                float missing, PredictionCacheEntry* out_preds) const {
+    auto m = std::any_cast<std::shared_ptr<Adapter>>(x);
+    CHECK_EQ(m->NumColumns(), model.learner_model_param->num_feature)
+        << "Number of columns in data must equal to trained model.";
+    CHECK_EQ(p_m->Info().num_row_, m->NumRows());
+    this->InitOutPredictions(p_m->Info(), &(out_preds->predictions), model);
+    auto const& batch = m->Value();
+    auto n_features = model.learner_model_param->num_feature;
+    this->PredictRows(
+        forest, model, m->NumRows(), 0,
+        [&](bst_idx_t ridx, RegTree::FVec* p_feats) {
+          auto row = batch.GetLine(ridx);
+          auto out = p_feats->Data();
+          bst_idx_t n_valids = 0;
+          for (std::size_t c = 0; c < row.Size(); ++c) {
+            auto e = row.GetElement(c);
+            if (missing != e.value && !common::CheckNAN(e.value)) {
+              out[e.column_idx] = e.value;
+              n_valids++;
+            }
+          }
+          p_feats->HasMissing(n_valids != n_features);
+        },
+        &out_preds->predictions.HostVector());
+  }
+
+ public:
+  explicit QuickScorerPredictor(Context const* ctx)
+      : Predictor::Predictor{ctx},
+        cpu_predictor_{Predictor::Create("cpu_predictor", ctx)} {}
+
+  void Configure(Args const& cfg) override { cpu_predictor_->Configure(cfg); }
+
+  void PredictBatch(DMatrix* p_fmat, PredictionCacheEntry* predts, gbm::GBTreeModel const& model,
+                    bst_tree_t tree_begin, bst_tree_t tree_end = 0) const override {
+    if (tree_end == 0) {
+      tree_end = model.trees.size();
+    }
+    auto forest = this->GetForest(model, tree_begin, tree_end);
+    if (!forest || p_fmat->Info().IsColumnSplit() || !p_fmat->PageExists<SparsePage>()) {
+      cpu_predictor_->PredictBatch(p_fmat, predts, model, tree_begin, tree_end);
+      return;
+    }
+
+    auto* out_preds = &predts->predictions.HostVector();
+    CHECK_EQ(out_preds->size(),
+             p_fmat->Info().num_row_ * model.learner_model_param->OutputLength());
+    for (auto const& batch : p_fmat->GetBatches<SparsePage>()) {
+      auto page = batch.GetView();
+      this->PredictRows(
+          *forest, model, batch.Size(), batch.base_rowid,
+          [&](bst_idx_t ridx, RegTree::FVec* p_feats) { p_feats->Fill(page[ridx]); }, out_preds);
+    }
+  }
+
+  bool InplacePredict(std::shared_ptr<DMatrix> p_m, gbm::GBTreeModel const& model, float missing,
+                      PredictionCacheEntry* out_preds, bst_tree_t tree_begin,
+                      bst_tree_t tree_end) const override {
+    auto proxy = dynamic_cast<data::DMatrixProxy*>(p_m.get());
+    CHECK(proxy) << error::InplacePredictProxy();
+    auto forest = this->GetForest(model, tree_begin, tree_end);
+    auto x = proxy->Adapter();
+    if (forest && !p_m->Info().IsColumnSplit()) {
+      if (x.type() == typeid(std::shared_ptr<data::DenseAdapter>)) {
+        this->DispatchedInplacePredict<data::DenseAdapter>(*forest, x, p_m, model, missing,
+                                                           out_preds);
+        return true;
+      } else if (x.type() == typeid(std::shared_ptr<data::ArrayAdapter>)) {
+        this->DispatchedInplacePredict<data::ArrayAdapter>(*forest, x, p_m, model, missing,
+                                                           out_preds);
+        return true;
+      }
+    }
+    return cpu_predictor_->InplacePredict(p_m, model, missing, out_preds, tree_begin, tree_end);
+  }
+
+  bool PredictDense(gbm::GBTreeModel const& model, float const* data, bst_idx_t n_rows,
+                    float missing, bst_tree_t tree_begin, bst_tree_t tree_end,
+                    linalg::MatrixView<float> out_predt) const override {
+    return cpu_predictor_->PredictDense(model, data, n_rows, missing, tree_begin, tree_end,
+                                        out_predt);
+  }
+
+  bool PredictDenseMulti(common::Span<DenseModelSlice const> models, float const* data,
+                         bst_idx_t n_rows, float missing) const override {
+    return cpu_predictor_->PredictDenseMulti(models, data, n_rows, missing);
+  }
+
+  bool PredictCascade(DMatrix* p_fmat, gbm::GBTreeModel const& model, float missing,
+                      bst_tree_t tree_begin, bst_tree_t tree_end,
+                      common::Span<bst_tree_t const> tree_checkpoints,
+                      common::Span<float const> thresholds, linalg::VectorView<float> out_preds,
+                      common::Span<std::uint8_t> finished) const override {
+    return cpu_predictor_->PredictCascade(p_fmat, model, missing, tree_begin, tree_end,
+                                          tree_checkpoints, thresholds, out_preds, finished);
+  }
+
+  void PredictLeaf(DMatrix* p_fmat, HostDeviceVector<float>* out_preds,
+                   gbm::GBTreeModel const& model, bst_tree_t tree_end) const override {
+    cpu_predictor_->PredictLeaf(p_fmat, out_preds, model, tree_end);
+  }
+
+  bool PredictLeafMargin(DMatrix* p_fmat, gbm::GBTreeModel const& model, bst_tree_t tree_end,
+                         HostDeviceVector<float>* out_leaf,
+                         HostDeviceVector<float>* out_margin) const override {
+    return cpu_predictor_->PredictLeafMargin(p_fmat, model, tree_end, out_leaf, out_margin);
+  }
+
+  void PredictContribution(DMatrix* p_fmat, HostDeviceVector<float>* out_contribs,
+                           gbm::GBTreeModel const& model, bst_tree_t tree_end,
+                           std::vector<float> const* tree_weights, bool approximate,
+                           int condition, unsigned condition_feature) const override {
+    cpu_predictor_->PredictContribution(p_fmat, out_contribs, model, tree_end, tree_weights,
+                                        approximate, condition, condition_feature);
+  }
+
+  void PredictInteractionContributions(DMatrix* p_fmat, HostDeviceVector<float>* out_contribs,
+                                       gbm::GBTreeModel const& model, bst_tree_t tree_end,
+                                       std::vector<float> const* tree_weights,
+                                       bool approximate) const override {
+    cpu_predictor_->PredictInteractionContributions(p_fmat, out_contribs, model, tree_end,
+                                                    tree_weights, approximate);
+  }
+};
+
+XGBOOST_REGISTER_PREDICTOR(QuickScorerPredictor, "qs_predictor")
+    .describe("Make predictions using the QuickScorer algorithm on CPU.")
+    .set_body([](Context const* ctx) { return new QuickScorerPredictor(ctx); });
+}  // namespace xgboost::predictor
@@ -0,0 +1,114 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#ifndef XGBOOST_PREDICTOR_QUICK_SCORER_H_
+#define XGBOOST_PREDICTOR_QUICK_SCORER_H_
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t, uint64_t
+#include <vector>   // for vector
+
+#include "../common/math.h"      // for CheckNAN
+#include "xgboost/base.h"        // for bst_tree_t, bst_feature_t
+#include "xgboost/context.h"     // for Context
+#include "xgboost/span.h"        // for Span
+#include "xgboost/tree_model.h"  // for RegTree
+
+namespace xgboost::gbm {
+struct GBTreeModel;
+}  // namespace xgboost::gbm
+
+namespace xgboost::predictor {
+/**
+ * @brief Bitvector representation of a forest for the QuickScorer algorithm.
+ *
+ * Leaves of each tree are numbered from left to right, and a tree is represented by a
+ * 64-bit vector where the i^th bit indicates whether the i^th leaf is still reachable.
+ * When a sample goes to the right of a split node, all leaves in the left subtree become
+ * unreachable, which is a bitwise AND with a precomputed mask. The exit leaf is the
+ * leftmost reachable leaf after all such nodes are visited.
+ *
+ * Split nodes of all trees are grouped by feature and sorted by threshold. Since a sample
+ * goes right when `threshold <= fvalue`, these nodes are a prefix of each feature group,
+ * and no tree is traversed.
+ *
+ * See "QuickScorer: A Fast Algorithm to Rank Documents with Additive Ensembles of
+ * Regression Trees" by Lucchese et al.
+ */
+class QuickScorerForest {
+ public:
+  using BitVector = std::uint64_t;
+  /** @brief Maximum number of leaves in a tree. */
+  static constexpr bst_node_t kMaxLeaves = sizeof(BitVector) * 8;
+
+ private:
+  // Thresholds, tree indices and masks for split nodes, grouped by feature.
+  std::vector<float> thresholds_;
+  std::vector<std::uint32_t> node_tree_;
+  std::vector<BitVector> node_mask_;
+  std::vector<std::size_t> feature_ptr_;
+  // The subset of split nodes that send missing values to the right, grouped by feature.
+  std::vector<std::uint32_t> missing_tree_;
+  std::vector<BitVector> missing_mask_;
+  std::vector<std::size_t> missing_ptr_;
+  // Leaf values of each tree, from left to right.
+  std::vector<float> leaf_values_;
+  std::vector<std::size_t> leaf_ptr_;
+  // Output group of each tree.
+  std::vector<bst_target_t> tree_group_;
+  // Version of the model this forest is built from.
+  std::uint64_t version_;
+
+  template <bool has_missing>
+  void Mask(RegTree::FVec const& feat, std::vector<BitVector>* p_bits) const {
+    auto& bits = *p_bits;
+    auto n_features = static_cast<bst_feature_t>(feature_ptr_.size() - 1);
+    for (bst_feature_t fidx = 0; fidx < n_features; ++fidx) {
+      auto beg = feature_ptr_[fidx];
+      auto end = feature_ptr_[fidx + 1];
+      auto fvalue = feat.GetFvalue(fidx);
+      if (common::CheckNAN(fvalue)) {
+        if (has_missing) {
+          for (auto i = missing_ptr_[fidx], n = missing_ptr_[fidx + 1]; i < n; ++i) {
+            bits[missing_tree_[i]] &= missing_mask_[i];
+          }
+        } else {
+          // Same as `!(fvalue < threshold)` in the tree.
+          for (auto i = beg; i < end; ++i) {
+            bits[node_tree_[i]] &= node_mask_[i];
+          }
+        }
+        continue;
+      }
+      for (auto i = beg; i < end && thresholds_[i] <= fvalue; ++i) {
+        bits[node_tree_[i]] &= node_mask_[i];
+      }
+    }
+  }
+
+ public:
+  QuickScorerForest(Context const* ctx, gbm::GBTreeModel const& model);
+
+  /**
+   * @brief Whether the model can be represented by the bitvectors.
+   *
+   * Requires scalar leaves, no categorical split and at most @ref kMaxLeaves leaves per
+   * tree.
+   */
+  [[nodiscard]] static bool CanCompile(gbm::GBTreeModel const& model);
+
+  [[nodiscard]] std::uint64_t Version() const { return version_; }
+  [[nodiscard]] bst_tree_t NumTrees() const { return leaf_ptr_.size() - 1; }
+
+  /**
+   * @brief Accumulate the prediction of all trees for a sample.
+   *
+   * @param feat Dense feature vector for a single sample.
+   * @param bits Workspace, resized to the number of trees.
+   * @param out  Output for each group.
+   */
+  void Predict(RegTree::FVec const& feat, std::vector<BitVector>* bits,
+               common::Span<float> out) const;
+};
+}  // namespace xgboost::predictor
+#endif  // XGBOOST_PREDICTOR_QUICK_SCORER_H_
@@ -6,21 +6,29 @@
 #ifndef XGBOOST_TREE_COMMON_ROW_PARTITIONER_H_
 #define XGBOOST_TREE_COMMON_ROW_PARTITIONER_H_
 
-#include <algorithm>  // for all_of, fill
-#include <cstdint>    // for uint32_t, int32_t
-#include <limits>     // for numeric_limits
-#include <vector>     // for vector
-
+#include <algorithm>    // for all_of, fill, min
+#include <cstdint>      // for uint32_t, int32_t
+#include <limits>       // for numeric_limits
+#include <numeric>      // for partial_sum
+#include <type_traits>  // for is_same_v
+#include <vector>       // for vector
+
+#include "../collective/allgather.h"      // for AllgatherV
 #include "../collective/allreduce.h"      // for Allreduce
+#include "../collective/communicator-inl.h"  // for GetRank, GetWorldSize, IsDistributed
 #include "../common/bitfield.h"           // for RBitField8
+#include "../common/categorical.h"        // for Decision
+#include "../common/common.h"             // for DivRoundUp
 #include "../common/linalg_op.h"          // for cbegin
 #include "../common/numeric.h"            // for Iota
 #include "../common/partition_builder.h"  // for PartitionBuilder
-#include "../common/row_set.h"            // for RowSetCollection
+#include "../common/row_set.h"            // for RowSetCollectionImpl
 #include "../common/threading_utils.h"    // for ParallelFor2d
+#include "../common/type.h"               // for RestoreType
 #include "xgboost/base.h"                 // for bst_idx_t
 #include "xgboost/collective/result.h"    // for Success, SafeColl
 #include "xgboost/context.h"              // for Context
+#include "xgboost/host_device_vector.h"   // for HostDeviceVector
 #include "xgboost/linalg.h"               // for TensorView
 #include "xgboost/span.h"                 // for Span
 
@@ -28,13 +36,14 @@ namespace xgboost::tree {
 
 static constexpr size_t kPartitionBlockSize = 2048;
 
+template <typename RowIdxT>
 class ColumnSplitHelper {
  public:
   ColumnSplitHelper() = default;
 
   ColumnSplitHelper(bst_idx_t num_row,
-                    common::PartitionBuilder<kPartitionBlockSize>* partition_builder,
-                    common::RowSetCollection* row_set_collection)
+                    common::PartitionBuilder<kPartitionBlockSize, RowIdxT>* partition_builder,
+                    common::RowSetCollectionImpl<RowIdxT>* row_set_collection)
       : partition_builder_{partition_builder}, row_set_collection_{row_set_collection} {
     auto n_bytes = BitVector::ComputeStorageSize(num_row);
     decision_storage_.resize(n_bytes);
@@ -48,6 +57,12 @@ class ColumnSplitHelper {
                  GHistIndexMatrix const& gmat, common::ColumnMatrix const& column_matrix,
                  std::vector<ExpandEntry> const& nodes,
                  std::vector<std::int32_t> const& split_conditions, RegTree const* p_tree) {
+    if (std::all_of(nodes.cbegin(), nodes.cend(),
+                    [](auto const& node) { return node.split_owner >= 0; })) {
+      this->PartitionByOwner<BinIdxType, any_missing, any_cat>(
+          ctx, space, n_threads, gmat, column_matrix, nodes, split_conditions, p_tree);
+      return;
+    }
     // When data is split by column, we don't have all the feature values in the local worker, so
     // we first collect all the decisions and whether the feature is missing into bit vectors.
     std::fill(decision_storage_.begin(), decision_storage_.end(), 0);
@@ -59,7 +74,7 @@ class ColumnSplitHelper {
     std::fill_n(this->tloc_missing_.data(), this->tloc_missing_.size(), 0);
 
     // Make thread-local storage.
-    using T = decltype(decision_storage_)::value_type;
+    using T = typename decltype(decision_storage_)::value_type;
     auto make_tloc = [&](std::vector<T>& storage, std::int32_t tidx) {
       auto span = common::Span<T>{storage};
       auto n = decision_storage_.size();
@@ -67,13 +82,14 @@ class ColumnSplitHelper {
       return bitvec;
     };
 
-    common::ParallelFor2d(space, n_threads, [&](std::size_t node_in_set, common::Range1d r) {
+    common::ParallelFor2dStealing(space, n_threads, [&](std::size_t node_in_set,
+                                                        common::Range1d r) {
       bst_node_t const nid = nodes[node_in_set].nid;
-      auto tidx = omp_get_thread_num();
+      auto tidx = common::ThreadIdx();
       auto decision = make_tloc(this->tloc_decision_, tidx);
       auto missing = make_tloc(this->tloc_missing_, tidx);
       bst_bin_t split_cond = column_matrix.IsInitialized() ? split_conditions[node_in_set] : 0;
-      partition_builder_->MaskRows<BinIdxType, any_missing, any_cat>(
+      partition_builder_->template MaskRows<BinIdxType, any_missing, any_cat>(
           node_in_set, nodes, r, split_cond, gmat, column_matrix, *p_tree,
           (*row_set_collection_)[nid].begin(), &decision, &missing);
     });
@@ -98,7 +114,7 @@ class ColumnSplitHelper {
     collective::SafeColl(rc);
 
     // Finally use the bit vectors to partition the rows.
-    common::ParallelFor2d(space, n_threads, [&](size_t node_in_set, common::Range1d r) {
+    common::ParallelFor2dStealing(space, n_threads, [&](size_t node_in_set, common::Range1d r) {
       size_t begin = r.begin();
       const int32_t nid = nodes[node_in_set].nid;
       const size_t task_id = partition_builder_->GetTaskIdx(node_in_set, begin);
@@ -110,6 +126,101 @@ class ColumnSplitHelper {
   }
 
  private:
+  /**
+   * @brief Only the worker that owns the split feature of a node can make the decisions for
+   *        it. The owner marks the rows by their positions in the node and broadcasts a
+   *        single bit for each row to other workers.
+   */
+  template <typename BinIdxType, bool any_missing, bool any_cat, typename ExpandEntry>
+  void PartitionByOwner(Context const* ctx, common::BlockedSpace2d const& space,
+                        std::int32_t n_threads, GHistIndexMatrix const& gmat,
+                        common::ColumnMatrix const& column_matrix,
+                        std::vector<ExpandEntry> const& nodes,
+                        std::vector<std::int32_t> const& split_conditions, RegTree const* p_tree) {
+    auto world = collective::GetWorldSize();
+    auto rank = collective::GetRank();
+    auto n_nodes = nodes.size();
+
+    // Layout of the gathered decisions, ordered by the worker then by the node. Each node
+    // starts at a new byte, the partition blocks are byte-aligned as well.
+    static_assert(kPartitionBlockSize % BitVector::kValueSize == 0);
+    std::vector<std::size_t> node_bytes(n_nodes), node_offset(n_nodes);
+    std::vector<std::int64_t> worker_bytes(world, 0);
+    std::size_t n_bytes = 0, rank_begin = 0;
+    for (std::int32_t w = 0; w < world; ++w) {
+      if (w == rank) {
+        rank_begin = n_bytes;
+      }
+      for (std::size_t i = 0; i < n_nodes; ++i) {
+        if (nodes[i].split_owner != w) {
+          continue;
+        }
+        node_bytes[i] = BitVector::ComputeStorageSize((*row_set_collection_)[nodes[i].nid].Size());
+        node_offset[i] = n_bytes;
+        n_bytes += node_bytes[i];
+        worker_bytes[w] += node_bytes[i];
+      }
+    }
+
+    auto n_owned = static_cast<std::size_t>(worker_bytes[rank]);
+    owned_decision_.resize(n_owned);
+    owned_missing_.resize(n_owned);
+    std::fill(owned_decision_.begin(), owned_decision_.end(), 0);
+    std::fill(owned_missing_.begin(), owned_missing_.end(), 0);
+    auto node_bits = [&](std::vector<BitVector::value_type>* storage, std::size_t node_in_set) {
+      auto span = common::Span<BitVector::value_type>{*storage};
+      return BitVector{span.subspan(node_offset[node_in_set] - rank_begin,
+                                    node_bytes[node_in_set])};
+    };
+
+    // Tasks write to disjoint bytes, no thread-local storage is needed.
+    common::ParallelFor2dStealing(space, n_threads, [&](std::size_t node_in_set,
+                                                        common::Range1d r) {
+      if (nodes[node_in_set].split_owner != rank) {
+        return;
+      }
+      bst_node_t const nid = nodes[node_in_set].nid;
+      auto decision = node_bits(&owned_decision_, node_in_set);
+      auto missing = node_bits(&owned_missing_, node_in_set);
+      bst_bin_t split_cond = column_matrix.IsInitialized() ? split_conditions[node_in_set] : 0;
+      partition_builder_->template MaskRowsByPosition<BinIdxType, any_missing, any_cat>(
+          node_in_set, nodes, r, split_cond, gmat, column_matrix, *p_tree,
+          (*row_set_collection_)[nid].begin(), &decision, &missing);
+    });
+    // Merge the missing values into the decisions.
+    for (std::size_t i = 0; i < n_nodes; ++i) {
+      if (nodes[i].split_owner == rank && p_tree->DefaultLeft(nodes[i].nid)) {
+        auto decision = node_bits(&owned_decision_, i);
+        decision |= node_bits(&owned_missing_, i);
+      }
+    }
+
+    // Each worker broadcasts the decisions for the nodes it owns.
+    common::Span<BitVector::value_type> go_left{owned_decision_};
+    if (collective::IsDistributed()) {
+      std::vector<std::int64_t> recv_segments;
+      auto rc = collective::AllgatherV(
+          ctx, linalg::MakeVec(owned_decision_.data(), owned_decision_.size()), &recv_segments,
+          &gathered_);
+      collective::SafeColl(rc);
+      CHECK_EQ(recv_segments.size(), worker_bytes.size() + 1);
+      for (std::int32_t w = 0; w < world; ++w) {
+        CHECK_EQ(recv_segments[w + 1] - recv_segments[w], worker_bytes[w]);
+      }
+      go_left = common::RestoreType<BitVector::value_type>(gathered_.HostSpan());
+    }
+    CHECK_EQ(go_left.size(), n_bytes);
+
+    common::ParallelFor2dStealing(space, n_threads, [&](size_t node_in_set, common::Range1d r) {
+      const int32_t nid = nodes[node_in_set].nid;
+      const size_t task_id = partition_builder_->GetTaskIdx(node_in_set, r.begin());
+      partition_builder_->AllocateForTask(task_id);
+      auto bits = BitVector{go_left.subspan(node_offset[node_in_set], node_bytes[node_in_set])};
+      partition_builder_->PartitionByDecision(node_in_set, r, (*row_set_collection_)[nid].begin(),
+                                              bits);
+    });
+  }
+
   using BitVector = RBitField8;
   std::vector<BitVector::value_type> decision_storage_{};
   BitVector decision_bits_{};
@@ -118,18 +229,28 @@ class ColumnSplitHelper {
 
   std::vector<BitVector::value_type> tloc_decision_;
   std::vector<BitVector::value_type> tloc_missing_;
+  // Decisions for the nodes owned by this worker, indexed by the positions of the rows.
+  std::vector<BitVector::value_type> owned_decision_;
+  std::vector<BitVector::value_type> owned_missing_;
+  HostDeviceVector<std::int8_t> gathered_;
 
-  common::PartitionBuilder<kPartitionBlockSize>* partition_builder_;
-  common::RowSetCollection* row_set_collection_;
+  common::PartitionBuilder<kPartitionBlockSize, RowIdxT>* partition_builder_;
+  common::RowSetCollectionImpl<RowIdxT>* row_set_collection_;
 };
 
-class CommonRowPartitioner {
+/**
+ * @tparam RowIdxT Type of the row indices, must be able to hold the global row index.
+ */
+template <typename RowIdxT>
+class CommonRowPartitionerImpl {
  public:
+  using RowIdxType = RowIdxT;
+
   bst_idx_t base_rowid = 0;
 
-  CommonRowPartitioner() = default;
-  CommonRowPartitioner(Context const* ctx, bst_idx_t num_row, bst_idx_t _base_rowid,
-                       bool is_col_split)
+  CommonRowPartitionerImpl() = default;
+  CommonRowPartitionerImpl(Context const* ctx, bst_idx_t num_row, bst_idx_t _base_rowid,
+                           bool is_col_split)
       : base_rowid{_base_rowid}, is_col_split_{is_col_split} {
     Reset(ctx, num_row, _base_rowid, is_col_split);
   }
@@ -137,21 +258,77 @@ class CommonRowPartitioner {
   void Reset(Context const* ctx, bst_idx_t num_row, bst_idx_t _base_rowid, bool is_col_split) {
     base_rowid = _base_rowid;
     is_col_split_ = is_col_split;
+    by_position_ = false;
 
-    std::vector<bst_idx_t>& row_indices = *row_set_collection_.Data();
+    CHECK_LE(base_rowid + num_row,
+             static_cast<bst_idx_t>(std::numeric_limits<RowIdxT>::max()) + 1);
+    std::vector<RowIdxT>& row_indices = *row_set_collection_.Data();
     row_indices.resize(num_row);
 
-    bst_idx_t* p_row_indices = row_indices.data();
-    common::Iota(ctx, p_row_indices, p_row_indices + num_row, base_rowid);
+    RowIdxT* p_row_indices = row_indices.data();
+    common::Iota(ctx, p_row_indices, p_row_indices + num_row, static_cast<RowIdxT>(base_rowid));
 
     row_set_collection_.Clear();
     row_set_collection_.Init();
 
     if (is_col_split_) {
-      column_split_helper_ = ColumnSplitHelper{num_row, &partition_builder_, &row_set_collection_};
+      column_split_helper_ =
+          ColumnSplitHelper<RowIdxT>{num_row, &partition_builder_, &row_set_collection_};
     }
   }
 
+  /**
+   * @brief Initialize the root node with only the rows that have non-zero gradient, like
+   *        the rows selected by the sampler. Rows excluded from the root don't participate
+   *        in histogram building and partitioning.
+   *
+   * @param gpair Gradient of rows in this page.
+   */
+  void Reset(Context const* ctx, bst_idx_t _base_rowid,
+             linalg::MatrixView<GradientPair const> gpair) {
+    base_rowid = _base_rowid;
+    is_col_split_ = false;
+    by_position_ = false;
+    bst_idx_t n_rows = gpair.Shape(0);
+    auto n_targets = gpair.Shape(1);
+    auto is_sampled = [&](bst_idx_t i) {
+      for (std::size_t t = 0; t < n_targets; ++t) {
+        auto g = gpair(i, t);
+        if (g.GetGrad() != 0.0f || g.GetHess() != 0.0f) {
+          return true;
+        }
+      }
+      return false;
+    };
+
+    // Count the sampled rows for each block, then write the row indices at the offsets.
+    auto n_blocks = common::DivRoundUp(n_rows, kPartitionBlockSize);
+    std::vector<bst_idx_t> offsets(n_blocks + 1, 0);
+    common::ParallelFor(n_blocks, ctx->Threads(), [&](auto k) {
+      auto end = std::min(n_rows, (k + 1) * kPartitionBlockSize);
+      for (auto i = k * kPartitionBlockSize; i < end; ++i) {
+        offsets[k + 1] += is_sampled(i);
+      }
+    });
+    std::partial_sum(offsets.cbegin(), offsets.cend(), offsets.begin());
+
+    CHECK_LE(base_rowid + n_rows, static_cast<bst_idx_t>(std::numeric_limits<RowIdxT>::max()) + 1);
+    std::vector<RowIdxT>& row_indices = *row_set_collection_.Data();
+    row_indices.resize(offsets.back());
+    common::ParallelFor(n_blocks, ctx->Threads(), [&](auto k) {
+      auto out = offsets[k];
+      auto end = std::min(n_rows, (k + 1) * kPartitionBlockSize);
+      for (auto i = k * kPartitionBlockSize; i < end; ++i) {
+        if (is_sampled(i)) {
+          row_indices[out++] = static_cast<RowIdxT>(i + base_rowid);
+        }
+      }
+    });
+
+    row_set_collection_.Clear();
+    row_set_collection_.Init();
+  }
+
   /* Making GHistIndexMatrix_t a templete parameter allows reuse this function for sycl-plugin */
   template <typename ExpandEntry, typename GHistIndexMatrixT>
   static void FindSplitConditions(const std::vector<ExpandEntry>& nodes, const RegTree& tree,
@@ -193,10 +370,84 @@ class CommonRowPartitioner {
     }
   }
 
+  /**
+   * @brief Track the node of each row in @ref Positions instead of partitioning the rows.
+   *        The row sets keep only the number of rows in each node until @ref Materialize is
+   *        called. Must be called before the root is split.
+   *
+   * @param n_rows Number of rows in this page, including the ones that are not in the root.
+   */
+  void StartPositions(Context const* ctx, bst_idx_t n_rows) {
+    CHECK(!is_col_split_) << "The positions are not supported by column split.";
+    CHECK_EQ(this->Size(), 1);
+    position_.resize(n_rows);
+    std::fill(position_.begin(), position_.end(), -1);
+    auto const& root = row_set_collection_[RegTree::kRoot];
+    common::ParallelFor(root.Size(), ctx->Threads(), [&](auto i) {
+      position_[root.begin()[i] - base_rowid] = RegTree::kRoot;
+    });
+    by_position_ = true;
+  }
+  [[nodiscard]] bool ByPosition() const { return by_position_; }
+  /**
+   * @brief The node of each row in this page, negative if the row is not used. Only valid
+   *        when @ref ByPosition is true.
+   */
+  [[nodiscard]] common::Span<bst_node_t const> Positions() const {
+    return common::Span{position_.data(), position_.size()};
+  }
+  /**
+   * @brief Write the row indices of each node from the positions and stop tracking the
+   *        positions. The rows are sorted in each node, the same as partitioning the rows
+   *        at each split. No-op if @ref ByPosition is false.
+   */
+  void Materialize(Context const* ctx) {
+    if (!by_position_) {
+      return;
+    }
+    by_position_ = false;
+    auto n_nodes = this->Size();
+    auto n_rows = static_cast<bst_idx_t>(position_.size());
+    auto n_blocks = common::DivRoundUp(n_rows, kPartitionBlockSize);
+    // Count the rows of each node in each block, then the offsets of the blocks in each node.
+    std::vector<bst_idx_t> offsets(n_blocks * n_nodes, 0);
+    common::ParallelFor(n_blocks, ctx->Threads(), [&](auto k) {
+      auto end = std::min(n_rows, (k + 1) * kPartitionBlockSize);
+      for (auto i = k * kPartitionBlockSize; i < end; ++i) {
+        if (position_[i] >= 0) {
+          ++offsets[k * n_nodes + position_[i]];
+        }
+      }
+    });
+    for (std::size_t nidx = 0; nidx < n_nodes; ++nidx) {
+      bst_idx_t n{0};
+      for (std::size_t k = 0; k < n_blocks; ++k) {
+        auto cnt = offsets[k * n_nodes + nidx];
+        offsets[k * n_nodes + nidx] = n;
+        n += cnt;
+      }
+      CHECK_EQ(n, row_set_collection_[nidx].Size());
+    }
+    common::ParallelFor(n_blocks, ctx->Threads(), [&](auto k) {
+      auto end = std::min(n_rows, (k + 1) * kPartitionBlockSize);
+      for (auto i = k * kPartitionBlockSize; i < end; ++i) {
+        auto nidx = position_[i];
+        if (nidx >= 0) {
+          row_set_collection_[nidx].begin()[offsets[k * n_nodes + nidx]++] =
+              static_cast<RowIdxT>(i + base_rowid);
+        }
+      }
+    });
+  }
+
   template <typename ExpandEntry>
   void UpdatePosition(Context const* ctx, GHistIndexMatrix const& gmat,
                       std::vector<ExpandEntry> const& nodes, RegTree const* p_tree) {
-    auto const& column_matrix = gmat.Transpose();
+    if (by_position_) {
+      this->UpdatePositionInPlace(ctx, gmat, nodes, p_tree);
+      return;
+    }
+    auto const& column_matrix = gmat.Transpose(ctx);
     if (column_matrix.IsInitialized()) {
       if (gmat.cut.HasCategorical()) {
         this->template UpdatePosition<true>(ctx, gmat, column_matrix, nodes, p_tree);
@@ -205,7 +456,8 @@ class CommonRowPartitioner {
       }
     } else {
       /* ColumnMatrix is not initilized.
-       * It means that we use 'approx' method.
+       * It means that we use 'approx' method, or the gradient index is dense and used
+       * directly by 'hist'.
        * any_missing and any_cat don't metter in this case.
        * Jump directly to the main method.
        */
@@ -270,10 +522,11 @@ class CommonRowPartitioner {
     // 2.3 Split elements of row_set_collection_ to left and right child-nodes for each node
     // Store results in intermediate buffers from partition_builder_
     if (is_col_split_) {
-      column_split_helper_.Partition<BinIdxType, any_missing, any_cat>(
+      column_split_helper_.template Partition<BinIdxType, any_missing, any_cat>(
           ctx, space, ctx->Threads(), gmat, column_matrix, nodes, split_conditions, p_tree);
     } else {
-      common::ParallelFor2d(space, ctx->Threads(), [&](size_t node_in_set, common::Range1d r) {
+      common::ParallelFor2dStealing(space, ctx->Threads(), [&](size_t node_in_set,
+                                                               common::Range1d r) {
         size_t begin = r.begin();
         const int32_t nid = nodes[node_in_set].nid;
         const size_t task_id = partition_builder_.GetTaskIdx(node_in_set, begin);
@@ -291,7 +544,8 @@ class CommonRowPartitioner {
 
     // 4. Copy elements from partition_builder_ to row_set_collection_ back
     // with updated row-indexes for each tree-node
-    common::ParallelFor2d(space, ctx->Threads(), [&](size_t node_in_set, common::Range1d r) {
+    common::ParallelFor2dStealing(space, ctx->Threads(), [&](size_t node_in_set,
+                                                             common::Range1d r) {
       const int32_t nid = nodes[node_in_set].nid;
       partition_builder_.MergeToArray(node_in_set, r.begin(), row_set_collection_[nid].begin());
     });
@@ -344,10 +598,122 @@ class CommonRowPartitioner {
   }
 
  private:
-  common::PartitionBuilder<kPartitionBlockSize> partition_builder_;
-  common::RowSetCollection row_set_collection_;
+  /**
+   * @brief Move each row of the split nodes to a child in @ref Positions. The rows are read
+   *        in a single pass, only the sizes of the children are recorded in the row sets.
+   */
+  template <typename ExpandEntry>
+  void UpdatePositionInPlace(Context const* ctx, GHistIndexMatrix const& gmat,
+                             std::vector<ExpandEntry> const& nodes, RegTree const* p_tree) {
+    CHECK_EQ(base_rowid, gmat.base_rowid);
+    CHECK_EQ(position_.size(), gmat.Size());
+    auto const& tree = *p_tree;
+    auto n_splits = nodes.size();
+    // The index of the split for each node, -1 if the node is not split.
+    std::vector<std::int32_t> split_idx(tree.GetNodes().size(), -1);
+    for (std::size_t i = 0; i < n_splits; ++i) {
+      split_idx[nodes[i].nid] = static_cast<std::int32_t>(i);
+    }
+    auto const& cut_values = gmat.cut.Values();
+    auto go_left = [&](bst_idx_t ridx, bst_node_t nidx) {
+      auto gidx = gmat.GetGindex(ridx, tree.SplitIndex(nidx));
+      if (gidx < 0) {
+        return tree.DefaultLeft(nidx);
+      }
+      if (tree.GetSplitTypes()[nidx] == FeatureType::kCategorical) {
+        return common::Decision(tree.NodeCats(nidx), cut_values[gidx]);
+      }
+      return cut_values[gidx] <= tree.SplitCond(nidx);
+    };
+
+    auto n_rows = static_cast<bst_idx_t>(position_.size());
+    auto n_blocks = common::DivRoundUp(n_rows, kPartitionBlockSize);
+    // The number of rows sent to each child by each block.
+    std::vector<bst_idx_t> n_left(n_blocks * n_splits, 0), n_right(n_blocks * n_splits, 0);
+    common::ParallelFor(n_blocks, ctx->Threads(), [&](auto k) {
+      auto end = std::min(n_rows, (k + 1) * kPartitionBlockSize);
+      for (auto i = k * kPartitionBlockSize; i < end; ++i) {
+        auto nidx = position_[i];
+        if (nidx < 0 || split_idx[nidx] < 0) {
+          continue;
+        }
+        auto s = k * n_splits + split_idx[nidx];
+        if (go_left(i, nidx)) {
+          position_[i] = tree.LeftChild(nidx);
+          ++n_left[s];
+        } else {
+          position_[i] = tree.RightChild(nidx);
+          ++n_right[s];
+        }
+      }
+    });
+
+    for (std::size_t i = 0; i < n_splits; ++i) {
+      bst_idx_t l{0}, r{0};
+      for (std::size_t k = 0; k < n_blocks; ++k) {
+        l += n_left[k * n_splits + i];
+        r += n_right[k * n_splits + i];
+      }
+      auto nidx = nodes[i].nid;
+      CHECK_EQ(tree.LeftChild(nidx) + 1, tree.RightChild(nidx));
+      row_set_collection_.AddSplit(nidx, tree.LeftChild(nidx), tree.RightChild(nidx), l, r);
+    }
+  }
+
+  common::PartitionBuilder<kPartitionBlockSize, RowIdxT> partition_builder_;
+  common::RowSetCollectionImpl<RowIdxT> row_set_collection_;
   bool is_col_split_;
-  ColumnSplitHelper column_split_helper_;
+  ColumnSplitHelper<RowIdxT> column_split_helper_;
+  // The node of each row when the rows are not partitioned, see @ref StartPositions.
+  std::vector<bst_node_t> position_;
+  bool by_position_{false};
+};
+
+using CommonRowPartitioner = CommonRowPartitionerImpl<bst_idx_t>;
+
+/**
+ * @brief Row partitioners for all the pages of a DMatrix.
+ *
+ *   The row indices are stored as 32-bit integers when the number of rows fits, which
+ *   halves the memory traffic of partitioning and histogram building. The partitioners
+ *   are accessed through @ref Visit, with the vector of the selected type.
+ */
+class RowPartitioners {
+  std::vector<CommonRowPartitionerImpl<std::uint32_t>> small_;
+  std::vector<CommonRowPartitionerImpl<bst_idx_t>> large_;
+  bool is_small_{true};
+
+ public:
+  /**
+   * @brief Select the type of row index. The partitioners are cleared if the type is
+   *        changed, otherwise they are kept for reuse.
+   *
+   * @param n_samples Total number of rows, the row indices are global.
+   */
+  void SetNumSamples(bst_idx_t n_samples) {
+    bool is_small = common::DispatchRowIdxType(
+        n_samples, [](auto t) { return std::is_same_v<decltype(t), std::uint32_t>; });
+    if (is_small != is_small_) {
+      small_.clear();
+      large_.clear();
+    }
+    is_small_ = is_small;
+  }
+
+  template <typename Fn>
+  decltype(auto) Visit(Fn&& fn) {
+    if (is_small_) {
+      return fn(small_);
+    }
+    return fn(large_);
+  }
+  template <typename Fn>
+  decltype(auto) Visit(Fn&& fn) const {
+    if (is_small_) {
+      return fn(small_);
+    }
+    return fn(large_);
+  }
 };
 
 }  // namespace xgboost::tree
@@ -1,10 +1,10 @@
 /*!
- * Copyright 2018-2019 by Contributors
+ * Copyright 2018-2025 by Contributors
  */
-#include <algorithm>
-#include <unordered_set>
-#include <vector>
+#include <algorithm>  // for max, copy_n
+#include <vector>     // for vector
 
+#include "../common/common.h"  // for DivRoundUp
 #include "xgboost/span.h"
 #include "xgboost/json.h"
 #include "constraints.h"
@@ -28,8 +28,7 @@ void FeatureInteractionConstraintHost::Reset() {
   if (!enabled_) {
     return;
   }
-  // Read std::vector<std::vector<bst_feature_t>> first and then
-  //   convert to std::vector<std::unordered_set<bst_feature_t>>
+  // Read std::vector<std::vector<bst_feature_t>> first and then convert to bitsets
   std::vector<std::vector<bst_feature_t>> tmp;
   try {
     ParseInteractionConstraint(this->interaction_constraint_str_, &tmp);
@@ -38,66 +37,87 @@ void FeatureInteractionConstraintHost::Reset() {
                << this->interaction_constraint_str_ << "\n"
                << "With error:\n" << e.what();
   }
-  for (const auto& e : tmp) {
-    interaction_constraints_.emplace_back(e.begin(), e.end());
+  // The bitsets cover the features in the constraints as well, features that are not in
+  // the data are still permitted for the child nodes like other features of the group.
+  std::size_t n_bits = std::max(n_features_, static_cast<bst_feature_t>(1));
+  for (auto const& constraint : tmp) {
+    for (auto fid : constraint) {
+      n_bits = std::max(n_bits, static_cast<std::size_t>(fid) + 1);
+    }
+  }
+  n_words_ = common::DivRoundUp(n_bits, kWordBits);
+  interaction_constraints_.assign(tmp.size() * n_words_, 0);
+  for (std::size_t c = 0; c < tmp.size(); ++c) {
+    auto* constraint = interaction_constraints_.data() + c * n_words_;
+    for (auto fid : tmp[c]) {
+      constraint[fid / kWordBits] |= BitWord{1} << (fid % kWordBits);
+    }
   }
 
   // Initialise interaction constraints record with all variables permitted for the first node
-  node_constraints_.clear();
-  node_constraints_.resize(1, std::unordered_set<bst_feature_t>());
-  node_constraints_[0].reserve(n_features_);
+  node_constraints_.assign(n_words_, 0);
   for (bst_feature_t i = 0; i < n_features_; ++i) {
-    node_constraints_[0].insert(i);
+    node_constraints_[i / kWordBits] |= BitWord{1} << (i % kWordBits);
   }
 
   // Initialise splits record
-  splits_.clear();
-  splits_.resize(1, std::unordered_set<bst_feature_t>());
+  splits_.assign(n_words_, 0);
 }
 
 void FeatureInteractionConstraintHost::SplitImpl(
     bst_node_t node_id, bst_feature_t feature_id, bst_node_t left_id, bst_node_t right_id) {
   bst_node_t newsize = std::max(left_id, right_id) + 1;
-
-  // Record previous splits for child nodes
-  auto feature_splits = splits_[node_id];  // fid history of current node
-  feature_splits.insert(feature_id);  // add feature of current node
-  splits_.resize(newsize);
-  splits_[left_id] = feature_splits;
-  splits_[right_id] = feature_splits;
-
-  // Resize constraints record, initialise all features to be not permitted for new nodes
   CHECK_NE(newsize, 0);
-  node_constraints_.resize(newsize, std::unordered_set<bst_feature_t>());
+  CHECK_LT(feature_id, n_words_ * kWordBits);
+  auto const n_words = n_words_;
 
-  // Permit features used in previous splits
-  for (bst_feature_t fid : feature_splits) {
-    node_constraints_[left_id].insert(fid);
-    node_constraints_[right_id].insert(fid);
-  }
+  // Record previous splits for child nodes, new nodes have no feature permitted.
+  splits_.resize(newsize * n_words, 0);
+  node_constraints_.resize(newsize * n_words, 0);
+  auto* left_splits = splits_.data() + left_id * n_words;
+  auto* right_splits = splits_.data() + right_id * n_words;
+  auto const* parent_splits = splits_.data() + node_id * n_words;
+  std::copy_n(parent_splits, n_words, left_splits);
+  left_splits[feature_id / kWordBits] |= BitWord{1} << (feature_id % kWordBits);
+  std::copy_n(left_splits, n_words, right_splits);
 
-  // Loop across specified interactions in constraints
-  for (const auto &constraint : interaction_constraints_) {
-    // flags whether the specified interaction is still relevant
-    bst_uint flag = 1;
+  // Permit features used in previous splits
+  auto* left = node_constraints_.data() + left_id * n_words;
+  auto* right = node_constraints_.data() + right_id * n_words;
+  std::copy_n(left_splits, n_words, left);
 
-    // Test relevance of specified interaction by checking all previous
-    // features are included
-    for (bst_uint checkvar : feature_splits) {
-      if (constraint.count(checkvar) == 0) {
-        flag = 0;
-        break;   // interaction is not relevant due to unmet constraint
-      }
+  // Permit all features of the interactions that contain all the previous splits.
+  auto n_constraints = interaction_constraints_.size() / n_words;
+  for (std::size_t c = 0; c < n_constraints; ++c) {
+    auto const* constraint = interaction_constraints_.data() + c * n_words;
+    BitWord unmet{0};
+    for (std::size_t i = 0; i < n_words; ++i) {
+      unmet |= left_splits[i] & ~constraint[i];
     }
-
-    // If interaction is still relevant, permit all other features in the
-    // interaction
-    if (flag == 1) {
-      for (bst_uint k : constraint) {
-        node_constraints_[left_id].insert(k);
-        node_constraints_[right_id].insert(k);
+    if (unmet == 0) {
+      for (std::size_t i = 0; i < n_words; ++i) {
+        left[i] |= constraint[i];
       }
     }
   }
+  std::copy_n(left, n_words, right);
+}
+
+common::Span<bst_feature_t const> FeatureInteractionConstraintHost::Query(
+    common::Span<bst_feature_t const> feature_list, bst_node_t nid,
+    std::vector<bst_feature_t>* out) const {
+  if (!enabled_) {
+    return feature_list;
+  }
+  auto const* allowed = this->NodeConstraint(nid);
+  out->resize(feature_list.size());
+  std::size_t n{0};
+  for (auto fid : feature_list) {
+    // Always write the feature, the output position moves only if it's allowed.
+    (*out)[n] = fid;
+    n += this->Test(allowed, fid);
+  }
+  out->resize(n);
+  return common::Span<bst_feature_t const>{*out};
 }
 }  // namespace xgboost
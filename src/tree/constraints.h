@@ -1,42 +1,60 @@
 /**
- * Copyright 2018-2023 by Contributors
+ * Copyright 2018-2025 by Contributors
  */
 #ifndef XGBOOST_TREE_CONSTRAINTS_H_
 #define XGBOOST_TREE_CONSTRAINTS_H_
 
-#include <string>
-#include <unordered_set>
-#include <vector>
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
+#include <string>   // for string
+#include <vector>   // for vector
 
 #include "param.h"
 #include "xgboost/base.h"
+#include "xgboost/logging.h"  // for CHECK_LT
+#include "xgboost/span.h"     // for Span
 
 namespace xgboost {
 /*!
  * \brief Feature interaction constraint implementation for CPU tree updaters.
  *
- * The interface is similar to the one for GPU Hist.
+ * The interface is similar to the one for GPU Hist. Sets of features are stored as
+ * bitsets with 64-bit words, each node has the set of allowed features and the set of
+ * features used by the splits of its ancestors.
  */
 class FeatureInteractionConstraintHost {
  protected:
-  // interaction_constraints_[constraint_id] contains a single interaction
-  //   constraint, which specifies a group of feature IDs that can interact
-  //   with each other
-  std::vector< std::unordered_set<bst_feature_t> > interaction_constraints_;
-  // int_cont_[nid] contains the set of all feature IDs that are allowed to
-  //   be used for a split at node nid
-  std::vector< std::unordered_set<bst_feature_t> > node_constraints_;
-  // splits_[nid] contains the set of all feature IDs that have been used for
-  //   splits in node nid and its parents
-  std::vector< std::unordered_set<bst_feature_t> > splits_;
+  using BitWord = std::uint64_t;
+  static constexpr std::size_t kWordBits = sizeof(BitWord) * 8;
+
+  // interaction_constraints_[constraint_id * n_words_, (constraint_id + 1) * n_words_)
+  //   contains a single interaction constraint, which specifies a group of feature IDs
+  //   that can interact with each other
+  std::vector<BitWord> interaction_constraints_;
+  // node_constraints_[nid * n_words_, (nid + 1) * n_words_) contains the set of all
+  //   feature IDs that are allowed to be used for a split at node nid
+  std::vector<BitWord> node_constraints_;
+  // splits_[nid * n_words_, (nid + 1) * n_words_) contains the set of all feature IDs
+  //   that have been used for splits in node nid and its parents
+  std::vector<BitWord> splits_;
   // string passed by user.
   std::string interaction_constraint_str_;
   // number of features in DMatrix/Booster
   bst_feature_t n_features_;
+  // number of words in each bitset
+  std::size_t n_words_{0};
   bool enabled_{false};
 
   void SplitImpl(int32_t node_id, bst_feature_t feature_id, bst_node_t left_id,
                  bst_node_t right_id);
+  [[nodiscard]] std::size_t NumNodes() const { return node_constraints_.size() / n_words_; }
+  [[nodiscard]] BitWord const* NodeConstraint(bst_node_t nid) const {
+    CHECK_LT(static_cast<std::size_t>(nid), this->NumNodes());
+    return node_constraints_.data() + nid * n_words_;
+  }
+  [[nodiscard]] bool Test(BitWord const* bits, bst_feature_t fid) const {
+    return fid < n_words_ * kWordBits && ((bits[fid / kWordBits] >> (fid % kWordBits)) & 1);
+  }
 
  public:
   FeatureInteractionConstraintHost() = default;
@@ -51,8 +69,22 @@ class FeatureInteractionConstraintHost {
 
   bool Query(bst_node_t nid, bst_feature_t fid) const {
     if (!enabled_) { return true; }
-    return node_constraints_.at(nid).find(fid) != node_constraints_.at(nid).cend();
+    return this->Test(this->NodeConstraint(nid), fid);
   }
+  /**
+   * \brief Get the features that are allowed at a node.
+   *
+   * \param feature_list The candidate features.
+   * \param nid          The node index.
+   * \param out          Buffer for the allowed features.
+   *
+   * \return The allowed features in the same order as the input. The input is returned if
+   *         the constraint is not enabled, otherwise the result is stored in `out`.
+   */
+  common::Span<bst_feature_t const> Query(common::Span<bst_feature_t const> feature_list,
+                                          bst_node_t nid, std::vector<bst_feature_t>* out) const;
+
+  [[nodiscard]] bool Enabled() const { return enabled_; }
 
   void Reset();
 
@@ -6,6 +6,7 @@
 #include <xgboost/span.h>
 #include <queue>
 #include <vector>
+#include "../common/cancel.h"  // for CancelScope
 #include "./param.h"
 
 namespace xgboost {
@@ -68,21 +69,49 @@ class Driver {
   // This set has no dependencies between entries so they may be expanded in
   // parallel or asynchronously
   std::vector<ExpandEntryT> Pop() {
-    if (queue_.empty()) return {};
-    // Return a single entry for loss guided mode
+    std::vector<ExpandEntryT> result;
+    this->Pop(&result);
+    return result;
+  }
+  // Same as above, but the output buffer is reused to avoid allocation in each round.
+  void Pop(std::vector<ExpandEntryT>* p_result) {
+    auto& result = *p_result;
+    result.clear();
+    if (queue_.empty()) return;
+    // The training can be paused between levels. Stop growing the tree once the training
+    // is cancelled, the remaining entries become leaves.
+    if (common::CancelScope::Checkpoint()) {
+      while (!queue_.empty()) {
+        queue_.pop();
+      }
+      return;
+    }
+    // Return a single entry for loss guided mode. Without a limit on the number of leaves,
+    // all valid entries are expanded eventually and their splits don't depend on the order
+    // of expansion. In that case, the best entries are returned as a batch regardless of
+    // depth to reduce the number of synchronized steps.
+    if (param_.grow_policy == TrainParam::kLossGuide && param_.max_leaves == 0) {
+      while (!queue_.empty() && result.size() < max_node_batch_size_) {
+        ExpandEntryT e = queue_.top();
+        queue_.pop();
+        if (e.IsValid(param_, num_leaves_)) {
+          num_leaves_++;
+          result.emplace_back(e);
+        }
+      }
+      return;
+    }
     if (param_.grow_policy == TrainParam::kLossGuide) {
       ExpandEntryT e = queue_.top();
       queue_.pop();
 
       if (e.IsValid(param_, num_leaves_)) {
         num_leaves_++;
-        return {e};
-      } else {
-        return {};
+        result.emplace_back(e);
       }
+      return;
     }
     // Return nodes on same level for depth wise
-    std::vector<ExpandEntryT> result;
     ExpandEntryT e = queue_.top();
     int level = e.depth;
     while (e.depth == level && !queue_.empty() && result.size() < max_node_batch_size_) {
@@ -96,7 +125,6 @@ class Driver {
         e = queue_.top();
       }
     }
-    return result;
   }
 
  private:
@@ -33,7 +33,7 @@ void FitStump(Context const* ctx, MetaInfo const& info,
   // Reduce by column, parallel by samples
   common::ParallelFor(gpair.Shape(0), ctx->Threads(), [&](auto i) {
     for (bst_target_t t = 0; t < n_targets; ++t) {
-      h_sum_tloc(omp_get_thread_num(), t) += GradientPairPrecise{gpair(i, t)};
+      h_sum_tloc(common::ThreadIdx(), t) += GradientPairPrecise{gpair(i, t)};
     }
   });
   // Aggregate to the first row.
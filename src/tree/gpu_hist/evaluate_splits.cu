@@ -1,7 +1,7 @@
 /**
  * Copyright 2020-2024, XGBoost Contributors
  */
-#include <algorithm>  // for :max
+#include <algorithm>  // for max, minmax_element
 #include <limits>     // for numeric_limits
 
 #include "../../collective/allgather.h"
@@ -387,12 +387,16 @@ void GPUHistEvaluator::CopyToHost(const std::vector<bst_node_t> &nidx) {
   auto h_cats = this->HostCatStorage(nidx);
   dh::CUDAEvent event;
   event.Record(dh::DefaultStream());
-  for (auto idx : nidx) {
-    copy_stream_.View().Wait(event);
-    dh::safe_cuda(cudaMemcpyAsync(
-        h_cats.GetNodeCatStorage(idx).data(), d_cats.GetNodeCatStorage(idx).data(),
-        d_cats.GetNodeCatStorage(idx).size_bytes(), cudaMemcpyDeviceToHost, copy_stream_.View()));
-  }
+  copy_stream_.View().Wait(event);
+  // The storage is indexed by the node, copy the range covering all the nodes at once
+  // instead of issuing a copy for each node in large batches.
+  auto [min_it, max_it] = std::minmax_element(nidx.cbegin(), nidx.cend());
+  auto n_bytes = (h_cats.GetNodeCatStorage(*max_it).data() -
+                  h_cats.GetNodeCatStorage(*min_it).data() + node_categorical_storage_size_) *
+                 sizeof(CatST);
+  dh::safe_cuda(cudaMemcpyAsync(h_cats.GetNodeCatStorage(*min_it).data(),
+                                d_cats.GetNodeCatStorage(*min_it).data(), n_bytes,
+                                cudaMemcpyDeviceToHost, copy_stream_.View()));
 }
 
 void GPUHistEvaluator::EvaluateSplits(Context const *ctx, const std::vector<bst_node_t> &nidx,
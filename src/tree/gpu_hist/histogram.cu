@@ -141,6 +141,7 @@ XGBOOST_DEV_INLINE void AtomicAddGpairGlobal(xgboost::GradientPairInt64* dest,
 template <bool kCompressed, int kBlockThreads, int kItemsPerThread>
 class HistogramAgent {
   int constexpr static kItemsPerTile = kBlockThreads * kItemsPerThread;
+  std::int32_t constexpr static kWarpSize = 32;
 
   GradientPairInt64* smem_arr_;
   GradientPairInt64* d_node_hist_;
@@ -169,6 +170,43 @@ class HistogramAgent {
         rounding_{rounding},
         d_gpair_{d_gpair} {}
 
+  /**
+   * @brief Add the gradient to the shared memory histogram, `gidx` is -1 for missing
+   *        values.
+   *
+   *   When the feature stride is smaller than the warp, the lanes of a warp might work on
+   *   the same feature, and a skewed feature, like a categorical feature with a dominating
+   *   category, makes the whole warp contend for the same bin. In that case the gradient
+   *   is summed within the warp and written with a single atomic operation.
+   */
+  __device__ void AddGpairShared(bst_bin_t gidx, GradientPairInt64 const& gpair) {
+#if __CUDA_ARCH__ >= 700
+    if (feature_stride_ < kWarpSize) {
+      auto constexpr kFullMask = ~std::uint32_t{0};
+      auto active = __activemask();
+      if (active == kFullMask && __match_any_sync(kFullMask, gidx) == kFullMask) {
+        auto g = gpair.GetQuantisedGrad();
+        auto h = gpair.GetQuantisedHess();
+#pragma unroll
+        for (std::int32_t delta = kWarpSize / 2; delta > 0; delta /= 2) {
+          g += __shfl_xor_sync(kFullMask, g, delta);
+          h += __shfl_xor_sync(kFullMask, h, delta);
+        }
+        if (gidx != -1 && threadIdx.x % kWarpSize == 0) {
+          AtomicAddGpairShared(smem_arr_ + gidx - group_.start_bin, GradientPairInt64{g, h});
+        }
+        return;
+      }
+    }
+#endif  // __CUDA_ARCH__ >= 700
+    // Avoid atomic add if it's a null value.
+    if (gidx != -1) {
+      // Subtract start_bin to write to group-local histogram. If this is not a dense
+      // matrix, then start_bin is 0 since featuregrouping doesn't support sparse data.
+      AtomicAddGpairShared(smem_arr_ + gidx - group_.start_bin, gpair);
+    }
+  }
+
   __device__ void ProcessPartialTileShared(std::size_t offset) {
     for (std::size_t idx = offset + threadIdx.x,
                      n = std::min(offset + kBlockThreads * kItemsPerTile, n_elements_);
@@ -176,17 +214,17 @@ class HistogramAgent {
       Idx ridx = d_ridx_[idx / feature_stride_];
       auto fidx = FeatIdx(group_, idx, feature_stride_);
       bst_bin_t compressed_bin = matrix_.gidx_iter[IterIdx(matrix_, ridx, fidx)];
+      GradientPairInt64 adjusted;
       if (compressed_bin != matrix_.NullValue()) {
         // The matrix is compressed with feature-local bins.
         if (kCompressed) {
           compressed_bin += this->matrix_.feature_segments[fidx];
         }
-        // Avoid atomic add if it's a null value.
-        auto adjusted = rounding_.ToFixedPoint(d_gpair_[ridx]);
-        // Subtract start_bin to write to group-local histogram. If this is not a dense
-        // matrix, then start_bin is 0 since featuregrouping doesn't support sparse data.
-        AtomicAddGpairShared(smem_arr_ + compressed_bin - group_.start_bin, adjusted);
+        adjusted = rounding_.ToFixedPoint(d_gpair_[ridx]);
+      } else {
+        compressed_bin = -1;  // missing
       }
+      this->AddGpairShared(compressed_bin, adjusted);
     }
   }
 
@@ -221,14 +259,15 @@ class HistogramAgent {
     }
 #pragma unroll
     for (int i = 0; i < kItemsPerThread; i++) {
-      // Avoid atomic add if it's a null value.
-      if (gidx[i] != -1) {
-        auto adjusted = rounding_.ToFixedPoint(gpair[i]);
-        AtomicAddGpairShared(smem_arr_ + gidx[i] - group_.start_bin, adjusted);
-      }
+      this->AddGpairShared(gidx[i], gidx[i] != -1 ? rounding_.ToFixedPoint(gpair[i])
+                                                  : GradientPairInt64{});
     }
   }
   __device__ void BuildHistogramWithShared() {
+    if (blockIdx.x * kItemsPerTile >= n_elements_) {
+      // Launched for a larger node in the same batch, nothing to add.
+      return;
+    }
     dh::BlockFill(smem_arr_, group_.num_bins, GradientPairInt64{});
     __syncthreads();
 
@@ -262,19 +301,28 @@ class HistogramAgent {
   }
 };
 
+/**
+ * @brief Nodes built by a single kernel launch, one for each `blockIdx.z`. It's passed as a
+ *        kernel parameter to avoid copying the node information to the device.
+ */
+struct HistNodeBatch {
+  static constexpr std::int32_t kMaxNodes = 64;
+
+  common::Span<RowPartitioner::RowIndexT const> ridx[kMaxNodes];
+  GradientPairInt64* hist[kMaxNodes];
+};
+
 template <bool kIsDense, bool use_shared_memory_histograms, int kBlockThreads, int kItemsPerThread>
 __global__ void __launch_bounds__(kBlockThreads)
     SharedMemHistKernel(const EllpackDeviceAccessor matrix,
-                        const FeatureGroupsAccessor feature_groups,
-                        common::Span<const RowPartitioner::RowIndexT> d_ridx,
-                        GradientPairInt64* __restrict__ d_node_hist,
+                        const FeatureGroupsAccessor feature_groups, HistNodeBatch const nodes,
                         const GradientPair* __restrict__ d_gpair,
                         GradientQuantiser const rounding) {
   extern __shared__ char smem[];
   const FeatureGroup group = feature_groups[blockIdx.y];
   auto smem_arr = reinterpret_cast<GradientPairInt64*>(smem);
   auto agent = HistogramAgent<kIsDense, kBlockThreads, kItemsPerThread>(
-      smem_arr, d_node_hist, group, matrix, d_ridx, rounding, d_gpair);
+      smem_arr, nodes.hist[blockIdx.z], group, matrix, nodes.ridx[blockIdx.z], rounding, d_gpair);
   if (use_shared_memory_histograms) {
     agent.BuildHistogramWithShared();
   } else {
@@ -288,6 +336,27 @@ constexpr std::int32_t kItemsPerThread = 8;
 constexpr std::int32_t ItemsPerTile() { return kBlockThreads * kItemsPerThread; }
 }  // namespace
 
+std::size_t HistSharedMemBudget(DeviceOrd device) {
+  auto max_shared_memory = dh::MaxSharedMemoryOptin(device.ordinal);
+  std::int32_t max_threads = 0, smem_per_mp = 0, reserved = 0;
+  dh::safe_cuda(
+      cudaDeviceGetAttribute(&max_threads, cudaDevAttrMaxThreadsPerMultiProcessor, device.ordinal));
+  dh::safe_cuda(cudaDeviceGetAttribute(&smem_per_mp, cudaDevAttrMaxSharedMemoryPerMultiprocessor,
+                                       device.ordinal));
+  dh::safe_cuda(
+      cudaDeviceGetAttribute(&reserved, cudaDevAttrReservedSharedMemoryPerBlock, device.ordinal));
+  // Keep the number of resident blocks limited by threads instead of the shared memory.
+  auto n_blocks = max_threads / kBlockThreads;
+  if (n_blocks < 2) {
+    return max_shared_memory;
+  }
+  auto per_block = smem_per_mp / n_blocks - reserved;
+  if (per_block <= 0) {
+    return max_shared_memory;
+  }
+  return std::min(max_shared_memory, static_cast<std::size_t>(per_block));
+}
+
 // Use auto deduction guide to workaround compiler error.
 template <auto GlobalDense = SharedMemHistKernel<true, false, kBlockThreads, kItemsPerThread>,
           auto Global = SharedMemHistKernel<false, false, kBlockThreads, kItemsPerThread>,
@@ -362,42 +431,61 @@ class DeviceHistogramBuilderImpl {
   void BuildHistogram(CUDAContext const* ctx, EllpackDeviceAccessor const& matrix,
                       FeatureGroupsAccessor const& feature_groups,
                       common::Span<GradientPair const> gpair,
-                      common::Span<const cuda_impl::RowIndexT> d_ridx,
-                      common::Span<GradientPairInt64> histogram, GradientQuantiser rounding) const {
+                      common::Span<common::Span<const cuda_impl::RowIndexT> const> ridx,
+                      common::Span<common::Span<GradientPairInt64> const> histograms,
+                      GradientQuantiser rounding) const {
     CHECK(kernel_);
+    CHECK_EQ(ridx.size(), histograms.size());
     // Otherwise launch blocks such that each block has a minimum amount of work to do
     // There are fixed costs to launching each block, e.g. zeroing shared memory
     // The below amount of minimum work was found by experimentation
     int columns_per_group = common::DivRoundUp(matrix.row_stride, feature_groups.NumGroups());
-    // Average number of matrix elements processed by each group
-    std::size_t items_per_group = d_ridx.size() * columns_per_group;
-
-    // Allocate number of blocks such that each block has about kMinItemsPerBlock work
-    // Up to a maximum where the device is saturated
     auto constexpr kMinItemsPerBlock = ItemsPerTile();
-    auto grid_size = std::min(kernel_->grid_size, static_cast<std::uint32_t>(common::DivRoundUp(
-                                                      items_per_group, kMinItemsPerBlock)));
-    auto launcher = [&](auto kernel) {
-      dh::LaunchKernel{dim3(grid_size, feature_groups.NumGroups()),  // NOLINT
-                       static_cast<uint32_t>(kBlockThreads), kernel_->smem_size, ctx->Stream()}(
-          kernel, matrix, feature_groups, d_ridx, histogram.data(), gpair.data(), rounding);
-    };
 
-    if (!this->kernel_->shared) {  // Use global memory
-      CHECK_EQ(this->kernel_->smem_size, 0);
-      if (matrix.IsDenseCompressed()) {
-        // Dense must use shared memory except for testing.
-        CHECK(this->kernel_->force_global);
-        launcher(this->kernel_->global_dense_kernel);
-      } else {
-        launcher(this->kernel_->global_kernel);
+    auto constexpr kMaxNodes = static_cast<std::size_t>(HistNodeBatch::kMaxNodes);
+    for (std::size_t beg = 0; beg < ridx.size(); beg += kMaxNodes) {
+      auto n_nodes = std::min(ridx.size() - beg, kMaxNodes);
+      HistNodeBatch nodes{};
+      std::size_t max_n_rows = 0;
+      for (std::size_t i = 0; i < n_nodes; ++i) {
+        nodes.ridx[i] = ridx[beg + i];
+        nodes.hist[i] = histograms[beg + i].data();
+        max_n_rows = std::max(max_n_rows, ridx[beg + i].size());
       }
-    } else {  // Use shared memory
-      CHECK_NE(this->kernel_->smem_size, 0);
-      if (matrix.IsDenseCompressed()) {
-        launcher(this->kernel_->shared_dense_kernel);
-      } else {
-        launcher(this->kernel_->shared_kernel);
+      if (max_n_rows == 0) {
+        continue;
+      }
+      // Average number of matrix elements processed by each group of the largest node
+      std::size_t items_per_group = max_n_rows * columns_per_group;
+
+      // Allocate number of blocks such that each block has about kMinItemsPerBlock work
+      // Up to a maximum where the device is saturated
+      auto grid_size = std::min(kernel_->grid_size, static_cast<std::uint32_t>(common::DivRoundUp(
+                                                        items_per_group, kMinItemsPerBlock)));
+      auto launcher = [&](auto kernel) {
+        dim3 grid{grid_size, static_cast<std::uint32_t>(feature_groups.NumGroups()),
+                  static_cast<std::uint32_t>(n_nodes)};
+        dh::LaunchKernel{grid, static_cast<uint32_t>(kBlockThreads), kernel_->smem_size,
+                         ctx->Stream()}(
+            kernel, matrix, feature_groups, nodes, gpair.data(), rounding);
+      };
+
+      if (!this->kernel_->shared) {  // Use global memory
+        CHECK_EQ(this->kernel_->smem_size, 0);
+        if (matrix.IsDenseCompressed()) {
+          // Dense must use shared memory except for testing.
+          CHECK(this->kernel_->force_global);
+          launcher(this->kernel_->global_dense_kernel);
+        } else {
+          launcher(this->kernel_->global_kernel);
+        }
+      } else {  // Use shared memory
+        CHECK_NE(this->kernel_->smem_size, 0);
+        if (matrix.IsDenseCompressed()) {
+          launcher(this->kernel_->shared_dense_kernel);
+        } else {
+          launcher(this->kernel_->shared_kernel);
+        }
       }
     }
   }
@@ -427,7 +515,18 @@ void DeviceHistogramBuilder::BuildHistogram(CUDAContext const* ctx,
                                             common::Span<GradientPairInt64> histogram,
                                             GradientQuantiser rounding) {
   this->monitor_.Start(__func__);
-  this->p_impl_->BuildHistogram(ctx, matrix, feature_groups, gpair, ridx, histogram, rounding);
+  this->p_impl_->BuildHistogram(ctx, matrix, feature_groups, gpair, {&ridx, 1}, {&histogram, 1},
+                                rounding);
+  this->monitor_.Stop(__func__);
+}
+
+void DeviceHistogramBuilder::BuildHistogram(
+    CUDAContext const* ctx, EllpackDeviceAccessor const& matrix,
+    FeatureGroupsAccessor const& feature_groups, common::Span<GradientPair const> gpair,
+    std::vector<common::Span<const cuda_impl::RowIndexT>> const& ridx,
+    std::vector<common::Span<GradientPairInt64>> const& histograms, GradientQuantiser rounding) {
+  this->monitor_.Start(__func__);
+  this->p_impl_->BuildHistogram(ctx, matrix, feature_groups, gpair, ridx, histograms, rounding);
   this->monitor_.Stop(__func__);
 }
 
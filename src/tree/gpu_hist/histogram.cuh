@@ -3,7 +3,10 @@
  */
 #ifndef HISTOGRAM_CUH_
 #define HISTOGRAM_CUH_
-#include <memory>  // for unique_ptr
+#include <cstddef>  // for size_t
+#include <map>      // for map
+#include <memory>   // for unique_ptr
+#include <vector>   // for vector
 
 #include "../../common/cuda_context.cuh"    // for CUDAContext
 #include "../../common/device_helpers.cuh"  // for LaunchN
@@ -144,6 +147,15 @@ class DeviceHistogramStorage {
   }
 };
 
+/**
+ * @brief Size of the shared memory used for the histogram of each feature group.
+ *
+ *   It's the largest size that allows as many thread blocks as the threads permit to reside
+ *   on a multiprocessor, like two blocks on Ampere and Hopper. A feature with more bins
+ *   than the budget still uses the maximum opt-in size.
+ */
+[[nodiscard]] std::size_t HistSharedMemBudget(DeviceOrd device);
+
 class DeviceHistogramBuilderImpl;
 
 class DeviceHistogramBuilder {
@@ -163,6 +175,19 @@ class DeviceHistogramBuilder {
                       common::Span<GradientPair const> gpair,
                       common::Span<const std::uint32_t> ridx,
                       common::Span<GradientPairInt64> histogram, GradientQuantiser rounding);
+  /**
+   * @brief Build the histograms for a batch of nodes. Nodes are processed by the same
+   *        kernel launch, which saves the launch overhead when there are many small nodes.
+   *
+   * @param ridx       Rows of each node.
+   * @param histograms Output histogram for each node.
+   */
+  void BuildHistogram(CUDAContext const* ctx, EllpackDeviceAccessor const& matrix,
+                      FeatureGroupsAccessor const& feature_groups,
+                      common::Span<GradientPair const> gpair,
+                      std::vector<common::Span<const std::uint32_t>> const& ridx,
+                      std::vector<common::Span<GradientPairInt64>> const& histograms,
+                      GradientQuantiser rounding);
 
   [[nodiscard]] auto GetNodeHistogram(bst_node_t nidx) { return hist_.GetNodeHistogram(nidx); }
 
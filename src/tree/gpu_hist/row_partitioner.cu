@@ -14,7 +14,6 @@ void RowPartitioner::Reset(Context const* ctx, bst_idx_t n_samples, bst_idx_t ba
   ridx_segments_.clear();
   ridx_.resize(n_samples);
   ridx_tmp_.resize(n_samples);
-  tmp_.clear();
   n_nodes_ = 1;  // Root
 
   CHECK_LE(n_samples, std::numeric_limits<cuda_impl::RowIndexT>::max());
@@ -183,6 +183,98 @@ void SortPositionBatch(Context const* ctx, common::Span<const PerNodeData<OpData
       SortPositionCopyKernel<kBlockSize, OpDataT>, batch_info_itr, ridx, ridx_tmp, total_rows);
 }
 
+/**
+ * @brief Partition the rows with warp-level compaction.
+ *
+ *   Consecutive items of a warp that belong to the same node form a run. The decisions are
+ *   gathered with a ballot, then the first lane of each run reserves the space for the left
+ *   and right rows of the run with a single atomic operation for each side. The left rows
+ *   are written from the beginning of the segment and the right rows from the end. The
+ *   order of rows inside a node is not preserved.
+ */
+template <int kBlockSize, typename OpT, typename OpDataT>
+__global__ __launch_bounds__(kBlockSize) void PartitionPositionKernel(
+    dh::LDGIterator<PerNodeData<OpDataT>> batch_info,
+    common::Span<const cuda_impl::RowIndexT> d_ridx, common::Span<cuda_impl::RowIndexT> d_ridx_out,
+    common::Span<cuda_impl::RowIndexT> d_left_counts,
+    common::Span<cuda_impl::RowIndexT> d_right_counts, bst_idx_t total_rows, OpT op) {
+  std::int32_t constexpr kWarpSize = 32;
+  static_assert(kBlockSize % kWarpSize == 0);
+  auto constexpr kFullMask = ~std::uint32_t{0};
+  std::uint32_t lane = threadIdx.x % kWarpSize;
+  std::uint32_t lanemask_le = kFullMask >> (kWarpSize - 1 - lane);
+  // All lanes of a warp run the same number of iterations for the warp intrinsics.
+  auto n_items = common::DivRoundUp(total_rows, kWarpSize) * kWarpSize;
+  for (auto idx : dh::GridStrideRange<std::size_t>(0, n_items)) {
+    bool valid = idx < total_rows;
+    int batch_idx = -1;
+    std::size_t item_idx = 0;
+    bool go_left = false;
+    if (valid) {
+      AssignBatch(batch_info, idx, &batch_idx, &item_idx);
+      go_left = op(d_ridx[item_idx], batch_idx, batch_info[batch_idx].data);
+    }
+    auto active = __ballot_sync(kFullMask, valid);
+    auto left = __ballot_sync(kFullMask, go_left);
+    // Items are assigned to nodes in order, the lanes of a node are contiguous.
+    auto prev = __shfl_up_sync(kFullMask, batch_idx, 1);
+    auto head = __ballot_sync(kFullMask, lane == 0 || prev != batch_idx);
+    std::uint32_t run_begin = kWarpSize - 1 - __clz(head & lanemask_le);
+    auto next = head & ~lanemask_le;
+    std::uint32_t run_end = next == 0 ? kWarpSize : __ffs(next) - 1;
+    std::uint32_t run = (kFullMask >> (kWarpSize - run_end)) & ~((1u << run_begin) - 1);
+
+    auto run_left = left & run;
+    auto run_right = active & ~left & run;
+    cuda_impl::RowIndexT left_base = 0, right_base = 0;
+    if (valid && lane == run_begin) {
+      left_base = atomicAdd(&d_left_counts[batch_idx], __popc(run_left));
+      right_base = atomicAdd(&d_right_counts[batch_idx], __popc(run_right));
+    }
+    left_base = __shfl_sync(kFullMask, left_base, run_begin);
+    right_base = __shfl_sync(kFullMask, right_base, run_begin);
+
+    if (valid) {
+      auto lanemask_lt = lanemask_le >> 1;
+      Segment const& segment = batch_info[batch_idx].segment;
+      cuda_impl::RowIndexT scatter_address;
+      if (go_left) {
+        scatter_address = segment.begin + left_base + __popc(run_left & lanemask_lt);
+      } else {
+        scatter_address = segment.end - 1 - right_base - __popc(run_right & lanemask_lt);
+      }
+      d_ridx_out[scatter_address] = d_ridx[item_idx];
+    }
+  }
+}
+
+/**
+ * @brief Same as @ref SortPositionBatch, but uses warp-level compaction instead of a
+ *        segmented scan. There's no temporary storage for the scan.
+ *
+ * @param d_counts Number of rows going left for each node, must be initialized to 0.
+ */
+template <typename OpT, typename OpDataT>
+void PartitionPositionBatch(Context const* ctx,
+                            common::Span<const PerNodeData<OpDataT>> d_batch_info,
+                            common::Span<cuda_impl::RowIndexT> ridx,
+                            common::Span<cuda_impl::RowIndexT> ridx_tmp,
+                            common::Span<cuda_impl::RowIndexT> d_counts, bst_idx_t total_rows,
+                            OpT op) {
+  dh::LDGIterator<PerNodeData<OpDataT>> batch_info_itr(d_batch_info.data());
+  dh::TemporaryArray<cuda_impl::RowIndexT> d_right_counts(d_counts.size(), 0);
+
+  constexpr int kBlockSize = 256;
+  const int kItemsThread = 12;
+  std::uint32_t const kGridSize =
+      xgboost::common::DivRoundUp(total_rows, kBlockSize * kItemsThread);
+  dh::LaunchKernel{kGridSize, kBlockSize, 0, ctx->CUDACtx()->Stream()}(
+      PartitionPositionKernel<kBlockSize, OpT, OpDataT>, batch_info_itr, ridx, ridx_tmp,
+      d_counts, dh::ToSpan(d_right_counts), total_rows, op);
+  dh::LaunchKernel{kGridSize, kBlockSize, 0, ctx->CUDACtx()->Stream()}(
+      SortPositionCopyKernel<kBlockSize, OpDataT>, batch_info_itr, ridx, ridx_tmp, total_rows);
+}
+
 struct NodePositionInfo {
   Segment segment;
   bst_node_t left_child = -1;
@@ -251,7 +343,6 @@ class RowPartitioner {
   dh::DeviceUVector<RowIndexT> ridx_;
   // Staging area for sorting ridx
   dh::DeviceUVector<RowIndexT> ridx_tmp_;
-  dh::DeviceUVector<int8_t> tmp_;
   dh::PinnedMemory pinned_;
   dh::PinnedMemory pinned2_;
   bst_node_t n_nodes_{0};  // Counter for internal checks.
@@ -336,9 +427,9 @@ class RowPartitioner {
     dh::TemporaryArray<RowIndexT> d_counts(nidx.size(), 0);
 
     // Partition the rows according to the operator
-    SortPositionBatch<UpdatePositionOpT, OpDataT>(ctx, dh::ToSpan(d_batch_info), dh::ToSpan(ridx_),
-                                                  dh::ToSpan(ridx_tmp_), dh::ToSpan(d_counts),
-                                                  total_rows, op, &tmp_);
+    PartitionPositionBatch<UpdatePositionOpT, OpDataT>(ctx, dh::ToSpan(d_batch_info),
+                                                       dh::ToSpan(ridx_), dh::ToSpan(ridx_tmp_),
+                                                       dh::ToSpan(d_counts), total_rows, op);
     dh::safe_cuda(cudaMemcpyAsync(h_counts.data(), d_counts.data().get(), h_counts.size_bytes(),
                                   cudaMemcpyDefault, ctx->CUDACtx()->Stream()));
     // TODO(Rory): this synchronisation hurts performance a lot
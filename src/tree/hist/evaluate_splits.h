@@ -4,27 +4,30 @@
 #ifndef XGBOOST_TREE_HIST_EVALUATE_SPLITS_H_
 #define XGBOOST_TREE_HIST_EVALUATE_SPLITS_H_
 
-#include <algorithm>  // for copy
+#include <algorithm>  // for copy, nth_element, sort, transform
+#include <cmath>      // for isinf
 #include <cstddef>    // for size_t
+#include <cstdint>    // for int32_t
 #include <limits>     // for numeric_limits
 #include <memory>     // for shared_ptr
-#include <numeric>    // for accumulate
+#include <numeric>    // for accumulate, iota
 #include <utility>    // for move
 #include <vector>     // for vector
 
 #include "../../collective/allgather.h"
-#include "../../common/categorical.h"  // for CatBitField
-#include "../../common/hist_util.h"    // for GHistRow, HistogramCuts
-#include "../../common/linalg_op.h"    // for cbegin, cend, begin
-#include "../../common/random.h"       // for ColumnSampler
-#include "../constraints.h"            // for FeatureInteractionConstraintHost
-#include "../param.h"                  // for TrainParam
-#include "../split_evaluator.h"        // for TreeEvaluator
-#include "expand_entry.h"              // for MultiExpandEntry
-#include "hist_cache.h"                // for BoundedHistCollection
-#include "xgboost/base.h"              // for bst_node_t, bst_target_t, bst_feature_t
-#include "xgboost/context.h"           // for COntext
-#include "xgboost/linalg.h"            // for Constants, Vector
+#include "../../common/categorical.h"      // for CatBitField
+#include "../../common/hist_util.h"        // for GHistRow, HistogramCuts
+#include "../../common/linalg_op.h"        // for cbegin, cend, begin
+#include "../../common/random.h"           // for ColumnSampler
+#include "../../common/threading_utils.h"  // for ParallelFor, ThreadIdx
+#include "../constraints.h"                // for FeatureInteractionConstraintHost
+#include "../param.h"                      // for TrainParam
+#include "../split_evaluator.h"            // for TreeEvaluator
+#include "expand_entry.h"                  // for MultiExpandEntry
+#include "hist_cache.h"                    // for BoundedHistCollection
+#include "xgboost/base.h"                  // for bst_node_t, bst_target_t, bst_feature_t
+#include "xgboost/context.h"               // for COntext
+#include "xgboost/linalg.h"                // for Constants, Vector
 
 namespace xgboost::tree {
 /**
@@ -68,6 +71,37 @@ AllgatherColumnSplit(Context const *ctx, std::vector<ExpandEntry> const &entries
   return all_entries;
 }
 
+/**
+ * @brief Find the worker that owns the feature of the best split for each entry.
+ *
+ * @param all_entries Expand entries gathered from all workers by @ref AllgatherColumnSplit.
+ * @param p_entries   Expand entries with the global best splits.
+ */
+template <typename ExpandEntry>
+void SetSplitOwner(std::vector<ExpandEntry> const &all_entries,
+                   std::vector<ExpandEntry> *p_entries) {
+  auto &entries = *p_entries;
+  auto n_entries = entries.size();
+  if (n_entries == 0) {
+    return;
+  }
+  CHECK_EQ(all_entries.size() % n_entries, 0);
+  auto n_workers = all_entries.size() / n_entries;
+  for (std::size_t nidx_in_set = 0; nidx_in_set < n_entries; ++nidx_in_set) {
+    auto &entry = entries[nidx_in_set];
+    entry.split_owner = -1;
+    // All workers have the same gathered entries, pick the first match for ties.
+    for (std::size_t worker = 0; worker < n_workers; ++worker) {
+      auto const &candidate = all_entries[worker * n_entries + nidx_in_set].split;
+      if (candidate.SplitIndex() == entry.split.SplitIndex() &&
+          candidate.loss_chg == entry.split.loss_chg) {
+        entry.split_owner = static_cast<std::int32_t>(worker);
+        break;
+      }
+    }
+  }
+}
+
 class HistEvaluator {
  private:
   struct NodeEntry {
@@ -85,6 +119,17 @@ class HistEvaluator {
   bool is_col_split_{false};
   FeatureInteractionConstraintHost interaction_constraints_;
   std::vector<NodeEntry> snode_;
+  // Buffers for evaluating splits, reused between tree levels and iterations.
+  std::vector<std::shared_ptr<HostDeviceVector<bst_feature_t>>> features_;
+  // Sampled features allowed by the interaction constraints for each node.
+  std::vector<std::vector<bst_feature_t>> allowed_features_;
+  // Features evaluated for each node.
+  std::vector<common::Span<bst_feature_t const>> feature_sets_;
+  std::vector<CPUExpandEntry> tloc_candidates_;
+  // Sorted bins of a categorical feature for each thread.
+  std::vector<std::vector<std::size_t>> tloc_sorted_idx_;
+  // Weights of the bins of a categorical feature for each thread.
+  std::vector<std::vector<float>> tloc_cat_weights_;
 
   // if sum of statistics for non-missing values in the node
   // is equal to sum of statistics for all values:
@@ -253,6 +298,154 @@ class HistEvaluator {
     p_best->Update(best);
   }
 
+  /**
+   * @brief Order the bins of a categorical feature by their weights for `EnumeratePart`.
+   *
+   *   Only the first and the last `max_cat_threshold` bins are enumerated, the bins in
+   *   between are used as a set by the partition. Instead of sorting all the bins, they are
+   *   selected around the two boundaries and only the enumerated bins are sorted, which is
+   *   linear in the number of categories. Ties are broken by the bin index, the result is
+   *   the same as a stable sort of all the bins.
+   */
+  void SortCategories(common::ConstGHistRow feat_hist,
+                      TreeEvaluator::SplitEvaluator<TrainParam> const &evaluator,
+                      std::vector<std::size_t> *p_sorted_idx, std::vector<float> *p_weights) const {
+    auto n_bins = feat_hist.size();
+    auto &weights = *p_weights;
+    weights.resize(n_bins);
+    for (std::size_t i = 0; i < n_bins; ++i) {
+      weights[i] = evaluator.CalcWeightCat(*param_, feat_hist[i]);
+    }
+    auto &sorted_idx = *p_sorted_idx;
+    sorted_idx.resize(n_bins);
+    std::iota(sorted_idx.begin(), sorted_idx.end(), 0);
+    auto less = [&](std::size_t l, std::size_t r) {
+      return weights[l] < weights[r] || (weights[l] == weights[r] && l < r);
+    };
+    auto k = static_cast<std::size_t>(param_->max_cat_threshold);
+    auto beg = sorted_idx.begin(), end = sorted_idx.end();
+    if (2 * k >= n_bins) {
+      std::sort(beg, end, less);
+      return;
+    }
+    std::nth_element(beg, beg + k, end, less);
+    std::sort(beg, beg + k, less);
+    std::nth_element(beg + k, end - k, end, less);
+    std::sort(end - k, end, less);
+  }
+
+  /**
+   * @brief Buffers for the running sums and the gains of one feature.
+   */
+  struct ScanBuffer {
+    std::vector<double> grad;
+    std::vector<double> hess;
+    std::vector<float> gain;
+
+    void Resize(std::size_t n_bins) {
+      grad.resize(n_bins);
+      hess.resize(n_bins);
+      gain.resize(n_bins);
+    }
+  };
+
+  /**
+   * @brief Whether the gain can be computed from the sum of gradient alone, which is the
+   *        case without monotonic constraints and `max_delta_step`.
+   */
+  [[nodiscard]] bool UseFastScan(TreeEvaluator::SplitEvaluator<TrainParam> const &evaluator) const {
+    return !evaluator.has_constraint && param_->max_delta_step == 0.0f;
+  }
+
+  /**
+   * @brief Same as `EnumerateSplit`, but split into three loops to help the compiler.
+   *
+   * The running sums are computed first. Then the gains of all bins are computed in a
+   * loop without branches that can be vectorised. Lastly, the best bin is selected in the
+   * order of the scan. The arithmetic is the same as `CalcSplitGain`, only usable when
+   * `UseFastScan` returns true.
+   */
+  template <int d_step>
+  GradStats EnumerateSplitFast(common::HistogramCuts const &cut, common::ConstGHistRow hist,
+                               bst_feature_t fidx, bst_node_t nidx, ScanBuffer *p_buf,
+                               SplitEntry *p_best) const {
+    static_assert(d_step == +1 || d_step == -1, "Invalid step.");
+
+    auto const &cut_ptr = cut.Ptrs();
+    auto const &cut_val = cut.Values();
+    auto const &parent = snode_[nidx];
+
+    auto f_begin = static_cast<bst_bin_t>(cut_ptr[fidx]);
+    auto f_end = static_cast<bst_bin_t>(cut_ptr[fidx + 1]);
+    auto n_bins = static_cast<std::size_t>(f_end - f_begin);
+    // Bin index of the k^th step in the scan.
+    auto bin_at = [&](std::size_t k) {
+      return d_step > 0 ? f_begin + static_cast<bst_bin_t>(k)
+                        : f_end - 1 - static_cast<bst_bin_t>(k);
+    };
+
+    auto &buf = *p_buf;
+    buf.Resize(n_bins);
+    GradStats left_sum;
+    for (std::size_t k = 0; k < n_bins; ++k) {
+      auto i = bin_at(k);
+      left_sum.Add(hist[i].GetGrad(), hist[i].GetHess());
+      buf.grad[k] = left_sum.GetGrad();
+      buf.hess[k] = left_sum.GetHess();
+    }
+
+    double const parent_grad = parent.stats.GetGrad();
+    double const parent_hess = parent.stats.GetHess();
+    float const alpha = param_->reg_alpha;
+    float const lambda = param_->reg_lambda;
+    float const min_child_weight = param_->min_child_weight;
+    float const root_gain = parent.root_gain;
+    auto child_gain = [=](double g, double h) {
+      auto a = static_cast<float>(common::Sqr(ThresholdL1(g, alpha)));
+      auto b = static_cast<float>(h + lambda);
+      return h <= 0 ? 0.0f : a / b;
+    };
+    auto const *grad = buf.grad.data();
+    auto const *hess = buf.hess.data();
+    auto *gain = buf.gain.data();
+#pragma omp simd
+    for (std::size_t k = 0; k < n_bins; ++k) {
+      double rgrad = parent_grad - grad[k];
+      double rhess = parent_hess - hess[k];
+      float loss_chg = child_gain(grad[k], hess[k]) + child_gain(rgrad, rhess) - root_gain;
+      bool valid = hess[k] >= min_child_weight && rhess >= min_child_weight;
+      gain[k] = valid ? loss_chg : -std::numeric_limits<float>::infinity();
+    }
+
+    // Same as the sequential update of a split entry for one feature, the first best gain
+    // is selected and infinite gain is skipped.
+    SplitEntry best;
+    auto best_k = n_bins;
+    float best_gain = best.loss_chg;
+    for (std::size_t k = 0; k < n_bins; ++k) {
+      if (!std::isinf(gain[k]) && gain[k] > best_gain) {
+        best_gain = gain[k];
+        best_k = k;
+      }
+    }
+
+    if (best_k != n_bins) {
+      GradStats lsum{buf.grad[best_k], buf.hess[best_k]};
+      GradStats rsum;
+      rsum.SetSubstract(parent.stats, lsum);
+      auto i = bin_at(best_k);
+      if (d_step > 0) {
+        best.Update(best_gain, fidx, cut_val[i], false, false, lsum, rsum);
+      } else {
+        auto split_pt = i == f_begin ? cut.MinValues()[fidx] : cut_val[i - 1];
+        best.Update(best_gain, fidx, split_pt, true, false, rsum, lsum);
+      }
+    }
+
+    p_best->Update(best);
+    return left_sum;
+  }
+
   // Enumerate/Scan the split values of specific feature
   // Returns the sum of gradients corresponding to the data points that contains
   // a non-missing value for the particular feature fid.
@@ -327,69 +520,184 @@ class HistEvaluator {
     return left_sum;
   }
 
+  /**
+   * @brief Find the best split of a single feature.
+   */
+  void EvaluateFeature(common::HistogramCuts const &cut,
+                       common::Span<FeatureType const> feature_types,
+                       common::ConstGHistRow histogram, bst_feature_t fidx, bst_node_t nidx,
+                       TreeEvaluator::SplitEvaluator<TrainParam> const &evaluator, bool fast_scan,
+                       std::int32_t tidx, ScanBuffer *buf, SplitEntry *best) {
+    auto const &cut_ptrs = cut.Ptrs();
+    bool is_cat = common::IsCat(feature_types, fidx);
+    if (is_cat) {
+      auto n_bins = cut_ptrs.at(fidx + 1) - cut_ptrs[fidx];
+      if (common::UseOneHot(n_bins, param_->max_cat_to_onehot)) {
+        EnumerateOneHot(cut, histogram, fidx, nidx, evaluator, best);
+      } else {
+        auto &sorted_idx = tloc_sorted_idx_[tidx];
+        auto feat_hist = histogram.subspan(cut_ptrs[fidx], n_bins);
+        // Sort the histogram to get contiguous partitions.
+        this->SortCategories(feat_hist, evaluator, &sorted_idx, &tloc_cat_weights_[tidx]);
+        EnumeratePart<+1>(cut, sorted_idx, histogram, fidx, nidx, evaluator, best);
+        EnumeratePart<-1>(cut, sorted_idx, histogram, fidx, nidx, evaluator, best);
+      }
+    } else if (fast_scan) {
+      auto grad_stats = EnumerateSplitFast<+1>(cut, histogram, fidx, nidx, buf, best);
+      if (SplitContainsMissingValues(grad_stats, snode_[nidx])) {
+        EnumerateSplitFast<-1>(cut, histogram, fidx, nidx, buf, best);
+      }
+    } else {
+      auto grad_stats = EnumerateSplit<+1>(cut, histogram, fidx, nidx, evaluator, best);
+      if (SplitContainsMissingValues(grad_stats, snode_[nidx])) {
+        EnumerateSplit<-1>(cut, histogram, fidx, nidx, evaluator, best);
+      }
+    }
+  }
+
+  /**
+   * @brief Sample the features of each node, only the features allowed by the interaction
+   *        constraints are kept.
+   */
+  void SampleFeatureSets(RegTree const &tree, std::vector<CPUExpandEntry> const &entries) {
+    // All nodes are on the same level, so we can store the shared ptr.
+    auto &features = this->features_;
+    features.resize(entries.size());
+    allowed_features_.resize(entries.size());
+    feature_sets_.resize(entries.size());
+    std::vector<bst_node_t> depths(entries.size());
+    std::transform(entries.cbegin(), entries.cend(), depths.begin(),
+                   [&](auto const &e) { return tree.GetDepth(e.nid); });
+    column_sampler_->GetFeatureSets(depths, &features);
+    for (size_t nidx_in_set = 0; nidx_in_set < entries.size(); ++nidx_in_set) {
+      auto nidx = entries[nidx_in_set].nid;
+      // Only the features allowed by the interaction constraints are evaluated.
+      feature_sets_[nidx_in_set] = interaction_constraints_.Query(
+          features[nidx_in_set]->ConstHostSpan(), nidx, &allowed_features_[nidx_in_set]);
+    }
+    CHECK(!features.empty());
+  }
+
  public:
+  /**
+   * @brief Local top-k features of each node for the voting-parallel split finding.
+   *
+   *   The features are ranked by the gain of their best split, computed from the local
+   *   histograms and the local sum of the gradient of each node. The features are sampled
+   *   here, the following @ref EvaluateSplits with the result of the vote reuses them.
+   *
+   * @param local_hist Local histograms of the nodes.
+   * @param local_sums Local sum of the gradient of each node, indexed by the node.
+   */
+  [[nodiscard]] std::vector<std::vector<bst_feature_t>> VoteFeatures(
+      BoundedHistCollection const &local_hist, common::Span<GradientPairPrecise const> local_sums,
+      common::HistogramCuts const &cut, common::Span<FeatureType const> feature_types,
+      RegTree const &tree, std::vector<CPUExpandEntry> const &entries, std::size_t top_k) {
+    this->SampleFeatureSets(tree, entries);
+    auto n_threads = ctx_->Threads();
+    tloc_sorted_idx_.resize(n_threads);
+    tloc_cat_weights_.resize(n_threads);
+
+    // Evaluate the local splits with the local sums as the parent statistics.
+    std::vector<NodeEntry> global_snode(entries.size());
+    auto evaluator = tree_evaluator_.GetEvaluator();
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+      auto nidx = entries[i].nid;
+      global_snode[i] = snode_.at(nidx);
+      snode_[nidx].stats = GradStats{local_sums[nidx]};
+      snode_[nidx].root_gain = evaluator.CalcGain(nidx, *param_, snode_[nidx].stats);
+    }
+
+    std::vector<std::vector<float>> gains(entries.size());
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+      gains[i].resize(feature_sets_[i].size());
+    }
+    auto fast_scan = this->UseFastScan(evaluator);
+    common::BlockedSpace2d space(
+        entries.size(), [&](std::size_t i) { return feature_sets_[i].size(); }, 1);
+    common::ParallelFor2dStealing(space, n_threads, [&](std::size_t i, common::Range1d r) {
+      auto tidx = common::ThreadIdx();
+      ScanBuffer buf;
+      auto nidx = entries[i].nid;
+      auto histogram = local_hist[nidx];
+      for (auto k = r.begin(); k < r.end(); ++k) {
+        SplitEntry best;
+        this->EvaluateFeature(cut, feature_types, histogram, feature_sets_[i][k], nidx,
+                              evaluator, fast_scan, tidx, &buf, &best);
+        gains[i][k] = best.loss_chg;
+      }
+    });
+
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+      snode_[entries[i].nid] = global_snode[i];
+    }
+
+    std::vector<std::vector<bst_feature_t>> votes(entries.size());
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+      auto const &fset = feature_sets_[i];
+      std::vector<std::size_t> idx(fset.size());
+      std::iota(idx.begin(), idx.end(), 0);
+      auto n_votes = std::min(top_k, idx.size());
+      std::partial_sort(idx.begin(), idx.begin() + n_votes, idx.end(),
+                        [&](std::size_t l, std::size_t r) {
+                          return gains[i][l] > gains[i][r] || (gains[i][l] == gains[i][r] && l < r);
+                        });
+      votes[i].resize(n_votes);
+      for (std::size_t k = 0; k < n_votes; ++k) {
+        votes[i][k] = fset[idx[k]];
+      }
+    }
+    return votes;
+  }
+
+  /**
+   * @param voted The features selected by the vote for each node, see @ref VoteFeatures.
+   *              The features are sampled if it's empty.
+   */
   void EvaluateSplits(const BoundedHistCollection &hist, common::HistogramCuts const &cut,
                       common::Span<FeatureType const> feature_types, const RegTree &tree,
-                      std::vector<CPUExpandEntry> *p_entries) {
+                      std::vector<CPUExpandEntry> *p_entries,
+                      std::vector<std::vector<bst_feature_t>> const *voted = nullptr) {
     auto n_threads = ctx_->Threads();
     auto &entries = *p_entries;
-    // All nodes are on the same level, so we can store the shared ptr.
-    std::vector<std::shared_ptr<HostDeviceVector<bst_feature_t>>> features(entries.size());
-    for (size_t nidx_in_set = 0; nidx_in_set < entries.size(); ++nidx_in_set) {
-      auto nidx = entries[nidx_in_set].nid;
-      features[nidx_in_set] = column_sampler_->GetFeatureSet(tree.GetDepth(nidx));
+    if (voted) {
+      // The voted features are a subset of the features sampled by the vote.
+      CHECK_EQ(voted->size(), entries.size());
+      for (std::size_t i = 0; i < entries.size(); ++i) {
+        feature_sets_[i] = common::Span{(*voted)[i]};
+      }
+    } else {
+      this->SampleFeatureSets(tree, entries);
     }
-    CHECK(!features.empty());
-    const size_t grain_size = std::max<size_t>(1, features.front()->Size() / n_threads);
+    auto const &feature_sets = this->feature_sets_;
+    const size_t grain_size = std::max<size_t>(1, feature_sets.front().size() / n_threads);
     common::BlockedSpace2d space(
-        entries.size(), [&](size_t nidx_in_set) { return features[nidx_in_set]->Size(); },
+        entries.size(), [&](size_t nidx_in_set) { return feature_sets[nidx_in_set].size(); },
         grain_size);
 
-    std::vector<CPUExpandEntry> tloc_candidates(n_threads * entries.size());
+    auto &tloc_candidates = this->tloc_candidates_;
+    tloc_candidates.resize(n_threads * entries.size());
+    tloc_sorted_idx_.resize(n_threads);
+    tloc_cat_weights_.resize(n_threads);
     for (size_t i = 0; i < entries.size(); ++i) {
       for (decltype(n_threads) j = 0; j < n_threads; ++j) {
         tloc_candidates[i * n_threads + j] = entries[i];
       }
     }
     auto evaluator = tree_evaluator_.GetEvaluator();
-    auto const &cut_ptrs = cut.Ptrs();
+    auto fast_scan = this->UseFastScan(evaluator);
 
-    common::ParallelFor2d(space, n_threads, [&](size_t nidx_in_set, common::Range1d r) {
-      auto tidx = omp_get_thread_num();
+    common::ParallelFor2dStealing(space, n_threads, [&](size_t nidx_in_set, common::Range1d r) {
+      auto tidx = common::ThreadIdx();
+      ScanBuffer buf;
       auto entry = &tloc_candidates[n_threads * nidx_in_set + tidx];
       auto best = &entry->split;
       auto nidx = entry->nid;
       auto histogram = hist[nidx];
-      auto features_set = features[nidx_in_set]->ConstHostSpan();
+      auto features_set = feature_sets[nidx_in_set];
       for (auto fidx_in_set = r.begin(); fidx_in_set < r.end(); fidx_in_set++) {
-        auto fidx = features_set[fidx_in_set];
-        bool is_cat = common::IsCat(feature_types, fidx);
-        if (!interaction_constraints_.Query(nidx, fidx)) {
-          continue;
-        }
-        if (is_cat) {
-          auto n_bins = cut_ptrs.at(fidx + 1) - cut_ptrs[fidx];
-          if (common::UseOneHot(n_bins, param_->max_cat_to_onehot)) {
-            EnumerateOneHot(cut, histogram, fidx, nidx, evaluator, best);
-          } else {
-            std::vector<size_t> sorted_idx(n_bins);
-            std::iota(sorted_idx.begin(), sorted_idx.end(), 0);
-            auto feat_hist = histogram.subspan(cut_ptrs[fidx], n_bins);
-            // Sort the histogram to get contiguous partitions.
-            std::stable_sort(sorted_idx.begin(), sorted_idx.end(), [&](size_t l, size_t r) {
-              auto ret = evaluator.CalcWeightCat(*param_, feat_hist[l]) <
-                         evaluator.CalcWeightCat(*param_, feat_hist[r]);
-              return ret;
-            });
-            EnumeratePart<+1>(cut, sorted_idx, histogram, fidx, nidx, evaluator, best);
-            EnumeratePart<-1>(cut, sorted_idx, histogram, fidx, nidx, evaluator, best);
-          }
-        } else {
-          auto grad_stats = EnumerateSplit<+1>(cut, histogram, fidx, nidx, evaluator, best);
-          if (SplitContainsMissingValues(grad_stats, snode_[nidx])) {
-            EnumerateSplit<-1>(cut, histogram, fidx, nidx, evaluator, best);
-          }
-        }
+        this->EvaluateFeature(cut, feature_types, histogram, features_set[fidx_in_set], nidx,
+                              evaluator, fast_scan, tidx, &buf, best);
       }
     });
 
@@ -409,6 +717,7 @@ class HistEvaluator {
               all_entries[worker * entries.size() + nidx_in_set].split);
         }
       }
+      SetSplitOwner(all_entries, &entries);
     }
   }
 
@@ -497,6 +806,13 @@ class HistMultiEvaluator {
   std::shared_ptr<common::ColumnSampler> column_sampler_;
   Context const *ctx_;
   bool is_col_split_{false};
+  // Buffers for evaluating splits, reused between tree levels and iterations.
+  std::vector<std::shared_ptr<HostDeviceVector<bst_feature_t>>> features_;
+  // Sampled features allowed by the interaction constraints for each node.
+  std::vector<std::vector<bst_feature_t>> allowed_features_;
+  std::vector<MultiExpandEntry> tloc_candidates_;
+  // Histograms of the node being evaluated for each thread.
+  std::vector<std::vector<common::ConstGHistRow>> tloc_node_hist_;
 
  private:
   static double MultiCalcSplitGain(TrainParam const &param,
@@ -579,42 +895,52 @@ class HistMultiEvaluator {
   void EvaluateSplits(RegTree const &tree, common::Span<const BoundedHistCollection *> hist,
                       common::HistogramCuts const &cut, std::vector<MultiExpandEntry> *p_entries) {
     auto &entries = *p_entries;
-    std::vector<std::shared_ptr<HostDeviceVector<bst_feature_t>>> features(entries.size());
+    auto &features = this->features_;
+    features.resize(entries.size());
+    allowed_features_.resize(entries.size());
+    std::vector<common::Span<bst_feature_t const>> feature_sets(entries.size());
+    std::vector<bst_node_t> depths(entries.size());
+    std::transform(entries.cbegin(), entries.cend(), depths.begin(),
+                   [&](auto const &e) { return tree.GetDepth(e.nid); });
+    column_sampler_->GetFeatureSets(depths, &features);
 
     for (std::size_t nidx_in_set = 0; nidx_in_set < entries.size(); ++nidx_in_set) {
       auto nidx = entries[nidx_in_set].nid;
-      features[nidx_in_set] = column_sampler_->GetFeatureSet(tree.GetDepth(nidx));
+      feature_sets[nidx_in_set] = interaction_constraints_.Query(
+          features[nidx_in_set]->ConstHostSpan(), nidx, &allowed_features_[nidx_in_set]);
     }
     CHECK(!features.empty());
 
     std::int32_t n_threads = ctx_->Threads();
-    std::size_t const grain_size = std::max<std::size_t>(1, features.front()->Size() / n_threads);
+    std::size_t const grain_size =
+        std::max<std::size_t>(1, feature_sets.front().size() / n_threads);
     common::BlockedSpace2d space(
-        entries.size(), [&](std::size_t nidx_in_set) { return features[nidx_in_set]->Size(); },
+        entries.size(), [&](std::size_t nidx_in_set) { return feature_sets[nidx_in_set].size(); },
         grain_size);
 
-    std::vector<MultiExpandEntry> tloc_candidates(n_threads * entries.size());
+    auto &tloc_candidates = this->tloc_candidates_;
+    tloc_candidates.resize(n_threads * entries.size());
+    tloc_node_hist_.resize(n_threads);
     for (std::size_t i = 0; i < entries.size(); ++i) {
       for (std::int32_t j = 0; j < n_threads; ++j) {
         tloc_candidates[i * n_threads + j] = entries[i];
       }
     }
-    common::ParallelFor2d(space, n_threads, [&](std::size_t nidx_in_set, common::Range1d r) {
-      auto tidx = omp_get_thread_num();
+    common::ParallelFor2dStealing(space, n_threads, [&](std::size_t nidx_in_set,
+                                                        common::Range1d r) {
+      auto tidx = common::ThreadIdx();
       auto entry = &tloc_candidates[n_threads * nidx_in_set + tidx];
       auto best = &entry->split;
       auto parent_sum = stats_.Slice(entry->nid, linalg::All());
-      std::vector<common::ConstGHistRow> node_hist;
+      auto &node_hist = tloc_node_hist_[tidx];
+      node_hist.clear();
       for (auto t_hist : hist) {
         node_hist.emplace_back((*t_hist)[entry->nid]);
       }
-      auto features_set = features[nidx_in_set]->ConstHostSpan();
+      auto features_set = feature_sets[nidx_in_set];
 
       for (auto fidx_in_set = r.begin(); fidx_in_set < r.end(); fidx_in_set++) {
         auto fidx = features_set[fidx_in_set];
-        if (!interaction_constraints_.Query(entry->nid, fidx)) {
-          continue;
-        }
         auto parent_gain = gain_[entry->nid];
         bool missing =
             this->EnumerateSplit<+1>(cut, fidx, node_hist, parent_sum, parent_gain, best);
@@ -640,6 +966,7 @@ class HistMultiEvaluator {
               all_entries[worker * entries.size() + nidx_in_set].split);
         }
       }
+      SetSplitOwner(all_entries, &entries);
     }
   }
 
@@ -735,7 +1062,7 @@ void UpdatePredictionCacheImpl(Context const *ctx, RegTree const *p_last_tree,
     CHECK_EQ(part.Size(), n_nodes);
     common::BlockedSpace2d space(
         part.Size(), [&](size_t node) { return part[node].Size(); }, 1024);
-    common::ParallelFor2d(space, ctx->Threads(), [&](bst_node_t nidx, common::Range1d r) {
+    common::ParallelFor2dStealing(space, ctx->Threads(), [&](bst_node_t nidx, common::Range1d r) {
       if (!tree[nidx].IsDeleted() && tree[nidx].IsLeaf()) {
         auto const &rowset = part[nidx];
         auto leaf_value = tree[nidx].LeafValue();
@@ -770,12 +1097,11 @@ void UpdatePredictionCacheImpl(Context const *ctx, RegTree const *p_last_tree,
     CHECK_EQ(part.Size(), n_nodes);
     common::BlockedSpace2d space(
         part.Size(), [&](size_t node) { return part[node].Size(); }, 1024);
-    common::ParallelFor2d(space, ctx->Threads(), [&](bst_node_t nidx, common::Range1d r) {
+    common::ParallelFor2dStealing(space, ctx->Threads(), [&](bst_node_t nidx, common::Range1d r) {
       if (tree.IsLeaf(nidx)) {
         auto const &rowset = part[nidx];
         auto leaf_value = mttree->LeafValue(nidx);
-        for (bst_idx_t const *it = rowset.begin() + r.begin(); it < rowset.begin() + r.end();
-             ++it) {
+        for (auto const *it = rowset.begin() + r.begin(); it < rowset.begin() + r.end(); ++it) {
           for (std::size_t i = 0; i < n_targets; ++i) {
             out_preds(*it, i) += leaf_value(i);
           }
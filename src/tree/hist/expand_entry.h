@@ -5,6 +5,7 @@
 #define XGBOOST_TREE_HIST_EXPAND_ENTRY_H_
 
 #include <algorithm>    // for all_of
+#include <cstdint>      // for int32_t
 #include <ostream>      // for ostream
 #include <string>       // for string
 #include <type_traits>  // for add_const_t
@@ -24,6 +25,9 @@ template <typename Impl>
 struct ExpandEntryImpl {
   bst_node_t nid{0};
   bst_node_t depth{0};
+  // The worker that owns the split feature when the data is split by column, -1 if
+  // unknown. This is not serialized.
+  std::int32_t split_owner{-1};
 
   [[nodiscard]] float GetLossChange() const {
     return static_cast<Impl const*>(this)->split.loss_chg;
@@ -3,13 +3,18 @@
  */
 #ifndef XGBOOST_TREE_HIST_HIST_CACHE_H_
 #define XGBOOST_TREE_HIST_HIST_CACHE_H_
-#include <cstddef>  // for size_t
-#include <map>      // for map
-#include <memory>   // for unique_ptr
-#include <vector>   // for vector
+#include <algorithm>  // for copy_n, sort
+#include <cstddef>    // for size_t
+#include <cstdint>    // for int64_t
+#include <map>        // for map
+#include <memory>     // for unique_ptr
+#include <utility>    // for pair
+#include <vector>     // for vector
 
 #include "../../common/hist_util.h"          // for GHistRow, ConstGHistRow
+#include "../../common/memory_stats.h"       // for MemTagScope
 #include "../../common/ref_resource_view.h"  // for ReallocVector
+#include "../tree_telemetry.h"               // for CurrentTreeRecord
 #include "xgboost/base.h"                    // for bst_node_t, bst_bin_t
 #include "xgboost/logging.h"                 // for CHECK_EQ
 #include "xgboost/span.h"                    // for Span
@@ -44,6 +49,12 @@ class BoundedHistCollection {
   // whether the tree has grown beyond the cache limit
   bool has_exceeded_{false};
 
+  static void RecordEvictions(std::size_t n_nodes) {
+    if (auto* record = CurrentTreeRecord()) {
+      record->hist_evictions += static_cast<std::int64_t>(n_nodes);
+    }
+  }
+
  public:
   BoundedHistCollection() = default;
   common::GHistRow operator[](std::size_t idx) {
@@ -65,15 +76,60 @@ class BoundedHistCollection {
    * @brief Clear the cache, mark whether the cache is exceeded the limit.
    */
   void Clear(bool exceeded) {
+    if (exceeded) {
+      this->RecordEvictions(node_map_.size());
+    }
     node_map_.clear();
     current_size_ = 0;
     has_exceeded_ = exceeded;
   }
 
+  /**
+   * @brief Evict all histograms except for the ones of `nodes`, mark the cache as exceeded.
+   *
+   *   The remaining histograms are moved to the front of the buffer in their original
+   *   order, so that new allocations are still contiguous.
+   */
+  void Retain(common::Span<bst_node_t const> nodes) {
+    // offset, node index
+    std::vector<std::pair<std::size_t, bst_node_t>> kept;
+    for (auto nidx : nodes) {
+      auto it = node_map_.find(nidx);
+      if (it != node_map_.cend()) {
+        kept.emplace_back(it->second, nidx);
+      }
+    }
+    std::sort(kept.begin(), kept.end());
+    this->RecordEvictions(node_map_.size() - kept.size());
+    node_map_.clear();
+    current_size_ = 0;
+    has_exceeded_ = true;
+    for (auto const& [offset, nidx] : kept) {
+      CHECK_GE(offset, current_size_);
+      if (offset != current_size_) {
+        std::copy_n(data_->data() + offset, n_total_bins_, data_->data() + current_size_);
+      }
+      node_map_[nidx] = current_size_;
+      current_size_ += n_total_bins_;
+    }
+  }
+
   [[nodiscard]] bool CanHost(common::Span<bst_node_t const> nodes_to_build,
                              common::Span<bst_node_t const> nodes_to_sub) const {
     auto n_new_nodes = nodes_to_build.size() + nodes_to_sub.size();
-    return n_new_nodes + node_map_.size() <= max_cached_nodes_;
+    return this->CanHost(n_new_nodes + node_map_.size());
+  }
+  [[nodiscard]] bool CanHost(std::size_t n_nodes) const { return n_nodes <= max_cached_nodes_; }
+  /**
+   * @brief Indices of all nodes in the cache, in ascending order.
+   */
+  [[nodiscard]] std::vector<bst_node_t> CachedNodes() const {
+    std::vector<bst_node_t> nodes;
+    nodes.reserve(node_map_.size());
+    for (auto const& kv : node_map_) {
+      nodes.push_back(kv.first);
+    }
+    return nodes;
   }
 
   /**
@@ -88,6 +144,7 @@ class BoundedHistCollection {
     auto alloc_size = n_new_nodes * n_total_bins_;
     auto new_size = alloc_size + current_size_;
     if (new_size > data_->size()) {
+      common::MemTagScope scope{common::MemTag::kHistogram};
       data_->Resize(new_size);
     }
     for (auto nidx : nodes_to_build) {
@@ -1,18 +1,25 @@
 /**
- * Copyright 2023 by XGBoost Contributors
+ * Copyright 2023-2025, XGBoost Contributors
  */
 #include "histogram.h"
 
-#include <cstddef>  // for size_t
-#include <numeric>  // for accumulate
-#include <utility>  // for swap
-#include <vector>   // for vector
+#include <algorithm>  // for copy_n, fill, min, partial_sort, sort
+#include <cstddef>    // for size_t
+#include <cstdint>    // for int32_t
+#include <limits>     // for numeric_limits
+#include <map>        // for map
+#include <numeric>    // for accumulate
+#include <utility>    // for swap, pair
+#include <vector>     // for vector
 
-#include "../../common/transform_iterator.h"  // for MakeIndexTransformIter
-#include "expand_entry.h"                     // for MultiExpandEntry, CPUExpandEntry
-#include "xgboost/logging.h"                  // for CHECK_NE
-#include "xgboost/span.h"                     // for Span
-#include "xgboost/tree_model.h"               // for RegTree
+#include "../../collective/allgather.h"         // for Allgather
+#include "../../collective/allreduce.h"         // for Allreduce
+#include "../../collective/communicator-inl.h"  // for GetRank, GetWorldSize
+#include "../../common/transform_iterator.h"    // for MakeIndexTransformIter
+#include "expand_entry.h"                       // for MultiExpandEntry, CPUExpandEntry
+#include "xgboost/logging.h"                    // for CHECK_NE
+#include "xgboost/span.h"                       // for Span
+#include "xgboost/tree_model.h"                 // for RegTree
 
 namespace xgboost::tree {
 void AssignNodes(RegTree const *p_tree, std::vector<MultiExpandEntry> const &valid_candidates,
@@ -60,4 +67,97 @@ void AssignNodes(RegTree const *p_tree, std::vector<CPUExpandEntry> const &candi
     ++n_idx;
   }
 }
+
+void HistogramBuilder::ReduceVoted(Context const *ctx, common::HistogramCuts const &cut,
+                                   std::vector<bst_node_t> const &nodes,
+                                   std::vector<std::vector<bst_feature_t>> const &votes,
+                                   std::vector<std::vector<bst_feature_t>> *selected) {
+  CHECK(this->UseVoting());
+  CHECK_EQ(nodes.size(), votes.size());
+  auto top_k = this->voting_top_k_;
+  auto n_nodes = nodes.size();
+  /**
+   * Gather the votes from all workers, padded to k for each node.
+   */
+  constexpr auto kNoVote = std::numeric_limits<bst_feature_t>::max();
+  auto n_votes = n_nodes * top_k;
+  auto world = static_cast<std::size_t>(collective::GetWorldSize());
+  std::vector<bst_feature_t> all_votes(n_votes * world, kNoVote);
+  auto rank = static_cast<std::size_t>(collective::GetRank());
+  for (std::size_t i = 0; i < n_nodes; ++i) {
+    CHECK_LE(votes[i].size(), top_k);
+    std::copy_n(votes[i].cbegin(), votes[i].size(), all_votes.begin() + rank * n_votes + i * top_k);
+  }
+  auto rc = collective::Allgather(ctx, linalg::MakeVec(all_votes.data(), all_votes.size()));
+  collective::SafeColl(rc);
+
+  /**
+   * Select the features with the most votes, ties are broken by the feature index.
+   */
+  auto &out = *selected;
+  out.resize(n_nodes);
+  std::vector<std::pair<std::int32_t, bst_feature_t>> counts;
+  for (std::size_t i = 0; i < n_nodes; ++i) {
+    std::map<bst_feature_t, std::int32_t> n_voted;
+    for (std::size_t w = 0; w < world; ++w) {
+      for (std::size_t j = 0; j < top_k; ++j) {
+        auto fidx = all_votes[w * n_votes + i * top_k + j];
+        if (fidx != kNoVote) {
+          n_voted[fidx]++;
+        }
+      }
+    }
+    counts.clear();
+    for (auto const &kv : n_voted) {
+      counts.emplace_back(-kv.second, kv.first);
+    }
+    auto n_selected = std::min(counts.size(), top_k * 2);
+    std::partial_sort(counts.begin(), counts.begin() + n_selected, counts.end());
+    out[i].resize(n_selected);
+    for (std::size_t j = 0; j < n_selected; ++j) {
+      out[i][j] = counts[j].second;
+    }
+    std::sort(out[i].begin(), out[i].end());
+  }
+
+  /**
+   * Allreduce the bins of the selected features.
+   */
+  auto const &ptrs = cut.Ptrs();
+  auto &buf = this->voted_buf_;
+  buf.clear();
+  for (std::size_t i = 0; i < n_nodes; ++i) {
+    auto hist = this->hist_[nodes[i]];
+    for (auto fidx : out[i]) {
+      buf.insert(buf.end(), hist.data() + ptrs[fidx], hist.data() + ptrs[fidx + 1]);
+    }
+  }
+  if (quantiser_) {
+    // Same as the full histogram, reduce the quantised sums as integers.
+    fixed_buf_.resize(buf.size() * 2);
+    quantiser_->ToFixedPoint(ctx, common::Span{buf}, common::Span{fixed_buf_});
+    rc = collective::Allreduce(ctx, &fixed_buf_, collective::Op::kSum);
+    collective::SafeColl(rc);
+    quantiser_->ToFloatingPoint(ctx, common::Span{fixed_buf_}, common::Span{buf});
+  } else {
+    rc = collective::Allreduce(
+        ctx, linalg::MakeVec(reinterpret_cast<double *>(buf.data()), buf.size() * 2),
+        collective::Op::kSum);
+    collective::SafeColl(rc);
+  }
+
+  this->voted_hist_.Clear(false);
+  this->voted_hist_.AllocateHistograms(nodes);
+  std::size_t k = 0;
+  for (std::size_t i = 0; i < n_nodes; ++i) {
+    auto hist = this->voted_hist_[nodes[i]];
+    std::fill(hist.begin(), hist.end(), GradientPairPrecise{});
+    for (auto fidx : out[i]) {
+      auto n_bins = ptrs[fidx + 1] - ptrs[fidx];
+      std::copy_n(buf.cbegin() + k, n_bins, hist.begin() + ptrs[fidx]);
+      k += n_bins;
+    }
+  }
+  CHECK_EQ(k, buf.size());
+}
 }  // namespace xgboost::tree
@@ -1,28 +1,43 @@
 /**
- * Copyright 2021-2024, XGBoost Contributors
+ * Copyright 2021-2025, XGBoost Contributors
  */
 #ifndef XGBOOST_TREE_HIST_HISTOGRAM_H_
 #define XGBOOST_TREE_HIST_HISTOGRAM_H_
 
-#include <algorithm>   // for max
+#include <algorithm>   // for max, find
 #include <cstddef>     // for size_t
 #include <cstdint>     // for int32_t
+#include <functional>  // for cref, function
+#include <future>      // for future, promise
+#include <limits>      // for numeric_limits
+#include <memory>      // for unique_ptr, make_unique
+#include <numeric>     // for partial_sum
 #include <utility>     // for move
 #include <vector>      // for vector
 
-#include "../../collective/allreduce.h"    // for Allreduce
+#include "../../collective/allreduce.h"    // for SparseAllreduce
+#include "../../common/column_matrix.h"    // for ColumnMatrix
+#include "../../common/common.h"           // for DivRoundUp
+#include "../../common/feature_bundle.h"   // for FeatureBundles
 #include "../../common/hist_util.h"        // for GHistRow, ParallelGHi...
-#include "../../common/row_set.h"          // for RowSetCollection
+#include "../../common/perf_counter.h"     // for PerfScope
+#include "../../common/row_set.h"          // for RowSetCollectionImpl
+#include "../../common/threadpool.h"       // for ThreadPool
 #include "../../common/threading_utils.h"  // for ParallelFor2d, Range1d, BlockedSpace2d
+#include "../../common/trace.h"            // for TraceScope
 #include "../../data/gradient_index.h"     // for GHistIndexMatrix
+#include "../tree_telemetry.h"             // for PhaseTimer, CurrentTreeRecord
 #include "expand_entry.h"                  // for MultiExpandEntry, CPUExpandEntry
 #include "hist_cache.h"                    // for BoundedHistCollection
 #include "param.h"                         // for HistMakerTrainParam
+#include "quantiser.h"                     // for HistQuantiser
 #include "xgboost/base.h"                  // for bst_node_t, bst_target_t, bst_bin_t
 #include "xgboost/context.h"               // for Context
 #include "xgboost/data.h"                  // for BatchIterator, BatchSet
+#include "xgboost/global_config.h"         // for InitNewThread
 #include "xgboost/linalg.h"                // for MatrixView, All, Vect...
 #include "xgboost/logging.h"               // for CHECK_GE
+#include "xgboost/objective.h"             // for RowGradient
 #include "xgboost/span.h"                  // for Span
 #include "xgboost/tree_model.h"            // for RegTree
 
@@ -39,7 +54,22 @@ void AssignNodes(RegTree const *p_tree, std::vector<MultiExpandEntry> const &val
 void AssignNodes(RegTree const *p_tree, std::vector<CPUExpandEntry> const &candidates,
                  common::Span<bst_node_t> nodes_to_build, common::Span<bst_node_t> nodes_to_sub);
 
+/**
+ * @brief Gradient computed by the histogram builder during the root histogram pass. Each
+ *        block of rows is written into the gradient buffer right before its histogram is
+ *        built, while the block is still in cache.
+ */
+struct FusedGradient {
+  RowGradient const *fn{nullptr};
+  common::Span<GradientPair> out_gpair;
+};
+
 class HistogramBuilder {
+ public:
+  // Number of rows in each task of the space from @ref ConstructHistSpace.
+  static std::size_t constexpr kRowBlockSize = 256;
+
+ private:
   /*! \brief culmulative histogram of gradients. */
   BoundedHistCollection hist_;
   common::ParallelGHistBuilder buffer_;
@@ -48,6 +78,21 @@ class HistogramBuilder {
   // Whether XGBoost is running in distributed environment.
   bool is_distributed_{false};
   bool is_col_split_{false};
+  // Set when the gradient is quantised, used to allreduce the histogram as integers.
+  HistQuantiser const *quantiser_{nullptr};
+  std::vector<std::int32_t> fixed_buf_;
+  // Features sampled for the current tree, empty if all features are used.
+  std::vector<bst_feature_t> features_;
+  // Build the histogram of sparse pages from the exclusive feature bundles.
+  bool bundle_features_{false};
+  Context const *ctx_{nullptr};
+  // Number of features voted by each worker for each node, 0 if voting is not used.
+  std::size_t voting_top_k_{0};
+  // Local sum of the gradient of each node, only used for voting.
+  std::vector<GradientPairPrecise> local_sums_;
+  // Global histograms of the voted features for the nodes being evaluated.
+  BoundedHistCollection voted_hist_;
+  std::vector<GradientPairPrecise> voted_buf_;
 
  public:
   /**
@@ -56,34 +101,185 @@ class HistogramBuilder {
    * @param total_bins       Total number of bins across all features
    * @param is_distributed   Mostly used for testing to allow injecting parameters instead
    *                         of using global rabit variable.
+   * @param quantiser        The grid of the gradient if it's quantised, otherwise nullptr.
    */
   void Reset(Context const *ctx, bst_bin_t total_bins, BatchParam const &p, bool is_distributed,
-             bool is_col_split, HistMakerTrainParam const *param) {
+             bool is_col_split, HistMakerTrainParam const *param,
+             HistQuantiser const *quantiser = nullptr) {
     n_threads_ = ctx->Threads();
     param_ = p;
     hist_.Reset(total_bins, param->MaxCachedHistNodes(ctx->Device()));
     buffer_.Init(total_bins);
     is_distributed_ = is_distributed;
     is_col_split_ = is_col_split;
+    quantiser_ = quantiser;
+    features_.clear();
+    bundle_features_ = param->enable_feature_bundling;
+    ctx_ = ctx;
+    voting_top_k_ = 0;
+    local_sums_.clear();
+    voted_hist_.Reset(total_bins, std::numeric_limits<std::size_t>::max());
+  }
+  /**
+   * @brief Use the voting-parallel split finding from PV-Tree for row-split distributed
+   *        training. No-op if the histograms are not allreduced.
+   *
+   *   The histograms of the builder are kept local to each worker, including the ones
+   *   obtained by subtraction. For each node, the workers vote for their local top-k
+   *   features and only the histograms of the global top-2k features are allreduced by
+   *   @ref ReduceVoted.
+   */
+  void EnableVoting(std::size_t top_k) { voting_top_k_ = this->NeedAllreduce() ? top_k : 0; }
+  [[nodiscard]] bool UseVoting() const { return voting_top_k_ != 0; }
+  [[nodiscard]] std::size_t VotingTopK() const { return voting_top_k_; }
+  /**
+   * @brief Local sum of the gradient of each node, indexed by the node.
+   */
+  [[nodiscard]] std::vector<GradientPairPrecise> const &LocalSums() const { return local_sums_; }
+  [[nodiscard]] std::vector<GradientPairPrecise> &LocalSums() { return local_sums_; }
+  /**
+   * @brief Select the features with the most votes from all workers for each node and
+   *        allreduce their histograms into @ref VotedHistogram.
+   *
+   * @param nodes    The nodes being evaluated, their local histograms must exist.
+   * @param votes    Local top-k features of each node, at most @ref VotingTopK for each node.
+   * @param selected Output sorted global top-2k features of each node, the same on all
+   *                 workers.
+   */
+  void ReduceVoted(Context const *ctx, common::HistogramCuts const &cut,
+                   std::vector<bst_node_t> const &nodes,
+                   std::vector<std::vector<bst_feature_t>> const &votes,
+                   std::vector<std::vector<bst_feature_t>> *selected);
+  /**
+   * @brief Global histograms of the nodes passed to the last @ref ReduceVoted call, only the
+   *        bins of the selected features are valid.
+   */
+  [[nodiscard]] BoundedHistCollection const &VotedHistogram() const { return voted_hist_; }
+  /**
+   * @brief Only build the histogram for features sampled by `colsample_bytree`. The bins
+   *        of other features are left as zero since they are never evaluated in this tree.
+   *
+   * @param features Sorted feature indices.
+   */
+  void SetFeatureSet(common::Span<bst_feature_t const> features, bst_feature_t n_features) {
+    if (features.size() >= n_features || is_col_split_) {
+      features_.clear();
+    } else {
+      features_.assign(features.cbegin(), features.cend());
+    }
   }
 
-  template <bool any_missing>
+  template <bool any_missing, typename RowIdxT>
   void BuildLocalHistograms(common::BlockedSpace2d const &space, GHistIndexMatrix const &gidx,
                             std::vector<bst_node_t> const &nodes_to_build,
-                            common::RowSetCollection const &row_set_collection,
-                            common::Span<GradientPair const> gpair_h, bool force_read_by_column) {
+                            common::RowSetCollectionImpl<RowIdxT> const &row_set_collection,
+                            common::Span<GradientPair const> gpair_h, bool force_read_by_column,
+                            FusedGradient const *fused, common::FeatureBundles const *bundles,
+                            common::ColumnMatrix const *columns,
+                            common::Span<std::int8_t const> by_feature = {}) {
     // Parallel processing by nodes and data in each node
     common::ParallelFor2d(space, this->n_threads_, [&](size_t nid_in_set, common::Range1d r) {
-      const auto tid = static_cast<unsigned>(omp_get_thread_num());
+      if (!by_feature.empty() && by_feature[nid_in_set]) {
+        return;
+      }
+      const auto tid = static_cast<unsigned>(common::ThreadIdx());
       bst_node_t const nidx = nodes_to_build[nid_in_set];
       auto const& elem = row_set_collection[nidx];
       auto start_of_row_set = std::min(r.begin(), elem.Size());
       auto end_of_row_set = std::min(r.end(), elem.Size());
-      auto rid_set = common::Span<bst_idx_t const>{elem.begin() + start_of_row_set,
-                                                   elem.begin() + end_of_row_set};
+      auto rid_set = common::Span<RowIdxT const>{elem.begin() + start_of_row_set,
+                                                 elem.begin() + end_of_row_set};
       auto hist = buffer_.GetInitializedHist(tid, nid_in_set);
       if (rid_set.size() != 0) {
-        common::BuildHist<any_missing>(gpair_h, rid_set, gidx, hist, force_read_by_column);
+        if (fused) {
+          // The rows of the root are sorted and contiguous.
+          CHECK_EQ(rid_set.back() - rid_set.front() + 1, rid_set.size());
+          (*fused->fn)(rid_set.front(), rid_set.back() + 1, fused->out_gpair);
+        }
+        if (bundles) {
+          common::BuildHistBundled(gpair_h, rid_set, *bundles, hist);
+        } else if (columns) {
+          common::BuildHistColumns(gpair_h, rid_set, *columns, gidx.base_rowid, hist,
+                                   common::Span{features_});
+        } else {
+          common::BuildHist<any_missing>(gpair_h, rid_set, gidx, hist, force_read_by_column,
+                                         common::Span{features_});
+        }
+      }
+    });
+  }
+
+  /**
+   * @brief Choose the nodes of a dense page whose histograms are built by splitting the
+   *        features among the threads instead of the rows.
+   *
+   *   Deep in a tree, the nodes have only a few blocks of rows and most of the threads
+   *   would be idle. A node is built by feature blocks when it has fewer row blocks than
+   *   threads and the whole space doesn't have enough tasks to keep the threads busy.
+   *
+   * @return A flag for each node in `nodes_to_build`, empty if no node is selected.
+   */
+  template <typename RowIdxT>
+  [[nodiscard]] std::vector<std::int8_t> SelectByFeature(
+      common::BlockedSpace2d const &space, GHistIndexMatrix const &gidx,
+      std::vector<bst_node_t> const &nodes_to_build,
+      common::RowSetCollectionImpl<RowIdxT> const &row_set_collection) const {
+    auto n_threads = static_cast<std::size_t>(this->n_threads_);
+    auto n_features = features_.empty() ? gidx.Features() : features_.size();
+    if (n_threads == 1 || n_features < n_threads || space.Size() >= n_threads * 2) {
+      return {};
+    }
+    std::vector<std::int8_t> by_feature(nodes_to_build.size(), 0);
+    bool any{false};
+    for (std::size_t i = 0; i < nodes_to_build.size(); ++i) {
+      auto n_rows = row_set_collection[nodes_to_build[i]].Size();
+      if (n_rows != 0 && common::DivRoundUp(n_rows, kRowBlockSize) < n_threads) {
+        by_feature[i] = 1;
+        any = true;
+      }
+    }
+    return any ? by_feature : std::vector<std::int8_t>{};
+  }
+  /**
+   * @brief Build the histograms of the selected nodes over blocks of features. Each
+   *        feature owns a disjoint range of bins, so the threads write into the target
+   *        histogram directly without a reduction.
+   */
+  template <typename RowIdxT>
+  void BuildByFeature(GHistIndexMatrix const &gidx, std::vector<bst_node_t> const &nodes_to_build,
+                      common::RowSetCollectionImpl<RowIdxT> const &row_set_collection,
+                      common::Span<GradientPair const> gpair_h,
+                      common::ColumnMatrix const *columns,
+                      common::Span<std::int8_t const> by_feature) {
+    std::vector<bst_feature_t> features{features_};
+    if (features.empty()) {
+      features.resize(gidx.Features());
+      std::iota(features.begin(), features.end(), 0);
+    }
+    std::vector<std::size_t> nodes;
+    std::vector<common::GHistRow> hists;
+    for (std::size_t i = 0; i < by_feature.size(); ++i) {
+      if (by_feature[i]) {
+        nodes.push_back(i);
+        hists.push_back(buffer_.GetInitializedTargetHist(i));
+      }
+    }
+    // A few blocks for each thread to balance the features with different number of bins.
+    std::size_t constexpr kBlocksPerThread = 4;
+    auto n_blocks =
+        std::min(features.size(), static_cast<std::size_t>(this->n_threads_) * kBlocksPerThread);
+    auto block_size = common::DivRoundUp(features.size(), n_blocks);
+    common::BlockedSpace2d space{
+        nodes.size(), [&](std::size_t) { return features.size(); }, block_size};
+    common::ParallelFor2d(space, this->n_threads_, [&](std::size_t k, common::Range1d r) {
+      auto const &elem = row_set_collection[nodes_to_build[nodes[k]]];
+      auto rid_set = common::Span<RowIdxT const>{elem.begin(), elem.Size()};
+      auto feature_block = common::Span{features}.subspan(r.begin(), r.end() - r.begin());
+      if (columns) {
+        common::BuildHistColumns(gpair_h, rid_set, *columns, gidx.base_rowid, hists[k],
+                                 feature_block);
+      } else {
+        common::BuildHist<false>(gpair_h, rid_set, gidx, hists[k], false, feature_block);
       }
     });
   }
@@ -112,9 +308,15 @@ class HistogramBuilder {
     auto cache_is_valid = can_host && !this->hist_.HasExceeded();
 
     if (!can_host) {
-      this->hist_.Clear(true);
+      this->Evict(p_tree, nodes_to_build, nodes_to_sub);
     }
 
+    // Only the first builder decides which nodes are obtained by subtraction.
+    auto record_hits = [&] {
+      if (auto *record = CurrentTreeRecord(); record && rearrange) {
+        record->hist_hits += static_cast<std::int64_t>(nodes_to_sub.size());
+      }
+    };
     if (!rearrange || cache_is_valid) {
       // If not rearrange, we allocate the histogram as usual, assuming the nodes have
       // been properly arranged by other builders.
@@ -122,6 +324,7 @@ class HistogramBuilder {
       if (rearrange) {
         CHECK(!this->hist_.HasExceeded());
       }
+      record_hits();
       return;
     }
 
@@ -140,61 +343,288 @@ class HistogramBuilder {
 
     nodes_to_sub = std::move(can_subtract);
     this->hist_.AllocateHistograms(nodes_to_build, nodes_to_sub);
+    record_hits();
+  }
+
+  /**
+   * @brief Make room for the new nodes when the cache is full.
+   *
+   *   The histograms of the parents of the new nodes are kept first for the subtraction
+   *   trick, followed by the histograms of leaves that might be expanded later. The
+   *   histograms of other nodes are no longer needed. If even the parents don't fit, the
+   *   cache is cleared. The decision depends only on the tree and the parents, so it's the
+   *   same for all target builders even after the nodes are rearranged.
+   */
+  void Evict(RegTree const *p_tree, std::vector<bst_node_t> const &nodes_to_build,
+             std::vector<bst_node_t> const &nodes_to_sub) {
+    auto n_new_nodes = nodes_to_build.size() + nodes_to_sub.size();
+    std::vector<bst_node_t> keep;
+    for (auto const &nodes : {std::cref(nodes_to_build), std::cref(nodes_to_sub)}) {
+      for (auto nidx : nodes.get()) {
+        auto parent = p_tree->Parent(nidx);
+        if (this->hist_.HistogramExists(parent) &&
+            std::find(keep.cbegin(), keep.cend(), parent) == keep.cend()) {
+          keep.push_back(parent);
+        }
+      }
+    }
+    if (!this->hist_.CanHost(keep.size() + n_new_nodes)) {
+      this->hist_.Clear(true);
+      return;
+    }
+    for (auto nidx : this->hist_.CachedNodes()) {
+      if (!this->hist_.CanHost(keep.size() + n_new_nodes + 1)) {
+        break;
+      }
+      if (p_tree->IsLeaf(nidx)) {
+        keep.push_back(nidx);
+      }
+    }
+    this->hist_.Retain(keep);
+  }
+
+  /**
+   * @brief Add the local histogram cache to the parallel buffer before processing the
+   *        first page.
+   */
+  void InitBuffer(common::BlockedSpace2d const &space,
+                  std::vector<bst_node_t> const &nodes_to_build) {
+    auto n_nodes = nodes_to_build.size();
+    std::vector<common::GHistRow> target_hists(n_nodes);
+    for (size_t i = 0; i < n_nodes; ++i) {
+      auto const nidx = nodes_to_build[i];
+      target_hists[i] = hist_[nidx];
+    }
+    buffer_.Reset(this->n_threads_, n_nodes, space, target_hists);
+  }
+  [[nodiscard]] common::Span<bst_feature_t const> FeatureSet() const {
+    return common::Span{features_};
   }
 
   /** Main entry point of this class, build histogram for tree nodes. */
+  template <typename RowIdxT>
   void BuildHist(std::size_t page_idx, common::BlockedSpace2d const &space,
-                 GHistIndexMatrix const &gidx, common::RowSetCollection const &row_set_collection,
+                 GHistIndexMatrix const &gidx,
+                 common::RowSetCollectionImpl<RowIdxT> const &row_set_collection,
                  std::vector<bst_node_t> const &nodes_to_build,
-                 linalg::VectorView<GradientPair const> gpair, bool force_read_by_column = false) {
+                 linalg::VectorView<GradientPair const> gpair, bool force_read_by_column = false,
+                 FusedGradient const *fused = nullptr) {
+    common::TraceScope trace{common::TraceEvent::kBuildHist,
+                             static_cast<std::int64_t>(nodes_to_build.size())};
+    common::PerfScope perf{"HistogramBuilder::BuildHist"};
     CHECK(gpair.Contiguous());
 
     if (page_idx == 0) {
-      // Add the local histogram cache to the parallel buffer before processing the first page.
-      auto n_nodes = nodes_to_build.size();
-      std::vector<common::GHistRow> target_hists(n_nodes);
-      for (size_t i = 0; i < n_nodes; ++i) {
-        auto const nidx = nodes_to_build[i];
-        target_hists[i] = hist_[nidx];
-      }
-      buffer_.Reset(this->n_threads_, n_nodes, space, target_hists);
+      this->InitBuffer(space, nodes_to_build);
     }
 
     if (gidx.IsDense()) {
+      // Use the column matrix written with the external memory page if there's one.
+      common::ColumnMatrix const *columns = nullptr;
+      if (force_read_by_column || common::ReadByColumn(gidx.cut.TotalBins())) {
+        columns = &gidx.Transpose(ctx_);
+        columns = columns->IsInitialized() ? columns : nullptr;
+      }
+      std::vector<std::int8_t> by_feature;
+      if (!fused) {
+        by_feature = this->SelectByFeature(space, gidx, nodes_to_build, row_set_collection);
+      }
+      if (!by_feature.empty()) {
+        this->BuildByFeature(gidx, nodes_to_build, row_set_collection, gpair.Values(), columns,
+                             common::Span{by_feature});
+      }
       this->BuildLocalHistograms<false>(space, gidx, nodes_to_build, row_set_collection,
-                                        gpair.Values(), force_read_by_column);
+                                        gpair.Values(), force_read_by_column, fused, nullptr,
+                                        columns, common::Span{by_feature});
     } else {
+      common::FeatureBundles const *bundles = nullptr;
+      if (bundle_features_ && !force_read_by_column) {
+        bundles = &gidx.Bundles(ctx_);
+        bundles = bundles->IsBundled() ? bundles : nullptr;
+      }
       this->BuildLocalHistograms<true>(space, gidx, nodes_to_build, row_set_collection,
-                                       gpair.Values(), force_read_by_column);
+                                       gpair.Values(), force_read_by_column, fused, bundles,
+                                       nullptr);
     }
   }
 
-  void SyncHistogram(Context const *ctx, RegTree const *p_tree,
-                     std::vector<bst_node_t> const &nodes_to_build,
-                     std::vector<bst_node_t> const &nodes_to_trick) {
+  /**
+   * @brief Whether the histograms of `n_nodes` nodes can be built by @ref
+   *        BuildHistByPosition. Every thread holds a histogram for each node, the reduction
+   *        of which must be small compared to a pass over the bin indices of the page.
+   */
+  [[nodiscard]] bool CanBuildByPosition(GHistIndexMatrix const &gidx, std::size_t n_nodes) const {
     auto n_total_bins = buffer_.TotalBins();
-    common::BlockedSpace2d space(
-        nodes_to_build.size(), [&](std::size_t) { return n_total_bins; }, 1024);
+    if (bundle_features_ || is_distributed_ || common::ReadByColumn(n_total_bins)) {
+      return false;
+    }
+    auto n_tloc_bins = static_cast<double>(n_threads_) * static_cast<double>(n_nodes) *
+                       static_cast<double>(n_total_bins);
+    return n_tloc_bins * 2.0 <= static_cast<double>(gidx.index.Size());
+  }
+  /**
+   * @brief Build the histograms of `nodes_to_build` in a single pass over the rows of a
+   *        page, using the node of each row instead of the row partitions. Each block of
+   *        rows is grouped by the nodes and added to the thread-local histograms.
+   *
+   * @param position The node of each row in the page, negative if the row is not used.
+   */
+  template <typename RowIdxT>
+  void BuildHistByPosition(GHistIndexMatrix const &gidx, common::Span<bst_node_t const> position,
+                           std::vector<bst_node_t> const &nodes_to_build,
+                           linalg::VectorView<GradientPair const> gpair) {
+    common::TraceScope trace{common::TraceEvent::kBuildHist,
+                             static_cast<std::int64_t>(nodes_to_build.size())};
+    common::PerfScope perf{"HistogramBuilder::BuildHistByPosition"};
+    CHECK(gpair.Contiguous());
+    CHECK_EQ(position.size(), gidx.Size());
+    auto n_nodes = nodes_to_build.size();
+    std::vector<common::GHistRow> target_hists(n_nodes);
+    bst_node_t max_nidx{0};
+    for (std::size_t i = 0; i < n_nodes; ++i) {
+      target_hists[i] = hist_[nodes_to_build[i]];
+      max_nidx = std::max(max_nidx, nodes_to_build[i]);
+    }
+    buffer_.Reset(this->n_threads_, n_nodes, target_hists);
+    // The index of each node in `nodes_to_build`, -1 if the node is not built.
+    std::vector<std::int32_t> node_idx(max_nidx + 1, -1);
+    for (std::size_t i = 0; i < n_nodes; ++i) {
+      node_idx[nodes_to_build[i]] = static_cast<std::int32_t>(i);
+      // The first thread owns the target histograms, which are reduced into even if the
+      // thread doesn't get a block of the node.
+      buffer_.GetInitializedHist(0, i);
+    }
+
+    constexpr std::size_t kBlockSize = 2048;
+    auto n_rows = position.size();
+    std::vector<std::vector<RowIdxT>> tloc_rows(this->n_threads_);
+    std::vector<std::vector<std::size_t>> tloc_ptr(this->n_threads_);
+    auto h_gpair = gpair.Values();
+    common::ParallelFor(common::DivRoundUp(n_rows, kBlockSize), this->n_threads_,
+                        common::Sched::Dyn(), [&](auto k) {
+      auto tid = static_cast<std::size_t>(common::ThreadIdx());
+      auto &rows = tloc_rows[tid];
+      auto &ptr = tloc_ptr[tid];
+      rows.resize(kBlockSize);
+      ptr.resize(n_nodes + 1);
+      std::fill(ptr.begin(), ptr.end(), 0);
+      auto begin = k * kBlockSize;
+      auto end = std::min(n_rows, begin + kBlockSize);
+      auto idx = [&](std::size_t i) {
+        auto nidx = position[i];
+        return (nidx < 0 || nidx > max_nidx) ? -1 : node_idx[nidx];
+      };
+      // Group the rows of this block by the nodes.
+      for (auto i = begin; i < end; ++i) {
+        if (auto j = idx(i); j >= 0) {
+          ++ptr[j + 1];
+        }
+      }
+      std::partial_sum(ptr.cbegin(), ptr.cend(), ptr.begin());
+      for (auto i = begin; i < end; ++i) {
+        if (auto j = idx(i); j >= 0) {
+          rows[ptr[j]++] = static_cast<RowIdxT>(i + gidx.base_rowid);
+        }
+      }
+      // `ptr[j]` is now the end of the j^th node.
+      for (std::size_t j = 0; j < n_nodes; ++j) {
+        auto rbegin = j == 0 ? 0 : ptr[j - 1];
+        if (ptr[j] == rbegin) {
+          continue;
+        }
+        auto rid_set = common::Span<RowIdxT const>{rows.data() + rbegin, rows.data() + ptr[j]};
+        auto hist = buffer_.GetInitializedHist(tid, j);
+        if (gidx.IsDense()) {
+          common::BuildHist<false>(h_gpair, rid_set, gidx, hist, false, common::Span{features_});
+        } else {
+          common::BuildHist<true>(h_gpair, rid_set, gidx, hist, false, common::Span{features_});
+        }
+      }
+    });
+  }
+
+  /**
+   * @brief Merge the thread-local buffers for the first `n_nodes` nodes of the last
+   *        `BuildHist` call.
+   */
+  void ReduceLocal(std::size_t n_nodes) {
+    auto n_total_bins = buffer_.TotalBins();
+    common::BlockedSpace2d space(n_nodes, [&](std::size_t) { return n_total_bins; }, 1024);
     common::ParallelFor2d(space, this->n_threads_, [&](size_t node, common::Range1d r) {
       // Merging histograms from each thread.
       this->buffer_.ReduceHist(node, r.begin(), r.end());
     });
-    if (is_distributed_ && !is_col_split_) {
-      // The cache is contiguous, we can perform allreduce for all nodes in one go.
-      CHECK(!nodes_to_build.empty());
-      auto first_nidx = nodes_to_build.front();
-      std::size_t n = n_total_bins * nodes_to_build.size() * 2;
-      auto rc = collective::Allreduce(
-          ctx, linalg::MakeVec(reinterpret_cast<double *>(this->hist_[first_nidx].data()), n),
-          collective::Op::kSum);
-      SafeColl(rc);
-    }
-
-    common::BlockedSpace2d const &subspace =
-        nodes_to_trick.size() == nodes_to_build.size()
-            ? space
-            : common::BlockedSpace2d{nodes_to_trick.size(),
-                                     [&](std::size_t) { return n_total_bins; }, 1024};
+  }
+  /**
+   * @brief Prepare for the allreduce of `n_nodes` histograms. The buffer for quantised
+   *        histograms is allocated here so that it's not reallocated while an allreduce is
+   *        running in the background.
+   */
+  void InitAllreduce(std::size_t n_nodes) {
+    if (quantiser_) {
+      fixed_buf_.resize(buffer_.TotalBins() * n_nodes * 2);
+    }
+  }
+  /**
+   * @brief Allreduce the histograms of `n_nodes` contiguous nodes starting from
+   *        `first_nidx`. Must be followed by @ref FinishAllreduce.
+   *
+   * @param offset The position of the first node in the nodes passed to @ref InitAllreduce.
+   * @param pool   Run the allreduce on this pool if not null, otherwise it's blocking.
+   */
+  [[nodiscard]] std::future<collective::Result> StartAllreduce(Context const *ctx,
+                                                               common::ThreadPool *pool,
+                                                               bst_node_t first_nidx,
+                                                               std::size_t n_nodes,
+                                                               std::size_t offset) {
+    // The cache is contiguous, we can perform allreduce for all nodes in one go.
+    auto n_total_bins = buffer_.TotalBins();
+    std::size_t n = n_total_bins * n_nodes * 2;
+    auto run = [&](auto data) {
+      // Empty bins are not sent when the histograms are sparse. The global communicator
+      // is thread-local, it's passed to the pool explicitly.
+      auto const *comm = collective::GlobalCommGroup().get();
+      auto fn = [=] { return collective::SparseAllreduce(ctx, *comm, data); };
+      if (pool) {
+        return pool->Submit(fn);
+      }
+      std::promise<collective::Result> rc;
+      rc.set_value(fn());
+      return rc.get_future();
+    };
+    if (quantiser_) {
+      // The sums are exact integers on the grid of the quantiser, reduce them as 32-bit
+      // integers to halve the communication.
+      auto hist = common::Span{this->hist_[first_nidx].data(), n / 2};
+      CHECK_LE((offset + n_nodes) * n_total_bins * 2, fixed_buf_.size());
+      auto fixed = common::Span{fixed_buf_}.subspan(offset * n_total_bins * 2, n);
+      quantiser_->ToFixedPoint(ctx, hist, fixed);
+      return run(linalg::MakeVec(fixed.data(), n));
+    }
+    return run(linalg::MakeVec(reinterpret_cast<double *>(this->hist_[first_nidx].data()), n));
+  }
+  /**
+   * @brief Wait for the allreduce started by @ref StartAllreduce.
+   */
+  void FinishAllreduce(Context const *ctx, bst_node_t first_nidx, std::size_t n_nodes,
+                       std::size_t offset, std::future<collective::Result> *p_rc) {
+    collective::SafeColl(p_rc->get());
+    if (quantiser_) {
+      auto n_total_bins = buffer_.TotalBins();
+      auto hist = common::Span{this->hist_[first_nidx].data(), n_total_bins * n_nodes};
+      auto fixed = common::Span{fixed_buf_}.subspan(offset * n_total_bins * 2, hist.size() * 2);
+      quantiser_->ToFloatingPoint(ctx, fixed, hist);
+    }
+  }
+  /**
+   * @brief Obtain the histograms of `nodes_to_trick` by subtracting the siblings from
+   *        the parents.
+   */
+  void SubtractHist(RegTree const *p_tree, std::vector<bst_node_t> const &nodes_to_trick) {
+    PhaseTimer timer{TreePhase::kSubtraction};
+    auto n_total_bins = buffer_.TotalBins();
+    common::BlockedSpace2d subspace{nodes_to_trick.size(),
+                                    [&](std::size_t) { return n_total_bins; }, 1024};
     common::ParallelFor2d(
         subspace, this->n_threads_, [&](std::size_t nidx_in_set, common::Range1d r) {
           auto subtraction_nidx = nodes_to_trick[nidx_in_set];
@@ -208,6 +638,24 @@ class HistogramBuilder {
         });
   }
 
+  void SyncHistogram(Context const *ctx, RegTree const *p_tree,
+                     std::vector<bst_node_t> const &nodes_to_build,
+                     std::vector<bst_node_t> const &nodes_to_trick) {
+    this->ReduceLocal(nodes_to_build.size());
+    // With voting, the histograms are kept local and only the voted features are reduced.
+    if (this->NeedAllreduce() && !this->UseVoting()) {
+      PhaseTimer timer{TreePhase::kSync};
+      CHECK(!nodes_to_build.empty());
+      auto first_nidx = nodes_to_build.front();
+      this->InitAllreduce(nodes_to_build.size());
+      auto rc = this->StartAllreduce(ctx, nullptr, first_nidx, nodes_to_build.size(), 0);
+      this->FinishAllreduce(ctx, first_nidx, nodes_to_build.size(), 0, &rc);
+    }
+    this->SubtractHist(p_tree, nodes_to_trick);
+  }
+  // Whether the histograms need to be synchronised across workers.
+  [[nodiscard]] bool NeedAllreduce() const { return is_distributed_ && !is_col_split_; }
+
  public:
   /* Getters for tests. */
   [[nodiscard]] BoundedHistCollection const &Histogram() const { return hist_; }
@@ -233,7 +681,8 @@ common::BlockedSpace2d ConstructHistSpace(Partitioner const &partitioners,
     }
   }
   common::BlockedSpace2d space{
-      nodes_to_build.size(), [&](size_t nidx_in_set) { return partition_size[nidx_in_set]; }, 256};
+      nodes_to_build.size(), [&](size_t nidx_in_set) { return partition_size[nidx_in_set]; },
+      HistogramBuilder::kRowBlockSize};
   return space;
 }
 
@@ -243,17 +692,28 @@ common::BlockedSpace2d ConstructHistSpace(Partitioner const &partitioners,
 class MultiHistogramBuilder {
   std::vector<HistogramBuilder> target_builders_;
   Context const *ctx_;
+  // Histograms of all targets for each thread, used by the fused kernel.
+  std::vector<common::GHistRow> tloc_hists_;
+  // Worker for overlapping the histogram allreduce with the histogram build, only used
+  // in row-split distributed training.
+  std::unique_ptr<common::ThreadPool> sync_pool_;
+  static constexpr std::size_t kMaxSyncGroups = 4;
 
  public:
   /**
    * @brief Build the histogram for root node.
+   *
+   * @param fused Compute the gradient of each block of rows before building its histogram,
+   *              for a single target tree. The gradient in `gpair` is uninitialized.
    */
   template <typename Partitioner, typename ExpandEntry>
   void BuildRootHist(DMatrix *p_fmat, RegTree const *p_tree,
                      std::vector<Partitioner> const &partitioners,
                      linalg::MatrixView<GradientPair const> gpair, ExpandEntry const &best,
-                     BatchParam const &param, bool force_read_by_column = false) {
+                     BatchParam const &param, bool force_read_by_column = false,
+                     FusedGradient const *fused = nullptr) {
     auto n_targets = p_tree->NumTargets();
+    CHECK(!fused || n_targets == 1);
     CHECK_EQ(gpair.Shape(1), n_targets);
     CHECK_EQ(p_fmat->Info().num_row_, gpair.Shape(0));
     CHECK_EQ(target_builders_.size(), n_targets);
@@ -268,11 +728,17 @@ class MultiHistogramBuilder {
 
     std::size_t page_idx{0};
     for (auto const &gidx : p_fmat->GetBatches<GHistIndexMatrix>(ctx_, param)) {
+      if (this->UseFusedTargets(gpair, force_read_by_column)) {
+        this->BuildHistFused(page_idx, space, gidx, partitioners[page_idx].Partitions(), nodes,
+                             gpair);
+        ++page_idx;
+        continue;
+      }
       for (bst_target_t t{0}; t < n_targets; ++t) {
         auto t_gpair = gpair.Slice(linalg::All(), t);
         this->target_builders_[t].BuildHist(page_idx, space, gidx,
                                             partitioners[page_idx].Partitions(), nodes, t_gpair,
-                                            force_read_by_column);
+                                            force_read_by_column, fused);
       }
       ++page_idx;
     }
@@ -280,6 +746,7 @@ class MultiHistogramBuilder {
     for (bst_target_t t = 0; t < p_tree->NumTargets(); ++t) {
       this->target_builders_[t].SyncHistogram(ctx_, p_tree, nodes, dummy_sub);
     }
+    this->UpdateLocalSums(p_tree, partitioners, gpair, nodes, dummy_sub);
   }
   /**
    * @brief Build histogram for left and right child of valid candidates
@@ -304,13 +771,26 @@ class MultiHistogramBuilder {
       target_builders_[t].AddHistRows(p_tree, &nodes_to_build, &nodes_to_sub, false);
     }
 
+    if (sync_pool_ && partitioners.size() == 1 && nodes_to_build.size() > 1 &&
+        !this->UseVoting()) {
+      this->BuildHistOverlapped(ctx, p_fmat, p_tree, partitioners.front(), gpair, param,
+                                nodes_to_build, nodes_to_sub, force_read_by_column);
+      return;
+    }
+
     auto space = ConstructHistSpace(partitioners, nodes_to_build);
     std::size_t page_idx{0};
     for (auto const &page : p_fmat->GetBatches<GHistIndexMatrix>(ctx_, param)) {
       CHECK_EQ(gpair.Shape(1), p_tree->NumTargets());
+      CHECK_EQ(gpair.Shape(0), p_fmat->Info().num_row_);
+      if (this->UseFusedTargets(gpair, force_read_by_column)) {
+        this->BuildHistFused(page_idx, space, page, partitioners[page_idx].Partitions(),
+                             nodes_to_build, gpair);
+        page_idx++;
+        continue;
+      }
       for (bst_target_t t = 0; t < p_tree->NumTargets(); ++t) {
         auto t_gpair = gpair.Slice(linalg::All(), t);
-        CHECK_EQ(t_gpair.Shape(0), p_fmat->Info().num_row_);
         this->target_builders_[t].BuildHist(page_idx, space, page,
                                             partitioners[page_idx].Partitions(), nodes_to_build,
                                             t_gpair, force_read_by_column);
@@ -321,6 +801,188 @@ class MultiHistogramBuilder {
     for (bst_target_t t = 0; t < p_tree->NumTargets(); ++t) {
       this->target_builders_[t].SyncHistogram(ctx, p_tree, nodes_to_build, nodes_to_sub);
     }
+    this->UpdateLocalSums(p_tree, partitioners, gpair, nodes_to_build, nodes_to_sub);
+  }
+
+  /**
+   * @brief Build the histograms for the left and right child of valid candidates from the
+   *        node positions of a single page, see @ref HistogramBuilder::BuildHistByPosition.
+   *        Only single-target trees are supported.
+   */
+  template <typename Partitioner, typename ExpandEntry>
+  void BuildHistByPosition(Context const *ctx, DMatrix *p_fmat, RegTree const *p_tree,
+                           std::vector<Partitioner> const &partitioners,
+                           std::vector<ExpandEntry> const &valid_candidates,
+                           linalg::MatrixView<GradientPair const> gpair, BatchParam const &param) {
+    CHECK_EQ(target_builders_.size(), 1);
+    CHECK_EQ(partitioners.size(), 1);
+    auto const &partitioner = partitioners.front();
+    CHECK(partitioner.ByPosition());
+    std::vector<bst_node_t> nodes_to_build(valid_candidates.size());
+    std::vector<bst_node_t> nodes_to_sub(valid_candidates.size());
+    AssignNodes(p_tree, valid_candidates, nodes_to_build, nodes_to_sub);
+
+    auto &builder = target_builders_.front();
+    builder.AddHistRows(p_tree, &nodes_to_build, &nodes_to_sub, true);
+    for (auto const &page : p_fmat->GetBatches<GHistIndexMatrix>(ctx_, param)) {
+      using RowIdxT = typename Partitioner::RowIdxType;
+      builder.BuildHistByPosition<RowIdxT>(page, partitioner.Positions(), nodes_to_build,
+                                           gpair.Slice(linalg::All(), 0));
+    }
+    builder.SyncHistogram(ctx, p_tree, nodes_to_build, nodes_to_sub);
+  }
+
+  /**
+   * @brief Compute the local sum of the gradient for the new nodes when voting is used. The
+   *        sums of the built nodes are accumulated from the rows, the others are obtained by
+   *        subtraction like the histograms.
+   */
+  template <typename Partitioner>
+  void UpdateLocalSums(RegTree const *p_tree, std::vector<Partitioner> const &partitioners,
+                       linalg::MatrixView<GradientPair const> gpair,
+                       std::vector<bst_node_t> const &nodes_to_build,
+                       std::vector<bst_node_t> const &nodes_to_sub) {
+    if (!this->UseVoting()) {
+      return;
+    }
+    auto &sums = target_builders_.front().LocalSums();
+    sums.resize(p_tree->GetNodes().size());
+    auto t_gpair = gpair.Slice(linalg::All(), 0);
+    common::ParallelFor(nodes_to_build.size(), ctx_->Threads(), [&](std::size_t i) {
+      auto nidx = nodes_to_build[i];
+      GradientPairPrecise sum;
+      for (auto const &partitioner : partitioners) {
+        for (auto rid : partitioner.Partitions()[nidx]) {
+          sum += GradientPairPrecise{t_gpair(rid)};
+        }
+      }
+      sums[nidx] = sum;
+    });
+    for (auto nidx : nodes_to_sub) {
+      auto parent = p_tree->Parent(nidx);
+      auto sibling = p_tree->IsLeftChild(nidx) ? p_tree->RightChild(parent)
+                                               : p_tree->LeftChild(parent);
+      sums[nidx] = sums[parent] - sums[sibling];
+    }
+  }
+
+  /**
+   * @brief Build the histograms in groups of nodes for row-split distributed training
+   *        with a single page. The allreduce of a group runs in the background while the
+   *        next group is being built. Only one allreduce can be in flight at a time.
+   */
+  template <typename Partitioner>
+  void BuildHistOverlapped(Context const *ctx, DMatrix *p_fmat, RegTree const *p_tree,
+                           Partitioner const &partitioner,
+                           linalg::MatrixView<GradientPair const> gpair, BatchParam const &param,
+                           std::vector<bst_node_t> const &nodes_to_build,
+                           std::vector<bst_node_t> const &nodes_to_sub,
+                           bool force_read_by_column) {
+    auto n_nodes = nodes_to_build.size();
+    auto n_groups = std::min(n_nodes, kMaxSyncGroups);
+    auto group_size = common::DivRoundUp(n_nodes, n_groups);
+    for (auto &v : target_builders_) {
+      v.InitAllreduce(n_nodes);
+    }
+
+    std::future<collective::Result> in_flight;
+    std::function<void()> finish;
+    auto wait = [&] {
+      if (finish) {
+        PhaseTimer timer{TreePhase::kSync};
+        finish();
+        finish = nullptr;
+      }
+    };
+    for (auto const &page : p_fmat->GetBatches<GHistIndexMatrix>(ctx_, param)) {
+      CHECK_EQ(gpair.Shape(1), p_tree->NumTargets());
+      for (std::size_t beg = 0; beg < n_nodes; beg += group_size) {
+        auto end = std::min(beg + group_size, n_nodes);
+        std::vector<bst_node_t> group{nodes_to_build.cbegin() + beg,
+                                      nodes_to_build.cbegin() + end};
+        // The histogram cache is contiguous, so is a group.
+        auto space = ConstructHistSpace(common::Span{&partitioner, 1}, group);
+        for (bst_target_t t = 0; t < p_tree->NumTargets(); ++t) {
+          auto t_gpair = gpair.Slice(linalg::All(), t);
+          CHECK_EQ(t_gpair.Shape(0), p_fmat->Info().num_row_);
+          auto &builder = this->target_builders_[t];
+          builder.BuildHist(0, space, page, partitioner.Partitions(), group, t_gpair,
+                            force_read_by_column);
+          builder.ReduceLocal(group.size());
+          // Wait for the previous group before starting a new allreduce.
+          wait();
+          auto first_nidx = group.front();
+          in_flight =
+              builder.StartAllreduce(ctx, this->sync_pool_.get(), first_nidx, group.size(), beg);
+          finish = [&, &builder = builder, first_nidx, n = group.size(), beg] {
+            builder.FinishAllreduce(ctx, first_nidx, n, beg, &in_flight);
+          };
+        }
+      }
+    }
+    wait();
+
+    for (bst_target_t t = 0; t < p_tree->NumTargets(); ++t) {
+      this->target_builders_[t].SubtractHist(p_tree, nodes_to_sub);
+    }
+  }
+
+  // Whether the histograms of all targets are built in a single pass over the rows.
+  [[nodiscard]] bool UseFusedTargets(linalg::MatrixView<GradientPair const> gpair,
+                                     bool force_read_by_column) const {
+    return target_builders_.size() > 1 && !force_read_by_column && gpair.CContiguous();
+  }
+  /**
+   * @brief Build the histograms of all targets together with @ref
+   *        common::BuildHistMultiTarget. The thread-local buffers of the target builders
+   *        are used, so the reduction and the allreduce are the same as building each
+   *        target separately.
+   */
+  template <typename RowIdxT>
+  void BuildHistFused(std::size_t page_idx, common::BlockedSpace2d const &space,
+                      GHistIndexMatrix const &gidx,
+                      common::RowSetCollectionImpl<RowIdxT> const &row_set_collection,
+                      std::vector<bst_node_t> const &nodes_to_build,
+                      linalg::MatrixView<GradientPair const> gpair) {
+    common::TraceScope trace{common::TraceEvent::kBuildHist,
+                             static_cast<std::int64_t>(nodes_to_build.size())};
+    common::PerfScope perf{"MultiHistogramBuilder::BuildHistFused"};
+    auto n_targets = target_builders_.size();
+    if (page_idx == 0) {
+      for (auto &v : target_builders_) {
+        v.InitBuffer(space, nodes_to_build);
+      }
+    }
+    auto n_threads = ctx_->Threads();
+    tloc_hists_.resize(n_threads * n_targets);
+    auto features = target_builders_.front().FeatureSet();
+    auto h_gpair = gpair.Values();
+    common::ParallelFor2d(space, n_threads, [&](std::size_t nid_in_set, common::Range1d r) {
+      auto tid = static_cast<std::size_t>(common::ThreadIdx());
+      auto const &elem = row_set_collection[nodes_to_build[nid_in_set]];
+      auto start_of_row_set = std::min(r.begin(), elem.Size());
+      auto end_of_row_set = std::min(r.end(), elem.Size());
+      auto rid_set = common::Span<RowIdxT const>{elem.begin() + start_of_row_set,
+                                                 elem.begin() + end_of_row_set};
+      auto hists = common::Span{tloc_hists_}.subspan(tid * n_targets, n_targets);
+      for (std::size_t t = 0; t < n_targets; ++t) {
+        hists[t] = target_builders_[t].Buffer().GetInitializedHist(tid, nid_in_set);
+      }
+      if (rid_set.empty()) {
+        return;
+      }
+      if (gidx.IsDense()) {
+        common::BuildHistMultiTarget<false>(h_gpair, rid_set, gidx, hists, features);
+      } else {
+        common::BuildHistMultiTarget<true>(h_gpair, rid_set, gidx, hists, features);
+      }
+    });
+  }
+
+  void SetFeatureSet(common::Span<bst_feature_t const> features, bst_feature_t n_features) {
+    for (auto &v : target_builders_) {
+      v.SetFeatureSet(features, n_features);
+    }
   }
 
   [[nodiscard]] auto const &Histogram(bst_target_t t) const {
@@ -328,13 +990,34 @@ class MultiHistogramBuilder {
   }
   [[nodiscard]] auto &Histogram(bst_target_t t) { return target_builders_[t].Histogram(); }
 
+  /**
+   * @brief Enable voting for single-target trees, the multi-target trees always allreduce
+   *        the full histograms. Must be called after @ref Reset.
+   */
+  void EnableVoting(std::size_t top_k) {
+    if (target_builders_.size() == 1) {
+      target_builders_.front().EnableVoting(top_k);
+    }
+  }
+  [[nodiscard]] bool UseVoting() const { return target_builders_.front().UseVoting(); }
+  [[nodiscard]] HistogramBuilder &Builder(bst_target_t t) { return target_builders_[t]; }
+
   void Reset(Context const *ctx, bst_bin_t total_bins, bst_target_t n_targets, BatchParam const &p,
-             bool is_distributed, bool is_col_split, HistMakerTrainParam const *param) {
+             bool is_distributed, bool is_col_split, HistMakerTrainParam const *param,
+             HistQuantiser const *quantiser = nullptr) {
     ctx_ = ctx;
     target_builders_.resize(n_targets);
     CHECK_GE(n_targets, 1);
     for (auto &v : target_builders_) {
-      v.Reset(ctx, total_bins, p, is_distributed, is_col_split, param);
+      v.Reset(ctx, total_bins, p, is_distributed, is_col_split, param, quantiser);
+    }
+    if (target_builders_.front().NeedAllreduce()) {
+      if (!sync_pool_) {
+        sync_pool_ = std::make_unique<common::ThreadPool>(StringView{"hist-sync"}, 1,
+                                                          InitNewThread{});
+      }
+    } else {
+      sync_pool_.reset();
     }
   }
 };
@@ -1,9 +1,10 @@
 /**
- * Copyright 2021-2024, XGBoost Contributors
+ * Copyright 2021-2025, XGBoost Contributors
  */
 #pragma once
 
 #include <cstddef>  // for size_t
+#include <cstdint>  // for int32_t
 #include <limits>   // for numeric_limits
 
 #include "xgboost/parameter.h"   // for XGBoostParameter
@@ -24,6 +25,12 @@ struct HistMakerTrainParam : public XGBoostParameter<HistMakerTrainParam> {
 
   bool debug_synchronize{false};
   bool extmem_single_page{false};
+  bool quantise_gradient{false};
+  bool fuse_gradient{true};
+  float sketch_reuse_threshold{0.0f};
+  bool enable_feature_bundling{false};
+  std::size_t voting_top_k{0};
+  std::int32_t position_max_depth{0};
 
   void CheckTreesSynchronized(Context const* ctx, RegTree const* local_tree) const;
 
@@ -44,6 +51,34 @@ struct HistMakerTrainParam : public XGBoostParameter<HistMakerTrainParam> {
         .set_lower_bound(1)
         .describe("Maximum number of nodes in histogram cache.");
     DMLC_DECLARE_FIELD(extmem_single_page).set_default(false);
+    DMLC_DECLARE_FIELD(quantise_gradient)
+        .set_default(false)
+        .describe("Round the gradient to a fixed point grid for the CPU histogram.");
+    DMLC_DECLARE_FIELD(fuse_gradient)
+        .set_default(true)
+        .describe("Compute the gradient of elementwise objectives during the root histogram "
+                  "pass of the CPU hist method.");
+    DMLC_DECLARE_FIELD(sketch_reuse_threshold)
+        .set_default(0.0f)
+        .set_range(0.0f, 1.0f)
+        .describe("Reuse the quantile sketch of the approx method when the normalized "
+                  "hessian has changed less than this total variation distance.");
+    DMLC_DECLARE_FIELD(enable_feature_bundling)
+        .set_default(false)
+        .describe("Merge mutually exclusive sparse features into bundles for building the "
+                  "CPU histogram.");
+    DMLC_DECLARE_FIELD(voting_top_k)
+        .set_default(0)
+        .describe("Number of features voted by each worker for each node in row-split "
+                  "distributed training with the CPU hist method. Only the histograms of the "
+                  "2 * voting_top_k features with the most votes are allreduced. 0 disables "
+                  "voting.");
+    DMLC_DECLARE_FIELD(position_max_depth)
+        .set_default(0)
+        .set_lower_bound(0)
+        .describe("Build the CPU histograms of the nodes up to this depth in a single pass "
+                  "over the rows using the node of each row, without partitioning the rows. "
+                  "Only used by depthwise single-target trees on in-core data. 0 disables.");
   }
 };
 }  // namespace xgboost::tree
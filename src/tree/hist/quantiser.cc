@@ -0,0 +1,99 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include "quantiser.h"
+
+#include <algorithm>  // for max, clamp
+#include <array>      // for array
+#include <cmath>      // for frexp, ldexp, nearbyint
+#include <cstddef>    // for size_t
+#include <limits>     // for numeric_limits
+#include <vector>     // for vector
+
+#include "../../collective/aggregator.h"   // for GlobalSum
+#include "../../common/threading_utils.h"  // for ParallelFor
+#include "xgboost/logging.h"               // for CHECK
+
+namespace xgboost::tree {
+namespace {
+/**
+ * @brief Find the largest power of 2 such that the sum of `n` rounded values bounded by
+ *        `bound` fits into a 32-bit integer.
+ *
+ * Rounding each value adds at most 0.5 to the sum.
+ */
+double FixedPointFactor(double bound, double n) {
+  auto constexpr kMax = static_cast<double>(std::numeric_limits<std::int32_t>::max());
+  // Keep the grid representable in float.
+  std::int32_t constexpr kMinExp = -100, kMaxExp = 100;
+  std::int32_t exp{0};
+  std::frexp(bound, &exp);  // bound < 2^exp
+  auto k = std::clamp(30 - exp, kMinExp, kMaxExp);
+  while (k > kMinExp && std::ldexp(bound, k) + n / 2.0 > kMax) {
+    --k;
+  }
+  return std::ldexp(1.0, k);
+}
+}  // anonymous namespace
+
+HistQuantiser::HistQuantiser(Context const* ctx, MetaInfo const& info,
+                             linalg::MatrixView<GradientPair const> gpair) {
+  CHECK(gpair.Contiguous());
+  auto values = gpair.Values();
+  auto n_threads = ctx->Threads();
+  // Positive grad, negative grad, positive hess, negative hess for each thread.
+  std::vector<std::array<double, 4>> tloc(n_threads, std::array<double, 4>{});
+  common::ParallelFor(values.size(), n_threads, [&](std::size_t i) {
+    auto& sums = tloc[common::ThreadIdx()];
+    auto g = values[i].GetGrad(), h = values[i].GetHess();
+    sums[g < 0 ? 1 : 0] += std::abs(g);
+    sums[h < 0 ? 3 : 2] += std::abs(h);
+  });
+  // Sums and the number of rows.
+  std::array<double, 5> sums{};
+  for (auto const& v : tloc) {
+    for (std::size_t i = 0; i < v.size(); ++i) {
+      sums[i] += v[i];
+    }
+  }
+  sums[4] = static_cast<double>(gpair.Shape(0));
+  auto rc = collective::GlobalSum(ctx, info, linalg::MakeVec(sums.data(), sums.size()));
+  collective::SafeColl(rc);
+
+  to_fixed_point_ = GradientPairPrecise{FixedPointFactor(std::max(sums[0], sums[1]), sums[4]),
+                                        FixedPointFactor(std::max(sums[2], sums[3]), sums[4])};
+  to_floating_point_ = GradientPairPrecise{1.0 / to_fixed_point_.GetGrad(),
+                                           1.0 / to_fixed_point_.GetHess()};
+}
+
+void HistQuantiser::Quantise(Context const* ctx, linalg::MatrixView<GradientPair> gpair) const {
+  CHECK(gpair.Contiguous());
+  auto values = gpair.Values();
+  common::ParallelFor(values.size(), ctx->Threads(), [&](std::size_t i) {
+    auto g = std::nearbyint(values[i].GetGrad() * to_fixed_point_.GetGrad());
+    auto h = std::nearbyint(values[i].GetHess() * to_fixed_point_.GetHess());
+    // Multiplied by a power of 2, the result is still on the grid after being rounded to
+    // float.
+    values[i] = GradientPair{static_cast<float>(g * to_floating_point_.GetGrad()),
+                             static_cast<float>(h * to_floating_point_.GetHess())};
+  });
+}
+
+void HistQuantiser::ToFixedPoint(Context const* ctx, common::Span<GradientPairPrecise const> hist,
+                                 common::Span<std::int32_t> out) const {
+  CHECK_EQ(hist.size() * 2, out.size());
+  common::ParallelFor(hist.size(), ctx->Threads(), [&](std::size_t i) {
+    out[i * 2] = static_cast<std::int32_t>(hist[i].GetGrad() * to_fixed_point_.GetGrad());
+    out[i * 2 + 1] = static_cast<std::int32_t>(hist[i].GetHess() * to_fixed_point_.GetHess());
+  });
+}
+
+void HistQuantiser::ToFloatingPoint(Context const* ctx, common::Span<std::int32_t const> in,
+                                    common::Span<GradientPairPrecise> hist) const {
+  CHECK_EQ(hist.size() * 2, in.size());
+  common::ParallelFor(hist.size(), ctx->Threads(), [&](std::size_t i) {
+    hist[i] = GradientPairPrecise{in[i * 2] * to_floating_point_.GetGrad(),
+                                  in[i * 2 + 1] * to_floating_point_.GetHess()};
+  });
+}
+}  // namespace xgboost::tree
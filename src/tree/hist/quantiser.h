@@ -0,0 +1,60 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#ifndef XGBOOST_TREE_HIST_QUANTISER_H_
+#define XGBOOST_TREE_HIST_QUANTISER_H_
+
+#include <cstdint>  // for int32_t
+
+#include "xgboost/base.h"     // for GradientPair, GradientPairPrecise
+#include "xgboost/context.h"  // for Context
+#include "xgboost/data.h"     // for MetaInfo
+#include "xgboost/linalg.h"   // for MatrixView
+#include "xgboost/span.h"     // for Span
+
+namespace xgboost::tree {
+/**
+ * @brief Round the gradient onto a power-of-2 grid for the CPU histogram.
+ *
+ * Unlike the GPU quantiser, the histogram is still accumulated in floating point. The
+ * step of the grid is chosen from the global sum of the gradient such that the sum of any
+ * subset of rows is an integer multiple of the step that fits into a 32-bit integer. As a
+ * result, all the sums in the histogram are exact, independent of the order of
+ * accumulation and the number of threads. In addition, the histogram can be allreduced
+ * as 32-bit integers instead of 64-bit floats.
+ */
+class HistQuantiser {
+  /* Convert gradient to fixed point representation. */
+  GradientPairPrecise to_fixed_point_{1.0, 1.0};
+  /* Convert fixed point representation back to floating point. */
+  GradientPairPrecise to_floating_point_{1.0, 1.0};
+
+ public:
+  HistQuantiser() = default;
+  /**
+   * @brief Choose the grid from all the targets of the gradient.
+   */
+  HistQuantiser(Context const* ctx, MetaInfo const& info,
+                linalg::MatrixView<GradientPair const> gpair);
+  /**
+   * @brief Round the gradient to the nearest point on the grid.
+   */
+  void Quantise(Context const* ctx, linalg::MatrixView<GradientPair> gpair) const;
+  /**
+   * @brief Convert a histogram built from quantised gradient into fixed point.
+   *
+   * @param hist Histogram with grad and hess interleaved.
+   * @param out  Output fixed point values, with the same layout as the histogram.
+   */
+  void ToFixedPoint(Context const* ctx, common::Span<GradientPairPrecise const> hist,
+                    common::Span<std::int32_t> out) const;
+  /**
+   * @brief Convert the fixed point values back into a histogram.
+   */
+  void ToFloatingPoint(Context const* ctx, common::Span<std::int32_t const> in,
+                       common::Span<GradientPairPrecise> hist) const;
+
+  [[nodiscard]] GradientPairPrecise ToFixedPointFactor() const { return to_fixed_point_; }
+};
+}  // namespace xgboost::tree
+#endif  // XGBOOST_TREE_HIST_QUANTISER_H_
@@ -4,11 +4,15 @@
 #ifndef XGBOOST_TREE_HIST_SAMPLER_H_
 #define XGBOOST_TREE_HIST_SAMPLER_H_
 
-#include <cstddef>  // std::size-t
-#include <cstdint>  // std::uint64_t
-#include <random>   // bernoulli_distribution, linear_congruential_engine
+#include <cmath>       // for sqrt
+#include <cstddef>     // std::size-t
+#include <cstdint>     // std::uint64_t
+#include <random>      // bernoulli_distribution, linear_congruential_engine
+#include <vector>      // for vector
 
-#include "../../common/random.h"  // GlobalRandom
+#include "../../common/algorithm.h"        // for RadixSort
+#include "../../common/random.h"           // GlobalRandom
+#include "../../common/threading_utils.h"  // for ParallelFor, ParallelRegion
 #include "../param.h"             // TrainParam
 #include "xgboost/base.h"         // GradientPair
 #include "xgboost/context.h"      // Context
@@ -44,16 +48,126 @@ struct RandomReplace {
   }
 };
 
-// Only uniform sampling, no gradient-based yet.
+/**
+ * @brief Combine the gradient pair into a single value. The approach is based on Minimal
+ *        Variance Sampling (MVS) with lambda set to 0.1, same as the GPU sampler.
+ */
+inline float CombineGradientPair(GradientPair const& gpair) {
+  constexpr float kLambda = 0.1f;
+  return std::sqrt(gpair.GetGrad() * gpair.GetGrad() +
+                   kLambda * gpair.GetHess() * gpair.GetHess());
+}
+
+/**
+ * @brief Find the threshold `u` such that the expected number of sampled rows, which is
+ *        the sum of `min(1, v / u)`, equals to the number of rows to be sampled.
+ *
+ * @param p_values The combined gradient of each row, sorted in place.
+ *
+ * @return 0 if all rows should be kept.
+ */
+inline float CalcSamplingThreshold(Context const* ctx, std::vector<float>* p_values,
+                                   double n_sampled) {
+  auto& values = *p_values;
+  common::RadixSort(ctx, common::Span{values});
+  auto n_samples = static_cast<double>(values.size());
+  // Rows before `i` are sampled with probability `v / u`, others are always kept.
+  double sum = 0.0;
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    sum += values[i];
+    auto n_kept = n_sampled - n_samples + static_cast<double>(i) + 1.0;
+    if (n_kept <= 0.0) {
+      continue;
+    }
+    auto u = sum / n_kept;
+    if (u > values[i] && (i + 1 == values.size() || u <= values[i + 1])) {
+      return static_cast<float>(u);
+    }
+  }
+  return 0.0f;
+}
+
+/**
+ * @brief Run `fn(i, eng)` for each row with a random engine that doesn't depend on the
+ *        number of threads. The function must draw exactly one number for each row.
+ */
+template <typename Fn>
+void ForEachRowRandom(Context const* ctx, bst_idx_t n_samples, Fn&& fn) {
+  auto& rnd = common::GlobalRandom();
+#if XGBOOST_CUSTOMIZE_GLOBAL_PRNG
+  for (bst_idx_t i = 0; i < n_samples; ++i) {
+    fn(i, rnd);
+  }
+#else
+  std::uint64_t initial_seed = rnd();
+
+  auto n_threads = static_cast<size_t>(ctx->Threads());
+  std::size_t const discard_size = n_samples / n_threads;
+
+  common::ParallelRegion(n_threads, [&](std::size_t tid) {
+    const size_t ibegin = tid * discard_size;
+    const size_t iend = (tid == (n_threads - 1)) ? n_samples : ibegin + discard_size;
+
+    const uint64_t displaced_seed = RandomReplace::SimpleSkip(
+        ibegin, initial_seed, RandomReplace::kBase, RandomReplace::kMod);
+    RandomReplace::EngineT eng(displaced_seed);
+    for (std::size_t i = ibegin; i < iend; ++i) {
+      fn(i, eng);
+    }
+  });
+#endif  // XGBOOST_CUSTOMIZE_GLOBAL_PRNG
+}
+
+/**
+ * @brief Gradient-based sampling. Rows with large gradient are always kept, others are
+ *        selected with probability proportional to the combined gradient and scaled by the
+ *        inverse of the probability.
+ */
+inline void SampleGradientBased(Context const* ctx, TrainParam const& param,
+                                linalg::MatrixView<GradientPair> out) {
+  bst_idx_t n_samples = out.Shape(0);
+  std::size_t n_targets = out.Shape(1);
+  auto combined = [&](std::size_t i) {
+    float v = 0.0f;
+    for (std::size_t j = 0; j < n_targets; ++j) {
+      auto c = CombineGradientPair(out(i, j));
+      v += c * c;
+    }
+    return std::sqrt(v);
+  };
+  std::vector<float> values(n_samples);
+  common::ParallelFor(n_samples, ctx->Threads(), [&](auto i) { values[i] = combined(i); });
+  auto u = CalcSamplingThreshold(ctx, &values, static_cast<double>(n_samples) * param.subsample);
+  if (u == 0.0f) {
+    return;
+  }
+
+  std::uniform_real_distribution<float> dist;
+  ForEachRowRandom(ctx, n_samples, [&](std::size_t i, auto& eng) {
+    auto r = dist(eng);
+    auto p = combined(i) / u;
+    if (p >= 1.0f) {
+      return;
+    }
+    for (std::size_t j = 0; j < n_targets; ++j) {
+      // Rows with empty gradient have zero probability.
+      out(i, j) = r < p ? out(i, j) / p : GradientPair{};
+    }
+  });
+}
+
 inline void SampleGradient(Context const* ctx, TrainParam param,
                            linalg::MatrixView<GradientPair> out) {
   CHECK(out.Contiguous());
-  CHECK_EQ(param.sampling_method, TrainParam::kUniform)
-      << "Only uniform sampling is supported, gradient-based sampling is only support by GPU Hist.";
-
   if (param.subsample >= 1.0) {
     return;
   }
+  if (param.sampling_method == TrainParam::kGradientBased) {
+    SampleGradientBased(ctx, param, out);
+    return;
+  }
+  CHECK_EQ(param.sampling_method, TrainParam::kUniform);
+
   bst_idx_t n_samples = out.Shape(0);
   auto& rnd = common::GlobalRandom();
 
@@ -72,36 +186,30 @@ inline void SampleGradient(Context const* ctx, TrainParam param,
   std::size_t const discard_size = n_samples / n_threads;
   std::bernoulli_distribution coin_flip(param.subsample);
 
-  dmlc::OMPException exc;
-#pragma omp parallel num_threads(n_threads)
-  {
-    exc.Run([&]() {
-      const size_t tid = omp_get_thread_num();
-      const size_t ibegin = tid * discard_size;
-      const size_t iend = (tid == (n_threads - 1)) ? n_samples : ibegin + discard_size;
-
-      const uint64_t displaced_seed = RandomReplace::SimpleSkip(
-          ibegin, initial_seed, RandomReplace::kBase, RandomReplace::kMod);
-      RandomReplace::EngineT eng(displaced_seed);
-      std::size_t n_targets = out.Shape(1);
-      if (n_targets > 1) {
-        for (std::size_t i = ibegin; i < iend; ++i) {
-          if (!coin_flip(eng)) {
-            for (std::size_t j = 0; j < n_targets; ++j) {
-              out(i, j) = GradientPair{};
-            }
+  common::ParallelRegion(n_threads, [&](std::size_t tid) {
+    const size_t ibegin = tid * discard_size;
+    const size_t iend = (tid == (n_threads - 1)) ? n_samples : ibegin + discard_size;
+
+    const uint64_t displaced_seed = RandomReplace::SimpleSkip(
+        ibegin, initial_seed, RandomReplace::kBase, RandomReplace::kMod);
+    RandomReplace::EngineT eng(displaced_seed);
+    std::size_t n_targets = out.Shape(1);
+    if (n_targets > 1) {
+      for (std::size_t i = ibegin; i < iend; ++i) {
+        if (!coin_flip(eng)) {
+          for (std::size_t j = 0; j < n_targets; ++j) {
+            out(i, j) = GradientPair{};
           }
         }
-      } else {
-        for (std::size_t i = ibegin; i < iend; ++i) {
-          if (!coin_flip(eng)) {
-            out(i, 0) = GradientPair{};
-          }
+      }
+    } else {
+      for (std::size_t i = ibegin; i < iend; ++i) {
+        if (!coin_flip(eng)) {
+          out(i, 0) = GradientPair{};
         }
       }
-    });
-  }
-  exc.Rethrow();
+    }
+  });
 #endif  // XGBOOST_CUSTOMIZE_GLOBAL_PRNG
 }
 }  // namespace tree
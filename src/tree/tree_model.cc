@@ -8,14 +8,21 @@
 #include <xgboost/json.h>
 #include <xgboost/tree_model.h>
 
-#include <cmath>
+#include <algorithm>  // for equal
+#include <array>      // for array
+#include <cmath>      // for isfinite
+#include <cstdlib>    // for abs
 #include <iomanip>
 #include <limits>
 #include <sstream>
-#include <type_traits>  // for is_floating_point_v
-
-#include "../common/categorical.h"  // for GetNodeCats
-#include "../common/common.h"       // for EscapeU8
+#include <string_view>  // for string_view
+#include <type_traits>  // for is_floating_point_v, is_same_v
+
+#include "../common/categorical.h"        // for GetNodeCats
+#include "../common/charconv.h"           // for to_chars, NumericLimits
+#include "../common/common.h"             // for EscapeU8
+#include "../common/io.h"                 // for AlignedResourceReadStream, AlignedFileWriteStream
+#include "../common/ref_resource_view.h"  // for ReadVec, WriteVec
 #include "../predictor/predict_fn.h"
 #include "io_utils.h"  // for GetElem
 #include "param.h"
@@ -32,38 +39,105 @@ DMLC_REGISTER_PARAMETER(TrainParam);
 }
 
 namespace {
+// Append the shortest representation of a float that round-trips. The digits come from
+// the Ryu printer in charconv.h, the layout follows iostream with the general format.
+void AppendFloat(float value, std::string* out) {
+  if (XGBOOST_EXPECT(!std::isfinite(value), false)) {
+    std::stringstream ss;
+    ss << value;
+    out->append(ss.str());
+    return;
+  }
+  std::array<char, NumericLimits<float>::kToCharsSize> buf;
+  auto ret = to_chars(buf.data(), buf.data() + buf.size(), value);
+  CHECK(ret.ec == std::errc());
+  // Scientific format "-d.dddE-x"
+  std::string_view str{buf.data(), static_cast<std::size_t>(ret.ptr - buf.data())};
+  auto epos = str.find('E');
+  CHECK_NE(epos, std::string_view::npos);
+  std::size_t i = 0;
+  if (str[0] == '-') {
+    out->push_back('-');
+    i = 1;
+  }
+  std::array<char, NumericLimits<float>::kToCharsSize> digits;
+  std::int32_t n_digits = 0;
+  for (; i < epos; ++i) {
+    if (str[i] != '.') {
+      digits[n_digits++] = str[i];
+    }
+  }
+  bool neg_exp = str[epos + 1] == '-';
+  std::int32_t exp = 0;
+  for (i = epos + 1 + neg_exp; i < str.size(); ++i) {
+    exp = exp * 10 + (str[i] - '0');
+  }
+  exp = neg_exp ? -exp : exp;
+
+  std::int32_t constexpr kFloatMaxPrecision = std::numeric_limits<float>::max_digits10;
+  if (exp < -4 || exp >= kFloatMaxPrecision) {
+    out->push_back(digits[0]);
+    if (n_digits > 1) {
+      out->push_back('.');
+      out->append(digits.data() + 1, n_digits - 1);
+    }
+    out->push_back('e');
+    out->push_back(exp < 0 ? '-' : '+');
+    auto abs_exp = std::abs(exp);
+    if (abs_exp < 10) {
+      out->push_back('0');
+    }
+    out->append(std::to_string(abs_exp));
+  } else if (exp < 0) {
+    out->append("0.");
+    out->append(-exp - 1, '0');
+    out->append(digits.data(), n_digits);
+  } else if (n_digits <= exp + 1) {
+    out->append(digits.data(), n_digits);
+    out->append(exp + 1 - n_digits, '0');
+  } else {
+    out->append(digits.data(), exp + 1);
+    out->push_back('.');
+    out->append(digits.data() + exp + 1, n_digits - exp - 1);
+  }
+}
+
 template <typename Float>
 std::enable_if_t<std::is_floating_point_v<Float>, std::string> ToStr(Float value) {
   int32_t constexpr kFloatMaxPrecision = std::numeric_limits<float>::max_digits10;
   static_assert(std::is_floating_point_v<Float>,
                 "Use std::to_string instead for non-floating point values.");
-  std::stringstream ss;
-  ss << std::setprecision(kFloatMaxPrecision) << value;
-  return ss.str();
+  if constexpr (std::is_same_v<Float, float>) {
+    std::string result;
+    AppendFloat(value, &result);
+    return result;
+  } else {
+    std::stringstream ss;
+    ss << std::setprecision(kFloatMaxPrecision) << value;
+    return ss.str();
+  }
 }
 
 template <typename Float>
 std::string ToStr(linalg::VectorView<Float> value, bst_target_t limit) {
-  int32_t constexpr kFloatMaxPrecision = std::numeric_limits<float>::max_digits10;
   static_assert(std::is_floating_point_v<Float>,
                 "Use std::to_string instead for non-floating point values.");
-  std::stringstream ss;
-  ss << std::setprecision(kFloatMaxPrecision);
   if (value.Size() == 1) {
-    ss << value(0);
-    return ss.str();
+    return ToStr(value(0));
   }
   CHECK_GE(limit, 2);
   auto n = std::min(static_cast<bst_target_t>(value.Size() - 1), limit - 1);
-  ss << "[";
+  std::string result{"["};
   for (std::size_t i = 0; i < n; ++i) {
-    ss << value(i) << ", ";
+    result += ToStr(value(i));
+    result += ", ";
   }
   if (value.Size() > limit) {
-    ss << "..., ";
+    result += "..., ";
   }
-  ss << value(value.Size() - 1) << "]";
-  return ss.str();
+  result += ToStr(value(value.Size() - 1));
+  result += "]";
+  return result;
 }
 }  // namespace
 /*!
@@ -981,6 +1055,73 @@ void RegTree::Save(dmlc::Stream* fo) const {
   }
 }
 
+bool RegTree::Read(common::AlignedResourceReadStream* fi) {
+  if (fi->Read(&param_, sizeof(param_)) != sizeof(param_)) {
+    return false;
+  }
+  CHECK_EQ(param_.size_leaf_vector, 1)
+      << "Multi-target tree is not supported by the mmap model format.";
+  p_mt_tree_.reset(nullptr);
+  split_categories_.clear();
+  if (!common::ReadVec(fi, &nodes_) || !common::ReadVec(fi, &stats_) ||
+      !common::ReadVec(fi, &split_types_) || !common::ReadVec(fi, &split_categories_) ||
+      !common::ReadVec(fi, &split_categories_segments_)) {
+    return false;
+  }
+  CHECK_EQ(static_cast<bst_node_t>(nodes_.size()), param_.num_nodes);
+  CHECK_EQ(static_cast<bst_node_t>(stats_.size()), param_.num_nodes);
+  CHECK_EQ(static_cast<bst_node_t>(split_types_.size()), param_.num_nodes);
+  CHECK_EQ(static_cast<bst_node_t>(split_categories_segments_.size()), param_.num_nodes);
+
+  deleted_nodes_.clear();
+  for (bst_node_t i = 1; i < param_.num_nodes; ++i) {
+    if (nodes_[i].IsDeleted()) {
+      deleted_nodes_.push_back(i);
+    }
+  }
+  CHECK_EQ(static_cast<bst_node_t>(deleted_nodes_.size()), param_.num_deleted);
+  return true;
+}
+
+namespace {
+template <typename T>
+[[nodiscard]] bool SkipVec(common::AlignedResourceReadStream* fi) {
+  std::uint64_t n{0};
+  if (!fi->Read(&n)) {
+    return false;
+  }
+  if (n == 0) {
+    return true;
+  }
+  auto n_bytes = sizeof(T) * n;
+  return fi->Consume(n_bytes).second == n_bytes;
+}
+}  // anonymous namespace
+
+bool RegTree::Skip(common::AlignedResourceReadStream* fi) {
+  TreeParam param;
+  if (fi->Read(&param, sizeof(param)) != sizeof(param)) {
+    return false;
+  }
+  return SkipVec<Node>(fi) && SkipVec<RTreeNodeStat>(fi) && SkipVec<FeatureType>(fi) &&
+         SkipVec<std::uint32_t>(fi) && SkipVec<CategoricalSplitMatrix::Segment>(fi);
+}
+
+std::size_t RegTree::Write(common::AlignedFileWriteStream* fo) const {
+  CHECK(!IsMultiTarget()) << "Please use JSON/UBJSON for saving models with multi-target trees.";
+  CHECK_EQ(param_.num_nodes, static_cast<bst_node_t>(nodes_.size()));
+  CHECK_EQ(param_.num_nodes, static_cast<bst_node_t>(stats_.size()));
+
+  std::size_t bytes{0};
+  bytes += fo->Write(&param_, sizeof(param_));
+  bytes += common::WriteVec(fo, nodes_);
+  bytes += common::WriteVec(fo, stats_);
+  bytes += common::WriteVec(fo, split_types_);
+  bytes += common::WriteVec(fo, split_categories_);
+  bytes += common::WriteVec(fo, split_categories_segments_);
+  return bytes;
+}
+
 template <bool typed>
 void RegTree::LoadCategoricalSplit(Json const& in) {
   auto const& categories_segments = get<I64ArrayT<typed>>(in["categories_segments"]);
@@ -1138,10 +1279,179 @@ void LoadModelImpl(Json const& in, TreeParam const& param, std::vector<RTreeNode
   }
 }
 
+namespace {
+// Call `fn` with an integer array saved in any of the types chosen by `SaveIntArray`, or
+// with a JSON array for text models.
+template <typename Fn>
+void DispatchIntArray(Json const& in, Fn&& fn) {
+  if (IsA<U8Array>(in)) {
+    fn(get<U8Array const>(in));
+  } else if (IsA<I16Array>(in)) {
+    fn(get<I16Array const>(in));
+  } else if (IsA<I32Array>(in)) {
+    fn(get<I32Array const>(in));
+  } else if (IsA<I64Array>(in)) {
+    fn(get<I64Array const>(in));
+  } else {
+    fn(get<Array const>(in));
+  }
+}
+
+[[nodiscard]] std::vector<std::int64_t> LoadIntArray(Json const& in, std::size_t n_nodes) {
+  std::vector<std::int64_t> out(n_nodes);
+  DispatchIntArray(in, [&](auto const& arr) {
+    CHECK_EQ(arr.size(), n_nodes);
+    for (std::size_t i = 0; i < n_nodes; ++i) {
+      out[i] = GetElem<Integer>(arr, i);
+    }
+  });
+  return out;
+}
+
+// Save the integers in the smallest typed array that holds all of them.
+template <typename GetValue>
+[[nodiscard]] Json SaveIntArray(bst_node_t n_nodes, GetValue&& get_value) {
+  std::int64_t lo{0}, hi{0};
+  for (bst_node_t i = 0; i < n_nodes; ++i) {
+    std::int64_t v = get_value(i);
+    lo = std::min(lo, v);
+    hi = std::max(hi, v);
+  }
+  auto save = [&](auto&& arr) {
+    using T = typename std::remove_reference_t<decltype(arr)>::Type;
+    for (bst_node_t i = 0; i < n_nodes; ++i) {
+      arr.Set(i, static_cast<T>(get_value(i)));
+    }
+    return Json{std::move(arr)};
+  };
+  auto fits = [&](auto t) {
+    using T = decltype(t);
+    return lo >= std::numeric_limits<T>::min() && hi <= std::numeric_limits<T>::max();
+  };
+  if (fits(std::uint8_t{})) {
+    return save(U8Array(n_nodes));
+  } else if (fits(std::int16_t{})) {
+    return save(I16Array(n_nodes));
+  } else if (fits(std::int32_t{})) {
+    return save(I32Array(n_nodes));
+  }
+  return save(I64Array(n_nodes));
+}
+
+// Load a tree saved by `SaveServingModel`, the statistics are set to zero.
+void LoadServingModelImpl(Json const& in, TreeParam const& param,
+                          std::vector<RTreeNodeStat>* p_stats,
+                          std::vector<RegTree::Node>* p_nodes) {
+  namespace tf = tree_field;
+  auto& stats = *p_stats;
+  auto& nodes = *p_nodes;
+
+  auto n_nodes = static_cast<std::size_t>(param.num_nodes);
+  CHECK_NE(n_nodes, 0);
+  auto lefts = LoadIntArray(in[tf::kLeft], n_nodes);
+  auto rights = LoadIntArray(in[tf::kRight], n_nodes);
+  auto parents = LoadIntArray(in[tf::kParent], n_nodes);
+  auto indices = LoadIntArray(in[tf::kSplitIdx], n_nodes);
+  auto default_left = LoadIntArray(in[tf::kDftLeft], n_nodes);
+  std::vector<float> conds(n_nodes);
+  auto load_conds = [&](auto const& arr) {
+    CHECK_EQ(arr.size(), n_nodes);
+    for (std::size_t i = 0; i < n_nodes; ++i) {
+      conds[i] = GetElem<Number>(arr, i);
+    }
+  };
+  if (IsA<F32Array>(in[tf::kSplitCond])) {
+    load_conds(get<F32Array const>(in[tf::kSplitCond]));
+  } else {
+    load_conds(get<Array const>(in[tf::kSplitCond]));
+  }
+
+  stats = std::remove_reference_t<decltype(stats)>(n_nodes);
+  nodes = std::remove_reference_t<decltype(nodes)>(n_nodes);
+  for (std::size_t i = 0; i < n_nodes; ++i) {
+    nodes[i] = RegTree::Node{static_cast<bst_node_t>(lefts[i]), static_cast<bst_node_t>(rights[i]),
+                             static_cast<bst_node_t>(parents[i]),
+                             static_cast<bst_feature_t>(indices[i]), conds[i],
+                             default_left[i] == 1};
+  }
+}
+}  // anonymous namespace
+
+void RegTree::SaveStats(Json* p_out) const {
+  CHECK(!this->IsMultiTarget());
+  namespace tf = tree_field;
+  auto n_nodes = param_.num_nodes;
+  F32Array loss_changes(n_nodes);
+  F32Array sum_hessian(n_nodes);
+  F32Array base_weights(n_nodes);
+  for (bst_node_t i = 0; i < n_nodes; ++i) {
+    auto const& s = stats_[i];
+    loss_changes.Set(i, s.loss_chg);
+    sum_hessian.Set(i, s.sum_hess);
+    base_weights.Set(i, s.base_weight);
+  }
+  auto& out = *p_out;
+  out[tf::kLossChg] = std::move(loss_changes);
+  out[tf::kSumHess] = std::move(sum_hessian);
+  out[tf::kBaseWeight] = std::move(base_weights);
+}
+
+void RegTree::LoadStats(Json const& in) {
+  CHECK(!this->IsMultiTarget());
+  namespace tf = tree_field;
+  auto const& in_obj = get<Object const>(in);
+  if (in_obj.find(tf::kLossChg) == in_obj.cend()) {
+    // Saved for serving.
+    std::fill(stats_.begin(), stats_.end(), RTreeNodeStat{});
+    return;
+  }
+  auto n_nodes = static_cast<std::size_t>(param_.num_nodes);
+  auto load = [&](auto const& loss_changes, auto const& sum_hessian, auto const& base_weights) {
+    CHECK_EQ(loss_changes.size(), n_nodes);
+    CHECK_EQ(sum_hessian.size(), n_nodes);
+    CHECK_EQ(base_weights.size(), n_nodes);
+    for (std::size_t i = 0; i < n_nodes; ++i) {
+      auto& s = stats_[i];
+      s.loss_chg = GetElem<Number>(loss_changes, i);
+      s.sum_hess = GetElem<Number>(sum_hessian, i);
+      s.base_weight = GetElem<Number>(base_weights, i);
+    }
+  };
+  if (IsA<F32Array>(in[tf::kLossChg])) {
+    load(get<F32Array const>(in[tf::kLossChg]), get<F32Array const>(in[tf::kSumHess]),
+         get<F32Array const>(in[tf::kBaseWeight]));
+  } else {
+    load(get<Array const>(in[tf::kLossChg]), get<Array const>(in[tf::kSumHess]),
+         get<Array const>(in[tf::kBaseWeight]));
+  }
+}
+
+bool RegTree::SameSplits(RegTree const& that) const {
+  if (this->IsMultiTarget() || that.IsMultiTarget()) {
+    return false;
+  }
+  if (param_.num_feature != that.param_.num_feature || nodes_ != that.nodes_ ||
+      split_types_ != that.split_types_) {
+    return false;
+  }
+  auto cats = this->GetSplitCategories();
+  auto that_cats = that.GetSplitCategories();
+  if (!std::equal(cats.cbegin(), cats.cend(), that_cats.cbegin(), that_cats.cend())) {
+    return false;
+  }
+  auto const& segments = split_categories_segments_;
+  auto const& that_segments = that.split_categories_segments_;
+  return std::equal(segments.cbegin(), segments.cend(), that_segments.cbegin(),
+                    that_segments.cend(), [](auto const& l, auto const& r) {
+                      return l.beg == r.beg && l.size == r.size;
+                    });
+}
+
 void RegTree::LoadModel(Json const& in) {
   namespace tf = tree_field;
 
-  bool typed = IsA<I32Array>(in[tf::kParent]);
+  // The parents of a tree saved for serving might be stored in a smaller type.
+  bool typed = IsA<I32Array>(in[tf::kParent]) || IsA<U8Array>(in[tf::kDftLeft]);
   auto const& in_obj = get<Object const>(in);
   // basic properties
   FromJson(in["tree_param"], &param_);
@@ -1162,7 +1472,9 @@ void RegTree::LoadModel(Json const& in) {
   }
 
   bool feature_is_64 = IsA<I64Array>(in["split_indices"]);
-  if (typed && feature_is_64) {
+  if (in_obj.find(tf::kLossChg) == in_obj.cend()) {
+    LoadServingModelImpl(in, param_, &stats_, &nodes_);
+  } else if (typed && feature_is_64) {
     LoadModelImpl<true, true>(in, param_, &stats_, &nodes_);
   } else if (typed && !feature_is_64) {
     LoadModelImpl<true, false>(in, param_, &stats_, &nodes_);
@@ -1274,8 +1586,36 @@ void RegTree::SaveModel(Json* p_out) const {
   out[tf::kDftLeft] = std::move(default_left);
 }
 
+void RegTree::SaveServingModel(Json* p_out) const {
+  if (this->IsMultiTarget()) {
+    // Multi-target trees don't have statistics.
+    this->SaveModel(p_out);
+    return;
+  }
+  auto& out = *p_out;
+  out["tree_param"] = ToJson(param_);
+  this->SaveCategoricalSplit(p_out);
+
+  CHECK_EQ(param_.num_nodes, static_cast<int>(nodes_.size()));
+  auto n_nodes = param_.num_nodes;
+  namespace tf = tree_field;
+  out[tf::kLeft] = SaveIntArray(n_nodes, [&](auto i) { return nodes_[i].LeftChild(); });
+  out[tf::kRight] = SaveIntArray(n_nodes, [&](auto i) { return nodes_[i].RightChild(); });
+  out[tf::kParent] = SaveIntArray(n_nodes, [&](auto i) { return nodes_[i].Parent(); });
+  out[tf::kSplitIdx] = SaveIntArray(n_nodes, [&](auto i) { return nodes_[i].SplitIndex(); });
+  // The split conditions and the leaf values are float, no smaller type is lossless.
+  F32Array conds(n_nodes);
+  U8Array default_left(n_nodes);
+  for (bst_node_t i = 0; i < n_nodes; ++i) {
+    conds.Set(i, nodes_[i].SplitCond());
+    default_left.Set(i, static_cast<uint8_t>(!!nodes_[i].DefaultLeft()));
+  }
+  out[tf::kSplitCond] = std::move(conds);
+  out[tf::kDftLeft] = std::move(default_left);
+}
+
 void RegTree::CalculateContributionsApprox(const RegTree::FVec &feat,
-                                           std::vector<float>* mean_values,
+                                           std::vector<float> const* mean_values,
                                            bst_float *out_contribs) const {
   CHECK_GT(mean_values->size(), 0U);
   // this follows the idea of http://blog.datadive.net/interpreting-random-forests/
@@ -0,0 +1,235 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include "tree_telemetry.h"
+
+#include <algorithm>  // for sort
+#include <exception>  // for uncaught_exceptions
+#include <string>     // for string
+#include <utility>    // for move
+
+#include "../collective/comm_group.h"  // for GlobalCommGroup
+#include "../collective/stats.h"       // for CollStats
+#include "xgboost/json.h"              // for Json, Object, Array, Integer, Number
+#include "xgboost/logging.h"           // for LOG, CHECK
+
+namespace xgboost::tree {
+StringView TreePhaseName(TreePhase phase) {
+  switch (phase) {
+    case TreePhase::kGradient:
+      return "gradient";
+    case TreePhase::kSampling:
+      return "sampling";
+    case TreePhase::kBuildHist:
+      return "build_hist";
+    case TreePhase::kSubtraction:
+      return "subtraction";
+    case TreePhase::kSync:
+      return "sync";
+    case TreePhase::kEvaluate:
+      return "evaluate";
+    case TreePhase::kPartition:
+      return "partition";
+    case TreePhase::kLeafUpdate:
+      return "leaf_update";
+    case TreePhase::kPredictionCache:
+      return "prediction_cache";
+    case TreePhase::kNumPhases:
+      break;
+  }
+  LOG(FATAL) << "Unknown tree phase: " << static_cast<std::int32_t>(phase);
+  return "";
+}
+
+void TreeRecord::AddLevelRows(bst_node_t depth, bst_idx_t n_rows) {
+  CHECK_GE(depth, 0);
+  auto d = static_cast<std::size_t>(depth);
+  if (rows_per_level.size() <= d) {
+    rows_per_level.resize(d + 1, 0);
+  }
+  rows_per_level[d] += n_rows;
+}
+
+Json TreeRecord::ToJson() const {
+  Json out{Object{}};
+  out["iteration"] = Integer{iteration};
+  out["tree"] = Integer{tree};
+  out["group"] = Integer{static_cast<std::int64_t>(group)};
+  out["elapsed"] = Number{elapsed};
+  Json jphases{Object{}};
+  for (std::size_t i = 0; i < kNumPhases; ++i) {
+    auto name = TreePhaseName(static_cast<TreePhase>(i));
+    jphases[std::string{name.c_str(), name.size()}] = Number{phases[i]};
+  }
+  out["phases"] = std::move(jphases);
+  out["n_expanded"] = Integer{n_expanded};
+  Json jrows{Array{}};
+  for (auto n : rows_per_level) {
+    get<Array>(jrows).emplace_back(Integer{static_cast<std::int64_t>(n)});
+  }
+  out["rows_per_level"] = std::move(jrows);
+  Json jcache{Object{}};
+  jcache["hits"] = Integer{hist_hits};
+  jcache["evictions"] = Integer{hist_evictions};
+  out["hist_cache"] = std::move(jcache);
+  out["comm_bytes"] = Integer{comm_bytes};
+  return out;
+}
+
+namespace {
+struct LocalState {
+  TelemetryRound* round{nullptr};
+  // The tree that is being built, or the last one built by this thread.
+  TreeRecord* record{nullptr};
+  std::int32_t next_tree{0};
+  PhaseTimer* timer{nullptr};
+  // Phases timed before the first tree of this thread.
+  std::array<double, TreeRecord::kNumPhases> pending{};
+};
+
+LocalState& Local() {
+  static thread_local LocalState state;
+  return state;
+}
+
+std::int64_t CommBytes() {
+  auto const& comm = collective::GlobalCommGroup();
+  if (!comm) {
+    return 0;
+  }
+  auto total = comm->Stats()->Total();
+  return total.n_sent + total.n_recv;
+}
+
+double Seconds(std::chrono::steady_clock::duration d) {
+  return std::chrono::duration<double>{d}.count();
+}
+}  // anonymous namespace
+
+std::atomic<TelemetryRound::Callback> TelemetryRound::callback_{nullptr};
+
+TelemetryRound::TelemetryRound(std::int32_t iteration, std::int32_t tree_begin,
+                               std::int32_t trees_per_group)
+    : iteration_{iteration},
+      tree_begin_{tree_begin},
+      trees_per_group_{std::max(trees_per_group, 1)},
+      enabled_{Enabled()} {
+  if (!enabled_) {
+    return;
+  }
+  auto& state = Local();
+  prev_ = state.round;
+  state.round = this;
+  state.record = nullptr;
+  state.next_tree = tree_begin;
+}
+
+TelemetryRound::~TelemetryRound() {
+  if (!enabled_) {
+    return;
+  }
+  auto& state = Local();
+  std::sort(records_.begin(), records_.end(),
+            [](auto const& l, auto const& r) { return l->tree < r->tree; });
+  // The gradient is computed by this thread when the trees are built by other threads.
+  if (!records_.empty()) {
+    for (std::size_t i = 0; i < TreeRecord::kNumPhases; ++i) {
+      records_.front()->phases[i] += state.pending[i];
+    }
+  }
+  state.pending.fill(0);
+  state.round = prev_;
+  state.record = nullptr;
+
+  auto callback = callback_.load();
+  if (!callback || std::uncaught_exceptions() != 0) {
+    return;
+  }
+  std::string str;
+  for (auto const& record : records_) {
+    Json::Dump(record->ToJson(), &str);
+    callback(str.c_str());
+  }
+}
+
+TelemetryRound::Join::Join(TelemetryRound* round, std::int32_t tree) {
+  auto& state = Local();
+  prev_ = state.round;
+  prev_tree_ = state.next_tree;
+  state.round = round;
+  state.record = nullptr;
+  state.next_tree = tree;
+}
+
+TelemetryRound::Join::~Join() {
+  auto& state = Local();
+  state.round = prev_;
+  state.record = nullptr;
+  state.next_tree = prev_tree_;
+  state.pending.fill(0);
+}
+
+TreeRecord* TelemetryRound::NewRecord(std::int32_t tree) {
+  auto record = std::make_unique<TreeRecord>();
+  record->iteration = iteration_;
+  record->tree = tree;
+  record->group = static_cast<bst_target_t>((tree - tree_begin_) / trees_per_group_);
+  std::lock_guard guard{mu_};
+  records_.push_back(std::move(record));
+  return records_.back().get();
+}
+
+TelemetryRound* TelemetryRound::Current() { return Local().round; }
+
+TreeRecord* CurrentTreeRecord() {
+  auto& state = Local();
+  return state.round ? state.record : nullptr;
+}
+
+TreeRecordScope::TreeRecordScope() {
+  auto& state = Local();
+  if (!state.round) {
+    return;
+  }
+  record_ = state.round->NewRecord(state.next_tree++);
+  for (std::size_t i = 0; i < TreeRecord::kNumPhases; ++i) {
+    record_->phases[i] += state.pending[i];
+  }
+  state.pending.fill(0);
+  state.record = record_;
+  begin_ = std::chrono::steady_clock::now();
+  comm_begin_ = CommBytes();
+}
+
+TreeRecordScope::~TreeRecordScope() {
+  if (!record_) {
+    return;
+  }
+  record_->elapsed += Seconds(std::chrono::steady_clock::now() - begin_);
+  record_->comm_bytes += CommBytes() - comm_begin_;
+}
+
+void PhaseTimer::Start() {
+  auto& state = Local();
+  parent_ = state.timer;
+  state.timer = this;
+  active_ = true;
+  begin_ = std::chrono::steady_clock::now();
+}
+
+void PhaseTimer::Stop() {
+  auto elapsed = Seconds(std::chrono::steady_clock::now() - begin_);
+  auto& state = Local();
+  state.timer = parent_;
+  if (parent_) {
+    parent_->children_ += elapsed;
+  }
+  auto i = static_cast<std::size_t>(phase_);
+  auto exclusive = elapsed - children_;
+  if (state.round && state.record) {
+    state.record->phases[i] += exclusive;
+  } else {
+    state.pending[i] += exclusive;
+  }
+}
+}  // namespace xgboost::tree
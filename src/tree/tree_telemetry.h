@@ -0,0 +1,196 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ *
+ * @brief Structured statistics of each tree built during training.
+ */
+#ifndef XGBOOST_TREE_TREE_TELEMETRY_H_
+#define XGBOOST_TREE_TREE_TELEMETRY_H_
+
+#include <array>    // for array
+#include <atomic>   // for atomic
+#include <chrono>   // for steady_clock
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int32_t, int64_t, uint8_t
+#include <memory>   // for unique_ptr
+#include <mutex>    // for mutex
+#include <vector>   // for vector
+
+#include "xgboost/base.h"         // for bst_idx_t, bst_node_t, bst_target_t
+#include "xgboost/string_view.h"  // for StringView
+
+namespace xgboost {
+class Json;
+
+namespace tree {
+/**
+ * @brief Timed phases of building a tree. Add the name to @ref TreePhaseName when adding
+ *        a new phase.
+ */
+enum class TreePhase : std::uint8_t {
+  kGradient = 0,
+  kSampling,
+  kBuildHist,
+  kSubtraction,
+  // Allreduce of the histograms.
+  kSync,
+  kEvaluate,
+  kPartition,
+  kLeafUpdate,
+  kPredictionCache,
+  kNumPhases,
+};
+
+[[nodiscard]] StringView TreePhaseName(TreePhase phase);
+
+/**
+ * @brief Statistics of a single tree.
+ */
+struct TreeRecord {
+  static constexpr auto kNumPhases = static_cast<std::size_t>(TreePhase::kNumPhases);
+
+  std::int32_t iteration{0};
+  // Index of the tree in the model.
+  std::int32_t tree{0};
+  bst_target_t group{0};
+  // Wall time of building the tree, in seconds.
+  double elapsed{0};
+  // Exclusive time of each phase, in seconds.
+  std::array<double, kNumPhases> phases{};
+  bst_node_t n_expanded{0};
+  // Number of local rows in the nodes expanded at each depth.
+  std::vector<bst_idx_t> rows_per_level;
+  // Number of histograms obtained by the subtraction trick with a cached parent.
+  std::int64_t hist_hits{0};
+  // Number of histograms removed from the cache when it overflows.
+  std::int64_t hist_evictions{0};
+  // Bytes sent to and received from the peers.
+  std::int64_t comm_bytes{0};
+
+  void AddLevelRows(bst_node_t depth, bst_idx_t n_rows);
+  [[nodiscard]] Json ToJson() const;
+};
+
+/**
+ * @brief Collects the records of the trees built in one boosting round, the records are
+ *        passed to the registered callback when the round ends.
+ *
+ *   Phases timed by a thread before its first tree of the round, like the gradient, are
+ *   accounted to that tree. Phases timed after a tree is built, like updating the
+ *   prediction cache, are accounted to the last tree built by the same thread. Nothing is
+ *   recorded if there's no callback.
+ */
+class TelemetryRound {
+  std::int32_t iteration_;
+  std::int32_t tree_begin_;
+  std::int32_t trees_per_group_;
+  std::mutex mu_;
+  std::vector<std::unique_ptr<TreeRecord>> records_;
+  TelemetryRound *prev_{nullptr};
+  bool enabled_;
+
+ public:
+  using Callback = void (*)(char const *);
+
+ private:
+  static std::atomic<Callback> callback_;
+
+ public:
+  /**
+   * @param iteration       The boosting round.
+   * @param tree_begin      Index of the first tree built in this round.
+   * @param trees_per_group Number of trees built for each output group.
+   */
+  TelemetryRound(std::int32_t iteration, std::int32_t tree_begin, std::int32_t trees_per_group);
+  ~TelemetryRound();
+
+  TelemetryRound(TelemetryRound const &that) = delete;
+  TelemetryRound &operator=(TelemetryRound const &that) = delete;
+
+  /**
+   * @brief Record the trees built by a different thread, starting from the tree at index
+   *        `tree`. The thread must leave the round before it ends.
+   */
+  class Join {
+    TelemetryRound *prev_;
+    std::int32_t prev_tree_;
+
+   public:
+    Join(TelemetryRound *round, std::int32_t tree);
+    ~Join();
+
+    Join(Join const &that) = delete;
+    Join &operator=(Join const &that) = delete;
+  };
+
+  [[nodiscard]] TreeRecord *NewRecord(std::int32_t tree);
+  /**
+   * @brief The round of the current thread, null if nothing is being recorded.
+   */
+  [[nodiscard]] static TelemetryRound *Current();
+
+  /**
+   * @brief Register the callback that receives a JSON document for each tree, null to stop
+   *        recording.
+   */
+  static void SetCallback(Callback callback) { callback_.store(callback); }
+  [[nodiscard]] static bool Enabled() {
+    return callback_.load(std::memory_order_relaxed) != nullptr;
+  }
+};
+
+/**
+ * @brief The record of the tree being built by the current thread, null if nothing is
+ *        being recorded.
+ */
+[[nodiscard]] TreeRecord *CurrentTreeRecord();
+
+/**
+ * @brief Record the tree built over the lifetime of this object, which becomes the @ref
+ *        CurrentTreeRecord of the thread. No-op if the thread is not in a @ref
+ *        TelemetryRound.
+ */
+class TreeRecordScope {
+  TreeRecord *record_{nullptr};
+  std::chrono::steady_clock::time_point begin_;
+  std::int64_t comm_begin_{0};
+
+ public:
+  TreeRecordScope();
+  ~TreeRecordScope();
+
+  TreeRecordScope(TreeRecordScope const &that) = delete;
+  TreeRecordScope &operator=(TreeRecordScope const &that) = delete;
+};
+
+/**
+ * @brief Time a phase over the lifetime of this object. The time of nested phases is
+ *        excluded from the enclosing phase.
+ */
+class PhaseTimer {
+  PhaseTimer *parent_{nullptr};
+  std::chrono::steady_clock::time_point begin_;
+  double children_{0};
+  TreePhase phase_;
+  bool active_{false};
+
+  void Start();
+  void Stop();
+
+ public:
+  explicit PhaseTimer(TreePhase phase) : phase_{phase} {
+    if (TelemetryRound::Enabled()) {
+      this->Start();
+    }
+  }
+  ~PhaseTimer() {
+    if (active_) {
+      this->Stop();
+    }
+  }
+
+  PhaseTimer(PhaseTimer const &that) = delete;
+  PhaseTimer &operator=(PhaseTimer const &that) = delete;
+};
+}  // namespace tree
+}  // namespace xgboost
+#endif  // XGBOOST_TREE_TREE_TELEMETRY_H_
@@ -4,9 +4,11 @@
  * \brief Implementation for the approx tree method.
  */
 #include <algorithm>  // for max, transform, fill_n
+#include <cmath>      // for abs
 #include <cstddef>    // for size_t
 #include <map>        // for map
 #include <memory>     // for allocator, unique_ptr, make_shared, make_unique
+#include <numeric>    // for accumulate
 #include <utility>    // for move
 #include <vector>     // for vector
 
@@ -14,9 +16,11 @@
 #include "../collective/communicator-inl.h"  // for IsDistributed
 #include "../common/hist_util.h"             // for HistogramCuts
 #include "../common/random.h"                // for ColumnSampler
+#include "../common/threading_utils.h"       // for ParallelFor
 #include "../common/timer.h"                 // for Monitor
+#include "../common/trace.h"                 // for TraceScope
 #include "../data/gradient_index.h"          // for GHistIndexMatrix
-#include "common_row_partitioner.h"          // for CommonRowPartitioner
+#include "common_row_partitioner.h"          // for RowPartitioners
 #include "dmlc/registry.h"                   // for DMLC_REGISTRY_FILE_TAG
 #include "driver.h"                          // for Driver
 #include "hist/evaluate_splits.h"            // for HistEvaluator, UpdatePredictionCacheImpl
@@ -43,8 +47,8 @@ DMLC_REGISTRY_FILE_TAG(updater_approx);
 
 namespace {
 // Return the BatchParam used by DMatrix.
-auto BatchSpec(TrainParam const &p, common::Span<float> hess, ObjInfo const task) {
-  return BatchParam{p.max_bin, hess, !task.const_hess};
+auto BatchSpec(TrainParam const &p, common::Span<float> hess, bool regen) {
+  return BatchParam{p.max_bin, hess, regen};
 }
 
 auto BatchSpec(TrainParam const &p, common::Span<float> hess) {
@@ -62,7 +66,7 @@ class GlobalApproxBuilder {
   Context const *ctx_;
   ObjInfo const *const task_;
 
-  std::vector<CommonRowPartitioner> partitioner_;
+  RowPartitioners partitioner_;
   // Pointer to last updated tree, used for update prediction cache.
   RegTree *p_last_tree_{nullptr};
   common::Monitor *monitor_;
@@ -71,23 +75,27 @@ class GlobalApproxBuilder {
   common::HistogramCuts feature_values_;
 
  public:
-  void InitData(DMatrix *p_fmat, RegTree const *p_tree, common::Span<float> hess) {
+  void InitData(DMatrix *p_fmat, RegTree const *p_tree, common::Span<float> hess,
+                bool regen) {
     monitor_->Start(__func__);
 
     n_batches_ = 0;
     bst_bin_t n_total_bins = 0;
-    partitioner_.clear();
+    partitioner_.SetNumSamples(p_fmat->Info().num_row_);
+    partitioner_.Visit([](auto &partitioners) { partitioners.clear(); });
     // Generating the GHistIndexMatrix is quite slow, is there a way to speed it up?
     for (auto const &page :
-         p_fmat->GetBatches<GHistIndexMatrix>(ctx_, BatchSpec(*param_, hess, *task_))) {
+         p_fmat->GetBatches<GHistIndexMatrix>(ctx_, BatchSpec(*param_, hess, regen))) {
       if (n_total_bins == 0) {
         n_total_bins = page.cut.TotalBins();
         feature_values_ = page.cut;
       } else {
         CHECK_EQ(n_total_bins, page.cut.TotalBins());
       }
-      partitioner_.emplace_back(this->ctx_, page.Size(), page.base_rowid,
-                                p_fmat->Info().IsColumnSplit());
+      partitioner_.Visit([&](auto &partitioners) {
+        partitioners.emplace_back(this->ctx_, page.Size(), page.base_rowid,
+                                  p_fmat->Info().IsColumnSplit());
+      });
       n_batches_++;
     }
 
@@ -112,9 +120,11 @@ class GlobalApproxBuilder {
     collective::SafeColl(rc);
 
     std::vector<CPUExpandEntry> nodes{best};
-    this->histogram_builder_.BuildRootHist(p_fmat, p_tree, partitioner_,
-                                           linalg::MakeTensorView(ctx_, gpair, gpair.size(), 1),
-                                           best, BatchSpec(*param_, hess));
+    partitioner_.Visit([&](auto const &partitioners) {
+      this->histogram_builder_.BuildRootHist(p_fmat, p_tree, partitioners,
+                                             linalg::MakeTensorView(ctx_, gpair, gpair.size(), 1),
+                                             best, BatchSpec(*param_, hess));
+    });
 
     auto weight = evaluator_.InitRoot(root_sum);
     p_tree->Stat(RegTree::kRoot).sum_hess = root_sum.GetHess();
@@ -134,7 +144,9 @@ class GlobalApproxBuilder {
     // Caching prediction seems redundant for approx tree method, as sketching takes up
     // majority of training time.
     CHECK_EQ(out_preds.Size(), data->Info().num_row_);
-    UpdatePredictionCacheImpl(ctx_, p_last_tree_, partitioner_, out_preds);
+    partitioner_.Visit([&](auto const &partitioners) {
+      UpdatePredictionCacheImpl(ctx_, p_last_tree_, partitioners, out_preds);
+    });
     monitor_->Stop(__func__);
   }
 
@@ -142,9 +154,11 @@ class GlobalApproxBuilder {
                       std::vector<CPUExpandEntry> const &valid_candidates,
                       std::vector<GradientPair> const &gpair, common::Span<float> hess) {
     monitor_->Start(__func__);
-    this->histogram_builder_.BuildHistLeftRight(
-        ctx_, p_fmat, p_tree, partitioner_, valid_candidates,
-        linalg::MakeTensorView(ctx_, gpair, gpair.size(), 1), BatchSpec(*param_, hess));
+    partitioner_.Visit([&](auto const &partitioners) {
+      this->histogram_builder_.BuildHistLeftRight(
+          ctx_, p_fmat, p_tree, partitioners, valid_candidates,
+          linalg::MakeTensorView(ctx_, gpair, gpair.size(), 1), BatchSpec(*param_, hess));
+    });
     monitor_->Stop(__func__);
   }
 
@@ -155,10 +169,12 @@ class GlobalApproxBuilder {
       return;
     }
     p_out_position->resize(hess.size());
-    for (auto const &part : partitioner_) {
-      part.LeafPartition(ctx_, tree, hess,
-                         common::Span{p_out_position->data(), p_out_position->size()});
-    }
+    partitioner_.Visit([&](auto const &partitioners) {
+      for (auto const &part : partitioners) {
+        part.LeafPartition(ctx_, tree, hess,
+                           common::Span{p_out_position->data(), p_out_position->size()});
+      }
+    });
     monitor_->Stop(__func__);
   }
 
@@ -175,15 +191,19 @@ class GlobalApproxBuilder {
         task_{task},
         monitor_{monitor} {}
 
+  /**
+   * @param regen Whether the quantile sketch should be regenerated with the hessian.
+   */
   void UpdateTree(DMatrix *p_fmat, std::vector<GradientPair> const &gpair, common::Span<float> hess,
-                  RegTree *p_tree, HostDeviceVector<bst_node_t> *p_out_position) {
+                  bool regen, RegTree *p_tree, HostDeviceVector<bst_node_t> *p_out_position) {
     p_last_tree_ = p_tree;
-    this->InitData(p_fmat, p_tree, hess);
+    this->InitData(p_fmat, p_tree, hess, regen);
 
     Driver<CPUExpandEntry> driver(*param_);
     auto &tree = *p_tree;
     driver.Push({this->InitRoot(p_fmat, gpair, hess, p_tree)});
-    auto expand_set = driver.Pop();
+    std::vector<CPUExpandEntry> expand_set;
+    driver.Pop(&expand_set);
 
     /**
      * Note for update position
@@ -195,11 +215,17 @@ class GlobalApproxBuilder {
      *   Applied: Ditto
      */
 
+    // Buffers for each level, reused to avoid allocation.
+    // candidates that can be further splited.
+    std::vector<CPUExpandEntry> valid_candidates;
+    // candidates that can be applied.
+    std::vector<CPUExpandEntry> applied;
+    std::vector<CPUExpandEntry> best_splits;
     while (!expand_set.empty()) {
-      // candidates that can be further splited.
-      std::vector<CPUExpandEntry> valid_candidates;
-      // candidates that can be applied.
-      std::vector<CPUExpandEntry> applied;
+      common::TraceScope trace{common::TraceEvent::kTreeLevel, expand_set.front().depth};
+      valid_candidates.clear();
+      applied.clear();
+      best_splits.clear();
       for (auto const &candidate : expand_set) {
         evaluator_.ApplyTreeSplit(candidate, p_tree);
         applied.push_back(candidate);
@@ -212,12 +238,13 @@ class GlobalApproxBuilder {
       size_t page_id = 0;
       for (auto const &page :
            p_fmat->GetBatches<GHistIndexMatrix>(ctx_, BatchSpec(*param_, hess))) {
-        partitioner_.at(page_id).UpdatePosition(ctx_, page, applied, p_tree);
+        partitioner_.Visit([&](auto &partitioners) {
+          partitioners.at(page_id).UpdatePosition(ctx_, page, applied, p_tree);
+        });
         page_id++;
       }
       monitor_->Stop("UpdatePosition");
 
-      std::vector<CPUExpandEntry> best_splits;
       if (!valid_candidates.empty()) {
         this->BuildHistogram(p_fmat, p_tree, valid_candidates, gpair, hess);
         for (auto const &candidate : valid_candidates) {
@@ -235,7 +262,7 @@ class GlobalApproxBuilder {
         monitor_->Stop("EvaluateSplits");
       }
       driver.Push(best_splits.begin(), best_splits.end());
-      expand_set = driver.Pop();
+      driver.Pop(&expand_set);
     }
 
     auto &h_position = p_out_position->HostVector();
@@ -256,6 +283,55 @@ class GlobalApproxUpdater : public TreeUpdater {
   std::shared_ptr<common::ColumnSampler> column_sampler_;
   ObjInfo const *task_;
   HistMakerTrainParam hist_param_;
+  // Hessian used by the last sketch and its sum.
+  std::vector<float> sketch_hess_;
+  double sketch_hess_sum_{0.0};
+  DMatrix const *p_sketch_fmat_{nullptr};
+
+  /**
+   * @brief Whether the quantile sketch needs to be regenerated for the new hessian.
+   *
+   *   The sketch is reused if the total variation distance between the normalized new
+   *   hessian and the hessian used by the last sketch is less than the threshold. The
+   *   weighted rank of any value in any feature changes by at most this distance.
+   */
+  [[nodiscard]] bool NeedSketch(DMatrix const *p_fmat, std::vector<float> const &hess) {
+    if (task_->const_hess) {
+      return false;
+    }
+    auto threshold = hist_param_.sketch_reuse_threshold;
+    if (threshold <= 0.0f) {
+      return true;
+    }
+    auto const &info = p_fmat->Info();
+    auto n_threads = ctx_->Threads();
+    auto thread_sum = [&](auto &&fn) {
+      std::vector<double> tloc(n_threads, 0.0);
+      common::ParallelFor(hess.size(), n_threads,
+                          [&](auto i) { tloc[common::ThreadIdx()] += fn(i); });
+      double sum = std::accumulate(tloc.cbegin(), tloc.cend(), 0.0);
+      auto rc = collective::GlobalSum(ctx_, info, linalg::MakeVec(&sum, 1));
+      collective::SafeColl(rc);
+      return sum;
+    };
+    auto hess_sum = thread_sum([&](auto i) { return static_cast<double>(hess[i]); });
+
+    bool can_reuse = p_sketch_fmat_ == p_fmat &&
+                     sketch_hess_.size() == hess.size() && hess_sum > 0.0 &&
+                     sketch_hess_sum_ > 0.0;
+    if (can_reuse) {
+      auto distance = thread_sum([&](auto i) {
+        return std::abs(hess[i] / hess_sum - sketch_hess_[i] / sketch_hess_sum_);
+      });
+      if (distance * 0.5 < threshold) {
+        return false;
+      }
+    }
+    sketch_hess_ = hess;
+    sketch_hess_sum_ = hess_sum;
+    p_sketch_fmat_ = p_fmat;
+    return true;
+  }
 
  public:
   explicit GlobalApproxUpdater(Context const *ctx, ObjInfo const *task)
@@ -303,10 +379,13 @@ class GlobalApproxUpdater : public TreeUpdater {
                    [](auto g) { return g.GetHess(); });
 
     cached_ = m;
+    auto regen = this->NeedSketch(m, hess);
 
     std::size_t t_idx = 0;
     for (auto p_tree : trees) {
-      this->pimpl_->UpdateTree(m, s_gpair, hess, p_tree, &out_position[t_idx]);
+      // Trees in the same iteration share the hessian.
+      this->pimpl_->UpdateTree(m, s_gpair, hess, regen && t_idx == 0, p_tree,
+                               &out_position[t_idx]);
       hist_param_.CheckTreesSynchronized(ctx_, p_tree);
       ++t_idx;
     }
@@ -6,6 +6,7 @@
  */
 #include <algorithm>
 #include <cmath>
+#include <numeric>  // for accumulate, partial_sum
 #include <vector>
 
 #include "../common/error_msg.h"  // for NoCategorical
@@ -232,6 +233,12 @@ class ColMaker: public TreeUpdater {
           }
         }
       }
+      {
+        // all rows are in the columns used for enumeration
+        has_live_cols_ = false;
+        live_cols_.Clear();
+        n_live_rows_ = position_.size();
+      }
       {
         if (!column_sampler_) {
           column_sampler_ = common::MakeColumnSampler(ctx_);
@@ -274,7 +281,7 @@ class ColMaker: public TreeUpdater {
       const MetaInfo& info = fmat.Info();
       // setup position
       common::ParallelFor(info.num_row_, ctx_->Threads(), [&](auto ridx) {
-        int32_t const tid = omp_get_thread_num();
+        int32_t const tid = common::ThreadIdx();
         if (position_[ridx] < 0) return;
         stemp_[tid][position_[ridx]].stats.Add(gpair[ridx]);
       });
@@ -443,6 +450,50 @@ class ColMaker: public TreeUpdater {
       }
     }
 
+    /**
+     * @brief Remove the rows that are not in any node to be expanded from the columns used
+     *        for enumeration. The columns are rebuilt only when most of the rows in the
+     *        current columns are finished, as rows never return to the expansion.
+     */
+    void CompactColumns(HostSparsePageView page) {
+      constexpr double kCompactRatio = 0.5;
+      auto n_threads = this->ctx_->Threads();
+      std::vector<bst_idx_t> n_active_tloc(n_threads, 0);
+      common::ParallelFor(position_.size(), n_threads, [&](auto ridx) {
+        n_active_tloc[common::ThreadIdx()] += position_[ridx] >= 0;
+      });
+      auto n_active = std::accumulate(n_active_tloc.cbegin(), n_active_tloc.cend(),
+                                      static_cast<bst_idx_t>(0));
+      if (static_cast<double>(n_active) > kCompactRatio * static_cast<double>(n_live_rows_)) {
+        return;
+      }
+      if (has_live_cols_) {
+        page = live_cols_.GetView();
+      }
+
+      SparsePage out;
+      auto n_features = page.Size();
+      auto& h_offset = out.offset.HostVector();
+      h_offset.assign(n_features + 1, 0);
+      common::ParallelFor(n_features, n_threads, [&](auto fidx) {
+        auto col = page[fidx];
+        h_offset[fidx + 1] = std::count_if(col.cbegin(), col.cend(), [&](Entry const& e) {
+          return position_[e.index] >= 0;
+        });
+      });
+      std::partial_sum(h_offset.cbegin(), h_offset.cend(), h_offset.begin());
+      auto& h_data = out.data.HostVector();
+      h_data.resize(h_offset.back());
+      common::ParallelFor(n_features, n_threads, [&](auto fidx) {
+        auto col = page[fidx];
+        std::copy_if(col.cbegin(), col.cend(), h_data.begin() + h_offset[fidx],
+                     [&](Entry const& e) { return position_[e.index] >= 0; });
+      });
+      live_cols_ = std::move(out);
+      has_live_cols_ = true;
+      n_live_rows_ = n_active;
+    }
+
     // update the solution candidate
     void UpdateSolution(SortedCSCPage const &batch, const std::vector<bst_feature_t> &feat_set,
                         const std::vector<GradientPair> &gpair) {
@@ -451,14 +502,18 @@ class ColMaker: public TreeUpdater {
       CHECK(this->ctx_);
       const int batch_size =  // NOLINT
           std::max(static_cast<int>(num_features / this->ctx_->Threads() / 32), 1);
-      auto page = batch.GetView();
+      auto full_page = batch.GetView();
+      this->CompactColumns(full_page);
+      auto page = has_live_cols_ ? live_cols_.GetView() : full_page;
       common::ParallelFor(
           num_features, ctx_->Threads(), common::Sched::Dyn(batch_size), [&](auto i) {
             auto evaluator = tree_evaluator_.GetEvaluator();
             bst_feature_t const fid = feat_set[i];
-            int32_t const tid = omp_get_thread_num();
+            int32_t const tid = common::ThreadIdx();
             auto c = page[fid];
-            const bool ind = c.size() != 0 && c[0].fvalue == c[c.size() - 1].fvalue;
+            auto full = full_page[fid];
+            const bool ind =
+                full.size() != 0 && full[0].fvalue == full[full.size() - 1].fvalue;
             if (colmaker_train_param_.NeedForwardSearch(column_densities_[fid], ind)) {
               this->EnumerateSplit(c.data(), c.data() + c.size(), +1, fid, gpair, stemp_[tid],
                                    evaluator);
@@ -590,6 +645,11 @@ class ColMaker: public TreeUpdater {
     std::shared_ptr<common::ColumnSampler> column_sampler_;
     // Instance Data: current node position in the tree of each instance
     std::vector<int> position_;
+    // Columns with only the rows that can still be split, see `CompactColumns`.
+    SparsePage live_cols_;
+    bool has_live_cols_{false};
+    // Number of rows that are not finished when the columns were compacted.
+    bst_idx_t n_live_rows_{0};
     // PerThread x PerTreeNode: statistics for per thread construction
     std::vector< std::vector<ThreadEntry> > stemp_;
     /*! \brief TreeNode Data: statistics for each constructed node */
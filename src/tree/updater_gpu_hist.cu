@@ -8,7 +8,7 @@
 #include <cmath>      // for isnan
 #include <cstddef>    // for size_t
 #include <memory>     // for unique_ptr, make_unique
-#include <utility>    // for move
+#include <utility>    // for move, exchange
 #include <vector>     // for vector
 
 #include "../collective/aggregator.h"
@@ -102,6 +102,12 @@ struct GPUHistMakerDevice {
   std::vector<bst_idx_t> const batch_ptr_;
   // node idx for each sample
   dh::device_vector<bst_node_t> positions_;
+  // The prediction cache is updated on a side stream, the positions and the nodes are read by
+  // the update until the context stream waits for the event.
+  dh::CUDAStream cache_stream_;
+  dh::CUDAEvent cache_updated_;
+  dh::CachingDeviceUVector<RegTree::Node> cache_nodes_;
+  bool cache_pending_{false};
   HistMakerTrainParam const* hist_param_;
   std::shared_ptr<common::HistogramCuts const> const cuts_;
   std::unique_ptr<FeatureGroups> feature_groups_;
@@ -157,7 +163,7 @@ struct GPUHistMakerDevice {
         hist_param_{hist_param},
         cuts_{std::move(cuts)},
         feature_groups_{std::make_unique<FeatureGroups>(*cuts_, dense_compressed,
-                                                        dh::MaxSharedMemoryOptin(ctx_->Ordinal()))},
+                                                        HistSharedMemBudget(ctx_->Device()))},
         param{std::move(_param)},
         interaction_constraints(param, static_cast<bst_feature_t>(info.num_col_)),
         sampler{std::make_unique<GradientBasedSampler>(
@@ -172,7 +178,11 @@ struct GPUHistMakerDevice {
     monitor.Init(std::string("GPUHistMakerDevice") + ctx_->Device().Name());
   }
 
-  ~GPUHistMakerDevice() = default;
+  ~GPUHistMakerDevice() {
+    if (cache_pending_) {
+      cache_stream_.Sync();
+    }
+  }
 
   // Reset values for each update iteration
   [[nodiscard]] DMatrix* Reset(HostDeviceVector<GradientPair> const* dh_gpair, DMatrix* p_fmat) {
@@ -317,13 +327,16 @@ struct GPUHistMakerDevice {
     this->monitor.Stop(__func__);
   }
 
-  void BuildHist(EllpackPage const& page, std::int32_t k, bst_bin_t nidx) {
+  // Build the histograms of all the nodes in one go.
+  void BuildHist(EllpackPage const& page, std::int32_t k, std::vector<bst_node_t> const& nodes) {
     monitor.Start(__func__);
-    auto d_node_hist = histogram_.GetNodeHistogram(nidx);
-    auto batch = page.Impl();
-    auto acc = batch->GetDeviceAccessor(ctx_);
-
-    auto d_ridx = partitioners_.at(k)->GetRows(nidx);
+    std::vector<common::Span<GradientPairInt64>> d_node_hist(nodes.size());
+    std::vector<common::Span<cuda_impl::RowIndexT const>> d_ridx(nodes.size());
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+      d_node_hist[i] = histogram_.GetNodeHistogram(nodes[i]);
+      d_ridx[i] = partitioners_.at(k)->GetRows(nodes[i]);
+    }
+    auto acc = page.Impl()->GetDeviceAccessor(ctx_);
     this->histogram_.BuildHistogram(ctx_->CUDACtx(), acc,
                                     feature_groups_->DeviceAccessor(ctx_->Device()), this->gpair,
                                     d_ridx, d_node_hist, *quantiser);
@@ -351,9 +364,7 @@ struct GPUHistMakerDevice {
     // Build the nodes that can not obtain the histogram using subtraction. This is the slow path.
     std::int32_t k = 0;
     for (auto const& page : p_fmat->GetBatches<EllpackPage>(ctx_, StaticBatch(true))) {
-      for (auto nidx : need_build) {
-        this->BuildHist(page, k, nidx);
-      }
+      this->BuildHist(page, k, need_build);
       ++k;
     }
     for (auto nidx : need_build) {
@@ -498,9 +509,7 @@ struct GPUHistMakerDevice {
 
       monitor.Stop("UpdatePositionBatch");
 
-      for (auto nidx : build_nidx) {
-        this->BuildHist(page, k, nidx);
-      }
+      this->BuildHist(page, k, build_nidx);
 
       ++k;
     }
@@ -518,6 +527,8 @@ struct GPUHistMakerDevice {
   void FinalisePosition(DMatrix* p_fmat, RegTree const* p_tree, ObjInfo task,
                         HostDeviceVector<bst_node_t>* p_out_position) {
     monitor.Start(__func__);
+    // The positions of the last tree might still be read by the cache update.
+    this->WaitPredictionCache();
     if (static_cast<std::size_t>(p_fmat->NumBatches() + 1) != this->batch_ptr_.size()) {
       if (task.UpdateTreeLeaf()) {
         LOG(FATAL) << "Current objective function can not be used with concatenated pages.";
@@ -593,7 +604,14 @@ struct GPUHistMakerDevice {
     monitor.Stop(__func__);
   }
 
-  bool UpdatePredictionCache(linalg::MatrixView<float> out_preds_d, RegTree const* p_tree) {
+  /**
+   * @brief Add the leaf values of the last tree to the prediction cache on the side stream.
+   *
+   * @param defer Leave the update running after the call, to overlap with the next tree. The
+   *              cache must not be read until @ref WaitPredictionCache.
+   */
+  bool UpdatePredictionCache(linalg::MatrixView<float> out_preds_d, RegTree const* p_tree,
+                             bool defer) {
     if (positions_.empty()) {
       return false;
     }
@@ -605,22 +623,45 @@ struct GPUHistMakerDevice {
     auto d_position = dh::ToSpan(positions_);
     CHECK_EQ(out_preds_d.Size(), d_position.size());
 
+    if (cache_pending_) {
+      // The node buffer might be reallocated.
+      cache_stream_.Sync();
+    }
+    // Start after the positions and the predictions are ready on the context stream.
+    dh::CUDAEvent ready;
+    ready.Record(ctx_->CUDACtx()->Stream());
+    cache_stream_.Wait(ready);
+
     // Use the nodes from tree, the leaf value might be changed by the objective since the
     // last update tree call.
-    dh::CachingDeviceUVector<RegTree::Node> nodes;
-    dh::CopyTo(p_tree->GetNodes(), &nodes, this->ctx_->CUDACtx()->Stream());
-    common::Span<RegTree::Node> d_nodes = dh::ToSpan(nodes);
+    dh::CopyTo(p_tree->GetNodes(), &cache_nodes_, cache_stream_.View());
+    common::Span<RegTree::Node> d_nodes = dh::ToSpan(cache_nodes_);
     CHECK_EQ(out_preds_d.Shape(1), 1);
-    dh::LaunchN(d_position.size(), ctx_->CUDACtx()->Stream(),
+    dh::LaunchN(d_position.size(), cache_stream_.View(),
                 [=] XGBOOST_DEVICE(std::size_t idx) mutable {
                   bst_node_t nidx = d_position[idx];
                   nidx = SamplePosition::Decode(nidx);
                   auto weight = d_nodes[nidx].LeafValue();
                   out_preds_d(idx, 0) += weight;
                 });
+    cache_updated_.Record(cache_stream_.View());
+    cache_pending_ = true;
+    if (!defer) {
+      this->WaitPredictionCache();
+    }
     return true;
   }
 
+  /**
+   * @brief Make the context stream wait for the prediction cache updates.
+   */
+  void WaitPredictionCache() {
+    if (cache_pending_) {
+      ctx_->CUDACtx()->Stream().Wait(cache_updated_);
+      cache_pending_ = false;
+    }
+  }
+
   void ApplySplit(const GPUExpandEntry& candidate, RegTree* p_tree) {
     RegTree& tree = *p_tree;
 
@@ -690,7 +731,7 @@ struct GPUHistMakerDevice {
     std::int32_t k = 0;
     CHECK_EQ(p_fmat->NumBatches(), this->partitioners_.size());
     for (auto const& page : p_fmat->GetBatches<EllpackPage>(ctx_, StaticBatch(true))) {
-      this->BuildHist(page, k, kRootNIdx);
+      this->BuildHist(page, k, {kRootNIdx});
       ++k;
     }
     this->histogram_.AllReduceHist(ctx_, p_fmat->Info(), kRootNIdx, 1);
@@ -861,13 +902,26 @@ class GPUHistMaker : public TreeUpdater {
     maker->UpdateTree(gpair, p_fmat, task_, p_tree, p_out_position);
   }
 
+  bool DeferPredictionCache() override {
+    this->defer_cache_ = true;
+    return true;
+  }
+
   bool UpdatePredictionCache(const DMatrix* data, linalg::MatrixView<float> p_out_preds) override {
-    if (maker == nullptr || p_last_fmat_ == nullptr || p_last_fmat_ != data) {
+    bool defer = std::exchange(this->defer_cache_, false);
+    if (maker == nullptr) {
       return false;
     }
-    monitor_.Start(__func__);
-    bool result = maker->UpdatePredictionCache(p_out_preds, p_last_tree_);
-    monitor_.Stop(__func__);
+    bool result = false;
+    if (p_last_fmat_ != nullptr && p_last_fmat_ == data) {
+      monitor_.Start(__func__);
+      result = maker->UpdatePredictionCache(p_out_preds, p_last_tree_, defer);
+      monitor_.Stop(__func__);
+    }
+    if (!defer) {
+      // Join the updates deferred by the previous calls.
+      maker->WaitPredictionCache();
+    }
     return result;
   }
 
@@ -878,6 +932,7 @@ class GPUHistMaker : public TreeUpdater {
 
  private:
   bool initialised_{false};
+  bool defer_cache_{false};
 
   HistMakerTrainParam hist_maker_param_;
 
@@ -993,7 +1048,7 @@ class GPUGlobalApproxMaker : public TreeUpdater {
       return false;
     }
     monitor_.Start(__func__);
-    bool result = maker_->UpdatePredictionCache(p_out_preds, p_last_tree_);
+    bool result = maker_->UpdatePredictionCache(p_out_preds, p_last_tree_, false);
     monitor_.Stop(__func__);
     return result;
   }
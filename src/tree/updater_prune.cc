@@ -6,12 +6,21 @@
  */
 #include <xgboost/tree_updater.h>
 
+#include <algorithm>  // for min, max
+#include <cmath>      // for abs
+#include <limits>     // for numeric_limits
 #include <memory>
+#include <vector>  // for vector
 
+#include "../collective/aggregator.h"   // for GlobalSum
+#include "../common/threading_utils.h"  // for ParallelFor
 #include "../common/timer.h"
+#include "../predictor/predict_fn.h"  // for GetNextNode
 #include "./param.h"
 #include "xgboost/base.h"
 #include "xgboost/json.h"
+#include "xgboost/linalg.h"     // for MakeVec
+#include "xgboost/parameter.h"  // for XGBoostParameter
 namespace xgboost::tree {
 DMLC_REGISTRY_FILE_TAG(updater_prune);
 
@@ -93,4 +102,239 @@ XGBOOST_REGISTER_TREE_UPDATER(TreePruner, "prune")
     .set_body([](Context const* ctx, ObjInfo const* task) {
       return new TreePruner{ctx, task};
     });
+
+struct CompactTrainParam : public XGBoostParameter<CompactTrainParam> {
+  float compact_drop_threshold;
+
+  DMLC_DECLARE_PARAMETER(CompactTrainParam) {
+    DMLC_DECLARE_FIELD(compact_drop_threshold)
+        .set_default(0.0f)
+        .set_lower_bound(0.0f)
+        .describe(
+            "Trees with a mean absolute output below this value on the input data are replaced "
+            "by a single leaf. 0 to disable.");
+  }
+};
+
+DMLC_REGISTER_PARAMETER(CompactTrainParam);
+
+/**
+ * @brief Rewrite trained trees into smaller trees with the same predictions. Used with
+ *        `process_type=update` after training.
+ *
+ *   - Splits decided by the earlier splits on the same path are removed. The bounds of
+ *     numerical features are tracked along the path, along with whether a missing value can
+ *     reach the node through the default branches.
+ *   - Splits with leaves of the same value on both sides are merged into a leaf.
+ *   - Optionally, trees that barely contribute to the prediction of the input data are
+ *     replaced by a leaf with the mean output, which is the only step changing the
+ *     prediction.
+ *
+ *   The nodes are re-indexed and deleted nodes are removed in the output tree.
+ */
+class TreeCompactor : public TreeUpdater {
+  struct Bound {
+    float lower{-std::numeric_limits<float>::infinity()};
+    float upper{std::numeric_limits<float>::infinity()};
+    // Whether a missing value can reach the node.
+    bool missing{true};
+  };
+
+  CompactTrainParam param_;
+  common::Monitor monitor_;
+  // Bounds of the features on the current path.
+  std::vector<Bound> bounds_;
+  // The node to be used after removing the decided splits, for each node.
+  std::vector<bst_node_t> resolved_;
+  // Whether the subtree has only one leaf value.
+  std::vector<std::int8_t> is_constant_;
+  std::vector<float> constant_;
+
+  [[nodiscard]] bst_node_t Resolve(RegTree const& tree, bst_node_t nidx) const {
+    while (!tree[nidx].IsLeaf() && tree.GetSplitTypes()[nidx] == FeatureType::kNumerical) {
+      auto const& node = tree[nidx];
+      auto const& bound = bounds_[node.SplitIndex()];
+      bool go_left = bound.upper <= node.SplitCond();
+      bool go_right = bound.lower >= node.SplitCond();
+      if (!go_left && !go_right) {
+        break;
+      }
+      // A missing value takes the default branch, which must agree with the decision.
+      if (bound.missing && node.DefaultLeft() != go_left) {
+        break;
+      }
+      nidx = go_left ? node.LeftChild() : node.RightChild();
+    }
+    return nidx;
+  }
+
+  void Analyze(RegTree const& tree, bst_node_t nidx) {
+    auto target = this->Resolve(tree, nidx);
+    resolved_[nidx] = target;
+    auto const& node = tree[target];
+    if (node.IsLeaf()) {
+      is_constant_[target] = true;
+      constant_[target] = node.LeafValue();
+      return;
+    }
+
+    bool is_num = tree.GetSplitTypes()[target] == FeatureType::kNumerical;
+    auto fidx = node.SplitIndex();
+    auto saved = bounds_[fidx];
+    for (auto go_left : {true, false}) {
+      auto& bound = bounds_[fidx];
+      if (is_num) {
+        if (go_left) {
+          bound.upper = std::min(bound.upper, node.SplitCond());
+        } else {
+          bound.lower = std::max(bound.lower, node.SplitCond());
+        }
+      }
+      bound.missing = saved.missing && node.DefaultLeft() == go_left;
+      this->Analyze(tree, go_left ? node.LeftChild() : node.RightChild());
+      bounds_[fidx] = saved;
+    }
+
+    auto left = resolved_[node.LeftChild()];
+    auto right = resolved_[node.RightChild()];
+    if (is_constant_[left] && is_constant_[right] && constant_[left] == constant_[right]) {
+      is_constant_[target] = true;
+      constant_[target] = constant_[left];
+    }
+  }
+
+  void Emit(RegTree const& tree, bst_node_t nidx, bst_node_t out_nidx, RegTree* p_out) const {
+    auto& out = *p_out;
+    auto target = resolved_[nidx];
+    auto const& node = tree[target];
+    auto const& stat = tree.Stat(target);
+    if (is_constant_[target]) {
+      out[out_nidx].SetLeaf(constant_[target]);
+      out.Stat(out_nidx) = {0.0f, stat.sum_hess, stat.base_weight};
+      return;
+    }
+    if (tree.GetSplitTypes()[target] == FeatureType::kCategorical) {
+      out.ExpandCategorical(out_nidx, node.SplitIndex(), tree.NodeCats(target),
+                            node.DefaultLeft(), stat.base_weight, 0.0f, 0.0f, stat.loss_chg,
+                            stat.sum_hess, 0.0f, 0.0f);
+    } else {
+      out.ExpandNode(out_nidx, node.SplitIndex(), node.SplitCond(), node.DefaultLeft(),
+                     stat.base_weight, 0.0f, 0.0f, stat.loss_chg, stat.sum_hess, 0.0f, 0.0f);
+    }
+    this->Emit(tree, node.LeftChild(), out[out_nidx].LeftChild(), p_out);
+    this->Emit(tree, node.RightChild(), out[out_nidx].RightChild(), p_out);
+  }
+
+  // Sum of the output and the absolute output of each tree, and the number of samples.
+  [[nodiscard]] std::vector<double> Contribution(DMatrix* p_fmat,
+                                                 std::vector<RegTree*> const& trees) const {
+    auto n_trees = trees.size();
+    auto n_threads = ctx_->Threads();
+    std::vector<double> tloc(n_threads * n_trees * 2, 0.0);
+    std::vector<RegTree::FVec> feats(n_threads);
+    for (auto& fvec : feats) {
+      fvec.Init(trees.front()->NumFeatures());
+    }
+    double n_samples = 0;
+    for (auto const& batch : p_fmat->GetBatches<SparsePage>()) {
+      auto page = batch.GetView();
+      common::ParallelFor(batch.Size(), n_threads, [&](auto i) {
+        auto tidx = common::ThreadIdx();
+        auto& fvec = feats[tidx];
+        fvec.Fill(page[i]);
+        for (std::size_t t = 0; t < n_trees; ++t) {
+          auto const& tree = *trees[t];
+          auto cats = tree.GetCategoriesMatrix();
+          bst_node_t nidx = 0;
+          while (!tree[nidx].IsLeaf()) {
+            auto fidx = tree[nidx].SplitIndex();
+            nidx = predictor::GetNextNode<true, true>(tree[nidx], nidx, fvec.GetFvalue(fidx),
+                                                      fvec.IsMissing(fidx), cats);
+          }
+          auto value = tree[nidx].LeafValue();
+          auto* out = tloc.data() + (tidx * n_trees + t) * 2;
+          out[0] += value;
+          out[1] += std::abs(value);
+        }
+        fvec.Drop();
+      });
+      n_samples += batch.Size();
+    }
+
+    std::vector<double> result(n_trees * 2 + 1, 0.0);
+    for (std::int32_t tidx = 0; tidx < n_threads; ++tidx) {
+      for (std::size_t i = 0; i < n_trees * 2; ++i) {
+        result[i] += tloc[tidx * n_trees * 2 + i];
+      }
+    }
+    result.back() = n_samples;
+    auto rc = collective::GlobalSum(ctx_, p_fmat->Info(),
+                                    linalg::MakeVec(result.data(), result.size()));
+    collective::SafeColl(rc);
+    return result;
+  }
+
+ public:
+  explicit TreeCompactor(Context const* ctx) : TreeUpdater(ctx) {
+    monitor_.Init("TreeCompactor");
+  }
+  [[nodiscard]] char const* Name() const override { return "compact"; }
+  void Configure(const Args& args) override { param_.UpdateAllowUnknown(args); }
+
+  void LoadConfig(Json const& in) override {
+    auto const& config = get<Object const>(in);
+    FromJson(config.at("compact_train_param"), &param_);
+  }
+  void SaveConfig(Json* p_out) const override {
+    auto& out = *p_out;
+    out["compact_train_param"] = ToJson(param_);
+  }
+  [[nodiscard]] bool CanModifyTree() const override { return true; }
+
+  void Update(TrainParam const*, linalg::Matrix<GradientPair>*, DMatrix* p_fmat,
+              common::Span<HostDeviceVector<bst_node_t>>,
+              const std::vector<RegTree*>& trees) override {
+    if (trees.empty()) {
+      return;
+    }
+    monitor_.Start(__func__);
+    std::vector<double> contribution;
+    if (param_.compact_drop_threshold > 0.0f) {
+      CHECK(!p_fmat->Info().IsColumnSplit())
+          << "Dropping trees is not supported for column-split data.";
+      contribution = this->Contribution(p_fmat, trees);
+    }
+
+    for (std::size_t t = 0; t < trees.size(); ++t) {
+      auto& tree = *trees[t];
+      if (tree.IsMultiTarget()) {
+        LOG(WARNING) << "Multi-target trees are not compacted.";
+        continue;
+      }
+      RegTree out{1, tree.NumFeatures()};
+      auto n_samples = contribution.empty() ? 0.0 : contribution.back();
+      if (n_samples > 0 && contribution[t * 2 + 1] / n_samples < param_.compact_drop_threshold) {
+        out[RegTree::kRoot].SetLeaf(static_cast<float>(contribution[t * 2] / n_samples));
+        out.Stat(RegTree::kRoot) = tree.Stat(RegTree::kRoot);
+        tree = std::move(out);
+        continue;
+      }
+
+      bounds_.assign(tree.NumFeatures(), Bound{});
+      resolved_.assign(tree.NumNodes(), RegTree::kInvalidNodeId);
+      is_constant_.assign(tree.NumNodes(), false);
+      constant_.assign(tree.NumNodes(), 0.0f);
+      this->Analyze(tree, RegTree::kRoot);
+      this->Emit(tree, RegTree::kRoot, RegTree::kRoot, &out);
+      LOG(INFO) << "tree compaction end, " << tree.NumExtraNodes() << " extra nodes before, "
+                << out.NumExtraNodes() << " after.";
+      tree = std::move(out);
+    }
+    monitor_.Stop(__func__);
+  }
+};
+
+XGBOOST_REGISTER_TREE_UPDATER(TreeCompactor, "compact")
+    .describe("Compactor that removes redundant nodes from the trees.")
+    .set_body([](Context const* ctx, ObjInfo const*) { return new TreeCompactor{ctx}; });
 }  // namespace xgboost::tree
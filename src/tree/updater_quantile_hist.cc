@@ -4,23 +4,27 @@
  * \brief use quantized feature values to construct a tree
  * \author Philip Cho, Tianqi Checn, Egor Smirnov
  */
-#include <algorithm>  // for max, copy, transform
+#include <algorithm>  // for max, copy, transform, fill
 #include <cstddef>    // for size_t
 #include <cstdint>    // for uint32_t, int32_t
 #include <memory>     // for allocator, unique_ptr, make_unique, shared_ptr
 #include <ostream>    // for operator<<, basic_ostream, char_traits
-#include <utility>    // for move
+#include <utility>    // for move, exchange
 #include <vector>     // for vector
 
 #include "../collective/aggregator.h"        // for GlobalSum
+#include "../collective/comm_group.h"        // for GlobalCommGroup
 #include "../collective/communicator-inl.h"  // for IsDistributed
+#include "../collective/stats.h"             // for CollStats
+#include "../common/common.h"                // for DivRoundUp
 #include "../common/hist_util.h"             // for HistogramCuts, GHistRow
 #include "../common/linalg_op.h"             // for begin, cbegin, cend
 #include "../common/random.h"                // for ColumnSampler
 #include "../common/threading_utils.h"       // for ParallelFor
 #include "../common/timer.h"                 // for Monitor
+#include "../common/trace.h"                 // for TraceScope
 #include "../data/gradient_index.h"          // for GHistIndexMatrix
-#include "common_row_partitioner.h"          // for CommonRowPartitioner
+#include "common_row_partitioner.h"          // for RowPartitioners
 #include "dmlc/registry.h"                   // for DMLC_REGISTRY_FILE_TAG
 #include "driver.h"                          // for Driver
 #include "hist/evaluate_splits.h"            // for HistEvaluator, HistMultiEvaluator, UpdatePre...
@@ -28,8 +32,11 @@
 #include "hist/hist_cache.h"                 // for BoundedHistCollection
 #include "hist/histogram.h"                  // for MultiHistogramBuilder
 #include "hist/param.h"                      // for HistMakerTrainParam
+#include "hist/quantiser.h"                  // for HistQuantiser
 #include "hist/sampler.h"                    // for SampleGradient
 #include "param.h"                           // for TrainParam, GradStats
+#include "sample_position.h"                 // for SamplePosition
+#include "tree_telemetry.h"                  // for PhaseTimer, TreeRecordScope, CurrentTreeRecord
 #include "xgboost/base.h"                    // for Args, GradientPairPrecise, GradientPair, Gra...
 #include "xgboost/context.h"                 // for Context
 #include "xgboost/data.h"                    // for BatchSet, DMatrix, BatchIterator, MetaInfo
@@ -37,6 +44,7 @@
 #include "xgboost/json.h"                    // for Object, Json, FromJson, ToJson, get
 #include "xgboost/linalg.h"                  // for MatrixView, TensorView, All, Matrix, Empty
 #include "xgboost/logging.h"                 // for LogCheck_EQ, CHECK_EQ, CHECK, LogCheck_GE
+#include "xgboost/objective.h"               // for RowGradient
 #include "xgboost/span.h"                    // for Span, operator!=, SpanIterator
 #include "xgboost/string_view.h"             // for operator<<
 #include "xgboost/task.h"                    // for ObjInfo
@@ -49,17 +57,84 @@ DMLC_REGISTRY_FILE_TAG(updater_quantile_hist);
 
 BatchParam HistBatch(TrainParam const *param) { return {param->max_bin, param->sparse_threshold}; }
 
+/**
+ * @brief Initialize the row partitioner of each page and return the number of bins.
+ *
+ * @param is_compacted Whether only the sampled rows are placed in the root node.
+ */
+bst_bin_t InitPartitioners(Context const *ctx, DMatrix *p_fmat, TrainParam const *param,
+                           linalg::MatrixView<GradientPair const> gpair, bool is_compacted,
+                           RowPartitioners *p_partitioners) {
+  PhaseTimer timer{TreePhase::kPartition};
+  p_partitioners->SetNumSamples(p_fmat->Info().num_row_);
+  return p_partitioners->Visit([&](auto &partitioners) {
+    bst_bin_t n_total_bins{0};
+    std::size_t page_idx{0};
+    for (auto const &page : p_fmat->GetBatches<GHistIndexMatrix>(ctx, HistBatch(param))) {
+      if (n_total_bins == 0) {
+        n_total_bins = page.cut.TotalBins();
+      } else {
+        CHECK_EQ(n_total_bins, page.cut.TotalBins());
+      }
+      if (page_idx == partitioners.size()) {
+        partitioners.emplace_back();
+      }
+      if (is_compacted) {
+        auto page_gpair = gpair.Slice(
+            linalg::Range(page.base_rowid, page.base_rowid + page.Size()), linalg::All());
+        partitioners[page_idx].Reset(ctx, page.base_rowid, page_gpair);
+      } else {
+        partitioners[page_idx].Reset(ctx, page.Size(), page.base_rowid,
+                                     p_fmat->Info().IsColumnSplit());
+      }
+      page_idx++;
+    }
+    partitioners.resize(page_idx);
+    return n_total_bins;
+  });
+}
+
+/**
+ * @brief Record the number of rows in each of the nodes to be partitioned.
+ */
+template <typename ExpandEntry>
+void RecordLevelRows(RowPartitioners const &partitioner, std::vector<ExpandEntry> const &nodes) {
+  auto *record = CurrentTreeRecord();
+  if (!record) {
+    return;
+  }
+  partitioner.Visit([&](auto const &partitioners) {
+    for (auto const &node : nodes) {
+      bst_idx_t n_rows{0};
+      for (auto const &part : partitioners) {
+        n_rows += part.Partitions()[node.nid].Size();
+      }
+      record->AddLevelRows(node.depth, n_rows);
+    }
+  });
+}
+
+/**
+ * @brief Exclude the rows that are not sampled, or have truncated gradient, from the tree
+ *        building. Column split requires the same rows in all workers for partitioning.
+ */
+bool CompactSampledRows(TrainParam const *param, ObjInfo const *task, DMatrix const *p_fmat) {
+  return (param->subsample < 1.0f || task->sparse_grad) && !p_fmat->Info().IsColumnSplit();
+}
+
 template <typename ExpandEntry, typename Updater>
 void UpdateTree(common::Monitor *monitor_, linalg::MatrixView<GradientPair const> gpair,
                 Updater *updater, DMatrix *p_fmat, TrainParam const *param,
+                HistQuantiser const *quantiser, FusedGradient const *fused,
                 HostDeviceVector<bst_node_t> *p_out_position, RegTree *p_tree) {
   monitor_->Start(__func__);
-  updater->InitData(p_fmat, p_tree);
+  updater->InitData(p_fmat, p_tree, gpair, quantiser);
 
   Driver<ExpandEntry> driver{*param};
   auto const &tree = *p_tree;
-  driver.Push(updater->InitRoot(p_fmat, gpair, p_tree));
-  auto expand_set = driver.Pop();
+  driver.Push(updater->InitRoot(p_fmat, gpair, p_tree, fused));
+  std::vector<ExpandEntry> expand_set;
+  driver.Pop(&expand_set);
 
   /**
    * Note for update position
@@ -70,11 +145,20 @@ void UpdateTree(common::Monitor *monitor_, linalg::MatrixView<GradientPair const
    *   Not applied: That node is root of the subtree, same rule as root.
    *   Applied: Ditto
    */
+  // Buffers for each level, reused to avoid allocation.
+  // candidates that can be further splited.
+  std::vector<ExpandEntry> valid_candidates;
+  // candidaates that can be applied.
+  std::vector<ExpandEntry> applied;
+  std::vector<ExpandEntry> best_splits;
   while (!expand_set.empty()) {
-    // candidates that can be further splited.
-    std::vector<ExpandEntry> valid_candidates;
-    // candidaates that can be applied.
-    std::vector<ExpandEntry> applied;
+    common::TraceScope trace{common::TraceEvent::kTreeLevel, expand_set.front().depth};
+    if (auto *record = CurrentTreeRecord()) {
+      record->n_expanded += static_cast<bst_node_t>(expand_set.size());
+    }
+    valid_candidates.clear();
+    applied.clear();
+    best_splits.clear();
     for (auto const &candidate : expand_set) {
       updater->ApplyTreeSplit(candidate, p_tree);
       CHECK_GT(p_tree->LeftChild(candidate.nid), candidate.nid);
@@ -86,7 +170,6 @@ void UpdateTree(common::Monitor *monitor_, linalg::MatrixView<GradientPair const
 
     updater->UpdatePosition(p_fmat, p_tree, applied);
 
-    std::vector<ExpandEntry> best_splits;
     if (!valid_candidates.empty()) {
       updater->BuildHistogram(p_fmat, p_tree, valid_candidates, gpair);
       for (auto const &candidate : valid_candidates) {
@@ -100,7 +183,7 @@ void UpdateTree(common::Monitor *monitor_, linalg::MatrixView<GradientPair const
       updater->EvaluateSplits(p_fmat, p_tree, &best_splits);
     }
     driver.Push(best_splits.begin(), best_splits.end());
-    expand_set = driver.Pop();
+    driver.Pop(&expand_set);
   }
 
   auto &h_out_position = p_out_position->HostVector();
@@ -123,10 +206,12 @@ class MultiTargetHistBuilder {
   std::unique_ptr<MultiHistogramBuilder> histogram_builder_;
   Context const *ctx_{nullptr};
   // Partitioner for each data batch.
-  std::vector<CommonRowPartitioner> partitioner_;
+  RowPartitioners partitioner_;
   // Pointer to last updated tree, used for update prediction cache.
   RegTree const *p_last_tree_{nullptr};
   DMatrix const *p_last_fmat_{nullptr};
+  // Whether the partitioners contain only the sampled rows.
+  bool is_compacted_{false};
 
   ObjInfo const *task_{nullptr};
 
@@ -134,9 +219,13 @@ class MultiTargetHistBuilder {
   void UpdatePosition(DMatrix *p_fmat, RegTree const *p_tree,
                       std::vector<MultiExpandEntry> const &applied) {
     monitor_->Start(__func__);
+    PhaseTimer timer{TreePhase::kPartition};
+    RecordLevelRows(partitioner_, applied);
     std::size_t page_id{0};
     for (auto const &page : p_fmat->GetBatches<GHistIndexMatrix>(ctx_, HistBatch(this->param_))) {
-      this->partitioner_.at(page_id).UpdatePosition(this->ctx_, page, applied, p_tree);
+      this->partitioner_.Visit([&](auto &partitioners) {
+        partitioners.at(page_id).UpdatePosition(this->ctx_, page, applied, p_tree);
+      });
       page_id++;
     }
     monitor_->Stop(__func__);
@@ -146,34 +235,31 @@ class MultiTargetHistBuilder {
     this->evaluator_->ApplyTreeSplit(candidate, p_tree);
   }
 
-  void InitData(DMatrix *p_fmat, RegTree const *p_tree) {
+  void InitData(DMatrix *p_fmat, RegTree const *p_tree,
+                linalg::MatrixView<GradientPair const> gpair, HistQuantiser const *quantiser) {
     monitor_->Start(__func__);
 
     p_last_fmat_ = p_fmat;
-    bst_bin_t n_total_bins = 0;
-    partitioner_.clear();
-    for (auto const &page : p_fmat->GetBatches<GHistIndexMatrix>(ctx_, HistBatch(param_))) {
-      if (n_total_bins == 0) {
-        n_total_bins = page.cut.TotalBins();
-      } else {
-        CHECK_EQ(n_total_bins, page.cut.TotalBins());
-      }
-      partitioner_.emplace_back(ctx_, page.Size(), page.base_rowid, p_fmat->Info().IsColumnSplit());
-    }
+    is_compacted_ = CompactSampledRows(param_, task_, p_fmat);
+    auto n_total_bins =
+        InitPartitioners(ctx_, p_fmat, param_, gpair, is_compacted_, &partitioner_);
 
     bst_target_t n_targets = p_tree->NumTargets();
     histogram_builder_ = std::make_unique<MultiHistogramBuilder>();
     histogram_builder_->Reset(ctx_, n_total_bins, n_targets, HistBatch(param_),
                               collective::IsDistributed(), p_fmat->Info().IsColumnSplit(),
-                              hist_param_);
+                              hist_param_, quantiser);
 
     evaluator_ = std::make_unique<HistMultiEvaluator>(ctx_, p_fmat->Info(), param_, col_sampler_);
+    histogram_builder_->SetFeatureSet(col_sampler_->GetTreeFeatureSet()->ConstHostSpan(),
+                                      p_fmat->Info().num_col_);
     p_last_tree_ = p_tree;
     monitor_->Stop(__func__);
   }
 
   MultiExpandEntry InitRoot(DMatrix *p_fmat, linalg::MatrixView<GradientPair const> gpair,
-                            RegTree *p_tree) {
+                            RegTree *p_tree, FusedGradient const *fused) {
+    CHECK(!fused) << "The gradient of multi-target trees must be computed before the update.";
     monitor_->Start(__func__);
     MultiExpandEntry best;
     best.nid = RegTree::kRoot;
@@ -186,7 +272,7 @@ class MultiTargetHistBuilder {
     auto h_root_sum_tloc = root_sum_tloc.HostView();
     common::ParallelFor(gpair.Shape(0), ctx_->Threads(), [&](auto i) {
       for (bst_target_t t{0}; t < n_targets; ++t) {
-        h_root_sum_tloc(omp_get_thread_num(), t) += GradientPairPrecise{gpair(i, t)};
+        h_root_sum_tloc(common::ThreadIdx(), t) += GradientPairPrecise{gpair(i, t)};
       }
     });
     // Aggregate to the first row.
@@ -202,7 +288,11 @@ class MultiTargetHistBuilder {
         linalg::MakeVec(reinterpret_cast<double *>(root_sum.Values().data()), root_sum.Size() * 2));
     collective::SafeColl(rc);
 
-    histogram_builder_->BuildRootHist(p_fmat, p_tree, partitioner_, gpair, best, HistBatch(param_));
+    partitioner_.Visit([&](auto const &partitioners) {
+      PhaseTimer timer{TreePhase::kBuildHist};
+      histogram_builder_->BuildRootHist(p_fmat, p_tree, partitioners, gpair, best,
+                                        HistBatch(param_));
+    });
 
     auto weight = evaluator_->InitRoot(root_sum);
     auto weight_t = weight.HostView();
@@ -216,6 +306,7 @@ class MultiTargetHistBuilder {
       hists.push_back(&(*histogram_builder_).Histogram(t));
     }
     for (auto const &gmat : p_fmat->GetBatches<GHistIndexMatrix>(ctx_, HistBatch(param_))) {
+      PhaseTimer timer{TreePhase::kEvaluate};
       evaluator_->EvaluateSplits(*p_tree, hists, gmat.cut, &nodes);
       break;
     }
@@ -228,14 +319,18 @@ class MultiTargetHistBuilder {
                       std::vector<MultiExpandEntry> const &valid_candidates,
                       linalg::MatrixView<GradientPair const> gpair) {
     monitor_->Start(__func__);
-    histogram_builder_->BuildHistLeftRight(ctx_, p_fmat, p_tree, partitioner_, valid_candidates,
-                                           gpair, HistBatch(param_));
+    PhaseTimer timer{TreePhase::kBuildHist};
+    partitioner_.Visit([&](auto const &partitioners) {
+      histogram_builder_->BuildHistLeftRight(ctx_, p_fmat, p_tree, partitioners, valid_candidates,
+                                             gpair, HistBatch(param_));
+    });
     monitor_->Stop(__func__);
   }
 
   void EvaluateSplits(DMatrix *p_fmat, RegTree const *p_tree,
                       std::vector<MultiExpandEntry> *best_splits) {
     monitor_->Start(__func__);
+    PhaseTimer timer{TreePhase::kEvaluate};
     std::vector<BoundedHistCollection const *> hists;
     for (bst_target_t t{0}; t < p_tree->NumTargets(); ++t) {
       hists.push_back(&(*histogram_builder_).Histogram(t));
@@ -250,15 +345,22 @@ class MultiTargetHistBuilder {
   void LeafPartition(RegTree const &tree, linalg::MatrixView<GradientPair const> gpair,
                      std::vector<bst_node_t> *p_out_position) {
     monitor_->Start(__func__);
+    PhaseTimer timer{TreePhase::kLeafUpdate};
     if (!task_->UpdateTreeLeaf()) {
       monitor_->Stop(__func__);
       return;
     }
     p_out_position->resize(gpair.Shape(0));
-    for (auto const &part : partitioner_) {
-      part.LeafPartition(ctx_, tree, gpair,
-                         common::Span{p_out_position->data(), p_out_position->size()});
+    if (is_compacted_) {
+      std::fill(p_out_position->begin(), p_out_position->end(),
+                SamplePosition::Encode(RegTree::kRoot, false));
     }
+    partitioner_.Visit([&](auto const &partitioners) {
+      for (auto const &part : partitioners) {
+        part.LeafPartition(ctx_, tree, gpair,
+                           common::Span{p_out_position->data(), p_out_position->size()});
+      }
+    });
     monitor_->Stop(__func__);
   }
 
@@ -283,9 +385,16 @@ class MultiTargetHistBuilder {
     if (!p_last_fmat_ || !p_last_tree_ || data != p_last_fmat_) {
       return false;
     }
+    if (is_compacted_) {
+      // Rows that are not sampled are not in the partitions.
+      return false;
+    }
     monitor_->Start(__func__);
+    PhaseTimer timer{TreePhase::kPredictionCache};
     CHECK_EQ(out_preds.Size(), data->Info().num_row_ * p_last_tree_->NumTargets());
-    UpdatePredictionCacheImpl(ctx_, p_last_tree_, partitioner_, out_preds);
+    partitioner_.Visit([&](auto const &partitioners) {
+      UpdatePredictionCacheImpl(ctx_, p_last_tree_, partitioners, out_preds);
+    });
     monitor_->Stop(__func__);
     return true;
   }
@@ -301,11 +410,13 @@ class HistUpdater {
   HistMakerTrainParam const *hist_param_{nullptr};
   std::shared_ptr<common::ColumnSampler> col_sampler_;
   std::unique_ptr<HistEvaluator> evaluator_;
-  std::vector<CommonRowPartitioner> partitioner_;
+  RowPartitioners partitioner_;
 
   // back pointers to tree and data matrix
   const RegTree *p_last_tree_{nullptr};
   DMatrix const *const p_last_fmat_{nullptr};
+  // Whether the partitioners contain only the sampled rows.
+  bool is_compacted_{false};
 
   std::unique_ptr<MultiHistogramBuilder> histogram_builder_;
   ObjInfo const *task_{nullptr};
@@ -334,77 +445,114 @@ class HistUpdater {
     if (!p_last_fmat_ || !p_last_tree_ || data != p_last_fmat_) {
       return false;
     }
+    if (is_compacted_) {
+      // Rows that are not sampled are not in the partitions.
+      return false;
+    }
     monitor_->Start(__func__);
+    PhaseTimer timer{TreePhase::kPredictionCache};
     CHECK_EQ(out_preds.Size(), data->Info().num_row_);
-    UpdatePredictionCacheImpl(ctx_, p_last_tree_, partitioner_, out_preds);
+    partitioner_.Visit([&](auto const &partitioners) {
+      UpdatePredictionCacheImpl(ctx_, p_last_tree_, partitioners, out_preds);
+    });
     monitor_->Stop(__func__);
     return true;
   }
 
  public:
   // initialize temp data structure
-  void InitData(DMatrix *fmat, RegTree const *p_tree) {
+  void InitData(DMatrix *fmat, RegTree const *p_tree, linalg::MatrixView<GradientPair const> gpair,
+                HistQuantiser const *quantiser) {
     monitor_->Start(__func__);
-    bst_bin_t n_total_bins{0};
-    size_t page_idx = 0;
-    for (auto const &page : fmat->GetBatches<GHistIndexMatrix>(ctx_, HistBatch(param_))) {
-      if (n_total_bins == 0) {
-        n_total_bins = page.cut.TotalBins();
-      } else {
-        CHECK_EQ(n_total_bins, page.cut.TotalBins());
-      }
-      if (page_idx < partitioner_.size()) {
-        partitioner_[page_idx].Reset(this->ctx_, page.Size(), page.base_rowid,
-                                     fmat->Info().IsColumnSplit());
-      } else {
-        partitioner_.emplace_back(this->ctx_, page.Size(), page.base_rowid,
-                                  fmat->Info().IsColumnSplit());
-      }
-      page_idx++;
-    }
+    is_compacted_ = CompactSampledRows(param_, task_, fmat);
+    auto n_total_bins = InitPartitioners(ctx_, fmat, param_, gpair, is_compacted_, &partitioner_);
     histogram_builder_->Reset(ctx_, n_total_bins, 1, HistBatch(param_), collective::IsDistributed(),
-                              fmat->Info().IsColumnSplit(), hist_param_);
+                              fmat->Info().IsColumnSplit(), hist_param_, quantiser);
+    histogram_builder_->EnableVoting(hist_param_->voting_top_k);
     evaluator_ = std::make_unique<HistEvaluator>(ctx_, this->param_, fmat->Info(), col_sampler_);
+    histogram_builder_->SetFeatureSet(col_sampler_->GetTreeFeatureSet()->ConstHostSpan(),
+                                      fmat->Info().num_col_);
+    if (this->UsePositions(fmat)) {
+      partitioner_.Visit([&](auto &partitioners) {
+        partitioners.front().StartPositions(ctx_, fmat->Info().num_row_);
+      });
+    }
     p_last_tree_ = p_tree;
     monitor_->Stop(__func__);
   }
+  /**
+   * @brief Whether the shallow nodes are built from the node positions, see @ref
+   *        HistMakerTrainParam::position_max_depth.
+   */
+  [[nodiscard]] bool UsePositions(DMatrix const *p_fmat) const {
+    auto n_pages = partitioner_.Visit([](auto const &partitioners) { return partitioners.size(); });
+    return hist_param_->position_max_depth > 0 && param_->grow_policy == TrainParam::kDepthWise &&
+           n_pages == 1 && !p_fmat->Info().IsColumnSplit() && !collective::IsDistributed();
+  }
 
   void EvaluateSplits(DMatrix *p_fmat, RegTree const *p_tree,
                       std::vector<CPUExpandEntry> *best_splits) {
     monitor_->Start(__func__);
+    PhaseTimer timer{TreePhase::kEvaluate};
     auto const &histograms = histogram_builder_->Histogram(0);
     auto ft = p_fmat->Info().feature_types.ConstHostSpan();
     for (auto const &gmat : p_fmat->GetBatches<GHistIndexMatrix>(ctx_, HistBatch(param_))) {
-      evaluator_->EvaluateSplits(histograms, gmat.cut, ft, *p_tree, best_splits);
+      if (histogram_builder_->UseVoting()) {
+        this->EvaluateVoted(gmat.cut, ft, p_tree, best_splits);
+      } else {
+        evaluator_->EvaluateSplits(histograms, gmat.cut, ft, *p_tree, best_splits);
+      }
       break;
     }
     monitor_->Stop(__func__);
   }
+  /**
+   * @brief Voting-parallel split finding, the histograms of the builder are local.
+   */
+  void EvaluateVoted(common::HistogramCuts const &cut, common::Span<FeatureType const> ft,
+                     RegTree const *p_tree, std::vector<CPUExpandEntry> *entries) {
+    auto &builder = histogram_builder_->Builder(0);
+    auto votes = evaluator_->VoteFeatures(builder.Histogram(), builder.LocalSums(), cut, ft,
+                                          *p_tree, *entries, builder.VotingTopK());
+    std::vector<bst_node_t> nodes(entries->size());
+    std::transform(entries->cbegin(), entries->cend(), nodes.begin(),
+                   [](auto const &e) { return e.nid; });
+    std::vector<std::vector<bst_feature_t>> selected;
+    builder.ReduceVoted(ctx_, cut, nodes, votes, &selected);
+    evaluator_->EvaluateSplits(builder.VotedHistogram(), cut, ft, *p_tree, entries, &selected);
+  }
 
   void ApplyTreeSplit(CPUExpandEntry const &candidate, RegTree *p_tree) {
     this->evaluator_->ApplyTreeSplit(candidate, p_tree);
   }
 
   CPUExpandEntry InitRoot(DMatrix *p_fmat, linalg::MatrixView<GradientPair const> gpair,
-                          RegTree *p_tree) {
+                          RegTree *p_tree, FusedGradient const *fused) {
     monitor_->Start(__func__);
     CPUExpandEntry node(RegTree::kRoot, p_tree->GetDepth(0));
 
-    this->histogram_builder_->BuildRootHist(p_fmat, p_tree, partitioner_, gpair, node,
-                                            HistBatch(param_));
+    // The gradient is available after the root histogram is built.
+    partitioner_.Visit([&](auto const &partitioners) {
+      PhaseTimer timer{TreePhase::kBuildHist};
+      this->histogram_builder_->BuildRootHist(p_fmat, p_tree, partitioners, gpair, node,
+                                              HistBatch(param_), false, fused);
+    });
 
     {
       GradientPairPrecise grad_stat;
       if (p_fmat->IsDense() && !collective::IsDistributed()) {
         /**
          * Specialized code for dense data: For dense data (with no missing value), the sum
-         * of gradient histogram is equal to snode[nid]
+         * of gradient histogram is equal to snode[nid]. Use the first feature sampled for
+         * this tree as the histogram of other features might not be built.
          */
         auto const &gmat = *(p_fmat->GetBatches<GHistIndexMatrix>(ctx_, HistBatch(param_)).begin());
         std::vector<std::uint32_t> const &row_ptr = gmat.cut.Ptrs();
         CHECK_GE(row_ptr.size(), 2);
-        std::uint32_t const ibegin = row_ptr[0];
-        std::uint32_t const iend = row_ptr[1];
+        auto const &h_features = col_sampler_->GetTreeFeatureSet()->ConstHostVector();
+        CHECK(!h_features.empty());
+        std::uint32_t const ibegin = row_ptr[h_features.front()];
+        std::uint32_t const iend = row_ptr[h_features.front() + 1];
         auto hist = this->histogram_builder_->Histogram(0)[RegTree::kRoot];
         auto begin = hist.data();
         for (std::uint32_t i = ibegin; i < iend; ++i) {
@@ -428,10 +576,15 @@ class HistUpdater {
 
       std::vector<CPUExpandEntry> entries{node};
       monitor_->Start("EvaluateSplits");
+      PhaseTimer timer{TreePhase::kEvaluate};
       auto ft = p_fmat->Info().feature_types.ConstHostSpan();
       for (auto const &gmat : p_fmat->GetBatches<GHistIndexMatrix>(ctx_, HistBatch(param_))) {
-        evaluator_->EvaluateSplits(histogram_builder_->Histogram(0), gmat.cut, ft, *p_tree,
-                                   &entries);
+        if (histogram_builder_->UseVoting()) {
+          this->EvaluateVoted(gmat.cut, ft, p_tree, &entries);
+        } else {
+          evaluator_->EvaluateSplits(histogram_builder_->Histogram(0), gmat.cut, ft, *p_tree,
+                                     &entries);
+        }
         break;
       }
       monitor_->Stop("EvaluateSplits");
@@ -446,17 +599,40 @@ class HistUpdater {
                       std::vector<CPUExpandEntry> const &valid_candidates,
                       linalg::MatrixView<GradientPair const> gpair) {
     monitor_->Start(__func__);
-    this->histogram_builder_->BuildHistLeftRight(ctx_, p_fmat, p_tree, partitioner_,
-                                                 valid_candidates, gpair, HistBatch(param_));
+    PhaseTimer timer{TreePhase::kBuildHist};
+    partitioner_.Visit([&](auto const &partitioners) {
+      if (partitioners.front().ByPosition()) {
+        this->histogram_builder_->BuildHistByPosition(ctx_, p_fmat, p_tree, partitioners,
+                                                      valid_candidates, gpair, HistBatch(param_));
+      } else {
+        this->histogram_builder_->BuildHistLeftRight(ctx_, p_fmat, p_tree, partitioners,
+                                                     valid_candidates, gpair, HistBatch(param_));
+      }
+    });
     monitor_->Stop(__func__);
   }
 
   void UpdatePosition(DMatrix *p_fmat, RegTree const *p_tree,
                       std::vector<CPUExpandEntry> const &applied) {
     monitor_->Start(__func__);
+    PhaseTimer timer{TreePhase::kPartition};
+    RecordLevelRows(partitioner_, applied);
+    // Depth of the children, the histograms of which are built next.
+    bst_node_t depth{0};
+    for (auto const &c : applied) {
+      depth = std::max(depth, c.depth + 1);
+    }
     std::size_t page_id{0};
     for (auto const &page : p_fmat->GetBatches<GHistIndexMatrix>(ctx_, HistBatch(param_))) {
-      this->partitioner_.at(page_id).UpdatePosition(this->ctx_, page, applied, p_tree);
+      this->partitioner_.Visit([&](auto &partitioners) {
+        auto &part = partitioners.at(page_id);
+        if (part.ByPosition() &&
+            (depth > hist_param_->position_max_depth ||
+             !histogram_builder_->Builder(0).CanBuildByPosition(page, applied.size()))) {
+          part.Materialize(this->ctx_);
+        }
+        part.UpdatePosition(this->ctx_, page, applied, p_tree);
+      });
       page_id++;
     }
     monitor_->Stop(__func__);
@@ -465,15 +641,28 @@ class HistUpdater {
   void LeafPartition(RegTree const &tree, linalg::MatrixView<GradientPair const> gpair,
                      std::vector<bst_node_t> *p_out_position) {
     monitor_->Start(__func__);
+    PhaseTimer timer{TreePhase::kLeafUpdate};
+    // The prediction cache needs the row partitions as well.
+    partitioner_.Visit([&](auto &partitioners) {
+      for (auto &part : partitioners) {
+        part.Materialize(ctx_);
+      }
+    });
     if (!task_->UpdateTreeLeaf()) {
       monitor_->Stop(__func__);
       return;
     }
     p_out_position->resize(gpair.Shape(0));
-    for (auto const &part : partitioner_) {
-      part.LeafPartition(ctx_, tree, gpair,
-                         common::Span{p_out_position->data(), p_out_position->size()});
+    if (is_compacted_) {
+      std::fill(p_out_position->begin(), p_out_position->end(),
+                SamplePosition::Encode(RegTree::kRoot, false));
     }
+    partitioner_.Visit([&](auto const &partitioners) {
+      for (auto const &part : partitioners) {
+        part.LeafPartition(ctx_, tree, gpair,
+                           common::Span{p_out_position->data(), p_out_position->size()});
+      }
+    });
     monitor_->Stop(__func__);
   }
 };
@@ -487,6 +676,9 @@ class QuantileHistMaker : public TreeUpdater {
   common::Monitor monitor_;
   ObjInfo const *task_{nullptr};
   HistMakerTrainParam hist_param_;
+  HistQuantiser quantiser_;
+  // Gradient to be computed during the next update, set by `FuseGradient`.
+  RowGradient const *fused_grad_{nullptr};
 
  public:
   explicit QuantileHistMaker(Context const *ctx, ObjInfo const *task)
@@ -510,6 +702,11 @@ class QuantileHistMaker : public TreeUpdater {
     if (!column_sampler_) {
       column_sampler_ = common::MakeColumnSampler(ctx_);
     }
+    // Measure the local work for finding the stragglers in row-split training.
+    auto *coll_stats = collective::GlobalCommGroup()->Stats();
+    bool record_load = collective::IsDistributed() && p_fmat->Info().IsRowSplit();
+    auto wait_before = record_load ? coll_stats->Total().wait : 0.0;
+    common::Timer load_timer;
 
     if (trees.front()->IsMultiTarget()) {
       CHECK(hist_param_.GetInitialised());
@@ -529,6 +726,26 @@ class QuantileHistMaker : public TreeUpdater {
     bst_target_t n_targets = trees.front()->NumTargets();
     auto h_gpair = gpair->HostView();
 
+    FusedGradient fused;
+    if (auto fn = std::exchange(fused_grad_, nullptr)) {
+      CHECK_EQ(n_targets, 1);
+      CHECK(h_gpair.CContiguous());
+      if (trees.size() == 1 && param->subsample >= 1.0 && !hist_param_.quantise_gradient) {
+        // Computed by the root histogram pass.
+        fused = FusedGradient{fn, h_gpair.Values()};
+      } else {
+        // The sampling and the quantiser need the gradient before building the tree.
+        PhaseTimer timer{TreePhase::kGradient};
+        constexpr std::size_t kBlockOfRows = 2048;
+        std::size_t n_samples = h_gpair.Shape(0);
+        auto n_blocks = common::DivRoundUp(n_samples, kBlockOfRows);
+        common::ParallelFor(n_blocks, ctx_->Threads(), [&](std::size_t block) {
+          std::size_t begin = block * kBlockOfRows;
+          (*fn)(begin, std::min(n_samples, begin + kBlockOfRows), h_gpair.Values());
+        });
+      }
+    }
+
     linalg::Matrix<GradientPair> sample_out;
     auto h_sample_out = h_gpair;
     auto need_copy = [&] {
@@ -541,23 +758,41 @@ class QuantileHistMaker : public TreeUpdater {
     }
 
     for (auto tree_it = trees.begin(); tree_it != trees.end(); ++tree_it) {
+      TreeRecordScope record;
       if (need_copy()) {
         // Copy gradient into buffer for sampling. This converts C-order to F-order.
         std::copy(linalg::cbegin(h_gpair), linalg::cend(h_gpair), linalg::begin(h_sample_out));
       }
       error::NoPageConcat(this->hist_param_.extmem_single_page);
-      SampleGradient(ctx_, *param, h_sample_out);
+      HistQuantiser const *p_quantiser{nullptr};
+      {
+        PhaseTimer timer{TreePhase::kSampling};
+        SampleGradient(ctx_, *param, h_sample_out);
+        if (hist_param_.quantise_gradient) {
+          quantiser_ = HistQuantiser{ctx_, p_fmat->Info(), h_sample_out};
+          quantiser_.Quantise(ctx_, h_sample_out);
+          p_quantiser = &quantiser_;
+        }
+      }
       auto *h_out_position = &out_position[tree_it - trees.begin()];
       if ((*tree_it)->IsMultiTarget()) {
         UpdateTree<MultiExpandEntry>(&monitor_, h_sample_out, p_mtimpl_.get(), p_fmat, param,
-                                     h_out_position, *tree_it);
+                                     p_quantiser, nullptr, h_out_position, *tree_it);
       } else {
         UpdateTree<CPUExpandEntry>(&monitor_, h_sample_out, p_impl_.get(), p_fmat, param,
-                                   h_out_position, *tree_it);
+                                   p_quantiser, fused.fn ? &fused : nullptr, h_out_position,
+                                   *tree_it);
       }
 
       hist_param_.CheckTreesSynchronized(ctx_, *tree_it);
     }
+
+    if (record_load) {
+      load_timer.Stop();
+      auto wait = coll_stats->Total().wait - wait_before;
+      coll_stats->RecordLoad(static_cast<std::int64_t>(p_fmat->Info().num_row_),
+                             std::max(load_timer.ElapsedSeconds() - wait, 0.0));
+    }
   }
 
   bool UpdatePredictionCache(const DMatrix *data, linalg::MatrixView<float> out_preds) override {
@@ -571,6 +806,14 @@ class QuantileHistMaker : public TreeUpdater {
   }
 
   [[nodiscard]] bool HasNodePosition() const override { return true; }
+
+  bool FuseGradient(RowGradient const *fn) override {
+    if (!hist_param_.fuse_gradient) {
+      return false;
+    }
+    fused_grad_ = fn;
+    return true;
+  }
 };
 
 XGBOOST_REGISTER_TREE_UPDATER(QuantileHistMaker, "grow_quantile_histmaker")
@@ -6,10 +6,13 @@
  */
 #include <xgboost/tree_updater.h>
 
+#include <algorithm>  // for min, fill
+#include <cstddef>    // for size_t
 #include <limits>
 #include <vector>
 
 #include "../collective/allreduce.h"
+#include "../common/common.h"  // for DivRoundUp
 #include "../common/threading_utils.h"
 #include "../predictor/predict_fn.h"
 #include "./param.h"
@@ -38,49 +41,53 @@ class TreeRefresher : public TreeUpdater {
     }
     CHECK_EQ(gpair->Shape(1), 1) << MTNotImplemented();
     const std::vector<GradientPair> &gpair_h = gpair->Data()->ConstHostVector();
+    // Offset of each tree in the statistics.
+    std::vector<std::size_t> tree_ptr(trees.size() + 1, 0);
+    for (std::size_t i = 0; i < trees.size(); ++i) {
+      tree_ptr[i + 1] = tree_ptr[i] + trees[i]->NumNodes();
+    }
     // Thread local variables.
     std::vector<std::vector<GradStats> > stemp;
     std::vector<RegTree::FVec> fvec_temp;
     // setup temp space for each thread
     const int nthread = ctx_->Threads();
-    fvec_temp.resize(nthread, RegTree::FVec());
+    fvec_temp.resize(nthread * kBlockOfRowsSize, RegTree::FVec());
     stemp.resize(nthread, std::vector<GradStats>());
-    dmlc::OMPException exc;
-#pragma omp parallel num_threads(nthread)
-    {
-      exc.Run([&]() {
-        int tid = omp_get_thread_num();
-        int num_nodes = 0;
-        for (auto tree : trees) {
-          num_nodes += tree->NumNodes();
-        }
-        stemp[tid].resize(num_nodes, GradStats());
-        std::fill(stemp[tid].begin(), stemp[tid].end(), GradStats());
-        fvec_temp[tid].Init(trees[0]->NumFeatures());
-      });
-    }
-    exc.Rethrow();
+    common::ParallelRegion(nthread, [&](std::int32_t tid) {
+      stemp[tid].resize(tree_ptr.back(), GradStats());
+      std::fill(stemp[tid].begin(), stemp[tid].end(), GradStats());
+      for (std::size_t i = 0; i < kBlockOfRowsSize; ++i) {
+        fvec_temp[tid * kBlockOfRowsSize + i].Init(trees[0]->NumFeatures());
+      }
+    });
 
     auto get_stats = [&]() {
-      const MetaInfo &info = p_fmat->Info();
       // start accumulating statistics
       for (const auto &batch : p_fmat->GetBatches<SparsePage>()) {
         auto page = batch.GetView();
         CHECK_LT(batch.Size(), std::numeric_limits<unsigned>::max());
-        const auto nbatch = static_cast<bst_omp_uint>(batch.Size());
-        common::ParallelFor(nbatch, ctx_->Threads(), [&](bst_omp_uint i) {
-          SparsePage::Inst inst = page[i];
-          const int tid = omp_get_thread_num();
-          const auto ridx = static_cast<bst_uint>(batch.base_rowid + i);
-          RegTree::FVec &feats = fvec_temp[tid];
-          feats.Fill(inst);
-          int offset = 0;
-          for (auto tree : trees) {
-            AddStats(*tree, feats, gpair_h, info, ridx,
-                     dmlc::BeginPtr(stemp[tid]) + offset);
-            offset += tree->NumNodes();
+        auto n_blocks = common::DivRoundUp(batch.Size(), kBlockOfRowsSize);
+        // A block of rows goes through each tree together to keep the tree in cache.
+        common::ParallelFor(n_blocks, ctx_->Threads(), [&](std::size_t block_idx) {
+          const int tid = common::ThreadIdx();
+          auto begin = block_idx * kBlockOfRowsSize;
+          auto n_rows = std::min(kBlockOfRowsSize, batch.Size() - begin);
+          auto feats = common::Span{fvec_temp}.subspan(tid * kBlockOfRowsSize, n_rows);
+          for (std::size_t i = 0; i < n_rows; ++i) {
+            feats[i].Fill(page[begin + i]);
+          }
+          for (std::size_t k = 0; k < trees.size(); ++k) {
+            auto const ridx = batch.base_rowid + begin;
+            auto *gstats = stemp[tid].data() + tree_ptr[k];
+            if (trees[k]->HasCategoricalSplit()) {
+              AddLeafStats<true>(*trees[k], feats, gpair_h, ridx, gstats);
+            } else {
+              AddLeafStats<false>(*trees[k], feats, gpair_h, ridx, gstats);
+            }
+          }
+          for (auto &feat : feats) {
+            feat.Drop();
           }
-          feats.Drop();
         });
       }
       // aggregate the statistics
@@ -92,39 +99,50 @@ class TreeRefresher : public TreeUpdater {
       });
     };
     get_stats();
-    // Synchronize the aggregated result.
+    // Synchronize the aggregated result, a single call for all the trees.
     auto &sum_grad = stemp[0];
     // x2 for gradient and hessian.
     auto rc = collective::Allreduce(
         ctx_, linalg::MakeVec(&sum_grad.data()->sum_grad, sum_grad.size() * 2),
-        collective::Op::kMax);
+        collective::Op::kSum);
     collective::SafeColl(rc);
-    bst_node_t offset = 0;
-    for (auto tree : trees) {
-      this->Refresh(param, dmlc::BeginPtr(sum_grad) + offset, 0, tree);
-      offset += tree->NumNodes();
-    }
+    common::ParallelFor(trees.size(), ctx_->Threads(), [&](std::size_t k) {
+      auto *gstats = dmlc::BeginPtr(sum_grad) + tree_ptr[k];
+      AggregateStats(*trees[k], RegTree::kRoot, gstats);
+      this->Refresh(param, gstats, 0, trees[k]);
+    });
   }
 
  private:
-  inline static void AddStats(const RegTree &tree,
-                              const RegTree::FVec &feat,
-                              const std::vector<GradientPair> &gpair,
-                              const MetaInfo&,
-                              const bst_uint ridx,
-                              GradStats *gstats) {
-    // start from groups that belongs to current data
-    auto pid = 0;
-    gstats[pid].Add(gpair[ridx]);
-    auto const& cats = tree.GetCategoriesMatrix();
-    // traverse tree
-    while (!tree[pid].IsLeaf()) {
-      unsigned split_index = tree[pid].SplitIndex();
-      pid = predictor::GetNextNode<true, true>(
-          tree[pid], pid, feat.GetFvalue(split_index), feat.IsMissing(split_index),
-          cats);
-      gstats[pid].Add(gpair[ridx]);
+  // Number of rows that go through the trees together.
+  static constexpr std::size_t kBlockOfRowsSize = 64;
+
+  // Add the gradient of each row to the leaf it reaches, the statistics of the internal
+  // nodes are obtained later by @ref AggregateStats.
+  template <bool has_categorical>
+  static void AddLeafStats(RegTree const &tree, common::Span<RegTree::FVec> feats,
+                           std::vector<GradientPair> const &gpair, bst_idx_t base_ridx,
+                           GradStats *gstats) {
+    auto const &cats = tree.GetCategoriesMatrix();
+    for (std::size_t i = 0; i < feats.size(); ++i) {
+      auto const &feat = feats[i];
+      bst_node_t pid = RegTree::kRoot;
+      // traverse tree
+      while (!tree[pid].IsLeaf()) {
+        unsigned split_index = tree[pid].SplitIndex();
+        pid = predictor::GetNextNode<true, has_categorical>(
+            tree[pid], pid, feat.GetFvalue(split_index), feat.IsMissing(split_index), cats);
+      }
+      gstats[pid].Add(gpair[base_ridx + i]);
+    }
+  }
+  // Sum the statistics of the children into each internal node.
+  static GradStats AggregateStats(RegTree const &tree, bst_node_t nid, GradStats *gstats) {
+    if (!tree[nid].IsLeaf()) {
+      gstats[nid] = AggregateStats(tree, tree[nid].LeftChild(), gstats);
+      gstats[nid].Add(AggregateStats(tree, tree[nid].RightChild(), gstats));
     }
+    return gstats[nid];
   }
   inline void Refresh(TrainParam const *param, const GradStats *gstats, int nid, RegTree *p_tree) {
     RegTree &tree = *p_tree;
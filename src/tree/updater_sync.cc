@@ -5,23 +5,67 @@
  */
 #include <xgboost/tree_updater.h>
 
+#include <cstdint>  // for uint64_t, int64_t
 #include <string>
 #include <vector>
 
+#include "../collective/allreduce.h"  // for Allreduce
 #include "../collective/broadcast.h"
 #include "../collective/communicator-inl.h"
 #include "../common/io.h"
+#include "../data/sparse_page_source.h"  // for ContentHash
 #include "xgboost/json.h"
 
 namespace xgboost::tree {
 
 DMLC_REGISTRY_FILE_TAG(updater_sync);
 
+namespace {
+std::uint64_t HashTree(RegTree const& tree) {
+  data::ContentHash hash;
+  if (tree.IsMultiTarget()) {
+    std::string s_tree;
+    common::MemoryBufferStream fs(&s_tree);
+    tree.Save(&fs);
+    hash.Update(s_tree.data(), s_tree.size());
+    return hash.Get();
+  }
+  hash.Update(common::Span{tree.GetNodes()});
+  hash.Update(common::Span{tree.GetStats()});
+  hash.Update(common::Span{tree.GetSplitTypes()});
+  hash.Update(tree.GetSplitCategories());
+  hash.Update(common::Span{tree.GetSplitCategoriesPtr()});
+  return hash.Get();
+}
+}  // anonymous namespace
+
 /*!
  * \brief syncher that synchronize the tree in all distributed nodes
  * can implement various strategies, so far it is always set to node 0's tree
+ *
+ * The trees are usually identical in all workers, as they are built from the same
+ * synchronized statistics. Only a hash of each tree is compared, and the trees are
+ * broadcast from node 0 when any of them differs.
  */
 class TreeSyncher : public TreeUpdater {
+  // Whether the trees of all workers are identical.
+  [[nodiscard]] bool Synchronized(std::vector<RegTree*> const& trees) const {
+    // The trees are identical if the maximum of the hash equals the minimum.
+    std::vector<std::uint64_t> hashes(trees.size() * 2);
+    for (std::size_t i = 0; i < trees.size(); ++i) {
+      hashes[i] = HashTree(*trees[i]);
+      hashes[i + trees.size()] = ~hashes[i];
+    }
+    auto rc = collective::Allreduce(ctx_, &hashes, collective::Op::kMax);
+    SafeColl(rc);
+    for (std::size_t i = 0; i < trees.size(); ++i) {
+      if (hashes[i] != ~hashes[i + trees.size()]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
  public:
   explicit TreeSyncher(Context const* tparam) : TreeUpdater(tparam) {}
   void Configure(const Args&) override {}
@@ -35,6 +79,9 @@ class TreeSyncher : public TreeUpdater {
               common::Span<HostDeviceVector<bst_node_t>> /*out_position*/,
               const std::vector<RegTree*>& trees) override {
     if (collective::GetWorldSize() == 1) return;
+    if (this->Synchronized(trees)) {
+      return;
+    }
     std::string s_model;
     common::MemoryBufferStream fs(&s_model);
     int rank = collective::GetRank();
@@ -43,9 +90,15 @@ class TreeSyncher : public TreeUpdater {
         tree->Save(&fs);
       }
     }
-    fs.Seek(0);
-    auto rc = collective::Broadcast(ctx_, linalg::MakeVec(s_model.data(), s_model.size()), 0);
+    auto n_bytes = static_cast<std::int64_t>(s_model.size());
+    auto rc = collective::Success() << [&] {
+      return collective::Broadcast(ctx_, linalg::MakeVec(&n_bytes, 1), 0);
+    } << [&] {
+      s_model.resize(n_bytes);
+      return collective::Broadcast(ctx_, linalg::MakeVec(s_model.data(), s_model.size()), 0);
+    };
     SafeColl(rc);
+    fs.Seek(0);
     for (auto tree : trees) {
       tree->Load(&fs);
     }
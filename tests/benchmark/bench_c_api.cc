@@ -0,0 +1,297 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ *
+ * Latency of the prediction functions in the C API, as seen by a serving application.
+ * Each call is timed individually to report the tail latency along with the number of heap
+ * allocations per call.
+ */
+#include <benchmark/benchmark.h>
+#include <xgboost/c_api.h>    // for XGBoosterPredictFromDense, XGBoosterPredictFromCSR
+#include <xgboost/json.h>     // for Json, Object, Number, Integer, Boolean
+#include <xgboost/linalg.h>   // for ArrayInterfaceStr, MakeTensorView, MakeVec
+#include <xgboost/logging.h>  // for CHECK_EQ
+
+#include <algorithm>  // for sort, min
+#include <atomic>     // for atomic
+#include <chrono>     // for steady_clock, duration
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint64_t, uint32_t, int64_t
+#include <cstdlib>    // for malloc, free
+#include <limits>     // for numeric_limits
+#include <memory>     // for shared_ptr
+#include <mutex>      // for mutex, lock_guard
+#include <new>        // for bad_alloc
+#include <random>     // for mt19937_64, uniform_real_distribution
+#include <string>     // for string, to_string
+#include <vector>     // for vector
+
+#include "bench_helpers.h"  // for GetOrCreate
+
+namespace xgboost::bench {
+namespace {
+// Number of calls to the global `operator new`, from all threads.
+std::atomic<std::uint64_t> n_allocs{0};
+}  // anonymous namespace
+}  // namespace xgboost::bench
+
+// Count the allocations of the whole process, including the ones made inside the library.
+void* operator new(std::size_t n) {
+  xgboost::bench::n_allocs.fetch_add(1, std::memory_order_relaxed);
+  if (auto ptr = std::malloc(n == 0 ? 1 : n)) {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace xgboost::bench {
+namespace {
+bst_feature_t constexpr kCols = 32;
+bst_idx_t constexpr kMaxRows = 100000;
+float constexpr kNaN = std::numeric_limits<float>::quiet_NaN();
+
+void SafeCall(int ret) { CHECK_EQ(ret, 0) << XGBGetLastError(); }
+
+struct CDMatrix {
+  DMatrixHandle handle{nullptr};
+  ~CDMatrix() { XGDMatrixFree(handle); }
+};
+
+struct CBooster {
+  BoosterHandle handle{nullptr};
+  ~CBooster() { XGBoosterFree(handle); }
+};
+
+/**
+ * @brief Samples for all batch sizes, a batch of size n is the first n rows.
+ */
+struct Samples {
+  // Row-major dense values without missing.
+  std::vector<float> dense;
+  // CSR with 60% of values missing.
+  std::vector<std::size_t> indptr;
+  std::vector<std::uint32_t> indices;
+  std::vector<float> values;
+};
+
+// The setup is shared by the caller threads of a benchmark, the cache is not thread-safe.
+std::mutex setup_lock;
+
+std::shared_ptr<Samples> GetSamples() {
+  return GetOrCreate<Samples>("c-api-samples", [] {
+    auto samples = new Samples;
+    std::mt19937_64 rng{0};
+    std::uniform_real_distribution<float> dist{0.0f, 1.0f};
+    samples->dense.resize(kMaxRows * kCols);
+    for (auto& v : samples->dense) {
+      v = dist(rng);
+    }
+    samples->indptr.push_back(0);
+    for (bst_idx_t i = 0; i < kMaxRows; ++i) {
+      for (bst_feature_t j = 0; j < kCols; ++j) {
+        if (dist(rng) >= 0.6f) {
+          samples->indices.push_back(j);
+          samples->values.push_back(samples->dense[i * kCols + j]);
+        }
+      }
+      samples->indptr.push_back(samples->values.size());
+    }
+    return samples;
+  });
+}
+
+/**
+ * @brief Synthetic model, trained with the C API on the first rows of the samples. The
+ *        booster is frozen so that the caller threads can share it.
+ */
+std::shared_ptr<CBooster> GetBooster(std::int64_t n_trees, std::int64_t depth) {
+  auto samples = GetSamples();
+  auto key = "c-api-" + std::to_string(n_trees) + "-" + std::to_string(depth);
+  return GetOrCreate<CBooster>(key, [&] {
+    bst_idx_t n_train = 1 << 14;
+    CDMatrix dtrain;
+    SafeCall(XGDMatrixCreateFromMat(samples->dense.data(), n_train, kCols, kNaN, &dtrain.handle));
+    std::vector<float> labels(n_train);
+    for (bst_idx_t i = 0; i < n_train; ++i) {
+      auto const* row = samples->dense.data() + i * kCols;
+      labels[i] = row[0] + row[kCols / 2] * row[kCols - 1] > 0.75f;
+    }
+    SafeCall(XGDMatrixSetFloatInfo(dtrain.handle, "label", labels.data(), n_train));
+
+    auto booster = new CBooster;
+    SafeCall(XGBoosterCreate(&dtrain.handle, 1, &booster->handle));
+    SafeCall(XGBoosterSetParam(booster->handle, "tree_method", "hist"));
+    SafeCall(XGBoosterSetParam(booster->handle, "objective", "binary:logistic"));
+    SafeCall(XGBoosterSetParam(booster->handle, "max_depth", std::to_string(depth).c_str()));
+    for (std::int64_t i = 0; i < n_trees; ++i) {
+      SafeCall(XGBoosterUpdateOneIter(booster->handle, i, dtrain.handle));
+    }
+    SafeCall(XGBoosterFreeze(booster->handle));
+    return booster;
+  });
+}
+
+// Normal prediction with all trees, inplace prediction also requires the missing value.
+std::string PredictConfig(bool inplace) {
+  Json config{Object{}};
+  config["type"] = Integer{0};
+  config["training"] = Boolean{false};
+  config["iteration_begin"] = Integer{0};
+  config["iteration_end"] = Integer{0};
+  config["strict_shape"] = Boolean{false};
+  if (inplace) {
+    config["missing"] = Number{kNaN};
+  }
+  return Json::Dump(config);
+}
+
+/**
+ * @brief Time each call and report the percentiles, along with the number of allocations
+ *        per call. The counters are averaged over the caller threads.
+ */
+class LatencyRecorder {
+  std::vector<double> samples_;
+  std::uint64_t n_allocs_;
+
+ public:
+  explicit LatencyRecorder(benchmark::State const& state) {
+    // Avoid counting the allocations of the recorder itself.
+    samples_.reserve(state.max_iterations);
+    n_allocs_ = n_allocs.load();
+  }
+
+  template <typename Fn>
+  void Time(Fn&& fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    fn();
+    auto t1 = std::chrono::steady_clock::now();
+    samples_.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+  }
+
+  void Report(benchmark::State* state) {
+    // Allocations from all threads during the loop.
+    auto n_calls = static_cast<double>(state->iterations()) * state->threads();
+    auto allocs = static_cast<double>(n_allocs.load() - n_allocs_) / n_calls;
+    if (samples_.empty()) {
+      return;
+    }
+    std::sort(samples_.begin(), samples_.end());
+    auto percentile = [&](double q) {
+      auto idx = static_cast<std::size_t>(q * samples_.size());
+      return samples_[std::min(idx, samples_.size() - 1)];
+    };
+    auto avg = benchmark::Counter::kAvgThreads;
+    state->counters["p50_us"] = benchmark::Counter{percentile(0.5), avg};
+    state->counters["p99_us"] = benchmark::Counter{percentile(0.99), avg};
+    state->counters["p999_us"] = benchmark::Counter{percentile(0.999), avg};
+    state->counters["allocs"] = benchmark::Counter{allocs, avg};
+  }
+};
+
+template <typename Fn>
+void RunPrediction(benchmark::State& state, Fn&& predict) {
+  LatencyRecorder recorder{state};
+  for (auto _ : state) {
+    recorder.Time(predict);
+  }
+  recorder.Report(&state);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+}  // anonymous namespace
+
+// Arguments are the batch size, the number of trees and the maximum depth. Run with
+// multiple threads to measure concurrent callers sharing a booster.
+void BM_CAPIPredictFromDense(benchmark::State& state) {
+  std::shared_ptr<Samples> samples;
+  std::shared_ptr<CBooster> booster;
+  {
+    std::lock_guard<std::mutex> guard{setup_lock};
+    samples = GetSamples();
+    booster = GetBooster(state.range(1), state.range(2));
+  }
+  bst_idx_t n_samples = state.range(0);
+  Context ctx;
+  auto array = linalg::ArrayInterfaceStr(linalg::MakeTensorView(
+      &ctx, common::Span<float>{samples->dense.data(), n_samples * kCols}, n_samples, kCols));
+  auto config = PredictConfig(true);
+
+  bst_ulong const* out_shape{nullptr};
+  bst_ulong out_dim{0};
+  float const* out_result{nullptr};
+  RunPrediction(state, [&] {
+    SafeCall(XGBoosterPredictFromDense(booster->handle, array.c_str(), config.c_str(), nullptr,
+                                       &out_shape, &out_dim, &out_result));
+    benchmark::DoNotOptimize(out_result);
+  });
+}
+
+void BM_CAPIPredictFromCSR(benchmark::State& state) {
+  std::shared_ptr<Samples> samples;
+  std::shared_ptr<CBooster> booster;
+  {
+    std::lock_guard<std::mutex> guard{setup_lock};
+    samples = GetSamples();
+    booster = GetBooster(state.range(1), state.range(2));
+  }
+  bst_idx_t n_samples = state.range(0);
+  auto nnz = samples->indptr[n_samples];
+  auto indptr = linalg::ArrayInterfaceStr(linalg::MakeVec(samples->indptr.data(), n_samples + 1));
+  auto indices = linalg::ArrayInterfaceStr(linalg::MakeVec(samples->indices.data(), nnz));
+  auto values = linalg::ArrayInterfaceStr(linalg::MakeVec(samples->values.data(), nnz));
+  auto config = PredictConfig(true);
+
+  bst_ulong const* out_shape{nullptr};
+  bst_ulong out_dim{0};
+  float const* out_result{nullptr};
+  RunPrediction(state, [&] {
+    SafeCall(XGBoosterPredictFromCSR(booster->handle, indptr.c_str(), indices.c_str(),
+                                     values.c_str(), kCols, config.c_str(), nullptr, &out_shape,
+                                     &out_dim, &out_result));
+    benchmark::DoNotOptimize(out_result);
+  });
+}
+
+void BM_CAPIPredictFromDMatrix(benchmark::State& state) {
+  std::shared_ptr<Samples> samples;
+  std::shared_ptr<CBooster> booster;
+  {
+    std::lock_guard<std::mutex> guard{setup_lock};
+    samples = GetSamples();
+    booster = GetBooster(state.range(1), state.range(2));
+  }
+  bst_idx_t n_samples = state.range(0);
+  // Each caller thread has its own DMatrix, the construction is not timed.
+  CDMatrix dmat;
+  SafeCall(XGDMatrixCreateFromMat(samples->dense.data(), n_samples, kCols, kNaN, &dmat.handle));
+  auto config = PredictConfig(false);
+
+  bst_ulong const* out_shape{nullptr};
+  bst_ulong out_dim{0};
+  float const* out_result{nullptr};
+  RunPrediction(state, [&] {
+    SafeCall(XGBoosterPredictFromDMatrix(booster->handle, dmat.handle, config.c_str(), &out_shape,
+                                         &out_dim, &out_result));
+    benchmark::DoNotOptimize(out_result);
+  });
+}
+
+#define XGBOOST_C_API_PREDICT_BENCHMARK(fn)                            \
+  BENCHMARK(fn)                                                        \
+      ->ArgNames({"batch", "trees", "depth"})                          \
+      ->ArgsProduct({{1, 64, 4096, kMaxRows}, {100}, {6}})             \
+      ->Args({1, 1000, 8})                                             \
+      ->Args({4096, 1000, 8})                                          \
+      ->Args({1, 100, 12})                                             \
+      ->Args({4096, 100, 12})                                          \
+      ->Threads(1)                                                     \
+      ->Threads(4)                                                     \
+      ->Unit(benchmark::kMicrosecond)                                  \
+      ->UseRealTime()
+
+XGBOOST_C_API_PREDICT_BENCHMARK(BM_CAPIPredictFromDense);
+XGBOOST_C_API_PREDICT_BENCHMARK(BM_CAPIPredictFromCSR);
+XGBOOST_C_API_PREDICT_BENCHMARK(BM_CAPIPredictFromDMatrix);
+
+#undef XGBOOST_C_API_PREDICT_BENCHMARK
+}  // namespace xgboost::bench
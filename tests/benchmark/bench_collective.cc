@@ -0,0 +1,331 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ *
+ * Simulated distributed runs with the workers as threads in the same process, connected
+ * through the loopback by a local tracker.
+ *
+ *   The collective benchmarks delay each message by a link model with a fixed latency and
+ *   a bandwidth limit, which makes it possible to compare the collective algorithms without
+ *   a cluster. The reported time is split into the communication, which includes waiting
+ *   for the peers and the simulated transfer time, and the local computation like the
+ *   reduction.
+ */
+#include <benchmark/benchmark.h>
+#include <xgboost/global_config.h>  // for InitNewThread
+#include <xgboost/json.h>           // for Json, Object, Integer, Number, get
+
+#include <algorithm>  // for max
+#include <chrono>     // for microseconds, duration
+#include <cstddef>    // for size_t
+#include <cstdint>    // for int8_t, int32_t, int64_t
+#include <memory>     // for shared_ptr, make_shared
+#include <string>     // for string, to_string
+#include <thread>     // for thread, sleep_for, hardware_concurrency
+#include <utility>    // for move
+#include <vector>     // for vector
+
+#include "../../src/collective/allgather.h"         // for RingAllgatherV
+#include "../../src/collective/allreduce.h"         // for Allreduce, AllreduceAlgo
+#include "../../src/collective/comm.h"              // for RabitComm, Channel
+#include "../../src/collective/comm_group.h"        // for GlobalCommGroup
+#include "../../src/collective/communicator-inl.h"  // for Init, Finalize, GetRank
+#include "../../src/collective/stats.h"             // for CollStats, ScopedCall, RecordWait
+#include "../../src/collective/tracker.h"           // for RabitTracker, GetHostAddress
+#include "../../src/common/timer.h"                 // for Timer
+#include "bench_helpers.h"                          // for MakeDMatrix, MakeModel
+
+namespace xgboost::collective {
+namespace {
+// Number of timed calls for each run of the workers.
+std::int32_t constexpr kRounds = 8;
+
+/**
+ * @brief Cost of sending a message between two workers.
+ */
+struct LinkModel {
+  std::chrono::microseconds latency{0};
+  // Bytes per second, 0 for unlimited.
+  double bandwidth{0};
+
+  [[nodiscard]] std::chrono::duration<double> Delay(std::size_t n_bytes) const {
+    std::chrono::duration<double> delay{latency};
+    if (bandwidth > 0) {
+      delay += std::chrono::duration<double>{static_cast<double>(n_bytes) / bandwidth};
+    }
+    return delay;
+  }
+};
+
+/**
+ * @brief Channel that holds each message for the time the link needs to deliver it.
+ */
+class SimulatedChannel : public Channel {
+  std::shared_ptr<Channel> chan_;
+  LinkModel link_;
+
+ public:
+  SimulatedChannel(Comm const& comm, std::shared_ptr<Channel> chan, LinkModel link)
+      : Channel{comm, chan->Socket()}, chan_{std::move(chan)}, link_{link} {}
+
+  using Channel::RecvAll;
+  using Channel::SendAll;
+
+  [[nodiscard]] Result SendAll(std::int8_t const* ptr, std::size_t n) override {
+    auto delay = link_.Delay(n);
+    if (delay.count() > 0) {
+      std::this_thread::sleep_for(delay);
+      // The transfer time is part of the communication.
+      RecordWait(delay.count());
+    }
+    return chan_->SendAll(ptr, n);
+  }
+  [[nodiscard]] Result RecvAll(std::int8_t* ptr, std::size_t n) override {
+    return chan_->RecvAll(ptr, n);
+  }
+  [[nodiscard]] Result Block() override { return chan_->Block(); }
+};
+
+/**
+ * @brief Rabit communicator with all the links replaced by simulated ones.
+ */
+class SimulatedComm : public RabitComm {
+  std::vector<std::shared_ptr<Channel>> links_;
+
+ public:
+  SimulatedComm(std::string const& host, std::int32_t port, std::int32_t rank, LinkModel link)
+      : RabitComm{host, port, std::chrono::seconds{30}, 1, "t:" + std::to_string(rank),
+                  DefaultNcclName()} {
+    for (auto const& chan : this->channels_) {
+      links_.emplace_back(chan ? std::make_shared<SimulatedChannel>(*this, chan, link) : chan);
+    }
+  }
+
+  [[nodiscard]] std::shared_ptr<Channel> Chan(std::int32_t rank) const override {
+    return links_.at(rank);
+  }
+};
+
+/**
+ * @brief Run the workers as threads, with a local tracker.
+ *
+ * @param fn Worker function with the tracker host, the tracker port, and the worker index.
+ */
+template <typename Fn>
+void RunWorkers(std::int32_t n_workers, Fn&& fn) {
+  system::SocketStartup();
+  std::string host;
+  SafeColl(GetHostAddress(&host));
+
+  Json config{Object{}};
+  config["host"] = host;
+  config["port"] = Integer{0};
+  config["n_workers"] = Integer{n_workers};
+  config["timeout"] = Integer{30};
+  RabitTracker tracker{config};
+  auto fut = tracker.Run();
+  auto port = tracker.Port();
+
+  std::vector<std::thread> workers;
+  for (std::int32_t i = 0; i < n_workers; ++i) {
+    workers.emplace_back([&, i, init = InitNewThread{}] {
+      init();
+      fn(host, port, i);
+    });
+  }
+  for (auto& t : workers) {
+    t.join();
+  }
+  SafeColl(fut.get());
+  system::SocketFinalize();
+}
+
+/**
+ * @brief Sum of the statistics over all the call sites.
+ */
+struct StatsSummary {
+  std::int64_t n_calls{0};
+  std::int64_t n_sent{0};
+  double elapsed{0};
+  double wait{0};
+
+  explicit StatsSummary(CollStats const& stats) {
+    auto jstats = stats.ToJson();
+    for (auto const& kv : get<Object const>(jstats)) {
+      n_calls += get<Integer const>(kv.second["n_calls"]);
+      n_sent += get<Integer const>(kv.second["n_sent"]);
+      elapsed += get<Number const>(kv.second["elapsed"]);
+      wait += get<Number const>(kv.second["wait"]);
+    }
+  }
+  StatsSummary() = default;
+};
+
+void ReportCollective(benchmark::State& state, std::vector<StatsSummary> const& runs,
+                      std::size_t n_bytes) {
+  StatsSummary total;
+  for (auto const& run : runs) {
+    total.n_calls += run.n_calls;
+    total.n_sent += run.n_sent;
+    total.elapsed += run.elapsed;
+    total.wait += run.wait;
+  }
+  auto n_calls = static_cast<double>(total.n_calls);
+  state.counters["comm_us"] = total.wait / n_calls * 1e6;
+  state.counters["compute_us"] = (total.elapsed - total.wait) / n_calls * 1e6;
+  state.counters["sent_KiB"] = static_cast<double>(total.n_sent) / n_calls / 1024.0;
+  state.SetBytesProcessed(state.iterations() * kRounds * n_bytes);
+}
+
+LinkModel MakeLink(benchmark::State const& state, std::int32_t idx) {
+  return LinkModel{std::chrono::microseconds{state.range(idx)},
+                   static_cast<double>(state.range(idx + 1)) * 1024.0 * 1024.0};
+}
+}  // anonymous namespace
+
+// Arguments are the number of workers, the message size in KiB, the link latency in
+// microseconds, the link bandwidth in MiB/s (0 for unlimited), and the algorithm, 1 for
+// the ring and 2 for recursive doubling. The time and the counters are from rank 0.
+void BM_SimAllreduce(benchmark::State& state) {
+  auto n_workers = static_cast<std::int32_t>(state.range(0));
+  std::size_t n_bytes = state.range(1) * 1024;
+  auto link = MakeLink(state, 2);
+  auto algo = static_cast<cpu_impl::AllreduceAlgo>(state.range(4));
+
+  std::vector<StatsSummary> runs;
+  for (auto _ : state) {
+    StatsSummary summary;
+    RunWorkers(n_workers, [&](std::string const& host, std::int32_t port, std::int32_t i) {
+      SimulatedComm comm{host, port, i, link};
+      std::vector<double> data(n_bytes / sizeof(double), 1.0);
+      auto erased = common::EraseType(common::Span{data.data(), data.size()});
+      auto op = [](common::Span<std::int8_t const> lhs, common::Span<std::int8_t> out) {
+        auto lhs_t = common::RestoreType<double const>(lhs);
+        auto out_t = common::RestoreType<double>(out);
+        for (std::size_t k = 0; k < out_t.size(); ++k) {
+          out_t[k] += lhs_t[k];
+        }
+      };
+      auto type = ToDType<double>::kType;
+      // Warm up the connections.
+      SafeColl(cpu_impl::Allreduce(comm, erased, op, type, algo));
+      CollStats stats;
+      for (std::int32_t r = 0; r < kRounds; ++r) {
+        ScopedCall scope{&stats, "Allreduce", CallSite::Current(), n_bytes};
+        SafeColl(cpu_impl::Allreduce(comm, erased, op, type, algo));
+      }
+      if (comm.Rank() == 0) {
+        summary = StatsSummary{stats};
+      }
+      SafeColl(comm.Shutdown());
+    });
+    state.SetIterationTime(summary.elapsed / kRounds);
+    runs.push_back(summary);
+  }
+  ReportCollective(state, runs, n_bytes);
+}
+
+BENCHMARK(BM_SimAllreduce)
+    ->ArgNames({"workers", "KiB", "lat_us", "MiBps", "algo"})
+    ->ArgsProduct({{4, 8}, {4, 1024}, {0, 200}, {0, 1024}, {1, 2}})
+    ->Iterations(4)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime();
+
+// Arguments are the number of workers, the average message size in KiB, the link latency
+// in microseconds and the link bandwidth in MiB/s. Worker i sends (i + 1) times as much
+// data as worker 0.
+void BM_SimAllgatherV(benchmark::State& state) {
+  auto n_workers = static_cast<std::int32_t>(state.range(0));
+  std::size_t n_bytes = state.range(1) * 1024;
+  auto link = MakeLink(state, 2);
+
+  std::vector<StatsSummary> runs;
+  for (auto _ : state) {
+    StatsSummary summary;
+    RunWorkers(n_workers, [&](std::string const& host, std::int32_t port, std::int32_t i) {
+      SimulatedComm comm{host, port, i, link};
+      auto n = n_bytes * 2 * (comm.Rank() + 1) / (comm.World() + 1);
+      std::vector<std::int8_t> data(n, static_cast<std::int8_t>(comm.Rank()));
+      std::vector<std::int8_t> out;
+      SafeColl(RingAllgatherV(comm, common::Span{data.data(), data.size()}, &out));
+      CollStats stats;
+      for (std::int32_t r = 0; r < kRounds; ++r) {
+        ScopedCall scope{&stats, "AllgatherV", CallSite::Current(), n};
+        SafeColl(RingAllgatherV(comm, common::Span{data.data(), data.size()}, &out));
+      }
+      if (comm.Rank() == 0) {
+        summary = StatsSummary{stats};
+      }
+      SafeColl(comm.Shutdown());
+    });
+    state.SetIterationTime(summary.elapsed / kRounds);
+    runs.push_back(summary);
+  }
+  ReportCollective(state, runs, n_bytes * n_workers);
+}
+
+BENCHMARK(BM_SimAllgatherV)
+    ->ArgNames({"workers", "KiB", "lat_us", "MiBps"})
+    ->ArgsProduct({{4, 8}, {4, 1024}, {0, 200}, {0, 1024}})
+    ->Iterations(4)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime();
+
+// Arguments are the number of workers, the number of samples per worker, the number of
+// features and the number of boosting rounds. The workers use the global communicator
+// without simulated links. The time includes the distributed quantile sketching and the
+// training, the communication is the time spent in the collective calls of rank 0.
+void BM_SimDistributedHist(benchmark::State& state) {
+  auto n_workers = static_cast<std::int32_t>(state.range(0));
+  auto n_samples = static_cast<bst_idx_t>(state.range(1));
+  auto n_features = static_cast<bst_feature_t>(state.range(2));
+  auto n_rounds = static_cast<std::int32_t>(state.range(3));
+  auto n_threads = std::max(static_cast<std::int32_t>(std::thread::hardware_concurrency()) /
+                                n_workers,
+                            1);
+
+  double total{0}, comm{0};
+  std::int64_t n_calls{0};
+  for (auto _ : state) {
+    double elapsed{0};
+    RunWorkers(n_workers, [&](std::string const& host, std::int32_t port, std::int32_t i) {
+      Json config{Object{}};
+      config["dmlc_communicator"] = String{"rabit"};
+      config["dmlc_tracker_uri"] = host;
+      config["dmlc_tracker_port"] = port;
+      config["dmlc_task_id"] = std::to_string(i);
+      Init(config);
+
+      auto p_fmat = bench::MakeDMatrix(n_samples, n_features, 0.0f, i);
+      common::Timer timer;
+      timer.Start();
+      auto learner = bench::MakeModel(p_fmat, n_rounds, {{"nthread", std::to_string(n_threads)}});
+      timer.Stop();
+      if (GetRank() == 0) {
+        StatsSummary summary{*GlobalCommGroup()->Stats()};
+        elapsed = timer.ElapsedSeconds();
+        total += elapsed;
+        comm += summary.elapsed;
+        n_calls += summary.n_calls;
+      }
+      learner.reset();
+      Finalize();
+    });
+    state.SetIterationTime(elapsed);
+  }
+  state.counters["comm_s"] = benchmark::Counter{comm, benchmark::Counter::kAvgIterations};
+  state.counters["compute_s"] =
+      benchmark::Counter{total - comm, benchmark::Counter::kAvgIterations};
+  state.counters["colls"] =
+      benchmark::Counter{static_cast<double>(n_calls), benchmark::Counter::kAvgIterations};
+}
+
+BENCHMARK(BM_SimDistributedHist)
+    ->ArgNames({"workers", "rows", "cols", "rounds"})
+    ->Args({2, 1 << 16, 32, 16})
+    ->Args({4, 1 << 16, 32, 16})
+    ->Args({4, 1 << 14, 256, 16})
+    ->Iterations(2)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime();
+}  // namespace xgboost::collective
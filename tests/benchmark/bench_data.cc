@@ -0,0 +1,87 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ *
+ * Benchmarks for the quantile sketching and the model IO.
+ */
+#include <benchmark/benchmark.h>
+#include <xgboost/context.h>  // for Context
+#include <xgboost/json.h>     // for Json
+#include <xgboost/learner.h>  // for Learner
+
+#include <ios>     // for ios
+#include <memory>  // for unique_ptr
+#include <string>  // for string, to_string
+
+#include "../../src/common/hist_util.h"  // for SketchOnDMatrix
+#include "bench_helpers.h"               // for MakeDMatrix, MakeModel, GetOrCreate
+
+namespace xgboost::bench {
+// Arguments are the number of samples, the number of features, the percentage of missing
+// values and the maximum number of bins.
+void BM_SketchOnDMatrix(benchmark::State& state) {
+  auto key = std::to_string(state.range(0)) + "-" + std::to_string(state.range(1)) + "-" +
+             std::to_string(state.range(2));
+  auto p_fmat = GetOrCreate<DMatrix>(
+      key, [&] { return MakeDMatrix(state.range(0), state.range(1), state.range(2) / 100.0f); });
+  Context ctx;
+  for (auto _ : state) {
+    auto cuts = common::SketchOnDMatrix(&ctx, p_fmat.get(), state.range(3));
+    benchmark::DoNotOptimize(cuts.Values().data());
+  }
+  state.SetItemsProcessed(state.iterations() * p_fmat->Info().num_nonzero_);
+}
+
+BENCHMARK(BM_SketchOnDMatrix)
+    ->ArgNames({"rows", "cols", "missing%", "bins"})
+    ->Args({1 << 20, 32, 0, 256})
+    ->Args({1 << 20, 32, 60, 256})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+namespace {
+// A UBJSON model with the number of trees and the maximum depth from the arguments.
+std::shared_ptr<std::string> GetUBJModel(benchmark::State const& state) {
+  auto key = std::to_string(state.range(0)) + "-" + std::to_string(state.range(1));
+  return GetOrCreate<std::string>(key, [&] {
+    auto p_fmat = MakeDMatrix(1 << 16, 32, 0.0f);
+    auto learner =
+        MakeModel(p_fmat, state.range(0), {{"max_depth", std::to_string(state.range(1))}});
+    Json model{Object{}};
+    learner->SaveModel(&model);
+    auto str = std::make_shared<std::string>();
+    Json::Dump(model, str.get(), std::ios::binary);
+    return str;
+  });
+}
+}  // anonymous namespace
+
+// Parse the UBJSON document.
+void BM_ParseUBJ(benchmark::State& state) {
+  auto str = GetUBJModel(state);
+  for (auto _ : state) {
+    auto model = Json::Load(StringView{*str}, std::ios::binary);
+    benchmark::DoNotOptimize(model);
+  }
+  state.SetBytesProcessed(state.iterations() * str->size());
+}
+
+// Parse the UBJSON document and load the model into a booster.
+void BM_LoadUBJModel(benchmark::State& state) {
+  auto str = GetUBJModel(state);
+  for (auto _ : state) {
+    std::unique_ptr<Learner> learner{Learner::Create({})};
+    learner->LoadModel(Json::Load(StringView{*str}, std::ios::binary));
+    benchmark::DoNotOptimize(learner.get());
+  }
+  state.SetBytesProcessed(state.iterations() * str->size());
+}
+
+BENCHMARK(BM_ParseUBJ)
+    ->ArgNames({"trees", "depth"})
+    ->Args({500, 6})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LoadUBJModel)
+    ->ArgNames({"trees", "depth"})
+    ->Args({500, 6})
+    ->Unit(benchmark::kMillisecond);
+}  // namespace xgboost::bench
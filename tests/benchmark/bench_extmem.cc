@@ -0,0 +1,233 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ *
+ * IO throughput of the external memory page sources. The pages are fetched from a disk cache
+ * created by synthetic iterators, with a simulated consumer that spends a fixed time on each
+ * page. Along with the time of each pass, the benchmarks report the statistics collected by
+ * the `PageSourceProfiler`, and the number of prefetched pages and the page size suggested
+ * for the storage device.
+ *
+ * The cache is written to the directory from the `XGBOOST_BENCH_EXTMEM_DIR` environment
+ * variable, or the temporary directory if it's not set. Drop the page cache of the OS
+ * before running the benchmarks for the storage device to be measured instead of the memory.
+ */
+#include <benchmark/benchmark.h>
+#include <xgboost/c_api.h>    // for XGProxyDMatrixCreate, XGProxyDMatrixSetDataDense
+#include <xgboost/context.h>  // for Context
+#include <xgboost/data.h>     // for DMatrix, ExtMemConfig, BatchParam
+#include <xgboost/linalg.h>   // for ArrayInterfaceStr, MakeTensorView
+#include <xgboost/logging.h>  // for CHECK_EQ
+
+#include <algorithm>   // for min, max
+#include <chrono>      // for microseconds
+#include <cstddef>     // for size_t
+#include <cstdint>     // for int32_t, int64_t, uint64_t
+#include <cstdlib>     // for getenv
+#include <filesystem>  // for path, temp_directory_path, create_directories
+#include <limits>      // for numeric_limits
+#include <memory>      // for shared_ptr
+#include <random>      // for mt19937_64, uniform_real_distribution
+#include <string>      // for string, to_string
+#include <thread>      // for sleep_for
+#include <vector>      // for vector
+
+#include "../../src/data/page_source_profiler.h"  // for PageSourceProfiler, SuggestPageSource
+#include "../../src/tree/param.h"                 // for TrainParam
+#include "bench_helpers.h"                        // for GetOrCreate
+
+namespace xgboost::bench {
+namespace {
+bst_idx_t constexpr kRows = 1 << 19;
+bst_feature_t constexpr kCols = 32;
+bst_bin_t constexpr kMaxBin = 256;
+
+/**
+ * @brief Dense batches of uniformly distributed values, passed to the DMatrix through a
+ *        proxy.
+ */
+class SyntheticIter {
+  DMatrixHandle proxy_{nullptr};
+  std::vector<std::vector<float>> batches_;
+  std::vector<std::string> interfaces_;
+  std::size_t iter_{0};
+
+ public:
+  SyntheticIter(bst_idx_t n_samples, bst_feature_t n_features, bst_idx_t rows_per_batch) {
+    CHECK_EQ(XGProxyDMatrixCreate(&proxy_), 0);
+    std::mt19937_64 rng{0};
+    std::uniform_real_distribution<float> dist{0.0f, 1.0f};
+    Context ctx;
+    for (bst_idx_t begin = 0; begin < n_samples; begin += rows_per_batch) {
+      auto n = std::min(rows_per_batch, n_samples - begin);
+      auto& batch = batches_.emplace_back(n * n_features);
+      for (auto& v : batch) {
+        v = dist(rng);
+      }
+      interfaces_.push_back(linalg::ArrayInterfaceStr(
+          linalg::MakeTensorView(&ctx, common::Span{batch}, n, n_features)));
+    }
+  }
+  ~SyntheticIter() { XGDMatrixFree(proxy_); }
+
+  SyntheticIter(SyntheticIter const& that) = delete;
+  SyntheticIter& operator=(SyntheticIter const& that) = delete;
+
+  [[nodiscard]] DMatrixHandle Proxy() const { return proxy_; }
+
+  static void Reset(DataIterHandle self) { static_cast<SyntheticIter*>(self)->iter_ = 0; }
+  static int Next(DataIterHandle self) {
+    auto* iter = static_cast<SyntheticIter*>(self);
+    if (iter->iter_ == iter->batches_.size()) {
+      return 0;
+    }
+    CHECK_EQ(XGProxyDMatrixSetDataDense(iter->proxy_, iter->interfaces_[iter->iter_].c_str()), 0);
+    ++iter->iter_;
+    return 1;
+  }
+};
+
+std::string CacheDir() {
+  std::filesystem::path dir;
+  if (auto const* env = std::getenv("XGBOOST_BENCH_EXTMEM_DIR")) {
+    dir = env;
+  } else {
+    dir = std::filesystem::temp_directory_path() / "xgboost_bench_extmem";
+  }
+  std::filesystem::create_directories(dir);
+  return dir.string();
+}
+
+// An external memory DMatrix with the number of rows in each batch from the first argument.
+// The quantile DMatrix keeps only the gradient index in the cache.
+std::shared_ptr<DMatrix> GetExtMem(benchmark::State const& state, bool quantile) {
+  auto rows_per_batch = static_cast<bst_idx_t>(state.range(0));
+  auto key = std::string{quantile ? "qdm-" : "sparse-"} + std::to_string(rows_per_batch);
+  return GetOrCreate<DMatrix>(key, [&] {
+    SyntheticIter iter{kRows, kCols, rows_per_batch};
+    ExtMemConfig config{CacheDir() + "/" + key,
+                        false,
+                        0,
+                        std::numeric_limits<float>::quiet_NaN(),
+                        0,
+                        Context{}.Threads()};
+    if (quantile) {
+      return std::shared_ptr<DMatrix>{DMatrix::Create(&iter, iter.Proxy(), nullptr,
+                                                      SyntheticIter::Reset, SyntheticIter::Next,
+                                                      kMaxBin,
+                                                      std::numeric_limits<std::int64_t>::max(),
+                                                      config)};
+    }
+    return std::shared_ptr<DMatrix>{DMatrix::Create(&iter, iter.Proxy(), SyntheticIter::Reset,
+                                                    SyntheticIter::Next, config)};
+  });
+}
+
+// Iterate over the pages created by `get_batches`, spending the time from the third argument
+// on each page. The profile of the fetches is reported in the counters.
+template <typename Fn>
+void RunPages(benchmark::State& state, std::int32_t max_prefetch, Fn&& get_batches) {
+  auto compute_us = state.range(2);
+  // Generate the pages before timing.
+  for (auto const& page : get_batches()) {
+    benchmark::DoNotOptimize(&page);
+  }
+
+  auto& profiler = data::PageSourceProfiler::Get();
+  std::vector<data::PageFetchRecord> records;
+  for (auto _ : state) {
+    profiler.Start();
+    for (auto const& page : get_batches()) {
+      benchmark::DoNotOptimize(&page);
+      std::this_thread::sleep_for(std::chrono::microseconds{compute_us});
+    }
+    auto pass = profiler.Stop();
+    records.insert(records.end(), pass.cbegin(), pass.cend());
+  }
+
+  double n_bytes{0}, read{0}, decode{0}, wait{0}, depth{0};
+  for (auto const& r : records) {
+    n_bytes += static_cast<double>(r.n_bytes);
+    read += r.read > 0 ? r.read : r.decode;
+    decode += r.decode;
+    wait += r.wait;
+    depth += r.depth;
+  }
+  auto n = std::max(static_cast<double>(records.size()), 1.0);
+  state.counters["read_MBps"] = read > 0 ? n_bytes / read / 1e6 : 0.0;
+  state.counters["decode_ms"] = decode / n * 1e3;
+  state.counters["wait_ms"] = wait / n * 1e3;
+  state.counters["depth"] = depth / n;
+  auto suggestion = data::SuggestPageSource(common::Span{records}, max_prefetch);
+  state.counters["suggested_n_prefetch"] = suggestion.n_prefetch_batches;
+  state.counters["suggested_page_MiB"] =
+      static_cast<double>(suggestion.page_bytes) / static_cast<double>(1 << 20);
+  state.SetBytesProcessed(static_cast<std::int64_t>(n_bytes));
+}
+
+BatchParam HistParam(benchmark::State const& state) {
+  BatchParam param{kMaxBin, tree::TrainParam::DftSparseThreshold()};
+  param.n_prefetch_batches = static_cast<std::int32_t>(state.range(1));
+  return param;
+}
+
+std::int32_t constexpr kMaxPrefetch = 8;
+}  // anonymous namespace
+
+// Arguments are the number of rows in each page, the number of prefetched pages and the
+// consumer time of each page in microseconds. The row page is always prefetched with the
+// default setting.
+void BM_ExtMemSparsePage(benchmark::State& state) {
+  auto p_fmat = GetExtMem(state, false);
+  RunPages(state, kMaxPrefetch, [&] { return p_fmat->GetBatches<SparsePage>(); });
+}
+
+void BM_ExtMemGHistIndex(benchmark::State& state) {
+  auto p_fmat = GetExtMem(state, false);
+  Context ctx;
+  RunPages(state, kMaxPrefetch,
+           [&] { return p_fmat->GetBatches<GHistIndexMatrix>(&ctx, HistParam(state)); });
+}
+
+void BM_ExtMemQuantileGHistIndex(benchmark::State& state) {
+  auto p_fmat = GetExtMem(state, true);
+  Context ctx;
+  RunPages(state, kMaxPrefetch,
+           [&] { return p_fmat->GetBatches<GHistIndexMatrix>(&ctx, HistParam(state)); });
+}
+
+BENCHMARK(BM_ExtMemSparsePage)
+    ->ArgNames({"page_rows", "n_prefetch", "compute_us"})
+    ->Args({1 << 14, 3, 0})
+    ->Args({1 << 16, 3, 0})
+    ->Args({1 << 16, 3, 2000})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_ExtMemGHistIndex)
+    ->ArgNames({"page_rows", "n_prefetch", "compute_us"})
+    ->ArgsProduct({{1 << 14, 1 << 16}, {1, 3, 8}, {0, 2000}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(BM_ExtMemQuantileGHistIndex)
+    ->ArgNames({"page_rows", "n_prefetch", "compute_us"})
+    ->ArgsProduct({{1 << 14, 1 << 16}, {1, 3, 8}, {0, 2000}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+#if defined(XGBOOST_USE_CUDA)
+// The ellpack pages are generated from the row pages of the same cache.
+void BM_ExtMemEllpack(benchmark::State& state) {
+  auto p_fmat = GetExtMem(state, false);
+  auto ctx = Context{}.MakeCUDA(0);
+  RunPages(state, kMaxPrefetch,
+           [&] { return p_fmat->GetBatches<EllpackPage>(&ctx, HistParam(state)); });
+}
+
+BENCHMARK(BM_ExtMemEllpack)
+    ->ArgNames({"page_rows", "n_prefetch", "compute_us"})
+    ->ArgsProduct({{1 << 14, 1 << 16}, {1, 3}, {0, 2000}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+#endif  // defined(XGBOOST_USE_CUDA)
+}  // namespace xgboost::bench
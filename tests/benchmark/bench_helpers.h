@@ -0,0 +1,109 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ *
+ * @brief Synthetic data for the benchmarks.
+ */
+#ifndef XGBOOST_TESTS_BENCHMARK_BENCH_HELPERS_H_
+#define XGBOOST_TESTS_BENCHMARK_BENCH_HELPERS_H_
+
+#include <xgboost/base.h>         // for bst_idx_t, bst_feature_t, GradientPair, Args
+#include <xgboost/context.h>      // for Context
+#include <xgboost/data.h>         // for DMatrix
+#include <xgboost/learner.h>      // for Learner
+#include <xgboost/linalg.h>       // for ArrayInterfaceStr, MakeTensorView
+#include <xgboost/string_view.h>  // for StringView
+
+#include <cstdint>  // for uint64_t, int32_t
+#include <limits>   // for numeric_limits
+#include <map>      // for map
+#include <memory>   // for shared_ptr
+#include <random>   // for mt19937_64, uniform_real_distribution
+#include <string>   // for string
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "../../src/data/adapter.h"  // for ArrayAdapter
+
+namespace xgboost::bench {
+/**
+ * @brief Generate a matrix with uniformly distributed values in [0, 1) and a binary label.
+ *
+ * @param sparsity Fraction of missing values.
+ */
+inline std::shared_ptr<DMatrix> MakeDMatrix(bst_idx_t n_samples, bst_feature_t n_features,
+                                            float sparsity, std::uint64_t seed = 0) {
+  std::mt19937_64 rng{seed};
+  std::uniform_real_distribution<float> dist{0.0f, 1.0f};
+  std::vector<float> data(n_samples * n_features);
+  for (auto& v : data) {
+    v = dist(rng);
+  }
+  std::vector<float> labels(n_samples);
+  for (bst_idx_t i = 0; i < n_samples; ++i) {
+    // Interactions between the first few features, so that trees have some depth.
+    auto const* row = data.data() + i * n_features;
+    auto score = row[0] + row[n_features / 2] * row[n_features - 1] + 0.25f * dist(rng);
+    labels[i] = score > 0.75f;
+  }
+  float constexpr kMissing = std::numeric_limits<float>::quiet_NaN();
+  if (sparsity > 0.0f) {
+    for (auto& v : data) {
+      if (dist(rng) < sparsity) {
+        v = kMissing;
+      }
+    }
+  }
+
+  Context ctx;
+  auto str = linalg::ArrayInterfaceStr(
+      linalg::MakeTensorView(&ctx, common::Span{data}, n_samples, n_features));
+  data::ArrayAdapter adapter{StringView{str}};
+  std::shared_ptr<DMatrix> p_fmat{DMatrix::Create(&adapter, kMissing, ctx.Threads())};
+  p_fmat->Info().labels.Reshape(n_samples, 1);
+  p_fmat->Info().labels.Data()->HostVector() = std::move(labels);
+  return p_fmat;
+}
+
+/**
+ * @brief Random gradient with positive Hessian.
+ */
+inline std::vector<GradientPair> MakeGradient(bst_idx_t n_samples, std::uint64_t seed = 0) {
+  std::mt19937_64 rng{seed};
+  std::uniform_real_distribution<float> dist{-1.0f, 1.0f};
+  std::vector<GradientPair> gpair(n_samples);
+  for (auto& g : gpair) {
+    g = GradientPair{dist(rng), dist(rng) + 1.0f};
+  }
+  return gpair;
+}
+
+/**
+ * @brief Train a model with the hist tree method.
+ */
+inline std::unique_ptr<Learner> MakeModel(std::shared_ptr<DMatrix> p_fmat, std::int32_t n_rounds,
+                                          Args const& args = {}) {
+  std::unique_ptr<Learner> learner{Learner::Create({p_fmat})};
+  learner->SetParams(Args{{"tree_method", "hist"}, {"objective", "binary:logistic"}});
+  learner->SetParams(args);
+  for (std::int32_t i = 0; i < n_rounds; ++i) {
+    learner->UpdateOneIter(i, p_fmat);
+  }
+  return learner;
+}
+
+/**
+ * @brief Cache the result of an expensive setup. A benchmark function is invoked several
+ *        times for estimating the number of iterations, but the data only needs to be
+ *        generated once.
+ */
+template <typename T, typename Fn>
+std::shared_ptr<T> GetOrCreate(std::string const& key, Fn&& fn) {
+  static std::map<std::string, std::shared_ptr<T>> cache;
+  auto it = cache.find(key);
+  if (it == cache.cend()) {
+    it = cache.emplace(key, std::shared_ptr<T>{fn()}).first;
+  }
+  return it->second;
+}
+}  // namespace xgboost::bench
+#endif  // XGBOOST_TESTS_BENCHMARK_BENCH_HELPERS_H_
@@ -0,0 +1,23 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <benchmark/benchmark.h>
+#include <xgboost/context.h>  // for Context
+
+#include <string>  // for to_string
+
+#include "../../src/common/version.h"  // for Version
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  // Recorded in the context section of the JSON output, for comparing results.
+  benchmark::AddCustomContext("xgboost_version",
+                              xgboost::Version::String(xgboost::Version::Self()));
+  benchmark::AddCustomContext("xgboost_threads", std::to_string(xgboost::Context{}.Threads()));
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,53 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ *
+ * Benchmarks for the CPU predictor.
+ */
+#include <benchmark/benchmark.h>
+#include <xgboost/host_device_vector.h>  // for HostDeviceVector
+#include <xgboost/learner.h>             // for Learner
+
+#include <string>  // for to_string
+
+#include "bench_helpers.h"  // for MakeDMatrix, MakeModel, GetOrCreate
+
+namespace xgboost::bench {
+// Arguments are the number of samples, the number of features, the percentage of missing
+// values, the number of trees and the maximum depth. The predictor processes dense inputs
+// in blocks of 64 rows, and sparse inputs with a density lower than 0.5 one row at a time.
+void BM_Predict(benchmark::State& state) {
+  auto n_samples = state.range(0);
+  auto n_features = state.range(1);
+  auto sparsity = state.range(2) / 100.0f;
+  auto key = std::to_string(n_samples) + "-" + std::to_string(n_features) + "-" +
+             std::to_string(state.range(2));
+  auto p_fmat =
+      GetOrCreate<DMatrix>(key, [&] { return MakeDMatrix(n_samples, n_features, sparsity); });
+  key += "-" + std::to_string(state.range(3)) + "-" + std::to_string(state.range(4));
+  auto learner = GetOrCreate<Learner>(key, [&] {
+    auto learner =
+        MakeModel(p_fmat, state.range(3), {{"max_depth", std::to_string(state.range(4))}});
+    // Bypass the prediction cache.
+    learner->Freeze();
+    return learner;
+  });
+
+  HostDeviceVector<float> predt;
+  for (auto _ : state) {
+    learner->Predict(p_fmat, true, &predt, 0, 0);
+    benchmark::DoNotOptimize(predt.HostPointer());
+  }
+  state.SetItemsProcessed(state.iterations() * n_samples);
+  state.SetLabel(sparsity < 0.5f ? "block-64" : "block-1");
+}
+
+BENCHMARK(BM_Predict)
+    ->ArgNames({"rows", "cols", "missing%", "trees", "depth"})
+    ->Args({1 << 16, 32, 0, 100, 6})
+    ->Args({1 << 16, 32, 0, 100, 12})
+    ->Args({1 << 16, 32, 60, 100, 6})
+    ->Args({1 << 16, 32, 60, 100, 12})
+    ->Args({1 << 10, 32, 0, 100, 6})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+}  // namespace xgboost::bench
@@ -0,0 +1,41 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ *
+ * End-to-end training benchmarks on synthetic data.
+ */
+#include <benchmark/benchmark.h>
+#include <xgboost/learner.h>  // for Learner
+
+#include <cstdint>  // for int32_t
+#include <string>   // for string, to_string
+
+#include "bench_helpers.h"  // for MakeDMatrix, MakeModel, GetOrCreate
+
+namespace xgboost::bench {
+// Arguments are the number of samples, the number of features, the number of boosting
+// rounds and the maximum depth. The gradient index is cached by the DMatrix in a warm-up
+// round before the measurement, see BM_SketchOnDMatrix for the quantile sketching.
+void BM_Train(benchmark::State& state) {
+  auto key = std::to_string(state.range(0)) + "-" + std::to_string(state.range(1));
+  auto p_fmat =
+      GetOrCreate<DMatrix>(key, [&] { return MakeDMatrix(state.range(0), state.range(1), 0.0f); });
+  Args args{{"max_depth", std::to_string(state.range(3))}, {"eta", "0.1"}};
+  MakeModel(p_fmat, 1, args);
+
+  auto n_rounds = static_cast<std::int32_t>(state.range(2));
+  for (auto _ : state) {
+    auto learner = MakeModel(p_fmat, n_rounds, args);
+    benchmark::DoNotOptimize(learner.get());
+  }
+  state.SetItemsProcessed(state.iterations() * n_rounds);
+}
+
+// Shaped like the HIGGS dataset with 28 features and the Epsilon dataset with 2000
+// features, with fewer samples.
+BENCHMARK(BM_Train)
+    ->ArgNames({"rows", "cols", "rounds", "depth"})
+    ->Args({1 << 20, 28, 50, 8})
+    ->Args({1 << 15, 2000, 20, 8})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+}  // namespace xgboost::bench
@@ -0,0 +1,169 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ *
+ * Benchmarks for the kernels of the hist tree method.
+ */
+#include <benchmark/benchmark.h>
+#include <xgboost/base.h>        // for GradientPair, GradientPairPrecise
+#include <xgboost/context.h>     // for Context
+#include <xgboost/tree_model.h>  // for RegTree
+
+#include <algorithm>  // for fill
+#include <cstddef>    // for size_t
+#include <memory>     // for make_shared
+#include <numeric>    // for iota
+#include <string>     // for to_string
+#include <vector>     // for vector
+
+#include "../../src/common/hist_util.h"           // for BuildHist, GHistRow
+#include "../../src/common/random.h"              // for ColumnSampler
+#include "../../src/data/gradient_index.h"        // for GHistIndexMatrix
+#include "../../src/tree/common_row_partitioner.h"  // for CommonRowPartitioner
+#include "../../src/tree/hist/evaluate_splits.h"  // for HistEvaluator
+#include "../../src/tree/hist/expand_entry.h"     // for CPUExpandEntry
+#include "../../src/tree/hist/hist_cache.h"       // for BoundedHistCollection
+#include "../../src/tree/hist/param.h"            // for HistMakerTrainParam
+#include "../../src/tree/param.h"                 // for TrainParam, GradStats
+#include "bench_helpers.h"                        // for MakeDMatrix, MakeGradient
+
+namespace xgboost::bench {
+using tree::BoundedHistCollection;
+using tree::CommonRowPartitioner;
+using tree::CPUExpandEntry;
+using tree::GradStats;
+using tree::HistEvaluator;
+using tree::HistMakerTrainParam;
+using tree::TrainParam;
+
+namespace {
+// Arguments are the number of samples, the number of features, the maximum number of bins
+// and the percentage of missing values. The DMatrix caches the gradient index.
+std::shared_ptr<DMatrix> GetDMatrix(benchmark::State const& state) {
+  auto key = std::to_string(state.range(0)) + "-" + std::to_string(state.range(1)) + "-" +
+             std::to_string(state.range(3));
+  return GetOrCreate<DMatrix>(
+      key, [&] { return MakeDMatrix(state.range(0), state.range(1), state.range(3) / 100.0f); });
+}
+
+// The page is cached by the DMatrix, the column matrix is initialized.
+GHistIndexMatrix const& GetGHist(Context const* ctx, std::shared_ptr<DMatrix> p_fmat,
+                                 benchmark::State const& state) {
+  BatchParam param{static_cast<bst_bin_t>(state.range(2)), 0.5};
+  return *p_fmat->GetBatches<GHistIndexMatrix>(ctx, param).begin();
+}
+
+void SetBinTypeLabel(GHistIndexMatrix const& gmat, benchmark::State* state) {
+  auto size = static_cast<std::int32_t>(gmat.index.GetBinTypeSize());
+  state->SetLabel((gmat.IsDense() ? "dense-uint" : "sparse-uint") + std::to_string(size * 8));
+}
+}  // anonymous namespace
+
+// Histogram build for all rows of the root node, by a single thread.
+void BM_BuildHist(benchmark::State& state) {
+  Context ctx;
+  auto p_fmat = GetDMatrix(state);
+  auto const& gmat = GetGHist(&ctx, p_fmat, state);
+  auto n_samples = gmat.Size();
+  auto gpair = MakeGradient(n_samples);
+  std::vector<bst_idx_t> row_indices(n_samples);
+  std::iota(row_indices.begin(), row_indices.end(), 0);
+  std::vector<GradientPairPrecise> hist(gmat.cut.TotalBins());
+  common::GHistRow row{hist.data(), hist.size()};
+
+  for (auto _ : state) {
+    std::fill(hist.begin(), hist.end(), GradientPairPrecise{});
+    if (gmat.IsDense()) {
+      common::BuildHist<false>(gpair, row_indices, gmat, row);
+    } else {
+      common::BuildHist<true>(gpair, row_indices, gmat, row);
+    }
+    benchmark::DoNotOptimize(hist.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n_samples);
+  SetBinTypeLabel(gmat, &state);
+}
+
+// Dense data for each of the bin types, the sparse data always uses 32-bit bin index.
+BENCHMARK(BM_BuildHist)
+    ->ArgNames({"rows", "cols", "bins", "missing%"})
+    ->Args({1 << 18, 32, 256, 0})
+    ->Args({1 << 18, 32, 1024, 0})
+    ->Args({1 << 18, 2, 1 << 17, 0})
+    ->Args({1 << 18, 32, 256, 60})
+    ->Args({1 << 18, 32, 256, 90});
+
+// Partition of all rows by a root split.
+void BM_Partition(benchmark::State& state) {
+  Context ctx;
+  auto p_fmat = GetDMatrix(state);
+  auto const& gmat = GetGHist(&ctx, p_fmat, state);
+  bst_feature_t constexpr kSplitIdx = 0;
+  auto ptr = gmat.cut.Ptrs()[kSplitIdx + 1];
+  auto split_value = gmat.cut.Values().at(ptr / 2);
+
+  RegTree tree;
+  tree.ExpandNode(RegTree::kRoot, kSplitIdx, split_value, true, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+                  0.0f, 0.0f);
+  std::vector<CPUExpandEntry> candidates{{RegTree::kRoot, 0}};
+  candidates.front().split.split_value = split_value;
+  candidates.front().split.sindex = kSplitIdx | (1U << 31);
+  candidates.front().split.loss_chg = 1.0f;
+
+  CommonRowPartitioner partitioner;
+  for (auto _ : state) {
+    state.PauseTiming();
+    partitioner.Reset(&ctx, gmat.Size(), 0, false);
+    state.ResumeTiming();
+    partitioner.UpdatePosition(&ctx, gmat, candidates, &tree);
+  }
+  state.SetItemsProcessed(state.iterations() * gmat.Size());
+  SetBinTypeLabel(gmat, &state);
+}
+
+BENCHMARK(BM_Partition)
+    ->ArgNames({"rows", "cols", "bins", "missing%"})
+    ->Args({1 << 20, 32, 256, 0})
+    ->Args({1 << 20, 32, 256, 60})
+    ->UseRealTime();
+
+// Split evaluation of the root node, using all threads.
+void BM_EvaluateSplits(benchmark::State& state) {
+  Context ctx;
+  auto p_fmat = GetDMatrix(state);
+  auto const& gmat = GetGHist(&ctx, p_fmat, state);
+  TrainParam param;
+  param.UpdateAllowUnknown(Args{});
+
+  auto gpair = MakeGradient(gmat.Size());
+  std::vector<bst_idx_t> row_indices(gmat.Size());
+  std::iota(row_indices.begin(), row_indices.end(), 0);
+  BoundedHistCollection hist;
+  HistMakerTrainParam hist_param;
+  hist.Reset(gmat.cut.TotalBins(), hist_param.MaxCachedHistNodes(ctx.Device()));
+  hist.AllocateHistograms({RegTree::kRoot});
+  common::BuildHist<false>(gpair, row_indices, gmat, hist[RegTree::kRoot]);
+  GradientPairPrecise root_sum;
+  for (auto const& g : gpair) {
+    root_sum += GradientPairPrecise{g};
+  }
+
+  MetaInfo info;
+  info.num_col_ = gmat.Features();
+  auto sampler = std::make_shared<common::ColumnSampler>(0u);
+  HistEvaluator evaluator{&ctx, &param, info, sampler};
+  RegTree tree;
+  for (auto _ : state) {
+    std::vector<CPUExpandEntry> entries{{RegTree::kRoot, 0}};
+    evaluator.InitRoot(GradStats{root_sum});
+    evaluator.EvaluateSplits(hist, gmat.cut, {}, tree, &entries);
+    benchmark::DoNotOptimize(entries.front().split.loss_chg);
+  }
+  state.SetItemsProcessed(state.iterations() * gmat.cut.TotalBins());
+}
+
+BENCHMARK(BM_EvaluateSplits)
+    ->ArgNames({"rows", "cols", "bins", "missing%"})
+    ->Args({1 << 14, 32, 256, 0})
+    ->Args({1 << 14, 2000, 256, 0})
+    ->UseRealTime();
+}  // namespace xgboost::bench
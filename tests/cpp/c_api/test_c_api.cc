@@ -8,11 +8,17 @@
 #include <xgboost/learner.h>
 #include <xgboost/version_config.h>
 
+#include <algorithm>   // for fill
 #include <array>       // for array
+#include <atomic>      // for atomic
 #include <cstddef>     // std::size_t
 #include <filesystem>  // std::filesystem
+#include <functional>  // for multiplies
 #include <limits>      // std::numeric_limits
+#include <memory>      // for unique_ptr
+#include <numeric>     // for accumulate
 #include <string>      // std::string
+#include <thread>      // for yield
 #include <vector>
 
 #include "../../../src/c_api/c_api_error.h"
@@ -593,6 +599,548 @@ TEST(CAPI, XGDMatrixGetQuantileCut) {
   TestXGDMatrixGetQuantileCut(&ctx);
 }
 
+TEST(CAPI, PredictHandle) {
+  bst_idx_t constexpr kRows = 128;
+  bst_feature_t constexpr kCols = 8;
+  bst_target_t constexpr kClasses = 3;
+  auto gen = RandomDataGenerator{kRows, kCols, 0.0}.Classes(kClasses);
+  auto p_fmat = gen.GenerateDMatrix(true);
+  HostDeviceVector<float> storage;
+  auto array_interface = gen.GenerateArrayInterface(&storage);
+  auto const &h_data = storage.ConstHostVector();
+
+  for (auto obj : {"multi:softprob", "multi:softmax"}) {
+    std::unique_ptr<Learner> learner{Learner::Create({p_fmat})};
+    learner->SetParams(Args{{"objective", obj}, {"num_class", std::to_string(kClasses)}});
+    for (std::int32_t i = 0; i < 4; ++i) {
+      learner->UpdateOneIter(i, p_fmat);
+    }
+    BoosterHandle booster = learner.get();
+
+    for (std::int32_t type : {0, 1}) {
+      Json config{Object{}};
+      config["type"] = Integer{type};
+      config["training"] = Boolean{false};
+      config["iteration_begin"] = Integer{0};
+      config["iteration_end"] = Integer{0};
+      config["strict_shape"] = Boolean{false};
+      config["missing"] = Number{-1.0f};
+      auto str_config = Json::Dump(config);
+
+      bst_ulong const *out_shape;
+      bst_ulong out_dim;
+      float const *out_result;
+      ASSERT_EQ(XGBoosterPredictFromDense(booster, array_interface.c_str(), str_config.c_str(),
+                                          nullptr, &out_shape, &out_dim, &out_result),
+                0);
+      auto n_outputs = out_dim == 1 ? kRows : out_shape[0] * out_shape[1];
+      std::vector<float> expected(out_result, out_result + n_outputs);
+
+      PredictHandle handle;
+      bst_ulong row_size{0};
+      ASSERT_EQ(XGBoosterCreatePredictHandle(booster, str_config.c_str(), &handle, &row_size), 0);
+      ASSERT_EQ(row_size * kRows, expected.size());
+
+      // Predict the data in small chunks, then the full data in one call.
+      std::vector<float> predt(expected.size(), 0.0f);
+      std::array<bst_ulong, 4> chunks{0, 1, 4, kRows};
+      for (std::size_t i = 0; i + 1 < chunks.size(); ++i) {
+        ASSERT_EQ(XGBoosterPredictWithHandle(handle, h_data.data() + chunks[i] * kCols,
+                                             chunks[i + 1] - chunks[i],
+                                             predt.data() + chunks[i] * row_size),
+                  0);
+      }
+      for (std::size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_FLOAT_EQ(predt[i], expected[i]);
+      }
+      std::fill(predt.begin(), predt.end(), 0.0f);
+      ASSERT_EQ(XGBoosterPredictWithHandle(handle, h_data.data(), kRows, predt.data()), 0);
+      for (std::size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_FLOAT_EQ(predt[i], expected[i]);
+      }
+      ASSERT_EQ(XGBoosterPredictWithHandle(handle, nullptr, 0, nullptr), 0);
+      ASSERT_EQ(XGPredictHandleFree(handle), 0);
+    }
+  }
+}
+
+TEST(CAPI, PredictThreads) {
+  bst_idx_t constexpr kRows = 64;
+  bst_feature_t constexpr kCols = 8;
+  auto gen = RandomDataGenerator{kRows, kCols, 0.0};
+  auto p_fmat = gen.GenerateDMatrix(true);
+  HostDeviceVector<float> storage;
+  auto array_interface = gen.GenerateArrayInterface(&storage);
+
+  std::unique_ptr<Learner> learner{Learner::Create({p_fmat})};
+  learner->SetParams(Args{{"nthread", "2"}});
+  for (std::int32_t i = 0; i < 3; ++i) {
+    learner->UpdateOneIter(i, p_fmat);
+  }
+  BoosterHandle booster = learner.get();
+
+  Json config{Object{}};
+  config["type"] = Integer{0};
+  config["training"] = Boolean{false};
+  config["iteration_begin"] = Integer{0};
+  config["iteration_end"] = Integer{0};
+  config["strict_shape"] = Boolean{false};
+  config["missing"] = Number{std::numeric_limits<float>::quiet_NaN()};
+
+  bst_ulong const *out_shape;
+  bst_ulong out_dim;
+  float const *out_result;
+  std::vector<std::vector<float>> results;
+  for (std::int64_t n_threads : {0, 1, 3}) {
+    config["nthread"] = Integer{n_threads};
+    auto str_config = Json::Dump(config);
+    ASSERT_EQ(XGBoosterPredictFromDense(booster, array_interface.c_str(), str_config.c_str(),
+                                        nullptr, &out_shape, &out_dim, &out_result),
+              0);
+    results.emplace_back(out_result, out_result + kRows);
+    // The booster is not changed.
+    ASSERT_EQ(learner->Ctx()->nthread, 2);
+  }
+  for (auto const &predt : results) {
+    ASSERT_EQ(predt, results.front());
+  }
+
+  config["nthread"] = Integer{-1};
+  auto str_config = Json::Dump(config);
+  ASSERT_EQ(XGBoosterPredictFromDense(booster, array_interface.c_str(), str_config.c_str(),
+                                      nullptr, &out_shape, &out_dim, &out_result),
+            -1);
+}
+
+TEST(CAPI, PredictWithHandles) {
+  bst_idx_t constexpr kRows = 300;
+  bst_feature_t constexpr kCols = 8;
+  auto gen = RandomDataGenerator{kRows, kCols, 0.2}.Classes(3);
+  auto p_fmat = gen.GenerateDMatrix(true);
+  HostDeviceVector<float> storage;
+  std::ignore = gen.GenerateArrayInterface(&storage);
+  auto const &h_data = storage.ConstHostVector();
+
+  std::vector<std::unique_ptr<Learner>> learners;
+  std::vector<PredictHandle> handles;
+  std::vector<bst_ulong> row_sizes;
+  for (auto obj : {"multi:softprob", "multi:softmax", "reg:absoluteerror"}) {
+    learners.emplace_back(Learner::Create({p_fmat}));
+    auto &learner = learners.back();
+    learner->SetParam("objective", obj);
+    if (std::string{obj}.find("multi") == 0) {
+      learner->SetParam("num_class", "3");
+    }
+    for (std::int32_t i = 0; i < 3; ++i) {
+      learner->UpdateOneIter(i, p_fmat);
+    }
+    for (std::int32_t type : {0, 1}) {
+      Json config{Object{}};
+      config["type"] = Integer{type};
+      config["iteration_begin"] = Integer{0};
+      config["iteration_end"] = Integer{type == 0 ? 0 : 2};
+      config["missing"] = Number{-1.0f};
+      auto str_config = Json::Dump(config);
+      PredictHandle handle;
+      bst_ulong row_size{0};
+      ASSERT_EQ(
+          XGBoosterCreatePredictHandle(learner.get(), str_config.c_str(), &handle, &row_size), 0);
+      handles.push_back(handle);
+      row_sizes.push_back(row_size);
+    }
+  }
+
+  std::vector<std::vector<float>> expected(handles.size());
+  std::vector<std::vector<float>> predts(handles.size());
+  std::vector<float *> out_results(handles.size());
+  for (std::size_t i = 0; i < handles.size(); ++i) {
+    expected[i].resize(kRows * row_sizes[i]);
+    ASSERT_EQ(XGBoosterPredictWithHandle(handles[i], h_data.data(), kRows, expected[i].data()),
+              0);
+    predts[i].resize(expected[i].size());
+    out_results[i] = predts[i].data();
+  }
+  ASSERT_EQ(XGBoosterPredictWithHandles(handles.data(), handles.size(), h_data.data(), kRows,
+                                        out_results.data()),
+            0);
+  for (std::size_t i = 0; i < handles.size(); ++i) {
+    for (std::size_t j = 0; j < expected[i].size(); ++j) {
+      ASSERT_FLOAT_EQ(predts[i][j], expected[i][j]);
+    }
+  }
+  ASSERT_EQ(XGBoosterPredictWithHandles(handles.data(), handles.size(), nullptr, 0, nullptr), 0);
+  ASSERT_EQ(XGBoosterPredictWithHandles(nullptr, 0, nullptr, 0, nullptr), 0);
+
+  // Different missing values are rejected.
+  Json config{Object{}};
+  config["type"] = Integer{0};
+  config["iteration_begin"] = Integer{0};
+  config["iteration_end"] = Integer{0};
+  config["missing"] = Number{-2.0f};
+  auto str_config = Json::Dump(config);
+  PredictHandle handle;
+  bst_ulong row_size{0};
+  ASSERT_EQ(
+      XGBoosterCreatePredictHandle(learners[0].get(), str_config.c_str(), &handle, &row_size), 0);
+  std::array<PredictHandle, 2> mixed{handles.front(), handle};
+  ASSERT_NE(XGBoosterPredictWithHandles(mixed.data(), mixed.size(), h_data.data(), kRows,
+                                        out_results.data()),
+            0);
+  ASSERT_EQ(XGPredictHandleFree(handle), 0);
+  for (auto h : handles) {
+    ASSERT_EQ(XGPredictHandleFree(h), 0);
+  }
+}
+
+TEST(CAPI, PredictOutputMask) {
+  bst_idx_t constexpr kRows = 64;
+  bst_feature_t constexpr kCols = 4;
+  auto p_fmat = RandomDataGenerator{kRows, kCols, 0.0}.Classes(2).GenerateDMatrix(true);
+  std::unique_ptr<Learner> learner{Learner::Create({p_fmat})};
+  learner->SetParam("objective", "binary:logistic");
+  for (std::int32_t i = 0; i < 3; ++i) {
+    learner->UpdateOneIter(i, p_fmat);
+  }
+  DMatrixHandle dmat = &p_fmat;
+
+  auto predict = [&](Json config, std::vector<bst_ulong> *shape) {
+    config["training"] = Boolean{false};
+    config["iteration_begin"] = Integer{0};
+    config["iteration_end"] = Integer{0};
+    config["strict_shape"] = Boolean{false};
+    auto str_config = Json::Dump(config);
+    bst_ulong const *out_shape;
+    bst_ulong out_dim;
+    float const *out_result;
+    auto rc = XGBoosterPredictFromDMatrix(learner.get(), dmat, str_config.c_str(), &out_shape,
+                                          &out_dim, &out_result);
+    EXPECT_EQ(rc, 0) << XGBGetLastError();
+    shape->assign(out_shape, out_shape + out_dim);
+    auto n = std::accumulate(shape->cbegin(), shape->cend(), bst_ulong{1}, std::multiplies<>{});
+    return std::vector<float>(out_result, out_result + n);
+  };
+
+  std::vector<bst_ulong> shape;
+  Json config{Object{}};
+  config["type"] = Integer{0};
+  auto value = predict(config, &shape);
+  config["type"] = Integer{6};
+  auto leaf = predict(config, &shape);
+  auto n_trees = leaf.size() / kRows;
+  ASSERT_EQ(n_trees, 3);
+
+  config = Json{Object{}};
+  config["output_mask"] = Integer{(1 << 0) | (1 << 6)};
+  auto fused = predict(config, &shape);
+  ASSERT_EQ(shape, (std::vector<bst_ulong>{kRows, 1 + n_trees}));
+  for (std::size_t i = 0; i < kRows; ++i) {
+    ASSERT_NEAR(fused[i * (1 + n_trees)], value[i], kRtEps);
+    for (std::size_t j = 0; j < n_trees; ++j) {
+      ASSERT_EQ(fused[i * (1 + n_trees) + 1 + j], leaf[i * n_trees + j]);
+    }
+  }
+
+  // Contribution is not supported.
+  config["output_mask"] = Integer{(1 << 3) | (1 << 6)};
+  config["training"] = Boolean{false};
+  config["iteration_begin"] = Integer{0};
+  config["iteration_end"] = Integer{0};
+  auto str_config = Json::Dump(config);
+  bst_ulong const *out_shape;
+  bst_ulong out_dim;
+  float const *out_result;
+  ASSERT_NE(XGBoosterPredictFromDMatrix(learner.get(), dmat, str_config.c_str(), &out_shape,
+                                        &out_dim, &out_result),
+            0);
+}
+
+namespace {
+struct AsyncTrainProgress {
+  std::vector<std::int32_t> iters;
+  std::vector<std::string> results;
+  std::atomic<std::int32_t> n_rounds{0};
+  std::int32_t stop_at{-1};
+};
+
+int AsyncTrainCallback(int iter, char const *eval_result, void *user_data) {
+  auto *progress = static_cast<AsyncTrainProgress *>(user_data);
+  progress->iters.push_back(iter);
+  progress->results.emplace_back(eval_result);
+  ++progress->n_rounds;
+  return iter == progress->stop_at;
+}
+}  // namespace
+
+TEST(CAPI, TrainAsync) {
+  bst_idx_t constexpr kRows = 256;
+  bst_feature_t constexpr kCols = 8;
+  auto p_fmat = RandomDataGenerator{kRows, kCols, 0.0}.GenerateDMatrix(true);
+  DMatrixHandle dtrain = &p_fmat;
+  std::array<DMatrixHandle, 1> dmats{dtrain};
+  std::array<char const *, 1> names{"train"};
+
+  {
+    // Train all the rounds, then continue the training with early stop.
+    std::unique_ptr<Learner> learner{Learner::Create({p_fmat})};
+    learner->SetParam("max_depth", "3");
+    AsyncTrainProgress progress;
+    AsyncTrainHandle handle;
+    ASSERT_EQ(XGBoosterTrainAsync(learner.get(), dtrain, dmats.data(), names.data(), names.size(),
+                                  4, AsyncTrainCallback, &progress, &handle),
+              0);
+    int n_rounds{0};
+    ASSERT_EQ(XGAsyncTrainWait(handle, &n_rounds), 0);
+    ASSERT_EQ(n_rounds, 4);
+    ASSERT_EQ(progress.iters, (std::vector<std::int32_t>{0, 1, 2, 3}));
+    for (auto const &str : progress.results) {
+      ASSERT_NE(str.find("train-rmse"), std::string::npos);
+    }
+    ASSERT_EQ(XGAsyncTrainFree(handle), 0);
+
+    progress.iters.clear();
+    progress.stop_at = 5;
+    ASSERT_EQ(XGBoosterTrainAsync(learner.get(), dtrain, nullptr, nullptr, 0, 8,
+                                  AsyncTrainCallback, &progress, &handle),
+              0);
+    ASSERT_EQ(XGAsyncTrainWait(handle, &n_rounds), 0);
+    ASSERT_EQ(n_rounds, 2);
+    ASSERT_EQ(progress.iters, (std::vector<std::int32_t>{4, 5}));
+    ASSERT_TRUE(progress.results.back().empty());
+    ASSERT_EQ(XGAsyncTrainFree(handle), 0);
+    ASSERT_EQ(learner->BoostedRounds(), 6);
+  }
+  {
+    // Pause for prediction, then cancel.
+    std::unique_ptr<Learner> learner{Learner::Create({p_fmat})};
+    learner->SetParam("max_depth", "3");
+    AsyncTrainProgress progress;
+    AsyncTrainHandle handle;
+    ASSERT_EQ(XGBoosterTrainAsync(learner.get(), dtrain, nullptr, nullptr, 0,
+                                  std::numeric_limits<std::int32_t>::max(), AsyncTrainCallback,
+                                  &progress, &handle),
+              0);
+    while (progress.n_rounds.load() < 2) {
+      std::this_thread::yield();
+    }
+    ASSERT_EQ(XGAsyncTrainPause(handle), 0);
+    int n_boosted{0};
+    ASSERT_EQ(XGBoosterBoostedRounds(learner.get(), &n_boosted), 0);
+    ASSERT_GE(n_boosted, 2);
+    auto p_test = RandomDataGenerator{kRows, kCols, 0.0}.Seed(1).GenerateDMatrix();
+    HostDeviceVector<float> predt;
+    learner->Predict(p_test, false, &predt, 0, 0);
+    ASSERT_EQ(predt.Size(), kRows);
+    ASSERT_EQ(XGAsyncTrainResume(handle), 0);
+
+    ASSERT_EQ(XGAsyncTrainCancel(handle), 0);
+    int n_rounds{0};
+    ASSERT_EQ(XGAsyncTrainWait(handle, &n_rounds), 0);
+    ASSERT_GE(n_rounds, n_boosted);
+    ASSERT_EQ(learner->BoostedRounds(), n_rounds);
+    ASSERT_EQ(XGAsyncTrainFree(handle), 0);
+  }
+}
+
+TEST(CAPI, ModelSlot) {
+  bst_idx_t constexpr kRows = 256;
+  bst_feature_t constexpr kCols = 8;
+  auto p_fmat = RandomDataGenerator{kRows, kCols, 0.0}.GenerateDMatrix(true);
+  auto p_test = RandomDataGenerator{kRows, kCols, 0.0}.Seed(1).GenerateDMatrix();
+  auto tempdir = std::filesystem::temp_directory_path();
+
+  // Two models with different number of rounds, saved into a buffer and a mmap file.
+  std::vector<std::vector<float>> expected;
+  std::vector<char> buffer;
+  auto mmap_path = (tempdir / "model_slot.mmap").string();
+  for (std::int32_t n_rounds : {2, 4}) {
+    std::unique_ptr<Learner> learner{Learner::Create({p_fmat})};
+    learner->SetParam("max_depth", "3");
+    for (std::int32_t i = 0; i < n_rounds; ++i) {
+      learner->UpdateOneIter(i, p_fmat);
+    }
+    HostDeviceVector<float> predt;
+    learner->Predict(p_test, false, &predt, 0, 0);
+    expected.push_back(predt.HostVector());
+    if (n_rounds == 2) {
+      bst_ulong len{0};
+      char const *data{nullptr};
+      ASSERT_EQ(XGBoosterSaveModelToBuffer(learner.get(), R"({"format": "ubj"})", &len, &data),
+                0);
+      buffer.assign(data, data + len);
+    } else {
+      ASSERT_EQ(XGBoosterSaveModel(learner.get(), mmap_path.c_str()), 0);
+    }
+  }
+  auto predict = [](BoosterHandle booster, std::shared_ptr<DMatrix> p_test) {
+    HostDeviceVector<float> predt;
+    static_cast<Learner *>(booster)->Predict(p_test, false, &predt, 0, 0);
+    return predt.HostVector();
+  };
+
+  ModelSlotHandle slot;
+  ASSERT_EQ(XGModelSlotCreate(R"({"nthread": 2})", &slot), 0);
+  ModelPinHandle pin_0;
+  BoosterHandle booster_0;
+  // Empty slot.
+  ASSERT_EQ(XGModelSlotAcquire(slot, &pin_0, &booster_0), -1);
+
+  bst_ulong version{0};
+  ASSERT_EQ(XGModelSlotLoadFromBuffer(slot, buffer.data(), buffer.size(), &version), 0);
+  ASSERT_EQ(version, 1);
+  ASSERT_EQ(XGModelSlotAcquire(slot, &pin_0, &booster_0), 0);
+  ASSERT_TRUE(static_cast<Learner *>(booster_0)->IsFrozen());
+  ASSERT_EQ(predict(booster_0, p_test), expected[0]);
+
+  // The pinned model is still valid after being replaced.
+  ASSERT_EQ(XGModelSlotLoad(slot, mmap_path.c_str(), &version), 0);
+  ASSERT_EQ(version, 2);
+  ModelPinHandle pin_1;
+  BoosterHandle booster_1;
+  ASSERT_EQ(XGModelSlotAcquire(slot, &pin_1, &booster_1), 0);
+  ASSERT_EQ(predict(booster_1, p_test), expected[1]);
+  ASSERT_EQ(predict(booster_0, p_test), expected[0]);
+  ASSERT_EQ(XGModelPinFree(pin_0), 0);
+  // A failed load keeps the current model.
+  ASSERT_EQ(XGModelSlotLoad(slot, (tempdir / "model_slot_missing.json").string().c_str(),
+                            &version),
+            -1);
+
+  // Swap the models while predicting from other threads.
+  std::atomic<bool> stop{false};
+  std::atomic<std::int32_t> n_mismatched{0};
+  std::vector<std::thread> readers;
+  for (std::int32_t t = 0; t < 2; ++t) {
+    readers.emplace_back([&] {
+      // Same data as the test DMatrix.
+      auto p_local = RandomDataGenerator{kRows, kCols, 0.0}.Seed(1).GenerateDMatrix();
+      while (!stop.load()) {
+        ModelPinHandle pin;
+        BoosterHandle booster;
+        if (XGModelSlotAcquire(slot, &pin, &booster) != 0) {
+          ++n_mismatched;
+          return;
+        }
+        auto predt = predict(booster, p_local);
+        if (predt != expected[0] && predt != expected[1]) {
+          ++n_mismatched;
+        }
+        XGModelPinFree(pin);
+      }
+    });
+  }
+  for (std::int32_t i = 0; i < 4; ++i) {
+    if (i % 2 == 0) {
+      ASSERT_EQ(XGModelSlotLoadFromBuffer(slot, buffer.data(), buffer.size(), &version), 0);
+    } else {
+      ASSERT_EQ(XGModelSlotLoad(slot, mmap_path.c_str(), &version), 0);
+    }
+  }
+  stop = true;
+  for (auto &t : readers) {
+    t.join();
+  }
+  ASSERT_EQ(n_mismatched.load(), 0);
+  ASSERT_EQ(version, 6);
+
+  // The pin outlives the slot.
+  ASSERT_EQ(XGModelSlotFree(slot), 0);
+  ASSERT_EQ(predict(booster_1, p_test), expected[1]);
+  ASSERT_EQ(XGModelPinFree(pin_1), 0);
+  std::filesystem::remove(mmap_path);
+}
+
+TEST(CAPI, DumpModelStream) {
+  bst_idx_t constexpr kRows = 64;
+  bst_feature_t constexpr kCols = 4;
+  auto p_fmat = RandomDataGenerator{kRows, kCols, 0.0}.GenerateDMatrix(true);
+  std::unique_ptr<Learner> learner{Learner::Create({p_fmat})};
+  learner->SetParam("num_parallel_tree", "3");
+  for (std::int32_t i = 0; i < 8; ++i) {
+    learner->UpdateOneIter(i, p_fmat);
+  }
+
+  for (auto format : {"text", "json"}) {
+    bst_ulong n_trees{0};
+    char const **dumps{nullptr};
+    ASSERT_EQ(XGBoosterDumpModelEx(learner.get(), "", 1, format, &n_trees, &dumps), 0);
+    std::vector<std::string> expected(dumps, dumps + n_trees);
+    ASSERT_EQ(n_trees, 24ul);
+
+    Json config{Object{}};
+    config["with_stats"] = Boolean{true};
+    config["format"] = String{format};
+    auto str_config = Json::Dump(config);
+    std::vector<std::string> streamed;
+    auto fn = [](bst_ulong idx, char const *dump, bst_ulong len, void *user_data) {
+      auto out = static_cast<std::vector<std::string> *>(user_data);
+      EXPECT_EQ(idx, out->size());
+      out->emplace_back(dump, len);
+      return 0;
+    };
+    ASSERT_EQ(XGBoosterDumpModelStream(learner.get(), str_config.c_str(), fn, &streamed), 0)
+        << XGBGetLastError();
+    ASSERT_EQ(streamed, expected);
+
+    // Stop early
+    streamed.clear();
+    auto stop = [](bst_ulong idx, char const *dump, bst_ulong len, void *user_data) {
+      static_cast<std::vector<std::string> *>(user_data)->emplace_back(dump, len);
+      return idx == 2 ? 1 : 0;
+    };
+    ASSERT_EQ(XGBoosterDumpModelStream(learner.get(), str_config.c_str(), stop, &streamed), 0);
+    ASSERT_EQ(streamed.size(), 3ul);
+  }
+}
+
+TEST(CAPI, GradientBuffer) {
+  bst_idx_t constexpr kRows = 64;
+  bst_target_t constexpr kTargets = 2;
+  auto p_fmat = RandomDataGenerator{kRows, 4, 0.0}.Targets(kTargets).GenerateDMatrix(true);
+  DMatrixHandle dtrain = &p_fmat;
+  Context ctx;
+
+  std::unique_ptr<Learner> expected{Learner::Create({p_fmat})};
+  std::unique_ptr<Learner> got{Learner::Create({p_fmat})};
+  for (auto const &learner : {expected.get(), got.get()}) {
+    learner->SetParams(Args{{"multi_strategy", "multi_output_tree"}});
+  }
+
+  for (std::int32_t iter = 0; iter < 3; ++iter) {
+    auto gpair = GenerateRandomGradients(kRows * kTargets, -1.0f, 1.0f);
+    auto const &h_gpair = gpair.ConstHostVector();
+    std::vector<float> grad(h_gpair.size()), hess(h_gpair.size());
+    for (std::size_t i = 0; i < h_gpair.size(); ++i) {
+      grad[i] = h_gpair[i].GetGrad();
+      hess[i] = h_gpair[i].GetHess();
+    }
+    auto s_grad = linalg::ArrayInterfaceStr(
+        linalg::MakeTensorView(&ctx, common::Span{grad}, kRows, kTargets));
+    auto s_hess = linalg::ArrayInterfaceStr(
+        linalg::MakeTensorView(&ctx, common::Span{hess}, kRows, kTargets));
+    ASSERT_EQ(XGBoosterTrainOneIter(expected.get(), dtrain, iter, s_grad.c_str(), s_hess.c_str()),
+              0);
+
+    char const *out;
+    ASSERT_EQ(XGBoosterGetGradientBuffer(got.get(), dtrain, &out), 0);
+    ArrayInterface<3> buffer{StringView{out}};
+    ASSERT_EQ(buffer.Shape<0>(), kRows);
+    ASSERT_EQ(buffer.Shape<1>(), kTargets);
+    ASSERT_EQ(buffer.Shape<2>(), 2);
+    ASSERT_EQ(buffer.type, ArrayInterfaceHandler::kF4);
+    auto ptr = static_cast<float *>(const_cast<void *>(buffer.data));
+    for (std::size_t i = 0; i < h_gpair.size(); ++i) {
+      ptr[i * 2] = grad[i];
+      ptr[i * 2 + 1] = hess[i];
+    }
+    ASSERT_EQ(XGBoosterTrainOneIterWithGradientBuffer(got.get(), dtrain, iter), 0);
+  }
+
+  Json m_expected{Object{}}, m_got{Object{}};
+  expected->SaveModel(&m_expected);
+  got->SaveModel(&m_got);
+  ASSERT_EQ(m_expected, m_got);
+}
+
 #if defined(XGBOOST_USE_CUDA)
 TEST(CAPI, GPUXGDMatrixGetQuantileCut) {
   auto ctx = MakeCUDACtx(0);
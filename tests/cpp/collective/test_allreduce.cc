@@ -3,12 +3,17 @@
  */
 #include <gtest/gtest.h>
 
-#include <numeric>  // for iota
+#include <algorithm>  // for count
+#include <cstdint>    // for int32_t
+#include <numeric>    // for iota
+#include <string>     // for string, to_string
+#include <vector>     // for vector
 
 #include "../../../src/collective/allreduce.h"
-#include "../../../src/collective/coll.h"  // for Coll
-#include "../../../src/common/type.h"  // for EraseType
-#include "test_worker.h"               // for WorkerForTest, TestDistributed
+#include "../../../src/collective/coll.h"        // for Coll
+#include "../../../src/collective/comm_group.h"  // for GlobalCommGroup
+#include "../../../src/common/type.h"            // for EraseType
+#include "test_worker.h"                         // for WorkerForTest, TestDistributed
 
 namespace xgboost::collective {
 namespace {
@@ -69,6 +74,48 @@ class AllreduceWorker : public WorkerForTest {
     }
   }
 
+  template <typename Fn>
+  void CheckSum(Fn&& allreduce) {
+    auto world = comm_.World();
+    for (std::size_t n : {1ul, 3ul, 64ul, 4097ul}) {
+      std::vector<std::int64_t> data(n);
+      std::iota(data.begin(), data.end(), comm_.Rank());
+      auto erased = common::EraseType(common::Span{data.data(), data.size()});
+      auto rc = allreduce(erased, [](common::Span<std::int8_t const> lhs,
+                                     common::Span<std::int8_t> out) {
+        auto lhs_t = common::RestoreType<std::int64_t const>(lhs);
+        auto out_t = common::RestoreType<std::int64_t>(out);
+        for (std::size_t i = 0; i < out_t.size(); ++i) {
+          out_t[i] += lhs_t[i];
+        }
+      });
+      SafeColl(rc);
+      for (std::size_t i = 0; i < n; ++i) {
+        // sum(i + r) for r in [0, world)
+        auto expected = static_cast<std::int64_t>(i) * world + world * (world - 1) / 2;
+        ASSERT_EQ(data[i], expected);
+      }
+    }
+  }
+
+  void Algo(cpu_impl::AllreduceAlgo algo) {
+    this->CheckSum([&](common::Span<std::int8_t> data, cpu_impl::Func const& op) {
+      return cpu_impl::Allreduce(comm_, data, op, ArrayInterfaceHandler::kI8, algo);
+    });
+  }
+
+  // Pretend that the workers are spread across `n_hosts` hosts.
+  void Hierarchical(std::int32_t n_hosts) {
+    std::vector<std::string> hosts(comm_.World());
+    for (std::int32_t r = 0; r < comm_.World(); ++r) {
+      hosts[r] = "host-" + std::to_string(r % n_hosts);
+    }
+    auto topo = MakeHostTopology(hosts, comm_.Rank());
+    this->CheckSum([&](common::Span<std::int8_t> data, cpu_impl::Func const& op) {
+      return cpu_impl::HierarchicalAllreduce(comm_, data, op, topo);
+    });
+  }
+
   void BitOr() {
     std::vector<std::uint32_t> data(comm_.World(), 0);
     data[comm_.Rank()] = ~std::uint32_t{0};
@@ -112,6 +159,57 @@ TEST_F(AllreduceTest, BitOr) {
   });
 }
 
+TEST_F(AllreduceTest, Algo) {
+  std::int32_t max_workers = std::min(7u, std::thread::hardware_concurrency());
+  for (auto algo : {cpu_impl::AllreduceAlgo::kRing, cpu_impl::AllreduceAlgo::kRecursiveDoubling}) {
+    // Cover both the power of 2 and the non-power of 2 world sizes.
+    for (std::int32_t n_workers = 1; n_workers <= max_workers; ++n_workers) {
+      TestDistributed(n_workers, [=](std::string host, std::int32_t port,
+                                     std::chrono::seconds timeout, std::int32_t r) {
+        AllreduceWorker worker{host, port, timeout, n_workers, r};
+        worker.Algo(algo);
+      });
+    }
+  }
+}
+
+TEST_F(AllreduceTest, Hierarchical) {
+  std::int32_t max_workers = std::min(7u, std::thread::hardware_concurrency());
+  for (std::int32_t n_workers = 1; n_workers <= max_workers; ++n_workers) {
+    for (std::int32_t n_hosts = 1; n_hosts <= std::min(n_workers, 3); ++n_hosts) {
+      TestDistributed(n_workers, [=](std::string host, std::int32_t port,
+                                     std::chrono::seconds timeout, std::int32_t r) {
+        AllreduceWorker worker{host, port, timeout, n_workers, r};
+        worker.Hierarchical(n_hosts);
+      });
+    }
+  }
+}
+
+TEST(AllreduceAlgo, Topology) {
+  std::vector<std::string> hosts{"a", "b", "a", "c", "b"};
+  auto topo = MakeHostTopology(hosts, 4);
+  ASSERT_EQ(topo.local, (std::vector<std::int32_t>{1, 4}));
+  ASSERT_EQ(topo.leaders, (std::vector<std::int32_t>{0, 1, 3}));
+  ASSERT_EQ(topo.Leader(), 1);
+  ASSERT_EQ(cpu_impl::SelectAllreduceAlgo(8, 5, topo), cpu_impl::AllreduceAlgo::kHierarchical);
+  // One worker per host.
+  topo = MakeHostTopology({"a", "b", "c"}, 0);
+  ASSERT_EQ(cpu_impl::SelectAllreduceAlgo(8, 3, topo),
+            cpu_impl::AllreduceAlgo::kRecursiveDoubling);
+  // Single host.
+  topo = MakeHostTopology({"a", "a", "a"}, 0);
+  ASSERT_EQ(cpu_impl::SelectAllreduceAlgo(8, 3, topo),
+            cpu_impl::AllreduceAlgo::kRecursiveDoubling);
+}
+
+TEST(AllreduceAlgo, Select) {
+  ASSERT_EQ(cpu_impl::SelectAllreduceAlgo(8, 256), cpu_impl::AllreduceAlgo::kRecursiveDoubling);
+  ASSERT_EQ(cpu_impl::SelectAllreduceAlgo(1ul << 20, 2),
+            cpu_impl::AllreduceAlgo::kRecursiveDoubling);
+  ASSERT_EQ(cpu_impl::SelectAllreduceAlgo(1ul << 20, 256), cpu_impl::AllreduceAlgo::kRing);
+}
+
 TEST_F(AllreduceTest, Restricted) {
   std::int32_t n_workers = std::min(3u, std::thread::hardware_concurrency());
   TestDistributed(n_workers, [=](std::string host, std::int32_t port, std::chrono::seconds timeout,
@@ -152,4 +250,71 @@ TEST(AllreduceGlobal, Small) {
     ASSERT_EQ(value, n_workers);
   });
 }
+
+TEST(AllreduceGlobal, Sparse) {
+  auto n_workers = 3;
+  TestDistributedGlobal(n_workers, [&]() {
+    Context ctx;
+    auto rank = GetRank();
+    for (std::size_t stride : {1, 64}) {
+      // Each worker sets a different subset of elements, the data is dense when the
+      // stride is 1.
+      std::vector<double> values(1024, 0.0);
+      for (std::size_t i = rank; i < values.size(); i += stride) {
+        values[i] = static_cast<double>(rank + 1);
+      }
+      auto rc = SparseAllreduce(&ctx, linalg::MakeVec(values.data(), values.size()));
+      SafeColl(rc);
+      for (std::size_t i = 0; i < values.size(); ++i) {
+        double expected = 0;
+        for (std::int32_t r = 0; r < n_workers; ++r) {
+          if (i >= static_cast<std::size_t>(r) && (i - r) % stride == 0) {
+            expected += r + 1;
+          }
+        }
+        ASSERT_EQ(values[i], expected);
+      }
+    }
+    // Integers, some of the workers don't contribute any element.
+    std::vector<std::int32_t> values(256, 0);
+    if (rank == 0) {
+      values[3] = -7;
+      values[200] = 5;
+    }
+    auto rc = SparseAllreduce(&ctx, linalg::MakeVec(values.data(), values.size()));
+    SafeColl(rc);
+    auto n_zeros = std::count(values.cbegin(), values.cend(), 0);
+    ASSERT_EQ(n_zeros, static_cast<std::int64_t>(values.size() - 2));
+    ASSERT_EQ(values[3], -7);
+    ASSERT_EQ(values[200], 5);
+  });
+}
+
+TEST(AllreduceGlobal, Stats) {
+  auto n_workers = 3;
+  TestDistributedGlobal(n_workers, [&]() {
+    Context ctx;
+    std::vector<double> values(64, 1.0);
+    for (std::int32_t i = 0; i < 2; ++i) {
+      auto rc = Allreduce(&ctx, linalg::MakeVec(values.data(), values.size()), Op::kSum);
+      SafeColl(rc);
+    }
+    auto stats = GlobalCommGroup()->Stats();
+    auto jstats = stats->ToJson();
+    auto const& obj = get<Object const>(jstats);
+    ASSERT_EQ(obj.size(), 1ul);
+    auto const& [key, value] = *obj.cbegin();
+    ASSERT_EQ(key.find("Allreduce@test_allreduce.cc:"), 0);
+    ASSERT_EQ(get<Integer const>(value["n_calls"]), 2);
+    ASSERT_EQ(get<Integer const>(value["n_bytes"]),
+              static_cast<std::int64_t>(values.size() * sizeof(double) * 2));
+    ASSERT_GT(get<Integer const>(value["n_sent"]), 0);
+    ASSERT_GT(get<Integer const>(value["n_recv"]), 0);
+    ASSERT_FALSE(get<String const>(value["algo"]).empty());
+
+    stats->Clear();
+    jstats = stats->ToJson();
+    ASSERT_TRUE(get<Object const>(jstats).empty());
+  });
+}
 }  // namespace xgboost::collective
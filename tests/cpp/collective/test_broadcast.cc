@@ -5,11 +5,12 @@
 #include <xgboost/collective/socket.h>
 
 #include <cstdint>  // for int32_t
+#include <numeric>  // for iota
 #include <string>   // for string
 #include <thread>   // for thread
 #include <vector>   // for vector
 
-#include "../../../src/collective/broadcast.h"  // for Broadcast
+#include "../../../src/collective/broadcast.h"  // for Broadcast, ChainBroadcast
 #include "test_worker.h"                        // for WorkerForTest, TestDistributed
 
 namespace xgboost::collective {
@@ -34,6 +35,22 @@ class Worker : public WorkerForTest {
       ASSERT_EQ(data[0], r);
     }
   }
+
+  void Chain() {
+    for (std::int32_t r = 0; r < comm_.World(); ++r) {
+      // The size is not a multiple of the segment size.
+      std::vector<std::int32_t> data(1031, comm_.Rank());
+      if (comm_.Rank() == r) {
+        std::iota(data.begin(), data.end(), r);
+      }
+      auto rc = cpu_impl::ChainBroadcast(this->comm_, common::EraseType(common::Span{data}), r,
+                                         64);
+      SafeColl(rc);
+      for (std::size_t i = 0; i < data.size(); ++i) {
+        ASSERT_EQ(data[i], static_cast<std::int32_t>(i) + r);
+      }
+    }
+  }
 };
 
 class BroadcastTest : public SocketTest {};
@@ -47,4 +64,13 @@ TEST_F(BroadcastTest, Basic) {
     worker.Run();
   });
 }
+
+TEST_F(BroadcastTest, Chain) {
+  std::int32_t n_workers = std::min(3u, std::thread::hardware_concurrency());
+  TestDistributed(n_workers, [=](std::string host, std::int32_t port, std::chrono::seconds timeout,
+                                 std::int32_t r) {
+    Worker worker{host, port, timeout, n_workers, r};
+    worker.Chain();
+  });
+}
 }  // namespace xgboost::collective
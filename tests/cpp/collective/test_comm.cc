@@ -3,9 +3,13 @@
  */
 #include <gtest/gtest.h>
 
+#include <numeric>  // for iota
+#include <vector>   // for vector
+
+#include "../../../src/collective/coll.h"  // for Coll
 #include "../../../src/collective/comm.h"
-#include "../../../src/common/type.h"  // for EraseType
-#include "test_worker.h"               // for TrackerTest
+#include "../../../src/common/type.h"      // for EraseType
+#include "test_worker.h"                   // for TrackerTest
 
 namespace xgboost::collective {
 namespace {
@@ -49,4 +53,71 @@ TEST_F(CommTest, Channel) {
 
   SafeColl(fut.get());
 }
+
+TEST_F(CommTest, MultiStream) {
+  auto n_workers = 4;
+  std::int32_t n_streams = 3;
+  RabitTracker tracker{MakeTrackerConfig(host, n_workers, timeout)};
+  auto fut = tracker.Run();
+
+  std::vector<std::thread> workers;
+  std::int32_t port = tracker.Port();
+
+  for (std::int32_t i = 0; i < n_workers; ++i) {
+    workers.emplace_back([=] {
+      WorkerForTest worker{host, port, timeout, n_workers, i, n_streams};
+      auto const& comm = worker.Comm();
+      for (std::int32_t r = 0; r < n_workers; ++r) {
+        if (r != i) {
+          auto p_chan = std::dynamic_pointer_cast<MultiStreamChannel>(comm.Chan(r));
+          ASSERT_TRUE(p_chan);
+          ASSERT_EQ(p_chan->Streams().size(), static_cast<std::size_t>(n_streams));
+        }
+      }
+
+      // Split into streams with a remainder, followed by a message that is not split.
+      std::size_t n = MultiStreamChannel::kMinStripeBytes * n_streams / sizeof(std::int32_t) + 5;
+      std::vector<std::int32_t> large(n);
+      std::int32_t small{-1};
+      if (i % 2 == 0) {
+        std::iota(large.begin(), large.end(), i);
+        small = i;
+        auto p_chan = comm.Chan(i + 1);
+        auto rc = Success() << [&] {
+          return p_chan->SendAll(EraseType(common::Span<std::int32_t const>{large}));
+        } << [&] { return p_chan->Block(); } << [&] {
+          return p_chan->SendAll(EraseType(common::Span<std::int32_t const>{&small, 1}));
+        } << [&] { return p_chan->Block(); };
+        SafeColl(rc);
+      } else {
+        auto p_chan = comm.Chan(i - 1);
+        auto rc = Success() << [&] {
+          return p_chan->RecvAll(EraseType(common::Span<std::int32_t>{large}));
+        } << [&] { return p_chan->Block(); } << [&] {
+          return p_chan->RecvAll(EraseType(common::Span<std::int32_t>{&small, 1}));
+        } << [&] { return p_chan->Block(); };
+        SafeColl(rc);
+        for (std::size_t k = 0; k < n; ++k) {
+          ASSERT_EQ(large[k], static_cast<std::int32_t>(k) + i - 1);
+        }
+        ASSERT_EQ(small, i - 1);
+      }
+
+      // Run a collective through the striped channels.
+      std::vector<std::int32_t> data(n, 1);
+      auto rc = Coll{}.Allreduce(comm, EraseType(common::Span{data.data(), data.size()}),
+                                 ArrayInterfaceHandler::kI4, Op::kSum);
+      SafeColl(rc);
+      for (auto v : data) {
+        ASSERT_EQ(v, n_workers);
+      }
+    });
+  }
+
+  for (auto &w : workers) {
+    w.join();
+  }
+
+  SafeColl(fut.get());
+}
 }  // namespace xgboost::collective
@@ -1,9 +1,10 @@
 /**
  * Copyright 2023-2024, XGBoost Contributors
  */
-#include <gtest/gtest.h>                // for ASSERT_TRUE, ASSERT_EQ
-#include <xgboost/collective/socket.h>  // for TCPSocket, Connect, SocketFinalize, SocketStartup
-#include <xgboost/string_view.h>        // for StringView
+#include <gtest/gtest.h>                    // for ASSERT_TRUE, ASSERT_EQ
+#include <xgboost/collective/poll_utils.h>  // for EPollHelper
+#include <xgboost/collective/socket.h>      // for TCPSocket, Connect, SocketFinalize, SocketStartup
+#include <xgboost/string_view.h>            // for StringView
 
 #include <chrono>        // for seconds
 #include <cstdint>       // for int8_t
@@ -101,4 +102,36 @@ TEST_F(LoopTest, Block) {
   SafeColl(rc);
   ASSERT_GE(t.ElapsedSeconds(), 1);
 }
+
+#if defined(__linux__)
+TEST_F(LoopTest, EPoll) {
+  TCPSocket& send = pair_.first;
+  TCPSocket& recv = pair_.second;
+  std::chrono::seconds timeout{1};
+
+  rabit::utils::EPollHelper poll;
+  poll.WatchWrite(send);
+  poll.WatchRead(recv);
+  SafeColl(poll.Poll(timeout));
+  ASSERT_TRUE(poll.CheckWrite(send));
+  ASSERT_FALSE(poll.CheckRead(recv));
+
+  // Nothing to read.
+  poll.Clear();
+  poll.WatchRead(recv);
+  auto rc = poll.Poll(timeout);
+  ASSERT_EQ(rc.Code(), std::make_error_code(std::errc::timed_out)) << rc.Report();
+
+  std::int8_t v{1};
+  ASSERT_EQ(send.Send(&v, 1), 1);
+  for (std::int32_t i = 0; i < 2; ++i) {
+    // The registration is reused in the second round.
+    poll.Clear();
+    poll.WatchRead(recv);
+    SafeColl(poll.Poll(timeout));
+    ASSERT_TRUE(poll.CheckRead(recv));
+    ASSERT_FALSE(poll.CheckWrite(send));
+  }
+}
+#endif  // defined(__linux__)
 }  // namespace xgboost::collective
@@ -0,0 +1,53 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+#include <thrust/host_vector.h>  // for host_vector
+
+#include <cstdint>  // for int32_t, int64_t
+#include <memory>   // for unique_ptr, make_unique
+#include <vector>   // for vector
+
+#include "../../../src/collective/peer_coll.cuh"   // for PeerGroup
+#include "../../../src/common/cuda_rt_utils.h"     // for AllVisibleGPUs, SetDevice
+#include "../../../src/common/device_helpers.cuh"  // for ToSpan, device_vector
+
+namespace xgboost::collective {
+TEST(PeerGroup, AllreduceSum) {
+  auto n_devices = curt::AllVisibleGPUs();
+  std::vector<DeviceOrd> devices;
+  for (std::int32_t i = 0; i < n_devices; ++i) {
+    devices.push_back(DeviceOrd::CUDA(i));
+  }
+  PeerGroup group{devices};
+  ASSERT_EQ(group.Size(), n_devices);
+
+  std::size_t n = 1 << 12;
+  std::vector<std::unique_ptr<dh::device_vector<std::int64_t>>> bufs;
+  std::vector<common::Span<std::int64_t>> data;
+  for (std::int32_t i = 0; i < n_devices; ++i) {
+    curt::SetDevice(i);
+    bufs.emplace_back(std::make_unique<dh::device_vector<std::int64_t>>(n, i + 1));
+    data.push_back(dh::ToSpan(*bufs.back()));
+  }
+  auto rc = group.AllreduceSum(data);
+  ASSERT_TRUE(rc.OK()) << rc.Report();
+
+  std::int64_t expected = n_devices * (n_devices + 1) / 2;
+  for (std::int32_t i = 0; i < n_devices; ++i) {
+    curt::SetDevice(i);
+    thrust::host_vector<std::int64_t> h_buf(*bufs[i]);
+    for (auto v : h_buf) {
+      ASSERT_EQ(v, expected);
+    }
+  }
+  curt::SetDevice(0);
+
+  // Mismatched size.
+  data.back() = data.back().subspan(1);
+  rc = group.AllreduceSum(data);
+  if (n_devices > 1) {
+    ASSERT_FALSE(rc.OK());
+  }
+}
+}  // namespace xgboost::collective
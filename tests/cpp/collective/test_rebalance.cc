@@ -0,0 +1,93 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+#include <xgboost/json.h>     // for Json, get
+#include <xgboost/learner.h>  // for Learner
+
+#include <cstdint>  // for int32_t, int64_t
+#include <memory>   // for unique_ptr
+#include <vector>   // for vector
+
+#include "../../../src/collective/comm_group.h"  // for GlobalCommGroup
+#include "../../../src/collective/rebalance.h"
+#include "../helpers.h"                         // for RandomDataGenerator
+#include "test_worker.h"                        // for TestDistributedGlobal
+
+namespace xgboost::collective {
+TEST(Rebalance, PlanRowTransfers) {
+  // Balanced.
+  std::vector<WorkerLoad> loads{{100, 1.0, 1}, {100, 1.05, 1}, {100, 0.95, 1}};
+  ASSERT_TRUE(PlanRowTransfers(common::Span{loads}, 0.1).empty());
+  // Not measured.
+  loads = {{100, 0.0, 0}, {100, 2.0, 1}};
+  ASSERT_TRUE(PlanRowTransfers(common::Span{loads}, 0.1).empty());
+
+  // The second worker is twice as slow as the others.
+  loads = {{100, 2.0, 2}, {100, 4.0, 2}, {100, 2.0, 2}};
+  auto transfers = PlanRowTransfers(common::Span{loads}, 0.1);
+  ASSERT_EQ(transfers.size(), 2);
+  std::vector<std::int64_t> n_rows{100, 100, 100};
+  for (auto const& t : transfers) {
+    ASSERT_EQ(t.src, 1);
+    ASSERT_GT(t.n_rows, 0);
+    n_rows[t.src] -= t.n_rows;
+    n_rows[t.dst] += t.n_rows;
+  }
+  // 300 rows in proportion to 1 : 0.5 : 1.
+  ASSERT_EQ(n_rows[0] + n_rows[1] + n_rows[2], 300);
+  ASSERT_EQ(n_rows[1], 60);
+  ASSERT_EQ(n_rows[0], 120);
+  ASSERT_EQ(n_rows[2], 120);
+
+  // Multiple donors.
+  loads = {{100, 3.0, 1}, {100, 3.0, 1}, {100, 1.0, 1}, {100, 1.0, 1}};
+  transfers = PlanRowTransfers(common::Span{loads}, 0.1);
+  std::int64_t moved{0};
+  for (auto const& t : transfers) {
+    ASSERT_LT(t.src, 2);
+    ASSERT_GE(t.dst, 2);
+    moved += t.n_rows;
+  }
+  ASSERT_EQ(moved, 100);
+}
+
+TEST(Rebalance, Distributed) {
+  std::int32_t n_workers = 3;
+  TestDistributedGlobal(n_workers, [&] {
+    Context ctx;
+    auto rank = GetRank();
+    auto p_fmat = RandomDataGenerator{64, 4, 0.0}.Seed(rank).GenerateDMatrix(true);
+    std::unique_ptr<Learner> learner{Learner::Create({p_fmat})};
+    learner->SetParams(Args{{"tree_method", "hist"}});
+    auto* stats = GlobalCommGroup()->Stats();
+    stats->Clear();
+    for (std::int32_t i = 0; i < 2; ++i) {
+      learner->UpdateOneIter(i, p_fmat);
+    }
+    auto load = stats->Load();
+    ASSERT_EQ(load.n_rows, 64);
+    ASSERT_EQ(load.n_updates, 2);
+    auto jstats = stats->ToJson();
+    ASSERT_EQ(get<Integer const>(jstats["worker_load"]["n_rows"]), 64);
+
+    // Replace the measurement with a slow worker.
+    stats->Clear();
+    stats->RecordLoad(64, rank == 0 ? 3.0 : 1.0);
+    std::vector<WorkerLoad> loads;
+    std::vector<RowTransfer> transfers;
+    auto rc = PlanRebalance(&ctx, *GlobalCommGroup(), 0.1, &loads, &transfers);
+    SafeColl(rc);
+    ASSERT_EQ(loads.size(), n_workers);
+    for (std::int32_t r = 0; r < n_workers; ++r) {
+      ASSERT_EQ(loads[r].n_rows, 64);
+      ASSERT_EQ(loads[r].build, r == 0 ? 3.0 : 1.0);
+    }
+    ASSERT_FALSE(transfers.empty());
+    for (auto const& t : transfers) {
+      ASSERT_EQ(t.src, 0);
+    }
+    stats->Clear();
+  });
+}
+}  // namespace xgboost::collective
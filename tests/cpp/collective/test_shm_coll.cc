@@ -0,0 +1,116 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>  // for min
+#include <chrono>     // for seconds
+#include <cstddef>    // for size_t
+#include <cstdint>    // for int32_t, int64_t
+#include <numeric>    // for iota, accumulate
+#include <string>     // for string
+#include <thread>     // for thread
+#include <vector>     // for vector
+
+#include "../../../src/collective/shm_coll.h"  // for ShmColl
+#include "../../../src/common/type.h"          // for EraseType
+#include "test_worker.h"                       // for WorkerForTest, TestDistributed
+
+namespace xgboost::collective {
+namespace {
+class ShmCollTest : public SocketTest {};
+
+class ShmWorker : public WorkerForTest {
+  ShmColl coll_;
+
+ public:
+  using WorkerForTest::WorkerForTest;
+
+  void Allreduce() {
+    auto world = comm_.World();
+    // Larger than a slot.
+    auto n = ShmColl::kSlotBytes / sizeof(std::int64_t) * 2 + 3;
+    std::vector<std::int64_t> data(n);
+    std::iota(data.begin(), data.end(), comm_.Rank());
+    auto rc = coll_.Allreduce(comm_, common::EraseType(common::Span{data.data(), data.size()}),
+                              ArrayInterfaceHandler::kI8, Op::kSum);
+    SafeColl(rc);
+    for (std::size_t i = 0; i < n; ++i) {
+      auto expected = static_cast<std::int64_t>(i) * world + world * (world - 1) / 2;
+      ASSERT_EQ(data[i], expected);
+    }
+
+    std::vector<double> values(17, comm_.Rank());
+    rc = coll_.Allreduce(comm_, common::EraseType(common::Span{values.data(), values.size()}),
+                         ArrayInterfaceHandler::kF8, Op::kMax);
+    SafeColl(rc);
+    for (auto v : values) {
+      ASSERT_EQ(v, world - 1);
+    }
+  }
+
+  void Broadcast() {
+    std::vector<std::int8_t> data(ShmColl::kSlotBytes + 5, 0);
+    std::int32_t root = comm_.World() - 1;
+    if (comm_.Rank() == root) {
+      std::iota(data.begin(), data.end(), 0);
+    }
+    auto rc = coll_.Broadcast(comm_, common::Span{data.data(), data.size()}, root);
+    SafeColl(rc);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+      ASSERT_EQ(data[i], static_cast<std::int8_t>(i));
+    }
+  }
+
+  void Allgather() {
+    std::size_t n = ShmColl::kSlotBytes / sizeof(std::int32_t) + 7;
+    std::vector<std::int32_t> data(n * comm_.World(), -1);
+    auto s_data = common::Span{data.data(), data.size()};
+    auto self = s_data.subspan(n * comm_.Rank(), n);
+    std::iota(self.begin(), self.end(), comm_.Rank());
+    auto rc = coll_.Allgather(comm_, common::EraseType(s_data));
+    SafeColl(rc);
+    for (std::int32_t r = 0; r < comm_.World(); ++r) {
+      auto seg = s_data.subspan(n * r, n);
+      for (std::size_t i = 0; i < seg.size(); ++i) {
+        ASSERT_EQ(seg[i], static_cast<std::int32_t>(r + i));
+      }
+    }
+  }
+
+  void AllgatherV() {
+    // Worker r sends (r * slot + r) bytes of value r, the first worker sends nothing.
+    std::vector<std::int64_t> sizes(comm_.World());
+    for (std::int32_t r = 0; r < comm_.World(); ++r) {
+      sizes[r] = static_cast<std::int64_t>(ShmColl::kSlotBytes * r + r);
+    }
+    std::vector<std::int8_t> data(sizes[comm_.Rank()], comm_.Rank());
+    std::vector<std::int64_t> segments(comm_.World() + 1);
+    std::vector<std::int8_t> recv(std::accumulate(sizes.cbegin(), sizes.cend(), std::int64_t{0}));
+    auto rc = coll_.AllgatherV(comm_, common::Span{data.data(), data.size()},
+                               common::Span{sizes.data(), sizes.size()},
+                               common::Span{segments.data(), segments.size()},
+                               common::Span{recv.data(), recv.size()}, AllgatherVAlgo::kBcast);
+    SafeColl(rc);
+    for (std::int32_t r = 0; r < comm_.World(); ++r) {
+      ASSERT_EQ(segments[r + 1] - segments[r], sizes[r]);
+      for (auto i = segments[r]; i < segments[r + 1]; ++i) {
+        ASSERT_EQ(recv[i], r);
+      }
+    }
+  }
+};
+}  // namespace
+
+TEST_F(ShmCollTest, Basic) {
+  std::int32_t n_workers = std::min(4u, std::thread::hardware_concurrency());
+  TestDistributed(n_workers, [=](std::string host, std::int32_t port, std::chrono::seconds timeout,
+                                 std::int32_t r) {
+    ShmWorker worker{host, port, timeout, n_workers, r};
+    worker.Allreduce();
+    worker.Broadcast();
+    worker.Allgather();
+    worker.AllgatherV();
+  });
+}
+}  // namespace xgboost::collective
@@ -77,6 +77,53 @@ TEST_F(TrackerTest, Print) {
   SafeColl(fut.get());
 }
 
+TEST_F(TrackerTest, Elastic) {
+  std::int32_t n_workers = 4;
+  // Longer than the elastic timeout, workers are waiting for the group to be formed.
+  std::chrono::seconds timeout{10};
+  auto config = MakeTrackerConfig(host, n_workers, timeout);
+  config["min_workers"] = Integer{n_workers - 1};
+  config["elastic_timeout"] = Integer{1};
+  RabitTracker tracker{config};
+  auto fut = tracker.Run();
+
+  std::vector<std::thread> workers;
+  auto rc = tracker.WaitUntilReady();
+  SafeColl(rc);
+
+  std::int32_t port = tracker.Port();
+
+  // One of the workers reports an error. All workers are on the same host, the tracker
+  // doesn't signal the others.
+  for (std::int32_t i = 0; i < n_workers; ++i) {
+    workers.emplace_back([=] {
+      WorkerForTest worker{host, port, timeout, n_workers, i};
+      if (worker.Comm().Rank() == 0) {
+        SafeColl(worker.Comm().SignalError(Fail("Test error.")));
+      }
+    });
+  }
+  for (auto &w : workers) {
+    w.join();
+  }
+
+  // The lost worker is not replaced, the tracker forms a smaller group.
+  workers.clear();
+  for (std::int32_t i = 0; i < n_workers - 1; ++i) {
+    workers.emplace_back([=] {
+      WorkerForTest worker{host, port, timeout, n_workers - 1, i};
+      ASSERT_EQ(worker.Comm().World(), n_workers - 1);
+      auto rc = worker.Comm().LogTracker("rank:" + std::to_string(worker.Comm().Rank()));
+      SafeColl(rc);
+    });
+  }
+  for (auto &w : workers) {
+    w.join();
+  }
+
+  SafeColl(fut.get());
+}
+
 TEST_F(TrackerTest, GetHostAddress) { ASSERT_TRUE(host.find("127.") == std::string::npos); }
 
 /**
@@ -37,12 +37,13 @@ class WorkerForTest {
 
  public:
   WorkerForTest(std::string host, std::int32_t port, std::chrono::seconds timeout,
-                std::int32_t world, std::int32_t rank)
+                std::int32_t world, std::int32_t rank, std::int32_t n_streams = 1)
       : tracker_host_{std::move(host)},
         tracker_port_{port},
         world_size_{world},
         task_id_{"t:" + std::to_string(rank)},
-        comm_{tracker_host_, tracker_port_, timeout, retry_, task_id_, DefaultNcclName()} {
+        comm_{tracker_host_, tracker_port_, timeout, retry_, task_id_, DefaultNcclName(),
+              n_streams} {
     CHECK_EQ(world_size_, comm_.World());
   }
   virtual ~WorkerForTest() noexcept(false) { SafeColl(comm_.Shutdown()); }
@@ -6,6 +6,12 @@
 #include <xgboost/span.h>
 
 #include <algorithm>  // is_sorted
+#include <cstddef>    // size_t
+#include <cstdint>    // int32_t, uint32_t
+#include <limits>     // numeric_limits
+#include <random>     // mt19937, uniform_int_distribution, normal_distribution
+#include <string>     // to_string
+#include <vector>     // vector
 
 #include "../../../src/common/algorithm.h"
 
@@ -31,5 +37,86 @@ TEST(Algorithm, Sort) {
   StableSort(&ctx, inputs.begin(), inputs.end(), std::less<>{});
   ASSERT_TRUE(std::is_sorted(inputs.cbegin(), inputs.cend()));
 }
+
+namespace {
+// Ties, signed zeros and infinity.
+std::vector<float> MakeSortInput(std::size_t n) {
+  std::mt19937 rng{static_cast<std::uint32_t>(n)};
+  std::normal_distribution<float> dist{0.0f, 10.0f};
+  std::uniform_int_distribution<std::int32_t> tie{0, 3};
+  std::vector<float> values(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    switch (tie(rng)) {
+      case 0:
+        values[i] = static_cast<float>(tie(rng)) - 1.5f;
+        break;
+      case 1:
+        values[i] = i % 2 == 0 ? 0.0f : -0.0f;
+        break;
+      default:
+        values[i] = i % 97 == 0 ? -std::numeric_limits<float>::infinity() : dist(rng);
+    }
+  }
+  return values;
+}
+}  // anonymous namespace
+
+TEST(Algorithm, RadixArgSortDesc) {
+  for (std::int32_t n_threads : {1, 4}) {
+    Context ctx;
+    ctx.Init(Args{{"nthread", std::to_string(n_threads)}});
+    for (std::size_t n : {0ul, 7ul, 100000ul}) {
+      auto values = MakeSortInput(n);
+      auto ret = RadixArgSortDesc<std::size_t>(&ctx, Span<float const>{values});
+      auto sol =
+          ArgSort<std::size_t>(&ctx, values.cbegin(), values.cend(), std::greater<>{});
+      ASSERT_EQ(ret, sol);
+      ret = RadixArgSort<std::size_t>(&ctx, Span<float const>{values});
+      sol = ArgSort<std::size_t>(&ctx, values.cbegin(), values.cend(), std::less<>{});
+      ASSERT_EQ(ret, sol);
+    }
+  }
+}
+
+TEST(Algorithm, RadixSort) {
+  for (std::int32_t n_threads : {1, 4}) {
+    Context ctx;
+    ctx.Init(Args{{"nthread", std::to_string(n_threads)}});
+    for (std::size_t n : {0ul, 7ul, 100000ul}) {
+      auto values = MakeSortInput(n);
+      auto sol = values;
+      std::sort(sol.begin(), sol.end());
+      RadixSort(&ctx, Span{values});
+      ASSERT_TRUE(std::is_sorted(values.cbegin(), values.cend()));
+      // Same values, -0 and 0 are only compared by the value.
+      for (std::size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(values[i], sol[i]);
+      }
+    }
+  }
+}
+
+TEST(Algorithm, SegmentedArgSort) {
+  for (std::int32_t n_threads : {1, 4}) {
+    Context ctx;
+    ctx.Init(Args{{"nthread", std::to_string(n_threads)}});
+    // Empty segments, small segments and a segment that is sorted in parallel.
+    std::vector<std::size_t> segments{0, 0, 3, 40, 40, 40000, 40001, 40100};
+    auto values = MakeSortInput(segments.back());
+    for (bool descending : {false, true}) {
+      std::vector<std::uint32_t> sorted_idx(values.size());
+      SegmentedArgSort(&ctx, Span<float const>{values}, Span<std::size_t const>{segments},
+                       descending, Span{sorted_idx});
+      for (std::size_t s = 0; s + 1 < segments.size(); ++s) {
+        auto beg = values.cbegin() + segments[s], end = values.cbegin() + segments[s + 1];
+        auto sol = descending ? ArgSort<std::uint32_t>(&ctx, beg, end, std::greater<>{})
+                              : ArgSort<std::uint32_t>(&ctx, beg, end, std::less<>{});
+        auto ret = std::vector<std::uint32_t>(sorted_idx.cbegin() + segments[s],
+                                              sorted_idx.cbegin() + segments[s + 1]);
+        ASSERT_EQ(ret, sol) << s;
+      }
+    }
+  }
+}
 }  // namespace common
 }  // namespace xgboost
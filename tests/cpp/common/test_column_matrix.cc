@@ -51,8 +51,9 @@ TEST(ColumnMatrix, Basic) {
   }
 }
 
-template <typename BinIdxType>
-void CheckSparseColumn(SparseColumnIter<BinIdxType>* p_col, const GHistIndexMatrix& gmat) {
+template <typename BinIdxType, typename RowIdxType>
+void CheckSparseColumn(SparseColumnIter<BinIdxType, RowIdxType>* p_col,
+                       const GHistIndexMatrix& gmat) {
   auto& col = *p_col;
 
   size_t n_samples = gmat.row_ptr.size() - 1;
@@ -82,10 +83,11 @@ TEST(ColumnMatrix, SparseColumn) {
     for (auto const& page : dmat->GetBatches<SparsePage>()) {
       column_matrix.InitFromSparse(page, gmat, 1.0, ctx.Threads());
     }
+    // Use 32-bit row indices for small matrices.
+    ASSERT_EQ(column_matrix.GetRowIdxTypeSize(), kUint32RowIdxTypeSize);
     common::DispatchBinType(column_matrix.GetTypeSize(), [&](auto dtype) {
       using T = decltype(dtype);
-      auto col = column_matrix.SparseColumn<T>(0, 0);
-      CheckSparseColumn(&col, gmat);
+      column_matrix.VisitSparseColumn<T>(0, 0, [&](auto& col) { CheckSparseColumn(&col, gmat); });
     });
   }
 }
@@ -133,7 +135,7 @@ TEST(ColumnMatrix, GrowMissing) {
       &iter, iter.Proxy(), nullptr, Reset, Next, std::numeric_limits<float>::quiet_NaN(), n_threads,
       n_bins, std::numeric_limits<std::int64_t>::max());
   for (auto const& page : m->GetBatches<GHistIndexMatrix>(&ctx, batch)) {
-    auto const& column_matrix = page.Transpose();
+    auto const& column_matrix = page.Transpose(&ctx);
     auto const& missing = column_matrix.Missing();
     auto n = NumpyArrayIterForTest::Rows() * NumpyArrayIterForTest::Cols();
     auto expected = std::remove_reference_t<decltype(missing)>::BitFieldT::ComputeStorageSize(n);
@@ -0,0 +1,113 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+#include <xgboost/learner.h>  // for Learner
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int32_t
+#include <memory>   // for unique_ptr
+#include <vector>   // for vector
+
+#include "../../../src/common/cpu_dispatch.h"
+#include "../../../src/common/hist_util.h"     // for BuildHist
+#include "../../../src/data/gradient_index.h"  // for GHistIndexMatrix
+#include "../helpers.h"
+
+namespace xgboost::common {
+namespace {
+// All instruction sets supported by the CPU.
+std::vector<CpuIsa> SupportedIsa() {
+  std::vector<CpuIsa> isa;
+  for (std::int32_t i = 0; i <= static_cast<std::int32_t>(DetectCpuIsa()); ++i) {
+    isa.push_back(static_cast<CpuIsa>(i));
+  }
+  return isa;
+}
+
+class CpuIsaRestore {
+  CpuIsa isa_{GetCpuIsa()};
+
+ public:
+  ~CpuIsaRestore() { SetCpuIsa(isa_); }
+};
+}  // anonymous namespace
+
+TEST(CpuDispatch, Select) {
+  CpuIsaRestore restore;
+  ASSERT_EQ(GetCpuIsa(), DetectCpuIsa());
+  for (auto isa : SupportedIsa()) {
+    SetCpuIsa(isa);
+    ASSERT_EQ(GetCpuIsa(), isa);
+    ASSERT_EQ(DispatchCpuIsa([] { return 3; }), 3);
+  }
+  ASSERT_EQ(CpuIsaName(CpuIsa::kBaseline), StringView{"baseline"});
+  ASSERT_EQ(CpuIsaName(CpuIsa::kAvx2), StringView{"avx2"});
+  ASSERT_EQ(CpuIsaName(CpuIsa::kAvx512), StringView{"avx512"});
+  if (DetectCpuIsa() != CpuIsa::kAvx512) {
+    ASSERT_THROW(SetCpuIsa(CpuIsa::kAvx512), dmlc::Error);
+  }
+}
+
+TEST(CpuDispatch, BuildHist) {
+  CpuIsaRestore restore;
+  bst_idx_t constexpr kRows = 1024;
+  Context ctx;
+  for (float sparsity : {0.0f, 0.4f}) {
+    auto p_fmat = RandomDataGenerator{kRows, 17, sparsity}.Seed(3).GenerateDMatrix();
+    GHistIndexMatrix gmat(&ctx, p_fmat.get(), 64, 0.5, false);
+    auto gpair = GenerateRandomGradients(kRows);
+    std::vector<bst_idx_t> row_indices;
+    for (bst_idx_t i = 0; i < kRows; i += 3) {
+      row_indices.push_back(i);
+    }
+    auto n_bins = gmat.cut.Ptrs().back();
+    std::vector<GradientPairPrecise> expected;
+    for (auto isa : SupportedIsa()) {
+      SetCpuIsa(isa);
+      std::vector<GradientPairPrecise> hist(n_bins);
+      if (gmat.IsDense()) {
+        BuildHist<false>(gpair.ConstHostSpan(), row_indices, gmat,
+                         GHistRow{hist.data(), hist.size()});
+      } else {
+        BuildHist<true>(gpair.ConstHostSpan(), row_indices, gmat,
+                        GHistRow{hist.data(), hist.size()});
+      }
+      if (isa == CpuIsa::kBaseline) {
+        expected = hist;
+        continue;
+      }
+      // Exactly the same as the baseline.
+      for (std::size_t i = 0; i < n_bins; ++i) {
+        ASSERT_EQ(hist[i].GetGrad(), expected[i].GetGrad()) << CpuIsaName(isa);
+        ASSERT_EQ(hist[i].GetHess(), expected[i].GetHess()) << CpuIsaName(isa);
+      }
+    }
+  }
+}
+
+TEST(CpuDispatch, Predict) {
+  CpuIsaRestore restore;
+  auto generate = [](std::int32_t seed, bool with_label) {
+    return RandomDataGenerator{512, 9, 0.2}.Seed(seed).GenerateDMatrix(with_label);
+  };
+  auto p_fmat = generate(1, true);
+  std::unique_ptr<Learner> learner{Learner::Create({p_fmat})};
+  learner->SetParams(Args{{"tree_method", "hist"}, {"max_depth", "5"}});
+  for (std::int32_t i = 0; i < 4; ++i) {
+    learner->UpdateOneIter(i, p_fmat);
+  }
+  std::vector<float> expected;
+  for (auto isa : SupportedIsa()) {
+    SetCpuIsa(isa);
+    // A new DMatrix for each run to skip the prediction cache.
+    HostDeviceVector<float> predt;
+    learner->Predict(generate(2, false), true, &predt, 0, 0);
+    if (isa == CpuIsa::kBaseline) {
+      expected = predt.HostVector();
+      continue;
+    }
+    ASSERT_EQ(predt.HostVector(), expected) << CpuIsaName(isa);
+  }
+}
+}  // namespace xgboost::common
@@ -26,6 +26,34 @@ TEST(DeviceUVector, Basic) {
   std::swap(verbosity, xgboost::GlobalConfigThreadLocalStore::Get()->verbosity);
 }
 
+#if !defined(XGBOOST_USE_RMM)
+TEST(DevicePool, Basic) {
+  if (!detail::UseDevicePool()) {
+    GTEST_SKIP_("Memory pool is not supported.");
+  }
+  auto device = CurrentDevice();
+  cudaMemPool_t pool;
+  dh::safe_cuda(cudaDeviceGetDefaultMemPool(&pool, device));
+  auto used = [&] {
+    std::uint64_t value{0};
+    dh::safe_cuda(cudaMemPoolGetAttribute(pool, cudaMemPoolAttrUsedMemCurrent, &value));
+    return value;
+  };
+  auto n_bytes = static_cast<std::uint64_t>(1) << 20;
+  auto before = used();
+  {
+    device_vector<std::int8_t> vec(n_bytes);
+    caching_device_vector<std::int8_t> cvec(n_bytes);
+    ASSERT_GE(used(), before + n_bytes * 2);
+  }
+  DefaultStream().Sync();
+  ASSERT_EQ(used(), before);
+
+  // Freed memory is kept by the pool and is counted as available.
+  ASSERT_GE(AvailableMemory(device), detail::DevicePoolIdleBytes(device));
+}
+#endif  // !defined(XGBOOST_USE_RMM)
+
 #if defined(__linux__)
 namespace {
 class TestVirtualMem : public ::testing::TestWithParam<CUmemLocationType> {
@@ -0,0 +1,130 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+#include <xgboost/learner.h>  // for Learner
+
+#include <algorithm>  // for sort
+#include <cstddef>    // for size_t
+#include <limits>     // for numeric_limits
+#include <memory>     // for shared_ptr, unique_ptr
+#include <random>     // for mt19937, uniform_int_distribution
+#include <vector>     // for vector
+
+#include "../../../src/common/feature_bundle.h"
+#include "../../../src/common/hist_util.h"
+#include "../../../src/data/gradient_index.h"
+#include "../helpers.h"
+
+namespace xgboost::common {
+namespace {
+/**
+ * @brief One-hot encoded groups, each row has exactly one feature in each group.
+ */
+std::shared_ptr<DMatrix> MakeOneHot(bst_idx_t n_samples, bst_feature_t n_groups,
+                                    bst_feature_t group_size) {
+  auto n_features = n_groups * group_size;
+  std::vector<float> x(n_samples * n_features, std::numeric_limits<float>::quiet_NaN());
+  std::mt19937 rng{3};
+  std::uniform_int_distribution<bst_feature_t> dist{0, group_size - 1};
+  for (bst_idx_t i = 0; i < n_samples; ++i) {
+    for (bst_feature_t g = 0; g < n_groups; ++g) {
+      auto f = g * group_size + dist(rng);
+      // Alternate between two values for the first group to have more than one bin.
+      x[i * n_features + f] = (g == 0 && i % 2 == 0) ? 2.0f : 1.0f;
+    }
+  }
+  return GetDMatrixFromData(x, n_samples, n_features);
+}
+}  // anonymous namespace
+
+TEST(FeatureBundles, OneHot) {
+  bst_idx_t n_samples = 1024;
+  bst_feature_t n_groups = 4, group_size = 16;
+  Context ctx;
+  auto p_fmat = MakeOneHot(n_samples, n_groups, group_size);
+  GHistIndexMatrix gmat{&ctx, p_fmat.get(), 256, 0.5, false};
+  ASSERT_FALSE(gmat.IsDense());
+
+  auto const& bundles = gmat.Bundles(&ctx);
+  ASSERT_TRUE(bundles.IsBundled());
+  ASSERT_GE(bundles.NumBundles(), n_groups);
+  ASSERT_LT(bundles.NumBundles(), n_groups * group_size);
+  ASSERT_EQ(bundles.GetBinTypeSize(), kUint8BinsTypeSize);
+  ASSERT_EQ(bundles.Size(), n_samples);
+
+  // The bundles are exact, every entry is kept.
+  auto const* data = bundles.Data<std::uint8_t>();
+  auto const& bin_map = bundles.BinMap();
+  auto const& ptrs = bundles.Ptrs();
+  for (bst_idx_t i = 0; i < n_samples; ++i) {
+    std::vector<std::uint32_t> bins;
+    for (std::size_t b = 0; b < bundles.NumBundles(); ++b) {
+      auto local = data[i * bundles.NumBundles() + b];
+      if (local != 0) {
+        bins.push_back(bin_map[ptrs[b] + local]);
+      }
+    }
+    std::sort(bins.begin(), bins.end());
+    std::vector<std::uint32_t> expected;
+    for (auto k = gmat.row_ptr[i]; k < gmat.row_ptr[i + 1]; ++k) {
+      expected.push_back(gmat.index[k]);
+    }
+    std::sort(expected.begin(), expected.end());
+    ASSERT_EQ(bins, expected);
+  }
+
+  std::vector<GradientPair> gpair(n_samples);
+  for (std::size_t i = 0; i < n_samples; ++i) {
+    gpair[i] = GradientPair{static_cast<float>(i % 7) * 0.25f - 0.5f, 1.0f + (i % 3)};
+  }
+  std::vector<bst_idx_t> row_indices;
+  for (std::size_t i = 1; i < n_samples; i += 3) {
+    row_indices.push_back(i);
+  }
+  std::size_t n_bins = gmat.cut.TotalBins();
+  std::vector<GradientPairPrecise> expected(n_bins);
+  BuildHist<true>(gpair, row_indices, gmat, GHistRow{expected.data(), expected.size()});
+  std::vector<GradientPairPrecise> hist(n_bins);
+  BuildHistBundled(gpair, row_indices, bundles, GHistRow{hist.data(), hist.size()});
+  for (std::size_t i = 0; i < n_bins; ++i) {
+    ASSERT_EQ(hist[i].GetGrad(), expected[i].GetGrad());
+    ASSERT_EQ(hist[i].GetHess(), expected[i].GetHess());
+  }
+}
+
+TEST(FeatureBundles, Dense) {
+  Context ctx;
+  auto p_fmat = RandomDataGenerator{64, 4, 0.0}.GenerateDMatrix();
+  GHistIndexMatrix gmat{&ctx, p_fmat.get(), 16, 0.5, false};
+  ASSERT_TRUE(gmat.IsDense());
+  ASSERT_FALSE(gmat.Bundles(&ctx).IsBundled());
+}
+
+TEST(FeatureBundles, Train) {
+  bst_idx_t n_samples = 1024;
+  auto p_fmat = MakeOneHot(n_samples, 4, 16);
+  std::vector<float> labels(n_samples);
+  std::mt19937 rng{1};
+  std::uniform_real_distribution<float> dist{0.0f, 1.0f};
+  for (auto& v : labels) {
+    v = dist(rng);
+  }
+  p_fmat->Info().labels.Reshape(n_samples);
+  p_fmat->Info().labels.Data()->HostVector() = labels;
+
+  auto train = [&](bool bundling) {
+    std::unique_ptr<Learner> learner{Learner::Create({p_fmat})};
+    learner->SetParams(Args{{"tree_method", "hist"},
+                            {"enable_feature_bundling", bundling ? "true" : "false"}});
+    for (std::int32_t i = 0; i < 4; ++i) {
+      learner->UpdateOneIter(i, p_fmat);
+    }
+    HostDeviceVector<float> predt;
+    learner->Predict(p_fmat, false, &predt, 0, 0);
+    return std::vector<float>{predt.ConstHostVector()};
+  };
+  // The histograms are the same, so is the model.
+  ASSERT_EQ(train(true), train(false));
+}
+}  // namespace xgboost::common
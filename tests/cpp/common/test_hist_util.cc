@@ -2,9 +2,12 @@
  * Copyright 2019-2024, XGBoost Contributors
  */
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
 #include <vector>
 #include <string>
 
+#include "../../../src/common/column_matrix.h"
 #include "../../../src/common/hist_util.h"
 #include "../../../src/data/gradient_index.h"
 #include "../helpers.h"
@@ -121,6 +124,52 @@ TEST(ParallelGHistBuilder, Reset) { ParallelGHistBuilderReset(); }
 
 TEST(ParallelGHistBuilder, ReduceHist) { ParallelGHistBuilderReduceHist(); }
 
+TEST(ParallelGHistBuilder, ThreadLocalBuffer) {
+  constexpr size_t kBins = 10;
+  constexpr size_t kTasksPerNode = 8;
+  const size_t nthreads = AllThreadsForTest();
+
+  HistCollection collection;
+  collection.Init(kBins);
+  constexpr size_t kMaxNodes = 6;
+  for (size_t inode = 0; inode < kMaxNodes; inode++) {
+    collection.AddHistRow(inode);
+    collection.AllocateData(inode);
+  }
+  ParallelGHistBuilder hist_builder;
+  hist_builder.Init(kBins);
+
+  // Owner thread of each additional histogram.
+  std::map<GradientPairPrecise const *, size_t> owners;
+  for (size_t n_nodes : {2, 5, 3, 6}) {
+    std::vector<GHistRow> target_hist(n_nodes);
+    for (size_t i = 0; i < target_hist.size(); ++i) {
+      target_hist[i] = collection[i];
+    }
+    common::BlockedSpace2d space(
+        n_nodes, [&](size_t /*node*/) { return kTasksPerNode; }, 1);
+    hist_builder.Reset(nthreads, n_nodes, space, target_hist);
+    std::vector<std::vector<GradientPairPrecise const *>> used(nthreads);
+    common::ParallelFor2d(space, nthreads, [&](size_t inode, common::Range1d) {
+      const size_t tid = omp_get_thread_num();
+      GHistRow hist = hist_builder.GetInitializedHist(tid, inode);
+      if (hist.data() != target_hist[inode].data()) {
+        used[tid].push_back(hist.data());
+      }
+    });
+    for (size_t tid = 0; tid < nthreads; ++tid) {
+      for (auto ptr : used[tid]) {
+        auto it = owners.find(ptr);
+        if (it == owners.cend()) {
+          owners[ptr] = tid;
+        } else {
+          ASSERT_EQ(it->second, tid);
+        }
+      }
+    }
+  }
+}
+
 TEST(CutsBuilder, SearchGroupInd) {
   size_t constexpr kNumGroups = 4;
   size_t constexpr kRows = 17;
@@ -405,5 +454,122 @@ TEST(HistUtil, SketchCategoricalFeatures) {
     return SketchOnDMatrix(&ctx, p_fmat, num_bins);
   });
 }
+
+TEST(HistUtil, BuildHistDenseBlocked) {
+  // More rows than a chunk and the number of features is not a multiple of the block.
+  size_t constexpr kRows = 3000, kCols = 30;
+  int32_t constexpr kBins = 64;
+  Context ctx;
+  auto p_fmat = RandomDataGenerator(kRows, kCols, 0).Seed(3).GenerateDMatrix();
+  GHistIndexMatrix gmat(&ctx, p_fmat.get(), kBins, 0.5, false);
+  ASSERT_TRUE(gmat.IsDense());
+  ASSERT_EQ(gmat.index.GetBinTypeSize(), kUint8BinsTypeSize);
+
+  std::vector<GradientPair> gpair(kRows);
+  for (size_t i = 0; i < kRows; ++i) {
+    gpair[i] = GradientPair{static_cast<float>(i % 7) * 0.1f, static_cast<float>(i % 5) * 0.2f};
+  }
+  // Rows in a node are not contiguous.
+  std::vector<bst_idx_t> row_indices;
+  for (size_t i = 0; i < kRows; i += 2) {
+    row_indices.push_back(i);
+  }
+
+  auto n_bins = gmat.cut.Ptrs().back();
+  std::vector<GradientPairPrecise> expected(n_bins);
+  for (auto ridx : row_indices) {
+    for (size_t i = gmat.row_ptr[ridx]; i < gmat.row_ptr[ridx + 1]; ++i) {
+      expected[gmat.index[i]] += GradientPairPrecise{gpair[ridx]};
+    }
+  }
+
+  for (bool force_read_by_column : {false, true}) {
+    std::vector<GradientPairPrecise> hist(n_bins);
+    BuildHist<false>(gpair, row_indices, gmat, GHistRow{hist.data(), hist.size()},
+                     force_read_by_column);
+    for (size_t i = 0; i < n_bins; ++i) {
+      ASSERT_NEAR(hist[i].GetGrad(), expected[i].GetGrad(), 1e-6);
+      ASSERT_NEAR(hist[i].GetHess(), expected[i].GetHess(), 1e-6);
+    }
+  }
+}
+
+TEST(HistUtil, BuildHistFeatureSet) {
+  size_t constexpr kRows = 512, kCols = 13;
+  Context ctx;
+  auto p_fmat = RandomDataGenerator(kRows, kCols, 0).Seed(5).GenerateDMatrix();
+  std::vector<GradientPair> gpair(kRows);
+  for (size_t i = 0; i < kRows; ++i) {
+    gpair[i] = GradientPair{static_cast<float>(i % 3) * 0.5f, 1.0f};
+  }
+  std::vector<bst_idx_t> row_indices;
+  for (size_t i = 1; i < kRows; i += 3) {
+    row_indices.push_back(i);
+  }
+  std::vector<bst_feature_t> features{0, 3, 4, 5, 6, 11};
+
+  // Both 8-bit and 16-bit bin indices.
+  for (int32_t n_bins : {32, 1024}) {
+    GHistIndexMatrix gmat(&ctx, p_fmat.get(), n_bins, 0.5, false);
+    ASSERT_TRUE(gmat.IsDense());
+    auto const &ptrs = gmat.cut.Ptrs();
+    std::vector<GradientPairPrecise> full(ptrs.back());
+    BuildHist<false>(gpair, row_indices, gmat, GHistRow{full.data(), full.size()});
+    for (bool force_read_by_column : {false, true}) {
+      std::vector<GradientPairPrecise> hist(ptrs.back());
+      BuildHist<false>(gpair, row_indices, gmat, GHistRow{hist.data(), hist.size()},
+                       force_read_by_column, features);
+      for (bst_feature_t f = 0; f < kCols; ++f) {
+        bool sampled = std::find(features.cbegin(), features.cend(), f) != features.cend();
+        for (auto i = ptrs[f]; i < ptrs[f + 1]; ++i) {
+          if (sampled) {
+            ASSERT_NEAR(hist[i].GetGrad(), full[i].GetGrad(), 1e-6);
+            ASSERT_NEAR(hist[i].GetHess(), full[i].GetHess(), 1e-6);
+          } else {
+            ASSERT_EQ(hist[i].GetGrad(), 0.0);
+            ASSERT_EQ(hist[i].GetHess(), 0.0);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(HistUtil, BuildHistColumns) {
+  size_t constexpr kRows = 512, kCols = 13;
+  Context ctx;
+  auto p_fmat = RandomDataGenerator(kRows, kCols, 0).Seed(7).GenerateDMatrix();
+  std::vector<GradientPair> gpair(kRows);
+  for (size_t i = 0; i < kRows; ++i) {
+    gpair[i] = GradientPair{static_cast<float>(i % 5) * 0.25f - 0.5f, 1.0f + (i % 3)};
+  }
+  std::vector<bst_idx_t> row_indices;
+  for (size_t i = 2; i < kRows; i += 3) {
+    row_indices.push_back(i);
+  }
+  std::vector<bst_feature_t> features{1, 2, 7, 12};
+
+  // Both 8-bit and 16-bit bin indices.
+  for (int32_t n_bins : {32, 1024}) {
+    GHistIndexMatrix gmat(&ctx, p_fmat.get(), n_bins, 0.5, false);
+    ASSERT_TRUE(gmat.IsDense());
+    ColumnMatrix columns{gmat, 0.5};
+    columns.InitFromGHist(&ctx, gmat);
+    ASSERT_FALSE(columns.AnyMissing());
+
+    for (auto fset : {Span<bst_feature_t const>{}, Span<bst_feature_t const>{features}}) {
+      auto n_total_bins = gmat.cut.Ptrs().back();
+      std::vector<GradientPairPrecise> expected(n_total_bins);
+      BuildHist<false>(gpair, row_indices, gmat, GHistRow{expected.data(), expected.size()},
+                       false, fset);
+      std::vector<GradientPairPrecise> hist(n_total_bins);
+      BuildHistColumns(gpair, row_indices, columns, 0, GHistRow{hist.data(), hist.size()}, fset);
+      for (size_t i = 0; i < n_total_bins; ++i) {
+        ASSERT_NEAR(hist[i].GetGrad(), expected[i].GetGrad(), 1e-6);
+        ASSERT_NEAR(hist[i].GetHess(), expected[i].GetHess(), 1e-6);
+      }
+    }
+  }
+}
 }  // namespace common
 }  // namespace xgboost
@@ -61,14 +61,20 @@ TEST(HistUtil, SketchBatchNumElements) {
 #endif  // defined(XGBOOST_USE_RMM) && XGBOOST_USE_RMM == 1
   size_t constexpr kCols = 10000;
   std::int32_t device = dh::CurrentDevice();
-  auto avail = static_cast<size_t>(dh::AvailableMemory(device) * 0.8);
+  double avail = dh::AvailableMemory(device) * 0.8;
   auto per_elem = detail::BytesPerElement(false);
-  auto avail_elem = avail / per_elem;
-  size_t rows = avail_elem / kCols * 10;
+  size_t rows = static_cast<size_t>(avail / per_elem) / kCols * 10;
   auto shape = detail::SketchShape{rows, kCols, rows * kCols};
   auto batch = detail::SketchBatchNumElements(detail::UnknownSketchNumElements(), shape, device,
                                               256, false, 0);
+  auto container = detail::SketchContainerPeakBytes(kCols, 256, rows * kCols);
+  auto avail_elem = static_cast<size_t>((avail - container) / per_elem);
   ASSERT_EQ(batch, avail_elem);
+
+  // The allocated container is not reserved twice.
+  batch = detail::SketchBatchNumElements(detail::UnknownSketchNumElements(), shape, device, 256,
+                                         false, container);
+  ASSERT_GT(batch, avail_elem);
 }
 
 TEST(HistUtil, DeviceSketchMemory) {
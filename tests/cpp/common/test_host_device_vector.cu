@@ -219,4 +219,49 @@ TEST(HostDeviceVector, Resize) {
     check(vec);
   }
 }
+
+TEST(HostDeviceVector, Pinned) {
+  size_t n = 1001;
+  auto device = DeviceOrd::CUDA(0);
+  HostDeviceVectorSetDeviceHandler hdvec_dev_hndlr(curt::SetDevice);
+  HostDeviceVector<int> v;
+  v.SetPinned(true);
+  InitHostDeviceVector(n, device, &v);
+  CheckDevice(&v, n, 0, GPUAccess::kRead);
+  PlusOne(&v);
+  CheckDevice(&v, n, 1, GPUAccess::kWrite);
+  CheckHost(&v, GPUAccess::kRead);
+  CheckHost(&v, GPUAccess::kNone);
+}
+
+TEST(HostDeviceVector, Prefetch) {
+  size_t n = 1001;
+  auto device = DeviceOrd::CUDA(0);
+  HostDeviceVectorSetDeviceHandler hdvec_dev_hndlr(curt::SetDevice);
+  HostDeviceVector<int> v;
+  InitHostDeviceVector(n, device, &v);
+
+  v.PrefetchToDevice();
+  // Both sides can read the data.
+  ASSERT_TRUE(v.HostCanRead());
+  ASSERT_TRUE(v.DeviceCanRead());
+  ASSERT_FALSE(v.DeviceCanWrite());
+  CheckDevice(&v, n, 0, GPUAccess::kRead);
+
+  PlusOne(&v);
+  v.PrefetchToHost();
+  // The access is not changed until the host reads the data.
+  ASSERT_FALSE(v.HostCanRead());
+  ASSERT_TRUE(v.DeviceCanWrite());
+  CheckHost(&v, GPUAccess::kRead);
+
+  // A write on the device after the prefetch drops the staged copy.
+  PlusOne(&v);
+  v.PrefetchToHost();
+  PlusOne(&v);
+  auto const& h_v = v.ConstHostVector();
+  for (size_t i = 0; i < n; ++i) {
+    ASSERT_EQ(h_v[i], i + 3);
+  }
+}
 }  // namespace xgboost::common
@@ -3,9 +3,11 @@
  */
 #include <gtest/gtest.h>
 
-#include <cstddef>  // for size_t
-#include <fstream>  // for ofstream
-#include <numeric>  // for iota
+#include <algorithm>  // for fill_n
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint8_t, uintptr_t
+#include <fstream>    // for ofstream
+#include <numeric>    // for iota
 
 #include "../../../src/common/io.h"
 #include "../filesystem.h"  // dmlc::TemporaryDirectory
@@ -153,6 +155,55 @@ TEST(IO, Resource) {
   }
 }
 
+TEST(IO, LargeMallocResource) {
+  auto policy = GetLargeAllocPolicy();
+  ASSERT_FALSE(policy.Enabled());
+  for (auto huge_pages : {HugePages::kTransparent, HugePages::kExplicit}) {
+    SetLargeAllocPolicy({huge_pages, true});
+    // Small buffers use malloc.
+    MallocResource small{64};
+    ASSERT_EQ(small.Size(), 64);
+
+    std::size_t n = detail::kHugePageSize + 128;
+    MallocResource resource{64};
+    std::iota(resource.DataAs<std::uint8_t>(), resource.DataAs<std::uint8_t>() + 64, 0);
+    resource.Resize(n, std::byte{3});
+    ASSERT_EQ(resource.Size(), n);
+    auto ptr = resource.DataAs<std::uint8_t>();
+#if defined(__linux__)
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % detail::kHugePageSize, 0);
+#endif  // defined(__linux__)
+    for (std::size_t i = 0; i < 64; ++i) {
+      ASSERT_EQ(ptr[i], i);
+    }
+    for (std::size_t i = 64; i < n; ++i) {
+      ASSERT_EQ(ptr[i], 3);
+    }
+
+    // Disabling the policy doesn't affect existing buffers.
+    SetLargeAllocPolicy({});
+    resource.Resize(256);
+    std::fill_n(resource.DataAs<std::uint8_t>(), resource.Size(), 7);
+    resource.Resize(n);
+#if defined(__linux__)
+    // Reused
+    ASSERT_EQ(resource.DataAs<std::uint8_t>(), ptr);
+    // Grown
+    resource.Resize(detail::kHugePageSize * 3);
+    ptr = resource.DataAs<std::uint8_t>();
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % detail::kHugePageSize, 0);
+#endif  // defined(__linux__)
+    ptr = resource.DataAs<std::uint8_t>();
+    for (std::size_t i = 0; i < 256; ++i) {
+      ASSERT_EQ(ptr[i], 7);
+    }
+    for (std::size_t i = 256; i < resource.Size(); ++i) {
+      ASSERT_EQ(ptr[i], 0);
+    }
+  }
+  SetLargeAllocPolicy(policy);
+}
+
 TEST(IO, PrivateMmapStream) {
   dmlc::TemporaryDirectory tempdir;
   auto path = tempdir.path + "/testfile";
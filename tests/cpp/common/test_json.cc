@@ -7,6 +7,8 @@
 #include <limits>  // for numeric_limits
 #include <map>
 #include <numeric>  // for iota
+#include <stdexcept>  // for out_of_range
+#include <tuple>      // for ignore
 
 #include "../../../src/common/io.h"
 #include "../../../src/common/json_utils.h"
@@ -351,6 +353,44 @@ TEST(Json, AssigningObjects) {
   }
 }
 
+TEST(Json, ObjectMap) {
+  Object::Map map;
+  for (auto key : {"c", "a", "b", "a"}) {
+    map[key] = Integer{static_cast<Integer::Int>(map.size())};
+  }
+  ASSERT_EQ(map.size(), 3ul);
+  std::vector<std::string> keys;
+  for (auto const& kv : map) {
+    keys.push_back(kv.first);
+  }
+  ASSERT_EQ(keys, (std::vector<std::string>{"a", "b", "c"}));
+  ASSERT_EQ(get<Integer const>(map.at("a")), 1);
+  ASSERT_NE(map.find(StringView{"b"}), map.cend());
+  ASSERT_EQ(map.find("d"), map.cend());
+  ASSERT_THROW({ std::ignore = map.at("d"); }, std::out_of_range);
+
+  ASSERT_FALSE(map.emplace("b", Integer{4}).second);
+  ASSERT_EQ(get<Integer const>(map.at("b")), 2);
+  ASSERT_EQ(map.erase("b"), 1ul);
+  ASSERT_EQ(map.erase("b"), 0ul);
+  ASSERT_EQ(map.size(), 2ul);
+
+  // The last one wins for duplicated keys.
+  auto jobj = Json::Load(StringView{R"({"b": 1, "a": 2, "b": 3})"});
+  ASSERT_EQ(get<Object const>(jobj).size(), 2ul);
+  ASSERT_EQ(get<Integer const>(jobj["b"]), 3);
+
+  std::vector<Object::Map::value_type> items;
+  items.emplace_back("b", Integer{1});
+  items.emplace_back("a", Integer{2});
+  items.emplace_back("b", Integer{3});
+  Json jitems{Object{Object::Map{std::move(items)}}};
+  ASSERT_EQ(jitems, jobj);
+  std::vector<char> out;
+  Json::Dump(jitems, &out, std::ios::binary);
+  ASSERT_EQ(Json::Load(StringView{out.data(), out.size()}, std::ios::binary), jobj);
+}
+
 TEST(Json, AssigningArray) {
   Json json;
   json = JsonArray();
@@ -742,6 +782,72 @@ TEST(UBJson, Basic) {
   }
 }
 
+TEST(UBJson, Sizer) {
+  Json obj{Object{}};
+  // Larger than a block of the byte swap.
+  std::size_t constexpr kElements = 1031;
+  F32Array f32{kElements};
+  I16Array i16{kElements};
+  I64Array i64{kElements};
+  for (std::size_t i = 0; i < kElements; ++i) {
+    f32.Set(i, static_cast<float>(i) / 3.0f);
+    i16.Set(i, static_cast<std::int16_t>(i) - 512);
+    i64.Set(i, static_cast<std::int64_t>(i) << 40);
+  }
+  obj["f32"] = std::move(f32);
+  obj["i16"] = std::move(i16);
+  obj["i64"] = std::move(i64);
+  obj["integers"] =
+      Array{std::vector<Json>{Json{Integer{3}}, Json{Integer{300}}, Json{Integer{1 << 20}},
+                              Json{Integer{std::int64_t{1} << 40}}}};
+  obj["scalars"] = Array{std::vector<Json>{Json{Boolean{true}}, Json{Number{1.5}}, Json{},
+                                           Json{String{"foo"}}}};
+  obj["empty"] = Object{};
+
+  // Large enough for the parallel writer.
+  Json array{Array{std::vector<Json>(64, obj)}};
+  for (std::int32_t n_threads : {1, 4}) {
+    UBJSizer sizer{n_threads};
+    sizer.Save(array);
+    std::vector<char> out;
+    Json::Dump(array, &out, std::ios::binary, n_threads);
+    ASSERT_EQ(sizer.Size(), out.size());
+    ASSERT_EQ(out.capacity(), out.size());
+    auto loaded = Json::Load(StringView{out.data(), out.size()}, std::ios::binary);
+    ASSERT_EQ(loaded, array);
+  }
+}
+
+TEST(UBJson, Skip) {
+  Json obj{Object{}};
+  obj["typed"] = F32Array{static_cast<std::size_t>(7)};
+  obj["array"] = Array{std::vector<Json>{Json{Integer{300}}, Json{String{"foo"}}, Json{}}};
+  obj["empty"] = Object{};
+  obj["scalars"] = Array{std::vector<Json>{Json{Boolean{true}}, Json{Number{1.5}}}};
+
+  Json array{Array{std::vector<Json>{obj, Json{Integer{3}}}}};
+  std::vector<char> out;
+  Json::Dump(array, &out, std::ios::binary);
+
+  class Reader : public UBJReader {
+   public:
+    using UBJReader::UBJReader;
+    void Check(std::size_t n_bytes) {
+      GetConsecutiveChar('[');
+      this->SkipValue();
+      auto last = this->Parse();
+      ASSERT_EQ(get<Integer const>(last), 3);
+      GetConsecutiveChar(']');
+      ASSERT_EQ(cursor_.Pos(), n_bytes);
+    }
+  };
+  Reader reader{StringView{out.data(), out.size()}};
+  reader.Check(out.size());
+
+  // truncated
+  Reader invalid{StringView{out.data(), out.size() / 2}};
+  ASSERT_THROW({ invalid.Check(out.size()); }, dmlc::Error);
+}
 
 TEST(Json, TypeCheck) {
   Json config{Object{}};
@@ -758,6 +864,24 @@ TEST(Json, TypeCheck) {
   }
 }
 
+TEST(Json, ParallelDump) {
+  std::vector<Json> elements;
+  for (std::int32_t i = 0; i < 64; ++i) {
+    Json obj{Object{}};
+    obj["id"] = Integer{i};
+    obj["values"] = F32Array{static_cast<std::size_t>(i)};
+    elements.emplace_back(std::move(obj));
+  }
+  Json jarr{Array{std::move(elements)}};
+  for (auto mode : {std::ios::out, std::ios::binary}) {
+    std::vector<char> serial;
+    Json::Dump(jarr, &serial, mode);
+    std::vector<char> parallel;
+    Json::Dump(jarr, &parallel, mode, 4);
+    ASSERT_EQ(serial, parallel);
+  }
+}
+
 TEST(Json, Dump) {
   auto str = GetModelStr();
   auto jobj = Json::Load(str);
@@ -0,0 +1,102 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+#include <xgboost/host_device_vector.h>  // for HostDeviceVector
+#include <xgboost/json.h>                // for Json, get
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int64_t, uint32_t
+#include <string>   // for string
+
+#include "../../../src/common/memory_stats.h"       // for MemoryAccount, MemTagScope
+#include "../../../src/common/ref_resource_view.h"  // for MakeFixedVecWithMalloc
+
+namespace xgboost::common {
+TEST(MemoryStats, Account) {
+  auto& stats = GlobalMemoryStats();
+  auto other = stats.CurrentBytes(MemTag::kOther);
+  auto hist = stats.CurrentBytes(MemTag::kHistogram);
+  {
+    MemoryAccount account;
+    account.Update(64);
+    ASSERT_EQ(account.Tag(), MemTag::kOther);
+    ASSERT_EQ(stats.CurrentBytes(MemTag::kOther), other + 64);
+    {
+      MemTagScope scope{MemTag::kHistogram};
+      ASSERT_EQ(MemTagScope::Current(), MemTag::kHistogram);
+      // Same size, nothing is changed.
+      account.Update(64);
+      ASSERT_EQ(account.Tag(), MemTag::kOther);
+      // The existing bytes are moved to the tag of the scope.
+      account.Update(128);
+      ASSERT_EQ(account.Tag(), MemTag::kHistogram);
+      ASSERT_EQ(stats.CurrentBytes(MemTag::kOther), other);
+      ASSERT_EQ(stats.CurrentBytes(MemTag::kHistogram), hist + 128);
+      {
+        MemTagScope nested{MemTag::kGradient};
+        // Tagged accounts are not changed by the scope.
+        account.Update(256);
+        ASSERT_EQ(account.Tag(), MemTag::kHistogram);
+      }
+      ASSERT_EQ(MemTagScope::Current(), MemTag::kHistogram);
+    }
+    ASSERT_EQ(MemTagScope::Current(), MemTag::kOther);
+    ASSERT_EQ(stats.CurrentBytes(MemTag::kHistogram), hist + 256);
+    ASSERT_GE(stats.PeakBytes(MemTag::kHistogram), hist + 256);
+    account.Update(32);
+    ASSERT_EQ(stats.CurrentBytes(MemTag::kHistogram), hist + 32);
+  }
+  ASSERT_EQ(stats.CurrentBytes(MemTag::kHistogram), hist);
+  ASSERT_GE(stats.PeakBytes(MemTag::kHistogram), hist + 256);
+
+  stats.ResetPeak();
+  ASSERT_EQ(stats.PeakBytes(MemTag::kHistogram), stats.CurrentBytes(MemTag::kHistogram));
+}
+
+TEST(MemoryStats, RefResourceView) {
+  auto& stats = GlobalMemoryStats();
+  auto before = stats.CurrentBytes(MemTag::kColumnMatrix);
+  std::size_t n = 1024;
+  {
+    MemTagScope scope{MemTag::kColumnMatrix};
+    auto vec = MakeFixedVecWithMalloc(n, std::uint32_t{0});
+    ASSERT_GE(stats.CurrentBytes(MemTag::kColumnMatrix), before + n * sizeof(std::uint32_t));
+  }
+  ASSERT_EQ(stats.CurrentBytes(MemTag::kColumnMatrix), before);
+}
+
+#if !defined(XGBOOST_USE_CUDA)
+TEST(MemoryStats, HostDeviceVector) {
+  auto& stats = GlobalMemoryStats();
+  auto before = stats.CurrentBytes(MemTag::kGradient);
+  std::size_t n = 2048;
+  {
+    HostDeviceVector<float> vec;
+    {
+      MemTagScope scope{MemTag::kGradient};
+      vec.Resize(n);
+    }
+    ASSERT_GE(stats.CurrentBytes(MemTag::kGradient), before + n * sizeof(float));
+    // Resized through the host vector, the size is updated on the next access.
+    vec.HostVector().resize(n * 4);
+    vec.ConstHostVector();
+    ASSERT_GE(stats.CurrentBytes(MemTag::kGradient), before + n * 4 * sizeof(float));
+  }
+  ASSERT_EQ(stats.CurrentBytes(MemTag::kGradient), before);
+}
+#endif  // !defined(XGBOOST_USE_CUDA)
+
+TEST(MemoryStats, Json) {
+  auto jstats = GlobalMemoryStats().ToJson();
+  auto const& obj = get<Object const>(jstats);
+  ASSERT_EQ(obj.size(), static_cast<std::size_t>(MemTag::kNumTags) + 1);
+  for (auto name : {"Other", "SparsePage", "GHistIndexMatrix", "ColumnMatrix", "Histogram",
+                    "PredictionCache", "Gradient", "PredictorBuffer", "Total"}) {
+    ASSERT_TRUE(obj.find(name) != obj.cend()) << name;
+    auto current = get<Integer const>(jstats[name]["current"]);
+    auto peak = get<Integer const>(jstats[name]["peak"]);
+    ASSERT_GE(peak, current);
+  }
+}
+}  // namespace xgboost::common
@@ -0,0 +1,67 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+#include <xgboost/json.h>  // for Json
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int32_t
+#include <vector>   // for vector
+
+#include "../../../src/common/perf_counter.h"     // for PerfCounters, PerfScope
+#include "../../../src/common/threading_utils.h"  // for ParallelFor
+#include "../../../src/common/timer.h"            // for Monitor
+
+namespace xgboost::common {
+TEST(PerfCounters, Phases) {
+  auto& counters = PerfCounters::Get();
+  ASSERT_FALSE(PerfCounters::Enabled());
+  counters.Configure(true);
+  if (!PerfCounters::Enabled()) {
+    GTEST_SKIP() << "Hardware performance counters are not available.";
+  }
+
+  std::size_t n = 1 << 20;
+  std::vector<double> data(n, 1.0);
+  auto work = [&] {
+    ParallelFor(n, 4, [&](std::size_t i) { data[i] = data[i] * 1.5 + 1.0; });
+  };
+  {
+    PerfScope perf{"Test::Scope"};
+    work();
+  }
+  Monitor monitor;
+  monitor.Init("Test");
+  for (std::int32_t i = 0; i < 3; ++i) {
+    monitor.Start("Monitor");
+    work();
+    monitor.Stop("Monitor");
+  }
+  counters.Configure(false);
+  // Ignored after the collection is stopped.
+  {
+    PerfScope perf{"Test::Stopped"};
+    work();
+  }
+
+  auto out = counters.Dump();
+  auto const& phases = get<Object const>(out);
+  ASSERT_EQ(phases.size(), 2);
+  ASSERT_EQ(get<Integer const>(out["Test::Scope"]["count"]), 1);
+  ASSERT_EQ(get<Integer const>(out["Test::Monitor"]["count"]), 3);
+  for (auto const& kv : phases) {
+    ASSERT_GT(get<Number const>(kv.second["elapsed"]), 0.0);
+    auto const& phase = get<Object const>(kv.second);
+    if (phase.find("instructions") != phase.cend()) {
+      // At least one instruction for each element.
+      ASSERT_GE(get<Integer const>(kv.second["instructions"]), n);
+    }
+  }
+
+  // Restarting clears the results.
+  counters.Configure(true);
+  counters.Configure(false);
+  out = counters.Dump();
+  ASSERT_TRUE(get<Object const>(out).empty());
+}
+}  // namespace xgboost::common
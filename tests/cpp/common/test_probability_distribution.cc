@@ -37,6 +37,25 @@ void RunDistributionGenericTest() {
   }
 }
 
+template <typename Distribution>
+void RunDistributionEvalTest() {
+  // Include the points where the exponentials overflow.
+  for (int i = -8000; i <= 8000; ++i) {
+    const double z = static_cast<double>(i) / 10.0;
+    const auto v = Distribution::Eval(z);
+    EXPECT_EQ(v.pdf, Distribution::PDF(z)) << z;
+    EXPECT_EQ(v.cdf, Distribution::CDF(z)) << z;
+    EXPECT_EQ(v.grad_pdf, Distribution::GradPDF(z)) << z;
+    EXPECT_EQ(v.hess_pdf, Distribution::HessPDF(z)) << z;
+  }
+}
+
+TEST(ProbabilityDistribution, DistributionEval) {
+  RunDistributionEvalTest<NormalDistribution>();
+  RunDistributionEvalTest<LogisticDistribution>();
+  RunDistributionEvalTest<ExtremeDistribution>();
+}
+
 TEST(ProbabilityDistribution, DistributionGeneric) {
   // Assert d/dx CDF = PDF, d/dx PDF = GradPDF, d/dx GradPDF = HessPDF
   // Do this for every distribution type
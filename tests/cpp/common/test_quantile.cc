@@ -5,12 +5,14 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>    // for ceil, log
 #include <cstdint>  // for int64_t
 
 #include "../../../src/collective/allreduce.h"
 #include "../../../src/common/hist_util.h"
 #include "../../../src/data/adapter.h"
 #include "../collective/test_worker.h"  // for TestDistributedGlobal
+#include "test_hist_util.h"             // for ValidateCuts
 #include "xgboost/context.h"
 
 namespace xgboost::common {
@@ -30,6 +32,38 @@ TEST(Quantile, LoadBalance) {
   CHECK_EQ(n_cols, kCols);
 }
 
+TEST(Quantile, SampleRows) {
+  ASSERT_EQ(SketchSampleSize(0.01, 0.05), std::ceil(std::log(40.0) / 2e-4));
+
+  bst_idx_t constexpr kRows = 1 << 15;
+  bst_feature_t constexpr kCols = 4;
+  bst_bin_t constexpr kBins = 16;
+  Context ctx;
+  ctx.UpdateAllowUnknown(Args{{"nthread", "3"}});
+  auto m = RandomDataGenerator{kRows, kCols, 0}.GenerateDMatrix();
+  auto const& info = m->Info();
+
+  HostSketchContainer sketch{&ctx, kBins, info.feature_types.ConstHostSpan(),
+                             std::vector<bst_idx_t>(kCols, kRows), false};
+  // Within 1/32 of the rank.
+  sketch.SampleRows(kRows, 0.5);
+  auto n_sampled = SketchSampleSize(0.5 / kBins);
+  ASSERT_LT(n_sampled, kRows);
+  ASSERT_DOUBLE_EQ(sketch.SampleRate(), static_cast<double>(n_sampled) / kRows);
+  for (auto const& page : m->GetBatches<SparsePage>()) {
+    sketch.PushRowPage(page, info);
+  }
+  HistogramCuts cuts;
+  sketch.MakeCuts(&ctx, info, &cuts);
+  ValidateCuts(cuts, m.get(), kBins);
+
+  // No sample for small data.
+  HostSketchContainer small{&ctx, kBins, info.feature_types.ConstHostSpan(),
+                            std::vector<bst_idx_t>(kCols, kRows), false};
+  small.SampleRows(n_sampled, 0.5);
+  ASSERT_EQ(small.SampleRate(), 1.0);
+}
+
 namespace {
 template <bool use_column>
 using ContainerType = std::conditional_t<use_column, SortedSketchContainer, HostSketchContainer>;
@@ -148,10 +182,9 @@ void DoTestDistributedQuantile(size_t rows, size_t cols) {
 }
 
 template <bool use_column>
-void TestDistributedQuantile(size_t const rows, size_t const cols) {
-  auto constexpr kWorkers = 4;
+void TestDistributedQuantile(size_t const rows, size_t const cols, std::int32_t n_workers = 4) {
   collective::TestDistributedGlobal(
-      kWorkers, [=] { DoTestDistributedQuantile<use_column>(rows, cols); }, false);
+      n_workers, [=] { DoTestDistributedQuantile<use_column>(rows, cols); }, false);
 }
 }  // anonymous namespace
 
@@ -165,6 +198,12 @@ TEST(Quantile, Distributed) {
   TestDistributedQuantile<false>(kRows, kCols);
 }
 
+TEST(Quantile, DistributedNonPof2) {
+  // The extra workers are folded into their neighbours when merging the sketches.
+  constexpr size_t kRows = 1000, kCols = 20;
+  TestDistributedQuantile<false>(kRows, kCols, 3);
+}
+
 TEST(Quantile, SortedDistributedBasic) {
   constexpr size_t kRows = 10, kCols = 10;
   TestDistributedQuantile<true>(kRows, kCols);
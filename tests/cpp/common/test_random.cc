@@ -100,6 +100,35 @@ TEST(ColumnSampler, ThreadSynchronisation) {
   ASSERT_TRUE(success);
 }
 
+TEST(ColumnSampler, BatchedNodeSampling) {
+  Context ctx;
+  bst_feature_t n = 256;
+  std::vector<float> feature_weights;
+  std::vector<bst_node_t> depths{1, 1, 2, 2, 2, 2};
+
+  ColumnSampler batched{3u};
+  batched.Init(&ctx, n, feature_weights, 0.25f, 0.5f, 0.5f);
+  std::vector<std::shared_ptr<HostDeviceVector<bst_feature_t>>> sets;
+  batched.GetFeatureSets(depths, &sets);
+  ASSERT_EQ(sets.size(), depths.size());
+
+  ColumnSampler single{3u};
+  single.Init(&ctx, n, feature_weights, 0.25f, 0.5f, 0.5f);
+  auto const& h_tree = single.GetTreeFeatureSet()->ConstHostVector();
+  for (std::size_t i = 0; i < depths.size(); ++i) {
+    auto const& h_set = sets[i]->ConstHostVector();
+    ASSERT_EQ(h_set, single.GetFeatureSet(depths[i])->ConstHostVector());
+    ASSERT_EQ(h_set.size(), n / 16);
+    ASSERT_TRUE(std::is_sorted(h_set.cbegin(), h_set.cend()));
+    ASSERT_EQ(std::adjacent_find(h_set.cbegin(), h_set.cend()), h_set.cend());
+    for (auto f : h_set) {
+      ASSERT_TRUE(std::binary_search(h_tree.cbegin(), h_tree.cend(), f));
+    }
+  }
+  // The permutation of the level is reused between nodes, the samples are still different.
+  ASSERT_NE(sets[2]->ConstHostVector(), sets[3]->ConstHostVector());
+}
+
 namespace {
 void TestWeightedSampling(Context const* ctx) {
   auto test_basic = [ctx](int first) {
@@ -12,7 +12,7 @@
 #include <xgboost/string_view.h>                // for StringView
 
 #include <cstddef>                              // for size_t
-#include <cstdint>                              // for uint32_t
+#include <cstdint>                              // for uint32_t, int32_t
 #include <numeric>                              // for iota
 #include <utility>                              // for move
 #include <vector>                               // for vector
@@ -110,6 +110,45 @@ TEST(RankingCache, InitFromCPU) {
   TestRankingCache(&ctx);
 }
 
+TEST(RankingCache, GroupsAndLabelBuckets) {
+  Context ctx;
+  auto p_fmat = EmptyDMatrix();
+  MetaInfo& info = p_fmat->Info();
+  info.num_row_ = 12;
+  info.group_ptr_ = {0, 2, 7, 8, 12};
+  info.labels = linalg::Matrix<float>{{1, 0, 2, 0, 2, 1, 0, 3, 1, 1, 1, 1},
+                                      {info.num_row_},
+                                      DeviceOrd::CPU()};
+  LambdaRankParam param;
+  param.UpdateAllowUnknown(Args{{"lambdarank_pair_method", "mean"}});
+  RankingCache cache{&ctx, info, param};
+
+  // Each group is visited exactly once.
+  std::vector<std::int32_t> n_visits(cache.Groups(), 0);
+  cache.ParallelForGroups(&ctx, [&](bst_group_t g) { n_visits[g]++; });
+  for (auto v : n_visits) {
+    ASSERT_EQ(v, 1);
+  }
+
+  auto check = [&](bst_group_t g, std::vector<std::uint32_t> bucket,
+                   std::vector<std::size_t> bucket_ptr) {
+    auto g_bucket = cache.LabelBucket(g);
+    ASSERT_EQ(g_bucket.size(), bucket.size());
+    for (std::size_t i = 0; i < bucket.size(); ++i) {
+      ASSERT_EQ(g_bucket[i], bucket[i]);
+    }
+    auto g_bucket_ptr = cache.LabelBucketPtr(g);
+    ASSERT_EQ(g_bucket_ptr.size(), bucket_ptr.size());
+    for (std::size_t i = 0; i < bucket_ptr.size(); ++i) {
+      ASSERT_EQ(g_bucket_ptr[i], bucket_ptr[i]);
+    }
+  };
+  check(0, {0, 1}, {0, 1, 2});
+  check(1, {0, 2, 0, 1, 2}, {0, 2, 3, 5});
+  check(2, {0}, {0, 1});
+  check(3, {0, 0, 0, 0}, {0, 4});
+}
+
 void TestNDCGCache(Context const* ctx) {
   auto p_fmat = EmptyDMatrix();
   MetaInfo& info = p_fmat->Info();
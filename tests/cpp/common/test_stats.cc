@@ -6,7 +6,11 @@
 #include <xgboost/linalg.h>  // Tensor,Vector
 
 #include <algorithm>  // for min
+#include <cmath>      // for isnan
+#include <random>     // for mt19937, uniform_int_distribution
 #include <thread>     // for thread
+#include <utility>    // for pair
+#include <vector>     // for vector
 
 #include "../../../src/common/linalg_op.h"  // for begin, end
 #include "../../../src/common/stats.h"
@@ -64,6 +68,36 @@ TEST(Stats, WeightedQuantile) {
   ASSERT_EQ(q, 5);
 }
 
+TEST(Stats, SelectQuantile) {
+  Context ctx;
+  std::mt19937 rng{0};
+  std::uniform_int_distribution<int> dist{0, 40};
+  for (std::size_t n : {1, 2, 3, 7, 100, 1001}) {
+    std::vector<float> values(n);
+    std::vector<float> weights(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      // Many ties, and integer weights to make the prefix sum exact.
+      values[i] = static_cast<float>(dist(rng)) / 4.0f;
+      weights[i] = static_cast<float>(dist(rng) % 4);
+    }
+    weights[0] = 1.0f;
+    auto beg = MakeIndexTransformIter([&](size_t i) { return values[i]; });
+    auto w = MakeIndexTransformIter([&](size_t i) { return weights[i]; });
+    for (double alpha : {0.0, 0.01, 0.1, 0.25, 0.5, 0.63, 0.9, 0.99, 1.0}) {
+      auto buf = values;
+      ASSERT_EQ(SelectQuantile(alpha, Span{buf}), Quantile(&ctx, alpha, beg, beg + n));
+      std::vector<std::pair<float, float>> w_buf(n);
+      for (std::size_t i = 0; i < n; ++i) {
+        w_buf[i] = {values[i], weights[i]};
+      }
+      ASSERT_EQ(SelectWeightedQuantile(alpha, Span{w_buf}),
+                WeightedQuantile(&ctx, alpha, beg, beg + n, w));
+    }
+  }
+  std::vector<float> empty;
+  ASSERT_TRUE(std::isnan(SelectQuantile(0.5, Span{empty})));
+}
+
 TEST(Stats, Median) {
   Context ctx;
 
@@ -3,7 +3,11 @@
  */
 #include <gtest/gtest.h>
 
+#include <atomic>   // std::atomic
 #include <cstddef>  // std::size_t
+#include <cstdint>  // std::int32_t
+#include <thread>   // std::thread
+#include <vector>   // std::vector
 
 #include "../../../src/common/threading_utils.h"  // BlockedSpace2d,ParallelFor2d,ParallelFor
 #include "dmlc/omp.h"                             // omp_in_parallel
@@ -87,6 +91,33 @@ TEST(ParallelFor2d, NonUniform) {
   }
 }
 
+TEST(ParallelFor2d, Stealing) {
+  constexpr size_t kDim1 = 7;
+  constexpr size_t kGrainSize = 16;
+  std::vector<size_t> dim2{1024, 3, 500, 0, 255, 17, 4096};
+  BlockedSpace2d space(kDim1, [&](size_t i) { return dim2[i]; }, kGrainSize);
+
+  std::vector<std::vector<int>> working_space(kDim1);
+  for (size_t i = 0; i < kDim1; i++) {
+    working_space[i].resize(dim2[i], 0);
+  }
+
+  for (std::int32_t n_threads : {1, 3, 16}) {
+    // Each block is visited exactly once.
+    ParallelFor2dStealing(space, n_threads, [&](size_t i, Range1d r) {
+      for (auto j = r.begin(); j < r.end(); ++j) {
+        working_space[i][j] += 1;
+      }
+    });
+  }
+
+  for (size_t i = 0; i < kDim1; i++) {
+    for (size_t j = 0; j < dim2[i]; j++) {
+      ASSERT_EQ(working_space[i][j], 3);
+    }
+  }
+}
+
 TEST(ParallelFor, Basic) {
   Context ctx;
   std::size_t n{16};
@@ -110,4 +141,77 @@ TEST(OmpGetNumThreads, Max) {
   ASSERT_LE(n_threads, std::thread::hardware_concurrency());
 #endif
 }
+
+namespace {
+// Run each task on a new thread.
+std::int32_t ThreadExecutor(void* executor_data, std::int32_t n_tasks, ParallelTask task,
+                            void* task_data) {
+  static_cast<std::atomic<std::int32_t>*>(executor_data)->fetch_add(1);
+  std::vector<std::thread> threads;
+  for (std::int32_t i = 0; i < n_tasks; ++i) {
+    threads.emplace_back([=] { task(task_data, i); });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  return 0;
+}
+
+std::int32_t FailedExecutor(void*, std::int32_t, ParallelTask, void*) { return -1; }
+}  // anonymous namespace
+
+TEST(ParallelFor, Executor) {
+  std::atomic<std::int32_t> n_calls{0};
+  SetParallelExecutor(ThreadExecutor, &n_calls);
+  std::int32_t n_threads = 4;
+  std::size_t n = 1031;
+  for (auto sched : {Sched::Auto(), Sched::Static(), Sched::Static(7), Sched::Dyn(),
+                     Sched::Dyn(16), Sched::Guided()}) {
+    std::vector<std::int32_t> visited(n, 0);
+    std::vector<std::size_t> sum_tloc(n_threads, 0);
+    ParallelFor(n, n_threads, sched, [&](std::size_t i) {
+      auto tid = ThreadIdx();
+      ASSERT_GE(tid, 0);
+      ASSERT_LT(tid, n_threads);
+      ASSERT_FALSE(omp_in_parallel());
+      visited[i]++;
+      sum_tloc[tid] += i;
+      // Nested loops run sequentially.
+      ASSERT_EQ(OmpGetNumThreads(n_threads), 1);
+      std::size_t nested = 0;
+      ParallelFor(4, n_threads, [&](std::size_t j) { nested += j; });
+      ASSERT_EQ(nested, 6);
+      ASSERT_EQ(ThreadIdx(), tid);
+    });
+    for (auto v : visited) {
+      ASSERT_EQ(v, 1);
+    }
+    std::size_t sum = 0;
+    for (auto v : sum_tloc) {
+      sum += v;
+    }
+    ASSERT_EQ(sum, n * (n - 1) / 2);
+  }
+  ASSERT_EQ(n_calls.load(), 6);
+  ASSERT_EQ(ThreadIdx(), 0);
+
+  BlockedSpace2d space{8, [](std::size_t) { return 16; }, 4};
+  std::vector<std::atomic<std::int32_t>> visited(space.Size());
+  ParallelFor2dStealing(space, n_threads, [&](std::size_t i, Range1d r) {
+    visited[i * 4 + r.begin() / 4]++;
+  });
+  for (auto const& v : visited) {
+    ASSERT_EQ(v.load(), 1);
+  }
+  ASSERT_EQ(n_calls.load(), 7);
+
+  ASSERT_THROW(
+      { ParallelFor(n, n_threads, [](std::size_t i) { CHECK_NE(i, 3); }); }, dmlc::Error);
+
+  SetParallelExecutor(FailedExecutor, nullptr);
+  ASSERT_THROW({ ParallelFor(n, n_threads, [](std::size_t) {}); }, dmlc::Error);
+  SetParallelExecutor(nullptr, nullptr);
+  void* executor_data = nullptr;
+  ASSERT_EQ(GetParallelExecutor(&executor_data), nullptr);
+}
 }  // namespace xgboost::common
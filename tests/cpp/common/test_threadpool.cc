@@ -4,12 +4,17 @@
 #include <gtest/gtest.h>
 #include <xgboost/global_config.h>  // for GlobalConfigThreadLocalStore
 
+#include <array>    // for array
+#include <atomic>   // for atomic
 #include <cstddef>  // for size_t
 #include <cstdint>  // for int32_t
 #include <future>   // for future
+#include <memory>   // for unique_ptr, make_unique
+#include <numeric>  // for iota
 #include <thread>   // for sleep_for, thread
+#include <vector>   // for vector
 
-#include "../../../src/common/threadpool.h"
+#include "../../../src/common/threadpool.h"  // for ThreadPool, MoveOnlyTask, MPMCQueue
 
 namespace xgboost::common {
 TEST(ThreadPool, Basic) {
@@ -70,4 +75,90 @@ TEST(ThreadPool, Basic) {
     ASSERT_EQ(val, 3);
   }
 }
+
+TEST(ThreadPool, Bulk) {
+  // Small queue to test submission when the queue is full.
+  ThreadPool pool{StringView{"test"}, 4, [] {}, 8};
+  std::vector<std::size_t> args(1024);
+  std::iota(args.begin(), args.end(), 0);
+  auto futures = pool.SubmitBulk(args, [](std::size_t i) { return i * 2; });
+  ASSERT_EQ(futures.size(), args.size());
+  for (std::size_t i = 0; i < futures.size(); ++i) {
+    ASSERT_EQ(futures[i].get(), i * 2);
+  }
+  // Move-only result and exception.
+  auto fut = pool.Submit([] { return std::make_unique<std::int32_t>(3); });
+  ASSERT_EQ(*fut.get(), 3);
+  auto err = pool.Submit([]() -> std::int32_t { LOG(FATAL) << "test"; return 0; });
+  ASSERT_THROW({ err.get(); }, dmlc::Error);
+}
+
+TEST(ThreadPool, MoveOnlyTask) {
+  std::int32_t n_calls = 0;
+  // Inline
+  MoveOnlyTask small{[&n_calls, p = std::make_unique<std::int32_t>(1)] { n_calls += *p; }};
+  // Heap allocated
+  std::array<std::int64_t, 16> data;
+  data.fill(2);
+  MoveOnlyTask large{[&n_calls, data] { n_calls += static_cast<std::int32_t>(data[15]); }};
+  static_assert(sizeof(data) > MoveOnlyTask::kInlineSize);
+
+  MoveOnlyTask moved{std::move(small)};
+  ASSERT_FALSE(small);
+  moved();
+  ASSERT_EQ(n_calls, 1);
+  moved = std::move(large);
+  ASSERT_FALSE(large);
+  moved();
+  ASSERT_EQ(n_calls, 3);
+  moved.Reset();
+  ASSERT_FALSE(moved);
+}
+
+TEST(ThreadPool, MPMCQueue) {
+  MPMCQueue<std::size_t> queue{16};
+  std::size_t v = 0;
+  ASSERT_FALSE(queue.TryPop(&v));
+  for (std::size_t i = 0; i < 16; ++i) {
+    ASSERT_TRUE(queue.TryPush(&i));
+  }
+  ASSERT_FALSE(queue.TryPush(&v));
+  for (std::size_t i = 0; i < 16; ++i) {
+    ASSERT_TRUE(queue.TryPop(&v));
+    ASSERT_EQ(v, i);
+  }
+
+  // Concurrent producers and consumers, each value is popped once.
+  std::size_t constexpr kProducers = 4, kPerProducer = 1 << 12;
+  std::vector<std::atomic<std::int32_t>> seen(kProducers * kPerProducer);
+  std::atomic<std::size_t> n_popped{0};
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < kProducers; ++t) {
+    threads.emplace_back([&, t] {
+      for (std::size_t i = 0; i < kPerProducer; ++i) {
+        auto value = t * kPerProducer + i;
+        while (!queue.TryPush(&value)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+    threads.emplace_back([&] {
+      std::size_t value;
+      while (n_popped.load() < seen.size()) {
+        if (queue.TryPop(&value)) {
+          seen[value]++;
+          n_popped++;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  for (auto const& s : seen) {
+    ASSERT_EQ(s.load(), 1);
+  }
+}
 }  // namespace xgboost::common
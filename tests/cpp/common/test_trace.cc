@@ -0,0 +1,73 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+#include <xgboost/json.h>  // for Json
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int64_t
+#include <set>      // for set
+#include <string>   // for string
+#include <thread>   // for thread
+
+#include "../../../src/common/io.h"               // for LoadSequentialFile
+#include "../../../src/common/threading_utils.h"  // for ParallelFor
+#include "../../../src/common/trace.h"            // for Tracer, TraceScope
+#include "dmlc/filesystem.h"  // for TemporaryDirectory
+
+namespace xgboost::common {
+TEST(Tracer, ChromeTrace) {
+  dmlc::TemporaryDirectory tmpdir;
+  auto path = tmpdir.path + "/trace.json";
+  auto& tracer = Tracer::Get();
+  ASSERT_FALSE(Tracer::Enabled());
+  { TraceScope trace{TraceEvent::kTreeLevel}; }
+
+  tracer.Configure(path);
+  ASSERT_TRUE(Tracer::Enabled());
+  std::size_t n = 64;
+  ParallelFor(n, 4, [&](std::size_t i) {
+    TraceScope trace{TraceEvent::kBuildHist, static_cast<std::int64_t>(i)};
+  });
+  // Only the most recent events are kept.
+  std::thread{[] {
+    for (std::size_t i = 0; i < Tracer::kBufferSize + 8; ++i) {
+      TraceScope trace{TraceEvent::kAllreduce, static_cast<std::int64_t>(i)};
+    }
+  }}.join();
+  tracer.Configure("");
+  ASSERT_FALSE(Tracer::Enabled());
+  { TraceScope trace{TraceEvent::kTreeLevel}; }
+
+  auto str = LoadSequentialFile(path);
+  auto trace = Json::Load(StringView{str.data(), str.size()});
+  auto const& events = get<Array const>(trace["traceEvents"]);
+  std::set<std::int64_t> hist_args;
+  std::size_t n_allreduce = 0;
+  for (auto const& event : events) {
+    auto name = get<String const>(event["name"]);
+    ASSERT_NE(name, "TreeLevel");
+    ASSERT_EQ(get<String const>(event["ph"]), "X");
+    ASSERT_GE(get<Number const>(event["dur"]), 0.0);
+    auto arg = get<Integer const>(event["args"]["value"]);
+    if (name == "BuildHist") {
+      hist_args.insert(arg);
+    } else {
+      ASSERT_EQ(name, "Allreduce");
+      ASSERT_GE(arg, 8);
+      ++n_allreduce;
+    }
+  }
+  ASSERT_EQ(hist_args.size(), n);
+  ASSERT_EQ(n_allreduce, Tracer::kBufferSize);
+
+  // Restart, the previous events are discarded.
+  tracer.Configure(path);
+  { TraceScope trace{TraceEvent::kPageRead, 3}; }
+  tracer.Configure("");
+  str = LoadSequentialFile(path);
+  trace = Json::Load(StringView{str.data(), str.size()});
+  ASSERT_EQ(get<Array const>(trace["traceEvents"]).size(), 1);
+  ASSERT_EQ(get<String const>(trace["traceEvents"][0]["name"]), "PageRead");
+}
+}  // namespace xgboost::common
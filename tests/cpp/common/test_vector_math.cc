@@ -0,0 +1,76 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>    // for exp, isnan, isinf
+#include <cstdint>  // for int32_t, int64_t
+#include <cstring>  // for memcpy
+#include <limits>   // for numeric_limits
+#include <vector>   // for vector
+
+#include "../../../src/common/math.h"         // for Sigmoid
+#include "../../../src/common/vector_math.h"  // for VectorExp, VectorSigmoid
+
+namespace xgboost::common {
+namespace {
+// Map the float to an integer that is monotonic in the value of the float.
+std::int64_t OrderedBits(float v) {
+  std::int32_t bits;
+  std::memcpy(&bits, &v, sizeof(bits));
+  return bits < 0 ? -static_cast<std::int64_t>(bits & 0x7fffffff) : bits;
+}
+}  // anonymous namespace
+
+TEST(VectorMath, Exp) {
+  std::vector<float> in;
+  for (float x = -110.0f; x < 95.0f; x += 0.0137f) {
+    in.push_back(x);
+  }
+  for (float x : {0.0f, -0.0f, 1e-30f, -1e-30f, 88.72f, 88.73f, -87.33f, -103.9f}) {
+    in.push_back(x);
+  }
+  std::vector<float> out(in.size());
+  VectorExp(Span<float const>{in}, Span<float>{out});
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    auto expected = static_cast<float>(std::exp(static_cast<double>(in[i])));
+    if (std::isinf(expected)) {
+      ASSERT_TRUE(std::isinf(out[i])) << in[i];
+    } else {
+      ASSERT_LE(std::abs(OrderedBits(expected) - OrderedBits(out[i])), kVectorExpMaxUlp) << in[i];
+    }
+  }
+
+  // The result doesn't depend on the position of the element.
+  for (std::size_t n = 0; n < 40; ++n) {
+    std::vector<float> head(in.cbegin() + 7, in.cbegin() + 7 + n);
+    VectorExp(Span<float const>{head}, Span<float>{head});
+    for (std::size_t i = 0; i < n; ++i) {
+      ASSERT_EQ(head[i], out[7 + i]);
+    }
+  }
+
+  constexpr float kInf = std::numeric_limits<float>::infinity();
+  std::vector<float> special{kInf, -kInf, std::numeric_limits<float>::quiet_NaN()};
+  VectorExp(Span<float const>{special}, Span<float>{special});
+  ASSERT_EQ(special[0], kInf);
+  ASSERT_EQ(special[1], 0.0f);
+  ASSERT_TRUE(std::isnan(special[2]));
+}
+
+TEST(VectorMath, Sigmoid) {
+  std::vector<float> in;
+  for (float x = -100.0f; x < 100.0f; x += 0.031f) {
+    in.push_back(x);
+  }
+  std::vector<float> out(in.size());
+  VectorSigmoid(Span<float const>{in}, Span<float>{out});
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    auto expected = Sigmoid(in[i]);
+    ASSERT_NEAR(out[i], expected, std::abs(expected) * 1e-6f) << in[i];
+  }
+  std::vector<float> nan{std::numeric_limits<float>::quiet_NaN()};
+  VectorSigmoid(Span<float const>{nan}, Span<float>{nan});
+  ASSERT_TRUE(std::isnan(nan[0]));
+}
+}  // namespace xgboost::common
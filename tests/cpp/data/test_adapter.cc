@@ -1,5 +1,6 @@
 // Copyright (c) 2019-2021 by XGBoost Contributors
 #include <gtest/gtest.h>
+#include <numeric>
 #include <type_traits>
 #include <utility>
 #include <xgboost/data.h>
@@ -57,6 +58,78 @@ TEST(Adapter, CSRArrayAdapter) {
   ASSERT_EQ(adapter.NumColumns(), n_features);
 }
 
+namespace {
+template <typename BatchT>
+void CheckTypedBatch(BatchT const& batch) {
+  bool is_typed = false;
+  data::DispatchTypedBatch(batch, [&](auto const& typed) {
+    is_typed = !std::is_same_v<std::remove_cv_t<std::remove_reference_t<decltype(typed)>>, BatchT>;
+    ASSERT_EQ(typed.Size(), batch.Size());
+    ASSERT_EQ(typed.NumCols(), batch.NumCols());
+    for (std::size_t i = 0; i < batch.Size(); ++i) {
+      auto line = batch.GetLine(i);
+      auto typed_line = typed.GetLine(i);
+      ASSERT_EQ(line.Size(), typed_line.Size());
+      for (std::size_t j = 0; j < line.Size(); ++j) {
+        auto e = line.GetElement(j);
+        auto te = typed_line.GetElement(j);
+        ASSERT_EQ(e.row_idx, te.row_idx);
+        ASSERT_EQ(e.column_idx, te.column_idx);
+        ASSERT_EQ(e.value, te.value);
+      }
+    }
+  });
+  ASSERT_TRUE(is_typed);
+}
+}  // anonymous namespace
+
+TEST(Adapter, TypedArrayBatch) {
+  std::size_t n_samples = 7, n_features = 5;
+  std::vector<std::int32_t> data(n_samples * n_features);
+  std::iota(data.begin(), data.end(), -3);
+  Context ctx;
+  // Row-major
+  auto row_major = linalg::MakeTensorView(&ctx, common::Span{data}, n_samples, n_features);
+  auto arr = ArrayInterfaceStr(row_major);
+  CheckTypedBatch(data::ArrayAdapter{StringView{arr}}.Value());
+  // Column-major
+  std::size_t shape[2]{n_samples, n_features};
+  std::size_t strides[2]{1, n_samples};
+  auto col_major = linalg::TensorView<std::int32_t, 2>{common::Span{data}, shape, strides,
+                                                       DeviceOrd::CPU()};
+  arr = ArrayInterfaceStr(col_major);
+  CheckTypedBatch(data::ArrayAdapter{StringView{arr}}.Value());
+
+  // Columnar with the same data type.
+  std::vector<double> values(n_samples * n_features);
+  std::iota(values.begin(), values.end(), 0.5);
+  std::vector<Json> columns;
+  for (std::size_t f = 0; f < n_features; ++f) {
+    auto column = linalg::MakeVec(values.data() + f * n_samples, n_samples);
+    columns.emplace_back(linalg::ArrayInterface(column));
+  }
+  std::string str;
+  Json::Dump(Json{Array{columns}}, &str);
+  data::ColumnarAdapter adapter{StringView{str}};
+  CheckTypedBatch(adapter.Value());
+
+  // SparsePage built from the typed batch is the same as the one from the dense data.
+  std::vector<float> fdata(data.cbegin(), data.cend());
+  data::DenseAdapter dense{fdata.data(), n_samples, n_features};
+  SparsePage expected, page;
+  expected.Push(dense.Value(), std::numeric_limits<float>::quiet_NaN(), 2);
+  arr = ArrayInterfaceStr(row_major);
+  page.Push(data::ArrayAdapter{StringView{arr}}.Value(), std::numeric_limits<float>::quiet_NaN(),
+            2);
+  ASSERT_EQ(page.offset.ConstHostVector(), expected.offset.ConstHostVector());
+  auto const& h_data = page.data.ConstHostVector();
+  auto const& h_expected = expected.data.ConstHostVector();
+  ASSERT_EQ(h_data.size(), h_expected.size());
+  for (std::size_t i = 0; i < h_data.size(); ++i) {
+    ASSERT_EQ(h_data[i], h_expected[i]);
+  }
+}
+
 TEST(Adapter, CSCAdapterColsMoreThanRows) {
   std::vector<float> data = {1, 2, 3, 4, 5, 6, 7, 8};
   std::vector<unsigned> row_idx = {0, 1, 0, 1, 0, 1, 0, 1};
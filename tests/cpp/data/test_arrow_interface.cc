@@ -0,0 +1,120 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+#include <xgboost/data.h>
+
+#include <array>    // for array
+#include <cmath>    // for isnan
+#include <cstdint>  // for int32_t, uint8_t
+#include <limits>   // for numeric_limits
+#include <memory>   // for shared_ptr
+#include <vector>   // for vector
+
+#include "../../../src/data/adapter.h"          // for ColumnarAdapter
+#include "../../../src/data/arrow_interface.h"  // for ArrowColumns
+
+namespace xgboost::data {
+namespace {
+void NoRelease(ArrowArray*) {}
+void NoRelease(ArrowSchema*) {}
+
+ArrowSchema MakeSchema(char const* format) {
+  ArrowSchema schema{};
+  schema.format = format;
+  schema.release = NoRelease;
+  return schema;
+}
+
+ArrowArray MakeArray(std::int64_t length, std::int64_t offset, std::int64_t null_count,
+                     void const** buffers) {
+  ArrowArray array{};
+  array.length = length;
+  array.offset = offset;
+  array.null_count = null_count;
+  array.n_buffers = 2;
+  array.buffers = buffers;
+  array.release = NoRelease;
+  return array;
+}
+}  // anonymous namespace
+
+TEST(ArrowInterface, RecordBatch) {
+  std::size_t constexpr kRows = 12;
+  // An int32 column with nulls and an offset of 3.
+  std::vector<std::int32_t> i32(kRows + 3);
+  for (std::size_t i = 0; i < i32.size(); ++i) {
+    i32[i] = static_cast<std::int32_t>(i);
+  }
+  // Every third value (after the offset) is null.
+  std::array<std::uint8_t, 2> i32_valid{};
+  for (std::size_t i = 0; i < kRows; ++i) {
+    if (i % 3 != 0) {
+      i32_valid[(i + 3) / 8] |= 1 << ((i + 3) % 8);
+    }
+  }
+  void const* i32_buffers[] = {i32_valid.data(), i32.data()};
+  // A boolean column without nulls.
+  std::array<std::uint8_t, 2> bools{0b01010101, 0b00000101};
+  void const* bool_buffers[] = {nullptr, bools.data()};
+  // A dictionary-encoded column, only the indices are used.
+  std::vector<std::uint8_t> codes(kRows);
+  for (std::size_t i = 0; i < kRows; ++i) {
+    codes[i] = i % 4;
+  }
+  void const* code_buffers[] = {nullptr, codes.data()};
+
+  std::array<ArrowArray, 3> children{MakeArray(kRows, 3, kRows / 3, i32_buffers),
+                                     MakeArray(kRows, 0, 0, bool_buffers),
+                                     MakeArray(kRows, 0, 0, code_buffers)};
+  std::array<ArrowSchema, 3> child_schemas{MakeSchema("i"), MakeSchema("b"), MakeSchema("C")};
+  ArrowSchema dict = MakeSchema("u");
+  child_schemas[2].dictionary = &dict;
+
+  std::array<ArrowArray*, 3> p_children{&children[0], &children[1], &children[2]};
+  std::array<ArrowSchema*, 3> p_child_schemas{&child_schemas[0], &child_schemas[1],
+                                              &child_schemas[2]};
+  void const* struct_buffers[] = {nullptr};
+  ArrowArray array = MakeArray(kRows, 0, 0, struct_buffers);
+  array.n_buffers = 1;
+  array.n_children = 3;
+  array.children = p_children.data();
+  ArrowSchema schema = MakeSchema("+s");
+  schema.n_children = 3;
+  schema.children = p_child_schemas.data();
+
+  ColumnarAdapter adapter{ArrowColumns{&array, &schema}};
+  ASSERT_EQ(adapter.NumRows(), kRows);
+  ASSERT_EQ(adapter.NumColumns(), 3);
+  std::shared_ptr<DMatrix> p_fmat{
+      DMatrix::Create(&adapter, std::numeric_limits<float>::quiet_NaN(), 1)};
+  ASSERT_EQ(p_fmat->Info().num_row_, kRows);
+  ASSERT_EQ(p_fmat->Info().num_col_, 3);
+
+  std::vector<float> dense(kRows * 3, std::numeric_limits<float>::quiet_NaN());
+  for (auto const& page : p_fmat->GetBatches<SparsePage>()) {
+    auto h_page = page.GetView();
+    for (std::size_t i = 0; i < h_page.Size(); ++i) {
+      for (auto const& e : h_page[i]) {
+        dense[i * 3 + e.index] = e.fvalue;
+      }
+    }
+  }
+  for (std::size_t i = 0; i < kRows; ++i) {
+    if (i % 3 == 0) {
+      ASSERT_TRUE(std::isnan(dense[i * 3]));
+    } else {
+      ASSERT_EQ(dense[i * 3], static_cast<float>(i + 3));
+    }
+    ASSERT_EQ(dense[i * 3 + 1], static_cast<float>((i % 2) == 0 && i < 11));
+    ASSERT_EQ(dense[i * 3 + 2], static_cast<float>(i % 4));
+  }
+}
+
+TEST(ArrowInterface, Unsupported) {
+  ArrowSchema schema = MakeSchema("i");
+  ArrowArray array{};
+  array.release = NoRelease;
+  ASSERT_THROW({ ArrowColumns columns(&array, &schema); }, dmlc::Error);
+}
+}  // namespace xgboost::data
@@ -0,0 +1,139 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+#include <xgboost/learner.h>  // for Learner
+
+#include <limits>  // for numeric_limits
+#include <memory>  // for make_shared, shared_ptr
+#include <vector>  // for vector
+
+#include "../../../src/data/adapter.h"           // for ArrayAdapter
+#include "../../../src/data/borrowed_dmatrix.h"  // for BorrowedDMatrix
+#include "../../../src/data/gradient_index.h"    // for GHistIndexMatrix
+#include "../helpers.h"
+
+namespace xgboost::data {
+namespace {
+auto constexpr kNaN = std::numeric_limits<float>::quiet_NaN();
+
+void CheckEqual(DMatrix* borrowed, DMatrix* simple) {
+  ASSERT_EQ(borrowed->Info().num_row_, simple->Info().num_row_);
+  ASSERT_EQ(borrowed->Info().num_col_, simple->Info().num_col_);
+  ASSERT_EQ(borrowed->Info().num_nonzero_, simple->Info().num_nonzero_);
+
+  Context ctx;
+  BatchParam param{64, 0.2};
+  for (auto const& page : borrowed->GetBatches<GHistIndexMatrix>(&ctx, param)) {
+    for (auto const& expected : simple->GetBatches<GHistIndexMatrix>(&ctx, param)) {
+      ASSERT_EQ(page.cut.Ptrs(), expected.cut.Ptrs());
+      ASSERT_EQ(page.cut.Values(), expected.cut.Values());
+      ASSERT_EQ(page.Size(), expected.Size());
+      for (bst_idx_t i = 0; i < page.Size() + 1; ++i) {
+        ASSERT_EQ(page.row_ptr[i], expected.row_ptr[i]);
+      }
+      for (std::size_t i = 0; i < page.index.Size(); ++i) {
+        ASSERT_EQ(page.index[i], expected.index[i]);
+      }
+    }
+  }
+  // The data is not copied for the gradient index.
+  ASSERT_FALSE(borrowed->PageExists<SparsePage>());
+
+  for (auto const& page : borrowed->GetBatches<SparsePage>()) {
+    for (auto const& expected : simple->GetBatches<SparsePage>()) {
+      ASSERT_EQ(page.offset.ConstHostVector(), expected.offset.ConstHostVector());
+      auto const& h_data = page.data.ConstHostVector();
+      auto const& h_expected = expected.data.ConstHostVector();
+      ASSERT_EQ(h_data.size(), h_expected.size());
+      for (std::size_t i = 0; i < h_data.size(); ++i) {
+        ASSERT_EQ(h_data[i].index, h_expected[i].index);
+        ASSERT_EQ(h_data[i].fvalue, h_expected[i].fvalue);
+      }
+    }
+  }
+  ASSERT_TRUE(borrowed->PageExists<SparsePage>());
+}
+}  // anonymous namespace
+
+TEST(BorrowedDMatrix, Dense) {
+  bst_idx_t n_samples = 256;
+  bst_feature_t n_features = 8;
+  for (auto sparsity : {0.0f, 0.4f}) {
+    HostDeviceVector<float> storage;
+    auto arr =
+        RandomDataGenerator{n_samples, n_features, sparsity}.GenerateArrayInterface(&storage);
+    auto proxy = std::make_shared<DMatrixProxy>();
+    proxy->SetArrayData(StringView{arr});
+    BorrowedDMatrix borrowed{proxy, kNaN, 0};
+    ASSERT_EQ(borrowed.IsDense(), sparsity == 0.0f);
+
+    ArrayAdapter adapter{StringView{arr}};
+    std::unique_ptr<DMatrix> simple{DMatrix::Create(&adapter, kNaN, 0)};
+    CheckEqual(&borrowed, simple.get());
+  }
+}
+
+TEST(BorrowedDMatrix, CSR) {
+  bst_idx_t n_samples = 256;
+  bst_feature_t n_features = 8;
+  HostDeviceVector<float> values;
+  HostDeviceVector<std::size_t> indptr;
+  HostDeviceVector<bst_feature_t> indices;
+  RandomDataGenerator{n_samples, n_features, 0.6}.GenerateCSR(&values, &indptr, &indices);
+  auto vec_interface = [](auto const& storage) {
+    auto arr = GetArrayInterface(&storage, storage.Size(), 1);
+    arr["shape"] = Array{std::vector<Json>{Json{static_cast<Integer::Int>(storage.Size())}}};
+    return Json::Dump(arr);
+  };
+  auto str_indptr = vec_interface(indptr);
+  auto str_indices = vec_interface(indices);
+  auto str_values = vec_interface(values);
+
+  auto proxy = std::make_shared<DMatrixProxy>();
+  proxy->SetCSRData(str_indptr.c_str(), str_indices.c_str(), str_values.c_str(), n_features,
+                    true);
+  BorrowedDMatrix borrowed{proxy, kNaN, 0};
+
+  CSRArrayAdapter adapter{StringView{str_indptr}, StringView{str_indices}, StringView{str_values},
+                          n_features};
+  std::unique_ptr<DMatrix> simple{DMatrix::Create(&adapter, kNaN, 0)};
+  CheckEqual(&borrowed, simple.get());
+}
+
+TEST(BorrowedDMatrix, Train) {
+  bst_idx_t n_samples = 512;
+  bst_feature_t n_features = 8;
+  HostDeviceVector<float> storage;
+  auto arr = RandomDataGenerator{n_samples, n_features, 0.2}.GenerateArrayInterface(&storage);
+  auto proxy = std::make_shared<DMatrixProxy>();
+  proxy->SetArrayData(StringView{arr});
+  std::shared_ptr<DMatrix> borrowed{new BorrowedDMatrix{proxy, kNaN, 0}};
+
+  ArrayAdapter adapter{StringView{arr}};
+  std::shared_ptr<DMatrix> simple{DMatrix::Create(&adapter, kNaN, 0)};
+
+  HostDeviceVector<float> label_storage;
+  auto labels = RandomDataGenerator{n_samples, 1, 0.0}.GenerateArrayInterface(&label_storage);
+  borrowed->SetInfo("label", labels);
+  simple->SetInfo("label", labels);
+
+  auto train = [](std::shared_ptr<DMatrix> p_fmat) {
+    std::unique_ptr<Learner> learner{Learner::Create({p_fmat})};
+    learner->SetParams(Args{{"tree_method", "hist"}, {"max_bin", "32"}});
+    for (std::int32_t i = 0; i < 4; ++i) {
+      learner->UpdateOneIter(i, p_fmat);
+    }
+    HostDeviceVector<float> predt;
+    learner->Predict(p_fmat, false, &predt, 0, 0);
+    return std::vector<float>{predt.ConstHostVector()};
+  };
+  auto predt = train(borrowed);
+  auto expected = train(simple);
+  ASSERT_EQ(predt.size(), expected.size());
+  for (std::size_t i = 0; i < predt.size(); ++i) {
+    ASSERT_NEAR(predt[i], expected[i], kRtEps);
+  }
+  ASSERT_FALSE(borrowed->PageExists<SparsePage>());
+}
+}  // namespace xgboost::data
@@ -156,5 +156,99 @@ TEST_P(TestEllpackPageRawFormat, HostIO) {
   }
 }
 
+TEST(EllpackPageRawFormat, HostCompact) {
+  auto ctx = MakeCUDACtx(0);
+  auto param = BatchParam{32, tree::TrainParam::DftSparseThreshold()};
+  // Most of the Ellpack page is padding.
+  auto p_fmat = RandomDataGenerator{256, 64, 0.9}.GenerateDMatrix();
+
+  std::shared_ptr<common::HistogramCuts const> cuts;
+  for (auto const &page : p_fmat->GetBatches<EllpackPage>(&ctx, param)) {
+    cuts = page.Impl()->CutsShared();
+  }
+  auto row_stride = GetRowStride(p_fmat.get());
+  EllpackCacheStreamPolicy<EllpackPage, EllpackFormatPolicy> policy;
+  auto cinfo = CInfoForTest(&ctx, p_fmat.get(), row_stride, param, cuts);
+  cinfo.direct_access = false;
+  policy.SetCuts(cuts, ctx.Device(), std::move(cinfo));
+  std::unique_ptr<EllpackPageRawFormat> format{policy.CreatePageFormat(param)};
+
+  std::size_t n_bytes{0};
+  auto fo = policy.CreateWriter({}, 0);
+  for (auto const &page : p_fmat->GetBatches<EllpackPage>(&ctx, param)) {
+    n_bytes += format->Write(page, fo.get());
+    ASSERT_EQ(n_bytes, page.Impl()->MemCostBytes());
+  }
+  auto cache = fo->Share();
+  ASSERT_EQ(cache->pages.size(), 1);
+  ASSERT_TRUE(cache->compact.front());
+  ASSERT_EQ(cache->SizeBytes(), n_bytes);
+  ASSERT_LT(cache->pages.front()->MemCostBytes(), n_bytes);
+
+  EllpackPage page;
+  auto fi = policy.CreateReader({}, static_cast<bst_idx_t>(0), n_bytes);
+  ASSERT_TRUE(format->Read(&page, fi.get()));
+  ASSERT_EQ(page.Impl()->MemCostBytes(), n_bytes);
+  for (auto const &orig : p_fmat->GetBatches<EllpackPage>(&ctx, param)) {
+    std::vector<common::CompressedByteT> h_orig, h_page;
+    auto h_acc_orig = orig.Impl()->GetHostAccessor(&ctx, &h_orig, {});
+    auto h_acc = page.Impl()->GetHostAccessor(&ctx, &h_page, {});
+    ASSERT_EQ(h_orig, h_page);
+    ASSERT_EQ(h_acc_orig.row_stride, h_acc.row_stride);
+    ASSERT_EQ(h_acc_orig.NullValue(), h_acc.NullValue());
+  }
+}
+
+#if defined(__linux__)
+TEST(EllpackPageRawFormat, HostHotPage) {
+  auto ctx = MakeCUDACtx(0);
+  auto param = BatchParam{32, tree::TrainParam::DftSparseThreshold()};
+  param.prefetch_copy = false;
+  auto p_fmat = RandomDataGenerator{256, 64, 0.9}.GenerateDMatrix();
+
+  std::shared_ptr<common::HistogramCuts const> cuts;
+  for (auto const &page : p_fmat->GetBatches<EllpackPage>(&ctx, param)) {
+    cuts = page.Impl()->CutsShared();
+  }
+  auto row_stride = GetRowStride(p_fmat.get());
+  EllpackCacheStreamPolicy<EllpackPage, EllpackFormatPolicy> policy;
+  auto cinfo = CInfoForTest(&ctx, p_fmat.get(), row_stride, param, cuts);
+  cinfo.direct_access = true;
+  policy.SetCuts(cuts, ctx.Device(), std::move(cinfo));
+  std::unique_ptr<EllpackPageRawFormat> format{policy.CreatePageFormat(param)};
+
+  std::size_t n_bytes{0};
+  {
+    auto fo = policy.CreateWriter({}, 0);
+    for (auto const &page : p_fmat->GetBatches<EllpackPage>(&ctx, param)) {
+      n_bytes += format->Write(page, fo.get());
+    }
+    // Stored as it is for direct access.
+    ASSERT_FALSE(fo->Share()->compact.front());
+    ASSERT_EQ(fo->Share()->NumDevicePages(), 0);
+  }
+
+  std::vector<common::CompressedByteT> h_orig;
+  for (auto const &orig : p_fmat->GetBatches<EllpackPage>(&ctx, param)) {
+    [[maybe_unused]] auto h_acc = orig.Impl()->GetHostAccessor(&ctx, &h_orig, {});
+  }
+  // The first read is not copied if the device can access the host memory.
+  auto first = curt::SupportsPageableMem() ? common::ResourceHandler::kCudaHostCache
+                                           : common::ResourceHandler::kCudaMalloc;
+  for (auto type : {first, common::ResourceHandler::kCudaGrowOnly,
+                    common::ResourceHandler::kCudaGrowOnly}) {
+    EllpackPage page;
+    auto fi = policy.CreateReader({}, static_cast<bst_idx_t>(0), n_bytes);
+    ASSERT_TRUE(format->Read(&page, fi.get()));
+    ASSERT_EQ(page.Impl()->gidx_buffer.Resource()->Type(), type);
+    ASSERT_EQ(fi->Share()->NumDevicePages(),
+              static_cast<std::int64_t>(type == common::ResourceHandler::kCudaGrowOnly));
+    std::vector<common::CompressedByteT> h_page;
+    [[maybe_unused]] auto h_acc = page.Impl()->GetHostAccessor(&ctx, &h_page, {});
+    ASSERT_EQ(h_orig, h_page);
+  }
+}
+#endif  // defined(__linux__)
+
 INSTANTIATE_TEST_SUITE_P(EllpackPageRawFormat, TestEllpackPageRawFormat, ::testing::Bool());
 }  // namespace xgboost::data
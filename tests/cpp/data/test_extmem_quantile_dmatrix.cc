@@ -7,17 +7,27 @@
 #include <xgboost/data.h>  // for BatchParam
 
 #include <algorithm>  // for equal
+#include <cstdint>    // for int64_t, uint8_t
+#include <limits>     // for numeric_limits
+#include <memory>     // for shared_ptr
+#include <string>     // for string
+#include <vector>     // for vector
 
-#include "../../../src/common/column_matrix.h"  // for ColumnMatrix
-#include "../../../src/data/gradient_index.h"   // for GHistIndexMatrix
-#include "../../../src/tree/param.h"            // for TrainParam
+#include "../../../src/common/column_matrix.h"              // for ColumnMatrix
+#include "../../../src/data/batch_utils.h"                  // for MatchingPageBytes
+#include "../../../src/data/gradient_index.h"               // for GHistIndexMatrix
+#include "../../../src/data/gradient_index_format.h"        // for GHistIndexRawFormat
+#include "../../../src/data/gradient_index_page_source.h"   // for GHistIndexHostStreamPolicy
+#include "../../../src/tree/param.h"                        // for TrainParam
+#include "../filesystem.h"                                  // for TemporaryDirectory
 
 namespace xgboost::data {
 namespace {
 class ExtMemQuantileDMatrixCpu : public ::testing::TestWithParam<float> {
  public:
   void Run(float sparsity) {
-    auto equal = [](Context const*, GHistIndexMatrix const& orig, GHistIndexMatrix const& sparse) {
+    auto equal = [](Context const* ctx, GHistIndexMatrix const& orig,
+                    GHistIndexMatrix const& sparse) {
       // Check the CSR matrix
       auto orig_cuts = orig.Cuts();
       auto sparse_cuts = sparse.Cuts();
@@ -33,8 +43,8 @@ class ExtMemQuantileDMatrixCpu : public ::testing::TestWithParam<float> {
       ASSERT_TRUE(equal);
 
       // Check the column matrix
-      common::ColumnMatrix const& orig_columns = orig.Transpose();
-      common::ColumnMatrix const& sparse_columns = sparse.Transpose();
+      common::ColumnMatrix const& orig_columns = orig.Transpose(ctx);
+      common::ColumnMatrix const& sparse_columns = sparse.Transpose(ctx);
 
       std::string str_orig, str_sparse;
       common::AlignedMemWriteStream fo_orig{&str_orig}, fo_sparse{&str_sparse};
@@ -58,4 +68,87 @@ INSTANTIATE_TEST_SUITE_P(ExtMemQuantileDMatrix, ExtMemQuantileDMatrixCpu, ::test
                                0.0f, tree::TrainParam::DftSparseThreshold(), 0.4f, 0.8f};
                            return sparsities;
                          }()));
+
+TEST(GHistIndexHostStreamPolicy, Spill) {
+  dmlc::TemporaryDirectory tmpdir;
+  auto path = tmpdir.path + "/cache.gradient_index.page";
+  std::vector<std::string> pages{std::string(64, 'a'), std::string(128, 'b'),
+                                 std::string(32, 'c')};
+  // The first and the last pages fit in the budget.
+  GHistIndexHostStreamPolicy<GHistIndexMatrix, GHistIndexFormatPolicy> policy;
+  policy.SetHostCache(128);
+  std::vector<bst_idx_t> offsets{0};
+  for (std::uint32_t i = 0; i < pages.size(); ++i) {
+    auto fo = policy.CreateWriter(StringView{path}, i);
+    offsets.push_back(offsets.back() + fo->Write(pages[i].data(), pages[i].size()));
+  }
+  auto cache = policy.HostCache();
+  ASSERT_EQ(cache->NumSpilled(), 1);
+  ASSERT_FALSE(cache->pages[1]);
+  ASSERT_EQ(cache->host_bytes, 96);
+  ASSERT_TRUE(FileExists(path));
+
+  for (std::size_t i = 0; i < pages.size(); ++i) {
+    auto fi = policy.CreateReader(StringView{path}, offsets[i], offsets[i + 1] - offsets[i]);
+    auto [ptr, n_bytes] = fi->Consume(pages[i].size());
+    ASSERT_EQ(n_bytes, pages[i].size());
+    ASSERT_EQ(std::string(reinterpret_cast<char const*>(ptr), n_bytes), pages[i]);
+  }
+  cache.reset();
+  // The spill file is removed with the cache.
+  policy.SetHostCache(0);
+  ASSERT_FALSE(FileExists(path));
+}
+
+TEST(ExtMemQuantileDMatrix, HostCache) {
+  dmlc::TemporaryDirectory tmpdir;
+  Context ctx;
+  BatchParam p{64, tree::TrainParam::DftSparseThreshold()};
+  auto make = [&](bool on_host, std::int64_t max_host_cache_bytes) {
+    NumpyArrayIterForTest iter{0.2f, 256, 16, 4};
+    auto config = ExtMemConfig{tmpdir.path + "/cache",
+                               on_host,
+                               ::xgboost::cuda_impl::MatchingPageBytes(),
+                               std::numeric_limits<float>::quiet_NaN(),
+                               ::xgboost::cuda_impl::MaxNumDevicePages(),
+                               ctx.Threads()};
+    config.max_host_cache_bytes = max_host_cache_bytes;
+    return std::shared_ptr<DMatrix>{DMatrix::Create(
+        static_cast<DataIterHandle>(&iter), iter.Proxy(), nullptr, Reset, Next, p.max_bin,
+        std::numeric_limits<std::int64_t>::max(), config)};
+  };
+  auto collect = [&](std::shared_ptr<DMatrix> p_fmat) {
+    std::vector<std::vector<std::uint8_t>> data;
+    for (auto const& page : p_fmat->GetBatches<GHistIndexMatrix>(&ctx, p)) {
+      data.emplace_back(page.data.cbegin(), page.data.cend());
+    }
+    return data;
+  };
+  auto spill_file = [](std::shared_ptr<DMatrix> const& p_fmat, std::string const& prefix) {
+    return MakeId(prefix, p_fmat.get()) + ".gradient_index.page";
+  };
+
+  auto on_disk = make(false, std::numeric_limits<std::int64_t>::max());
+  auto expected = collect(on_disk);
+  ASSERT_TRUE(FileExists(spill_file(on_disk, tmpdir.path + "/cache")));
+
+  auto in_memory = make(true, std::numeric_limits<std::int64_t>::max());
+  ASSERT_FALSE(FileExists(spill_file(in_memory, tmpdir.path + "/cache")));
+  ASSERT_EQ(collect(in_memory), expected);
+
+  // Only the first page fits in the budget.
+  std::size_t page_bytes = 0;
+  for (auto const& page : in_memory->GetBatches<GHistIndexMatrix>(&ctx, p)) {
+    std::string buf;
+    common::AlignedMemWriteStream fo{&buf};
+    page_bytes = GHistIndexRawFormat{page.Cuts()}.Write(page, &fo);
+    break;
+  }
+  auto partial = make(true, page_bytes + page_bytes / 2);
+  auto path = spill_file(partial, tmpdir.path + "/cache");
+  ASSERT_TRUE(FileExists(path));
+  ASSERT_EQ(collect(partial), expected);
+  partial.reset();
+  ASSERT_FALSE(FileExists(path));
+}
 }  // namespace xgboost::data
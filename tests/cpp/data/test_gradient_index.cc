@@ -156,6 +156,42 @@ TEST(GradientIndex, PushBatch) {
   test(0.9f);
 }
 
+TEST(GradientIndex, DeferColumns) {
+  bst_idx_t n_samples{128};
+  bst_feature_t n_features{13};
+  bst_bin_t n_bins{16};
+  Context ctx;
+  auto p = BatchParam{n_bins, tree::TrainParam::DftSparseThreshold()};
+
+  auto serialize = [](common::ColumnMatrix const &columns) {
+    std::string buf;
+    common::AlignedMemWriteStream fo{&buf};
+    auto n_bytes = columns.Write(&fo);
+    EXPECT_EQ(fo.Tell(), n_bytes);
+    return buf;
+  };
+
+  for (float sparsity : {0.0f, 0.4f}) {
+    auto p_fmat = RandomDataGenerator{n_samples, n_features, sparsity}.GenerateDMatrix();
+    auto const &page = *p_fmat->GetBatches<SparsePage>().begin();
+    for (auto const &gidx : p_fmat->GetBatches<GHistIndexMatrix>(&ctx, p)) {
+      // Built from the sparse page during construction.
+      GHistIndexMatrix expected{page,           {}, gidx.cut, n_bins, p_fmat->IsDense(),
+                                p.sparse_thresh, ctx.Threads()};
+      // The dense gradient index is used by the partitioner directly.
+      auto const &columns = gidx.Transpose(&ctx);
+      ASSERT_EQ(columns.IsInitialized(), sparsity != 0.0f);
+      ASSERT_EQ(expected.Transpose(&ctx).IsInitialized(), columns.IsInitialized());
+      if (!columns.IsInitialized()) {
+        continue;
+      }
+      // Built from the gradient index on the first call.
+      ASSERT_EQ(serialize(columns), serialize(expected.Transpose(&ctx)));
+      ASSERT_EQ(&columns, &gidx.Transpose(&ctx));
+    }
+  }
+}
+
 #if defined(XGBOOST_USE_CUDA)
 
 namespace {
@@ -191,12 +227,13 @@ class GHistIndexMatrixTest : public testing::TestWithParam<std::tuple<float, flo
         ASSERT_EQ(gidx_from_sparse[i], gidx_from_ellpack[i]);
       }
 
-      auto const &columns_from_sparse = from_sparse_page.Transpose();
-      auto const &columns_from_ellpack = from_ellpack->Transpose();
+      auto const &columns_from_sparse = from_sparse_page.Transpose(&ctx);
+      auto const &columns_from_ellpack = from_ellpack->Transpose(&ctx);
       ASSERT_EQ(columns_from_sparse.AnyMissing(), columns_from_ellpack.AnyMissing());
       ASSERT_EQ(columns_from_sparse.GetTypeSize(), columns_from_ellpack.GetTypeSize());
       ASSERT_EQ(columns_from_sparse.GetNumFeature(), columns_from_ellpack.GetNumFeature());
-      for (size_t i = 0; i < n_features; ++i) {
+      ASSERT_EQ(columns_from_sparse.IsInitialized(), columns_from_ellpack.IsInitialized());
+      for (size_t i = 0; i < columns_from_sparse.GetNumFeature(); ++i) {
         ASSERT_EQ(columns_from_sparse.GetColumnType(i), columns_from_ellpack.GetColumnType(i));
       }
 
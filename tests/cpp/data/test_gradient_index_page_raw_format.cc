@@ -56,7 +56,46 @@ TEST(GHistIndexPageRawFormat, IO) {
     ASSERT_TRUE(std::equal(loaded.index.Offset(), loaded.index.Offset() + loaded.index.OffsetSize(),
                            page.index.Offset()));
 
-    ASSERT_EQ(loaded.Transpose().GetTypeSize(), loaded.Transpose().GetTypeSize());
+    ASSERT_EQ(loaded.Transpose(&ctx).GetTypeSize(), loaded.Transpose(&ctx).GetTypeSize());
+  }
+}
+
+TEST(GHistIndexPageRawFormat, BitPacked) {
+  Context ctx;
+  // Dense data with few bins, each bin index takes 3 bits instead of 8 bits.
+  bst_idx_t constexpr kRows = 256;
+  bst_feature_t constexpr kCols = 16;
+  auto m = RandomDataGenerator{kRows, kCols, 0.0}.GenerateDMatrix();
+  dmlc::TemporaryDirectory tmpdir;
+  std::string path = tmpdir.path + "/ghistindex.page";
+  auto batch = BatchParam{8, 0.5};
+
+  common::HistogramCuts cuts;
+  for (auto const &index : m->GetBatches<GHistIndexMatrix>(&ctx, batch)) {
+    cuts = index.Cuts();
+  }
+  auto format = std::make_unique<GHistIndexRawFormat>(std::move(cuts));
+
+  std::size_t bytes{0};
+  {
+    auto fo = std::make_unique<common::AlignedFileWriteStream>(StringView{path}, "wb");
+    for (auto const &index : m->GetBatches<GHistIndexMatrix>(&ctx, batch)) {
+      ASSERT_EQ(index.index.GetBinTypeSize(), common::kUint8BinsTypeSize);
+      bytes += format->Write(index, fo.get());
+    }
+  }
+
+  GHistIndexMatrix page;
+  std::unique_ptr<common::AlignedResourceReadStream> fi{
+      std::make_unique<common::PrivateMmapConstStream>(path, 0, bytes)};
+  ASSERT_TRUE(format->Read(&page, fi.get()));
+  for (auto const &loaded : m->GetBatches<GHistIndexMatrix>(&ctx, batch)) {
+    ASSERT_TRUE(page.IsDense());
+    ASSERT_EQ(loaded.index.GetBinTypeSize(), page.index.GetBinTypeSize());
+    ASSERT_EQ(loaded.index.Size(), page.index.Size());
+    for (std::size_t i = 0; i < loaded.index.Size(); ++i) {
+      ASSERT_EQ(loaded.index[i], page.index[i]);
+    }
   }
 }
 }  // namespace xgboost::data
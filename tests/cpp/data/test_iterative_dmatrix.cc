@@ -10,6 +10,7 @@
 
 #include "../../../src/data/gradient_index.h"
 #include "../../../src/data/iterative_dmatrix.h"
+#include "../../../src/tree/param.h"  // for TrainParam
 #include "../helpers.h"
 #include "xgboost/data.h"  // DMatrix
 
@@ -39,4 +40,53 @@ TEST(IterativeDMatrix, IsDense) {
   test(0.1);
   test(1.0);
 }
+
+TEST(IterativeDMatrix, SinglePass) {
+  bst_bin_t n_bins = 16;
+  auto n_threads = 0;
+  auto constexpr kNaN = std::numeric_limits<float>::quiet_NaN();
+  auto constexpr kMaxBlocks = std::numeric_limits<std::int64_t>::max();
+  for (auto sparsity : {0.0f, 0.4f}) {
+    NumpyArrayIterForTest iter(sparsity);
+    auto multi = std::make_shared<IterativeDMatrix>(&iter, iter.Proxy(), nullptr, Reset, Next,
+                                                    kNaN, n_threads, n_bins, kMaxBlocks);
+    IterativeDMatrix single(&iter, iter.Proxy(), nullptr, Reset, Next, kNaN, n_threads, n_bins,
+                            kMaxBlocks, true);
+    // Use the cuts from the multi-pass matrix to compare the quantised data.
+    IterativeDMatrix single_ref(&iter, iter.Proxy(), multi, Reset, Next, kNaN, n_threads, n_bins,
+                                kMaxBlocks, true);
+
+    for (auto const* m : {&single, &single_ref}) {
+      ASSERT_EQ(m->Info().num_row_, multi->Info().num_row_);
+      ASSERT_EQ(m->Info().num_col_, multi->Info().num_col_);
+      ASSERT_EQ(m->Info().num_nonzero_, multi->Info().num_nonzero_);
+      ASSERT_EQ(m->IsDense(), multi->IsDense());
+    }
+
+    Context ctx;
+    BatchParam param{n_bins, tree::TrainParam::DftSparseThreshold()};
+    for (auto const& page : single_ref.GetBatches<GHistIndexMatrix>(&ctx, param)) {
+      for (auto const& expected : multi->GetBatches<GHistIndexMatrix>(&ctx, param)) {
+        ASSERT_EQ(page.cut.Ptrs(), expected.cut.Ptrs());
+        ASSERT_EQ(page.cut.Values(), expected.cut.Values());
+        ASSERT_EQ(page.Size(), expected.Size());
+        for (bst_idx_t i = 0; i < page.Size() + 1; ++i) {
+          ASSERT_EQ(page.row_ptr[i], expected.row_ptr[i]);
+        }
+        ASSERT_EQ(page.index.Size(), expected.index.Size());
+        for (std::size_t i = 0; i < page.index.Size(); ++i) {
+          ASSERT_EQ(page.index[i], expected.index[i]);
+        }
+      }
+    }
+    for (auto const& page : single.GetBatches<GHistIndexMatrix>(&ctx, param)) {
+      ASSERT_EQ(page.cut.Ptrs().size(), single.Info().num_col_ + 1);
+      for (auto const& expected : multi->GetBatches<GHistIndexMatrix>(&ctx, param)) {
+        for (bst_idx_t i = 0; i < page.Size() + 1; ++i) {
+          ASSERT_EQ(page.row_ptr[i], expected.row_ptr[i]);
+        }
+      }
+    }
+  }
+}
 }  // namespace xgboost::data
@@ -0,0 +1,94 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+
+#include <cstddef>  // for size_t
+#include <fstream>  // for ofstream
+#include <sstream>  // for stringstream
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "../../../src/data/libsvm_parser.h"
+#include "../filesystem.h"  // for TemporaryDirectory
+
+namespace xgboost::data {
+TEST(LibSVMParser, Basic) {
+  std::string text{"1:0.5 qid:2 0:1.5 3:-2e3\n\n0:1 qid:2\t1:4\r\n"};
+  LibSVMBlock out;
+  ASSERT_TRUE(ParseLibSVM(StringView{text}, false, 1, &out));
+  ASSERT_EQ(out.Size(), 2);
+  ASSERT_EQ(out.offset, (std::vector<std::size_t>{0, 2, 3}));
+  ASSERT_EQ(out.label, (std::vector<float>{1.0f, 0.0f}));
+  ASSERT_EQ(out.weight, (std::vector<float>{0.5f, 1.0f}));
+  ASSERT_EQ(out.qid, (std::vector<std::uint64_t>{2, 2}));
+  ASSERT_EQ(out.index, (std::vector<std::uint32_t>{0, 3, 1}));
+  ASSERT_EQ(out.value, (std::vector<float>{1.5f, -2e3f, 4.0f}));
+
+  // One-based
+  text = "+1 1:2\n-1 2:3";
+  out = LibSVMBlock{};
+  ASSERT_TRUE(ParseLibSVM(StringView{text}, true, 1, &out));
+  ASSERT_EQ(out.label, (std::vector<float>{1.0f, -1.0f}));
+  ASSERT_TRUE(out.weight.empty());
+  ASSERT_TRUE(out.qid.empty());
+  ASSERT_EQ(out.index, (std::vector<std::uint32_t>{0, 1}));
+  out = LibSVMBlock{};
+  ASSERT_FALSE(ParseLibSVM(StringView{"1 0:2"}, true, 1, &out));
+}
+
+TEST(LibSVMParser, Unsupported) {
+  for (auto text : {"1 0:1 # comment", "1 0:1 2", "1:2 0:1\n1 0:1", "1 0:1 qid:3", "a 0:1"}) {
+    LibSVMBlock out;
+    ASSERT_FALSE(ParseLibSVM(StringView{text}, false, 1, &out)) << text;
+  }
+}
+
+TEST(LibSVMParser, Threads) {
+  std::stringstream ss;
+  std::size_t constexpr kRows = 1 << 16;
+  for (std::size_t i = 0; i < kRows; ++i) {
+    ss << (i % 2) << ":" << (i % 7) << " qid:" << i / 16;
+    for (std::size_t j = 0; j < i % 11; ++j) {
+      ss << " " << j * 3 << ":" << static_cast<float>(i) / (j + 1);
+    }
+    ss << "\n";
+  }
+  auto text = ss.str();
+  LibSVMBlock expected, got;
+  ASSERT_TRUE(ParseLibSVM(StringView{text}, false, 1, &expected));
+  ASSERT_TRUE(ParseLibSVM(StringView{text}, false, 8, &got));
+  ASSERT_EQ(expected.Size(), kRows);
+  ASSERT_EQ(expected.offset, got.offset);
+  ASSERT_EQ(expected.label, got.label);
+  ASSERT_EQ(expected.weight, got.weight);
+  ASSERT_EQ(expected.qid, got.qid);
+  ASSERT_EQ(expected.index, got.index);
+  ASSERT_EQ(expected.value, got.value);
+}
+
+TEST(LibSVMParser, CreateParser) {
+  dmlc::TemporaryDirectory tempdir;
+  auto path = tempdir.path + "/test.libsvm";
+  {
+    std::ofstream fout{path};
+    fout << "1 0:1 2:3\n0 1:2\n";
+  }
+  auto parser = TryCreateNativeParser(path + "?format=libsvm", 2);
+  ASSERT_TRUE(parser);
+  std::size_t n_rows{0};
+  while (parser->Next()) {
+    auto const& block = parser->Value();
+    n_rows += block.size;
+    ASSERT_EQ(block.offset[block.size], 3);
+    ASSERT_EQ(block.weight, nullptr);
+  }
+  ASSERT_EQ(n_rows, 2);
+  parser->BeforeFirst();
+  ASSERT_TRUE(parser->Next());
+
+  ASSERT_FALSE(TryCreateNativeParser(path + "?format=csv", 2));
+  ASSERT_FALSE(TryCreateNativeParser(path + "?format=libsvm&label_column=0", 2));
+  ASSERT_FALSE(TryCreateNativeParser(tempdir.path + "/missing.libsvm?format=libsvm", 2));
+}
+}  // namespace xgboost::data
@@ -7,8 +7,10 @@
 #include <gmock/gmock.h>
 #include <xgboost/data.h>
 
+#include <limits>  // for numeric_limits
 #include <memory>
 #include <string>
+#include <vector>  // for vector
 
 #include "../collective/test_worker.h"  // for TestDistributedGlobal
 #include "../filesystem.h"              // dmlc::TemporaryDirectory
@@ -321,6 +323,29 @@ TEST(MetaInfo, Validate) {
 #endif  // defined(XGBOOST_USE_CUDA)
 }
 
+TEST(MetaInfo, InvalidValues) {
+  Context ctx;
+  MetaInfo info;
+  // Larger than a block of the validation.
+  std::size_t n_samples = 10000;
+  std::vector<float> values(n_samples, 1.0f);
+  info.SetInfo(ctx, "label", Make1dInterfaceTest(values.data(), n_samples));
+  info.SetInfo(ctx, "weight", Make1dInterfaceTest(values.data(), n_samples));
+
+  values[9500] = std::numeric_limits<float>::infinity();
+  values[9000] = std::numeric_limits<float>::quiet_NaN();
+  ASSERT_THAT([&] { info.SetInfo(ctx, "label", Make1dInterfaceTest(values.data(), n_samples)); },
+              GMockThrow("at index: 9000"));
+
+  values[9000] = 1.0f;
+  values[6000] = -1.0f;
+  ASSERT_THAT([&] { info.SetInfo(ctx, "weight", Make1dInterfaceTest(values.data(), n_samples)); },
+              GMockThrow("at index: 6000"));
+  values[6000] = 1.0f;
+  ASSERT_THAT([&] { info.SetInfo(ctx, "weight", Make1dInterfaceTest(values.data(), n_samples)); },
+              GMockThrow("at index: 9500"));
+}
+
 TEST(MetaInfo, HostExtend) {
   xgboost::MetaInfo lhs, rhs;
   xgboost::Context ctx;
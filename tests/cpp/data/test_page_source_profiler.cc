@@ -0,0 +1,87 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+#include <xgboost/data.h>  // for SparsePage, DMatrix
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int32_t, int64_t
+#include <vector>   // for vector
+
+#include "../../../src/data/page_source_profiler.h"
+#include "../filesystem.h"  // dmlc::TemporaryDirectory
+#include "../helpers.h"
+
+namespace xgboost::data {
+TEST(PageSourceProfiler, Suggest) {
+  ASSERT_EQ(SuggestPageSource({}, 4).n_prefetch_batches, 1);
+
+  // 1ms latency, 1GB/s
+  double latency = 1e-3, bandwidth = 1e9;
+  std::vector<PageFetchRecord> records;
+  for (std::int64_t n_bytes : {1 << 20, 1 << 22, 1 << 24}) {
+    PageFetchRecord r;
+    r.n_bytes = n_bytes;
+    r.read = latency + static_cast<double>(n_bytes) / bandwidth;
+    r.decode = 1e-3;
+    r.compute = 5e-3;
+    records.push_back(r);
+  }
+  auto suggestion = SuggestPageSource(common::Span{records}, 8);
+  ASSERT_NEAR(suggestion.latency, latency, 1e-7);
+  ASSERT_NEAR(suggestion.bandwidth, bandwidth, bandwidth * 1e-6);
+  // 9ms of read for 1ms of latency.
+  ASSERT_NEAR(static_cast<double>(suggestion.page_bytes), 9e6, 1e3);
+  // Mean fetch time is about 9.4ms.
+  ASSERT_EQ(suggestion.n_prefetch_batches, 3);
+  // Bounded by the maximum.
+  ASSERT_EQ(SuggestPageSource(common::Span{records}, 2).n_prefetch_batches, 2);
+
+  // Same size, no latency can be estimated.
+  for (auto& r : records) {
+    r.n_bytes = 1 << 20;
+    r.read = 1e-3;
+  }
+  suggestion = SuggestPageSource(common::Span{records}, 8);
+  ASSERT_EQ(suggestion.latency, 0.0);
+  ASSERT_EQ(suggestion.page_bytes, 1 << 20);
+  ASSERT_EQ(suggestion.n_prefetch_batches, 2);
+}
+
+TEST(PageSourceProfiler, SparsePage) {
+  dmlc::TemporaryDirectory tmpdir;
+  std::size_t n_batches = 4;
+  auto p_fmat = RandomDataGenerator{256, 8, 0.0}.Batches(n_batches).GenerateSparsePageDMatrix(
+      tmpdir.path + "/cache", false);
+
+  auto& profiler = PageSourceProfiler::Get();
+  ASSERT_FALSE(PageSourceProfiler::Enabled());
+  profiler.Start();
+  for (auto const& page : p_fmat->GetBatches<SparsePage>()) {
+    ASSERT_NE(page.Size(), 0);
+  }
+  auto records = profiler.Stop();
+  ASSERT_FALSE(PageSourceProfiler::Enabled());
+
+  ASSERT_EQ(records.size(), n_batches);
+  for (std::size_t i = 0; i < records.size(); ++i) {
+    auto const& r = records[i];
+    ASSERT_EQ(r.source, StringView{"SparsePage"});
+    ASSERT_EQ(r.page, i);
+    ASSERT_GT(r.n_bytes, 0);
+    ASSERT_GT(r.decode, 0.0);
+    ASSERT_GE(r.read, 0.0);
+    ASSERT_GE(r.depth, 1);
+    if (i != 0) {
+      ASSERT_GE(r.begin, records[i - 1].begin);
+    }
+  }
+
+  // Nothing is recorded after stopping.
+  for (auto const& page : p_fmat->GetBatches<SparsePage>()) {
+    ASSERT_NE(page.Size(), 0);
+  }
+  profiler.Start();
+  ASSERT_TRUE(profiler.Stop().empty());
+}
+}  // namespace xgboost::data
@@ -6,12 +6,16 @@
 #include <array>   // std::array
 #include <limits>  // std::numeric_limits
 #include <memory>  // std::unique_ptr
-
-#include "../../../src/data/adapter.h"         // ArrayAdapter
-#include "../../../src/data/simple_dmatrix.h"  // SimpleDMatrix
-#include "../collective/test_worker.h"         // for TestDistributedGlobal
-#include "../filesystem.h"                     // dmlc::TemporaryDirectory
-#include "../helpers.h"                        // RandomDataGenerator,CreateSimpleTestData
+#include <string>  // for string
+#include <vector>  // for vector
+
+#include "../../../src/common/column_matrix.h"  // for ColumnMatrix
+#include "../../../src/data/adapter.h"          // ArrayAdapter
+#include "../../../src/data/gradient_index.h"   // for GHistIndexMatrix
+#include "../../../src/data/simple_dmatrix.h"   // SimpleDMatrix
+#include "../collective/test_worker.h"          // for TestDistributedGlobal
+#include "../filesystem.h"                      // dmlc::TemporaryDirectory
+#include "../helpers.h"                         // RandomDataGenerator,CreateSimpleTestData
 #include "xgboost/base.h"
 #include "xgboost/host_device_vector.h"  // HostDeviceVector
 #include "xgboost/string_view.h"         // StringView
@@ -138,6 +142,16 @@ TEST(SimpleDMatrix, MissingData) {
                      &adapter, std::numeric_limits<float>::quiet_NaN(), -1),
                  dmlc::Error);
   }
+  {
+    // The first row with `inf` is reported.
+    std::vector<float> dense(64 * 4, 1.0f);
+    dense[50 * 4 + 1] = -std::numeric_limits<float>::infinity();
+    dense[37 * 4 + 3] = std::numeric_limits<float>::infinity();
+    data::DenseAdapter adapter(dense.data(), 64, 4);
+    ASSERT_THAT(
+        [&] { data::SimpleDMatrix dmat(&adapter, std::numeric_limits<float>::quiet_NaN(), 4); },
+        GMockThrow("Found `inf` at row: 37"));
+  }
 }
 
 TEST(SimpleDMatrix, EmptyRow) {
@@ -419,6 +433,31 @@ TEST(SimpleDMatrix, SaveLoadBinary) {
   delete dmat_read;
 }
 
+TEST(SimpleDMatrix, LoadBinaryMmap) {
+  dmlc::TemporaryDirectory tempdir;
+  auto p_fmat = RandomDataGenerator{64, 8, 0.3}.GenerateDMatrix(true);
+  auto path = tempdir.path + "/simple.binary";
+  dynamic_cast<data::SimpleDMatrix *>(p_fmat.get())->SaveToLocalFile(path);
+
+  std::unique_ptr<dmlc::Stream> fi{dmlc::Stream::Create(path.c_str(), "r")};
+  data::SimpleDMatrix from_stream{fi.get()};
+  data::SimpleDMatrix from_mmap{path, 4};
+
+  ASSERT_EQ(from_stream.Info().num_row_, from_mmap.Info().num_row_);
+  ASSERT_EQ(from_stream.Info().labels.Data()->HostVector(),
+            from_mmap.Info().labels.Data()->HostVector());
+  auto const &expected = *from_stream.GetBatches<SparsePage>().begin();
+  auto const &loaded = *from_mmap.GetBatches<SparsePage>().begin();
+  ASSERT_EQ(expected.offset.HostVector(), loaded.offset.HostVector());
+  auto const &h_expected = expected.data.HostVector();
+  auto const &h_loaded = loaded.data.HostVector();
+  ASSERT_EQ(h_expected.size(), h_loaded.size());
+  for (std::size_t i = 0; i < h_expected.size(); ++i) {
+    ASSERT_EQ(h_expected[i].index, h_loaded[i].index);
+    ASSERT_EQ(h_expected[i].fvalue, h_loaded[i].fvalue);
+  }
+}
+
 TEST(SimpleDMatrix, Threads) {
   size_t constexpr kRows{16};
   size_t constexpr kCols{8};
@@ -446,3 +485,81 @@ TEST(SimpleDMatrix, ColumnSplit) {
   auto constexpr kWorldSize{3};
   collective::TestDistributedGlobal(kWorldSize, VerifyColumnSplit);
 }
+
+TEST(SimpleDMatrix, Append) {
+  Context ctx;
+  bst_idx_t constexpr kRows = 256;
+  bst_feature_t constexpr kCols = 8;
+  bst_bin_t constexpr kBins = 16;
+  auto test = [&](float sparsity) {
+    // The first matrix is dense, the appended one might not be.
+    auto p_fmat = RandomDataGenerator{kRows, kCols, 0.0}.GenerateDMatrix(true);
+    auto p_new = RandomDataGenerator{kRows / 2, kCols, sparsity}.Seed(3).GenerateDMatrix(true);
+    BatchParam param{kBins, 0.2};
+    common::HistogramCuts cuts;
+    for (auto const& page : p_fmat->GetBatches<GHistIndexMatrix>(&ctx, param)) {
+      cuts = page.cut;
+    }
+
+    auto n_nonzero = p_fmat->Info().num_nonzero_ + p_new->Info().num_nonzero_;
+    auto p_simple = std::dynamic_pointer_cast<data::SimpleDMatrix>(p_fmat);
+    ASSERT_TRUE(p_simple);
+    p_simple->Append(p_new.get());
+    ASSERT_EQ(p_fmat->Info().num_row_, kRows + kRows / 2);
+    ASSERT_EQ(p_fmat->Info().labels.Size(), kRows + kRows / 2);
+    ASSERT_EQ(p_fmat->Info().num_nonzero_, n_nonzero);
+    ASSERT_EQ(p_fmat->IsDense(), sparsity == 0.0);
+
+    auto const& page = *p_fmat->GetBatches<SparsePage>().begin();
+    ASSERT_EQ(page.Size(), kRows + kRows / 2);
+    GHistIndexMatrix expected{page, {}, cuts, kBins, p_fmat->IsDense(), param.sparse_thresh,
+                              ctx.Threads()};
+    for (auto const& gidx : p_fmat->GetBatches<GHistIndexMatrix>(&ctx, param)) {
+      // The cuts are not updated.
+      ASSERT_EQ(gidx.cut.Values(), cuts.Values());
+      ASSERT_EQ(gidx.Size(), page.Size());
+      ASSERT_EQ(gidx.IsDense(), p_fmat->IsDense());
+      ASSERT_EQ(gidx.Transpose(&ctx).IsInitialized(), !gidx.IsDense());
+      for (std::size_t i = 0; i < gidx.hit_count.size(); ++i) {
+        ASSERT_EQ(gidx.hit_count[i], expected.hit_count[i]);
+      }
+      for (bst_idx_t i = 0; i < gidx.Size(); ++i) {
+        for (bst_feature_t j = 0; j < kCols; ++j) {
+          ASSERT_EQ(gidx.GetGindex(i, j), expected.GetGindex(i, j));
+        }
+      }
+    }
+  };
+  test(0.0);
+  test(0.4);
+}
+
+TEST(SimpleDMatrix, CachedGradientIndex) {
+  Context ctx;
+  bst_feature_t constexpr kCols = 8;
+  auto p_fmat = RandomDataGenerator{128, kCols, 0.2}.GenerateDMatrix(true);
+  auto get = [&](bst_bin_t max_bin) {
+    GHistIndexMatrix const* ptr{nullptr};
+    for (auto const& page : p_fmat->GetBatches<GHistIndexMatrix>(&ctx, {max_bin, 0.2})) {
+      ptr = &page;
+      EXPECT_LE(page.cut.Ptrs()[1] - page.cut.Ptrs()[0], max_bin);
+    }
+    return ptr;
+  };
+  auto p_16 = get(16);
+  auto p_32 = get(32);
+  ASSERT_NE(p_16, p_32);
+  // Switching back doesn't rebuild the index.
+  ASSERT_EQ(get(16), p_16);
+  ASSERT_EQ(get(32), p_32);
+  ASSERT_EQ(get(32), p_32);
+  // Changing the feature types invalidates the cached index, the old one is still alive
+  // in the cache.
+  std::vector<std::string> types(kCols, "q");
+  std::vector<char const*> c_types;
+  for (auto const& t : types) {
+    c_types.push_back(t.c_str());
+  }
+  p_fmat->Info().SetFeatureInfo("feature_type", c_types.data(), c_types.size());
+  ASSERT_NE(get(16), p_16);
+}
@@ -3,10 +3,15 @@
  */
 #include <gtest/gtest.h>
 #include <xgboost/data.h>
+#include <xgboost/learner.h>  // for Learner
 
+#include <filesystem>  // for directory_iterator
 #include <future>
 #include <thread>
+#include <utility>  // for pair
+#include <vector>   // for vector
 
+#include "../../../src/common/column_matrix.h"  // for ColumnMatrix
 #include "../../../src/common/io.h"
 #include "../../../src/data/adapter.h"
 #include "../../../src/data/file_iterator.h"
@@ -395,3 +400,190 @@ TEST(SparsePageDMatrix, Determinism) {
     ASSERT_EQ(caches[i], caches.front());
   }
 }
+
+TEST(SparsePageDMatrix, PersistentCache) {
+  dmlc::TemporaryDirectory tmpdir;
+  auto prefix = tmpdir.path + "/cache";
+  Context ctx;
+  auto make = [&] {
+    NumpyArrayIterForTest iter{0.3f, 256, 8, 4};
+    auto config = ExtMemConfig{prefix,
+                               false,
+                               cuda_impl::MatchingPageBytes(),
+                               std::numeric_limits<float>::quiet_NaN(),
+                               cuda_impl::MaxNumDevicePages(),
+                               ctx.Threads()};
+    config.persistent = true;
+    return std::shared_ptr<DMatrix>{
+        DMatrix::Create(static_cast<DataIterHandle>(&iter), iter.Proxy(), Reset, Next, config)};
+  };
+  auto n_caches = [&] {
+    std::size_t n = 0;
+    for (auto const& entry : std::filesystem::directory_iterator{tmpdir.path}) {
+      auto name = entry.path().filename().string();
+      if (name.size() > 5 && name.substr(name.size() - 5) == ".meta") {
+        ++n;
+      }
+    }
+    return n;
+  };
+  auto collect = [&](std::shared_ptr<DMatrix> p_fmat, BatchParam const& param) {
+    std::vector<std::uint32_t> bins;
+    std::vector<float> cuts;
+    for (auto const& page : p_fmat->GetBatches<GHistIndexMatrix>(&ctx, param)) {
+      for (std::size_t i = 0; i < page.index.Size(); ++i) {
+        bins.push_back(page.index[i]);
+      }
+      cuts = page.cut.Values();
+    }
+    return std::pair{bins, cuts};
+  };
+
+  BatchParam param{64, 0.8};
+  auto expected = collect(make(), param);
+  // The index is kept after the DMatrix is freed.
+  ASSERT_EQ(n_caches(), 1);
+  auto p_fmat = make();
+  auto reused = collect(p_fmat, param);
+  ASSERT_EQ(reused, expected);
+  // The reused cache is not removed.
+  p_fmat.reset();
+  ASSERT_EQ(n_caches(), 1);
+
+  // Different quantile configuration.
+  BatchParam other{16, 0.8};
+  p_fmat = make();
+  ASSERT_NE(collect(p_fmat, other).second, expected.second);
+  ASSERT_EQ(collect(p_fmat, param), expected);
+  p_fmat.reset();
+  ASSERT_EQ(n_caches(), 2);
+}
+
+TEST(SparsePageDMatrix, TargetPageBytes) {
+  dmlc::TemporaryDirectory tmpdir;
+  bst_idx_t n_samples = 1024;
+  auto make = [&](std::size_t n_batches, std::int64_t target_page_bytes) {
+    NumpyArrayIterForTest iter{0.3f, n_samples, 8, n_batches};
+    auto config = ExtMemConfig{tmpdir.path + "/cache",
+                               false,
+                               cuda_impl::MatchingPageBytes(),
+                               std::numeric_limits<float>::quiet_NaN(),
+                               cuda_impl::MaxNumDevicePages(),
+                               AllThreadsForTest()};
+    config.target_page_bytes = target_page_bytes;
+    return std::shared_ptr<DMatrix>{
+        DMatrix::Create(static_cast<DataIterHandle>(&iter), iter.Proxy(), Reset, Next, config)};
+  };
+  auto concat = [&](std::shared_ptr<DMatrix> p_fmat) {
+    SparsePage out;
+    bst_idx_t base_rowid = 0;
+    for (auto const& page : p_fmat->GetBatches<SparsePage>()) {
+      EXPECT_EQ(page.base_rowid, base_rowid);
+      base_rowid += page.Size();
+      out.Push(page);
+    }
+    EXPECT_EQ(base_rowid, n_samples);
+    return out;
+  };
+  auto check = [&](std::shared_ptr<DMatrix> p_fmat, SparsePage const& expected) {
+    ASSERT_EQ(p_fmat->Info().num_row_, n_samples);
+    ASSERT_EQ(p_fmat->Info().num_nonzero_, expected.data.Size());
+    auto out = concat(p_fmat);
+    ASSERT_EQ(out.offset.ConstHostVector(), expected.offset.ConstHostVector());
+    auto const& h_data = out.data.ConstHostVector();
+    auto const& h_expected = expected.data.ConstHostVector();
+    ASSERT_EQ(h_data.size(), h_expected.size());
+    for (std::size_t i = 0; i < h_data.size(); ++i) {
+      ASSERT_EQ(h_data[i].index, h_expected[i].index);
+      ASSERT_EQ(h_data[i].fvalue, h_expected[i].fvalue);
+    }
+  };
+
+  std::size_t n_batches = 16;
+  auto p_fmat = make(n_batches, 0);
+  ASSERT_EQ(p_fmat->NumBatches(), n_batches);
+  auto expected = concat(p_fmat);
+  auto total_bytes = expected.MemCostBytes();
+
+  // Merge the small batches.
+  p_fmat = make(n_batches, total_bytes / 4);
+  ASSERT_GT(p_fmat->NumBatches(), 1);
+  ASSERT_LE(p_fmat->NumBatches(), 4);
+  check(p_fmat, expected);
+
+  // Split a large batch.
+  p_fmat = make(1, total_bytes / 6);
+  ASSERT_EQ(p_fmat->NumBatches(), 6);
+  check(p_fmat, expected);
+  Context ctx;
+  for (auto const& page : p_fmat->GetBatches<GHistIndexMatrix>(&ctx, BatchParam{64, 0.8})) {
+    ASSERT_GT(page.Size(), 0);
+  }
+}
+
+TEST(SparsePageDMatrix, ColumnPages) {
+  dmlc::TemporaryDirectory tmpdir;
+  bst_idx_t n_samples = 512;
+  bst_feature_t n_features = 8;
+  auto make = [&](bool column_pages) {
+    NumpyArrayIterForTest iter{0.0f, n_samples, n_features, 4};
+    auto config = ExtMemConfig{tmpdir.path + "/cache",
+                               false,
+                               cuda_impl::MatchingPageBytes(),
+                               std::numeric_limits<float>::quiet_NaN(),
+                               cuda_impl::MaxNumDevicePages(),
+                               AllThreadsForTest()};
+    config.column_pages = column_pages;
+    std::shared_ptr<DMatrix> p_fmat{
+        DMatrix::Create(static_cast<DataIterHandle>(&iter), iter.Proxy(), Reset, Next, config)};
+    std::vector<float> labels(n_samples);
+    for (bst_idx_t i = 0; i < n_samples; ++i) {
+      labels[i] = static_cast<float>(i % 3) * 0.5f;
+    }
+    p_fmat->Info().labels.Reshape(n_samples);
+    p_fmat->Info().labels.Data()->HostVector() = labels;
+    return p_fmat;
+  };
+
+  Context ctx;
+  BatchParam param{64, tree::TrainParam::DftSparseThreshold()};
+  auto with_columns = make(true);
+  ASSERT_TRUE(with_columns->IsDense());
+  std::int32_t n_pages = 0;
+  for (auto const& page : with_columns->GetBatches<GHistIndexMatrix>(&ctx, param)) {
+    auto const& columns = page.Transpose(&ctx);
+    ASSERT_TRUE(columns.IsInitialized());
+    ASSERT_FALSE(columns.AnyMissing());
+    ASSERT_EQ(columns.GetTypeSize(), common::kUint8BinsTypeSize);
+    for (bst_feature_t f = 0; f < n_features; ++f) {
+      auto column = columns.DenseColumn<std::uint8_t, false>(f);
+      for (bst_idx_t i = 0; i < page.Size(); ++i) {
+        ASSERT_EQ(column[i], page.GetGindex(page.base_rowid + i, f));
+      }
+    }
+    ++n_pages;
+  }
+  ASSERT_EQ(n_pages, 4);
+
+  auto without_columns = make(false);
+  for (auto const& page : without_columns->GetBatches<GHistIndexMatrix>(&ctx, param)) {
+    ASSERT_FALSE(page.Transpose(&ctx).IsInitialized());
+  }
+
+  auto train = [](std::shared_ptr<DMatrix> p_fmat) {
+    std::unique_ptr<Learner> learner{Learner::Create({p_fmat})};
+    learner->SetParams(Args{{"tree_method", "hist"}, {"max_bin", "64"}});
+    for (std::int32_t i = 0; i < 4; ++i) {
+      learner->UpdateOneIter(i, p_fmat);
+    }
+    HostDeviceVector<float> predt;
+    learner->Predict(p_fmat, false, &predt, 0, 0);
+    return std::vector<float>{predt.ConstHostVector()};
+  };
+  auto predt = train(with_columns);
+  auto expected = train(without_columns);
+  ASSERT_EQ(predt.size(), expected.size());
+  for (std::size_t i = 0; i < predt.size(); ++i) {
+    ASSERT_NEAR(predt[i], expected[i], kRtEps);
+  }
+}
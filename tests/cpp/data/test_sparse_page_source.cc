@@ -0,0 +1,52 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int32_t, int64_t
+
+#include "../../../src/data/sparse_page_source.h"  // for PrefetchDepth
+
+namespace xgboost::data {
+TEST(PrefetchDepth, Adaptive) {
+  PrefetchDepth depth;
+  auto page_bytes = [](std::int32_t) { return static_cast<std::size_t>(64); };
+  std::int32_t constexpr kMax = 4;
+  // Start with the maximum depth.
+  ASSERT_EQ(depth.Update(0.0, 0.0, kMax, page_bytes, 0), kMax);
+  // Compute-bound, shrink one at a time.
+  ASSERT_EQ(depth.Update(0.0, 1.0, kMax, page_bytes, 0), kMax - 1);
+  ASSERT_EQ(depth.Update(0.0, 1.0, kMax, page_bytes, 0), kMax - 2);
+  // Within the band, no change.
+  ASSERT_EQ(depth.Update(0.05, 1.0, kMax, page_bytes, 0), kMax - 2);
+  // IO-bound, grow up to the maximum.
+  ASSERT_EQ(depth.Update(1.0, 1.0, kMax, page_bytes, 0), kMax - 1);
+  ASSERT_EQ(depth.Update(1.0, 1.0, kMax, page_bytes, 0), kMax);
+  ASSERT_EQ(depth.Update(1.0, 1.0, kMax, page_bytes, 0), kMax);
+  // Never goes below 1.
+  for (std::int32_t i = 0; i < kMax * 2; ++i) {
+    depth.Update(0.0, 1.0, kMax, page_bytes, 0);
+  }
+  ASSERT_EQ(depth.Depth(), 1);
+
+  depth.Reset();
+  ASSERT_EQ(depth.Depth(), 0);
+}
+
+TEST(PrefetchDepth, Budget) {
+  PrefetchDepth depth;
+  auto page_bytes = [](std::int32_t k) { return static_cast<std::size_t>(k == 0 ? 256 : 64); };
+  std::int32_t constexpr kMax = 4;
+  // The first page is always fetched.
+  ASSERT_EQ(depth.Update(0.0, 0.0, kMax, page_bytes, 128), 1);
+  depth.Reset();
+  ASSERT_EQ(depth.Update(0.0, 0.0, kMax, page_bytes, 256 + 64 * 2), 3);
+  // Pending reads can not be cancelled, decrease one at a time even if the budget is
+  // exceeded.
+  ASSERT_EQ(depth.Update(1.0, 1.0, kMax, page_bytes, 1), 2);
+  ASSERT_EQ(depth.Update(1.0, 1.0, kMax, page_bytes, 1), 1);
+  // No limit.
+  ASSERT_EQ(depth.Update(1.0, 1.0, kMax, page_bytes, 0), 2);
+}
+}  // namespace xgboost::data
@@ -1,6 +1,7 @@
 /**
  * Copyright 2019-2024, XGBoost contributors
  */
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <xgboost/context.h>
 #include <xgboost/host_device_vector.h>  // for HostDeviceVector
@@ -9,13 +10,16 @@
 
 #include <limits>    // for numeric_limits
 #include <memory>    // for shared_ptr
+#include <numeric>   // for iota
 #include <optional>  // for optional
 #include <string>    // for string
+#include <utility>   // for pair
+#include <vector>    // for vector
 
 #include "../../../src/data/proxy_dmatrix.h"  // for DMatrixProxy
 #include "../../../src/gbm/gbtree.h"
 #include "../filesystem.h"  // dmlc::TemporaryDirectory
-#include "../helpers.h"
+#include "../helpers.h"  // for GMockThrow
 #include "xgboost/base.h"
 #include "xgboost/predictor.h"
 
@@ -99,6 +103,103 @@ TEST(GBTree, PredictionCache) {
   ASSERT_EQ(out_predictions.predictions.HostVector(), first_iter);
 }
 
+TEST(GBTree, PrefixCache) {
+  size_t constexpr kRows = 64, kCols = 8;
+  Context ctx;
+  LearnerModelParam mparam{MakeMP(kCols, .5, 1)};
+
+  std::unique_ptr<GradientBooster> p_gbm{GradientBooster::Create("gbtree", &ctx, &mparam)};
+  auto& gbtree = dynamic_cast<gbm::GBTree&>(*p_gbm);
+  gbtree.Configure({{"tree_method", "hist"}});
+  auto p_m = RandomDataGenerator{kRows, kCols, 0}.GenerateDMatrix();
+  linalg::Matrix<GradientPair> gpair({kRows}, ctx.Device());
+  gpair.Data()->Copy(GenerateRandomGradients(kRows));
+  PredictionCacheEntry train;
+  for (std::int32_t i = 0; i < 4; ++i) {
+    gbtree.DoBoost(p_m.get(), &gpair, &train, nullptr);
+  }
+
+  auto predict = [&](PredictionCacheEntry* entry, bst_layer_t begin, bst_layer_t end) {
+    gbtree.PredictBatch(p_m.get(), entry, false, begin, end);
+    return entry->predictions.HostVector();
+  };
+  std::vector<std::pair<bst_layer_t, bst_layer_t>> ranges{{1, 3}, {0, 4}, {0, 2},
+                                                          {2, 4}, {0, 1}, {3, 4}};
+  std::vector<std::vector<float>> expected;
+  for (auto [begin, end] : ranges) {
+    PredictionCacheEntry entry;
+    expected.push_back(predict(&entry, begin, end));
+  }
+
+  gbtree.Configure({{"tree_method", "hist"}, {"prefix_cache", "true"}});
+  PredictionCacheEntry cached;
+  auto check = [&] {
+    for (std::size_t i = 0; i < ranges.size(); ++i) {
+      auto [begin, end] = ranges[i];
+      auto got = predict(&cached, begin, end);
+      ASSERT_EQ(got.size(), expected[i].size());
+      for (std::size_t j = 0; j < got.size(); ++j) {
+        ASSERT_NEAR(got[j], expected[i][j], 1e-5);
+      }
+      ASSERT_EQ(cached.version, begin == 0 ? end : 0);
+    }
+  };
+  check();
+  ASSERT_EQ(cached.n_prefix_layers, 5);
+
+  // The prefix sums are rebuilt after the model is changed.
+  gbtree.DoBoost(p_m.get(), &gpair, &train, nullptr);
+  auto version = cached.prefix_model_version;
+  check();
+  ASSERT_NE(cached.prefix_model_version, version);
+  ASSERT_EQ(cached.n_prefix_layers, 5);
+}
+
+TEST(GBTree, ConcurrentTrees) {
+  bst_idx_t constexpr kRows = 256;
+  std::int32_t constexpr kIters = 4;
+  auto p_dmat = RandomDataGenerator{kRows, 10, 0}.Classes(3).GenerateDMatrix(true);
+
+  for (auto n_forest : {"1", "2"}) {
+    auto train = [&](std::string n_concurrent, HostDeviceVector<float>* predt) {
+      std::unique_ptr<Learner> learner{Learner::Create({p_dmat})};
+      learner->SetParams(Args{{"tree_method", "hist"},
+                              {"objective", "multi:softprob"},
+                              {"num_class", "3"},
+                              {"num_parallel_tree", n_forest},
+                              {"concurrent_trees", n_concurrent},
+                              {"nthread", "4"}});
+      for (std::int32_t iter = 0; iter < kIters; ++iter) {
+        learner->UpdateOneIter(iter, p_dmat);
+      }
+      // The prediction cache is updated by the workers.
+      learner->Predict(p_dmat, true, predt, 0, 0, true);
+      auto p_fmat = RandomDataGenerator{kRows, 10, 0}.GenerateDMatrix();
+      HostDeviceVector<float> full;
+      learner->Predict(p_fmat, true, &full, 0, 0);
+      auto const& h_predt = predt->ConstHostVector();
+      auto const& h_full = full.ConstHostVector();
+      ASSERT_EQ(h_predt.size(), kRows * 3);
+      ASSERT_EQ(h_predt.size(), h_full.size());
+      for (std::size_t i = 0; i < h_full.size(); ++i) {
+        ASSERT_NEAR(h_predt[i], h_full[i], kRtEps);
+      }
+    };
+    HostDeviceVector<float> expected;
+    train("1", &expected);
+    for (auto n_concurrent : {"2", "3", "8"}) {
+      HostDeviceVector<float> predt;
+      train(n_concurrent, &predt);
+      auto const& h_expected = expected.ConstHostVector();
+      auto const& h_predt = predt.ConstHostVector();
+      ASSERT_EQ(h_expected.size(), h_predt.size());
+      for (std::size_t i = 0; i < h_expected.size(); ++i) {
+        ASSERT_NEAR(h_expected[i], h_predt[i], kRtEps) << n_concurrent;
+      }
+    }
+  }
+}
+
 TEST(GBTree, WrongUpdater) {
   size_t constexpr kRows = 17;
   size_t constexpr kCols = 15;
@@ -359,6 +460,69 @@ TEST(GBTree, JsonIO) {
   check_config(j_config_rt["updater"]);
 }
 
+TEST(GBTree, DedupTrees) {
+  bst_feature_t constexpr kCols = 4;
+  Context ctx;
+  LearnerModelParam mparam{MakeMP(kCols, .5, 1)};
+  gbm::GBTreeModel model{&mparam, &ctx};
+
+  // Stumps with two distinct splits, each appears twice with different statistics.
+  std::vector<std::unique_ptr<RegTree>> trees;
+  for (std::int32_t i = 0; i < 5; ++i) {
+    trees.emplace_back(std::make_unique<RegTree>(1, kCols));
+    auto fidx = static_cast<bst_feature_t>(i % 2);
+    float leaf = i == 4 ? 3.0f : 1.0f;
+    trees.back()->ExpandNode(RegTree::kRoot, fidx, 0.5f, true, 0.0f, -leaf, leaf, 1.0f + i,
+                             10.0f + i, 5.0f, 5.0f + i);
+  }
+  model.CommitModelGroup(std::move(trees), 0);
+  model.iteration_indptr.push_back(model.param.num_trees);
+
+  Json dedup{Object{}};
+  model.SaveModel(&dedup, true);
+  auto const& jtrees = get<Array const>(dedup["trees"]);
+  ASSERT_EQ(jtrees.size(), 5ul);
+  std::vector<std::int64_t> shared;
+  for (auto const& jtree : jtrees) {
+    auto const& obj = get<Object const>(jtree);
+    auto it = obj.find("shared");
+    shared.push_back(it == obj.cend() ? -1 : get<Integer const>(it->second));
+  }
+  ASSERT_EQ(shared, (std::vector<std::int64_t>{-1, -1, 0, 1, -1}));
+
+  auto check = [&](gbm::GBTreeModel const& loaded) {
+    ASSERT_EQ(loaded.trees.size(), model.trees.size());
+    for (std::size_t i = 0; i < model.trees.size(); ++i) {
+      ASSERT_TRUE(*loaded.trees[i] == *model.trees[i]) << i;
+    }
+  };
+  for (auto mode : {std::ios::in, std::ios::binary}) {
+    std::vector<char> str;
+    Json::Dump(dedup, &str, mode);
+    gbm::GBTreeModel loaded{&mparam, &ctx};
+    loaded.LoadModel(Json::Load(StringView{str.data(), str.size()}, mode));
+    check(loaded);
+  }
+  // Streaming reader.
+  Json doc{Object{}};
+  doc["learner"] = Object{};
+  doc["learner"]["gradient_booster"] = Object{};
+  doc["learner"]["gradient_booster"]["model"] = dedup;
+  std::vector<char> str;
+  Json::Dump(doc, &str, std::ios::binary);
+  gbm::TreesOneGroup loaded_trees;
+  auto in = gbm::LoadUBJModel(&ctx, StringView{str.data(), str.size()}, &loaded_trees);
+  gbm::GBTreeModel loaded{&mparam, &ctx};
+  loaded.LoadModel(in["learner"]["gradient_booster"]["model"], std::move(loaded_trees));
+  check(loaded);
+
+  Json plain{Object{}};
+  model.SaveModel(&plain);
+  for (auto const& jtree : get<Array const>(plain["trees"])) {
+    ASSERT_EQ(get<Object const>(jtree).count("shared"), 0ul);
+  }
+}
+
 TEST(Dart, JsonIO) {
   size_t constexpr kRows = 16, kCols = 16;
 
@@ -454,6 +618,35 @@ class Dart : public testing::TestWithParam<char const*> {
 
 TEST_P(Dart, Prediction) { this->Run(GetParam()); }
 
+TEST(Dart, TrainingMargin) {
+  bst_idx_t constexpr kRows = 256;
+  bst_feature_t constexpr kCols = 8;
+  auto make_dmat = [&] { return RandomDataGenerator{kRows, kCols, 0}.GenerateDMatrix(true); };
+  // The margin of the training data is updated incrementally when the same DMatrix is used
+  // for all iterations, and rebuilt from all trees when a new DMatrix is used.
+  auto train = [&](bool reuse) {
+    auto p_fmat = make_dmat();
+    std::unique_ptr<Learner> learner{Learner::Create({p_fmat})};
+    learner->SetParams(Args{{"booster", "dart"}, {"rate_drop", "0.3"}, {"max_depth", "3"}});
+    learner->Configure();
+    for (std::int32_t i = 0; i < 16; ++i) {
+      if (!reuse) {
+        p_fmat = make_dmat();
+      }
+      learner->UpdateOneIter(i, p_fmat);
+    }
+    HostDeviceVector<float> predt;
+    learner->Predict(make_dmat(), true, &predt, 0, 0);
+    return predt.HostVector();
+  };
+  auto incremental = train(true);
+  auto rebuilt = train(false);
+  ASSERT_EQ(incremental.size(), rebuilt.size());
+  for (std::size_t i = 0; i < incremental.size(); ++i) {
+    ASSERT_NEAR(incremental[i], rebuilt[i], 1e-5);
+  }
+}
+
 #if defined(XGBOOST_USE_CUDA)
 INSTANTIATE_TEST_SUITE_P(PredictorTypes, Dart, testing::Values("CPU", "GPU"));
 #else
@@ -590,6 +783,106 @@ TEST(Dart, Slice) {
   ASSERT_EQ(weights.size(), trees.size());
 }
 
+TEST(GBTree, SliceSharesTrees) {
+  bst_idx_t constexpr kRows = 256, kCols = 8;
+  bst_target_t constexpr kClasses = 2;
+  auto m = RandomDataGenerator{kRows, kCols, 0}.Classes(kClasses).GenerateDMatrix(true);
+  std::unique_ptr<Learner> learner{Learner::Create({m})};
+  learner->SetParams(Args{{"num_class", std::to_string(kClasses)}, {"max_depth", "3"}});
+  std::int32_t constexpr kIters = 6;
+  for (std::int32_t i = 0; i < kIters; ++i) {
+    learner->UpdateOneIter(i, m);
+  }
+  bool out_of_bound = false;
+  std::unique_ptr<Learner> sliced{learner->Slice(1, 5, 2, &out_of_bound)};
+  ASSERT_FALSE(out_of_bound);
+  Json expected{Object{}};
+  sliced->SaveModel(&expected);
+
+  {
+    // The slice is a view of the original trees.
+    Json j_model{Object{}};
+    learner->SaveModel(&j_model);
+    Context ctx;
+    auto mparam = MakeMP(kCols, 0.5, kClasses);
+    std::unique_ptr<GradientBooster> gbm{GradientBooster::Create("gbtree", &ctx, &mparam)};
+    gbm->LoadModel(j_model["learner"]["gradient_booster"]);
+    std::unique_ptr<GradientBooster> out{GradientBooster::Create("gbtree", &ctx, &mparam)};
+    gbm->Slice(1, 5, 2, out.get(), &out_of_bound);
+    ASSERT_FALSE(out_of_bound);
+    auto const& in_trees = dynamic_cast<gbm::GBTree*>(gbm.get())->Model().trees;
+    auto const& out_trees = dynamic_cast<gbm::GBTree*>(out.get())->Model().trees;
+    ASSERT_EQ(out_trees.size(), 2 * kClasses);
+    for (bst_target_t k = 0; k < kClasses; ++k) {
+      ASSERT_EQ(out_trees[k].get(), in_trees[kClasses + k].get());
+      ASSERT_EQ(out_trees[kClasses + k].get(), in_trees[3 * kClasses + k].get());
+    }
+    // Both the JSON and the UBJSON outputs are the same as a copy.
+    for (auto format : {std::ios::out, std::ios::binary}) {
+      Json j_slice{Object{}}, j_copy{Object{}};
+      out->SaveModel(&j_slice);
+      std::vector<char> buf;
+      Json::Dump(j_slice, &buf, format);
+      std::unique_ptr<GradientBooster> copy{GradientBooster::Create("gbtree", &ctx, &mparam)};
+      copy->LoadModel(Json::Load(StringView{buf.data(), buf.size()}, format));
+      copy->SaveModel(&j_copy);
+      ASSERT_EQ(j_slice, j_copy);
+    }
+  }
+
+  // Updating the original model doesn't change the slice.
+  learner->SetParams(Args{{"process_type", "update"}, {"updater", "refresh"}, {"eta", "0.9"}});
+  auto p_other = RandomDataGenerator{kRows, kCols, 0}.Seed(3).Classes(kClasses).GenerateDMatrix(
+      true);
+  for (std::int32_t i = 0; i < kIters; ++i) {
+    learner->UpdateOneIter(i, p_other);
+  }
+  Json got{Object{}};
+  sliced->SaveModel(&got);
+  ASSERT_EQ(got, expected);
+}
+
+TEST(GBTree, Append) {
+  bst_idx_t constexpr kRows = 256, kCols = 16;
+  bst_target_t constexpr kClasses = 3;
+  auto m = RandomDataGenerator{kRows, kCols, 0}.Classes(kClasses).GenerateDMatrix(true);
+  for (auto booster : {"gbtree", "dart"}) {
+    std::unique_ptr<Learner> learner{Learner::Create({m})};
+    learner->SetParams(Args{{"booster", booster},
+                            {"num_parallel_tree", "2"},
+                            {"num_class", std::to_string(kClasses)},
+                            {"max_depth", "2"}});
+    std::int32_t constexpr kIters = 6;
+    for (std::int32_t i = 0; i < kIters; ++i) {
+      learner->UpdateOneIter(i, m);
+    }
+    learner->SetAttr("best_iteration", "3");
+
+    bool out_of_bound = false;
+    std::unique_ptr<Learner> front{learner->Slice(0, 4, 1, &out_of_bound)};
+    std::unique_ptr<Learner> back{learner->Slice(4, kIters, 1, &out_of_bound)};
+    ASSERT_FALSE(out_of_bound);
+    if (std::string{booster} == "dart") {
+      ASSERT_THAT([&] { front->Append(back.get()); }, GMockThrow("not supported by dart"));
+      continue;
+    }
+    back->SetAttr("best_iteration", "3");
+    front->Append(back.get());
+    ASSERT_EQ(front->BoostedRounds(), kIters);
+
+    Json expected{Object{}};
+    learner->SaveModel(&expected);
+    Json merged{Object{}};
+    front->SaveModel(&merged);
+    ASSERT_EQ(merged, expected);
+
+    HostDeviceVector<float> predt_0, predt_1;
+    learner->Predict(m, false, &predt_0, 0, 0);
+    front->Predict(m, false, &predt_1, 0, 0);
+    ASSERT_EQ(predt_0.ConstHostVector(), predt_1.ConstHostVector());
+  }
+}
+
 TEST(GBTree, FeatureScore) {
   size_t n_samples = 1000, n_features = 10, n_classes = 4;
   auto m = RandomDataGenerator{n_samples, n_features, 0.5}.Classes(n_classes).GenerateDMatrix(true);
@@ -627,6 +920,80 @@ TEST(GBTree, FeatureScore) {
   test_eq("cover");
 }
 
+TEST(GBTree, FeatureScoreIncremental) {
+  bst_idx_t n_samples = 256;
+  bst_feature_t n_features = 8;
+  auto m = RandomDataGenerator{n_samples, n_features, 0.5}.GenerateDMatrix(true);
+
+  std::unique_ptr<Learner> learner{Learner::Create({m})};
+  learner->Configure();
+
+  auto check = [&](Learner* learner) {
+    // The cached statistics for all trees must match the ones from walking the trees.
+    std::vector<std::int32_t> trees(learner->BoostedRounds());
+    std::iota(trees.begin(), trees.end(), 0);
+    for (auto type : {"weight", "gain", "total_gain", "cover", "total_cover"}) {
+      std::vector<bst_feature_t> features, features_walk;
+      std::vector<float> scores, scores_walk;
+      learner->CalcFeatureScore(type, {}, &features, &scores);
+      learner->CalcFeatureScore(type, trees, &features_walk, &scores_walk);
+      ASSERT_EQ(features, features_walk);
+      ASSERT_EQ(scores.size(), scores_walk.size());
+      for (std::size_t i = 0; i < scores.size(); ++i) {
+        ASSERT_NEAR(scores[i], scores_walk[i], kRtEps * std::abs(scores_walk[i]) + kRtEps);
+      }
+    }
+  };
+
+  for (std::int32_t i = 0; i < 4; ++i) {
+    learner->UpdateOneIter(i, m);
+    check(learner.get());
+  }
+
+  Json model{Object{}};
+  learner->SaveModel(&model);
+  std::unique_ptr<Learner> loaded{Learner::Create({m})};
+  loaded->LoadModel(model);
+  loaded->Configure();
+  check(loaded.get());
+  loaded->UpdateOneIter(4, m);
+  check(loaded.get());
+}
+
+TEST(GBTree, MeanValuesIncremental) {
+  bst_idx_t n_samples = 128;
+  bst_feature_t n_features = 6;
+  auto m = RandomDataGenerator{n_samples, n_features, 0.2}.GenerateDMatrix(true);
+
+  std::unique_ptr<Learner> learner{Learner::Create({m})};
+  learner->SetParam("max_depth", "4");
+  auto contribs = [&](Learner* learner, bool approximate) {
+    HostDeviceVector<float> out;
+    learner->Predict(m, false, &out, 0, 0, false, false, true, approximate);
+    return out.HostVector();
+  };
+  // The cached mean values must match the ones computed from scratch for a loaded model.
+  auto check = [&] {
+    Json model{Object{}};
+    learner->SaveModel(&model);
+    std::unique_ptr<Learner> loaded{Learner::Create({m})};
+    loaded->LoadModel(model);
+    for (auto approximate : {true, false}) {
+      auto expected = contribs(loaded.get(), approximate);
+      auto got = contribs(learner.get(), approximate);
+      ASSERT_EQ(got.size(), expected.size());
+      for (std::size_t i = 0; i < got.size(); ++i) {
+        ASSERT_NEAR(got[i], expected[i], kRtEps);
+      }
+    }
+  };
+
+  for (std::int32_t i = 0; i < 4; ++i) {
+    learner->UpdateOneIter(i, m);
+    check();
+  }
+}
+
 TEST(GBTree, PredictRange) {
   size_t n_samples = 1000, n_features = 10, n_classes = 4;
   auto m = RandomDataGenerator{n_samples, n_features, 0.5}.Classes(n_classes).GenerateDMatrix(true);
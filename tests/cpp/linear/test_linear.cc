@@ -7,6 +7,7 @@
 #include "../helpers.h"
 #include "test_json_io.h"
 #include "../../../src/gbm/gblinear_model.h"
+#include "../../../src/linear/coordinate_common.h"
 #include "xgboost/base.h"
 
 namespace xgboost {
@@ -64,6 +65,86 @@ TEST(Linear, coordinate) {
   ASSERT_EQ(model.Bias()[0], 5.0f);
 }
 
+TEST(Linear, ColumnGradient) {
+  bst_idx_t constexpr kRows = 64;
+  bst_feature_t constexpr kCols = 4;
+  Context ctx;
+  std::vector<GradientPair> gpair(kRows);
+  for (bst_idx_t i = 0; i < kRows; ++i) {
+    gpair[i] = GradientPair{static_cast<float>(i % 5) - 2.0f, i % 7 == 0 ? -1.0f : 0.5f};
+  }
+  // The contiguous path for dense columns and the gather path for sparse columns.
+  for (float sparsity : {0.0f, 0.5f}) {
+    auto p_fmat = RandomDataGenerator{kRows, kCols, sparsity}.GenerateDMatrix();
+    for (auto const& batch : p_fmat->GetBatches<CSCPage>(&ctx)) {
+      auto page = batch.GetView();
+      for (bst_feature_t fidx = 0; fidx < kCols; ++fidx) {
+        auto col = page[fidx];
+        double sum_grad = 0.0, sum_hess = 0.0;
+        for (auto const& c : col) {
+          auto const& p = gpair[c.index];
+          if (p.GetHess() < 0.0f) {
+            continue;
+          }
+          sum_grad += p.GetGrad() * c.fvalue;
+          sum_hess += p.GetHess() * c.fvalue * c.fvalue;
+        }
+        auto [grad, hess] = linear::GetColumnGradient(col, 0, 1, gpair.data());
+        ASSERT_NEAR(grad, sum_grad, 1e-5);
+        ASSERT_NEAR(hess, sum_hess, 1e-5);
+
+        auto expected = gpair;
+        for (auto const& c : col) {
+          if (expected[c.index].GetHess() >= 0.0f) {
+            auto h = expected[c.index].GetHess();
+            expected[c.index] += GradientPair{h * c.fvalue * 0.5f, 0.0f};
+          }
+        }
+        auto updated = gpair;
+        linear::UpdateColumnResidual(col, 0, 1, 0.5f, updated.data());
+        for (bst_idx_t i = 0; i < kRows; ++i) {
+          ASSERT_FLOAT_EQ(updated[i].GetGrad(), expected[i].GetGrad());
+          ASSERT_EQ(updated[i].GetHess(), expected[i].GetHess());
+        }
+      }
+    }
+  }
+}
+
+TEST(Linear, GreedyIncrementalSums) {
+  bst_idx_t constexpr kRows = 1000;
+  bst_feature_t constexpr kCols = 50;
+  Context ctx;
+  ctx.UpdateAllowUnknown(Args{{"nthread", "2"}});
+  auto p_fmat = RandomDataGenerator{kRows, kCols, 0.9}.GenerateDMatrix();
+  LearnerModelParam mparam{MakeMP(kCols, .5, 1)};
+  gbm::GBLinearModel model{&mparam};
+  model.LazyInitModel();
+  std::vector<GradientPair> gpair(kRows);
+  for (bst_idx_t i = 0; i < kRows; ++i) {
+    gpair[i] = GradientPair{static_cast<float>(i % 13) / 13.0f - 0.5f, 1.0f};
+  }
+
+  float constexpr kAlpha = 0.0f, kLambda = 1.0f;
+  std::unique_ptr<linear::FeatureSelector> selector{
+      linear::FeatureSelector::Create(linear::kGreedy)};
+  selector->Setup(&ctx, model, gpair, p_fmat.get(), kAlpha, kLambda, 0);
+  for (std::int32_t k = 0; k < 8; ++k) {
+    auto fidx = selector->NextFeature(&ctx, k, model, 0, gpair, p_fmat.get(), kAlpha, kLambda);
+    // A new selector computes the sums from all the columns.
+    std::unique_ptr<linear::FeatureSelector> full{
+        linear::FeatureSelector::Create(linear::kGreedy)};
+    full->Setup(&ctx, model, gpair, p_fmat.get(), kAlpha, kLambda, 0);
+    ASSERT_EQ(fidx, full->NextFeature(&ctx, 0, model, 0, gpair, p_fmat.get(), kAlpha, kLambda));
+
+    auto [sum_grad, sum_hess] = linear::GetGradient(&ctx, 0, 1, fidx, gpair, p_fmat.get());
+    auto dw = static_cast<float>(
+        linear::CoordinateDelta(sum_grad, sum_hess, model[fidx][0], kAlpha, kLambda));
+    model[fidx][0] += dw;
+    linear::UpdateResidualParallel(&ctx, fidx, 0, 1, dw, &gpair, p_fmat.get());
+  }
+}
+
 TEST(Coordinate, JsonIO){
   TestUpdaterJsonIO("coord_descent");
 }
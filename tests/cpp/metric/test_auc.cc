@@ -0,0 +1,78 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <gtest/gtest.h>      // for Test, ASSERT_NEAR, ASSERT_EQ
+#include <xgboost/context.h>  // for Context
+#include <xgboost/linalg.h>   // for Matrix
+#include <xgboost/metric.h>   // for Metric
+
+#include <cmath>    // for log, isnan
+#include <memory>   // for unique_ptr
+#include <random>   // for mt19937, uniform_real_distribution, bernoulli_distribution
+#include <string>   // for string
+#include <utility>  // for as_const
+#include <vector>   // for vector
+
+#include "../../../src/metric/auc.h"  // for HistogramROCAUC, HistogramPRAUC
+#include "../helpers.h"               // for GetMetricEval
+
+namespace xgboost::metric {
+TEST(Metric, HistogramAUC) {
+  // Bins in descending order of the prediction, (negative, positive) in each bin.
+  linalg::Matrix<double> hist{{0.0, 2.0, 1.0, 1.0, 2.0, 0.0}, {3, 2}, DeviceOrd::CPU()};
+  auto [roc, roc_bound] = detail::HistogramROCAUC(std::as_const(hist).HostView());
+  ASSERT_NEAR(roc, (2.0 * 3.0 + 0.5 * 1.0 + 1.0 * 2.0) / 9.0, kRtEps);
+  ASSERT_NEAR(roc_bound, 0.5 / 9.0, kRtEps);
+
+  auto [pr, pr_bound] = detail::HistogramPRAUC(std::as_const(hist).HostView());
+  ASSERT_GT(pr, 0.0);
+  ASSERT_LE(pr, 1.0);
+  // Only the second bin has both positive and negative samples.
+  ASSERT_NEAR(pr_bound, std::log(4.0 / 3.0) / 3.0, kRtEps);
+
+  linalg::Matrix<double> invalid{{1.0, 0.0, 2.0, 0.0}, {2, 2}, DeviceOrd::CPU()};
+  ASSERT_TRUE(std::isnan(detail::HistogramROCAUC(std::as_const(invalid).HostView()).first));
+  ASSERT_TRUE(std::isnan(detail::HistogramPRAUC(std::as_const(invalid).HostView()).first));
+}
+
+TEST(Metric, ApproxAUC) {
+  Context ctx;
+  std::size_t n = 4096;
+  std::mt19937 rng{1};
+  std::uniform_real_distribution<float> dist{0.0f, 1.0f};
+  std::vector<float> labels(n);
+  std::vector<float> weights(n);
+  HostDeviceVector<float> predts(n);
+  auto& h_predts = predts.HostVector();
+  for (std::size_t i = 0; i < n; ++i) {
+    labels[i] = std::bernoulli_distribution{0.3}(rng);
+    h_predts[i] = 0.5f * labels[i] + dist(rng);
+    weights[i] = dist(rng) + 0.5f;
+  }
+
+  for (auto name : {"auc", "aucpr"}) {
+    std::unique_ptr<Metric> exact{Metric::Create(name, &ctx)};
+    auto expected = GetMetricEval(exact.get(), predts, labels, weights);
+
+    std::unique_ptr<Metric> approx{Metric::Create(name, &ctx)};
+    approx->Configure(Args{{"auc_approx_bins", "512"}, {"auc_approx_tolerance", "1.0"}});
+    auto got = GetMetricEval(approx.get(), predts, labels, weights);
+    ASSERT_NE(got, expected);
+    ASSERT_NEAR(got, expected, 1e-2);
+
+    // The bound can't be met, fall back to the exact AUC.
+    approx->Configure(Args{{"auc_approx_tolerance", "0.0"}});
+    ASSERT_EQ(GetMetricEval(approx.get(), predts, labels, weights), expected);
+
+    Json config{Object{}};
+    approx->SaveConfig(&config);
+    ASSERT_EQ(get<String const>(config["auc_param"]["auc_approx_bins"]), "512");
+  }
+
+  // Each bin has a unique prediction, the approximation is exact.
+  std::unique_ptr<Metric> approx{Metric::Create("auc", &ctx)};
+  approx->Configure(Args{{"auc_approx_bins", "5"}, {"auc_approx_tolerance", "0.0"}});
+  ASSERT_NEAR(GetMetricEval(approx.get(), {0.0f, 0.25f, 0.5f, 0.75f, 1.0f}, {0, 1, 0, 1, 1}),
+              5.0 / 6.0, kRtEps);
+}
+}  // namespace xgboost::metric
@@ -1,6 +1,11 @@
 // Copyright by Contributors
 #include <xgboost/metric.h>
 
+#include <memory>  // for unique_ptr
+#include <string>  // for string
+#include <vector>  // for vector
+
+#include "../../../src/metric/metric_common.h"  // for EvaluateMetrics
 #include "../helpers.h"
 namespace xgboost {
 TEST(Metric, UnknownMetric) {
@@ -14,4 +19,74 @@ TEST(Metric, UnknownMetric) {
   EXPECT_NO_THROW(metric = xgboost::Metric::Create("error@0.5f", &ctx));
   delete metric;
 }
+
+namespace {
+void CheckFused(Context const* ctx, std::vector<std::string> const& names,
+                HostDeviceVector<float> const& predts, std::shared_ptr<DMatrix> p_fmat) {
+  std::vector<std::unique_ptr<Metric>> metrics;
+  for (auto const& name : names) {
+    metrics.emplace_back(Metric::Create(name, ctx));
+    metrics.back()->Configure({});
+  }
+  auto results = metric::EvaluateMetrics(ctx, metrics, predts, p_fmat);
+  ASSERT_EQ(results.size(), names.size());
+  for (std::size_t i = 0; i < metrics.size(); ++i) {
+    // Same as evaluating the metric alone.
+    ASSERT_EQ(results[i], metrics[i]->Evaluate(predts, p_fmat)) << names[i];
+  }
+}
+}  // anonymous namespace
+
+TEST(Metric, Fused) {
+  Context ctx;
+  bst_idx_t n_samples = 5000;
+  SimpleLCG lcg;
+  SimpleRealUniformDistribution<float> dist{0.01f, 0.99f};
+
+  auto p_fmat = EmptyDMatrix();
+  auto& info = p_fmat->Info();
+  info.num_row_ = n_samples;
+  info.labels.Reshape(n_samples, 1);
+  auto& h_labels = info.labels.Data()->HostVector();
+  HostDeviceVector<float> predts(n_samples);
+  auto& h_predts = predts.HostVector();
+  for (bst_idx_t i = 0; i < n_samples; ++i) {
+    h_labels[i] = i % 3 == 0 ? 1.0f : 0.0f;
+    h_predts[i] = dist(&lcg);
+  }
+  for (bool weighted : {false, true}) {
+    if (weighted) {
+      info.weights_.Resize(n_samples);
+      for (auto& w : info.weights_.HostVector()) {
+        w = dist(&lcg);
+      }
+    }
+    // Includes metrics that are not fused.
+    CheckFused(&ctx, {"rmse", "mae", "mphe", "logloss", "error", "auc", "rmsle"}, predts,
+               p_fmat);
+  }
+
+  // Multi-class
+  std::size_t n_classes = 4;
+  info.weights_.Resize(0);
+  predts.Resize(n_samples * n_classes);
+  for (bst_idx_t i = 0; i < n_samples; ++i) {
+    h_labels[i] = static_cast<float>(i % n_classes);
+    float sum = 0;
+    for (std::size_t k = 0; k < n_classes; ++k) {
+      h_predts[i * n_classes + k] = dist(&lcg);
+      sum += h_predts[i * n_classes + k];
+    }
+    for (std::size_t k = 0; k < n_classes; ++k) {
+      h_predts[i * n_classes + k] /= sum;
+    }
+  }
+  CheckFused(&ctx, {"merror", "mlogloss", "merror"}, predts, p_fmat);
+
+  h_labels[n_samples - 1] = static_cast<float>(n_classes);
+  std::vector<std::unique_ptr<Metric>> metrics;
+  metrics.emplace_back(Metric::Create("merror", &ctx));
+  metrics.emplace_back(Metric::Create("mlogloss", &ctx));
+  ASSERT_THROW({ auto r = metric::EvaluateMetrics(&ctx, metrics, predts, p_fmat); }, dmlc::Error);
+}
 }  // namespace xgboost
@@ -7,7 +7,14 @@
 #include <xgboost/context.h>  // for Context
 #include <xgboost/metric.h>   // for Metric
 
-#include <memory>  // for unique_ptr
+#include <algorithm>   // for stable_sort, sort, min
+#include <cmath>       // for log2
+#include <cstddef>     // for size_t
+#include <functional>  // for greater
+#include <memory>      // for unique_ptr
+#include <numeric>     // for iota
+#include <random>      // for mt19937, uniform_int_distribution, bernoulli_distribution
+#include <vector>      // for vector
 
 #include "../helpers.h"    // for GetMetricEval, CreateEmptyGe...
 #include "xgboost/base.h"  // for bst_float, kRtEps
@@ -26,4 +33,60 @@ TEST(Metric, AMS) {
   ASSERT_STREQ(metric->Name(), "ams@0");
   EXPECT_NEAR(GetMetricEval(metric.get(), {0, 1}, {0, 1}), 0.311f, 0.001f);
 }
+
+TEST(Metric, RankTopKTies) {
+  // Groups of different sizes with many tied predictions. The metrics sort only the top k
+  // of each group, the result should be the same as a full stable sort.
+  Context ctx;
+  ctx.UpdateAllowUnknown(Args{{"nthread", "4"}});
+  std::vector<bst_uint> gptr{0, 1, 4, 504, 530, 531};
+  std::mt19937 rng{3};
+  std::vector<float> labels(gptr.back());
+  HostDeviceVector<float> predts(gptr.back());
+  auto& h_predts = predts.HostVector();
+  for (std::size_t i = 0; i < labels.size(); ++i) {
+    labels[i] = std::bernoulli_distribution{0.2}(rng);
+    h_predts[i] = static_cast<float>(std::uniform_int_distribution<int>{0, 8}(rng)) / 8.0f;
+  }
+  labels.back() = 0.0f;
+
+  std::size_t k = 10;
+  double pre{0}, map{0}, ndcg{0};
+  for (std::size_t g = 0; g + 1 < gptr.size(); ++g) {
+    std::size_t n_samples = gptr[g + 1] - gptr[g];
+    std::vector<std::size_t> sorted_idx(n_samples);
+    std::iota(sorted_idx.begin(), sorted_idx.end(), gptr[g]);
+    std::stable_sort(sorted_idx.begin(), sorted_idx.end(),
+                     [&](auto l, auto r) { return h_predts[l] > h_predts[r]; });
+    auto n = std::min(k, n_samples);
+    double n_hits{0}, g_map{0}, dcg{0};
+    for (std::size_t i = 0; i < n; ++i) {
+      auto l = labels[sorted_idx[i]];
+      n_hits += l;
+      g_map += n_hits / static_cast<double>(i + 1) * l;
+      dcg += l / std::log2(static_cast<double>(i) + 2.0);
+    }
+    pre += n_hits / static_cast<double>(n);
+
+    std::vector<float> g_labels(labels.cbegin() + gptr[g], labels.cbegin() + gptr[g + 1]);
+    std::sort(g_labels.begin(), g_labels.end(), std::greater<>{});
+    double idcg{0}, n_rel{0};
+    for (std::size_t i = 0; i < g_labels.size(); ++i) {
+      n_rel += g_labels[i];
+      if (i < n) {
+        idcg += g_labels[i] / std::log2(static_cast<double>(i) + 2.0);
+      }
+    }
+    map += n_rel > 0 ? g_map / std::min(n_rel, static_cast<double>(k)) : 1.0;
+    ndcg += idcg > 0 ? dcg / idcg : 1.0;
+  }
+  auto n_groups = static_cast<double>(gptr.size() - 1);
+
+  std::unique_ptr<Metric> metric{Metric::Create("pre@10", &ctx)};
+  ASSERT_NEAR(GetMetricEval(metric.get(), predts, labels, {}, gptr), pre / n_groups, kRtEps);
+  metric.reset(Metric::Create("map@10", &ctx));
+  ASSERT_NEAR(GetMetricEval(metric.get(), predts, labels, {}, gptr), map / n_groups, kRtEps);
+  metric.reset(Metric::Create("ndcg@10", &ctx));
+  ASSERT_NEAR(GetMetricEval(metric.get(), predts, labels, {}, gptr), ndcg / n_groups, kRtEps);
+}
 }  // namespace xgboost::metric
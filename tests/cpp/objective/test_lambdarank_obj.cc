@@ -10,7 +10,9 @@
 #include <initializer_list>                     // for initializer_list
 #include <memory>                               // for unique_ptr, shared_ptr, make_shared
 #include <numeric>                              // for iota
+#include <random>                               // for mt19937, minstd_rand, uniform_int_distri...
 #include <string>                               // for char_traits, basic_string, string
+#include <utility>                              // for pair
 #include <vector>                               // for vector
 
 #include "../../../src/common/ranking_utils.h"  // for NDCGCache, LambdaRankParam
@@ -238,6 +240,73 @@ TEST(LambdaRank, MakePair) {
   }
 }
 
+TEST(LambdaRank, MakePairMeanTies) {
+  Context ctx;
+  MetaInfo info;
+  info.num_row_ = 257;
+  info.group_ptr_ = {0, 3, 100, 101, static_cast<bst_group_t>(info.num_row_)};
+  std::vector<float> h_label(info.num_row_);
+  std::vector<float> h_predt(info.num_row_);
+  std::mt19937 rng{3};
+  std::uniform_int_distribution<std::int32_t> label_dist{0, 4};
+  std::uniform_int_distribution<std::int32_t> predt_dist{0, 16};
+  for (std::size_t i = 0; i < info.num_row_; ++i) {
+    h_label[i] = label_dist(rng);
+    // Ties in the prediction as well.
+    h_predt[i] = predt_dist(rng);
+  }
+  info.labels = linalg::Matrix<float>{{info.num_row_}, DeviceOrd::CPU()};
+  info.labels.Data()->HostVector() = h_label;
+  auto g_label = info.labels.HostView().Slice(linalg::All(), 0);
+
+  ltr::LambdaRankParam param;
+  param.UpdateAllowUnknown(
+      Args{{"lambdarank_pair_method", "mean"}, {"lambdarank_num_pair_per_sample", "3"}});
+  auto p_cache = std::make_shared<ltr::NDCGCache>(&ctx, info, param);
+  auto rank_idx = p_cache->SortedIdx(&ctx, h_predt);
+
+  for (bst_group_t g = 0; g < p_cache->Groups(); ++g) {
+    auto beg = info.group_ptr_[g], cnt = info.group_ptr_[g + 1] - beg;
+    auto g_rank = rank_idx.subspan(beg, cnt);
+    auto gg_label = g_label.Slice(linalg::Range(beg, beg + cnt));
+    std::vector<std::pair<std::size_t, std::size_t>> pairs;
+    MakePairs(&ctx, 7, p_cache, g, gg_label, g_rank,
+              [&](auto i, auto j) { pairs.emplace_back(i, j); });
+
+    // Reference: stable sort of the rank list by label, then the same sampling.
+    std::vector<std::size_t> y_sorted_idx(cnt);
+    std::iota(y_sorted_idx.begin(), y_sorted_idx.end(), 0);
+    std::stable_sort(y_sorted_idx.begin(), y_sorted_idx.end(), [&](auto l, auto r) {
+      return gg_label(g_rank[l]) > gg_label(g_rank[r]);
+    });
+    auto y = [&](std::size_t k) { return gg_label(g_rank[y_sorted_idx[k]]); };
+    std::minstd_rand rnd(7);
+    rnd.discard(g);
+    std::vector<std::pair<std::size_t, std::size_t>> expected;
+    for (std::size_t i = 0; i < cnt;) {
+      std::size_t j = i + 1;
+      while (j < cnt && y(i) == y(j)) {
+        ++j;
+      }
+      std::size_t n_lefts = i, n_rights = cnt - j;
+      if (n_lefts + n_rights != 0) {
+        for (std::size_t p = 0; p < param.NumPair(); ++p) {
+          for (std::size_t k = i; k < j; ++k) {
+            auto ridx = std::uniform_int_distribution<std::size_t>(
+                static_cast<std::size_t>(0), n_lefts + n_rights - 1)(rnd);
+            if (ridx >= n_lefts) {
+              ridx = ridx - i + j;
+            }
+            expected.emplace_back(y_sorted_idx[k], y_sorted_idx[ridx]);
+          }
+        }
+      }
+      i = j;
+    }
+    ASSERT_EQ(pairs, expected);
+  }
+}
+
 void TestMAPStat(Context const* ctx) {
   auto p_fmat = EmptyDMatrix();
   MetaInfo& info = p_fmat->Info();
@@ -3,6 +3,12 @@
  */
 #include <xgboost/objective.h>
 #include <xgboost/context.h>
+
+#include <cmath>    // for exp
+#include <string>   // for to_string
+#include <utility>  // for make_pair
+#include <vector>   // for vector
+
 #include "../../src/common/common.h"
 #include "../helpers.h"
 #include "test_multiclass_obj.h"
@@ -55,6 +61,91 @@ void TestSoftmaxMultiClassBasic(const Context* ctx) {
   }
 }
 
+void TestSoftmaxMultiClassManyClasses(const Context* ctx) {
+  // Not a multiple of the SIMD width.
+  std::size_t constexpr kClasses = 37, kRows = 5;
+  std::unique_ptr<ObjFunction> obj{ObjFunction::Create("multi:softprob", ctx)};
+  obj->Configure(Args{{"num_class", std::to_string(kClasses)}});
+
+  std::vector<float> preds(kClasses * kRows);
+  for (std::size_t i = 0; i < preds.size(); ++i) {
+    preds[i] = static_cast<float>(i % 11) * 0.7f - 3.0f - static_cast<float>(i / kClasses);
+  }
+  MetaInfo info;
+  info.num_row_ = kRows;
+  info.labels.Reshape(kRows, 1);
+  for (std::size_t i = 0; i < kRows; ++i) {
+    info.labels.HostView()(i, 0) = static_cast<float>(i * 7);
+  }
+  info.weights_.HostVector() = {0.5f, 1.0f, 1.5f, 2.0f, 2.5f};
+
+  HostDeviceVector<float> in_preds{preds};
+  linalg::Matrix<GradientPair> out_gpair;
+  obj->GetGradient(in_preds, info, 0, &out_gpair);
+  auto const& h_gpair = out_gpair.Data()->ConstHostVector();
+  ASSERT_EQ(h_gpair.size(), preds.size());
+
+  for (std::size_t i = 0; i < kRows; ++i) {
+    auto point = common::Span{preds}.subspan(i * kClasses, kClasses);
+    double sum = 0;
+    for (auto v : point) {
+      sum += std::exp(static_cast<double>(v));
+    }
+    auto w = info.weights_.ConstHostVector()[i];
+    for (std::size_t k = 0; k < kClasses; ++k) {
+      double p = std::exp(static_cast<double>(point[k])) / sum;
+      double g = (k == i * 7 ? p - 1.0 : p) * w;
+      double h = 2.0 * p * (1.0 - p) * w;
+      ASSERT_NEAR(h_gpair[i * kClasses + k].GetGrad(), g, 1e-6);
+      ASSERT_NEAR(h_gpair[i * kClasses + k].GetHess(), h, 1e-6);
+    }
+  }
+}
+
+void TestSoftmaxMultiClassSparseGrad(const Context* ctx) {
+  std::size_t constexpr kClasses = 37, kRows = 5;
+  float constexpr kEps = 0.01f;
+  std::vector<float> preds(kClasses * kRows);
+  for (std::size_t i = 0; i < preds.size(); ++i) {
+    preds[i] = static_cast<float>(i % 11) * 0.7f - 3.0f - static_cast<float>(i / kClasses);
+  }
+  MetaInfo info;
+  info.num_row_ = kRows;
+  info.labels.Reshape(kRows, 1);
+  for (std::size_t i = 0; i < kRows; ++i) {
+    info.labels.HostView()(i, 0) = static_cast<float>(i * 7);
+  }
+  HostDeviceVector<float> in_preds{preds};
+
+  auto get_gradient = [&](Args const& args) {
+    std::unique_ptr<ObjFunction> obj{ObjFunction::Create("multi:softprob", ctx)};
+    obj->Configure(args);
+    linalg::Matrix<GradientPair> out_gpair;
+    obj->GetGradient(in_preds, info, 0, &out_gpair);
+    return std::make_pair(obj->Task(), out_gpair.Data()->ConstHostVector());
+  };
+  auto [dense_task, dense] = get_gradient(Args{{"num_class", std::to_string(kClasses)}});
+  ASSERT_FALSE(dense_task.sparse_grad);
+  auto [sparse_task, sparse] = get_gradient(
+      Args{{"num_class", std::to_string(kClasses)}, {"sparse_grad_eps", std::to_string(kEps)}});
+  ASSERT_TRUE(sparse_task.sparse_grad);
+
+  ASSERT_EQ(sparse.size(), dense.size());
+  std::size_t n_truncated = 0;
+  for (std::size_t i = 0; i < dense.size(); ++i) {
+    if (std::abs(dense[i].GetGrad()) < kEps) {
+      ASSERT_EQ(sparse[i].GetGrad(), 0.0f);
+      ASSERT_EQ(sparse[i].GetHess(), 0.0f);
+      ++n_truncated;
+    } else {
+      ASSERT_EQ(sparse[i].GetGrad(), dense[i].GetGrad());
+      ASSERT_EQ(sparse[i].GetHess(), dense[i].GetHess());
+    }
+  }
+  ASSERT_GT(n_truncated, 0);
+  ASSERT_LT(n_truncated, dense.size());
+}
+
 void TestSoftprobMultiClassBasic(const Context* ctx) {
   std::vector<std::pair<std::string, std::string>> args {
     std::pair<std::string, std::string>("num_class", "3")};
@@ -12,6 +12,10 @@ void TestSoftmaxMultiClassObjGPair(const Context* ctx);
 
 void TestSoftmaxMultiClassBasic(const Context* ctx);
 
+void TestSoftmaxMultiClassManyClasses(const Context* ctx);
+
+void TestSoftmaxMultiClassSparseGrad(const Context* ctx);
+
 void TestSoftprobMultiClassBasic(const Context* ctx);
 
 }  // namespace xgboost
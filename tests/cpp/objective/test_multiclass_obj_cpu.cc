@@ -18,6 +18,16 @@ TEST(Objective, DeclareUnifiedTest(SoftmaxMultiClassBasic)) {
   TestSoftmaxMultiClassBasic(&ctx);
 }
 
+TEST(Objective, DeclareUnifiedTest(SoftmaxMultiClassManyClasses)) {
+  auto ctx = MakeCUDACtx(GPUIDX);
+  TestSoftmaxMultiClassManyClasses(&ctx);
+}
+
+TEST(Objective, DeclareUnifiedTest(SoftmaxMultiClassSparseGrad)) {
+  auto ctx = MakeCUDACtx(GPUIDX);
+  TestSoftmaxMultiClassSparseGrad(&ctx);
+}
+
 TEST(Objective, DeclareUnifiedTest(SoftprobMultiClassBasic)) {
   Context ctx = MakeCUDACtx(GPUIDX);
   TestSoftprobMultiClassBasic(&ctx);
@@ -1,15 +1,19 @@
 /**
  * Copyright 2017-2024 by XGBoost contributors
  */
-#include <xgboost/base.h>       // Args
-#include <xgboost/context.h>    // Context
-#include <xgboost/objective.h>  // ObjFunction
-#include <xgboost/span.h>       // Span
+#include <xgboost/base.h>                     // Args
+#include <xgboost/context.h>                  // Context
+#include <xgboost/multi_target_tree_model.h>  // MultiTargetTree
+#include <xgboost/objective.h>                // ObjFunction
+#include <xgboost/span.h>                     // Span
+#include <xgboost/tree_model.h>               // RegTree
 
-#include <memory>               // std::unique_ptr
-#include <vector>               // std::vector
+#include <cstddef>                            // std::size_t
+#include <memory>                             // std::unique_ptr
+#include <numeric>                            // std::iota
+#include <vector>                             // std::vector
 
-#include "../helpers.h"         // CheckConfigReload,MakeCUDACtx,DeclareUnifiedTest
+#include "../helpers.h"                       // CheckConfigReload,MakeCUDACtx,DeclareUnifiedTest
 
 #include "test_quantile_obj.h"
 
@@ -70,4 +74,49 @@ void TestQuantileIntercept(const Context* ctx) {
   // mean([3, 5])
   ASSERT_NEAR(base_scores(0), 4.0, kRtEps);
 }
+
+void TestQuantileMultiTargetLeaf(const Context* ctx) {
+  Args args{{"quantile_alpha", "[0.9, 0.1, 0.5]"}};
+  std::unique_ptr<ObjFunction> obj{ObjFunction::Create("reg:quantileerror", ctx)};
+  obj->Configure(args);
+
+  bst_target_t n_targets{3};
+  MetaInfo info;
+  info.num_row_ = 16;
+  info.labels.Reshape(info.num_row_, 1);
+  auto& h_labels = info.labels.Data()->HostVector();
+  std::iota(h_labels.begin(), h_labels.end(), 0.0f);
+
+  // The prediction of the 0.1 quantile is lower than the others, the quantiles of the
+  // residuals cross.
+  HostDeviceVector<float> predt(info.num_row_ * n_targets, 0.0f);
+  auto h_predt = linalg::MakeTensorView(ctx, predt.HostSpan(), info.num_row_, n_targets);
+  for (std::size_t i = 0; i < info.num_row_; ++i) {
+    h_predt(i, 1) = -10.0f;
+  }
+
+  HostDeviceVector<bst_node_t> position(info.num_row_);
+  auto& h_position = position.HostVector();
+  for (std::size_t i = 0; i < h_position.size(); ++i) {
+    h_position[i] = i < info.num_row_ / 2 ? 1 : 2;
+  }
+
+  RegTree tree{n_targets, 1};
+  linalg::Vector<float> weight{{1.0f, 2.0f, 3.0f}, {3ul}, DeviceOrd::CPU()};
+  tree.ExpandNode(RegTree::kRoot, /*split_idx=*/0, 0.5f, true, weight.HostView(),
+                  weight.HostView(), weight.HostView());
+
+  float lr = 0.5f;
+  obj->UpdateTreeLeaf(position, info, lr, predt, 0, &tree);
+  auto check = [&](bst_node_t nidx, std::vector<float> const& expected) {
+    auto leaf = tree.GetMultiTargetTree()->LeafValue(nidx);
+    for (bst_target_t t = 0; t < n_targets; ++t) {
+      ASSERT_EQ(leaf(t), expected[t] * lr);
+    }
+  };
+  // Without rearrangement, the leaf values of the left leaf are {7, 10, 3.5}. They are
+  // sorted by alpha, 0.1 for target 1, 0.5 for target 2 and 0.9 for target 0.
+  check(1, {10.0f, 3.5f, 7.0f});
+  check(2, {18.0f, 11.5f, 15.0f});
+}
 }  // namespace xgboost
@@ -12,6 +12,8 @@ void TestQuantile(const Context* ctx);
 
 void TestQuantileIntercept(const Context* ctx);
 
+void TestQuantileMultiTargetLeaf(const Context* ctx);
+
 }  // namespace xgboost
 
 #endif  // XGBOOST_TEST_REGRESSION_OBJ_H_
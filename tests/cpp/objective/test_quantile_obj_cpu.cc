@@ -17,4 +17,12 @@ TEST(Objective, DeclareUnifiedTest(QuantileIntercept)) {
   Context ctx = MakeCUDACtx(GPUIDX);
   TestQuantileIntercept(&ctx);
 }
+
+// Vector leaf is not yet supported by the GPU.
+#if !defined(__CUDACC__)
+TEST(Objective, QuantileMultiTargetLeaf) {
+  Context ctx;
+  TestQuantileMultiTargetLeaf(&ctx);
+}
+#endif  // !defined(__CUDACC__)
 }  // namespace xgboost
@@ -4,12 +4,14 @@
 #include <gtest/gtest.h>
 #include <xgboost/span.h>  // for Span
 
-#include <array>  // for array
+#include <array>    // for array
+#include <numeric>  // for iota
+#include <vector>   // for vector
 
 #include "../../../../src/common/type.h"   // for EraseType
 #include "../../collective/test_worker.h"  // for SocketTest
 #include "federated_coll.h"                // for FederatedColl
-#include "federated_comm.h"                // for FederatedComm
+#include "federated_comm.h"                // for FederatedComm, kStreamThresholdBytes
 #include "test_worker.h"                   // for TestFederated
 
 namespace xgboost::collective {
@@ -35,6 +37,23 @@ TEST_F(FederatedCollTest, Allreduce) {
   });
 }
 
+TEST_F(FederatedCollTest, AllreduceStream) {
+  std::int32_t n_workers = std::min(std::thread::hardware_concurrency(), 3u);
+  TestFederated(n_workers, [=](std::shared_ptr<FederatedComm> comm, std::int32_t) {
+    // Large enough to be sent in multiple chunks.
+    std::vector<std::int32_t> buffer(kStreamThresholdBytes / sizeof(std::int32_t) + 3);
+    std::iota(buffer.begin(), buffer.end(), 0);
+
+    FederatedColl coll{};
+    auto rc = coll.Allreduce(*comm, common::EraseType(common::Span{buffer.data(), buffer.size()}),
+                             ArrayInterfaceHandler::kI4, Op::kSum);
+    SafeColl(rc);
+    for (std::size_t i = 0; i < buffer.size(); i++) {
+      ASSERT_EQ(buffer[i], static_cast<std::int32_t>(i) * n_workers);
+    }
+  });
+}
+
 TEST_F(FederatedCollTest, Broadcast) {
   std::int32_t n_workers = std::min(std::thread::hardware_concurrency(), 3u);
   TestFederated(n_workers, [=](std::shared_ptr<FederatedComm> comm, std::int32_t) {
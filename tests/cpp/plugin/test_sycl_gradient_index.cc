@@ -9,6 +9,7 @@
 #pragma GCC diagnostic pop
 
 #include "../../../plugin/sycl/data/gradient_index.h"
+#include "../../../plugin/sycl/common/quantile.h"
 #include "../../../plugin/sycl/device_manager.h"
 #include "sycl_helpers.h"
 #include "../helpers.h"
@@ -51,4 +52,49 @@ TEST(SyclGradientIndex, Init) {
   }
 }
 
+TEST(SyclGradientIndex, SketchOnDevice) {
+  size_t n_columns = 5;
+  int max_bins = 64;
+
+  Context ctx;
+  ctx.UpdateAllowUnknown(Args{{"device", "sycl"}});
+
+  DeviceManager device_manager;
+  auto qu = device_manager.GetQueue(ctx.Device());
+
+  {
+    // Fewer unique values than bins, the cuts are exact.
+    auto p_fmat = RandomDataGenerator{48, n_columns, 0.2}.GenerateDMatrix();
+    ASSERT_TRUE(common::CanSketchOnDevice(p_fmat.get()));
+    auto cuts_sycl = common::SketchOnDevice(qu, &ctx, p_fmat.get(), max_bins);
+    Context cpu_ctx;
+    auto cuts = xgboost::common::SketchOnDMatrix(&cpu_ctx, p_fmat.get(), max_bins);
+    VerifySyclVector(cuts_sycl.cut_ptrs_.ConstHostVector(), cuts.cut_ptrs_.ConstHostVector());
+    VerifySyclVector(cuts_sycl.cut_values_.ConstHostVector(), cuts.cut_values_.ConstHostVector());
+    VerifySyclVector(cuts_sycl.min_vals_.ConstHostVector(), cuts.min_vals_.ConstHostVector());
+  }
+
+  {
+    auto p_fmat = RandomDataGenerator{1024, n_columns, 0.0}.GenerateDMatrix();
+    auto cuts = common::SketchOnDevice(qu, &ctx, p_fmat.get(), max_bins);
+    const auto& ptrs = cuts.cut_ptrs_.ConstHostVector();
+    const auto& values = cuts.cut_values_.ConstHostVector();
+    ASSERT_EQ(ptrs.size(), n_columns + 1);
+    for (size_t fid = 0; fid < n_columns; ++fid) {
+      ASSERT_GT(ptrs[fid + 1], ptrs[fid]);
+      ASSERT_LE(ptrs[fid + 1] - ptrs[fid], static_cast<uint32_t>(max_bins));
+      for (auto i = ptrs[fid] + 1; i < ptrs[fid + 1]; ++i) {
+        ASSERT_GT(values[i], values[i - 1]);
+      }
+    }
+  }
+
+  {
+    // Weighted samples use the host sketch.
+    auto p_fmat = RandomDataGenerator{48, n_columns, 0.0}.GenerateDMatrix();
+    p_fmat->Info().weights_.HostVector().resize(48, 1.0f);
+    ASSERT_FALSE(common::CanSketchOnDevice(p_fmat.get()));
+  }
+}
+
 }  // namespace xgboost::sycl::data
@@ -5,6 +5,11 @@
 
 #include <oneapi/dpl/random>
 
+#include <numeric>  // for iota
+#include <string>   // for string
+#include <utility>  // for make_pair
+#include <vector>   // for vector
+
 #include "../../../plugin/sycl/tree/hist_updater.h"
 #include "../../../plugin/sycl/device_manager.h"
 
@@ -558,6 +563,64 @@ void TestHistUpdaterExpandWithDepthWise(const xgboost::tree::TrainParam& param)
   ASSERT_NEAR(ans[2], -0.15, 1e-6);
 }
 
+template <typename GradientSumT>
+void TestHistUpdaterLossGuideBatch() {
+  const size_t num_rows = 64;
+  const size_t num_columns = 1;
+  const size_t n_bins = 16;
+
+  Context ctx;
+  ctx.UpdateAllowUnknown(Args{{"device", "sycl"}});
+
+  DeviceManager device_manager;
+  auto qu = device_manager.GetQueue(ctx.Device());
+
+  std::vector<float> data(num_rows);
+  std::iota(data.begin(), data.end(), 0.0f);
+  auto p_fmat = GetDMatrixFromData(data, num_rows, num_columns);
+  common::GHistIndexMatrix gmat;
+  gmat.Init(qu, &ctx, p_fmat.get(), n_bins);
+
+  HostDeviceVector<GradientPair> gpair(num_rows, {0, 0}, ctx.Device());
+  GenerateRandomGPairs(qu, gpair.DevicePointer(), num_rows, false);
+
+  // Without a limit on the number of leaves, the loss guided tree expands all nodes of a
+  // level in a single batch and matches the depth wise tree.
+  auto grow = [&](std::string policy) {
+    xgboost::tree::TrainParam param;
+    param.UpdateAllowUnknown(Args{{"max_depth", "3"}, {"grow_policy", policy}});
+    RegTree tree;
+    FeatureInteractionConstraintHost int_constraints;
+    TestHistUpdater<GradientSumT> updater(&ctx, qu, param, int_constraints, p_fmat.get());
+    updater.SetHistSynchronizer(new BatchHistSynchronizer<GradientSumT>());
+    updater.SetHistRowsAdder(new BatchHistRowsAdder<GradientSumT>());
+    updater.TestInitData(gmat, gpair, *p_fmat, tree);
+    if (policy == "lossguide") {
+      updater.TestExpandWithLossGuide(gmat, p_fmat.get(), &tree, gpair);
+    } else {
+      updater.TestExpandWithDepthWise(gmat, p_fmat.get(), &tree, gpair);
+    }
+    const auto& nodes = tree.GetNodes();
+    std::vector<float> leaf(data.size());
+    for (size_t data_idx = 0; data_idx < data.size(); ++data_idx) {
+      size_t node_idx = 0;
+      while (!nodes[node_idx].IsLeaf()) {
+        node_idx = data[data_idx] < nodes[node_idx].SplitCond() ? nodes[node_idx].LeftChild()
+                                                                : nodes[node_idx].RightChild();
+      }
+      leaf[data_idx] = nodes[node_idx].LeafValue();
+    }
+    return std::make_pair(tree.NumNodes(), leaf);
+  };
+
+  auto [n_nodes, leaf] = grow("lossguide");
+  auto [expected_n_nodes, expected_leaf] = grow("depthwise");
+  ASSERT_EQ(n_nodes, expected_n_nodes);
+  for (size_t i = 0; i < leaf.size(); ++i) {
+    ASSERT_NEAR(leaf[i], expected_leaf[i], 1e-6);
+  }
+}
+
 TEST(SyclHistUpdater, Sampling) {
   xgboost::tree::TrainParam param;
   param.UpdateAllowUnknown(Args{{"subsample", "0.7"}});
@@ -634,6 +697,11 @@ TEST(SyclHistUpdater, ExpandWithLossGuide) {
   TestHistUpdaterExpandWithLossGuide<double>(param);
 }
 
+TEST(SyclHistUpdater, LossGuideBatch) {
+  TestHistUpdaterLossGuideBatch<float>();
+  TestHistUpdaterLossGuideBatch<double>();
+}
+
 TEST(SyclHistUpdater, ExpandWithDepthWise) {
   xgboost::tree::TrainParam param;
   param.UpdateAllowUnknown(Args{{"max_depth", "2"}});
@@ -107,4 +107,41 @@ TEST(SyclPredictor, Multi) {
   TestVectorLeafPrediction(&ctx);
 }
 
+TEST(SyclPredictor, WorkGroupTraversal) {
+  bst_feature_t constexpr kCols = 16;
+  auto p_train = RandomDataGenerator{256, kCols, 0.2}.Classes(3).GenerateDMatrix(true);
+  std::unique_ptr<Learner> learner{Learner::Create({p_train})};
+  learner->SetParams(Args{{"device", "sycl"}, {"objective", "multi:softprob"},
+                          {"num_class", "3"}});
+
+  auto check = [&] {
+    Json model{Object{}};
+    learner->SaveModel(&model);
+    std::unique_ptr<Learner> cpu{Learner::Create({p_train})};
+    cpu->LoadModel(model);
+    cpu->SetParam("device", "cpu");
+    // Few rows for the work-group traversal and many rows for the row traversal.
+    for (bst_idx_t n_samples : {3, 4096}) {
+      auto p_fmat = RandomDataGenerator{n_samples, kCols, 0.2}.Seed(n_samples).GenerateDMatrix();
+      HostDeviceVector<float> predt, expected;
+      learner->Predict(p_fmat, true, &predt, 0, 0);
+      cpu->Predict(p_fmat, true, &expected, 0, 0);
+      auto const& h_predt = predt.ConstHostVector();
+      auto const& h_expected = expected.ConstHostVector();
+      ASSERT_EQ(h_predt.size(), n_samples * 3);
+      ASSERT_EQ(h_predt.size(), h_expected.size());
+      for (std::size_t i = 0; i < h_expected.size(); ++i) {
+        ASSERT_NEAR(h_predt[i], h_expected[i], kRtEps);
+      }
+    }
+  };
+  for (std::int32_t i = 0; i < 8; ++i) {
+    learner->UpdateOneIter(i, p_train);
+  }
+  check();
+  // The cached device model is refreshed once the model is updated.
+  learner->UpdateOneIter(8, p_train);
+  check();
+}
+
 }  // namespace xgboost
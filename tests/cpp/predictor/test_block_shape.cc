@@ -0,0 +1,52 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+
+#include <cstddef>  // for size_t
+#include <vector>   // for vector
+
+#include "../../../src/predictor/block_shape.h"
+
+namespace xgboost::predictor {
+TEST(BlockShape, Rows) {
+  std::size_t constexpr kCacheSize = 1024 * 1024;
+  std::vector<std::size_t> tree_bytes(4, 1024);
+  // Narrow data keeps the full block.
+  auto shape = ChooseBlockShape(64, 128 * sizeof(float), 0, tree_bytes, kCacheSize);
+  ASSERT_EQ(shape.n_rows, 64);
+  // 16 rows of 32KB fit in half of the cache.
+  shape = ChooseBlockShape(64, 8192 * sizeof(float), 0, tree_bytes, kCacheSize);
+  ASSERT_EQ(shape.n_rows, 16);
+  // Not smaller than the minimum.
+  shape = ChooseBlockShape(64, 1024 * 1024, 0, tree_bytes, kCacheSize);
+  ASSERT_EQ(shape.n_rows, 8);
+  // Unblocked prediction.
+  shape = ChooseBlockShape(1, 1024 * 1024, 0, tree_bytes, kCacheSize);
+  ASSERT_EQ(shape.n_rows, 1);
+}
+
+TEST(BlockShape, Tiles) {
+  std::size_t constexpr kCacheSize = 1024;
+  // The whole model fits in the cache.
+  std::vector<std::size_t> tree_bytes{100, 100, 100};
+  auto shape = ChooseBlockShape(64, 4, 2, tree_bytes, kCacheSize);
+  ASSERT_EQ(shape.NumTiles(), 1);
+  ASSERT_EQ(shape.tree_ptr, (std::vector<bst_tree_t>{2, 5}));
+
+  // A tree larger than the budget gets its own tile.
+  tree_bytes = {300, 200, 1000, 100, 100, 400};
+  shape = ChooseBlockShape(64, 4, 2, tree_bytes, kCacheSize);
+  ASSERT_EQ(shape.tree_ptr, (std::vector<bst_tree_t>{2, 4, 5, 7, 8}));
+
+  // Empty range.
+  shape = ChooseBlockShape(64, 4, 3, {}, kCacheSize);
+  ASSERT_EQ(shape.NumTiles(), 1);
+  ASSERT_EQ(shape.tree_ptr, (std::vector<bst_tree_t>{3, 3}));
+
+  // Unknown cache size.
+  tree_bytes.assign(4, DefaultL2CacheSize() / 4);
+  shape = ChooseBlockShape(64, 4, 0, tree_bytes, 0);
+  ASSERT_EQ(shape.tree_ptr, (std::vector<bst_tree_t>{0, 2, 4}));
+}
+}  // namespace xgboost::predictor
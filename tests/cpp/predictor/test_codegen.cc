@@ -0,0 +1,116 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+#include <xgboost/context.h>                  // for Context
+#include <xgboost/learner.h>                  // for Learner
+#include <xgboost/multi_target_tree_model.h>  // for MultiTargetTree
+#include <xgboost/tree_model.h>               // for RegTree
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t
+#include <memory>   // for make_unique, unique_ptr
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "../../../src/common/bitfield.h"     // for LBitField32
+#include "../../../src/gbm/gbtree_model.h"    // for GBTreeModel
+#include "../../../src/predictor/codegen.h"   // for GenerateCode
+#include "../helpers.h"                       // for MakeMP, RandomDataGenerator
+
+namespace xgboost::predictor {
+namespace {
+std::size_t Count(std::string const& str, std::string const& pattern) {
+  std::size_t n{0};
+  for (auto pos = str.find(pattern); pos != std::string::npos;
+       pos = str.find(pattern, pos + pattern.size())) {
+    ++n;
+  }
+  return n;
+}
+}  // namespace
+
+TEST(Codegen, Scalar) {
+  Context ctx;
+  bst_feature_t constexpr kCols = 3;
+  LearnerModelParam mparam{MakeMP(kCols, 0.5, 2)};
+  gbm::GBTreeModel model{&mparam, &ctx};
+
+  std::vector<std::unique_ptr<RegTree>> trees;
+  trees.emplace_back(std::make_unique<RegTree>(1, kCols));
+  {
+    auto& tree = *trees.back();
+    bst_cat_t cat = 33;
+    std::vector<std::uint32_t> split_cats(LBitField32::ComputeStorageSize(cat + 1));
+    LBitField32 bitset{split_cats};
+    bitset.Set(cat);
+    tree.ExpandCategorical(RegTree::kRoot, 1, split_cats, false, 0.0f, 1.0f, 2.0f, 0.0f, 0.0f,
+                           0.0f, 0.0f);
+  }
+  model.CommitModelGroup(std::move(trees), 0);
+  trees.clear();
+  trees.emplace_back(std::make_unique<RegTree>(1, kCols));
+  trees.back()->ExpandNode(RegTree::kRoot, 2, 0.1f, true, 0.0f, 3.0f, 4.0f, 0.0f, 0.0f, 0.0f,
+                           0.0f);
+  model.CommitModelGroup(std::move(trees), 1);
+
+  auto code = GenerateCode(model, 0, 2);
+  ASSERT_EQ(Count(code, "static float xgb_tree_"), 2);
+  ASSERT_NE(code.find("size_t xgboost_num_feature(void) { return 3; }"), std::string::npos);
+  ASSERT_NE(code.find("size_t xgboost_num_target(void) { return 2; }"), std::string::npos);
+  // Lowest bit first, the category 33 is the second bit of the second word.
+  ASSERT_NE(code.find("static uint32_t const xgb_cats_0_0[] = {0u, 2u};"), std::string::npos);
+  ASSERT_NE(code.find("!xgb_missing(x[1], missing) && !xgb_in_set(xgb_cats_0_0, 2, x[1])"),
+            std::string::npos);
+  // The threshold is printed with enough digits to round trip.
+  ASSERT_NE(code.find("xgb_missing(x[2], missing) || x[2] < 1.00000001e-01f"), std::string::npos);
+  ASSERT_NE(code.find("y[0] += xgb_tree_0(x, missing);"), std::string::npos);
+  ASSERT_NE(code.find("y[1] += xgb_tree_1(x, missing);"), std::string::npos);
+
+  // Slice
+  code = GenerateCode(model, 1, 2);
+  ASSERT_EQ(Count(code, "static float xgb_tree_"), 1);
+  ASSERT_EQ(code.find("xgb_in_set"), std::string::npos);
+}
+
+TEST(Codegen, MultiTarget) {
+  Context ctx;
+  bst_feature_t constexpr kCols = 4;
+  bst_target_t constexpr kTargets = 3;
+  LearnerModelParam mparam{kCols, linalg::Tensor<float, 1>{{0.5f}, {1}, DeviceOrd::CPU()}, 1,
+                           kTargets, MultiStrategy::kMultiOutputTree};
+  gbm::GBTreeModel model{&mparam, &ctx};
+
+  std::vector<std::unique_ptr<RegTree>> trees;
+  trees.emplace_back(std::make_unique<RegTree>(kTargets, kCols));
+  linalg::Vector<float> base_weight{{1.0f, 2.0f, 3.0f}, {3ul}, DeviceOrd::CPU()};
+  linalg::Vector<float> left_weight{{2.0f, 3.0f, 4.0f}, {3ul}, DeviceOrd::CPU()};
+  linalg::Vector<float> right_weight{{3.0f, 4.0f, 5.0f}, {3ul}, DeviceOrd::CPU()};
+  trees.back()->ExpandNode(RegTree::kRoot, 1, 0.5f, true, base_weight.HostView(),
+                           left_weight.HostView(), right_weight.HostView());
+  model.CommitModelGroup(std::move(trees), 0);
+
+  auto code = GenerateCode(model, 0, 1);
+  ASSERT_NE(code.find("static void xgb_tree_0(float const* x, float missing, float* out)"),
+            std::string::npos);
+  ASSERT_NE(code.find("size_t xgboost_num_target(void) { return 3; }"), std::string::npos);
+  ASSERT_EQ(Count(code, "out[2] += "), 2);
+  ASSERT_NE(code.find("xgb_tree_0(x, missing, y);"), std::string::npos);
+}
+
+TEST(Codegen, Learner) {
+  bst_idx_t constexpr kRows = 64;
+  bst_feature_t constexpr kCols = 8;
+  auto Xy = RandomDataGenerator{kRows, kCols, 0.0}.GenerateDMatrix(true);
+  std::unique_ptr<Learner> learner{Learner::Create({Xy})};
+  learner->SetParams(Args{{"max_depth", "3"}, {"num_parallel_tree", "2"}});
+  for (std::int32_t i = 0; i < 4; ++i) {
+    learner->UpdateOneIter(i, Xy);
+  }
+  ASSERT_EQ(Count(learner->GenerateCode(0, 0), "static float xgb_tree_"), 8);
+  auto code = learner->GenerateCode(1, 3);
+  ASSERT_EQ(Count(code, "static float xgb_tree_"), 4);
+  ASSERT_NE(code.find("static float xgb_tree_2("), std::string::npos);
+  ASSERT_NE(code.find("static float xgb_tree_5("), std::string::npos);
+}
+}  // namespace xgboost::predictor
@@ -0,0 +1,334 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+#include <xgboost/context.h>     // for Context
+#include <xgboost/span.h>        // for Span
+#include <xgboost/tree_model.h>  // for RegTree
+
+#include <cmath>    // for isnan
+#include <cstdint>  // for int32_t, uint32_t
+#include <limits>   // for numeric_limits
+#include <memory>   // for make_unique, make_shared
+#include <vector>   // for vector
+
+#include "../../../src/common/bitfield.h"            // for LBitField32
+#include "../../../src/common/threading_utils.h"     // for NumNumaNodes
+#include "../../../src/gbm/gbtree_model.h"           // for GBTreeModel
+#include "../../../src/predictor/compiled_forest.h"  // for CompiledForest, NumaForest
+#include "../../../src/predictor/predict_fn.h"       // for GetNextNode
+#include "../helpers.h"                              // for MakeMP
+
+namespace xgboost::predictor {
+namespace {
+float Predict(CompiledForest const& forest, std::vector<float> const& x) {
+  RegTree::FVec feat;
+  feat.Init(x.size());
+  bool has_missing = false;
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    feat.Data()[i] = x[i];
+    has_missing |= std::isnan(x[i]);
+  }
+  feat.HasMissing(has_missing);
+  return has_missing ? forest.PredValue<true>(0, feat) : forest.PredValue<false>(0, feat);
+}
+}  // namespace
+
+TEST(CompiledForest, Basic) {
+  Context ctx;
+  bst_feature_t constexpr kCols = 3;
+  LearnerModelParam mparam{MakeMP(kCols, .0, 1)};
+  gbm::GBTreeModel model{&mparam, &ctx};
+
+  std::vector<std::unique_ptr<RegTree>> trees;
+  trees.emplace_back(std::make_unique<RegTree>(1, kCols));
+  auto& tree = *trees.back();
+  tree.ExpandNode(RegTree::kRoot, 0, 0.5f, true, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+  // Expand the left child first, then collapse it to get deleted nodes in the middle.
+  tree.ExpandNode(1, 2, 0.0f, false, 0.0f, 4.0f, 5.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+  tree.ExpandNode(2, 1, 1.0f, false, 0.0f, 2.0f, 3.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+  tree.ChangeToLeaf(1, 1.0f);
+  model.CommitModelGroup(std::move(trees), 0);
+
+  ASSERT_TRUE(CompiledForest::CanCompile(model));
+  CompiledForest forest{&ctx, model};
+  ASSERT_EQ(forest.Version(), model.Version());
+  ASSERT_EQ(forest.NumTrees(), 1);
+  ASSERT_EQ(forest.NumNodes(), 5ul);
+  // Not filled enough for the complete layout.
+  ASSERT_FALSE(forest.IsComplete(0));
+
+  auto nan = std::numeric_limits<float>::quiet_NaN();
+  ASSERT_EQ(Predict(forest, {0.0f, 0.0f, 0.0f}), 1.0f);
+  ASSERT_EQ(Predict(forest, {1.0f, 0.0f, 0.0f}), 2.0f);
+  ASSERT_EQ(Predict(forest, {1.0f, 2.0f, 0.0f}), 3.0f);
+  // default left
+  ASSERT_EQ(Predict(forest, {nan, 2.0f, 0.0f}), 1.0f);
+  // default right
+  ASSERT_EQ(Predict(forest, {1.0f, nan, nan}), 3.0f);
+
+  auto version = model.Version();
+  std::vector<std::unique_ptr<RegTree>> new_trees;
+  new_trees.emplace_back(std::make_unique<RegTree>(1, kCols));
+  model.CommitModelGroup(std::move(new_trees), 0);
+  ASSERT_NE(model.Version(), version);
+}
+
+TEST(CompiledForest, Block) {
+  Context ctx;
+  bst_feature_t constexpr kCols = 4;
+  LearnerModelParam mparam{MakeMP(kCols, .0, 1)};
+  gbm::GBTreeModel model{&mparam, &ctx};
+
+  std::vector<std::unique_ptr<RegTree>> trees;
+  trees.emplace_back(std::make_unique<RegTree>(1, kCols));
+  auto& tree = *trees.back();
+  // A full tree with depth 4, leaf values are unique.
+  for (bst_node_t nidx = 0; nidx < 15; ++nidx) {
+    auto fidx = static_cast<bst_feature_t>(nidx % kCols);
+    auto split_cond = static_cast<float>(nidx % 3) / 3.0f;
+    bool default_left = nidx % 2 == 0;
+    tree.ExpandNode(nidx, fidx, split_cond, default_left, 0.0f, 2.0f * nidx + 1.0f,
+                    2.0f * nidx + 2.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+  }
+  model.CommitModelGroup(std::move(trees), 0);
+  CompiledForest forest{&ctx, model};
+
+  // Cover the vectorized groups and the remainder.
+  std::size_t constexpr kRows = 61;
+  auto nan = std::numeric_limits<float>::quiet_NaN();
+  std::vector<RegTree::FVec> feats(kRows);
+  for (std::size_t i = 0; i < kRows; ++i) {
+    feats[i].Init(kCols);
+    bool has_missing = false;
+    for (bst_feature_t j = 0; j < kCols; ++j) {
+      auto v = static_cast<float>((i * 7 + j * 3) % 10) / 10.0f;
+      if ((i + j) % 5 == 0) {
+        v = nan;
+        has_missing = true;
+      }
+      feats[i].Data()[j] = v;
+    }
+    feats[i].HasMissing(has_missing);
+  }
+
+  std::vector<float> out(kRows, 0.0f);
+  forest.PredValue(0, common::Span<RegTree::FVec const>{feats}, common::Span<float>{out});
+  for (std::size_t i = 0; i < kRows; ++i) {
+    auto expected = feats[i].HasMissing() ? forest.PredValue<true>(0, feats[i])
+                                          : forest.PredValue<false>(0, feats[i]);
+    ASSERT_EQ(out[i], expected) << i;
+  }
+}
+
+TEST(CompiledForest, Complete) {
+  Context ctx;
+  bst_feature_t constexpr kCols = 3;
+  LearnerModelParam mparam{MakeMP(kCols, .0, 1)};
+  gbm::GBTreeModel model{&mparam, &ctx};
+
+  std::vector<std::unique_ptr<RegTree>> trees;
+  trees.emplace_back(std::make_unique<RegTree>(1, kCols));
+  auto& tree = *trees.back();
+  // A tree with depth 4 and a leaf at depth 2, padded with 6 nodes in the complete layout.
+  for (bst_node_t nidx = 0; nidx < 13; ++nidx) {
+    if (nidx == 4) {
+      continue;
+    }
+    auto fidx = static_cast<bst_feature_t>(nidx % kCols);
+    auto split_cond = static_cast<float>(nidx % 4) / 4.0f;
+    tree.ExpandNode(nidx, fidx, split_cond, nidx % 3 == 0, 0.0f, 2.0f * nidx + 1.0f,
+                    2.0f * nidx + 2.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+  }
+  ASSERT_EQ(tree.GetNumLeaves(), 13);
+  model.CommitModelGroup(std::move(trees), 0);
+
+  CompiledForest forest{&ctx, model};
+  ASSERT_TRUE(forest.IsComplete(0));
+  ASSERT_EQ(forest.NumNodes(), 31ul);
+
+  auto const& ref = *model.trees.front();
+  auto nan = std::numeric_limits<float>::quiet_NaN();
+  std::vector<float> values{nan, 0.0f, 0.2f, 0.25f, 0.6f, 0.75f, 1.0f};
+  std::vector<RegTree::FVec> feats;
+  for (auto f0 : values) {
+    for (auto f1 : values) {
+      for (auto f2 : values) {
+        std::vector<float> x{f0, f1, f2};
+        bst_node_t leaf{RegTree::kRoot};
+        while (!ref[leaf].IsLeaf()) {
+          auto fvalue = x[ref[leaf].SplitIndex()];
+          leaf = GetNextNode<true, false>(ref[leaf], leaf, fvalue, std::isnan(fvalue), {});
+        }
+        ASSERT_EQ(Predict(forest, x), ref[leaf].LeafValue());
+        auto& feat = feats.emplace_back();
+        feat.Init(kCols);
+        for (bst_feature_t j = 0; j < kCols; ++j) {
+          feat.Data()[j] = x[j];
+        }
+        feat.HasMissing(std::isnan(f0) || std::isnan(f1) || std::isnan(f2));
+      }
+    }
+  }
+
+  std::vector<float> out(feats.size());
+  forest.PredValue(0, common::Span<RegTree::FVec const>{feats}, common::Span<float>{out});
+  for (std::size_t i = 0; i < feats.size(); ++i) {
+    auto expected = feats[i].HasMissing() ? forest.PredValue<true>(0, feats[i])
+                                          : forest.PredValue<false>(0, feats[i]);
+    ASSERT_EQ(out[i], expected) << i;
+  }
+}
+
+TEST(CompiledForest, Numa) {
+  Context ctx;
+  ctx.UpdateAllowUnknown(Args{{"nthread", "4"}});
+  bst_feature_t constexpr kCols = 2;
+  LearnerModelParam mparam{MakeMP(kCols, .0, 1)};
+  gbm::GBTreeModel model{&mparam, &ctx};
+  std::vector<std::unique_ptr<RegTree>> trees;
+  trees.emplace_back(std::make_unique<RegTree>(1, kCols));
+  trees.back()->ExpandNode(RegTree::kRoot, 1, 0.5f, true, 0.0f, 1.0f, 2.0f, 0.0f, 0.0f, 0.0f,
+                           0.0f);
+  model.CommitModelGroup(std::move(trees), 0);
+
+  auto forest = std::make_shared<CompiledForest const>(&ctx, model);
+  NumaForest numa{&ctx, forest};
+  ASSERT_EQ(numa.Forest(), forest.get());
+  ASSERT_LE(numa.NumReplicas(), static_cast<std::size_t>(common::NumNumaNodes()));
+  if (common::NumNumaNodes() == 1) {
+    ASSERT_EQ(numa.NumReplicas(), 0ul);
+    ASSERT_EQ(numa.Local(), forest.get());
+  }
+  auto const& local = *numa.Local();
+  ASSERT_EQ(local.NumNodes(), forest->NumNodes());
+  ASSERT_EQ(Predict(local, {0.0f, 0.0f}), 1.0f);
+  ASSERT_EQ(Predict(local, {0.0f, 1.0f}), 2.0f);
+}
+
+TEST(CompiledForest, SharedTrees) {
+  Context ctx;
+  bst_feature_t constexpr kCols = 2;
+  LearnerModelParam mparam{MakeMP(kCols, .0, 2)};
+  gbm::GBTreeModel model{&mparam, &ctx};
+
+  // Trees 0, 2 and 4 have the same split with different leaf values, tree 3 has the same
+  // split but belongs to another group.
+  std::vector<std::unique_ptr<RegTree>> trees;
+  std::vector<bst_feature_t> fidx{0, 1, 0, 0, 0};
+  std::vector<std::int32_t> groups{0, 0, 0, 1, 0};
+  for (std::size_t i = 0; i < fidx.size(); ++i) {
+    trees.emplace_back(std::make_unique<RegTree>(1, kCols));
+    auto leaf = static_cast<float>(i + 1);
+    trees.back()->ExpandNode(RegTree::kRoot, fidx[i], 0.5f, true, 0.0f, -leaf, leaf, 0.0f,
+                             0.0f, 0.0f, 0.0f);
+  }
+  for (std::size_t i = 0; i < trees.size(); ++i) {
+    std::vector<std::unique_ptr<RegTree>> group;
+    group.emplace_back(std::move(trees[i]));
+    model.CommitModelGroup(std::move(group), groups[i]);
+  }
+  CompiledForest forest{&ctx, model};
+  auto constexpr kNoTree = CompiledForest::kNoTree;
+  ASSERT_EQ(forest.PrevShared(0), kNoTree);
+  ASSERT_EQ(forest.PrevShared(1), kNoTree);
+  ASSERT_EQ(forest.PrevShared(2), 0);
+  ASSERT_EQ(forest.PrevShared(3), kNoTree);
+  ASSERT_EQ(forest.PrevShared(4), 2);
+
+  std::size_t constexpr kRows = 37;
+  auto nan = std::numeric_limits<float>::quiet_NaN();
+  std::vector<RegTree::FVec> feats(kRows);
+  for (std::size_t i = 0; i < kRows; ++i) {
+    feats[i].Init(kCols);
+    feats[i].Data()[0] = i % 3 == 0 ? nan : static_cast<float>(i % 2);
+    feats[i].Data()[1] = 0.0f;
+    feats[i].HasMissing(i % 3 == 0);
+  }
+  common::Span<RegTree::FVec const> s_feats{feats};
+  std::vector<bst_node_t> leaves(kRows);
+  std::vector<float> out(kRows);
+  for (bst_tree_t tree_end : {1, 3, 5}) {
+    forest.PredValue(0, tree_end, s_feats, common::Span{leaves}, common::Span{out});
+    for (std::size_t i = 0; i < kRows; ++i) {
+      float expected = 0.0f;
+      for (bst_tree_t t = 0; t < tree_end; t += 2) {
+        expected += feats[i].HasMissing() ? forest.PredValue<true>(t, feats[i])
+                                          : forest.PredValue<false>(t, feats[i]);
+      }
+      ASSERT_EQ(out[i], expected) << i;
+    }
+  }
+}
+
+TEST(CompiledForest, Categorical) {
+  Context ctx;
+  bst_feature_t constexpr kCols = 3;
+  LearnerModelParam mparam{MakeMP(kCols, .0, 1)};
+  gbm::GBTreeModel model{&mparam, &ctx};
+  ASSERT_FALSE(CompiledForest::CanCompile(model));
+
+  std::vector<std::unique_ptr<RegTree>> trees;
+  trees.emplace_back(std::make_unique<RegTree>(1, kCols));
+  auto& tree = *trees.back();
+  // Categories on both sides of the 64-bit word boundary.
+  std::vector<std::uint32_t> split_cats(LBitField32::ComputeStorageSize(100));
+  for (bst_cat_t c : {2, 40, 63, 64, 99}) {
+    LBitField32{split_cats}.Set(c);
+  }
+  tree.ExpandCategorical(RegTree::kRoot, 0, split_cats, true, 1.0f, 2.0f, 3.0f, 1.0f, 2.0f, 1.0f,
+                         1.0f);
+  // A numerical split followed by a categorical split with a single word.
+  tree.ExpandNode(1, 1, 0.5f, false, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+  std::vector<std::uint32_t> small_cats(LBitField32::ComputeStorageSize(4));
+  LBitField32{small_cats}.Set(3);
+  tree.ExpandCategorical(4, 2, small_cats, false, 0.0f, 4.0f, 5.0f, 1.0f, 1.0f, 1.0f, 1.0f);
+  model.CommitModelGroup(std::move(trees), 0);
+  ASSERT_TRUE(CompiledForest::CanCompile(model));
+
+  CompiledForest forest{&ctx, model};
+  auto const& ref = *model.trees.front();
+  auto nan = std::numeric_limits<float>::quiet_NaN();
+  std::vector<float> cats;
+  for (std::int32_t c = -2; c < 140; ++c) {
+    cats.push_back(static_cast<float>(c));
+  }
+  cats.push_back(2.5f);
+  cats.push_back(1e9f);
+  cats.push_back(nan);
+  for (auto c0 : cats) {
+    for (auto f1 : {0.0f, 1.0f}) {
+      for (auto c2 : {0.0f, 3.0f, 3.5f, 7.0f, -1.0f, nan}) {
+        std::vector<float> x{c0, f1, c2};
+        RegTree::FVec feat;
+        feat.Init(kCols);
+        for (bst_feature_t j = 0; j < kCols; ++j) {
+          feat.Data()[j] = x[j];
+        }
+        feat.HasMissing(std::isnan(c0) || std::isnan(c2));
+        bst_node_t leaf{RegTree::kRoot};
+        while (!ref[leaf].IsLeaf()) {
+          auto fvalue = feat.GetFvalue(ref[leaf].SplitIndex());
+          leaf = GetNextNode<true, true>(ref[leaf], leaf, fvalue, std::isnan(fvalue),
+                                         ref.GetCategoriesMatrix());
+        }
+        ASSERT_EQ(Predict(forest, x), ref[leaf].LeafValue()) << c0 << " " << f1 << " " << c2;
+      }
+    }
+  }
+
+  std::vector<RegTree::FVec> feats(cats.size());
+  for (std::size_t i = 0; i < cats.size(); ++i) {
+    feats[i].Init(kCols);
+    feats[i].Data()[0] = cats[i];
+    feats[i].Data()[1] = 1.0f;
+    feats[i].Data()[2] = 3.0f;
+    feats[i].HasMissing(std::isnan(cats[i]));
+  }
+  std::vector<float> out(feats.size());
+  forest.PredValue(0, common::Span<RegTree::FVec const>{feats}, common::Span<float>{out});
+  for (std::size_t i = 0; i < feats.size(); ++i) {
+    ASSERT_EQ(out[i], Predict(forest, {cats[i], 1.0f, 3.0f})) << i;
+  }
+}
+}  // namespace xgboost::predictor
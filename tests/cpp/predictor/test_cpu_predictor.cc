@@ -4,6 +4,8 @@
 #include <gtest/gtest.h>
 #include <xgboost/predictor.h>
 
+#include <random>  // for mt19937, uniform_real_distribution
+
 #include "../../../src/collective/communicator-inl.h"
 #include "../../../src/data/adapter.h"
 #include "../../../src/data/proxy_dmatrix.h"
@@ -208,5 +210,311 @@ TEST(CpuPredictor, Multi) {
   TestVectorLeafPrediction(&ctx);
 }
 
+TEST(CpuPredictor, VectorLeafForest) {
+  Context ctx;
+  TestVectorLeafForest(&ctx);
+}
+
 TEST(CpuPredictor, Access) { TestPredictionDeviceAccess(); }
+
+TEST(CpuPredictor, ReuseFeatureVectors) {
+  // Feature vectors are reused across predictions on the same thread, run models with
+  // different number of features and sparse inputs back to back.
+  bst_idx_t constexpr kRows{64};
+  std::vector<std::unique_ptr<Learner>> learners;
+  std::vector<RandomDataGenerator> gens;
+  std::vector<std::vector<float>> expected;
+  for (bst_feature_t n_features : {8u, 32u}) {
+    gens.emplace_back(kRows, n_features, 0.6);
+    auto Xy = gens.back().GenerateDMatrix(true);
+    learners.emplace_back(Learner::Create({Xy}));
+    for (std::int32_t i = 0; i < 4; ++i) {
+      learners.back()->UpdateOneIter(i, Xy);
+    }
+    HostDeviceVector<float> predt;
+    learners.back()->Predict(gens.back().GenerateDMatrix(true), false, &predt, 0, 0);
+    expected.push_back(predt.HostVector());
+  }
+
+  for (std::size_t k = 0; k < 4; ++k) {
+    auto i = k % learners.size();
+    HostDeviceVector<float> data;
+    HostDeviceVector<std::size_t> rptrs;
+    HostDeviceVector<bst_feature_t> columns;
+    gens[i].GenerateCSR(&data, &rptrs, &columns);
+    std::string data_str, rptr_str, col_str;
+    Json::Dump(GetArrayInterface(&data, data.Size(), 1), &data_str);
+    Json::Dump(GetArrayInterface(&rptrs, kRows + 1, 1), &rptr_str);
+    Json::Dump(GetArrayInterface(&columns, columns.Size(), 1), &col_str);
+    std::shared_ptr<data::DMatrixProxy> x{new data::DMatrixProxy};
+    auto n_features = learners[i]->GetNumFeature();
+    x->SetCSRData(rptr_str.data(), col_str.data(), data_str.data(), n_features, true);
+
+    HostDeviceVector<float>* p_predt{nullptr};
+    learners[i]->InplacePredict(x, PredictionType::kValue,
+                                std::numeric_limits<float>::quiet_NaN(), &p_predt, 0, 0);
+    auto const& h_predt = p_predt->ConstHostVector();
+    ASSERT_EQ(h_predt.size(), expected[i].size());
+    for (std::size_t j = 0; j < h_predt.size(); ++j) {
+      ASSERT_EQ(h_predt[j], expected[i][j]);
+    }
+  }
+}
+
+TEST(CpuPredictor, TreeTiles) {
+  // Large enough to be divided into tiles of trees when the L2 cache is 2MB or smaller.
+  bst_tree_t constexpr kTrees = 96;
+  bst_node_t constexpr kSplits = 1023;
+  bst_feature_t constexpr kCols = 16;
+  bst_idx_t constexpr kRows = 300;
+  Context ctx;
+  LearnerModelParam mparam{MakeMP(kCols, 0.5, 1)};
+  gbm::GBTreeModel model{&mparam, &ctx};
+  std::mt19937 rng{0};
+  std::uniform_real_distribution<float> dist{0.0f, 1.0f};
+  for (bst_tree_t t = 0; t < kTrees; ++t) {
+    std::vector<std::unique_ptr<RegTree>> trees;
+    trees.emplace_back(std::make_unique<RegTree>(1, kCols));
+    for (bst_node_t nidx = 0; nidx < kSplits; ++nidx) {
+      trees.back()->ExpandNode(nidx, rng() % kCols, dist(rng), rng() % 2 == 0, 0.0f, dist(rng),
+                               dist(rng), 0.0f, 0.0f, 0.0f, 0.0f);
+    }
+    model.CommitModelGroup(std::move(trees), 0);
+  }
+
+  auto p_fmat = RandomDataGenerator{kRows, kCols, 0.2}.GenerateDMatrix();
+  std::unique_ptr<Predictor> predictor{Predictor::Create("cpu_predictor", &ctx)};
+  PredictionCacheEntry full;
+  predictor->InitOutPredictions(p_fmat->Info(), &full.predictions, model);
+  predictor->PredictBatch(p_fmat.get(), &full, model, 0, kTrees);
+
+  // Each tree alone fits in the cache.
+  std::vector<float> expected(kRows, 0.5f);
+  for (bst_tree_t t = 0; t < kTrees; ++t) {
+    PredictionCacheEntry one;
+    predictor->InitOutPredictions(p_fmat->Info(), &one.predictions, model);
+    predictor->PredictBatch(p_fmat.get(), &one, model, t, t + 1);
+    auto const& h_one = one.predictions.ConstHostVector();
+    for (bst_idx_t i = 0; i < kRows; ++i) {
+      expected[i] += h_one[i] - 0.5f;
+    }
+  }
+  auto const& h_full = full.predictions.ConstHostVector();
+  for (bst_idx_t i = 0; i < kRows; ++i) {
+    ASSERT_NEAR(h_full[i], expected[i], 1e-3);
+  }
+}
+
+TEST(CpuPredictor, WideSparse) {
+  // Wide enough for the feature vectors to keep a bitmask of the present features.
+  bst_tree_t constexpr kTrees = 8;
+  bst_feature_t constexpr kCols = 10000;
+  bst_idx_t constexpr kRows = 128;
+  Context ctx;
+  LearnerModelParam mparam{MakeMP(kCols, 0.5, 1)};
+  gbm::GBTreeModel model{&mparam, &ctx};
+  std::mt19937 rng{0};
+  std::uniform_real_distribution<float> dist{0.0f, 1.0f};
+  for (bst_tree_t t = 0; t < kTrees; ++t) {
+    std::vector<std::unique_ptr<RegTree>> trees;
+    trees.emplace_back(std::make_unique<RegTree>(1, kCols));
+    for (bst_node_t nidx = 0; nidx < 31; ++nidx) {
+      trees.back()->ExpandNode(nidx, rng() % kCols, dist(rng), rng() % 2 == 0, 0.0f, dist(rng),
+                               dist(rng), 0.0f, 0.0f, 0.0f, 0.0f);
+    }
+    model.CommitModelGroup(std::move(trees), 0);
+  }
+
+  auto p_fmat = RandomDataGenerator{kRows, kCols, 0.99}.GenerateDMatrix();
+  std::unique_ptr<Predictor> predictor{Predictor::Create("cpu_predictor", &ctx)};
+  PredictionCacheEntry predt;
+  predictor->InitOutPredictions(p_fmat->Info(), &predt.predictions, model);
+  predictor->PredictBatch(p_fmat.get(), &predt, model, 0, kTrees);
+
+  // The leaf prediction walks the trees without the compiled forest.
+  HostDeviceVector<float> leaves;
+  predictor->PredictLeaf(p_fmat.get(), &leaves, model, kTrees);
+  auto const& h_leaves = leaves.ConstHostVector();
+  auto const& h_predt = predt.predictions.ConstHostVector();
+  for (bst_idx_t i = 0; i < kRows; ++i) {
+    float expected = 0.5f;
+    for (bst_tree_t t = 0; t < kTrees; ++t) {
+      auto nidx = static_cast<bst_node_t>(h_leaves[i * kTrees + t]);
+      expected += (*model.trees[t])[nidx].LeafValue();
+    }
+    ASSERT_NEAR(h_predt[i], expected, 1e-5);
+  }
+}
+
+TEST(CpuPredictor, Cascade) {
+  bst_idx_t constexpr kRows{256};
+  bst_feature_t constexpr kCols{16};
+  auto gen = RandomDataGenerator{kRows, kCols, 0.2};
+  HostDeviceVector<float> data;
+  gen.GenerateDense(&data);
+  auto p_fmat = GetDMatrixFromData(data.HostVector(), kRows, kCols);
+  p_fmat->Info().labels.Reshape(kRows, 1);
+  auto& h_labels = p_fmat->Info().labels.Data()->HostVector();
+  for (std::size_t i = 0; i < kRows; ++i) {
+    h_labels[i] = i % 2;
+  }
+  std::unique_ptr<Learner> learner{Learner::Create({p_fmat})};
+  learner->SetParams(Args{{"objective", "binary:logistic"}, {"max_depth", "3"}});
+  for (std::int32_t i = 0; i < 8; ++i) {
+    learner->UpdateOneIter(i, p_fmat);
+  }
+
+  bst_layer_t constexpr kCheckpoint = 3;
+  HostDeviceVector<float> full, partial;
+  learner->Predict(p_fmat, true, &full, 0, 0);
+  learner->Predict(p_fmat, true, &partial, 0, kCheckpoint);
+  auto const& h_full = full.ConstHostVector();
+  auto const& h_partial = partial.ConstHostVector();
+  auto sorted = h_partial;
+  std::sort(sorted.begin(), sorted.end());
+  auto threshold = sorted[kRows / 2];
+
+  std::shared_ptr<data::DMatrixProxy> proxy{new data::DMatrixProxy};
+  std::string arr_str;
+  Json::Dump(GetArrayInterface(&data, kRows, kCols), &arr_str);
+  proxy->SetArrayData(arr_str.data());
+
+  auto missing = std::numeric_limits<float>::quiet_NaN();
+  for (std::shared_ptr<DMatrix> p_m : {p_fmat, std::shared_ptr<DMatrix>{proxy}}) {
+    HostDeviceVector<float> out;
+    HostDeviceVector<std::uint8_t> finished;
+    // No early exit.
+    learner->PredictCascade(p_m, PredictionType::kMargin, missing, 0, 0, {kCheckpoint},
+                            {-std::numeric_limits<float>::infinity()}, &out, &finished);
+    ASSERT_EQ(out.Size(), kRows);
+    for (std::size_t i = 0; i < kRows; ++i) {
+      ASSERT_EQ(finished.HostVector()[i], 1);
+      ASSERT_NEAR(out.HostVector()[i], h_full[i], kRtEps);
+    }
+
+    learner->PredictCascade(p_m, PredictionType::kMargin, missing, 0, 0, {kCheckpoint},
+                            {threshold}, &out, &finished);
+    auto const& h_out = out.ConstHostVector();
+    auto const& h_finished = finished.ConstHostVector();
+    std::size_t n_finished = 0;
+    for (std::size_t i = 0; i < kRows; ++i) {
+      if (h_partial[i] < threshold) {
+        ASSERT_EQ(h_finished[i], 0);
+        ASSERT_NEAR(h_out[i], h_partial[i], kRtEps);
+      } else {
+        ASSERT_EQ(h_finished[i], 1);
+        ASSERT_NEAR(h_out[i], h_full[i], kRtEps);
+        ++n_finished;
+      }
+    }
+    ASSERT_GT(n_finished, 0);
+    ASSERT_LT(n_finished, kRows);
+
+    // Checkpoints must be inside the iteration range.
+    ASSERT_THROW(learner->PredictCascade(p_m, PredictionType::kMargin, missing, 0, kCheckpoint,
+                                         {kCheckpoint}, {threshold}, &out, &finished),
+                 dmlc::Error);
+  }
+}
+
+TEST(CpuPredictor, LeafMargin) {
+  bst_idx_t constexpr kRows{200};
+  bst_feature_t constexpr kCols{8};
+  auto p_fmat = RandomDataGenerator{kRows, kCols, 0.3}.Classes(3).GenerateDMatrix(true);
+  for (auto strategy : {"one_output_per_tree", "multi_output_tree"}) {
+    std::unique_ptr<Learner> learner{Learner::Create({p_fmat})};
+    learner->SetParams(Args{{"objective", "multi:softprob"},
+                            {"num_class", "3"},
+                            {"multi_strategy", strategy},
+                            {"max_depth", "4"}});
+    for (std::int32_t i = 0; i < 4; ++i) {
+      learner->UpdateOneIter(i, p_fmat);
+    }
+    for (bool output_margin : {true, false}) {
+      for (bst_layer_t layer_end : {0, 2}) {
+        HostDeviceVector<float> expected_predt, expected_leaf;
+        learner->Predict(p_fmat, output_margin, &expected_predt, 0, layer_end);
+        learner->Predict(p_fmat, false, &expected_leaf, 0, layer_end, false, true);
+
+        HostDeviceVector<float> predt, leaf;
+        learner->PredictLeafMargin(p_fmat, output_margin, &predt, &leaf, 0, layer_end);
+        ASSERT_EQ(leaf.ConstHostVector(), expected_leaf.ConstHostVector());
+        ASSERT_EQ(predt.Size(), expected_predt.Size());
+        for (std::size_t i = 0; i < predt.Size(); ++i) {
+          ASSERT_NEAR(predt.ConstHostVector()[i], expected_predt.ConstHostVector()[i], kRtEps);
+        }
+      }
+    }
+    HostDeviceVector<float> predt, leaf;
+    ASSERT_THROW(learner->PredictLeafMargin(p_fmat, true, &predt, &leaf, 1, 2), dmlc::Error);
+  }
+}
+
+TEST(CpuPredictor, InteractionContributions) {
+  Context ctx;
+  bst_idx_t constexpr kRows{64};
+  bst_feature_t constexpr kCols{6};
+  bst_target_t constexpr kClasses{3};
+  auto p_fmat = RandomDataGenerator{kRows, kCols, 0.2}.Classes(kClasses).GenerateDMatrix(true);
+  std::unique_ptr<Learner> learner{Learner::Create({p_fmat})};
+  learner->SetParams(Args{{"objective", "multi:softprob"},
+                          {"num_class", std::to_string(kClasses)},
+                          {"num_parallel_tree", "2"},
+                          {"max_depth", "4"}});
+  for (std::int32_t i = 0; i < 3; ++i) {
+    learner->UpdateOneIter(i, p_fmat);
+  }
+  Json model{Object{}};
+  learner->SaveModel(&model);
+  auto model_param = MakeMP(kCols, 0.0, kClasses);
+  gbm::GBTreeModel gbtree{&model_param, &ctx};
+  gbtree.LoadModel(model["learner"]["gradient_booster"]["model"]);
+
+  std::unique_ptr<Predictor> predictor{Predictor::Create("cpu_predictor", &ctx)};
+  predictor->Configure({});
+  std::vector<float> tree_weights(gbtree.trees.size());
+  for (std::size_t j = 0; j < tree_weights.size(); ++j) {
+    tree_weights[j] = 0.5f + static_cast<float>(j % 3) * 0.25f;
+  }
+  std::size_t constexpr kColumns = kCols + 1;
+  for (auto const* weights : std::vector<std::vector<float> const*>{nullptr, &tree_weights}) {
+    HostDeviceVector<float> interactions, contribs, on, off;
+    predictor->PredictInteractionContributions(p_fmat.get(), &interactions, gbtree, 0, weights);
+    predictor->PredictContribution(p_fmat.get(), &contribs, gbtree, 0, weights);
+    auto const& h_inter = interactions.ConstHostVector();
+    auto const& h_contribs = contribs.ConstHostVector();
+    ASSERT_EQ(h_inter.size(), kRows * kClasses * kColumns * kColumns);
+
+    for (std::size_t r = 0; r < kRows * kClasses; ++r) {
+      auto const* mat = h_inter.data() + r * kColumns * kColumns;
+      for (std::size_t f = 0; f < kColumns; ++f) {
+        // Rows sum to the contributions.
+        double sum{0};
+        for (std::size_t k = 0; k < kColumns; ++k) {
+          sum += mat[f * kColumns + k];
+          ASSERT_EQ(mat[f * kColumns + k], mat[k * kColumns + f]);
+        }
+        ASSERT_NEAR(sum, h_contribs[r * kColumns + f], 1e-4);
+      }
+    }
+
+    // Same as conditioning on each of the features.
+    for (bst_feature_t f = 0; f < kCols; ++f) {
+      predictor->PredictContribution(p_fmat.get(), &off, gbtree, 0, weights, false, -1, f);
+      predictor->PredictContribution(p_fmat.get(), &on, gbtree, 0, weights, false, 1, f);
+      auto const& h_on = on.ConstHostVector();
+      auto const& h_off = off.ConstHostVector();
+      for (std::size_t r = 0; r < kRows * kClasses; ++r) {
+        for (std::size_t k = 0; k < kColumns; ++k) {
+          if (k == f) {
+            continue;
+          }
+          auto expected = (h_on[r * kColumns + k] - h_off[r * kColumns + k]) / 2.0f;
+          auto v = h_inter[r * kColumns * kColumns + f * kColumns + k];
+          ASSERT_NEAR(v, expected, 1e-4) << r << ", " << f << ", " << k;
+        }
+      }
+    }
+  }
+}
 }  // namespace xgboost
@@ -0,0 +1,109 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+#include <xgboost/context.h>             // for Context
+#include <xgboost/host_device_vector.h>  // for HostDeviceVector
+#include <xgboost/learner.h>             // for Learner
+#include <xgboost/tree_model.h>          // for RegTree
+
+#include <cmath>    // for isnan
+#include <cstdint>  // for int32_t
+#include <limits>   // for numeric_limits
+#include <memory>   // for unique_ptr, shared_ptr
+#include <random>   // for mt19937, uniform_real_distribution
+#include <utility>  // for pair, move
+#include <vector>   // for vector
+
+#include "../../../src/predictor/cpu_treeshap.h"  // for TreeShapTable, CalculateContributions
+#include "../helpers.h"                           // for RandomDataGenerator
+
+namespace xgboost {
+namespace {
+// A random tree with few features such that features are repeated on the paths.
+RegTree MakeRandomTree(bst_feature_t n_features, bst_node_t max_depth, std::mt19937* rng) {
+  RegTree tree{1, n_features};
+  std::uniform_real_distribution<float> dist{0.0f, 1.0f};
+  std::vector<std::pair<bst_node_t, float>> leaves{{RegTree::kRoot, 64.0f}};
+  for (bst_node_t depth = 0; depth < max_depth; ++depth) {
+    std::vector<std::pair<bst_node_t, float>> next;
+    for (auto [nidx, hess] : leaves) {
+      if (depth != 0 && dist(*rng) < 0.2f) {
+        continue;
+      }
+      auto fidx = static_cast<bst_feature_t>(dist(*rng) * n_features) % n_features;
+      float left_hess = hess * (0.1f + 0.8f * dist(*rng));
+      tree.ExpandNode(nidx, fidx, dist(*rng), dist(*rng) < 0.5f, 0.0f, dist(*rng) - 0.5f,
+                      dist(*rng) - 0.5f, 1.0f, hess, left_hess, hess - left_hess);
+      next.emplace_back(tree[nidx].LeftChild(), left_hess);
+      next.emplace_back(tree[nidx].RightChild(), hess - left_hess);
+    }
+    leaves = std::move(next);
+  }
+  return tree;
+}
+}  // namespace
+
+TEST(CpuTreeShap, Table) {
+  std::mt19937 rng{2025};
+  bst_feature_t constexpr kCols = 5;
+  std::uniform_real_distribution<float> dist{0.0f, 1.0f};
+  TreeShapWorkspace workspace;
+  for (std::int32_t t = 0; t < 8; ++t) {
+    auto tree = MakeRandomTree(kCols, 8, &rng);
+    ASSERT_LE(TreeShapTable::TableSize(tree), tree.GetNumLeaves() * (1ul << kCols));
+    TreeShapTable table{tree};
+    // Exclude the bias term.
+    std::vector<float> mean_values{0.0f};
+    RegTree::FVec feat;
+    feat.Init(kCols);
+    for (std::int32_t r = 0; r < 32; ++r) {
+      bool has_missing = false;
+      for (bst_feature_t f = 0; f < kCols; ++f) {
+        auto v = dist(rng);
+        bool missing = v < 0.2f;
+        feat.Data()[f] = missing ? std::numeric_limits<float>::quiet_NaN() : dist(rng);
+        has_missing |= missing;
+      }
+      feat.HasMissing(has_missing);
+      std::vector<float> expected(kCols + 1, 0.0f), got(kCols + 1, 0.0f);
+      CalculateContributions(tree, feat, &mean_values, expected.data(), 0, 0, tree.MaxDepth(0),
+                             &workspace);
+      table.Calculate(tree, feat, &workspace, got.data());
+      for (bst_feature_t f = 0; f < kCols + 1; ++f) {
+        ASSERT_NEAR(expected[f], got[f], 1e-5);
+      }
+    }
+  }
+  // Root only.
+  RegTree stump{1, kCols};
+  ASSERT_EQ(TreeShapTable::TableSize(stump), 0);
+}
+
+TEST(CpuTreeShap, PredictContribution) {
+  bst_idx_t constexpr kRows = 256;
+  bst_feature_t constexpr kCols = 8;
+  std::shared_ptr<DMatrix> p_fmat = RandomDataGenerator{kRows, kCols, 0.2}.GenerateDMatrix(true);
+  std::unique_ptr<Learner> learner{Learner::Create({p_fmat})};
+  learner->SetParams(Args{{"max_depth", "5"}, {"nthread", "4"}});
+  for (std::int32_t i = 0; i < 8; ++i) {
+    learner->UpdateOneIter(i, p_fmat);
+  }
+  // Path tables are used for the full batch.
+  HostDeviceVector<float> batch;
+  learner->Predict(p_fmat, false, &batch, 0, 0, false, false, true);
+  auto const& h_batch = batch.ConstHostVector();
+  ASSERT_EQ(h_batch.size(), kRows * (kCols + 1));
+  // The recursive algorithm is used for a single row.
+  for (std::int32_t i = 0; i < static_cast<std::int32_t>(kRows); i += 17) {
+    std::shared_ptr<DMatrix> p_row{p_fmat->Slice(std::vector<std::int32_t>{i})};
+    HostDeviceVector<float> row;
+    learner->Predict(p_row, false, &row, 0, 0, false, false, true);
+    auto const& h_row = row.ConstHostVector();
+    ASSERT_EQ(h_row.size(), kCols + 1);
+    for (bst_feature_t f = 0; f < kCols + 1; ++f) {
+      ASSERT_NEAR(h_row[f], h_batch[i * (kCols + 1) + f], 1e-5);
+    }
+  }
+}
+}  // namespace xgboost
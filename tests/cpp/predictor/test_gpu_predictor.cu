@@ -7,7 +7,12 @@
 #include <xgboost/logging.h>
 #include <xgboost/predictor.h>
 
+#include <cstdint>  // for int32_t
+#include <memory>   // for make_unique
+#include <limits>   // for numeric_limits
 #include <string>
+#include <thread>   // for thread
+#include <vector>   // for vector
 
 #include "../../../src/data/device_adapter.cuh"
 #include "../../../src/data/proxy_dmatrix.h"
@@ -55,6 +60,49 @@ TEST(GPUPredictor, Basic) {
   }
 }
 
+TEST(GPUPredictor, CachedTrees) {
+  auto ctx = MakeCUDACtx(0);
+  auto cpu_ctx = MakeCUDACtx(-1);
+  bst_feature_t constexpr kCols{16};
+  std::int32_t constexpr kClasses{3};
+  LearnerModelParam mparam{MakeMP(kCols, .5, kClasses, ctx.Device())};
+  gbm::GBTreeModel model{&mparam, &ctx};
+  // Full trees with depth 6, the nodes of all trees don't fit into a single cache group.
+  for (std::int32_t i = 0; i < 96; ++i) {
+    auto tree = std::make_unique<RegTree>();
+    for (bst_node_t nidx = 0; nidx < (1 << 6) - 1; ++nidx) {
+      auto fidx = static_cast<bst_feature_t>((nidx * 7 + i) % kCols);
+      tree->ExpandNode(nidx, fidx, static_cast<float>(nidx % 5) / 5.0f, nidx % 2 == 0, 0.0f,
+                       static_cast<float>(i % 7) - 3.0f, static_cast<float>(nidx % 3), 0.0f,
+                       1.0f, 0.5f, 0.5f);
+    }
+    std::vector<std::unique_ptr<RegTree>> trees;
+    trees.push_back(std::move(tree));
+    model.CommitModelGroup(std::move(trees), i % kClasses);
+  }
+
+  std::unique_ptr<Predictor> gpu_predictor{Predictor::Create("gpu_predictor", &ctx)};
+  std::unique_ptr<Predictor> cpu_predictor{Predictor::Create("cpu_predictor", &cpu_ctx)};
+  gpu_predictor->Configure({});
+  cpu_predictor->Configure({});
+
+  for (auto sparsity : {0.0f, 0.5f}) {
+    auto p_fmat = RandomDataGenerator{1000, kCols, sparsity}.GenerateDMatrix();
+    PredictionCacheEntry gpu_out, cpu_out;
+    gpu_predictor->InitOutPredictions(p_fmat->Info(), &gpu_out.predictions, model);
+    gpu_predictor->PredictBatch(p_fmat.get(), &gpu_out, model, 0);
+    cpu_predictor->InitOutPredictions(p_fmat->Info(), &cpu_out.predictions, model);
+    cpu_predictor->PredictBatch(p_fmat.get(), &cpu_out, model, 0);
+
+    auto const& h_gpu = gpu_out.predictions.ConstHostVector();
+    auto const& h_cpu = cpu_out.predictions.ConstHostVector();
+    ASSERT_EQ(h_gpu.size(), h_cpu.size());
+    for (std::size_t i = 0; i < h_gpu.size(); ++i) {
+      ASSERT_NEAR(h_gpu[i], h_cpu[i], kRtEps);
+    }
+  }
+}
+
 namespace {
 void VerifyBasicColumnSplit(std::array<std::vector<float>, 32> const& expected_result) {
   auto const world_size = collective::GetWorldSize();
@@ -219,6 +267,58 @@ TEST(GPUPredictor, InplacePredictCuDF) {
   TestInplacePrediction(&ctx, p_fmat, kRows, kCols);
 }
 
+TEST(GPUPredictor, ConcurrentInplacePredict) {
+  auto ctx = MakeCUDACtx(0);
+  bst_idx_t constexpr kRows{256};
+  bst_feature_t constexpr kCols{16};
+  auto p_train = RandomDataGenerator{kRows, kCols, 0.0}.Device(ctx.Device()).GenerateDMatrix(true);
+  std::unique_ptr<Learner> learner{Learner::Create({p_train})};
+  learner->SetParams(Args{{"device", ctx.DeviceName()}, {"max_depth", "4"}});
+  for (std::int32_t iter = 0; iter < 4; ++iter) {
+    learner->UpdateOneIter(iter, p_train);
+  }
+
+  RandomDataGenerator gen(kRows, kCols, 0.5);
+  gen.Device(ctx.Device());
+  HostDeviceVector<float> data;
+  std::string interface_str = gen.GenerateArrayInterface(&data);
+  auto predict = [&](HostDeviceVector<float>* out) {
+    // Each thread uses its own proxy.
+    std::shared_ptr<DMatrix> p_fmat{new data::DMatrixProxy};
+    dynamic_cast<data::DMatrixProxy*>(p_fmat.get())->SetCUDAArray(interface_str.c_str());
+    HostDeviceVector<float>* p_out{nullptr};
+    learner->InplacePredict(p_fmat, PredictionType::kMargin,
+                            std::numeric_limits<float>::quiet_NaN(), &p_out, 0, 0);
+    out->Resize(p_out->Size());
+    out->Copy(*p_out);
+  };
+  HostDeviceVector<float> expected;
+  predict(&expected);
+
+  std::int32_t constexpr kThreads = 4;
+  std::vector<HostDeviceVector<float>> results(kThreads);
+  std::vector<std::thread> workers;
+  for (std::int32_t t = 0; t < kThreads; ++t) {
+    workers.emplace_back([&, t] {
+      for (std::int32_t i = 0; i < 8; ++i) {
+        predict(&results[t]);
+      }
+    });
+  }
+  for (auto& w : workers) {
+    w.join();
+  }
+  for (auto const& predt : results) {
+    ASSERT_EQ(predt.ConstHostVector(), expected.ConstHostVector());
+  }
+
+  // The cached model is updated after training.
+  learner->UpdateOneIter(4, p_train);
+  HostDeviceVector<float> updated;
+  predict(&updated);
+  ASSERT_NE(updated.ConstHostVector(), expected.ConstHostVector());
+}
+
 TEST(GpuPredictor, LesserFeatures) {
   auto ctx = MakeCUDACtx(0);
   TestPredictionWithLesserFeatures(&ctx);
@@ -357,6 +457,11 @@ TEST(GPUPredictor, Sparse) {
   TestSparsePrediction(&ctx, 0.8);
 }
 
+TEST(GPUPredictor, VectorLeafForest) {
+  auto ctx = MakeCUDACtx(0);
+  TestVectorLeafForest(&ctx);
+}
+
 TEST_F(MGPUPredictorTest, SparseColumnSplit) {
   TestSparsePredictionColumnSplit(curt::AllVisibleGPUs(), true, 0.2);
   TestSparsePredictionColumnSplit(curt::AllVisibleGPUs(), true, 0.8);
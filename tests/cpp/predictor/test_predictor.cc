@@ -11,9 +11,11 @@
 #include <xgboost/predictor.h>           // for PredictionCacheEntry, Predictor, Predic...
 #include <xgboost/string_view.h>         // for StringView
 
+#include <cmath>          // for isnan
 #include <limits>         // for numeric_limits
 #include <memory>         // for shared_ptr
 #include <unordered_map>  // for unordered_map
+#include <vector>         // for vector
 
 #include "../../../src/common/bitfield.h"         // for LBitField32
 #include "../../../src/data/iterative_dmatrix.h"  // for IterativeDMatrix
@@ -23,6 +25,7 @@
 #include "xgboost/json.h"                         // for Json, Object, get, String
 #include "xgboost/linalg.h"                       // for MakeVec, Tensor, TensorView, Vector
 #include "xgboost/logging.h"                      // for CHECK
+#include "xgboost/multi_target_tree_model.h"      // for MultiTargetTree
 #include "xgboost/span.h"                         // for operator!=, SpanIterator, Span
 #include "xgboost/tree_model.h"                   // for RegTree
 
@@ -822,6 +825,82 @@ void TestVectorLeafPrediction(Context const *ctx) {
   run_test(1.5, &data);
 }
 
+void TestVectorLeafForest(Context const *ctx) {
+  bst_idx_t constexpr kRows = 100;
+  bst_feature_t constexpr kCols = 6;
+  // Larger than the block of targets and the block of trees used by the CPU predictor.
+  bst_target_t constexpr kTargets = 130;
+  bst_tree_t constexpr kTrees = 20;
+
+  LearnerModelParam mparam{kCols, linalg::Vector<float>{{0.5}, {1}, DeviceOrd::CPU()}, 1,
+                           kTargets, MultiStrategy::kMultiOutputTree};
+  gbm::GBTreeModel model{&mparam, ctx};
+  auto weight = [&](bst_tree_t t, bst_node_t nidx) {
+    std::vector<float> w(kTargets);
+    for (bst_target_t k = 0; k < kTargets; ++k) {
+      w[k] = static_cast<float>(t + 1) * 0.01f + static_cast<float>(nidx) + k * 0.001f;
+    }
+    return w;
+  };
+  for (bst_tree_t t = 0; t < kTrees; ++t) {
+    std::vector<std::unique_ptr<RegTree>> trees;
+    trees.emplace_back(std::make_unique<RegTree>(kTargets, kCols));
+    auto &tree = *trees.back();
+    auto expand = [&](bst_node_t nidx, bst_feature_t fidx, float cond, bool default_left,
+                      bst_node_t left) {
+      auto base_w = weight(t, nidx);
+      auto left_w = weight(t, left);
+      auto right_w = weight(t, left + 1);
+      tree.ExpandNode(nidx, fidx, cond, default_left, linalg::MakeVec(base_w.data(), kTargets),
+                      linalg::MakeVec(left_w.data(), kTargets),
+                      linalg::MakeVec(right_w.data(), kTargets));
+    };
+    expand(RegTree::kRoot, t % kCols, 0.5f, t % 2 == 0, 1);
+    expand(1, (t + 1) % kCols, 0.3f, t % 3 == 0, 3);
+    model.CommitModelGroup(std::move(trees), 0);
+  }
+
+  HostDeviceVector<float> storage;
+  RandomDataGenerator{kRows, kCols, 0.2}.GenerateArrayInterface(&storage);
+  auto const &h_x = storage.ConstHostVector();
+  auto p_fmat = GetDMatrixFromData(h_x, kRows, kCols);
+
+  std::unique_ptr<Predictor> predictor{
+      Predictor::Create(ctx->IsCUDA() ? "gpu_predictor" : "cpu_predictor", ctx)};
+  auto run = [&](bst_tree_t tree_begin, bst_tree_t tree_end) {
+    PredictionCacheEntry predt_cache;
+    predictor->InitOutPredictions(p_fmat->Info(), &predt_cache.predictions, model);
+    predictor->PredictBatch(p_fmat.get(), &predt_cache, model, tree_begin, tree_end);
+    auto const &h_predt = predt_cache.predictions.ConstHostVector();
+    ASSERT_EQ(h_predt.size(), kRows * kTargets);
+
+    for (bst_idx_t i = 0; i < kRows; ++i) {
+      std::vector<float> expected(kTargets, 0.5f);
+      for (auto t = tree_begin; t < tree_end; ++t) {
+        auto const *tree = model.trees[t]->GetMultiTargetTree();
+        bst_node_t nidx = RegTree::kRoot;
+        while (!tree->IsLeaf(nidx)) {
+          auto v = h_x[i * kCols + tree->SplitIndex(nidx)];
+          if (std::isnan(v)) {
+            nidx = tree->DefaultChild(nidx);
+          } else {
+            nidx = v < tree->SplitCond(nidx) ? tree->LeftChild(nidx) : tree->RightChild(nidx);
+          }
+        }
+        auto leaf = tree->LeafValue(nidx);
+        for (bst_target_t k = 0; k < kTargets; ++k) {
+          expected[k] += leaf(k);
+        }
+      }
+      for (bst_target_t k = 0; k < kTargets; ++k) {
+        ASSERT_NEAR(h_predt[i * kTargets + k], expected[k], 1e-4) << i << ", " << k;
+      }
+    }
+  };
+  run(0, kTrees);
+  run(3, 19);
+}
+
 void ShapExternalMemoryTest::Run(Context const *ctx, bool is_qdm, bool is_interaction) {
   bst_idx_t n_samples{2048};
   bst_feature_t n_features{16};
@@ -0,0 +1,248 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+#include <xgboost/context.h>     // for Context
+#include <xgboost/learner.h>     // for Learner
+#include <xgboost/span.h>        // for Span
+#include <xgboost/tree_model.h>  // for RegTree
+
+#include <cmath>    // for isnan
+#include <cstdint>  // for uint8_t, uint16_t
+#include <limits>   // for numeric_limits
+#include <memory>   // for make_unique, shared_ptr
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "../../../src/common/hist_util.h"            // for HistogramCuts
+#include "../../../src/data/proxy_dmatrix.h"          // for DMatrixProxy
+#include "../../../src/gbm/gbtree_model.h"            // for GBTreeModel
+#include "../../../src/predictor/quantized_forest.h"  // for QuantizedForest
+#include "../helpers.h"                               // for MakeMP, RandomDataGenerator
+
+namespace xgboost::predictor {
+namespace {
+template <typename BinT>
+float Predict(QuantizedForest const& forest, std::vector<float> const& x) {
+  RegTree::FVec feat;
+  feat.Init(x.size());
+  bool has_missing = false;
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    feat.Data()[i] = x[i];
+    has_missing |= std::isnan(x[i]);
+  }
+  feat.HasMissing(has_missing);
+  std::vector<BinT> bins(x.size());
+  forest.Quantise(feat, common::Span<BinT>{bins});
+  float out{0.0f};
+  for (bst_tree_t t = 0; t < forest.NumTrees(); ++t) {
+    out += has_missing ? forest.PredValue<BinT, true>(t, bins.data())
+                       : forest.PredValue<BinT, false>(t, bins.data());
+  }
+  return out;
+}
+}  // namespace
+
+TEST(QuantizedForest, Forest) {
+  Context ctx;
+  bst_feature_t constexpr kCols = 3;
+  LearnerModelParam mparam{MakeMP(kCols, .0, 1)};
+  gbm::GBTreeModel model{&mparam, &ctx};
+
+  std::vector<std::unique_ptr<RegTree>> trees;
+  trees.emplace_back(std::make_unique<RegTree>(1, kCols));
+  auto& tree = *trees.back();
+  tree.ExpandNode(RegTree::kRoot, 0, 0.5f, true, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+  tree.ExpandNode(1, 2, 0.0f, false, 0.0f, 4.0f, 5.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+  tree.ExpandNode(2, 1, 1.0f, false, 0.0f, 2.0f, 3.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+  // Share the feature 1 with a different threshold.
+  trees.emplace_back(std::make_unique<RegTree>(1, kCols));
+  trees.back()->ExpandNode(RegTree::kRoot, 1, 0.5f, false, 0.0f, 10.0f, 20.0f, 0.0f, 0.0f, 0.0f,
+                           0.0f);
+  model.CommitModelGroup(std::move(trees), 0);
+
+  ASSERT_TRUE(QuantizedForest::CanCompile(model));
+  QuantizedForest forest{&ctx, model};
+  ASSERT_EQ(forest.Version(), model.Version());
+  ASSERT_EQ(forest.NumTrees(), 2);
+  ASSERT_EQ(forest.NumNodes(), 8ul);
+  ASSERT_EQ(forest.BinBits(), 8);
+
+  auto nan = std::numeric_limits<float>::quiet_NaN();
+  ASSERT_EQ(Predict<std::uint8_t>(forest, {0.0f, 0.0f, -1.0f}), 4.0f + 10.0f);
+  ASSERT_EQ(Predict<std::uint8_t>(forest, {0.0f, 1.0f, 0.0f}), 5.0f + 20.0f);
+  ASSERT_EQ(Predict<std::uint8_t>(forest, {1.0f, 0.0f, 0.0f}), 2.0f + 10.0f);
+  ASSERT_EQ(Predict<std::uint8_t>(forest, {1.0f, 0.7f, 0.0f}), 2.0f + 20.0f);
+  // Threshold is inclusive for the right child.
+  ASSERT_EQ(Predict<std::uint8_t>(forest, {0.5f, 1.0f, 0.0f}), 3.0f + 20.0f);
+  ASSERT_EQ(Predict<std::uint8_t>(forest, {0.5f, 0.5f, 0.0f}), 2.0f + 20.0f);
+  // default left for the root, default right for the others
+  ASSERT_EQ(Predict<std::uint8_t>(forest, {nan, nan, nan}), 5.0f + 20.0f);
+  ASSERT_EQ(Predict<std::uint8_t>(forest, {1.0f, nan, 0.0f}), 3.0f + 20.0f);
+}
+
+TEST(QuantizedForest, WideBins) {
+  Context ctx;
+  bst_feature_t constexpr kCols = 2;
+  LearnerModelParam mparam{MakeMP(kCols, .0, 1)};
+  gbm::GBTreeModel model{&mparam, &ctx};
+
+  // A chain with more thresholds than an 8-bit bin can hold, always expand the right child.
+  bst_node_t constexpr kSplits = 300;
+  std::vector<std::unique_ptr<RegTree>> trees;
+  trees.emplace_back(std::make_unique<RegTree>(1, kCols));
+  auto& tree = *trees.back();
+  bst_node_t nidx = RegTree::kRoot;
+  for (bst_node_t i = 0; i < kSplits; ++i) {
+    tree.ExpandNode(nidx, 0, static_cast<float>(i), true, 0.0f, static_cast<float>(i), 0.0f,
+                    0.0f, 0.0f, 0.0f, 0.0f);
+    nidx = tree[nidx].RightChild();
+  }
+  tree[nidx].SetLeaf(static_cast<float>(kSplits));
+  model.CommitModelGroup(std::move(trees), 0);
+
+  ASSERT_TRUE(QuantizedForest::CanCompile(model));
+  QuantizedForest forest{&ctx, model};
+  ASSERT_EQ(forest.BinBits(), 16);
+  for (bst_node_t i = 0; i < kSplits; ++i) {
+    // x in [i - 1, i) exits at the i^th split.
+    ASSERT_EQ(Predict<std::uint16_t>(forest, {static_cast<float>(i) - 0.5f, 0.0f}),
+              static_cast<float>(i));
+  }
+  ASSERT_EQ(Predict<std::uint16_t>(forest, {static_cast<float>(kSplits), 0.0f}),
+            static_cast<float>(kSplits));
+  ASSERT_EQ(Predict<std::uint16_t>(forest, {std::numeric_limits<float>::quiet_NaN(), 0.0f}),
+            0.0f);
+}
+
+TEST(QuantizedForest, HistogramCuts) {
+  Context ctx;
+  bst_feature_t constexpr kCols = 2;
+  LearnerModelParam mparam{MakeMP(kCols, .0, 1)};
+
+  common::HistogramCuts cuts;
+  cuts.cut_values_.HostVector() = {0.5f, 1.0f, 2.0f, 0.0f, 3.0f};
+  cuts.cut_ptrs_.HostVector() = {0, 3, 5};
+  cuts.min_vals_.HostVector() = {0.0f, -1.0f};
+
+  auto make_model = [&](float split_cond) {
+    auto model = std::make_unique<gbm::GBTreeModel>(&mparam, &ctx);
+    std::vector<std::unique_ptr<RegTree>> trees;
+    trees.emplace_back(std::make_unique<RegTree>(1, kCols));
+    trees.back()->ExpandNode(RegTree::kRoot, 0, split_cond, true, 0.0f, 1.0f, 2.0f, 0.0f, 0.0f,
+                             0.0f, 0.0f);
+    model->CommitModelGroup(std::move(trees), 0);
+    return model;
+  };
+  // Not a cut.
+  ASSERT_FALSE(QuantizedForest::CanCompile(*make_model(0.7f), cuts));
+  // The last cut is greater than all values.
+  ASSERT_FALSE(QuantizedForest::CanCompile(*make_model(2.0f), cuts));
+
+  auto model = make_model(1.0f);
+  ASSERT_TRUE(QuantizedForest::CanCompile(*model, cuts));
+  QuantizedForest forest{&ctx, *model, cuts};
+  ASSERT_EQ(forest.BinBits(), 8);
+  // Local bins of the gradient index, the threshold is the cut at bin 1.
+  std::vector<std::uint8_t> bins{0, 0};
+  ASSERT_EQ((forest.PredValue<std::uint8_t, false>(0, bins.data())), 1.0f);
+  bins[0] = 1;
+  ASSERT_EQ((forest.PredValue<std::uint8_t, false>(0, bins.data())), 1.0f);
+  bins[0] = 2;
+  ASSERT_EQ((forest.PredValue<std::uint8_t, false>(0, bins.data())), 2.0f);
+  bins[0] = std::numeric_limits<std::uint8_t>::max();
+  ASSERT_EQ((forest.PredValue<std::uint8_t, true>(0, bins.data())), 1.0f);
+}
+
+TEST(QuantizedForest, Learner) {
+  bst_idx_t constexpr kRows = 256;
+  bst_feature_t constexpr kCols = 16;
+  auto gen = RandomDataGenerator{kRows, kCols, 0.3};
+  auto Xy = gen.GenerateDMatrix(true);
+  std::unique_ptr<Learner> learner{Learner::Create({Xy})};
+  learner->SetParams(Args{{"max_depth", "6"}, {"base_score", "0.5"}, {"tree_method", "exact"}});
+  for (std::int32_t i = 0; i < 8; ++i) {
+    learner->UpdateOneIter(i, Xy);
+  }
+
+  HostDeviceVector<float> expected;
+  learner->Predict(gen.GenerateDMatrix(true), false, &expected, 0, 0);
+  HostDeviceVector<float> expected_slice;
+  learner->Predict(gen.GenerateDMatrix(true), false, &expected_slice, 2, 5);
+
+  learner->SetParam("predictor", "quantized_predictor");
+  learner->Configure();
+  HostDeviceVector<float> predt;
+  learner->Predict(gen.GenerateDMatrix(true), false, &predt, 0, 0);
+  auto const& h_expected = expected.ConstHostVector();
+  auto const& h_predt = predt.ConstHostVector();
+  ASSERT_EQ(h_expected.size(), h_predt.size());
+  for (std::size_t i = 0; i < h_expected.size(); ++i) {
+    ASSERT_FLOAT_EQ(h_expected[i], h_predt[i]);
+  }
+  HostDeviceVector<float> predt_slice;
+  learner->Predict(gen.GenerateDMatrix(true), false, &predt_slice, 2, 5);
+  auto const& h_expected_slice = expected_slice.ConstHostVector();
+  auto const& h_predt_slice = predt_slice.ConstHostVector();
+  ASSERT_EQ(h_expected_slice.size(), h_predt_slice.size());
+  for (std::size_t i = 0; i < h_expected_slice.size(); ++i) {
+    ASSERT_FLOAT_EQ(h_expected_slice[i], h_predt_slice[i]);
+  }
+
+  // Inplace prediction with dense data.
+  HostDeviceVector<float> with_nan(kRows * kCols, std::numeric_limits<float>::quiet_NaN());
+  auto& h_with_nan = with_nan.HostVector();
+  for (auto const& page : Xy->GetBatches<SparsePage>()) {
+    auto batch = page.GetView();
+    for (std::size_t i = 0; i < batch.Size(); ++i) {
+      for (auto e : batch[i]) {
+        h_with_nan[i * kCols + e.index] = e.fvalue;
+      }
+    }
+  }
+  auto dense = std::shared_ptr<DMatrix>(new data::DMatrixProxy{});
+  auto array_interface = GetArrayInterface(&with_nan, kRows, kCols);
+  std::string arr_str;
+  Json::Dump(array_interface, &arr_str);
+  dynamic_cast<data::DMatrixProxy*>(dense.get())->SetArrayData(arr_str.data());
+  HostDeviceVector<float>* p_inplace;
+  learner->InplacePredict(dense, PredictionType::kValue, std::numeric_limits<float>::quiet_NaN(),
+                          &p_inplace, 0, 0);
+  auto const& h_inplace = p_inplace->ConstHostVector();
+  ASSERT_EQ(h_expected.size(), h_inplace.size());
+  for (std::size_t i = 0; i < h_expected.size(); ++i) {
+    ASSERT_FLOAT_EQ(h_expected[i], h_inplace[i]);
+  }
+}
+
+TEST(QuantizedForest, GHistIndex) {
+  bst_idx_t constexpr kRows = 256;
+  bst_feature_t constexpr kCols = 16;
+  bst_bin_t constexpr kBins = 64;
+  for (float sparsity : {0.0f, 0.3f}) {
+    auto gen = RandomDataGenerator{kRows, kCols, sparsity}.Bins(kBins);
+    auto Xy = gen.GenerateQuantileDMatrix(true);
+    std::unique_ptr<Learner> learner{Learner::Create({Xy})};
+    learner->SetParams(Args{{"max_depth", "6"},
+                            {"base_score", "0.5"},
+                            {"tree_method", "hist"},
+                            {"max_bin", std::to_string(kBins)}});
+    for (std::int32_t i = 0; i < 8; ++i) {
+      learner->UpdateOneIter(i, Xy);
+    }
+    // Predict a quantile DMatrix with the training data as reference.
+    HostDeviceVector<float> expected;
+    learner->Predict(gen.Ref(Xy).GenerateQuantileDMatrix(true), false, &expected, 0, 0);
+    learner->SetParam("predictor", "quantized_predictor");
+    learner->Configure();
+    HostDeviceVector<float> predt;
+    learner->Predict(gen.Ref(Xy).GenerateQuantileDMatrix(true), false, &predt, 0, 0);
+    auto const& h_expected = expected.ConstHostVector();
+    auto const& h_predt = predt.ConstHostVector();
+    ASSERT_EQ(h_expected.size(), h_predt.size());
+    for (std::size_t i = 0; i < h_expected.size(); ++i) {
+      ASSERT_FLOAT_EQ(h_expected[i], h_predt[i]);
+    }
+  }
+}
+}  // namespace xgboost::predictor
@@ -0,0 +1,143 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+#include <xgboost/context.h>     // for Context
+#include <xgboost/learner.h>     // for Learner
+#include <xgboost/span.h>        // for Span
+#include <xgboost/tree_model.h>  // for RegTree
+
+#include <cmath>   // for isnan
+#include <limits>  // for numeric_limits
+#include <memory>  // for make_unique, shared_ptr
+#include <string>  // for string
+#include <vector>  // for vector
+
+#include "../../../src/data/proxy_dmatrix.h"      // for DMatrixProxy
+#include "../../../src/gbm/gbtree_model.h"        // for GBTreeModel
+#include "../../../src/predictor/quick_scorer.h"  // for QuickScorerForest
+#include "../helpers.h"                           // for MakeMP, RandomDataGenerator
+
+namespace xgboost::predictor {
+namespace {
+float Predict(QuickScorerForest const& forest, std::vector<float> const& x) {
+  RegTree::FVec feat;
+  feat.Init(x.size());
+  bool has_missing = false;
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    feat.Data()[i] = x[i];
+    has_missing |= std::isnan(x[i]);
+  }
+  feat.HasMissing(has_missing);
+  std::vector<QuickScorerForest::BitVector> bits;
+  float out{0.0f};
+  forest.Predict(feat, &bits, common::Span<float>{&out, 1});
+  return out;
+}
+}  // namespace
+
+TEST(QuickScorer, Forest) {
+  Context ctx;
+  bst_feature_t constexpr kCols = 3;
+  LearnerModelParam mparam{MakeMP(kCols, .0, 1)};
+  gbm::GBTreeModel model{&mparam, &ctx};
+
+  std::vector<std::unique_ptr<RegTree>> trees;
+  trees.emplace_back(std::make_unique<RegTree>(1, kCols));
+  auto& tree = *trees.back();
+  tree.ExpandNode(RegTree::kRoot, 0, 0.5f, true, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+  tree.ExpandNode(1, 2, 0.0f, false, 0.0f, 4.0f, 5.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+  tree.ExpandNode(2, 1, 1.0f, false, 0.0f, 2.0f, 3.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+  trees.emplace_back(std::make_unique<RegTree>(1, kCols));
+  trees.back()->ExpandNode(RegTree::kRoot, 1, 0.5f, false, 0.0f, 10.0f, 20.0f, 0.0f, 0.0f, 0.0f,
+                           0.0f);
+  model.CommitModelGroup(std::move(trees), 0);
+
+  ASSERT_TRUE(QuickScorerForest::CanCompile(model));
+  QuickScorerForest forest{&ctx, model};
+  ASSERT_EQ(forest.Version(), model.Version());
+  ASSERT_EQ(forest.NumTrees(), 2);
+
+  auto nan = std::numeric_limits<float>::quiet_NaN();
+  ASSERT_EQ(Predict(forest, {0.0f, 0.0f, -1.0f}), 4.0f + 10.0f);
+  ASSERT_EQ(Predict(forest, {0.0f, 1.0f, 0.0f}), 5.0f + 20.0f);
+  ASSERT_EQ(Predict(forest, {1.0f, 0.0f, 0.0f}), 2.0f + 10.0f);
+  // Threshold is inclusive for the right child.
+  ASSERT_EQ(Predict(forest, {0.5f, 1.0f, 0.0f}), 3.0f + 20.0f);
+  // default left for the root, default right for the others
+  ASSERT_EQ(Predict(forest, {nan, nan, nan}), 5.0f + 20.0f);
+  ASSERT_EQ(Predict(forest, {1.0f, nan, 0.0f}), 3.0f + 20.0f);
+}
+
+TEST(QuickScorer, MaxLeaves) {
+  Context ctx;
+  bst_feature_t constexpr kCols = 2;
+  LearnerModelParam mparam{MakeMP(kCols, .0, 1)};
+  gbm::GBTreeModel model{&mparam, &ctx};
+
+  std::vector<std::unique_ptr<RegTree>> trees;
+  trees.emplace_back(std::make_unique<RegTree>(1, kCols));
+  auto& tree = *trees.back();
+  // A chain, always expand the right child.
+  bst_node_t nidx = RegTree::kRoot;
+  for (bst_node_t i = 0; i < QuickScorerForest::kMaxLeaves; ++i) {
+    tree.ExpandNode(nidx, 0, static_cast<float>(i), true, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+                    0.0f);
+    nidx = tree[nidx].RightChild();
+  }
+  ASSERT_EQ(tree.GetNumLeaves(), QuickScorerForest::kMaxLeaves + 1);
+  model.CommitModelGroup(std::move(trees), 0);
+  ASSERT_FALSE(QuickScorerForest::CanCompile(model));
+}
+
+TEST(QuickScorer, Learner) {
+  bst_idx_t constexpr kRows = 256;
+  bst_feature_t constexpr kCols = 16;
+  auto gen = RandomDataGenerator{kRows, kCols, 0.3};
+  auto Xy = gen.GenerateDMatrix(true);
+  std::unique_ptr<Learner> learner{Learner::Create({Xy})};
+  learner->SetParams(Args{{"max_depth", "4"}, {"base_score", "0.5"}});
+  for (std::int32_t i = 0; i < 8; ++i) {
+    learner->UpdateOneIter(i, Xy);
+  }
+
+  HostDeviceVector<float> expected;
+  learner->Predict(gen.GenerateDMatrix(true), false, &expected, 0, 0);
+
+  learner->SetParam("predictor", "qs_predictor");
+  learner->Configure();
+  HostDeviceVector<float> predt;
+  learner->Predict(gen.GenerateDMatrix(true), false, &predt, 0, 0);
+  auto const& h_expected = expected.ConstHostVector();
+  auto const& h_predt = predt.ConstHostVector();
+  ASSERT_EQ(h_expected.size(), h_predt.size());
+  for (std::size_t i = 0; i < h_expected.size(); ++i) {
+    ASSERT_FLOAT_EQ(h_expected[i], h_predt[i]);
+  }
+
+  // Inplace prediction with dense data.
+  HostDeviceVector<float> with_nan(kRows * kCols, std::numeric_limits<float>::quiet_NaN());
+  auto& h_with_nan = with_nan.HostVector();
+  for (auto const& page : Xy->GetBatches<SparsePage>()) {
+    auto batch = page.GetView();
+    for (std::size_t i = 0; i < batch.Size(); ++i) {
+      for (auto e : batch[i]) {
+        h_with_nan[i * kCols + e.index] = e.fvalue;
+      }
+    }
+  }
+  auto dense = std::shared_ptr<DMatrix>(new data::DMatrixProxy{});
+  auto array_interface = GetArrayInterface(&with_nan, kRows, kCols);
+  std::string arr_str;
+  Json::Dump(array_interface, &arr_str);
+  dynamic_cast<data::DMatrixProxy*>(dense.get())->SetArrayData(arr_str.data());
+  HostDeviceVector<float>* p_inplace;
+  learner->InplacePredict(dense, PredictionType::kValue, std::numeric_limits<float>::quiet_NaN(),
+                          &p_inplace, 0, 0);
+  auto const& h_inplace = p_inplace->ConstHostVector();
+  ASSERT_EQ(h_expected.size(), h_inplace.size());
+  for (std::size_t i = 0; i < h_expected.size(); ++i) {
+    ASSERT_FLOAT_EQ(h_expected[i], h_inplace[i]);
+  }
+}
+}  // namespace xgboost::predictor
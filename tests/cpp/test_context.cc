@@ -5,7 +5,8 @@
 #include <xgboost/base.h>
 #include <xgboost/context.h>
 
-#include <sstream>
+#include <sstream>  // for stringstream
+#include <thread>   // for thread
 
 namespace xgboost {
 TEST(Context, CPU) {
@@ -35,6 +36,29 @@ TEST(Context, CPU) {
   ASSERT_EQ(ss.str(), "cpu");
 }
 
+TEST(Context, ScopedThreads) {
+  Context ctx;
+  ctx.UpdateAllowUnknown(Args{{"nthread", "2"}});
+  auto n_threads = ctx.Threads();
+  {
+    ScopedThreads threads{1};
+    ASSERT_EQ(ctx.Threads(), 1);
+    {
+      ScopedThreads restored{0};
+      ASSERT_EQ(ctx.Threads(), n_threads);
+    }
+    ASSERT_EQ(ctx.Threads(), 1);
+    // Other threads are not affected.
+    std::int32_t other{0};
+    std::thread t{[&] { other = ctx.Threads(); }};
+    t.join();
+    ASSERT_EQ(other, n_threads);
+    ASSERT_EQ(ctx.nthread, 2);
+  }
+  ASSERT_EQ(ctx.Threads(), n_threads);
+  ASSERT_THROW({ ScopedThreads threads{-1}; }, dmlc::Error);
+}
+
 TEST(Context, ErrorInit) {
   Context ctx;
   ASSERT_THROW({ ctx.Init({{"foo", "bar"}}); }, dmlc::Error);
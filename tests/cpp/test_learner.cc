@@ -152,6 +152,23 @@ TEST(Learner, Configuration) {
   }
 }
 
+TEST(Learner, ConfigureOnChange) {
+  auto p_dmat = RandomDataGenerator{16, 4, 0}.GenerateDMatrix(true);
+  std::unique_ptr<Learner> learner{Learner::Create({p_dmat})};
+  Json config{Object{}};
+  ASSERT_THAT([&] { learner->SaveConfig(&config); }, GMockThrow("Call Configure"));
+  learner->Configure();
+  learner->SaveConfig(&config);
+  ASSERT_EQ(get<String const>(config["learner"]["generic_param"]["seed"]), "0");
+  // Configured, nothing to do.
+  learner->Configure();
+  learner->SetParam("seed", "3");
+  ASSERT_THAT([&] { learner->SaveConfig(&config); }, GMockThrow("Call Configure"));
+  learner->Configure();
+  learner->SaveConfig(&config);
+  ASSERT_EQ(get<String const>(config["learner"]["generic_param"]["seed"]), "3");
+}
+
 TEST(Learner, JsonModelIO) {
   // Test of comparing JSON object directly.
   size_t constexpr kRows = 8;
@@ -205,6 +222,175 @@ TEST(Learner, JsonModelIO) {
   }
 }
 
+TEST(Learner, StreamedModelIO) {
+  bst_idx_t constexpr kRows = 64;
+  std::int32_t constexpr kIters = 4;
+  auto p_dmat = RandomDataGenerator{kRows, 10, 0}.Classes(3).GenerateDMatrix(true);
+
+  for (auto booster : {"gbtree", "dart"}) {
+    std::unique_ptr<Learner> learner{Learner::Create({p_dmat})};
+    // Single thread so that the trees are loaded in multiple batches.
+    learner->SetParams(Args{{"booster", booster},
+                            {"objective", "multi:softprob"},
+                            {"num_class", "3"},
+                            {"num_parallel_tree", "2"},
+                            {"nthread", "1"}});
+    for (std::int32_t iter = 0; iter < kIters; ++iter) {
+      learner->UpdateOneIter(iter, p_dmat);
+    }
+    Json out{Object{}};
+    learner->SaveModel(&out);
+
+    for (auto mode : {std::ios::in, std::ios::binary}) {
+      std::vector<char> buffer;
+      Json::Dump(out, &buffer, mode);
+      std::unique_ptr<Learner> loaded{Learner::Create({p_dmat})};
+      loaded->LoadModel(StringView{buffer.data(), buffer.size()}, mode);
+      loaded->Configure();
+      Json new_in{Object{}};
+      loaded->SaveModel(&new_in);
+      ASSERT_EQ(new_in, out);
+    }
+  }
+
+  // Booster without trees.
+  std::unique_ptr<Learner> learner{Learner::Create({p_dmat})};
+  learner->SetParams(
+      Args{{"booster", "gblinear"}, {"objective", "multi:softprob"}, {"num_class", "3"}});
+  learner->UpdateOneIter(0, p_dmat);
+  Json out{Object{}};
+  learner->SaveModel(&out);
+  std::vector<char> buffer;
+  Json::Dump(out, &buffer, std::ios::binary);
+  learner.reset(Learner::Create({p_dmat}));
+  learner->LoadModel(StringView{buffer.data(), buffer.size()}, std::ios::binary);
+  learner->Configure();
+  Json new_in{Object{}};
+  learner->SaveModel(&new_in);
+  ASSERT_EQ(new_in, out);
+}
+
+TEST(Learner, MmapModelIO) {
+  bst_idx_t constexpr kRows = 64;
+  std::int32_t constexpr kIters = 4;
+  auto p_dmat = RandomDataGenerator{kRows, 10, 0}.Classes(3).GenerateDMatrix(true);
+  dmlc::TemporaryDirectory tmpdir;
+  auto path = tmpdir.path + "/model.mmap";
+
+  for (auto booster : {"gbtree", "dart", "gblinear"}) {
+    std::unique_ptr<Learner> learner{Learner::Create({p_dmat})};
+    learner->SetParams(
+        Args{{"booster", booster}, {"objective", "multi:softprob"}, {"num_class", "3"}});
+    for (std::int32_t iter = 0; iter < kIters; ++iter) {
+      learner->UpdateOneIter(iter, p_dmat);
+    }
+    learner->SetAttr("best_score", "0.5");
+    learner->Configure();
+    learner->SaveMmapModel(path);
+    Json out{Object{}};
+    learner->SaveModel(&out);
+
+    std::unique_ptr<Learner> loaded{Learner::Create({p_dmat})};
+    loaded->LoadMmapModel(path);
+    loaded->Configure();
+    Json new_in{Object{}};
+    loaded->SaveModel(&new_in);
+    ASSERT_EQ(new_in, out) << booster;
+  }
+
+  {
+    std::ofstream fout{path};
+    fout << "{}";
+  }
+  std::unique_ptr<Learner> learner{Learner::Create({p_dmat})};
+  ASSERT_THAT([&] { learner->LoadMmapModel(path); }, GMockThrow("Invalid mmap model"));
+}
+
+TEST(Learner, LazyModelIO) {
+  bst_idx_t constexpr kRows = 64;
+  std::int32_t constexpr kIters = 6;
+  auto p_dmat = RandomDataGenerator{kRows, 10, 0}.Classes(3).GenerateDMatrix(true);
+  dmlc::TemporaryDirectory tmpdir;
+  auto path = tmpdir.path + "/model.mmap";
+
+  std::unique_ptr<Learner> learner{Learner::Create({p_dmat})};
+  learner->SetParams(Args{{"objective", "multi:softprob"}, {"num_class", "3"}});
+  for (std::int32_t iter = 0; iter < kIters; ++iter) {
+    learner->UpdateOneIter(iter, p_dmat);
+  }
+  learner->SaveMmapModel(path);
+
+  // A budget smaller than a tree loads one layer at a time, the unlimited budget loads
+  // the whole model as a single page.
+  for (std::size_t max_bytes : {std::size_t{1}, std::size_t{0}}) {
+    std::unique_ptr<Learner> loaded{Learner::Create({p_dmat})};
+    loaded->LoadLazyModel(path, max_bytes);
+    loaded->Configure();
+    for (auto [begin, end] : {std::pair{0, 0}, std::pair{1, 4}, std::pair{5, 6}}) {
+      HostDeviceVector<float> expected, predt;
+      learner->Predict(p_dmat, false, &expected, begin, end);
+      loaded->Predict(p_dmat, false, &predt, begin, end);
+      ASSERT_EQ(expected.Size(), predt.Size());
+      for (std::size_t i = 0; i < predt.Size(); ++i) {
+        ASSERT_NEAR(expected.HostVector()[i], predt.HostVector()[i], kRtEps);
+      }
+    }
+
+    Json out{Object{}};
+    ASSERT_THAT([&] { loaded->SaveModel(&out); }, GMockThrow("loaded on demand"));
+    HostDeviceVector<float> leaf;
+    ASSERT_THAT([&] { loaded->Predict(p_dmat, false, &leaf, 0, 0, false, true); },
+                GMockThrow("loaded on demand"));
+  }
+}
+
+TEST(Learner, PredictionCacheIO) {
+  bst_idx_t constexpr kRows = 64;
+  std::int32_t constexpr kIters = 4;
+  auto p_dmat = RandomDataGenerator{kRows, 10, 0}.Classes(3).GenerateDMatrix(true);
+  dmlc::TemporaryDirectory tmpdir;
+  auto path = tmpdir.path + "/predt.cache";
+
+  Args args{{"objective", "multi:softprob"}, {"num_class", "3"}};
+  std::unique_ptr<Learner> learner{Learner::Create({p_dmat})};
+  learner->SetParams(args);
+  for (std::int32_t iter = 0; iter < kIters; ++iter) {
+    learner->UpdateOneIter(iter, p_dmat);
+  }
+  Json model{Object{}};
+  learner->SaveModel(&model);
+  learner->SavePredictionCache(p_dmat, path);
+
+  std::unique_ptr<Learner> loaded{Learner::Create({p_dmat})};
+  loaded->LoadModel(model);
+  loaded->SetParams(args);
+  ASSERT_TRUE(loaded->LoadPredictionCache(p_dmat, path));
+  HostDeviceVector<float> expected, predt;
+  learner->Predict(p_dmat, true, &expected, 0, 0);
+  loaded->Predict(p_dmat, true, &predt, 0, 0);
+  ASSERT_EQ(expected.ConstHostVector(), predt.ConstHostVector());
+
+  // Continue the training from the restored cache.
+  for (std::int32_t iter = kIters; iter < kIters * 2; ++iter) {
+    learner->UpdateOneIter(iter, p_dmat);
+    loaded->UpdateOneIter(iter, p_dmat);
+  }
+  learner->Predict(p_dmat, true, &expected, 0, 0);
+  loaded->Predict(p_dmat, true, &predt, 0, 0);
+  ASSERT_EQ(expected.Size(), predt.Size());
+  for (std::size_t i = 0; i < predt.Size(); ++i) {
+    ASSERT_NEAR(expected.HostVector()[i], predt.HostVector()[i], kRtEps);
+  }
+
+  // The cache is saved from the first few iterations.
+  ASSERT_FALSE(loaded->LoadPredictionCache(p_dmat, path));
+  std::unique_ptr<Learner> other{Learner::Create({p_dmat})};
+  other->LoadModel(model);
+  auto p_other = RandomDataGenerator{kRows, 10, 0}.Classes(3).Seed(1).GenerateDMatrix(true);
+  ASSERT_FALSE(other->LoadPredictionCache(p_other, path));
+  ASSERT_TRUE(other->LoadPredictionCache(p_dmat, path));
+}
+
 TEST(Learner, ConfigIO) {
   bst_idx_t n_samples = 128;
   bst_feature_t n_features = 12;
@@ -283,6 +469,58 @@ TEST(Learner, MultiThreadedPredict) {
   }
 }
 
+TEST(Learner, FrozenPredict) {
+  bst_idx_t constexpr kRows = 256;
+  bst_feature_t constexpr kCols = 16;
+  auto p_dmat = RandomDataGenerator{kRows, kCols, 0.2}.GenerateDMatrix(true);
+  std::shared_ptr<Learner> learner{Learner::Create({p_dmat})};
+  learner->SetParams(Args{{"objective", "binary:logistic"}, {"max_depth", "3"}});
+  for (std::int32_t i = 0; i < 4; ++i) {
+    learner->UpdateOneIter(i, p_dmat);
+  }
+  HostDeviceVector<float> expected;
+  learner->Predict(p_dmat, false, &expected, 0, 0);
+
+  ASSERT_FALSE(learner->IsFrozen());
+  learner->Freeze();
+  ASSERT_TRUE(learner->IsFrozen());
+
+  // Mutating the booster is rejected.
+  ASSERT_THROW(learner->SetParam("eta", "0.1"), dmlc::Error);
+  ASSERT_THROW(learner->UpdateOneIter(4, p_dmat), dmlc::Error);
+  ASSERT_THROW(learner->SetAttr("best_iteration", "1"), dmlc::Error);
+  HostDeviceVector<float> predt;
+  ASSERT_THROW(learner->Predict(p_dmat, false, &predt, 0, 0, true), dmlc::Error);
+  Json model{Object{}};
+  learner->SaveModel(&model);
+  ASSERT_THROW(learner->LoadModel(model), dmlc::Error);
+
+  auto n_threads = std::max(std::thread::hardware_concurrency(), 2u);
+  std::vector<std::thread> threads;
+  for (decltype(n_threads) thread_id = 0; thread_id < n_threads; ++thread_id) {
+    threads.emplace_back([&] {
+      HostDeviceVector<float> predictions;
+      for (std::size_t iter = 0; iter < 4; ++iter) {
+        learner->Predict(p_dmat, false, &predictions, 0, 0);
+        auto const &h_expected = expected.ConstHostVector();
+        auto const &h_predt = predictions.ConstHostVector();
+        ASSERT_EQ(h_expected, h_predt);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Output margin and a partial range use the same path.
+  learner->Predict(p_dmat, true, &predt, 0, 2);
+  HostDeviceVector<float> margin;
+  std::unique_ptr<Learner> copy{Learner::Create({})};
+  copy->LoadModel(model);
+  copy->Predict(p_dmat, true, &margin, 0, 2);
+  ASSERT_EQ(predt.ConstHostVector(), margin.ConstHostVector());
+}
+
 TEST(Learner, BinaryModelIO) {
   size_t constexpr kRows = 8;
   int32_t constexpr kIters = 4;
@@ -468,6 +706,85 @@ TEST(Learner, FeatureInfo) {
   }
 }
 
+TEST(Learner, FusedGradient) {
+  bst_idx_t constexpr kRows = 256;
+  std::int32_t constexpr kIters = 4;
+  for (float sparsity : {0.0f, 0.5f}) {
+    auto p_dmat = RandomDataGenerator{kRows, 8, sparsity}.Classes(2).GenerateDMatrix(true);
+    auto& h_weight = p_dmat->Info().weights_.HostVector();
+    h_weight.resize(kRows);
+    std::mt19937 rng{0};
+    std::uniform_real_distribution<float> dist{0.5f, 2.0f};
+    std::generate(h_weight.begin(), h_weight.end(), [&] { return dist(rng); });
+
+    // Subsampling and random forest compute the gradient before building the trees.
+    for (auto const& args : {Args{}, Args{{"subsample", "0.5"}}, Args{{"num_parallel_tree", "2"}},
+                             Args{{"quantise_gradient", "true"}}}) {
+      for (auto obj : {"reg:squarederror", "binary:logistic"}) {
+        std::vector<HostDeviceVector<float>> predt(2);
+        for (bool fuse : {false, true}) {
+          std::unique_ptr<Learner> learner{Learner::Create({p_dmat})};
+          learner->SetParams(args);
+          learner->SetParams(Args{{"objective", obj},
+                                  {"tree_method", "hist"},
+                                  {"scale_pos_weight", "1.5"},
+                                  {"fuse_gradient", fuse ? "true" : "false"}});
+          for (std::int32_t iter = 0; iter < kIters; ++iter) {
+            learner->UpdateOneIter(iter, p_dmat);
+          }
+          learner->Predict(p_dmat, true, &predt[fuse], 0, 0);
+        }
+        ASSERT_EQ(predt[0].ConstHostVector(), predt[1].ConstHostVector());
+      }
+    }
+  }
+}
+
+TEST(Learner, AsyncEval) {
+  bst_idx_t constexpr kRows = 256;
+  std::int32_t constexpr kIters = 4;
+  auto p_train = RandomDataGenerator{kRows, 8, 0.0}.Classes(2).GenerateDMatrix(true);
+  auto p_valid = RandomDataGenerator{kRows, 8, 0.0}.Classes(2).Seed(1).GenerateDMatrix(true);
+  std::vector<std::shared_ptr<DMatrix>> data_sets{p_train, p_valid};
+  std::vector<std::string> data_names{"train", "valid"};
+
+  std::vector<std::vector<std::string>> results(2);
+  for (bool async : {false, true}) {
+    std::unique_ptr<Learner> learner{Learner::Create(data_sets)};
+    learner->SetParams(Args{{"objective", "binary:logistic"},
+                            {"eval_metric", "auc"},
+                            {"eval_metric", "logloss"},
+                            {"async_eval", async ? "true" : "false"}});
+    for (std::int32_t iter = 0; iter < kIters; ++iter) {
+      learner->UpdateOneIter(iter, p_train);
+      auto result = learner->EvalOneIter(iter, data_sets, data_names);
+      if (async && iter == 0) {
+        // No result until the second iteration.
+        ASSERT_TRUE(result.empty());
+      } else {
+        results[async].push_back(result);
+      }
+    }
+    auto pending = learner->EvalPending();
+    ASSERT_EQ(pending.empty(), !async);
+    if (async) {
+      results[async].push_back(pending);
+    }
+    ASSERT_TRUE(learner->EvalPending().empty());
+  }
+  ASSERT_EQ(results[0].size(), kIters);
+  ASSERT_EQ(results[0], results[1]);
+  ASSERT_EQ(results[1].front().substr(0, 3), "[0]");
+
+  {
+    // Destroy the learner with an evaluation in flight.
+    std::unique_ptr<Learner> learner{Learner::Create(data_sets)};
+    learner->SetParams(Args{{"objective", "binary:logistic"}, {"async_eval", "true"}});
+    learner->UpdateOneIter(0, p_train);
+    ASSERT_TRUE(learner->EvalOneIter(0, data_sets, data_names).empty());
+  }
+}
+
 TEST(Learner, MultiTarget) {
   size_t constexpr kRows{128}, kCols{10}, kTargets{3};
   auto m = RandomDataGenerator{kRows, kCols, 0}.GenerateDMatrix();
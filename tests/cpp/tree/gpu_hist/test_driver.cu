@@ -40,6 +40,33 @@ TEST(GpuHist, DriverDepthWise) {
   EXPECT_TRUE(driver.Pop().empty());
 }
 
+TEST(GpuHist, DriverPopInto) {
+  TrainParam p;
+  p.UpdateAllowUnknown(Args{{"grow_policy", "depthwise"}});
+
+  Driver<GPUExpandEntry> driver(p, 2);
+  DeviceSplitCandidate split;
+  split.loss_chg = 1.0f;
+  split.left_sum = {0, 1};
+  split.right_sum = {0, 1};
+  for (bst_node_t nidx = 1; nidx < 4; ++nidx) {
+    driver.Push({GPUExpandEntry{nidx, 1, split, 2.0f, 1.0f, 1.0f}});
+  }
+  // The output is cleared before the new entries are appended.
+  std::vector<GPUExpandEntry> res(8, GPUExpandEntry{0, 0, split, 2.0f, 1.0f, 1.0f});
+  auto capacity = res.capacity();
+  driver.Pop(&res);
+  ASSERT_EQ(res.size(), 2);
+  ASSERT_EQ(res[0].nid, 1);
+  ASSERT_EQ(res[1].nid, 2);
+  ASSERT_EQ(res.capacity(), capacity);
+  driver.Pop(&res);
+  ASSERT_EQ(res.size(), 1);
+  ASSERT_EQ(res[0].nid, 3);
+  driver.Pop(&res);
+  ASSERT_TRUE(res.empty());
+}
+
 TEST(GpuHist, DriverLossGuided) {
   DeviceSplitCandidate high_gain;
   high_gain.left_sum = {0, 1};
@@ -49,7 +76,8 @@ TEST(GpuHist, DriverLossGuided) {
   low_gain.loss_chg = 1.0f;
 
   TrainParam p;
-  p.UpdateAllowUnknown(Args{{"grow_policy", "lossguide"}});
+  // Without a limit on leaves, entries are returned in batches.
+  p.UpdateAllowUnknown(Args{{"grow_policy", "lossguide"}, {"max_leaves", "8"}});
 
   Driver<GPUExpandEntry> driver(p);
   EXPECT_TRUE(driver.Pop().empty());
@@ -238,6 +238,112 @@ void TestDeterministicHistogram(bool is_dense, std::size_t shm_size, bool force_
   }
 }
 
+TEST(Histogram, SkewedFeature) {
+  // Most of the values of the first feature fall into the same bin, the warps contend for
+  // it when the number of features is small.
+  Context ctx = MakeCUDACtx(0);
+  bst_idx_t n_samples = 8192;
+  bst_feature_t n_features = 3;
+  bst_bin_t n_bins = 16;
+  std::vector<float> x(n_samples * n_features);
+  for (bst_idx_t i = 0; i < n_samples; ++i) {
+    x[i * n_features] = i % 97 == 0 ? static_cast<float>(i % 7) : 1.0f;
+    x[i * n_features + 1] = static_cast<float>(i % 13);
+    x[i * n_features + 2] = static_cast<float>(i % 5);
+  }
+  auto p_fmat = GetDMatrixFromData(x, n_samples, n_features);
+  auto gpair = GenerateRandomGradients(n_samples);
+  gpair.SetDevice(ctx.Device());
+
+  for (auto const& page : p_fmat->GetBatches<EllpackPage>(&ctx, BatchParam{n_bins, 0.2})) {
+    auto impl = page.Impl();
+    RowPartitioner row_partitioner;
+    row_partitioner.Reset(&ctx, n_samples, impl->base_rowid);
+    auto ridx = row_partitioner.GetRows(0);
+    auto quantiser = GradientQuantiser(&ctx, gpair.DeviceSpan(), MetaInfo());
+    auto total_bins = impl->Cuts().TotalBins();
+
+    auto build = [&](FeatureGroups const& fg, bool force_global) {
+      dh::device_vector<GradientPairInt64> histogram(total_bins);
+      DeviceHistogramBuilder builder;
+      builder.Reset(&ctx, HistMakerTrainParam::CudaDefaultNodes(),
+                    fg.DeviceAccessor(ctx.Device()), total_bins, force_global);
+      builder.BuildHistogram(ctx.CUDACtx(), impl->GetDeviceAccessor(&ctx),
+                             fg.DeviceAccessor(ctx.Device()), gpair.DeviceSpan(), ridx,
+                             dh::ToSpan(histogram), quantiser);
+      std::vector<GradientPairInt64> h_histogram(total_bins);
+      thrust::copy(histogram.cbegin(), histogram.cend(), h_histogram.begin());
+      return h_histogram;
+    };
+
+    FeatureGroups feature_groups{impl->Cuts(), impl->IsDenseCompressed(),
+                                 HistSharedMemBudget(ctx.Device())};
+    auto shared = build(feature_groups, false);
+    FeatureGroups single_group{impl->Cuts()};
+    auto global = build(single_group, true);
+    for (bst_bin_t i = 0; i < total_bins; ++i) {
+      ASSERT_EQ(shared[i].GetQuantisedGrad(), global[i].GetQuantisedGrad());
+      ASSERT_EQ(shared[i].GetQuantisedHess(), global[i].GetQuantisedHess());
+    }
+  }
+}
+
+TEST(Histogram, BuildHistBatch) {
+  Context ctx = MakeCUDACtx(0);
+  bst_idx_t n_samples = 4096;
+  bst_feature_t n_features = 16;
+  auto p_fmat = RandomDataGenerator{n_samples, n_features, 0.5}.GenerateDMatrix();
+  auto gpair = GenerateRandomGradients(n_samples);
+  gpair.SetDevice(ctx.Device());
+
+  // More nodes than a single kernel launch can handle, with uneven and empty nodes.
+  std::size_t n_nodes = 80;
+  std::vector<std::vector<cuda_impl::RowIndexT>> h_node_ridx(n_nodes);
+  for (bst_idx_t i = 0; i < n_samples; ++i) {
+    h_node_ridx[(i * i) % n_nodes].push_back(i);
+  }
+  std::vector<cuda_impl::RowIndexT> h_ridx;
+  std::vector<std::size_t> ridx_ptr{0};
+  for (auto const& rows : h_node_ridx) {
+    h_ridx.insert(h_ridx.end(), rows.cbegin(), rows.cend());
+    ridx_ptr.push_back(h_ridx.size());
+  }
+  dh::device_vector<cuda_impl::RowIndexT> ridx(h_ridx);
+
+  for (auto const& page : p_fmat->GetBatches<EllpackPage>(&ctx, BatchParam{64, 0.2})) {
+    auto impl = page.Impl();
+    auto quantiser = GradientQuantiser(&ctx, gpair.DeviceSpan(), MetaInfo());
+    auto total_bins = impl->Cuts().TotalBins();
+    FeatureGroups feature_groups{impl->Cuts(), impl->IsDenseCompressed(),
+                                 HistSharedMemBudget(ctx.Device())};
+    auto d_fg = feature_groups.DeviceAccessor(ctx.Device());
+    DeviceHistogramBuilder builder;
+    builder.Reset(&ctx, HistMakerTrainParam::CudaDefaultNodes(), d_fg, total_bins, false);
+
+    dh::device_vector<GradientPairInt64> batched(total_bins * n_nodes);
+    dh::device_vector<GradientPairInt64> single(total_bins * n_nodes);
+    std::vector<common::Span<cuda_impl::RowIndexT const>> d_ridx;
+    std::vector<common::Span<GradientPairInt64>> d_batched;
+    for (std::size_t i = 0; i < n_nodes; ++i) {
+      d_ridx.push_back(dh::ToSpan(ridx).subspan(ridx_ptr[i], ridx_ptr[i + 1] - ridx_ptr[i]));
+      d_batched.push_back(dh::ToSpan(batched).subspan(i * total_bins, total_bins));
+      builder.BuildHistogram(ctx.CUDACtx(), impl->GetDeviceAccessor(&ctx), d_fg,
+                             gpair.DeviceSpan(), d_ridx.back(),
+                             dh::ToSpan(single).subspan(i * total_bins, total_bins), quantiser);
+    }
+    builder.BuildHistogram(ctx.CUDACtx(), impl->GetDeviceAccessor(&ctx), d_fg, gpair.DeviceSpan(),
+                           d_ridx, d_batched, quantiser);
+
+    std::vector<GradientPairInt64> h_batched(batched.size()), h_single(single.size());
+    thrust::copy(batched.cbegin(), batched.cend(), h_batched.begin());
+    thrust::copy(single.cbegin(), single.cend(), h_single.begin());
+    for (std::size_t i = 0; i < h_single.size(); ++i) {
+      ASSERT_EQ(h_batched[i].GetQuantisedGrad(), h_single[i].GetQuantisedGrad());
+      ASSERT_EQ(h_batched[i].GetQuantisedHess(), h_single[i].GetQuantisedHess());
+    }
+  }
+}
+
 class TestGPUDeterministic : public ::testing::TestWithParam<std::tuple<bool, std::size_t, bool>> {
  protected:
   void Run() {
@@ -8,10 +8,12 @@
 #include <xgboost/base.h>
 #include <xgboost/tree_model.h>  // for RegTree
 
-#include <cstddef>   // for size_t
-#include <cstdint>   // for uint32_t
-#include <iterator>  // for distance
-#include <vector>    // for vector
+#include <algorithm>  // for min
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint32_t
+#include <iterator>   // for distance
+#include <numeric>    // for iota
+#include <vector>     // for vector
 
 #include "../../../../src/data/ellpack_page.cuh"
 #include "../../../../src/tree/gpu_hist/expand_entry.cuh"  // for GPUExpandEntry
@@ -56,7 +58,8 @@ void TestUpdatePositionBatch() {
 
 TEST(RowPartitioner, Batch) { TestUpdatePositionBatch(); }
 
-void TestSortPositionBatch(const std::vector<int>& ridx_in, const std::vector<Segment>& segments) {
+void TestSortPositionBatch(const std::vector<int>& ridx_in, const std::vector<Segment>& segments,
+                           bool compaction = false) {
   auto ctx = MakeCUDACtx(0);
   thrust::device_vector<cuda_impl::RowIndexT> ridx = ridx_in;
   thrust::device_vector<cuda_impl::RowIndexT> ridx_tmp(ridx_in.size());
@@ -77,10 +80,16 @@ void TestSortPositionBatch(const std::vector<int>& ridx_in, const std::vector<Se
   dh::safe_cuda(cudaMemcpyAsync(d_batch_info.data().get(), h_batch_info.data(),
                                 h_batch_info.size() * sizeof(PerNodeData<int>), cudaMemcpyDefault,
                                 nullptr));
-  dh::DeviceUVector<std::int8_t> tmp;
-  SortPositionBatch<decltype(op), int>(&ctx, dh::ToSpan(d_batch_info), dh::ToSpan(ridx),
-                                       dh::ToSpan(ridx_tmp), dh::ToSpan(counts), total_rows, op,
-                                       &tmp);
+  if (compaction) {
+    PartitionPositionBatch<decltype(op), int>(&ctx, dh::ToSpan(d_batch_info), dh::ToSpan(ridx),
+                                              dh::ToSpan(ridx_tmp), dh::ToSpan(counts),
+                                              total_rows, op);
+  } else {
+    dh::DeviceUVector<std::int8_t> tmp;
+    SortPositionBatch<decltype(op), int>(&ctx, dh::ToSpan(d_batch_info), dh::ToSpan(ridx),
+                                         dh::ToSpan(ridx_tmp), dh::ToSpan(counts), total_rows, op,
+                                         &tmp);
+  }
 
   auto op_without_data = [=] __device__(auto ridx) {
     return ridx % 2 == 0;
@@ -105,6 +114,24 @@ TEST(RowPartitioner, SortPositionBatch) {
   TestSortPositionBatch({0, 1, 2, 3, 4, 5}, {{3, 6}, {0, 2}});
 }
 
+TEST(RowPartitioner, PartitionPositionBatch) {
+  TestSortPositionBatch({0, 1, 2, 3, 4, 5}, {{0, 3}, {3, 6}}, true);
+  TestSortPositionBatch({0, 1, 2, 3, 4, 5}, {{0, 1}, {3, 6}}, true);
+  TestSortPositionBatch({0, 1, 2, 3, 4, 5}, {{0, 6}}, true);
+  TestSortPositionBatch({0, 1, 2, 3, 4, 5}, {{3, 6}, {0, 2}}, true);
+  // Nodes that span across warps and warps that span across nodes.
+  std::vector<int> ridx(100000);
+  std::iota(ridx.begin(), ridx.end(), 0);
+  std::vector<Segment> segments;
+  for (cuda_impl::RowIndexT begin = 0, size = 1; begin < ridx.size(); size = size * 3 + 1) {
+    auto end = std::min(begin + size, static_cast<cuda_impl::RowIndexT>(ridx.size()));
+    segments.emplace_back(begin, end);
+    begin = end;
+  }
+  ASSERT_LE(segments.size(), cuda_impl::kMaxUpdatePositionBatchSize);
+  TestSortPositionBatch(ridx, segments, true);
+}
+
 namespace {
 void GetSplit(RegTree* tree, float split_value, std::vector<GPUExpandEntry>* candidates) {
   CHECK(!tree->IsMultiTarget());
@@ -168,6 +168,96 @@ TEST(HistEvaluator, Evaluate) {
   TestEvaluateSplits(true);
 }
 
+TEST(HistEvaluator, NumericalScan) {
+  // Compare the vectorised scan against the split evaluator.
+  Context ctx;
+  ctx.nthread = 2;
+  bst_feature_t constexpr kCols = 3;
+  bst_bin_t constexpr kBinsPerFeature = 37;
+  auto sampler = std::make_shared<common::ColumnSampler>(1u);
+
+  common::HistogramCuts cuts;
+  auto &h_ptrs = cuts.cut_ptrs_.HostVector();
+  auto &h_vals = cuts.cut_values_.HostVector();
+  h_ptrs = {0};
+  for (bst_feature_t f = 0; f < kCols; ++f) {
+    for (bst_bin_t i = 0; i < kBinsPerFeature; ++i) {
+      h_vals.push_back(static_cast<float>(i));
+    }
+    h_ptrs.push_back(h_vals.size());
+  }
+  cuts.min_vals_.HostVector().resize(kCols, -1.0f);
+  MetaInfo info;
+  info.num_col_ = kCols;
+
+  HistMakerTrainParam hist_param;
+  BoundedHistCollection hist;
+  hist.Reset(cuts.TotalBins(), hist_param.MaxCachedHistNodes(ctx.Device()));
+  hist.AllocateHistograms({0});
+  SimpleLCG lcg;
+  SimpleRealUniformDistribution<double> grad_dist{-4.0, 4.0};
+  SimpleRealUniformDistribution<double> hess_dist{0.0, 4.0};
+  for (auto &e : hist[0]) {
+    e = GradientPairPrecise{grad_dist(&lcg), hess_dist(&lcg)};
+  }
+  // Some missing values.
+  GradStats parent_sum{grad_dist(&lcg), hess_dist(&lcg)};
+  for (std::size_t i = cuts.Ptrs()[0]; i < cuts.Ptrs()[1]; ++i) {
+    parent_sum.Add(hist[0][i].GetGrad(), hist[0][i].GetHess());
+  }
+
+  for (auto alpha : {"0", "1.5"}) {
+    TrainParam param;
+    param.UpdateAllowUnknown(
+        Args{{"min_child_weight", "2"}, {"reg_lambda", "0.5"}, {"reg_alpha", alpha}});
+    auto evaluator = HistEvaluator{&ctx, &param, info, sampler};
+    RegTree tree;
+    std::vector<CPUExpandEntry> entries(1);
+    entries.front().nid = 0;
+    entries.front().depth = 0;
+    evaluator.InitRoot(parent_sum);
+    evaluator.EvaluateSplits(hist, cuts, {}, tree, &entries);
+
+    SplitEntry expected;
+    auto split_evaluator = evaluator.Evaluator();
+    auto root_gain = evaluator.Stats().front().root_gain;
+    auto valid = [&](GradStats const &l, GradStats const &r) {
+      return l.GetHess() >= param.min_child_weight && r.GetHess() >= param.min_child_weight;
+    };
+    for (bst_feature_t f = 0; f < kCols; ++f) {
+      GradStats left, right;
+      // Forward, missing on the right.
+      for (auto i = cuts.Ptrs()[f]; i < cuts.Ptrs()[f + 1]; ++i) {
+        left.Add(hist[0][i].GetGrad(), hist[0][i].GetHess());
+        right.SetSubstract(parent_sum, left);
+        if (valid(left, right)) {
+          auto loss_chg = split_evaluator.CalcSplitGain(param, 0, f, left, right) - root_gain;
+          expected.Update(loss_chg, f, cuts.Values()[i], false, false, left, right);
+        }
+      }
+      // Backward, missing on the left.
+      left = right = GradStats{};
+      for (auto i = cuts.Ptrs()[f + 1]; i > cuts.Ptrs()[f]; --i) {
+        right.Add(hist[0][i - 1].GetGrad(), hist[0][i - 1].GetHess());
+        left.SetSubstract(parent_sum, right);
+        if (valid(left, right)) {
+          auto loss_chg = split_evaluator.CalcSplitGain(param, 0, f, left, right) - root_gain;
+          auto split_pt = i - 1 == cuts.Ptrs()[f] ? cuts.MinValues()[f] : cuts.Values()[i - 2];
+          expected.Update(loss_chg, f, split_pt, true, false, left, right);
+        }
+      }
+    }
+
+    auto const &split = entries.front().split;
+    ASSERT_GT(split.loss_chg, 0.0f);
+    ASSERT_EQ(split.loss_chg, expected.loss_chg);
+    ASSERT_EQ(split.SplitIndex(), expected.SplitIndex());
+    ASSERT_EQ(split.DefaultLeft(), expected.DefaultLeft());
+    ASSERT_EQ(split.split_value, expected.split_value);
+    ASSERT_EQ(split.left_sum.GetHess(), expected.left_sum.GetHess());
+  }
+}
+
 TEST(HistMultiEvaluator, Evaluate) {
   Context ctx;
   ctx.nthread = 1;
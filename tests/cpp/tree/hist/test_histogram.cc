@@ -17,7 +17,9 @@
 #include <iterator>    // for back_inserter
 #include <limits>      // for numeric_limits
 #include <memory>      // for shared_ptr, allocator, unique_ptr
+#include <string>      // for to_string
 #include <numeric>     // for iota, accumulate
+#include <utility>     // for move
 #include <vector>      // for vector
 
 #include "../../../../src/collective/communicator-inl.h"  // for GetRank, GetWorldSize
@@ -86,6 +88,53 @@ TEST(CPUHistogram, AddRows) {
   TestAddHistRows(false);
 }
 
+TEST(CPUHistogram, EvictCache) {
+  Context ctx;
+  bst_bin_t constexpr kBins = 8;
+  HistMakerTrainParam hist_param;
+  hist_param.Init(Args{{"max_cached_hist_node", "4"}});
+  HistogramBuilder histogram_builder;
+  histogram_builder.Reset(&ctx, kBins, {kBins, 0.5}, false, false, &hist_param);
+
+  RegTree tree;
+  std::vector<bst_node_t> nodes_to_build{RegTree::kRoot};
+  std::vector<bst_node_t> nodes_to_sub;
+  histogram_builder.AddHistRows(&tree, &nodes_to_build, &nodes_to_sub, true);
+
+  tree.ExpandNode(RegTree::kRoot, 0, 0, false, 0, 0, 0, 0, 0, 0, 0);
+  nodes_to_build = {tree.LeftChild(RegTree::kRoot)};
+  nodes_to_sub = {tree.RightChild(RegTree::kRoot)};
+  histogram_builder.AddHistRows(&tree, &nodes_to_build, &nodes_to_sub, true);
+  auto &hist = histogram_builder.Histogram();
+  auto right = tree.RightChild(RegTree::kRoot);
+  std::fill_n(hist[right].data(), kBins, GradientPairPrecise{1.0, 2.0});
+
+  // Grow the left child, the cache is full.
+  auto left = tree.LeftChild(RegTree::kRoot);
+  tree.ExpandNode(left, 0, 0, false, 0, 0, 0, 0, 0, 0, 0);
+  nodes_to_build = {tree.LeftChild(left)};
+  nodes_to_sub = {tree.RightChild(left)};
+  histogram_builder.AddHistRows(&tree, &nodes_to_build, &nodes_to_sub, true);
+  // The parent is kept for subtraction, and the right leaf is kept for later.
+  ASSERT_EQ(nodes_to_sub.size(), 1);
+  ASSERT_TRUE(hist.HistogramExists(left));
+  ASSERT_FALSE(hist.HistogramExists(RegTree::kRoot));
+  ASSERT_TRUE(hist.HistogramExists(right));
+  for (auto v : hist[right]) {
+    ASSERT_EQ(v.GetGrad(), 1.0);
+    ASSERT_EQ(v.GetHess(), 2.0);
+  }
+
+  // Grow the right leaf, its histogram can still be used for subtraction.
+  tree.ExpandNode(right, 0, 0, false, 0, 0, 0, 0, 0, 0, 0);
+  nodes_to_build = {tree.LeftChild(right)};
+  nodes_to_sub = {tree.RightChild(right)};
+  histogram_builder.AddHistRows(&tree, &nodes_to_build, &nodes_to_sub, true);
+  ASSERT_EQ(nodes_to_build.size(), 1);
+  ASSERT_EQ(nodes_to_sub.size(), 1);
+  ASSERT_TRUE(hist.HistogramExists(right));
+}
+
 void TestSyncHist(bool is_distributed) {
   std::size_t constexpr kNRows = 8, kNCols = 16;
   bst_bin_t constexpr kMaxBins = 4;
@@ -298,6 +347,65 @@ TEST(CPUHistogram, BuildHist) {
   TestBuildHistogram(&ctx, false, true, false);
 }
 
+TEST(CPUHistogram, BuildByFeature) {
+  // Two blocks of rows for four threads, built by feature blocks.
+  bst_idx_t constexpr kRows = 300;
+  bst_feature_t constexpr kCols = 64;
+  bst_bin_t constexpr kMaxBins = 16;
+  auto p_fmat = RandomDataGenerator{kRows, kCols, 0.0}.Seed(3).GenerateDMatrix();
+  Context ctx;
+  auto gpair = GenerateRandomGradients(&ctx, kRows, 1);
+  std::vector<bst_feature_t> sampled(kCols / 2);
+  std::iota(sampled.begin(), sampled.end(), kCols / 4);
+
+  auto build = [&](std::int32_t n_threads, bool force_read_by_column, bool colsample) {
+    Context ctx;
+    ctx.UpdateAllowUnknown(Args{{"nthread", std::to_string(n_threads)}});
+    HistogramBuilder histogram;
+    HistMakerTrainParam hist_param;
+    BatchParam batch{kMaxBins, 0.5};
+    auto const &gmat = *(p_fmat->GetBatches<GHistIndexMatrix>(&ctx, batch).begin());
+    histogram.Reset(&ctx, gmat.cut.TotalBins(), batch, false, false, &hist_param);
+    if (colsample) {
+      histogram.SetFeatureSet(common::Span{sampled}, kCols);
+    }
+    RegTree tree;
+    common::RowSetCollection row_set_collection;
+    InitRowPartitionForTest(&row_set_collection, kRows);
+    std::vector<bst_node_t> nodes_to_build{RegTree::kRoot};
+    std::vector<bst_node_t> dummy_sub;
+    histogram.AddHistRows(&tree, &nodes_to_build, &dummy_sub, false);
+    common::BlockedSpace2d space{
+        1, [&](std::size_t) { return row_set_collection[RegTree::kRoot].Size(); },
+        HistogramBuilder::kRowBlockSize};
+    if (n_threads == 1) {
+      EXPECT_TRUE(histogram.SelectByFeature(space, gmat, nodes_to_build, row_set_collection)
+                      .empty());
+    } else {
+      EXPECT_EQ(histogram.SelectByFeature(space, gmat, nodes_to_build, row_set_collection)
+                    .size(),
+                1);
+    }
+    histogram.BuildHist(0, space, gmat, row_set_collection, nodes_to_build,
+                        gpair.HostView().Slice(linalg::All(), 0), force_read_by_column);
+    histogram.SyncHistogram(&ctx, &tree, nodes_to_build, {});
+    auto hist = histogram.Histogram()[RegTree::kRoot];
+    return std::vector<GradientPairPrecise>(hist.cbegin(), hist.cend());
+  };
+
+  for (auto force_read_by_column : {false, true}) {
+    for (auto colsample : {false, true}) {
+      auto expected = build(1, force_read_by_column, colsample);
+      auto got = build(4, force_read_by_column, colsample);
+      ASSERT_EQ(expected.size(), got.size());
+      for (std::size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(expected[i].GetGrad(), got[i].GetGrad());
+        ASSERT_EQ(expected[i].GetHess(), got[i].GetHess());
+      }
+    }
+  }
+}
+
 TEST(CPUHistogram, BuildHistColumnSplit) {
   auto constexpr kWorkers = 4;
   Context ctx;
@@ -512,6 +620,127 @@ TEST(CPUHistogram, ExternalMemory) {
   TestHistogramExternalMemory(&ctx, {kBins, sparse_thresh}, false, true);
 }
 
+namespace {
+// Grow a complete tree with 3 levels and return the histograms of the last level.
+std::vector<GradientPairPrecise> BuildCompleteTree(Context const *ctx, DMatrix *p_fmat,
+                                                   bool is_distributed) {
+  bst_bin_t constexpr kBins = 64;
+  HistMakerTrainParam hist_param;
+  auto batch = BatchParam{kBins, TrainParam::DftSparseThreshold()};
+  common::HistogramCuts cuts;
+  for (auto const &page : p_fmat->GetBatches<GHistIndexMatrix>(ctx, batch)) {
+    cuts = page.cut;
+  }
+
+  RegTree tree;
+  MultiHistogramBuilder hist_builder;
+  hist_builder.Reset(ctx, cuts.TotalBins(), tree.NumTargets(), batch, is_distributed, false,
+                     &hist_param);
+  std::vector<CommonRowPartitioner> partitioners;
+  partitioners.emplace_back(ctx, p_fmat->Info().num_row_, /*base_rowid=*/0, false);
+  auto gpair = GenerateRandomGradients(p_fmat->Info().num_row_, 0.0, 1.0);
+  auto h_gpair = linalg::MakeTensorView(ctx, gpair.ConstHostSpan(), gpair.Size(), 1);
+
+  CPUExpandEntry root;
+  hist_builder.BuildRootHist(p_fmat, &tree, partitioners, h_gpair, root, batch);
+  std::vector<CPUExpandEntry> candidates{root};
+  for (bst_feature_t fidx = 0; fidx < 3; ++fidx) {
+    // Split at the middle of the feature.
+    auto split_cond = cuts.Values()[(cuts.Ptrs()[fidx] + cuts.Ptrs()[fidx + 1]) / 2];
+    for (auto &c : candidates) {
+      c.split.Update(1.0f, fidx, split_cond, false, false, GradStats{1.0, 1.0},
+                     GradStats{1.0, 1.0});
+      tree.ExpandNode(c.nid, c.split.SplitIndex(), c.split.split_value, false, 2.0f, 1.0f, 1.0f,
+                      c.GetLossChange(), 2.0f, 1.0f, 1.0f);
+    }
+    for (auto const &page : p_fmat->GetBatches<GHistIndexMatrix>(ctx, batch)) {
+      partitioners.front().UpdatePosition(ctx, page, candidates, &tree);
+    }
+    hist_builder.BuildHistLeftRight(ctx, p_fmat, &tree, partitioners, candidates, h_gpair, batch);
+
+    std::vector<CPUExpandEntry> children;
+    for (auto const &c : candidates) {
+      children.emplace_back(tree.LeftChild(c.nid), tree.GetDepth(c.nid) + 1);
+      children.emplace_back(tree.RightChild(c.nid), tree.GetDepth(c.nid) + 1);
+    }
+    candidates = std::move(children);
+  }
+
+  std::vector<GradientPairPrecise> result;
+  for (auto const &c : candidates) {
+    auto hist = hist_builder.Histogram(0)[c.nid];
+    std::copy(hist.cbegin(), hist.cend(), std::back_inserter(result));
+  }
+  return result;
+}
+}  // anonymous namespace
+
+TEST(CPUHistogram, OverlappedSync) {
+  // Build the histograms in groups while the allreduce runs in the background, then
+  // compare with the local histograms. All workers have the same data.
+  std::int32_t constexpr kWorkers = 3;
+  collective::TestDistributedGlobal(kWorkers, [&] {
+    Context ctx;
+    ctx.UpdateAllowUnknown(Args{{"nthread", "2"}});
+    auto p_fmat = RandomDataGenerator{2048, 8, 0.0}.Seed(3).GenerateDMatrix();
+    auto local = BuildCompleteTree(&ctx, p_fmat.get(), false);
+    auto global = BuildCompleteTree(&ctx, p_fmat.get(), true);
+    ASSERT_EQ(local.size(), global.size());
+    for (std::size_t i = 0; i < local.size(); ++i) {
+      ASSERT_NEAR(local[i].GetGrad() * kWorkers, global[i].GetGrad(), kRtEps);
+      ASSERT_NEAR(local[i].GetHess() * kWorkers, global[i].GetHess(), kRtEps);
+    }
+  });
+}
+
+TEST(CPUHistogram, MultiTargetFused) {
+  // The fused kernel for all targets should give the same histograms as building each
+  // target separately.
+  Context ctx;
+  ctx.UpdateAllowUnknown(Args{{"nthread", "2"}});
+  bst_bin_t constexpr kBins = 32;
+  bst_target_t constexpr kTargets = 3;
+  bst_idx_t constexpr kRows = 512;
+  bst_feature_t constexpr kCols = 8;
+  HistMakerTrainParam hist_param;
+  auto batch = BatchParam{kBins, TrainParam::DftSparseThreshold()};
+
+  for (float sparsity : {0.0f, 0.4f}) {
+    auto p_fmat = RandomDataGenerator{kRows, kCols, sparsity}.Seed(3).GenerateDMatrix();
+    bst_bin_t n_total_bins{0};
+    for (auto const &page : p_fmat->GetBatches<GHistIndexMatrix>(&ctx, batch)) {
+      n_total_bins = page.cut.TotalBins();
+    }
+    auto gpair = GenerateRandomGradients(&ctx, kRows, kTargets);
+    std::vector<CommonRowPartitioner> partitioners;
+    partitioners.emplace_back(&ctx, kRows, /*base_rowid=*/0, false);
+    CPUExpandEntry root;
+
+    RegTree tree{kTargets, kCols};
+    MultiHistogramBuilder fused;
+    fused.Reset(&ctx, n_total_bins, kTargets, batch, false, false, &hist_param);
+    fused.BuildRootHist(p_fmat.get(), &tree, partitioners, gpair.HostView(), root, batch);
+
+    for (bst_target_t t = 0; t < kTargets; ++t) {
+      RegTree t_tree{1, kCols};
+      linalg::Matrix<GradientPair> t_gpair{{kRows, static_cast<bst_idx_t>(1)}, ctx.Device()};
+      for (bst_idx_t i = 0; i < kRows; ++i) {
+        t_gpair.HostView()(i, 0) = gpair.HostView()(i, t);
+      }
+      MultiHistogramBuilder single;
+      single.Reset(&ctx, n_total_bins, 1, batch, false, false, &hist_param);
+      single.BuildRootHist(p_fmat.get(), &t_tree, partitioners, t_gpair.HostView(), root, batch);
+      auto expected = single.Histogram(0)[RegTree::kRoot];
+      auto got = fused.Histogram(t)[RegTree::kRoot];
+      ASSERT_EQ(expected.size(), got.size());
+      for (std::size_t i = 0; i < got.size(); ++i) {
+        ASSERT_NEAR(expected[i].GetGrad(), got[i].GetGrad(), kRtEps);
+        ASSERT_NEAR(expected[i].GetHess(), got[i].GetHess(), kRtEps);
+      }
+    }
+  }
+}
+
 namespace {
 class OverflowTest : public ::testing::TestWithParam<std::tuple<bool, bool>> {
  public:
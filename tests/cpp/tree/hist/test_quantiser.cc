@@ -0,0 +1,85 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+#include <xgboost/json.h>     // for Json
+#include <xgboost/learner.h>  // for Learner
+
+#include <cmath>    // for nearbyint
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int32_t
+#include <limits>   // for numeric_limits
+#include <memory>   // for unique_ptr
+#include <string>   // for string, to_string
+#include <vector>   // for vector
+
+#include "../../../../src/tree/hist/quantiser.h"  // for HistQuantiser
+#include "../../helpers.h"                        // for GenerateRandomGradients
+
+namespace xgboost::tree {
+TEST(HistQuantiser, Grid) {
+  Context ctx;
+  ctx.UpdateAllowUnknown(Args{{"nthread", "4"}});
+  bst_idx_t constexpr kRows = 4096;
+  bst_target_t constexpr kTargets = 2;
+  auto gpair = GenerateRandomGradients(&ctx, kRows, kTargets, -1.0f, 1.0f);
+  MetaInfo info;
+  info.num_row_ = kRows;
+
+  HistQuantiser quantiser{&ctx, info, gpair.HostView()};
+  auto factor = quantiser.ToFixedPointFactor();
+  // Power of 2
+  ASSERT_EQ(std::log2(factor.GetGrad()), std::nearbyint(std::log2(factor.GetGrad())));
+  ASSERT_EQ(std::log2(factor.GetHess()), std::nearbyint(std::log2(factor.GetHess())));
+  quantiser.Quantise(&ctx, gpair.HostView());
+
+  auto h_gpair = gpair.HostView();
+  // All values are on the grid, and the sum doesn't depend on the order.
+  GradientPairPrecise forward, backward;
+  for (std::size_t i = 0; i < h_gpair.Size(); ++i) {
+    auto g = h_gpair.Values()[i].GetGrad() * factor.GetGrad();
+    auto h = h_gpair.Values()[i].GetHess() * factor.GetHess();
+    ASSERT_EQ(g, std::nearbyint(g));
+    ASSERT_EQ(h, std::nearbyint(h));
+    forward += GradientPairPrecise{h_gpair.Values()[i]};
+    backward += GradientPairPrecise{h_gpair.Values()[h_gpair.Size() - i - 1]};
+  }
+  ASSERT_EQ(forward.GetGrad(), backward.GetGrad());
+  ASSERT_EQ(forward.GetHess(), backward.GetHess());
+  auto constexpr kMax = static_cast<double>(std::numeric_limits<std::int32_t>::max());
+  ASSERT_LE(forward.GetHess() * factor.GetHess(), kMax);
+
+  // Round trip
+  std::vector<GradientPairPrecise> hist{forward, backward, GradientPairPrecise{h_gpair(0, 1)}};
+  std::vector<std::int32_t> fixed(hist.size() * 2);
+  quantiser.ToFixedPoint(&ctx, common::Span{hist}, common::Span{fixed});
+  ASSERT_EQ(fixed[0], static_cast<std::int32_t>(forward.GetGrad() * factor.GetGrad()));
+  std::vector<GradientPairPrecise> restored(hist.size());
+  quantiser.ToFloatingPoint(&ctx, common::Span{fixed}, common::Span{restored});
+  for (std::size_t i = 0; i < hist.size(); ++i) {
+    ASSERT_EQ(restored[i].GetGrad(), hist[i].GetGrad());
+    ASSERT_EQ(restored[i].GetHess(), hist[i].GetHess());
+  }
+}
+
+TEST(HistQuantiser, Deterministic) {
+  auto Xy = RandomDataGenerator{2048, 16, 0.1}.GenerateDMatrix(true);
+  auto train = [&](std::int32_t n_threads) {
+    std::unique_ptr<Learner> learner{Learner::Create({Xy})};
+    learner->SetParams(Args{{"tree_method", "hist"},
+                            {"quantise_gradient", "true"},
+                            {"max_depth", "6"},
+                            {"base_score", "0.5"},
+                            {"nthread", std::to_string(n_threads)}});
+    for (std::int32_t i = 0; i < 4; ++i) {
+      learner->UpdateOneIter(i, Xy);
+    }
+    Json model{Object{}};
+    learner->SaveModel(&model);
+    std::string str;
+    Json::Dump(model, &str);
+    return str;
+  };
+  ASSERT_EQ(train(1), train(7));
+}
+}  // namespace xgboost::tree
@@ -5,6 +5,7 @@
 
 #include <cstddef>  // std::size_t
 #include <string>   // std::to_string
+#include <vector>   // std::vector
 
 #include "../../../../src/tree/hist/sampler.h"  // SampleGradient
 #include "../../../../src/tree/param.h"         // TrainParam
@@ -53,5 +54,53 @@ TEST(Sampler, Basic) {
   run(1);
   run(3);
 }
+
+TEST(Sampler, GradientBased) {
+  std::size_t constexpr kRows = 4096;
+  double constexpr kSubsample = .2;
+  TrainParam param;
+  param.UpdateAllowUnknown(
+      Args{{"subsample", std::to_string(kSubsample)}, {"sampling_method", "gradient_based"}});
+  Context ctx;
+  ctx.UpdateAllowUnknown(Args{{"nthread", "4"}});
+
+  auto gpair = linalg::Constant(&ctx, GradientPair{}, kRows, 1);
+  auto h_gpair = gpair.HostView();
+  for (std::size_t i = 0; i < kRows; ++i) {
+    // A few rows with large gradient, and some rows with empty gradient.
+    float g = i % 64 == 0 ? 100.0f : static_cast<float>(i % 7);
+    h_gpair(i, 0) = GradientPair{g, g == 0.0f ? 0.0f : 1.0f};
+  }
+  auto orig = h_gpair.Values();
+  std::vector<GradientPair> h_orig(orig.cbegin(), orig.cend());
+  SampleGradient(&ctx, param, h_gpair);
+
+  std::size_t n_sampled{0};
+  double orig_sum{0}, sampled_sum{0};
+  for (std::size_t i = 0; i < kRows; ++i) {
+    orig_sum += h_orig[i].GetGrad();
+    sampled_sum += h_gpair(i, 0).GetGrad();
+    if (h_orig[i].GetGrad() == 0.0f) {
+      ASSERT_EQ(h_gpair(i, 0).GetGrad(), 0.0f);
+      ASSERT_EQ(h_gpair(i, 0).GetHess(), 0.0f);
+      continue;
+    }
+    if (h_orig[i].GetGrad() == 100.0f) {
+      // Always selected without scaling.
+      ASSERT_EQ(h_gpair(i, 0).GetGrad(), h_orig[i].GetGrad());
+      ASSERT_EQ(h_gpair(i, 0).GetHess(), h_orig[i].GetHess());
+    }
+    if (h_gpair(i, 0).GetHess() != 0.0f) {
+      n_sampled++;
+      // Scaled by the inverse of the probability.
+      ASSERT_GE(h_gpair(i, 0).GetHess(), h_orig[i].GetHess());
+    }
+  }
+  auto ratio = static_cast<double>(n_sampled) / static_cast<double>(kRows);
+  ASSERT_LT(ratio, kSubsample * 1.5);
+  ASSERT_GT(ratio, kSubsample * 0.5);
+  // The sampled gradient is an unbiased estimation.
+  ASSERT_NEAR(sampled_sum / orig_sum, 1.0, 0.2);
+}
 }  // namespace tree
 }  // namespace xgboost
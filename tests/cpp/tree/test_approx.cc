@@ -6,6 +6,7 @@
 
 #include <algorithm>  // for transform
 #include <memory>     // for unique_ptr
+#include <string>     // for string
 #include <vector>     // for vector
 
 #include "../../../src/tree/common_row_partitioner.h"
@@ -130,6 +131,52 @@ TEST(Approx, InteractionConstraint) {
   }
 }
 
+TEST(Approx, SketchReuse) {
+  bst_idx_t constexpr kRows = 2048;
+  bst_feature_t constexpr kCols = 4;
+  Context ctx;
+  ObjInfo task{ObjInfo::kRegression};
+  TrainParam param;
+  param.UpdateAllowUnknown(Args{{"max_bin", "16"}});
+
+  auto run = [&](std::string threshold) {
+    auto p_fmat = RandomDataGenerator{kRows, kCols, 0}.GenerateDMatrix();
+    std::unique_ptr<TreeUpdater> updater{TreeUpdater::Create("grow_histmaker", &ctx, &task)};
+    updater->Configure(Args{{"sketch_reuse_threshold", threshold}});
+    auto update = [&](auto hess_fn) {
+      linalg::Matrix<GradientPair> gpair({kRows}, ctx.Device());
+      auto& h_gpair = gpair.Data()->HostVector();
+      for (bst_idx_t i = 0; i < kRows; ++i) {
+        h_gpair[i] = GradientPair{static_cast<float>(i % 3) - 1.0f, hess_fn(i)};
+      }
+      RegTree tree{1, kCols};
+      std::vector<HostDeviceVector<bst_node_t>> position(1);
+      updater->Update(&param, &gpair, p_fmat.get(), position, {&tree});
+      // Get the cached gradient index without regeneration.
+      for (auto const& page : p_fmat->GetBatches<GHistIndexMatrix>(&ctx, {16, {}, false})) {
+        return page.cut.Values();
+      }
+      return std::vector<float>{};
+    };
+    std::vector<std::vector<float>> cuts;
+    cuts.push_back(update([](bst_idx_t) { return 1.0f; }));
+    // The total variation distance to the uniform hessian is about 0.03.
+    cuts.push_back(update([&](bst_idx_t i) { return i < kRows / 32 ? 2.0f : 1.0f; }));
+    // Most of the weight is in the first half of the rows.
+    cuts.push_back(update([&](bst_idx_t i) { return i < kRows / 2 ? 100.0f : 0.01f; }));
+    return cuts;
+  };
+
+  auto regen = run("0");
+  ASSERT_NE(regen[0], regen[1]);
+  ASSERT_NE(regen[1], regen[2]);
+
+  auto reuse = run("0.1");
+  ASSERT_EQ(reuse[0], regen[0]);
+  ASSERT_EQ(reuse[0], reuse[1]);
+  ASSERT_EQ(reuse[2], regen[2]);
+}
+
 namespace {
 void TestColumnSplitPartitioner(size_t n_samples, size_t base_rowid, std::shared_ptr<DMatrix> Xy,
                                 std::vector<float>* hess, float min_value, float mid_value,
@@ -6,7 +6,9 @@
 #include <xgboost/context.h>                      // for Context
 
 #include <algorithm>                              // for transform
+#include <cstdint>                                // for uint32_t
 #include <iterator>                               // for distance
+#include <type_traits>                            // for is_same_v
 #include <vector>                                 // for vector
 
 #include "../../../src/common/numeric.h"          // for ==RunLengthEncode
@@ -139,4 +141,61 @@ TEST(CommonRowPartitioner, LeafPartition) {
 }
 
 TEST(CommonRowPartitioner, LeafPartitionExternalMemory) { TestExternalMemory(); }
+
+TEST(CommonRowPartitioner, SampledRows) {
+  Context ctx;
+  ctx.UpdateAllowUnknown(Args{{"nthread", "3"}});
+  bst_idx_t n_samples = 5000, base_rowid = 128;
+  bst_target_t n_targets = 2;
+  auto gpair = linalg::Constant(&ctx, GradientPair{}, n_samples, n_targets);
+  auto h_gpair = gpair.HostView();
+  std::vector<bst_idx_t> expected;
+  for (bst_idx_t i = 0; i < n_samples; ++i) {
+    if (i % 3 == 0) {
+      // Sampled if any of the targets is not empty.
+      h_gpair(i, i % 2) = GradientPair{1.0f, 0.0f};
+      expected.push_back(i + base_rowid);
+    }
+  }
+
+  CommonRowPartitioner partitioner{&ctx, n_samples, base_rowid, false};
+  ASSERT_EQ(partitioner[RegTree::kRoot].Size(), n_samples);
+  partitioner.Reset(&ctx, base_rowid, h_gpair);
+  auto const& root = partitioner[RegTree::kRoot];
+  ASSERT_EQ(partitioner.Size(), 1);
+  ASSERT_EQ(std::vector<bst_idx_t>(root.begin(), root.end()), expected);
+}
+
+TEST(CommonRowPartitioner, RowIdx32) {
+  Context ctx;
+  ctx.UpdateAllowUnknown(Args{{"nthread", "2"}});
+  bst_idx_t n_samples = 4096;
+  auto p_fmat = RandomDataGenerator{n_samples, 4, 0.3}.GenerateDMatrix();
+
+  RowPartitioners partitioners;
+  partitioners.SetNumSamples(n_samples);
+  partitioners.Visit([](auto const& parts) {
+    using RowIdxT = typename std::remove_reference_t<decltype(parts)>::value_type::RowIdxType;
+    static_assert(std::is_same_v<RowIdxT, std::uint32_t> || std::is_same_v<RowIdxT, bst_idx_t>);
+    ASSERT_TRUE((std::is_same_v<RowIdxT, std::uint32_t>));
+  });
+
+  RegTree tree;
+  std::vector<CPUExpandEntry> candidates{{0, 0}};
+  for (auto const& page : p_fmat->GetBatches<GHistIndexMatrix>(&ctx, BatchParam{32, 0.2})) {
+    auto ptr = page.cut.Ptrs()[1];
+    GetSplit(&tree, page.cut.Values().at(ptr / 2), &candidates);
+
+    CommonRowPartitionerImpl<std::uint32_t> small{&ctx, page.Size(), page.base_rowid, false};
+    CommonRowPartitioner large{&ctx, page.Size(), page.base_rowid, false};
+    small.UpdatePosition(&ctx, page, candidates, &tree);
+    large.UpdatePosition(&ctx, page, candidates, &tree);
+    ASSERT_EQ(small.Size(), large.Size());
+    for (bst_node_t nidx = 0; nidx < static_cast<bst_node_t>(large.Size()); ++nidx) {
+      ASSERT_EQ(std::vector<bst_idx_t>(small[nidx].begin(), small[nidx].end()),
+                std::vector<bst_idx_t>(large[nidx].begin(), large[nidx].end()));
+    }
+    ASSERT_NE(large[tree[RegTree::kRoot].LeftChild()].Size(), 0);
+  }
+}
 }  // namespace xgboost::tree
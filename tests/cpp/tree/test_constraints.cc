@@ -5,8 +5,11 @@
 #include <xgboost/base.h>
 #include <xgboost/logging.h>
 
+#include <algorithm>  // for find
 #include <memory>
+#include <numeric>  // for iota
 #include <string>
+#include <vector>
 
 #include "../../../src/tree/constraints.h"
 #include "../../../src/tree/hist/evaluate_splits.h"
@@ -59,6 +62,48 @@ TEST(CPUFeatureInteractionConstraint, Basic) {
   ASSERT_FALSE(constraints.Query(1, 5));
 }
 
+TEST(CPUFeatureInteractionConstraint, FeatureList) {
+  // Groups across the 64-bit words of the bitsets.
+  std::string const constraints_str = R"constraint([[1, 70, 130], [70, 150], [3, 4]])constraint";
+  TrainParam param;
+  param.interaction_constraints = constraints_str;
+  bst_feature_t constexpr kFeatures = 160;
+
+  FeatureInteractionConstraintHost constraints;
+  constraints.Configure(param, kFeatures);
+  ASSERT_TRUE(constraints.Enabled());
+  constraints.Split(/*node_id=*/0, /*feature_id=*/70, /*left_id=*/1, /*right_id=*/2);
+  constraints.Split(/*node_id=*/1, /*feature_id=*/150, /*left_id=*/3, /*right_id=*/4);
+
+  std::vector<bst_feature_t> h_input_feature_list(kFeatures);
+  std::iota(h_input_feature_list.begin(), h_input_feature_list.end(), 0);
+  common::Span<bst_feature_t const> s_input{h_input_feature_list};
+  std::vector<bst_feature_t> buf;
+
+  auto s_output = constraints.Query(s_input, 0, &buf);
+  ASSERT_EQ(s_output.size(), kFeatures);
+  s_output = constraints.Query(s_input, 2, &buf);
+  ASSERT_EQ(std::vector<bst_feature_t>(s_output.cbegin(), s_output.cend()),
+            (std::vector<bst_feature_t>{1, 70, 130, 150}));
+  s_output = constraints.Query(s_input, 4, &buf);
+  ASSERT_EQ(std::vector<bst_feature_t>(s_output.cbegin(), s_output.cend()),
+            (std::vector<bst_feature_t>{70, 150}));
+  for (bst_node_t nidx = 0; nidx < 5; ++nidx) {
+    s_output = constraints.Query(s_input, nidx, &buf);
+    for (auto fidx : h_input_feature_list) {
+      bool found = std::find(s_output.cbegin(), s_output.cend(), fidx) != s_output.cend();
+      ASSERT_EQ(found, constraints.Query(nidx, fidx));
+    }
+  }
+
+  // No-op if the constraint is not enabled.
+  TrainParam empty;
+  empty.UpdateAllowUnknown(Args{});
+  FeatureInteractionConstraintHost disabled;
+  disabled.Configure(empty, kFeatures);
+  ASSERT_EQ(disabled.Query(s_input, 3, &buf).data(), s_input.data());
+}
+
 TEST(CPUMonoConstraint, Basic) {
   std::size_t kRows{64}, kCols{16};
   Context ctx;
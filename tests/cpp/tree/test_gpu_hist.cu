@@ -10,9 +10,11 @@
 #include <xgboost/tree_model.h>          // for RegTree
 #include <xgboost/tree_updater.h>        // for TreeUpdater
 
-#include <memory>  // for unique_ptr
-#include <string>  // for string
-#include <vector>  // for vector
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int32_t
+#include <memory>   // for unique_ptr
+#include <string>   // for string
+#include <vector>   // for vector
 
 #include "../../../src/common/random.h"  // for GlobalRandom
 #include "../../../src/tree/param.h"     // for TrainParam
@@ -232,6 +234,33 @@ TEST(GpuHist, MaxDepth) {
   ASSERT_THROW({learner->UpdateOneIter(0, p_mat);}, dmlc::Error);
 }
 
+TEST(GpuHist, DeferredPredictionCache) {
+  bst_idx_t constexpr kRows = 1024;
+  std::int32_t constexpr kIters = 4;
+  auto p_dmat = RandomDataGenerator{kRows, 10, 0}.Classes(3).GenerateDMatrix(true);
+  std::unique_ptr<Learner> learner{Learner::Create({p_dmat})};
+  learner->SetParams(Args{{"tree_method", "hist"},
+                          {"device", "cuda"},
+                          {"objective", "multi:softprob"},
+                          {"num_class", "3"}});
+  for (std::int32_t iter = 0; iter < kIters; ++iter) {
+    learner->UpdateOneIter(iter, p_dmat);
+  }
+  // The cache of the first two groups is updated on the side stream.
+  HostDeviceVector<float> predt;
+  learner->Predict(p_dmat, true, &predt, 0, 0, true);
+  auto p_fmat = RandomDataGenerator{kRows, 10, 0}.GenerateDMatrix();
+  HostDeviceVector<float> full;
+  learner->Predict(p_fmat, true, &full, 0, 0);
+  auto const& h_predt = predt.ConstHostVector();
+  auto const& h_full = full.ConstHostVector();
+  ASSERT_EQ(h_predt.size(), kRows * 3);
+  ASSERT_EQ(h_predt.size(), h_full.size());
+  for (std::size_t i = 0; i < h_full.size(); ++i) {
+    ASSERT_NEAR(h_predt[i], h_full[i], kRtEps);
+  }
+}
+
 TEST(GpuHist, PageConcatConfig) {
   auto ctx = MakeCUDACtx(0);
   bst_idx_t n_samples = 64, n_features = 32;
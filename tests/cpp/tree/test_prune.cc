@@ -11,7 +11,9 @@
 #include <string>
 #include <vector>
 
-#include "../../../src/tree/param.h"  // for TrainParam
+#include "../../../src/collective/comm_group.h"  // for GlobalCommGroup
+#include "../../../src/tree/param.h"             // for TrainParam
+#include "../collective/test_worker.h"           // for TestDistributedGlobal
 #include "../helpers.h"
 
 namespace xgboost::tree {
@@ -86,4 +88,88 @@ TEST(Updater, Prune) {
   pruner->Update(&param, &gpair, p_dmat.get(), position, trees);
   ASSERT_EQ(tree.NumExtraNodes(), 2);
 }
+
+TEST(Updater, Compact) {
+  bst_feature_t constexpr kCols = 4;
+  Context ctx;
+  ObjInfo task{ObjInfo::kRegression};
+  std::unique_ptr<TreeUpdater> compactor{TreeUpdater::Create("compact", &ctx, &task)};
+  compactor->Configure(Args{});
+  TrainParam param;
+  param.Init(Args{});
+  linalg::Matrix<GradientPair> gpair;
+  std::vector<HostDeviceVector<bst_node_t>> position(1);
+  auto p_dmat = RandomDataGenerator{64, kCols, 0}.GenerateDMatrix();
+
+  auto make_tree = [&](bool default_left) {
+    RegTree tree{1u, kCols};
+    tree.ExpandNode(RegTree::kRoot, 0, 0.5f, true, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f);
+    // Decided by the root for valid values, the right leaf is reachable by missing values
+    // if the default direction is right.
+    tree.ExpandNode(tree[RegTree::kRoot].LeftChild(), 0, 0.7f, default_left, 0.0f, 0.1f, 0.9f,
+                    1.0f, 1.0f, 0.0f, 0.0f);
+    // Leaves with the same value.
+    tree.ExpandNode(tree[RegTree::kRoot].RightChild(), 1, 0.5f, true, 0.0f, 0.2f, 0.2f, 1.0f,
+                    1.0f, 0.0f, 0.0f);
+    return tree;
+  };
+
+  auto tree = make_tree(true);
+  std::vector<RegTree*> trees{&tree};
+  compactor->Update(&param, &gpair, p_dmat.get(), position, trees);
+  ASSERT_EQ(tree.NumNodes(), 3);
+  ASSERT_EQ(tree[RegTree::kRoot].SplitIndex(), 0);
+  ASSERT_EQ(tree[tree[RegTree::kRoot].LeftChild()].LeafValue(), 0.1f);
+  ASSERT_EQ(tree[tree[RegTree::kRoot].RightChild()].LeafValue(), 0.2f);
+
+  tree = make_tree(false);
+  compactor->Update(&param, &gpair, p_dmat.get(), position, trees);
+  ASSERT_EQ(tree.NumNodes(), 5);
+
+  // Drop the tree.
+  compactor->Configure(Args{{"compact_drop_threshold", "1.0"}});
+  compactor->Update(&param, &gpair, p_dmat.get(), position, trees);
+  ASSERT_EQ(tree.NumNodes(), 1);
+  ASSERT_GE(tree[RegTree::kRoot].LeafValue(), 0.1f);
+  ASSERT_LE(tree[RegTree::kRoot].LeafValue(), 0.2f);
+
+  Json config{Object{}};
+  compactor->SaveConfig(&config);
+  ASSERT_EQ(get<String const>(config["compact_train_param"]["compact_drop_threshold"]), "1");
+}
+TEST(Updater, Sync) {
+  std::int32_t n_workers = 3;
+  collective::TestDistributedGlobal(n_workers, [&] {
+    Context ctx;
+    ObjInfo task{ObjInfo::kRegression};
+    auto rank = collective::GetRank();
+    auto make_tree = [](float leaf) {
+      RegTree tree{1u, 4};
+      tree.ExpandNode(RegTree::kRoot, 1, 0.5f, true, 0.0f, leaf, -leaf, 1.0f, 1.0f, 0.5f, 0.5f);
+      return tree;
+    };
+    std::unique_ptr<TreeUpdater> syncher{TreeUpdater::Create("sync", &ctx, &task)};
+    syncher->Configure({});
+    TrainParam param;
+    param.Init(Args{});
+    std::vector<HostDeviceVector<bst_node_t>> position(1);
+    auto* stats = collective::GlobalCommGroup()->Stats();
+
+    // Identical trees are not broadcast.
+    stats->Clear();
+    auto tree = make_tree(0.1f);
+    std::vector<RegTree*> trees{&tree};
+    syncher->Update(&param, nullptr, nullptr, position, trees);
+    ASSERT_TRUE(tree == make_tree(0.1f));
+    auto jstats = stats->ToJson();
+    for (auto const& kv : get<Object const>(jstats)) {
+      ASSERT_EQ(kv.first.find("Broadcast"), std::string::npos);
+    }
+
+    // The tree of the first worker is used when they are different.
+    tree = make_tree(rank == 1 ? 0.2f : 0.1f);
+    syncher->Update(&param, nullptr, nullptr, position, trees);
+    ASSERT_TRUE(tree == make_tree(0.1f));
+  });
+}
 }  // namespace xgboost::tree
@@ -6,9 +6,12 @@
 #include <xgboost/tree_updater.h>
 
 #include <cstddef>  // for size_t
+#include <cstdint>  // for int32_t
 #include <string>
+#include <utility>  // for make_pair
 #include <vector>
 
+#include "../../../src/common/random.h"  // for GlobalRandom
 #include "../../../src/tree/common_row_partitioner.h"
 #include "../../../src/tree/hist/expand_entry.h"  // for MultiExpandEntry, CPUExpandEntry
 #include "../collective/test_worker.h"  // for TestDistributedGlobal
@@ -101,7 +104,8 @@ template <typename ExpandEntry>
 void VerifyColumnSplitPartitioner(bst_target_t n_targets, size_t n_samples,
                                   bst_feature_t n_features, size_t base_rowid,
                                   std::shared_ptr<DMatrix> Xy, float min_value, float mid_value,
-                                  CommonRowPartitioner const& expected_mid_partitioner) {
+                                  CommonRowPartitioner const& expected_mid_partitioner,
+                                  bool by_owner) {
   auto dmat =
       std::unique_ptr<DMatrix>{Xy->SliceCol(collective::GetWorldSize(), collective::GetRank())};
 
@@ -110,6 +114,8 @@ void VerifyColumnSplitPartitioner(bst_target_t n_targets, size_t n_samples,
 
   std::vector<ExpandEntry> candidates{{0, 0}};
   candidates.front().split.loss_chg = 0.4;
+  // All workers have the split feature in this test, let the first one make the decisions.
+  candidates.front().split_owner = by_owner ? 0 : -1;
   auto cuts = common::SketchOnDMatrix(&ctx, dmat.get(), 64);
 
   for (auto const& page : Xy->GetBatches<SparsePage>()) {
@@ -164,7 +170,7 @@ void VerifyColumnSplitPartitioner(bst_target_t n_targets, size_t n_samples,
 }
 
 template <typename ExpandEntry>
-void TestColumnSplitPartitioner(bst_target_t n_targets) {
+void TestColumnSplitPartitioner(bst_target_t n_targets, bool by_owner = false) {
   std::size_t n_samples = 1024, base_rowid = 0;
   bst_feature_t n_features = 16;
   auto Xy = RandomDataGenerator{n_samples, n_features, 0}.GenerateDMatrix(true);
@@ -198,7 +204,7 @@ void TestColumnSplitPartitioner(bst_target_t n_targets) {
   auto constexpr kWorkers = 4;
   collective::TestDistributedGlobal(kWorkers, [&] {
     VerifyColumnSplitPartitioner<ExpandEntry>(n_targets, n_samples, n_features, base_rowid, Xy,
-                                              min_value, mid_value, mid_partitioner);
+                                              min_value, mid_value, mid_partitioner, by_owner);
   });
 }
 }  // anonymous namespace
@@ -207,6 +213,122 @@ TEST(QuantileHist, PartitionerColumnSplit) { TestColumnSplitPartitioner<CPUExpan
 
 TEST(QuantileHist, MultiPartitionerColumnSplit) { TestColumnSplitPartitioner<MultiExpandEntry>(3); }
 
+TEST(QuantileHist, PartitionerColumnSplitByOwner) {
+  TestColumnSplitPartitioner<CPUExpandEntry>(1, true);
+}
+
+TEST(QuantileHist, VotingParallel) {
+  auto constexpr kRows = 256;
+  auto constexpr kCols = 16;
+  auto constexpr kWorkers = 2;
+  collective::TestDistributedGlobal(kWorkers, [&] {
+    Context ctx;
+    collective::GetWorkerLocalThreads(kWorkers, &ctx);
+    auto p_dmat =
+        RandomDataGenerator{kRows, kCols, 0.2}.Seed(collective::GetRank()).GenerateDMatrix();
+    auto gpair = GenerateRandomGradients(&ctx, kRows, 1);
+    ObjInfo task{ObjInfo::kRegression};
+
+    auto train = [&](std::size_t top_k) {
+      std::unique_ptr<TreeUpdater> updater{
+          TreeUpdater::Create("grow_quantile_histmaker", &ctx, &task)};
+      // The gradient is quantised so that the sums don't depend on the order of the
+      // reduction and the subtraction.
+      updater->Configure(Args{{"voting_top_k", std::to_string(top_k)},
+                              {"quantise_gradient", "true"},
+                              {"debug_synchronize", "true"}});
+      TrainParam param;
+      param.Init(Args{{"max_depth", "4"}});
+      std::vector<HostDeviceVector<bst_node_t>> position(1);
+      RegTree tree{1u, static_cast<bst_feature_t>(kCols)};
+      updater->Update(&param, &gpair, p_dmat.get(), position, {&tree});
+      return tree;
+    };
+    Json expected{Object{}};
+    train(0).SaveModel(&expected);
+    // All features are voted, same as reducing the full histograms.
+    Json full{Object{}};
+    train(kCols).SaveModel(&full);
+    ASSERT_EQ(full, expected);
+    // The trees are synchronised with fewer features.
+    auto tree = train(2);
+    ASSERT_GT(tree.NumExtraNodes(), 0);
+  });
+}
+
+TEST(QuantileHist, SparseGradient) {
+  auto constexpr kRows = 1024;
+  auto constexpr kCols = 8;
+  Context ctx;
+  auto p_dmat = RandomDataGenerator{kRows, kCols, 0.2}.Seed(3).GenerateDMatrix();
+  auto gpair = GenerateRandomGradients(&ctx, kRows, 1);
+  auto h_gpair = gpair.HostView();
+  for (std::size_t i = 0; i < kRows; ++i) {
+    if (i % 3 != 0) {
+      h_gpair(i, 0) = GradientPair{};
+    }
+  }
+
+  auto train = [&](bool sparse_grad) {
+    ObjInfo task{ObjInfo::kClassification};
+    task.sparse_grad = sparse_grad;
+    std::unique_ptr<TreeUpdater> updater{
+        TreeUpdater::Create("grow_quantile_histmaker", &ctx, &task)};
+    updater->Configure(Args{});
+    TrainParam param;
+    param.Init(Args{{"max_depth", "4"}});
+    std::vector<HostDeviceVector<bst_node_t>> position(1);
+    RegTree tree{1u, static_cast<bst_feature_t>(kCols)};
+    updater->Update(&param, &gpair, p_dmat.get(), position, {&tree});
+    Json model{Object{}};
+    tree.SaveModel(&model);
+    return model;
+  };
+  // Rows with zero gradient don't contribute to the tree.
+  auto expected = train(false);
+  ASSERT_EQ(train(true), expected);
+}
+
+TEST(QuantileHist, PositionHist) {
+  auto constexpr kRows = 4096;
+  auto constexpr kCols = 8;
+  Context ctx;
+  ctx.UpdateAllowUnknown(Args{{"nthread", "2"}});
+  auto gpair = GenerateRandomGradients(&ctx, kRows, 1);
+  for (auto sparsity : {0.0f, 0.3f}) {
+    auto p_dmat = RandomDataGenerator{kRows, kCols, sparsity}.Seed(1).GenerateDMatrix();
+    auto train = [&](std::int32_t max_depth, std::string subsample) {
+      // Update the leaves for the positions.
+      ObjInfo task{ObjInfo::kRegression, false, true};
+      std::unique_ptr<TreeUpdater> updater{
+          TreeUpdater::Create("grow_quantile_histmaker", &ctx, &task)};
+      // The gradient is quantised so that the sums don't depend on the order of the rows.
+      updater->Configure(Args{{"position_max_depth", std::to_string(max_depth)},
+                              {"quantise_gradient", "true"}});
+      TrainParam param;
+      param.Init(Args{{"max_depth", "6"}, {"max_bin", "16"}, {"subsample", subsample}});
+      std::vector<HostDeviceVector<bst_node_t>> position(1);
+      RegTree tree{1u, static_cast<bst_feature_t>(kCols)};
+      // The gradient is sampled in place.
+      linalg::Matrix<GradientPair> sampled{gpair.Shape(), ctx.Device()};
+      sampled.Data()->Copy(*gpair.Data());
+      common::GlobalRandom().seed(3);
+      updater->Update(&param, &sampled, p_dmat.get(), position, {&tree});
+      Json model{Object{}};
+      tree.SaveModel(&model);
+      return std::make_pair(model, position.front().ConstHostVector());
+    };
+    for (auto subsample : {"1.0", "0.5"}) {
+      auto expected = train(0, subsample);
+      for (std::int32_t max_depth : {2, 6}) {
+        auto got = train(max_depth, subsample);
+        ASSERT_EQ(got.first, expected.first);
+        ASSERT_EQ(got.second, expected.second);
+      }
+    }
+  }
+}
+
 namespace {
 class TestHistColumnSplit : public ::testing::TestWithParam<std::tuple<bst_target_t, bool, float>> {
  public:
@@ -56,4 +56,48 @@ TEST(Updater, Refresh) {
   ASSERT_NEAR(0, tree.Stat(1).loss_chg, kEps);
   ASSERT_NEAR(0, tree.Stat(2).loss_chg, kEps);
 }
+
+TEST(Updater, RefreshBlocks) {
+  // More rows than a block, with multiple trees.
+  bst_idx_t constexpr kRows = 211;
+  bst_feature_t constexpr kCols = 4;
+  Context ctx;
+  ctx.UpdateAllowUnknown(Args{{"nthread", "3"}});
+
+  auto p_dmat = RandomDataGenerator{kRows, kCols, 0.2f}.Seed(3).GenerateDMatrix();
+  auto gpair = GenerateRandomGradients(&ctx, kRows, 1);
+
+  std::vector<RegTree> h_trees(3, RegTree{1u, kCols});
+  std::vector<RegTree *> trees;
+  for (std::size_t k = 0; k < h_trees.size(); ++k) {
+    auto &tree = h_trees[k];
+    auto fidx = static_cast<bst_feature_t>(k);
+    tree.ExpandNode(0, fidx, 0.5f, k % 2 == 0, 0.0, 0.2f, 0.8f, 0.0f, 0.0f, 0.0f, 0.0f);
+    tree.ExpandNode(tree[0].LeftChild(), fidx + 1, 0.3f, true, 0.0, 0.1f, 0.4f, 0.0f, 0.0f,
+                    0.0f, 0.0f);
+    trees.push_back(&tree);
+  }
+
+  ObjInfo task{ObjInfo::kRegression};
+  std::unique_ptr<TreeUpdater> refresher(TreeUpdater::Create("refresh", &ctx, &task));
+  std::vector<HostDeviceVector<bst_node_t>> position;
+  tree::TrainParam param;
+  param.UpdateAllowUnknown(Args{{"reg_lambda", "1"}});
+  refresher->Update(&param, &gpair, p_dmat.get(), position, trees);
+
+  double sum_hess = 0;
+  for (auto const &g : gpair.Data()->ConstHostVector()) {
+    sum_hess += g.GetHess();
+  }
+  for (auto const &tree : h_trees) {
+    ASSERT_NEAR(tree.Stat(RegTree::kRoot).sum_hess, sum_hess, 1e-3);
+    for (bst_node_t nidx = 0; nidx < tree.NumNodes(); ++nidx) {
+      if (!tree[nidx].IsLeaf()) {
+        auto children = tree.Stat(tree[nidx].LeftChild()).sum_hess +
+                        tree.Stat(tree[nidx].RightChild()).sum_hess;
+        ASSERT_NEAR(tree.Stat(nidx).sum_hess, children, 1e-3);
+      }
+    }
+  }
+}
 }  // namespace xgboost::tree
@@ -3,8 +3,12 @@
  */
 #include <gtest/gtest.h>
 
+#include <cmath>   // for isnan
+#include <vector>  // for vector
+
 #include "../../../src/common/bitfield.h"
 #include "../../../src/common/categorical.h"
+#include "../../../src/common/io.h"  // for AlignedMemWriteStream, AlignedResourceReadStream
 #include "../filesystem.h"
 #include "../helpers.h"
 #include "xgboost/tree_model.h"
@@ -59,6 +63,46 @@ TEST(Tree, ModelShape) {
 // Manually construct tree in binary format
 // Do not use structs in case they change
 // We want to preserve backwards compatibility
+TEST(Tree, FVecMask) {
+  RegTree::FVec feats;
+  bst_feature_t constexpr kCols = 130;
+  feats.Init(kCols, true);
+  ASSERT_TRUE(feats.HasMask());
+  std::vector<Entry> entries{{0, 1.0f}, {64, 2.0f}, {129, 3.0f}};
+  feats.Fill(SparsePage::Inst{entries.data(), entries.size()});
+  ASSERT_TRUE(feats.HasMissing());
+  feats.Set(70, 4.0f);
+  for (bst_feature_t i = 0; i < kCols; ++i) {
+    switch (i) {
+      case 0:
+        ASSERT_EQ(feats.GetFvalue(i), 1.0f);
+        break;
+      case 64:
+        ASSERT_EQ(feats.GetFvalue(i), 2.0f);
+        break;
+      case 70:
+        ASSERT_EQ(feats.GetFvalue(i), 4.0f);
+        break;
+      case 129:
+        ASSERT_EQ(feats.GetFvalue(i), 3.0f);
+        break;
+      default:
+        ASSERT_TRUE(std::isnan(feats.GetFvalue(i)));
+    }
+  }
+  feats.Reset(64);
+  ASSERT_TRUE(std::isnan(feats.GetFvalue(64)));
+  ASSERT_TRUE(std::isnan(feats.Data()[64]));
+
+  feats.Drop();
+  ASSERT_TRUE(feats.HasMask());
+  for (bst_feature_t i = 0; i < kCols; ++i) {
+    ASSERT_TRUE(std::isnan(feats.GetFvalue(i)));
+  }
+  feats.Init(kCols);
+  ASSERT_FALSE(feats.HasMask());
+}
+
 TEST(Tree, Load) {
   dmlc::TemporaryDirectory tempdir;
   const std::string tmp_file = tempdir.path + "/tree.model";
@@ -268,6 +312,76 @@ TEST(Tree, CategoricalIO) {
   }
 }
 
+TEST(Tree, ServingIO) {
+  RegTree tree;
+  GrowTree(&tree);
+  ASSERT_GT(tree.GetSplitCategories().size(), 0ul);
+
+  Json out{Object{}};
+  tree.SaveServingModel(&out);
+  auto const& obj = get<Object const>(out);
+  ASSERT_EQ(obj.find("loss_changes"), obj.cend());
+  ASSERT_EQ(obj.find("sum_hessian"), obj.cend());
+  ASSERT_EQ(obj.find("base_weights"), obj.cend());
+  // Less than 256 features and 32768 nodes.
+  ASSERT_TRUE(IsA<U8Array>(out["split_indices"]));
+  ASSERT_TRUE(IsA<I16Array>(out["left_children"]));
+  ASSERT_TRUE(IsA<I16Array>(out["parents"]));
+
+  auto check = [&](Json const& in) {
+    RegTree loaded;
+    loaded.LoadModel(in);
+    ASSERT_TRUE(loaded.SameSplits(tree));
+    for (bst_node_t nidx = 0; nidx < loaded.NumNodes(); ++nidx) {
+      ASSERT_EQ(loaded.Stat(nidx).sum_hess, 0.0f);
+      ASSERT_EQ(loaded[nidx].Parent(), tree[nidx].Parent());
+      ASSERT_EQ(loaded[nidx].IsLeftChild(), tree[nidx].IsLeftChild());
+    }
+  };
+  check(out);
+  for (auto mode : {std::ios::binary, std::ios::out}) {
+    std::string str;
+    Json::Dump(out, &str, mode);
+    check(Json::Load(StringView{str}, mode));
+  }
+}
+
+TEST(Tree, FlatIO) {
+  auto check = [](RegTree const& tree) {
+    std::string buf;
+    {
+      common::AlignedMemWriteStream fo{&buf};
+      auto n_bytes = tree.Write(&fo);
+      ASSERT_EQ(n_bytes, buf.size());
+    }
+    auto resource = std::make_shared<common::MallocResource>(buf.size());
+    std::copy_n(buf.data(), buf.size(), resource->DataAs<char>());
+    common::AlignedResourceReadStream fi{resource};
+    RegTree loaded;
+    ASSERT_TRUE(loaded.Read(&fi));
+    ASSERT_EQ(fi.Tell(), buf.size());
+
+    Json out{Object{}};
+    tree.SaveModel(&out);
+    Json saved{Object{}};
+    loaded.SaveModel(&saved);
+    ASSERT_EQ(out, saved);
+  };
+
+  RegTree tree;
+  bst_cat_t cat = 32;
+  std::vector<uint32_t> split_cats(LBitField32::ComputeStorageSize(cat + 1));
+  LBitField32 bitset{split_cats};
+  bitset.Set(cat);
+  tree.ExpandCategorical(0, 0, split_cats, true, 1.0, 2.0, 3.0, 11.0, 2.0,
+                         /*left_sum=*/3.0, /*right_sum=*/4.0);
+  check(tree);
+
+  RegTree grown;
+  GrowTree(&grown);
+  check(grown);
+}
+
 namespace {
 RegTree ConstructTree() {
   RegTree tree;
@@ -423,6 +537,21 @@ TEST(Tree, DumpText) {
   ASSERT_EQ(str.find("cover"), std::string::npos);
 }
 
+TEST(Tree, DumpTextFloat) {
+  RegTree tree;
+  tree.ExpandNode(
+      /*nid=*/0, /*split_index=*/0, /*split_value=*/0.5f,
+      /*default_left=*/true, 0.0f, /*left_leaf_weight=*/0.1f, /*right_leaf_weight=*/-1e-8f,
+      /*loss_change=*/3.25f, /*sum_hess=*/4.0f, /*left_sum=*/1.0f, /*right_sum=*/3.0f);
+  FeatureMap fmap;
+  auto str = tree.DumpModel(fmap, true, "text");
+  // Shortest representation that round-trips.
+  ASSERT_NE(str.find("[f0<0.5]"), std::string::npos) << str;
+  ASSERT_NE(str.find("leaf=0.1,"), std::string::npos) << str;
+  ASSERT_NE(str.find("leaf=-1e-08,"), std::string::npos) << str;
+  ASSERT_NE(str.find("gain=3.25,cover=4"), std::string::npos) << str;
+}
+
 TEST(Tree, DumpTextCategorical) {
   TestCategoricalTreeDump("text", ",");
 }
@@ -149,6 +149,26 @@ TEST_F(TestGrowPolicy, Hist) {
   this->TestCombination(&ctx, "hist");
 }
 
+TEST_F(TestGrowPolicy, LossGuideUnlimitedLeaves) {
+  // Without a limit on leaves, nodes are expanded in batches for lossguide. The tree should
+  // be equivalent to the one grown with depthwise.
+  Context ctx;
+  auto predict = [&](std::string tree_method, std::string policy) {
+    auto learner = this->TrainOneIter(&ctx, tree_method, policy, 0, 5);
+    HostDeviceVector<float> predt;
+    learner->Predict(Xy_, false, &predt, 0, 0);
+    return predt.HostVector();
+  };
+  for (auto tree_method : {"hist", "approx"}) {
+    auto lossguide = predict(tree_method, "lossguide");
+    auto depthwise = predict(tree_method, "depthwise");
+    ASSERT_EQ(lossguide.size(), depthwise.size());
+    for (std::size_t i = 0; i < lossguide.size(); ++i) {
+      ASSERT_NEAR(lossguide[i], depthwise[i], kRtEps);
+    }
+  }
+}
+
 #if defined(XGBOOST_USE_CUDA)
 TEST_F(TestGrowPolicy, GpuHist) {
   auto ctx = MakeCUDACtx(0);
@@ -0,0 +1,129 @@
+/**
+ * Copyright 2025, XGBoost Contributors
+ */
+#include <gtest/gtest.h>
+#include <xgboost/json.h>     // for Json, get
+#include <xgboost/learner.h>  // for Learner
+
+#include <chrono>   // for milliseconds
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int32_t, int64_t
+#include <memory>   // for unique_ptr
+#include <string>   // for string
+#include <thread>   // for sleep_for
+#include <vector>   // for vector
+
+#include "../../../src/tree/tree_telemetry.h"
+#include "../helpers.h"
+
+namespace xgboost::tree {
+namespace {
+std::vector<Json> records;
+
+void Collect(char const* str) { records.push_back(Json::Load(StringView{str})); }
+
+class TreeTelemetryTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    records.clear();
+    TelemetryRound::SetCallback(Collect);
+  }
+  void TearDown() override { TelemetryRound::SetCallback(nullptr); }
+};
+}  // anonymous namespace
+
+TEST_F(TreeTelemetryTest, Round) {
+  {
+    // Timed before the tree, accounted to the first tree.
+    PhaseTimer gradient{TreePhase::kGradient};
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  {
+    TelemetryRound round{3, 6, 1};
+    for (std::int32_t i = 0; i < 2; ++i) {
+      TreeRecordScope scope;
+      auto* record = CurrentTreeRecord();
+      ASSERT_TRUE(record);
+      record->n_expanded += 2;
+      record->AddLevelRows(1, 16);
+      record->AddLevelRows(0, 32);
+      PhaseTimer build{TreePhase::kBuildHist};
+      {
+        PhaseTimer sub{TreePhase::kSubtraction};
+        std::this_thread::sleep_for(std::chrono::milliseconds{2});
+      }
+    }
+    {
+      // Accounted to the last tree.
+      PhaseTimer cache{TreePhase::kPredictionCache};
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    ASSERT_TRUE(records.empty());
+  }
+  ASSERT_FALSE(CurrentTreeRecord());
+  ASSERT_EQ(records.size(), 2);
+  for (std::int32_t i = 0; i < 2; ++i) {
+    auto const& record = records[i];
+    ASSERT_EQ(get<Integer const>(record["iteration"]), 3);
+    ASSERT_EQ(get<Integer const>(record["tree"]), 6 + i);
+    ASSERT_EQ(get<Integer const>(record["group"]), i);
+    ASSERT_EQ(get<Integer const>(record["n_expanded"]), 2);
+    auto const& rows = get<Array const>(record["rows_per_level"]);
+    ASSERT_EQ(rows.size(), 2);
+    ASSERT_EQ(get<Integer const>(rows[0]), 32);
+    ASSERT_EQ(get<Integer const>(rows[1]), 16);
+    auto const& phases = record["phases"];
+    ASSERT_EQ(get<Object const>(phases).size(), TreeRecord::kNumPhases);
+    auto sub = get<Number const>(phases["subtraction"]);
+    // The nested phase is excluded.
+    ASSERT_GE(sub, 0.002);
+    ASSERT_LT(get<Number const>(phases["build_hist"]), sub);
+    ASSERT_GE(get<Number const>(record["elapsed"]), sub);
+    ASSERT_EQ(get<Number const>(phases["gradient"]) > 0, i == 0);
+    ASSERT_EQ(get<Number const>(phases["prediction_cache"]) > 0, i == 1);
+  }
+
+  // Nothing is recorded outside of a round.
+  records.clear();
+  {
+    TreeRecordScope scope;
+    ASSERT_FALSE(CurrentTreeRecord());
+  }
+  ASSERT_TRUE(records.empty());
+}
+
+TEST_F(TreeTelemetryTest, Hist) {
+  bst_idx_t n_samples = 512;
+  std::int32_t n_iters = 3;
+  auto p_fmat = RandomDataGenerator{n_samples, 8, 0.0}.Classes(3).GenerateDMatrix(true);
+  for (auto n_concurrent : {"1", "3"}) {
+    records.clear();
+    std::unique_ptr<Learner> learner{Learner::Create({p_fmat})};
+    learner->SetParams(Args{{"tree_method", "hist"},
+                            {"objective", "multi:softprob"},
+                            {"num_class", "3"},
+                            {"max_depth", "3"},
+                            {"concurrent_trees", n_concurrent},
+                            {"nthread", "3"}});
+    for (std::int32_t i = 0; i < n_iters; ++i) {
+      learner->UpdateOneIter(i, p_fmat);
+    }
+    ASSERT_EQ(records.size(), static_cast<std::size_t>(n_iters * 3));
+    for (std::int64_t i = 0; i < static_cast<std::int64_t>(records.size()); ++i) {
+      auto const& record = records[i];
+      ASSERT_EQ(get<Integer const>(record["iteration"]), i / 3);
+      ASSERT_EQ(get<Integer const>(record["tree"]), i);
+      ASSERT_EQ(get<Integer const>(record["group"]), i % 3);
+      ASSERT_GE(get<Integer const>(record["n_expanded"]), 1);
+      auto const& rows = get<Array const>(record["rows_per_level"]);
+      ASSERT_FALSE(rows.empty());
+      ASSERT_EQ(get<Integer const>(rows[0]), static_cast<std::int64_t>(n_samples));
+      auto const& phases = record["phases"];
+      ASSERT_GT(get<Number const>(phases["build_hist"]), 0.0);
+      ASSERT_GT(get<Number const>(phases["evaluate"]), 0.0);
+      ASSERT_GT(get<Number const>(phases["partition"]), 0.0);
+      ASSERT_EQ(get<Integer const>(record["comm_bytes"]), 0);
+    }
+  }
+}
+}  // namespace xgboost::tree
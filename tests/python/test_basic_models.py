@@ -223,6 +223,31 @@ class TestModels:
     def test_custom_objective(self):
         self.run_custom_objective()
 
+    def test_gradient_buffer(self) -> None:
+        n_samples, n_targets = 256, 3
+        X, y, _ = tm.make_regression(n_samples, 8, use_cupy=False)
+        y = np.stack([y * (i + 1) for i in range(n_targets)], axis=1)
+        Xy = xgb.DMatrix(X, y)
+        params = {"multi_strategy": "multi_output_tree"}
+        expected = xgb.Booster(params, [Xy])
+        got = xgb.Booster(params, [Xy])
+        for i in range(4):
+            predt = expected.predict(Xy, output_margin=True)
+            grad, hess = predt - y, np.ones(y.shape)
+            expected.boost(Xy, i, grad, hess)
+
+            buf = got.gradient_buffer(Xy)
+            assert buf.shape == (n_samples, n_targets, 2)
+            assert buf.dtype == np.float32
+            buf[:, :, 0] = grad
+            buf[:, :, 1] = hess
+            got.boost_with_gradient_buffer(Xy, i)
+
+        np.testing.assert_allclose(
+            got.predict(Xy, output_margin=True),
+            expected.predict(Xy, output_margin=True),
+        )
+
     def test_multi_eval_metric(self):
         dtrain, dtest = tm.load_agaricus(__file__)
         watchlist = [(dtest, "eval"), (dtrain, "train")]
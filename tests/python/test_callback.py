@@ -119,6 +119,51 @@ class TestCallbacks:
         dump = booster.get_dump(dump_format="json")
         assert len(dump) - booster.best_iteration == early_stopping_rounds + 1
 
+    def test_async_eval(self, breast_cancer: BreastCancer) -> None:
+        D_train = xgb.DMatrix(breast_cancer.tr[0], breast_cancer.tr[1])
+        D_valid = xgb.DMatrix(breast_cancer.va[0], breast_cancer.va[1])
+        evals = [(D_train, "Train"), (D_valid, "Valid")]
+        params = {"objective": "binary:logistic", "eval_metric": ["error", "auc"]}
+
+        results = []
+        for async_eval in [False, True]:
+            evals_result: xgb.callback.TrainingCallback.EvalsLog = {}
+            xgb.train(
+                {**params, "async_eval": async_eval},
+                D_train,
+                evals=evals,
+                num_boost_round=8,
+                evals_result=evals_result,
+                verbose_eval=False,
+            )
+            results.append(evals_result)
+        assert results[0] == results[1]
+        assert len(results[1]["Valid"]["auc"]) == 8
+
+        # The evaluation of the final iteration arrives after training.
+        booster = xgb.train(
+            {**params, "async_eval": True},
+            D_train,
+            evals=evals,
+            num_boost_round=1000,
+            early_stopping_rounds=5,
+            verbose_eval=False,
+        )
+        assert booster.eval_pending() == ""
+        dump = booster.get_dump(dump_format="json")
+        assert len(dump) - booster.best_iteration <= 5 + 2
+
+        with pytest.raises(ValueError, match="Custom metric"):
+            xgb.train(
+                {**params, "async_eval": True},
+                D_train,
+                evals=evals,
+                custom_metric=eval_error_metric,
+                num_boost_round=2,
+            )
+        with pytest.raises(ValueError, match="cv"):
+            xgb.cv({**params, "async_eval": True}, D_train, num_boost_round=2)
+
     def test_early_stopping_custom_eval(self, breast_cancer: BreastCancer) -> None:
         D_train = xgb.DMatrix(breast_cancer.tr[0], breast_cancer.tr[1])
         D_valid = xgb.DMatrix(breast_cancer.va[0], breast_cancer.va[1])
@@ -511,6 +556,41 @@ class TestCallbacks:
             for i in range(1, 10):
                 assert os.path.exists(os.path.join(tmpdir, "model_" + str(i) + ".pkl"))
 
+    def test_incremental_check_point(self, breast_cancer: BreastCancer) -> None:
+        X, y = breast_cancer.full
+        m = xgb.DMatrix(X, y)
+        with tempfile.TemporaryDirectory() as tmpdir:
+            check_point = xgb.callback.TrainingCheckPoint(
+                directory=tmpdir, interval=3, name="model", incremental=True
+            )
+            booster = xgb.train(
+                {"objective": "binary:logistic"},
+                m,
+                num_boost_round=10,
+                evals=[(m, "Train")],
+                verbose_eval=False,
+                # Runs before the checkpoint to record the best iteration.
+                callbacks=[xgb.callback.EarlyStopping(rounds=20), check_point],
+            )
+            fmt = xgb.callback.TrainingCheckPoint.default_format
+            assert os.path.exists(os.path.join(tmpdir, f"model_3.{fmt}"))
+            for i in (6, 9):
+                assert os.path.exists(os.path.join(tmpdir, f"model_{i}.delta.{fmt}"))
+
+            merged = xgb.callback.TrainingCheckPoint.merge(tmpdir, name="model")
+            assert merged.num_boosted_rounds() == booster.num_boosted_rounds()
+            assert merged.attributes() == booster.attributes()
+            np.testing.assert_allclose(merged.predict(m), booster.predict(m))
+
+            os.remove(os.path.join(tmpdir, f"model_6.delta.{fmt}"))
+            with pytest.raises(ValueError, match="Missing checkpoint"):
+                xgb.callback.TrainingCheckPoint.merge(tmpdir, name="model")
+
+        with pytest.raises(ValueError, match="incremental"):
+            xgb.callback.TrainingCheckPoint(
+                directory=".", as_pickle=True, incremental=True
+            )
+
     def test_callback_list(self) -> None:
         X, y = tm.data.get_california_housing()
         m = xgb.DMatrix(X, y)
@@ -119,6 +119,54 @@ eval[test] = {data_path}
 
             assert hash(cli_model_bin) == hash(py_model_bin)
 
+    def test_cli_predict_stream(self):
+        data_path = "{root}/demo/data/agaricus.txt.train?format=libsvm".format(
+            root=self.PROJECT_ROOT)
+        exe = self.get_exe()
+        seed = 1994
+
+        with tempfile.TemporaryDirectory() as tmpdir:
+            model_out_cli = os.path.join(tmpdir, 'test_cli_predict_stream.json')
+            config_path = os.path.join(tmpdir, 'test_cli_predict_stream.conf')
+            train_conf = self.template.format(data_path=data_path,
+                                              seed=seed,
+                                              task='train',
+                                              model_in='NULL',
+                                              model_out=model_out_cli,
+                                              test_path='NULL',
+                                              name_pred='NULL',
+                                              model_dir='NULL')
+            with open(config_path, 'w') as fd:
+                fd.write(train_conf)
+            subprocess.run([exe, config_path], check=True)
+
+            def predict(name, args):
+                predict_out = os.path.join(tmpdir, name)
+                predict_conf = self.template.format(task='pred',
+                                                    seed=seed,
+                                                    data_path=data_path,
+                                                    model_in=model_out_cli,
+                                                    model_out='NULL',
+                                                    test_path=data_path,
+                                                    name_pred=predict_out,
+                                                    model_dir='NULL')
+                with open(config_path, 'w') as fd:
+                    fd.write(predict_conf)
+                subprocess.run([exe, config_path] + args, check=True)
+                with open(predict_out, 'r') as fd:
+                    return fd.read()
+
+            expected = predict('full', [])
+            # The batches don't align with the blocks of the parser.
+            for n_rows in [1, 1000, 1 << 20]:
+                streamed = predict(
+                    'stream-' + str(n_rows), ['pred_batch_rows=' + str(n_rows)]
+                )
+                assert streamed == expected
+            expected = predict('full-margin', ['pred_margin=1'])
+            streamed = predict('stream-margin', ['pred_margin=1', 'pred_batch_rows=777'])
+            assert streamed == expected
+
     def test_cli_help(self):
         exe = self.get_exe()
         completed = subprocess.run([exe], stdout=subprocess.PIPE)
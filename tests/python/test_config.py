@@ -1,9 +1,13 @@
+import json
 import multiprocessing
+import os
+import tempfile
 from concurrent.futures import ThreadPoolExecutor
 
 import pytest
 
 import xgboost as xgb
+from xgboost import testing as tm
 
 
 @pytest.mark.parametrize("verbosity_level", [0, 1, 2, 3])
@@ -59,7 +63,60 @@ def test_nested_config() -> None:
     assert verbosity == 1
 
 
-def test_thread_safety():
+def test_trace_file() -> None:
+    X, y, _ = tm.make_regression(256, 8, use_cupy=False)
+    Xy = xgb.DMatrix(X, y)
+    with tempfile.TemporaryDirectory() as tmpdir:
+        path = os.path.join(tmpdir, "trace.json")
+        with xgb.config_context(trace_file=path):
+            assert xgb.get_config()["trace_file"] == path
+            xgb.train({"tree_method": "hist", "max_depth": 3}, Xy, num_boost_round=2)
+        # The trace is written once the tracing is stopped.
+        assert xgb.get_config()["trace_file"] == ""
+        with open(path, "r") as fd:
+            trace = json.load(fd)
+        names = {event["name"] for event in trace["traceEvents"]}
+        assert {"TreeLevel", "BuildHist"}.issubset(names)
+
+
+@pytest.mark.parametrize("huge_pages", ["transparent", "explicit"])
+def test_huge_pages(huge_pages: str) -> None:
+    # Large enough for the gradient index to use huge pages.
+    X, y, _ = tm.make_regression(1 << 16, 32, use_cupy=False)
+    Xy = xgb.QuantileDMatrix(X, y)
+    params = {"tree_method": "hist", "max_depth": 6}
+    booster = xgb.train(params, Xy, num_boost_round=4)
+    with xgb.config_context(huge_pages=huge_pages, numa_interleave=True):
+        assert xgb.get_config()["huge_pages"] == huge_pages
+        Xy = xgb.QuantileDMatrix(X, y)
+        booster_hp = xgb.train(params, Xy, num_boost_round=4)
+    assert xgb.get_config()["huge_pages"] == "none"
+    assert booster.save_raw() == booster_hp.save_raw()
+
+
+def test_perf_counters() -> None:
+    X, y, _ = tm.make_regression(256, 8, use_cupy=False)
+    Xy = xgb.DMatrix(X, y)
+    with xgb.config_context(perf_counters=True):
+        booster = xgb.train({"tree_method": "hist"}, Xy, num_boost_round=2)
+        booster.predict(Xy)
+    counters = xgb.config.get_perf_counters()
+    if not counters:
+        pytest.skip("Hardware performance counters are not available.")
+    assert counters["CPUPredictor::PredictBatch"]["count"] >= 1
+    assert counters["HistogramBuilder::BuildHist"]["elapsed"] > 0.0
+
+
+def test_memory_stats() -> None:
+    X, y, _ = tm.make_regression(4096, 8, use_cupy=False)
+    Xy = xgb.DMatrix(X, y)
+    xgb.train({"tree_method": "hist"}, Xy, num_boost_round=2)
+    stats = xgb.config.get_memory_stats()
+    for name in ("SparsePage", "GHistIndexMatrix", "Histogram", "Gradient", "Total"):
+        assert stats[name]["peak"] >= stats[name]["current"]
+    assert stats["SparsePage"]["current"] >= X.nbytes
+    assert stats["GHistIndexMatrix"]["peak"] > 0
+    assert stats["Total"]["peak"] >= stats["SparsePage"]["peak"]
     n_threads = multiprocessing.cpu_count()
     futures = []
     with ThreadPoolExecutor(max_workers=n_threads) as executor:
@@ -122,6 +122,43 @@ class TestBoosterIO:
             predt_1 = booster.predict(Xy)
             np.testing.assert_allclose(predt_0, predt_1)
 
+            path = os.path.join(tempdir, "model.mmap")
+            booster.save_model(path)
+            booster = xgb.Booster(model_file=path)
+            predt_1 = booster.predict(Xy)
+            np.testing.assert_allclose(predt_0, predt_1)
+
+            lazy = xgb.Booster()
+            lazy.load_model_lazy(path, max_bytes=1)
+            predt_1 = lazy.predict(Xy)
+            np.testing.assert_allclose(predt_0, predt_1)
+            with pytest.raises(ValueError, match="loaded on demand"):
+                lazy.save_raw()
+
+    def test_serving_model_io(self) -> None:
+        X, y, _ = tm.make_regression(1024, 16, use_cupy=False)
+        Xy = xgb.DMatrix(X, y)
+        booster = xgb.train({"tree_method": "hist"}, Xy, num_boost_round=16)
+        predt_0 = booster.predict(Xy)
+
+        for raw_format in ("json", "ubj"):
+            full = booster.save_raw(raw_format)
+            raw = booster.save_raw(raw_format, serving=True)
+            assert len(raw) < len(full) * 0.6
+            loaded = xgb.Booster(model_file=raw)
+            np.testing.assert_allclose(loaded.predict(Xy), predt_0)
+            assert loaded.get_score(importance_type="weight") == booster.get_score(
+                importance_type="weight"
+            )
+            with pytest.raises(ValueError, match="serving"):
+                loaded.predict(Xy, pred_contribs=True)
+            with pytest.raises(ValueError, match="serving"):
+                loaded.get_score(importance_type="gain")
+            # The flag is kept after saving the model again.
+            loaded = xgb.Booster(model_file=loaded.save_raw(raw_format))
+            with pytest.raises(ValueError, match="serving"):
+                loaded.get_score(importance_type="cover")
+
     @pytest.mark.skipif(**tm.no_json_schema())
     def test_json_io_schema(self) -> None:
         import jsonschema
@@ -232,6 +232,17 @@ class TestInplacePredict:
         from_dmatrix = booster.predict(dtrain)
         np.testing.assert_allclose(from_dmatrix, from_inplace)
 
+    def test_nthread(self) -> None:
+        booster = self.booster
+        expected = booster.inplace_predict(self.X, missing=self.missing)
+        for nthread in (1, 2):
+            predt = booster.inplace_predict(
+                self.X, missing=self.missing, nthread=nthread
+            )
+            np.testing.assert_allclose(predt, expected)
+        with pytest.raises(ValueError, match="nthread"):
+            booster.inplace_predict(self.X, nthread=-1)
+
     @pytest.mark.skipif(**tm.no_pandas())
     def test_dtypes(self) -> None:
         for orig, x in np_dtypes(self.rows, self.cols):
@@ -466,6 +466,37 @@ class TestTreeMethod:
     def test_quantile_loss(self, weighted: bool) -> None:
         check_quantile_loss("hist", weighted)
 
+    @pytest.mark.skipif(**tm.no_sklearn())
+    @pytest.mark.parametrize("weighted", [True, False])
+    def test_quantile_loss_vector_leaf(self, weighted: bool) -> None:
+        from sklearn.datasets import make_regression
+
+        rng = np.random.RandomState(1994)
+        X, y = make_regression(n_samples=4096, n_features=8, random_state=rng)
+        weight = rng.random(size=y.shape[0]) if weighted else None
+        Xy = xgb.DMatrix(X, y, weight=weight)
+        alpha = np.array([0.9, 0.1, 0.3, 0.5, 0.7])
+        evals_result: Dict[str, Dict] = {}
+        booster = xgb.train(
+            {
+                "objective": "reg:quantileerror",
+                "tree_method": "hist",
+                "multi_strategy": "multi_output_tree",
+                "quantile_alpha": alpha,
+            },
+            Xy,
+            num_boost_round=16,
+            evals=[(Xy, "Train")],
+            evals_result=evals_result,
+        )
+        loss = evals_result["Train"]["quantile"]
+        assert loss[-1] < loss[0]
+        predt = booster.predict(Xy, strict_shape=True)
+        assert predt.shape == (y.shape[0], alpha.size)
+        # The predicted quantiles don't cross.
+        sorted_predt = predt[:, np.argsort(alpha)]
+        assert np.all(np.diff(sorted_predt, axis=1) >= 0)
+
     @pytest.mark.skipif(**tm.no_pandas())
     @pytest.mark.parametrize("tree_method", ["hist"])
     def test_get_quantile_cut(self, tree_method: str) -> None: